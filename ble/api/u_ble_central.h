@@ -0,0 +1,217 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_BLE_CENTRAL_H_
+#define _U_BLE_CENTRAL_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup _BLE _Bluetooth Low Energy
+ *  @{
+ */
+
+/** @file
+ * @brief This header file defines a scheduler for a BLE central that
+ * polls a set of peripherals, e.g. sensors, for the values of their
+ * characteristics.  Up to #U_BLE_CENTRAL_MAX_CONNECTIONS connections
+ * are kept open at any one time and reads are made on the peers that
+ * are already connected while the connection to the next peer is
+ * being set up.  The value handles of the characteristics of a peer
+ * are discovered once and then cached, so that reconnecting to a peer
+ * does not require another discovery; the cache can be read out with
+ * uBleCentralGetHandles() and restored, e.g. after a power cycle, with
+ * uBleCentralPresetHandles().
+ *
+ * Like the NUS API, the functions of this API take over the connection
+ * callback of the BLE device (see uBleGapSetConnectCallback()) and are
+ * intended to be used without any other BLE GAP or GATT functions being
+ * called at the same time.
+ *
+ * Note: only BLE on an external (AT-command driven) u-blox module is
+ * supported.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_BLE_CENTRAL_MAX_PEERS
+/** The maximum number of peers that can be added with
+ * uBleCentralAddPeer().
+ */
+# define U_BLE_CENTRAL_MAX_PEERS 20
+#endif
+
+#ifndef U_BLE_CENTRAL_MAX_CONNECTIONS
+/** The maximum number of connections the scheduler keeps open at any
+ * one time; this should not be more than the number of simultaneous
+ * central connections the module supports.
+ */
+# define U_BLE_CENTRAL_MAX_CONNECTIONS 4
+#endif
+
+#ifndef U_BLE_CENTRAL_MAX_CHARS_PER_PEER
+/** The maximum number of characteristics that can be read from
+ * each peer.
+ */
+# define U_BLE_CENTRAL_MAX_CHARS_PER_PEER 4
+#endif
+
+#ifndef U_BLE_CENTRAL_CONNECT_TIMEOUT_MS
+/** How long to wait for a connection to a peer to be established
+ * before giving up on that peer for this poll.
+ */
+# define U_BLE_CENTRAL_CONNECT_TIMEOUT_MS 10000
+#endif
+
+#ifndef U_BLE_CENTRAL_VALUE_MAX_LENGTH
+/** The maximum length of a characteristic value that can be read.
+ */
+# define U_BLE_CENTRAL_VALUE_MAX_LENGTH 32
+#endif
+
+/** The maximum length of a characteristic UUID string, e.g.
+ * "6E400003B5A3F393E0A9E50E24DCCA9E", including the terminator.
+ */
+#define U_BLE_CENTRAL_UUID_MAX_LENGTH 33
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Read callback, called from the task that called uBleCentralPoll()
+ * once for each characteristic of each peer.
+ *
+ *  @param peerIndex        the index of the peer, as returned by
+ *                          uBleCentralAddPeer().
+ *  @param charIndex        the index of the characteristic in the
+ *                          array passed to uBleCentralAddPeer().
+ *  @param errorOrLength    the number of bytes at pValue on success,
+ *                          else negative error code.
+ *  @param[in] pValue       the value read, NULL on error.
+ *  @param[in] pParam       the parameter passed to uBleCentralStart().
+ */
+typedef void (*uBleCentralReadCallback_t)(int32_t peerIndex,
+                                          size_t charIndex,
+                                          int32_t errorOrLength,
+                                          const uint8_t *pValue,
+                                          void *pParam);
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Start the scheduler.  The BLE interface of the provided device
+ *  must have been brought up in central mode before this is called.
+ *
+ * @param[in] devHandle   the handle of the u-blox BLE device.
+ * @param[in] cb          the callback that will receive the values
+ *                        read, cannot be NULL.
+ * @param[in] pParam      a parameter that will be passed to cb,
+ *                        may be NULL.
+ * @return                zero on success, on failure negative error code.
+ */
+int32_t uBleCentralStart(uDeviceHandle_t devHandle,
+                         uBleCentralReadCallback_t cb,
+                         void *pParam);
+
+/** Add a peer to be polled.
+ *
+ * @param[in] pAddress     the address of the peer, as would be passed
+ *                         to uBleGapConnect().
+ * @param[in] ppCharUuids  an array of the UUIDs of the characteristics
+ *                         to read from the peer, in the form they are
+ *                         reported by uBleGattDiscoverChar(); the
+ *                         strings are copied.
+ * @param numChars         the number of entries in ppCharUuids, at most
+ *                         #U_BLE_CENTRAL_MAX_CHARS_PER_PEER.
+ * @return                 on success the index of the peer, else
+ *                         negative error code.
+ */
+int32_t uBleCentralAddPeer(const char *pAddress,
+                           const char *const *ppCharUuids,
+                           size_t numChars);
+
+/** Get the cached value handles of the characteristics of a peer, e.g.
+ *  so that they can be stored and passed to uBleCentralPresetHandles()
+ *  after a restart.
+ *
+ * @param peerIndex           the index of the peer.
+ * @param[out] pValueHandles  a place to put the value handles, one
+ *                            for each characteristic, zero for those
+ *                            not yet discovered.
+ * @param numHandles          the number of entries at pValueHandles.
+ * @return                    on success the number of value handles
+ *                            written, else negative error code.
+ */
+int32_t uBleCentralGetHandles(int32_t peerIndex,
+                              uint16_t *pValueHandles,
+                              size_t numHandles);
+
+/** Preset the value handles of the characteristics of a peer so that
+ *  no discovery is needed when connecting to it, similar in function to
+ *  uBleSpsPresetSpsServerHandles().  If a read with a preset handle
+ *  fails, the handles of the peer are forgotten and discovery
+ *  is performed on the next connection.
+ *
+ * @param peerIndex          the index of the peer.
+ * @param[in] pValueHandles  the value handles, one for each
+ *                           characteristic, in the order given to
+ *                           uBleCentralAddPeer().
+ * @param numHandles         the number of entries at pValueHandles.
+ * @return                   zero on success, on failure negative
+ *                           error code.
+ */
+int32_t uBleCentralPresetHandles(int32_t peerIndex,
+                                 const uint16_t *pValueHandles,
+                                 size_t numHandles);
+
+/** Read the characteristics of all peers once, reporting each value
+ *  to the read callback.  Peers that are already connected are read
+ *  while the connection to the next peer is set up; connections are
+ *  kept open between polls unless room is needed for a peer that
+ *  is not connected, in which case the least recently read
+ *  connection is closed.
+ *
+ * @param timeoutMs  the maximum time to spend on this poll.
+ * @return           on success the number of peers of which all
+ *                   characteristics were read, else negative error code.
+ */
+int32_t uBleCentralPoll(int32_t timeoutMs);
+
+/** Stop the scheduler, close all of its connections and free
+ *  its resources.
+ *
+ * @return zero on success, on failure negative error code.
+ */
+int32_t uBleCentralStop();
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif  // _U_BLE_CENTRAL_H_
+
+// End of file
@@ -81,6 +81,14 @@ extern "C" {
 
 #define U_SHORT_RANGE_BT_ADDRESS_SIZE 14
 
+#ifndef U_BLE_GAP_SCAN_DEDUP_TABLE_SIZE
+/** The number of address/payload combinations that
+ * uBleGapScanFiltered() remembers for de-duplication; when the table
+ * is full the oldest is forgotten.
+ */
+# define U_BLE_GAP_SCAN_DEDUP_TABLE_SIZE 32
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -111,6 +119,33 @@ typedef struct {
  */
 typedef bool (*uBleGapScanCallback_t)(uBleScanResult_t *pScanResult);
 
+/** Filtering and batching for uBleGapScanFiltered().
+ */
+typedef struct {
+    int32_t rssiMin;        /**< results with an RSSI below this are dropped;
+                                 set to INT32_MIN to keep all results. */
+    int32_t dedupTtlMs;     /**< a result with the same address and advertisement
+                                 data as one already reported less than this
+                                 long ago is dropped; zero to report all. */
+    int32_t batchWindowMs;  /**< results are collected for this long and then
+                                 reported together, one result per address with
+                                 the most recent RSSI; zero to report each
+                                 result as it arrives. */
+    size_t maxBatchResults; /**< the maximum number of results in a batch, a
+                                 batch being reported early if it is full. */
+} uBleGapScanFilter_t;
+
+/** BLE batched scan result callback.
+ *  @param[in]  pResults    the results in this batch.
+ *  @param      numResults  the number of results at pResults.
+ *  @param[in]  pParam      the parameter passed to uBleGapScanFiltered().
+ *  @return                 true if the scan should continue or
+ *                          false to stop it before the timeout.
+ */
+typedef bool (*uBleGapScanBatchCallback_t)(const uBleScanResult_t *pResults,
+                                           size_t numResults,
+                                           void *pParam);
+
 /** Connect/disconnect callback for central and peripheral.
  *  @param[in]  connHandle  connection handle identifying the peer.
  *                          Must later be used for uBleGapDisconnect and
@@ -175,6 +210,32 @@ int32_t uBleGapScan(uDeviceHandle_t devHandle,
                     uint32_t timeousMs,
                     uBleGapScanCallback_t cb);
 
+/** As uBleGapScan() but with on-host filtering and batching of the
+ *  results, reducing the number of callbacks in a busy radio
+ *  environment: results below an RSSI threshold are dropped, repeats
+ *  of the same advertisement from the same address are suppressed for
+ *  a time and what is left is delivered in batches.  Since the scan is
+ *  synchronous, a batch window is checked when a result arrives and
+ *  the last batch is delivered when the scan ends.
+ *  Requires the BLE device to be in central mode.
+ *
+ * @param[in] devHandle   the handle of the u-blox BLE device.
+ * @param[in] discType    type of scan to perform.
+ * @param[in] activeScan  active or passive scan.
+ * @param[in] timeousMs   total time interval in milliseconds used for the scan.
+ * @param[in] pFilter     the filter to apply, cannot be NULL.
+ * @param[in] cb          a callback routine for the batches of results.
+ * @param[in] pParam      a parameter that will be passed to cb, may be NULL.
+ * @return                zero on success, on failure negative error code.
+ */
+int32_t uBleGapScanFiltered(uDeviceHandle_t devHandle,
+                            uBleGapDiscoveryType_t discType,
+                            bool activeScan,
+                            uint32_t timeousMs,
+                            const uBleGapScanFilter_t *pFilter,
+                            uBleGapScanBatchCallback_t cb,
+                            void *pParam);
+
 /** Try connecting to another peripheral BLE device.
  *  If a connection callback has been set via uBleGapSetConnectCallback() then
  *  this will be called when the connection has been completed.
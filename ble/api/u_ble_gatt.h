@@ -22,6 +22,8 @@
  * of another module should be included here; otherwise
  * please keep #includes to your .c files. */
 
+#include "u_ble_gap.h" // U_SHORT_RANGE_BT_ADDRESS_SIZE
+
 /** \addtogroup _BLE _Bluetooth Low Energy
  * @{
  */
@@ -29,6 +31,11 @@
 /** @file
  * @brief This header file defines the general BLE GATT APIs.
  *
+ * When in central mode the results of service and characteristic
+ * discovery may be cached, see uBleGattCacheEnable(), so that
+ * reconnecting to a peer whose GATT database has not changed does
+ * not require another discovery over the air.
+ *
  */
 
 #ifdef __cplusplus
@@ -39,10 +46,88 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The maximum length of a UUID string reported by discovery,
+ * including the terminator.
+ */
+#define U_BLE_GATT_UUID_MAX_LENGTH 33
+
+/** The length of the value of the Database Hash characteristic.
+ */
+#define U_BLE_GATT_DATABASE_HASH_LENGTH 16
+
+#ifndef U_BLE_GATT_CACHE_MAX_PEERS
+/** The number of peers whose GATT database is kept in the cache;
+ * when the cache is full the entry of the least recently connected
+ * peer that is not currently connected is reused.
+ */
+# define U_BLE_GATT_CACHE_MAX_PEERS 4
+#endif
+
+#ifndef U_BLE_GATT_CACHE_MAX_SERVICES
+/** The maximum number of services that can be cached for a peer;
+ * if a peer has more than this its services are not cached.
+ */
+# define U_BLE_GATT_CACHE_MAX_SERVICES 8
+#endif
+
+#ifndef U_BLE_GATT_CACHE_MAX_CHARS
+/** The maximum number of characteristics that can be cached for
+ * a peer; if a peer has more than this its characteristics are
+ * not cached.
+ */
+# define U_BLE_GATT_CACHE_MAX_CHARS 16
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** A cached service.
+ */
+typedef struct {
+    uint16_t startHandle;
+    uint16_t endHandle;
+    char uuid[U_BLE_GATT_UUID_MAX_LENGTH];
+} uBleGattCacheService_t;
+
+/** A cached characteristic.
+ */
+typedef struct {
+    uint16_t attrHandle;
+    uint16_t valueHandle;
+    uint8_t properties;
+    char uuid[U_BLE_GATT_UUID_MAX_LENGTH];
+} uBleGattCacheChar_t;
+
+/** The cached GATT database of a peer: this is what is passed to
+ * the save callback of uBleGattCacheEnable() and may be restored
+ * with uBleGattCachePreset(); it contains no pointers and so may be
+ * stored as it is, e.g. in flash.
+ */
+typedef struct {
+    char address[U_SHORT_RANGE_BT_ADDRESS_SIZE];  /**< the peer address, as
+                                                       reported on connection. */
+    bool servicesValid;                           /**< true if services[] is complete. */
+    size_t numServices;
+    uBleGattCacheService_t services[U_BLE_GATT_CACHE_MAX_SERVICES];
+    bool charsValid;                              /**< true if chars[] is complete. */
+    size_t numChars;
+    uBleGattCacheChar_t chars[U_BLE_GATT_CACHE_MAX_CHARS];
+    uint16_t databaseHashHandle;                  /**< the value handle of the Database
+                                                       Hash characteristic, zero if the
+                                                       peer does not have one. */
+    uint8_t databaseHash[U_BLE_GATT_DATABASE_HASH_LENGTH];
+} uBleGattCacheEntry_t;
+
+/** Callback called when the cached GATT database of a peer has been
+ * updated, so that the application may store it.
+ * @param[in]  pEntry  the cache entry, only valid for the duration
+ *                     of the callback.
+ * @param[in]  pParam  the parameter passed to uBleGattCacheEnable().
+ */
+typedef void (*uBleGattCacheSaveCallback_t)(const uBleGattCacheEntry_t *pEntry,
+                                            void *pParam);
+
 /** Callback from service discovery of a connected BLE device when in
  *  central mode.
  * @param[in]  connHandle  corresponding connection handle.
@@ -95,9 +180,56 @@ typedef void (*uBleGattWriteCallback_t)(uint8_t connHandle,
 
 /* Central (client) role GATT functions */
 
+/** Enable the cache of discovered GATT databases.  While it is enabled,
+ *  uBleGattDiscoverServices() and uBleGattDiscoverChar() record what they
+ *  discover for the connected peer and, when called again for that peer,
+ *  even on a later connection, report the cached results without
+ *  talking to the peer.  On the first discovery of each connection, if
+ *  the peer has a Database Hash characteristic, that is read (a single
+ *  exchange over the air) and, if it has changed, the cache entry is
+ *  discarded and discovery is performed as normal.  For peers without
+ *  a Database Hash call uBleGattCacheInvalidate() if their GATT database
+ *  might have changed, e.g. on receipt of a Service Changed indication.
+ *
+ *  The cache learns the address of a peer from the connection event, so
+ *  a connection callback must have been set with uBleGapSetConnectCallback()
+ *  for the cache to be used.  There is one cache, shared by all devices.
+ *
+ * @param[in] pSaveCb  a callback that will be called when a cache entry
+ *                     has been updated, e.g. so that it can be stored
+ *                     and restored with uBleGattCachePreset(); may be NULL.
+ * @param[in] pParam   a parameter that will be passed to pSaveCb, may
+ *                     be NULL.
+ * @return             zero on success, on failure negative error code.
+ */
+int32_t uBleGattCacheEnable(uBleGattCacheSaveCallback_t pSaveCb, void *pParam);
+
+/** Add an entry to the GATT cache, e.g. one passed to the save callback
+ *  of uBleGattCacheEnable() before a restart; any existing entry for the
+ *  same peer is replaced.  Must not be called while connected to that peer.
+ *
+ * @param[in] pEntry  the cache entry, cannot be NULL.
+ * @return            zero on success, on failure negative error code.
+ */
+int32_t uBleGattCachePreset(const uBleGattCacheEntry_t *pEntry);
+
+/** Discard the cached GATT database of a peer; the next discovery
+ *  will be performed over the air.
+ *
+ * @param[in] pAddress  the address of the peer, NULL to discard the
+ *                      whole cache.
+ * @return              zero on success, on failure negative error code.
+ */
+int32_t uBleGattCacheInvalidate(const char *pAddress);
+
+/** Disable the GATT cache and free its memory.
+ */
+void uBleGattCacheDisable();
+
 /** Do a enumeration (discovery) of all services in a connected peripheral
  *  when in central mode. The supplied callback will be called for each
- *  service found.
+ *  service found.  If the GATT cache is enabled (see uBleGattCacheEnable())
+ *  and holds the services of the peer they are reported from the cache.
  *
  * @param[in] devHandle   the handle of the u-blox BLE device.
  * @param[in] connHandle  the connection handle retrieved from uBleGapConnect().
@@ -110,7 +242,9 @@ int32_t uBleGattDiscoverServices(uDeviceHandle_t devHandle,
 
 /** Do a enumeration (discovery) of all characteristics in a connected peripheral
  *  when in central mode. The supplied callback will be called for each
- *  characteristic found.
+ *  characteristic found.  If the GATT cache is enabled (see
+ *  uBleGattCacheEnable()) and holds the characteristics of the peer they
+ *  are reported from the cache.
  *
  * @param[in] devHandle   the handle of the u-blox BLE device.
  * @param[in] connHandle  the connection handle retrieved from uBleGapConnect().
@@ -31,6 +31,13 @@
  * client and server. Minimal point to point implementation, only one connection
  * at the time is supported.
  *
+ * In addition to writing one characteristic value per call with
+ * uBleNusWrite(), a streaming mode may be started with
+ * uBleNusStreamStart(): data is then queued with uBleNusStreamWrite(),
+ * split into fragments that fit the ATT MTU of the link and sent
+ * without waiting for a response from the peer, while received data
+ * is collected in a ring buffer to be picked up with uBleNusStreamRead().
+ *
  */
 
 #ifdef __cplusplus
@@ -40,6 +47,43 @@ extern "C" {
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
+
+#ifndef U_BLE_NUS_STREAM_TX_BUFFER_SIZE
+/** The size of the transmit queue in streaming mode.
+ */
+# define U_BLE_NUS_STREAM_TX_BUFFER_SIZE 2048
+#endif
+
+#ifndef U_BLE_NUS_STREAM_RX_BUFFER_SIZE
+/** The size of the receive ring buffer in streaming mode.
+ */
+# define U_BLE_NUS_STREAM_RX_BUFFER_SIZE 2048
+#endif
+
+/** The default size of a fragment in streaming mode, which fits
+ * the default ATT MTU of 23 bytes.
+ */
+#define U_BLE_NUS_STREAM_FRAGMENT_SIZE_DEFAULT 20
+
+/** The largest size of a fragment in streaming mode, which fits
+ * an ATT MTU of 247 bytes.
+ */
+#define U_BLE_NUS_STREAM_FRAGMENT_SIZE_MAX 244
+
+#ifndef U_BLE_NUS_STREAM_TASK_STACK_SIZE_BYTES
+/** The stack size of the task that empties the transmit queue in
+ * streaming mode.
+ */
+# define U_BLE_NUS_STREAM_TASK_STACK_SIZE_BYTES (1536 + U_BLE_NUS_STREAM_FRAGMENT_SIZE_MAX)
+#endif
+
+#ifndef U_BLE_NUS_STREAM_TASK_PRIORITY
+/** The priority of the task that empties the transmit queue in
+ * streaming mode.
+ */
+# define U_BLE_NUS_STREAM_TASK_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -51,6 +95,17 @@ extern "C" {
 typedef void (*uBleNusReceiveCallback_t)(uint8_t *pValue,
                                          uint8_t valueLength);
 
+/** Data available callback for streaming mode, called from the
+ *  AT client URC task when data has been added to the receive
+ *  ring buffer; it should not block, just trigger a call to
+ *  uBleNusStreamRead() from somewhere else.
+ *  @param  numBytes    the number of bytes now in the receive
+ *                      ring buffer.
+ *  @param[in] pParam   the parameter passed to uBleNusStreamStart().
+ */
+typedef void (*uBleNusDataAvailableCallback_t)(size_t numBytes,
+                                               void *pParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -105,12 +160,55 @@ int32_t uBleNusWrite(const void *pValue, uint8_t valueLength);
  */
 int32_t uBleNusSetAdvData(uint8_t *pAdvData, uint8_t advDataSize);
 
-/** Close down possible NUS connection
+/** Close down possible NUS connection; this also stops streaming
+ *  mode if it was started.
  *
  * @return                    zero on success, on failure negative error code.
  */
 int32_t uBleNusDeInit();
 
+/** Start streaming mode; uBleNusInit() must have been called.  While
+ *  streaming, received data goes to the receive ring buffer rather than
+ *  to the callback given to uBleNusInit().
+ *
+ * @param fragmentSize   the maximum number of bytes to send in one go,
+ *                       which should be the ATT MTU of the link minus 3;
+ *                       zero for #U_BLE_NUS_STREAM_FRAGMENT_SIZE_DEFAULT,
+ *                       at most #U_BLE_NUS_STREAM_FRAGMENT_SIZE_MAX.
+ * @param[in] cb         a callback to be called when data has been
+ *                       received, may be NULL.
+ * @param[in] pParam     a parameter that will be passed to cb, may
+ *                       be NULL.
+ * @return               zero on success, on failure negative error code.
+ */
+int32_t uBleNusStreamStart(size_t fragmentSize,
+                           uBleNusDataAvailableCallback_t cb,
+                           void *pParam);
+
+/** Queue data for sending in streaming mode; this does not block, the
+ *  data is sent by a task of its own.
+ *
+ * @param[in] pData  the data to send.
+ * @param length     the number of bytes at pData.
+ * @return           on success the number of bytes queued, which will be
+ *                   less than length if the transmit queue is full, else
+ *                   negative error code.
+ */
+int32_t uBleNusStreamWrite(const void *pData, size_t length);
+
+/** Read received data in streaming mode.
+ *
+ * @param[out] pData  a place to put the data.
+ * @param length      the amount of storage at pData.
+ * @return            on success the number of bytes read, else
+ *                    negative error code.
+ */
+int32_t uBleNusStreamRead(void *pData, size_t length);
+
+/** Stop streaming mode; data that has not yet been sent is thrown away.
+ */
+void uBleNusStreamStop();
+
 #ifdef __cplusplus
 }
 #endif
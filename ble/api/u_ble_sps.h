@@ -109,6 +109,29 @@ extern "C" {
 #define U_BLE_SPS_CONN_PARAM_LINK_LOSS_TMO_DEFAULT 2000
 #endif
 
+/** Link layer payload length requested with Data Length Extension
+ *  when high throughput is enabled, see
+ *  uBleSpsEnableHighThroughputOnNext(); 251 is the maximum, enough
+ *  for one notification of the maximum MTU to go in one packet.
+ */
+#ifndef U_BLE_SPS_HIGH_THROUGHPUT_DATA_LENGTH
+#define U_BLE_SPS_HIGH_THROUGHPUT_DATA_LENGTH 251
+#endif
+
+/** Minimum connection interval requested when high throughput
+ *  is enabled.
+ */
+#ifndef U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MIN
+#define U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MIN 12
+#endif
+
+/** Maximum connection interval requested when high throughput
+ *  is enabled.
+ */
+#ifndef U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MAX
+#define U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MAX 24
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -326,6 +349,28 @@ int32_t uBleSpsPresetSpsServerHandles(uDeviceHandle_t devHandle, const uBleSpsHa
  */
 int32_t uBleSpsDisableFlowCtrlOnNext(uDeviceHandle_t devHandle);
 
+/** Enable high throughput for the next SPS connection, whether
+ * it is one we make with uBleSpsConnectSps() or one a remote
+ * device makes to us.
+ *
+ * High throughput is disabled by default.  When enabled, once the
+ * MTU has been exchanged, the link is asked to use Data Length
+ * Extension, with #U_BLE_SPS_HIGH_THROUGHPUT_DATA_LENGTH octets,
+ * the 2M PHY and a connection interval between
+ * #U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MIN and
+ * #U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MAX, so that each notification
+ * of a full MTU goes in one link layer packet and several of them
+ * go in each connection event.  What is actually used depends on
+ * the remote device.  The lower-power default link is kept if this
+ * is not called.  Only supported on open CPU, i.e. when the BLE
+ * stack is on this MCU.
+ *
+ * @param devHandle the handle of the u-blox device.
+ *
+ * @return          zero on success, on failure negative error code.
+ */
+int32_t uBleSpsEnableHighThroughputOnNext(uDeviceHandle_t devHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,494 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Implementation of the BLE central polling scheduler.
+ */
+
+#ifndef U_CFG_BLE_MODULE_INTERNAL
+
+#ifdef U_CFG_OVERRIDE
+#include "u_cfg_override.h"  // For a customer's configuration override
+#endif
+
+#include "stdbool.h"
+#include "stddef.h"  // NULL, size_t etc.
+#include "stdint.h"  // int32_t etc.
+#include "string.h"  // memset(), strncpy(), strncmp()
+#include "u_error_common.h"
+#include "u_at_client.h"
+#include "u_ble.h"
+#include "u_ble_cfg.h"
+#include "u_ble_extmod_private.h"
+#include "u_ble_gap.h"
+#include "u_ble_gatt.h"
+#include "u_ble_private.h"
+#include "u_cfg_sw.h"
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_short_range.h"
+#include "u_short_range_module_type.h"
+#include "u_short_range_private.h"
+
+#include "u_ble_central.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_BLE_CENTRAL_IDLE_WAIT_MS
+/** How long uBleCentralPoll() waits when there is nothing for it
+ * to do but wait for a connection to be established or dropped.
+ */
+# define U_BLE_CENTRAL_IDLE_WAIT_MS 20
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** A peer, including its cache of characteristic value handles.
+ */
+typedef struct {
+    char address[U_SHORT_RANGE_BT_ADDRESS_SIZE];
+    char charUuids[U_BLE_CENTRAL_MAX_CHARS_PER_PEER][U_BLE_CENTRAL_UUID_MAX_LENGTH];
+    size_t numChars;
+    uint16_t valueHandles[U_BLE_CENTRAL_MAX_CHARS_PER_PEER]; /**< zero if not known. */
+    volatile int32_t connHandle;  /**< -1 if not connected. */
+    bool disconnecting;
+    bool done;                    /**< true once dealt with in this poll. */
+    int32_t lastReadMs;
+} uBleCentralPeer_t;
+
+/** The context of the scheduler.
+ */
+typedef struct {
+    uDeviceHandle_t devHandle;
+    uBleCentralReadCallback_t pCb;
+    void *pCbParam;
+    uBleCentralPeer_t peers[U_BLE_CENTRAL_MAX_PEERS];
+    size_t numPeers;
+    volatile int32_t connectPeer;   /**< the peer being connected, -1 if none. */
+    int32_t connectStartMs;
+    volatile int32_t connectState;  /**< 0 pending, 1 connected, -1 failed. */
+    volatile int32_t connectHandle;
+    volatile int32_t strayHandle;   /**< a connection that came up too late, -1 if none. */
+    int32_t discoverPeer;
+} uBleCentralContext_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+static uBleCentralContext_t *gpContext = NULL;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Called from the URC task: only state is updated here, all of the
+// AT commands are issued by uBleCentralPoll().  Since only one
+// connection is ever being established at a time, a connect event
+// must belong to the peer being connected.
+static void connectCallback(int32_t connHandle, char *pAddress, bool connected)
+{
+    uBleCentralContext_t *pContext = gpContext;
+    bool found = false;
+
+    (void)pAddress;
+    if (pContext != NULL) {
+        if (connected) {
+            if ((pContext->connectPeer >= 0) && (pContext->connectState == 0)) {
+                pContext->connectHandle = connHandle;
+                pContext->connectState = 1;
+            } else {
+                pContext->strayHandle = connHandle;
+            }
+        } else {
+            for (size_t x = 0; x < pContext->numPeers; x++) {
+                if (pContext->peers[x].connHandle == connHandle) {
+                    pContext->peers[x].connHandle = -1;
+                    found = true;
+                }
+            }
+            if (!found && (pContext->connectPeer >= 0) && (pContext->connectState == 0)) {
+                // The connection attempt failed
+                pContext->connectState = -1;
+            }
+        }
+    }
+}
+
+static void discoverCharacteristics(uint8_t connHandle, uint16_t attrHandle,
+                                    uint8_t properties, uint16_t valueHandle,
+                                    char *pUuid)
+{
+    uBleCentralContext_t *pContext = gpContext;
+    uBleCentralPeer_t *pPeer;
+
+    (void)connHandle;
+    (void)attrHandle;
+    (void)properties;
+    if ((pContext != NULL) && (pContext->discoverPeer >= 0)) {
+        pPeer = &(pContext->peers[pContext->discoverPeer]);
+        for (size_t x = 0; x < pPeer->numChars; x++) {
+            if (strncmp(pUuid, pPeer->charUuids[x], strlen(pPeer->charUuids[x])) == 0) {
+                pPeer->valueHandles[x] = valueHandle;
+            }
+        }
+    }
+}
+
+// Report an error for all of the characteristics of a peer.
+static void failPeer(uBleCentralContext_t *pContext, int32_t peerIndex, int32_t errorCode)
+{
+    uBleCentralPeer_t *pPeer = &(pContext->peers[peerIndex]);
+
+    for (size_t x = 0; x < pPeer->numChars; x++) {
+        pContext->pCb(peerIndex, x, errorCode, NULL, pContext->pCbParam);
+    }
+    pPeer->done = true;
+}
+
+// Read all of the characteristics of a connected peer, discovering
+// their value handles first if they are not already known; returns
+// true if all of the reads were successful.
+static bool readPeer(uBleCentralContext_t *pContext, int32_t peerIndex)
+{
+    uBleCentralPeer_t *pPeer = &(pContext->peers[peerIndex]);
+    int32_t connHandle = pPeer->connHandle;
+    uint8_t value[U_BLE_CENTRAL_VALUE_MAX_LENGTH];
+    bool discovered = false;
+    bool forget = false;
+    bool success = true;
+    int32_t x;
+
+    for (size_t y = 0; (y < pPeer->numChars) && !discovered; y++) {
+        if (pPeer->valueHandles[y] == 0) {
+            pContext->discoverPeer = peerIndex;
+            uBleGattDiscoverChar(pContext->devHandle, connHandle, discoverCharacteristics);
+            pContext->discoverPeer = -1;
+            discovered = true;
+        }
+    }
+
+    for (size_t y = 0; y < pPeer->numChars; y++) {
+        x = (int32_t)U_BLE_ERROR_NOT_FOUND;
+        if (pPeer->valueHandles[y] != 0) {
+            x = uBleGattReadValue(pContext->devHandle, connHandle,
+                                  pPeer->valueHandles[y], value, sizeof(value));
+            if ((x < 0) && !discovered && (pPeer->connHandle >= 0)) {
+                // Still connected, so the cached handles may be stale
+                forget = true;
+            }
+        }
+        if (x < 0) {
+            success = false;
+        }
+        pContext->pCb(peerIndex, y, x, (x >= 0) ? value : NULL, pContext->pCbParam);
+    }
+
+    if (forget) {
+        // Discover again next time
+        memset(pPeer->valueHandles, 0, sizeof(pPeer->valueHandles));
+    }
+    pPeer->lastReadMs = uPortGetTickTimeMs();
+    pPeer->done = true;
+
+    return success;
+}
+
+// Find a peer that is connected, has been dealt with in this poll
+// and is not already being disconnected, least recently read first.
+static int32_t findDisconnectCandidate(uBleCentralContext_t *pContext)
+{
+    int32_t peerIndex = -1;
+    uBleCentralPeer_t *pPeer;
+
+    for (size_t x = 0; x < pContext->numPeers; x++) {
+        pPeer = &(pContext->peers[x]);
+        if ((pPeer->connHandle >= 0) && pPeer->done && !pPeer->disconnecting &&
+            ((peerIndex < 0) ||
+             (pPeer->lastReadMs - pContext->peers[peerIndex].lastReadMs < 0))) {
+            peerIndex = (int32_t)x;
+        }
+    }
+
+    return peerIndex;
+}
+
+// Start connecting to the next peer that needs it, if there is room;
+// returns true if a connection could not even be started, in which
+// case that peer has been dealt with.
+static bool connectNext(uBleCentralContext_t *pContext)
+{
+    int32_t peerIndex = -1;
+    size_t numConnections = 0;
+    uBleCentralPeer_t *pPeer;
+    bool failed = false;
+    int32_t x;
+
+    for (size_t y = 0; y < pContext->numPeers; y++) {
+        pPeer = &(pContext->peers[y]);
+        if (pPeer->connHandle >= 0) {
+            numConnections++;
+        } else if (!pPeer->done && (peerIndex < 0)) {
+            peerIndex = (int32_t)y;
+        }
+    }
+
+    if (peerIndex >= 0) {
+        if (numConnections >= U_BLE_CENTRAL_MAX_CONNECTIONS) {
+            // Make room: the disconnect event will free the slot
+            x = findDisconnectCandidate(pContext);
+            if (x >= 0) {
+                pContext->peers[x].disconnecting = true;
+                uBleGapDisconnect(pContext->devHandle, pContext->peers[x].connHandle);
+            }
+        } else {
+            pContext->connectState = 0;
+            pContext->connectStartMs = uPortGetTickTimeMs();
+            pContext->connectPeer = peerIndex;
+            x = uBleGapConnect(pContext->devHandle, pContext->peers[peerIndex].address);
+            if (x < 0) {
+                pContext->connectPeer = -1;
+                failPeer(pContext, peerIndex, x);
+                failed = true;
+            }
+        }
+    }
+
+    return failed;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+int32_t uBleCentralStart(uDeviceHandle_t devHandle,
+                         uBleCentralReadCallback_t cb,
+                         void *pParam)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+    uBleCentralContext_t *pContext;
+
+    if ((gpContext == NULL) && (cb != NULL)) {
+        errorCode = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+        pContext = (uBleCentralContext_t *)pUPortMalloc(sizeof(uBleCentralContext_t));
+        if (pContext != NULL) {
+            memset(pContext, 0, sizeof(*pContext));
+            pContext->devHandle = devHandle;
+            pContext->pCb = cb;
+            pContext->pCbParam = pParam;
+            pContext->connectPeer = -1;
+            pContext->strayHandle = -1;
+            pContext->discoverPeer = -1;
+            gpContext = pContext;
+            errorCode = uBleGapSetConnectCallback(devHandle, connectCallback);
+            if (errorCode != (int32_t)U_ERROR_COMMON_SUCCESS) {
+                gpContext = NULL;
+                uPortFree(pContext);
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+int32_t uBleCentralAddPeer(const char *pAddress,
+                           const char *const *ppCharUuids,
+                           size_t numChars)
+{
+    int32_t errorCodeOrIndex = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleCentralContext_t *pContext = gpContext;
+    uBleCentralPeer_t *pPeer;
+
+    if (pContext != NULL) {
+        errorCodeOrIndex = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pAddress != NULL) && (ppCharUuids != NULL) && (numChars > 0) &&
+            (numChars <= U_BLE_CENTRAL_MAX_CHARS_PER_PEER)) {
+            errorCodeOrIndex = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+            if (pContext->numPeers < U_BLE_CENTRAL_MAX_PEERS) {
+                pPeer = &(pContext->peers[pContext->numPeers]);
+                memset(pPeer, 0, sizeof(*pPeer));
+                strncpy(pPeer->address, pAddress, sizeof(pPeer->address) - 1);
+                for (size_t x = 0; x < numChars; x++) {
+                    strncpy(pPeer->charUuids[x], ppCharUuids[x], sizeof(pPeer->charUuids[x]) - 1);
+                }
+                pPeer->numChars = numChars;
+                pPeer->connHandle = -1;
+                errorCodeOrIndex = (int32_t)pContext->numPeers;
+                pContext->numPeers++;
+            }
+        }
+    }
+
+    return errorCodeOrIndex;
+}
+
+int32_t uBleCentralGetHandles(int32_t peerIndex,
+                              uint16_t *pValueHandles,
+                              size_t numHandles)
+{
+    int32_t errorCodeOrNum = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleCentralContext_t *pContext = gpContext;
+    uBleCentralPeer_t *pPeer;
+
+    if (pContext != NULL) {
+        errorCodeOrNum = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((peerIndex >= 0) && ((size_t)peerIndex < pContext->numPeers) &&
+            (pValueHandles != NULL)) {
+            pPeer = &(pContext->peers[peerIndex]);
+            if (numHandles > pPeer->numChars) {
+                numHandles = pPeer->numChars;
+            }
+            memcpy(pValueHandles, pPeer->valueHandles, numHandles * sizeof(uint16_t));
+            errorCodeOrNum = (int32_t)numHandles;
+        }
+    }
+
+    return errorCodeOrNum;
+}
+
+int32_t uBleCentralPresetHandles(int32_t peerIndex,
+                                 const uint16_t *pValueHandles,
+                                 size_t numHandles)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleCentralContext_t *pContext = gpContext;
+    uBleCentralPeer_t *pPeer;
+
+    if (pContext != NULL) {
+        errorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((peerIndex >= 0) && ((size_t)peerIndex < pContext->numPeers) &&
+            (pValueHandles != NULL) &&
+            (numHandles == pContext->peers[peerIndex].numChars)) {
+            pPeer = &(pContext->peers[peerIndex]);
+            memcpy(pPeer->valueHandles, pValueHandles, numHandles * sizeof(uint16_t));
+            errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    return errorCode;
+}
+
+int32_t uBleCentralPoll(int32_t timeoutMs)
+{
+    int32_t errorCodeOrNum = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleCentralContext_t *pContext = gpContext;
+    uBleCentralPeer_t *pPeer;
+    int32_t startTimeMs = uPortGetTickTimeMs();
+    size_t numDone = 0;
+    int32_t connectPeer;
+    int32_t x;
+    bool busy;
+
+    if (pContext != NULL) {
+        errorCodeOrNum = 0;
+        for (size_t y = 0; y < pContext->numPeers; y++) {
+            pContext->peers[y].done = false;
+        }
+        while ((numDone < pContext->numPeers) &&
+               (uPortGetTickTimeMs() - startTimeMs < timeoutMs)) {
+            busy = false;
+            x = pContext->strayHandle;
+            if (x >= 0) {
+                // A connection we gave up on arrived after all
+                pContext->strayHandle = -1;
+                uBleGapDisconnect(pContext->devHandle, x);
+            }
+            connectPeer = pContext->connectPeer;
+            if (connectPeer >= 0) {
+                pPeer = &(pContext->peers[connectPeer]);
+                if (pContext->connectState == 1) {
+                    pPeer->disconnecting = false;
+                    pPeer->connHandle = pContext->connectHandle;
+                    pContext->connectPeer = -1;
+                } else if ((pContext->connectState < 0) ||
+                           (uPortGetTickTimeMs() - pContext->connectStartMs >
+                            U_BLE_CENTRAL_CONNECT_TIMEOUT_MS)) {
+                    pContext->connectPeer = -1;
+                    if (!pPeer->done) {
+                        x = (int32_t)U_ERROR_COMMON_TIMEOUT;
+                        if (pContext->connectState < 0) {
+                            x = (int32_t)U_BLE_ERROR_NOT_FOUND;
+                        }
+                        failPeer(pContext, connectPeer, x);
+                        numDone++;
+                    }
+                }
+            }
+            if ((pContext->connectPeer < 0) && connectNext(pContext)) {
+                numDone++;
+            }
+            // Read one connected peer per pass so that connection
+            // events are picked up promptly; the reads overlap with
+            // any connection being established
+            for (size_t y = 0; (y < pContext->numPeers) && !busy; y++) {
+                pPeer = &(pContext->peers[y]);
+                if (!pPeer->done && (pPeer->connHandle >= 0) &&
+                    ((int32_t)y != pContext->connectPeer)) {
+                    if (readPeer(pContext, (int32_t)y)) {
+                        errorCodeOrNum++;
+                    }
+                    numDone++;
+                    busy = true;
+                }
+            }
+            if (!busy) {
+                uPortTaskBlock(U_BLE_CENTRAL_IDLE_WAIT_MS);
+            }
+        }
+    }
+
+    return errorCodeOrNum;
+}
+
+int32_t uBleCentralStop()
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+    uBleCentralContext_t *pContext = gpContext;
+    int32_t x;
+
+    if (pContext != NULL) {
+        for (size_t y = 0; y < pContext->numPeers; y++) {
+            x = pContext->peers[y].connHandle;
+            if (x >= 0) {
+                uBleGapDisconnect(pContext->devHandle, x);
+            }
+        }
+        x = pContext->strayHandle;
+        if (x >= 0) {
+            uBleGapDisconnect(pContext->devHandle, x);
+        }
+        errorCode = uBleGapSetConnectCallback(pContext->devHandle, NULL);
+        gpContext = NULL;
+        uPortFree(pContext);
+    }
+
+    return errorCode;
+}
+
+#endif // U_CFG_BLE_MODULE_INTERNAL
+
+// End of file
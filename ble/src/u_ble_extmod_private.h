@@ -42,6 +42,21 @@ extern "C" {
  */
 int32_t uBlePrivateGetRole(const uAtClientHandle_t atHandle);
 
+/** Tell the GATT cache that a connection has been made; called
+ * from the connection URC.
+ *
+ * @param connHandle  the connection handle.
+ * @param[in] pAddress the address of the peer.
+ */
+void uBleGattPrivateCacheConnected(int32_t connHandle, const char *pAddress);
+
+/** Tell the GATT cache that a connection has been closed; called
+ * from the disconnection URC.
+ *
+ * @param connHandle  the connection handle.
+ */
+void uBleGattPrivateCacheDisconnected(int32_t connHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -70,6 +70,26 @@ typedef enum { BLE_ROLE_ANY,
                BLE_ROLE_PERIPHERAL
              } bleRoleCheck_t;
 
+/** An entry in the de-duplication table of uBleGapScanFiltered().
+ */
+typedef struct {
+    uint32_t hash;  /**< hash of the address and advertisement data. */
+    int32_t timeMs; /**< when a result with this hash was last reported. */
+    bool valid;
+} uBleGapScanDedup_t;
+
+/** Context for uBleGapScanFiltered().
+ */
+typedef struct {
+    const uBleGapScanFilter_t *pFilter;
+    uBleGapScanBatchCallback_t pCb;
+    void *pCbParam;
+    uBleGapScanDedup_t dedup[U_BLE_GAP_SCAN_DEDUP_TABLE_SIZE];
+    uBleScanResult_t *pResults; /**< the current batch. */
+    size_t numResults;
+    int32_t batchStartMs;
+} uBleGapScanFilterContext_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -118,6 +138,7 @@ static void connectUrc(uAtClientHandle_t atHandle, void *pParameter)
     int32_t connHandle = uAtClientReadInt(atHandle);
     (void)uAtClientReadInt(atHandle);
     uAtClientReadString(atHandle, address, sizeof(address), false);
+    uBleGattPrivateCacheConnected(connHandle, address);
     cb(connHandle, address, true);
 }
 
@@ -125,6 +146,7 @@ static void disconnectUrc(uAtClientHandle_t atHandle, void *pParameter)
 {
     uBleGapConnectCallback_t cb = (uBleGapConnectCallback_t)pParameter;
     int32_t connHandle = uAtClientReadInt(atHandle);
+    uBleGattPrivateCacheDisconnected(connHandle);
     cb(connHandle, NULL, false);
 }
 
@@ -146,6 +168,186 @@ static int32_t setConnectUrc(uAtClientHandle_t atHandle, uBleGapConnectCallback_
     return errorCode;
 }
 
+// Perform a scan, passing each result to pHandler.
+static int32_t scan(uDeviceHandle_t devHandle,
+                    uBleGapDiscoveryType_t discType,
+                    bool activeScan,
+                    uint32_t timeousMs,
+                    bool (*pHandler)(uBleScanResult_t *, void *),
+                    void *pHandlerParam)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uShortRangePrivateInstance_t *pInstance;
+    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+        pInstance = pUShortRangePrivateGetInstance(devHandle);
+        errorCode = (int32_t)U_BLE_ERROR_INVALID_MODE;
+        if (validateBle(pInstance, BLE_ROLE_CENTRAL)) {
+            uAtClientHandle_t atHandle = pInstance->atHandle;
+            uAtClientLock(atHandle);
+            // Set the timeout for the AT response and thereby the scan timeout
+            uAtClientTimeoutSet(atHandle, timeousMs + 500);
+
+            // Start the scan
+            uAtClientCommandStart(atHandle, "AT+UBTD=");
+            uAtClientWriteInt(atHandle, discType);
+            uAtClientWriteInt(atHandle, activeScan ? 1 : 2);
+            uAtClientWriteInt(atHandle, timeousMs);
+            uAtClientCommandStop(atHandle);
+
+            // Get the responses synchronously
+            uBleScanResult_t result;
+            bool ok = true;
+            bool keepGoing = true;
+            while (keepGoing && uAtClientResponseStart(atHandle, "+UBTD:") == 0) {
+                errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+                ok = uAtClientReadString(atHandle,
+                                         result.address,
+                                         sizeof(result.address),
+                                         false) == (sizeof(result.address) - 1);
+                result.rssi = uAtClientReadInt(atHandle);
+                ok = ok && uAtClientErrorGet(atHandle) == 0;
+                ok = ok && uAtClientReadString(atHandle,
+                                               result.name,
+                                               sizeof(result.name),
+                                               false) >= 0;
+                result.dataType = uAtClientReadInt(atHandle);
+                ok = ok && (result.dataType == 1 || result.dataType == 2);
+                if (ok) {
+                    ok = false;
+                    int32_t dataLength = uAtClientReadHexData(atHandle, result.data, sizeof(result.data));
+                    if (dataLength >= 0) {
+                        result.dataLength = dataLength;
+                        ok = true;
+                    }
+                }
+                if (ok) {
+                    keepGoing = pHandler(&result, pHandlerParam);
+                }
+            }
+            uAtClientResponseStop(atHandle);
+            uAtClientUnlock(atHandle);
+        }
+        uShortRangeUnlock();
+    }
+    return errorCode;
+}
+
+// Pass a scan result straight to the application callback.
+static bool scanResultHandler(uBleScanResult_t *pResult, void *pParam)
+{
+    bool keepGoing = true;
+    uBleGapScanCallback_t cb = (uBleGapScanCallback_t)pParam;
+
+    if (cb) {
+        keepGoing = cb(pResult);
+    }
+
+    return keepGoing;
+}
+
+// FNV-1a hash a block of memory into hash.
+static uint32_t hashAdd(uint32_t hash, const void *pData, size_t length)
+{
+    const uint8_t *pByte = (const uint8_t *) pData;
+
+    for (size_t x = 0; x < length; x++) {
+        hash = (hash ^ *pByte) * 16777619UL;
+        pByte++;
+    }
+
+    return hash;
+}
+
+// Return true if a scan result has been reported too recently
+// to be reported again, else record that it is being reported.
+static bool scanFilterIsDuplicate(uBleGapScanFilterContext_t *pContext,
+                                  const uBleScanResult_t *pResult, int32_t nowMs)
+{
+    bool isDuplicate = false;
+    uBleGapScanDedup_t *pDedup = NULL;
+    uBleGapScanDedup_t *pTmp;
+    uint32_t hash = 2166136261UL;
+
+    hash = hashAdd(hash, pResult->address, strlen(pResult->address));
+    hash = hashAdd(hash, &(pResult->dataType), sizeof(pResult->dataType));
+    hash = hashAdd(hash, pResult->data, pResult->dataLength);
+    for (size_t x = 0; (x < U_BLE_GAP_SCAN_DEDUP_TABLE_SIZE) && (pDedup == NULL); x++) {
+        pTmp = &(pContext->dedup[x]);
+        if (pTmp->valid && (pTmp->hash == hash)) {
+            pDedup = pTmp;
+        }
+    }
+    if (pDedup == NULL) {
+        // Not seen before: use an empty entry or the oldest
+        for (size_t x = 0; x < U_BLE_GAP_SCAN_DEDUP_TABLE_SIZE; x++) {
+            pTmp = &(pContext->dedup[x]);
+            if ((pDedup == NULL) || (pDedup->valid &&
+                                     (!pTmp->valid || (pTmp->timeMs - pDedup->timeMs < 0)))) {
+                pDedup = pTmp;
+            }
+        }
+    } else if (nowMs - pDedup->timeMs < pContext->pFilter->dedupTtlMs) {
+        isDuplicate = true;
+    }
+    if (!isDuplicate) {
+        // The time is only refreshed when a result is let through,
+        // so that a device that keeps advertising the same thing is
+        // reported once every dedupTtlMs
+        pDedup->hash = hash;
+        pDedup->timeMs = nowMs;
+        pDedup->valid = true;
+    }
+
+    return isDuplicate;
+}
+
+// Deliver the current batch of scan results, if there is one.
+static bool scanFilterFlush(uBleGapScanFilterContext_t *pContext)
+{
+    bool keepGoing = true;
+
+    if (pContext->numResults > 0) {
+        keepGoing = pContext->pCb(pContext->pResults, pContext->numResults,
+                                  pContext->pCbParam);
+        pContext->numResults = 0;
+    }
+
+    return keepGoing;
+}
+
+// Filter a scan result and add it to the current batch, delivering
+// the batch if it is full or its window has expired.
+static bool scanFilterHandler(uBleScanResult_t *pResult, void *pParam)
+{
+    uBleGapScanFilterContext_t *pContext = (uBleGapScanFilterContext_t *)pParam;
+    const uBleGapScanFilter_t *pFilter = pContext->pFilter;
+    int32_t nowMs = uPortGetTickTimeMs();
+    size_t x = 0;
+    bool keepGoing = true;
+
+    if ((pResult->rssi >= pFilter->rssiMin) &&
+        ((pFilter->dedupTtlMs <= 0) || !scanFilterIsDuplicate(pContext, pResult, nowMs))) {
+        if (pContext->numResults == 0) {
+            pContext->batchStartMs = nowMs;
+        }
+        // One result per address in a batch, the most recent
+        while ((x < pContext->numResults) &&
+               (strcmp(pContext->pResults[x].address, pResult->address) != 0)) {
+            x++;
+        }
+        pContext->pResults[x] = *pResult;
+        if (x == pContext->numResults) {
+            pContext->numResults++;
+        }
+        if ((pContext->numResults >= pFilter->maxBatchResults) ||
+            (nowMs - pContext->batchStartMs >= pFilter->batchWindowMs)) {
+            keepGoing = scanFilterFlush(pContext);
+        }
+    }
+
+    return keepGoing;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -203,59 +405,42 @@ int32_t uBleGapScan(uDeviceHandle_t devHandle,
                     uint32_t timeousMs,
                     uBleGapScanCallback_t cb)
 {
-    int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
-    uShortRangePrivateInstance_t *pInstance;
-    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
-        pInstance = pUShortRangePrivateGetInstance(devHandle);
-        errorCode = (int32_t)U_BLE_ERROR_INVALID_MODE;
-        if (validateBle(pInstance, BLE_ROLE_CENTRAL)) {
-            uAtClientHandle_t atHandle = pInstance->atHandle;
-            uAtClientLock(atHandle);
-            // Set the timeout for the AT response and thereby the scan timeout
-            uAtClientTimeoutSet(atHandle, timeousMs + 500);
+    return scan(devHandle, discType, activeScan, timeousMs,
+                scanResultHandler, (void *)cb);
+}
 
-            // Start the scan
-            uAtClientCommandStart(atHandle, "AT+UBTD=");
-            uAtClientWriteInt(atHandle, discType);
-            uAtClientWriteInt(atHandle, activeScan ? 1 : 2);
-            uAtClientWriteInt(atHandle, timeousMs);
-            uAtClientCommandStop(atHandle);
+int32_t uBleGapScanFiltered(uDeviceHandle_t devHandle,
+                            uBleGapDiscoveryType_t discType,
+                            bool activeScan,
+                            uint32_t timeousMs,
+                            const uBleGapScanFilter_t *pFilter,
+                            uBleGapScanBatchCallback_t cb,
+                            void *pParam)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+    uBleGapScanFilterContext_t *pContext;
 
-            // Get the responses synchronously
-            uBleScanResult_t result;
-            bool ok = true;
-            bool keepGoing = true;
-            while (keepGoing && uAtClientResponseStart(atHandle, "+UBTD:") == 0) {
-                errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
-                ok = uAtClientReadString(atHandle,
-                                         result.address,
-                                         sizeof(result.address),
-                                         false) == (sizeof(result.address) - 1);
-                result.rssi = uAtClientReadInt(atHandle);
-                ok = ok && uAtClientErrorGet(atHandle) == 0;
-                ok = ok && uAtClientReadString(atHandle,
-                                               result.name,
-                                               sizeof(result.name),
-                                               false) >= 0;
-                result.dataType = uAtClientReadInt(atHandle);
-                ok = ok && (result.dataType == 1 || result.dataType == 2);
-                if (ok) {
-                    ok = false;
-                    int32_t dataLength = uAtClientReadHexData(atHandle, result.data, sizeof(result.data));
-                    if (dataLength >= 0) {
-                        result.dataLength = dataLength;
-                        ok = true;
-                    }
-                }
-                if (ok && cb) {
-                    keepGoing = cb(&result);
-                }
-            }
-            uAtClientResponseStop(atHandle);
-            uAtClientUnlock(atHandle);
+    if ((pFilter != NULL) && (pFilter->maxBatchResults > 0) && (cb != NULL)) {
+        errorCode = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+        // The batch follows the context in the same allocation
+        pContext = (uBleGapScanFilterContext_t *)pUPortMalloc(sizeof(*pContext) +
+                                                              (pFilter->maxBatchResults *
+                                                               sizeof(uBleScanResult_t)));
+        if (pContext != NULL) {
+            memset(pContext, 0, sizeof(*pContext));
+            pContext->pFilter = pFilter;
+            pContext->pCb = cb;
+            pContext->pCbParam = pParam;
+            pContext->pResults = (uBleScanResult_t *)(pContext + 1);
+            errorCode = scan(devHandle, discType, activeScan, timeousMs,
+                             scanFilterHandler, pContext);
+            // Deliver whatever is left; if the application stopped
+            // the scan there will be nothing
+            scanFilterFlush(pContext);
+            uPortFree(pContext);
         }
-        uShortRangeUnlock();
     }
+
     return errorCode;
 }
 
@@ -61,25 +61,153 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The UUID of the Database Hash characteristic, as reported
+ * by discovery.
+ */
+#define U_BLE_GATT_DATABASE_HASH_UUID "2B2A"
+
+#ifndef U_BLE_GATT_URC_VALUE_MAX_LENGTH
+/** The largest characteristic value that will be passed on from
+ * a notification or write URC, enough for an ATT MTU of 247 bytes.
+ */
+# define U_BLE_GATT_URC_VALUE_MAX_LENGTH 244
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** A peer in the GATT cache.
+ */
+typedef struct {
+    uBleGattCacheEntry_t entry;
+    bool inUse;
+    volatile int32_t connHandle; /**< -1 if not connected. */
+    bool checked;                /**< true once the database hash has been
+                                      checked on this connection. */
+    int32_t connectedTimeMs;
+} uBleGattCachePeer_t;
+
+/** The GATT cache: peers[] is protected by mutex, except that the
+ * entry of a connected peer is only ever written by the discovery
+ * functions, since a connected peer is never reused.
+ */
+typedef struct {
+    uPortMutexHandle_t mutex;
+    uBleGattCacheSaveCallback_t pSaveCb;
+    void *pSaveCbParam;
+    uBleGattCachePeer_t peers[U_BLE_GATT_CACHE_MAX_PEERS];
+} uBleGattCache_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/** The GATT cache, NULL if not enabled.
+ */
+static uBleGattCache_t *gpCache = NULL;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Clear out the GATT database of a cached peer, leaving the address.
+static void cacheClear(uBleGattCacheEntry_t *pEntry)
+{
+    pEntry->servicesValid = false;
+    pEntry->numServices = 0;
+    pEntry->charsValid = false;
+    pEntry->numChars = 0;
+    pEntry->databaseHashHandle = 0;
+}
+
+// Find the peer with the given address or, if there is none, a
+// peer that can be reused: unused, else the least recently connected
+// that is not connected; must be called with the cache mutex locked.
+static uBleGattCachePeer_t *pCacheFindAddress(uBleGattCache_t *pCache,
+                                              const char *pAddress)
+{
+    uBleGattCachePeer_t *pPeer = NULL;
+    uBleGattCachePeer_t *pTmp;
+
+    for (size_t x = 0; (x < U_BLE_GATT_CACHE_MAX_PEERS) && (pPeer == NULL); x++) {
+        pTmp = &(pCache->peers[x]);
+        if (pTmp->inUse &&
+            (strncmp(pTmp->entry.address, pAddress, sizeof(pTmp->entry.address)) == 0)) {
+            pPeer = pTmp;
+        }
+    }
+    for (size_t x = 0; (x < U_BLE_GATT_CACHE_MAX_PEERS) && (pPeer == NULL); x++) {
+        if (!pCache->peers[x].inUse) {
+            pPeer = &(pCache->peers[x]);
+        }
+    }
+    if (pPeer == NULL) {
+        for (size_t x = 0; x < U_BLE_GATT_CACHE_MAX_PEERS; x++) {
+            pTmp = &(pCache->peers[x]);
+            if ((pTmp->connHandle < 0) &&
+                ((pPeer == NULL) || (pTmp->connectedTimeMs - pPeer->connectedTimeMs < 0))) {
+                pPeer = pTmp;
+            }
+        }
+    }
+
+    return pPeer;
+}
+
+// Get the cached peer for a connection, checking its database
+// hash if that has not yet been done on this connection; returns
+// NULL if the cache is not enabled or the peer is not known.
+static uBleGattCachePeer_t *pCacheGet(uDeviceHandle_t devHandle, int32_t connHandle)
+{
+    uBleGattCache_t *pCache = gpCache;
+    uBleGattCachePeer_t *pPeer = NULL;
+    uBleGattCacheEntry_t *pEntry;
+    uint8_t hash[U_BLE_GATT_DATABASE_HASH_LENGTH];
+
+    if (pCache != NULL) {
+        U_PORT_MUTEX_LOCK(pCache->mutex);
+        for (size_t x = 0; (x < U_BLE_GATT_CACHE_MAX_PEERS) && (pPeer == NULL); x++) {
+            if (pCache->peers[x].inUse && (pCache->peers[x].connHandle == connHandle)) {
+                pPeer = &(pCache->peers[x]);
+            }
+        }
+        U_PORT_MUTEX_UNLOCK(pCache->mutex);
+        if ((pPeer != NULL) && !pPeer->checked) {
+            // The first look at the cache on this connection: if the
+            // peer has a database hash, one read tells us whether
+            // what we have is still valid
+            pPeer->checked = true;
+            pEntry = &(pPeer->entry);
+            if ((pEntry->databaseHashHandle != 0) &&
+                ((uBleGattReadValue(devHandle, connHandle, pEntry->databaseHashHandle,
+                                    hash, sizeof(hash)) != (int32_t)sizeof(hash)) ||
+                 (memcmp(hash, pEntry->databaseHash, sizeof(hash)) != 0))) {
+                cacheClear(pEntry);
+            }
+        }
+    }
+
+    return pPeer;
+}
+
+// Call the save callback for a cached peer.
+static void cacheSave(const uBleGattCachePeer_t *pPeer)
+{
+    uBleGattCache_t *pCache = gpCache;
+
+    if ((pCache != NULL) && (pCache->pSaveCb != NULL)) {
+        pCache->pSaveCb(&(pPeer->entry), pCache->pSaveCbParam);
+    }
+}
+
 static void notifyUrc(uAtClientHandle_t atHandle,
                       void *pParameter)
 {
     uBleGattNotificationCallback_t cb = (uBleGattNotificationCallback_t)pParameter;
     uint8_t connHandle = uAtClientReadInt(atHandle);
     uint16_t valueHandle = uAtClientReadInt(atHandle);
-    uint8_t value[25];
+    uint8_t value[U_BLE_GATT_URC_VALUE_MAX_LENGTH];
     uint16_t valueSize = uAtClientReadHexData(atHandle, value, sizeof(value));
     if (valueSize > 0) {
         cb(connHandle, valueHandle, value, (uint8_t)valueSize);
@@ -92,7 +220,7 @@ static void writeUrc(uAtClientHandle_t atHandle,
     uBleGattWriteCallback_t cb = (uBleGattWriteCallback_t)pParameter;
     uint8_t connHandle = uAtClientReadInt(atHandle);
     uint16_t valueHandle = uAtClientReadInt(atHandle);
-    uint8_t value[25];
+    uint8_t value[U_BLE_GATT_URC_VALUE_MAX_LENGTH];
     uint16_t valueSize = uAtClientReadHexData(atHandle, value, sizeof(value));
     if (valueSize > 0) {
         cb(connHandle, valueHandle, value, (uint8_t)valueSize);
@@ -131,7 +259,27 @@ int32_t uBleGattDiscoverServices(uDeviceHandle_t devHandle,
 {
     int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
     uShortRangePrivateInstance_t *pInstance;
-    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+    uBleGattCachePeer_t *pPeer = pCacheGet(devHandle, connHandle);
+    uBleGattCacheEntry_t *pEntry = NULL;
+    bool cached = false;
+    bool overflow = false;
+
+    if (pPeer != NULL) {
+        pEntry = &(pPeer->entry);
+        if (pEntry->servicesValid) {
+            for (size_t x = 0; x < pEntry->numServices; x++) {
+                if (cb) {
+                    cb(connHandle, pEntry->services[x].startHandle,
+                       pEntry->services[x].endHandle, pEntry->services[x].uuid);
+                }
+            }
+            errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+            cached = true;
+        } else {
+            pEntry->numServices = 0;
+        }
+    }
+    if (!cached && (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS)) {
         pInstance = pUShortRangePrivateGetInstance(devHandle);
         uAtClientHandle_t atHandle = pInstance->atHandle;
         uAtClientLock(atHandle);
@@ -151,6 +299,17 @@ int32_t uBleGattDiscoverServices(uDeviceHandle_t devHandle,
                                                uuid,
                                                sizeof(uuid),
                                                false) >= 0;
+                if (ok && (pEntry != NULL)) {
+                    if (pEntry->numServices < U_BLE_GATT_CACHE_MAX_SERVICES) {
+                        pEntry->services[pEntry->numServices].startHandle = startHandle;
+                        pEntry->services[pEntry->numServices].endHandle = endHandle;
+                        strncpy(pEntry->services[pEntry->numServices].uuid, uuid,
+                                sizeof(pEntry->services[pEntry->numServices].uuid));
+                        pEntry->numServices++;
+                    } else {
+                        overflow = true;
+                    }
+                }
                 if (ok && cb) {
                     cb(connHandle, startHandle, endHandle, uuid);
                 }
@@ -164,6 +323,11 @@ int32_t uBleGattDiscoverServices(uDeviceHandle_t devHandle,
 
         uShortRangeUnlock();
     }
+    if (!cached && (pEntry != NULL) &&
+        (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) && !overflow) {
+        pEntry->servicesValid = true;
+        cacheSave(pPeer);
+    }
     return errorCode;
 }
 
@@ -173,7 +337,30 @@ int32_t uBleGattDiscoverChar(uDeviceHandle_t devHandle,
 {
     int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
     uShortRangePrivateInstance_t *pInstance;
-    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+    uBleGattCachePeer_t *pPeer = pCacheGet(devHandle, connHandle);
+    uBleGattCacheEntry_t *pEntry = NULL;
+    uBleGattCacheChar_t *pChar;
+    bool cached = false;
+    bool overflow = false;
+
+    if (pPeer != NULL) {
+        pEntry = &(pPeer->entry);
+        if (pEntry->charsValid) {
+            for (size_t x = 0; x < pEntry->numChars; x++) {
+                pChar = &(pEntry->chars[x]);
+                if (cb) {
+                    cb(connHandle, pChar->attrHandle, pChar->properties,
+                       pChar->valueHandle, pChar->uuid);
+                }
+            }
+            errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+            cached = true;
+        } else {
+            pEntry->numChars = 0;
+            pEntry->databaseHashHandle = 0;
+        }
+    }
+    if (!cached && (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS)) {
         pInstance = pUShortRangePrivateGetInstance(devHandle);
         uAtClientHandle_t atHandle = pInstance->atHandle;
         uAtClientLock(atHandle);
@@ -197,6 +384,21 @@ int32_t uBleGattDiscoverChar(uDeviceHandle_t devHandle,
                                                uuid,
                                                sizeof(uuid),
                                                false) >= 0;
+                if (ok && (pEntry != NULL)) {
+                    if (pEntry->numChars < U_BLE_GATT_CACHE_MAX_CHARS) {
+                        pChar = &(pEntry->chars[pEntry->numChars]);
+                        pChar->attrHandle = attrHandle;
+                        pChar->valueHandle = valueHandle;
+                        pChar->properties = prop;
+                        strncpy(pChar->uuid, uuid, sizeof(pChar->uuid));
+                        pEntry->numChars++;
+                    } else {
+                        overflow = true;
+                    }
+                    if (strcmp(uuid, U_BLE_GATT_DATABASE_HASH_UUID) == 0) {
+                        pEntry->databaseHashHandle = valueHandle;
+                    }
+                }
                 if (ok && cb) {
                     cb(connHandle, attrHandle, prop, valueHandle, uuid);
                 }
@@ -209,6 +411,19 @@ int32_t uBleGattDiscoverChar(uDeviceHandle_t devHandle,
         uAtClientUnlock(atHandle);
         uShortRangeUnlock();
     }
+    if (!cached && (pEntry != NULL) &&
+        (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) && !overflow) {
+        // Remember the database hash so that it can be checked
+        // against on the next connection
+        if ((pEntry->databaseHashHandle != 0) &&
+            (uBleGattReadValue(devHandle, connHandle, pEntry->databaseHashHandle,
+                               pEntry->databaseHash, U_BLE_GATT_DATABASE_HASH_LENGTH) !=
+             U_BLE_GATT_DATABASE_HASH_LENGTH)) {
+            pEntry->databaseHashHandle = 0;
+        }
+        pEntry->charsValid = true;
+        cacheSave(pPeer);
+    }
     return errorCode;
 }
 
@@ -412,4 +627,149 @@ int32_t uBleGattAddCharacteristic(uDeviceHandle_t devHandle,
     return errorCode;
 }
 
+int32_t uBleGattCacheEnable(uBleGattCacheSaveCallback_t pSaveCb, void *pParam)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+    uBleGattCache_t *pCache = gpCache;
+
+    if (pCache == NULL) {
+        errorCode = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+        pCache = (uBleGattCache_t *)pUPortMalloc(sizeof(*pCache));
+        if (pCache != NULL) {
+            memset(pCache, 0, sizeof(*pCache));
+            for (size_t x = 0; x < U_BLE_GATT_CACHE_MAX_PEERS; x++) {
+                pCache->peers[x].connHandle = -1;
+            }
+            errorCode = uPortMutexCreate(&(pCache->mutex));
+            if (errorCode == 0) {
+                gpCache = pCache;
+            } else {
+                uPortFree(pCache);
+                pCache = NULL;
+            }
+        }
+    }
+    if (pCache != NULL) {
+        pCache->pSaveCb = pSaveCb;
+        pCache->pSaveCbParam = pParam;
+    }
+
+    return errorCode;
+}
+
+int32_t uBleGattCachePreset(const uBleGattCacheEntry_t *pEntry)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleGattCache_t *pCache = gpCache;
+    uBleGattCachePeer_t *pPeer;
+
+    if (pCache != NULL) {
+        errorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pEntry != NULL) && (pEntry->numServices <= U_BLE_GATT_CACHE_MAX_SERVICES) &&
+            (pEntry->numChars <= U_BLE_GATT_CACHE_MAX_CHARS)) {
+            U_PORT_MUTEX_LOCK(pCache->mutex);
+            errorCode = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+            pPeer = pCacheFindAddress(pCache, pEntry->address);
+            if (pPeer != NULL) {
+                errorCode = (int32_t)U_ERROR_COMMON_BUSY;
+                if (pPeer->connHandle < 0) {
+                    pPeer->entry = *pEntry;
+                    pPeer->entry.address[sizeof(pPeer->entry.address) - 1] = 0;
+                    pPeer->inUse = true;
+                    pPeer->connectedTimeMs = uPortGetTickTimeMs();
+                    errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+                }
+            }
+            U_PORT_MUTEX_UNLOCK(pCache->mutex);
+        }
+    }
+
+    return errorCode;
+}
+
+int32_t uBleGattCacheInvalidate(const char *pAddress)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleGattCache_t *pCache = gpCache;
+    uBleGattCachePeer_t *pPeer;
+
+    if (pCache != NULL) {
+        errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+        U_PORT_MUTEX_LOCK(pCache->mutex);
+        for (size_t x = 0; x < U_BLE_GATT_CACHE_MAX_PEERS; x++) {
+            pPeer = &(pCache->peers[x]);
+            if (pPeer->inUse &&
+                ((pAddress == NULL) ||
+                 (strncmp(pPeer->entry.address, pAddress, sizeof(pPeer->entry.address)) == 0))) {
+                cacheClear(&(pPeer->entry));
+            }
+        }
+        U_PORT_MUTEX_UNLOCK(pCache->mutex);
+    }
+
+    return errorCode;
+}
+
+void uBleGattCacheDisable()
+{
+    uBleGattCache_t *pCache = gpCache;
+
+    if (pCache != NULL) {
+        U_PORT_MUTEX_LOCK(pCache->mutex);
+        gpCache = NULL;
+        U_PORT_MUTEX_UNLOCK(pCache->mutex);
+        uPortMutexDelete(pCache->mutex);
+        uPortFree(pCache);
+    }
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS THAT ARE PRIVATE TO BLE
+ * -------------------------------------------------------------- */
+
+void uBleGattPrivateCacheConnected(int32_t connHandle, const char *pAddress)
+{
+    uBleGattCache_t *pCache = gpCache;
+    uBleGattCachePeer_t *pPeer;
+
+    if ((pCache != NULL) && (pAddress != NULL)) {
+        U_PORT_MUTEX_LOCK(pCache->mutex);
+        for (size_t x = 0; x < U_BLE_GATT_CACHE_MAX_PEERS; x++) {
+            // In case a disconnection was missed
+            if (pCache->peers[x].connHandle == connHandle) {
+                pCache->peers[x].connHandle = -1;
+            }
+        }
+        pPeer = pCacheFindAddress(pCache, pAddress);
+        if (pPeer != NULL) {
+            if (!pPeer->inUse ||
+                (strncmp(pPeer->entry.address, pAddress, sizeof(pPeer->entry.address)) != 0)) {
+                // A new peer
+                memset(&(pPeer->entry), 0, sizeof(pPeer->entry));
+                strncpy(pPeer->entry.address, pAddress, sizeof(pPeer->entry.address) - 1);
+                pPeer->inUse = true;
+            }
+            pPeer->checked = false;
+            pPeer->connectedTimeMs = uPortGetTickTimeMs();
+            pPeer->connHandle = connHandle;
+        }
+        U_PORT_MUTEX_UNLOCK(pCache->mutex);
+    }
+}
+
+void uBleGattPrivateCacheDisconnected(int32_t connHandle)
+{
+    uBleGattCache_t *pCache = gpCache;
+
+    if (pCache != NULL) {
+        U_PORT_MUTEX_LOCK(pCache->mutex);
+        for (size_t x = 0; x < U_BLE_GATT_CACHE_MAX_PEERS; x++) {
+            if (pCache->peers[x].connHandle == connHandle) {
+                pCache->peers[x].connHandle = -1;
+            }
+        }
+        U_PORT_MUTEX_UNLOCK(pCache->mutex);
+    }
+}
+
 #endif
\ No newline at end of file
@@ -45,9 +45,12 @@
 #include "u_ble_gatt.h"
 #include "u_ble_private.h"
 #include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
 #include "u_port.h"
 #include "u_port_os.h"
 #include "u_port_heap.h"
+#include "u_port_event_queue.h"
+#include "u_ringbuffer.h"
 #include "u_short_range.h"
 #include "u_short_range_module_type.h"
 #include "u_short_range_pbuf.h"
@@ -69,10 +72,38 @@
 
 #define VALIDATE(f) if (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) { errorCode = f; }
 
+#ifndef U_BLE_NUS_STREAM_TX_RETRY_MS
+/** How long to wait before trying again when the module refuses
+ * to take a fragment in streaming mode, e.g. because its buffers
+ * are full.
+ */
+# define U_BLE_NUS_STREAM_TX_RETRY_MS 10
+#endif
+
+#ifndef U_BLE_NUS_STREAM_TX_RETRIES
+/** The number of times to try sending a fragment in streaming mode
+ * before leaving it for the next call to uBleNusStreamWrite().
+ */
+# define U_BLE_NUS_STREAM_TX_RETRIES 50
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Streaming mode state; the linear buffers of the two ring buffers
+ * follow this structure in the same allocation.
+ */
+typedef struct {
+    uRingBuffer_t txRingBuffer;
+    uRingBuffer_t rxRingBuffer;
+    size_t fragmentSize;
+    int32_t txQueueHandle;
+    volatile bool txEventPending;
+    uBleNusDataAvailableCallback_t pDataAvailableCb;
+    void *pDataAvailableCbParam;
+} uBleNusStream_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -85,6 +116,8 @@ static int32_t gConnHandle;
 static uint16_t gRxHandle, gTxHandle;
 static uBleNusReceiveCallback_t gReceiveCallback;
 
+static uBleNusStream_t *gpStream = NULL;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -120,10 +153,58 @@ static void receiveCallback(uint8_t connHandle,
                             uint8_t *pValue,
                             uint8_t valueSize)
 {
+    uBleNusStream_t *pStream = gpStream;
     (void)connHandle;
     if ((valueHandle == gRxHandle && gIsServer) ||
         (valueHandle == gTxHandle && !gIsServer)) {
-        gReceiveCallback(pValue, valueSize);
+        if (pStream != NULL) {
+            // If there is no room the data is lost, counted by
+            // uRingBufferStatAddLoss()
+            uRingBufferAdd(&(pStream->rxRingBuffer), (const char *)pValue, valueSize);
+            if (pStream->pDataAvailableCb != NULL) {
+                pStream->pDataAvailableCb(uRingBufferDataSize(&(pStream->rxRingBuffer)),
+                                          pStream->pDataAvailableCbParam);
+            }
+        } else if (gReceiveCallback != NULL) {
+            gReceiveCallback(pValue, valueSize);
+        }
+    }
+}
+
+// Send data to the peer without waiting for a response.
+static int32_t writeNoResponse(const void *pValue, uint8_t valueLength)
+{
+    if (gIsServer) {
+        return uBleGattWriteNotifyValue(gDeviceHandle, gConnHandle, gTxHandle, pValue, valueLength);
+    } else {
+        return uBleGattWriteValue(gDeviceHandle, gConnHandle, gRxHandle, pValue, valueLength, false);
+    }
+}
+
+// Event queue handler: empty the transmit queue in streaming mode,
+// a fragment at a time, for as long as the module will take it.
+static void onStreamTxEvent(void *pParam, size_t paramLength)
+{
+    uBleNusStream_t *pStream = *((uBleNusStream_t **)pParam);
+    char fragment[U_BLE_NUS_STREAM_FRAGMENT_SIZE_MAX];
+    size_t length;
+    int32_t retries = 0;
+
+    (void)paramLength;
+    // Clear the flag first so that data added from now on
+    // will cause another event
+    pStream->txEventPending = false;
+    length = uRingBufferPeek(&(pStream->txRingBuffer), fragment, pStream->fragmentSize, 0);
+    while ((length > 0) && (gConnectState == 1) && (retries < U_BLE_NUS_STREAM_TX_RETRIES)) {
+        if (writeNoResponse(fragment, (uint8_t)length) == (int32_t)U_ERROR_COMMON_SUCCESS) {
+            uRingBufferRead(&(pStream->txRingBuffer), NULL, length);
+            length = uRingBufferPeek(&(pStream->txRingBuffer), fragment,
+                                     pStream->fragmentSize, 0);
+            retries = 0;
+        } else {
+            uPortTaskBlock(U_BLE_NUS_STREAM_TX_RETRY_MS);
+            retries++;
+        }
     }
 }
 
@@ -189,6 +270,7 @@ int32_t uBleNusInit(uDeviceHandle_t devHandle,
 int32_t uBleNusDeInit()
 {
     int32_t errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
+    uBleNusStreamStop();
     if (gConnectState == 1) {
         errorCode = uBleGapDisconnect(gDeviceHandle, gConnHandle);
     }
@@ -223,4 +305,130 @@ int32_t uBleNusSetAdvData(uint8_t *pAdvData, uint8_t advDataSize)
     return size + 2;
 }
 
+int32_t uBleNusStreamStart(size_t fragmentSize,
+                           uBleNusDataAvailableCallback_t cb,
+                           void *pParam)
+{
+    int32_t errorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleNusStream_t *pStream;
+    char *pBuffer;
+    int32_t x;
+
+    if (gDeviceHandle != NULL) {
+        errorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if (fragmentSize == 0) {
+            fragmentSize = U_BLE_NUS_STREAM_FRAGMENT_SIZE_DEFAULT;
+        }
+        if ((gpStream == NULL) && (fragmentSize <= U_BLE_NUS_STREAM_FRAGMENT_SIZE_MAX)) {
+            errorCode = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+            pStream = (uBleNusStream_t *)pUPortMalloc(sizeof(uBleNusStream_t) +
+                                                      U_BLE_NUS_STREAM_TX_BUFFER_SIZE +
+                                                      U_BLE_NUS_STREAM_RX_BUFFER_SIZE);
+            if (pStream != NULL) {
+                memset(pStream, 0, sizeof(*pStream));
+                pStream->fragmentSize = fragmentSize;
+                pStream->pDataAvailableCb = cb;
+                pStream->pDataAvailableCbParam = pParam;
+                pBuffer = (char *)(pStream + 1);
+                // Each ring buffer has exactly one producer and one
+                // consumer (the application and the transmit task, the
+                // receive callback and the application) so no locking
+                errorCode = uRingBufferCreateLockFree(&(pStream->txRingBuffer), pBuffer,
+                                                      U_BLE_NUS_STREAM_TX_BUFFER_SIZE);
+                if (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) {
+                    errorCode = uRingBufferCreateLockFree(&(pStream->rxRingBuffer),
+                                                          pBuffer + U_BLE_NUS_STREAM_TX_BUFFER_SIZE,
+                                                          U_BLE_NUS_STREAM_RX_BUFFER_SIZE);
+                    if (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) {
+                        // Queue length 1 is enough since txEventPending
+                        // means there is at most one event waiting
+                        x = uPortEventQueueOpen(onStreamTxEvent, "uBleNusStreamTx",
+                                                sizeof(uBleNusStream_t *),
+                                                U_BLE_NUS_STREAM_TASK_STACK_SIZE_BYTES,
+                                                U_BLE_NUS_STREAM_TASK_PRIORITY, 1);
+                        pStream->txQueueHandle = x;
+                        if (x >= 0) {
+                            gpStream = pStream;
+                        } else {
+                            errorCode = x;
+                            uRingBufferDelete(&(pStream->rxRingBuffer));
+                        }
+                    }
+                    if (errorCode != (int32_t)U_ERROR_COMMON_SUCCESS) {
+                        uRingBufferDelete(&(pStream->txRingBuffer));
+                    }
+                }
+                if (errorCode != (int32_t)U_ERROR_COMMON_SUCCESS) {
+                    uPortFree(pStream);
+                }
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+int32_t uBleNusStreamWrite(const void *pData, size_t length)
+{
+    int32_t errorCodeOrLength = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleNusStream_t *pStream = gpStream;
+    size_t available;
+
+    if (pStream != NULL) {
+        errorCodeOrLength = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pData != NULL) || (length == 0)) {
+            available = uRingBufferAvailableSize(&(pStream->txRingBuffer));
+            if (length > available) {
+                length = available;
+            }
+            errorCodeOrLength = 0;
+            if ((length > 0) &&
+                uRingBufferAdd(&(pStream->txRingBuffer), (const char *)pData, length)) {
+                errorCodeOrLength = (int32_t)length;
+            }
+            if ((uRingBufferDataSize(&(pStream->txRingBuffer)) > 0) &&
+                !pStream->txEventPending) {
+                // Kick the transmit task; there is only ever one event
+                // pending, the task empties the whole queue
+                pStream->txEventPending = true;
+                if (uPortEventQueueSend(pStream->txQueueHandle, &pStream,
+                                        sizeof(pStream)) != 0) {
+                    pStream->txEventPending = false;
+                }
+            }
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+int32_t uBleNusStreamRead(void *pData, size_t length)
+{
+    int32_t errorCodeOrLength = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uBleNusStream_t *pStream = gpStream;
+
+    if (pStream != NULL) {
+        errorCodeOrLength = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if (pData != NULL) {
+            errorCodeOrLength = (int32_t)uRingBufferRead(&(pStream->rxRingBuffer),
+                                                         (char *)pData, length);
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+void uBleNusStreamStop()
+{
+    uBleNusStream_t *pStream = gpStream;
+
+    if (pStream != NULL) {
+        gpStream = NULL;
+        uPortEventQueueClose(pStream->txQueueHandle);
+        uRingBufferDelete(&(pStream->rxRingBuffer));
+        uRingBufferDelete(&(pStream->txRingBuffer));
+        uPortFree(pStream);
+    }
+}
+
 #endif
\ No newline at end of file
@@ -777,6 +777,12 @@ int32_t uBleSpsDisableFlowCtrlOnNext(uDeviceHandle_t devHandle)
     return (int32_t)U_ERROR_COMMON_NOT_IMPLEMENTED;
 }
 
+int32_t uBleSpsEnableHighThroughputOnNext(uDeviceHandle_t devHandle)
+{
+    (void)devHandle;
+    return (int32_t)U_ERROR_COMMON_NOT_IMPLEMENTED;
+}
+
 #endif
 
 // End of file
@@ -48,7 +48,6 @@
 #include "u_port_debug.h"
 #include "u_port_event_queue.h"
 #include "u_cfg_os_platform_specific.h"
-#include "u_ringbuffer.h"
 
 #include "u_ble_sps.h"
 #include "u_ble_private.h"
@@ -59,6 +58,22 @@
 
 #define U_BLE_PDU_HEADER_SIZE 3
 
+#ifndef U_BLE_SPS_CREDIT_LOW_WATERMARK_PERCENT
+/** When flow control is on, the remote is given more RX credits
+ * once the credits it has left fall to this percentage of the
+ * number of packets the receive buffer can hold, in batches of at
+ * least as many again, or straight away if it has none left. This
+ * tops the remote up before it stalls, without sending a credit
+ * update for every packet the application reads.
+ */
+# define U_BLE_SPS_CREDIT_LOW_WATERMARK_PERCENT 25
+#endif
+
+/** The most RX credits that may be outstanding on the remote: a
+ * credit grant is a single byte and 0xff means "disconnect".
+ */
+#define U_BLE_SPS_MAX_RX_CREDITS 254
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -99,6 +114,14 @@ typedef enum {
 } spsRole_t;
 
 /** SPS Connection information
+ *
+ * rxData is a single-producer, single-consumer ring: the producer is
+ * addReceivedDataToBuffer(), called from the BLE stack, which is the
+ * only writer of rxWriteIndex, the consumer is uBleSpsReceive(), the
+ * only writer of rxReadIndex, hence neither has to wait on a lock and
+ * the BLE stack is never held up by the application reading data.
+ * One byte is always left empty so that the ring is empty when the
+ * two indexes are equal.
  * */
 typedef struct {
     int32_t      gapConnHandle;
@@ -114,16 +137,28 @@ typedef struct {
             uint16_t creditsClientConf;
         } server;
     };
-    uint8_t                rxCreditsOnRemote;
+    volatile uint32_t      rxCreditsGranted;  /**< free-running count of RX credits
+                                                   sent to the remote, written only
+                                                   by updateRxCreditsOnRemote(). */
+    volatile uint32_t      rxPacketsReceived; /**< free-running count of packets
+                                                   received against those credits,
+                                                   written only by
+                                                   addReceivedDataToBuffer(). */
     uint8_t                txCredits;
     spsState_t             spsState;
     uint16_t               mtu;
     uPortSemaphoreHandle_t txCreditsSemaphore;
     char                   rxData[U_BLE_SPS_BUFFER_SIZE];
-    uRingBuffer_t          rxRingBuffer;
+    volatile size_t        rxWriteIndex;
+    volatile size_t        rxReadIndex;
+    volatile bool          rxDataEventPending; /**< set by the producer when it
+                                                    sends EVENT_SPS_RX_DATA_AVAILABLE,
+                                                    cleared before the event is
+                                                    handled. */
     uint32_t               dataSendTimeoutMs;
     spsRole_t              localSpsRole;
     bool                   flowCtrlEnabled;
+    bool                   highThroughput;
 } spsConnection_t;
 
 /** SPS Client event
@@ -144,10 +179,14 @@ static bool validSpsConnHandle(int32_t spsConnHandle);
 static spsConnection_t *initSpsConnection(int32_t spsConnHandle, int32_t gapConnHandle,
                                           spsRole_t localSpsRole);
 static void addLocalTxCredits(int32_t spsConnHandle, uint8_t credits);
+static size_t rxRingUsed(const spsConnection_t *pSpsConn);
+static bool rxRingAdd(spsConnection_t *pSpsConn, const char *pData, size_t length);
+static size_t rxRingRead(spsConnection_t *pSpsConn, char *pData, size_t length);
 static void addReceivedDataToBuffer(int32_t spsConnHandle, const void *pData, uint16_t length);
 static bool sendDataToRemoteFifo(const spsConnection_t *pSpsConn, const char *pData,
                                  uint16_t bytesToSendNow);
 static void updateRxCreditsOnRemote(spsConnection_t *pSpsConn);
+static void requestHighThroughput(const spsConnection_t *pSpsConn);
 static void gapConnectionEvent(int32_t gapConnHandle, uPortGattGapConnStatus_t status,
                                void *pParameter);
 
@@ -203,6 +242,7 @@ static void *gpSpsDataAvailableCallbackParam;
 static spsConnection_t *gpSpsConnections[U_BLE_SPS_MAX_CONNECTIONS];
 static uBleSpsHandles_t gNextConnServerHandles;
 static bool gFlowCtrlOnNext = true;
+static bool gHighThroughputOnNext = false;
 
 static uPortGattUuid128_t gSpsCreditsCharUuid = {
     .type = U_PORT_GATT_UUID_TYPE_128,
@@ -328,7 +368,6 @@ static void freeSpsConnection(int32_t spsConnHandle)
 {
     if (validSpsConnHandle(spsConnHandle)) {
         spsConnection_t *pSpsConn = gpSpsConnections[spsConnHandle];
-        uRingBufferDelete(&pSpsConn->rxRingBuffer);
         uPortSemaphoreDelete(pSpsConn->txCreditsSemaphore);
         uPortFree(pSpsConn);
         gpSpsConnections[spsConnHandle] = NULL;
@@ -359,7 +398,8 @@ static spsConnection_t *initSpsConnection(int32_t spsConnHandle, int32_t gapConn
     if (gpSpsConnections[spsConnHandle] != NULL) {
         spsConnection_t *pSpsConn = gpSpsConnections[spsConnHandle];
         pSpsConn->gapConnHandle = gapConnHandle;
-        pSpsConn->rxCreditsOnRemote = 0;
+        pSpsConn->rxCreditsGranted = 0;
+        pSpsConn->rxPacketsReceived = 0;
         pSpsConn->txCredits = 0;
         pSpsConn->mtu = 23;
         pSpsConn->client.attHandle.service = 0;
@@ -371,11 +411,13 @@ static spsConnection_t *initSpsConnection(int32_t spsConnHandle, int32_t gapConn
         pSpsConn->server.creditsClientConf = 0;
         pSpsConn->spsState = SPS_STATE_DISCONNECTED;
         uPortSemaphoreCreate(&(pSpsConn->txCreditsSemaphore), 0, 1);
-        uRingBufferCreate(&pSpsConn->rxRingBuffer, pSpsConn->rxData, sizeof(pSpsConn->rxData));
-        uRingBufferReset(&pSpsConn->rxRingBuffer);
+        pSpsConn->rxWriteIndex = 0;
+        pSpsConn->rxReadIndex = 0;
+        pSpsConn->rxDataEventPending = false;
         pSpsConn->dataSendTimeoutMs = U_BLE_SPS_DEFAULT_SEND_TIMEOUT_MS;
         pSpsConn->localSpsRole = localSpsRole;
         pSpsConn->flowCtrlEnabled = true;
+        pSpsConn->highThroughput = false;
     }
 
     return gpSpsConnections[spsConnHandle];
@@ -410,24 +452,81 @@ static void addLocalTxCredits(int32_t spsConnHandle, uint8_t credits)
     }
 }
 
+// The number of bytes in the receive ring; may be called by either
+// the producer or the consumer.
+static size_t rxRingUsed(const spsConnection_t *pSpsConn)
+{
+    size_t writeIndex = pSpsConn->rxWriteIndex;
+    size_t readIndex = pSpsConn->rxReadIndex;
+
+    return (writeIndex + sizeof(pSpsConn->rxData) - readIndex) % sizeof(pSpsConn->rxData);
+}
+
+// Add data to the receive ring: producer only, all or nothing.
+static bool rxRingAdd(spsConnection_t *pSpsConn, const char *pData, size_t length)
+{
+    bool success = false;
+    size_t writeIndex = pSpsConn->rxWriteIndex;
+    size_t chunk;
+
+    if (rxRingUsed(pSpsConn) + length < sizeof(pSpsConn->rxData)) {
+        chunk = sizeof(pSpsConn->rxData) - writeIndex;
+        if (chunk > length) {
+            chunk = length;
+        }
+        memcpy(pSpsConn->rxData + writeIndex, pData, chunk);
+        memcpy(pSpsConn->rxData, pData + chunk, length - chunk);
+        // Only move the write index once the data is in place
+        pSpsConn->rxWriteIndex = (writeIndex + length) % sizeof(pSpsConn->rxData);
+        success = true;
+    }
+
+    return success;
+}
+
+// Read data from the receive ring: consumer only.
+static size_t rxRingRead(spsConnection_t *pSpsConn, char *pData, size_t length)
+{
+    size_t readIndex = pSpsConn->rxReadIndex;
+    size_t used = rxRingUsed(pSpsConn);
+    size_t chunk;
+
+    if (length > used) {
+        length = used;
+    }
+    chunk = sizeof(pSpsConn->rxData) - readIndex;
+    if (chunk > length) {
+        chunk = length;
+    }
+    memcpy(pData, pSpsConn->rxData + readIndex, chunk);
+    memcpy(pData + chunk, pSpsConn->rxData, length - chunk);
+    // Only move the read index once the data has been copied out
+    pSpsConn->rxReadIndex = (readIndex + length) % sizeof(pSpsConn->rxData);
+
+    return length;
+}
+
 static void addReceivedDataToBuffer(int32_t spsConnHandle, const void *pData, uint16_t length)
 {
     if (spsConnHandle != U_BLE_SPS_INVALID_HANDLE) {
         spsConnection_t *pSpsConn = pGetSpsConn(spsConnHandle);
-        bool bufferWasEmpty = (uRingBufferDataSize(&(pSpsConn->rxRingBuffer)) == 0);
 
-        if (pSpsConn->rxCreditsOnRemote > 0) {
+        if (pSpsConn->rxCreditsGranted != pSpsConn->rxPacketsReceived) {
             // Keep track of how many credits the remote has left
-            pSpsConn->rxCreditsOnRemote--;
+            pSpsConn->rxPacketsReceived++;
         } else {
             if (pSpsConn->flowCtrlEnabled) {
                 uPortLog("U_BLE_SPS: Remote sent %d bytes without credits!\n", length);
             }
         }
 
-        if (uRingBufferAdd(&(pSpsConn->rxRingBuffer), (const char *)pData, length)) {
-            if (bufferWasEmpty) {
+        if (rxRingAdd(pSpsConn, (const char *)pData, length)) {
+            // Only tell the application once, until it has been told:
+            // the data is added first so that, if the flag has been
+            // cleared already, the application is bound to read it
+            if (!pSpsConn->rxDataEventPending) {
                 spsEvent_t event;
+                pSpsConn->rxDataEventPending = true;
                 event.type = EVENT_SPS_RX_DATA_AVAILABLE;
                 event.spsConnHandle = spsConnHandle;
                 uPortEventQueueSend(gSpsEventQueue, &event, sizeof(event));
@@ -443,10 +542,21 @@ static bool sendDataToRemoteFifo(const spsConnection_t *pSpsConn, const char *pD
                                  uint16_t bytesToSendNow)
 {
     bool success;
+    int32_t errorCode;
 
     if ((pSpsConn->localSpsRole == SPS_SERVER) && (pSpsConn->server.fifoClientConf & 1)) {
-        success = (uPortGattNotify(pSpsConn->gapConnHandle,
-                                   &gSpsFifoChar, pData, bytesToSendNow) == (int32_t)U_ERROR_COMMON_SUCCESS);
+        // Queue the notification without waiting, so that a
+        // connection event can carry several of them; only when
+        // the queue is full do we wait for one to be sent
+        errorCode = uPortGattNotifyNoWait(pSpsConn->gapConnHandle,
+                                          &gSpsFifoChar, pData, bytesToSendNow);
+        if ((errorCode == (int32_t)U_ERROR_COMMON_BUSY) &&
+            (uPortGattNotifyWaitSlot(pSpsConn->gapConnHandle,
+                                     (int32_t)pSpsConn->dataSendTimeoutMs) == 0)) {
+            errorCode = uPortGattNotifyNoWait(pSpsConn->gapConnHandle,
+                                              &gSpsFifoChar, pData, bytesToSendNow);
+        }
+        success = (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS);
     } else {
         success = (uPortGattWriteAttribute(pSpsConn->gapConnHandle, pSpsConn->client.attHandle.fifoValue,
                                            pData, bytesToSendNow) == (int32_t)U_ERROR_COMMON_SUCCESS);
@@ -455,33 +565,70 @@ static bool sendDataToRemoteFifo(const spsConnection_t *pSpsConn, const char *pD
     return success;
 }
 
+static void requestHighThroughput(const spsConnection_t *pSpsConn)
+{
+    // All of these complete in the background and, if the remote
+    // side refuses, the link just stays as it was, hence errors
+    // are only logged
+    if (uPortGattRequestDataLength(pSpsConn->gapConnHandle,
+                                   U_BLE_SPS_HIGH_THROUGHPUT_DATA_LENGTH) != 0) {
+        uPortLog("U_BLE_SPS: data length extension request failed.\n");
+    }
+    if (uPortGattRequestPhy2M(pSpsConn->gapConnHandle) != 0) {
+        uPortLog("U_BLE_SPS: 2M PHY request failed.\n");
+    }
+    if (uPortGattUpdateConnParams(pSpsConn->gapConnHandle,
+                                  U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MIN,
+                                  U_BLE_SPS_HIGH_THROUGHPUT_CONN_INT_MAX,
+                                  U_BLE_SPS_CONN_PARAM_CONN_LATENCY_DEFAULT,
+                                  U_BLE_SPS_CONN_PARAM_LINK_LOSS_TMO_DEFAULT) != 0) {
+        uPortLog("U_BLE_SPS: connection parameter update request failed.\n");
+    }
+}
+
 static void updateRxCreditsOnRemote(spsConnection_t *pSpsConn)
 {
-    size_t avaibleBufferSize = uRingBufferAvailableSize(&(pSpsConn->rxRingBuffer));
-    uint8_t availableRxCredits = 0;
+    size_t freeBufferSize = sizeof(pSpsConn->rxData) - 1 - rxRingUsed(pSpsConn);
     size_t maxPacketDataSize = pSpsConn->mtu - U_BLE_PDU_HEADER_SIZE;
-    int16_t rxCreditsWeCanSend;
-
-    // First we calculate how many full size packets would fit into the current buffer
-    while ((avaibleBufferSize > maxPacketDataSize) && (availableRxCredits < 255)) {
-        avaibleBufferSize -= maxPacketDataSize;
-        availableRxCredits++;
+    int32_t window = (int32_t)((sizeof(pSpsConn->rxData) - 1) / maxPacketDataSize);
+    int32_t creditsOnRemote = (int32_t)(pSpsConn->rxCreditsGranted -
+                                        pSpsConn->rxPacketsReceived);
+    int32_t lowWatermark;
+    int32_t rxCreditsWeCanSend;
+    bool sendNow;
+
+    if (window > U_BLE_SPS_MAX_RX_CREDITS) {
+        window = U_BLE_SPS_MAX_RX_CREDITS;
+    }
+    lowWatermark = (window * U_BLE_SPS_CREDIT_LOW_WATERMARK_PERCENT) / 100;
+    if (lowWatermark < 1) {
+        lowWatermark = 1;
     }
 
-    // We maybe give the remote permission to send some more packets, but never more than
-    // that the total space occupied by the packets could overflow the current free
-    // buffer space i.e. availableRxCredits = rxCreditsWeCanSend + rxCreditsOnRemote
-    rxCreditsWeCanSend = (int16_t)availableRxCredits - (int16_t)(pSpsConn->rxCreditsOnRemote);
-    // Only send new credits when we at least can double the amount available on the remote,
-    // to minimize credits traffic, i.e. when we can send more credits than exists on remote
-    if ((rxCreditsWeCanSend > (int16_t)(pSpsConn->rxCreditsOnRemote)) &&
-        (rxCreditsWeCanSend > 0)) {
+    // We can give the remote permission to send as many full size
+    // packets as would fit into the free buffer space, less those
+    // it already has permission to send
+    rxCreditsWeCanSend = (int32_t)(freeBufferSize / maxPacketDataSize);
+    if (rxCreditsWeCanSend > window) {
+        rxCreditsWeCanSend = window;
+    }
+    rxCreditsWeCanSend -= creditsOnRemote;
+
+    // If the remote has no credits left it is stalled, so give it
+    // whatever we can; otherwise wait until it is down to the low
+    // watermark and then only send a worthwhile batch, to keep the
+    // number of credit updates down
+    sendNow = (rxCreditsWeCanSend > 0) &&
+              ((creditsOnRemote == 0) ||
+               ((creditsOnRemote <= lowWatermark) && (rxCreditsWeCanSend >= lowWatermark)));
+    if (sendNow) {
         bool success = false;
+        uint8_t credits = (uint8_t)rxCreditsWeCanSend;
 
         if (pSpsConn->localSpsRole == SPS_SERVER) {
             if (pSpsConn->server.creditsClientConf & 1) {
                 success = (uPortGattNotify(pSpsConn->gapConnHandle,
-                                           &gSpsCreditsChar, &rxCreditsWeCanSend, 1) == 0);
+                                           &gSpsCreditsChar, &credits, 1) == 0);
             } else {
                 // Credit Characteristics Client Configuration notification
                 // bit is not set
@@ -489,12 +636,12 @@ static void updateRxCreditsOnRemote(spsConnection_t *pSpsConn)
             }
         } else { // SPS_CLIENT
             success = (uPortGattWriteAttribute(pSpsConn->gapConnHandle,
-                                               pSpsConn->client.attHandle.creditsValue, &rxCreditsWeCanSend, 1) == 0);
+                                               pSpsConn->client.attHandle.creditsValue, &credits, 1) == 0);
         }
 
         if (success) {
-            uPortLog("U_BLE_SPS: Sent %d credits\n", rxCreditsWeCanSend);
-            pSpsConn->rxCreditsOnRemote += (uint8_t)rxCreditsWeCanSend;
+            uPortLog("U_BLE_SPS: Sent %d credits\n", credits);
+            pSpsConn->rxCreditsGranted += credits;
         }
     }
 }
@@ -565,6 +712,13 @@ static void gapConnectionEvent(int32_t gapConnHandle, uPortGattGapConnStatus_t s
                     spsConnection_t *pSpsConn = initSpsConnection(spsConnHandle, gapConnHandle, SPS_SERVER);
                     uPortGattGetRemoteAddress(gapConnHandle, addr, &addrType);
                     addrArrayToString(addr, addrType, true, pSpsConn->remoteAddr);
+                    pSpsConn->highThroughput = gHighThroughputOnNext;
+                    gHighThroughputOnNext = false;
+                    if (pSpsConn->highThroughput) {
+                        // As server we don't do the MTU exchange, that's
+                        // up to the client, so ask for the rest now
+                        requestHighThroughput(pSpsConn);
+                    }
                     uPortLog("U_BLE_SPS: Remote GAP connected, SPS conn handle: %d\n", spsConnHandle);
                 } else {
                     uPortLog("U_BLE_SPS: We already have maximum nbr of allowed SPS connections!\n", spsConnHandle);
@@ -878,6 +1032,9 @@ static void onBleSpsEvent(void *pParam, size_t eventSize)
 
         case EVENT_SPS_MTU_EXCHANGED:
             // MTU exchanged
+            if (pSpsConn->highThroughput) {
+                requestHighThroughput(pSpsConn);
+            }
             // continue and start subscription to Credit notifications
             // from server if we want flow control, otherwise go
             // directly to FIFO subscription
@@ -919,6 +1076,9 @@ static void onBleSpsEvent(void *pParam, size_t eventSize)
             break;
 
         case EVENT_SPS_RX_DATA_AVAILABLE:
+            // Clear the flag before the callback reads the data so
+            // that anything added after this raises a new event
+            pSpsConn->rxDataEventPending = false;
             if (gpSpsDataAvailableCallback != NULL) {
                 gpSpsDataAvailableCallback(pEvent->spsConnHandle, gpSpsDataAvailableCallbackParam);
             }
@@ -1172,6 +1332,8 @@ int32_t uBleSpsConnectSps(uDeviceHandle_t devHandle,
                         // Maybe disable flow control
                         pSpsConn->flowCtrlEnabled = gFlowCtrlOnNext;
                         gFlowCtrlOnNext = true;
+                        pSpsConn->highThroughput = gHighThroughputOnNext;
+                        gHighThroughputOnNext = false;
                         errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                     }
                 }
@@ -1313,9 +1475,9 @@ int32_t uBleSpsReceive(uDeviceHandle_t devHandle, int32_t channel, char *pData,
         return (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
     }
 
-    if (validSpsConnHandle(spsConnHandle)) {
+    if (validSpsConnHandle(spsConnHandle) && (pData != NULL) && (length >= 0)) {
         spsConnection_t *pSpsConn = pGetSpsConn(spsConnHandle);
-        sizeOrErrorCode = (int32_t)uRingBufferRead(&(pSpsConn->rxRingBuffer), pData, length);
+        sizeOrErrorCode = (int32_t)rxRingRead(pSpsConn, pData, (size_t)length);
         if ((sizeOrErrorCode > 0) && (pSpsConn->flowCtrlEnabled)) {
             updateRxCreditsOnRemote(pSpsConn);
         }
@@ -1371,6 +1533,17 @@ int32_t uBleSpsDisableFlowCtrlOnNext(uDeviceHandle_t devHandle)
     return (int32_t)U_ERROR_COMMON_SUCCESS;
 }
 
+int32_t uBleSpsEnableHighThroughputOnNext(uDeviceHandle_t devHandle)
+{
+    if (uDeviceGetDeviceType(devHandle) != (int32_t)U_DEVICE_TYPE_SHORT_RANGE_OPEN_CPU) {
+        return (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+
+    gHighThroughputOnNext = true;
+
+    return (int32_t)U_ERROR_COMMON_SUCCESS;
+}
+
 #endif
 
 // End of file
@@ -0,0 +1,293 @@
+/*
+ * Copyright 2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Tests for the BLE central scheduler API: these should pass on
+ * all platforms where one UART is available and the external NUS server
+ * used by the NUS tests is advertising; that server is found with a
+ * filtered scan and its GAP Device Name characteristic is polled.
+ * IMPORTANT: see notes in u_cfg_test_platform_specific.h for the
+ * naming rules that must be followed when using the U_PORT_TEST_FUNCTION()
+ * macro.
+ */
+#ifdef U_CFG_OVERRIDE
+#include "u_cfg_override.h"  // For a customer's configuration override
+#endif
+
+#include "stdint.h"  // int32_t etc.
+
+// Must always be included before u_short_range_test_selector.h
+// lint -efile(766, u_ble_module_type.h)
+#include "u_ble_module_type.h"
+#include "u_short_range_test_selector.h"
+
+#if U_SHORT_RANGE_TEST_BLE() && defined(U_CFG_TEST_SHORT_RANGE_MODULE_TYPE) && \
+    !defined(U_CFG_BLE_MODULE_INTERNAL)
+#include "stddef.h"
+#include "stdbool.h"
+#include "string.h"
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_debug.h"
+#include "u_port_os.h"
+#include "u_port_uart.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_at_client.h"
+#include "u_short_range_pbuf.h"
+#include "u_short_range.h"
+#include "u_short_range_edm_stream.h"
+
+#include "u_network.h"
+#include "u_network_config_ble.h"
+
+#include "u_ble_cfg.h"
+#include "u_ble.h"
+#include "u_ble_gap.h"
+#include "u_ble_gatt.h"
+#include "u_ble_central.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_BLE_CENTRAL_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#define EXT_SERVER_NAME "UbxExtNusServer"
+
+/** The UUID of the GAP Device Name characteristic, which every
+ * peripheral has.
+ */
+#define DEVICE_NAME_CHAR_UUID "2A00"
+
+#define SERVER_FOUND (gPeerMac[0] != 0)
+// Peer wait time in seconds. The external server may be busy
+#define PEER_WAIT_TIME_S 100
+
+#define POLL_TIMEOUT_MS 30000
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+static uDeviceHandle_t gDeviceHandle;
+static uDeviceCfg_t gDeviceCfg = {
+    .deviceType = U_DEVICE_TYPE_SHORT_RANGE,
+    .deviceCfg = {
+        .cfgSho = {
+            .moduleType = U_CFG_TEST_SHORT_RANGE_MODULE_TYPE
+        }
+    },
+    .transportType = U_DEVICE_TRANSPORT_TYPE_UART,
+    .transportCfg = {
+        .cfgUart = {
+            .uart = U_CFG_APP_SHORT_RANGE_UART,
+            .baudRate = U_SHORT_RANGE_UART_BAUD_RATE,
+            .pinTxd = U_CFG_APP_PIN_SHORT_RANGE_TXD,
+            .pinRxd = U_CFG_APP_PIN_SHORT_RANGE_RXD,
+            .pinCts = U_CFG_APP_PIN_SHORT_RANGE_CTS,
+            .pinRts = U_CFG_APP_PIN_SHORT_RANGE_RTS,
+#ifdef U_CFG_APP_UART_PREFIX
+            .pPrefix = U_PORT_STRINGIFY_QUOTED(U_CFG_APP_UART_PREFIX) // Relevant for Linux only
+#else
+            .pPrefix = NULL
+#endif
+        }
+    }
+};
+
+static uNetworkCfgBle_t gNetworkCfg = {
+    .type = U_NETWORK_TYPE_BLE,
+    .role = U_BLE_CFG_ROLE_CENTRAL,
+    .spsServer = false,
+};
+
+static char gPeerMac[U_SHORT_RANGE_BT_ADDRESS_SIZE] = {0};
+static char gDeviceName[U_BLE_CENTRAL_VALUE_MAX_LENGTH + 1] = {0};
+static int32_t gReadCount = 0;
+static int32_t gCacheSaveCount = 0;
+static int32_t gScanBatchCount = 0;
+
+static const uBleGapScanFilter_t gScanFilter = {
+    .rssiMin = -90,
+    .dedupTtlMs = 5000,
+    .batchWindowMs = 1000,
+    .maxBatchResults = 8
+};
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+static bool scanBatch(const uBleScanResult_t *pResults, size_t numResults, void *pParam)
+{
+    bool keepGoing = true;
+
+    (void)pParam;
+    U_PORT_TEST_ASSERT((numResults > 0) && (numResults <= gScanFilter.maxBatchResults));
+    for (size_t x = 0; x < numResults; x++) {
+        U_PORT_TEST_ASSERT(pResults[x].rssi >= gScanFilter.rssiMin);
+        // An address should only appear once in a batch
+        for (size_t y = x + 1; y < numResults; y++) {
+            U_PORT_TEST_ASSERT(strcmp(pResults[x].address, pResults[y].address) != 0);
+        }
+        if (strstr(pResults[x].name, EXT_SERVER_NAME)) {
+            strncpy(gPeerMac, pResults[x].address, sizeof(gPeerMac));
+            keepGoing = false;
+        }
+    }
+    gScanBatchCount++;
+
+    return keepGoing;
+}
+
+static void readCallback(int32_t peerIndex, size_t charIndex,
+                         int32_t errorOrLength, const uint8_t *pValue,
+                         void *pParam)
+{
+    (void)pParam;
+    U_TEST_PRINT_LINE("peer %d characteristic %d: %d.", peerIndex, charIndex, errorOrLength);
+    if ((peerIndex == 0) && (charIndex == 0) && (errorOrLength >= 0)) {
+        memcpy(gDeviceName, pValue, errorOrLength);
+        gDeviceName[errorOrLength] = 0;
+        gReadCount++;
+    }
+}
+
+static void cacheSaveCallback(const uBleGattCacheEntry_t *pEntry, void *pParam)
+{
+    (void)pParam;
+    U_TEST_PRINT_LINE("GATT cache entry for %s saved: %d service(s), %d characteristic(s).",
+                      pEntry->address, pEntry->numServices, pEntry->numChars);
+    gCacheSaveCount++;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Poll the external NUS server twice, the second time using the
+ * cached value handle, then reconnect and make sure that the GATT
+ * cache means that no discovery is performed.
+ */
+U_PORT_TEST_FUNCTION("[bleCentral]", "bleCentralPoll")
+{
+    int32_t resourceCount;
+    const char *pCharUuids[] = {DEVICE_NAME_CHAR_UUID};
+    uint16_t valueHandle = 0;
+    int32_t peerIndex;
+
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+    U_PORT_TEST_ASSERT(uDeviceInit() == 0);
+    U_TEST_PRINT_LINE("initiating the module");
+    U_PORT_TEST_ASSERT(uDeviceOpen(&gDeviceCfg, &gDeviceHandle) == 0);
+    U_TEST_PRINT_LINE("initiating BLE");
+    U_PORT_TEST_ASSERT(uNetworkInterfaceUp(gDeviceHandle, U_NETWORK_TYPE_BLE, &gNetworkCfg) == 0);
+
+    U_TEST_PRINT_LINE("scanning for server");
+    gPeerMac[0] = 0;
+    for (uint32_t i = 0; !SERVER_FOUND && i < PEER_WAIT_TIME_S / 10; i++) {
+        U_TEST_PRINT_LINE("try #%d", i + 1);
+        U_PORT_TEST_ASSERT(uBleGapScanFiltered(gDeviceHandle,
+                                               U_BLE_GAP_SCAN_DISCOVER_ALL_ONCE,
+                                               true, 10000, &gScanFilter,
+                                               scanBatch, NULL) == 0);
+    }
+    U_TEST_PRINT_LINE("%d batch(es) of scan results.", gScanBatchCount);
+    U_PORT_TEST_ASSERT(SERVER_FOUND);
+
+    // Nothing can be done before the scheduler is started
+    U_PORT_TEST_ASSERT(uBleCentralAddPeer(gPeerMac, pCharUuids, 1) < 0);
+    U_PORT_TEST_ASSERT(uBleCentralPoll(1000) < 0);
+    U_PORT_TEST_ASSERT(uBleGattCacheEnable(cacheSaveCallback, NULL) == 0);
+    U_PORT_TEST_ASSERT(uBleCentralStart(gDeviceHandle, readCallback, NULL) == 0);
+    peerIndex = uBleCentralAddPeer(gPeerMac, pCharUuids, 1);
+    U_PORT_TEST_ASSERT(peerIndex == 0);
+    U_PORT_TEST_ASSERT(uBleCentralGetHandles(peerIndex, &valueHandle, 1) == 1);
+    U_PORT_TEST_ASSERT(valueHandle == 0);
+
+    // BLE connection may fail so do multiple tries if that happens
+    for (uint32_t i = 0; (gReadCount == 0) && i < 3; i++) {
+        U_TEST_PRINT_LINE("polling %s, try #%d", gPeerMac, i + 1);
+        uBleCentralPoll(POLL_TIMEOUT_MS);
+    }
+    U_PORT_TEST_ASSERT(gReadCount > 0);
+    U_TEST_PRINT_LINE("device name is \"%s\".", gDeviceName);
+    U_PORT_TEST_ASSERT(uBleCentralGetHandles(peerIndex, &valueHandle, 1) == 1);
+    U_PORT_TEST_ASSERT(valueHandle != 0);
+
+    // The second poll should use the existing connection and the cached handle
+    gReadCount = 0;
+    U_PORT_TEST_ASSERT(uBleCentralPoll(POLL_TIMEOUT_MS) == 1);
+    U_PORT_TEST_ASSERT(gReadCount == 1);
+    U_PORT_TEST_ASSERT(gCacheSaveCount > 0);
+
+    // Start again, which closes the connection and forgets the
+    // handles held by the scheduler: discovery should now come
+    // from the GATT cache
+    U_PORT_TEST_ASSERT(uBleCentralStop() == 0);
+    gCacheSaveCount = 0;
+    gReadCount = 0;
+    U_PORT_TEST_ASSERT(uBleCentralStart(gDeviceHandle, readCallback, NULL) == 0);
+    U_PORT_TEST_ASSERT(uBleCentralAddPeer(gPeerMac, pCharUuids, 1) == 0);
+    for (uint32_t i = 0; (gReadCount == 0) && i < 3; i++) {
+        U_TEST_PRINT_LINE("polling %s again, try #%d", gPeerMac, i + 1);
+        uBleCentralPoll(POLL_TIMEOUT_MS);
+    }
+    U_PORT_TEST_ASSERT(gReadCount > 0);
+    U_PORT_TEST_ASSERT(gCacheSaveCount == 0);
+
+    U_TEST_PRINT_LINE("closing down the module");
+    U_PORT_TEST_ASSERT(uBleCentralStop() == 0);
+    uBleGattCacheDisable();
+    U_PORT_TEST_ASSERT(uBleGapReset(gDeviceHandle) == 0);
+    U_PORT_TEST_ASSERT(uDeviceClose(gDeviceHandle, false) == 0);
+    uDeviceDeinit();
+    uPortDeinit();
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = resourceCount - uTestUtilGetDynamicResourceCount();
+    U_TEST_PRINT_LINE("we have leaked %d resource(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+#endif
+
+// End of file
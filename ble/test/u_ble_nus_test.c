@@ -151,6 +151,8 @@ static char gPeerResponse[100] = {0};
 
 static int32_t gResourceCountStart;
 
+static volatile size_t gStreamBytesAvailable = 0;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -174,6 +176,12 @@ static void peerIncoming(uint8_t *pValue, uint8_t valueSize)
     gPeerResponse[valueSize] = 0;
 }
 
+static void streamDataAvailable(size_t numBytes, void *pParam)
+{
+    (void)pParam;
+    gStreamBytesAvailable = numBytes;
+}
+
 static void preamble(int32_t role)
 {
     uPortDeinit();
@@ -247,6 +255,26 @@ U_PORT_TEST_FUNCTION("[bleNus]", "bleNusClient")
         U_TEST_PRINT_LINE("No server response before timeout");
     }
     U_PORT_TEST_ASSERT(HAS_RESPONSE);
+
+    // Do the same again in streaming mode
+    U_TEST_PRINT_LINE("starting streaming mode");
+    U_PORT_TEST_ASSERT(uBleNusStreamStart(0, streamDataAvailable, NULL) == 0);
+    gStreamBytesAvailable = 0;
+    U_TEST_PRINT_LINE("streaming command: %s", EXT_SERVER_COMMAND);
+    U_PORT_TEST_ASSERT(uBleNusStreamWrite(EXT_SERVER_COMMAND,
+                                          strlen(EXT_SERVER_COMMAND) + 1) ==
+                       (int32_t)strlen(EXT_SERVER_COMMAND) + 1);
+    for (size_t x = 0; (gStreamBytesAvailable == 0) && (x < 20); x++) {
+        uPortTaskBlock(100);
+    }
+    U_PORT_TEST_ASSERT(gStreamBytesAvailable > 0);
+    gPeerResponse[0] = 0;
+    int32_t length = uBleNusStreamRead(gPeerResponse, sizeof(gPeerResponse) - 1);
+    U_PORT_TEST_ASSERT(length > 0);
+    gPeerResponse[length] = 0;
+    U_TEST_PRINT_LINE("streamed server response: %s", gPeerResponse);
+    U_PORT_TEST_ASSERT(uBleNusStreamRead(gPeerResponse, sizeof(gPeerResponse)) == 0);
+    uBleNusStreamStop();
     postamble();
 }
 
@@ -70,6 +70,7 @@
 #include "u_short_range.h"
 #include "u_short_range_edm_stream.h"
 #include "u_ble.h"
+#include "u_ble_cfg.h"
 
 #include "u_short_range_test_selector.h"
 
@@ -88,6 +89,20 @@
  */
 #define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
 
+#ifndef U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES
+/** The amount of data to send to, and have echoed back by, the
+ * remote SPS peer in the throughput benchmark.
+ */
+# define U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES (1024 * 20)
+#endif
+
+#ifndef U_BLE_SPS_TEST_BENCHMARK_TIMEOUT_MS
+/** How long to allow for the throughput benchmark to be echoed
+ * back in, per run.
+ */
+# define U_BLE_SPS_TEST_BENCHMARK_TIMEOUT_MS 60000
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -98,6 +113,29 @@
 
 static uBleTestPrivate_t gHandles = { -1, -1, NULL, NULL };
 
+#if defined(U_CFG_BLE_MODULE_INTERNAL) && defined(U_BLE_TEST_CFG_REMOTE_SPS_PERIPHERAL)
+/** The address of the remote SPS peer, which echoes what it is sent.
+ */
+static const char gRemoteSpsAddress[] =
+    U_PORT_STRINGIFY_QUOTED(U_BLE_TEST_CFG_REMOTE_SPS_PERIPHERAL);
+
+/** Data to send in the throughput benchmark.
+ */
+static char gBenchmarkData[244];
+
+/** The SPS channel of the benchmark, -1 when not connected.
+ */
+static volatile int32_t gBenchmarkChannel = -1;
+
+/** The MTU of the benchmark connection.
+ */
+static volatile int32_t gBenchmarkMtu = 0;
+
+/** The number of bytes echoed back in the benchmark.
+ */
+static volatile int32_t gBenchmarkBytesReceived = 0;
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -173,6 +211,138 @@ U_PORT_TEST_FUNCTION("[bleSps]", "bleSps")
 
 #endif
 
+#if defined(U_CFG_BLE_MODULE_INTERNAL) && defined(U_BLE_TEST_CFG_REMOTE_SPS_PERIPHERAL)
+
+static void benchmarkDataCallback(int32_t channel, void *pParameters)
+{
+    char buffer[64];
+    int32_t length;
+    (void) pParameters;
+
+    do {
+        length = uBleSpsReceive(gHandles.devHandle, channel, buffer, sizeof(buffer));
+        if (length > 0) {
+            gBenchmarkBytesReceived += length;
+        }
+    } while (length > 0);
+}
+
+static void benchmarkConnectionCallback(int32_t connHandle, char *address, int32_t type,
+                                        int32_t channel, int32_t mtu, void *pParameters)
+{
+    (void) connHandle;
+    (void) address;
+    (void) pParameters;
+
+    if (type == (int32_t) U_BLE_SPS_CONNECTED) {
+        gBenchmarkMtu = mtu;
+        gBenchmarkChannel = channel;
+    } else {
+        gBenchmarkChannel = -1;
+    }
+}
+
+// Connect to the remote SPS peer, send it
+// U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES and wait for it to be echoed
+// back, returning the throughput in bytes per second.
+static int32_t benchmarkRun(bool highThroughput)
+{
+    int32_t bytesSent = 0;
+    int32_t x;
+    int32_t startTimeMs;
+    int32_t durationMs;
+
+    gBenchmarkChannel = -1;
+    gBenchmarkBytesReceived = 0;
+    if (highThroughput) {
+        U_PORT_TEST_ASSERT(uBleSpsEnableHighThroughputOnNext(gHandles.devHandle) == 0);
+    }
+    U_PORT_TEST_ASSERT(uBleSpsConnectSps(gHandles.devHandle, gRemoteSpsAddress, NULL) == 0);
+    for (x = 0; (x < 100) && (gBenchmarkChannel < 0); x++) {
+        uPortTaskBlock(100);
+    }
+    U_PORT_TEST_ASSERT(gBenchmarkChannel >= 0);
+    // Give the link parameter updates time to happen
+    uPortTaskBlock(2000);
+    uBleSpsSetSendTimeout(gHandles.devHandle, gBenchmarkChannel, 1000);
+
+    startTimeMs = uPortGetTickTimeMs();
+    while ((gBenchmarkBytesReceived < U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES) &&
+           (uPortGetTickTimeMs() - startTimeMs < U_BLE_SPS_TEST_BENCHMARK_TIMEOUT_MS)) {
+        if (bytesSent < U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES) {
+            x = U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES - bytesSent;
+            if (x > (int32_t) sizeof(gBenchmarkData)) {
+                x = sizeof(gBenchmarkData);
+            }
+            x = uBleSpsSend(gHandles.devHandle, gBenchmarkChannel, gBenchmarkData, x);
+            U_PORT_TEST_ASSERT(x >= 0);
+            bytesSent += x;
+        } else {
+            uPortTaskBlock(10);
+        }
+    }
+    durationMs = uPortGetTickTimeMs() - startTimeMs;
+    U_TEST_PRINT_LINE("%s: MTU %d, %d byte(s) echoed in %d ms, %d byte(s)/second.",
+                      highThroughput ? "high throughput" : "default", gBenchmarkMtu,
+                      gBenchmarkBytesReceived, durationMs,
+                      durationMs > 0 ? (int32_t) ((((int64_t) gBenchmarkBytesReceived) * 1000) /
+                                                  durationMs) : 0);
+    U_PORT_TEST_ASSERT(gBenchmarkBytesReceived == U_BLE_SPS_TEST_BENCHMARK_SIZE_BYTES);
+
+    U_PORT_TEST_ASSERT(uBleSpsDisconnect(gHandles.devHandle, gBenchmarkChannel) == 0);
+    for (x = 0; (x < 40) && (gBenchmarkChannel >= 0); x++) {
+        uPortTaskBlock(100);
+    }
+    U_PORT_TEST_ASSERT(gBenchmarkChannel < 0);
+
+    return durationMs > 0 ? (int32_t) ((((int64_t) gBenchmarkBytesReceived) * 1000) /
+                                       durationMs) : 0;
+}
+
+/** Measure SPS throughput, with the default link and then with
+ * the high-throughput link, to the remote SPS peer.
+ */
+U_PORT_TEST_FUNCTION("[bleSps]", "bleSpsThroughput")
+{
+    int32_t resourceCount;
+    uBleCfg_t cfg = {.role = U_BLE_CFG_ROLE_CENTRAL, .spsServer = false};
+    int32_t bytesPerSecondDefault;
+    int32_t bytesPerSecondHigh;
+
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    for (size_t x = 0; x < sizeof(gBenchmarkData); x++) {
+        gBenchmarkData[x] = (char) ('0' + (x % 10));
+    }
+
+    U_PORT_TEST_ASSERT(uBleTestPrivatePreamble(U_BLE_MODULE_TYPE_INTERNAL,
+                                               NULL,
+                                               &gHandles) == 0);
+    U_PORT_TEST_ASSERT(uBleCfgConfigure(gHandles.devHandle, &cfg) == 0);
+    U_PORT_TEST_ASSERT(uBleSpsSetCallbackConnectionStatus(gHandles.devHandle,
+                                                          benchmarkConnectionCallback,
+                                                          NULL) == 0);
+    U_PORT_TEST_ASSERT(uBleSpsSetDataAvailableCallback(gHandles.devHandle,
+                                                       benchmarkDataCallback,
+                                                       NULL) == 0);
+
+    bytesPerSecondDefault = benchmarkRun(false);
+    bytesPerSecondHigh = benchmarkRun(true);
+    U_TEST_PRINT_LINE("high throughput is %d%% of default.",
+                      bytesPerSecondDefault > 0 ? (bytesPerSecondHigh * 100) / bytesPerSecondDefault : 0);
+
+    uBleSpsSetDataAvailableCallback(gHandles.devHandle, NULL, NULL);
+    uBleSpsSetCallbackConnectionStatus(gHandles.devHandle, NULL, NULL);
+    uBleTestPrivatePostamble(&gHandles);
+
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+#endif
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
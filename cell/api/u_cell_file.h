@@ -48,10 +48,37 @@ extern "C" {
  */
 #define U_CELL_FILE_NAME_MAX_LENGTH 248
 
+#ifndef U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH
+/** The largest amount of data that a file stream (see
+ * uCellFileStreamOpen()) will move to or from the module in a
+ * single AT command; the limit is there so that one transfer
+ * completes well within the AT timeout applied by uCellFileWrite()
+ * even on a slow (e.g. 115,200 bits/s) link.
+ */
+# define U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH 8192
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** A file stream, used by uCellFileStreamOpen() etc.  The storage
+ * for this is provided by the caller; the contents may be changed
+ * without notice and should not be accessed/relied-upon by the
+ * caller.
+ */
+typedef struct {
+    uDeviceHandle_t cellHandle;
+    char fileName[U_CELL_FILE_NAME_MAX_LENGTH + 1];
+    bool writeNotRead;
+    char *pBuffer;
+    size_t bufferSize;
+    size_t bufferFill;       /* Write: bytes waiting in pBuffer; read: bytes valid in pBuffer. */
+    size_t bufferReadOffset; /* Read only: the next byte in pBuffer to return. */
+    size_t fileOffset;       /* Read only: the next byte of the file to fetch. */
+    size_t fileSize;         /* Read only: the size of the file when opened. */
+} uCellFileStream_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS:  WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -298,6 +325,109 @@ int32_t uCellFileListNext_r(char *pFileName, void **ppRentrant);
  */
 void uCellFileListLast_r(void **ppRentrant);
 
+/** Switch on an in-RAM cache of the default "USER" area of the file
+ * system.  While the cache is on, uCellFileSize() answers from the
+ * cache for any file whose size is known and, once a complete
+ * listing has been obtained with uCellFileListFirst() (or the
+ * re-entrant version), uCellFileListFirst() answers from the
+ * cache too; writes and deletes made through this API keep the
+ * cache up to date.  This saves the AT traffic of, for instance,
+ * checking for the presence of files at every boot.
+ *
+ * IMPORTANT: the cache only knows about changes made through this
+ * API; files created, changed or removed by the module itself (e.g.
+ * HTTP response files, see uCellHttpRequest()) or by another AT
+ * client will not be reflected.  If that matters, switch the cache
+ * off and on again to refresh it.  Also, since tagged areas of the
+ * file system may overlap the default area, any write or delete
+ * made while a tag is set (see uCellFileSetTag()) empties the cache.
+ *
+ * The cache is off by default and is freed when the cellular
+ * instance is removed.
+ *
+ * @param cellHandle the handle of the cellular instance.
+ * @return           zero on success or negative error code on failure.
+ */
+int32_t uCellFileSetCacheOn(uDeviceHandle_t cellHandle);
+
+/** Switch off the file system cache, freeing its memory; see
+ * uCellFileSetCacheOn().
+ *
+ * @param cellHandle the handle of the cellular instance.
+ */
+void uCellFileSetCacheOff(uDeviceHandle_t cellHandle);
+
+/** Open a file stream, allowing a large file to be written or read
+ * piece by piece using a small RAM buffer while the transfers over
+ * the AT interface are made as large as possible: writes are gathered
+ * in pBuffer and sent to the module using uCellFileWrite() once pBuffer
+ * is full, or directly (in chunks of up to
+ * #U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH) where the caller writes more
+ * than pBuffer can hold; reads are fetched with uCellFileBlockRead()
+ * a buffer-full at a time, or directly into the caller's storage for
+ * large reads.  The larger pBuffer is, the fewer AT round trips there
+ * will be.
+ *
+ * Opening a stream for write deletes any existing file of the same
+ * name.  Only files in the default "USER" area of the file system can
+ * be read in this way, see uCellFileSetTag().  A stream is NOT
+ * thread-safe: it should be used from only one task.
+ *
+ * @param cellHandle      the handle of the cellular instance.
+ * @param[in] pFileName   the null-terminated name of the file.
+ * @param writeNotRead    true to open the file for writing, false for
+ *                        reading.
+ * @param[in] pBuffer     a buffer for the stream to use; this MUST
+ *                        remain valid until uCellFileStreamClose()
+ *                        is called; cannot be NULL.
+ * @param bufferSize      the amount of storage at pBuffer.
+ * @param[out] pStream    a pointer to storage for the stream, which
+ *                        must remain valid until uCellFileStreamClose()
+ *                        is called; cannot be NULL.
+ * @return                zero on success or negative error code on
+ *                        failure.
+ */
+int32_t uCellFileStreamOpen(uDeviceHandle_t cellHandle,
+                            const char *pFileName, bool writeNotRead,
+                            char *pBuffer, size_t bufferSize,
+                            uCellFileStream_t *pStream);
+
+/** Write to a file stream opened with writeNotRead set to true.
+ *
+ * @param[in] pStream  a pointer to the stream.
+ * @param[in] pData    the data to write; cannot be NULL.
+ * @param dataSize     the number of bytes at pData.
+ * @return             on success the number of bytes written, which
+ *                     may include bytes not yet sent to the module,
+ *                     else negative error code.
+ */
+int32_t uCellFileStreamWrite(uCellFileStream_t *pStream,
+                             const char *pData, size_t dataSize);
+
+/** Read from a file stream opened with writeNotRead set to false.
+ *
+ * @param[in] pStream  a pointer to the stream.
+ * @param[out] pData   a place to put the data; cannot be NULL.
+ * @param dataSize     the amount of storage at pData.
+ * @return             on success the number of bytes read, zero
+ *                     at the end of the file, else negative error
+ *                     code.
+ */
+int32_t uCellFileStreamRead(uCellFileStream_t *pStream,
+                            char *pData, size_t dataSize);
+
+/** Close a file stream; for a stream opened for writing any data
+ * still held in the buffer is written to the file system.  The
+ * stream storage and buffer may be re-used once this function has
+ * returned.
+ *
+ * @param[in] pStream  a pointer to the stream.
+ * @return             zero on success or negative error code on
+ *                     failure, in which case the data written
+ *                     to the file may be incomplete.
+ */
+int32_t uCellFileStreamClose(uCellFileStream_t *pStream);
+
 #ifdef __cplusplus
 }
 #endif
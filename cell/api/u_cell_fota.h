@@ -130,8 +130,45 @@ typedef struct {
                                 #U_CELL_FOTA_STATUS_TYPE_PERCENTAGE_CHECK or
                                 #U_CELL_FOTA_STATUS_TYPE_PERCENTAGE_INSTALL. */
     } value;
+    int32_t bytesPerSecond; /**< the download throughput measured by this
+                                 code over the current download session,
+                                 -1 if not known; this can only be
+                                 worked out if the image size has been
+                                 given with uCellFotaSetProgress(). */
+    int32_t etaSeconds; /**< the estimated number of seconds until the
+                             download completes, based on the rate
+                             that the download percentage has been
+                             rising, -1 if not known. */
 } uCellFotaStatus_t;
 
+/** The host-side record of the progress of a FOTA download; this
+ * may be read with uCellFotaGetProgress(), stored by the application
+ * in non-volatile memory and then given back with uCellFotaSetProgress()
+ * after a reset of the host so that the progress, throughput and ETA
+ * figures carry on from where they were; the download itself is
+ * carried out, and resumed, by the module.
+ */
+typedef struct {
+    int32_t imageSizeBytes; /**< the size of the FOTA image in bytes,
+                                 -1 if not known; the module does not
+                                 report this, it must be provided by
+                                 the application (e.g. from the
+                                 service that initiated the update). */
+    int32_t bytesReceived;  /**< the number of bytes of the image that
+                                 have been received, derived from the
+                                 download percentage and imageSizeBytes,
+                                 -1 if imageSizeBytes is not known. */
+    size_t percentage;      /**< the most recent download percentage
+                                 reported by the module. */
+    int32_t sessionCount;   /**< the number of download sessions (i.e.
+                                 download starts) that have been seen
+                                 for this image. */
+    int32_t bytesPerSecond; /**< the throughput of the most recent
+                                 download session, -1 if not known. */
+    int32_t etaSeconds;     /**< the estimated time to completion in
+                                 seconds, -1 if not known. */
+} uCellFotaProgress_t;
+
 /** Function signature of the FOTA status callback.
  */
 typedef void (uCellFotaStatusCallback_t) (uDeviceHandle_t cellHandle,
@@ -173,6 +210,38 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
                                    uCellFotaStatusCallback_t *pCallback,
                                    void *pCallbackParameter);
 
+/** Get the host-side progress of a FOTA download, as gathered
+ * from the status URCs while a FOTA status callback has been set
+ * (or as given to uCellFotaSetProgress()).  The application may
+ * store this so that it can be given back to uCellFotaSetProgress()
+ * after a host reset.
+ *
+ * @param cellHandle        the handle of the cellular instance.
+ * @param[out] pProgress    a place to put the progress; cannot be NULL.
+ * @return                  zero on success or negative error code on
+ *                          failure.
+ */
+int32_t uCellFotaGetProgress(uDeviceHandle_t cellHandle,
+                             uCellFotaProgress_t *pProgress);
+
+/** Set the host-side progress of a FOTA download, e.g. to resume
+ * progress tracking after a host reset, using what was previously
+ * read with uCellFotaGetProgress(), or simply to tell this code
+ * the size of the FOTA image so that throughput can be reported
+ * in bytes per second.  The bytesPerSecond and etaSeconds fields
+ * are ignored, they will be recalculated when the next download
+ * progress is reported by the module.  Use NULL to reset the
+ * progress, e.g. when a new image is to be downloaded.
+ *
+ * @param cellHandle        the handle of the cellular instance.
+ * @param[in] pProgress     the progress to resume from; use NULL
+ *                          to clear the progress.
+ * @return                  zero on success or negative error code on
+ *                          failure.
+ */
+int32_t uCellFotaSetProgress(uDeviceHandle_t cellHandle,
+                             const uCellFotaProgress_t *pProgress);
+
 #ifdef __cplusplus
 }
 #endif
@@ -58,14 +58,99 @@ extern "C" {
  */
 #define U_CELL_INFO_ICCID_BUFFER_SIZE 21
 
+#ifndef U_CELL_INFO_IDENTITY_STR_MAX_LENGTH_BYTES
+/** The maximum length of each of the manufacturer, model and
+ * firmware version strings stored in #uCellInfoIdentity_t,
+ * including room for a null terminator.
+ */
+# define U_CELL_INFO_IDENTITY_STR_MAX_LENGTH_BYTES 64
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** A snapshot of the identity of a cellular module, as returned by
+ * uCellInfoGetIdentity(); the application may store this, e.g. in
+ * non-volatile memory, and hand it back with uCellInfoSetIdentity()
+ * after a subsequent power-on to avoid the identity being read from
+ * the module again.  The contents should be treated as opaque.
+ */
+typedef struct {
+    uint32_t fingerprint; /**< a checksum over the remaining fields. */
+    int32_t moduleType;   /**< the uCellModuleType_t of the module. */
+    char imei[U_CELL_INFO_IMEI_SIZE + 1];
+    char manufacturer[U_CELL_INFO_IDENTITY_STR_MAX_LENGTH_BYTES];
+    char model[U_CELL_INFO_IDENTITY_STR_MAX_LENGTH_BYTES];
+    char firmwareVersion[U_CELL_INFO_IDENTITY_STR_MAX_LENGTH_BYTES];
+} uCellInfoIdentity_t;
+
+/** A snapshot of those capabilities of a cellular module that cannot
+ * be known from its type and so are found out by trying AT commands,
+ * as returned by uCellInfoGetCapabilities(); the application may store
+ * this, e.g. in non-volatile memory, and hand it back with
+ * uCellInfoSetCapabilities() after a subsequent power-on so that
+ * the AT commands need not be tried again.  The contents should be
+ * treated as opaque.
+ */
+typedef struct {
+    uint32_t fingerprint;     /**< a checksum over the remaining fields. */
+    int32_t moduleType;       /**< the uCellModuleType_t of the module. */
+    uint32_t probedBitmap;    /**< the capabilities that have been found out. */
+    uint32_t supportedBitmap; /**< of those, the ones that are supported. */
+} uCellInfoCapabilities_t;
+
+/** Callback that will be called when the radio parameters have
+ * changed, see uCellInfoSetRadioParametersCallback().
+ *
+ * @param cellHandle      the handle of the cellular instance.
+ * @param rssiDbm         the new RSSI, as uCellInfoGetRssiDbm().
+ * @param rsrpDbm         the new RSRP, as uCellInfoGetRsrpDbm().
+ * @param rsrqDb          the new RSRQ, as uCellInfoGetRsrqDb().
+ * @param[in] pParameter  the pCallbackParameter that was passed to
+ *                        uCellInfoSetRadioParametersCallback().
+ */
+typedef void (uCellInfoRadioParametersCallback_t)(uDeviceHandle_t cellHandle,
+                                                  int32_t rssiDbm,
+                                                  int32_t rsrpDbm,
+                                                  int32_t rsrqDb,
+                                                  void *pParameter);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
 
+/** Have the radio parameters kept up to date by the module rather
+ * than by polling.  The module is asked to emit its "signal"
+ * indicator URC (AT+CMER/+CIEV) which it does whenever the signal
+ * strength, in bars, changes; on each such change the radio
+ * parameters are refreshed (as uCellInfoRefreshRadioParameters()
+ * would) and, if any of RSSI, RSRP or RSRQ has moved by at least
+ * changeThresholdDb since the last notification (or has become
+ * available/unavailable), pCallback is called.  In the meantime
+ * uCellInfoGetRssiDbm() etc. simply return the cached values, no
+ * AT traffic being involved.
+ *
+ * The indicator reporting is lost if the module is rebooted or
+ * powered off, in which case this function should be called again.
+ *
+ * @param cellHandle          the handle of the cellular instance.
+ * @param changeThresholdDb   the amount by which any of RSSI, RSRP or
+ *                            RSRQ must change for pCallback to be
+ *                            called; zero means any change.
+ * @param[in] pCallback       the callback, use NULL to stop the
+ *                            module reporting the indicator.
+ * @param[in] pCallbackParameter a parameter that will be passed to
+ *                            pCallback as its last parameter; may
+ *                            be NULL.
+ * @return                    zero on success, negative error code on
+ *                            failure.
+ */
+int32_t uCellInfoSetRadioParametersCallback(uDeviceHandle_t cellHandle,
+                                            int32_t changeThresholdDb,
+                                            uCellInfoRadioParametersCallback_t *pCallback,
+                                            void *pCallbackParameter);
+
 /** Refresh the RF status values.  Call this to refresh
  * RSSI, RSRP, RSRQ, Cell ID, EARFCN, etc.  This way all of the
  * values read are synchronised to a given point in time.  The
@@ -305,6 +390,83 @@ int32_t uCellInfoGetModelStr(uDeviceHandle_t cellHandle,
 int32_t uCellInfoGetFirmwareVersionStr(uDeviceHandle_t cellHandle,
                                        char *pStr, size_t size);
 
+/** Get a snapshot of the identity of the cellular module: IMEI,
+ * manufacturer, model and firmware version.  The values are read
+ * from the module (unless a snapshot is already held, see
+ * uCellInfoSetIdentity()) and are then retained so that subsequent
+ * calls to uCellInfoGetImei(), uCellInfoGetManufacturerStr(),
+ * uCellInfoGetModelStr() and uCellInfoGetFirmwareVersionStr() are
+ * answered without talking to the module.
+ *
+ * @param cellHandle         the handle of the cellular instance.
+ * @param[out] pIdentity     a place to put the snapshot; cannot be NULL.
+ * @return                   zero on success, negative error code on
+ *                           failure.
+ */
+int32_t uCellInfoGetIdentity(uDeviceHandle_t cellHandle,
+                             uCellInfoIdentity_t *pIdentity);
+
+/** Hand back a snapshot previously obtained with uCellInfoGetIdentity(),
+ * e.g. after the application has stored it across a power cycle,
+ * so that uCellInfoGetImei(), uCellInfoGetManufacturerStr(),
+ * uCellInfoGetModelStr() and uCellInfoGetFirmwareVersionStr() are
+ * answered from it instead of from the module.  The snapshot is
+ * rejected if its fingerprint is not valid or if it was taken from
+ * a different module type.  The snapshot is retained until this
+ * function is called with NULL or the cellular instance is removed.
+ *
+ * Note that the firmware version will change if the module has been
+ * updated by FOTA, the application should call this function with
+ * NULL and obtain a new snapshot in that case.  The IMSI is not
+ * part of the snapshot since the SIM may be changed while power
+ * is off.
+ *
+ * @param cellHandle         the handle of the cellular instance.
+ * @param[in] pIdentity      the snapshot, use NULL to discard any
+ *                           snapshot held.
+ * @return                   zero on success, else negative error code,
+ *                           #U_ERROR_COMMON_INVALID_PARAMETER if the
+ *                           snapshot is not valid for this module.
+ */
+int32_t uCellInfoSetIdentity(uDeviceHandle_t cellHandle,
+                             const uCellInfoIdentity_t *pIdentity);
+
+/** Get a snapshot of the capabilities of the cellular module that
+ * have been found out so far by trying AT commands; this does not
+ * itself talk to the module.  Each such capability is only tried
+ * once, the outcome being retained until the cellular instance
+ * is removed, including across power-off and reboot.
+ *
+ * @param cellHandle           the handle of the cellular instance.
+ * @param[out] pCapabilities   a place to put the snapshot; cannot
+ *                             be NULL.
+ * @return                     zero on success, negative error code
+ *                             on failure.
+ */
+int32_t uCellInfoGetCapabilities(uDeviceHandle_t cellHandle,
+                                 uCellInfoCapabilities_t *pCapabilities);
+
+/** Hand back a snapshot previously obtained with
+ * uCellInfoGetCapabilities(), e.g. after the application has stored
+ * it across a power cycle, so that the capabilities it covers are
+ * not tried again.  The snapshot replaces whatever is currently
+ * known and is rejected if its fingerprint is not valid or if it
+ * was taken from a different module type.
+ *
+ * As for uCellInfoSetIdentity(), the application should call this
+ * function with NULL, and so start again, if the firmware of the
+ * module has been updated by FOTA.
+ *
+ * @param cellHandle          the handle of the cellular instance.
+ * @param[in] pCapabilities   the snapshot, use NULL to forget all
+ *                            that is known.
+ * @return                    zero on success, else negative error code,
+ *                            #U_ERROR_COMMON_INVALID_PARAMETER if the
+ *                            snapshot is not valid for this module.
+ */
+int32_t uCellInfoSetCapabilities(uDeviceHandle_t cellHandle,
+                                 const uCellInfoCapabilities_t *pCapabilities);
+
 /** Get the UTC time according to cellular.  This feature requires
  * a connection to have been activated and support for this feature
  * is optional in the cellular network.  To get the local time instead
@@ -360,6 +522,28 @@ int32_t uCellInfoGetTimeUtcStr(uDeviceHandle_t cellHandle,
 int64_t uCellInfoGetTime(uDeviceHandle_t cellHandle,
                          int32_t *pTimeZoneSeconds);
 
+/** Switch on or off the RAM time service.  When it is on,
+ * uCellInfoGetTime() and uCellInfoGetTimeUtc() (and their aliases
+ * uCellTimeGet() and uCellTimeGetUtc()) read the module's clock once
+ * and then, until resyncIntervalSeconds has passed, return the time
+ * from RAM, advanced by uPortGetTickTimeMs(), without talking to the
+ * module.  Each re-read of the module's clock is also used to measure
+ * how fast uPortGetTickTimeMs() runs compared with the module's clock
+ * (once at least #U_CELL_INFO_TIME_CACHE_DRIFT_MIN_SECONDS has passed)
+ * and that drift is then corrected for.  The service is off by default;
+ * uCellCfgSetTime() causes the module's clock to be re-read next time.
+ * uCellInfoGetTimeUtcStr() always reads the module's clock.
+ *
+ * @param cellHandle             the handle of the cellular instance.
+ * @param resyncIntervalSeconds  how often to re-read the module's
+ *                               clock; use zero to switch the RAM
+ *                               time service off.
+ * @return                       zero on success else negative error
+ *                               code.
+ */
+int32_t uCellInfoSetTimeCache(uDeviceHandle_t cellHandle,
+                              int32_t resyncIntervalSeconds);
+
 /** Determine if RTS flow control, the signal from the
  * cellular module to this software that the module is
  * ready to receive data, is enabled.
@@ -333,6 +333,30 @@ void uCellLocSetDesiredFixTimeout(uDeviceHandle_t cellHandle,
  */
 int32_t uCellLocGetDesiredFixTimeout(uDeviceHandle_t cellHandle);
 
+/** Set the maximum age of a cached location fix.  If this is
+ * set to a non-zero value then a successful fix obtained with
+ * uCellLocGet() is retained along with the logical ID of the
+ * serving cell at the time and, if uCellLocGet() is called again
+ * within maxAgeSeconds while the serving cell is unchanged, the
+ * retained fix is returned immediately, without sending a new
+ * request to the Cell Locate service.  Setting zero, the default,
+ * switches caching off and discards any retained fix.
+ *
+ * @param cellHandle    the handle of the cellular instance.
+ * @param maxAgeSeconds the maximum age of a cached fix in seconds,
+ *                      zero to switch caching off.
+ */
+void uCellLocSetCacheMaxAge(uDeviceHandle_t cellHandle,
+                            int32_t maxAgeSeconds);
+
+/** Get the maximum age of a cached location fix.
+ *
+ * @param cellHandle  the handle of the cellular instance.
+ * @return            the maximum age in seconds, zero if caching
+ *                    is off, else negative error code.
+ */
+int32_t uCellLocGetCacheMaxAge(uDeviceHandle_t cellHandle);
+
 /** Set whether a GNSS chip attached to the cellular module
  * should be used in the location fix or not.  If this is not
  * called then the default #U_CELL_LOC_GNSS_ENABLE_DEFAULT
@@ -35,6 +35,15 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/* U_CFG_CELL_MODULE_TYPE_ONLY: define this to the suffix of a
+ * member of uCellModuleType_t,
+ * e.g. U_CFG_CELL_MODULE_TYPE_ONLY=SARA_R5, to build the cellular
+ * driver for that module type alone: the feature checks of the
+ * driver then become constants, so that the code for other module
+ * types is dropped by the compiler, and uCellAdd() will reject any
+ * other module type.  Not defined by default.
+ */
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
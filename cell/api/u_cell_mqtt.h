@@ -119,6 +119,23 @@ extern "C" {
 # define U_CELL_MQTT_PROMPT_TIMEOUT_KEEP_ALIVE_SECONDS 30
 #endif
 
+#ifndef U_CELL_MQTT_PUBLISH_WINDOW_SIZE
+/** The maximum number of asynchronous publishes (see
+ * uCellMqttSetPublishCallback()) that may be in flight at any
+ * one time; when this many publishes are awaiting completion
+ * uCellMqttPublish() will return #U_ERROR_COMMON_BUSY.
+ */
+# define U_CELL_MQTT_PUBLISH_WINDOW_SIZE 4
+#endif
+
+#ifndef U_CELL_MQTT_PUBLISH_FILE_NAME
+/** The name of the file on the module's file system that
+ * uCellMqttPublishViaFile() uses to stage a message; the file is
+ * deleted again once the publish has completed.
+ */
+# define U_CELL_MQTT_PUBLISH_FILE_NAME "ubxlib_mqtt_publish.bin"
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -593,6 +610,48 @@ int32_t uCellMqttSetDisconnectCallback(uDeviceHandle_t cellHandle,
                                        void (*pCallback) (int32_t, void *),
                                        void *pCallbackParam);
 
+/** Set a callback to be called when a publish completes; setting
+ * a callback switches uCellMqttPublish() into asynchronous mode:
+ * instead of waiting for the broker to acknowledge each message,
+ * uCellMqttPublish() returns as soon as the module has accepted the
+ * message, returning a non-negative message ID, and pCallback is
+ * called with that message ID when the module indicates that the
+ * publish is complete.  This allows messages to be pipelined, up to
+ * #U_CELL_MQTT_PUBLISH_WINDOW_SIZE of them; when that many are in
+ * flight uCellMqttPublish() returns #U_ERROR_COMMON_BUSY, the caller
+ * should then wait for a callback before trying again.
+ *
+ * The module does not report a message ID when a publish completes;
+ * the message ID is assigned by this code and publishes complete in
+ * the order they were sent.  If a publish has not completed within
+ * #U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS it is completed with the
+ * error code #U_ERROR_COMMON_TIMEOUT by the next call to
+ * uCellMqttPublish(); if the MQTT connection is lost, all publishes
+ * in flight are completed with the error code #U_CELL_ERROR_NOT_CONNECTED.
+ *
+ * Not supported for MQTT-SN or on SARA-R4 modules with the old
+ * syntax, which do not indicate the completion of a publish.
+ *
+ * @param cellHandle         the handle of the cellular instance
+ *                           to be used.
+ * @param[in] pCallback      the callback. The first parameter is the
+ *                           message ID, as returned by uCellMqttPublish(),
+ *                           the second parameter is zero if the publish
+ *                           was successful, else negative error code,
+ *                           the third parameter is pCallbackParam.  The
+ *                           callback is run in the AT client's callback
+ *                           task.  Use NULL to return to synchronous
+ *                           mode, in which case any publishes in flight
+ *                           will not be reported.
+ * @param[in] pCallbackParam this value will be passed to pCallback
+ *                           as the third parameter.
+ * @return                   zero on success else negative error
+ *                           code.
+ */
+int32_t uCellMqttSetPublishCallback(uDeviceHandle_t cellHandle,
+                                    void (*pCallback) (int32_t, int32_t, void *),
+                                    void *pCallbackParam);
+
 /** Set the number of retries that the MQTT client will make for any
  * operation that fails due to the radio interface.  If this function
  * is not called #U_CELL_MQTT_RETRIES_DEFAULT will apply.
@@ -660,13 +719,86 @@ bool uCellMqttIsSupported(uDeviceHandle_t cellHandle);
  *                          by the broker across MQTT disconnects/
  *                          connects.
  * @return                  zero on success else negative error
- *                          code.
+ *                          code; if a publish callback has been set
+ *                          with uCellMqttSetPublishCallback() then,
+ *                          on success, the non-negative message ID
+ *                          is returned instead of zero.
  */
 int32_t uCellMqttPublish(uDeviceHandle_t cellHandle, const char *pTopicNameStr,
                          const char *pMessage,
                          size_t messageSizeBytes,
                          uCellMqttQos_t qos, bool retain);
 
+/** Publish the contents of a file, already present on the module's
+ * file system (e.g. written with uCellFileWrite()), as an MQTT
+ * message.  The message is read from the file by the module itself,
+ * so it need not pass over the AT interface as part of the publish:
+ * use this for messages larger than uCellMqttPublish() can carry;
+ * the maximum size is module-dependent, consult the AT command
+ * manual for your module.  Not supported by SARA-R4 modules with
+ * the old MQTT syntax or by MQTT-SN.  Otherwise behaves in the same
+ * way as uCellMqttPublish(), including asynchronous operation if a
+ * publish callback has been set with uCellMqttSetPublishCallback();
+ * in that case the file must not be modified or deleted until the
+ * callback has been called.
+ *
+ * @param cellHandle        the handle of the cellular instance to
+ *                          be used.
+ * @param[in] pTopicNameStr the null-terminated topic string
+ *                          for the message; cannot be NULL.
+ * @param[in] pFileNameStr  the null-terminated name of the file
+ *                          on the module's file system that contains
+ *                          the message; cannot be NULL, may be up to
+ *                          #U_CELL_FILE_NAME_MAX_LENGTH characters long.
+ * @param qos               the MQTT QoS to use for this message.
+ * @param retain            if true the message will be retained
+ *                          by the broker across MQTT disconnects/
+ *                          connects.
+ * @return                  zero on success else negative error
+ *                          code; if a publish callback has been set
+ *                          with uCellMqttSetPublishCallback() then,
+ *                          on success, the non-negative message ID
+ *                          is returned instead of zero.
+ */
+int32_t uCellMqttPublishFile(uDeviceHandle_t cellHandle,
+                             const char *pTopicNameStr,
+                             const char *pFileNameStr,
+                             uCellMqttQos_t qos, bool retain);
+
+/** Publish a message by first writing it to the file
+ * #U_CELL_MQTT_PUBLISH_FILE_NAME on the module's file system and
+ * then publishing the contents of that file with
+ * uCellMqttPublishFile(); the file is deleted afterwards.  This
+ * is a convenient way of sending messages that are larger than
+ * uCellMqttPublish() can carry: writing the file is a single
+ * binary transfer, with no hex-encoding, whatever the content of
+ * the message.  Since the file has to remain in place until the
+ * publish has completed this function is always blocking; it is
+ * not supported while a publish callback is set with
+ * uCellMqttSetPublishCallback(), use uCellFileWrite() and
+ * uCellMqttPublishFile() directly in that case.  Not supported by
+ * SARA-R4 modules with the old MQTT syntax or by MQTT-SN.
+ *
+ * @param cellHandle        the handle of the cellular instance to
+ *                          be used.
+ * @param[in] pTopicNameStr the null-terminated topic string
+ *                          for the message; cannot be NULL.
+ * @param[in] pMessage      a pointer to the message; the message
+ *                          is not restricted to ASCII values.
+ *                          Cannot be NULL.
+ * @param messageSizeBytes  the length of the message at pMessage.
+ * @param qos               the MQTT QoS to use for this message.
+ * @param retain            if true the message will be retained
+ *                          by the broker across MQTT disconnects/
+ *                          connects.
+ * @return                  zero on success else negative error code.
+ */
+int32_t uCellMqttPublishViaFile(uDeviceHandle_t cellHandle,
+                                const char *pTopicNameStr,
+                                const char *pMessage,
+                                size_t messageSizeBytes,
+                                uCellMqttQos_t qos, bool retain);
+
 /** Subscribe to an MQTT topic. The pKeepGoingCallback()
  * function set during initialisation will be called while
  * this function is waiting for a subscription to complete.
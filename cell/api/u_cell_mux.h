@@ -194,6 +194,32 @@ int32_t uCellMuxAddChannel(uDeviceHandle_t cellHandle,
                            int32_t channel,
                            uDeviceSerial_t **ppDeviceSerial);
 
+/** As uCellMuxAddChannel() but with the size of the receive buffer
+ * for the channel given explicitly.  Each channel has its own receive
+ * buffer and flow control is applied, via the multiplexer protocol,
+ * separately to each channel as its buffer fills up and empties; a
+ * large buffer on a channel that carries sustained bursts of data
+ * (e.g. GNSS at a high NMEA rate) reduces how often that channel
+ * needs to be flow-controlled off.
+ *
+ * @param cellHandle             the handle of the cellular instance.
+ * @param channel                the channel number to open, see
+ *                               uCellMuxAddChannel().
+ * @param receiveBufferSizeBytes the size of the receive buffer to
+ *                               allocate for the channel; use zero
+ *                               for the default, which is the same
+ *                               as that employed by uCellMuxAddChannel().
+ * @param[out] ppDeviceSerial    a pointer to a place to put the
+ *                               handle of the virtual serial port
+ *                               that is the multiplexer channel.
+ * @return                       zero on success or negative error
+ *                               code on failure.
+ */
+int32_t uCellMuxAddChannelExt(uDeviceHandle_t cellHandle,
+                              int32_t channel,
+                              size_t receiveBufferSizeBytes,
+                              uDeviceSerial_t **ppDeviceSerial);
+
 /** Get the serial device for an open multiplexer channel.
  *
  * @param cellHandle the handle of the cellular instance.
@@ -204,6 +230,49 @@ int32_t uCellMuxAddChannel(uDeviceHandle_t cellHandle,
 uDeviceSerial_t *pUCellMuxChannelGetDeviceSerial(uDeviceHandle_t cellHandle,
                                                  int32_t channel);
 
+/** Set a direct delivery callback for a multiplexer channel.  Normally
+ * the received data for a channel is copied into the receive buffer
+ * of its virtual serial port, from where it has to be copied again by
+ * calling read(); with a delivery callback set, data received on the
+ * channel is instead passed to pCallback in place, straight out of the
+ * buffer of the physical serial port, saving a copy and the need for
+ * flow control on the channel.  This is only appropriate for a consumer
+ * that can deal with the data immediately (e.g. a GNSS message parser
+ * adding to a ring buffer of its own):
+ *
+ * - pCallback is called from the multiplexer's receive task while
+ *   the buffer of the physical serial port is locked, so it must be
+ *   quick and must NOT call back into this API or the virtual
+ *   serial port of any multiplexer channel,
+ * - pData is only valid for the duration of the callback,
+ * - a single received frame may be delivered in two calls, where
+ *   the data wraps around the end of the buffer,
+ * - any data that was already in the receive buffer of the virtual
+ *   serial port when the callback was set must still be read with
+ *   read().
+ *
+ * The AT channel, which is always consumed through the AT client,
+ * cannot have a delivery callback.
+ *
+ * @param cellHandle          the handle of the cellular instance.
+ * @param[in] pDeviceSerial   the handle of the virtual serial port that
+ *                            is the multiplexer channel, as returned
+ *                            by uCellMuxAddChannel().
+ * @param[in] pCallback       the callback; use NULL to go back to
+ *                            buffering the received data.
+ * @param[in] pCallbackParam  a parameter that will be passed to pCallback
+ *                            as its last parameter.
+ * @return                    zero on success or negative error code on
+ *                            failure.
+ */
+int32_t uCellMuxSetDeliveryCallback(uDeviceHandle_t cellHandle,
+                                    uDeviceSerial_t *pDeviceSerial,
+                                    void (*pCallback)(uDeviceSerial_t *pDeviceSerial,
+                                                      const char *pData,
+                                                      size_t sizeBytes,
+                                                      void *pCallbackParam),
+                                    void *pCallbackParam);
+
 /** Remove a multiplexer channel.  Note that this does NOT free
  * memory to ensure thread safety; memory is free'd when the cellular
  * instance is closed (or see uCellMuxFree()).
@@ -550,7 +550,9 @@ void uCellNetScanGetLast(uDeviceHandle_t cellHandle);
  *
  * @param cellHandle                 the handle of the cellular instance.
  * @param[in] pCallback              pointer to a function to process each
- *                                   result, as they are returned, where the
+ *                                   result as soon as it is returned by the
+ *                                   module, without waiting for the scan to
+ *                                   complete, where the
  *                                   first parameter is the handle of the
  *                                   cellular device, the second parameter
  *                                   is a pointer to the cell information
@@ -982,6 +982,49 @@ int32_t uCellPwrGetDeepSleepActive(uDeviceHandle_t cellHandle,
 int32_t uCellPwrWakeUpFromDeepSleep(uDeviceHandle_t cellHandle,
                                     bool (*pKeepGoingCallback) (uDeviceHandle_t));
 
+/** Defer a non-urgent operation (e.g. refreshing information,
+ * synchronising time or getting location) so that, if the module is
+ * in deep sleep, it doesn't cost a wake-up of its own.  The operation
+ * is run when the module is next awake anyway (i.e. it has been woken
+ * up for some other reason or its protocol stack wakes up, as
+ * indicated by the +UUPSMR URC), or when latencyBudgetMs has passed,
+ * whichever is the sooner; in the latter case the module is woken up
+ * and ALL of the deferred operations are run together, so that they
+ * share the one wake-up, in the order they were deferred.  If the
+ * module is not in deep sleep the operation is run straight away.
+ *
+ * pCallback is called from the AT client callback task, not from the
+ * context of the caller, and is free to call any of the functions of
+ * this API.  Operations that have not been run when the cellular
+ * instance is removed are discarded.  This requires the timer API of
+ * the port layer to be implemented.
+ *
+ * @param cellHandle       the handle of the cellular instance.
+ * @param latencyBudgetMs  the longest that the operation may be
+ *                         delayed, in milliseconds.
+ * @param[in] pCallback    the operation to run, cannot be NULL.
+ * @param[in] pCallbackParam a parameter that will be passed to
+ *                         pCallback as its second parameter; may
+ *                         be NULL.
+ * @return                 zero on success or negative error code
+ *                         on failure.
+ */
+int32_t uCellPwrDefer(uDeviceHandle_t cellHandle, int32_t latencyBudgetMs,
+                      void (*pCallback) (uDeviceHandle_t cellHandle,
+                                         void *pCallbackParam),
+                      void *pCallbackParam);
+
+/** Run any operations deferred with uCellPwrDefer() now, without
+ * waiting for the module to wake up or for their latency budgets
+ * to run out, e.g. because the application has just woken the
+ * module for something else.
+ *
+ * @param cellHandle  the handle of the cellular instance.
+ * @return            zero on success or negative error code on
+ *                    failure.
+ */
+int32_t uCellPwrDeferFlush(uDeviceHandle_t cellHandle);
+
 /** Disable UART, AKA 32 kHz, sleep. 32 kHz sleep is always
  * enabled where supported by the module; call this function
  * to disable 32 kHz sleep.
@@ -56,6 +56,27 @@ extern "C" {
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Callback for uCellSecZtpRead(), called with each chunk of
+ * each of the items read.
+ *
+ * @param cellHandle      the handle of the cellular instance.
+ * @param item            the item the chunk belongs to: 0 for the
+ *                        device public certificate, 1 for the device
+ *                        private key and 2 for the certificate
+ *                        authorities.
+ * @param[in] pData       the chunk of data, NOT null-terminated; this
+ *                        is only valid for the duration of the callback.
+ * @param size            the number of bytes at pData, may be zero.
+ * @param isLast          true if this is the last chunk of the item.
+ * @param pCallbackParam  the pCallbackParam passed to uCellSecZtpRead().
+ */
+typedef void (*uCellSecZtpCallback_t)(uDeviceHandle_t cellHandle,
+                                      int32_t item,
+                                      const char *pData,
+                                      size_t size,
+                                      bool isLast,
+                                      void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS:  WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -289,6 +310,29 @@ int32_t uCellSecZtpGetCertificateAuthorities(uDeviceHandle_t cellHandle,
                                              char *pData,
                                              size_t dataSizeBytes);
 
+/** Read the device public certificate, the device private key and
+ * the certificate authorities, in that order, in a single locked AT
+ * session, passing the data to pCallback in chunks straight from
+ * the receive buffer of the AT client; no storage for the items
+ * is required, nor is there any need to first find out their size.
+ * This feature is only supported if the Zero Touch Provisioning
+ * feature is enabled for your module.
+ *
+ * pCallback is called with the cellular API locked: it must
+ * not call back into this API.
+ *
+ * @param cellHandle          the handle of the cellular instance.
+ * @param[in] pCallback       the callback that will receive the
+ *                            data; cannot be NULL.
+ * @param[in] pCallbackParam  passed to pCallback, may be NULL.
+ * @return                    on success the total number of bytes
+ *                            passed to pCallback, else negative
+ *                            error code.
+ */
+int32_t uCellSecZtpRead(uDeviceHandle_t cellHandle,
+                        uCellSecZtpCallback_t pCallback,
+                        void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: PRE-SHARED KEY GENERATION
  * -------------------------------------------------------------- */
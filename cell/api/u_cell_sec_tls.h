@@ -120,6 +120,48 @@ void uCellSecTlsPrivateLink(void);
  */
 uCellSecTlsContext_t *pUCellSecSecTlsAdd(uDeviceHandle_t cellHandle);
 
+/** As pUCellSecSecTlsAdd() but, if a free security profile in the
+ * module is known to have been left configured with the settings
+ * identified by settingsKey (see uCellSecTlsSettingsKeySet()), that
+ * profile is re-used without being reset, saving the AT+USECPRF
+ * commands that would otherwise be needed to configure it again.
+ * This function is called internally within ubxlib by the common
+ * TLS security API (common/security/api/u_security_tls.h).
+ *
+ * @param cellHandle          the handle of the cellular instance.
+ * @param settingsKey         a value identifying the complete set of
+ *                            settings that the caller wishes to apply,
+ *                            e.g. a hash of them.
+ * @param[out] pIsConfigured  a place to put whether the profile is
+ *                            already configured with the settings
+ *                            identified by settingsKey, in which case
+ *                            the caller need not configure it; if
+ *                            false the caller must configure the
+ *                            profile and then call
+ *                            uCellSecTlsSettingsKeySet().  May be NULL.
+ * @return                    on success a pointer to the TLS security
+ *                            context, else NULL, in which case
+ *                            uCellSecTlsResetLastError() should be called
+ *                            to determine the cause of the failure).
+ */
+uCellSecTlsContext_t *pUCellSecSecTlsAddCached(uDeviceHandle_t cellHandle,
+                                               uint32_t settingsKey,
+                                               bool *pIsConfigured);
+
+/** Record that the security profile of the given context has been
+ * completely configured with the settings identified by settingsKey,
+ * so that the profile may be re-used by pUCellSecSecTlsAddCached()
+ * once this context has been removed.  The record is forgotten if
+ * any setting of the profile is subsequently changed or the module
+ * is rebooted or powered off.
+ *
+ * @param[in] pContext  a pointer to the TLS security context.
+ * @param settingsKey   the value identifying the settings.
+ * @return              zero on success else negative error code.
+ */
+int32_t uCellSecTlsSettingsKeySet(const uCellSecTlsContext_t *pContext,
+                                  uint32_t settingsKey);
+
 /** Remove a cellular TLS security context.  This function is called
  * internally within ubxlib by the common TLS security API
  * (common/security/api/u_security_tls.h) when a secure connection
@@ -484,6 +526,33 @@ int32_t uCellSecTlsSniSet(const uCellSecTlsContext_t *pContext,
 int32_t uCellSecTlsSniGet(const uCellSecTlsContext_t *pContext,
                           char *pSni, size_t size);
 
+/* ----------------------------------------------------------------
+ * FUNCTIONS: SESSION RESUMPTION
+ * -------------------------------------------------------------- */
+
+/** Switch TLS session resumption on or off; when on, the module
+ * will attempt to resume the previous TLS session with the same
+ * server, avoiding the exchange of certificates that a full
+ * handshake requires.  Session resumption is off by default and
+ * is not supported by all modules: see the AT+USECPRF=13 command
+ * in the AT manual for your module.
+ *
+ * @param[in] pContext a pointer to the security context.
+ * @param onNotOff     true to switch session resumption on,
+ *                     false to switch it off.
+ * @return             zero on success else negative error
+ *                     code.
+ */
+int32_t uCellSecTlsSessionResumptionSet(const uCellSecTlsContext_t *pContext,
+                                        bool onNotOff);
+
+/** Get whether TLS session resumption is on or off.
+ *
+ * @param[in] pContext a pointer to the security context.
+ * @return             true if session resumption is on, else false.
+ */
+bool uCellSecTlsSessionResumptionGet(const uCellSecTlsContext_t *pContext);
+
 #ifdef __cplusplus
 }
 #endif
@@ -80,10 +80,77 @@ extern "C" {
 # define U_CELL_SOCK_DNS_LOOKUP_TIME_SECONDS 332
 #endif
 
+#ifndef U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES
+/** The size of the read-ahead buffer of a TCP socket.  If this
+ * is greater than zero, uCellSockRead() calls asking for less
+ * than this many bytes are served from a per-socket buffer that
+ * is filled with as much as the module will give in one go,
+ * rather than each costing an AT+USORD round trip; useful for
+ * line-oriented protocols.  The buffer is allocated on first
+ * use and free'd, with any unread data, when the socket is
+ * closed.  Zero, the default, means no read-ahead buffer.
+ * #U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES is a sensible value.
+ */
+# define U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES 0
+#endif
+
+#ifndef U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES
+/** The size of the write coalescing buffer of a TCP socket.  If
+ * this is greater than zero, uCellSockWrite() calls of less than
+ * this many bytes are gathered in a per-socket buffer which is
+ * sent to the module, with a single AT+USOWR, when it is full or
+ * #U_CELL_SOCK_WRITE_COALESCE_TIMEOUT_MS after data first went
+ * into it, whichever is the sooner, rather than each costing an
+ * AT round trip.  In the spirit of Nagle's algorithm, setting the
+ * #U_SOCK_OPT_TCP_NODELAY option of a socket to non-zero flushes
+ * the buffer and bypasses it from then on.  Anything buffered is
+ * also flushed before the socket is closed or enters direct-link
+ * mode.  The buffer is allocated on first use.  Zero, the default,
+ * means no write coalescing.
+ */
+# define U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES 0
+#endif
+
+#ifndef U_CELL_SOCK_WRITE_COALESCE_TIMEOUT_MS
+/** The longest time that data may sit in the write coalescing
+ * buffer of a TCP socket, see
+ * #U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES.
+ */
+# define U_CELL_SOCK_WRITE_COALESCE_TIMEOUT_MS 100
+#endif
+
+#ifndef U_CELL_SOCK_DIRECT_LINK_CONNECT_TIMEOUT_MS
+/** The amount of time allowed for the module to respond with
+ * "CONNECT" when a socket is put into direct-link mode (see
+ * #U_SOCK_OPT_DIRECT_LINK); if it does not, AT mode is restored.
+ */
+# define U_CELL_SOCK_DIRECT_LINK_CONNECT_TIMEOUT_MS 10000
+#endif
+
+#ifndef U_CELL_SOCK_DIRECT_LINK_GUARD_TIME_MS
+/** The silent period either side of the "+++" escape sequence
+ * used to leave direct-link mode; this must be longer than
+ * the escape prompt delay of the module (ATS12), which is one
+ * second by default.
+ */
+# define U_CELL_SOCK_DIRECT_LINK_GUARD_TIME_MS 1200
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** One entry in a uCellSockReadBatch() call.
+ */
+typedef struct {
+    int32_t sockHandle;     /**< the handle of the socket to read from. */
+    void *pData;            /**< a buffer in which to store the received bytes. */
+    size_t dataSizeBytes;   /**< the number of bytes of storage available at pData. */
+    int32_t negErrnoOrSize; /**< filled in by uCellSockReadBatch(): the number
+                                 of bytes received else negated value of
+                                 U_SOCK_Exxx from u_sock_errno.h. */
+} uCellSockReadBatch_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS:  WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -166,6 +233,35 @@ int32_t uCellSockConnect(uDeviceHandle_t cellHandle,
                          int32_t sockHandle,
                          const uSockAddress_t *pRemoteAddress);
 
+/** Connect to a server without waiting for the connection to be
+ * made: the module is asked to connect asynchronously and this
+ * function returns straight away; pCallback is called when the
+ * connection has been made, or has failed.  Not all modules
+ * support this, in which case -U_SOCK_ENOSYS is returned and
+ * uCellSockConnect() should be used instead.
+ *
+ * @param cellHandle         the handle of the cellular instance.
+ * @param sockHandle         the handle of the socket.
+ * @param[in] pRemoteAddress the address of the server to
+ *                           connect to, including port number.
+ * @param[in] pCallback      the callback to call when the connection
+ *                           attempt completes, parameters the cellular
+ *                           handle, the socket handle and zero on
+ *                           success else a (non-negated) value of
+ *                           U_SOCK_Exxx from u_sock_errno.h; cannot
+ *                           be NULL.  The callback is called from the
+ *                           AT client callback task.
+ * @return                   -U_SOCK_EINPROGRESS if the connection
+ *                           attempt has been started, else some other
+ *                           negated value of U_SOCK_Exxx from
+ *                           u_sock_errno.h.
+ */
+int32_t uCellSockConnectAsync(uDeviceHandle_t cellHandle,
+                              int32_t sockHandle,
+                              const uSockAddress_t *pRemoteAddress,
+                              void (*pCallback) (uDeviceHandle_t,
+                                                 int32_t, int32_t));
+
 /** Close a socket.
  *
  * @param cellHandle     the handle of the cellular instance.
@@ -415,6 +511,49 @@ int32_t uCellSockReceiveFrom(uDeviceHandle_t cellHandle,
                              uSockAddress_t *pRemoteAddress,
                              void *pData, size_t dataSizeBytes);
 
+/** Send several datagrams, holding the AT interface once for all
+ * of them; each datagram is subject to the same limits as for
+ * uCellSockSendTo().  Sending stops at the first datagram that
+ * fails.
+ *
+ * @param cellHandle         the handle of the cellular instance.
+ * @param sockHandle         the handle of the socket.
+ * @param[in,out] pDatagrams the datagrams to send; the pAddress
+ *                           field of each cannot be NULL.  The
+ *                           outcome of each datagram is written to
+ *                           its negErrnoOrSize field.
+ * @param numDatagrams       the number of entries at pDatagrams.
+ * @return                   the number of datagrams sent else
+ *                           negated value of U_SOCK_Exxx from
+ *                           u_sock_errno.h.
+ */
+int32_t uCellSockSendToBatch(uDeviceHandle_t cellHandle,
+                             int32_t sockHandle,
+                             uSockDatagram_t *pDatagrams,
+                             size_t numDatagrams);
+
+/** Receive several datagrams, holding the AT interface once for
+ * all of them; each datagram is subject to the same limits as for
+ * uCellSockReceiveFrom().  Receiving stops when there are no more
+ * datagrams waiting.
+ *
+ * @param cellHandle         the handle of the cellular instance.
+ * @param sockHandle         the handle of the socket.
+ * @param[in,out] pDatagrams buffers for the datagrams; the pAddress
+ *                           field of each may be NULL.  The outcome
+ *                           of each is written to its negErrnoOrSize
+ *                           field, entries after the first failure
+ *                           are not touched.
+ * @param numDatagrams       the number of entries at pDatagrams.
+ * @return                   the number of datagrams received else
+ *                           negated value of U_SOCK_Exxx from
+ *                           u_sock_errno.h.
+ */
+int32_t uCellSockReceiveFromBatch(uDeviceHandle_t cellHandle,
+                                  int32_t sockHandle,
+                                  uSockDatagram_t *pDatagrams,
+                                  size_t numDatagrams);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: STREAM (TCP)
  * -------------------------------------------------------------- */
@@ -450,6 +589,28 @@ int32_t uCellSockRead(uDeviceHandle_t cellHandle,
                       int32_t sockHandle,
                       void *pData, size_t dataSizeBytes);
 
+/** Receive bytes on several connected sockets in one go: rather
+ * than AT-locking for each socket the AT interface is locked once
+ * and the AT+USORD reads are issued back to back.  Only sockets
+ * which the module has said have data waiting are read, the rest
+ * are given -U_SOCK_EWOULDBLOCK.  Sockets in direct-link mode have
+ * no AT interface: they have their data read directly and, since
+ * the AT interface is then not available, any other sockets are
+ * given -U_SOCK_EBUSY.
+ *
+ * @param cellHandle     the handle of the cellular instance.
+ * @param[in,out] pBatch the sockets to read from and buffers to
+ *                       read into, the outcome for each socket
+ *                       being written to the negErrnoOrSize field.
+ * @param numItems       the number of entries at pBatch.
+ * @return               the total number of bytes received else
+ *                       negated value of U_SOCK_Exxx from
+ *                       u_sock_errno.h.
+ */
+int32_t uCellSockReadBatch(uDeviceHandle_t cellHandle,
+                           uCellSockReadBatch_t *pBatch,
+                           size_t numItems);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: ASYNC
  * -------------------------------------------------------------- */
@@ -55,6 +55,7 @@
 #include "u_cell_private.h" // don't change it
 #include "u_cell_mux.h"
 #include "u_cell_mux_private.h"
+#include "u_cell_pwr_private.h"
 
 // The headers below necessary to work around an Espressif linker problem, see uCellInit()
 #include "u_sock.h"
@@ -104,6 +105,8 @@ static void addCellInstance(uCellPrivateInstance_t *pInstance)
 {
     pInstance->pNext = gpUCellPrivateInstanceList;
     gpUCellPrivateInstanceList = pInstance;
+    // Allow pUCellPrivateGetInstance() to go straight to it
+    U_DEVICE_INSTANCE(pInstance->cellHandle)->pApiInstance = pInstance;
 }
 
 // Remove a cell instance from the list.
@@ -134,10 +137,24 @@ static void removeCellInstance(uCellPrivateInstance_t *pInstance)
             uCellPrivateLocRemoveContext(pInstance);
             // Free any sleep context
             uCellPrivateSleepRemoveContext(pInstance);
+            // Free any deferred operations
+            uCellPwrPrivateDeferRemoveContext(pInstance);
+            // Free the registration semaphore
+            if (pInstance->registrationSemaphore != NULL) {
+                uPortSemaphoreDelete(pInstance->registrationSemaphore);
+            }
             // Free any FOTA context
             uPortFree(pInstance->pFotaContext);
+            // Free any radio parameters callback context
+            uPortFree(pInstance->pRadioParametersContext);
+            // Free any identity snapshot
+            uPortFree(pInstance->pIdentity);
             // Free any HTTP context
             uCellPrivateHttpRemoveContext(pInstance);
+            // Free any file system cache
+            uCellPrivateFileCacheRemove(pInstance);
+            // Free any RAM time service
+            uPortFree(pInstance->pTimeCache);
             // Free any CMUX context
             uCellMuxPrivateRemoveContext(pInstance);
             // Free any CellTime context
@@ -261,7 +278,7 @@ int32_t uCellAdd(uCellModuleType_t moduleType,
 
             // Check parameters
             handleOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-            if (((size_t) moduleType < gUCellPrivateModuleListSize) &&
+            if (U_CELL_PRIVATE_MODULE_IS_SUPPORTED(moduleType) &&
                 (atHandle != NULL) &&
                 (pGetCellInstanceAtHandle(atHandle) == NULL)) {
                 handleOrErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
@@ -293,7 +310,8 @@ int32_t uCellAdd(uCellModuleType_t moduleType,
                         pInstance->networkStatus[x] = U_CELL_NET_STATUS_UNKNOWN;
                     }
                     uCellPrivateClearRadioParameters(&(pInstance->radioParameters), false);
-                    pInstance->pModule = &(gUCellPrivateModuleList[moduleType]);
+                    pInstance->pModule =
+                        &(gUCellPrivateModuleList[U_CELL_PRIVATE_MODULE_INDEX(moduleType)]);
                     pInstance->sockNextLocalPort = -1;
                     pInstance->deepSleepBlockedBy = -1;
                     pInstance->gnssAidMode = U_CELL_LOC_GNSS_AIDING_TYPES;
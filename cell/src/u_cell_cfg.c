@@ -328,7 +328,7 @@ static uCellNetRat_t getRatSaraU2(uCellPrivateInstance_t *pInstance,
         if (rank == 0) {
             // If we were being asked for the RAT at rank 0, this is it
             // as there is no other rank
-            errorOrRat = (int32_t) uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[0]);
+            errorOrRat = (int32_t) uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), modes[0]);
         }
         uPortLog("U_CELL_CFG: RAT is %d (in module terms %d).\n",
                  errorOrRat, modes[0]);
@@ -338,14 +338,15 @@ static uCellNetRat_t getRatSaraU2(uCellPrivateInstance_t *pInstance,
         // number and that indicates the preference
         if (rank == 0) {
             // If we were being asked for the RAT at rank 0, this is it
-            errorOrRat = (int32_t) uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[1]);
+            errorOrRat = (int32_t) uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), modes[1]);
         } else if (rank == 1) {
             // If we were being asked for the RAT at rank 1, it is
             // the OTHER one, the non-preferred RAT, that we must report
             if (modes[1] ==
-                cellRatToModuleRat(pInstance->pModule->moduleType, U_CELL_NET_RAT_GSM_GPRS_EGPRS)) {
+                cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
+                                   U_CELL_NET_RAT_GSM_GPRS_EGPRS)) {
                 errorOrRat = (int32_t)U_CELL_NET_RAT_UTRAN;
-            } else if (modes[1] == cellRatToModuleRat(pInstance->pModule->moduleType, U_CELL_NET_RAT_UTRAN)) {
+            } else if (modes[1] == cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), U_CELL_NET_RAT_UTRAN)) {
                 errorOrRat = (int32_t) U_CELL_NET_RAT_GSM_GPRS_EGPRS;
             }
         }
@@ -403,7 +404,8 @@ static int32_t getRatRankSaraU2(uCellPrivateInstance_t *pInstance,
         // If the first mode is 0 (2G mode) or 2 (3G mode) then we are in
         // single mode operation and so can check for the indicated
         // RAT here
-        if (rat == uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[0])) {
+        if (rat == uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
+                                                  modes[0])) {
             errorCodeOrRank = 0;
         }
     } else if ((modes[0] == 1) && (modes[1] >= 0)) {
@@ -415,7 +417,8 @@ static int32_t getRatRankSaraU2(uCellPrivateInstance_t *pInstance,
         // be at rank 1
         if ((rat == U_CELL_NET_RAT_GSM_GPRS_EGPRS) || (rat == U_CELL_NET_RAT_UTRAN)) {
             errorCodeOrRank = 1;
-            if (rat == uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[1])) {
+            if (rat == uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
+                                                      modes[1])) {
                 errorCodeOrRank = 0;
             }
         }
@@ -444,11 +447,11 @@ static int32_t setRatSaraU2(uCellPrivateInstance_t *pInstance,
     cops = setCops(atHandle, 2);
 
     uPortLog("U_CELL_CFG: setting sole RAT to %d (in module terms %d).\n",
-             rat, cellRatToModuleRat(pInstance->pModule->moduleType, rat));
+             rat, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
     uAtClientLock(atHandle);
     uAtClientCommandStart(atHandle, "AT+URAT=");
     uAtClientWriteInt(atHandle,
-                      cellRatToModuleRat(pInstance->pModule->moduleType, rat));
+                      cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
     uAtClientCommandStopReadResponse(atHandle);
     errorCode = uAtClientUnlock(atHandle);
 
@@ -514,7 +517,7 @@ static int32_t setRatRankSaraU2(uCellPrivateInstance_t *pInstance,
             if (rank == 0) {
                 // ...and we are setting the first rank,
                 // then set the preference in the second number
-                modes[1] = cellRatToModuleRat(pInstance->pModule->moduleType, rat);
+                modes[1] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat);
                 validOperation = true;
             } else if (rank == 1) {
                 // ...otherwise if we are setting the second
@@ -523,11 +526,11 @@ static int32_t setRatRankSaraU2(uCellPrivateInstance_t *pInstance,
                 // In other words, to put 2G at rank 1, we
                 // need to set 3G as our preferred RAT.
                 if (rat == U_CELL_NET_RAT_GSM_GPRS_EGPRS) {
-                    modes[1] = cellRatToModuleRat(pInstance->pModule->moduleType,
+                    modes[1] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                   U_CELL_NET_RAT_UTRAN);
                     validOperation = true;
                 } else if (rat == U_CELL_NET_RAT_UTRAN) {
-                    modes[1] = cellRatToModuleRat(pInstance->pModule->moduleType,
+                    modes[1] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                   U_CELL_NET_RAT_GSM_GPRS_EGPRS);
                     validOperation = true;
                 }
@@ -536,23 +539,23 @@ static int32_t setRatRankSaraU2(uCellPrivateInstance_t *pInstance,
             // ...and we are in single mode...
             if (rank == 0) {
                 // ...then if we are setting rank 0 just set it
-                modes[0] = cellRatToModuleRat(pInstance->pModule->moduleType, rat);
+                modes[0] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat);
                 validOperation = true;
             } else if (rank == 1) {
                 // ...or if we're setting rank 1, then if it
                 // is different from the existing RAT...
-                if (rat != uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[0])) {
+                if (rat != uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), modes[0])) {
                     // ...then switch to dual mode and, as above, set
                     // the opposite of the desired RAT in the second
                     // number.
                     if (rat == U_CELL_NET_RAT_GSM_GPRS_EGPRS) {
                         modes[0] = 1;
-                        modes[1] = cellRatToModuleRat(pInstance->pModule->moduleType,
+                        modes[1] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                       U_CELL_NET_RAT_UTRAN);
                         validOperation = true;
                     } else if (rat == U_CELL_NET_RAT_UTRAN) {
                         modes[0] = 1;
-                        modes[1] = cellRatToModuleRat(pInstance->pModule->moduleType,
+                        modes[1] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                       U_CELL_NET_RAT_GSM_GPRS_EGPRS);
                         validOperation = true;
                     }
@@ -572,15 +575,15 @@ static int32_t setRatRankSaraU2(uCellPrivateInstance_t *pInstance,
                 // then we set the single mode to be
                 // the opposite of the currently
                 // preferred RAT
-                if (uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[1]) ==
-                    U_CELL_NET_RAT_GSM_GPRS_EGPRS) {
-                    modes[0] = cellRatToModuleRat(pInstance->pModule->moduleType,
+                if (uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
+                                                   modes[1]) == U_CELL_NET_RAT_GSM_GPRS_EGPRS) {
+                    modes[0] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                   U_CELL_NET_RAT_UTRAN);
                     modes[1] = -1;
                     validOperation = true;
-                } else if (uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType,
+                } else if (uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                           modes[1]) == U_CELL_NET_RAT_UTRAN) {
-                    modes[0] = cellRatToModuleRat(pInstance->pModule->moduleType,
+                    modes[0] = cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                   U_CELL_NET_RAT_GSM_GPRS_EGPRS);
                     modes[1] = -1;
                     validOperation = true;
@@ -602,7 +605,8 @@ static int32_t setRatRankSaraU2(uCellPrivateInstance_t *pInstance,
         for (size_t x = 0; (x < sizeof(modes) / sizeof(modes[0])); x++) {
             if (modes[x] >= 0) {
                 uPortLog("  rank[%d]: %d (in module terms %d).\n", x,
-                         uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, modes[x]),
+                         uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
+                                                        modes[x]),
                          modes[x]);
             } else {
                 uPortLog("  rank[%d]: %d (in module terms %d).\n", x,
@@ -621,7 +625,7 @@ static int32_t setRatRankSaraU2(uCellPrivateInstance_t *pInstance,
     } else {
         uPortLog("U_CELL_CFG: setting RAT %d (in module terms %d) at rank %d"
                  " is not a valid thing to do.\n", rat,
-                 cellRatToModuleRat(pInstance->pModule->moduleType, rat), rank);
+                 cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat), rank);
     }
 
     // Put AT+COPS back
@@ -664,7 +668,7 @@ static uCellNetRat_t getRatSaraRx(const uCellPrivateInstance_t *pInstance,
     // Read up to N integers representing the RATs
     for (size_t x = 0; x < pInstance->pModule->maxNumSimultaneousRats; x++) {
         rat = uAtClientReadInt(atHandle);
-        rats[x] = uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, rat);
+        rats[x] = uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat);
     }
     uAtClientResponseStop(atHandle);
     if (uAtClientUnlock(atHandle) == 0) {
@@ -673,7 +677,7 @@ static uCellNetRat_t getRatSaraRx(const uCellPrivateInstance_t *pInstance,
     uPortLog("U_CELL_CFG: RATs are:\n");
     for (size_t x = 0; x < sizeof(rats) / sizeof(rats[0]); x++) {
         uPortLog("  rank[%d]: %d (in module terms %d).\n",
-                 x, rats[x], cellRatToModuleRat(pInstance->pModule->moduleType, rats[x]));
+                 x, rats[x], cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rats[x]));
     }
 
     return (uCellNetRat_t) errorOrRat;
@@ -697,7 +701,7 @@ static int32_t getRatRankSaraRx(const uCellPrivateInstance_t *pInstance,
     for (size_t x = 0; (errorCodeOrRank < 0) &&
          (x < pInstance->pModule->maxNumSimultaneousRats); x++) {
         y = uAtClientReadInt(atHandle);
-        if (rat == uCellPrivateModuleRatToCellRat(pInstance->pModule->moduleType, y)) {
+        if (rat == uCellPrivateModuleRatToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), y)) {
             errorCodeOrRank = (int32_t) x;
         }
     }
@@ -716,7 +720,7 @@ static int32_t setRatSaraRx(uCellPrivateInstance_t *pInstance,
     uAtClientHandle_t atHandle = pInstance->atHandle;
     int32_t cFunMode = -1;
 
-    if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+    if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
         // For SARA-R5 the module has to be in state AT+CFUN=0
         cFunMode = uCellPrivateCFunGet(pInstance);
         if (cFunMode != 0) {
@@ -726,10 +730,10 @@ static int32_t setRatSaraRx(uCellPrivateInstance_t *pInstance,
 
     // Do the mode change
     uPortLog("U_CELL_CFG: setting sole RAT to %d (in module terms %d).\n",
-             rat, cellRatToModuleRat(pInstance->pModule->moduleType, rat));
+             rat, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
     uAtClientLock(atHandle);
     uAtClientCommandStart(atHandle, "AT+URAT=");
-    uAtClientWriteInt(atHandle, cellRatToModuleRat(pInstance->pModule->moduleType, rat));
+    uAtClientWriteInt(atHandle, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
     uAtClientCommandStopReadResponse(atHandle);
     errorCode = uAtClientUnlock(atHandle);
 
@@ -768,7 +772,7 @@ static int32_t setRatRankSaraRx(uCellPrivateInstance_t *pInstance,
 
     uPortLog("U_CELL_CFG: setting the RAT at rank %d to"
              " %d (in module terms %d).\n",
-             rank, rat, cellRatToModuleRat(pInstance->pModule->moduleType, rat));
+             rank, rat, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
     // Remove duplicates
     for (size_t x = 0; x < sizeof(rats) / sizeof(rats[0]); x++) {
         for (size_t y = x + 1; y < sizeof(rats) / sizeof(rats[0]); y++) {
@@ -779,7 +783,7 @@ static int32_t setRatRankSaraRx(uCellPrivateInstance_t *pInstance,
         }
     }
 
-    if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+    if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
         // For SARA-R5 the module has to be in state AT+CFUN=0
         cFunMode = uCellPrivateCFunGet(pInstance);
         if (cFunMode != 0) {
@@ -791,7 +795,7 @@ static int32_t setRatRankSaraRx(uCellPrivateInstance_t *pInstance,
     uPortLog("U_CELL_CFG: RATs (removing duplicates) become:\n");
     for (size_t x = 0; x < sizeof(rats) / sizeof(rats[0]); x++) {
         uPortLog("  rank[%d]: %d (in module terms %d).\n",
-                 x, rats[x], cellRatToModuleRat(pInstance->pModule->moduleType,
+                 x, rats[x], cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                 (uCellNetRat_t) rats[x]));
     }
     uAtClientLock(atHandle);
@@ -799,7 +803,7 @@ static int32_t setRatRankSaraRx(uCellPrivateInstance_t *pInstance,
     for (size_t x = 0; x < sizeof(rats) / sizeof(rats[0]); x++) {
         if (rats[x] != (int32_t) U_CELL_NET_RAT_UNKNOWN_OR_NOT_USED) {
             uAtClientWriteInt(atHandle,
-                              cellRatToModuleRat(pInstance->pModule->moduleType,
+                              cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
                                                  (uCellNetRat_t) rats[x]));
         }
     }
@@ -919,7 +923,7 @@ static int32_t addGreetingUrc(uCellPrivateInstance_t *pInstance,
     // +1 for terminator, +2 for the SARA-R41X workaround
     char buffer[U_CELL_CFG_GREETING_CALLBACK_MAX_LEN_BYTES + 1 + 2];
 
-    if (U_CELL_PRIVATE_MODULE_IS_SARA_R41X(pInstance->pModule->moduleType)) {
+    if (U_CELL_PRIVATE_MODULE_IS_SARA_R41X(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
         // This is necessary since SARA-R41X modules add an odd set of
         // control characters before the greeting string: usually this is
         // a null and then 0x0a (LF) 0x0d (CR), rather than the usual CR/LF.
@@ -954,7 +958,7 @@ static void removeGreetingUrc(uCellPrivateInstance_t *pInstance,
     // +1 for terminator, +2 for the SARA-R41X workaround
     char buffer[U_CELL_CFG_GREETING_CALLBACK_MAX_LEN_BYTES + 1 + 2];
 
-    if (U_CELL_PRIVATE_MODULE_IS_SARA_R41X(pInstance->pModule->moduleType)) {
+    if (U_CELL_PRIVATE_MODULE_IS_SARA_R41X(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
         // Same reasoning as for addGreetingUrc()
         strncpy(buffer + 2, pStr, sizeof(buffer) - 2);
         // Add LF/CR at the start
@@ -983,18 +987,14 @@ static int32_t setAndStoreBaudRate(const uCellPrivateInstance_t *pInstance,
     uAtClientLock(atHandle);
     uAtClientCommandStart(atHandle, "AT+IPR=");
     uAtClientWriteInt(atHandle, baudRate);
-    uAtClientCommandStopReadResponse(atHandle);
-    errorCode = uAtClientUnlock(atHandle);
-    if ((errorCode == 0) &&
-        U_CELL_PRIVATE_HAS(pInstance->pModule,
+    if (U_CELL_PRIVATE_HAS(pInstance->pModule,
                            U_CELL_PRIVATE_FEATURE_AT_PROFILES)) {
         // Make sure it is stored in an NVM profile,
-        // where supported
-        uAtClientLock(atHandle);
-        uAtClientCommandStart(atHandle, "AT&W");
-        uAtClientCommandStopReadResponse(atHandle);
-        errorCode = uAtClientUnlock(atHandle);
+        // where supported, on the same command line
+        uAtClientCommandAppend(atHandle, "&W");
     }
+    uAtClientCommandStopReadResponse(atHandle);
+    errorCode = uAtClientUnlock(atHandle);
 
     return errorCode;
 }
@@ -1029,12 +1029,13 @@ int32_t uCellCfgSetBandMask(uDeviceHandle_t cellHandle,
                 atHandle = pInstance->atHandle;
                 uPortLog("U_CELL_CFG: setting band mask for RAT %d (in module"
                          " terms %d) to 0x%08x%08x %08x%08x.\n",
-                         rat, cellRatToModuleRatBandMask(pInstance->pModule->moduleType, rat),
+                         rat, cellRatToModuleRatBandMask(U_CELL_PRIVATE_MODULE_TYPE(pInstance),
+                                                         rat),
                          (uint32_t) (bandMask2 >> 32), (uint32_t) bandMask2,
                          (uint32_t) (bandMask1 >> 32), (uint32_t) bandMask1);
                 uAtClientLock(atHandle);
                 uAtClientCommandStart(atHandle, "AT+UBANDMASK=");
-                uAtClientWriteInt(atHandle, cellRatToModuleRatBandMask(pInstance->pModule->moduleType, rat));
+                uAtClientWriteInt(atHandle, cellRatToModuleRatBandMask(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
                 uAtClientWriteUint64(atHandle, bandMask1);
                 uAtClientWriteUint64(atHandle, bandMask2);
                 uAtClientCommandStopReadResponse(atHandle);
@@ -1093,7 +1094,7 @@ int32_t uCellCfgGetBandMask(uDeviceHandle_t cellHandle,
 
             atHandle = pInstance->atHandle;
             uPortLog("U_CELL_CFG: getting band mask for RAT %d (in module terms %d).\n",
-                     rat, cellRatToModuleRatBandMask(pInstance->pModule->moduleType, rat));
+                     rat, cellRatToModuleRatBandMask(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
             uAtClientLock(atHandle);
             uAtClientCommandStart(atHandle, "AT+UBANDMASK?");
             uAtClientCommandStop(atHandle);
@@ -1169,10 +1170,10 @@ int32_t uCellCfgGetBandMask(uDeviceHandle_t cellHandle,
 
             // Convert the RAT numbering to keep things simple on the brain
             for (size_t x = 0; x < sizeof(rats) / sizeof(rats[0]); x++) {
-                rats[x] = (int32_t) moduleRatBandMaskToCellRat(pInstance->pModule->moduleType, rats[x]);
+                rats[x] = (int32_t) moduleRatBandMaskToCellRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rats[x]);
             }
 
-            if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_LARA_R6) {
+            if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_LARA_R6) {
                 // LARA-R6 uses the same band-mask number for both 2G and 3G, which
                 // will have been converted to our 2G RAT number by
                 // moduleRatBandMaskToCellRat() so, if the user has asked for
@@ -1189,7 +1190,7 @@ int32_t uCellCfgGetBandMask(uDeviceHandle_t cellHandle,
                     *pBandMask2 = masks[x][1];
                     uPortLog("U_CELL_CFG: band mask for RAT %d (in module terms %d)"
                              " is 0x%08x%08x %08x%08x.\n",
-                             rat, cellRatToModuleRat(pInstance->pModule->moduleType, rat),
+                             rat, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat),
                              (uint32_t) (*pBandMask2 >> 32), (uint32_t) (*pBandMask2),
                              (uint32_t) (*pBandMask1 >> 32), (uint32_t) (*pBandMask1));
                     errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
@@ -1226,7 +1227,7 @@ int32_t uCellCfgSetRat(uDeviceHandle_t cellHandle,
                 // different between SARA-U2 versus
                 // SARA-R4/R5 so do them in separate
                 // functions
-                if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_U201) {
+                if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_U201) {
                     errorCode = setRatSaraU2(pInstance, rat);
                 } else {
                     // Do the mode change
@@ -1273,7 +1274,7 @@ int32_t uCellCfgSetRatRank(uDeviceHandle_t cellHandle,
                 // different between SARA-U2 versus
                 // SARA-R4/R5 so do them in separate
                 // functions
-                if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_U201) {
+                if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_U201) {
                     errorCode = setRatRankSaraU2(pInstance, rat, rank);
                 } else {
                     errorCode = setRatRankSaraRx(pInstance, rat, rank);
@@ -1313,7 +1314,7 @@ uCellNetRat_t uCellCfgGetRat(uDeviceHandle_t cellHandle,
             // different between SARA-U2 versus
             // SARA-R4/R5 so do them in separate
             // functions
-            if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_U201) {
+            if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_U201) {
                 errorCodeOrRat = (int32_t) getRatSaraU2(pInstance, rank);
             } else {
                 errorCodeOrRat = (int32_t) getRatSaraRx(pInstance, rank);
@@ -1347,7 +1348,7 @@ int32_t uCellCfgGetRatRank(uDeviceHandle_t cellHandle,
             // different between SARA-U2 versus
             // SARA-R4/R5 so do them in separate
             // functions
-            if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_U201) {
+            if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_U201) {
                 errorCodeOrRank = (int32_t) getRatRankSaraU2(pInstance, rat);
             } else {
                 errorCodeOrRank = (int32_t) getRatRankSaraRx(pInstance, rat);
@@ -1355,11 +1356,11 @@ int32_t uCellCfgGetRatRank(uDeviceHandle_t cellHandle,
 
             if (errorCodeOrRank >= 0) {
                 uPortLog("U_CELL_CFG: rank of RAT %d (in module terms"
-                         " %d) is %d.\n", rat, cellRatToModuleRat(pInstance->pModule->moduleType, rat),
+                         " %d) is %d.\n", rat, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat),
                          errorCodeOrRank);
             } else {
                 uPortLog("U_CELL_CFG: RAT %d (in module terms %d) "
-                         " is not ranked.\n", rat, cellRatToModuleRat(pInstance->pModule->moduleType, rat));
+                         " is not ranked.\n", rat, cellRatToModuleRat(U_CELL_PRIVATE_MODULE_TYPE(pInstance), rat));
             }
         }
 
@@ -1953,6 +1954,12 @@ int64_t uCellCfgSetTime(uDeviceHandle_t cellHandle, int64_t timeLocal,
             errorCode = uAtClientUnlock(atHandle);
             if (errorCode == 0) {
                 uPortLog("U_CELL_CFG: time set to %s.\n", buffer);
+                if (pInstance->pTimeCache != NULL) {
+                    // Make the RAM time service re-read the
+                    // module's clock, and start measuring
+                    // drift again, next time around
+                    pInstance->pTimeCache->synced = false;
+                }
             }
         }
 
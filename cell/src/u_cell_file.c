@@ -39,6 +39,7 @@
 #include "u_error_common.h"
 #include "u_port.h"
 #include "u_port_os.h"
+#include "u_port_heap.h"
 #include "u_at_client.h"
 #include "u_cell_module_type.h"
 #include "u_cell_net.h"
@@ -58,6 +59,246 @@ static uCellPrivateFileListContainer_t *gpFileList = NULL;
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Get the file system cache for an instance, NULL if the cache
+// is off or doesn't apply because a tag is in use.
+static uCellPrivateFileCache_t *pCacheGet(const uCellPrivateInstance_t *pInstance)
+{
+    uCellPrivateFileCache_t *pCache = NULL;
+
+    if (pInstance->pFileSystemTag == NULL) {
+        pCache = pInstance->pFileCache;
+    }
+
+    return pCache;
+}
+
+// Find a file in the cache.
+static uCellPrivateFileCacheEntry_t *pCacheFind(const uCellPrivateFileCache_t *pCache,
+                                                const char *pFileName)
+{
+    uCellPrivateFileCacheEntry_t *pEntry = pCache->pList;
+
+    while ((pEntry != NULL) && (strcmp(pEntry->pFileName, pFileName) != 0)) {
+        pEntry = pEntry->pNext;
+    }
+
+    return pEntry;
+}
+
+// Add a file to the end of the cache, or update the size of an
+// existing one; the file name need not be null-terminated.
+static void cacheAdd(uCellPrivateFileCache_t *pCache, const char *pFileName,
+                     size_t fileNameLength, int32_t size)
+{
+    uCellPrivateFileCacheEntry_t **ppEntry = &(pCache->pList);
+    uCellPrivateFileCacheEntry_t *pEntry = NULL;
+
+    while ((*ppEntry != NULL) && (pEntry == NULL)) {
+        if ((strlen((*ppEntry)->pFileName) == fileNameLength) &&
+            (memcmp((*ppEntry)->pFileName, pFileName, fileNameLength) == 0)) {
+            pEntry = *ppEntry;
+        } else {
+            ppEntry = &((*ppEntry)->pNext);
+        }
+    }
+    if (pEntry == NULL) {
+        // +1 for the terminator
+        pEntry = (uCellPrivateFileCacheEntry_t *) pUPortMalloc(sizeof(*pEntry) +
+                                                               fileNameLength + 1);
+        if (pEntry != NULL) {
+            pEntry->pFileName = ((char *) pEntry) + sizeof(*pEntry);
+            memcpy(pEntry->pFileName, pFileName, fileNameLength);
+            *(pEntry->pFileName + fileNameLength) = 0;
+            pEntry->pNext = NULL;
+            *ppEntry = pEntry;
+        } else {
+            // Can't keep track any more
+            pCache->listComplete = false;
+        }
+    }
+    if (pEntry != NULL) {
+        pEntry->size = size;
+    }
+}
+
+// Remove a file from the cache.
+static void cacheRemove(uCellPrivateFileCache_t *pCache, const char *pFileName)
+{
+    uCellPrivateFileCacheEntry_t **ppEntry = &(pCache->pList);
+    uCellPrivateFileCacheEntry_t *pEntry;
+
+    while (*ppEntry != NULL) {
+        pEntry = *ppEntry;
+        if (strcmp(pEntry->pFileName, pFileName) == 0) {
+            *ppEntry = pEntry->pNext;
+            uPortFree(pEntry);
+        } else {
+            ppEntry = &(pEntry->pNext);
+        }
+    }
+}
+
+// Empty the cache.
+static void cacheClear(uCellPrivateFileCache_t *pCache)
+{
+    uCellPrivateFileCacheEntry_t *pEntry;
+
+    while (pCache->pList != NULL) {
+        pEntry = pCache->pList->pNext;
+        uPortFree(pCache->pList);
+        pCache->pList = pEntry;
+    }
+    pCache->listComplete = false;
+}
+
+// Update the cache after a write to a file.
+static void cacheWrite(uCellPrivateInstance_t *pInstance, const char *pFileName,
+                       int32_t errorCodeOrSize)
+{
+    uCellPrivateFileCache_t *pCache = pCacheGet(pInstance);
+    uCellPrivateFileCacheEntry_t *pEntry;
+
+    if (pCache != NULL) {
+        pEntry = pCacheFind(pCache, pFileName);
+        if (pEntry != NULL) {
+            if ((errorCodeOrSize >= 0) && (pEntry->size >= 0)) {
+                // Writes append
+                pEntry->size += errorCodeOrSize;
+            } else {
+                // Don't know what happened
+                pEntry->size = -1;
+            }
+        } else if (pCache->listComplete) {
+            if (errorCodeOrSize >= 0) {
+                // Must be a new file
+                cacheAdd(pCache, pFileName, strlen(pFileName), errorCodeOrSize);
+            } else {
+                // Don't know whether the file now exists or not
+                pCache->listComplete = false;
+            }
+        }
+    } else if (pInstance->pFileCache != NULL) {
+        // A tag is in use and tagged areas may overlap the
+        // default area, so we no longer know anything
+        cacheClear(pInstance->pFileCache);
+    }
+}
+
+// Update the cache after a delete.
+static void cacheDelete(uCellPrivateInstance_t *pInstance, const char *pFileName)
+{
+    uCellPrivateFileCache_t *pCache = pCacheGet(pInstance);
+
+    if (pCache != NULL) {
+        cacheRemove(pCache, pFileName);
+    } else if (pInstance->pFileCache != NULL) {
+        // As for cacheWrite()
+        cacheClear(pInstance->pFileCache);
+    }
+}
+
+// Populate the cache from a file listing, where pFileName is the
+// first file name and pList the remainder of the list; the sizes
+// of any files already in the cache are retained.
+static void cacheList(uCellPrivateFileCache_t *pCache, const char *pFileName,
+                      const uCellPrivateFileListContainer_t *pList)
+{
+    uCellPrivateFileCache_t oldCache;
+    uCellPrivateFileCacheEntry_t *pEntry;
+    int32_t size;
+
+    oldCache = *pCache;
+    pCache->pList = NULL;
+    pCache->listComplete = true;
+    size = -1;
+    pEntry = pCacheFind(&oldCache, pFileName);
+    if (pEntry != NULL) {
+        size = pEntry->size;
+    }
+    cacheAdd(pCache, pFileName, strlen(pFileName), size);
+    for (; pList != NULL; pList = pList->pNext) {
+        size = -1;
+        for (pEntry = oldCache.pList; pEntry != NULL; pEntry = pEntry->pNext) {
+            if ((strlen(pEntry->pFileName) == pList->fileNameLength) &&
+                (memcmp(pEntry->pFileName, pList->pFileName, pList->fileNameLength) == 0)) {
+                size = pEntry->size;
+            }
+        }
+        cacheAdd(pCache, pList->pFileName, pList->fileNameLength, size);
+    }
+    cacheClear(&oldCache);
+}
+
+// Make a file listing from the cache, in the same form as
+// uCellPrivateFileListFirst().
+static int32_t cacheListFirst(const uCellPrivateFileCache_t *pCache,
+                              uCellPrivateFileListContainer_t **ppList,
+                              char *pFileName)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+    uCellPrivateFileListContainer_t **ppTail = ppList;
+    uCellPrivateFileListContainer_t *pContainer;
+    size_t fileNameLength;
+    int32_t count = 0;
+
+    for (uCellPrivateFileCacheEntry_t *pEntry = pCache->pList;
+         (pEntry != NULL) && (errorCodeOrCount != (int32_t) U_ERROR_COMMON_NO_MEMORY);
+         pEntry = pEntry->pNext) {
+        fileNameLength = strlen(pEntry->pFileName);
+        pContainer = (uCellPrivateFileListContainer_t *) pUPortMalloc(sizeof(*pContainer) +
+                                                                      fileNameLength);
+        if (pContainer != NULL) {
+            pContainer->pFileName = ((char *) pContainer) + sizeof(*pContainer);
+            memcpy(pContainer->pFileName, pEntry->pFileName, fileNameLength);
+            pContainer->fileNameLength = fileNameLength;
+            pContainer->pNext = NULL;
+            *ppTail = pContainer;
+            ppTail = &(pContainer->pNext);
+            count++;
+        } else {
+            errorCodeOrCount = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        }
+    }
+    if (errorCodeOrCount == (int32_t) U_ERROR_COMMON_NO_MEMORY) {
+        uCellPrivateFileListLast(ppList);
+    } else if (count > 0) {
+        errorCodeOrCount = count;
+        // Copy out the first item and remove it
+        uCellPrivateFileListNext(ppList, pFileName);
+    }
+
+    return errorCodeOrCount;
+}
+
+// Write data to a file in chunks of at most
+// U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH.
+static int32_t writeChunks(uDeviceHandle_t cellHandle, const char *pFileName,
+                           const char *pData, size_t dataSize)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    size_t thisSize;
+    int32_t x;
+
+    while ((dataSize > 0) && (errorCode == 0)) {
+        thisSize = dataSize;
+        if (thisSize > U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH) {
+            thisSize = U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH;
+        }
+        x = uCellFileWrite(cellHandle, pFileName, pData, thisSize);
+        if (x == (int32_t) thisSize) {
+            pData += thisSize;
+            dataSize -= thisSize;
+        } else {
+            errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+            if (x < 0) {
+                errorCode = x;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -173,6 +414,7 @@ int32_t uCellFileWrite(uDeviceHandle_t cellHandle,
                 uAtClientResponseStop(atHandle);
                 errorCode = uAtClientUnlock(atHandle);
             }
+            cacheWrite(pInstance, pFileName, errorCode);
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
@@ -215,7 +457,7 @@ int32_t uCellFileRead(uDeviceHandle_t cellHandle,
             }
             uAtClientCommandStop(atHandle);
             // Grab the response
-            if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+            if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                 // SARA-R4 only puts \n before the
                 // response, not \r\n as it should
                 uAtClientResponseStart(atHandle, "\n+URDFILE:");
@@ -235,17 +477,16 @@ int32_t uCellFileRead(uDeviceHandle_t cellHandle,
             // Get the leading quote mark out of the way
             uAtClientReadBytes(atHandle, NULL, 1, true);
             // Now read out all the actual data,
-            // first the bit we want
-            readSize = uAtClientReadBytes(atHandle, pData,
-                                          // Cast in two stages to keep Lint happy
-                                          (size_t)  (unsigned) readSize,
-                                          true);
+            // first the bit we want, straight from the
+            // AT client's buffer
+            readSize = uCellPrivateReadBytesInPlace(atHandle, pData,
+                                                    // Cast in two stages to keep Lint happy
+                                                    (size_t)  (unsigned) readSize);
             if (indicatedReadSize > readSize) {
                 //...and then the rest poured away to NULL
-                uAtClientReadBytes(atHandle, NULL,
-                                   // Cast in two stages to keep Lint happy
-                                   (size_t) (unsigned) (indicatedReadSize - readSize),
-                                   true);
+                uCellPrivateReadBytesInPlace(atHandle, NULL,
+                                             // Cast in two stages to keep Lint happy
+                                             (size_t) (unsigned) (indicatedReadSize - readSize));
             }
             // Make sure to wait for the stop tag before
             // we finish
@@ -301,7 +542,7 @@ int32_t uCellFileBlockRead(uDeviceHandle_t cellHandle,
                 uAtClientWriteInt(atHandle, (int32_t) dataSize);
                 uAtClientCommandStop(atHandle);
                 // Grab the response
-                if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                     // SARA-R4 only puts \n before the
                     // response, not \r\n as it should
                     uAtClientResponseStart(atHandle, "\n+URDBLOCK:");
@@ -321,17 +562,16 @@ int32_t uCellFileBlockRead(uDeviceHandle_t cellHandle,
                 // Get the leading quote mark out of the way
                 uAtClientReadBytes(atHandle, NULL, 1, true);
                 // Now read out all the actual data,
-                // first the bit we want
-                readSize = uAtClientReadBytes(atHandle, pData,
-                                              // Cast in two stages to keep Lint happy
-                                              (size_t) (unsigned) readSize,
-                                              true);
+                // first the bit we want, straight from the
+                // AT client's buffer
+                readSize = uCellPrivateReadBytesInPlace(atHandle, pData,
+                                                        // Cast in two stages to keep Lint happy
+                                                        (size_t) (unsigned) readSize);
                 if (indicatedReadSize > readSize) {
                     //...and then the rest poured away to NULL
-                    uAtClientReadBytes(atHandle, NULL,
-                                       // Cast in two stages to keep Lint happy
-                                       (size_t) (unsigned) (indicatedReadSize - readSize),
-                                       true);
+                    uCellPrivateReadBytesInPlace(atHandle, NULL,
+                                                 // Cast in two stages to keep Lint happy
+                                                 (size_t) (unsigned) (indicatedReadSize - readSize));
                 }
                 // Make sure to wait for the stop tag before
                 // we finish
@@ -357,6 +597,8 @@ int32_t uCellFileSize(uDeviceHandle_t cellHandle,
     uCellPrivateInstance_t *pInstance;
     uAtClientHandle_t atHandle;
     int32_t size = 0;
+    uCellPrivateFileCache_t *pCache;
+    uCellPrivateFileCacheEntry_t *pEntry = NULL;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -367,27 +609,39 @@ int32_t uCellFileSize(uDeviceHandle_t cellHandle,
         // Check parameters
         if ((pInstance != NULL) && (pFileName != NULL) &&
             (strlen(pFileName) <= U_CELL_FILE_NAME_MAX_LENGTH)) {
-            errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
-            atHandle = pInstance->atHandle;
-            // Do the ULSTFILE thang with the AT interface
-            uAtClientLock(atHandle);
-            uAtClientCommandStart(atHandle, "AT+ULSTFILE=");
-            // Write get file size op_code
-            uAtClientWriteInt(atHandle, 2);
-            // Write file name
-            uAtClientWriteString(atHandle, pFileName, true);
-            if (pInstance->pFileSystemTag != NULL) {
-                // Write tag
-                uAtClientWriteString(atHandle, pInstance->pFileSystemTag, true);
+            pCache = pCacheGet(pInstance);
+            if (pCache != NULL) {
+                pEntry = pCacheFind(pCache, pFileName);
             }
-            uAtClientCommandStop(atHandle);
-            // Grab the response
-            uAtClientResponseStart(atHandle, "+ULSTFILE:");
-            // Read file size
-            size = uAtClientReadInt(atHandle);
-            uAtClientResponseStop(atHandle);
-            if (uAtClientUnlock(atHandle) == 0) {
-                errorCode = size;
+            if ((pEntry != NULL) && (pEntry->size >= 0)) {
+                // Got it from the cache
+                errorCode = pEntry->size;
+            } else {
+                errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+                atHandle = pInstance->atHandle;
+                // Do the ULSTFILE thang with the AT interface
+                uAtClientLock(atHandle);
+                uAtClientCommandStart(atHandle, "AT+ULSTFILE=");
+                // Write get file size op_code
+                uAtClientWriteInt(atHandle, 2);
+                // Write file name
+                uAtClientWriteString(atHandle, pFileName, true);
+                if (pInstance->pFileSystemTag != NULL) {
+                    // Write tag
+                    uAtClientWriteString(atHandle, pInstance->pFileSystemTag, true);
+                }
+                uAtClientCommandStop(atHandle);
+                // Grab the response
+                uAtClientResponseStart(atHandle, "+ULSTFILE:");
+                // Read file size
+                size = uAtClientReadInt(atHandle);
+                uAtClientResponseStop(atHandle);
+                if (uAtClientUnlock(atHandle) == 0) {
+                    errorCode = size;
+                    if ((pCache != NULL) && (size >= 0)) {
+                        cacheAdd(pCache, pFileName, strlen(pFileName), size);
+                    }
+                }
             }
         }
 
@@ -411,6 +665,9 @@ int32_t uCellFileDelete(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         if (pInstance != NULL) {
             errorCode = uCellPrivateFileDelete(pInstance, pFileName);
+            if (errorCode == 0) {
+                cacheDelete(pInstance, pFileName);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
@@ -447,6 +704,7 @@ int32_t uCellFileListFirst_r(uDeviceHandle_t cellHandle,
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     uCellPrivateInstance_t *pInstance;
+    uCellPrivateFileCache_t *pCache;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -456,9 +714,22 @@ int32_t uCellFileListFirst_r(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         if ((pInstance != NULL) && (ppRentrant != NULL)) {
             *ppRentrant = NULL;
-            errorCode = uCellPrivateFileListFirst(pInstance,
-                                                  (uCellPrivateFileListContainer_t **) ppRentrant,
-                                                  pFileName);
+            pCache = pCacheGet(pInstance);
+            if ((pCache != NULL) && pCache->listComplete && (pFileName != NULL)) {
+                errorCode = cacheListFirst(pCache,
+                                           (uCellPrivateFileListContainer_t **) ppRentrant,
+                                           pFileName);
+            } else {
+                errorCode = uCellPrivateFileListFirst(pInstance,
+                                                      (uCellPrivateFileListContainer_t **) ppRentrant,
+                                                      pFileName);
+                // Note: an empty listing can't be distinguished from
+                // a failed one so only a non-empty listing is cached
+                if ((pCache != NULL) && (errorCode > 0)) {
+                    cacheList(pCache, pFileName,
+                              (uCellPrivateFileListContainer_t *) *ppRentrant);
+                }
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
@@ -507,4 +778,234 @@ void uCellFileListLast_r(void **ppRentrant)
     }
 }
 
+// Switch the file system cache on.
+int32_t uCellFileSetCacheOn(uDeviceHandle_t cellHandle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (pInstance != NULL) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            if (pInstance->pFileCache == NULL) {
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                pInstance->pFileCache = (uCellPrivateFileCache_t *) pUPortMalloc(sizeof(uCellPrivateFileCache_t));
+                if (pInstance->pFileCache != NULL) {
+                    memset(pInstance->pFileCache, 0, sizeof(*pInstance->pFileCache));
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Switch the file system cache off.
+void uCellFileSetCacheOff(uDeviceHandle_t cellHandle)
+{
+    uCellPrivateInstance_t *pInstance;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        if (pInstance != NULL) {
+            uCellPrivateFileCacheRemove(pInstance);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+}
+
+// Open a file stream.
+int32_t uCellFileStreamOpen(uDeviceHandle_t cellHandle,
+                            const char *pFileName, bool writeNotRead,
+                            char *pBuffer, size_t bufferSize,
+                            uCellFileStream_t *pStream)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t x;
+
+    // Note: no need to lock the cellular API mutex here,
+    // the uCellFileXxx() functions called do that
+    if ((pFileName != NULL) && (strlen(pFileName) <= U_CELL_FILE_NAME_MAX_LENGTH) &&
+        (pBuffer != NULL) && (bufferSize > 0) && (pStream != NULL)) {
+        memset(pStream, 0, sizeof(*pStream));
+        pStream->cellHandle = cellHandle;
+        strncpy(pStream->fileName, pFileName, sizeof(pStream->fileName));
+        pStream->writeNotRead = writeNotRead;
+        pStream->pBuffer = pBuffer;
+        pStream->bufferSize = bufferSize;
+        if (writeNotRead) {
+            // uCellFileWrite() appends, so get rid of any existing
+            // file; an error here just means there was no file
+            uCellFileDelete(cellHandle, pFileName);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        } else {
+            x = uCellFileSize(cellHandle, pFileName);
+            errorCode = x;
+            if (x >= 0) {
+                pStream->fileSize = (size_t) x;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+        if (errorCode != 0) {
+            pStream->pBuffer = NULL;
+        }
+    }
+
+    return errorCode;
+}
+
+// Write to a file stream.
+int32_t uCellFileStreamWrite(uCellFileStream_t *pStream,
+                             const char *pData, size_t dataSize)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    size_t thisSize;
+    size_t totalSize = 0;
+
+    if ((pStream != NULL) && (pStream->pBuffer != NULL) &&
+        pStream->writeNotRead && (pData != NULL)) {
+        errorCodeOrSize = (int32_t) U_ERROR_COMMON_SUCCESS;
+        while ((dataSize > 0) && (errorCodeOrSize == 0)) {
+            if ((pStream->bufferFill == 0) && (dataSize >= pStream->bufferSize)) {
+                // Nothing gathered and at least a buffer-full to
+                // write: send it straight from the caller's data
+                thisSize = dataSize;
+                errorCodeOrSize = writeChunks(pStream->cellHandle, pStream->fileName,
+                                              pData, thisSize);
+            } else {
+                // Gather the data in the buffer, writing it out
+                // when the buffer is full
+                thisSize = pStream->bufferSize - pStream->bufferFill;
+                if (thisSize > dataSize) {
+                    thisSize = dataSize;
+                }
+                memcpy(pStream->pBuffer + pStream->bufferFill, pData, thisSize);
+                pStream->bufferFill += thisSize;
+                if (pStream->bufferFill == pStream->bufferSize) {
+                    errorCodeOrSize = writeChunks(pStream->cellHandle,
+                                                  pStream->fileName,
+                                                  pStream->pBuffer,
+                                                  pStream->bufferFill);
+                    pStream->bufferFill = 0;
+                }
+            }
+            if (errorCodeOrSize == 0) {
+                pData += thisSize;
+                dataSize -= thisSize;
+                totalSize += thisSize;
+            }
+        }
+        if (errorCodeOrSize == 0) {
+            errorCodeOrSize = (int32_t) totalSize;
+        }
+    }
+
+    return errorCodeOrSize;
+}
+
+// Read from a file stream.
+int32_t uCellFileStreamRead(uCellFileStream_t *pStream,
+                            char *pData, size_t dataSize)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    size_t thisSize;
+    size_t totalSize = 0;
+    int32_t x = 1;
+
+    if ((pStream != NULL) && (pStream->pBuffer != NULL) &&
+        !pStream->writeNotRead && (pData != NULL)) {
+        while ((dataSize > 0) && (x > 0)) {
+            thisSize = pStream->bufferFill - pStream->bufferReadOffset;
+            if (thisSize > 0) {
+                // Return what we have in the buffer
+                if (thisSize > dataSize) {
+                    thisSize = dataSize;
+                }
+                memcpy(pData, pStream->pBuffer + pStream->bufferReadOffset, thisSize);
+                pStream->bufferReadOffset += thisSize;
+                pData += thisSize;
+                dataSize -= thisSize;
+                totalSize += thisSize;
+            } else if (pStream->fileOffset < pStream->fileSize) {
+                // Need more from the file: if the caller wants
+                // at least a buffer-full, read it straight into
+                // their storage, else fill the buffer
+                thisSize = pStream->fileSize - pStream->fileOffset;
+                if (thisSize > U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH) {
+                    thisSize = U_CELL_FILE_STREAM_CHUNK_MAX_LENGTH;
+                }
+                if (dataSize >= pStream->bufferSize) {
+                    if (thisSize > dataSize) {
+                        thisSize = dataSize;
+                    }
+                    x = uCellFileBlockRead(pStream->cellHandle, pStream->fileName,
+                                           pData, pStream->fileOffset, thisSize);
+                    if (x > 0) {
+                        pData += x;
+                        dataSize -= (size_t) x;
+                        totalSize += (size_t) x;
+                    }
+                } else {
+                    if (thisSize > pStream->bufferSize) {
+                        thisSize = pStream->bufferSize;
+                    }
+                    x = uCellFileBlockRead(pStream->cellHandle, pStream->fileName,
+                                           pStream->pBuffer, pStream->fileOffset,
+                                           thisSize);
+                    pStream->bufferReadOffset = 0;
+                    pStream->bufferFill = 0;
+                    if (x > 0) {
+                        pStream->bufferFill = (size_t) x;
+                    }
+                }
+                if (x > 0) {
+                    pStream->fileOffset += (size_t) x;
+                }
+            } else {
+                // End of file
+                x = 0;
+            }
+        }
+        errorCodeOrSize = (int32_t) totalSize;
+        if ((totalSize == 0) && (x < 0)) {
+            // Only report an error if there's no data to return,
+            // it will be reported again on the next call anyway
+            errorCodeOrSize = x;
+        }
+    }
+
+    return errorCodeOrSize;
+}
+
+// Close a file stream.
+int32_t uCellFileStreamClose(uCellFileStream_t *pStream)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pStream != NULL) && (pStream->pBuffer != NULL)) {
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        if (pStream->writeNotRead && (pStream->bufferFill > 0)) {
+            // Write out whatever is left in the buffer
+            errorCode = writeChunks(pStream->cellHandle, pStream->fileName,
+                                    pStream->pBuffer, pStream->bufferFill);
+        }
+        pStream->bufferFill = 0;
+        pStream->pBuffer = NULL;
+    }
+
+    return errorCode;
+}
+
 // End of file
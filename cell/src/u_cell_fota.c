@@ -32,6 +32,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memset()
 
 #include "u_cfg_sw.h"
 
@@ -87,6 +88,10 @@ typedef struct {
 typedef struct {
     uCellFotaStatusCallback_t *pCallback;
     void *pCallbackParameter;
+    uCellFotaProgress_t progress;
+    bool sessionStarted;
+    int32_t sessionStartTimeMs;
+    size_t sessionStartPercentage;
 } uCellPrivateFotaContext_t;
 
 /* ----------------------------------------------------------------
@@ -155,6 +160,105 @@ static int32_t convertUufwinstallStatus(int32_t uufwinstallStatus)
     return installStatus;
 }
 
+// Set a progress structure to its "nothing known" state.
+static void clearProgress(uCellFotaProgress_t *pProgress)
+{
+    memset(pProgress, 0, sizeof(*pProgress));
+    pProgress->imageSizeBytes = -1;
+    pProgress->bytesReceived = -1;
+    pProgress->bytesPerSecond = -1;
+    pProgress->etaSeconds = -1;
+}
+
+// Work out the number of bytes received, if the image size is known.
+static void updateBytesReceived(uCellFotaProgress_t *pProgress)
+{
+    if (pProgress->imageSizeBytes >= 0) {
+        pProgress->bytesReceived = (int32_t) (((int64_t) pProgress->imageSizeBytes *
+                                               pProgress->percentage) / 100);
+    }
+}
+
+// Get the FOTA context, allocating it if it doesn't already exist.
+static uCellPrivateFotaContext_t *pFotaContextGet(uCellPrivateInstance_t *pInstance)
+{
+    uCellPrivateFotaContext_t *pContext = (uCellPrivateFotaContext_t *) pInstance->pFotaContext;
+
+    if (pContext == NULL) {
+        // Note: we don't deallocate this until
+        // cellular is closed down in order to
+        // ensure thread-safety of the callback
+        pContext = (uCellPrivateFotaContext_t *) pUPortMalloc(sizeof(uCellPrivateFotaContext_t));
+        if (pContext != NULL) {
+            memset(pContext, 0, sizeof(*pContext));
+            clearProgress(&(pContext->progress));
+            pInstance->pFotaContext = pContext;
+        }
+    }
+
+    return pContext;
+}
+
+// Update the host-side progress of a download from a status
+// report, filling in the throughput and ETA fields of the status.
+static void updateProgress(uCellPrivateFotaContext_t *pContext,
+                           uCellFotaStatus_t *pStatus)
+{
+    uCellFotaProgress_t *pProgress = &(pContext->progress);
+    int32_t nowMs = uPortGetTickTimeMs();
+    int32_t elapsedMs;
+    int64_t gained;
+
+    switch (pStatus->type) {
+        case U_CELL_FOTA_STATUS_TYPE_DOWNLOAD:
+            if (pStatus->value.download == U_CELL_FOTA_STATUS_DOWNLOAD_START) {
+                // The module may carry on from where it left off,
+                // so measure from the percentage we already have
+                pProgress->sessionCount++;
+                pContext->sessionStarted = true;
+                pContext->sessionStartTimeMs = nowMs;
+                pContext->sessionStartPercentage = pProgress->percentage;
+            } else {
+                // The session is over, one way or another
+                pContext->sessionStarted = false;
+                pProgress->etaSeconds = -1;
+                if (pStatus->value.download == U_CELL_FOTA_STATUS_DOWNLOAD_SUCCESS) {
+                    pProgress->percentage = 100;
+                    pProgress->etaSeconds = 0;
+                }
+            }
+            break;
+        case U_CELL_FOTA_STATUS_TYPE_PERCENTAGE_DOWNLOAD:
+            if (!pContext->sessionStarted ||
+                (pStatus->value.percentage < pContext->sessionStartPercentage)) {
+                // Either we've joined a download part way through
+                // (e.g. after a host reset) or the module has begun
+                // again from the start: measure from here
+                pContext->sessionStarted = true;
+                pContext->sessionStartTimeMs = nowMs;
+                pContext->sessionStartPercentage = pStatus->value.percentage;
+            }
+            pProgress->percentage = pStatus->value.percentage;
+            elapsedMs = nowMs - pContext->sessionStartTimeMs;
+            gained = (int64_t) pProgress->percentage - pContext->sessionStartPercentage;
+            if ((elapsedMs > 0) && (gained > 0)) {
+                pProgress->etaSeconds = (int32_t) (((100 - (int64_t) pProgress->percentage) *
+                                                    elapsedMs / gained) / 1000);
+                if (pProgress->imageSizeBytes >= 0) {
+                    pProgress->bytesPerSecond = (int32_t) ((pProgress->imageSizeBytes * gained *
+                                                            10) / elapsedMs);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    updateBytesReceived(pProgress);
+
+    pStatus->bytesPerSecond = pProgress->bytesPerSecond;
+    pStatus->etaSeconds = pProgress->etaSeconds;
+}
+
 // Callback via which the user's FOTA status callback is called.
 // This must be called through the uAtClientCallback() mechanism in
 // order to prevent customer code blocking the AT client.
@@ -181,6 +285,8 @@ static void queueFotaStatus(uCellPrivateInstance_t *pInstance,
     uCellPrivateFotaContext_t *pContext = (uCellPrivateFotaContext_t *) pInstance->pFotaContext;
     uCellFotaStatusCallbackParameters_t *pCallback;
 
+    updateProgress(pContext, pStatus);
+
     // Put all the data in a struct and pass a pointer to it to our
     // local callback via the AT client's callback mechanism to decouple
     // it from whatever might have called us.
@@ -314,6 +420,8 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
     uAtClientHandle_t atHandle;
     uCellPrivateFotaContext_t *pContext;
     int32_t state = 0;
+    uAtClientDeviceError_t deviceError;
+    int32_t atError;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -326,15 +434,8 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
             if (U_CELL_PRIVATE_HAS(pInstance->pModule,
                                    U_CELL_PRIVATE_FEATURE_FOTA)) {
                 errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-                pContext = (uCellPrivateFotaContext_t *) pInstance->pFotaContext;
-                if (pContext == NULL) {
-                    // Note: we don't deallocate this until
-                    // cellular is closed down in order to
-                    // ensure thread-safety of the callback
-                    pContext = (uCellPrivateFotaContext_t *) pUPortMalloc(sizeof(uCellPrivateFotaContext_t));
-                }
+                pContext = pFotaContextGet(pInstance);
                 if (pContext != NULL) {
-                    pInstance->pFotaContext = pContext;
                     errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                     atHandle = pInstance->atHandle;
                     // Remove any existing URC handlers
@@ -357,6 +458,8 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
                         errorCode = uAtClientUnlock(atHandle);
                         if (errorCode == 0) {
                             if ((state == 1) &&
+                                uCellPrivateCapabilityTry(pInstance,
+                                                          U_CELL_PRIVATE_CAPABILITY_UFWINSTALL) &&
                                 (uAtClientSetUrcHandler(atHandle, "+UFWPREVAL:",
                                                         UFWPREVAL_urc, pInstance) == 0) &&
                                 (uAtClientSetUrcHandler(atHandle, "+UUFWINSTALL:",
@@ -365,6 +468,8 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
                                 // command which is required to get the validation
                                 // and installation progress (and it can only be
                                 // switched on, not off); don't fail on this
+                                // and remember if it is not supported so
+                                // that we don't try again
                                 uAtClientLock(atHandle);
                                 uAtClientCommandStart(atHandle, "AT+UFWINSTALL=");
                                 // Specify the port number if given
@@ -378,7 +483,16 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
                                 uAtClientWriteString(atHandle, "", false);
                                 uAtClientWriteInt(atHandle, state);
                                 uAtClientCommandStopReadResponse(atHandle);
-                                if (uAtClientUnlock(atHandle) != 0) {
+                                uAtClientDeviceErrorGet(atHandle, &deviceError);
+                                atError = uAtClientUnlock(atHandle);
+                                if ((atError == 0) || (modulePortNumber < 0)) {
+                                    // Can't blame the capability for an
+                                    // error if a port number was given
+                                    uCellPrivateCapabilitySet(pInstance,
+                                                              U_CELL_PRIVATE_CAPABILITY_UFWINSTALL,
+                                                              atError, &deviceError);
+                                }
+                                if (atError != 0) {
                                     // Clean up on error
                                     uAtClientRemoveUrcHandler(atHandle, "+UUFWINSTALL:");
                                     uAtClientRemoveUrcHandler(atHandle, "+UFWPREVAL:");
@@ -401,4 +515,80 @@ int32_t uCellFotaSetStatusCallback(uDeviceHandle_t cellHandle,
     return errorCode;
 }
 
+// Get the host-side progress of a FOTA download.
+int32_t uCellFotaGetProgress(uDeviceHandle_t cellHandle,
+                             uCellFotaProgress_t *pProgress)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uCellPrivateFotaContext_t *pContext;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (pProgress != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if (U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                   U_CELL_PRIVATE_FEATURE_FOTA)) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                pContext = (uCellPrivateFotaContext_t *) pInstance->pFotaContext;
+                if (pContext != NULL) {
+                    *pProgress = pContext->progress;
+                } else {
+                    clearProgress(pProgress);
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Set the host-side progress of a FOTA download.
+int32_t uCellFotaSetProgress(uDeviceHandle_t cellHandle,
+                             const uCellFotaProgress_t *pProgress)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uCellPrivateFotaContext_t *pContext;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) &&
+            ((pProgress == NULL) || (pProgress->percentage <= 100))) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if (U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                   U_CELL_PRIVATE_FEATURE_FOTA)) {
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                pContext = pFotaContextGet(pInstance);
+                if (pContext != NULL) {
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    clearProgress(&(pContext->progress));
+                    if (pProgress != NULL) {
+                        pContext->progress.imageSizeBytes = pProgress->imageSizeBytes;
+                        pContext->progress.percentage = pProgress->percentage;
+                        pContext->progress.sessionCount = pProgress->sessionCount;
+                        updateBytesReceived(&(pContext->progress));
+                    }
+                    // Start measuring again with the next report
+                    pContext->sessionStarted = false;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // End of file
@@ -281,18 +281,30 @@ static int32_t setSecurity(uDeviceHandle_t cellHandle, int32_t httpHandle,
 
     if (errorCode == 0) {
         atHandle = pCellInstance->atHandle;
-        uAtClientLock(atHandle);
-        uAtClientCommandStart(atHandle, "AT+UHTTP=");
-        uAtClientWriteInt(atHandle, pHttpInstance->profileId);
-        uAtClientWriteInt(atHandle, 6);
-        uAtClientWriteInt(atHandle, onNotOff);
         if (onNotOff) {
             port = 443;
-            uAtClientWriteInt(atHandle, securityProfileId);
+        } else {
+            securityProfileId = -1;
         }
-        uAtClientCommandStopReadResponse(atHandle);
-        errorCode = uAtClientUnlock(atHandle);
-        if ((errorCode == 0) && (pHttpInstance->userSpecifiedPort == 0)) {
+        // Only talk to the module if the profile isn't
+        // already configured this way
+        if (securityProfileId != pHttpInstance->securityProfileId) {
+            uAtClientLock(atHandle);
+            uAtClientCommandStart(atHandle, "AT+UHTTP=");
+            uAtClientWriteInt(atHandle, pHttpInstance->profileId);
+            uAtClientWriteInt(atHandle, 6);
+            uAtClientWriteInt(atHandle, onNotOff);
+            if (onNotOff) {
+                uAtClientWriteInt(atHandle, securityProfileId);
+            }
+            uAtClientCommandStopReadResponse(atHandle);
+            errorCode = uAtClientUnlock(atHandle);
+            if (errorCode == 0) {
+                pHttpInstance->securityProfileId = securityProfileId;
+            }
+        }
+        if ((errorCode == 0) && (pHttpInstance->userSpecifiedPort == 0) &&
+            (port != pHttpInstance->port)) {
             // Set the port number as appropriate for security
             // or not, but only if the user hasn't specified their own
             uAtClientLock(atHandle);
@@ -302,6 +314,9 @@ static int32_t setSecurity(uDeviceHandle_t cellHandle, int32_t httpHandle,
             uAtClientWriteInt(atHandle, port);
             uAtClientCommandStopReadResponse(atHandle);
             errorCode = uAtClientUnlock(atHandle);
+            if (errorCode == 0) {
+                pHttpInstance->port = port;
+            }
         }
     }
 
@@ -461,7 +476,6 @@ int32_t uCellHttpOpen(uDeviceHandle_t cellHandle, const char *pServerName,
     uSockAddress_t address = {0};
     char *pServerNameTmp;
     char *pTmp;
-    int32_t authenticationType = 0;
     uAtClientHandle_t atHandle;
     int32_t y;
 
@@ -529,6 +543,10 @@ int32_t uCellHttpOpen(uDeviceHandle_t cellHandle, const char *pServerName,
                             pHttpInstance->timeoutSeconds = timeoutSeconds;
                             pHttpInstance->pCallback = pCallback;
                             pHttpInstance->pCallbackParam = pCallbackParam;
+                            // A reset profile has security off and
+                            // sits on the default HTTP port
+                            pHttpInstance->securityProfileId = -1;
+                            pHttpInstance->port = 80;
                             atHandle = pCellInstance->atHandle;
                             // Reset the HTTP profile
                             uAtClientLock(atHandle);
@@ -573,6 +591,7 @@ int32_t uCellHttpOpen(uDeviceHandle_t cellHandle, const char *pServerName,
                                     // if one was specified
                                     errorCodeOrHandle = doUhttpInteger(atHandle, profileId, 5, address.port);
                                     pHttpInstance->userSpecifiedPort = address.port;
+                                    pHttpInstance->port = address.port;
                                 }
                                 if ((errorCodeOrHandle == 0) && (pUserName != NULL)) {
                                     // Deal with credentials: user name
@@ -582,12 +601,11 @@ int32_t uCellHttpOpen(uDeviceHandle_t cellHandle, const char *pServerName,
                                     // Deal with credentials: password
                                     errorCodeOrHandle = doUhttpString(atHandle, profileId, 3, pPassword);
                                 }
-                                if (errorCodeOrHandle == 0) {
-                                    // Deal with credentials: set the authentication type
-                                    if (pUserName != NULL) {
-                                        authenticationType = 1;
-                                    }
-                                    errorCodeOrHandle = doUhttpInteger(atHandle, profileId, 4, authenticationType);
+                                if ((errorCodeOrHandle == 0) && (pUserName != NULL)) {
+                                    // Deal with credentials: set the authentication
+                                    // type; no need if there are no credentials
+                                    // since a reset profile has no authentication
+                                    errorCodeOrHandle = doUhttpInteger(atHandle, profileId, 4, 1);
                                 }
                                 if (errorCodeOrHandle == 0) {
                                     // Finally: set the timeout.
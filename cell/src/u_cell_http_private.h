@@ -41,6 +41,9 @@ extern "C" {
 typedef struct uCellHttpInstance_t {
     int32_t profileId;    /**< this will be the handle for the HTTP instance. */
     uint16_t userSpecifiedPort;
+    uint16_t port;        /**< the port number currently configured in the module. */
+    int32_t securityProfileId; /**< the security profile currently configured
+                                    in the module, -1 if security is off. */
     int32_t timeoutSeconds;
     uCellHttpCallback_t *pCallback;
     void *pCallbackParam;
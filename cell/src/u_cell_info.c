@@ -34,7 +34,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // strlen()
+#include "string.h"    // strlen(), memcpy(), memset()
 #include "time.h"      // struct tm
 #include "ctype.h"     // isdigit()
 
@@ -45,8 +45,10 @@
 
 #include "u_port_clib_platform_specific.h" // strtok_r() and, in some cases, isblank()
 #include "u_port_clib_mktime64.h"
+#include "u_port.h"
 #include "u_port_debug.h"
 #include "u_port_os.h"
+#include "u_port_heap.h"
 #include "u_port_uart.h"
 
 #include "u_at_client.h"
@@ -64,10 +66,48 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_CELL_INFO_CIEV_INDICATOR_SIGNAL
+/** The index of the "signal" indicator in the +CIEV URC, i.e.
+ * its position in the list returned by AT+CIND=?.
+ */
+# define U_CELL_INFO_CIEV_INDICATOR_SIGNAL 2
+#endif
+
+#ifndef U_CELL_INFO_TIME_CACHE_DRIFT_MIN_SECONDS
+/** The minimum period over which the drift of the module's clock
+ * against uPortGetTickTimeMs() is measured by the RAM time service
+ * (see uCellInfoSetTimeCache()) before it is used: the module's
+ * clock has a resolution of one second so a short period would
+ * give a very noisy result.
+ */
+# define U_CELL_INFO_TIME_CACHE_DRIFT_MIN_SECONDS 3600
+#endif
+
+#ifndef U_CELL_INFO_TIME_CACHE_JUMP_SECONDS
+/** If, on re-reading the module's clock, the RAM time service finds
+ * that it differs from the predicted time by more than this then it
+ * assumes that the module's clock has been moved (e.g. by the network)
+ * and starts measuring drift afresh.
+ */
+# define U_CELL_INFO_TIME_CACHE_JUMP_SECONDS 10
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Context for uCellInfoSetRadioParametersCallback().
+ */
+typedef struct {
+    int32_t changeThresholdDb;
+    uCellInfoRadioParametersCallback_t *pCallback;
+    void *pCallbackParameter;
+    int32_t lastSignal; /**< The last "signal" indicator value, -1 if none. */
+    int32_t rssiDbm;    /**< The RSSI at the last notification. */
+    int32_t rsrpDbm;    /**< The RSRP at the last notification. */
+    int32_t rsrqDb;     /**< The RSRQ at the last notification. */
+} uCellInfoRadioParametersContext_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -179,39 +219,32 @@ static int32_t getSinr(const char *pStr, int32_t divisor)
     return sinrDb;
 }
 
-// Fill in the radio parameters the AT+CSQ way
-static int32_t getRadioParamsCsq(uAtClientHandle_t atHandle,
-                                 uCellPrivateRadioParameters_t *pRadioParameters)
+// Read the response to AT+CSQ into the radio parameters; the
+// command must have been sent and the AT client locked by the caller.
+static void readRadioParamsCsq(uAtClientHandle_t atHandle,
+                               uCellPrivateRadioParameters_t *pRadioParameters)
 {
-    int32_t errorCode;
     int32_t x;
     int32_t y;
 
-    uAtClientLock(atHandle);
-    uAtClientCommandStart(atHandle, "AT+CSQ");
-    uAtClientCommandStop(atHandle);
     uAtClientResponseStart(atHandle, "+CSQ:");
     x = uAtClientReadInt(atHandle);
     y = uAtClientReadInt(atHandle);
     if (y == 99) {
         y = -1;
     }
-    uAtClientResponseStop(atHandle);
-    errorCode = uAtClientUnlock(atHandle);
 
-    if (errorCode == 0) {
+    if (uAtClientErrorGet(atHandle) == 0) {
         if ((x >= 0) && (x <= 31)) {
             pRadioParameters->rssiDbm =  -(113 - (x * 2));
         }
         pRadioParameters->rxQual = y;
     }
-
-    return errorCode;
 }
 
 // Fill in the radio parameters the AT+UCGED=2 way, SARA-R5 flavour
-static int32_t getRadioParamsUcged2SaraR5(uAtClientHandle_t atHandle,
-                                          uCellPrivateRadioParameters_t *pRadioParameters)
+static void readRadioParamsUcged2SaraR5(uAtClientHandle_t atHandle,
+                                        uCellPrivateRadioParameters_t *pRadioParameters)
 {
     int32_t x;
     char buffer[10]; // More than enough room for an SNIR reading, e.g. 13.75,
@@ -223,9 +256,6 @@ static int32_t getRadioParamsUcged2SaraR5(uAtClientHandle_t atHandle,
     // e.g.
     // 6,4,001,01
     // 2525,5,50,50,e8fe,1a2d001,1,d60814d1,8001,01,28,31,13.75,3,1,10,28,-50,-6,0,255,255,0
-    uAtClientLock(atHandle);
-    uAtClientCommandStart(atHandle, "AT+UCGED?");
-    uAtClientCommandStop(atHandle);
     // The line with just "+UCGED: 2" on it
     uAtClientResponseStart(atHandle, "+UCGED:");
     uAtClientSkipParameters(atHandle, 1);
@@ -263,22 +293,16 @@ static int32_t getRadioParamsUcged2SaraR5(uAtClientHandle_t atHandle,
     if (x > 0) {
         pRadioParameters->snrDb = getSinr(buffer, 1);
     }
-    uAtClientResponseStop(atHandle);
-
-    return uAtClientUnlock(atHandle);
 }
 
 // Fill in the radio parameters the AT+UCGED=2 way, SARA-R422 flavour
-static int32_t getRadioParamsUcged2SaraR422(uAtClientHandle_t atHandle,
-                                            uCellPrivateRadioParameters_t *pRadioParameters)
+static void readRadioParamsUcged2SaraR422(uAtClientHandle_t atHandle,
+                                          uCellPrivateRadioParameters_t *pRadioParameters)
 {
     int32_t x;
     int32_t y;
     char buffer[U_CELL_PRIVATE_CELL_ID_LOGICAL_SIZE + 1]; // +1 for terminator
 
-    uAtClientLock(atHandle);
-    uAtClientCommandStart(atHandle, "AT+UCGED?");
-    uAtClientCommandStop(atHandle);
     // The line with just "+UCGED: 2" on it
     uAtClientResponseStart(atHandle, "+UCGED:");
     uAtClientSkipParameters(atHandle, 1);
@@ -358,15 +382,11 @@ static int32_t getRadioParamsUcged2SaraR422(uAtClientHandle_t atHandle,
             pRadioParameters->snrDb = (x - (20 * 5)) / 5;
         }
     }
-
-    uAtClientResponseStop(atHandle);
-
-    return uAtClientUnlock(atHandle);
 }
 
 // Fill in the radio parameters the AT+UCGED=2 way, LARA-R6 flavour
-static int32_t getRadioParamsUcged2LaraR6(uAtClientHandle_t atHandle,
-                                          uCellPrivateRadioParameters_t *pRadioParameters)
+static void readRadioParamsUcged2LaraR6(uAtClientHandle_t atHandle,
+                                        uCellPrivateRadioParameters_t *pRadioParameters)
 {
     int32_t rat;
     int32_t skipParameters = 2;
@@ -403,9 +423,6 @@ static int32_t getRadioParamsUcged2LaraR6(uAtClientHandle_t atHandle,
     // e.g.
     // 4,0,001,01
     // 2525,5,25,50,2b67,69f6bc7,111,00000000,ffff,ff,67,19,0.00,255,255,255,67,11,255,0,255,255,0,0
-    uAtClientLock(atHandle);
-    uAtClientCommandStart(atHandle, "AT+UCGED?");
-    uAtClientCommandStop(atHandle);
     // The line with just "+UCGED: 2" on it
     uAtClientResponseStart(atHandle, "+UCGED:");
     uAtClientSkipParameters(atHandle, 1);
@@ -489,9 +506,6 @@ static int32_t getRadioParamsUcged2LaraR6(uAtClientHandle_t atHandle,
         default:
             break;
     }
-    uAtClientResponseStop(atHandle);
-
-    return uAtClientUnlock(atHandle);
 }
 
 // Turn a string such as "-104.20", i.e. a signed
@@ -517,14 +531,11 @@ static int32_t strToInt32(const char *pString)
 }
 
 // Fill in the radio parameters the AT+UCGED=5 way
-static int32_t getRadioParamsUcged5(uAtClientHandle_t atHandle,
-                                    uCellPrivateRadioParameters_t *pRadioParameters)
+static void readRadioParamsUcged5(uAtClientHandle_t atHandle,
+                                  uCellPrivateRadioParameters_t *pRadioParameters)
 {
     char buffer[16];
 
-    uAtClientLock(atHandle);
-    uAtClientCommandStart(atHandle, "AT+UCGED?");
-    uAtClientCommandStop(atHandle);
     uAtClientResponseStart(atHandle, "+RSRP:");
     pRadioParameters->cellIdPhysical = uAtClientReadInt(atHandle);
     pRadioParameters->earfcn = uAtClientReadInt(atHandle);
@@ -537,8 +548,6 @@ static int32_t getRadioParamsUcged5(uAtClientHandle_t atHandle,
     if (uAtClientReadString(atHandle, buffer, sizeof(buffer), false) > 0) {
         pRadioParameters->rsrqDb = strToInt32(buffer);
     }
-    uAtClientResponseStop(atHandle);
-    return uAtClientUnlock(atHandle);
 }
 
 // Get the time and time-zone offset.
@@ -631,6 +640,78 @@ static int64_t getTimeAndTimeZone(uAtClientHandle_t atHandle,
     return errorCodeOrValue;
 }
 
+// Get the local time and time zone, from the RAM time service if
+// it is on (re-reading the module's clock if required), else from
+// the module.
+static int64_t getTimeAndTimeZoneCached(const uCellPrivateInstance_t *pInstance,
+                                        int32_t *pTimeZoneSeconds)
+{
+    int64_t errorCodeOrValue = (int64_t) U_ERROR_COMMON_SUCCESS;
+    uCellPrivateTimeCache_t *pCache = pInstance->pTimeCache;
+    int32_t nowMs = uPortGetTickTimeMs();
+    int64_t elapsedMs;
+    int64_t timeLocal;
+    int32_t timeZoneSeconds = 0;
+    int64_t predictedUtc;
+    int64_t errorSeconds;
+
+    if (pCache == NULL) {
+        errorCodeOrValue = getTimeAndTimeZone(pInstance->atHandle, pTimeZoneSeconds);
+    } else {
+        if (!pCache->synced ||
+            ((nowMs - pCache->syncTickMs) / 1000 >= pCache->resyncIntervalSeconds)) {
+            timeLocal = getTimeAndTimeZone(pInstance->atHandle, &timeZoneSeconds);
+            if (timeLocal >= 0) {
+                if (pCache->synced) {
+                    // Compare the module's clock with what we'd predicted
+                    elapsedMs = nowMs - pCache->syncTickMs;
+                    predictedUtc = pCache->timeLocal - pCache->timeZoneSeconds +
+                                   (elapsedMs + (elapsedMs * pCache->driftPpm / 1000000)) / 1000;
+                    errorSeconds = timeLocal - timeZoneSeconds - predictedUtc;
+                    if ((errorSeconds > U_CELL_INFO_TIME_CACHE_JUMP_SECONDS) ||
+                        (errorSeconds < -U_CELL_INFO_TIME_CACHE_JUMP_SECONDS)) {
+                        // The module's clock has been moved (e.g. by the
+                        // network): start measuring drift afresh
+                        pCache->refTimeUtc = timeLocal - timeZoneSeconds;
+                        pCache->refElapsedMs = 0;
+                    } else {
+                        // Measure drift over the whole period since the
+                        // reference point since the module's clock only
+                        // has a resolution of one second
+                        pCache->refElapsedMs += elapsedMs;
+                        if (pCache->refElapsedMs / 1000 >= U_CELL_INFO_TIME_CACHE_DRIFT_MIN_SECONDS) {
+                            pCache->driftPpm = (int32_t) ((((timeLocal - timeZoneSeconds -
+                                                             pCache->refTimeUtc) * 1000) -
+                                                           pCache->refElapsedMs) * 1000000 /
+                                                          pCache->refElapsedMs);
+                        }
+                    }
+                } else {
+                    pCache->refTimeUtc = timeLocal - timeZoneSeconds;
+                    pCache->refElapsedMs = 0;
+                }
+                pCache->timeLocal = timeLocal;
+                pCache->timeZoneSeconds = timeZoneSeconds;
+                pCache->syncTickMs = nowMs;
+                pCache->synced = true;
+            } else if (!pCache->synced) {
+                errorCodeOrValue = timeLocal;
+            }
+        }
+        if (errorCodeOrValue == 0) {
+            // Serve the time from RAM
+            elapsedMs = nowMs - pCache->syncTickMs;
+            errorCodeOrValue = pCache->timeLocal +
+                               (elapsedMs + (elapsedMs * pCache->driftPpm / 1000000)) / 1000;
+            if (pTimeZoneSeconds != NULL) {
+                *pTimeZoneSeconds = pCache->timeZoneSeconds;
+            }
+        }
+    }
+
+    return errorCodeOrValue;
+}
+
 // Get the cell ID.
 int32_t getCellId(uDeviceHandle_t cellHandle, bool logicalNotPhysical)
 {
@@ -657,6 +738,148 @@ int32_t getCellId(uDeviceHandle_t cellHandle, bool logicalNotPhysical)
     return errorCodeOrValue;
 }
 
+// Return true if a radio parameter has changed by at least
+// threshold, or has become available/unavailable.
+static bool radioValueChanged(int32_t oldValue, int32_t newValue,
+                              int32_t notAvailable, int32_t threshold)
+{
+    bool changed;
+    int32_t difference;
+
+    if ((oldValue == notAvailable) || (newValue == notAvailable)) {
+        changed = (oldValue != newValue);
+    } else {
+        difference = newValue - oldValue;
+        if (difference < 0) {
+            difference = -difference;
+        }
+        changed = (difference > 0) && (difference >= threshold);
+    }
+
+    return changed;
+}
+
+// Refresh the radio parameters and call the user's callback if
+// they have changed enough; this must be called through the
+// uAtClientCallback() mechanism since it does AT stuff and
+// calls user code.
+static void radioParametersCallback(uAtClientHandle_t atHandle, void *pParameter)
+{
+    uCellPrivateInstance_t *pInstance = (uCellPrivateInstance_t *) pParameter;
+    uCellInfoRadioParametersContext_t *pContext;
+    uCellInfoRadioParametersCallback_t *pCallback = NULL;
+    void *pCallbackParameter = NULL;
+    int32_t rssiDbm = 0;
+    int32_t rsrpDbm = 0;
+    int32_t rsrqDb = 0;
+
+    (void) atHandle;
+
+    if (uCellInfoRefreshRadioParameters(pInstance->cellHandle) == 0) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pContext = (uCellInfoRadioParametersContext_t *) pInstance->pRadioParametersContext;
+        if ((pContext != NULL) && (pContext->pCallback != NULL)) {
+            rssiDbm = pInstance->radioParameters.rssiDbm;
+            rsrpDbm = pInstance->radioParameters.rsrpDbm;
+            rsrqDb = pInstance->radioParameters.rsrqDb;
+            if (radioValueChanged(pContext->rssiDbm, rssiDbm, 0,
+                                  pContext->changeThresholdDb) ||
+                radioValueChanged(pContext->rsrpDbm, rsrpDbm, 0,
+                                  pContext->changeThresholdDb) ||
+                radioValueChanged(pContext->rsrqDb, rsrqDb, 0x7FFFFFFF,
+                                  pContext->changeThresholdDb)) {
+                pContext->rssiDbm = rssiDbm;
+                pContext->rsrpDbm = rsrpDbm;
+                pContext->rsrqDb = rsrqDb;
+                pCallback = pContext->pCallback;
+                pCallbackParameter = pContext->pCallbackParameter;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+
+        // Call the user outside the mutex so that they
+        // can call cellular API functions
+        if (pCallback != NULL) {
+            pCallback(pInstance->cellHandle, rssiDbm, rsrpDbm, rsrqDb,
+                      pCallbackParameter);
+        }
+    }
+}
+
+// The +CIEV URC handler.
+static void CIEV_urc(uAtClientHandle_t atHandle, void *pParameter)
+{
+    uCellPrivateInstance_t *pInstance = (uCellPrivateInstance_t *) pParameter;
+    uCellInfoRadioParametersContext_t *pContext;
+    int32_t indicator;
+    int32_t value;
+
+    indicator = uAtClientReadInt(atHandle);
+    value = uAtClientReadInt(atHandle);
+    pContext = (uCellInfoRadioParametersContext_t *) pInstance->pRadioParametersContext;
+    if ((indicator == U_CELL_INFO_CIEV_INDICATOR_SIGNAL) && (value >= 0) &&
+        (pContext != NULL) && (pContext->pCallback != NULL) &&
+        (value != pContext->lastSignal)) {
+        pContext->lastSignal = value;
+        // Can't do AT stuff from a URC, need to go via
+        // the AT client's callback mechanism
+        uAtClientCallback(atHandle, radioParametersCallback, pInstance);
+    }
+}
+
+// Compute a 32-bit FNV-1a hash.
+static uint32_t fingerprint(const uint8_t *pByte, size_t length)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (size_t x = 0; x < length; x++) {
+        hash ^= *(pByte + x);
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+// Compute the fingerprint of an identity snapshot: a hash over
+// all of the fields except the fingerprint itself.
+static uint32_t identityFingerprint(const uCellInfoIdentity_t *pIdentity)
+{
+    return fingerprint((const uint8_t *) &(pIdentity->moduleType),
+                       sizeof(*pIdentity) - offsetof(uCellInfoIdentity_t, moduleType));
+}
+
+// Compute the fingerprint of a capabilities snapshot, likewise.
+static uint32_t capabilitiesFingerprint(const uCellInfoCapabilities_t *pCapabilities)
+{
+    return fingerprint((const uint8_t *) &(pCapabilities->moduleType),
+                       sizeof(*pCapabilities) - offsetof(uCellInfoCapabilities_t, moduleType));
+}
+
+// Get the identity snapshot held for an instance, NULL if there is none.
+static const uCellInfoIdentity_t *pIdentityGet(const uCellPrivateInstance_t *pInstance)
+{
+    return (const uCellInfoIdentity_t *) pInstance->pIdentity;
+}
+
+// Copy a string from an identity snapshot, truncating it to fit
+// size (which must be greater than zero) and returning the number
+// of characters copied, not including the null terminator.
+static int32_t copyIdentityStr(const char *pSrc, char *pStr, size_t size)
+{
+    size_t length = strlen(pSrc);
+
+    if (length > size - 1) {
+        length = size - 1;
+    }
+    memcpy(pStr, pSrc, length);
+    *(pStr + length) = 0;
+
+    return (int32_t) length;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -669,6 +892,7 @@ int32_t uCellInfoRefreshRadioParameters(uDeviceHandle_t cellHandle)
     uCellPrivateRadioParameters_t *pRadioParameters;
     uAtClientHandle_t atHandle;
     uCellNetRat_t rat;
+    void (*pReadUcged)(uAtClientHandle_t, uCellPrivateRadioParameters_t *) = NULL;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -686,40 +910,46 @@ int32_t uCellInfoRefreshRadioParameters(uDeviceHandle_t cellHandle)
                 // are different between EUTRAN and GERAN but
                 // AT+CSQ works in all cases though it sometimes
                 // doesn't return a reading.  Collect what we can
-                // with it
-                errorCode = getRadioParamsCsq(atHandle, pRadioParameters);
-                // Note that AT+UCGED is used next rather than AT+CESQ
+                // with it, batched with AT+UCGED where that is
+                // supported so that both are done in one go.
+                // Note that AT+UCGED is used rather than AT+CESQ
                 // as, in my experience, it is more reliable in
                 // reporting answers.
-                // Allow a little sleepy-byes here, don't want to overtask
-                // the module if this is being called repeatedly
-                uPortTaskBlock(500);
                 if (U_CELL_PRIVATE_HAS(pInstance->pModule, U_CELL_PRIVATE_FEATURE_UCGED5)) {
                     // SARA-R4 (except 422) only supports UCGED=5, and it only
                     // supports it in EUTRAN mode
                     rat = uCellPrivateGetActiveRat(pInstance);
                     if (U_CELL_PRIVATE_RAT_IS_EUTRAN(rat)) {
-                        errorCode = getRadioParamsUcged5(atHandle, pRadioParameters);
-                    } else {
-                        // Can't use AT+UCGED, that's all we can get
-                        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                        pReadUcged = readRadioParamsUcged5;
                     }
                 } else {
                     // The AT+UCGED=2 formats are module-specific
-                    switch (pInstance->pModule->moduleType) {
+                    switch (U_CELL_PRIVATE_MODULE_TYPE(pInstance)) {
                         case U_CELL_MODULE_TYPE_SARA_R5:
-                            errorCode = getRadioParamsUcged2SaraR5(atHandle, pRadioParameters);
+                            pReadUcged = readRadioParamsUcged2SaraR5;
                             break;
                         case U_CELL_MODULE_TYPE_SARA_R422:
-                            errorCode = getRadioParamsUcged2SaraR422(atHandle, pRadioParameters);
+                            pReadUcged = readRadioParamsUcged2SaraR422;
                             break;
                         case U_CELL_MODULE_TYPE_LARA_R6:
-                            errorCode = getRadioParamsUcged2LaraR6(atHandle, pRadioParameters);
+                            pReadUcged = readRadioParamsUcged2LaraR6;
                             break;
                         default:
                             break;
                     }
                 }
+                uAtClientLock(atHandle);
+                uAtClientCommandStart(atHandle, "AT+CSQ");
+                if (pReadUcged != NULL) {
+                    uAtClientCommandAppend(atHandle, "+UCGED?");
+                }
+                uAtClientCommandStop(atHandle);
+                readRadioParamsCsq(atHandle, pRadioParameters);
+                if (pReadUcged != NULL) {
+                    pReadUcged(atHandle, pRadioParameters);
+                }
+                uAtClientResponseStop(atHandle);
+                errorCode = uAtClientUnlock(atHandle);
             }
 
             if (errorCode == 0) {
@@ -745,6 +975,75 @@ int32_t uCellInfoRefreshRadioParameters(uDeviceHandle_t cellHandle)
     return errorCode;
 }
 
+// Set a callback for changes in the radio parameters.
+int32_t uCellInfoSetRadioParametersCallback(uDeviceHandle_t cellHandle,
+                                            int32_t changeThresholdDb,
+                                            uCellInfoRadioParametersCallback_t *pCallback,
+                                            void *pCallbackParameter)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uCellInfoRadioParametersContext_t *pContext;
+    uAtClientHandle_t atHandle;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (changeThresholdDb >= 0)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pContext = (uCellInfoRadioParametersContext_t *) pInstance->pRadioParametersContext;
+            if (pContext == NULL) {
+                // Note: we don't deallocate this until
+                // cellular is closed down in order to
+                // ensure thread-safety of the callback
+                pContext = (uCellInfoRadioParametersContext_t *) pUPortMalloc(sizeof(*pContext));
+                pInstance->pRadioParametersContext = pContext;
+            }
+            if (pContext != NULL) {
+                atHandle = pInstance->atHandle;
+                uAtClientRemoveUrcHandler(atHandle, "+CIEV:");
+                pContext->changeThresholdDb = changeThresholdDb;
+                pContext->pCallback = pCallback;
+                pContext->pCallbackParameter = pCallbackParameter;
+                // Start from "nothing known" so that the first
+                // reading is notified
+                pContext->lastSignal = -1;
+                pContext->rssiDbm = 0;
+                pContext->rsrpDbm = 0;
+                pContext->rsrqDb = 0x7FFFFFFF;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if (pCallback != NULL) {
+                    errorCode = uAtClientSetUrcHandler(atHandle, "+CIEV:",
+                                                       CIEV_urc, pInstance);
+                }
+                if (errorCode == 0) {
+                    // Switch indicator event reporting on or off
+                    uAtClientLock(atHandle);
+                    uAtClientCommandStart(atHandle, "AT+CMER=");
+                    uAtClientWriteInt(atHandle, 1);
+                    uAtClientWriteInt(atHandle, 0);
+                    uAtClientWriteInt(atHandle, 0);
+                    uAtClientWriteInt(atHandle, pCallback != NULL ? 1 : 0);
+                    uAtClientCommandStopReadResponse(atHandle);
+                    errorCode = uAtClientUnlock(atHandle);
+                }
+                if ((errorCode != 0) && (pCallback != NULL)) {
+                    // Clean up on error
+                    uAtClientRemoveUrcHandler(atHandle, "+CIEV:");
+                    pContext->pCallback = NULL;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // Get the RSSI.
 int32_t uCellInfoGetRssiDbm(uDeviceHandle_t cellHandle)
 {
@@ -1016,7 +1315,12 @@ int32_t uCellInfoGetImei(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         if ((pInstance != NULL) && (pImei != NULL)) {
-            errorCode = uCellPrivateGetImei(pInstance, pImei);
+            if (pInstance->pIdentity != NULL) {
+                memcpy(pImei, pIdentityGet(pInstance)->imei, U_CELL_INFO_IMEI_SIZE);
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            } else {
+                errorCode = uCellPrivateGetImei(pInstance, pImei);
+            }
             if (errorCode == 0) {
                 uPortLog("U_CELL_INFO: IMEI is %.*s.\n",
                          U_CELL_INFO_IMEI_SIZE, pImei);
@@ -1113,8 +1417,13 @@ int32_t uCellInfoGetManufacturerStr(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         if ((pInstance != NULL) && (pStr != NULL) && (size > 0)) {
-            errorCodeOrSize = getString(pInstance->atHandle, "AT+CGMI",
-                                        pStr, size);
+            if (pInstance->pIdentity != NULL) {
+                errorCodeOrSize = copyIdentityStr(pIdentityGet(pInstance)->manufacturer,
+                                                  pStr, size);
+            } else {
+                errorCodeOrSize = getString(pInstance->atHandle, "AT+CGMI",
+                                            pStr, size);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
@@ -1137,8 +1446,13 @@ int32_t uCellInfoGetModelStr(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         if ((pInstance != NULL) && (pStr != NULL) && (size > 0)) {
-            errorCodeOrSize = getString(pInstance->atHandle, "AT+CGMM",
-                                        pStr, size);
+            if (pInstance->pIdentity != NULL) {
+                errorCodeOrSize = copyIdentityStr(pIdentityGet(pInstance)->model,
+                                                  pStr, size);
+            } else {
+                errorCodeOrSize = getString(pInstance->atHandle, "AT+CGMM",
+                                            pStr, size);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
@@ -1161,9 +1475,14 @@ int32_t uCellInfoGetFirmwareVersionStr(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         if ((pInstance != NULL) && (pStr != NULL) && (size > 0)) {
-            // Use ATI9 instead of AT+CGMR as it contains more information
-            errorCodeOrSize = getString(pInstance->atHandle, "ATI9",
-                                        pStr, size);
+            if (pInstance->pIdentity != NULL) {
+                errorCodeOrSize = copyIdentityStr(pIdentityGet(pInstance)->firmwareVersion,
+                                                  pStr, size);
+            } else {
+                // Use ATI9 instead of AT+CGMR as it contains more information
+                errorCodeOrSize = getString(pInstance->atHandle, "ATI9",
+                                            pStr, size);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
@@ -1172,6 +1491,157 @@ int32_t uCellInfoGetFirmwareVersionStr(uDeviceHandle_t cellHandle,
     return errorCodeOrSize;
 }
 
+// Get a snapshot of the identity of the cellular module.
+int32_t uCellInfoGetIdentity(uDeviceHandle_t cellHandle,
+                             uCellInfoIdentity_t *pIdentity)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (pIdentity != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            if (pInstance->pIdentity != NULL) {
+                *pIdentity = *pIdentityGet(pInstance);
+            } else {
+                atHandle = pInstance->atHandle;
+                // Zero everything so that the fingerprint is repeatable
+                memset(pIdentity, 0, sizeof(*pIdentity));
+                pIdentity->moduleType = (int32_t) U_CELL_PRIVATE_MODULE_TYPE(pInstance);
+                if ((uCellPrivateGetImei(pInstance, pIdentity->imei) != 0) ||
+                    (getString(atHandle, "AT+CGMI", pIdentity->manufacturer,
+                               sizeof(pIdentity->manufacturer)) < 0) ||
+                    (getString(atHandle, "AT+CGMM", pIdentity->model,
+                               sizeof(pIdentity->model)) < 0) ||
+                    (getString(atHandle, "ATI9", pIdentity->firmwareVersion,
+                               sizeof(pIdentity->firmwareVersion)) < 0)) {
+                    errorCode = (int32_t) U_CELL_ERROR_AT;
+                }
+                if (errorCode == 0) {
+                    pIdentity->fingerprint = identityFingerprint(pIdentity);
+                    // Retain a copy; not a problem if there's no
+                    // memory for it, the getters just go to the module
+                    pInstance->pIdentity = pUPortMalloc(sizeof(*pIdentity));
+                    if (pInstance->pIdentity != NULL) {
+                        *((uCellInfoIdentity_t *) pInstance->pIdentity) = *pIdentity;
+                    }
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Hand back a previously obtained identity snapshot.
+int32_t uCellInfoSetIdentity(uDeviceHandle_t cellHandle,
+                             const uCellInfoIdentity_t *pIdentity)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (pInstance != NULL) {
+            if (pIdentity == NULL) {
+                uPortFree(pInstance->pIdentity);
+                pInstance->pIdentity = NULL;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            } else if ((pIdentity->fingerprint == identityFingerprint(pIdentity)) &&
+                       (pIdentity->moduleType == (int32_t) U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                if (pInstance->pIdentity == NULL) {
+                    pInstance->pIdentity = pUPortMalloc(sizeof(*pIdentity));
+                }
+                if (pInstance->pIdentity != NULL) {
+                    *((uCellInfoIdentity_t *) pInstance->pIdentity) = *pIdentity;
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Get a snapshot of the capabilities found out so far.
+int32_t uCellInfoGetCapabilities(uDeviceHandle_t cellHandle,
+                                 uCellInfoCapabilities_t *pCapabilities)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (pCapabilities != NULL)) {
+            memset(pCapabilities, 0, sizeof(*pCapabilities));
+            pCapabilities->moduleType = (int32_t) U_CELL_PRIVATE_MODULE_TYPE(pInstance);
+            pCapabilities->probedBitmap = pInstance->capabilityProbedBitmap;
+            pCapabilities->supportedBitmap = pInstance->capabilitySupportedBitmap;
+            pCapabilities->fingerprint = capabilitiesFingerprint(pCapabilities);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Hand back a previously obtained capabilities snapshot.
+int32_t uCellInfoSetCapabilities(uDeviceHandle_t cellHandle,
+                                 const uCellInfoCapabilities_t *pCapabilities)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    // Ignore any capabilities this version doesn't know about
+    uint32_t mask = (1UL << (int32_t) U_CELL_PRIVATE_CAPABILITY_MAX_NUM) - 1;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (pInstance != NULL) {
+            if (pCapabilities == NULL) {
+                pInstance->capabilityProbedBitmap = 0;
+                pInstance->capabilitySupportedBitmap = 0;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            } else if ((pCapabilities->fingerprint == capabilitiesFingerprint(pCapabilities)) &&
+                       (pCapabilities->moduleType ==
+                        (int32_t) U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
+                pInstance->capabilityProbedBitmap = pCapabilities->probedBitmap & mask;
+                pInstance->capabilitySupportedBitmap = pCapabilities->supportedBitmap &
+                                                       pInstance->capabilityProbedBitmap;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // Get the UTC time according to cellular.
 int64_t uCellInfoGetTimeUtc(uDeviceHandle_t cellHandle)
 {
@@ -1186,8 +1656,8 @@ int64_t uCellInfoGetTimeUtc(uDeviceHandle_t cellHandle)
         pInstance = pUCellPrivateGetInstance(cellHandle);
         errorCodeOrUtcTime = (int64_t) U_ERROR_COMMON_INVALID_PARAMETER;
         if (pInstance != NULL) {
-            errorCodeOrUtcTime = getTimeAndTimeZone(pInstance->atHandle,
-                                                    &timeZoneSeconds);
+            errorCodeOrUtcTime = getTimeAndTimeZoneCached(pInstance,
+                                                          &timeZoneSeconds);
             if (errorCodeOrUtcTime >= 0) {
                 errorCodeOrUtcTime -= timeZoneSeconds;
             }
@@ -1259,8 +1729,8 @@ int64_t uCellInfoGetTime(uDeviceHandle_t cellHandle, int32_t *pTimeZoneSeconds)
         pInstance = pUCellPrivateGetInstance(cellHandle);
         errorCodeOrTime = (int64_t) U_ERROR_COMMON_INVALID_PARAMETER;
         if (pInstance != NULL) {
-            errorCodeOrTime = getTimeAndTimeZone(pInstance->atHandle,
-                                                 &timeZoneSeconds);
+            errorCodeOrTime = getTimeAndTimeZoneCached(pInstance,
+                                                       &timeZoneSeconds);
             if ((errorCodeOrTime >= 0) && (pTimeZoneSeconds != NULL)) {
                 *pTimeZoneSeconds = timeZoneSeconds;
             }
@@ -1272,6 +1742,48 @@ int64_t uCellInfoGetTime(uDeviceHandle_t cellHandle, int32_t *pTimeZoneSeconds)
     return errorCodeOrTime;
 }
 
+// Switch the RAM time service on or off.
+int32_t uCellInfoSetTimeCache(uDeviceHandle_t cellHandle,
+                              int32_t resyncIntervalSeconds)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uCellPrivateTimeCache_t *pCache;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (resyncIntervalSeconds >= 0)) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            if (resyncIntervalSeconds == 0) {
+                uPortFree(pInstance->pTimeCache);
+                pInstance->pTimeCache = NULL;
+            } else {
+                pCache = pInstance->pTimeCache;
+                if (pCache == NULL) {
+                    errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                    pCache = (uCellPrivateTimeCache_t *) pUPortMalloc(sizeof(*pCache));
+                    if (pCache != NULL) {
+                        memset(pCache, 0, sizeof(*pCache));
+                        pInstance->pTimeCache = pCache;
+                        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    }
+                }
+                if (pCache != NULL) {
+                    pCache->resyncIntervalSeconds = resyncIntervalSeconds;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // Determine if RTS flow control is enabled.
 bool uCellInfoIsRtsFlowControlEnabled(uDeviceHandle_t cellHandle)
 {
@@ -508,6 +508,10 @@ static int32_t ensureContext(uCellPrivateInstance_t *pInstance)
                 pContext->desiredFixTimeoutSeconds = U_CELL_LOC_DESIRED_FIX_TIMEOUT_DEFAULT_SECONDS;
                 pContext->gnssEnable = U_CELL_LOC_GNSS_ENABLE_DEFAULT;
                 pContext->fixStatus = (int32_t) U_LOCATION_STATUS_UNKNOWN;
+                pContext->fixCacheMaxAgeSeconds = 0;
+                pContext->fixCacheCellIdLogical = -1;
+                pContext->fixCacheTimeMs = 0;
+                pContext->pFixCache = NULL;
                 uAtClientSetUrcHandler(pInstance->atHandle,
                                        "+UULOCIND:", UULOCIND_urc,
                                        pInstance);
@@ -523,6 +527,47 @@ static int32_t ensureContext(uCellPrivateInstance_t *pInstance)
     return errorCode;
 }
 
+// Get a cached fix, if there is one that is young enough and was
+// obtained on the current serving cell.
+// gUCellPrivateMutex should be locked before this is called.
+static bool fixCacheGet(const uCellPrivateInstance_t *pInstance,
+                        volatile uCellLocFixDataStorageBlock_t *pBlock)
+{
+    bool found = false;
+    const uCellPrivateLocContext_t *pContext = pInstance->pLocContext;
+
+    if ((pContext->pFixCache != NULL) &&
+        (pContext->fixCacheCellIdLogical >= 0) &&
+        (pContext->fixCacheCellIdLogical == pInstance->radioParameters.cellIdLogical) &&
+        ((uPortGetTickTimeMs() - pContext->fixCacheTimeMs) / 1000 <
+         pContext->fixCacheMaxAgeSeconds)) {
+        *pBlock = *((uCellLocFixDataStorageBlock_t *) pContext->pFixCache);
+        found = true;
+    }
+
+    return found;
+}
+
+// Retain a fix in the cache, if caching is on.
+// gUCellPrivateMutex should be locked before this is called.
+static void fixCacheSet(const uCellPrivateInstance_t *pInstance,
+                        const volatile uCellLocFixDataStorageBlock_t *pBlock)
+{
+    uCellPrivateLocContext_t *pContext = pInstance->pLocContext;
+
+    if ((pContext->fixCacheMaxAgeSeconds > 0) &&
+        (pInstance->radioParameters.cellIdLogical >= 0)) {
+        if (pContext->pFixCache == NULL) {
+            pContext->pFixCache = pUPortMalloc(sizeof(uCellLocFixDataStorageBlock_t));
+        }
+        if (pContext->pFixCache != NULL) {
+            *((uCellLocFixDataStorageBlock_t *) pContext->pFixCache) = *pBlock;
+            pContext->fixCacheCellIdLogical = pInstance->radioParameters.cellIdLogical;
+            pContext->fixCacheTimeMs = uPortGetTickTimeMs();
+        }
+    }
+}
+
 // Check all the basics and lock the mutex, MUST be called
 // at the start of every API function; use the helper macro
 // U_CELL_LOC_ENTRY_FUNCTION to be sure of this, rather than
@@ -1253,6 +1298,49 @@ int32_t uCellLocGetDesiredFixTimeout(uDeviceHandle_t cellHandle)
     return errorCodeOrFixTimeout;
 }
 
+// Set the maximum age of a cached fix.
+void uCellLocSetCacheMaxAge(uDeviceHandle_t cellHandle,
+                            int32_t maxAgeSeconds)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance = NULL;
+    uCellPrivateLocContext_t *pContext;
+
+    U_CELL_LOC_ENTRY_FUNCTION(cellHandle, &pInstance, &errorCode);
+
+    if ((errorCode == 0) && (pInstance != NULL)) {
+        pContext = pInstance->pLocContext;
+        if (maxAgeSeconds < 0) {
+            maxAgeSeconds = 0;
+        }
+        pContext->fixCacheMaxAgeSeconds = maxAgeSeconds;
+        if (maxAgeSeconds == 0) {
+            uPortFree(pContext->pFixCache);
+            pContext->pFixCache = NULL;
+            pContext->fixCacheCellIdLogical = -1;
+        }
+    }
+
+    U_CELL_LOC_EXIT_FUNCTION();
+}
+
+// Get the maximum age of a cached fix.
+int32_t uCellLocGetCacheMaxAge(uDeviceHandle_t cellHandle)
+{
+    int32_t errorCodeOrMaxAge = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance = NULL;
+
+    U_CELL_LOC_ENTRY_FUNCTION(cellHandle, &pInstance, &errorCodeOrMaxAge);
+
+    if ((errorCodeOrMaxAge == 0) && (pInstance != NULL)) {
+        errorCodeOrMaxAge = pInstance->pLocContext->fixCacheMaxAgeSeconds;
+    }
+
+    U_CELL_LOC_EXIT_FUNCTION();
+
+    return errorCodeOrMaxAge;
+}
+
 // Set whether a GNSS chip is used or not.
 void uCellLocSetGnssEnable(uDeviceHandle_t cellHandle, bool onNotOff)
 {
@@ -1619,90 +1707,99 @@ int32_t uCellLocGet(uDeviceHandle_t cellHandle,
     if ((errorCode == 0) && (pInstance != NULL)) {
         errorCode = (int32_t) U_CELL_ERROR_NOT_REGISTERED;
         if (uCellPrivateIsRegistered(pInstance)) {
-            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
             pContext = pInstance->pLocContext;
-
-            // Lock the fix storage mutex while we fiddle with it
-            U_PORT_MUTEX_LOCK(pContext->fixDataStorageMutex);
-
-            if (pContext->pFixDataStorage == NULL) {
-                // Allocate the data storage. This will be freed by the
-                // local callback that is called from the URC handler
-                // once it's got an answer and copied it into our
-                // data block
-                pFixDataStorage = (uCellLocFixDataStorage_t *) pUPortMalloc(sizeof(*pFixDataStorage));
-                if (pFixDataStorage != NULL) {
-                    // Attach our block to it
-                    pFixDataStorage->type = U_CELL_LOC_FIX_DATA_STORAGE_TYPE_BLOCK;
-                    pFixDataStorage->store.pBlock = &fixDataStorageBlock;
-                    pContext->pFixDataStorage = (void *) pFixDataStorage;
-                    // Register a URC handler and give it the instance,
-                    // which has our data storage attached to it
-                    uAtClientRemoveUrcHandler(pInstance->atHandle, "+UULOC:");
-                    uAtClientSetUrcHandler(pInstance->atHandle,
-                                           "+UULOC:", UULOC_urc,
-                                           pInstance);
-                    // Start the location fix
-                    pContext->fixStatus = (int32_t) U_LOCATION_STATUS_UNKNOWN;
-                    errorCode = beginLocationFix(pInstance);
-                    if (errorCode != 0) {
+            if (fixCacheGet(pInstance, &fixDataStorageBlock)) {
+                // Young enough and still on the same cell, no need to ask
+                uPortLog("U_CELL_LOC: using cached fix.\n");
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            } else {
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+
+                // Lock the fix storage mutex while we fiddle with it
+                U_PORT_MUTEX_LOCK(pContext->fixDataStorageMutex);
+
+                if (pContext->pFixDataStorage == NULL) {
+                    // Allocate the data storage. This will be freed by the
+                    // local callback that is called from the URC handler
+                    // once it's got an answer and copied it into our
+                    // data block
+                    pFixDataStorage = (uCellLocFixDataStorage_t *) pUPortMalloc(sizeof(*pFixDataStorage));
+                    if (pFixDataStorage != NULL) {
+                        // Attach our block to it
+                        pFixDataStorage->type = U_CELL_LOC_FIX_DATA_STORAGE_TYPE_BLOCK;
+                        pFixDataStorage->store.pBlock = &fixDataStorageBlock;
+                        pContext->pFixDataStorage = (void *) pFixDataStorage;
+                        // Register a URC handler and give it the instance,
+                        // which has our data storage attached to it
                         uAtClientRemoveUrcHandler(pInstance->atHandle, "+UULOC:");
+                        uAtClientSetUrcHandler(pInstance->atHandle,
+                                               "+UULOC:", UULOC_urc,
+                                               pInstance);
+                        // Start the location fix
+                        pContext->fixStatus = (int32_t) U_LOCATION_STATUS_UNKNOWN;
+                        errorCode = beginLocationFix(pInstance);
+                        if (errorCode != 0) {
+                            uAtClientRemoveUrcHandler(pInstance->atHandle, "+UULOC:");
+                        }
                     }
                 }
-            }
 
-            U_PORT_MUTEX_UNLOCK(pContext->fixDataStorageMutex);
+                U_PORT_MUTEX_UNLOCK(pContext->fixDataStorageMutex);
 
-            if (errorCode == 0) {
-                uPortLog("U_CELL_LOC: waiting for the answer...\n");
-                // Wait for the callback called by the URC to set
-                // errorCode inside our block to success
-                startTime = uPortGetTickTimeMs();
-                while ((fixDataStorageBlock.errorCode == (int32_t) U_ERROR_COMMON_TIMEOUT) &&
-                       (((pKeepGoingCallback == NULL) &&
-                         (uPortGetTickTimeMs() - startTime) / 1000 < U_CELL_LOC_TIMEOUT_SECONDS) ||
-                        ((pKeepGoingCallback != NULL) && pKeepGoingCallback(cellHandle)))) {
-                    // Relax a little
-                    uPortTaskBlock(1000);
-                }
-                uAtClientRemoveUrcHandler(pInstance->atHandle, "+UULOC:");
-                errorCode = fixDataStorageBlock.errorCode;
                 if (errorCode == 0) {
-                    if (pLatitudeX1e7 != NULL) {
-                        *pLatitudeX1e7 = fixDataStorageBlock.latitudeX1e7;
-                    }
-                    if (pLongitudeX1e7 != NULL) {
-                        *pLongitudeX1e7 = fixDataStorageBlock.longitudeX1e7;
-                    }
-                    if (pAltitudeMillimetres != NULL) {
-                        *pAltitudeMillimetres = fixDataStorageBlock.altitudeMillimetres;
+                    uPortLog("U_CELL_LOC: waiting for the answer...\n");
+                    // Wait for the callback called by the URC to set
+                    // errorCode inside our block to success
+                    startTime = uPortGetTickTimeMs();
+                    while ((fixDataStorageBlock.errorCode == (int32_t) U_ERROR_COMMON_TIMEOUT) &&
+                           (((pKeepGoingCallback == NULL) &&
+                             (uPortGetTickTimeMs() - startTime) / 1000 < U_CELL_LOC_TIMEOUT_SECONDS) ||
+                            ((pKeepGoingCallback != NULL) && pKeepGoingCallback(cellHandle)))) {
+                        // Relax a little
+                        uPortTaskBlock(1000);
                     }
-                    if (pRadiusMillimetres != NULL) {
-                        *pRadiusMillimetres = fixDataStorageBlock.radiusMillimetres;
-                    }
-                    if (pSpeedMillimetresPerSecond != NULL) {
-                        *pSpeedMillimetresPerSecond = fixDataStorageBlock.speedMillimetresPerSecond;
-                    }
-                    if (pSvs != NULL) {
-                        *pSvs = fixDataStorageBlock.svs;
-                    }
-                    if (pTimeUtc != NULL) {
-                        *pTimeUtc = fixDataStorageBlock.timeUtc;
+                    uAtClientRemoveUrcHandler(pInstance->atHandle, "+UULOC:");
+                    errorCode = fixDataStorageBlock.errorCode;
+                    if (errorCode == 0) {
+                        fixCacheSet(pInstance, &fixDataStorageBlock);
                     }
                 }
-            }
 
-            // Free memory, locking the mutex while we do so
-            U_PORT_MUTEX_LOCK(pContext->fixDataStorageMutex);
+                // Free memory, locking the mutex while we do so
+                U_PORT_MUTEX_LOCK(pContext->fixDataStorageMutex);
 
-            // In case the callback hasn't freed the fix
-            // data storage memory
-            if (pContext->pFixDataStorage != NULL) {
-                uPortFree(pContext->pFixDataStorage);
-                pContext->pFixDataStorage = NULL;
-            }
+                // In case the callback hasn't freed the fix
+                // data storage memory
+                if (pContext->pFixDataStorage != NULL) {
+                    uPortFree(pContext->pFixDataStorage);
+                    pContext->pFixDataStorage = NULL;
+                }
 
-            U_PORT_MUTEX_UNLOCK(pContext->fixDataStorageMutex);
+                U_PORT_MUTEX_UNLOCK(pContext->fixDataStorageMutex);
+            }
+            if (errorCode == 0) {
+                if (pLatitudeX1e7 != NULL) {
+                    *pLatitudeX1e7 = fixDataStorageBlock.latitudeX1e7;
+                }
+                if (pLongitudeX1e7 != NULL) {
+                    *pLongitudeX1e7 = fixDataStorageBlock.longitudeX1e7;
+                }
+                if (pAltitudeMillimetres != NULL) {
+                    *pAltitudeMillimetres = fixDataStorageBlock.altitudeMillimetres;
+                }
+                if (pRadiusMillimetres != NULL) {
+                    *pRadiusMillimetres = fixDataStorageBlock.radiusMillimetres;
+                }
+                if (pSpeedMillimetresPerSecond != NULL) {
+                    *pSpeedMillimetresPerSecond = fixDataStorageBlock.speedMillimetresPerSecond;
+                }
+                if (pSvs != NULL) {
+                    *pSvs = fixDataStorageBlock.svs;
+                }
+                if (pTimeUtc != NULL) {
+                    *pTimeUtc = fixDataStorageBlock.timeUtc;
+                }
+            }
         }
     }
 
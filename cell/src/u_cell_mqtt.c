@@ -287,6 +287,24 @@ typedef struct {
                                                       required for SARA-R4. */
     size_t numTries; /**< The number of tries for a radio-related operation. */
     bool mqttSn; /**< true if this is an MQTT-SN session, else false. */
+    void (*pPublishCallback) (int32_t, int32_t, void *); /**< if non-NULL then
+                                                              publishes are
+                                                              asynchronous and
+                                                              this is called
+                                                              when each one
+                                                              completes. */
+    void *pPublishCallbackParam; /**< user parameter to be passed to the
+                                      publish callback. */
+    int32_t publishMessageId[U_CELL_MQTT_PUBLISH_WINDOW_SIZE]; /**< the message IDs of
+                                                                    asynchronous publishes
+                                                                    in flight, in order. */
+    int32_t publishStartTimeMs[U_CELL_MQTT_PUBLISH_WINDOW_SIZE]; /**< when each of the entries
+                                                                      in publishMessageId was
+                                                                      sent. */
+    size_t publishOldest; /**< index of the oldest entry in publishMessageId. */
+    size_t publishCount; /**< the number of entries in publishMessageId. */
+    int32_t publishNextMessageId; /**< the message ID to give the next
+                                       asynchronous publish. */
 } uCellMqttContext_t;
 
 /** Structure to hold all of the data needed by messageIndicationCallback()
@@ -299,6 +317,17 @@ typedef struct {
     void *pCallbackParam;
 } uCellMessageIndicationCallbackData_t;
 
+/** Structure to hold all of the data needed by publishCallback()
+ * so that we can call it in a thread-safe way without having to lock
+ * a mutex.
+ */
+typedef struct {
+    int32_t messageId;
+    int32_t errorCode;
+    void (*pCallback) (int32_t, int32_t, void *);
+    void *pCallbackParam;
+} uCellMqttPublishCallbackData_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -365,6 +394,60 @@ static void messageIndicationCallback(uAtClientHandle_t atHandle, void *pParam)
     uPortFree(pMessageIndicationCallbackData);
 }
 
+// A local "trampoline" for the publish callback, here so
+// that it can call pPublishCallback in a separate task.
+static void publishCallback(uAtClientHandle_t atHandle, void *pParam)
+{
+    uCellMqttPublishCallbackData_t *pPublishCallbackData = (uCellMqttPublishCallbackData_t *) pParam;
+
+    (void) atHandle;
+
+    // No need to lock any mutexes here: we have all the data we need
+    if (pPublishCallbackData->pCallback != NULL) {
+        pPublishCallbackData->pCallback(pPublishCallbackData->messageId,
+                                        pPublishCallbackData->errorCode,
+                                        pPublishCallbackData->pCallbackParam);
+    }
+
+    // Must free the memory we were handed
+    uPortFree(pPublishCallbackData);
+}
+
+// Complete the oldest asynchronous publish that is in flight, calling
+// the publish callback via the AT client's callback task.  This must
+// be called with the AT client locked or from a URC handler.
+static void publishComplete(uAtClientHandle_t atHandle,
+                            volatile uCellMqttContext_t *pContext,
+                            int32_t errorCode)
+{
+    uCellMqttPublishCallbackData_t *pPublishCallbackData;
+
+    if (pContext->publishCount > 0) {
+        if (pContext->pPublishCallback != NULL) {
+            // Allocate memory for the data the publish callback
+            // will need; publishCallback() will free this
+            pPublishCallbackData = (uCellMqttPublishCallbackData_t *) pUPortMalloc(sizeof(
+                                                                                       *pPublishCallbackData));
+            if (pPublishCallbackData != NULL) {
+                pPublishCallbackData->messageId = pContext->publishMessageId[pContext->publishOldest];
+                pPublishCallbackData->errorCode = errorCode;
+                pPublishCallbackData->pCallback = pContext->pPublishCallback;
+                pPublishCallbackData->pCallbackParam = pContext->pPublishCallbackParam;
+                if (uAtClientCallback(atHandle, publishCallback,
+                                      (void *) pPublishCallbackData) != 0) {
+                    // Free memory on failure to send
+                    uPortFree(pPublishCallbackData);
+                }
+            }
+        }
+        pContext->publishOldest++;
+        if (pContext->publishOldest >= U_CELL_MQTT_PUBLISH_WINDOW_SIZE) {
+            pContext->publishOldest = 0;
+        }
+        pContext->publishCount--;
+    }
+}
+
 // A local "trampoline" for the disconnect callback,
 // here so that it can obtain the last MQTT error code from
 // the module outside of the URC task.
@@ -442,6 +525,10 @@ static void UUMQTTC_UUMQTTSNC_urc(uAtClientHandle_t atHandle,
         // Keep alive returns to "off" when the session ends,
         // it must be set afresh each time
         pContext->keptAlive = false;
+        // Any asynchronous publishes in flight are not going to complete now
+        while (pContext->publishCount > 0) {
+            publishComplete(atHandle, pContext, (int32_t) U_CELL_ERROR_NOT_CONNECTED);
+        }
         pUrcStatus->flagsBitmap |= 1 << U_CELL_MQTT_URC_FLAG_CONNECT_UPDATED;
     } else if (urcType == 1) {
         // Login
@@ -461,13 +548,17 @@ static void UUMQTTC_UUMQTTSNC_urc(uAtClientHandle_t atHandle,
         }
         pUrcStatus->flagsBitmap |= 1 << U_CELL_MQTT_URC_FLAG_CONNECT_UPDATED;
     } else if ((urcType == MQTT_COMMAND_OPCODE_PUBLISH_STRING(mqttSn)) ||
-               (!mqttSn && (urcType == 9))) {
-        // Publish hex or binary, 1 means success
+               (!mqttSn && ((urcType == 9) || (urcType == 3)))) {
+        // Publish hex, binary or file, 1 means success
         if (urcParam1 == 1) {
             // Published
             pUrcStatus->flagsBitmap |= 1 << U_CELL_MQTT_URC_FLAG_PUBLISH_SUCCESS;
         }
         pUrcStatus->flagsBitmap |= 1 << U_CELL_MQTT_URC_FLAG_PUBLISH_UPDATED;
+        // The URC carries no message ID but the module completes
+        // publishes in order, so this must be the oldest one in flight
+        publishComplete(atHandle, pContext,
+                        urcParam1 == 1 ? (int32_t) U_ERROR_COMMON_SUCCESS : (int32_t) U_ERROR_COMMON_DEVICE_ERROR);
     } else if (urcType == MQTT_COMMAND_OPCODE_SUBSCRIBE(mqttSn)) {
         // Subscribe
         // Get the QoS
@@ -482,7 +573,7 @@ static void UUMQTTC_UUMQTTSNC_urc(uAtClientHandle_t atHandle,
             uAtClientReadString(atHandle, (char *) pUrcStatus->topicNameShort,
                                 sizeof(pUrcStatus->topicNameShort), false);
         }
-        if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+        if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
             // On SARA-R4, 0 to 2 mean success
             if ((urcParam1 >= 0) && (urcParam1 <= 2) &&
                 (urcParam2 >= 0)) {
@@ -789,7 +880,7 @@ static void UUMQTT_urc(uAtClientHandle_t atHandle,
         // Sort out if this is "+UUMQTTC:"/"+UUMQTTSNC:"
         // or "+UUMQTTx:" or [SARA-R4 only] "+UUMQTTCM:"
         if (uAtClientReadBytes(atHandle, bytes, sizeof(bytes), true) == sizeof(bytes)) {
-            if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+            if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                 if (bytes[0] == 'C') {
                     // Either "+UUMQTTC" or "+UUMQTTCM"
                     if (bytes[1] == 'M') {
@@ -1332,6 +1423,7 @@ static int32_t connect(const uCellPrivateInstance_t *pInstance,
     volatile uCellMqttUrcStatus_t *pUrcStatus;
     uAtClientHandle_t atHandle;
     int32_t startTimeMs;
+    int32_t wakeTimeMs;
     int32_t status = 1;
     size_t tryCount = 0;
 
@@ -1345,10 +1437,8 @@ static int32_t connect(const uCellPrivateInstance_t *pInstance,
         // take a little while to find out that the connection
         // has actually been made and hence we wait here for
         // it to be ready to connect
-        while (uPortGetTickTimeMs() - pInstance->connectedAtMs <
-               U_CELL_MQTT_CONNECT_DELAY_MILLISECONDS) {
-            uPortTaskBlock(100);
-        }
+        wakeTimeMs = pInstance->connectedAtMs;
+        uPortTaskBlockUntil(&wakeTimeMs, U_CELL_MQTT_CONNECT_DELAY_MILLISECONDS);
     }
 
     // Note that we retry this if the failure was due to radio conditions
@@ -1517,12 +1607,16 @@ static int32_t mqttSnTopicNameToStr(const uCellMqttSnTopicName_t *pTopicName,
  * STATIC FUNCTIONS: PUBLISH/SUBSCRIBE/UNSUBSCRIBE/READ
  * -------------------------------------------------------------- */
 
-// Publish a message, MQTT or MQTT-SN style.
+// Publish a message, MQTT or MQTT-SN style; if pFileNameStr is
+// not NULL then the message is instead the contents of that file
+// on the module's file system (MQTT only), pMessage and
+// messageSizeBytes being ignored.
 static int32_t publish(const uCellPrivateInstance_t *pInstance,
                        const char *pTopicNameStr,
                        int32_t topicNameType,
                        const char *pMessage,
                        size_t messageSizeBytes,
+                       const char *pFileNameStr,
                        uCellMqttQos_t qos, bool retain)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
@@ -1537,10 +1631,32 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
     int32_t startTimeMs;
     int32_t promptTimeoutSeconds = U_CELL_MQTT_PROMPT_TIMEOUT_NORMAL_SECONDS;
     size_t tryCount = 0;
+    bool asyncMode;
+    bool windowFull = false;
+    size_t x;
 
     pContext = (volatile uCellMqttContext_t *) pInstance->pMqttContext;
     mqttSn = pContext->mqttSn;
     pUrcStatus = &(pContext->urcStatus);
+    atHandle = pInstance->atHandle;
+    // uCellMqttSetPublishCallback() only allows a publish callback
+    // where there is a URC to complete the publish
+    asyncMode = (pContext->pPublishCallback != NULL) && !mqttSn;
+    if (asyncMode) {
+        // Time out anything that has been in flight for too long
+        // and apply back-pressure if the window is full
+        uAtClientLock(atHandle);
+        while ((pContext->publishCount > 0) &&
+               (uPortGetTickTimeMs() - pContext->publishStartTimeMs[pContext->publishOldest] >
+                (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000))) {
+            publishComplete(atHandle, pContext, (int32_t) U_ERROR_COMMON_TIMEOUT);
+        }
+        if (pContext->publishCount >= U_CELL_MQTT_PUBLISH_WINDOW_SIZE) {
+            errorCode = (int32_t) U_ERROR_COMMON_BUSY;
+            windowFull = true;
+        }
+        uAtClientUnlock(atHandle);
+    }
     if (mqttSn) {
         isAscii = isAllowedMqttSn(pMessage, messageSizeBytes, retain);
     } else {
@@ -1550,23 +1666,26 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
     }
     //lint -e(568) Suppress value never being negative, who knows
     // what warnings levels a customer might compile with
-    if (((int32_t) qos >= 0) &&
+    if (!windowFull && ((int32_t) qos >= 0) &&
         ((mqttSn && (qos < U_CELL_MQTT_QOS_SN_PUBLISH_MAX_NUM)) || (qos <  U_CELL_MQTT_QOS_MAX_NUM)) &&
         (pTopicNameStr != NULL) &&
         (strlen(pTopicNameStr) <= U_CELL_MQTT_WRITE_TOPIC_MAX_LENGTH_BYTES) &&
-        (retain || (pMessage != NULL)) &&
-        ((U_CELL_PRIVATE_HAS(pInstance->pModule,
-                             U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH) &&
-          (messageSizeBytes <= U_CELL_MQTT_PUBLISH_BIN_MAX_LENGTH_BYTES)) ||
-         (!U_CELL_PRIVATE_HAS(pInstance->pModule,
-                              U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH) &&
-          ((isAscii && (messageSizeBytes <= U_CELL_MQTT_PUBLISH_HEX_MAX_LENGTH_BYTES * 2)) ||
-           (messageSizeBytes <= U_CELL_MQTT_PUBLISH_HEX_MAX_LENGTH_BYTES))))) {
+        ((pFileNameStr != NULL) ?
+         (!mqttSn && (strlen(pFileNameStr) <= U_CELL_FILE_NAME_MAX_LENGTH)) :
+         ((retain || (pMessage != NULL)) &&
+          ((U_CELL_PRIVATE_HAS(pInstance->pModule,
+                               U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH) &&
+            (messageSizeBytes <= U_CELL_MQTT_PUBLISH_BIN_MAX_LENGTH_BYTES)) ||
+           (!U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH) &&
+            ((isAscii && (messageSizeBytes <= U_CELL_MQTT_PUBLISH_HEX_MAX_LENGTH_BYTES * 2)) ||
+             (messageSizeBytes <= U_CELL_MQTT_PUBLISH_HEX_MAX_LENGTH_BYTES))))))) {
         errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-        if (!U_CELL_PRIVATE_HAS(pInstance->pModule,
-                                U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH) ||
-            mqttSn ||
-            ((messageSizeBytes == 0) && retain)) { // Zero length retain messages always sent as ASCII
+        if ((pFileNameStr == NULL) &&
+            (!U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                 U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH) ||
+             mqttSn ||
+             ((messageSizeBytes == 0) && retain))) { // Zero length retain messages always sent as ASCII
             // Note: the MQTT-SN AT interface never supports binary
             // publishing (even where the MQTT one does)
             // If we aren't able to publish a message as a binary
@@ -1593,15 +1712,23 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
             }
         }
 
-        if ((pTextMessage != NULL) ||
+        if ((pTextMessage != NULL) || (pFileNameStr != NULL) ||
             U_CELL_PRIVATE_HAS(pInstance->pModule,
                                U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)) {
             errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
-            atHandle = pInstance->atHandle;
             // We retry this if the failure was due to radio conditions
             do {
                 uAtClientLock(atHandle);
                 pUrcStatus->flagsBitmap = 0;
+                if (asyncMode) {
+                    // Add this publish to the in-flight queue now, with the
+                    // AT client locked, since its URC could arrive as soon
+                    // as the message has been sent
+                    x = (pContext->publishOldest + pContext->publishCount) % U_CELL_MQTT_PUBLISH_WINDOW_SIZE;
+                    pContext->publishMessageId[x] = pContext->publishNextMessageId;
+                    pContext->publishStartTimeMs[x] = uPortGetTickTimeMs();
+                    pContext->publishCount++;
+                }
                 if (U_CELL_PRIVATE_HAS(pInstance->pModule,
                                        U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)) {
                     // In the old SARA-R4 syntax there's no URC
@@ -1612,7 +1739,10 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
                 }
                 uAtClientCommandStart(atHandle, MQTT_COMMAND_AT_COMMAND_STRING(mqttSn));
                 // Publish the message
-                if (pTextMessage != NULL) {
+                if (pFileNameStr != NULL) {
+                    // File mode (not supported by MQTT-SN, hence we don't need a macro)
+                    uAtClientWriteInt(atHandle, 3);
+                } else if (pTextMessage != NULL) {
                     // ASCII or hex mode
                     uAtClientWriteInt(atHandle, MQTT_COMMAND_OPCODE_PUBLISH_STRING(mqttSn));
                 } else {
@@ -1639,7 +1769,12 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
                 }
                 // Topic
                 uAtClientWriteString(atHandle, pTopicNameStr, true);
-                if (pTextMessage == NULL) {
+                if (pFileNameStr != NULL) {
+                    // The name of the file containing the message
+                    uAtClientWriteString(atHandle, pFileNameStr, true);
+                    messageWritten = true;
+                    uAtClientCommandStop(atHandle);
+                } else if (pTextMessage == NULL) {
                     // The length of the binary message
                     uAtClientWriteInt(atHandle, (int32_t) messageSizeBytes);
                     uAtClientCommandStop(atHandle);
@@ -1687,12 +1822,27 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
                 // If the message wasn't written this will tidy
                 // up any rubbish lying around in the AT buffer
                 uAtClientResponseStop(atHandle);
+                if (asyncMode && (pContext->publishCount > 0) &&
+                    (!messageWritten || (uAtClientErrorGet(atHandle) != 0))) {
+                    // There will be no URC for this publish: remove
+                    // it again, it is the newest entry
+                    pContext->publishCount--;
+                }
 
                 if ((uAtClientUnlock(atHandle) == 0) && (status == 1)) {
                     if (U_CELL_PRIVATE_HAS(pInstance->pModule,
                                            U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)) {
                         // For the old SARA-R4 syntax, that's it
                         errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    } else if (asyncMode) {
+                        // The module has the message: return its message
+                        // ID, the publish callback will say how it went
+                        errorCode = pContext->publishNextMessageId;
+                        if (pContext->publishNextMessageId < INT32_MAX) {
+                            pContext->publishNextMessageId++;
+                        } else {
+                            pContext->publishNextMessageId = 0;
+                        }
                     } else {
                         // Wait for a URC to say that the publish
                         // has succeeded
@@ -1718,12 +1868,12 @@ static int32_t publish(const uCellPrivateInstance_t *pInstance,
                     }
                 }
                 tryCount++;
-            } while ((errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) &&
+            } while ((errorCode < 0) &&
                      (tryCount < pContext->numTries) && mqttRetry(pInstance, mqttSn));
 
             uPortFree(pTextMessage);
 
-            if (errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) {
+            if (errorCode < 0) {
                 printErrorCodes(pInstance);
             }
         }
@@ -1952,7 +2102,7 @@ static int32_t readMessage(const uCellPrivateInstance_t *pInstance,
                                U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)) {
             U_ASSERT(pUrcMessage != NULL);
             // For the old-style SARA-R4 interface we need a URC capture
-            U_ASSERT(U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType));
+            U_ASSERT(U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance)));
             pUrcMessage->messageRead = false;
             pUrcMessage->pTopicNameStr = pTopicNameStr;
             pUrcMessage->topicNameSizeBytes = (int32_t) topicNameSizeBytes;
@@ -2173,13 +2323,18 @@ int32_t uCellMqttInit(uDeviceHandle_t cellHandle, const char *pBrokerNameStr,
                     pContext->pUrcMessage = NULL;
                     pContext->numTries = U_CELL_MQTT_RETRIES_DEFAULT + 1;
                     pContext->mqttSn = mqttSn;
+                    pContext->pPublishCallback = NULL;
+                    pContext->pPublishCallbackParam = NULL;
+                    pContext->publishOldest = 0;
+                    pContext->publishCount = 0;
+                    pContext->publishNextMessageId = 0;
                     pInstance->pMqttContext = pContext;
-                    if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                    if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                         // SARA-R4 requires a pUrcMessage as well
                         pContext->pUrcMessage = (uCellMqttUrcMessage_t *) pUPortMalloc(sizeof(*(pContext->pUrcMessage)));
                     }
                     if ((pContext->pUrcMessage != NULL) ||
-                        !U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                        !U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                         atHandle = pInstance->atHandle;
                         // Deal with the broker name string
                         // Allocate space to fiddle with the
@@ -2479,7 +2634,7 @@ int32_t uCellMqttGetLocalPort(uDeviceHandle_t cellHandle)
                 }
             }
             if ((errorCodeOrPort < 0) &&
-                U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                 // SARA-R4 doesn't respond with a port number if the
                 // port number is just the default one.
                 errorCodeOrPort = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
@@ -3119,6 +3274,47 @@ int32_t uCellMqttSetDisconnectCallback(uDeviceHandle_t cellHandle,
     return errorCode;
 }
 
+// Set a callback to be called when an asynchronous publish completes.
+int32_t uCellMqttSetPublishCallback(uDeviceHandle_t cellHandle,
+                                    void (*pCallback) (int32_t, int32_t, void *),
+                                    void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance = NULL;
+    volatile uCellMqttContext_t *pContext;
+    uAtClientHandle_t atHandle;
+
+    U_CELL_MQTT_ENTRY_FUNCTION(cellHandle, &pInstance, &errorCode, true);
+
+    if ((errorCode == 0) && (pInstance != NULL)) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        pContext = (volatile uCellMqttContext_t *) pInstance->pMqttContext;
+        // Asynchronous publish relies on the URC that indicates
+        // publish completion, which MQTT-SN and the old SARA-R4
+        // syntax do not provide
+        if (!pContext->mqttSn &&
+            !U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)) {
+            atHandle = pInstance->atHandle;
+            // Lock the AT client so that the URC handler doesn't
+            // see a half-updated publish callback or queue
+            uAtClientLock(atHandle);
+            pContext->pPublishCallback = pCallback;
+            pContext->pPublishCallbackParam = pCallbackParam;
+            if (pCallback == NULL) {
+                // Forget anything in flight
+                pContext->publishCount = 0;
+            }
+            uAtClientUnlock(atHandle);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    U_CELL_MQTT_EXIT_FUNCTION();
+
+    return errorCode;
+}
+
 // Set the number of retries on radio-related failure.
 void uCellMqttSetRetries(uDeviceHandle_t cellHandle, size_t numRetries)
 {
@@ -3225,7 +3421,8 @@ int32_t uCellMqttPublish(uDeviceHandle_t cellHandle,
                                U_CELL_PRIVATE_FEATURE_MQTT) &&
             !pContext->mqttSn) {
             errorCode = publish(pInstance, pTopicNameStr, -1,
-                                pMessage, messageSizeBytes, qos, retain);
+                                pMessage, messageSizeBytes, NULL,
+                                qos, retain);
         }
     }
 
@@ -3234,6 +3431,91 @@ int32_t uCellMqttPublish(uDeviceHandle_t cellHandle,
     return errorCode;
 }
 
+// Publish the contents of a file as an MQTT message.
+int32_t uCellMqttPublishFile(uDeviceHandle_t cellHandle,
+                             const char *pTopicNameStr,
+                             const char *pFileNameStr,
+                             uCellMqttQos_t qos, bool retain)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance = NULL;
+    volatile uCellMqttContext_t *pContext;
+
+    U_CELL_MQTT_ENTRY_FUNCTION(cellHandle, &pInstance, &errorCode, true);
+
+    if ((errorCode == 0) && (pInstance != NULL)) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        pContext = (volatile uCellMqttContext_t *) pInstance->pMqttContext;
+        if (U_CELL_PRIVATE_HAS(pInstance->pModule,
+                               U_CELL_PRIVATE_FEATURE_MQTT) &&
+            !U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX) &&
+            !pContext->mqttSn) {
+            errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+            if (pFileNameStr != NULL) {
+                errorCode = publish(pInstance, pTopicNameStr, -1,
+                                    NULL, 0, pFileNameStr,
+                                    qos, retain);
+            }
+        }
+    }
+
+    U_CELL_MQTT_EXIT_FUNCTION();
+
+    return errorCode;
+}
+
+// Publish an MQTT message by way of a file.
+int32_t uCellMqttPublishViaFile(uDeviceHandle_t cellHandle,
+                                const char *pTopicNameStr,
+                                const char *pMessage,
+                                size_t messageSizeBytes,
+                                uCellMqttQos_t qos, bool retain)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance = NULL;
+    volatile uCellMqttContext_t *pContext;
+
+    U_CELL_MQTT_ENTRY_FUNCTION(cellHandle, &pInstance, &errorCode, true);
+
+    if ((errorCode == 0) && (pInstance != NULL)) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        pContext = (volatile uCellMqttContext_t *) pInstance->pMqttContext;
+        if (U_CELL_PRIVATE_HAS(pInstance->pModule,
+                               U_CELL_PRIVATE_FEATURE_MQTT) &&
+            !U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX) &&
+            !pContext->mqttSn && (pContext->pPublishCallback == NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+            if ((pTopicNameStr != NULL) && (pMessage != NULL)) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+    }
+
+    U_CELL_MQTT_EXIT_FUNCTION();
+
+    if (errorCode == 0) {
+        // The file writing and publishing functions each lock
+        // the cellular API themselves, hence this is done outside
+        // the entry/exit functions.  Writing a file appends to it,
+        // so make sure there is nothing left over from last time
+        uCellFileDelete(cellHandle, U_CELL_MQTT_PUBLISH_FILE_NAME);
+        errorCode = uCellFileWrite(cellHandle, U_CELL_MQTT_PUBLISH_FILE_NAME,
+                                   pMessage, messageSizeBytes);
+        if (errorCode == (int32_t) messageSizeBytes) {
+            errorCode = uCellMqttPublishFile(cellHandle, pTopicNameStr,
+                                             U_CELL_MQTT_PUBLISH_FILE_NAME,
+                                             qos, retain);
+        } else if (errorCode >= 0) {
+            errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+        }
+        uCellFileDelete(cellHandle, U_CELL_MQTT_PUBLISH_FILE_NAME);
+    }
+
+    return errorCode;
+}
+
 // Subscribe to an MQTT topic.
 int32_t uCellMqttSubscribe(uDeviceHandle_t cellHandle,
                            const char *pTopicFilterStr,
@@ -3429,7 +3711,8 @@ int32_t uCellMqttSnPublish(uDeviceHandle_t cellHandle,
             if (topicNameType >= 0) {
                 errorCode = publish(pInstance, topicNameStr,
                                     topicNameType, pMessage,
-                                    messageSizeBytes, qos, retain);
+                                    messageSizeBytes, NULL,
+                                    qos, retain);
             }
         }
     }
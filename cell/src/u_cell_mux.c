@@ -111,6 +111,15 @@
 # define U_CELL_MUX_WRITE_TIMEOUT_MS U_PORT_UART_WRITE_TIMEOUT_MS
 #endif
 
+#ifndef U_CELL_MUX_WRITE_MAX_FRAMES
+/** The maximum number of CMUX frames that a write to a CMUX
+ * channel will encode into its temporary buffer and send with
+ * a single UART write: fewer, larger, UART writes cost less,
+ * the price being heap for this many maximum-length frames.
+ */
+# define U_CELL_MUX_WRITE_MAX_FRAMES 4
+#endif
+
 /** Macro to check that a CMUX channel is open.
  */
 #define U_CELL_MUX_IS_OPEN(state) ((state) == U_CELL_MUX_PRIVATE_CHANNEL_STATE_OPEN)
@@ -162,6 +171,8 @@ typedef struct {
     uCellMuxPrivateContext_t *pContext;
     int32_t channel;
     uint32_t eventBitMap;
+    bool writeCoalesceFlush; /**< if true this is not a user event but a request to
+                                  flush the write coalescing buffer of the channel. */
 } uCellMuxEvenTrampoline_t;
 
 /* ----------------------------------------------------------------
@@ -189,36 +200,6 @@ static const char gMuxCldCommandFrame[] = {0xf9, 0x03, 0xff, 0x05, 0xc3, 0x01, 0
  * STATIC FUNCTIONS: HELPER FUNCTIONS FOR VIRTUAL SERIAL PORT
  * -------------------------------------------------------------- */
 
-// Event handler, common to all virtual serial ports.
-static void eventHandler(void *pParam, size_t paramLength)
-{
-    uCellMuxEvenTrampoline_t *pEventTrampoline = (uCellMuxEvenTrampoline_t *) pParam;
-    uCellMuxPrivateContext_t *pContext = pEventTrampoline->pContext;
-    uDeviceSerial_t *pDeviceSerial;
-    uCellMuxPrivateChannelContext_t *pChannelContext;
-    uCellMuxPrivateEventCallback_t *pEventCallback;
-
-    (void) paramLength;
-
-    // It is deliberate that this function re-derives everything from the
-    // main context since only the main context can be guaranteed to be still
-    // around when this event eventually occurs
-    if (pContext != NULL) {
-        pDeviceSerial = pUCellMuxPrivateGetDeviceSerial(pContext, pEventTrampoline->channel);
-        if (pDeviceSerial != NULL) {
-            pChannelContext = (uCellMuxPrivateChannelContext_t *) pUInterfaceContext(pDeviceSerial);
-            if ((pChannelContext != NULL) && !pChannelContext->markedForDeletion) {
-                pEventCallback = &(pChannelContext->eventCallback);
-                if (pEventCallback->pFunction != NULL) {
-                    pEventCallback->pFunction(pDeviceSerial,
-                                              pEventTrampoline->eventBitMap,
-                                              pEventCallback->pParam);
-                }
-            }
-        }
-    }
-}
-
 // Send an event, either through manual triggering of the serial device
 // or through new data having arrived.  Set delayMs to less than zero for
 // a normal send, zero or more for a try send.
@@ -239,6 +220,7 @@ static int32_t sendEvent(uCellMuxPrivateContext_t *pContext,
             trampolineData.pContext = pContext;
             trampolineData.channel = pChannelContext->channel;
             trampolineData.eventBitMap = eventBitMap;
+            trampolineData.writeCoalesceFlush = false;
             if (delayMs < 0) {
                 errorCode = uPortEventQueueSend(pContext->eventQueueHandle, &trampolineData,
                                                 sizeof(trampolineData));
@@ -347,20 +329,35 @@ static int32_t serialWriteInnards(struct uDeviceSerial_t *pDeviceSerial,
                                                        pUInterfaceContext(pDeviceSerial);
     uCellPrivateInstance_t *pInstance = pChannelContext->pContext->pInstance;
     char *pBufferEncoded;
-    size_t chunkSize = U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES;
+    size_t chunkSize = pChannelContext->pContext->informationLengthMaxBytes;
+    size_t numFrames;
     size_t thisChunkSize;
+    size_t sizeEncoded;
     size_t sizeWritten = 0;
     int32_t thisLengthWritten;
+    size_t lengthEncoded;
     size_t lengthWritten;
     int32_t startTimeMs;
     bool activityPinIsSet = false;
 
-    // Encode the CMUX frame in chunks of the maximum information
-    // length using a temporary buffer
+    // Encode the CMUX frames, in chunks of the maximum information
+    // length, into a temporary buffer big enough for several of
+    // them so that they may be sent with a single UART write
+    if ((chunkSize == 0) || (chunkSize > U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES)) {
+        chunkSize = U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES;
+    }
+    numFrames = (sizeBytes + chunkSize - 1) / chunkSize;
+    if (numFrames > U_CELL_MUX_WRITE_MAX_FRAMES) {
+        numFrames = U_CELL_MUX_WRITE_MAX_FRAMES;
+    }
+    if (numFrames == 0) {
+        numFrames = 1;
+    }
     if (chunkSize > sizeBytes) {
         chunkSize = sizeBytes;
     }
-    pBufferEncoded = (char *) pUPortMalloc(chunkSize + U_CELL_MUX_PRIVATE_FRAME_OVERHEAD_MAX_BYTES);
+    pBufferEncoded = (char *) pUPortMalloc(numFrames * (chunkSize +
+                                                        U_CELL_MUX_PRIVATE_FRAME_OVERHEAD_MAX_BYTES));
     if (pBufferEncoded != NULL) {
         sizeOrErrorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
         if (pInstance->pinDtrPowerSaving >= 0) {
@@ -370,24 +367,35 @@ static int32_t serialWriteInnards(struct uDeviceSerial_t *pDeviceSerial,
         startTimeMs = uPortGetTickTimeMs();
         while ((sizeWritten < sizeBytes) && (sizeOrErrorCode >= 0) &&
                (uPortGetTickTimeMs() - startTimeMs < U_CELL_MUX_WRITE_TIMEOUT_MS)) {
-            // Encode a chunk as UIH
-            thisChunkSize = sizeBytes - sizeWritten;
-            if (thisChunkSize > U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES) {
-                thisChunkSize = U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES;
+            // Encode up to numFrames chunks as UIH, back to back
+            lengthEncoded = 0;
+            sizeEncoded = 0;
+            for (size_t x = 0; (x < numFrames) && (sizeWritten + sizeEncoded < sizeBytes) &&
+                 (sizeOrErrorCode >= 0); x++) {
+                thisChunkSize = sizeBytes - (sizeWritten + sizeEncoded);
+                if (thisChunkSize > chunkSize) {
+                    thisChunkSize = chunkSize;
+                }
+                sizeOrErrorCode = uCellMuxPrivateEncode(pChannelContext->channel,
+                                                        U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH,
+                                                        false, ((const char *) pBuffer) +
+                                                        sizeWritten + sizeEncoded,
+                                                        thisChunkSize,
+                                                        pBufferEncoded + lengthEncoded);
+                if (sizeOrErrorCode >= 0) {
+                    lengthEncoded += sizeOrErrorCode;
+                    sizeEncoded += thisChunkSize;
+                }
             }
-            sizeOrErrorCode = uCellMuxPrivateEncode(pChannelContext->channel,
-                                                    U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH,
-                                                    false, ((const char *) pBuffer) + sizeWritten,
-                                                    thisChunkSize, pBufferEncoded);
             if (sizeOrErrorCode >= 0) {
                 lengthWritten = 0;
-                while ((sizeOrErrorCode >= 0) && (lengthWritten < (size_t) sizeOrErrorCode) &&
+                while ((sizeOrErrorCode >= 0) && (lengthWritten < lengthEncoded) &&
                        (uPortGetTickTimeMs() - startTimeMs < U_CELL_MUX_WRITE_TIMEOUT_MS)) {
                     if (!pChannelContext->traffic.txIsFlowControlledOff) {
                         // Send the data
                         thisLengthWritten = uPortUartWrite(pChannelContext->pContext->underlyingStreamHandle,
                                                            pBufferEncoded + lengthWritten,
-                                                           sizeOrErrorCode - lengthWritten);
+                                                           lengthEncoded - lengthWritten);
                         if (thisLengthWritten >= 0) {
                             lengthWritten += thisLengthWritten;
                         } else {
@@ -416,7 +424,7 @@ static int32_t serialWriteInnards(struct uDeviceSerial_t *pDeviceSerial,
                 }
 #endif
                 // Keep track of the amount of user information written
-                sizeWritten += thisChunkSize;
+                sizeWritten += sizeEncoded;
             }
         }
 
@@ -436,6 +444,139 @@ static int32_t serialWriteInnards(struct uDeviceSerial_t *pDeviceSerial,
     return sizeOrErrorCode;
 }
 
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+// Send whatever is in the write coalescing buffer of a channel,
+// returning zero on success else negative error code; either
+// way the buffer is emptied.
+// The channel mutex must be locked before this is called.
+static int32_t writeCoalesceFlush(struct uDeviceSerial_t *pDeviceSerial)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *)
+                                                       pUInterfaceContext(pDeviceSerial);
+
+    if (pChannelContext->writeCoalesceLength > 0) {
+        if (pChannelContext->writeCoalesceTimer != NULL) {
+            uPortTimerStop(pChannelContext->writeCoalesceTimer);
+        }
+        errorCode = serialWriteInnards(pDeviceSerial, pChannelContext->writeCoalesce,
+                                       pChannelContext->writeCoalesceLength);
+        if (errorCode > 0) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+        pChannelContext->writeCoalesceLength = 0;
+    }
+
+    return errorCode;
+}
+
+// Timer callback for the write coalescing buffer of a channel:
+// flushing involves a UART write so hand it over to the event
+// queue of the multiplexer rather than doing it in the timer task.
+static void writeCoalesceTimerCallback(const uPortTimerHandle_t timerHandle,
+                                       void *pParameter)
+{
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *) pParameter;
+    uCellMuxEvenTrampoline_t trampolineData;
+
+    (void) timerHandle;
+
+    if ((pChannelContext != NULL) && !pChannelContext->markedForDeletion) {
+        trampolineData.pContext = pChannelContext->pContext;
+        trampolineData.channel = pChannelContext->channel;
+        trampolineData.eventBitMap = 0;
+        trampolineData.writeCoalesceFlush = true;
+        uPortEventQueueSend(pChannelContext->pContext->eventQueueHandle,
+                            &trampolineData, sizeof(trampolineData));
+    }
+}
+
+// Write user data to a channel through its write coalescing buffer,
+// returning the number of bytes accepted else negative error code.
+// The channel mutex must be locked before this is called.
+static int32_t writeCoalesce(struct uDeviceSerial_t *pDeviceSerial,
+                             const void *pBuffer, size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *)
+                                                       pUInterfaceContext(pDeviceSerial);
+    size_t bufferSize = pChannelContext->pContext->informationLengthMaxBytes;
+
+    // Fill no more than one frame
+    if ((bufferSize == 0) || (bufferSize > sizeof(pChannelContext->writeCoalesce))) {
+        bufferSize = sizeof(pChannelContext->writeCoalesce);
+    }
+    if ((pChannelContext->writeCoalesceTimer == NULL) || (sizeBytes >= bufferSize)) {
+        // Can't hold it or too big to be worth holding: send
+        // what is waiting, to keep things in order, then this
+        sizeOrErrorCode = writeCoalesceFlush(pDeviceSerial);
+        if (sizeOrErrorCode == 0) {
+            sizeOrErrorCode = serialWriteInnards(pDeviceSerial, pBuffer, sizeBytes);
+        }
+    } else {
+        if (pChannelContext->writeCoalesceLength + sizeBytes > bufferSize) {
+            sizeOrErrorCode = writeCoalesceFlush(pDeviceSerial);
+        }
+        if (sizeOrErrorCode == 0) {
+            memcpy(pChannelContext->writeCoalesce + pChannelContext->writeCoalesceLength,
+                   pBuffer, sizeBytes);
+            if (pChannelContext->writeCoalesceLength == 0) {
+                // First data in: start the clock
+                uPortTimerStart(pChannelContext->writeCoalesceTimer);
+            }
+            pChannelContext->writeCoalesceLength += sizeBytes;
+            if (pChannelContext->writeCoalesceLength == bufferSize) {
+                // A full frame: no point in waiting
+                writeCoalesceFlush(pDeviceSerial);
+            }
+            sizeOrErrorCode = (int32_t) sizeBytes;
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+#endif
+
+// Event handler, common to all virtual serial ports.
+static void eventHandler(void *pParam, size_t paramLength)
+{
+    uCellMuxEvenTrampoline_t *pEventTrampoline = (uCellMuxEvenTrampoline_t *) pParam;
+    uCellMuxPrivateContext_t *pContext = pEventTrampoline->pContext;
+    uDeviceSerial_t *pDeviceSerial;
+    uCellMuxPrivateChannelContext_t *pChannelContext;
+    uCellMuxPrivateEventCallback_t *pEventCallback;
+
+    (void) paramLength;
+
+    // It is deliberate that this function re-derives everything from the
+    // main context since only the main context can be guaranteed to be still
+    // around when this event eventually occurs
+    if (pContext != NULL) {
+        pDeviceSerial = pUCellMuxPrivateGetDeviceSerial(pContext, pEventTrampoline->channel);
+        if (pDeviceSerial != NULL) {
+            pChannelContext = (uCellMuxPrivateChannelContext_t *) pUInterfaceContext(pDeviceSerial);
+            if ((pChannelContext != NULL) && !pChannelContext->markedForDeletion) {
+                if (pEventTrampoline->writeCoalesceFlush) {
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+                    U_PORT_MUTEX_LOCK(pChannelContext->mutex);
+                    if (U_CELL_MUX_IS_OPEN(pChannelContext->state)) {
+                        writeCoalesceFlush(pDeviceSerial);
+                    }
+                    U_PORT_MUTEX_UNLOCK(pChannelContext->mutex);
+#endif
+                } else {
+                    pEventCallback = &(pChannelContext->eventCallback);
+                    if (pEventCallback->pFunction != NULL) {
+                        pEventCallback->pFunction(pDeviceSerial,
+                                                  pEventTrampoline->eventBitMap,
+                                                  pEventCallback->pParam);
+                    }
+                }
+            }
+        }
+    }
+}
+
 // Send flow control on or off for the given channel.
 static int32_t sendFlowControl(uCellMuxPrivateContext_t *pContext,
                                uint8_t channel, bool stopNotGo)
@@ -461,6 +602,32 @@ static int32_t sendFlowControl(uCellMuxPrivateContext_t *pContext,
     return serialWriteInnards(pDeviceSerial, buffer, sizeof(buffer));
 }
 
+// Work out the receive buffer fill levels at which a channel should
+// be flow controlled off and back on again: the gap between the two
+// provides hysteresis so that we don't toggle flow control on every
+// frame.
+static void setRxWatermarks(volatile uCellMuxPrivateTraffic_t *pTraffic,
+                            size_t informationLengthMaxBytes)
+{
+    size_t sizeBytes = pTraffic->rxBufferSizeBytes;
+    size_t headroomBytes = informationLengthMaxBytes * U_CELL_MUX_PRIVATE_RX_FLOW_OFF_HEADROOM_FRAMES;
+
+    pTraffic->rxFlowOffWatermarkBytes = (sizeBytes * (100 - U_CELL_MUX_PRIVATE_RX_FLOW_OFF_THRESHOLD_PERCENT)) /
+                                        100;
+    // Make sure there is room for what may already be in flight
+    // when the flow control is received by the far end
+    if ((sizeBytes > headroomBytes * 2) &&
+        (pTraffic->rxFlowOffWatermarkBytes > sizeBytes - headroomBytes)) {
+        pTraffic->rxFlowOffWatermarkBytes = sizeBytes - headroomBytes;
+    }
+    pTraffic->rxFlowOnWatermarkBytes = (sizeBytes * (100 - U_CELL_MUX_PRIVATE_RX_FLOW_ON_THRESHOLD_PERCENT)) /
+                                       100;
+    if (pTraffic->rxFlowOnWatermarkBytes >= pTraffic->rxFlowOffWatermarkBytes) {
+        pTraffic->rxFlowOnWatermarkBytes = pTraffic->rxFlowOffWatermarkBytes / 2;
+    }
+    pTraffic->rxFlowOnSent = false;
+}
+
 // Send a CMUX command and check the response
 static int32_t sendCommandCheckResponse(uDeviceSerial_t *pDeviceSerial,
                                         uCellMuxUserFrame_t *pFrameSend,
@@ -590,8 +757,23 @@ static int32_t serialOpen(struct uDeviceSerial_t *pDeviceSerial,
                     pTraffic->pRxBufferStart = (char *) pReceiveBuffer;
                     pTraffic->rxBufferSizeBytes = receiveBufferSizeBytes;
                     pTraffic->rxBufferIsMalloced = isMalloced;
+                    setRxWatermarks(pTraffic, pChannelContext->pContext->informationLengthMaxBytes);
                     pTraffic->pRxBufferWrite = pTraffic->pRxBufferStart;
                     pTraffic->pRxBufferRead = pTraffic->pRxBufferWrite;
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+                    pChannelContext->writeCoalesceLength = 0;
+                    pChannelContext->writeCoalesceTimer = NULL;
+                    if ((pChannelContext->channel != U_CELL_MUX_PRIVATE_CHANNEL_ID_CONTROL) &&
+                        (uPortTimerCreate((uPortTimerHandle_t *) & (pChannelContext->writeCoalesceTimer),
+                                          "cmuxCoalesce", writeCoalesceTimerCallback,
+                                          (void *) pChannelContext,
+                                          U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS,
+                                          false) != 0)) {
+                        // Without a timer we can't coalesce: writes
+                        // will just go straight through
+                        pChannelContext->writeCoalesceTimer = NULL;
+                    }
+#endif
                     pChannelContext->state = U_CELL_MUX_PRIVATE_CHANNEL_STATE_OPEN;
                 } else if (isMalloced) {
                     // Clean up on error
@@ -621,6 +803,16 @@ static void serialClose(struct uDeviceSerial_t *pDeviceSerial)
         U_PORT_MUTEX_LOCK(pChannelContext->mutex);
 
         pTraffic = &(pChannelContext->traffic);
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+        // Send anything that is waiting before we go
+        if (U_CELL_MUX_IS_OPEN(pChannelContext->state)) {
+            writeCoalesceFlush(pDeviceSerial);
+        }
+        if (pChannelContext->writeCoalesceTimer != NULL) {
+            uPortTimerDelete(pChannelContext->writeCoalesceTimer);
+            pChannelContext->writeCoalesceTimer = NULL;
+        }
+#endif
         if (pChannelContext->channel == 0) {
             // To close channel 0, the control channel, we send the CLD
             // command and wait for the CLD response
@@ -674,6 +866,32 @@ static int32_t serialGetReceiveSize(struct uDeviceSerial_t *pDeviceSerial)
     return sizeOrErrorCode;
 }
 
+// Having read from the receive buffer of the CMUX channel, switch
+// flow control back on if it was off and there is now room.
+// The channel mutex must be locked before this is called.
+static void serialReadFlowControl(struct uDeviceSerial_t *pDeviceSerial)
+{
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *)
+                                                       pUInterfaceContext(pDeviceSerial);
+    uCellMuxPrivateTraffic_t *pTraffic = &(pChannelContext->traffic);
+
+    if (pTraffic->rxIsFlowControlledOff && !pTraffic->rxFlowOnSent &&
+        ((size_t) serialGetReceiveSizeInnards(pDeviceSerial) <= pTraffic->rxFlowOnWatermarkBytes)) {
+        sendFlowControl(pChannelContext->pContext, pChannelContext->channel, false);
+        // The rxIsFlowControlledOff flag gets reset down in
+        // controlChannelInformation() when the acknowledgement arrives;
+        // until then, don't keep asking
+        pTraffic->rxFlowOnSent = true;
+        // Re-trigger decoding of any received data we didn't previously
+        // have room to process
+        uPortUartEventSend(pChannelContext->pContext->underlyingStreamHandle,
+                           U_DEVICE_SERIAL_EVENT_BITMASK_DATA_RECEIVED);
+#ifdef U_CELL_MUX_ENABLE_DEBUG
+        uPortLog("U_CELL_CMUX: decoding retriggered.\n");
+#endif
+    }
+}
+
 // Read from the receive buffer of the CMUX channel.
 static int32_t serialRead(struct uDeviceSerial_t *pDeviceSerial,
                           void *pBuffer, size_t sizeBytes)
@@ -690,6 +908,11 @@ static int32_t serialRead(struct uDeviceSerial_t *pDeviceSerial,
         if (pBuffer != NULL) {
             sizeOrErrorCode = (int32_t) U_CELL_ERROR_NOT_CONNECTED;
             if (U_CELL_MUX_IS_OPEN(pChannelContext->state)) {
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+                // A read usually means that a response to what has
+                // been written is expected, so don't hold it back
+                writeCoalesceFlush(pDeviceSerial);
+#endif
                 pTraffic = &(pChannelContext->traffic);
                 sizeOrErrorCode = serialReadInnards(pTraffic, pBuffer, sizeBytes);
 #ifdef U_CELL_MUX_ENABLE_DEBUG
@@ -698,19 +921,49 @@ static int32_t serialRead(struct uDeviceSerial_t *pDeviceSerial,
                              sizeOrErrorCode);
                 }
 #endif
-                if (pTraffic->rxIsFlowControlledOff &&
-                    (((pTraffic->rxBufferSizeBytes - serialGetReceiveSizeInnards(pDeviceSerial)) * 100) /
-                     pTraffic->rxBufferSizeBytes > U_CELL_MUX_PRIVATE_RX_FLOW_ON_THRESHOLD_PERCENT)) {
-                    sendFlowControl(pChannelContext->pContext, pChannelContext->channel, false);
-                    // The rxIsFlowControlledOff flag gets reset down in
-                    // controlChannelInformation() when the acknowledgement arrives
-                    // Re-trigger decoding of any received data we didn't previously
-                    // have room to process
-                    uPortUartEventSend(pChannelContext->pContext->underlyingStreamHandle,
-                                       U_DEVICE_SERIAL_EVENT_BITMASK_DATA_RECEIVED);
-#ifdef U_CELL_MUX_ENABLE_DEBUG
-                    uPortLog("U_CELL_CMUX: decoding retriggered.\n");
+                serialReadFlowControl(pDeviceSerial);
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(pChannelContext->mutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
+// Get a pointer to the next contiguous received data in the receive
+// buffer of the CMUX channel; the CMUX decoder only ever writes
+// ahead of the write pointer so this remains stable until consumed.
+static int32_t serialPeek(struct uDeviceSerial_t *pDeviceSerial,
+                          const void **ppData)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *)
+                                                       pUInterfaceContext(pDeviceSerial);
+    uCellMuxPrivateTraffic_t *pTraffic;
+    const char *pRxBufferWrite;
+
+    if ((pChannelContext != NULL) && !pChannelContext->markedForDeletion) {
+
+        U_PORT_MUTEX_LOCK(pChannelContext->mutex);
+
+        if (ppData != NULL) {
+            sizeOrErrorCode = (int32_t) U_CELL_ERROR_NOT_CONNECTED;
+            if (U_CELL_MUX_IS_OPEN(pChannelContext->state)) {
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+                // As for a read
+                writeCoalesceFlush(pDeviceSerial);
 #endif
+                pTraffic = &(pChannelContext->traffic);
+                pRxBufferWrite = pTraffic->pRxBufferWrite;
+                *ppData = pTraffic->pRxBufferRead;
+                sizeOrErrorCode = 0;
+                if (pTraffic->pRxBufferRead < pRxBufferWrite) {
+                    sizeOrErrorCode = pRxBufferWrite - pTraffic->pRxBufferRead;
+                } else if (pTraffic->pRxBufferRead > pRxBufferWrite) {
+                    // Only up to the end of the buffer
+                    sizeOrErrorCode = pTraffic->pRxBufferStart + pTraffic->rxBufferSizeBytes -
+                                      pTraffic->pRxBufferRead;
                 }
             }
         }
@@ -721,6 +974,57 @@ static int32_t serialRead(struct uDeviceSerial_t *pDeviceSerial,
     return sizeOrErrorCode;
 }
 
+// Remove data, obtained with serialPeek(), from the receive buffer
+// of the CMUX channel.
+static int32_t serialConsume(struct uDeviceSerial_t *pDeviceSerial,
+                             size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *)
+                                                       pUInterfaceContext(pDeviceSerial);
+    uCellMuxPrivateTraffic_t *pTraffic;
+    const char *pRxBufferWrite;
+    size_t thisSize = 0;
+
+    if ((pChannelContext != NULL) && !pChannelContext->markedForDeletion) {
+
+        U_PORT_MUTEX_LOCK(pChannelContext->mutex);
+
+        sizeOrErrorCode = (int32_t) U_CELL_ERROR_NOT_CONNECTED;
+        if (U_CELL_MUX_IS_OPEN(pChannelContext->state)) {
+            pTraffic = &(pChannelContext->traffic);
+            pRxBufferWrite = pTraffic->pRxBufferWrite;
+            // Limit this to what serialPeek() could have returned
+            if (pTraffic->pRxBufferRead < pRxBufferWrite) {
+                thisSize = pRxBufferWrite - pTraffic->pRxBufferRead;
+            } else if (pTraffic->pRxBufferRead > pRxBufferWrite) {
+                thisSize = pTraffic->pRxBufferStart + pTraffic->rxBufferSizeBytes -
+                           pTraffic->pRxBufferRead;
+            }
+            if (thisSize > sizeBytes) {
+                thisSize = sizeBytes;
+            }
+            pTraffic->pRxBufferRead += thisSize;
+            if (pTraffic->pRxBufferRead >= pTraffic->pRxBufferStart +
+                pTraffic->rxBufferSizeBytes) {
+                pTraffic->pRxBufferRead = pTraffic->pRxBufferStart;
+            }
+            sizeOrErrorCode = (int32_t) thisSize;
+#ifdef U_CELL_MUX_ENABLE_DEBUG
+            if (sizeOrErrorCode > 0) {
+                uPortLog("U_CELL_CMUX_%d: app consumed %d byte(s).\n", pChannelContext->channel,
+                         sizeOrErrorCode);
+            }
+#endif
+            serialReadFlowControl(pDeviceSerial);
+        }
+
+        U_PORT_MUTEX_UNLOCK(pChannelContext->mutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
 // Write to the CMUX channel.
 static int32_t serialWrite(struct uDeviceSerial_t *pDeviceSerial,
                            const void *pBuffer, size_t sizeBytes)
@@ -735,7 +1039,11 @@ static int32_t serialWrite(struct uDeviceSerial_t *pDeviceSerial,
 
         sizeOrErrorCode = (int32_t) U_CELL_ERROR_NOT_CONNECTED;
         if (U_CELL_MUX_IS_OPEN(pChannelContext->state)) {
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+            sizeOrErrorCode = writeCoalesce(pDeviceSerial, pBuffer, sizeBytes);
+#else
             sizeOrErrorCode = serialWriteInnards(pDeviceSerial, pBuffer, sizeBytes);
+#endif
         }
 
         U_PORT_MUTEX_UNLOCK(pChannelContext->mutex);
@@ -999,6 +1307,8 @@ static void initSerialInterface(struct uDeviceSerial_t *pDeviceSerial)
     pDeviceSerial->ctsResume = serialCtsResume;
     pDeviceSerial->discardOnOverflow = serialDiscardOnOverflow;
     pDeviceSerial->isDiscardOnOverflowEnabled = serialIsDiscardOnOverflowEnabled;
+    pDeviceSerial->peek = serialPeek;
+    pDeviceSerial->consume = serialConsume;
 }
 
 /* ----------------------------------------------------------------
@@ -1010,7 +1320,7 @@ static uint8_t getChannelGnss(const uCellPrivateInstance_t *pInstance)
 {
     uint8_t channel = pInstance->pModule->defaultMuxChannelGnss;
 
-    if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+    if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
         // For the SARA-R5 case the CMUX channel for GNSS is different
         // if we are exchanging AT commands on the AUX UART, which is
         // USIO variant 2.
@@ -1077,6 +1387,7 @@ static int32_t openChannel(uCellMuxPrivateContext_t *pContext,
                 pChannelContext->markedForDeletion = false;
                 memset(&(pChannelContext->traffic), 0, sizeof(pChannelContext->traffic));
                 memset(&(pChannelContext->eventCallback), 0, sizeof(pChannelContext->eventCallback));
+                memset(&(pChannelContext->deliveryCallback), 0, sizeof(pChannelContext->deliveryCallback));
                 errorCode = pDeviceSerial->open(pDeviceSerial, NULL, receiveBufferSizeBytes);
                 // Don't clean up on error here - the serial device will be re-used if
                 // the user tries again and this ensures thread-safety.
@@ -1139,6 +1450,7 @@ static void controlChannelInformation(uCellMuxPrivateContext_t *pContext,
                 pChannelContext->traffic.txIsFlowControlledOff = ((*(pBuffer + 3) & 0x02) == 0x02);
             } else {
                 pChannelContext->traffic.rxIsFlowControlledOff = ((*(pBuffer + 3) & 0x02) == 0x02);
+                pChannelContext->traffic.rxFlowOnSent = false;
             }
         }
         if (isCommand) {
@@ -1251,6 +1563,21 @@ static void cmuxDecodeControl(uCellMuxPrivateContext_t *pContext)
     }
 }
 
+// Pass a span of a decoded information field straight to the delivery
+// callback of a channel; pParam is the channel's serial device.
+static void deliverSpan(const char *pSpan, size_t sizeBytes, void *pParam)
+{
+    uDeviceSerial_t *pDeviceSerial = (uDeviceSerial_t *) pParam;
+    uCellMuxPrivateChannelContext_t *pChannelContext = (uCellMuxPrivateChannelContext_t *)
+                                                       pUInterfaceContext(pDeviceSerial);
+    uCellMuxPrivateDeliveryCallback_t *pDeliveryCallback = &(pChannelContext->deliveryCallback);
+    void (*pFunction)(struct uDeviceSerial_t *, const char *, size_t, void *) = pDeliveryCallback->pFunction;
+
+    if (pFunction != NULL) {
+        pFunction(pDeviceSerial, pSpan, sizeBytes, pDeliveryCallback->pParam);
+    }
+}
+
 // Decode received CMUX frames, just the non-control-channel ones, from
 // the ring buffer.
 static void cmuxDecode(uCellMuxPrivateContext_t *pContext, uint32_t eventBitMap)
@@ -1269,6 +1596,9 @@ static void cmuxDecode(uCellMuxPrivateContext_t *pContext, uint32_t eventBitMap)
     const char *pRxBufferRead;
 
     if (pContext != NULL) {
+        U_LOG_RAM_TRACE_BEGIN(U_LOG_RAM_EVENT_CELL_MUX_DECODE,
+                              (int32_t) uRingBufferDataSizeHandle(&(pContext->ringBuffer),
+                                                                  pContext->readHandle));
         // Try to decode new CMUX messages from the ring buffer
         errorCodeOrLength = 0;
         while ((errorCodeOrLength >= 0) && !stalled) {
@@ -1307,7 +1637,16 @@ static void cmuxDecode(uCellMuxPrivateContext_t *pContext, uint32_t eventBitMap)
                             case U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH:
                             //fall-through
                             case U_CELL_MUX_PRIVATE_FRAME_TYPE_UI:
-                                if (pTraffic->rxBufferSizeBytes > 0) {
+                                if (pChannelContext->deliveryCallback.pFunction != NULL) {
+                                    // The consumer takes the data directly: re-parse
+                                    // the buffer to hand it the information field in
+                                    // place, no buffering, hence no flow control
+                                    parserContext.pSpanCallback = deliverSpan;
+                                    parserContext.pSpanCallbackParam = pDeviceSerial;
+                                    uRingBufferParseHandle(&(pContext->ringBuffer),
+                                                           pContext->readHandle,
+                                                           parserList, &parserContext);
+                                } else if (pTraffic->rxBufferSizeBytes > 0) {
                                     // We have user information, work out how much we can cope with
                                     // -1 below to avoid pointer wrap
                                     bufferLength  = pTraffic->rxBufferSizeBytes - serialGetReceiveSizeInnards(pDeviceSerial) - 1;
@@ -1400,10 +1739,10 @@ static void cmuxDecode(uCellMuxPrivateContext_t *pContext, uint32_t eventBitMap)
                                     // After all that, check if the channel's receive buffer is
                                     // sufficiently full that we should flow control off this channel
                                     if (!pTraffic->rxIsFlowControlledOff &&
-                                        (((pTraffic->rxBufferSizeBytes - serialGetReceiveSizeInnards(pDeviceSerial)) * 100) /
-                                         pTraffic->rxBufferSizeBytes) < U_CELL_MUX_PRIVATE_RX_FLOW_OFF_THRESHOLD_PERCENT) {
+                                        ((size_t) serialGetReceiveSizeInnards(pDeviceSerial) >= pTraffic->rxFlowOffWatermarkBytes)) {
                                         sendFlowControl(pContext, parserContext.address, true);
                                         pTraffic->rxIsFlowControlledOff = true;
+                                        pTraffic->rxFlowOnSent = false;
                                     }
 
                                     // Call the  event callback a user may have set for this
@@ -1446,6 +1785,7 @@ static void cmuxDecode(uCellMuxPrivateContext_t *pContext, uint32_t eventBitMap)
                 }
             }
         }
+        U_LOG_RAM_TRACE_END(U_LOG_RAM_EVENT_CELL_MUX_DECODE, stalled);
     }
 }
 
@@ -1551,6 +1891,8 @@ int32_t uCellMuxEnable(uDeviceHandle_t cellHandle)
     uDeviceSerial_t *pDeviceSerial;
     int32_t cmeeMode = 2;
     char tempBuffer[32];
+    size_t informationLengthBytes;
+    size_t triedLengthBytes;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -1611,22 +1953,40 @@ int32_t uCellMuxEnable(uDeviceHandle_t cellHandle)
                         uAtClientStreamGetExt(atHandle, &stream);
                         uRingBufferFlushHandle(&(pContext->ringBuffer), pContext->readHandle);
                         pContext->underlyingStreamHandle = stream.handle.int32;
-                        uAtClientCommandStart(atHandle, "AT+CMUX=");
-                        // Only basic mode and only UIH frames are supported by any
-                        // of the cellular modules we support
-                        uAtClientWriteInt(atHandle, 0);
-                        uAtClientWriteInt(atHandle, 0);
-                        // As advised in the u-blox multiplexer document, port
-                        // speed is left empty for max compatibility
-                        uAtClientWriteString(atHandle, "", false);
-                        // Set the information field length
-                        uAtClientWriteInt(atHandle,
-                                          U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES);
-                        // Everything else is left at defaults for max compatibility
-                        uAtClientCommandStopReadResponse(atHandle);
-                        // Not unlocking here, just check for errors
-                        errorCode = uAtClientErrorGet(atHandle);
+                        // Negotiate the information field length, N1: if the
+                        // module won't accept what we ask for, try smaller values,
+                        // down to the 27.010 default, which it must accept
+                        informationLengthBytes = U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES;
+                        do {
+                            triedLengthBytes = informationLengthBytes;
+                            uAtClientClearError(atHandle);
+                            uAtClientCommandStart(atHandle, "AT+CMUX=");
+                            // Only basic mode and only UIH frames are supported by any
+                            // of the cellular modules we support
+                            uAtClientWriteInt(atHandle, 0);
+                            uAtClientWriteInt(atHandle, 0);
+                            // As advised in the u-blox multiplexer document, port
+                            // speed is left empty for max compatibility
+                            uAtClientWriteString(atHandle, "", false);
+                            // Set the information field length
+                            uAtClientWriteInt(atHandle, (int32_t) informationLengthBytes);
+                            // Everything else is left at defaults for max compatibility
+                            uAtClientCommandStopReadResponse(atHandle);
+                            // Not unlocking here, just check for errors
+                            errorCode = uAtClientErrorGet(atHandle);
+                            if ((errorCode != 0) &&
+                                (informationLengthBytes > U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_DEFAULT_BYTES)) {
+                                informationLengthBytes /= 2;
+                                if (informationLengthBytes < U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_DEFAULT_BYTES) {
+                                    informationLengthBytes = U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_DEFAULT_BYTES;
+                                }
+                            }
+                        } while ((errorCode != 0) && (informationLengthBytes != triedLengthBytes));
+                        pContext->informationLengthMaxBytes = triedLengthBytes;
                         if (errorCode == 0) {
+#ifdef U_CELL_MUX_ENABLE_DEBUG
+                            uPortLog("U_CELL_CMUX: N1 is %d.\n", (int32_t) triedLengthBytes);
+#endif
                             // Leave the AT client locked to stop it reacting to stuff coming
                             // back over the UART, which will shortly become the MUX
                             // control channel and not an AT interface at all.
@@ -1648,7 +2008,7 @@ int32_t uCellMuxEnable(uDeviceHandle_t cellHandle)
                                 // we will need a data buffer for the information field carrying the
                                 // user data (i.e. AT commands)
                                 errorCode = openChannel(pContext, U_CELL_MUX_PRIVATE_CHANNEL_ID_AT,
-                                                        U_CELL_MUX_PRIVATE_VIRTUAL_SERIAL_BUFFER_LENGTH_BYTES);
+                                                        U_CELL_MUX_PRIVATE_AT_CHANNEL_BUFFER_LENGTH_BYTES);
                                 if (errorCode == 0) {
 #ifdef U_CELL_MUX_ENABLE_DEBUG
                                     uPortLog("U_CELL_CMUX_1: AT channel open, flushing stored URCs...\n");
@@ -1746,10 +2106,11 @@ bool uCellMuxIsEnabled(uDeviceHandle_t cellHandle)
     return isEnabled;
 }
 
-// Add a multiplexer channel.
-int32_t uCellMuxAddChannel(uDeviceHandle_t cellHandle,
-                           int32_t channel,
-                           uDeviceSerial_t **ppDeviceSerial)
+// Add a multiplexer channel with a given receive buffer size.
+int32_t uCellMuxAddChannelExt(uDeviceHandle_t cellHandle,
+                              int32_t channel,
+                              size_t receiveBufferSizeBytes,
+                              uDeviceSerial_t **ppDeviceSerial)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     uCellPrivateInstance_t *pInstance;
@@ -1770,11 +2131,16 @@ int32_t uCellMuxAddChannel(uDeviceHandle_t cellHandle,
             if (pInstance->pMuxContext != NULL) {
                 pContext = (uCellMuxPrivateContext_t *) pInstance->pMuxContext;
                 if (pContext->savedAtHandle != NULL) {
+                    if (receiveBufferSizeBytes == 0) {
+                        receiveBufferSizeBytes = U_CELL_MUX_PRIVATE_VIRTUAL_SERIAL_BUFFER_LENGTH_BYTES;
+                        if (channel == U_CELL_MUX_CHANNEL_ID_GNSS) {
+                            receiveBufferSizeBytes = U_CELL_MUX_PRIVATE_GNSS_CHANNEL_BUFFER_LENGTH_BYTES;
+                        }
+                    }
                     if (channel == U_CELL_MUX_CHANNEL_ID_GNSS) {
                         channel = pContext->channelGnss;
                     }
-                    errorCode = openChannel(pContext, channel,
-                                            U_CELL_MUX_PRIVATE_VIRTUAL_SERIAL_BUFFER_LENGTH_BYTES);
+                    errorCode = openChannel(pContext, channel, receiveBufferSizeBytes);
                     if (errorCode == 0) {
 #ifdef U_CELL_MUX_ENABLE_DEBUG
                         uPortLog("U_CELL_CMUX_%d: channel added.\n", channel);
@@ -1791,6 +2157,14 @@ int32_t uCellMuxAddChannel(uDeviceHandle_t cellHandle,
     return errorCode;
 }
 
+// Add a multiplexer channel.
+int32_t uCellMuxAddChannel(uDeviceHandle_t cellHandle,
+                           int32_t channel,
+                           uDeviceSerial_t **ppDeviceSerial)
+{
+    return uCellMuxAddChannelExt(cellHandle, channel, 0, ppDeviceSerial);
+}
+
 // Get the serial device handle for an open multiplexer channel.
 uDeviceSerial_t *pUCellMuxChannelGetDeviceSerial(uDeviceHandle_t cellHandle,
                                                  int32_t channel)
@@ -1857,6 +2231,58 @@ int32_t uCellMuxRemoveChannel(uDeviceHandle_t cellHandle,
     return errorCode;
 }
 
+// Set a direct delivery callback for a multiplexer channel.
+int32_t uCellMuxSetDeliveryCallback(uDeviceHandle_t cellHandle,
+                                    uDeviceSerial_t *pDeviceSerial,
+                                    void (*pCallback)(uDeviceSerial_t *pDeviceSerial,
+                                                      const char *pData,
+                                                      size_t sizeBytes,
+                                                      void *pCallbackParam),
+                                    void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uCellMuxPrivateContext_t *pContext;
+    uCellMuxPrivateChannelContext_t *pChannelContext;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        if ((pInstance != NULL) && (pDeviceSerial != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+            if (pInstance->pMuxContext != NULL) {
+                pContext = (uCellMuxPrivateContext_t *) pInstance->pMuxContext;
+                errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+                pChannelContext = (uCellMuxPrivateChannelContext_t *) pUInterfaceContext(pDeviceSerial);
+                // Only for user channels on this multiplexer
+                if ((pChannelContext != NULL) && (pChannelContext->pContext == pContext) &&
+                    !pChannelContext->markedForDeletion &&
+                    (pChannelContext->channel != U_CELL_MUX_PRIVATE_CHANNEL_ID_CONTROL) &&
+                    (pChannelContext->channel != U_CELL_MUX_PRIVATE_CHANNEL_ID_AT)) {
+
+                    U_PORT_MUTEX_LOCK(pChannelContext->mutex);
+
+                    // Null the function first so that the decoder can
+                    // never see a new function with an old parameter
+                    pChannelContext->deliveryCallback.pFunction = NULL;
+                    pChannelContext->deliveryCallback.pParam = pCallbackParam;
+                    pChannelContext->deliveryCallback.pFunction = pCallback;
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+
+                    U_PORT_MUTEX_UNLOCK(pChannelContext->mutex);
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // Disable multiplexer mode.
 int32_t uCellMuxDisable(uDeviceHandle_t cellHandle)
 {
@@ -210,6 +210,53 @@ U_INLINE static bool getByte(uParseHandle_t parseHandle,
     return success;
 }
 
+// Get a block of bytes: if parseHandle is NULL then the pContext
+// buffer will be used as the source and pContext->bufferIndex will be
+// advanced, else the ring-buffer will be used as the source.  pBuffer
+// may be NULL, in which case the bytes are skipped.  memmove() is used
+// in the linear case since the information field may be decoded back
+// into the buffer it came from.
+U_INLINE static size_t getBytes(uParseHandle_t parseHandle,
+                                uCellMuxPrivateParserContext_t *pContext,
+                                char *pBuffer, size_t length)
+{
+    if (parseHandle == NULL) {
+        if (length > pContext->bufferSize - pContext->bufferIndex) {
+            length = pContext->bufferSize - pContext->bufferIndex;
+        }
+        if (pBuffer != NULL) {
+            memmove(pBuffer, pContext->pBuffer + pContext->bufferIndex, length);
+        }
+        pContext->bufferIndex += length;
+    } else {
+        length = uRingBufferGetBytesUnprotected(parseHandle, pBuffer, length);
+    }
+
+    return length;
+}
+
+// Get a pointer to a contiguous span of bytes without copying them:
+// if parseHandle is NULL then the span is in the pContext buffer and
+// pContext->bufferIndex will be advanced, else the span is in the
+// ring buffer, in which case it may be shorter than length if the
+// ring buffer wraps.
+U_INLINE static size_t getSpan(uParseHandle_t parseHandle,
+                               uCellMuxPrivateParserContext_t *pContext,
+                               const char **ppSpan, size_t length)
+{
+    if (parseHandle == NULL) {
+        if (length > pContext->bufferSize - pContext->bufferIndex) {
+            length = pContext->bufferSize - pContext->bufferIndex;
+        }
+        *ppSpan = pContext->pBuffer + pContext->bufferIndex;
+        pContext->bufferIndex += length;
+    } else {
+        length = uRingBufferGetSpanUnprotected(parseHandle, ppSpan, length);
+    }
+
+    return length;
+}
+
 // Get the discard size: if parseHandle is non-NULL then the ring
 // buffer function will be called, else this will return 0 because
 // that is always the right answer for the linear buffer case.
@@ -353,12 +400,41 @@ int32_t uCellMuxPrivateParseCmux(uParseHandle_t parseHandle, void *pUserParam)
     if (bytesAvailable(parseHandle, pContextParser) < (size_t) informationLengthBytes + 2) {
         return U_ERROR_COMMON_TIMEOUT;
     }
-    for (size_t y = 0; y < informationLengthBytes; y++) {
-        getByte(parseHandle, pContextParser, &x);
-        if ((pContextParser->pInformation != NULL) && (y < pContextParser->informationLengthBytes)) {
-            *(pContextParser->pInformation + y) = (char) x;
+    const char *pSpan[2] = {NULL, NULL};
+    size_t spanLengthBytes[2] = {0, 0};
+    if (pContextParser->pSpanCallback != NULL) {
+        // Find where the information field is, without copying it:
+        // two spans is enough since a ring buffer can only wrap once
+        size_t remainingBytes = informationLengthBytes;
+        for (size_t y = 0; (y < sizeof(pSpan) / sizeof(pSpan[0])) && (remainingBytes > 0); y++) {
+            spanLengthBytes[y] = getSpan(parseHandle, pContextParser, &(pSpan[y]), remainingBytes);
+            remainingBytes -= spanLengthBytes[y];
+            if (type != U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH) {
+                for (size_t z = 0; z < spanLengthBytes[y]; z++) {
+                    fcs = gFcsTable[fcs ^ (uint8_t) * (pSpan[y] + z)];
+                }
+            }
         }
-        if (type != U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH) {
+    } else if (type == U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH) {
+        // The FCS of a UIH frame covers only the header, so the
+        // information field, which is where all of the throughput
+        // is, can be copied in bulk and anything that won't fit
+        // in the caller's storage skipped
+        size_t copyLengthBytes = 0;
+        if (pContextParser->pInformation != NULL) {
+            copyLengthBytes = informationLengthBytes;
+            if (copyLengthBytes > pContextParser->informationLengthBytes) {
+                copyLengthBytes = pContextParser->informationLengthBytes;
+            }
+        }
+        getBytes(parseHandle, pContextParser, pContextParser->pInformation, copyLengthBytes);
+        getBytes(parseHandle, pContextParser, NULL, informationLengthBytes - copyLengthBytes);
+    } else {
+        for (size_t y = 0; y < informationLengthBytes; y++) {
+            getByte(parseHandle, pContextParser, &x);
+            if ((pContextParser->pInformation != NULL) && (y < pContextParser->informationLengthBytes)) {
+                *(pContextParser->pInformation + y) = (char) x;
+            }
             fcs = gFcsTable[fcs ^ x];
         }
     }
@@ -379,6 +455,14 @@ int32_t uCellMuxPrivateParseCmux(uParseHandle_t parseHandle, void *pUserParam)
         pContextParser->type = type;
         pContextParser->pollFinal = pollFinal;
         pContextParser->informationLengthBytes = informationLengthBytes;
+        if (pContextParser->pSpanCallback != NULL) {
+            for (size_t y = 0; y < sizeof(pSpan) / sizeof(pSpan[0]); y++) {
+                if (spanLengthBytes[y] > 0) {
+                    pContextParser->pSpanCallback(pSpan[y], spanLengthBytes[y],
+                                                  pContextParser->pSpanCallbackParam);
+                }
+            }
+        }
     }
 
     return (int32_t) U_ERROR_COMMON_SUCCESS;
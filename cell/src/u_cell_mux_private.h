@@ -48,6 +48,10 @@ extern "C" {
  * pouring received data into since the multiplexing protocol serialises
  * several things and, if one of them gets "stuck" because it has nowhere
  * to put its data, the ones that follow will be stuck also. So we use 128.
+ * This is the value requested of the module, as N1, by uCellMuxEnable();
+ * should a module refuse it, smaller values are tried, down to
+ * #U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_DEFAULT_BYTES, and
+ * whatever is agreed is used when sending.
  */
 # define U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES 128
 #endif
@@ -64,6 +68,25 @@ extern "C" {
 # define U_CELL_MUX_PRIVATE_VIRTUAL_SERIAL_BUFFER_LENGTH_BYTES (U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES * 4)
 #endif
 
+/** The default value of N1 from 3GPP 27.010 basic mode, which
+ * any module will accept.
+ */
+#define U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_DEFAULT_BYTES 31
+
+#ifndef U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS
+/** If this is greater than zero then writes to a CMUX channel that
+ * are smaller than an information field are held in a coalescing
+ * buffer for up to this many milliseconds, so that several
+ * of them can be sent as a single CMUX frame, saving the frame
+ * overhead and the UART write for each one.  The buffer is sent
+ * earlier if it fills up, if a larger write comes along or if the
+ * channel is read from (since a read usually means that a response
+ * to what was written is expected).  Off by default as it adds
+ * latency to every short write.
+ */
+# define U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS 0
+#endif
+
 /** The maximum overhead, on top of the information field length, for
  * a CMUX frame, consisting of 1 byte each for the opening and closing
  * flags, 1 byte for the address, 1 byte for control, up to 2 bytes
@@ -100,6 +123,21 @@ extern "C" {
  */
 #define U_CELL_MUX_PRIVATE_INFORMATION_MAX_LENGTH_BYTES 0x7FFF
 
+#ifndef U_CELL_MUX_PRIVATE_AT_CHANNEL_BUFFER_LENGTH_BYTES
+/** The length of the receive buffer for the AT channel.
+ */
+# define U_CELL_MUX_PRIVATE_AT_CHANNEL_BUFFER_LENGTH_BYTES U_CELL_MUX_PRIVATE_VIRTUAL_SERIAL_BUFFER_LENGTH_BYTES
+#endif
+
+#ifndef U_CELL_MUX_PRIVATE_GNSS_CHANNEL_BUFFER_LENGTH_BYTES
+/** The length of the receive buffer for the GNSS channel, used
+ * when uCellMuxAddChannel() is called with #U_CELL_MUX_CHANNEL_ID_GNSS;
+ * larger than that of the AT channel since, at high NMEA rates,
+ * GNSS data arrives in sustained bursts.
+ */
+# define U_CELL_MUX_PRIVATE_GNSS_CHANNEL_BUFFER_LENGTH_BYTES (U_CELL_MUX_PRIVATE_VIRTUAL_SERIAL_BUFFER_LENGTH_BYTES * 2)
+#endif
+
 #ifndef U_CELL_MUX_PRIVATE_BUFFER_LENGTH_BYTES
 /** The length of the raw buffer, enough to store at least
  * one maximum-length CMUX frame on each channel.
@@ -180,6 +218,18 @@ extern "C" {
 # define U_CELL_MUX_PRIVATE_RX_FLOW_OFF_THRESHOLD_PERCENT 40
 #endif
 
+#ifndef U_CELL_MUX_PRIVATE_RX_FLOW_OFF_HEADROOM_FRAMES
+/** The number of maximum-length information fields which the
+ * receive buffer of a channel must still have room for when we
+ * tell the far end to stop sending; this covers frames that are
+ * already in flight when the flow control arrives which would
+ * otherwise stall decoding for all channels.  Only applied where
+ * the receive buffer is large enough to accommodate it, otherwise
+ * #U_CELL_MUX_PRIVATE_RX_FLOW_OFF_THRESHOLD_PERCENT alone applies.
+ */
+# define U_CELL_MUX_PRIVATE_RX_FLOW_OFF_HEADROOM_FRAMES 2
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -237,6 +287,14 @@ typedef struct {
                                         This may be more than the size of pInformation,
                                         though the buffer size of pInformation will always
                                         be respected. */
+    void (*pSpanCallback)(const char *pSpan, size_t sizeBytes,
+                          void *pParam); /**< if non-NULL the information field of a
+                                              decoded CMUX frame is passed to this
+                                              in place, in up to two contiguous spans,
+                                              instead of being copied to pInformation;
+                                              this is only called once the whole frame
+                                              has been validated. */
+    void *pSpanCallbackParam; /**< passed to pSpanCallback as pParam. */
     char *pBuffer;       /**< a buffer to be decoded; may be NULL if the source of
                               information to be decoded is actually a ring-buffer (which
                               works differently, see uCellMuxPrivateParseCmux()). */
@@ -254,6 +312,8 @@ typedef struct {
     uAtClientHandle_t savedAtHandle; /**< the AT client handle we were using in normal mode. */
     int32_t underlyingStreamHandle; /**< the handle of the stream [UART] that the MUX is running on. */
     uint8_t channelGnss; /**< the CMUX channel to use for GNSS. */
+    size_t informationLengthMaxBytes; /**< the maximum information field length (N1)
+                                           agreed with the module. */
     uDeviceSerial_t *pDeviceSerial[U_CELL_MUX_MAX_CHANNELS]; /**< the channels. */
     uRingBuffer_t ringBuffer; /**< the ring buffer where we put the stream from the cellular module,
                                    generic version. */
@@ -279,6 +339,13 @@ typedef struct {
     uint32_t filter;
 } uCellMuxPrivateEventCallback_t;
 
+/** A direct delivery callback, see uCellMuxSetDeliveryCallback().
+ */
+typedef struct {
+    void (*pFunction)(struct uDeviceSerial_t *, const char *, size_t, void *);
+    void *pParam;
+} uCellMuxPrivateDeliveryCallback_t;
+
 /** Structure to hold stuff to do with data transfer for a channel.
  */
 typedef struct {
@@ -293,6 +360,12 @@ typedef struct {
     bool discardOnOverflow;
     bool txIsFlowControlledOff; /**< remote-end doesn't want us to send to it. */
     bool rxIsFlowControlledOff; /**< we don't want the remote-end to send stuff to us. */
+    bool rxFlowOnSent; /**< we have asked the remote end to resume sending but it
+                            has not yet acknowledged that. */
+    size_t rxFlowOffWatermarkBytes; /**< fill level of the receive buffer at or
+                                         above which we flow control off. */
+    size_t rxFlowOnWatermarkBytes;  /**< fill level of the receive buffer at or
+                                         below which we flow control back on. */
 } uCellMuxPrivateTraffic_t;
 
 /** The context data for a single CMUX channel.
@@ -305,6 +378,13 @@ typedef struct {
     uPortMutexHandle_t mutex;
     uCellMuxPrivateTraffic_t traffic;
     uCellMuxPrivateEventCallback_t eventCallback;
+    uCellMuxPrivateDeliveryCallback_t deliveryCallback;
+#if U_CELL_MUX_PRIVATE_WRITE_COALESCE_TIMEOUT_MS > 0
+    char writeCoalesce[U_CELL_MUX_PRIVATE_INFORMATION_LENGTH_MAX_BYTES]; /**< user data waiting
+                                                                              to be sent. */
+    size_t writeCoalesceLength;
+    uPortTimerHandle_t writeCoalesceTimer;
+#endif
 } uCellMuxPrivateChannelContext_t;
 
 /* ----------------------------------------------------------------
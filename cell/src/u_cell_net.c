@@ -92,6 +92,15 @@
 */
 #define U_CELL_NET_CREG_OR_CGREG_TYPE 2
 
+#ifndef U_CELL_NET_REGISTRATION_URC_WAIT_MS
+/** While waiting for registration, how long to wait for a
+ * +CxREG URC to arrive before falling back to querying the
+ * registration status with AT+CxREG?; the loop, and hence
+ * the keep-going callback, is also serviced at this interval.
+ */
+# define U_CELL_NET_REGISTRATION_URC_WAIT_MS 2000
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -196,7 +205,7 @@ static int32_t activateContext(const uCellPrivateInstance_t *pInstance,
 
 // Callback via which the user's registration status callback
 // is called.  This must be called through the uAtClientCallback()
-// mechanism in order to prevent customer code blocking the AT
+// (or uAtClientCallbackPriority()) mechanism in order to prevent customer code blocking the AT
 // client.
 static void registrationStatusCallback(uAtClientHandle_t atHandle,
                                        void *pParameter)
@@ -257,6 +266,7 @@ static void setNetworkStatus(uCellPrivateInstance_t *pInstance,
                              bool fromUrc)
 {
     uCellNetRegistationStatus_t *pStatus;
+    bool reactivationQueued = false;
     bool printAllowed = true;
 #if U_CFG_OS_CLIB_LEAKS
     // If we're in a URC and the C library leaks memory
@@ -357,6 +367,10 @@ static void setNetworkStatus(uCellPrivateInstance_t *pInstance,
     }
 
     pInstance->networkStatus[domain] = status;
+    if (fromUrc && (pInstance->registrationSemaphore != NULL)) {
+        // Let registerNetwork() know that something has happened
+        uPortSemaphoreGive(pInstance->registrationSemaphore);
+    }
 
     pInstance->rat[domain] = U_CELL_NET_RAT_UNKNOWN_OR_NOT_USED;
     if (U_CELL_NET_STATUS_MEANS_REGISTERED(status) &&
@@ -384,6 +398,7 @@ static void setNetworkStatus(uCellPrivateInstance_t *pInstance,
                 // out of the URC task
                 uAtClientCallback(pInstance->atHandle,
                                   activateContextCallback, pInstance);
+                reactivationQueued = true;
             }
             pInstance->profileState = U_CELL_PRIVATE_PROFILE_STATE_SHOULD_BE_UP;
         }
@@ -405,8 +420,17 @@ static void setNetworkStatus(uCellPrivateInstance_t *pInstance,
             pStatus->networkStatus = status;
             pStatus->pCallback = pInstance->pRegistrationStatusCallback;
             pStatus->pCallbackParameter = pInstance->pRegistrationStatusCallbackParameter;
-            uAtClientCallback(pInstance->atHandle,
-                              registrationStatusCallback, pStatus);
+            if (reactivationQueued) {
+                // Must run after activateContextCallback(), which is
+                // on the normal callback queue, so use the same queue
+                uAtClientCallback(pInstance->atHandle,
+                                  registrationStatusCallback, pStatus);
+            } else {
+                // Use the priority callback queue so that the user
+                // isn't kept waiting behind, e.g., socket data reads
+                uAtClientCallbackPriority(pInstance->atHandle,
+                                          registrationStatusCallback, pStatus);
+            }
         }
     }
 }
@@ -480,9 +504,9 @@ static inline uCellNetStatus_t CXREG_urc(uCellPrivateInstance_t *pInstance,
         // the end, inserted) after <tac> and before <ci>, which has to be
         // skipped before the RAT can be read.
         if ((gRegTypes[2 /* CEREG */].type == 4) &&
-            (((pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R410M_02B) ||
-              (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R412M_02B)) ||
-             ((pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_LARA_R6) &&
+            (((U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R410M_02B) ||
+              (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R412M_02B)) ||
+             ((U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_LARA_R6) &&
               responseToCommandNotUrc))) {
             skippedParameters++;
         }
@@ -606,7 +630,7 @@ static void CEREG_urc(uAtClientHandle_t atHandle,
 
 // Callback via which the user's base station connection
 // status callback is called.  This must be called through
-// the uAtClientCallback() mechanism in order to prevent
+// the uAtClientCallbackPriority() mechanism in order to prevent
 // customer code blocking the AT client.
 static void connectionStatusCallback(uAtClientHandle_t atHandle,
                                      void *pParameter)
@@ -651,7 +675,7 @@ static void CSCON_urc(uAtClientHandle_t atHandle,
             pStatus->isConnected = isConnected;
             pStatus->pCallback = pInstance->pConnectionStatusCallback;
             pStatus->pCallbackParameter = pInstance->pConnectionStatusCallbackParameter;
-            uAtClientCallback(atHandle, connectionStatusCallback, pStatus);
+            uAtClientCallbackPriority(atHandle, connectionStatusCallback, pStatus);
         }
     }
 }
@@ -774,6 +798,12 @@ static int32_t prepareConnect(uCellPrivateInstance_t *pInstance)
         uAtClientCommandStopReadResponse(atHandle);
         errorCode = uAtClientUnlock(atHandle);
     }
+    if ((errorCode == 0) && (pInstance->registrationSemaphore == NULL)) {
+        // Create the semaphore that the URCs give to let
+        // registerNetwork() know about a change; if this
+        // fails registerNetwork() will just poll
+        uPortSemaphoreCreate(&(pInstance->registrationSemaphore), 0, 1);
+    }
     if (errorCode == 0) {
         // We're not going to get anywhere unless a SIM
         // is inserted and this might take a while to be
@@ -1081,6 +1111,10 @@ static int32_t registerNetwork(uCellPrivateInstance_t *pInstance,
         // Wait for registration to succeed
         errorCode = (int32_t) U_CELL_ERROR_NOT_REGISTERED;
         regType = 0;
+        if (pInstance->registrationSemaphore != NULL) {
+            // Make sure we don't pick up a stale give
+            uPortSemaphoreTryTake(pInstance->registrationSemaphore, 0);
+        }
         while (keepGoing && keepGoingLocalCb(pInstance) &&
                !uCellPrivateIsRegistered(pInstance)) {
             // Prod the modem anyway, we've nout much else to do
@@ -1145,9 +1179,11 @@ static int32_t registerNetwork(uCellPrivateInstance_t *pInstance,
                 if (U_CELL_NET_STATUS_MEANS_REGISTERED(status)) {
                     // Skip <lac>/<tac>
                     if ((regType == 2 /* CEREG */) && (gRegTypes[regType].type == 4) &&
-                        (((pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R410M_02B) ||
-                          (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R412M_02B)) ||
-                         ((pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_LARA_R6) &&
+                        (((U_CELL_PRIVATE_MODULE_TYPE(pInstance) ==
+                           U_CELL_MODULE_TYPE_SARA_R410M_02B) ||
+                          (U_CELL_PRIVATE_MODULE_TYPE(pInstance) ==
+                           U_CELL_MODULE_TYPE_SARA_R412M_02B)) ||
+                         ((U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_LARA_R6) &&
                           !gotUrc))) {
                         // SARA-R41x-02B modules, and LARA-R6 modules but only in the
                         // non-URC case, sneak an extra <rac_or_mme> parameter in between
@@ -1183,6 +1219,13 @@ static int32_t registerNetwork(uCellPrivateInstance_t *pInstance,
                     if (errorCount > 10) {
                         keepGoing = false;
                     }
+                } else if ((pInstance->registrationSemaphore != NULL) &&
+                           !uCellPrivateIsRegistered(pInstance)) {
+                    // Rather than hammering the AT interface, wait for
+                    // a +CxREG URC to tell us something has changed,
+                    // only querying again if none turns up
+                    uPortSemaphoreTryTake(pInstance->registrationSemaphore,
+                                          U_CELL_NET_REGISTRATION_URC_WAIT_MS);
                 } else {
                     uPortTaskBlock(300);
                 }
@@ -1343,8 +1386,8 @@ static int32_t setAuthenticationMode(const uCellPrivateInstance_t *pInstance,
     uAtClientCommandStart(atHandle, "AT+UAUTHREQ=");
     uAtClientWriteInt(atHandle, contextId);
     uAtClientWriteInt(atHandle, 3); // Automatic choice of authentication type
-    if (!U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType) &&
-        (pInstance->pModule->moduleType != U_CELL_MODULE_TYPE_LARA_R6)) {
+    if (!U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance)) &&
+        (U_CELL_PRIVATE_MODULE_TYPE(pInstance) != U_CELL_MODULE_TYPE_LARA_R6)) {
         uAtClientWriteString(atHandle, pUsername, true);
         uAtClientWriteString(atHandle, pPassword, true);
     } else {
@@ -1774,7 +1817,7 @@ static int32_t handleExistingContext(uCellPrivateInstance_t *pInstance,
             // need to do something about it
             rat = uCellPrivateGetActiveRat(pInstance);
             if (U_CELL_PRIVATE_RAT_IS_EUTRAN(rat) ||
-                U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                 // If we're on EUTRAN or we're on SARA-R4,
                 // can't/don't go to the "no PDP context" state.
                 // Deregistration will sort it
@@ -1800,6 +1843,34 @@ static int32_t handleExistingContext(uCellPrivateInstance_t *pInstance,
  * STATIC FUNCTIONS: MISC
  * -------------------------------------------------------------- */
 
+// Get the APN database entry to start with for the given IMSI.  If
+// a previous connection with the same IMSI succeeded using an entry
+// further down the APN database then that entry is returned so that
+// it is tried first, with *ppApnConfigFallback set to the start of
+// the database entries for the IMSI, else *ppApnConfigFallback is
+// set to NULL.
+static const char *pApnGetConfigFast(uCellPrivateInstance_t *pInstance,
+                                     const char *pImsi,
+                                     const char **ppApnConfigFallback)
+{
+    const char *pApnConfig = pApnGetConfig(pImsi);
+
+    *ppApnConfigFallback = NULL;
+    if (memcmp(pInstance->apnDbImsi, pImsi, sizeof(pInstance->apnDbImsi)) != 0) {
+        // A different SIM, forget what we knew
+        memcpy(pInstance->apnDbImsi, pImsi, sizeof(pInstance->apnDbImsi));
+        pInstance->pApnDbLast = NULL;
+    }
+    if ((pInstance->pApnDbLast != NULL) && (pApnConfig != NULL) &&
+        (pInstance->pApnDbLast != pApnConfig)) {
+        *ppApnConfigFallback = pApnConfig;
+        pApnConfig = pInstance->pApnDbLast;
+        uPortLog("U_CELL_NET: trying the last APN that worked first.\n");
+    }
+
+    return pApnConfig;
+}
+
 // Read DNS addresses SARA-R4/R5/R6 style.
 static int32_t getDnsStr(const uCellPrivateInstance_t *pInstance,
                          bool v6, char *pStrDns1, char *pStrDns2)
@@ -2082,6 +2153,8 @@ int32_t uCellNetConnect(uDeviceHandle_t cellHandle,
     uCellPrivateInstance_t *pInstance;
     char buffer[15];  // At least 15 characters for the IMSI
     const char *pApnConfig = NULL;
+    const char *pApnConfigThis = NULL;
+    const char *pApnConfigFallback = NULL;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -2109,12 +2182,14 @@ int32_t uCellNetConnect(uDeviceHandle_t cellHandle,
                                               U_CELL_MNO_DB_FEATURE_NO_CGDCONT) &&
                         (uCellPrivateGetImsi(pInstance, buffer) == 0)) {
                         // Set up the APN look-up since none is specified
-                        pApnConfig = pApnGetConfig(buffer);
+                        pApnConfig = pApnGetConfigFast(pInstance, buffer,
+                                                       &pApnConfigFallback);
                     }
                     pInstance->pKeepGoingCallback = pKeepGoingCallback;
                     pInstance->startTimeMs = uPortGetTickTimeMs();
                     // Now try to connect, potentially multiple times
                     do {
+                        pApnConfigThis = pApnConfig;
                         if (pApnConfig != NULL) {
                             pApn = _APN_GET(pApnConfig);
                             pUsername = _APN_GET(pApnConfig);
@@ -2235,6 +2310,12 @@ int32_t uCellNetConnect(uDeviceHandle_t cellHandle,
                                 }
                             }
                         }
+                        if ((errorCode != 0) && (pApnConfigFallback != NULL)) {
+                            // The APN that worked last time didn't work this
+                            // time, go back to the start of the database
+                            pApnConfig = pApnConfigFallback;
+                            pApnConfigFallback = NULL;
+                        }
                         // Exit if there are no errors or if the APN
                         // was user-specified (pApnConfig == NULL) or
                         // we're out of APN database options or the
@@ -2243,6 +2324,11 @@ int32_t uCellNetConnect(uDeviceHandle_t cellHandle,
                              (*pApnConfig != '\0') && keepGoingLocalCb(pInstance));
 
                     if (errorCode == 0) {
+                        if (pApnConfigThis != NULL) {
+                            // Remember which APN database entry worked
+                            // so that it can be tried first next time
+                            pInstance->pApnDbLast = pApnConfigThis;
+                        }
                         // Remember the MCC/MNC in case we need to deactivate
                         // and reactivate context later and that causes
                         // de/re-registration.
@@ -2371,6 +2457,8 @@ int32_t uCellNetActivate(uDeviceHandle_t cellHandle,
     const char *pMccMnc = NULL;
     char imsi[15];
     const char *pApnConfig = NULL;
+    const char *pApnConfigThis = NULL;
+    const char *pApnConfigFallback = NULL;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -2394,10 +2482,12 @@ int32_t uCellNetActivate(uDeviceHandle_t cellHandle,
                     if ((pApn == NULL) &&
                         (uCellPrivateGetImsi(pInstance, imsi) == 0)) {
                         // Set up the APN look-up since none is specified
-                        pApnConfig = pApnGetConfig(imsi);
+                        pApnConfig = pApnGetConfigFast(pInstance, imsi,
+                                                       &pApnConfigFallback);
                     }
                     // Now try to activate the context, potentially multiple times
                     do {
+                        pApnConfigThis = pApnConfig;
                         if (pApnConfig != NULL) {
                             pApn = _APN_GET(pApnConfig);
                             pUsername = _APN_GET(pApnConfig);
@@ -2459,12 +2549,24 @@ int32_t uCellNetActivate(uDeviceHandle_t cellHandle,
                                                             U_CELL_NET_PROFILE_ID);
                             }
                         }
+                        if ((errorCode != 0) && (pApnConfigFallback != NULL)) {
+                            // The APN that worked last time didn't work this
+                            // time, go back to the start of the database
+                            pApnConfig = pApnConfigFallback;
+                            pApnConfigFallback = NULL;
+                        }
                         // Exit if there are no errors or if the APN
                         // was user-specified (pApnConfig == NULL) or
                         // we're out of APN database options
                     } while ((errorCode != 0) && (pApnConfig != NULL) &&
                              (*pApnConfig != '\0') && keepGoingLocalCb(pInstance));
 
+                    if ((errorCode == 0) && (pApnConfigThis != NULL)) {
+                        // Remember which APN database entry worked
+                        // so that it can be tried first next time
+                        pInstance->pApnDbLast = pApnConfigThis;
+                    }
+
                     // Take away the callback again
                     pInstance->pKeepGoingCallback = NULL;
                     pInstance->startTimeMs = 0;
@@ -2513,7 +2615,7 @@ int32_t uCellNetDeactivate(uDeviceHandle_t cellHandle,
             if (uCellPrivateIsRegistered(pInstance)) {
                 rat = uCellPrivateGetActiveRat(pInstance);
                 if (U_CELL_PRIVATE_RAT_IS_EUTRAN(rat) ||
-                    U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                    U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                     // Can't not have a PDP context, deregister entirely
                     errorCode = disconnectNetwork(pInstance, pKeepGoingCallback);
                 } else {
@@ -2803,7 +2905,7 @@ int32_t uCellNetDeepScan(uDeviceHandle_t cellHandle,
         pInstance = pUCellPrivateGetInstance(cellHandle);
         if (pInstance != NULL) {
             errorCodeOrNumber = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
-            if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+            if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
                 // Make sure the radio is on for this
                 cFunMode = uCellPrivateCFunOne(pInstance);
                 atHandle = pInstance->atHandle;
@@ -2842,9 +2944,11 @@ int32_t uCellNetDeepScan(uDeviceHandle_t cellHandle,
                                 if (pCallback != NULL) {
                                     keepGoing = pCallback(cellHandle, &cell, pCallbackParameter);
                                 }
-                                // Wait for more
+                                // Look for more straight away: the AT timeout
+                                // provides the wait if there is nothing there,
+                                // while lines that have already arrived are
+                                // passed to the callback without delay
                                 errorCodeOrNumber = (int32_t) U_ERROR_COMMON_TIMEOUT;
-                                uPortTaskBlock(1000);
                             }
                         } else {
                             // Either there was nothing (a timeout) or there was a "+CME ERROR"
@@ -2861,9 +2965,6 @@ int32_t uCellNetDeepScan(uDeviceHandle_t cellHandle,
                                     }
                                     errorCodeOrNumber = (int32_t) U_ERROR_COMMON_TIMEOUT;
                                     uAtClientClearError(atHandle);
-                                    if (keepGoing) {
-                                        uPortTaskBlock(1000);
-                                    }
                                 }
                             }
                         }
@@ -47,6 +47,8 @@
 
 #include "u_at_client.h"
 
+#include "u_device_shared.h"
+
 #include "u_sock.h"
 
 #include "u_security.h"
@@ -95,6 +97,7 @@ uPortMutexHandle_t gUCellPrivateMutex = NULL;
  * compiled into the driver.
  */
 const uCellPrivateModule_t gUCellPrivateModuleList[] = {
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_U201)
     {
         U_CELL_MODULE_TYPE_SARA_U201, 1 /* Pwr On pull ms */, 1500 /* Pwr off pull ms */,
         5 /* Boot wait */, 5 /* Min awake */, 5 /* Pwr down wait */, 5 /* Reboot wait */, 10 /* AT timeout */,
@@ -102,21 +105,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         2 /* Simultaneous RATs */,
         ((1ULL << (int32_t) U_CELL_NET_RAT_GSM_GPRS_EGPRS) |
          (1ULL << (int32_t) U_CELL_NET_RAT_UTRAN)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_USE_UPSD_CONTEXT_ACTIVATION) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CONTEXT_MAPPING_REQUIRED)    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AUTO_BAUDING)                |
-         // In theory SARA-U201 does support DTR power saving however we do not
-         // have this in our regression test farm and hence it is not marked
-         // as supported for now
-         // (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DTR_POWER_SAVING)
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AT_PROFILES)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CTS_CONTROL)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SOCK_SET_LOCAL_PORT)         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING) /* features */
-         // CMUX is supported here but we do not test it hence it is not marked as supported
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_U201 /* features */,
         6 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_R410M_02B)
     {
         U_CELL_MODULE_TYPE_SARA_R410M_02B, 300 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         6 /* Boot wait */, 30 /* Min awake */, 35 /* Pwr down wait */, 5 /* Reboot wait */, 10 /* AT timeout */,
@@ -124,24 +117,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         2 /* Simultaneous RATs */,
         ((1ULL << (int32_t) U_CELL_NET_RAT_CATM1)          |
          (1ULL << (int32_t) U_CELL_NET_RAT_NB1)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)        |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CLOSE)   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)               |
-         // In theory SARA-R410M does support keep alive but I have been
-         // unable to make it work (always returns error) and hence this is
-         // not marked as supported for now
-         // (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                  |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)  /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_R410M_02B /* features */,
         3 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_R412M_02B)
     {
         U_CELL_MODULE_TYPE_SARA_R412M_02B, 300 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         5 /* Boot wait */, 30 /* Min awake */, 35 /* Pwr down wait */, 10 /* Reboot wait */, 10 /* AT timeout */,
@@ -150,28 +130,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         ((1ULL << (int32_t) U_CELL_NET_RAT_GSM_GPRS_EGPRS) |
          (1ULL << (int32_t) U_CELL_NET_RAT_CATM1)          |
          (1ULL << (int32_t) U_CELL_NET_RAT_NB1)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                            |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                                  |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CLOSE)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION)    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)             |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SET_LOCAL_PORT)                 |
-         // In theory SARA-R412M does support keep alive but I have been
-         // unable to make it work (always returns error) and hence this is
-         // not marked as supported for now
-         // (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SESSION_RETAIN)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                              |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)  /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_R412M_02B /* features */,
         3 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_R412M_03B)
     {
         U_CELL_MODULE_TYPE_SARA_R412M_03B, 300 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         6 /* Boot wait */, 30 /* Min awake */, 35 /* Pwr down wait */, 5 /* Reboot wait */, 10 /* AT timeout */,
@@ -180,19 +143,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         ((1ULL << (int32_t) U_CELL_NET_RAT_GSM_GPRS_EGPRS) |
          (1ULL << (int32_t) U_CELL_NET_RAT_CATM1)          |
          (1ULL << (int32_t) U_CELL_NET_RAT_NB1)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                              |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX) /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_R412M_03B /* features */,
         3 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_R5)
     {
         U_CELL_MODULE_TYPE_SARA_R5, 1500 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         6 /* Boot wait */, 10 /* Min awake */, 20 /* Pwr down wait */, 15 /* Reboot wait */, 10 /* AT timeout */,
@@ -204,38 +159,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         ((1ULL << (int32_t) U_CELL_NET_RAT_CATM1) |
          (1ULL << (int32_t) U_CELL_NET_RAT_NB1)) /* RATs */,
 #endif
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ROOT_OF_TRUST)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DATA_COUNTERS)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_IANA_NUMBERING)         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_CIPHER_LIST)            |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_WILL)                           |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CONTEXT_MAPPING_REQUIRED)            |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AUTO_BAUDING)                        |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AT_PROFILES)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_ZTP)                        |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DTR_POWER_SAVING)                    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING_PAGING_WINDOW_SET) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTTSN)                              |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CTS_CONTROL)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SOCK_SET_LOCAL_PORT)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SNR_REPORTED) /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_R5 /* features */,
         4 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_R410M_03B)
     {
         U_CELL_MODULE_TYPE_SARA_R410M_03B, 300 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         6 /* Boot wait */, 30 /* Min awake */, 35 /* Pwr down wait */, 5 /* Reboot wait */, 10 /* AT timeout */,
@@ -243,22 +171,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         2 /* Simultaneous RATs */,
         ((1ULL << (int32_t) U_CELL_NET_RAT_CATM1)          |
          (1ULL << (int32_t) U_CELL_NET_RAT_NB1)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                              |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)   /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_R410M_03B /* features */,
         3 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_SARA_R422)
     {
         U_CELL_MODULE_TYPE_SARA_R422, 300 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         5 /* Boot wait */, 30 /* Min awake */, 35 /* Pwr down wait */, 10 /* Reboot wait */, 10 /* AT timeout */,
@@ -267,35 +184,11 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         ((1ULL << (int32_t) U_CELL_NET_RAT_GSM_GPRS_EGPRS) |
          (1ULL << (int32_t) U_CELL_NET_RAT_CATM1)          |
          (1ULL << (int32_t) U_CELL_NET_RAT_NB1)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ROOT_OF_TRUST)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CLOSE)                    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_IANA_NUMBERING)         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_WILL)                           |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CONTEXT_MAPPING_REQUIRED)            |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      |
-         // SARA-R422 _does_ support 3GPP power saving, however the tests fail at the
-         // moment because a second attempt to enter 3GPP power saving, after waking-up
-         // from sleep to do something, fails, hence the support is disabled until
-         // we determine why that is
-         //(1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   |
-         //(1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING_PAGING_WINDOW_SET) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                  |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTTSN)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                  |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                  |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SNR_REPORTED) /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_SARA_R422 /* features */,
         3 /* Default CMUX channel for GNSS */
     },
+#endif
+#if U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(U_CELL_PRIVATE_MODULE_NUM_LARA_R6)
     {
         U_CELL_MODULE_TYPE_LARA_R6, 300 /* Pwr On pull ms */, 2000 /* Pwr off pull ms */,
         10 /* Boot wait */, 30 /* Min awake */, 35 /* Pwr down wait */, 10 /* Reboot wait */, 10 /* AT timeout */,
@@ -304,26 +197,10 @@ const uCellPrivateModule_t gUCellPrivateModuleList[] = {
         ((1ULL << (int32_t) U_CELL_NET_RAT_GSM_GPRS_EGPRS) |
          (1ULL << (int32_t) U_CELL_NET_RAT_LTE)            |
          (1ULL << (int32_t) U_CELL_NET_RAT_UTRAN)) /* RATs */,
-        ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ROOT_OF_TRUST)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_IANA_NUMBERING)         |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_WILL)                           |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DTR_POWER_SAVING)                    |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTTSN)                              |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SOCK_SET_LOCAL_PORT)                 |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                |
-         (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SNR_REPORTED) /* features */
-        ),
+        U_CELL_PRIVATE_FEATURES_LARA_R6 /* features */,
         3 /* Default CMUX channel for GNSS */
-    }
+    },
+#endif
 };
 
 /** Number of items in the gUCellPrivateModuleList array, has to be
@@ -544,7 +421,7 @@ int32_t privateActivateProfile(const uCellPrivateInstance_t *pInstance,
                 errorCode = uAtClientUnlock(atHandle);
             }
             if ((errorCode == 0) &&
-                (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5)) {
+                (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5)) {
                 errorCode = (int32_t) U_CELL_ERROR_CONTEXT_ACTIVATION_FAILURE;
                 // SARA-R5 pattern: the context also has to be
                 // activated and we're not actually done
@@ -599,10 +476,18 @@ bool uCellPrivateIsNumeric(const char *pBuffer, size_t bufferSize)
 // Find a cellular instance in the list by instance handle.
 uCellPrivateInstance_t *pUCellPrivateGetInstance(uDeviceHandle_t cellHandle)
 {
-    uCellPrivateInstance_t *pInstance = gpUCellPrivateInstanceList;
-
-    while ((pInstance != NULL) && (pInstance->cellHandle != cellHandle)) {
-        pInstance = pInstance->pNext;
+    uCellPrivateInstance_t *pInstance = NULL;
+    uDeviceInstance_t *pDevInstance;
+
+    // The device instance points straight at our instance, no
+    // need to search the list; the device instance is invalidated
+    // when the cellular instance is removed
+    if ((uDeviceGetInstance(cellHandle, &pDevInstance) == 0) &&
+        (pDevInstance->deviceType == U_DEVICE_TYPE_CELL)) {
+        pInstance = (uCellPrivateInstance_t *) pDevInstance->pApiInstance;
+        if ((pInstance != NULL) && (pInstance->cellHandle != cellHandle)) {
+            pInstance = NULL;
+        }
     }
 
     return pInstance;
@@ -669,6 +554,9 @@ void uCellPrivateClearDynamicParameters(uCellPrivateInstance_t *pInstance)
         pInstance->rat[x] = U_CELL_NET_RAT_UNKNOWN_OR_NOT_USED;
     }
     uCellPrivateClearRadioParameters(&(pInstance->radioParameters), false);
+    // Can't be sure that the security profiles in the module
+    // have been retained
+    pInstance->secTlsProfileCacheBitmap = 0;
 }
 
 // Get the current CFUN mode.
@@ -915,13 +803,9 @@ void uCellPrivateScanFree(uCellPrivateNet_t **ppScanResults)
 // Get the module characteristics for a given instance.
 const uCellPrivateModule_t *pUCellPrivateGetModule(uDeviceHandle_t cellHandle)
 {
-    uCellPrivateInstance_t *pInstance = gpUCellPrivateInstanceList;
+    uCellPrivateInstance_t *pInstance = pUCellPrivateGetInstance(cellHandle);
     const uCellPrivateModule_t *pModule = NULL;
 
-    while ((pInstance != NULL) && (pInstance->cellHandle != cellHandle)) {
-        pInstance = pInstance->pNext;
-    }
-
     if (pInstance != NULL) {
         pModule = pInstance->pModule;
     }
@@ -944,6 +828,8 @@ void uCellPrivateLocRemoveContext(uCellPrivateInstance_t *pInstance)
             U_PORT_MUTEX_UNLOCK(pContext->fixDataStorageMutex);
             uPortMutexDelete(pContext->fixDataStorageMutex);
             pContext->fixDataStorageMutex = NULL;
+            // Free any cached fix
+            uPortFree(pContext->pFixCache);
         }
         // Free the context
         uPortFree(pContext);
@@ -1108,7 +994,7 @@ int32_t uCellPrivateSuspendUartPowerSaving(const uCellPrivateInstance_t *pInstan
         uAtClientResponseStart(atHandle, "+UPSV:");
         *pMode = uAtClientReadInt(atHandle);
         *pTimeout = -1;
-        if (!U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType) &&
+        if (!U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance)) &&
             ((*pMode == 1) || (*pMode == 4))) {
             // Only non-SARA-R4 modules have a timeout value and
             // only for AT+UPSV modes 1 and 4
@@ -1288,6 +1174,24 @@ void uCellPrivateFileListLast(uCellPrivateFileListContainer_t **ppFileListContai
     }
 }
 
+// Remove the file system cache for the given instance.
+void uCellPrivateFileCacheRemove(uCellPrivateInstance_t *pInstance)
+{
+    uCellPrivateFileCacheEntry_t *pEntry;
+    uCellPrivateFileCacheEntry_t *pNextEntry;
+
+    if ((pInstance != NULL) && (pInstance->pFileCache != NULL)) {
+        pEntry = pInstance->pFileCache->pList;
+        while (pEntry != NULL) {
+            pNextEntry = pEntry->pNext;
+            uPortFree(pEntry);
+            pEntry = pNextEntry;
+        }
+        uPortFree(pInstance->pFileCache);
+        pInstance->pFileCache = NULL;
+    }
+}
+
 // Remove the HTTP context for the given instance.
 void uCellPrivateHttpRemoveContext(uCellPrivateInstance_t *pInstance)
 {
@@ -1507,6 +1411,60 @@ void uCellPrivateCellTimeRemoveContext(uCellPrivateInstance_t *pInstance)
     }
 }
 
+// Determine whether a capability of the module should be tried.
+bool uCellPrivateCapabilityTry(const uCellPrivateInstance_t *pInstance,
+                               uCellPrivateCapability_t capability)
+{
+    uint32_t bit = 1UL << (int32_t) capability;
+
+    return ((pInstance->capabilityProbedBitmap & bit) == 0) ||
+           ((pInstance->capabilitySupportedBitmap & bit) != 0);
+}
+
+// Record the outcome of trying a capability of the module.
+void uCellPrivateCapabilitySet(uCellPrivateInstance_t *pInstance,
+                               uCellPrivateCapability_t capability,
+                               int32_t atError,
+                               const uAtClientDeviceError_t *pDeviceError)
+{
+    uint32_t bit = 1UL << (int32_t) capability;
+
+    if (atError == 0) {
+        pInstance->capabilityProbedBitmap |= bit;
+        pInstance->capabilitySupportedBitmap |= bit;
+    } else if (pDeviceError->type != U_AT_CLIENT_DEVICE_ERROR_TYPE_NO_ERROR) {
+        pInstance->capabilityProbedBitmap |= bit;
+        pInstance->capabilitySupportedBitmap &= ~bit;
+    }
+}
+
+// Read binary data from the AT client receive buffer.
+int32_t uCellPrivateReadBytesInPlace(uAtClientHandle_t atHandle,
+                                     char *pBuffer, size_t lengthBytes)
+{
+    int32_t errorCodeOrLength = 0;
+    int32_t x = 0;
+    const char *pData;
+
+    while ((lengthBytes > 0) && (x >= 0)) {
+        x = uAtClientReadBytesInPlace(atHandle, &pData, lengthBytes);
+        if (x > 0) {
+            if (pBuffer != NULL) {
+                memcpy(pBuffer, pData, x);
+                pBuffer += x;
+            }
+            uAtClientReadBytesInPlaceRelease(atHandle, x);
+            lengthBytes -= x;
+            errorCodeOrLength += x;
+        } else {
+            errorCodeOrLength = x;
+            x = -1;
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
 // Perform an abort of an AT command.
 void uCellPrivateAbortAtCommand(const uCellPrivateInstance_t *pInstance)
 {
@@ -105,14 +105,269 @@ extern "C" {
      ((rat) == U_CELL_NET_RAT_CATM1) ||    \
      ((rat) == U_CELL_NET_RAT_NB1))
 
+/** The features of each module type, the featuresBitmap field of
+ * its entry in gUCellPrivateModuleList; these are macros so that,
+ * where the module type is fixed at compile time with
+ * U_CFG_CELL_MODULE_TYPE_ONLY, U_CELL_PRIVATE_HAS() is a constant.
+ */
+#define U_CELL_PRIVATE_FEATURES_SARA_U201                                                   \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_USE_UPSD_CONTEXT_ACTIVATION) |               \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CONTEXT_MAPPING_REQUIRED)    |               \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AUTO_BAUDING)                |               \
+     /* In theory SARA-U201 does support DTR power saving however we do not */              \
+     /* have this in our regression test farm and hence it is not marked */                 \
+     /* as supported for now */                                                             \
+     /* (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DTR_POWER_SAVING) */                      \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AT_PROFILES)                 |               \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CTS_CONTROL)                 |               \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SOCK_SET_LOCAL_PORT)         |               \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                           \
+     /* CMUX is supported here but we do not test it hence it is not marked as supported */ \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_SARA_R410M_02B                                  \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)        |            \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CLOSE)   |            \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)               |            \
+     /* In theory SARA-R410M does support keep alive but I have been */         \
+     /* unable to make it work (always returns error) and hence this is */      \
+     /* not marked as supported for now */                                      \
+     /* (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)         | */ \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX) |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                  |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)         |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)       |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                    |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                    |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)       |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                            \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_SARA_R412M_02B                                              \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                            |    \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                                  |    \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CLOSE)                       |    \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION)    |    \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)             |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SET_LOCAL_PORT)                 |       \
+     /* In theory SARA-R412M does support keep alive but I have been */                     \
+     /* unable to make it work (always returns error) and hence this is */                  \
+     /* not marked as supported for now */                                                  \
+     /* (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     | */ \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SESSION_RETAIN)                 |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                              |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                        \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_SARA_R412M_03B                                        \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                              | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                  \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_SARA_R5                                               \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ROOT_OF_TRUST)                       | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DATA_COUNTERS)                       | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_IANA_NUMBERING)         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_CIPHER_LIST)            | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)                 | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_WILL)                           | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CONTEXT_MAPPING_REQUIRED)            | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AUTO_BAUDING)                        | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_AT_PROFILES)                         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_ZTP)                        | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DTR_POWER_SAVING)                    | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING_PAGING_WINDOW_SET) | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTTSN)                              | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CTS_CONTROL)                         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SOCK_SET_LOCAL_PORT)                 | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SNR_REPORTED)                        | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CONNECT)                    \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_SARA_R410M_03B                                        \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UCGED5)                              | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                   | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                  \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_SARA_R422                                                   \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ROOT_OF_TRUST)                       |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CLOSE)                    |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_IANA_NUMBERING)         |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)                 |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_WILL)                           |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CONTEXT_MAPPING_REQUIRED)            |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     |       \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DEEP_SLEEP_URC)                      |       \
+     /* SARA-R422 _does_ support 3GPP power saving, however the tests fail at the */        \
+     /* moment because a second attempt to enter 3GPP power saving, after waking-up */      \
+     /* from sleep to do something, fails, hence the support is disabled until */           \
+     /* we determine why that is */                                                         \
+     /* (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING)                   | */ \
+     /* (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_3GPP_POWER_SAVING_PAGING_WINDOW_SET) | */ \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_EDRX)                                  |     \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTTSN)                                |     \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                  |     \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING)                     |     \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                  |     \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SNR_REPORTED)                                \
+    )
+
+#define U_CELL_PRIVATE_FEATURES_LARA_R6                                               \
+    ((1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MNO_PROFILE)                         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CSCON)                               | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ROOT_OF_TRUST)                       | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_IANA_NUMBERING)         | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SECURITY_TLS_SERVER_NAME_INDICATION) | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_BINARY_PUBLISH)                 | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_WILL)                           | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_KEEP_ALIVE)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTT_SECURITY)                       | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FILE_SYSTEM_TAG)                     | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_DTR_POWER_SAVING)                    | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_MQTTSN)                              | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SOCK_SET_LOCAL_PORT)                 | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_FOTA)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_CMUX)                                | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_SNR_REPORTED)                        | \
+     (1ULL << (int32_t) U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CONNECT)                    \
+    )
+
+/** The value of each member of uCellModuleType_t, by suffix, for use
+ * where the preprocessor needs a number; must match uCellModuleType_t.
+ */
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_U201      0
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_R410M_02B 1
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_R412M_02B 2
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_R412M_03B 3
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_R5        4
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_R410M_03B 5
+#define U_CELL_PRIVATE_MODULE_NUM_SARA_R422      6
+#define U_CELL_PRIVATE_MODULE_NUM_LARA_R6        7
+
+/** Helpers to paste the suffix given by U_CFG_CELL_MODULE_TYPE_ONLY
+ * onto something.
+ */
+#define U_CELL_PRIVATE_CONCAT_(a, b) a##b
+#define U_CELL_PRIVATE_CONCAT(a, b) U_CELL_PRIVATE_CONCAT_(a, b)
+
+#ifdef U_CFG_CELL_MODULE_TYPE_ONLY
+/** The number of the only module type this driver supports.
+ */
+# define U_CELL_PRIVATE_MODULE_NUM_ONLY \
+    U_CELL_PRIVATE_CONCAT(U_CELL_PRIVATE_MODULE_NUM_, U_CFG_CELL_MODULE_TYPE_ONLY)
+/** The only module type this driver supports.
+ */
+# define U_CELL_PRIVATE_MODULE_TYPE_ONLY \
+    U_CELL_PRIVATE_CONCAT(U_CELL_MODULE_TYPE_, U_CFG_CELL_MODULE_TYPE_ONLY)
+/** The features of the only module type this driver supports.
+ */
+# define U_CELL_PRIVATE_FEATURES_ONLY \
+    U_CELL_PRIVATE_CONCAT(U_CELL_PRIVATE_FEATURES_, U_CFG_CELL_MODULE_TYPE_ONLY)
+#else
+# define U_CELL_PRIVATE_MODULE_NUM_ONLY -1
+#endif
+
+/** Return true if the module type with the given number is compiled
+ * into this driver; for use with #if.
+ */
+#define U_CELL_PRIVATE_MODULE_IS_COMPILED_IN(moduleNum) \
+    ((U_CELL_PRIVATE_MODULE_NUM_ONLY < 0) || (U_CELL_PRIVATE_MODULE_NUM_ONLY == (moduleNum)))
+
+#ifdef U_CFG_CELL_MODULE_TYPE_ONLY
+
+/** Return true if the given module type is supported by this driver.
+ */
+# define U_CELL_PRIVATE_MODULE_IS_SUPPORTED(moduleType) \
+    ((moduleType) == U_CELL_PRIVATE_MODULE_TYPE_ONLY)
+
+/** The index of the given module type in gUCellPrivateModuleList.
+ */
+# define U_CELL_PRIVATE_MODULE_INDEX(moduleType) 0
+
+/** The module type of the given instance: a constant since
+ * there is only one.
+ */
+# define U_CELL_PRIVATE_MODULE_TYPE(pInstance) \
+    ((void) (pInstance), (uCellModuleType_t) U_CELL_PRIVATE_MODULE_TYPE_ONLY)
+
+/** Determine if the given feature is supported or not
+ * by the pointed-to module, a constant other than the NULL check.
+ */
+//lint --emacro((774), U_CELL_PRIVATE_HAS) Suppress left side always
+// evaluates to True
+# define U_CELL_PRIVATE_HAS(pModule, feature) \
+    ((pModule != NULL) && ((U_CELL_PRIVATE_FEATURES_ONLY) & (1ULL << (int32_t) (feature))))
+
+#else
+
+/** Return true if the given module type is supported by this driver.
+ */
+# define U_CELL_PRIVATE_MODULE_IS_SUPPORTED(moduleType) \
+    ((size_t) (moduleType) < gUCellPrivateModuleListSize)
+
+/** The index of the given module type in gUCellPrivateModuleList.
+ */
+# define U_CELL_PRIVATE_MODULE_INDEX(moduleType) (moduleType)
+
+/** The module type of the given instance.
+ */
+# define U_CELL_PRIVATE_MODULE_TYPE(pInstance) ((pInstance)->pModule->moduleType)
+
 /** Determine if the given feature is supported or not
  * by the pointed-to module.
  */
 //lint --emacro((774), U_CELL_PRIVATE_HAS) Suppress left side always
 // evaluates to True
-#define U_CELL_PRIVATE_HAS(pModule, feature) \
+# define U_CELL_PRIVATE_HAS(pModule, feature) \
     ((pModule != NULL) && ((pModule->featuresBitmap) & (1ULL << (int32_t) (feature))))
 
+#endif
+
 #ifndef U_CELL_PRIVATE_GREETING_STR
 /** A greeting string, a useful indication that the module
  * rebooted underneath us unexpectedly.
@@ -237,9 +492,24 @@ typedef enum {
     U_CELL_PRIVATE_FEATURE_FOTA,
     U_CELL_PRIVATE_FEATURE_UART_POWER_SAVING,
     U_CELL_PRIVATE_FEATURE_CMUX,
-    U_CELL_PRIVATE_FEATURE_SNR_REPORTED
+    U_CELL_PRIVATE_FEATURE_SNR_REPORTED,
+    U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CONNECT
 } uCellPrivateFeature_t;
 
+/** Capabilities of a cellular module that cannot be known from its
+ * type, e.g. because they depend on the firmware version, and so are
+ * found out by trying the AT command concerned: the outcome is
+ * remembered in the instance so that the AT command is only tried
+ * once.  The application may persist the outcomes through
+ * uCellInfoGetCapabilities(), hence only ever add to the end of
+ * this list.
+ */
+typedef enum {
+    U_CELL_PRIVATE_CAPABILITY_UPSMVER,    /**< AT+UPSMVER, not supported by SARA-R5xx-00B. */
+    U_CELL_PRIVATE_CAPABILITY_UFWINSTALL, /**< AT+UFWINSTALL, for FOTA progress reporting. */
+    U_CELL_PRIVATE_CAPABILITY_MAX_NUM
+} uCellPrivateCapability_t;
+
 /** The characteristics that may differ between cellular modules.
  * Note: order is important since this is statically initialised.
  */
@@ -329,6 +599,10 @@ typedef struct {
     uPortMutexHandle_t fixDataStorageMutex;  /**< protect manipulation of fix data storage. */
     void *pFixDataStorage;/**< pointer to data storage used when establishing a fix. */
     int32_t fixStatus;    /**< status of a location fix. */
+    int32_t fixCacheMaxAgeSeconds; /**< the maximum age of a cached fix, 0 for no caching. */
+    int32_t fixCacheCellIdLogical; /**< the serving cell when the cached fix was obtained. */
+    int32_t fixCacheTimeMs;        /**< the time at which the cached fix was obtained. */
+    void *pFixCache;               /**< the cached fix, NULL if there is none. */
 } uCellPrivateLocContext_t;
 
 /** Type to keep track of the deep sleep state.
@@ -394,6 +668,38 @@ typedef struct uCellPrivateFileListContainer_t {
     struct uCellPrivateFileListContainer_t *pNext;
 } uCellPrivateFileListContainer_t;
 
+/** An entry in the file system cache, see uCellFileSetCacheOn();
+ * as for #uCellPrivateFileListContainer_t the file name is
+ * stored in the space immediately following the structure.
+ */
+typedef struct uCellPrivateFileCacheEntry_t {
+    char *pFileName;  /**< A pointer to the file name, null terminated. */
+    int32_t size;     /**< The size of the file, negative if not known. */
+    struct uCellPrivateFileCacheEntry_t *pNext;
+} uCellPrivateFileCacheEntry_t;
+
+/** The file system cache, see uCellFileSetCacheOn().
+ */
+typedef struct {
+    bool listComplete; /**< True if pList contains every file in the
+                            default area of the file system. */
+    uCellPrivateFileCacheEntry_t *pList;
+} uCellPrivateFileCache_t;
+
+/** The RAM time service, see uCellInfoSetTimeCache().
+ */
+typedef struct {
+    int32_t resyncIntervalSeconds; /**< How often to re-read the module's clock. */
+    bool synced;             /**< True if the fields below are valid. */
+    int64_t timeLocal;       /**< The local time when last read from the module. */
+    int32_t timeZoneSeconds; /**< The time zone offset when last read from the module. */
+    int32_t syncTickMs;      /**< uPortGetTickTimeMs() when the module was last read. */
+    int64_t refTimeUtc;      /**< The UTC time at the start of drift measurement. */
+    int64_t refElapsedMs;    /**< Tick time elapsed since refTimeUtc. */
+    int32_t driftPpm;        /**< How fast the module clock runs compared with
+                                  uPortGetTickTimeMs(), in parts per million. */
+} uCellPrivateTimeCache_t;
+
 /** Definition of a cellular instance.
  */
 typedef struct uCellPrivateInstance_t {
@@ -417,6 +723,10 @@ typedef struct uCellPrivateInstance_t {
                                                        been requested (set
                                                        to zeroes for automatic
                                                        mode). */
+    char apnDbImsi[15]; /**< The IMSI that pApnDbLast applies to. */
+    const char *pApnDbLast; /**< The entry in the APN database that last
+                                 resulted in a successful connection for
+                                 apnDbImsi, NULL if there is none. */
     int64_t lastCfunFlipTimeMs; /**< The last time a flip of state from
                                      "off" (AT+CFUN=0/4) to "on" (AT+CFUN=1)
                                      or back was performed. */
@@ -434,6 +744,8 @@ typedef struct uCellPrivateInstance_t {
                                   change. */
     int32_t mnoProfile;     /**< The active MNO profile, populated at boot. */
     bool (*pKeepGoingCallback) (uDeviceHandle_t cellHandle);  /**< Used while connecting. */
+    uPortSemaphoreHandle_t registrationSemaphore; /**< Given by the +CxREG URCs,
+                                                       used while registering. */
     void (*pRegistrationStatusCallback) (uCellNetRegDomain_t, uCellNetStatus_t, void *);
     void *pRegistrationStatusCallbackParameter;
     void (*pConnectionStatusCallback) (bool, void *);
@@ -449,15 +761,32 @@ typedef struct uCellPrivateInstance_t {
     uCellPrivateLocContext_t *pLocContext; /**< Hook for a location context. **/
     bool socketsHexMode; /**< Set to true for sockets to use hex mode. */
     const char *pFileSystemTag; /**< The tagged area of the file system currently being addressed. */
+    uCellPrivateFileCache_t *pFileCache; /**< Cache of the default area of the file system, NULL if off. */
+    uCellPrivateTimeCache_t *pTimeCache; /**< The RAM time service, NULL if off. */
     uCellPrivateDeepSleepState_t deepSleepState; /**< The current deep sleep state. */
     int32_t deepSleepBlockedBy; /** Set to a positive integer if an app on the module is blocking deep sleep. */
     bool inWakeUpCallback; /**< So that we can avoid recursion. */
     uCellPrivateSleep_t *pSleepContext; /**< Context for sleep stuff. */
+    void *pDeferContext; /**< Queue for uCellPwrDefer(), lodged here as a void *
+                              to avoid spreading its types all over. */
     uCellPrivateUartSleepCache_t uartSleepCache; /**< Used only by uCellPwrEnable/DisableUartSleep(). */
     uCellPrivateProfileState_t profileState; /**< To track whether a profile is meant to be active. */
+    uint32_t secTlsProfileCacheBitmap; /**< A bit for each security profile ID
+                                            whose settings are known to be
+                                            those recorded by u_cell_sec_tls.c. */
+    uint32_t capabilityProbedBitmap; /**< A bit for each uCellPrivateCapability_t
+                                          whose support has been found out; not
+                                          cleared by a reboot since support can
+                                          only change with the firmware. */
+    uint32_t capabilitySupportedBitmap; /**< Of capabilityProbedBitmap, the bits
+                                             of the capabilities that are supported. */
     void *pFotaContext; /**< FOTA context, lodged here as a void * to
                              avoid spreading its types all over. */
     void *pHttpContext;  /**< Hook for a HTTP context. */
+    void *pRadioParametersContext; /**< Context for uCellInfoSetRadioParametersCallback(),
+                                        lodged here as a void * to avoid spreading its
+                                        types all over. */
+    void *pIdentity; /**< Identity snapshot, see uCellInfoSetIdentity(). */
     void *pMuxContext; /**< CMUX context, lodged here as a void * to
                             avoid spreading its types all over. */
     void *pCellTimeContext;  /**< Hook for CellTime context. */
@@ -562,7 +891,8 @@ void uCellPrivateClearRadioParameters(uCellPrivateRadioParameters_t *pParameters
                                       bool leaveCellIdLogicalAlone);
 
 /** Clear the dynamic parameters of an instance, so the network
- * status, the active RAT and the radio parameters.  This should
+ * status, the active RAT, the radio parameters and the record of
+ * which security profiles are known to be configured.  This should
  * be called when the module is being rebooted or powered off.
  *
  * @param pInstance a pointer to the instance.
@@ -874,6 +1204,14 @@ int32_t uCellPrivateFileListNext(uCellPrivateFileListContainer_t **ppFileListCon
  */
 void uCellPrivateFileListLast(uCellPrivateFileListContainer_t **ppFileListContainer);
 
+/** Remove the file system cache for the given instance.
+ *
+ * Note: gUCellPrivateMutex should be locked before this is called.
+ *
+ * @param pInstance   a pointer to the cellular instance.
+ */
+void uCellPrivateFileCacheRemove(uCellPrivateInstance_t *pInstance);
+
 /** Remove the HTTP context for the given instance.
  *
  * Note:  gUCellPrivateMutex and the linked list mutex of the HTTP
@@ -949,6 +1287,54 @@ bool uCellPrivateGnssInsideCell(const uCellPrivateInstance_t *pInstance);
  */
 void uCellPrivateCellTimeRemoveContext(uCellPrivateInstance_t *pInstance);
 
+/** Determine whether a capability of the module should be tried,
+ * i.e. it is not already known to be unsupported.
+ *
+ * Note:  gUCellPrivateMutex should be locked before this is called.
+ *
+ * @param pInstance   a pointer to the cellular instance.
+ * @param capability  the capability.
+ * @return            false if the capability has been found out to
+ *                    be not supported, else true.
+ */
+bool uCellPrivateCapabilityTry(const uCellPrivateInstance_t *pInstance,
+                               uCellPrivateCapability_t capability);
+
+/** Record the outcome of trying a capability of the module.  The
+ * capability is only recorded as unsupported if the module actually
+ * returned an error, not if the AT command failed for some other
+ * reason, e.g. a timeout.
+ *
+ * Note:  gUCellPrivateMutex should be locked before this is called.
+ *
+ * @param pInstance        a pointer to the cellular instance.
+ * @param capability       the capability.
+ * @param atError          the return value of uAtClientUnlock() for
+ *                         the AT command that tried the capability.
+ * @param[in] pDeviceError the device error for that AT command, as
+ *                         returned by uAtClientDeviceErrorGet() before
+ *                         the unlock.
+ */
+void uCellPrivateCapabilitySet(uCellPrivateInstance_t *pInstance,
+                               uCellPrivateCapability_t capability,
+                               int32_t atError,
+                               const uAtClientDeviceError_t *pDeviceError);
+
+/** Read binary data of known length from an AT response, copying it
+ * straight out of the receive buffer of the AT client with
+ * uAtClientReadBytesInPlace().  uAtClientIgnoreStopTag() must have
+ * been called beforehand.
+ *
+ * @param atHandle      the handle of the AT client.
+ * @param[out] pBuffer  a place to put the data; may be NULL, in
+ *                      which case the data is thrown away.
+ * @param lengthBytes   the number of bytes to read.
+ * @return              the number of bytes read or negative error
+ *                      code.
+ */
+int32_t uCellPrivateReadBytesInPlace(uAtClientHandle_t atHandle,
+                                     char *pBuffer, size_t lengthBytes);
+
 #ifdef __cplusplus
 }
 #endif
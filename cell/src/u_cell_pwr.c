@@ -33,7 +33,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // strlen()
+#include "string.h"    // strlen(), memcpy()
 
 #include "u_cfg_sw.h"
 
@@ -74,6 +74,27 @@
  */
 #define U_CELL_PWR_CONFIGURATION_COMMAND_TRIES 3
 
+#ifndef U_CELL_PWR_CONFIGURATION_BATCH
+/** Set this to 1 to send the configuration AT commands that every
+ * module type gets (see gpConfigCommand[]) concatenated on a single
+ * AT command line, rather than one at a time, reducing the number of
+ * command/response turn-arounds, and hence the time taken by
+ * uCellPwrOn() or a return from deep sleep; should the module
+ * reject the concatenated line the commands are sent individually
+ * as normal.
+ */
+# define U_CELL_PWR_CONFIGURATION_BATCH 0
+#endif
+
+#ifndef U_CELL_PWR_CONFIGURATION_BATCH_MAX_LENGTH_BYTES
+/** The maximum length of the concatenated configuration AT command
+ * line when #U_CELL_PWR_CONFIGURATION_BATCH is 1, including the
+ * null terminator; if the commands do not fit they are sent
+ * individually.
+ */
+# define U_CELL_PWR_CONFIGURATION_BATCH_MAX_LENGTH_BYTES 96
+#endif
+
 /** The UART power saving duration in GSM frames, needed for the
  * UART power saving AT command.
  */
@@ -110,6 +131,26 @@ typedef struct {
     void *pCallbackParam;
 } uCellPwrDeepSleepWakeUpCallback_t;
 
+/** An operation deferred with uCellPwrDefer().
+ */
+typedef struct uCellPwrDeferred_t {
+    uDeviceHandle_t cellHandle;
+    void (*pCallback) (uDeviceHandle_t, void *);
+    void *pCallbackParam;
+    int32_t deadlineMs;
+    struct uCellPwrDeferred_t *pNext;
+} uCellPwrDeferred_t;
+
+/** The queue of operations deferred with uCellPwrDefer(); this has
+ * its own mutex as it is flushed from a timer callback and from URCs,
+ * neither of which should wait on gUCellPrivateMutex.
+ */
+typedef struct {
+    uPortMutexHandle_t mutex;
+    uPortTimerHandle_t timer;
+    uCellPwrDeferred_t *pList;
+} uCellPwrDeferContext_t;
+
 /** All the parameters for an E-DRX URC callback.
  */
 typedef struct {
@@ -829,6 +870,81 @@ static void deepSleepWakeUpCallback(uAtClientHandle_t atHandle, void *pParameter
     }
 }
 
+// Run a list of deferred operations; this is called through the
+// uAtClientCallback() mechanism so that the operations are free to
+// call this API.
+static void deferRun(uAtClientHandle_t atHandle, void *pParameter)
+{
+    uCellPwrDeferred_t *pDeferred = (uCellPwrDeferred_t *) pParameter;
+    uCellPwrDeferred_t *pNext;
+
+    (void) atHandle;
+
+    while (pDeferred != NULL) {
+        pNext = pDeferred->pNext;
+        pDeferred->pCallback(pDeferred->cellHandle, pDeferred->pCallbackParam);
+        uPortFree(pDeferred);
+        pDeferred = pNext;
+    }
+}
+
+// Hand all deferred operations over to be run, e.g. because the
+// module is awake anyway or a latency budget has run out; that way
+// they all share the same wake-up.
+static void deferFlush(uCellPrivateInstance_t *pInstance)
+{
+    uCellPwrDeferContext_t *pContext = (uCellPwrDeferContext_t *) pInstance->pDeferContext;
+    uCellPwrDeferred_t *pList;
+
+    if (pContext != NULL) {
+        U_PORT_MUTEX_LOCK(pContext->mutex);
+        pList = pContext->pList;
+        if ((pList != NULL) &&
+            (uAtClientCallback(pInstance->atHandle, deferRun, pList) == 0)) {
+            pContext->pList = NULL;
+        }
+        uPortTimerStop(pContext->timer);
+        U_PORT_MUTEX_UNLOCK(pContext->mutex);
+    }
+}
+
+// Timer callback for when the latency budget of a deferred
+// operation has run out.
+static void deferTimerCallback(const uPortTimerHandle_t timerHandle,
+                               void *pParameter)
+{
+    (void) timerHandle;
+
+    deferFlush((uCellPrivateInstance_t *) pParameter);
+}
+
+// Get the deferred operation queue, creating it if necessary.
+static uCellPwrDeferContext_t *pDeferContextGet(uCellPrivateInstance_t *pInstance)
+{
+    uCellPwrDeferContext_t *pContext = (uCellPwrDeferContext_t *) pInstance->pDeferContext;
+
+    if (pContext == NULL) {
+        pContext = (uCellPwrDeferContext_t *) pUPortMalloc(sizeof(*pContext));
+        if (pContext != NULL) {
+            memset(pContext, 0, sizeof(*pContext));
+            if ((uPortMutexCreate(&(pContext->mutex)) == 0) &&
+                (uPortTimerCreate(&(pContext->timer), "cellDefer",
+                                  deferTimerCallback, pInstance,
+                                  1000, false) == 0)) {
+                pInstance->pDeferContext = pContext;
+            } else {
+                if (pContext->mutex != NULL) {
+                    uPortMutexDelete(pContext->mutex);
+                }
+                uPortFree(pContext);
+                pContext = NULL;
+            }
+        }
+    }
+
+    return pContext;
+}
+
 // URC for the module's protocol stack entering/leaving deactivated
 // mode; not that this doesn't _necessarily_ mean that the module is about
 // to enter deep sleep, or woken up from deep sleep in fact.
@@ -846,6 +962,10 @@ static void UUPSMR_urc(uAtClientHandle_t atHandle, void *pParameter)
     // 2 means sleep is blocked.
     if (x == 1) {
         pInstance->deepSleepState = U_CELL_PRIVATE_DEEP_SLEEP_STATE_PROTOCOL_STACK_ASLEEP;
+    } else if (x == 0) {
+        // Whatever the module is waking up for, it is a good
+        // time for any deferred operations
+        deferFlush(pInstance);
     }
     pInstance->deepSleepBlockedBy = -1;
     if (x == 2) {
@@ -918,6 +1038,52 @@ static bool moduleConfigureOne(uAtClientHandle_t atHandle,
     return success;
 }
 
+#if U_CELL_PWR_CONFIGURATION_BATCH
+// Send all of the configuration commands in gpConfigCommand[]
+// concatenated on a single AT command line.
+static bool moduleConfigureBatch(uAtClientHandle_t atHandle)
+{
+    bool success = false;
+    char buffer[U_CELL_PWR_CONFIGURATION_BATCH_MAX_LENGTH_BYTES];
+    size_t length = 2;
+    size_t commandLength;
+    const char *pCommand;
+    bool previousIsExtended = false;
+    bool fits = true;
+
+    // All of the commands start with "AT", which is only
+    // needed once; basic commands (e.g. E0, &C1) can follow
+    // each other directly while an extended command (+...)
+    // must be terminated with a semicolon if another command
+    // follows it
+    memcpy(buffer, "AT", 3);
+    for (size_t x = 0;
+         (x < sizeof(gpConfigCommand) / sizeof(gpConfigCommand[0])) && fits;
+         x++) {
+        pCommand = gpConfigCommand[x] + 2;
+        commandLength = strlen(pCommand);
+        if (length + commandLength + (previousIsExtended ? 1 : 0) < sizeof(buffer)) {
+            if (previousIsExtended) {
+                *(buffer + length) = ';';
+                length++;
+            }
+            memcpy(buffer + length, pCommand, commandLength + 1);
+            length += commandLength;
+            previousIsExtended = (*pCommand == '+');
+        } else {
+            fits = false;
+        }
+    }
+
+    if (fits) {
+        success = moduleConfigureOne(atHandle, buffer,
+                                     U_CELL_PWR_CONFIGURATION_COMMAND_TRIES);
+    }
+
+    return success;
+}
+#endif
+
 // Configure the cellular module.
 static int32_t moduleConfigure(uCellPrivateInstance_t *pInstance,
                                bool andRadioOff, bool returningFromSleep)
@@ -932,16 +1098,21 @@ static int32_t moduleConfigure(uCellPrivateInstance_t *pInstance,
     int32_t y;
 
     // First send all the commands that everyone gets
-    for (size_t x = 0;
-         (x < sizeof(gpConfigCommand) / sizeof(gpConfigCommand[0])) &&
-         success; x++) {
-        success = moduleConfigureOne(atHandle, gpConfigCommand[x],
-                                     U_CELL_PWR_CONFIGURATION_COMMAND_TRIES);
+#if U_CELL_PWR_CONFIGURATION_BATCH
+    if (!moduleConfigureBatch(atHandle))
+#endif
+    {
+        for (size_t x = 0;
+             (x < sizeof(gpConfigCommand) / sizeof(gpConfigCommand[0])) &&
+             success; x++) {
+            success = moduleConfigureOne(atHandle, gpConfigCommand[x],
+                                         U_CELL_PWR_CONFIGURATION_COMMAND_TRIES);
+        }
     }
 
     if (success &&
-        (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType) ||
-         (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_LARA_R6))) {
+        (U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance)) ||
+         (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_LARA_R6))) {
         // SARA-R4 and LARA-R6 only: switch on the right UCGED mode
         // (SARA-R5 and SARA-U201 have a single mode and require no setting)
         if (U_CELL_PRIVATE_HAS(pInstance->pModule, U_CELL_PRIVATE_FEATURE_UCGED5)) {
@@ -1011,7 +1182,7 @@ static int32_t moduleConfigure(uCellPrivateInstance_t *pInstance,
     }
 
     if (uAtClientWakeUpHandlerIsSet(atHandle) &&
-        U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+        U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
         // SARA-R4 doesn't support modes 1, 2 or 3 but
         // does support the functionality of mode 1
         // though numbered as mode 4 and without the
@@ -1084,7 +1255,7 @@ static int32_t moduleConfigure(uCellPrivateInstance_t *pInstance,
         uCellPwrPrivateGet3gppPowerSaving(pInstance, false, NULL, NULL, NULL);
         uCellPrivateSetDeepSleepState(pInstance);
         if (success &&
-            U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+            U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
             // For SARA-R4, whether the E-DRX URC is on or not does not
             // survive a restart, so need to set it up again here
             success = (setEDrxUrc(pInstance) == 0);
@@ -1408,9 +1579,33 @@ int32_t uCellPwrPrivateOn(uCellPrivateInstance_t *pInstance,
         }
     }
 
+    if (asleepAtStart && (errorCode == 0)) {
+        // Having paid for the wake-up, do any deferred operations now
+        deferFlush(pInstance);
+    }
+
     return errorCode;
 }
 
+// Free the queue of deferred operations.
+void uCellPwrPrivateDeferRemoveContext(uCellPrivateInstance_t *pInstance)
+{
+    uCellPwrDeferContext_t *pContext = (uCellPwrDeferContext_t *) pInstance->pDeferContext;
+    uCellPwrDeferred_t *pNext;
+
+    if (pContext != NULL) {
+        uPortTimerDelete(pContext->timer);
+        while (pContext->pList != NULL) {
+            pNext = pContext->pList->pNext;
+            uPortFree(pContext->pList);
+            pContext->pList = pNext;
+        }
+        uPortMutexDelete(pContext->mutex);
+        uPortFree(pContext);
+        pInstance->pDeferContext = NULL;
+    }
+}
+
 // Decode an active time (T3324) string representing the binary value
 // of a GPRS Timer 2 IE into seconds.
 int32_t uCellPwrPrivateActiveTimeStrToSeconds(const char *pStr, int32_t *pSeconds)
@@ -1926,7 +2121,7 @@ int32_t uCellPwrReboot(uDeviceHandle_t cellHandle,
             // Clear the dynamic parameters
             uCellPrivateClearDynamicParameters(pInstance);
             uAtClientCommandStart(atHandle, "AT+CFUN=");
-            if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+            if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
                 // SARA-R5 doesn't support 15 (which doesn't reset the SIM)
                 uAtClientWriteInt(atHandle, 16);
             } else {
@@ -1946,7 +2141,7 @@ int32_t uCellPwrReboot(uDeviceHandle_t cellHandle,
                 // to be entered at a power cycle
                 for (size_t x = 2; (x > 0) && (!success) &&
                      ((pKeepGoingCallback == NULL) || pKeepGoingCallback(cellHandle)); x--) {
-                    if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+                    if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
                         // SARA-R5 chucks out a load of stuff after
                         // boot in its development version: flush it away
                         uAtClientFlush(atHandle);
@@ -2086,7 +2281,7 @@ int32_t uCellPwrResetHard(uDeviceHandle_t cellHandle, int32_t pinReset)
                     uPortGpioSet(pinReset, (int32_t) !U_CELL_RESET_PIN_TOGGLE_TO_STATE);
                     // Wait for the module to boot
                     uPortTaskBlock(pInstance->pModule->rebootCommandWaitSeconds * 1000);
-                    if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R5) {
+                    if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R5) {
                         // SARA-R5 chucks out a load of stuff after
                         // boot in its development version: flush it away
                         uAtClientFlush(pInstance->atHandle);
@@ -2238,7 +2433,7 @@ int32_t  uCellPwrSetRequested3gppPowerSaving(uDeviceHandle_t cellHandle,
                 errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                 // Before we start...
                 if (onNotOff &&
-                    U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                    U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                     // For SARA-R4, the default value of psm_ver will
                     // cause the module to enter 3GPP sleep even
                     // without the network's agreement.  This is not
@@ -2276,7 +2471,8 @@ int32_t  uCellPwrSetRequested3gppPowerSaving(uDeviceHandle_t cellHandle,
                                                    activeTimeSeconds,
                                                    periodicWakeupSeconds);
                     if (errorCode == 0) {
-                        if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType) &&
+                        if (U_CELL_PRIVATE_MODULE_IS_SARA_R4(
+                                U_CELL_PRIVATE_MODULE_TYPE(pInstance)) &&
                             ((onNotOff != onNotOffPrevious) ||
                              (activeTimeSeconds != activeTimeSecondsPrevious) ||
                              (periodicWakeupSeconds != periodicWakeupSecondsPrevious))) {
@@ -2498,6 +2694,8 @@ int32_t uCellPwrSetRequestedEDrx(uDeviceHandle_t cellHandle,
     uAtClientHandle_t atHandle;
     char encoded[4 + 1]; // String representing four binary digits
     int32_t value;
+    uAtClientDeviceError_t deviceError;
+    int32_t atError;
 
     if (gUCellPrivateMutex != NULL) {
 
@@ -2519,11 +2717,12 @@ int32_t uCellPwrSetRequestedEDrx(uDeviceHandle_t cellHandle,
                 (!onNotOff || uAtClientWakeUpHandlerIsSet(atHandle))) {
                 // SARA-R4 won't let E-DRX be configured when it is connected
                 errorCode = (int32_t) U_CELL_ERROR_CONNECTED;
-                if (!U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType) ||
+                if (!U_CELL_PRIVATE_MODULE_IS_SARA_R4(U_CELL_PRIVATE_MODULE_TYPE(pInstance)) ||
                     !uCellPrivateIsRegistered(pInstance)) {
                     errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                     // Before we start...
-                    if (onNotOff) {
+                    if (onNotOff &&
+                        uCellPrivateCapabilityTry(pInstance, U_CELL_PRIVATE_CAPABILITY_UPSMVER)) {
                         // If bit 3 of the UPSMVER command is set then full
                         // 3GPP sleep may be entered in some E-DRX circumstances,
                         // thus losing all of the module-based IP/MQTT
@@ -2537,8 +2736,13 @@ int32_t uCellPwrSetRequestedEDrx(uDeviceHandle_t cellHandle,
                         value = uAtClientReadInt(atHandle);
                         uAtClientResponseStop(atHandle);
                         // Note: don't set errorCode here as SARA-R5xx-00B
-                        // doesn't support AT+UPSMVER
-                        if ((uAtClientUnlock(atHandle) == 0) && (value >= 0) && ((value & 0x08) != 0)) {
+                        // doesn't support AT+UPSMVER; remember whether it
+                        // does so that we don't have to ask again
+                        uAtClientDeviceErrorGet(atHandle, &deviceError);
+                        atError = uAtClientUnlock(atHandle);
+                        uCellPrivateCapabilitySet(pInstance, U_CELL_PRIVATE_CAPABILITY_UPSMVER,
+                                                  atError, &deviceError);
+                        if ((atError == 0) && (value >= 0) && ((value & 0x08) != 0)) {
                             // If bit 3 is 1, set it to 0
                             value &= ~0x08;
                             uAtClientLock(atHandle);
@@ -2588,7 +2792,8 @@ int32_t uCellPwrSetRequestedEDrx(uDeviceHandle_t cellHandle,
                         uAtClientCommandStopReadResponse(atHandle);
                         errorCode = uAtClientUnlock(atHandle);
                         if ((errorCode == 0) &&
-                            U_CELL_PRIVATE_MODULE_IS_SARA_R4(pInstance->pModule->moduleType)) {
+                            U_CELL_PRIVATE_MODULE_IS_SARA_R4(
+                                U_CELL_PRIVATE_MODULE_TYPE(pInstance))) {
                             pInstance->rebootIsRequired = true;
                         }
                     }
@@ -2784,6 +2989,101 @@ int32_t uCellPwrWakeUpFromDeepSleep(uDeviceHandle_t cellHandle,
     return uCellPwrOn(cellHandle, NULL, pKeepGoingCallback);
 }
 
+// Defer an operation until the module is next awake.
+int32_t uCellPwrDefer(uDeviceHandle_t cellHandle, int32_t latencyBudgetMs,
+                      void (*pCallback) (uDeviceHandle_t cellHandle,
+                                         void *pCallbackParam),
+                      void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uCellPwrDeferContext_t *pContext;
+    uCellPwrDeferred_t *pDeferred;
+    uCellPwrDeferred_t **ppEnd;
+    int32_t nowMs;
+    int32_t waitMs;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (pCallback != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pContext = pDeferContextGet(pInstance);
+            pDeferred = (uCellPwrDeferred_t *) pUPortMalloc(sizeof(*pDeferred));
+            if ((pContext != NULL) && (pDeferred != NULL)) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if (latencyBudgetMs < 0) {
+                    latencyBudgetMs = 0;
+                }
+                nowMs = uPortGetTickTimeMs();
+                pDeferred->cellHandle = cellHandle;
+                pDeferred->pCallback = pCallback;
+                pDeferred->pCallbackParam = pCallbackParam;
+                pDeferred->deadlineMs = nowMs + latencyBudgetMs;
+                pDeferred->pNext = NULL;
+                waitMs = latencyBudgetMs;
+                U_PORT_MUTEX_LOCK(pContext->mutex);
+                // Add to the end so that operations are run in the order
+                // they were deferred, working out the shortest wait as we go
+                ppEnd = &(pContext->pList);
+                while (*ppEnd != NULL) {
+                    if ((*ppEnd)->deadlineMs - nowMs < waitMs) {
+                        waitMs = (*ppEnd)->deadlineMs - nowMs;
+                    }
+                    ppEnd = &((*ppEnd)->pNext);
+                }
+                *ppEnd = pDeferred;
+                U_PORT_MUTEX_UNLOCK(pContext->mutex);
+                if ((pInstance->deepSleepState != U_CELL_PRIVATE_DEEP_SLEEP_STATE_ASLEEP) ||
+                    (waitMs <= 0)) {
+                    // There is no wake-up to be saved, or no time
+                    // left to wait for one, so go now
+                    deferFlush(pInstance);
+                } else {
+                    uPortTimerStop(pContext->timer);
+                    if ((uPortTimerChange(pContext->timer, (uint32_t) waitMs) != 0) ||
+                        (uPortTimerStart(pContext->timer) != 0)) {
+                        // Can't keep to the latency budget without the timer
+                        deferFlush(pInstance);
+                    }
+                }
+            } else {
+                uPortFree(pDeferred);
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Run any deferred operations now.
+int32_t uCellPwrDeferFlush(uDeviceHandle_t cellHandle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (pInstance != NULL) {
+            deferFlush(pInstance);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // Disable 32 kHz sleep.
 int32_t uCellPwrDisableUartSleep(uDeviceHandle_t cellHandle)
 {
@@ -77,6 +77,13 @@ int32_t uCellPwrPrivateOn(uCellPrivateInstance_t *pInstance,
                           bool (*pKeepGoingCallback) (uDeviceHandle_t),
                           bool allowPrinting);
 
+/** Free the queue of operations deferred with uCellPwrDefer(),
+ * without running them.
+ *
+ * @param[in] pInstance  a pointer to the cellular instance.
+ */
+void uCellPwrPrivateDeferRemoveContext(uCellPrivateInstance_t *pInstance);
+
 /** Decode a string representing the binary value of a 3GPP power
  * saving active time (T3324) as a GPRS Timer 2 IE into seconds.
  *
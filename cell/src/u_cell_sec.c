@@ -32,7 +32,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // memset()
+#include "string.h"    // memset(), memchr()
 
 #include "u_error_common.h"
 
@@ -94,6 +94,14 @@
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/** The AT+USECDEVCERT type for each of the items read by
+ * uCellSecZtpRead(), in the order they are read.
+ */
+static const int32_t gZtpType[] = {1, // Device public certificate
+                                   0, // Device private key
+                                   2  // Certificate authorities
+                                  };
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -186,6 +194,69 @@ static int32_t ztpGet(uDeviceHandle_t cellHandle, int32_t type,
     return errorCodeOrSize;
 }
 
+// Read one ZTP item, passing it to pCallback in chunks borrowed from
+// the receive buffer of the AT client; the AT client must be locked.
+static int32_t ztpReadItem(uDeviceHandle_t cellHandle,
+                           uAtClientHandle_t atHandle, int32_t item,
+                           uCellSecZtpCallback_t pCallback,
+                           void *pCallbackParam)
+{
+    int32_t errorCodeOrSize = 0;
+    int32_t x = 0;
+    const char *pData;
+    const char *pQuote = NULL;
+    bool inQuotes = false;
+    bool done = false;
+
+    uAtClientCommandStart(atHandle, "AT+USECDEVCERT=");
+    uAtClientWriteInt(atHandle, gZtpType[item]);
+    uAtClientCommandStop(atHandle);
+    uAtClientResponseStart(atHandle, "+USECDEVCERT:");
+    // Skip the type that is sent back to us
+    uAtClientSkipParameters(atHandle, 1);
+    // The item is a quoted string which may contain
+    // line-endings, so switch off stop tag detection and
+    // look for the quotes ourselves
+    uAtClientIgnoreStopTag(atHandle);
+    while (!done && (x >= 0)) {
+        x = uAtClientReadBytesInPlace(atHandle, &pData, INT_MAX);
+        if (x > 0) {
+            pQuote = (const char *) memchr(pData, '"', x);
+            if (!inQuotes) {
+                // Skip up to and including the opening quote
+                if (pQuote != NULL) {
+                    x = (int32_t) (pQuote - pData) + 1;
+                    inQuotes = true;
+                }
+            } else {
+                if (pQuote != NULL) {
+                    x = (int32_t) (pQuote - pData);
+                    done = true;
+                }
+                pCallback(cellHandle, item, pData, x, done, pCallbackParam);
+                errorCodeOrSize += x;
+                if (done) {
+                    // Consume the closing quote as well
+                    x++;
+                }
+            }
+            uAtClientReadBytesInPlaceRelease(atHandle, x);
+        } else if (x == 0) {
+            x = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+        }
+    }
+    uAtClientRestoreStopTag(atHandle);
+    uAtClientResponseStop(atHandle);
+    if (x < 0) {
+        errorCodeOrSize = x;
+    }
+    if (uAtClientErrorGet(atHandle) < 0) {
+        errorCodeOrSize = uAtClientErrorGet(atHandle);
+    }
+
+    return errorCodeOrSize;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -457,6 +528,56 @@ int32_t uCellSecZtpGetCertificateAuthorities(uDeviceHandle_t cellHandle,
     return ztpGet(cellHandle, 2, pData, dataSizeBytes);
 }
 
+// Read all of the ZTP items in one go.
+int32_t uCellSecZtpRead(uDeviceHandle_t cellHandle,
+                        uCellSecZtpCallback_t pCallback,
+                        void *pCallbackParam)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+    int32_t x = 0;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (pCallback != NULL)) {
+            errorCodeOrSize = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if (U_CELL_PRIVATE_HAS(pInstance->pModule,
+                                   U_CELL_PRIVATE_FEATURE_SECURITY_ZTP)) {
+                atHandle = pInstance->atHandle;
+                errorCodeOrSize = 0;
+                uAtClientLock(atHandle);
+                // Keep the lock for all of the items so that the
+                // commands follow one another with nothing else
+                // getting in between
+                for (size_t y = 0; (y < sizeof(gZtpType) / sizeof(gZtpType[0])) &&
+                     (x >= 0); y++) {
+                    x = ztpReadItem(cellHandle, atHandle, (int32_t) y,
+                                    pCallback, pCallbackParam);
+                    if (x >= 0) {
+                        errorCodeOrSize += x;
+                    }
+                }
+                if (x < 0) {
+                    errorCodeOrSize = x;
+                }
+                x = uAtClientUnlock(atHandle);
+                if (x < 0) {
+                    errorCodeOrSize = x;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return errorCodeOrSize;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: PRE-SHARED KEY GENERATION
  * -------------------------------------------------------------- */
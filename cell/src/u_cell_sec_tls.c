@@ -79,6 +79,10 @@
 #define U_CELL_SEC_IANA_STRING_NUM_CHARS 4
 
 // Do some cross checking
+#if U_CELL_SEC_PROFILES_MAX_NUM > 32
+# error U_CELL_SEC_PROFILES_MAX_NUM must fit into secTlsProfileCacheBitmap
+#endif
+
 #if U_CELL_SEC_TLS_PSK_ID_MAX_LENGTH_BYTES < U_CELL_SEC_TLS_PSK_MAX_LENGTH_BYTES
 # error U_CELL_SEC_TLS_PSK_ID_MAX_LENGTH_BYTES is less than U_CELL_SEC_TLS_PSK_MAX_LENGTH_BYTES
 #endif
@@ -95,6 +99,15 @@ typedef struct {
     uint8_t legacy;
 } uCellSecTlsIanaToLegacy_t;
 
+/** Record of the settings a security profile in the module was
+ * left with, valid only while the profile's bit is set in
+ * secTlsProfileCacheBitmap of the instance.
+ */
+typedef struct {
+    uDeviceHandle_t cellHandle;
+    uint32_t settingsKey;
+} uCellSecTlsProfileCache_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -107,6 +120,10 @@ static int32_t gLastErrorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
  */
 static uCellSecTlsContext_t *gpContextList[U_CELL_SEC_PROFILES_MAX_NUM] = {0};
 
+/** The settings each security profile was last left with.
+ */
+static uCellSecTlsProfileCache_t gProfileCache[U_CELL_SEC_PROFILES_MAX_NUM] = {0};
+
 /** Array of IANA to u-blox legacy cipher suite numbers.
  */
 static const uCellSecTlsIanaToLegacy_t gIanaToLegacyCipher[] = {
@@ -149,27 +166,76 @@ static const uCellSecTlsIanaToLegacy_t gIanaToLegacyCipher[] = {
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
-// Get a new context.
-static uCellSecTlsContext_t *pNewContext()
+// Return true if the settings of the given profile ID are
+// known to be those recorded in gProfileCache[].
+static bool profileIsCached(const uCellPrivateInstance_t *pInstance,
+                            size_t profileId)
 {
-    uCellSecTlsContext_t *pContext = NULL;
+    return (gProfileCache[profileId].cellHandle == pInstance->cellHandle) &&
+           ((pInstance->secTlsProfileCacheBitmap & (((uint32_t) 1) << profileId)) != 0);
+}
 
-    // Find an unused entry in the list
+// Forget any settings recorded for the given profile ID, called
+// before anything is written to the profile.
+static void profileCacheInvalidate(uCellPrivateInstance_t *pInstance,
+                                   size_t profileId)
+{
+    pInstance->secTlsProfileCacheBitmap &= ~(((uint32_t) 1) << profileId);
+}
+
+// Choose a free profile ID: one that already holds the settings
+// at pSettingsKey if there is one, else preferably one that holds
+// no recorded settings, so that those remain available for re-use;
+// returns -1 if there is no free profile ID.
+static int32_t profileIdSelect(const uCellPrivateInstance_t *pInstance,
+                               const uint32_t *pSettingsKey,
+                               bool *pIsCached)
+{
+    int32_t profileId = -1;
+    int32_t uncachedProfileId = -1;
+
+    *pIsCached = false;
     for (size_t x = 0; (x < sizeof(gpContextList) / sizeof(gpContextList[0])) &&
-         (pContext == NULL); x++) {
+         !*pIsCached; x++) {
         if (gpContextList[x] == NULL) {
-            // Allocate memory for the entry
-            gpContextList[x] = (uCellSecTlsContext_t *) pUPortMalloc(sizeof(uCellSecTlsContext_t));
-            if (gpContextList[x] != NULL) {
-                // Initialise the entry
-                pContext = gpContextList[x];
-                pContext->cellHandle = NULL;
-                pContext->cipherList.pString = NULL;
-                pContext->cipherList.index = 0;
-                pContext->profileId = (uint8_t) x;
+            if (profileIsCached(pInstance, x)) {
+                if ((pSettingsKey != NULL) &&
+                    (gProfileCache[x].settingsKey == *pSettingsKey)) {
+                    profileId = (int32_t) x;
+                    *pIsCached = true;
+                } else if (profileId < 0) {
+                    profileId = (int32_t) x;
+                }
+            } else if (uncachedProfileId < 0) {
+                uncachedProfileId = (int32_t) x;
             }
         }
     }
+    if (!*pIsCached && (uncachedProfileId >= 0)) {
+        profileId = uncachedProfileId;
+    }
+
+    return profileId;
+}
+
+// Get a new context for the given, unused, profile ID.
+static uCellSecTlsContext_t *pNewContext(int32_t profileId)
+{
+    uCellSecTlsContext_t *pContext = NULL;
+
+    if ((profileId >= 0) &&
+        (profileId < (int32_t) (sizeof(gpContextList) / sizeof(gpContextList[0])))) {
+        // Allocate memory for the entry
+        gpContextList[profileId] = (uCellSecTlsContext_t *) pUPortMalloc(sizeof(uCellSecTlsContext_t));
+        if (gpContextList[profileId] != NULL) {
+            // Initialise the entry
+            pContext = gpContextList[profileId];
+            pContext->cellHandle = NULL;
+            pContext->cipherList.pString = NULL;
+            pContext->cipherList.index = 0;
+            pContext->profileId = (uint8_t) profileId;
+        }
+    }
 
     return pContext;
 }
@@ -205,6 +271,7 @@ static int32_t setString(const uCellSecTlsContext_t *pContext,
             pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
             if (pInstance != NULL) {
                 atHandle = pInstance->atHandle;
+                profileCacheInvalidate(pInstance, pContext->profileId);
                 // Talk to the cellular module to set the string thing
                 uAtClientLock(atHandle);
                 uAtClientCommandStart(atHandle, "AT+USECPRF=");
@@ -330,6 +397,7 @@ static int32_t setSequence(const uCellSecTlsContext_t *pContext,
                 }
                 if (pString != NULL) {
                     atHandle = pInstance->atHandle;
+                    profileCacheInvalidate(pInstance, pContext->profileId);
                     // Talk to the cellular module to set the thing
                     uAtClientLock(atHandle);
                     uAtClientCommandStart(atHandle, "AT+USECPRF=");
@@ -420,6 +488,7 @@ static int32_t cipherSuiteSet(const uCellSecTlsContext_t *pContext,
                 }
                 if (y >= 0) {
                     atHandle = pInstance->atHandle;
+                    profileCacheInvalidate(pInstance, pContext->profileId);
                     // Talk to the cellular module to add the
                     // cipher suite
                     uAtClientLock(atHandle);
@@ -543,6 +612,7 @@ static int32_t setGeneratePsk(const uCellSecTlsContext_t *pContext,
                 pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
                 if (pInstance != NULL) {
                     atHandle = pInstance->atHandle;
+                    profileCacheInvalidate(pInstance, pContext->profileId);
                     // Talk to the cellular module to set the PSK
                     // generation mode
                     uAtClientLock(atHandle);
@@ -571,6 +641,64 @@ static int32_t setGeneratePsk(const uCellSecTlsContext_t *pContext,
     return errorCode;
 }
 
+// Add a cellular TLS security context, re-using a profile that
+// already holds the settings at pSettingsKey if possible.
+static uCellSecTlsContext_t *pAddContext(uDeviceHandle_t cellHandle,
+                                         const uint32_t *pSettingsKey,
+                                         bool *pIsConfigured)
+{
+    uCellSecTlsContext_t *pContext = NULL;
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+    int32_t profileId;
+    bool isCached = false;
+
+    gLastErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        gLastErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUCellPrivateGetInstance(cellHandle);
+        if (pInstance != NULL) {
+            gLastErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            profileId = profileIdSelect(pInstance, pSettingsKey, &isCached);
+            pContext = pNewContext(profileId);
+            if (pContext != NULL) {
+                pContext->cellHandle = cellHandle;
+                gLastErrorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if (!isCached) {
+                    // The profile is going to be reset to defaults,
+                    // so any recorded settings no longer apply
+                    profileCacheInvalidate(pInstance, pContext->profileId);
+                    gProfileCache[pContext->profileId].cellHandle = cellHandle;
+                    atHandle = pInstance->atHandle;
+                    // Talk to the cellular module to initialise the context
+                    // to defaults
+                    uAtClientLock(atHandle);
+                    uAtClientCommandStart(atHandle, "AT+USECPRF=");
+                    uAtClientWriteInt(atHandle, pContext->profileId);
+                    uAtClientCommandStopReadResponse(atHandle);
+                    gLastErrorCode = uAtClientUnlock(atHandle);
+                    if (gLastErrorCode != 0) {
+                        // If initialisation failed, free the
+                        // context again
+                        freeContext(pContext);
+                        pContext = NULL;
+                    }
+                }
+                if (pIsConfigured != NULL) {
+                    *pIsConfigured = isCached;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return pContext;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -587,43 +715,49 @@ void uCellSecTlsPrivateLink()
 // Add a cellular TLS security context with default settings.
 uCellSecTlsContext_t *pUCellSecSecTlsAdd(uDeviceHandle_t cellHandle)
 {
-    uCellSecTlsContext_t *pContext = NULL;
+    return pAddContext(cellHandle, NULL, NULL);
+}
+
+// Add a cellular TLS security context, re-using a profile that
+// was previously configured with the same settings if possible.
+uCellSecTlsContext_t *pUCellSecSecTlsAddCached(uDeviceHandle_t cellHandle,
+                                               uint32_t settingsKey,
+                                               bool *pIsConfigured)
+{
+    if (pIsConfigured != NULL) {
+        *pIsConfigured = false;
+    }
+
+    return pAddContext(cellHandle, &settingsKey, pIsConfigured);
+}
+
+// Record that the profile of a context now holds the given settings.
+int32_t uCellSecTlsSettingsKeySet(const uCellSecTlsContext_t *pContext,
+                                  uint32_t settingsKey)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     uCellPrivateInstance_t *pInstance;
-    uAtClientHandle_t atHandle;
 
-    gLastErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     if (gUCellPrivateMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
 
-        gLastErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-        pInstance = pUCellPrivateGetInstance(cellHandle);
-        if (pInstance != NULL) {
-            gLastErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-            pContext = pNewContext();
-            if (pContext != NULL) {
-                pContext->cellHandle = cellHandle;
-                atHandle = pInstance->atHandle;
-                // Talk to the cellular module to initialise the context
-                // to defaults
-                uAtClientLock(atHandle);
-                uAtClientCommandStart(atHandle, "AT+USECPRF=");
-                uAtClientWriteInt(atHandle, pContext->profileId);
-                uAtClientCommandStopReadResponse(atHandle);
-                gLastErrorCode = uAtClientUnlock(atHandle);
-                if (gLastErrorCode != 0) {
-                    // If initialisation failed, free the
-                    // context again
-                    freeContext(pContext);
-                    pContext = NULL;
-                }
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pContext != NULL) &&
+            (pContext->profileId < sizeof(gProfileCache) / sizeof(gProfileCache[0]))) {
+            pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
+            if (pInstance != NULL) {
+                gProfileCache[pContext->profileId].cellHandle = pContext->cellHandle;
+                gProfileCache[pContext->profileId].settingsKey = settingsKey;
+                pInstance->secTlsProfileCacheBitmap |= ((uint32_t) 1) << pContext->profileId;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
             }
         }
 
         U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
     }
 
-    return pContext;
+    return errorCode;
 }
 
 // Remove a cellular TLS security context.
@@ -775,6 +909,7 @@ int32_t uCellSecTlsUseDeviceCertificateSet(const uCellSecTlsContext_t *pContext,
             pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
             if (pInstance != NULL) {
                 atHandle = pInstance->atHandle;
+                profileCacheInvalidate(pInstance, pContext->profileId);
                 uAtClientLock(atHandle);
                 uAtClientCommandStart(atHandle, "AT+USECPRF=");
                 uAtClientWriteInt(atHandle, pContext->profileId);
@@ -1013,6 +1148,7 @@ int32_t uCellSecTlsVersionSet(const uCellSecTlsContext_t *pContext,
                         break;
                 }
                 atHandle = pInstance->atHandle;
+                profileCacheInvalidate(pInstance, pContext->profileId);
                 // Talk to the cellular module to set the minimum
                 // TLS version
                 uAtClientLock(atHandle);
@@ -1116,6 +1252,7 @@ int32_t uCellSecTlsCertificateCheckSet(const uCellSecTlsContext_t *pContext,
             pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
             if (pInstance != NULL) {
                 atHandle = pInstance->atHandle;
+                profileCacheInvalidate(pInstance, pContext->profileId);
                 gLastErrorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                 if (check >= U_CELL_SEC_TLS_CERTIFICATE_CHECK_ROOT_CA_URL) {
                     // Write the URL first
@@ -1273,4 +1410,83 @@ int32_t uCellSecTlsSniGet(const uCellSecTlsContext_t *pContext,
     return gLastErrorCode;
 }
 
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: SESSION RESUMPTION
+ * -------------------------------------------------------------- */
+
+// Switch TLS session resumption on or off.
+int32_t uCellSecTlsSessionResumptionSet(const uCellSecTlsContext_t *pContext,
+                                        bool onNotOff)
+{
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+
+    gLastErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        gLastErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (pContext != NULL) {
+            pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
+            if (pInstance != NULL) {
+                atHandle = pInstance->atHandle;
+                profileCacheInvalidate(pInstance, pContext->profileId);
+                uAtClientLock(atHandle);
+                uAtClientCommandStart(atHandle, "AT+USECPRF=");
+                // Profile ID
+                uAtClientWriteInt(atHandle, pContext->profileId);
+                // Operation 13 is the session resumption operation
+                uAtClientWriteInt(atHandle, 13);
+                uAtClientWriteInt(atHandle, onNotOff ? 1 : 0);
+                uAtClientCommandStopReadResponse(atHandle);
+                gLastErrorCode = uAtClientUnlock(atHandle);
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return gLastErrorCode;
+}
+
+// Get whether TLS session resumption is on or off.
+bool uCellSecTlsSessionResumptionGet(const uCellSecTlsContext_t *pContext)
+{
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+    int32_t x;
+    bool isOn = false;
+
+    if (gUCellPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUCellPrivateMutex);
+
+        if (pContext != NULL) {
+            pInstance = pUCellPrivateGetInstance(pContext->cellHandle);
+            if (pInstance != NULL) {
+                atHandle = pInstance->atHandle;
+                uAtClientLock(atHandle);
+                uAtClientCommandStart(atHandle, "AT+USECPRF=");
+                uAtClientWriteInt(atHandle, pContext->profileId);
+                uAtClientWriteInt(atHandle, 13);
+                uAtClientCommandStop(atHandle);
+                // The response is +USECPRF: 0,13,x
+                uAtClientResponseStart(atHandle, "+USECPRF:");
+                // Skip the profile ID and the operation
+                uAtClientSkipParameters(atHandle, 2);
+                x = uAtClientReadInt(atHandle);
+                uAtClientResponseStop(atHandle);
+                if ((uAtClientUnlock(atHandle) == 0) && (x == 1)) {
+                    isOn = true;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUCellPrivateMutex);
+    }
+
+    return isOn;
+}
+
 // End of file
@@ -125,6 +125,26 @@ typedef struct {
     void (*pClosedCallback) (uDeviceHandle_t, int32_t); /**< Set to NULL
                                                      if socket is
                                                      not in use. */
+    void (*pConnectCallback) (uDeviceHandle_t, int32_t, int32_t); /**< Set
+                                                                while an
+                                                                asynchronous
+                                                                connect is
+                                                                in progress. */
+    int32_t connectErrno; /**< The outcome of an asynchronous connect. */
+    bool directLink; /**< true if the socket is in direct-link mode,
+                          in which case the AT client is held locked. */
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+    char *pReadAhead; /**< The read-ahead buffer, allocated on first use. */
+    size_t readAheadLength; /**< The number of bytes in pReadAhead. */
+    size_t readAheadIndex; /**< The read position in pReadAhead. */
+#endif
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+    char *pWriteCoalesce; /**< The write coalescing buffer, allocated
+                               on first use. */
+    size_t writeCoalesceLength; /**< The number of bytes in pWriteCoalesce. */
+    uPortTimerHandle_t writeCoalesceTimer; /**< Flushes pWriteCoalesce. */
+    bool noDelay; /**< true if U_SOCK_OPT_TCP_NODELAY has been set. */
+#endif
 } uCellSockSocket_t;
 
 /** Definition of a URC handler.
@@ -149,6 +169,14 @@ static int32_t gNextSockHandle = 0;
  */
 static uCellSockSocket_t gSockets[U_CELL_SOCK_MAX_NUM_SOCKETS];
 
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+/** Mutex to protect the write coalescing buffers, which are
+ * flushed from the AT client callback task as well as from
+ * uCellSockWrite().
+ */
+static uPortMutexHandle_t gMutexWriteCoalesce = NULL;
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: LIST MANAGEMENT
  * -------------------------------------------------------------- */
@@ -223,6 +251,20 @@ static uCellSockSocket_t *pSockCreate(int32_t sockHandle,
         pSock->pAsyncClosedCallback = NULL;
         pSock->pDataCallback = NULL;
         pSock->pClosedCallback = NULL;
+        pSock->pConnectCallback = NULL;
+        pSock->connectErrno = U_SOCK_ENONE;
+        pSock->directLink = false;
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+        pSock->pReadAhead = NULL;
+        pSock->readAheadLength = 0;
+        pSock->readAheadIndex = 0;
+#endif
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+        pSock->pWriteCoalesce = NULL;
+        pSock->writeCoalesceLength = 0;
+        pSock->writeCoalesceTimer = NULL;
+        pSock->noDelay = false;
+#endif
     }
 
     return pSock;
@@ -245,6 +287,29 @@ static void sockFree(int32_t sockHandle)
             pSock->pAsyncClosedCallback = NULL;
             pSock->pDataCallback = NULL;
             pSock->pClosedCallback = NULL;
+            pSock->pConnectCallback = NULL;
+            pSock->directLink = false;
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+            // Drop any read-ahead data
+            uPortFree(pSock->pReadAhead);
+            pSock->pReadAhead = NULL;
+            pSock->readAheadLength = 0;
+            pSock->readAheadIndex = 0;
+#endif
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+            // Drop the write coalescing buffer and its timer
+            U_PORT_MUTEX_LOCK(gMutexWriteCoalesce);
+            if (pSock->writeCoalesceTimer != NULL) {
+                uPortTimerStop(pSock->writeCoalesceTimer);
+                uPortTimerDelete(pSock->writeCoalesceTimer);
+                pSock->writeCoalesceTimer = NULL;
+            }
+            uPortFree(pSock->pWriteCoalesce);
+            pSock->pWriteCoalesce = NULL;
+            pSock->writeCoalesceLength = 0;
+            pSock->noDelay = false;
+            U_PORT_MUTEX_UNLOCK(gMutexWriteCoalesce);
+#endif
         }
     }
 }
@@ -311,6 +376,32 @@ static void closedCallback(const uAtClientHandle_t atHandle,
     }
 }
 
+// Callback trampoline for an asynchronous connect completing.
+static void connectCallback(const uAtClientHandle_t atHandle,
+                            void *pParameter)
+{
+    //lint -e(507) Suppress size incompatibility: the compiler
+    // we use for Lint checking is 64 bit so has 8 byte pointers
+    // and Lint doesn't like them being used to carry 4 byte integers
+    int32_t sockHandle = U_PTR_TO_INT32(pParameter);
+    uCellSockSocket_t *pSocket;
+    void (*pCallback) (uDeviceHandle_t, int32_t, int32_t);
+
+    (void) atHandle;
+
+    if (sockHandle >= 0) {
+        // Find the entry
+        pSocket = pFindBySockHandle(sockHandle);
+        if ((pSocket != NULL) && (pSocket->pConnectCallback != NULL)) {
+            // Done with the callback now
+            pCallback = pSocket->pConnectCallback;
+            pSocket->pConnectCallback = NULL;
+            pCallback(pSocket->cellHandle, sockHandle,
+                      pSocket->connectErrno);
+        }
+    }
+}
+
 // Socket Read/Read-From URC.
 static void UUSORD_UUSORF_urc(const uAtClientHandle_t atHandle,
                               void *pUnused)
@@ -367,6 +458,38 @@ static void UUSOCL_urc(const uAtClientHandle_t atHandle,
     }
 }
 
+// Callback for Socket Connect URC, only seen when connecting
+// asynchronously.
+static void UUSOCO_urc(const uAtClientHandle_t atHandle,
+                       void *pUnused)
+{
+    int32_t sockHandleModule;
+    int32_t socketError;
+    uCellSockSocket_t *pSocket = NULL;
+
+    (void) pUnused;
+
+    // +UUSOCO: <socket>,<socket_error>
+    sockHandleModule = uAtClientReadInt(atHandle);
+    socketError = uAtClientReadInt(atHandle);
+    if (sockHandleModule >= 0) {
+        // Find the entry
+        pSocket = pFindBySockHandleModule(atHandle,
+                                          sockHandleModule);
+        if ((pSocket != NULL) && (pSocket->pConnectCallback != NULL)) {
+            // The module's socket error numbers are
+            // the same as ours
+            pSocket->connectErrno = socketError;
+            if (socketError < 0) {
+                pSocket->connectErrno = U_SOCK_EIO;
+            }
+            uAtClientCallback(atHandle,
+                              connectCallback,
+                              U_INT32_TO_PTR(pSocket->sockHandle));
+        }
+    }
+}
+
 /* ----------------------------------------------------------------
  * MORE VARIABLES
  * -------------------------------------------------------------- */
@@ -376,9 +499,116 @@ static void UUSOCL_urc(const uAtClientHandle_t atHandle,
 static const uCellSockUrcHandler_t gUrcHandlers[] = {
     {"+UUSORD:", UUSORD_UUSORF_urc},
     {"+UUSORF:", UUSORD_UUSORF_urc},
-    {"+UUSOCL:", UUSOCL_urc}
+    {"+UUSOCL:", UUSOCL_urc},
+    {"+UUSOCO:", UUSOCO_urc}
 };
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: DIRECT LINK
+ * -------------------------------------------------------------- */
+
+// Put a socket into direct-link mode, returning a (non-negated)
+// value of U_SOCK_Exxx; on success the AT client is left locked,
+// with stop tag detection off, until directLinkLeave() is called.
+static int32_t directLinkEnter(uCellSockSocket_t *pSocket)
+{
+    int32_t errnoLocal = U_SOCK_EIO;
+    uAtClientHandle_t atHandle = pSocket->atHandle;
+
+    uAtClientLock(atHandle);
+    uAtClientTimeoutSet(atHandle, U_CELL_SOCK_DIRECT_LINK_CONNECT_TIMEOUT_MS);
+    uAtClientCommandStart(atHandle, "AT+USODL=");
+    uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+    uAtClientCommandStop(atHandle);
+    uAtClientResponseStart(atHandle, "CONNECT");
+    // Consume the remainder of the CONNECT line
+    uAtClientSkipParameters(atHandle, 1);
+    if (uAtClientErrorGet(atHandle) == 0) {
+        // Everything from here on is socket data
+        uAtClientIgnoreStopTag(atHandle);
+        pSocket->directLink = true;
+        errnoLocal = U_SOCK_ENONE;
+    } else {
+        // No CONNECT, stay in AT mode
+        uAtClientResponseStop(atHandle);
+        uAtClientUnlock(atHandle);
+        // See what the module's socket error number
+        // has to say for debug purposes
+        doUsoer(atHandle);
+    }
+
+    return errnoLocal;
+}
+
+// Take a socket out of direct-link mode and unlock the AT
+// client, returning a (non-negated) value of U_SOCK_Exxx.
+static int32_t directLinkLeave(uCellSockSocket_t *pSocket)
+{
+    int32_t errnoLocal = U_SOCK_EIO;
+    uAtClientHandle_t atHandle = pSocket->atHandle;
+
+    uAtClientLockExtend(atHandle);
+    // Send the escape sequence with silence either side
+    uPortTaskBlock(U_CELL_SOCK_DIRECT_LINK_GUARD_TIME_MS);
+    uAtClientWriteBytes(atHandle, "+++", 3, true);
+    uPortTaskBlock(U_CELL_SOCK_DIRECT_LINK_GUARD_TIME_MS);
+    // Throw away any socket data that arrived before
+    // the escape and whatever the module said on leaving
+    // direct-link mode, then check that AT mode is back
+    uAtClientFlush(atHandle);
+    uAtClientLockExtend(atHandle);
+    uAtClientCommandStart(atHandle, "AT");
+    uAtClientCommandStopReadResponse(atHandle);
+    pSocket->directLink = false;
+    if (uAtClientUnlock(atHandle) == 0) {
+        errnoLocal = U_SOCK_ENONE;
+    }
+
+    return errnoLocal;
+}
+
+// Read from a socket in direct-link mode without waiting,
+// returning the number of bytes read or negated value of
+// U_SOCK_Exxx.
+static int32_t directLinkRead(const uCellSockSocket_t *pSocket,
+                              void *pData, size_t dataSizeBytes)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_EIO;
+    uAtClientHandle_t atHandle = pSocket->atHandle;
+    int32_t x;
+
+    // Reset the lock timer and any error
+    uAtClientLockExtend(atHandle);
+    x = uAtClientReadBytesAvailable(atHandle, (char *) pData, dataSizeBytes);
+    if (x > 0) {
+        negErrnoLocalOrSize = x;
+    } else if (x == 0) {
+        negErrnoLocalOrSize = -U_SOCK_EWOULDBLOCK;
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+// Write to a socket in direct-link mode, returning the
+// number of bytes written or negated value of U_SOCK_Exxx.
+static int32_t directLinkWrite(const uCellSockSocket_t *pSocket,
+                               const void *pData, size_t dataSizeBytes)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_EIO;
+    uAtClientHandle_t atHandle = pSocket->atHandle;
+    size_t x;
+
+    // Reset the lock timer and any error
+    uAtClientLockExtend(atHandle);
+    x = uAtClientWriteBytes(atHandle, (const char *) pData,
+                            dataSizeBytes, true);
+    if (uAtClientErrorGet(atHandle) == 0) {
+        negErrnoLocalOrSize = (int32_t) x;
+    }
+
+    return negErrnoLocalOrSize;
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: SOCKET OPTIONS
  * -------------------------------------------------------------- */
@@ -572,6 +802,54 @@ static int32_t getOptionLinger(const uCellSockSocket_t *pSocket,
     return errnoLocal;
 }
 
+// Set the direct-link socket option, returning a
+// (non-negated) value of U_SOCK_Exxx.
+static int32_t setOptionDirectLink(uCellSockSocket_t *pSocket,
+                                   const void *pOptionValue,
+                                   size_t optionValueLength)
+{
+    int32_t errnoLocal = U_SOCK_EINVAL;
+    bool onNotOff;
+
+    if ((pOptionValue != NULL) &&
+        (optionValueLength >= sizeof(int32_t))) {
+        onNotOff = (*((const int32_t *) pOptionValue) != 0);
+        errnoLocal = U_SOCK_ENONE;
+        if (onNotOff && !pSocket->directLink) {
+            errnoLocal = directLinkEnter(pSocket);
+        } else if (!onNotOff && pSocket->directLink) {
+            errnoLocal = directLinkLeave(pSocket);
+        }
+    }
+
+    return errnoLocal;
+}
+
+// Get the direct-link socket option, returning a (non-negated)
+// value of U_SOCK_Exxx.
+static int32_t getOptionDirectLink(const uCellSockSocket_t *pSocket,
+                                   void *pOptionValue,
+                                   size_t *pOptionValueLength)
+{
+    int32_t errnoLocal = U_SOCK_EINVAL;
+
+    if (pOptionValueLength != NULL) {
+        if (pOptionValue != NULL) {
+            if (*pOptionValueLength >= sizeof(int32_t)) {
+                errnoLocal = U_SOCK_ENONE;
+                *((int32_t *) pOptionValue) = (int32_t) pSocket->directLink;
+                *pOptionValueLength = sizeof(int32_t);
+            }
+        } else {
+            errnoLocal = U_SOCK_ENONE;
+            // Caller just wants to know the length required
+            *pOptionValueLength = sizeof(int32_t);
+        }
+    }
+
+    return errnoLocal;
+}
+
 // Set hex mode on the underlying AT interface on or off.
 int32_t setHexMode(uDeviceHandle_t cellHandle, bool hexModeOnNotOff)
 {
@@ -648,9 +926,819 @@ static int32_t doUsoctl(uDeviceHandle_t cellHandle, int32_t sockHandle,
         }
     }
 
-    return negErrnoLocallOrValue;
+    return negErrnoLocallOrValue;
+}
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: STREAM (TCP) WRITE
+ * -------------------------------------------------------------- */
+
+// Write data to a TCP socket in the module, returning the
+// number of bytes written or negated value of U_SOCK_Exxx.
+static int32_t writeModule(const uCellPrivateInstance_t *pInstance,
+                           const uCellSockSocket_t *pSocket,
+                           const void *pData, size_t dataSizeBytes)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_ENOMEM;
+    uAtClientHandle_t atHandle = pInstance->atHandle;
+    int32_t leftToSendSize = (int32_t) dataSizeBytes;
+    int32_t sentSize = 0;
+    int32_t dataOffset = 0;
+    int32_t thisSendSize = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
+    size_t x = 0;
+    bool written = true;
+    char *pHexBuffer = NULL;
+
+    if (pInstance->socketsHexMode) {
+        thisSendSize /= 2;
+        pHexBuffer = (char *)pUPortMalloc(thisSendSize * 2 + 1); // +1 for terminator
+    }
+    if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
+        negErrnoLocalOrSize = U_SOCK_ENONE;
+        x = 0;
+        while ((leftToSendSize > 0) &&
+               (negErrnoLocalOrSize == U_SOCK_ENONE) &&
+               (x < U_CELL_SOCK_TCP_RETRY_LIMIT) &&
+               written) {
+            if (leftToSendSize < thisSendSize) {
+                thisSendSize = leftToSendSize;
+            }
+            uAtClientLock(atHandle);
+            uAtClientCommandStart(atHandle, "AT+USOWR=");
+            // Write module socket handle
+            uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+            // Number of bytes to follow
+            uAtClientWriteInt(atHandle, (int32_t) thisSendSize);
+            written = false;
+            if (pHexBuffer) {
+                // Make the hex-coded null terminated string
+                uBinToHex((const char *) pData + dataOffset,
+                          thisSendSize, pHexBuffer);
+                pHexBuffer[thisSendSize * 2] = 0;
+                // Send the hex mode data as a string
+                //lint -e(679) Suppress suspicious truncation
+                uAtClientWriteString(atHandle, pHexBuffer, true);
+                uAtClientCommandStop(atHandle);
+                written = true;
+            } else {
+                uAtClientCommandStop(atHandle);
+                // Wait for the prompt
+                if (uAtClientWaitCharacter(atHandle, '@') == 0) {
+                    // Wait for it...
+                    uPortTaskBlock(50);
+                    // Go!
+                    uAtClientWriteBytes(atHandle,
+                                        (const char *) pData + dataOffset,
+                                        thisSendSize, true);
+                    written = true;
+                }
+            }
+            if (written) {
+                // Grab the response
+                uAtClientResponseStart(atHandle, "+USOWR:");
+                // Skip the socket ID
+                uAtClientSkipParameters(atHandle, 1);
+                // Bytes sent
+                sentSize = uAtClientReadInt(atHandle);
+                uAtClientResponseStop(atHandle);
+                // Note: the sentSize check below is because we have seen cases
+                // where the module returns just "OK", missing out the "+USOWR: x"
+                // response; what to do when this happens?  The AT unlock check
+                // will pass because it has been sent an "OK", but has the data
+                // been sent or was the OK for a previous "AT" and we have somehow
+                // or other become unsynchronised with the module? Gonna assume
+                // the worst, that the data has not been sent.
+                if (sentSize < 0) {
+                    sentSize = 0;
+                }
+                if (uAtClientUnlock(atHandle) == 0) {
+                    dataOffset += sentSize;
+                    leftToSendSize -= sentSize;
+                    // Technically, it should be OK to
+                    // send fewer bytes than asked for,
+                    // however if this happens a lot we'll
+                    // get stuck, which isn't desirable,
+                    // so use the loop counter to avoid that
+                    if (sentSize < thisSendSize) {
+                        x++;
+                    }
+                } else {
+                    negErrnoLocalOrSize = -U_SOCK_EIO;
+                    // Got an AT interface error, see
+                    // what the module's socket error
+                    // number has to say for debug purposes
+                    doUsoer(atHandle);
+                }
+            } else {
+                negErrnoLocalOrSize = -U_SOCK_EIO;
+                uAtClientUnlock(atHandle);
+            }
+        }
+    }
+    // Free the buffer
+    uPortFree(pHexBuffer);
+
+    if (negErrnoLocalOrSize == U_SOCK_ENONE) {
+        // All is good
+        negErrnoLocalOrSize = ((int32_t) dataSizeBytes) - leftToSendSize;
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+
+// Flush the write coalescing buffer of a socket, returning a
+// (non-negated) value of U_SOCK_Exxx: anything the module does
+// not take stays in the buffer, the timer being restarted to have
+// another go later, and U_SOCK_EWOULDBLOCK is returned.
+// gMutexWriteCoalesce must be locked before this is called.
+static int32_t writeCoalesceFlush(uCellSockSocket_t *pSocket)
+{
+    int32_t errnoLocal = U_SOCK_ENONE;
+    const uCellPrivateInstance_t *pInstance;
+    int32_t negErrnoLocalOrSize;
+
+    if ((pSocket->writeCoalesceLength > 0) && !pSocket->directLink) {
+        errnoLocal = U_SOCK_EINVAL;
+        pInstance = pUCellPrivateGetInstance(pSocket->cellHandle);
+        if (pInstance != NULL) {
+            if (pSocket->writeCoalesceTimer != NULL) {
+                uPortTimerStop(pSocket->writeCoalesceTimer);
+            }
+            negErrnoLocalOrSize = writeModule(pInstance, pSocket,
+                                              pSocket->pWriteCoalesce,
+                                              pSocket->writeCoalesceLength);
+            if (negErrnoLocalOrSize >= 0) {
+                // Keep whatever was not sent
+                pSocket->writeCoalesceLength -= negErrnoLocalOrSize;
+                memmove(pSocket->pWriteCoalesce,
+                        pSocket->pWriteCoalesce + negErrnoLocalOrSize,
+                        pSocket->writeCoalesceLength);
+                errnoLocal = U_SOCK_ENONE;
+            } else {
+                errnoLocal = -negErrnoLocalOrSize;
+            }
+            if (pSocket->writeCoalesceLength > 0) {
+                if (errnoLocal == U_SOCK_ENONE) {
+                    errnoLocal = U_SOCK_EWOULDBLOCK;
+                }
+                if (pSocket->writeCoalesceTimer != NULL) {
+                    uPortTimerStart(pSocket->writeCoalesceTimer);
+                }
+            }
+        }
+    }
+
+    return errnoLocal;
+}
+
+// AT client callback which flushes the write coalescing buffer
+// of a socket once its timer has expired.
+static void writeCoalesceFlushCallback(const uAtClientHandle_t atHandle,
+                                       void *pParameter)
+{
+    //lint -e(507) Suppress size incompatibility: the compiler
+    // we use for Lint checking is 64 bit so has 8 byte pointers
+    // and Lint doesn't like them being used to carry 4 byte integers
+    int32_t sockHandle = U_PTR_TO_INT32(pParameter);
+    uCellSockSocket_t *pSocket;
+
+    (void) atHandle;
+
+    if ((gMutexWriteCoalesce != NULL) && (sockHandle >= 0)) {
+        U_PORT_MUTEX_LOCK(gMutexWriteCoalesce);
+        // Find the entry: it may have gone in the meantime
+        pSocket = pFindBySockHandle(sockHandle);
+        if (pSocket != NULL) {
+            writeCoalesceFlush(pSocket);
+        }
+        U_PORT_MUTEX_UNLOCK(gMutexWriteCoalesce);
+    }
+}
+
+// Timer callback for the write coalescing buffer of a socket:
+// flushing involves AT commands so hand it over to the AT client
+// callback task rather than doing it in the timer task.
+static void writeCoalesceTimerCallback(const uPortTimerHandle_t timerHandle,
+                                       void *pParameter)
+{
+    uCellSockSocket_t *pSocket;
+
+    (void) timerHandle;
+
+    pSocket = pFindBySockHandle(U_PTR_TO_INT32(pParameter));
+    if ((pSocket != NULL) && (pSocket->atHandle != NULL)) {
+        uAtClientCallback(pSocket->atHandle, writeCoalesceFlushCallback,
+                          pParameter);
+    }
+}
+
+// Write data to a TCP socket through its write coalescing buffer,
+// returning the number of bytes accepted or negated value of
+// U_SOCK_Exxx.
+static int32_t writeCoalesce(const uCellPrivateInstance_t *pInstance,
+                             uCellSockSocket_t *pSocket,
+                             const void *pData, size_t dataSizeBytes)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_ENOMEM;
+    int32_t errnoLocal;
+    bool bypass;
+
+    U_PORT_MUTEX_LOCK(gMutexWriteCoalesce);
+
+    if (pSocket->pWriteCoalesce == NULL) {
+        pSocket->pWriteCoalesce = (char *) pUPortMalloc(
+                                      U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES);
+    }
+    if ((pSocket->pWriteCoalesce != NULL) && (pSocket->writeCoalesceTimer == NULL)) {
+        if (uPortTimerCreate(&(pSocket->writeCoalesceTimer), "sockCoalesce",
+                             writeCoalesceTimerCallback,
+                             U_INT32_TO_PTR(pSocket->sockHandle),
+                             U_CELL_SOCK_WRITE_COALESCE_TIMEOUT_MS,
+                             false) != 0) {
+            // Without a timer we can't coalesce: data
+            // will just go straight through
+            pSocket->writeCoalesceTimer = NULL;
+        }
+    }
+    if (pSocket->pWriteCoalesce != NULL) {
+        // Things which can't wait, or are too big to
+        // be worth buffering, go straight to the module,
+        // after whatever is already buffered
+        bypass = pSocket->noDelay || (pSocket->writeCoalesceTimer == NULL) ||
+                 (dataSizeBytes >= U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES);
+        errnoLocal = U_SOCK_ENONE;
+        if (bypass || (pSocket->writeCoalesceLength + dataSizeBytes >
+                       U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES)) {
+            errnoLocal = writeCoalesceFlush(pSocket);
+        }
+        if (errnoLocal != U_SOCK_ENONE) {
+            negErrnoLocalOrSize = -errnoLocal;
+        } else if (bypass) {
+            negErrnoLocalOrSize = writeModule(pInstance, pSocket,
+                                              pData, dataSizeBytes);
+        } else {
+            memcpy(pSocket->pWriteCoalesce + pSocket->writeCoalesceLength,
+                   pData, dataSizeBytes);
+            if (pSocket->writeCoalesceLength == 0) {
+                // First data in: start the clock
+                uPortTimerStart(pSocket->writeCoalesceTimer);
+            }
+            pSocket->writeCoalesceLength += dataSizeBytes;
+            if (pSocket->writeCoalesceLength == U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES) {
+                // Full: no point in waiting; the data has been
+                // accepted so any failure here is left for the
+                // timer to retry
+                writeCoalesceFlush(pSocket);
+            }
+            negErrnoLocalOrSize = (int32_t) dataSizeBytes;
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(gMutexWriteCoalesce);
+
+    return negErrnoLocalOrSize;
+}
+
+// Flush any data waiting in the write coalescing buffer of a socket,
+// e.g. before it is closed, returning a (non-negated) value of
+// U_SOCK_Exxx.
+static int32_t writeCoalesceFlushNow(uCellSockSocket_t *pSocket)
+{
+    int32_t errnoLocal;
+
+    U_PORT_MUTEX_LOCK(gMutexWriteCoalesce);
+    errnoLocal = writeCoalesceFlush(pSocket);
+    U_PORT_MUTEX_UNLOCK(gMutexWriteCoalesce);
+
+    return errnoLocal;
+}
+
+#endif // #if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: STREAM (TCP) READ
+ * -------------------------------------------------------------- */
+
+// Read data from a TCP socket in the module, returning the
+// number of bytes read or negated value of U_SOCK_Exxx.
+// If atLocked is true the caller has already locked the AT
+// client, and it is left locked.
+static int32_t readModule(const uCellPrivateInstance_t *pInstance,
+                          uCellSockSocket_t *pSocket,
+                          char *pData, size_t dataSizeBytes,
+                          bool atLocked)
+{
+    int32_t negErrnoLocalOrSize;
+    uAtClientHandle_t atHandle = pInstance->atHandle;
+    int32_t dataLengthMax = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
+    int32_t x = -1;
+    int32_t thisWantedReceiveSize;
+    int32_t thisActualReceiveSize;
+    int32_t totalReceivedSize = 0;
+    int32_t readLength;
+    char *pHexBuffer = NULL;
+    bool probe;
+
+    if (pInstance->socketsHexMode) {
+        dataLengthMax /= 2;
+    }
+
+    // If the URC has not filled in pendingBytes,
+    // rather than asking the module how much there
+    // is to read and then reading it, which would
+    // cost two AT round trips, just try a read
+    // straight away: if nothing is there the module
+    // will return a length of zero
+    probe = (pSocket->pendingBytes == 0);
+    negErrnoLocalOrSize = U_SOCK_ENONE;
+    // Run around the loop until we run out of
+    // pending data or room in the buffer
+    while ((dataSizeBytes > 0) &&
+           ((pSocket->pendingBytes > 0) || probe) &&
+           (negErrnoLocalOrSize == U_SOCK_ENONE)) {
+        thisWantedReceiveSize = dataLengthMax;
+        if (thisWantedReceiveSize > (int32_t) dataSizeBytes) {
+            thisWantedReceiveSize = (int32_t) dataSizeBytes;
+        }
+        if (!atLocked) {
+            uAtClientLock(atHandle);
+        }
+        uAtClientCommandStart(atHandle, "AT+USORD=");
+        uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+        // Number of bytes to read
+        uAtClientWriteInt(atHandle, thisWantedReceiveSize);
+        uAtClientCommandStop(atHandle);
+        uAtClientResponseStart(atHandle, "+USORD:");
+        // Skip the socket ID
+        uAtClientSkipParameters(atHandle, 1);
+        // Read the amount of data
+        thisActualReceiveSize = uAtClientReadInt(atHandle);
+        if (thisActualReceiveSize > (int32_t) dataSizeBytes) {
+            thisActualReceiveSize = (int32_t) dataSizeBytes;
+        }
+        if (thisActualReceiveSize > 0) {
+            if (pInstance->socketsHexMode) {
+                // In hex mode we need a buffer to dump
+                // the hex into and then we can decode it
+                negErrnoLocalOrSize = -U_SOCK_ENOMEM;
+                //lint -e{647} Suppress suspicious truncation
+                pHexBuffer = (char *) pUPortMalloc(thisActualReceiveSize * 2 + 1);  // +1 for terminator
+            }
+            if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
+                negErrnoLocalOrSize = U_SOCK_ENONE;
+                if (pHexBuffer != NULL) {
+                    // In hex mode we can read in the whole string
+                    //lint -e{647} Suppress suspicious truncation
+                    readLength = uAtClientReadString(atHandle, pHexBuffer,
+                                                     thisActualReceiveSize * 2 + 1,
+                                                     false);
+                    if (readLength > 0) {
+                        x = ((int32_t) dataSizeBytes) * 2;
+                        if (readLength > x) {
+                            readLength = x;
+                        }
+                        uHexToBin(pHexBuffer, readLength,
+                                  pData + totalReceivedSize);
+                    }
+                    // Free memory
+                    uPortFree(pHexBuffer);
+                } else {
+                    // Binary mode, don't stop for anything!
+                    uAtClientIgnoreStopTag(atHandle);
+                    // Get the leading quote mark out of the way
+                    uAtClientReadBytes(atHandle, NULL, 1, true);
+                    // Now read out the available data,
+                    // straight from the AT client's buffer
+                    uCellPrivateReadBytesInPlace(atHandle,
+                                                 pData + totalReceivedSize,
+                                                 thisActualReceiveSize);
+                    // Make sure we wait for the stop tag before
+                    // going around again
+                    uAtClientRestoreStopTag(atHandle);
+                }
+            }
+        }
+        uAtClientResponseStop(atHandle);
+        // BEFORE unlocking, work out what's happened.
+        // This is to prevent a URC being processed that
+        // may indicate data left and over-write pendingBytes
+        // while we're also writing to it.
+        if ((uAtClientErrorGet(atHandle) == 0) &&
+            (thisActualReceiveSize >= 0)) {
+            // Must use what +USORD returns here as it may be less
+            // or more than we asked for and also may be
+            // more than pendingBytes, depending on how
+            // the URCs landed
+            // This update of pendingBytes will be overwritten
+            // by the URC but we have to do something here
+            // 'cos we don't get a URC to tell us when pendingBytes
+            // has gone to zero.
+            if (thisActualReceiveSize > pSocket->pendingBytes) {
+                pSocket->pendingBytes = 0;
+            } else {
+                pSocket->pendingBytes -= thisActualReceiveSize;
+            }
+            totalReceivedSize += thisActualReceiveSize;
+            dataSizeBytes -= thisActualReceiveSize;
+            if (probe && (thisActualReceiveSize == 0)) {
+                // Nothing there after all
+                negErrnoLocalOrSize = -U_SOCK_EWOULDBLOCK;
+            }
+        } else {
+            negErrnoLocalOrSize = -U_SOCK_EIO;
+        }
+        probe = false;
+        if (atLocked) {
+            // Keep the lock but give the next command its full time
+            uAtClientLockExtend(atHandle);
+        } else {
+            uAtClientUnlock(atHandle);
+        }
+    }
+
+    if (totalReceivedSize > 0) {
+        negErrnoLocalOrSize = totalReceivedSize;
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+// Take up to dataSizeBytes from the read-ahead buffer of a
+// socket, returning the number of bytes taken.
+static size_t readAheadTake(uCellSockSocket_t *pSocket,
+                            char *pData, size_t dataSizeBytes)
+{
+    size_t size = pSocket->readAheadLength - pSocket->readAheadIndex;
+
+    if (size > dataSizeBytes) {
+        size = dataSizeBytes;
+    }
+    if (size > 0) {
+        memcpy(pData, pSocket->pReadAhead + pSocket->readAheadIndex, size);
+        pSocket->readAheadIndex += size;
+    }
+
+    return size;
+}
+
+// Read data from a TCP socket via its read-ahead buffer,
+// returning the number of bytes read or negated value of
+// U_SOCK_Exxx.  Reads smaller than the buffer are served from
+// it, refilling it from the module with as much as the module
+// will give when it is empty; larger reads bypass it.
+static int32_t readAhead(const uCellPrivateInstance_t *pInstance,
+                         uCellSockSocket_t *pSocket,
+                         char *pData, size_t dataSizeBytes)
+{
+    int32_t negErrnoLocalOrSize = U_SOCK_ENONE;
+    size_t size;
+
+    // Anything already in the buffer comes first
+    size = readAheadTake(pSocket, pData, dataSizeBytes);
+    if (size < dataSizeBytes) {
+        if ((dataSizeBytes - size < U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES) &&
+            (pSocket->pReadAhead == NULL)) {
+            // Allocate the buffer on first use
+            pSocket->pReadAhead = (char *) pUPortMalloc(U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES);
+        }
+        if ((dataSizeBytes - size < U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES) &&
+            (pSocket->pReadAhead != NULL)) {
+            // A small read: refill the buffer and serve from it
+            pSocket->readAheadLength = 0;
+            pSocket->readAheadIndex = 0;
+            negErrnoLocalOrSize = readModule(pInstance, pSocket, pSocket->pReadAhead,
+                                             U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES,
+                                             false);
+            if (negErrnoLocalOrSize > 0) {
+                pSocket->readAheadLength = negErrnoLocalOrSize;
+                negErrnoLocalOrSize = (int32_t) readAheadTake(pSocket, pData + size,
+                                                              dataSizeBytes - size);
+            }
+        } else {
+            // A large read, or no memory for the buffer, go direct
+            negErrnoLocalOrSize = readModule(pInstance, pSocket, pData + size,
+                                             dataSizeBytes - size, false);
+        }
+        if (negErrnoLocalOrSize > 0) {
+            size += negErrnoLocalOrSize;
+        }
+    }
+
+    if (size > 0) {
+        negErrnoLocalOrSize = (int32_t) size;
+    }
+
+    return negErrnoLocalOrSize;
+}
+#endif
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: UDP
+ * -------------------------------------------------------------- */
+
+// Send a datagram from a socket in the module, returning the
+// number of bytes sent or negated value of U_SOCK_Exxx.
+// If atLocked is true the caller has already locked the AT
+// client, and it is left locked.
+static int32_t sendToModule(const uCellPrivateInstance_t *pInstance,
+                            const uCellSockSocket_t *pSocket,
+                            const uSockAddress_t *pRemoteAddress,
+                            const void *pData, size_t dataSizeBytes,
+                            bool atLocked)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_EDESTADDRREQ;
+    uAtClientHandle_t atHandle = pInstance->atHandle;
+    char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
+    char *pRemoteIpAddress;
+    size_t dataLengthMax = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
+    int32_t sentSize = 0;
+    int32_t atError;
+    size_t x;
+    bool written = false;
+    char *pHexBuffer = NULL;
+
+    if (pInstance->socketsHexMode) {
+        dataLengthMax /= 2;
+    }
+    if (uSockAddressToString(pRemoteAddress, buffer,
+                             sizeof(buffer)) > 0) {
+        pRemoteIpAddress = pUSockDomainRemovePort(buffer);
+        if (pRemoteIpAddress != NULL) {
+            negErrnoLocalOrSize = -U_SOCK_EMSGSIZE;
+            if (dataSizeBytes <= dataLengthMax) {
+                if (pInstance->socketsHexMode) {
+                    negErrnoLocalOrSize = -U_SOCK_ENOMEM;
+                    pHexBuffer = (char *) pUPortMalloc(dataSizeBytes * 2 + 1);  // +1 for terminator
+                    if (pHexBuffer != NULL) {
+                        // Make the hex-coded null terminated string
+                        x = uBinToHex((const char *) pData, dataSizeBytes, pHexBuffer);
+                        *(pHexBuffer + x) = 0;
+                    }
+                }
+                if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
+                    negErrnoLocalOrSize = -U_SOCK_EIO;
+                    if (!atLocked) {
+                        uAtClientLock(atHandle);
+                    }
+                    uAtClientCommandStart(atHandle, "AT+USOST=");
+                    // Write module socket handle
+                    uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+                    // Write IP address
+                    uAtClientWriteString(atHandle, pRemoteIpAddress, true);
+                    // Write port number
+                    uAtClientWriteInt(atHandle, pRemoteAddress->port);
+                    // Number of bytes to follow
+                    uAtClientWriteInt(atHandle, (int32_t) dataSizeBytes);
+                    if (pHexBuffer) {
+                        // Send the hex mode data as a string
+                        uAtClientWriteString(atHandle, pHexBuffer, true);
+                        uAtClientCommandStop(atHandle);
+                        // Free the buffer
+                        uPortFree(pHexBuffer);
+                        written = true;
+                    } else {
+                        // Not in hex mode, wait for the prompt
+                        uAtClientCommandStop(atHandle);
+                        if (uAtClientWaitCharacter(atHandle, '@') == 0) {
+                            // Wait for it...
+                            uPortTaskBlock(50);
+                            // Send the binary data
+                            uAtClientWriteBytes(atHandle, (const char *) pData,
+                                                dataSizeBytes, true);
+                            written = true;
+                        }
+                    }
+                    if (written) {
+                        // Grab the response
+                        uAtClientResponseStart(atHandle, "+USOST:");
+                        // Skip the socket ID
+                        uAtClientSkipParameters(atHandle, 1);
+                        // Bytes sent
+                        sentSize = uAtClientReadInt(atHandle);
+                        uAtClientResponseStop(atHandle);
+                    }
+                    if (atLocked) {
+                        // Keep the lock but give the next command its full time
+                        atError = uAtClientLockExtend(atHandle);
+                    } else {
+                        atError = uAtClientUnlock(atHandle);
+                    }
+                    if (written && (atError == 0) && (sentSize >= 0)) {
+                        // All is good, probably
+                        negErrnoLocalOrSize = sentSize;
+                    }
+                }
+            }
+        }
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+// Receive a datagram from a socket in the module, returning the
+// number of bytes received or negated value of U_SOCK_Exxx.
+// If atLocked is true the caller has already locked the AT
+// client, and it is left locked.
+static int32_t receiveFromModule(const uCellPrivateInstance_t *pInstance,
+                                 uCellSockSocket_t *pSocket,
+                                 uSockAddress_t *pRemoteAddress,
+                                 void *pData, size_t dataSizeBytes,
+                                 bool atLocked)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_EWOULDBLOCK;
+    uAtClientHandle_t atHandle = pInstance->atHandle;
+    int32_t dataLengthMax = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
+    char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
+    int32_t x;
+    int32_t port = -1;
+    int32_t receivedSize = -1;
+    int32_t readLength;
+    int32_t atError;
+    char *pHexBuffer = NULL;
+
+    buffer[0] = 0;  // In case of slip-ups
+
+    // Note: the real maximum length of UDP packet we can receive
+    // comes from fitting all of the following into one buffer:
+    //
+    // +USORF: xx,"max.len.ip.address.ipv4.or.ipv6",yyyyy,wwww,"the_data"\r\n
+    //
+    // where xx is the handle, max.len.ip.address.ipv4.or.ipv6 is NSAPI_IP_SIZE,
+    // yyyyy is the port number (max 65536), wwww is the length of the data and
+    // the_data is binary data. I make that 29 + 48 + len(the_data),
+    // so the overhead is 77 bytes.
+
+    if (pInstance->socketsHexMode) {
+        dataLengthMax /= 2;
+    }
+    if (pSocket->pendingBytes == 0) {
+        // If the URC has not filled in pendingBytes,
+        // ask the module directly if there is anything
+        // to read
+        if (!atLocked) {
+            uAtClientLock(atHandle);
+        }
+        uAtClientCommandStart(atHandle, "AT+USORF=");
+        uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+        // Zero bytes to read, just want to know the number
+        // of bytes waiting
+        uAtClientWriteInt(atHandle, 0);
+        uAtClientCommandStop(atHandle);
+        uAtClientResponseStart(atHandle, "+USORF:");
+        // Skip the socket ID
+        uAtClientSkipParameters(atHandle, 1);
+        // Read the amount of data
+        x = uAtClientReadInt(atHandle);
+        uAtClientResponseStop(atHandle);
+        // Update pending bytes here, before
+        // unlocking, as otherwise a data callback
+        // triggered by a URC could be sitting waiting
+        // to grab the AT lock and jump in before
+        // pending bytes has been updated, leading it
+        // back into here again, etc, etc.
+        if (x > 0) {
+            pSocket->pendingBytes = x;
+            // DON'T call the user data callback here:
+            // we already have the AT interface locked
+            // and a user might try to call back into
+            // here which would result in deadlock.
+            // They will get their received data, there
+            // is no need to worry.
+        }
+        if (atLocked) {
+            atError = uAtClientLockExtend(atHandle);
+        } else {
+            atError = uAtClientUnlock(atHandle);
+        }
+        if ((atError != 0) || (x < 0)) {
+            // Looks like the socket has gone
+            pSocket->pendingBytes = 0;
+            negErrnoLocalOrSize = -U_SOCK_EIO;
+        }
+    }
+    if (pSocket->pendingBytes > 0) {
+        // In the UDP case we HAVE to read the number
+        // of bytes pending as this will be the size
+        // of the next UDP packet in the module and the
+        // module can only deliver whole UDP packets.
+        if (!atLocked) {
+            uAtClientLock(atHandle);
+        }
+        uAtClientCommandStart(atHandle, "AT+USORF=");
+        uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+        // Number of bytes to read
+        uAtClientWriteInt(atHandle, dataLengthMax);
+        uAtClientCommandStop(atHandle);
+        uAtClientResponseStart(atHandle, "+USORF:");
+        // Skip the socket ID
+        uAtClientSkipParameters(atHandle, 1);
+        // Read the IP address
+        uAtClientReadString(atHandle, buffer,
+                            sizeof(buffer), false);
+        // Read the port
+        port = uAtClientReadInt(atHandle);
+        // Read the amount of data
+        receivedSize = uAtClientReadInt(atHandle);
+        if (receivedSize > dataLengthMax) {
+            receivedSize = dataLengthMax;
+        }
+        if ((int32_t) dataSizeBytes > receivedSize) {
+            dataSizeBytes = receivedSize;
+        }
+        if (receivedSize > 0) {
+            if (pInstance->socketsHexMode) {
+                // In hex mode we need a buffer to dump
+                // the hex into and then we can decode it
+                negErrnoLocalOrSize = -U_SOCK_ENOMEM;
+                //lint -e{647} Suppress suspicious truncation
+                pHexBuffer = (char *) pUPortMalloc(receivedSize * 2 + 1);  // +1 for terminator
+            }
+            if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
+                if (pHexBuffer != NULL) {
+                    // In hex mode we can read in the whole string
+                    //lint -e{647} Suppress suspicious truncation
+                    readLength = uAtClientReadString(atHandle, pHexBuffer,
+                                                     receivedSize * 2 + 1, false);
+                    if (readLength > 0) {
+                        x = (int32_t) dataSizeBytes * 2;
+                        if (readLength > x) {
+                            readLength = x;
+                        }
+                        uHexToBin(pHexBuffer, readLength, (char *) pData);
+                    }
+                    // Free memory
+                    uPortFree(pHexBuffer);
+                } else {
+                    // Binary mode, don't stop for anything!
+                    uAtClientIgnoreStopTag(atHandle);
+                    // Get the leading quote mark out of the way
+                    uAtClientReadBytes(atHandle, NULL, 1, true);
+                    // Now read out all the actual data,
+                    // first the bit we want, straight from
+                    // the AT client's buffer
+                    uCellPrivateReadBytesInPlace(atHandle, (char *) pData,
+                                                 dataSizeBytes);
+                    if (receivedSize > (int32_t) dataSizeBytes) {
+                        //...and then the rest poured away to NULL
+                        uCellPrivateReadBytesInPlace(atHandle, NULL,
+                                                     receivedSize -
+                                                     dataSizeBytes);
+                    }
+                    // Make sure to wait for the stop tag before
+                    // we finish
+                    uAtClientRestoreStopTag(atHandle);
+                }
+            }
+        }
+        uAtClientResponseStop(atHandle);
+        // BEFORE unlocking, work out what's happened.
+        // This is to prevent a URC being processed that
+        // may indicate data left and over-write pendingBytes
+        // while we're also writing to it.
+        if ((uAtClientErrorGet(atHandle) == 0) &&
+            (receivedSize >= 0)) {
+            // Must use what +USORF returns here as it may be less
+            // or more than we asked for and also may be
+            // more than pendingBytes, depending on how
+            // the URCs landed
+            // This update of pendingBytes will be overwritten
+            // by the URC but we have to do something here
+            // 'cos we don't get a URC to tell us when pendingBytes
+            // has gone to zero.
+            if (receivedSize > pSocket->pendingBytes) {
+                pSocket->pendingBytes = 0;
+            } else {
+                pSocket->pendingBytes -= receivedSize;
+            }
+            negErrnoLocalOrSize = receivedSize;
+        }
+        if (atLocked) {
+            // Keep the lock but give the next command its full time
+            uAtClientLockExtend(atHandle);
+        } else {
+            uAtClientUnlock(atHandle);
+        }
+    }
+
+    if ((negErrnoLocalOrSize >= 0) && (pRemoteAddress != NULL) && (port >= 0)) {
+        if (uSockStringToAddress(buffer, pRemoteAddress) == 0) {
+            pRemoteAddress->port = (uint16_t) port;
+        } else {
+            // If we can't decode the remote address this becomes
+            // an error, can't go receiving things from servers
+            // we know not who they are
+            negErrnoLocalOrSize = -U_SOCK_EIO;
+        }
+    }
+
+    return negErrnoLocalOrSize;
 }
 
+
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -667,9 +1755,16 @@ void uCellSockPrivateLink()
 // Initialise the cellular sockets layer.
 int32_t uCellSockInit()
 {
+    int32_t errnoLocal = U_SOCK_ENONE;
     uCellSockSocket_t *pSock = NULL;
 
     if (!gInitialised) {
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+        if (uPortMutexCreate(&gMutexWriteCoalesce) != 0) {
+            gMutexWriteCoalesce = NULL;
+            errnoLocal = U_SOCK_ENOMEM;
+        }
+#endif
 
         // Clear the list
         for (size_t x = 0; (x < sizeof(gSockets) / sizeof(gSockets[0])); x++) {
@@ -682,10 +1777,10 @@ int32_t uCellSockInit()
             pSock->pClosedCallback = NULL;
         }
 
-        gInitialised = true;
+        gInitialised = (errnoLocal == U_SOCK_ENONE);
     }
 
-    return U_SOCK_ENONE;
+    return -errnoLocal;
 }
 
 // Initialise the cellular sockets instance.
@@ -719,8 +1814,11 @@ int32_t uCellSockInitInstance(uDeviceHandle_t cellHandle)
 void uCellSockDeinit()
 {
     if (gInitialised) {
-        // Nothing to do, URCs will have been
-        // removed on close
+        // URCs will have been removed on close
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+        uPortMutexDelete(gMutexWriteCoalesce);
+        gMutexWriteCoalesce = NULL;
+#endif
         gInitialised = false;
     }
 }
@@ -847,6 +1945,71 @@ int32_t uCellSockConnect(uDeviceHandle_t cellHandle,
     return -errnoLocal;
 }
 
+// Connect to a server without waiting.
+int32_t uCellSockConnectAsync(uDeviceHandle_t cellHandle,
+                              int32_t sockHandle,
+                              const uSockAddress_t *pRemoteAddress,
+                              void (*pCallback) (uDeviceHandle_t,
+                                                 int32_t, int32_t))
+{
+    int32_t errnoLocal = U_SOCK_EINVAL;
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+    uCellSockSocket_t *pSocket;
+    char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
+    char *pRemoteIpAddress;
+
+    // Find the instance
+    pInstance = pUCellPrivateGetInstance(cellHandle);
+    if ((pInstance != NULL) && (pCallback != NULL)) {
+        errnoLocal = U_SOCK_ENOSYS;
+        if (U_CELL_PRIVATE_HAS(pInstance->pModule,
+                               U_CELL_PRIVATE_FEATURE_ASYNC_SOCK_CONNECT)) {
+            errnoLocal = U_SOCK_EINVAL;
+            atHandle = pInstance->atHandle;
+            // Find the entry
+            if (sockHandle >= 0) {
+                pSocket = pFindBySockHandle(sockHandle);
+                if ((pSocket != NULL) &&
+                    (uSockAddressToString(pRemoteAddress, buffer,
+                                          sizeof(buffer)) > 0)) {
+                    errnoLocal = U_SOCK_EALREADY;
+                    if (pSocket->pConnectCallback == NULL) {
+                        pRemoteIpAddress = pUSockDomainRemovePort(buffer);
+                        // Set the callback before asking, the URC
+                        // could come back very quickly
+                        pSocket->pConnectCallback = pCallback;
+                        pSocket->connectErrno = U_SOCK_ENONE;
+                        uAtClientLock(atHandle);
+                        uAtClientCommandStart(atHandle, "AT+USOCO=");
+                        // Write module socket handle
+                        uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
+                        // Write IP address
+                        uAtClientWriteString(atHandle, pRemoteIpAddress, true);
+                        // Write port number
+                        uAtClientWriteInt(atHandle, pRemoteAddress->port);
+                        // Connect asynchronously
+                        uAtClientWriteInt(atHandle, 1);
+                        uAtClientCommandStopReadResponse(atHandle);
+                        if (uAtClientUnlock(atHandle) == 0) {
+                            // Off it goes
+                            errnoLocal = U_SOCK_EINPROGRESS;
+                        } else {
+                            errnoLocal = U_SOCK_EHOSTUNREACH;
+                            pSocket->pConnectCallback = NULL;
+                            // See what the module's socket error
+                            // number has to say for debug purposes
+                            doUsoer(atHandle);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return -errnoLocal;
+}
+
 // Close a socket.
 int32_t uCellSockClose(uDeviceHandle_t cellHandle,
                        int32_t sockHandle,
@@ -868,6 +2031,14 @@ int32_t uCellSockClose(uDeviceHandle_t cellHandle,
         if (sockHandle >= 0) {
             pSocket = pFindBySockHandle(sockHandle);
             if (pSocket != NULL) {
+                if (pSocket->directLink) {
+                    // Need AT mode back to close the socket
+                    directLinkLeave(pSocket);
+                }
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+                // Don't lose anything still waiting to go
+                writeCoalesceFlushNow(pSocket);
+#endif
                 errnoLocal = U_SOCK_EIO;
                 // Close the socket through the cellular module
                 // If have seen modules return ERROR to this
@@ -998,6 +2169,16 @@ int32_t uCellSockOptionSet(uDeviceHandle_t cellHandle,
                                     errnoLocal = setOptionLinger(pSocket, pOptionValue,
                                                                  optionValueLength);
                                     break;
+                                // The u-blox specific direct-link option
+                                case U_SOCK_OPT_DIRECT_LINK:
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+                                    // Buffered data must go before
+                                    // the AT interface is given up
+                                    writeCoalesceFlushNow(pSocket);
+#endif
+                                    errnoLocal = setOptionDirectLink(pSocket, pOptionValue,
+                                                                     optionValueLength);
+                                    break;
                                 default:
                                     break;
                             }
@@ -1023,6 +2204,20 @@ int32_t uCellSockOptionSet(uDeviceHandle_t cellHandle,
                                 // which have an integer as a
                                 // parameter
                                 case U_SOCK_OPT_TCP_NODELAY:
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+                                    if ((pOptionValue != NULL) &&
+                                        (optionValueLength >= sizeof(int32_t))) {
+                                        // No delay means no coalescing either
+                                        pSocket->noDelay = (*((const int32_t *) pOptionValue) != 0);
+                                        if (pSocket->noDelay) {
+                                            writeCoalesceFlushNow(pSocket);
+                                        }
+                                    }
+#endif
+                                    errnoLocal = setOptionInt(pSocket, level,
+                                                              option, pOptionValue,
+                                                              optionValueLength);
+                                    break;
                                 case U_SOCK_OPT_TCP_KEEPIDLE:
                                     errnoLocal = setOptionInt(pSocket, level,
                                                               option, pOptionValue,
@@ -1084,6 +2279,11 @@ int32_t uCellSockOptionGet(uDeviceHandle_t cellHandle,
                                     errnoLocal = getOptionLinger(pSocket, pOptionValue,
                                                                  pOptionValueLength);
                                     break;
+                                // The u-blox specific direct-link option
+                                case U_SOCK_OPT_DIRECT_LINK:
+                                    errnoLocal = getOptionDirectLink(pSocket, pOptionValue,
+                                                                     pOptionValueLength);
+                                    break;
                                 default:
                                     break;
                             }
@@ -1234,99 +2434,72 @@ int32_t uCellSockSendTo(uDeviceHandle_t cellHandle,
 {
     int32_t negErrnoLocalOrSize = -U_SOCK_EINVAL;
     uCellPrivateInstance_t *pInstance;
-    uAtClientHandle_t atHandle;
     uCellSockSocket_t *pSocket;
-    char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
-    char *pRemoteIpAddress;
-    size_t dataLengthMax = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
-    int32_t sentSize = 0;
-    size_t x;
-    bool written = false;
-    char *pHexBuffer = NULL;
 
     // Find the instance
     pInstance = pUCellPrivateGetInstance(cellHandle);
     if (pInstance != NULL) {
-        atHandle = pInstance->atHandle;
-        if (pInstance->socketsHexMode) {
-            dataLengthMax /= 2;
+        // Find the entry
+        if (sockHandle >= 0) {
+            pSocket = pFindBySockHandle(sockHandle);
+            if (pSocket != NULL) {
+                negErrnoLocalOrSize = sendToModule(pInstance, pSocket,
+                                                   pRemoteAddress, pData,
+                                                   dataSizeBytes, false);
+            }
         }
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+// Send several datagrams.
+int32_t uCellSockSendToBatch(uDeviceHandle_t cellHandle,
+                             int32_t sockHandle,
+                             uSockDatagram_t *pDatagrams,
+                             size_t numDatagrams)
+{
+    int32_t negErrnoLocalOrNum = -U_SOCK_EINVAL;
+    uCellPrivateInstance_t *pInstance;
+    uCellSockSocket_t *pSocket;
+    uSockDatagram_t *pDatagram;
+    int32_t numSent = 0;
+    bool keepGoing = true;
+
+    // Find the instance
+    pInstance = pUCellPrivateGetInstance(cellHandle);
+    if ((pInstance != NULL) && ((pDatagrams != NULL) || (numDatagrams == 0))) {
         // Find the entry
         if (sockHandle >= 0) {
             pSocket = pFindBySockHandle(sockHandle);
             if (pSocket != NULL) {
-                negErrnoLocalOrSize = -U_SOCK_EDESTADDRREQ;
-                if (uSockAddressToString(pRemoteAddress, buffer,
-                                         sizeof(buffer)) > 0) {
-                    pRemoteIpAddress = pUSockDomainRemovePort(buffer);
-                    if (pRemoteIpAddress != NULL) {
-                        negErrnoLocalOrSize = -U_SOCK_EMSGSIZE;
-                        if (dataSizeBytes <= dataLengthMax) {
-                            if (pInstance->socketsHexMode) {
-                                negErrnoLocalOrSize = -U_SOCK_ENOMEM;
-                                pHexBuffer = (char *) pUPortMalloc(dataSizeBytes * 2 + 1);  // +1 for terminator
-                                if (pHexBuffer != NULL) {
-                                    // Make the hex-coded null terminated string
-                                    x = uBinToHex((const char *) pData, dataSizeBytes, pHexBuffer);
-                                    *(pHexBuffer + x) = 0;
-                                }
-                            }
-                            if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
-                                negErrnoLocalOrSize = -U_SOCK_EIO;
-                                uAtClientLock(atHandle);
-                                uAtClientCommandStart(atHandle, "AT+USOST=");
-                                // Write module socket handle
-                                uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
-                                // Write IP address
-                                uAtClientWriteString(atHandle, pRemoteIpAddress, true);
-                                // Write port number
-                                uAtClientWriteInt(atHandle, pRemoteAddress->port);
-                                // Number of bytes to follow
-                                uAtClientWriteInt(atHandle, (int32_t) dataSizeBytes);
-                                if (pHexBuffer) {
-                                    // Send the hex mode data as a string
-                                    uAtClientWriteString(atHandle, pHexBuffer, true);
-                                    uAtClientCommandStop(atHandle);
-                                    // Free the buffer
-                                    uPortFree(pHexBuffer);
-                                    written = true;
-                                } else {
-                                    // Not in hex mode, wait for the prompt
-                                    uAtClientCommandStop(atHandle);
-                                    if (uAtClientWaitCharacter(atHandle, '@') == 0) {
-                                        // Wait for it...
-                                        uPortTaskBlock(50);
-                                        // Send the binary data
-                                        uAtClientWriteBytes(atHandle, (const char *) pData,
-                                                            dataSizeBytes, true);
-                                        written = true;
-                                    }
-                                }
-                                if (written) {
-                                    // Grab the response
-                                    uAtClientResponseStart(atHandle, "+USOST:");
-                                    // Skip the socket ID
-                                    uAtClientSkipParameters(atHandle, 1);
-                                    // Bytes sent
-                                    sentSize = uAtClientReadInt(atHandle);
-                                    uAtClientResponseStop(atHandle);
-                                    if ((uAtClientUnlock(atHandle) == 0) &&
-                                        (sentSize >= 0)) {
-                                        // All is good, probably
-                                        negErrnoLocalOrSize = sentSize;
-                                    }
-                                } else {
-                                    uAtClientUnlock(atHandle);
-                                }
-                            }
-                        }
+                negErrnoLocalOrNum = U_SOCK_ENONE;
+                // Hold the AT lock across the lot, stopping
+                // at the first datagram that fails
+                uAtClientLock(pInstance->atHandle);
+                for (size_t x = 0; (x < numDatagrams) && keepGoing; x++) {
+                    pDatagram = pDatagrams + x;
+                    pDatagram->negErrnoOrSize = sendToModule(pInstance, pSocket,
+                                                             pDatagram->pAddress,
+                                                             pDatagram->pData,
+                                                             pDatagram->dataSizeBytes,
+                                                             true);
+                    if (pDatagram->negErrnoOrSize >= 0) {
+                        numSent++;
+                    } else {
+                        negErrnoLocalOrNum = pDatagram->negErrnoOrSize;
+                        keepGoing = false;
                     }
                 }
+                uAtClientUnlock(pInstance->atHandle);
+                if (numSent > 0) {
+                    negErrnoLocalOrNum = numSent;
+                }
             }
         }
     }
 
-    return negErrnoLocalOrSize;
+    return negErrnoLocalOrNum;
 }
 
 // Receive a datagram.
@@ -1337,189 +2510,73 @@ int32_t uCellSockReceiveFrom(uDeviceHandle_t cellHandle,
 {
     int32_t negErrnoLocalOrSize = -U_SOCK_EINVAL;
     uCellPrivateInstance_t *pInstance;
-    uAtClientHandle_t atHandle;
     uCellSockSocket_t *pSocket;
-    int32_t dataLengthMax = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
-    char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
-    int32_t x;
-    int32_t port = -1;
-    int32_t receivedSize = -1;
-    int32_t readLength;
-    char *pHexBuffer = NULL;
-
-    buffer[0] = 0;  // In case of slip-ups
-
-    // Note: the real maximum length of UDP packet we can receive
-    // comes from fitting all of the following into one buffer:
-    //
-    // +USORF: xx,"max.len.ip.address.ipv4.or.ipv6",yyyyy,wwww,"the_data"\r\n
-    //
-    // where xx is the handle, max.len.ip.address.ipv4.or.ipv6 is NSAPI_IP_SIZE,
-    // yyyyy is the port number (max 65536), wwww is the length of the data and
-    // the_data is binary data. I make that 29 + 48 + len(the_data),
-    // so the overhead is 77 bytes.
 
     // Find the instance
     pInstance = pUCellPrivateGetInstance(cellHandle);
     if (pInstance != NULL) {
-        atHandle = pInstance->atHandle;
-        if (pInstance->socketsHexMode) {
-            dataLengthMax /= 2;
+        // Find the entry
+        if (sockHandle >= 0) {
+            pSocket = pFindBySockHandle(sockHandle);
+            if (pSocket != NULL) {
+                negErrnoLocalOrSize = receiveFromModule(pInstance, pSocket,
+                                                        pRemoteAddress, pData,
+                                                        dataSizeBytes, false);
+            }
         }
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+// Receive several datagrams.
+int32_t uCellSockReceiveFromBatch(uDeviceHandle_t cellHandle,
+                                  int32_t sockHandle,
+                                  uSockDatagram_t *pDatagrams,
+                                  size_t numDatagrams)
+{
+    int32_t negErrnoLocalOrNum = -U_SOCK_EINVAL;
+    uCellPrivateInstance_t *pInstance;
+    uCellSockSocket_t *pSocket;
+    uSockDatagram_t *pDatagram;
+    int32_t numReceived = 0;
+    bool keepGoing = true;
+
+    // Find the instance
+    pInstance = pUCellPrivateGetInstance(cellHandle);
+    if ((pInstance != NULL) && ((pDatagrams != NULL) || (numDatagrams == 0))) {
         // Find the entry
         if (sockHandle >= 0) {
             pSocket = pFindBySockHandle(sockHandle);
             if (pSocket != NULL) {
-                negErrnoLocalOrSize = -U_SOCK_EWOULDBLOCK;
-                if (pSocket->pendingBytes == 0) {
-                    // If the URC has not filled in pendingBytes,
-                    // ask the module directly if there is anything
-                    // to read
-                    uAtClientLock(atHandle);
-                    uAtClientCommandStart(atHandle, "AT+USORF=");
-                    uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
-                    // Zero bytes to read, just want to know the number
-                    // of bytes waiting
-                    uAtClientWriteInt(atHandle, 0);
-                    uAtClientCommandStop(atHandle);
-                    uAtClientResponseStart(atHandle, "+USORF:");
-                    // Skip the socket ID
-                    uAtClientSkipParameters(atHandle, 1);
-                    // Read the amount of data
-                    x = uAtClientReadInt(atHandle);
-                    uAtClientResponseStop(atHandle);
-                    // Update pending bytes here, before
-                    // unlocking, as otherwise a data callback
-                    // triggered by a URC could be sitting waiting
-                    // to grab the AT lock and jump in before
-                    // pending bytes has been updated, leading it
-                    // back into here again, etc, etc.
-                    if (x > 0) {
-                        pSocket->pendingBytes = x;
-                        // DON'T call the user data callback here:
-                        // we already have the AT interface locked
-                        // and a user might try to call back into
-                        // here which would result in deadlock.
-                        // They will get their received data, there
-                        // is no need to worry.
-                    }
-                    if ((uAtClientUnlock(atHandle) != 0) || (x < 0)) {
-                        // Looks like the socket has gone
-                        pSocket->pendingBytes = 0;
-                        negErrnoLocalOrSize = -U_SOCK_EIO;
+                negErrnoLocalOrNum = -U_SOCK_EWOULDBLOCK;
+                // Hold the AT lock across the lot, stopping when
+                // there is nothing more to read or an error occurs;
+                // entries not reached are left untouched
+                uAtClientLock(pInstance->atHandle);
+                for (size_t x = 0; (x < numDatagrams) && keepGoing; x++) {
+                    pDatagram = pDatagrams + x;
+                    pDatagram->negErrnoOrSize = receiveFromModule(pInstance, pSocket,
+                                                                  pDatagram->pAddress,
+                                                                  pDatagram->pData,
+                                                                  pDatagram->dataSizeBytes,
+                                                                  true);
+                    if (pDatagram->negErrnoOrSize >= 0) {
+                        numReceived++;
+                    } else {
+                        negErrnoLocalOrNum = pDatagram->negErrnoOrSize;
+                        keepGoing = false;
                     }
                 }
-                if (pSocket->pendingBytes > 0) {
-                    // In the UDP case we HAVE to read the number
-                    // of bytes pending as this will be the size
-                    // of the next UDP packet in the module and the
-                    // module can only deliver whole UDP packets.
-                    uAtClientLock(atHandle);
-                    uAtClientCommandStart(atHandle, "AT+USORF=");
-                    uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
-                    // Number of bytes to read
-                    uAtClientWriteInt(atHandle, dataLengthMax);
-                    uAtClientCommandStop(atHandle);
-                    uAtClientResponseStart(atHandle, "+USORF:");
-                    // Skip the socket ID
-                    uAtClientSkipParameters(atHandle, 1);
-                    // Read the IP address
-                    uAtClientReadString(atHandle, buffer,
-                                        sizeof(buffer), false);
-                    // Read the port
-                    port = uAtClientReadInt(atHandle);
-                    // Read the amount of data
-                    receivedSize = uAtClientReadInt(atHandle);
-                    if (receivedSize > dataLengthMax) {
-                        receivedSize = dataLengthMax;
-                    }
-                    if ((int32_t) dataSizeBytes > receivedSize) {
-                        dataSizeBytes = receivedSize;
-                    }
-                    if (receivedSize > 0) {
-                        if (pInstance->socketsHexMode) {
-                            // In hex mode we need a buffer to dump
-                            // the hex into and then we can decode it
-                            negErrnoLocalOrSize = -U_SOCK_ENOMEM;
-                            //lint -e{647} Suppress suspicious truncation
-                            pHexBuffer = (char *) pUPortMalloc(receivedSize * 2 + 1);  // +1 for terminator
-                        }
-                        if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
-                            if (pHexBuffer != NULL) {
-                                // In hex mode we can read in the whole string
-                                //lint -e{647} Suppress suspicious truncation
-                                readLength = uAtClientReadString(atHandle, pHexBuffer,
-                                                                 receivedSize * 2 + 1, false);
-                                if (readLength > 0) {
-                                    x = (int32_t) dataSizeBytes * 2;
-                                    if (readLength > x) {
-                                        readLength = x;
-                                    }
-                                    uHexToBin(pHexBuffer, readLength, (char *) pData);
-                                }
-                                // Free memory
-                                uPortFree(pHexBuffer);
-                            } else {
-                                // Binary mode, don't stop for anything!
-                                uAtClientIgnoreStopTag(atHandle);
-                                // Get the leading quote mark out of the way
-                                uAtClientReadBytes(atHandle, NULL, 1, true);
-                                // Now read out all the actual data,
-                                // first the bit we want
-                                uAtClientReadBytes(atHandle, (char *) pData,
-                                                   dataSizeBytes, true);
-                                if (receivedSize > (int32_t) dataSizeBytes) {
-                                    //...and then the rest poured away to NULL
-                                    uAtClientReadBytes(atHandle, NULL,
-                                                       receivedSize -
-                                                       dataSizeBytes, true);
-                                }
-                                // Make sure to wait for the stop tag before
-                                // we finish
-                                uAtClientRestoreStopTag(atHandle);
-                            }
-                        }
-                    }
-                    uAtClientResponseStop(atHandle);
-                    // BEFORE unlocking, work out what's happened.
-                    // This is to prevent a URC being processed that
-                    // may indicate data left and over-write pendingBytes
-                    // while we're also writing to it.
-                    if ((uAtClientErrorGet(atHandle) == 0) &&
-                        (receivedSize >= 0)) {
-                        // Must use what +USORF returns here as it may be less
-                        // or more than we asked for and also may be
-                        // more than pendingBytes, depending on how
-                        // the URCs landed
-                        // This update of pendingBytes will be overwritten
-                        // by the URC but we have to do something here
-                        // 'cos we don't get a URC to tell us when pendingBytes
-                        // has gone to zero.
-                        if (receivedSize > pSocket->pendingBytes) {
-                            pSocket->pendingBytes = 0;
-                        } else {
-                            pSocket->pendingBytes -= receivedSize;
-                        }
-                        negErrnoLocalOrSize = receivedSize;
-                    }
-                    uAtClientUnlock(atHandle);
+                uAtClientUnlock(pInstance->atHandle);
+                if (numReceived > 0) {
+                    negErrnoLocalOrNum = numReceived;
                 }
             }
         }
     }
 
-    if ((negErrnoLocalOrSize >= 0) && (pRemoteAddress != NULL) && (port >= 0)) {
-        if (uSockStringToAddress(buffer, pRemoteAddress) == 0) {
-            pRemoteAddress->port = (uint16_t) port;
-        } else {
-            // If we can't decode the remote address this becomes
-            // an error, can't go receiving things from servers
-            // we know not who they are
-            negErrnoLocalOrSize = -U_SOCK_EIO;
-        }
-    }
-
-    return negErrnoLocalOrSize;
+    return negErrnoLocalOrNum;
 }
 
 /* ----------------------------------------------------------------
@@ -1533,120 +2590,29 @@ int32_t uCellSockWrite(uDeviceHandle_t cellHandle,
 {
     int32_t negErrnoLocalOrSize = -U_SOCK_EINVAL;
     uCellPrivateInstance_t *pInstance;
-    uAtClientHandle_t atHandle;
     uCellSockSocket_t *pSocket;
-    int32_t leftToSendSize = (int32_t) dataSizeBytes;
-    int32_t sentSize = 0;
-    int32_t dataOffset = 0;
-    int32_t thisSendSize = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
-    size_t x = 0;
-    bool written = true;
-    char *pHexBuffer = NULL;
 
     // Find the instance
     pInstance = pUCellPrivateGetInstance(cellHandle);
     if (pInstance != NULL) {
-        atHandle = pInstance->atHandle;
-        if (pInstance->socketsHexMode) {
-            thisSendSize /= 2;
-            negErrnoLocalOrSize = -U_SOCK_ENOMEM;
-            pHexBuffer = (char *)pUPortMalloc(thisSendSize * 2 + 1); // +1 for terminator
-        }
         // Find the entry
         if (sockHandle >= 0) {
             pSocket = pFindBySockHandle(sockHandle);
             if (pSocket != NULL) {
-                if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
-                    negErrnoLocalOrSize = U_SOCK_ENONE;
-                    x = 0;
-                    while ((leftToSendSize > 0) &&
-                           (negErrnoLocalOrSize == U_SOCK_ENONE) &&
-                           (x < U_CELL_SOCK_TCP_RETRY_LIMIT) &&
-                           written) {
-                        if (leftToSendSize < thisSendSize) {
-                            thisSendSize = leftToSendSize;
-                        }
-                        uAtClientLock(atHandle);
-                        uAtClientCommandStart(atHandle, "AT+USOWR=");
-                        // Write module socket handle
-                        uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
-                        // Number of bytes to follow
-                        uAtClientWriteInt(atHandle, (int32_t) thisSendSize);
-                        written = false;
-                        if (pHexBuffer) {
-                            // Make the hex-coded null terminated string
-                            uBinToHex((const char *) pData + dataOffset,
-                                      thisSendSize, pHexBuffer);
-                            pHexBuffer[thisSendSize * 2] = 0;
-                            // Send the hex mode data as a string
-                            //lint -e(679) Suppress suspicious truncation
-                            uAtClientWriteString(atHandle, pHexBuffer, true);
-                            uAtClientCommandStop(atHandle);
-                            written = true;
-                        } else {
-                            uAtClientCommandStop(atHandle);
-                            // Wait for the prompt
-                            if (uAtClientWaitCharacter(atHandle, '@') == 0) {
-                                // Wait for it...
-                                uPortTaskBlock(50);
-                                // Go!
-                                uAtClientWriteBytes(atHandle,
-                                                    (const char *) pData + dataOffset,
-                                                    thisSendSize, true);
-                                written = true;
-                            }
-                        }
-                        if (written) {
-                            // Grab the response
-                            uAtClientResponseStart(atHandle, "+USOWR:");
-                            // Skip the socket ID
-                            uAtClientSkipParameters(atHandle, 1);
-                            // Bytes sent
-                            sentSize = uAtClientReadInt(atHandle);
-                            uAtClientResponseStop(atHandle);
-                            // Note: the sentSize check below is because we have seen cases
-                            // where the module returns just "OK", missing out the "+USOWR: x"
-                            // response; what to do when this happens?  The AT unlock check
-                            // will pass because it has been sent an "OK", but has the data
-                            // been sent or was the OK for a previous "AT" and we have somehow
-                            // or other become unsynchronised with the module? Gonna assume
-                            // the worst, that the data has not been sent.
-                            if (sentSize < 0) {
-                                sentSize = 0;
-                            }
-                            if (uAtClientUnlock(atHandle) == 0) {
-                                dataOffset += sentSize;
-                                leftToSendSize -= sentSize;
-                                // Technically, it should be OK to
-                                // send fewer bytes than asked for,
-                                // however if this happens a lot we'll
-                                // get stuck, which isn't desirable,
-                                // so use the loop counter to avoid that
-                                if (sentSize < thisSendSize) {
-                                    x++;
-                                }
-                            } else {
-                                negErrnoLocalOrSize = -U_SOCK_EIO;
-                                // Got an AT interface error, see
-                                // what the module's socket error
-                                // number has to say for debug purposes
-                                doUsoer(atHandle);
-                            }
-                        } else {
-                            negErrnoLocalOrSize = -U_SOCK_EIO;
-                            uAtClientUnlock(atHandle);
-                        }
-                    }
+                if (pSocket->directLink) {
+                    // No AT commands required, just send the data
+                    negErrnoLocalOrSize = directLinkWrite(pSocket, pData, dataSizeBytes);
+                } else {
+#if U_CELL_SOCK_WRITE_COALESCE_BUFFER_SIZE_BYTES > 0
+                    negErrnoLocalOrSize = writeCoalesce(pInstance, pSocket,
+                                                        pData, dataSizeBytes);
+#else
+                    negErrnoLocalOrSize = writeModule(pInstance, pSocket,
+                                                      pData, dataSizeBytes);
+#endif
                 }
             }
         }
-        // Free the buffer
-        uPortFree(pHexBuffer);
-    }
-
-    if (negErrnoLocalOrSize == U_SOCK_ENONE) {
-        // All is good
-        negErrnoLocalOrSize = ((int32_t) dataSizeBytes) - leftToSendSize;
     }
 
     return negErrnoLocalOrSize;
@@ -1659,167 +2625,108 @@ int32_t uCellSockRead(uDeviceHandle_t cellHandle,
 {
     int32_t negErrnoLocalOrSize = -U_SOCK_EINVAL;
     uCellPrivateInstance_t *pInstance;
-    uAtClientHandle_t atHandle;
     uCellSockSocket_t *pSocket;
-    int32_t dataLengthMax = U_CELL_SOCK_MAX_SEGMENT_SIZE_BYTES;
-    int32_t x = -1;
-    int32_t thisWantedReceiveSize;
-    int32_t thisActualReceiveSize;
-    int32_t totalReceivedSize = 0;
-    int32_t readLength;
-    char *pHexBuffer = NULL;
 
     // Find the instance
     pInstance = pUCellPrivateGetInstance(cellHandle);
     if (pInstance != NULL) {
-        atHandle = pInstance->atHandle;
-        if (pInstance->socketsHexMode) {
-            dataLengthMax /= 2;
-        }
         // Find the entry
         if (sockHandle >= 0) {
             pSocket = pFindBySockHandle(sockHandle);
             if (pSocket != NULL) {
-                negErrnoLocalOrSize = -U_SOCK_EWOULDBLOCK;
-                if (pSocket->pendingBytes == 0) {
-                    // If the URC has not filled in pendingBytes,
-                    // ask the module directly if there is anything
-                    // to read
-                    uAtClientLock(atHandle);
-                    uAtClientCommandStart(atHandle, "AT+USORD=");
-                    uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
-                    // Zero bytes to read, just want to know the number
-                    // of bytes waiting
-                    uAtClientWriteInt(atHandle, 0);
-                    uAtClientCommandStop(atHandle);
-                    uAtClientResponseStart(atHandle, "+USORD:");
-                    // Skip the socket ID
-                    uAtClientSkipParameters(atHandle, 1);
-                    // Read the amount of data
-                    x = uAtClientReadInt(atHandle);
-                    uAtClientResponseStop(atHandle);
-                    // Update pending bytes here, before
-                    // unlocking, as otherwise a data callback
-                    // triggered by a URC could be sitting waiting
-                    // to grab the AT lock and jump in before
-                    // pending bytes has been updated, leading it
-                    // back into here again, etc, etc.
-                    if (x > 0) {
-                        pSocket->pendingBytes = x;
-                        // DON'T call the user data callback here:
-                        // we already have the AT interface locked
-                        // and a user might try to call back into
-                        // here which would result in deadlock.
-                        // They will get their received data, there
-                        // is no need to worry.
-                    }
-                    if ((uAtClientUnlock(atHandle) != 0) || (x < 0)) {
-                        // Looks like the socket has gone
-                        pSocket->pendingBytes = 0;
-                        negErrnoLocalOrSize = -U_SOCK_EIO;
-                    }
+                if (pSocket->directLink) {
+                    // No AT commands required, just take what is there
+                    negErrnoLocalOrSize = directLinkRead(pSocket, pData, dataSizeBytes);
+                } else {
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+                    negErrnoLocalOrSize = readAhead(pInstance, pSocket,
+                                                    (char *) pData, dataSizeBytes);
+#else
+                    negErrnoLocalOrSize = readModule(pInstance, pSocket,
+                                                     (char *) pData, dataSizeBytes,
+                                                     false);
+#endif
                 }
-                if (pSocket->pendingBytes > 0) {
-                    negErrnoLocalOrSize = U_SOCK_ENONE;
-                    // Run around the loop until we run out of
-                    // pending data or room in the buffer
-                    while ((dataSizeBytes > 0) &&
-                           (pSocket->pendingBytes > 0) &&
-                           (negErrnoLocalOrSize == U_SOCK_ENONE)) {
-                        thisWantedReceiveSize = dataLengthMax;
-                        if (thisWantedReceiveSize > (int32_t) dataSizeBytes) {
-                            thisWantedReceiveSize = (int32_t) dataSizeBytes;
-                        }
+            }
+        }
+    }
+
+    return negErrnoLocalOrSize;
+}
+
+// Receive bytes on several connected sockets in one go.
+int32_t uCellSockReadBatch(uDeviceHandle_t cellHandle,
+                           uCellSockReadBatch_t *pBatch,
+                           size_t numItems)
+{
+    int32_t negErrnoLocalOrSize = -U_SOCK_EINVAL;
+    uCellPrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+    uCellSockSocket_t *pSocket;
+    uCellSockReadBatch_t *pItem;
+    bool directLink = false;
+    bool atLocked = false;
+    size_t size;
+
+    // Find the instance
+    pInstance = pUCellPrivateGetInstance(cellHandle);
+    if ((pInstance != NULL) && ((pBatch != NULL) || (numItems == 0))) {
+        atHandle = pInstance->atHandle;
+        negErrnoLocalOrSize = 0;
+        // A socket in direct-link mode has the AT client locked
+        for (size_t x = 0; x < sizeof(gSockets) / sizeof(gSockets[0]); x++) {
+            if ((gSockets[x].sockHandle >= 0) && (gSockets[x].atHandle == atHandle) &&
+                gSockets[x].directLink) {
+                directLink = true;
+            }
+        }
+        for (size_t x = 0; x < numItems; x++) {
+            pItem = pBatch + x;
+            pItem->negErrnoOrSize = -U_SOCK_EINVAL;
+            pSocket = NULL;
+            if ((pItem->sockHandle >= 0) &&
+                ((pItem->pData != NULL) || (pItem->dataSizeBytes == 0))) {
+                pSocket = pFindBySockHandle(pItem->sockHandle);
+            }
+            if (pSocket != NULL) {
+                size = 0;
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+                // Anything already read ahead comes first
+                size = readAheadTake(pSocket, (char *) pItem->pData,
+                                     pItem->dataSizeBytes);
+#endif
+                pItem->negErrnoOrSize = -U_SOCK_EWOULDBLOCK;
+                if (pSocket->directLink) {
+                    pItem->negErrnoOrSize = directLinkRead(pSocket,
+                                                           (char *) pItem->pData + size,
+                                                           pItem->dataSizeBytes - size);
+                } else if (directLink) {
+                    pItem->negErrnoOrSize = -U_SOCK_EBUSY;
+                } else if ((pSocket->pendingBytes > 0) && (size < pItem->dataSizeBytes)) {
+                    if (!atLocked) {
+                        // Lock once for the lot
                         uAtClientLock(atHandle);
-                        uAtClientCommandStart(atHandle, "AT+USORD=");
-                        uAtClientWriteInt(atHandle, pSocket->sockHandleModule);
-                        // Number of bytes to read
-                        uAtClientWriteInt(atHandle, thisWantedReceiveSize);
-                        uAtClientCommandStop(atHandle);
-                        uAtClientResponseStart(atHandle, "+USORD:");
-                        // Skip the socket ID
-                        uAtClientSkipParameters(atHandle, 1);
-                        // Read the amount of data
-                        thisActualReceiveSize = uAtClientReadInt(atHandle);
-                        if (thisActualReceiveSize > (int32_t) dataSizeBytes) {
-                            thisActualReceiveSize = (int32_t) dataSizeBytes;
-                        }
-                        if (thisActualReceiveSize > 0) {
-                            if (pInstance->socketsHexMode) {
-                                // In hex mode we need a buffer to dump
-                                // the hex into and then we can decode it
-                                negErrnoLocalOrSize = -U_SOCK_ENOMEM;
-                                //lint -e{647} Suppress suspicious truncation
-                                pHexBuffer = (char *) pUPortMalloc(thisActualReceiveSize * 2 + 1);  // +1 for terminator
-                            }
-                            if (!pInstance->socketsHexMode || (pHexBuffer != NULL)) {
-                                negErrnoLocalOrSize = U_SOCK_ENONE;
-                                if (pHexBuffer != NULL) {
-                                    // In hex mode we can read in the whole string
-                                    //lint -e{647} Suppress suspicious truncation
-                                    readLength = uAtClientReadString(atHandle, pHexBuffer,
-                                                                     thisActualReceiveSize * 2 + 1,
-                                                                     false);
-                                    if (readLength > 0) {
-                                        x = ((int32_t) dataSizeBytes) * 2;
-                                        if (readLength > x) {
-                                            readLength = x;
-                                        }
-                                        uHexToBin(pHexBuffer, readLength,
-                                                  (char *) pData + totalReceivedSize);
-                                    }
-                                    // Free memory
-                                    uPortFree(pHexBuffer);
-                                } else {
-                                    // Binary mode, don't stop for anything!
-                                    uAtClientIgnoreStopTag(atHandle);
-                                    // Get the leading quote mark out of the way
-                                    uAtClientReadBytes(atHandle, NULL, 1, true);
-                                    // Now read out the available data
-                                    uAtClientReadBytes(atHandle,
-                                                       (char *) pData +
-                                                       totalReceivedSize,
-                                                       thisActualReceiveSize, true);
-                                    // Make sure we wait for the stop tag before
-                                    // going around again
-                                    uAtClientRestoreStopTag(atHandle);
-                                }
-                            }
-                        }
-                        uAtClientResponseStop(atHandle);
-                        // BEFORE unlocking, work out what's happened.
-                        // This is to prevent a URC being processed that
-                        // may indicate data left and over-write pendingBytes
-                        // while we're also writing to it.
-                        if ((uAtClientErrorGet(atHandle) == 0) &&
-                            (thisActualReceiveSize >= 0)) {
-                            // Must use what +USORD returns here as it may be less
-                            // or more than we asked for and also may be
-                            // more than pendingBytes, depending on how
-                            // the URCs landed
-                            // This update of pendingBytes will be overwritten
-                            // by the URC but we have to do something here
-                            // 'cos we don't get a URC to tell us when pendingBytes
-                            // has gone to zero.
-                            if (thisActualReceiveSize > pSocket->pendingBytes) {
-                                pSocket->pendingBytes = 0;
-                            } else {
-                                pSocket->pendingBytes -= thisActualReceiveSize;
-                            }
-                            totalReceivedSize += thisActualReceiveSize;
-                            dataSizeBytes -= thisActualReceiveSize;
-                        } else {
-                            negErrnoLocalOrSize = -U_SOCK_EIO;
-                        }
-                        uAtClientUnlock(atHandle);
+                        atLocked = true;
+                    }
+                    pItem->negErrnoOrSize = readModule(pInstance, pSocket,
+                                                       (char *) pItem->pData + size,
+                                                       pItem->dataSizeBytes - size,
+                                                       true);
+                }
+                if (size > 0) {
+                    if (pItem->negErrnoOrSize < 0) {
+                        pItem->negErrnoOrSize = 0;
                     }
+                    pItem->negErrnoOrSize += (int32_t) size;
                 }
             }
+            if (pItem->negErrnoOrSize > 0) {
+                negErrnoLocalOrSize += pItem->negErrnoOrSize;
+            }
+        }
+        if (atLocked) {
+            uAtClientUnlock(atHandle);
         }
-    }
-
-    if (totalReceivedSize > 0) {
-        negErrnoLocalOrSize = totalReceivedSize;
     }
 
     return negErrnoLocalOrSize;
@@ -1944,6 +2851,7 @@ int32_t uCellSockGetHostByName(uDeviceHandle_t cellHandle,
     char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
     uSockAddress_t address;
     int32_t startTimeMs;
+    int32_t wakeTimeMs;
 
     memset(&address, 0, sizeof(address));
     buffer[0] = 0;
@@ -1962,13 +2870,11 @@ int32_t uCellSockGetHostByName(uDeviceHandle_t cellHandle,
         while ((atError < 0) &&
                (uPortGetTickTimeMs() - startTimeMs <
                 U_CELL_SOCK_DNS_SHOULD_RETRY_MS)) {
-            if (pInstance->pModule->moduleType == U_CELL_MODULE_TYPE_SARA_R422) {
+            if (U_CELL_PRIVATE_MODULE_TYPE(pInstance) == U_CELL_MODULE_TYPE_SARA_R422) {
                 // SARA-R422 can get upset if UDNSRN is sent very quickly
                 // after a connection is made so we add a short delay here
-                while (uPortGetTickTimeMs() - pInstance->connectedAtMs <
-                       U_CELL_SOCK_SARA_R422_DNS_DELAY_MILLISECONDS) {
-                    uPortTaskBlock(100);
-                }
+                wakeTimeMs = pInstance->connectedAtMs;
+                uPortTaskBlockUntil(&wakeTimeMs, U_CELL_SOCK_SARA_R422_DNS_DELAY_MILLISECONDS);
             }
             atHandle = pInstance->atHandle;
 
@@ -2099,6 +3005,11 @@ int32_t uCellSockGetBytesPending(uDeviceHandle_t cellHandle,
             if (pSocket != NULL) {
                 // Return the value we have stored based on URCs
                 negErrnoLocalOrSize = pSocket->pendingBytes;
+#if U_CELL_SOCK_READ_AHEAD_BUFFER_SIZE_BYTES > 0
+                // ...plus whatever is in the read-ahead buffer
+                negErrnoLocalOrSize += (int32_t) (pSocket->readAheadLength -
+                                                  pSocket->readAheadIndex);
+#endif
             }
         }
     }
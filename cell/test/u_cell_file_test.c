@@ -100,6 +100,32 @@
  */
 #define U_CELL_FILE_TEST_REENTRANT_STRING_SIZE 9
 
+/** The name of the file to use when testing the cache.
+ */
+#define U_CELL_FILE_TEST_CACHE_FILE_NAME "cache"
+
+/** The name of the file to use when testing streaming.
+ */
+#define U_CELL_FILE_TEST_STREAM_FILE_NAME "stream"
+
+#ifndef U_CELL_FILE_TEST_STREAM_SIZE_BYTES
+/** The amount of data to stream to and from a file when testing
+ * and measuring throughput.
+ */
+# define U_CELL_FILE_TEST_STREAM_SIZE_BYTES (1024 * 32)
+#endif
+
+#ifndef U_CELL_FILE_TEST_STREAM_BUFFER_SIZE_BYTES
+/** The size of buffer to give to the stream.
+ */
+# define U_CELL_FILE_TEST_STREAM_BUFFER_SIZE_BYTES 4096
+#endif
+
+/** The size of each of the small reads and writes that the
+ * caller makes to the stream.
+ */
+#define U_CELL_FILE_TEST_STREAM_PIECE_SIZE_BYTES 100
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -143,6 +169,25 @@ static bool checkTracker(bool *pTracker, size_t size)
     return isGood;
 }
 
+// Return true if the given file is in the file listing, using
+// pBuffer (which must be at least U_CELL_FILE_NAME_MAX_LENGTH + 1
+// bytes big) as storage.
+static bool isListed(uDeviceHandle_t cellHandle, const char *pFileName,
+                     char *pBuffer)
+{
+    bool found = false;
+
+    for (int32_t x = uCellFileListFirst(cellHandle, pBuffer);
+         x >= 0;
+         x = uCellFileListNext(cellHandle, pBuffer)) {
+        if (strcmp(pBuffer, pFileName) == 0) {
+            found = true;
+        }
+    }
+
+    return found;
+}
+
 /* ----------------------------------------------------------------
 * PUBLIC FUNCTIONS
 * -------------------------------------------------------------- */
@@ -582,6 +627,189 @@ U_PORT_TEST_FUNCTION("[cellFile]", "cellFileListAllReentrant")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Test the file system cache.
+ */
+U_PORT_TEST_FUNCTION("[cellFile]", "cellFileCache")
+{
+    int32_t resourceCount;
+    uDeviceHandle_t cellHandle;
+    char *pFileName;
+    int32_t startTimeMs;
+
+    pFileName = (char *) pUPortMalloc(U_CELL_FILE_NAME_MAX_LENGTH + 1);
+    U_PORT_TEST_ASSERT(pFileName != NULL);
+
+    // In case a previous test failed
+    uCellTestPrivateCleanup(&gHandles);
+
+    // Obtain the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Do the standard preamble
+    U_PORT_TEST_ASSERT(uCellTestPrivatePreamble(U_CFG_TEST_CELL_MODULE_TYPE,
+                                                &gHandles, true) == 0);
+    cellHandle = gHandles.cellHandle;
+
+    // Make sure our file isn't there to begin with
+    uCellFileDelete(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME);
+
+    U_PORT_TEST_ASSERT(uCellFileSetCacheOn(cellHandle) == 0);
+    // Should be able to do it again
+    U_PORT_TEST_ASSERT(uCellFileSetCacheOn(cellHandle) == 0);
+
+    // The first listing populates the cache (provided there's at
+    // least one file on the module, which there will be after this)
+    U_PORT_TEST_ASSERT(uCellFileWrite(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME,
+                                      "some", 4) == 4);
+    startTimeMs = uPortGetTickTimeMs();
+    U_PORT_TEST_ASSERT(isListed(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME, pFileName));
+    U_TEST_PRINT_LINE("listing from the module took %d ms.",
+                      uPortGetTickTimeMs() - startTimeMs);
+    startTimeMs = uPortGetTickTimeMs();
+    U_PORT_TEST_ASSERT(isListed(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME, pFileName));
+    U_TEST_PRINT_LINE("listing from the cache took %d ms.",
+                      uPortGetTickTimeMs() - startTimeMs);
+
+    // Size should follow our writes
+    U_PORT_TEST_ASSERT(uCellFileSize(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) == 4);
+    U_PORT_TEST_ASSERT(uCellFileWrite(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME,
+                                      " text", 5) == 5);
+    U_PORT_TEST_ASSERT(uCellFileSize(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) == 9);
+
+    // Delete should remove it from the listing
+    U_PORT_TEST_ASSERT(uCellFileDelete(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) == 0);
+    U_PORT_TEST_ASSERT(!isListed(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME, pFileName));
+    U_PORT_TEST_ASSERT(uCellFileSize(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) < 0);
+
+    // Re-create it and check that the cache and the module agree
+    U_PORT_TEST_ASSERT(uCellFileWrite(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME,
+                                      "again", 5) == 5);
+    U_PORT_TEST_ASSERT(isListed(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME, pFileName));
+    U_PORT_TEST_ASSERT(uCellFileSize(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) == 5);
+    uCellFileSetCacheOff(cellHandle);
+    U_PORT_TEST_ASSERT(isListed(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME, pFileName));
+    U_PORT_TEST_ASSERT(uCellFileSize(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) == 5);
+
+    U_PORT_TEST_ASSERT(uCellFileDelete(cellHandle, U_CELL_FILE_TEST_CACHE_FILE_NAME) == 0);
+    uPortFree(pFileName);
+
+    // Do the standard postamble, leaving the module on for the next
+    // test to speed things up
+    uCellTestPrivatePostamble(&gHandles, false);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test streaming to and from a file, measuring throughput.
+ */
+U_PORT_TEST_FUNCTION("[cellFile]", "cellFileStream")
+{
+    int32_t resourceCount;
+    uDeviceHandle_t cellHandle;
+    uCellFileStream_t stream;
+    char *pBuffer;
+    char piece[U_CELL_FILE_TEST_STREAM_PIECE_SIZE_BYTES];
+    size_t offset = 0;
+    size_t thisSize;
+    int32_t x;
+    int32_t startTimeMs;
+    int32_t durationMs;
+
+    // In case a previous test failed
+    uCellTestPrivateCleanup(&gHandles);
+
+    // Obtain the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Do the standard preamble
+    U_PORT_TEST_ASSERT(uCellTestPrivatePreamble(U_CFG_TEST_CELL_MODULE_TYPE,
+                                                &gHandles, true) == 0);
+    cellHandle = gHandles.cellHandle;
+
+    pBuffer = (char *) pUPortMalloc(U_CELL_FILE_TEST_STREAM_BUFFER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+
+    // Check parameters
+    U_PORT_TEST_ASSERT(uCellFileStreamOpen(cellHandle, NULL, true, pBuffer,
+                                           U_CELL_FILE_TEST_STREAM_BUFFER_SIZE_BYTES,
+                                           &stream) < 0);
+    U_PORT_TEST_ASSERT(uCellFileStreamOpen(cellHandle, U_CELL_FILE_TEST_STREAM_FILE_NAME,
+                                           true, NULL, 0, &stream) < 0);
+
+    // Write the file in small pieces, the stream gathering
+    // them into buffer-sized transfers
+    U_TEST_PRINT_LINE("streaming %d byte(s) to file in %d byte pieces...",
+                      U_CELL_FILE_TEST_STREAM_SIZE_BYTES,
+                      U_CELL_FILE_TEST_STREAM_PIECE_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(uCellFileStreamOpen(cellHandle, U_CELL_FILE_TEST_STREAM_FILE_NAME,
+                                           true, pBuffer,
+                                           U_CELL_FILE_TEST_STREAM_BUFFER_SIZE_BYTES,
+                                           &stream) == 0);
+    // Can't read from a write stream
+    U_PORT_TEST_ASSERT(uCellFileStreamRead(&stream, piece, sizeof(piece)) < 0);
+    startTimeMs = uPortGetTickTimeMs();
+    while (offset < U_CELL_FILE_TEST_STREAM_SIZE_BYTES) {
+        thisSize = sizeof(piece);
+        if (thisSize > U_CELL_FILE_TEST_STREAM_SIZE_BYTES - offset) {
+            thisSize = U_CELL_FILE_TEST_STREAM_SIZE_BYTES - offset;
+        }
+        for (size_t y = 0; y < thisSize; y++) {
+            piece[y] = (char) (offset + y);
+        }
+        U_PORT_TEST_ASSERT(uCellFileStreamWrite(&stream, piece, thisSize) == (int32_t) thisSize);
+        offset += thisSize;
+    }
+    U_PORT_TEST_ASSERT(uCellFileStreamClose(&stream) == 0);
+    durationMs = uPortGetTickTimeMs() - startTimeMs;
+    U_TEST_PRINT_LINE("write took %d ms (%d bytes/second).", durationMs,
+                      durationMs > 0 ? (U_CELL_FILE_TEST_STREAM_SIZE_BYTES * 1000) / durationMs : 0);
+    U_PORT_TEST_ASSERT(uCellFileSize(cellHandle,
+                                     U_CELL_FILE_TEST_STREAM_FILE_NAME) == U_CELL_FILE_TEST_STREAM_SIZE_BYTES);
+
+    // Read it back in small pieces and check it
+    U_TEST_PRINT_LINE("streaming %d byte(s) back from file in %d byte pieces...",
+                      U_CELL_FILE_TEST_STREAM_SIZE_BYTES,
+                      U_CELL_FILE_TEST_STREAM_PIECE_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(uCellFileStreamOpen(cellHandle, U_CELL_FILE_TEST_STREAM_FILE_NAME,
+                                           false, pBuffer,
+                                           U_CELL_FILE_TEST_STREAM_BUFFER_SIZE_BYTES,
+                                           &stream) == 0);
+    // Can't write to a read stream
+    U_PORT_TEST_ASSERT(uCellFileStreamWrite(&stream, piece, sizeof(piece)) < 0);
+    offset = 0;
+    startTimeMs = uPortGetTickTimeMs();
+    do {
+        x = uCellFileStreamRead(&stream, piece, sizeof(piece));
+        U_PORT_TEST_ASSERT(x >= 0);
+        for (int32_t y = 0; y < x; y++) {
+            U_PORT_TEST_ASSERT(piece[y] == (char) (offset + y));
+        }
+        offset += (size_t) x;
+    } while (x > 0);
+    durationMs = uPortGetTickTimeMs() - startTimeMs;
+    U_PORT_TEST_ASSERT(uCellFileStreamClose(&stream) == 0);
+    U_TEST_PRINT_LINE("read took %d ms (%d bytes/second).", durationMs,
+                      durationMs > 0 ? (U_CELL_FILE_TEST_STREAM_SIZE_BYTES * 1000) / durationMs : 0);
+    U_PORT_TEST_ASSERT(offset == U_CELL_FILE_TEST_STREAM_SIZE_BYTES);
+
+    U_PORT_TEST_ASSERT(uCellFileDelete(cellHandle, U_CELL_FILE_TEST_STREAM_FILE_NAME) == 0);
+    uPortFree(pBuffer);
+
+    // Do the standard postamble, leaving the module on for the next
+    // test to speed things up
+    uCellTestPrivatePostamble(&gHandles, false);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Test deleting file.
  */
 U_PORT_TEST_FUNCTION("[cellFile]", "cellFileDelete")
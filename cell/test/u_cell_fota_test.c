@@ -38,6 +38,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memset()
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -120,6 +121,7 @@ U_PORT_TEST_FUNCTION("[cellFota]", "cellFotaVeryBasicIndeed")
     uDeviceHandle_t cellHandle;
     const uCellPrivateModule_t *pModule;
     int32_t resourceCount;
+    uCellFotaProgress_t progress;
     int32_t x;
 
     // In case a previous test failed
@@ -149,6 +151,32 @@ U_PORT_TEST_FUNCTION("[cellFota]", "cellFotaVeryBasicIndeed")
             U_PORT_TEST_ASSERT(x == 0);
             x = uCellFotaSetStatusCallback(cellHandle, -1, NULL, NULL);
             U_PORT_TEST_ASSERT(x == 0);
+
+            U_TEST_PRINT_LINE("checking that FOTA progress can be resumed.");
+            memset(&progress, 0, sizeof(progress));
+            progress.imageSizeBytes = 1000;
+            progress.percentage = 50;
+            progress.sessionCount = 2;
+            progress.bytesPerSecond = 1;
+            progress.etaSeconds = 1;
+            U_PORT_TEST_ASSERT(uCellFotaSetProgress(cellHandle, &progress) == 0);
+            memset(&progress, 0xff, sizeof(progress));
+            U_PORT_TEST_ASSERT(uCellFotaGetProgress(cellHandle, &progress) == 0);
+            U_PORT_TEST_ASSERT(progress.imageSizeBytes == 1000);
+            U_PORT_TEST_ASSERT(progress.bytesReceived == 500);
+            U_PORT_TEST_ASSERT(progress.percentage == 50);
+            U_PORT_TEST_ASSERT(progress.sessionCount == 2);
+            // These are always recalculated
+            U_PORT_TEST_ASSERT(progress.bytesPerSecond == -1);
+            U_PORT_TEST_ASSERT(progress.etaSeconds == -1);
+            progress.percentage = 101;
+            U_PORT_TEST_ASSERT(uCellFotaSetProgress(cellHandle, &progress) < 0);
+            U_PORT_TEST_ASSERT(uCellFotaSetProgress(cellHandle, NULL) == 0);
+            U_PORT_TEST_ASSERT(uCellFotaGetProgress(cellHandle, &progress) == 0);
+            U_PORT_TEST_ASSERT(progress.imageSizeBytes == -1);
+            U_PORT_TEST_ASSERT(progress.bytesReceived == -1);
+            U_PORT_TEST_ASSERT(progress.percentage == 0);
+            U_PORT_TEST_ASSERT(progress.sessionCount == 0);
         } else {
             U_PORT_TEST_ASSERT(x == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
         }
@@ -440,6 +440,10 @@ U_PORT_TEST_FUNCTION("[cellHttp]", "cellHttp")
                                callback, (void *) &gCallbackData);
     U_PORT_TEST_ASSERT(httpHandle >= 0);
     U_PORT_TEST_ASSERT(!uCellHttpIsSecured(cellHandle, httpHandle, NULL));
+    // Switching security off when it is already off should
+    // succeed without disturbing the profile
+    U_PORT_TEST_ASSERT(uCellHttpSetSecurityOff(cellHandle, httpHandle) == 0);
+    U_PORT_TEST_ASSERT(!uCellHttpIsSecured(cellHandle, httpHandle, NULL));
 
     // Note: we don't test with HTTPS here, that's done when the
     // code is tested from the common HTTP Client level.
@@ -108,6 +108,10 @@ static int64_t gStopTimeMs;
  */
 static uCellTestPrivate_t gHandles = U_CELL_TEST_PRIVATE_DEFAULTS;
 
+/** Count of calls to radioParametersCallback().
+ */
+static volatile int32_t gRadioParametersCallbackCount = 0;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -126,6 +130,19 @@ static bool keepGoingCallback(uDeviceHandle_t unused)
     return keepGoing;
 }
 
+// Callback for changes in the radio parameters.
+static void radioParametersCallback(uDeviceHandle_t cellHandle,
+                                    int32_t rssiDbm, int32_t rsrpDbm,
+                                    int32_t rsrqDb, void *pParameter)
+{
+    (void) cellHandle;
+    (void) pParameter;
+
+    U_TEST_PRINT_LINE("radio parameters: RSSI %d dBm, RSRP %d dBm, RSRQ %d dB.",
+                      rssiDbm, rsrpDbm, rsrqDb);
+    gRadioParametersCallbackCount++;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -142,6 +159,9 @@ U_PORT_TEST_FUNCTION("[cellInfo]", "cellInfoImeiEtc")
     char buffer[64];
     int32_t bytesRead;
     int32_t resourceCount;
+    uCellInfoIdentity_t identity;
+    uCellInfoCapabilities_t capabilities;
+    uCellInfoCapabilities_t capabilitiesRestored;
 #if defined(U_CFG_APP_PIN_CELL_RTS_GET) || defined(U_CFG_APP_PIN_CELL_CTS_GET)
     bool isEnabled;
 #endif
@@ -235,6 +255,39 @@ U_PORT_TEST_FUNCTION("[cellInfo]", "cellInfoImeiEtc")
                                             sizeof(buffer)) >= 0);
     U_PORT_TEST_ASSERT(strlen(buffer) <= U_CELL_INFO_ICCID_BUFFER_SIZE);
 
+    U_TEST_PRINT_LINE("getting and restoring an identity snapshot...");
+    memset(&identity, 0, sizeof(identity));
+    U_PORT_TEST_ASSERT(uCellInfoGetIdentity(cellHandle, &identity) == 0);
+    U_PORT_TEST_ASSERT(strlen(identity.imei) == U_CELL_INFO_IMEI_SIZE);
+    U_PORT_TEST_ASSERT(strlen(identity.model) > 0);
+    U_PORT_TEST_ASSERT(uCellInfoSetIdentity(cellHandle, NULL) == 0);
+    // A corrupted snapshot should be rejected
+    identity.firmwareVersion[0]++;
+    U_PORT_TEST_ASSERT(uCellInfoSetIdentity(cellHandle, &identity) < 0);
+    identity.firmwareVersion[0]--;
+    U_PORT_TEST_ASSERT(uCellInfoSetIdentity(cellHandle, &identity) == 0);
+    // The getters should now return the snapshot
+    memset(buffer, 0, sizeof(buffer));
+    bytesRead = uCellInfoGetModelStr(cellHandle, buffer, sizeof(buffer));
+    U_PORT_TEST_ASSERT((bytesRead == strlen(identity.model)) &&
+                       (strcmp(buffer, identity.model) == 0));
+    memset(buffer, 0, sizeof(buffer));
+    U_PORT_TEST_ASSERT(uCellInfoGetImei(cellHandle, buffer) == 0);
+    U_PORT_TEST_ASSERT(strcmp(buffer, identity.imei) == 0);
+    U_PORT_TEST_ASSERT(uCellInfoSetIdentity(cellHandle, NULL) == 0);
+
+    U_TEST_PRINT_LINE("getting and restoring a capabilities snapshot...");
+    U_PORT_TEST_ASSERT(uCellInfoGetCapabilities(cellHandle, &capabilities) == 0);
+    U_PORT_TEST_ASSERT(uCellInfoSetCapabilities(cellHandle, NULL) == 0);
+    // A corrupted snapshot should be rejected
+    capabilities.supportedBitmap++;
+    U_PORT_TEST_ASSERT(uCellInfoSetCapabilities(cellHandle, &capabilities) < 0);
+    capabilities.supportedBitmap--;
+    U_PORT_TEST_ASSERT(uCellInfoSetCapabilities(cellHandle, &capabilities) == 0);
+    U_PORT_TEST_ASSERT(uCellInfoGetCapabilities(cellHandle, &capabilitiesRestored) == 0);
+    U_PORT_TEST_ASSERT(memcmp(&capabilitiesRestored, &capabilities,
+                              sizeof(capabilities)) == 0);
+
 #ifdef U_CFG_APP_PIN_CELL_RTS_GET
     U_TEST_PRINT_LINE("checking RTS...");
     isEnabled = uCellInfoIsRtsFlowControlEnabled(cellHandle);
@@ -360,6 +413,20 @@ U_PORT_TEST_FUNCTION("[cellInfo]", "cellInfoRadioParameters")
                            (x == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED));
     }
 
+    U_TEST_PRINT_LINE("checking radio parameter change notifications...");
+    gRadioParametersCallbackCount = 0;
+    U_PORT_TEST_ASSERT(uCellInfoSetRadioParametersCallback(cellHandle, -1,
+                                                           radioParametersCallback,
+                                                           NULL) < 0);
+    U_PORT_TEST_ASSERT(uCellInfoSetRadioParametersCallback(cellHandle, 3,
+                                                           radioParametersCallback,
+                                                           NULL) == 0);
+    uPortTaskBlock(10000);
+    U_TEST_PRINT_LINE("%d radio parameter notification(s) received.",
+                      gRadioParametersCallbackCount);
+    U_PORT_TEST_ASSERT(uCellInfoSetRadioParametersCallback(cellHandle, 0,
+                                                           NULL, NULL) == 0);
+
     // Disconnect
     U_PORT_TEST_ASSERT(uCellNetDisconnect(cellHandle, NULL) == 0);
 
@@ -426,6 +493,20 @@ U_PORT_TEST_FUNCTION("[cellInfo]", "cellInfoTime")
     U_PORT_TEST_ASSERT((timeLocal - timeZoneOffsetSeconds) - timeUtc <
                        U_CELL_INFO_TEST_TIME_MARGIN_SECONDS);
 
+    U_TEST_PRINT_LINE("switching on the RAM time service...");
+    U_PORT_TEST_ASSERT(uCellInfoSetTimeCache(cellHandle, -1) < 0);
+    U_PORT_TEST_ASSERT(uCellInfoSetTimeCache(cellHandle, 3600) == 0);
+    timeUtc = uCellInfoGetTimeUtc(cellHandle);
+    U_PORT_TEST_ASSERT(timeUtc > U_CELL_INFO_TEST_MIN_TIME);
+    uPortTaskBlock(2000);
+    // This should now come from RAM and have advanced
+    x = uCellInfoGetTimeUtc(cellHandle);
+    U_TEST_PRINT_LINE("UTC time from RAM is %d.", (int32_t) x);
+    U_PORT_TEST_ASSERT((x > timeUtc) && (x - timeUtc < U_CELL_INFO_TEST_TIME_MARGIN_SECONDS));
+    x = uCellInfoGetTime(cellHandle, &timeZoneOffsetSeconds);
+    U_PORT_TEST_ASSERT(x - timeZoneOffsetSeconds >= timeUtc);
+    U_PORT_TEST_ASSERT(uCellInfoSetTimeCache(cellHandle, 0) == 0);
+
     // Disconnect
     U_PORT_TEST_ASSERT(uCellNetDisconnect(cellHandle, NULL) == 0);
     uPortTaskBlock(1000);
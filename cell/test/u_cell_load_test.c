@@ -0,0 +1,703 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief A load test: a number of emulated modules, each with its
+ * own UART, AT client and cellular or GNSS instance, are driven
+ * concurrently, one task per module, with a socket, MQTT or GNSS
+ * workload; the aggregate throughput and the per-module latency
+ * percentiles are printed, the latter as a line of JSON, so that
+ * the effect of the global locks in ubxlib (the socket container
+ * mutex, the cellular and GNSS API mutexes) on a host that drives
+ * many modules can be seen.  Since it relies on the module emulator,
+ * this test is only compiled on Linux and not when the driver has
+ * been restricted to a single cellular or GNSS module type.
+ * IMPORTANT: see notes in u_cfg_test_platform_specific.h for the
+ * naming rules that must be followed when using the
+ * U_PORT_TEST_FUNCTION() macro.
+ */
+
+#if defined(__linux__) && !defined(U_CFG_CELL_MODULE_TYPE_ONLY) && \
+    !defined(U_CFG_GNSS_MODULE_TYPE_ONLY)
+
+# ifdef U_CFG_OVERRIDE
+#  include "u_cfg_override.h" // For a customer's configuration override
+# endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "stdlib.h"    // qsort()
+#include "string.h"    // memset(), memcmp(), strlen()
+#include "stdio.h"     // snprintf()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port_clib_platform_specific.h" /* Integer stdio, must be included
+                                              before the other port files if
+                                              any print or scan function is used. */
+#include "u_port.h"
+#include "u_port_os.h"   // Required by u_cell_private.h
+#include "u_port_heap.h"
+#include "u_port_debug.h"
+#include "u_port_uart.h"
+#include "u_port_module_emulator.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_hex_bin_convert.h"
+
+#include "u_at_client.h"
+
+#include "u_ubx_protocol.h"
+
+#include "u_device.h"
+
+#include "u_sock.h"
+
+#include "u_cell_module_type.h"
+#include "u_cell.h"
+#include "u_cell_net.h"     // Required by u_cell_private.h
+#include "u_cell_private.h" // So that we can get at some innards
+#include "u_cell_sock.h"
+#include "u_cell_mqtt.h"
+
+#include "u_gnss_module_type.h"
+#include "u_gnss_type.h"
+#include "u_gnss.h"
+#include "u_gnss_pos.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_CELL_LOAD_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_CELL_LOAD_TEST_NUM_DEVICES
+/** The number of emulated modules to drive at once; the workloads
+ * are allocated socket, MQTT, GNSS, socket, etc.
+ */
+# define U_CELL_LOAD_TEST_NUM_DEVICES 4
+#endif
+
+#if U_CELL_LOAD_TEST_NUM_DEVICES > U_PORT_MODULE_EMULATOR_MAX_NUM
+# error U_CELL_LOAD_TEST_NUM_DEVICES cannot be larger than U_PORT_MODULE_EMULATOR_MAX_NUM.
+#endif
+
+#if U_CELL_LOAD_TEST_NUM_DEVICES > U_AT_CLIENT_MAX_NUM
+# error U_CELL_LOAD_TEST_NUM_DEVICES cannot be larger than U_AT_CLIENT_MAX_NUM.
+#endif
+
+#ifndef U_CELL_LOAD_TEST_NUM_OPERATIONS
+/** The number of operations each module performs: a socket write
+ * and read-back, an MQTT publish or a GNSS position request.
+ */
+# define U_CELL_LOAD_TEST_NUM_OPERATIONS 50
+#endif
+
+#ifndef U_CELL_LOAD_TEST_BAUD_RATE
+/** The baud rate at which the emulated modules pace their output.
+ */
+# define U_CELL_LOAD_TEST_BAUD_RATE 115200
+#endif
+
+#ifndef U_CELL_LOAD_TEST_TASK_STACK_SIZE_BYTES
+/** The stack size of each load task.
+ */
+# define U_CELL_LOAD_TEST_TASK_STACK_SIZE_BYTES (1024 * 8)
+#endif
+
+#ifndef U_CELL_LOAD_TEST_TIMEOUT_SECONDS
+/** How long to wait for all of the load tasks to finish.
+ */
+# define U_CELL_LOAD_TEST_TIMEOUT_SECONDS 120
+#endif
+
+#ifndef U_CELL_LOAD_TEST_PUBLISH_TIMEOUT_MS
+/** How long to wait for an MQTT publish to complete.
+ */
+# define U_CELL_LOAD_TEST_PUBLISH_TIMEOUT_MS 10000
+#endif
+
+/** The size of the data written to and read back from a socket
+ * in each operation; must match gSockData and the socket rules.
+ */
+#define U_CELL_LOAD_TEST_SOCK_DATA_LENGTH_BYTES 32
+
+/** The size of the body of a UBX-NAV-PVT message.
+ */
+#define U_CELL_LOAD_TEST_NAV_PVT_BODY_LENGTH_BYTES 92
+
+/** The latitude reported by the emulated GNSS modules.
+ */
+#define U_CELL_LOAD_TEST_LATITUDE_X1E7 521234567
+
+/** The longitude reported by the emulated GNSS modules.
+ */
+#define U_CELL_LOAD_TEST_LONGITUDE_X1E7 -12345678
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** The workloads.
+ */
+typedef enum {
+    U_CELL_LOAD_TEST_WORKLOAD_SOCK,
+    U_CELL_LOAD_TEST_WORKLOAD_MQTT,
+    U_CELL_LOAD_TEST_WORKLOAD_GNSS,
+    U_CELL_LOAD_TEST_WORKLOAD_MAX_NUM
+} uCellLoadTestWorkload_t;
+
+/** Everything to do with one emulated module.
+ */
+typedef struct {
+    uCellLoadTestWorkload_t workload;
+    uPortModuleEmulatorCfg_t emulatorCfg;
+    int32_t emulatorHandle;
+    char deviceName[U_PORT_MODULE_EMULATOR_DEVICE_NAME_MAX_LENGTH_BYTES];
+    int32_t uartHandle;
+    uAtClientHandle_t atClientHandle;
+    uDeviceHandle_t devHandle;
+    uSockDescriptor_t sock;
+    uPortTaskHandle_t taskHandle;
+    volatile bool done;
+    int32_t errorCount;
+    size_t numOperations;
+    int32_t latencyUs[U_CELL_LOAD_TEST_NUM_OPERATIONS];
+    volatile int32_t publishCount;   /**< the number of publish callbacks. */
+    volatile int32_t publishErrorCode;
+    volatile int64_t publishDoneUs;
+    uPortModuleEmulatorStats_t statsStart;
+} uCellLoadTestDevice_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The names of the workloads, for printing.
+ */
+static const char *const gpWorkloadStr[] = {"sock", "mqtt", "gnss"};
+
+/** The emulated modules.
+ */
+static uCellLoadTestDevice_t gDevice[U_CELL_LOAD_TEST_NUM_DEVICES];
+
+/** Set to true to start all of the load tasks at once.
+ */
+static volatile bool gGo = false;
+
+/** The data written to a socket; the emulator echoes it back.
+ */
+static const char gSockData[U_CELL_LOAD_TEST_SOCK_DATA_LENGTH_BYTES] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b,
+    0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+    0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+
+/** The script of a module handling a hex-mode TCP socket.
+ */
+static const uPortModuleEmulatorRule_t gSockRules[] = {
+    {"AT+USOCR=", "\r\n+USOCR: 0\r\n\r\nOK\r\n", 0, NULL, 0},
+    {"AT+USOWR=", "\r\n+USOWR: 0,32\r\n\r\nOK\r\n", 0, "\r\n+UUSORD: 0,32\r\n", 0},
+    {
+        "AT+USORD=", "\r\n+USORD: 0,32,\"000102030405060708090A0B0C0D0E0F"
+        "101112131415161718191A1B1C1D1E1F\"\r\n\r\nOK\r\n", 0, NULL, 0
+    }
+};
+
+/** The script of a module handling MQTT.
+ */
+static const uPortModuleEmulatorRule_t gMqttRules[] = {
+    {"AT+UMQTTC=0", "\r\nOK\r\n", 0, "\r\n+UUMQTTC: 0,1\r\n", 0},
+    {"AT+UMQTTC=1", "\r\nOK\r\n", 0, "\r\n+UUMQTTC: 1,1\r\n", 0},
+    {"AT+UMQTTC=2", "\r\nOK\r\n", 0, "\r\n+UUMQTTC: 2,1\r\n", 0}
+};
+
+/** The script of a module handling GNSS over AT: the response,
+ * which contains a UBX-NAV-PVT message, is filled in at run-time.
+ */
+static uPortModuleEmulatorRule_t gGnssRules[] = {
+    {"AT+UGUBX=", NULL, 0, NULL, 0}
+};
+
+/** Storage for the response in gGnssRules: the hex-encoded
+ * UBX-NAV-PVT message plus the AT command and OK.
+ */
+static char gGnssResponse[((U_CELL_LOAD_TEST_NAV_PVT_BODY_LENGTH_BYTES +
+                            U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) * 2) + 32];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Compare two int32_t's, for qsort().
+static int compareInt32(const void *pA, const void *pB)
+{
+    int32_t a = *((const int32_t *) pA);
+    int32_t b = *((const int32_t *) pB);
+
+    return (a > b) - (a < b);
+}
+
+// Return the given percentile of a sorted array.
+static int32_t percentile(const int32_t *pSorted, size_t numEntries,
+                          int32_t percent)
+{
+    size_t x = 0;
+
+    if (numEntries > 0) {
+        x = (numEntries * percent) / 100;
+        if (x >= numEntries) {
+            x = numEntries - 1;
+        }
+    }
+
+    return (numEntries > 0) ? pSorted[x] : 0;
+}
+
+// Fill in the response of gGnssRules with a UBX-NAV-PVT message
+// carrying a 3D fix.
+static void gnssResponseCreate()
+{
+    char body[U_CELL_LOAD_TEST_NAV_PVT_BODY_LENGTH_BYTES] = {0};
+    char message[U_CELL_LOAD_TEST_NAV_PVT_BODY_LENGTH_BYTES +
+                 U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES];
+    uint16_t uint16;
+    uint32_t uint32;
+    int32_t sizeBytes;
+    size_t x;
+
+    // Year 2023, month, day, hour, minute, second
+    uint16 = uUbxProtocolUint16Encode(2023);
+    memcpy(body + 4, &uint16, sizeof(uint16));
+    body[6] = 6;
+    body[7] = 15;
+    body[8] = 12;
+    body[9] = 30;
+    body[10] = 0;
+    // Date and time valid
+    body[11] = 0x03;
+    // 3D fix, gnssFixOK, number of satellites
+    body[20] = 0x03;
+    body[21] = 0x01;
+    body[23] = 12;
+    // Longitude, latitude, height above MSL and horizontal
+    // accuracy, all little-endian
+    uint32 = uUbxProtocolUint32Encode((uint32_t) U_CELL_LOAD_TEST_LONGITUDE_X1E7);
+    memcpy(body + 24, &uint32, sizeof(uint32));
+    uint32 = uUbxProtocolUint32Encode((uint32_t) U_CELL_LOAD_TEST_LATITUDE_X1E7);
+    memcpy(body + 28, &uint32, sizeof(uint32));
+    uint32 = uUbxProtocolUint32Encode(10000);
+    memcpy(body + 36, &uint32, sizeof(uint32));
+    uint32 = uUbxProtocolUint32Encode(5000);
+    memcpy(body + 40, &uint32, sizeof(uint32));
+    sizeBytes = uUbxProtocolEncode(0x01, 0x07, body, sizeof(body), message);
+    x = snprintf(gGnssResponse, sizeof(gGnssResponse), "\r\n+UGUBX: \"");
+    if (sizeBytes > 0) {
+        x += uBinToHex(message, sizeBytes, gGnssResponse + x);
+    }
+    snprintf(gGnssResponse + x, sizeof(gGnssResponse) - x, "\"\r\n\r\nOK\r\n");
+    gGnssRules[0].pResponse = gGnssResponse;
+}
+
+// Callback for an asynchronous MQTT publish completing.
+static void publishCallback(int32_t messageId, int32_t errorCode,
+                            void *pParam)
+{
+    uCellLoadTestDevice_t *pDevice = (uCellLoadTestDevice_t *) pParam;
+
+    (void) messageId;
+
+    pDevice->publishDoneUs = uPortGetTickTimeUs();
+    pDevice->publishErrorCode = errorCode;
+    pDevice->publishCount++;
+}
+
+// Perform one socket operation: write some data and read the
+// echo back.
+static bool sockOperation(uCellLoadTestDevice_t *pDevice)
+{
+    char buffer[U_CELL_LOAD_TEST_SOCK_DATA_LENGTH_BYTES];
+
+    return (uSockWrite(pDevice->sock, gSockData,
+                       sizeof(gSockData)) == sizeof(gSockData)) &&
+           (uSockRead(pDevice->sock, buffer, sizeof(buffer)) == sizeof(buffer)) &&
+           (memcmp(buffer, gSockData, sizeof(buffer)) == 0);
+}
+
+// Perform one MQTT operation: an asynchronous publish, waiting
+// for it to complete.
+static bool mqttOperation(uCellLoadTestDevice_t *pDevice)
+{
+    bool success = false;
+    int32_t publishCount = pDevice->publishCount;
+    int32_t startTimeMs;
+
+    if (uCellMqttPublish(pDevice->devHandle, "ubxlib/load", "0123456789", 10,
+                         U_CELL_MQTT_QOS_AT_MOST_ONCE, false) >= 0) {
+        startTimeMs = uPortGetTickTimeMs();
+        while ((pDevice->publishCount == publishCount) &&
+               (uPortGetTickTimeMs() - startTimeMs < U_CELL_LOAD_TEST_PUBLISH_TIMEOUT_MS)) {
+            uPortTaskBlock(1);
+        }
+        success = (pDevice->publishCount != publishCount) &&
+                  (pDevice->publishErrorCode == 0);
+    }
+
+    return success;
+}
+
+// Perform one GNSS operation: get the position.
+static bool gnssOperation(uCellLoadTestDevice_t *pDevice)
+{
+    int32_t latitudeX1e7 = 0;
+    int32_t longitudeX1e7 = 0;
+
+    return (uGnssPosGet(pDevice->devHandle, &latitudeX1e7, &longitudeX1e7,
+                        NULL, NULL, NULL, NULL, NULL, NULL) == 0) &&
+           (latitudeX1e7 == U_CELL_LOAD_TEST_LATITUDE_X1E7) &&
+           (longitudeX1e7 == U_CELL_LOAD_TEST_LONGITUDE_X1E7);
+}
+
+// The task that drives one emulated module.
+static void loadTask(void *pParameter)
+{
+    uCellLoadTestDevice_t *pDevice = (uCellLoadTestDevice_t *) pParameter;
+    int64_t startTimeUs;
+    bool success;
+
+    while (!gGo) {
+        uPortTaskBlock(1);
+    }
+
+    for (size_t x = 0; x < U_CELL_LOAD_TEST_NUM_OPERATIONS; x++) {
+        startTimeUs = uPortGetTickTimeUs();
+        switch (pDevice->workload) {
+            case U_CELL_LOAD_TEST_WORKLOAD_SOCK:
+                success = sockOperation(pDevice);
+                break;
+            case U_CELL_LOAD_TEST_WORKLOAD_MQTT:
+                success = mqttOperation(pDevice);
+                if (success) {
+                    // The publish completes in the callback
+                    pDevice->latencyUs[x] = (int32_t) (pDevice->publishDoneUs - startTimeUs);
+                }
+                break;
+            default:
+                success = gnssOperation(pDevice);
+                break;
+        }
+        if ((pDevice->workload != U_CELL_LOAD_TEST_WORKLOAD_MQTT) || !success) {
+            pDevice->latencyUs[x] = (int32_t) (uPortGetTickTimeUs() - startTimeUs);
+        }
+        if (!success) {
+            pDevice->errorCount++;
+        }
+        pDevice->numOperations++;
+    }
+
+    pDevice->done = true;
+    uPortTaskDelete(NULL);
+}
+
+// Bring up an emulated module, its UART, its AT client and
+// the cellular or GNSS instance on it, and prepare its workload;
+// returns true on success.
+static bool deviceOpen(uCellLoadTestDevice_t *pDevice, size_t index)
+{
+    uAtClientStreamHandle_t stream;
+    uGnssTransportHandle_t transportHandle;
+    uSockAddress_t address;
+    bool success = false;
+
+    pDevice->workload = (uCellLoadTestWorkload_t) (index % U_CELL_LOAD_TEST_WORKLOAD_MAX_NUM);
+    switch (pDevice->workload) {
+        case U_CELL_LOAD_TEST_WORKLOAD_SOCK:
+            pDevice->emulatorCfg.pRules = gSockRules;
+            pDevice->emulatorCfg.numRules = sizeof(gSockRules) / sizeof(gSockRules[0]);
+            break;
+        case U_CELL_LOAD_TEST_WORKLOAD_MQTT:
+            pDevice->emulatorCfg.pRules = gMqttRules;
+            pDevice->emulatorCfg.numRules = sizeof(gMqttRules) / sizeof(gMqttRules[0]);
+            break;
+        default:
+            pDevice->emulatorCfg.pRules = gGnssRules;
+            pDevice->emulatorCfg.numRules = sizeof(gGnssRules) / sizeof(gGnssRules[0]);
+            break;
+    }
+    // Anything else the module is asked just gets "OK"
+    pDevice->emulatorCfg.pDefaultResponse = "\r\nOK\r\n";
+    pDevice->emulatorCfg.baudRate = U_CELL_LOAD_TEST_BAUD_RATE;
+
+    pDevice->emulatorHandle = uPortModuleEmulatorStart(&pDevice->emulatorCfg,
+                                                       pDevice->deviceName);
+    if ((pDevice->emulatorHandle >= 0) &&
+        (uPortUartPrefix(pDevice->deviceName) == 0)) {
+        pDevice->uartHandle = uPortUartOpen(-1, 115200, NULL,
+                                            U_CFG_TEST_UART_BUFFER_LENGTH_BYTES,
+                                            -1, -1, -1, -1);
+    }
+    if (pDevice->uartHandle >= 0) {
+        stream.handle.int32 = pDevice->uartHandle;
+        stream.type = U_AT_CLIENT_STREAM_TYPE_UART;
+        pDevice->atClientHandle = uAtClientAddExt(&stream, NULL, U_CELL_AT_BUFFER_LENGTH_BYTES);
+    }
+    if (pDevice->atClientHandle != NULL) {
+        // With this many modules chattering the AT prints would
+        // swamp everything else
+        uAtClientPrintAtSet(pDevice->atClientHandle, false);
+        if (pDevice->workload == U_CELL_LOAD_TEST_WORKLOAD_GNSS) {
+            transportHandle.pAt = pDevice->atClientHandle;
+            success = (uGnssAdd(U_GNSS_MODULE_TYPE_M9, U_GNSS_TRANSPORT_AT,
+                                transportHandle, -1, false,
+                                &pDevice->devHandle) == 0);
+        } else {
+            success = (uCellAdd(U_CELL_MODULE_TYPE_SARA_R410M_03B,
+                                pDevice->atClientHandle, -1, -1, -1, false,
+                                &pDevice->devHandle) == 0);
+        }
+        // The emulator doesn't need a gap between AT commands;
+        // this must be done after the add, which sets the module's
+        // own delay
+        uAtClientDelaySet(pDevice->atClientHandle, 0);
+    }
+    if (success) {
+        switch (pDevice->workload) {
+            case U_CELL_LOAD_TEST_WORKLOAD_SOCK:
+                // SARA-R410M-03B sockets are binary with a prompt,
+                // which the emulator can't do, so use hex mode
+                pDevice->sock = -1;
+                success = (uCellSockHexModeOn(pDevice->devHandle) == 0) &&
+                          (uSockStringToAddress("10.0.0.1:5000", &address) == 0);
+                if (success) {
+                    pDevice->sock = uSockCreate(pDevice->devHandle, U_SOCK_TYPE_STREAM,
+                                                U_SOCK_PROTOCOL_TCP);
+                    success = (pDevice->sock >= 0) &&
+                              (uSockConnect(pDevice->sock, &address) == 0);
+                }
+                break;
+            case U_CELL_LOAD_TEST_WORKLOAD_MQTT:
+                success = (uCellMqttInit(pDevice->devHandle, "10.0.0.1", "ubxlib_load",
+                                         NULL, NULL, NULL, false) == 0) &&
+                          (uCellMqttSetPublishCallback(pDevice->devHandle, publishCallback,
+                                                       pDevice) == 0) &&
+                          (uCellMqttConnect(pDevice->devHandle) == 0);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return success;
+}
+
+// Take down the workload of a module; the cellular and GNSS
+// instances are removed by uDeviceDeinit().
+static void deviceClose(uCellLoadTestDevice_t *pDevice)
+{
+    if (pDevice->devHandle != NULL) {
+        if (pDevice->workload == U_CELL_LOAD_TEST_WORKLOAD_SOCK) {
+            if (pDevice->sock >= 0) {
+                uSockClose(pDevice->sock);
+            }
+        } else if (pDevice->workload == U_CELL_LOAD_TEST_WORKLOAD_MQTT) {
+            uCellMqttDisconnect(pDevice->devHandle);
+            uCellMqttDeinit(pDevice->devHandle);
+        }
+    }
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Drive U_CELL_LOAD_TEST_NUM_DEVICES emulated modules concurrently
+ * and report the throughput and tail latency.
+ *
+ * IMPORTANT: see notes in u_cfg_test_platform_specific.h for the
+ * naming rules that must be followed when using the
+ * U_PORT_TEST_FUNCTION() macro.
+ */
+U_PORT_TEST_FUNCTION("[cellLoad]", "cellLoadConcurrent")
+{
+    uCellLoadTestDevice_t *pDevice;
+    uPortModuleEmulatorStats_t stats;
+    int32_t sorted[U_CELL_LOAD_TEST_NUM_OPERATIONS];
+    int32_t startTimeMs;
+    int32_t timeMs;
+    bool done = false;
+    size_t totalOperations = 0;
+    int32_t totalErrors = 0;
+    size_t totalBytes = 0;
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+    U_PORT_TEST_ASSERT(uAtClientInit() == 0);
+    // This brings up short-range as well, which the sockets
+    // API requires if it is compiled in
+    U_PORT_TEST_ASSERT(uDeviceInit() == 0);
+
+    gnssResponseCreate();
+    memset(gDevice, 0, sizeof(gDevice));
+    gGo = false;
+    for (size_t x = 0; x < U_CELL_LOAD_TEST_NUM_DEVICES; x++) {
+        pDevice = &(gDevice[x]);
+        pDevice->emulatorHandle = -1;
+        pDevice->uartHandle = -1;
+        U_PORT_TEST_ASSERT(deviceOpen(pDevice, x));
+        U_TEST_PRINT_LINE("module %d: %s workload on emulator \"%s\".", x,
+                          gpWorkloadStr[pDevice->workload], pDevice->deviceName);
+        U_PORT_TEST_ASSERT(uPortModuleEmulatorGetStats(pDevice->emulatorHandle,
+                                                       &pDevice->statsStart) == 0);
+        U_PORT_TEST_ASSERT(uPortTaskCreate(loadTask, "loadTask",
+                                           U_CELL_LOAD_TEST_TASK_STACK_SIZE_BYTES,
+                                           pDevice, U_CFG_TEST_OS_TASK_PRIORITY,
+                                           &pDevice->taskHandle) == 0);
+    }
+
+    U_TEST_PRINT_LINE("running %d operation(s) on each of %d module(s) at once...",
+                      U_CELL_LOAD_TEST_NUM_OPERATIONS, U_CELL_LOAD_TEST_NUM_DEVICES);
+    startTimeMs = uPortGetTickTimeMs();
+    gGo = true;
+    while (!done &&
+           (uPortGetTickTimeMs() - startTimeMs < U_CELL_LOAD_TEST_TIMEOUT_SECONDS * 1000)) {
+        uPortTaskBlock(10);
+        done = true;
+        for (size_t x = 0; done && (x < U_CELL_LOAD_TEST_NUM_DEVICES); x++) {
+            done = gDevice[x].done;
+        }
+    }
+    timeMs = uPortGetTickTimeMs() - startTimeMs;
+    U_PORT_TEST_ASSERT(done);
+    // Let the tasks exit
+    uPortTaskBlock(100);
+
+    for (size_t x = 0; x < U_CELL_LOAD_TEST_NUM_DEVICES; x++) {
+        pDevice = &(gDevice[x]);
+        U_PORT_TEST_ASSERT(uPortModuleEmulatorGetStats(pDevice->emulatorHandle, &stats) == 0);
+        stats.bytesReceived -= pDevice->statsStart.bytesReceived;
+        stats.bytesSent -= pDevice->statsStart.bytesSent;
+        totalBytes += stats.bytesReceived + stats.bytesSent;
+        totalOperations += pDevice->numOperations;
+        totalErrors += pDevice->errorCount;
+        memcpy(sorted, pDevice->latencyUs, pDevice->numOperations * sizeof(sorted[0]));
+        qsort(sorted, pDevice->numOperations, sizeof(sorted[0]), compareInt32);
+        U_TEST_PRINT_LINE("module %d (%s): %d operation(s), %d error(s), %d byte(s) in,"
+                          " %d byte(s) out, latency p50 %d us, p90 %d us, p99 %d us,"
+                          " max %d us.", x, gpWorkloadStr[pDevice->workload],
+                          pDevice->numOperations, pDevice->errorCount,
+                          stats.bytesSent, stats.bytesReceived,
+                          percentile(sorted, pDevice->numOperations, 50),
+                          percentile(sorted, pDevice->numOperations, 90),
+                          percentile(sorted, pDevice->numOperations, 99),
+                          percentile(sorted, pDevice->numOperations, 100));
+        uPortLog(U_TEST_PREFIX "{\"test\":\"cellLoadConcurrent\",\"module\":%d,"
+                 "\"workload\":\"%s\",\"operations\":%d,\"errors\":%d,\"p50Us\":%d,"
+                 "\"p90Us\":%d,\"p99Us\":%d,\"maxUs\":%d}\n", x,
+                 gpWorkloadStr[pDevice->workload], pDevice->numOperations,
+                 pDevice->errorCount, percentile(sorted, pDevice->numOperations, 50),
+                 percentile(sorted, pDevice->numOperations, 90),
+                 percentile(sorted, pDevice->numOperations, 99),
+                 percentile(sorted, pDevice->numOperations, 100));
+    }
+    if (timeMs <= 0) {
+        timeMs = 1;
+    }
+    U_TEST_PRINT_LINE("%d operation(s) in %d ms, %d error(s): %d operation(s)/s,"
+                      " %d byte(s)/s on the wire.", totalOperations, timeMs, totalErrors,
+                      (int32_t) ((totalOperations * 1000) / timeMs),
+                      (int32_t) ((totalBytes * 1000) / timeMs));
+    uPortLog(U_TEST_PREFIX "{\"test\":\"cellLoadConcurrent\",\"modules\":%d,"
+             "\"baudRate\":%d,\"operations\":%d,\"errors\":%d,\"wallMs\":%d,"
+             "\"operationsPerSecond\":%d,\"bytesPerSecond\":%d}\n",
+             U_CELL_LOAD_TEST_NUM_DEVICES, U_CELL_LOAD_TEST_BAUD_RATE, totalOperations,
+             totalErrors, timeMs, (int32_t) ((totalOperations * 1000) / timeMs),
+             (int32_t) ((totalBytes * 1000) / timeMs));
+    U_PORT_TEST_ASSERT(totalOperations == U_CELL_LOAD_TEST_NUM_DEVICES *
+                       U_CELL_LOAD_TEST_NUM_OPERATIONS);
+    U_PORT_TEST_ASSERT(totalErrors == 0);
+
+    for (size_t x = 0; x < U_CELL_LOAD_TEST_NUM_DEVICES; x++) {
+        deviceClose(&(gDevice[x]));
+    }
+    uSockCleanUp();
+    uSockDeinit();
+    uDeviceDeinit();
+    uAtClientDeinit();
+    for (size_t x = 0; x < U_CELL_LOAD_TEST_NUM_DEVICES; x++) {
+        pDevice = &(gDevice[x]);
+        uPortUartClose(pDevice->uartHandle);
+        uPortModuleEmulatorStop(pDevice->emulatorHandle);
+    }
+
+    uPortDeinit();
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Clean-up to be run at the end of this round of tests, just
+ * in case there were test failures which would have resulted
+ * in the deinitialisation being skipped.
+ */
+U_PORT_TEST_FUNCTION("[cellLoad]", "cellLoadCleanUp")
+{
+    uSockDeinit();
+    uDeviceDeinit();
+    uAtClientDeinit();
+    for (size_t x = 0; x < U_CELL_LOAD_TEST_NUM_DEVICES; x++) {
+        if (gDevice[x].uartHandle >= 0) {
+            uPortUartClose(gDevice[x].uartHandle);
+            gDevice[x].uartHandle = -1;
+        }
+        if (gDevice[x].emulatorHandle >= 0) {
+            uPortModuleEmulatorStop(gDevice[x].emulatorHandle);
+            gDevice[x].emulatorHandle = -1;
+        }
+    }
+    uPortDeinit();
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+#endif // #if defined(__linux__) && !defined(U_CFG_CELL_MODULE_TYPE_ONLY) && ...
+
+// End of file
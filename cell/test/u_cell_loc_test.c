@@ -586,6 +586,18 @@ U_PORT_TEST_FUNCTION("[cellLoc]", "cellLocCfg")
     uCellLocSetDesiredFixTimeout(cellHandle, y);
     U_TEST_PRINT_LINE("desired fix timeout returned to.", y);
 
+    // Check the fix cache maximum age
+    y = uCellLocGetCacheMaxAge(cellHandle);
+    U_TEST_PRINT_LINE("fix cache maximum age is %d second(s).", y);
+    U_PORT_TEST_ASSERT(y == 0);
+    uCellLocSetCacheMaxAge(cellHandle, 30);
+    z = uCellLocGetCacheMaxAge(cellHandle);
+    U_TEST_PRINT_LINE("fix cache maximum age is now %d second(s).", z);
+    U_PORT_TEST_ASSERT(z == 30);
+    // A negative value should be treated as zero
+    uCellLocSetCacheMaxAge(cellHandle, -1);
+    U_PORT_TEST_ASSERT(uCellLocGetCacheMaxAge(cellHandle) == 0);
+
     // Check whether GNSS is used or not
     y = (int32_t) uCellLocGetGnssEnable(cellHandle);
     U_TEST_PRINT_LINE("GNSS is %s.", y ? "enabled" : "disabled");
@@ -451,6 +451,21 @@ U_PORT_TEST_FUNCTION("[cellMqtt]", "cellMqtt")
             U_PORT_TEST_ASSERT(!uCellMqttIsKeptAlive(cellHandle));
         }
 
+        // Publish by way of a file
+        U_TEST_PRINT_LINE("testing publishing via a file...");
+        for (z = 0; z < sizeof(buffer2); z++) {
+            // Binary content, including NULLs
+            buffer2[z] = (char) z;
+        }
+        x = uCellMqttPublishViaFile(cellHandle, "ubx_test/file", buffer2,
+                                    sizeof(buffer2), U_CELL_MQTT_QOS_AT_MOST_ONCE,
+                                    false);
+        if (U_CELL_PRIVATE_HAS(pModule, U_CELL_PRIVATE_FEATURE_MQTT_SARA_R4_OLD_SYNTAX)) {
+            U_PORT_TEST_ASSERT(x == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
+        } else {
+            U_PORT_TEST_ASSERT(x == 0);
+        }
+
         // Disconnect
         U_TEST_PRINT_LINE("disconnecting from broker...");
         U_PORT_TEST_ASSERT(uCellMqttDisconnect(cellHandle) == 0);
@@ -106,10 +106,41 @@
 # define U_CELL_MUX_PRIVATE_TEST_FILL_CHAR 0xFF
 #endif
 
+#ifndef U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES
+/** The length of information field to use when measuring
+ * encode/decode throughput: 127 is the largest that fits a
+ * single-byte length.
+ */
+# define U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES 127
+#endif
+
+#ifndef U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS
+/** The number of frames to encode and then decode when measuring
+ * throughput.
+ */
+# define U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS 10000
+#endif
+
+#ifndef U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_RING_BUFFER_SIZE_BYTES
+/** The size of ring buffer to decode from when measuring throughput;
+ * deliberately not a multiple of the frame size so that frames
+ * wrap around the end of the buffer.
+ */
+# define U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_RING_BUFFER_SIZE_BYTES 1000
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Context for spanCallback().
+ */
+typedef struct {
+    const char *pExpected;
+    size_t offset;
+    size_t errorCount;
+} uCellMuxPrivateTestSpan_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -145,6 +176,20 @@ const char *pBool(bool isTrue)
     return isTrue ? "true" : "false";
 }
 
+// Callback for information field spans, checks them against the
+// expected contents; pParam should point to a uCellMuxPrivateTestSpan_t
+// where offset is reset to zero before each frame is parsed.
+static void spanCallback(const char *pSpan, size_t sizeBytes, void *pParam)
+{
+    uCellMuxPrivateTestSpan_t *pTestSpan = (uCellMuxPrivateTestSpan_t *) pParam;
+
+    if ((pTestSpan->offset + sizeBytes > U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES) ||
+        (memcmp(pSpan, pTestSpan->pExpected + pTestSpan->offset, sizeBytes) != 0)) {
+        pTestSpan->errorCount++;
+    }
+    pTestSpan->offset += sizeBytes;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -291,4 +336,157 @@ U_PORT_TEST_FUNCTION("[cellMuxPrivate]", "cellMuxPrivateBackToBack")
     uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
 }
 
+/** Measure the throughput of the CMUX encoder and, reading from
+ * a ring buffer as the real CMUX receive path does, the decoder,
+ * both copying out and passing the information field in place.
+ * The figures are printed for information: nothing is asserted
+ * about the speed since that is platform-dependent, only about
+ * the integrity of the decoded data.
+ */
+U_PORT_TEST_FUNCTION("[cellMuxPrivate]", "cellMuxPrivateThroughput")
+{
+    int32_t resourceCount;
+    uRingBuffer_t ringBuffer;
+    int32_t readHandle;
+    U_RING_BUFFER_PARSER_f parserList[] = {uCellMuxPrivateParseCmux, NULL};
+    uCellMuxPrivateParserContext_t parserContext = {0};
+    char *pRingBufferStorage;
+    char *pFrame;
+    char *pInformation;
+    char *pDecoded;
+    int32_t frameLength = 0;
+    int32_t startTimeMs;
+    int32_t durationMs;
+    size_t decodeCount = 0;
+    uCellMuxPrivateTestSpan_t testSpan = {0};
+    int64_t totalBytes = ((int64_t) U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES) *
+                         U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS;
+
+    // Obtain the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    pRingBufferStorage = (char *) pUPortMalloc(U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_RING_BUFFER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pRingBufferStorage != NULL);
+    pFrame = (char *) pUPortMalloc(U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES +
+                                   U_CELL_MUX_PRIVATE_FRAME_OVERHEAD_MAX_BYTES);
+    U_PORT_TEST_ASSERT(pFrame != NULL);
+    pInformation = (char *) pUPortMalloc(U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pInformation != NULL);
+    pDecoded = (char *) pUPortMalloc(U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pDecoded != NULL);
+    for (size_t x = 0; x < U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES; x++) {
+        *(pInformation + x) = (char) x;
+    }
+    U_PORT_TEST_ASSERT(uRingBufferCreateWithReadHandle(&ringBuffer, pRingBufferStorage,
+                                                       U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_RING_BUFFER_SIZE_BYTES,
+                                                       1) == 0);
+    uRingBufferSetReadRequiresHandle(&ringBuffer, true);
+    readHandle = uRingBufferTakeReadHandle(&ringBuffer);
+    U_PORT_TEST_ASSERT(readHandle >= 0);
+
+    // Encode
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS; x++) {
+        frameLength = uCellMuxPrivateEncode(1, U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH, false,
+                                            pInformation,
+                                            U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES,
+                                            pFrame);
+    }
+    durationMs = uPortGetTickTimeMs() - startTimeMs;
+    U_PORT_TEST_ASSERT(frameLength > 0);
+    if (durationMs > 0) {
+        U_TEST_PRINT_LINE("encoded %d %d-byte UIH frames in %d ms, %d kbytes/second.",
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS,
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES,
+                          durationMs, (int32_t) (totalBytes / durationMs));
+    } else {
+        U_TEST_PRINT_LINE("encoded %d %d-byte UIH frames in less than 1 ms.",
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS,
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES);
+    }
+
+    // Decode: add the frame to the ring buffer, parse it, copying
+    // out the information field, then remove it from the ring buffer
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS; x++) {
+        U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, pFrame, frameLength));
+        parserContext.address = U_CELL_MUX_PRIVATE_ADDRESS_ANY;
+        parserContext.type = U_CELL_MUX_PRIVATE_FRAME_TYPE_NONE;
+        parserContext.pInformation = pDecoded;
+        parserContext.informationLengthBytes = U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES;
+        if (((int32_t) uRingBufferParseHandle(&ringBuffer, readHandle, parserList,
+                                              &parserContext) == frameLength) &&
+            (parserContext.type == U_CELL_MUX_PRIVATE_FRAME_TYPE_UIH) &&
+            (parserContext.informationLengthBytes == U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES)) {
+            decodeCount++;
+        }
+        uRingBufferReadHandle(&ringBuffer, readHandle, pFrame, frameLength);
+    }
+    durationMs = uPortGetTickTimeMs() - startTimeMs;
+    if (durationMs > 0) {
+        U_TEST_PRINT_LINE("decoded %d %d-byte UIH frames in %d ms, %d kbytes/second.",
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS,
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES,
+                          durationMs, (int32_t) (totalBytes / durationMs));
+    } else {
+        U_TEST_PRINT_LINE("decoded %d %d-byte UIH frames in less than 1 ms.",
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS,
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES);
+    }
+    U_PORT_TEST_ASSERT(decodeCount == U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS);
+    U_PORT_TEST_ASSERT(memcmp(pDecoded, pInformation,
+                              U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES) == 0);
+
+    // Decode again but passing the information field in place
+    decodeCount = 0;
+    testSpan.pExpected = pInformation;
+    parserContext.pInformation = NULL;
+    parserContext.pSpanCallback = spanCallback;
+    parserContext.pSpanCallbackParam = &testSpan;
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS; x++) {
+        U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, pFrame, frameLength));
+        parserContext.address = U_CELL_MUX_PRIVATE_ADDRESS_ANY;
+        parserContext.type = U_CELL_MUX_PRIVATE_FRAME_TYPE_NONE;
+        testSpan.offset = 0;
+        if (((int32_t) uRingBufferParseHandle(&ringBuffer, readHandle, parserList,
+                                              &parserContext) == frameLength) &&
+            (testSpan.offset == U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES)) {
+            decodeCount++;
+        }
+        uRingBufferReadHandle(&ringBuffer, readHandle, NULL, frameLength);
+    }
+    durationMs = uPortGetTickTimeMs() - startTimeMs;
+    if (durationMs > 0) {
+        U_TEST_PRINT_LINE("decoded in place %d %d-byte UIH frames in %d ms, %d kbytes/second.",
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS,
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES,
+                          durationMs, (int32_t) (totalBytes / durationMs));
+    } else {
+        U_TEST_PRINT_LINE("decoded in place %d %d-byte UIH frames in less than 1 ms.",
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS,
+                          U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_INFORMATION_SIZE_BYTES);
+    }
+    U_PORT_TEST_ASSERT(decodeCount == U_CELL_MUX_PRIVATE_TEST_THROUGHPUT_ITERATIONS);
+    U_PORT_TEST_ASSERT(testSpan.errorCount == 0);
+
+    // Clean up
+    uRingBufferDelete(&ringBuffer);
+    uPortFree(pRingBufferStorage);
+    uPortFree(pFrame);
+    uPortFree(pInformation);
+    uPortFree(pDecoded);
+
+    uPortDeinit();
+
+    // Check for resource leaks
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
 // End of file
@@ -38,6 +38,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "stdlib.h"    // qsort()
 #include "string.h"    // memset(), strncpy()
 #include "stdio.h"     // snprintf()
 
@@ -69,6 +70,13 @@
 #include "u_cell_test_cfg.h"
 #include "u_cell_test_private.h"
 
+#if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+# include "u_sock.h"
+# include "u_cell_pwr.h"
+# include "u_cell_sock.h"
+# include "u_sock_test_shared_cfg.h" // For the echo server
+#endif
+
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
@@ -81,10 +89,36 @@
  */
 #define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
 
+#ifndef U_CELL_NET_TEST_BENCHMARK_NUM
+/** The number of times to power the module on, connect and open
+ * a socket if U_CELL_NET_TEST_BENCHMARK is defined.
+ */
+# define U_CELL_NET_TEST_BENCHMARK_NUM 5
+#endif
+
+/** The string that follows #U_TEST_PREFIX at the start of each
+ * line of machine-readable benchmark results.
+ */
+#define U_CELL_NET_TEST_BENCHMARK_CSV_PREFIX "CSV,"
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+#if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+/** The phases of getting from power-on to a connected socket.
+ */
+typedef enum {
+    U_CELL_NET_TEST_PHASE_PWR_ON,       /**< uCellPwrOn(). */
+    U_CELL_NET_TEST_PHASE_REGISTER,     /**< uCellNetConnect() up to registration. */
+    U_CELL_NET_TEST_PHASE_ACTIVATE,     /**< the rest of uCellNetConnect(). */
+    U_CELL_NET_TEST_PHASE_DNS,          /**< uCellSockGetHostByName(). */
+    U_CELL_NET_TEST_PHASE_SOCK_CONNECT, /**< uCellSockCreate() and uCellSockConnect(). */
+    U_CELL_NET_TEST_PHASE_TOTAL,        /**< all of the above. */
+    U_CELL_NET_TEST_PHASE_MAX_NUM
+} uCellNetTestPhase_t;
+#endif
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -114,6 +148,20 @@ static bool gHasBeenConnected = false;
  */
 static int32_t gCallbackErrorCode = 0;
 
+#if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+/** The names of the phases, for the benchmark results; must match
+ * uCellNetTestPhase_t.
+ */
+static const char *const gpPhaseName[] = {"pwr_on", "register", "activate",
+                                          "dns", "sock_connect", "total"
+                                         };
+
+/** The time at which benchmarkRegisterCallback() was first told that
+ * the module is registered, zero if it has not been.
+ */
+static volatile int32_t gRegisteredTimeMs = 0;
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -183,6 +231,45 @@ static void connectCallback(bool isConnected, void *pParameter)
     }
 }
 
+#if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+
+// Registration status callback for the benchmark, noting when
+// the module becomes registered.
+static void benchmarkRegisterCallback(uCellNetRegDomain_t domain,
+                                      uCellNetStatus_t status,
+                                      void *pParameter)
+{
+    (void) pParameter;
+
+    if ((domain == U_CELL_NET_REG_DOMAIN_PS) && (gRegisteredTimeMs == 0) &&
+        U_CELL_NET_STATUS_MEANS_REGISTERED(status)) {
+        gRegisteredTimeMs = uPortGetTickTimeMs();
+    }
+}
+
+// Compare two int32_t's, for qsort().
+static int compareInt32(const void *p1, const void *p2)
+{
+    return *((const int32_t *) p1) - *((const int32_t *) p2);
+}
+
+// Print the statistics of a set of timings as a line of comma-separated
+// values; the timings are sorted in the process.
+static void benchmarkPrintStats(const char *pName, int32_t *pTimeMs, size_t num)
+{
+    int32_t totalMs = 0;
+
+    qsort(pTimeMs, num, sizeof(pTimeMs[0]), compareInt32);
+    for (size_t x = 0; x < num; x++) {
+        totalMs += pTimeMs[x];
+    }
+    U_TEST_PRINT_LINE(U_CELL_NET_TEST_BENCHMARK_CSV_PREFIX "%s,%d,%d,%d,%d,%d",
+                      pName, num, pTimeMs[0], pTimeMs[num / 2],
+                      totalMs / (int32_t) num, pTimeMs[num - 1]);
+}
+
+#endif // #if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -813,6 +900,142 @@ U_PORT_TEST_FUNCTION("[cellNet]", "cellNetScanRegActDeact")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+#if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+/** Benchmark the time from power-on to a connected socket, only
+ * compiled if U_CELL_NET_TEST_BENCHMARK is defined and the module's
+ * PWR_ON pin is under our control: the module is powered off and then
+ * powered on, connected to the network, the echo server is looked up
+ * and a TCP socket is connected to it, U_CELL_NET_TEST_BENCHMARK_NUM
+ * times.  The time spent in each phase is printed for each go and the
+ * statistics (count, minimum, median, average and maximum) of each
+ * phase as comma-separated values, each line beginning with
+ * #U_CELL_NET_TEST_BENCHMARK_CSV_PREFIX, the first such line being a
+ * header, so that they can be picked out of the test log by a script.
+ */
+U_PORT_TEST_FUNCTION("[cellNet]", "cellNetBenchmarkConnect")
+{
+    uDeviceHandle_t cellHandle;
+    int32_t timeMs[U_CELL_NET_TEST_PHASE_MAX_NUM][U_CELL_NET_TEST_BENCHMARK_NUM];
+    int32_t phaseMs[U_CELL_NET_TEST_PHASE_MAX_NUM];
+    uSockAddress_t address;
+    int32_t sockHandle;
+    int32_t startTimeMs;
+    int32_t connectStartTimeMs;
+    int32_t phaseStartTimeMs;
+    int32_t x;
+    int32_t resourceCount;
+
+    // In case a previous test failed
+    uCellTestPrivateCleanup(&gHandles);
+
+    // Obtain the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Do the standard preamble
+    U_PORT_TEST_ASSERT(uCellTestPrivatePreamble(U_CFG_TEST_CELL_MODULE_TYPE,
+                                                &gHandles, true) == 0);
+    cellHandle = gHandles.cellHandle;
+    U_PORT_TEST_ASSERT(uCellNetSetRegistrationStatusCallback(cellHandle,
+                                                             benchmarkRegisterCallback,
+                                                             NULL) == 0);
+
+    for (size_t y = 0; y < U_CELL_NET_TEST_BENCHMARK_NUM; y++) {
+        // Start from cold each time
+        U_TEST_PRINT_LINE("powering off for go %d of %d...", y + 1,
+                          U_CELL_NET_TEST_BENCHMARK_NUM);
+        U_PORT_TEST_ASSERT(uCellPwrOff(cellHandle, NULL) == 0);
+
+        startTimeMs = uPortGetTickTimeMs();
+        U_PORT_TEST_ASSERT(uCellPwrOn(cellHandle, U_CELL_TEST_CFG_SIM_PIN, NULL) == 0);
+        connectStartTimeMs = uPortGetTickTimeMs();
+        phaseMs[U_CELL_NET_TEST_PHASE_PWR_ON] = connectStartTimeMs - startTimeMs;
+
+        gRegisteredTimeMs = 0;
+        gStopTimeMs = connectStartTimeMs + (U_CELL_TEST_CFG_CONNECT_TIMEOUT_SECONDS * 1000);
+        x = uCellNetConnect(cellHandle, NULL,
+# ifdef U_CELL_TEST_CFG_APN
+                            U_PORT_STRINGIFY_QUOTED(U_CELL_TEST_CFG_APN),
+# else
+                            NULL,
+# endif
+# ifdef U_CELL_TEST_CFG_USERNAME
+                            U_PORT_STRINGIFY_QUOTED(U_CELL_TEST_CFG_USERNAME),
+# else
+                            NULL,
+# endif
+# ifdef U_CELL_TEST_CFG_PASSWORD
+                            U_PORT_STRINGIFY_QUOTED(U_CELL_TEST_CFG_PASSWORD),
+# else
+                            NULL,
+# endif
+                            keepGoingCallback);
+        U_PORT_TEST_ASSERT(x == 0);
+        phaseStartTimeMs = uPortGetTickTimeMs();
+        // If the registration callback was never told, e.g. because
+        // the module registered before the callback could see it,
+        // all of the connection time is counted as registration
+        x = gRegisteredTimeMs;
+        if ((x == 0) || (x > phaseStartTimeMs)) {
+            x = phaseStartTimeMs;
+        }
+        phaseMs[U_CELL_NET_TEST_PHASE_REGISTER] = x - connectStartTimeMs;
+        phaseMs[U_CELL_NET_TEST_PHASE_ACTIVATE] = phaseStartTimeMs - x;
+
+        U_PORT_TEST_ASSERT(uCellSockInit() == 0);
+        U_PORT_TEST_ASSERT(uCellSockInitInstance(cellHandle) == 0);
+        U_PORT_TEST_ASSERT(uCellSockGetHostByName(cellHandle,
+                                                  U_SOCK_TEST_ECHO_TCP_SERVER_DOMAIN_NAME,
+                                                  &(address.ipAddress)) == 0);
+        address.port = U_SOCK_TEST_ECHO_TCP_SERVER_PORT;
+        x = uPortGetTickTimeMs();
+        phaseMs[U_CELL_NET_TEST_PHASE_DNS] = x - phaseStartTimeMs;
+        phaseStartTimeMs = x;
+
+        sockHandle = uCellSockCreate(cellHandle, U_SOCK_TYPE_STREAM, U_SOCK_PROTOCOL_TCP);
+        U_PORT_TEST_ASSERT(sockHandle >= 0);
+        U_PORT_TEST_ASSERT(uCellSockConnect(cellHandle, sockHandle, &address) == 0);
+        x = uPortGetTickTimeMs();
+        phaseMs[U_CELL_NET_TEST_PHASE_SOCK_CONNECT] = x - phaseStartTimeMs;
+        phaseMs[U_CELL_NET_TEST_PHASE_TOTAL] = x - startTimeMs;
+
+        U_TEST_PRINT_LINE("power-on %d ms, register %d ms, activate %d ms, DNS %d ms,"
+                          " socket connect %d ms, total %d ms.",
+                          phaseMs[U_CELL_NET_TEST_PHASE_PWR_ON],
+                          phaseMs[U_CELL_NET_TEST_PHASE_REGISTER],
+                          phaseMs[U_CELL_NET_TEST_PHASE_ACTIVATE],
+                          phaseMs[U_CELL_NET_TEST_PHASE_DNS],
+                          phaseMs[U_CELL_NET_TEST_PHASE_SOCK_CONNECT],
+                          phaseMs[U_CELL_NET_TEST_PHASE_TOTAL]);
+        for (size_t z = 0; z < U_CELL_NET_TEST_PHASE_MAX_NUM; z++) {
+            timeMs[z][y] = phaseMs[z];
+        }
+
+        U_PORT_TEST_ASSERT(uCellSockClose(cellHandle, sockHandle, NULL) == 0);
+        uCellSockDeinit();
+        U_PORT_TEST_ASSERT(uCellNetDisconnect(cellHandle, NULL) == 0);
+    }
+
+    uCellNetSetRegistrationStatusCallback(cellHandle, NULL, NULL);
+
+    // Print the results together so that they are easy to find
+    U_TEST_PRINT_LINE(U_CELL_NET_TEST_BENCHMARK_CSV_PREFIX "phase,num,min_ms,median_ms,"
+                      "avg_ms,max_ms");
+    for (size_t z = 0; z < U_CELL_NET_TEST_PHASE_MAX_NUM; z++) {
+        benchmarkPrintStats(gpPhaseName[z], timeMs[z], U_CELL_NET_TEST_BENCHMARK_NUM);
+    }
+
+    // Do the standard postamble, leaving the module on for the next
+    // test to speed things up
+    uCellTestPrivatePostamble(&gHandles, false);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+#endif // #if defined(U_CELL_NET_TEST_BENCHMARK) && (U_CFG_APP_PIN_CELL_PWR_ON >= 0)
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
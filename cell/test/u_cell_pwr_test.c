@@ -188,6 +188,10 @@ typedef struct {
  */
 static uCellTestPrivate_t gHandles = U_CELL_TEST_PRIVATE_DEFAULTS;
 
+/** Count of the number of times deferCallback() has been called.
+ */
+static volatile int32_t gDeferCallbackCount = 0;
+
 # if ((U_CFG_APP_PIN_CELL_PWR_ON >= 0) && !defined(U_CFG_TEST_CELL_PWR_DISABLE)) || \
   !defined(U_CFG_CELL_DISABLE_UART_POWER_SAVING)
 /** Used for keepGoingCallback() timeout.
@@ -230,6 +234,16 @@ uCellPwrTest3gppPowerSavingParameters_t g3gppPowerSavingCallbackParameter = {0};
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Callback for uCellPwrDefer(), where the parameter is a pointer
+// to an int32_t which is expected to be one more than the count.
+static void deferCallback(uDeviceHandle_t cellHandle, void *pParam)
+{
+    if ((cellHandle == gHandles.cellHandle) &&
+        (*((int32_t *) pParam) == gDeferCallbackCount + 1)) {
+        gDeferCallbackCount++;
+    }
+}
+
 # if ((U_CFG_APP_PIN_CELL_PWR_ON >= 0) && !defined(U_CFG_TEST_CELL_PWR_DISABLE)) || \
   !defined(U_CFG_CELL_DISABLE_UART_POWER_SAVING)
 // Callback function for the cellular power-down and connection process.
@@ -787,6 +801,8 @@ U_PORT_TEST_FUNCTION("[cellPwr]", "cellPwr")
 U_PORT_TEST_FUNCTION("[cellPwr]", "cellPwrReboot")
 {
     int32_t resourceCount;
+    int32_t x;
+    int32_t y;
 
     // In case a previous test failed
     uCellTestPrivateCleanup(&gHandles);
@@ -810,6 +826,20 @@ U_PORT_TEST_FUNCTION("[cellPwr]", "cellPwrReboot")
 
     U_PORT_TEST_ASSERT(uCellPwrIsAlive(gHandles.cellHandle));
 
+    // The module is awake, so deferred operations should be run
+    // straight away and in order
+    U_TEST_PRINT_LINE("deferring operations...");
+    gDeferCallbackCount = 0;
+    x = 1;
+    y = 2;
+    U_PORT_TEST_ASSERT(uCellPwrDefer(gHandles.cellHandle, 60000, deferCallback, &x) == 0);
+    U_PORT_TEST_ASSERT(uCellPwrDefer(gHandles.cellHandle, 60000, deferCallback, &y) == 0);
+    for (size_t z = 0; (z < 50) && (gDeferCallbackCount < 2); z++) {
+        uPortTaskBlock(100);
+    }
+    U_PORT_TEST_ASSERT(gDeferCallbackCount == 2);
+    U_PORT_TEST_ASSERT(uCellPwrDeferFlush(gHandles.cellHandle) == 0);
+
     // Do the standard postamble, leaving the module on for the next
     // test to speed things up
     uCellTestPrivatePostamble(&gHandles, false);
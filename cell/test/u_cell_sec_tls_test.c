@@ -141,6 +141,7 @@ U_PORT_TEST_FUNCTION("[cellSecTls]", "cellSecTlsSettings")
     char *pBuffer;
     size_t numCiphers;
     bool good;
+    bool isConfigured = false;
     int32_t y;
     int32_t z;
 
@@ -468,6 +469,38 @@ U_PORT_TEST_FUNCTION("[cellSecTls]", "cellSecTlsSettings")
                                              U_CELL_SEC_TLS_TEST_NAME_LENGTH_BYTES + 1) < 0);
     }
 
+    // Not all modules support session resumption
+    if (uCellSecTlsSessionResumptionSet(pContext, true) == 0) {
+        U_TEST_PRINT_LINE("session resumption is supported.");
+        U_PORT_TEST_ASSERT(uCellSecTlsSessionResumptionGet(pContext));
+        U_PORT_TEST_ASSERT(uCellSecTlsSessionResumptionSet(pContext, false) == 0);
+        U_PORT_TEST_ASSERT(!uCellSecTlsSessionResumptionGet(pContext));
+    }
+
+    // Check that a profile left configured is re-used without being
+    // reset and that changing a setting of it prevents that
+    U_TEST_PRINT_LINE("checking re-use of a configured security profile...");
+    U_PORT_TEST_ASSERT(uCellSecTlsRootCaCertificateNameSet(pContext, "test_name_6") == 0);
+    U_PORT_TEST_ASSERT(uCellSecTlsSettingsKeySet(pContext, 0x1234) == 0);
+    y = pContext->profileId;
+    uCellSecTlsRemove(pContext);
+    pContext = pUCellSecSecTlsAddCached(cellHandle, 0x1234, &isConfigured);
+    U_PORT_TEST_ASSERT(pContext != NULL);
+    U_PORT_TEST_ASSERT(isConfigured);
+    U_PORT_TEST_ASSERT(pContext->profileId == y);
+    U_PORT_TEST_ASSERT(uCellSecTlsRootCaCertificateNameGet(pContext, pBuffer,
+                                                           U_CELL_SEC_TLS_TEST_NAME_LENGTH_BYTES + 1) ==
+                       U_CELL_SEC_TLS_TEST_NAME_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(strcmp(pBuffer, "test_name_6") == 0);
+    U_PORT_TEST_ASSERT(uCellSecTlsRootCaCertificateNameSet(pContext, "test_name_7") == 0);
+    uCellSecTlsRemove(pContext);
+    pContext = pUCellSecSecTlsAddCached(cellHandle, 0x1234, &isConfigured);
+    U_PORT_TEST_ASSERT(pContext != NULL);
+    U_PORT_TEST_ASSERT(!isConfigured);
+    U_PORT_TEST_ASSERT(uCellSecTlsRootCaCertificateNameGet(pContext, pBuffer,
+                                                           U_CELL_SEC_TLS_TEST_NAME_LENGTH_BYTES + 1) == 0);
+    U_PORT_TEST_ASSERT(strcmp(pBuffer, "") == 0);
+
     // Remove the security context again
     U_TEST_PRINT_LINE("removing security context again...");
     uCellSecTlsRemove(pContext);
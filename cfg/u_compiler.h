@@ -125,6 +125,19 @@
 #define U_ATOMIC_GET(pPtr) __atomic_load_n(pPtr, __ATOMIC_SEQ_CST)
 #endif
 
+/** U_ATOMIC_SET: set the value of a variable atomically.
+ */
+#ifdef _MSC_VER
+/** Microsoft Visual C++ definition; stores (of volatiles) are
+ * atomic on x86_64.
+ */
+# define U_ATOMIC_SET(pPtr, value) *pPtr = value
+#else
+/** Default (GCC) definition.
+ */
+#define U_ATOMIC_SET(pPtr, value) __atomic_store_n(pPtr, value, __ATOMIC_SEQ_CST)
+#endif
+
 /** U_ATOMIC_INCREMENT: increment a variable atomically and return
  * its new value.
  */
@@ -151,6 +164,39 @@
 #define U_ATOMIC_DECREMENT(pPtr) __atomic_fetch_sub(pPtr, 1, __ATOMIC_SEQ_CST)
 #endif
 
+/** U_ATOMIC_ADD: add a value to a 32-bit variable atomically and
+ * return its old value.
+ */
+#ifdef _MSC_VER
+/** Microsoft Visual C++ definition, using the compiler intrinsic
+ * so that windows.h is not required.
+ */
+# include <intrin.h>
+# define U_ATOMIC_ADD(pPtr, value) _InterlockedExchangeAdd((volatile long *) (pPtr), value)
+#else
+/** Default (GCC) definition.
+ */
+#define U_ATOMIC_ADD(pPtr, value) __atomic_fetch_add(pPtr, value, __ATOMIC_SEQ_CST)
+#endif
+
+/** U_ATOMIC_COMPARE_AND_SWAP: if the 32-bit variable at pPtr is equal
+ * to expected, set it to desired, atomically; evaluates to true if
+ * the variable was set.
+ */
+#ifdef _MSC_VER
+/** Microsoft Visual C++ definition, using the compiler intrinsic
+ * so that windows.h is not required.
+ */
+# define U_ATOMIC_COMPARE_AND_SWAP(pPtr, expected, desired) \
+    (_InterlockedCompareExchange((volatile long *) (pPtr), (long) (desired), \
+                                 (long) (expected)) == (long) (expected))
+#else
+/** Default (GCC) definition.
+ */
+#define U_ATOMIC_COMPARE_AND_SWAP(pPtr, expected, desired) \
+    __sync_bool_compare_and_swap(pPtr, expected, desired)
+#endif
+
 /** @}*/
 
 #endif // _U_COMPILER_H_
@@ -392,6 +392,38 @@ extern "C" {
 # define U_AT_CLIENT_CALLBACK_TASK_PRIORITY U_CFG_OS_APP_TASK_PRIORITY
 #endif
 
+#ifndef U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH
+/** The length of the priority callback queue, used by
+ * uAtClientCallbackPriority().  If this is greater than zero
+ * a second callback task, with its own queue, is created so
+ * that short, latency-sensitive callbacks (e.g. network
+ * registration status changes) are not held up behind slow
+ * ones (e.g. socket data reads) queued with uAtClientCallback().
+ * The default is zero, in which case no extra task is created
+ * and uAtClientCallbackPriority() behaves exactly like
+ * uAtClientCallback().
+ */
+# define U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH 0
+#endif
+
+#ifndef U_AT_CLIENT_PRIORITY_CALLBACK_TASK_STACK_SIZE_BYTES
+/** The stack size for the task in which any callbacks triggered
+ * via uAtClientCallbackPriority() will run; only relevant if
+ * #U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH is greater than zero.
+ */
+# define U_AT_CLIENT_PRIORITY_CALLBACK_TASK_STACK_SIZE_BYTES U_AT_CLIENT_CALLBACK_TASK_STACK_SIZE_BYTES
+#endif
+
+#ifndef U_AT_CLIENT_PRIORITY_CALLBACK_TASK_PRIORITY
+/** The priority of the task in which any callbacks triggered via
+ * uAtClientCallbackPriority() will run; only relevant if
+ * #U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH is greater than zero.
+ * Like #U_AT_CLIENT_CALLBACK_TASK_PRIORITY this must be less than
+ * #U_AT_CLIENT_URC_TASK_PRIORITY.
+ */
+# define U_AT_CLIENT_PRIORITY_CALLBACK_TASK_PRIORITY U_AT_CLIENT_CALLBACK_TASK_PRIORITY
+#endif
+
 #ifndef U_AT_CLIENT_MAX_NUM
 /** The maximum number of AT handlers that can be active at any
  * one time.
@@ -406,6 +438,64 @@ extern "C" {
 # define U_AT_CLIENT_ACTIVITY_PIN_HYSTERESIS_INTERVAL_MS 10
 #endif
 
+#ifndef U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES
+/** The size of the buffer, one per AT client, into which the
+ * pieces of an outgoing AT command (the command itself, delimiters,
+ * parameters, etc.) are gathered so that they reach the stream in
+ * a single write rather than in many small ones.  Anything larger
+ * than this is written directly.  Set this to 0 to disable
+ * gathering.
+ */
+# define U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES 64
+#endif
+
+#ifndef U_AT_CLIENT_RECEIVE_BUFFER_SHRINK_IDLE_MS
+/** Where a receive buffer has been allowed to grow with
+ * uAtClientReceiveBufferSizeMaxSet(), the time for which the
+ * extra space must have gone unused before the buffer is shrunk
+ * back to the size it was given in uAtClientAddExt(); value in
+ * milliseconds.
+ */
+# define U_AT_CLIENT_RECEIVE_BUFFER_SHRINK_IDLE_MS 30000
+#endif
+
+#ifndef U_AT_CLIENT_STATS_NUM_COMMANDS
+/** The number of different AT commands for which each AT client
+ * keeps statistics, see uAtClientStatsGet().  A command is
+ * identified by its prefix, e.g. "AT+COPS?" or "AT+COPS=", and
+ * commands beyond the first #U_AT_CLIENT_STATS_NUM_COMMANDS that
+ * are seen are not counted.  Statistics gathering costs around
+ * 130 bytes of RAM per command per AT client, plus a little time
+ * on every command, hence the default of 0 which disables it
+ * entirely.
+ */
+# define U_AT_CLIENT_STATS_NUM_COMMANDS 0
+#endif
+
+#ifndef U_AT_CLIENT_STATS_PREFIX_LENGTH_BYTES
+/** The maximum length of the prefix by which a command is
+ * identified for statistics purposes, see uAtClientStatsGet();
+ * longer prefixes are truncated.
+ */
+# define U_AT_CLIENT_STATS_PREFIX_LENGTH_BYTES 16
+#endif
+
+/** U_AT_CLIENT_STREAM_TYPE_ONLY may be defined to one of the
+ * values of #uAtClientStream_t, e.g. U_AT_CLIENT_STREAM_TYPE_UART,
+ * on a system where every AT client uses that one type of stream:
+ * the AT client may then call the stream functions directly, rather
+ * than through pointers, and uAtClientAddExt() will refuse any
+ * other type of stream.  Not defined by default.
+ */
+
+/** The number of bins in the response time histogram of
+ * #uAtClientStats_t: bin 0 counts responses that took 0 ms,
+ * bin 1 those that took 1 ms, bin 2 those that took 2 to 3 ms,
+ * bin 3 those that took 4 to 7 ms, etc., the last bin counting
+ * everything longer.
+ */
+#define U_AT_CLIENT_STATS_HISTOGRAM_NUM_BINS 17
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -456,6 +546,44 @@ typedef struct {
     int32_t code;
 } uAtClientDeviceError_t;
 
+/** One element of a list of data to be written with
+ * uAtClientWriteVec().
+ */
+typedef struct {
+    const char *pData;  /**< the data to write. */
+    size_t length;      /**< the number of bytes at pData. */
+} uAtClientIoVec_t;
+
+/** Statistics for one AT command, see uAtClientStatsGet().  The
+ * time for a command is measured from uAtClientCommandStart() to
+ * uAtClientResponseStop() or, if that is never called, to
+ * uAtClientUnlock().
+ */
+typedef struct {
+    char prefix[U_AT_CLIENT_STATS_PREFIX_LENGTH_BYTES + 1]; /**< the command,
+                                                                 up to and
+                                                                 including
+                                                                 any '=' or '?',
+                                                                 null-terminated. */
+    int32_t count;        /**< the number of times the command was sent. */
+    int32_t timeoutCount; /**< the number of times the AT server did not
+                               provide a response within the AT timeout. */
+    int32_t minMs;        /**< the shortest response time in milliseconds. */
+    int32_t meanMs;       /**< the mean response time in milliseconds. */
+    int32_t maxMs;        /**< the longest response time in milliseconds. */
+    int32_t p99Ms;        /**< the response time in milliseconds within which
+                               99% of responses arrived, to the resolution of
+                               histogram. */
+    int64_t totalMs;      /**< the total response time in milliseconds. */
+    int32_t txBytes;      /**< the number of bytes sent to the AT server
+                               for the command, including parameters. */
+    int32_t rxBytes;      /**< the number of bytes received from the AT server
+                               while the command was in progress. */
+    /** The number of responses falling into each bin of the
+        response time histogram, see #U_AT_CLIENT_STATS_HISTOGRAM_NUM_BINS. */
+    int32_t histogram[U_AT_CLIENT_STATS_HISTOGRAM_NUM_BINS];
+} uAtClientStats_t;
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: INITIALISATION AND CONFIGURATION
  * -------------------------------------------------------------- */
@@ -550,6 +678,94 @@ uAtClientHandle_t uAtClientAddExt(const uAtClientStreamHandle_t *pStream,
                                   void *pReceiveBuffer,
                                   size_t receiveBufferSize);
 
+/** Allow the receive buffer of an AT client to grow on demand.
+ * By default the receive buffer is fixed at the size passed to
+ * uAtClientAddExt(); if this function is called, rather than
+ * overflowing, the receive buffer will be doubled in size as
+ * required, up to receiveBufferSizeMax bytes.  Once the extra
+ * space has gone unused for #U_AT_CLIENT_RECEIVE_BUFFER_SHRINK_IDLE_MS
+ * the buffer is shrunk back to the size passed to uAtClientAddExt().
+ * This is only possible where the AT client allocated the receive
+ * buffer itself, i.e. where pReceiveBuffer was NULL when
+ * uAtClientAddExt() was called.
+ *
+ * Use uAtClientReceiveBufferHighWaterMarkGet() to determine how
+ * large a receive buffer an application actually needs.
+ *
+ * @param atHandle              the handle of the AT client.
+ * @param receiveBufferSizeMax  the maximum size that the receive
+ *                              buffer may grow to, in the same terms
+ *                              as the receiveBufferSize parameter of
+ *                              uAtClientAddExt(), i.e. including
+ *                              #U_AT_CLIENT_BUFFER_OVERHEAD_BYTES;
+ *                              use a value no larger than the
+ *                              receiveBufferSize passed to
+ *                              uAtClientAddExt() to stop the buffer
+ *                              growing.
+ * @return                      zero on success else negative error
+ *                              code; #U_ERROR_COMMON_NOT_SUPPORTED
+ *                              will be returned if the receive buffer
+ *                              was provided by the caller of
+ *                              uAtClientAddExt().
+ */
+int32_t uAtClientReceiveBufferSizeMaxSet(uAtClientHandle_t atHandle,
+                                         size_t receiveBufferSizeMax);
+
+/** Get the current size of the receive buffer of an AT client,
+ * which will only differ from that passed to uAtClientAddExt() if
+ * uAtClientReceiveBufferSizeMaxSet() has been called.
+ *
+ * @param atHandle  the handle of the AT client.
+ * @return          the current size of the receive buffer, in the
+ *                  same terms as the receiveBufferSize parameter
+ *                  of uAtClientAddExt(), i.e. including
+ *                  #U_AT_CLIENT_BUFFER_OVERHEAD_BYTES, else
+ *                  negative error code.
+ */
+int32_t uAtClientReceiveBufferSizeGet(uAtClientHandle_t atHandle);
+
+/** Get the high-water mark of the receive buffer of an AT client:
+ * the largest receive buffer size, in the same terms as the
+ * receiveBufferSize parameter of uAtClientAddExt(), i.e. including
+ * #U_AT_CLIENT_BUFFER_OVERHEAD_BYTES, that has been required since
+ * the AT client was added.  If this is equal to the size of the
+ * receive buffer then the receive buffer has been filled and may
+ * have overflowed.
+ *
+ * @param atHandle  the handle of the AT client.
+ * @return          the high-water mark, else negative error code.
+ */
+int32_t uAtClientReceiveBufferHighWaterMarkGet(uAtClientHandle_t atHandle);
+
+/** Get the statistics that an AT client has gathered about the
+ * AT commands it has sent, one entry per command; only available
+ * if #U_AT_CLIENT_STATS_NUM_COMMANDS is non-zero.  Use this to
+ * find out which AT commands dominate the time spent talking to
+ * the AT server.
+ *
+ * @param atHandle     the handle of the AT client.
+ * @param[out] pStats  a pointer to an array of numStats entries
+ *                     into which the statistics will be written,
+ *                     in the order the commands were first sent;
+ *                     may be NULL if numStats is zero.
+ * @param numStats     the number of entries at pStats.
+ * @return             the number of commands for which statistics
+ *                     are held, which may be more than numStats,
+ *                     else negative error code;
+ *                     #U_ERROR_COMMON_NOT_SUPPORTED is returned if
+ *                     #U_AT_CLIENT_STATS_NUM_COMMANDS is zero.
+ */
+int32_t uAtClientStatsGet(uAtClientHandle_t atHandle,
+                          uAtClientStats_t *pStats,
+                          size_t numStats);
+
+/** Reset the statistics that an AT client has gathered about
+ * the AT commands it has sent.
+ *
+ * @param atHandle  the handle of the AT client.
+ */
+void uAtClientStatsReset(uAtClientHandle_t atHandle);
+
 /** Tell the given AT client to throw away asynchronous events; use NULL
  * as the parameter to apply this to all AT clients.  This function
  * is useful when the application that is using the AT client is shutting
@@ -793,6 +1009,46 @@ int32_t uAtClientUnlock(uAtClientHandle_t atHandle);
 void uAtClientCommandStart(uAtClientHandle_t atHandle,
                            const char *pCommand);
 
+/** Append a further, independent, AT command to the AT command
+ * line begun with uAtClientCommandStart(), e.g. to send
+ * `AT+CSQ;+UCGED?` in one go; this allows a batch of commands
+ * to be in flight with the AT server at once, saving a round
+ * trip per command.  Parameters for the appended command may
+ * be written with uAtClientWriteInt() etc. as normal.  Once the
+ * batch is complete, call uAtClientCommandStop() and then read
+ * the responses, which are returned by the AT server in the
+ * order the commands were sent, each one beginning with a call
+ * to uAtClientResponseStart() as usual; there is then a
+ * single uAtClientResponseStop() for the whole batch, e.g.:
+ *
+ * ```
+ * uAtClientLock(client);
+ * uAtClientCommandStart(client, "AT+CSQ");
+ * uAtClientCommandAppend(client, "+UCGED?");
+ * uAtClientCommandStop(client);
+ * uAtClientResponseStart(client, "+CSQ:");
+ * ...
+ * uAtClientResponseStart(client, "+UCGED:");
+ * ...
+ * uAtClientResponseStop(client);
+ * uAtClientUnlock(client);
+ * ```
+ *
+ * Note that the AT server stops processing the command line at
+ * the first command which fails, returning a single `ERROR`
+ * for the lot, hence only batch commands where this behaviour
+ * is acceptable; also bear in mind that the AT server will have
+ * a limit on the length of a command line (for u-blox modules
+ * this is usually at least 1024 characters).
+ *
+ * @param atHandle      the handle of the AT client.
+ * @param[in] pCommand  the null-terminated command string; a
+ *                      leading "AT" may be included, it will
+ *                      be ignored.
+ */
+void uAtClientCommandAppend(uAtClientHandle_t atHandle,
+                            const char *pCommand);
+
 /** Write an integer-type AT command parameter to the AT
  * command sequence, used after uAtClientCommandStart()
  * has been called to start the AT command sequence. The
@@ -868,6 +1124,26 @@ size_t uAtClientWriteBytes(uAtClientHandle_t atHandle,
                            bool standalone);
 
 
+/** Write a list of byte sequences as though they were a single
+ * sequence, e.g. a prefix, a payload and a suffix, without the
+ * caller having to copy them into one buffer first; the pieces
+ * are gathered (see #U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES) so that
+ * they are given to the stream in as few writes as possible.
+ * In all other respects this behaves as uAtClientWriteBytes().
+ *
+ * @param atHandle     the handle of the AT client.
+ * @param[in] pIoVec   an array of byte sequences to write; cannot
+ *                     be NULL.
+ * @param ioVecCount   the number of elements at pIoVec.
+ * @param standalone   set this to true if the bytes should be
+ *                     written on their own (see uAtClientWriteBytes()).
+ * @return             the total number of bytes written.
+ */
+size_t uAtClientWriteVec(uAtClientHandle_t atHandle,
+                         const uAtClientIoVec_t *pIoVec,
+                         size_t ioVecCount,
+                         bool standalone);
+
 /** Write a part of a string argument to AT command sequence.
  * Used after uAtClientCommandStart() has been called to
  * start the AT command sequence.
@@ -1067,6 +1343,70 @@ int32_t uAtClientReadBytes(uAtClientHandle_t atHandle,
                            char *pBuffer, size_t lengthBytes,
                            bool standalone);
 
+/** Borrow received bytes directly from the receive buffer of the
+ * AT client, avoiding the copy that uAtClientReadBytes() would
+ * perform; useful when reading large amounts of binary data,
+ * e.g. from a socket or a file, where the caller can copy the
+ * data straight to its final destination.  This may only be
+ * called when uAtClientIgnoreStopTag() is in force, i.e. the
+ * bytes are binary data of known length.
+ *
+ * If there are no unread bytes in the receive buffer this
+ * function will wait, up to the AT timeout, for more to arrive.
+ * The bytes are NOT consumed by this function: once the
+ * caller has finished with them uAtClientReadBytesInPlaceRelease()
+ * must be called with the number of bytes that have been used
+ * and, until then, no other uAtClientReadXxx() or
+ * uAtClientSkipXxx() function may be called since they may move
+ * the contents of the receive buffer.  Since the receive buffer
+ * is of limited size the number of bytes returned may be fewer
+ * than lengthBytes: callers should loop until they have all that
+ * they need.
+ *
+ * @param atHandle      the handle of the AT client.
+ * @param[out] ppData   a place to put a pointer to the first
+ *                      unread byte in the receive buffer; cannot
+ *                      be NULL.
+ * @param lengthBytes   the maximum number of bytes wanted.
+ * @return              the number of contiguous bytes available
+ *                      at *ppData, which will be at most lengthBytes,
+ *                      or negative error code.
+ */
+int32_t uAtClientReadBytesInPlace(uAtClientHandle_t atHandle,
+                                  const char **ppData,
+                                  size_t lengthBytes);
+
+/** Consume bytes that were borrowed with uAtClientReadBytesInPlace().
+ *
+ * @param atHandle      the handle of the AT client.
+ * @param lengthBytes   the number of bytes to consume; should be
+ *                      no more than the value returned by the
+ *                      preceding call to uAtClientReadBytesInPlace().
+ */
+void uAtClientReadBytesInPlaceRelease(uAtClientHandle_t atHandle,
+                                      size_t lengthBytes);
+
+/** Read whatever raw bytes are available, without waiting and
+ * without regard to stop tags: first anything already in the
+ * receive buffer is returned, else the stream is read once,
+ * without blocking.  This is intended for when the module is
+ * in a transparent data mode (e.g. a direct-link socket) and
+ * the caller holds the lock, so that there are no AT responses
+ * or URCs in the stream.  Must be called between uAtClientLock()
+ * and uAtClientUnlock().
+ *
+ * @param atHandle      the handle of the AT client.
+ * @param[out] pBuffer  a buffer in which to place the bytes
+ *                      read; may be NULL, in which case the
+ *                      bytes are thrown away.
+ * @param lengthBytes   the maximum number of bytes to read.
+ * @return              the number of bytes read, zero if there
+ *                      were none, else negative error code.
+ */
+int32_t uAtClientReadBytesAvailable(uAtClientHandle_t atHandle,
+                                    char *pBuffer,
+                                    size_t lengthBytes);
+
 /** Read binary data received as a hex string from from the
  *  AT response
  *
@@ -1373,6 +1713,30 @@ int32_t uAtClientCallback(uAtClientHandle_t atHandle,
                           void (*pCallback) (uAtClientHandle_t, void *),
                           void *pCallbackParam);
 
+/** As uAtClientCallback() but the callback is queued on the
+ * priority callback queue, which has its own task with a stack
+ * size of #U_AT_CLIENT_PRIORITY_CALLBACK_TASK_STACK_SIZE_BYTES
+ * running at priority #U_AT_CLIENT_PRIORITY_CALLBACK_TASK_PRIORITY.
+ * Use this for short callbacks whose latency matters, so that
+ * they are not delayed by slow callbacks queued through
+ * uAtClientCallback().  Callbacks queued with this function are
+ * run in the order they are called but there is NO ordering
+ * guarantee between them and callbacks queued with
+ * uAtClientCallback(); if two callbacks must run in a given
+ * order, queue them with the same function.  If
+ * #U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH is zero (the
+ * default) this is the same as calling uAtClientCallback().
+ *
+ * @param atHandle            the handle of the AT client.
+ * @param[in] pCallback       the callback function.
+ * @param[in] pCallbackParam  a parameter to pass to the callback,
+ *                            as the second parameter, may be NULL.
+ * @return                    zero on success else negative error code.
+ */
+int32_t uAtClientCallbackPriority(uAtClientHandle_t atHandle,
+                                  void (*pCallback) (uAtClientHandle_t, void *),
+                                  void *pCallbackParam);
+
 /** Get the stack high watermark for the task at the end of the
  * AT callback event queue, the minimum amount of free stack
  * space.  If this gets close to zero you either need to do less
@@ -67,6 +67,7 @@
 #include "u_short_range_edm_stream.h"
 
 #include "u_hex_bin_convert.h"
+#include "u_trace.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -181,6 +182,27 @@
 # define U_AT_CLIENT_CALLBACK_QUEUE_YIELD_MS 50
 #endif
 
+#ifndef U_AT_CLIENT_URC_HASH_NUM_BUCKETS
+/** The number of hash buckets that URC handlers are sorted into,
+ * must be a power of two.  When a line arrives only the handlers
+ * in the bucket selected by the first
+ * #U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES characters of the line
+ * (plus any handlers with prefixes shorter than that) need be
+ * compared, rather than every handler that has been registered.
+ */
+# define U_AT_CLIENT_URC_HASH_NUM_BUCKETS 16
+#endif
+
+#ifndef U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES
+/** The number of characters at the start of a URC prefix that
+ * are used to form its hash key; since almost all URC prefixes
+ * begin with "+U" or "+C" this needs to be reasonably long to
+ * be discriminating.  Prefixes shorter than this are kept on
+ * a separate list which is always checked.
+ */
+# define U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES 5
+#endif
+
 /** Guard for the URC task data receive loop to make
  * sure it can't be drowned by the incoming stream,
  * preventing control commands from getting in.
@@ -263,6 +285,11 @@
 # error U_AT_CLIENT_CALLBACK_TASK_PRIORITY must be less than U_AT_CLIENT_URC_TASK_PRIORITY
 #endif
 
+#if (U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH > 0) && \
+    (U_AT_CLIENT_PRIORITY_CALLBACK_TASK_PRIORITY >= U_AT_CLIENT_URC_TASK_PRIORITY)
+# error U_AT_CLIENT_PRIORITY_CALLBACK_TASK_PRIORITY must be less than U_AT_CLIENT_URC_TASK_PRIORITY
+#endif
+
 #ifdef U_CFG_AT_CLIENT_DETAILED_DEBUG
 /** Macros for detailed debugging of buffering behaviour.
  * This one for use inside the bufferFill() function.
@@ -327,6 +354,7 @@ typedef struct uAtClientUrc_t {
     size_t prefixLength;       /** The length of pPrefix. */
     void (*pHandler) (uAtClientHandle_t, void *); /** The handler to call if pPrefix is matched. */
     void *pHandlerParam;       /** The parameter to pass to pHandler. */
+    struct uAtClientUrc_t *pNextInBucket; /** The next URC in the same hash bucket. */
     struct uAtClientUrc_t *pNext;
 } uAtClientUrc_t;
 
@@ -416,15 +444,34 @@ typedef struct {
     uPortMutexHandle_t *pNextFree;
 } uAtClientMutexStack_t;
 
+/** The functions of a type of stream that the AT client calls
+ * while sending and receiving, resolved once when the AT client
+ * is added rather than by switching on the stream type every time;
+ * a NULL pointer means that the operation happens elsewhere (e.g.
+ * for EDM writes go through the transmit intercept function).
+ */
+typedef struct {
+    int32_t (*pRead)(const uAtClientStreamHandle_t *pStream, char *pBuffer,
+                     size_t sizeBytes);
+    int32_t (*pWrite)(const uAtClientStreamHandle_t *pStream, const char *pData,
+                      size_t sizeBytes);
+    int32_t (*pGetReceiveSize)(const uAtClientStreamHandle_t *pStream);
+} uAtClientStreamFunctions_t;
+
 /** Definition of an AT client instance.
  */
 typedef struct uAtClientInstance_t {
     int32_t magicNumber; /** The magic number that uniquely identifies this AT client. */
     uAtClientStreamHandle_t stream; /** The stream handle to use. */
+    const uAtClientStreamFunctions_t *pStreamFunctions; /** The functions of stream. */
     uPortMutexHandle_t mutex; /** Mutex for threadsafeness. */
     uPortMutexHandle_t streamMutex; /** Mutex for the data stream. */
     uPortMutexHandle_t urcPermittedMutex; /** Mutex that we can use to avoid trampling on a URC. */
     uAtClientReceiveBuffer_t *pReceiveBuffer; /** Pointer to the receive buffer structure. */
+    size_t receiveBufferSizeInitial; /** The data buffer size that pReceiveBuffer was created with. */
+    size_t receiveBufferSizeMax; /** The data buffer size that pReceiveBuffer may grow to. */
+    int32_t receiveBufferBusyTimeMs; /** When pReceiveBuffer last held more than receiveBufferSizeInitial. */
+    size_t receiveBufferHighWaterMark; /** The most that has been held in pReceiveBuffer. */
     bool debugOn; /** Whether general debug is on or off. */
     bool printAtOn; /** Whether printing of AT commands and responses is on or off. */
     bool newSendNextTime; /** Flag used when printing timestamps in the log. */
@@ -441,12 +488,27 @@ typedef struct uAtClientInstance_t {
     uAtClientTag_t stopTag; /** The stop tag for the current scope. */
     uAtClientUrc_t *pUrcList; /** Linked-list anchor for URC handlers. */
     uAtClientUrc_t *pUrcRead;  /** Pointer used when reading the URC handlers. */
+    /** Hash buckets into which the URC handlers in pUrcList are sorted,
+        the last entry being for handlers with a prefix shorter than
+        U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES. */
+    uAtClientUrc_t *pUrcBucket[U_AT_CLIENT_URC_HASH_NUM_BUCKETS + 1];
     int32_t lastResponseStopMs; /** The time the last response ended in milliseconds. */
     int32_t lockTimeMs; /** The time when the stream was locked. */
     int32_t lastTxTimeMs; /** The time when the last transmit activity was carried out, set to -1 initially. */
     size_t urcMaxStringLength; /** The longest URC string to monitor for. */
     size_t maxRespLength; /** The max length of OK, (CME) (CMS) ERROR and URCs. */
     bool delimiterRequired; /** Is a delimiter to be inserted before the next parameter or not. */
+#if U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES > 0
+    char txBuffer[U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES]; /** Where writes are gathered before being sent to the stream. */
+    size_t txBufferLength; /** The number of bytes in txBuffer. */
+    bool txBufferFlushing; /** Set while txBuffer is being written to the stream. */
+#endif
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    uAtClientStats_t stats[U_AT_CLIENT_STATS_NUM_COMMANDS]; /** Statistics, one entry per command. */
+    size_t numStats; /** The number of entries of stats that are in use. */
+    uAtClientStats_t *pStatsCurrent; /** The entry in stats for the command in progress, else NULL. */
+    int32_t statsStartTimeMs; /** The time at which the command in progress was started. */
+#endif
     uAtClientMutexStack_t lockedStreamMutexStack; /** A place to store locked stream mutexes. */
     void (*pUrcHijackInt32)(int32_t, uint32_t, void *); /** Hijack function, deprecated form. */
     void (*pUrcHijackExt)(const uAtClientStreamHandle_t *, uint32_t, void *); /** Hijack function. */
@@ -466,6 +528,7 @@ typedef struct uAtClientInstance_t {
                                    as its fourth parameter. */
     uAtClientWakeUp_t *pWakeUp; /** Pointer to a wake-up handler structure. */
     uAtClientActivityPin_t *pActivityPin; /** Pointer to an activity pin structure. */
+    bool traceInResponse; /** True if a U_TRACE_STAGE_AT_RESPONSE stage has been pushed. */
     struct uAtClientInstance_t *pNext;
 } uAtClientInstance_t;
 
@@ -544,6 +607,13 @@ static const uAtClientTagDef_t gNoStopTag = {"", 0};
  */
 static int32_t gEventQueueHandle;
 
+#if U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH > 0
+/** The event queue for priority callbacks, protected by
+ * gMutexEventQueue in the same way as gEventQueueHandle.
+ */
+static int32_t gEventQueueHandlePriority;
+#endif
+
 /** Mutex to protect gEventQueueHandle.
  * Note: the reason for this being separate to gMutex is
  * because uAtClientCallback(), which needs to ensure that
@@ -730,6 +800,85 @@ static void printLogDebug(const uAtClientDetailedDebug_t *pDebug,
 }
 #endif
 
+// The stream functions for a UART.
+static int32_t streamReadUart(const uAtClientStreamHandle_t *pStream,
+                              char *pBuffer, size_t sizeBytes)
+{
+    return uPortUartRead(pStream->handle.int32, pBuffer, sizeBytes);
+}
+
+static int32_t streamWriteUart(const uAtClientStreamHandle_t *pStream,
+                               const char *pData, size_t sizeBytes)
+{
+    return uPortUartWrite(pStream->handle.int32, pData, sizeBytes);
+}
+
+static int32_t streamGetReceiveSizeUart(const uAtClientStreamHandle_t *pStream)
+{
+    return uPortUartGetReceiveSize(pStream->handle.int32);
+}
+
+// The stream functions for EDM; writes are made by the
+// transmit intercept function.
+static int32_t streamReadEdm(const uAtClientStreamHandle_t *pStream,
+                             char *pBuffer, size_t sizeBytes)
+{
+    return uShortRangeEdmStreamAtRead(pStream->handle.int32, pBuffer, sizeBytes);
+}
+
+static int32_t streamGetReceiveSizeEdm(const uAtClientStreamHandle_t *pStream)
+{
+    return uShortRangeEdmStreamAtGetReceiveSize(pStream->handle.int32);
+}
+
+// The stream functions for a virtual serial device.
+static int32_t streamReadVirtualSerial(const uAtClientStreamHandle_t *pStream,
+                                       char *pBuffer, size_t sizeBytes)
+{
+    uDeviceSerial_t *pDeviceSerial = pStream->handle.pDeviceSerial;
+
+    return pDeviceSerial->read(pDeviceSerial, pBuffer, sizeBytes);
+}
+
+static int32_t streamWriteVirtualSerial(const uAtClientStreamHandle_t *pStream,
+                                        const char *pData, size_t sizeBytes)
+{
+    uDeviceSerial_t *pDeviceSerial = pStream->handle.pDeviceSerial;
+
+    return pDeviceSerial->write(pDeviceSerial, pData, sizeBytes);
+}
+
+static int32_t streamGetReceiveSizeVirtualSerial(const uAtClientStreamHandle_t *pStream)
+{
+    uDeviceSerial_t *pDeviceSerial = pStream->handle.pDeviceSerial;
+
+    return pDeviceSerial->getReceiveSize(pDeviceSerial);
+}
+
+/** The stream functions, indexed by stream type; defined here
+ * rather than under VARIABLES since they point at the functions
+ * above.
+ */
+static const uAtClientStreamFunctions_t gStreamFunctions[] = {
+    // U_AT_CLIENT_STREAM_TYPE_UART
+    {streamReadUart, streamWriteUart, streamGetReceiveSizeUart},
+    // U_AT_CLIENT_STREAM_TYPE_EDM
+    {streamReadEdm, NULL, streamGetReceiveSizeEdm},
+    // U_AT_CLIENT_STREAM_TYPE_VIRTUAL_SERIAL
+    {streamReadVirtualSerial, streamWriteVirtualSerial, streamGetReceiveSizeVirtualSerial}
+};
+
+#ifdef U_AT_CLIENT_STREAM_TYPE_ONLY
+/** With only one type of stream the functions are known at compile
+ * time and so can be called directly.
+ */
+# define U_AT_CLIENT_STREAM_FUNCTIONS(pClient) (&(gStreamFunctions[U_AT_CLIENT_STREAM_TYPE_ONLY]))
+#else
+/** Get the stream functions of an AT client.
+ */
+# define U_AT_CLIENT_STREAM_FUNCTIONS(pClient) ((pClient)->pStreamFunctions)
+#endif
+
 // Find an AT client instance in the list by stream handle.
 // gMutex should be locked before this is called.
 static uAtClientInstance_t *pGetAtClientInstance(const uAtClientStreamHandle_t *pStream)
@@ -882,6 +1031,7 @@ static void removeClient(uAtClientInstance_t *pClient)
         pClient->pUrcList = pUrc->pNext;
         uPortFree(pUrc);
     }
+    memset(pClient->pUrcBucket, 0, sizeof(pClient->pUrcBucket));
 
     // Remove any activity pin
     uPortFree(pClient->pActivityPin);
@@ -1101,19 +1251,34 @@ static uPortMutexHandle_t streamTryLock(const uAtClientInstance_t *pClient,
     return streamMutex;
 }
 
-// Find one character buffer inside another.
+// Find one character buffer inside another.  Rather than comparing
+// at every position, memchr() (which the C library will usually have
+// optimised to work a word or more at a time) is used to hop
+// between occurrences of the first character of pFind and only
+// then is memcmp() called on the remainder.  The strings searched
+// for are all short (e.g. stop tags) so this is quicker than
+// building any sort of skip table.
 static const char *pMemStr(const char *pBuffer,
                            size_t bufferLength,
                            const char *pFind,
                            size_t findLength)
 {
     const char *pPos = NULL;
-
-    if (bufferLength >= findLength) {
-        for (size_t x = 0; (pPos == NULL) &&
-             (x < (bufferLength - findLength) + 1); x++) {
-            if (memcmp(pBuffer + x, pFind, findLength) == 0) {
-                pPos = pBuffer + x;
+    const char *pEnd;
+
+    if (findLength == 0) {
+        pPos = pBuffer;
+    } else if (bufferLength >= findLength) {
+        pEnd = pBuffer + (bufferLength - findLength) + 1;
+        while ((pPos == NULL) && (pBuffer < pEnd)) {
+            pBuffer = (const char *) memchr(pBuffer, *pFind, pEnd - pBuffer);
+            if (pBuffer == NULL) {
+                pBuffer = pEnd;
+            } else if ((findLength == 1) ||
+                       (memcmp(pBuffer + 1, pFind + 1, findLength - 1) == 0)) {
+                pPos = pBuffer;
+            } else {
+                pBuffer++;
             }
         }
     }
@@ -1121,6 +1286,39 @@ static const char *pMemStr(const char *pBuffer,
     return pPos;
 }
 
+// Work out the hash bucket for a string of the given length:
+// if the string is too short to form a key then the "short"
+// bucket, the last one, is returned.
+static size_t urcBucketIndex(const char *pString, size_t length)
+{
+    size_t index = U_AT_CLIENT_URC_HASH_NUM_BUCKETS;
+    size_t hash = 0;
+
+    if (length >= U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES) {
+        for (size_t x = 0; x < U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES; x++) {
+            hash = (hash * 31) + (unsigned char) * (pString + x);
+        }
+        index = hash & (U_AT_CLIENT_URC_HASH_NUM_BUCKETS - 1);
+    }
+
+    return index;
+}
+
+// Unlink a URC from its hash bucket.
+static void urcBucketRemove(uAtClientInstance_t *pClient,
+                            const uAtClientUrc_t *pUrc)
+{
+    uAtClientUrc_t **ppUrc = &(pClient->pUrcBucket[urcBucketIndex(pUrc->pPrefix,
+                                                                  pUrc->prefixLength)]);
+
+    while ((*ppUrc != NULL) && (*ppUrc != pUrc)) {
+        ppUrc = &((*ppUrc)->pNextInBucket);
+    }
+    if (*ppUrc != NULL) {
+        *ppUrc = pUrc->pNextInBucket;
+    }
+}
+
 // Print out AT commands and responses.
 static void printAt(uAtClientInstance_t *pClient,
                     const char *pAt, size_t length, bool sending)
@@ -1268,171 +1466,589 @@ static int32_t pollTimeRemaining(int32_t atTimeoutMs,
     return (int32_t) timeRemainingMs;
 }
 
-// Zero the buffer.
-// totalReset also clears out any buffered data that
-// may be awaiting processing by a receive intercept
-// function
-static void bufferReset(const uAtClientInstance_t *pClient,
-                        bool totalReset)
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+// Return true if a wake-up handler is being run, in which case the
+// commands it sends are not counted since they would be confused
+// with the command that caused the wake-up.
+static bool statsInWakeUp(const uAtClientInstance_t *pClient)
 {
-#if U_CFG_ENABLE_LOGGING
-    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
-#endif
-    uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
+    return (pClient->pWakeUp != NULL) && (pClient->pWakeUp->wakeUpTask != NULL);
+}
 
-    LOG_IF(totalReset, 200);
-    // If there is no receive intercept function then
-    // the buffered data can be reset also
-    if (totalReset || (pClient->pInterceptRx == NULL)) {
-        pBuffer->lengthBuffered = 0;
+// Start timing a command, adding an entry for it if there isn't one.
+static void statsStart(uAtClientInstance_t *pClient, const char *pCommand)
+{
+    uAtClientStats_t *pStats = NULL;
+    // Include any '=' or '?' so that reads and writes are distinguished
+    size_t length = strcspn(pCommand, "=?");
+
+    if (pCommand[length] != 0) {
+        length++;
+    }
+    if (length > U_AT_CLIENT_STATS_PREFIX_LENGTH_BYTES) {
+        length = U_AT_CLIENT_STATS_PREFIX_LENGTH_BYTES;
     }
 
-    if (pBuffer->lengthBuffered > 0) {
-        LOG_IF(!totalReset, 201);
-        if (pBuffer->length > pBuffer->lengthBuffered) {
-            // This should never occur, but if it did
-            // it would not be good so best be safe.
-            if (pClient->debugOn) {
-                uPortLog("U_AT_CLIENT_%d-%d%s: *** WARNING ***"
-                         " lengthBuffered (%d) > length (%d).\n",
-                         pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
-                         pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)),
-                         pBuffer->lengthBuffered, pBuffer->length);
+    if (!statsInWakeUp(pClient)) {
+        for (size_t x = 0; (x < pClient->numStats) && (pStats == NULL); x++) {
+            if ((strncmp(pClient->stats[x].prefix, pCommand, length) == 0) &&
+                (pClient->stats[x].prefix[length] == 0)) {
+                pStats = &(pClient->stats[x]);
             }
-            pBuffer->length = pBuffer->lengthBuffered;
         }
-        // If there is stuff buffered, which will be beyond
-        // length, need to move that down when we reset
-        memmove(((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t),
-                ((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t) + pBuffer->length,
-                pBuffer->lengthBuffered - pBuffer->length);
-        U_ASSERT(U_AT_CLIENT_GUARD_CHECK(pBuffer));
-        pBuffer->lengthBuffered -= pBuffer->length;
+        if ((pStats == NULL) && (pClient->numStats < U_AT_CLIENT_STATS_NUM_COMMANDS)) {
+            pStats = &(pClient->stats[pClient->numStats]);
+            pClient->numStats++;
+            memset(pStats, 0, sizeof(*pStats));
+            memcpy(pStats->prefix, pCommand, length);
+            pStats->minMs = INT_MAX;
+        }
+        pClient->pStatsCurrent = pStats;
+        pClient->statsStartTimeMs = uPortGetTickTimeMs();
     }
-    pBuffer->readIndex = 0;
-    pBuffer->length = 0;
 }
 
-// Set the read position to 0 and move the buffer's
-// unread content to the beginning.
-static void bufferRewind(const uAtClientInstance_t *pClient)
+// Stop timing the command in progress, if there is one.
+static void statsStop(uAtClientInstance_t *pClient)
 {
-    uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
-#if U_CFG_ENABLE_LOGGING
-    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
-#endif
-
-    LOG(100);
-    if ((pBuffer->readIndex > 0) &&
-        (pBuffer->length >= pBuffer->readIndex)) {
-        if (pBuffer->lengthBuffered < pBuffer->readIndex) {
-            // This should never occur, but if it did
-            // it would not be good so best be safe.
-            if (pClient->debugOn) {
-                uPortLog("U_AT_CLIENT_%d-%d%s: *** WARNING ***"
-                         " lengthBuffered (%d) < readIndex (%d).\n",
-                         pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
-                         pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)),
-                         pBuffer->lengthBuffered, pBuffer->readIndex);
-            }
-            pBuffer->lengthBuffered = pBuffer->readIndex;
+    uAtClientStats_t *pStats = pClient->pStatsCurrent;
+    int32_t durationMs;
+    size_t bin = 0;
+
+    if ((pStats != NULL) && !statsInWakeUp(pClient)) {
+        durationMs = uPortGetTickTimeMs() - pClient->statsStartTimeMs;
+        if (durationMs < 0) {
+            durationMs = 0;
         }
-        pBuffer->length -= pBuffer->readIndex;
-        pBuffer->lengthBuffered -= pBuffer->readIndex;
-        LOG(101);
-        // Move what has not been read to the
-        // beginning of the buffer
-        memmove(((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t),
-                ((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t) + pBuffer->readIndex,
-                pBuffer->lengthBuffered);
-        U_ASSERT(U_AT_CLIENT_GUARD_CHECK(pBuffer));
-        pBuffer->readIndex = 0;
-        LOG(102);
+        pStats->count++;
+        if (pClient->numConsecutiveAtTimeouts > 0) {
+            pStats->timeoutCount++;
+        }
+        if (durationMs < pStats->minMs) {
+            pStats->minMs = durationMs;
+        }
+        if (durationMs > pStats->maxMs) {
+            pStats->maxMs = durationMs;
+        }
+        pStats->totalMs += durationMs;
+        // The bin is the number of significant bits in the duration
+        while ((durationMs > 0) && (bin < U_AT_CLIENT_STATS_HISTOGRAM_NUM_BINS - 1)) {
+            durationMs >>= 1;
+            bin++;
+        }
+        pStats->histogram[bin]++;
+        pClient->pStatsCurrent = NULL;
     }
 }
 
-// Read from the UART/serial interface in nice coherent lines.
-static int32_t serialReadNoStutter(uAtClientInstance_t *pClient,
-                                   uAtClientBlockState_t blockState,
-                                   int32_t atTimeoutMs)
+// Add to the bytes sent or received by the command in progress.
+static void statsAddBytes(const uAtClientInstance_t *pClient,
+                          size_t length, bool isTx)
 {
-    int32_t readLength = 0;
-    int32_t thisReadLength;
-    uDeviceSerial_t *pDeviceSerial;
-    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
-    char *pBuffer = U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
-                    pReceiveBuffer->lengthBuffered;
-    int32_t bufferSize = pReceiveBuffer->dataBufferSize -
-                         pReceiveBuffer->lengthBuffered;
+    uAtClientStats_t *pStats = pClient->pStatsCurrent;
 
-    // Retry the read until we're sure there's nothing
-    do {
-        thisReadLength = 0;
-        switch (pClient->stream.type) {
-            case U_AT_CLIENT_STREAM_TYPE_UART:
-                thisReadLength = uPortUartRead(pClient->stream.handle.int32,
-                                               pBuffer, bufferSize);
-                break;
-            case U_AT_CLIENT_STREAM_TYPE_VIRTUAL_SERIAL:
-                pDeviceSerial = pClient->stream.handle.pDeviceSerial;
-                thisReadLength = pDeviceSerial->read(pDeviceSerial, pBuffer, bufferSize);
-                break;
-            default:
-                break;
-        }
-        if (thisReadLength > 0) {
-            readLength += thisReadLength;
-            pBuffer += thisReadLength;
-            bufferSize -= thisReadLength;
-            if (blockState == U_AT_CLIENT_BLOCK_STATE_NOTHING_RECEIVED) {
-                // Got something: now wait for more
-                blockState = U_AT_CLIENT_BLOCK_STATE_WAIT_FOR_MORE;
-                uPortTaskBlock(U_AT_CLIENT_STREAM_READ_RETRY_DELAY_MS);
-            }
+    if ((pStats != NULL) && !statsInWakeUp(pClient)) {
+        if (isTx) {
+            pStats->txBytes += (int32_t) length;
         } else {
-            if (blockState == U_AT_CLIENT_BLOCK_STATE_WAIT_FOR_MORE) {
-                // We were waiting for more but we have received nothing
-                // so stop blocking now
-                blockState = U_AT_CLIENT_BLOCK_STATE_DO_NOT_BLOCK;
-            } else {
-                uPortTaskBlock(U_AT_CLIENT_STREAM_READ_RETRY_DELAY_MS);
-            }
-
+            pStats->rxBytes += (int32_t) length;
         }
-    } while ((bufferSize > 0) &&
-             (blockState != U_AT_CLIENT_BLOCK_STATE_DO_NOT_BLOCK) &&
-             (pollTimeRemaining(atTimeoutMs, pClient->lockTimeMs) > 0));
-
-    return readLength;
+    }
 }
+#endif
 
-// This is where data comes into the AT client.
-// Read from the stream into the receive buffer.
-// Returns true on a successful read or false on timeout.
-static bool bufferFill(uAtClientInstance_t *pClient,
-                       bool blocking)
+// Write data to the stream.
+//
+// Design note concerning the wake-up handler
+// process below; first the needs:
+// - the wake-up handler must be allowed to call back
+//   into this AT interface, one level of recursion.
+// - the wake-up handler must be allowed to launch
+//   asynchronous callbacks that may also call into
+//   this AT interface.
+// - these asynchronous callbacks must be blocked
+//   from doing AT things while the wake-up process
+//   is occurring and then be allowed to continue
+//   once the wake-up has been completed.
+// Given those needs, the design here is: when wake-up
+// is required inWakeUpHandlerMutex is locked and
+// the current task ID saved before the wake-up function
+// is called. The U_AT_CLIENT_LOCK_CLIENT_MUTEX that
+// gates every AT client API call checks the current
+// task ID against this saved task ID and, if it
+// matches, it blocks against a separate wake-up mutex
+// rather than the normal mutex.  If the task ID does
+// not match then it _also_ blocks on inWakeUpHandlerMutex
+// before proceeding, hence holding off processing until
+// the wake-up process has completed.
+static size_t writeStream(uAtClientInstance_t *pClient,
+                          const char *pData, size_t length,
+                          bool andFlush)
 {
-    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
-    int32_t atTimeoutMs = -1;
-    int32_t readLength = 0;
-    size_t x = 0;
-    size_t y = 0;
-    size_t z = 0;
-    size_t length;
-    uDeviceSerial_t *pDeviceSerial;
-    bool eventIsCallback = false;
-    char *pData = NULL;
-    //lint -esym(838, pDataIntercept) Suppress initial value not used: it
-    // is if detailed debugging is on
-    char *pDataIntercept = NULL;
-    uAtClientBlockState_t blockState = U_AT_CLIENT_BLOCK_STATE_DO_NOT_BLOCK;
-#if U_CFG_ENABLE_LOGGING
-    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
-#endif
+    int32_t thisLengthWritten = 0;
+    int32_t (*pWrite)(const uAtClientStreamHandle_t *, const char *, size_t);
+    size_t lengthToWrite;
+    bool traced;
+    const char *pDataStart = pData;
+    const char *pDataToWrite = pData;
+    // cppcheck insists that pDataStart + length can be
+    // out of bounds if length is 23 when being called
+    // from uAtClientWriteUint64(), where length is checked
+    // against the size of numberString, which is 24.
+    // I can't see how that's possible: maybe the
+    // the ORing with andFlush below is confusing it?
+    // codechecker_suppress [cppcheck-pointerOutOfBoundsCond] "pDataStart + length is not out of bounds"
+    const char *pDataEnd = pDataStart + length;
+    int32_t savedLockTimeMs;
+    int32_t wakeUpDurationMs = 0;
+    uAtClientScope_t savedScope;
+    uAtClientTag_t savedStopTag;
+    bool savedDelimiterRequired;
+    uAtClientDeviceError_t savedDeviceError;
 
-    // Determine if we're in a callback or not
-    switch (pClient->stream.type) {
-        case U_AT_CLIENT_STREAM_TYPE_UART:
+    while (((pData < pDataEnd) || andFlush) &&
+           (pClient->error == U_ERROR_COMMON_SUCCESS)) {
+        lengthToWrite = length - (pData - pDataStart);
+        if ((pClient->pWakeUp != NULL) && (pClient->lastTxTimeMs >= 0) &&
+            (uPortGetTickTimeMs() - pClient->lastTxTimeMs > pClient->pWakeUp->inactivityTimeoutMs) &&
+            (uPortMutexTryLock(pClient->pWakeUp->inWakeUpHandlerMutex, 0) == 0)) {
+            // We have a wake-up handler, the inactivity timeout
+            // has expired and we've managed to lock the wake-up
+            // handler mutex (if we aren't able to lock the wake-up
+            // handler mutex  then we must already be in the wake-up
+            // handler, having recursed, so can just continue); now
+            // we need to call the wake-up handler function.
+            // Set wakeUpTask to the current task handle so
+            // that any future calls can be locked against the
+            // separate pWakeUp->mutex if they come from the task
+            // we're in at the moment, the one dealing with the wake-up
+            uPortTaskGetHandle(&(pClient->pWakeUp->wakeUpTask));
+            // The pClient->mutex will have been locked on the way
+            // into here by U_AT_CLIENT_LOCK_CLIENT_MUTEX.
+            // Remember the lock time and measure how long
+            // waking-up takes in order to correct for it
+            savedLockTimeMs = pClient->lockTimeMs;
+            wakeUpDurationMs = uPortGetTickTimeMs();
+            // Remember the dynamic things that the
+            // wake-up handler might overwrite
+            savedScope = pClient->scope;
+            savedStopTag = pClient->stopTag;
+            savedDelimiterRequired = pClient->delimiterRequired;
+            savedDeviceError = pClient->deviceError;
+            // Reset the scope, stopTag and delimiterRequired
+            pClient->scope = U_AT_CLIENT_SCOPE_NONE;
+            pClient->stopTag.pTagDef = &gNoStopTag;
+            pClient->stopTag.found = false;
+            pClient->delimiterRequired = false;
+            // Now actually call the wake-up callback which may recurse
+            // back into here
+            if (pClient->pWakeUp->pHandler((uAtClientHandle_t) pClient,
+                                           pClient->pWakeUp->pParam) != 0) {
+                setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
+            }
+            // At this point all of the calls back into here
+            // performed as part of the wake-up process will have
+            // been completed; there may have been calls from other
+            // tasks but they will have been blocked on the normal
+            // mutex before reaching here.
+            // We can now set the wakeUpTask back to NULL and all
+            // blocking will be on the normal mutex again
+            pClient->pWakeUp->wakeUpTask = NULL;
+            // Put all the saved things back
+            pClient->scope = savedScope;
+            pClient->stopTag = savedStopTag;
+            pClient->delimiterRequired = savedDelimiterRequired;
+            pClient->deviceError = savedDeviceError;
+            // Set the adjusted lock time, allowing for potential
+            // wrap in uPortGetTickTimeMs()
+            wakeUpDurationMs = uPortGetTickTimeMs() - wakeUpDurationMs;
+            if (wakeUpDurationMs > 0) {
+                pClient->lockTimeMs = savedLockTimeMs + wakeUpDurationMs;
+            } else {
+                pClient->lockTimeMs = uPortGetTickTimeMs();
+            }
+            // We are no longer in the wake-up handler
+            uPortMutexUnlock(pClient->pWakeUp->inWakeUpHandlerMutex);
+        }
+
+        if (pClient->error == U_ERROR_COMMON_SUCCESS) {
+            if (pClient->pInterceptTx != NULL) {
+                if (pData < pDataEnd) {
+                    // Call the intercept function
+                    pDataToWrite = pClient->pInterceptTx((uAtClientHandle_t) pClient,
+                                                         &pData, &lengthToWrite,
+                                                         pClient->pInterceptTxContext);
+                } else {
+                    // andFlush must be true: call the intercept
+                    // function again with NULL to flush it out
+                    pDataToWrite = pClient->pInterceptTx((uAtClientHandle_t) pClient,
+                                                         NULL, &lengthToWrite,
+                                                         pClient->pInterceptTxContext);
+                    andFlush = false;
+                }
+            } else {
+                // If there is no intercept function then move pData
+                // on, plus clear andFlush, to indicate that we're done
+                pData = pDataEnd;
+                andFlush = false;
+            }
+            if ((pDataToWrite == NULL) && (lengthToWrite > 0)) {
+                setError(pClient, U_ERROR_COMMON_UNKNOWN);
+            }
+            while ((lengthToWrite > 0) &&
+                   (pDataToWrite != NULL) &&
+                   (pClient->error == U_ERROR_COMMON_SUCCESS)) {
+                // Send the data; if there is no write function
+                // the write is handled in the intercept
+                pWrite = U_AT_CLIENT_STREAM_FUNCTIONS(pClient)->pWrite;
+                if (pWrite != NULL) {
+                    traced = uTraceStagePush(U_TRACE_STAGE_AT_WRITE);
+                    thisLengthWritten = pWrite(&(pClient->stream), pDataToWrite, lengthToWrite);
+                    if (traced) {
+                        uTraceStagePop();
+                    }
+                }
+                if (thisLengthWritten > 0) {
+                    pDataToWrite += thisLengthWritten;
+                    lengthToWrite -= thisLengthWritten;
+                    pClient->lastTxTimeMs = uPortGetTickTimeMs();
+                } else {
+                    setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
+                }
+            }
+        }
+    }
+
+    // If there is an intercept function it may be that
+    // the length written is longer or shorter than
+    // passed in so it is not easily possible to printAt()
+    // exactly what was written, we can only check
+    // if *everything* was written
+    if (pClient->error == U_ERROR_COMMON_SUCCESS) {
+        printAt(pClient, pDataStart, length, true);
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+        statsAddBytes(pClient, length, true);
+#endif
+    } else {
+        length = 0;
+    }
+
+    return length;
+}
+
+#if U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES > 0
+// Send whatever has been gathered in txBuffer to the stream,
+// flushing any transmit intercept function if andFlush is true.
+static void txBufferFlush(uAtClientInstance_t *pClient, bool andFlush)
+{
+    if (!pClient->txBufferFlushing &&
+        ((pClient->txBufferLength > 0) || andFlush)) {
+        // Set txBufferFlushing so that any writes that occur
+        // while we're in the stream write (e.g. from a wake-up
+        // handler) go directly to the stream
+        pClient->txBufferFlushing = true;
+        writeStream(pClient, pClient->txBuffer, pClient->txBufferLength, andFlush);
+        pClient->txBufferLength = 0;
+        pClient->txBufferFlushing = false;
+    }
+}
+#endif
+
+// Write data: AT command prefixes, delimiters, parameters etc. are
+// gathered into txBuffer, if there is one, so that a whole AT
+// command reaches the stream in a single write; the gathered data
+// is sent when andFlush is true (e.g. at the end of an AT command),
+// when txBuffer is full or before anything is read from the stream.
+// Note that, since the stream write may be deferred, an error
+// in it will only be reported later.
+static size_t write(uAtClientInstance_t *pClient,
+                    const char *pData, size_t length,
+                    bool andFlush)
+{
+#if U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES > 0
+    if (!pClient->txBufferFlushing) {
+        if (pClient->error == U_ERROR_COMMON_SUCCESS) {
+            if (pClient->txBufferLength + length > sizeof(pClient->txBuffer)) {
+                // Won't fit, send what we have
+                txBufferFlush(pClient, false);
+            }
+            if (length > sizeof(pClient->txBuffer)) {
+                // Still won't fit, send this directly
+                length = writeStream(pClient, pData, length, andFlush);
+                andFlush = false;
+            } else {
+                memcpy(pClient->txBuffer + pClient->txBufferLength, pData, length);
+                pClient->txBufferLength += length;
+            }
+            if (andFlush) {
+                txBufferFlush(pClient, true);
+            }
+            if (pClient->error != U_ERROR_COMMON_SUCCESS) {
+                length = 0;
+            }
+        } else {
+            length = 0;
+        }
+    } else {
+        length = writeStream(pClient, pData, length, andFlush);
+    }
+
+    return length;
+#else
+    return writeStream(pClient, pData, length, andFlush);
+#endif
+}
+
+// Zero the buffer.
+// totalReset also clears out any buffered data that
+// may be awaiting processing by a receive intercept
+// function
+static void bufferReset(const uAtClientInstance_t *pClient,
+                        bool totalReset)
+{
+#if U_CFG_ENABLE_LOGGING
+    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
+#endif
+    uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
+
+    LOG_IF(totalReset, 200);
+    // If there is no receive intercept function then
+    // the buffered data can be reset also
+    if (totalReset || (pClient->pInterceptRx == NULL)) {
+        pBuffer->lengthBuffered = 0;
+    }
+
+    if (pBuffer->lengthBuffered > 0) {
+        LOG_IF(!totalReset, 201);
+        if (pBuffer->length > pBuffer->lengthBuffered) {
+            // This should never occur, but if it did
+            // it would not be good so best be safe.
+            if (pClient->debugOn) {
+                uPortLog("U_AT_CLIENT_%d-%d%s: *** WARNING ***"
+                         " lengthBuffered (%d) > length (%d).\n",
+                         pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
+                         pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)),
+                         pBuffer->lengthBuffered, pBuffer->length);
+            }
+            pBuffer->length = pBuffer->lengthBuffered;
+        }
+        // If there is stuff buffered, which will be beyond
+        // length, need to move that down when we reset
+        memmove(((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t),
+                ((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t) + pBuffer->length,
+                pBuffer->lengthBuffered - pBuffer->length);
+        U_ASSERT(U_AT_CLIENT_GUARD_CHECK(pBuffer));
+        pBuffer->lengthBuffered -= pBuffer->length;
+    }
+    pBuffer->readIndex = 0;
+    pBuffer->length = 0;
+}
+
+// Set the read position to 0 and move the buffer's
+// unread content to the beginning.
+static void bufferCompact(const uAtClientInstance_t *pClient)
+{
+    uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
+#if U_CFG_ENABLE_LOGGING
+    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
+#endif
+
+    LOG(100);
+    if ((pBuffer->readIndex > 0) &&
+        (pBuffer->length >= pBuffer->readIndex)) {
+        if (pBuffer->lengthBuffered < pBuffer->readIndex) {
+            // This should never occur, but if it did
+            // it would not be good so best be safe.
+            if (pClient->debugOn) {
+                uPortLog("U_AT_CLIENT_%d-%d%s: *** WARNING ***"
+                         " lengthBuffered (%d) < readIndex (%d).\n",
+                         pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
+                         pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)),
+                         pBuffer->lengthBuffered, pBuffer->readIndex);
+            }
+            pBuffer->lengthBuffered = pBuffer->readIndex;
+        }
+        pBuffer->length -= pBuffer->readIndex;
+        pBuffer->lengthBuffered -= pBuffer->readIndex;
+        LOG(101);
+        // Move what has not been read to the
+        // beginning of the buffer
+        memmove(((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t),
+                ((char *) pBuffer) + sizeof(uAtClientReceiveBuffer_t) + pBuffer->readIndex,
+                pBuffer->lengthBuffered);
+        U_ASSERT(U_AT_CLIENT_GUARD_CHECK(pBuffer));
+        pBuffer->readIndex = 0;
+        LOG(102);
+    }
+}
+
+// Reclaim the space in the receive buffer taken up by what has
+// already been read.  This is called every time a line is examined
+// so, rather than moving the unread content to the beginning of the
+// buffer every time, which would be a memmove() per line under URC
+// traffic, that is only done when it is free, i.e. there is nothing
+// unread to move, or when there is less space left at the end of the
+// buffer than has already been read; the rest of the time the read
+// position is simply left where it is.
+static void bufferRewind(const uAtClientInstance_t *pClient)
+{
+    const uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
+
+    if ((pBuffer->readIndex >= pBuffer->lengthBuffered) ||
+        (pBuffer->dataBufferSize - pBuffer->lengthBuffered < pBuffer->readIndex)) {
+        bufferCompact(pClient);
+    }
+}
+
+// Move the receive buffer into a newly allocated one with a data
+// buffer of the given size, contents and all; only possible if the
+// receive buffer was allocated by us.  Note: this moves
+// pClient->pReceiveBuffer, so anything that has a copy of that
+// pointer must refresh it afterwards.
+static bool bufferResize(uAtClientInstance_t *pClient,
+                         size_t dataBufferSize)
+{
+    uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
+    uAtClientReceiveBuffer_t *pNewBuffer = NULL;
+#if U_CFG_ENABLE_LOGGING
+    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
+#endif
+
+    if (pBuffer->isMalloced && (dataBufferSize >= pBuffer->lengthBuffered)) {
+        pNewBuffer = (uAtClientReceiveBuffer_t *) pUPortMalloc(dataBufferSize +
+                                                                U_AT_CLIENT_BUFFER_OVERHEAD_BYTES);
+        if (pNewBuffer != NULL) {
+            // Copy the management structure, which includes the
+            // opening marker, and everything buffered
+            memcpy(pNewBuffer, pBuffer, sizeof(uAtClientReceiveBuffer_t) +
+                   pBuffer->lengthBuffered);
+            pNewBuffer->dataBufferSize = dataBufferSize;
+            memcpy(U_AT_CLIENT_DATA_BUFFER_PTR(pNewBuffer) + dataBufferSize,
+                   U_AT_CLIENT_MARKER, U_AT_CLIENT_MARKER_SIZE);
+            U_ASSERT(U_AT_CLIENT_GUARD_CHECK(pNewBuffer));
+            pClient->pReceiveBuffer = pNewBuffer;
+            uPortFree(pBuffer);
+            if (pClient->debugOn) {
+                uPortLog("U_AT_CLIENT_%d-%d%s: receive buffer is now %d byte(s).\n",
+                         pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
+                         pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)),
+                         dataBufferSize);
+            }
+        }
+    }
+
+    return (pNewBuffer != NULL);
+}
+
+// Grow a full receive buffer, if we're allowed to.
+static bool bufferGrow(uAtClientInstance_t *pClient)
+{
+    size_t dataBufferSize = pClient->pReceiveBuffer->dataBufferSize;
+    bool grown = false;
+
+    if (dataBufferSize < pClient->receiveBufferSizeMax) {
+        dataBufferSize *= 2;
+        if (dataBufferSize > pClient->receiveBufferSizeMax) {
+            dataBufferSize = pClient->receiveBufferSizeMax;
+        }
+        grown = bufferResize(pClient, dataBufferSize);
+    }
+
+    return grown;
+}
+
+// Shrink the receive buffer back to its initial size if it has
+// grown, is empty and the extra space has gone unused for a while.
+static void bufferShrinkIfIdle(uAtClientInstance_t *pClient)
+{
+    uAtClientReceiveBuffer_t *pBuffer = pClient->pReceiveBuffer;
+
+    if ((pBuffer->dataBufferSize > pClient->receiveBufferSizeInitial) &&
+        (pBuffer->readIndex >= pBuffer->length) &&
+        (pBuffer->lengthBuffered == pBuffer->length) &&
+        (uPortGetTickTimeMs() - pClient->receiveBufferBusyTimeMs >
+         U_AT_CLIENT_RECEIVE_BUFFER_SHRINK_IDLE_MS)) {
+        bufferReset(pClient, true);
+        bufferResize(pClient, pClient->receiveBufferSizeInitial);
+    }
+}
+
+// Read from the UART/serial interface in nice coherent lines.
+static int32_t serialReadNoStutter(uAtClientInstance_t *pClient,
+                                   uAtClientBlockState_t blockState,
+                                   int32_t atTimeoutMs)
+{
+    int32_t readLength = 0;
+    int32_t thisReadLength;
+    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
+    char *pBuffer = U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
+                    pReceiveBuffer->lengthBuffered;
+    int32_t bufferSize = pReceiveBuffer->dataBufferSize -
+                         pReceiveBuffer->lengthBuffered;
+
+    // Retry the read until we're sure there's nothing
+    do {
+        thisReadLength = U_AT_CLIENT_STREAM_FUNCTIONS(pClient)->pRead(&(pClient->stream),
+                                                                      pBuffer, bufferSize);
+        if (thisReadLength > 0) {
+            readLength += thisReadLength;
+            pBuffer += thisReadLength;
+            bufferSize -= thisReadLength;
+            if (blockState == U_AT_CLIENT_BLOCK_STATE_NOTHING_RECEIVED) {
+                // Got something: now wait for more
+                blockState = U_AT_CLIENT_BLOCK_STATE_WAIT_FOR_MORE;
+                uPortTaskBlock(U_AT_CLIENT_STREAM_READ_RETRY_DELAY_MS);
+            }
+        } else {
+            if (blockState == U_AT_CLIENT_BLOCK_STATE_WAIT_FOR_MORE) {
+                // We were waiting for more but we have received nothing
+                // so stop blocking now
+                blockState = U_AT_CLIENT_BLOCK_STATE_DO_NOT_BLOCK;
+            } else {
+                uPortTaskBlock(U_AT_CLIENT_STREAM_READ_RETRY_DELAY_MS);
+            }
+
+        }
+    } while ((bufferSize > 0) &&
+             (blockState != U_AT_CLIENT_BLOCK_STATE_DO_NOT_BLOCK) &&
+             (pollTimeRemaining(atTimeoutMs, pClient->lockTimeMs) > 0));
+
+    return readLength;
+}
+
+// This is where data comes into the AT client.
+// Read from the stream into the receive buffer.
+// Returns true on a successful read or false on timeout.
+static bool bufferFill(uAtClientInstance_t *pClient,
+                       bool blocking)
+{
+    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
+    int32_t atTimeoutMs = -1;
+    int32_t readLength = 0;
+    size_t x = 0;
+    size_t y = 0;
+    size_t z = 0;
+    size_t length;
+    uDeviceSerial_t *pDeviceSerial;
+    bool eventIsCallback = false;
+    char *pData = NULL;
+    //lint -esym(838, pDataIntercept) Suppress initial value not used: it
+    // is if detailed debugging is on
+    char *pDataIntercept = NULL;
+    uAtClientBlockState_t blockState = U_AT_CLIENT_BLOCK_STATE_DO_NOT_BLOCK;
+#if U_CFG_ENABLE_LOGGING
+    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
+#endif
+
+#if U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES > 0
+    // Anything gathered for transmission must be on its way before
+    // we wait for a response
+    txBufferFlush(pClient, false);
+#endif
+
+    // Determine if we're in a callback or not
+    switch (pClient->stream.type) {
+        case U_AT_CLIENT_STREAM_TYPE_UART:
             eventIsCallback = uPortUartEventIsCallback(pClient->stream.handle.int32);
             break;
         case U_AT_CLIENT_STREAM_TYPE_VIRTUAL_SERIAL:
@@ -1497,7 +2113,16 @@ static bool bufferFill(uAtClientInstance_t *pClient,
         }
     }
 
-    // Reset buffer if it has become full
+    // If the buffer has become full, reclaim what has been read or,
+    // if that doesn't help, grow it, if allowed, or otherwise reset it
+    if ((pReceiveBuffer->lengthBuffered == pReceiveBuffer->dataBufferSize) &&
+        (pReceiveBuffer->readIndex > 0)) {
+        bufferCompact(pClient);
+    }
+    if ((pReceiveBuffer->lengthBuffered == pReceiveBuffer->dataBufferSize) &&
+        bufferGrow(pClient)) {
+        pReceiveBuffer = pClient->pReceiveBuffer;
+    }
     if (pReceiveBuffer->lengthBuffered == pReceiveBuffer->dataBufferSize) {
         if (pClient->debugOn) {
             uPortLog("U_AT_CLIENT_%d-%d%s: !!! overflow.\n",
@@ -1678,10 +2303,20 @@ static bool bufferFill(uAtClientInstance_t *pClient,
     LOG_BUFFER_FILL(15);
     if (readLength > 0) {
         printAt(pClient, U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
-                pReceiveBuffer->length + pReceiveBuffer->readIndex,
-                readLength, false);
+                pReceiveBuffer->length, readLength, false);
         pReceiveBuffer->length += readLength;
         LOG_BUFFER_FILL(16);
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+        statsAddBytes(pClient, readLength, false);
+#endif
+    }
+
+    // Keep track of how much of the buffer is really needed
+    if (pReceiveBuffer->lengthBuffered > pClient->receiveBufferHighWaterMark) {
+        pClient->receiveBufferHighWaterMark = pReceiveBuffer->lengthBuffered;
+    }
+    if (pReceiveBuffer->lengthBuffered > pClient->receiveBufferSizeInitial) {
+        pClient->receiveBufferBusyTimeMs = uPortGetTickTimeMs();
     }
 
     U_ASSERT(U_AT_CLIENT_GUARD_CHECK(pReceiveBuffer));
@@ -1689,6 +2324,50 @@ static bool bufferFill(uAtClientInstance_t *pClient,
     return readLength > 0;
 }
 
+// Do a blocking bufferFill(), setting the error flag and
+// dealing with consecutive timeouts if nothing arrives.
+static bool bufferFillOrTimeout(uAtClientInstance_t *pClient)
+{
+#if U_CFG_ENABLE_LOGGING
+    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
+#endif
+    bool filled = bufferFill(pClient, true);
+
+    if (filled) {
+        // Read something, all good
+        pClient->numConsecutiveAtTimeouts = 0;
+    } else {
+        // Timeout
+        if (pClient->debugOn) {
+            uPortLog("U_AT_CLIENT_%d-%d%s: timeout.\n",
+                     pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
+                     pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)));
+        }
+        setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
+        consecutiveTimeout(pClient);
+    }
+
+    return filled;
+}
+
+// Make sure that there is at least one unread character in the
+// receive buffer, resetting and re-filling the buffer if everything
+// has been read.  Returns false on timeout, in which case the
+// error flag is also set.
+static bool bufferEnsureUnread(uAtClientInstance_t *pClient)
+{
+    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
+    bool unread = true;
+
+    if (pReceiveBuffer->readIndex >= pReceiveBuffer->length) {
+        // Everything has been read, try to bring more in
+        bufferReset(pClient, false);
+        unread = bufferFillOrTimeout(pClient);
+    }
+
+    return unread;
+}
+
 // Get a character from the receive buffer.
 // Resets and re-fills the buffer if everything has been read,
 // i.e. the receive position is equal to the received length.
@@ -1697,9 +2376,6 @@ static bool bufferFill(uAtClientInstance_t *pClient,
 static int32_t bufferReadChar(uAtClientInstance_t *pClient)
 {
     uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
-#if U_CFG_ENABLE_LOGGING
-    char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
-#endif
     int32_t character = -1;
 
     // Note that we need to distinguish two cases here:
@@ -1709,35 +2385,53 @@ static int32_t bufferReadChar(uAtClientInstance_t *pClient)
     // platforms makes it more interesting, hence the casting
     // below
 
-    if (pReceiveBuffer->readIndex < pReceiveBuffer->length) {
-        // Read from the buffer
+    if (bufferEnsureUnread(pClient)) {
+        // Read from the buffer, which may have moved
+        pReceiveBuffer = pClient->pReceiveBuffer;
         character = (unsigned char) * (U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
                                        pReceiveBuffer->readIndex);
         pReceiveBuffer->readIndex++;
-    } else {
-        // Everything has been read, try to bring more in
-        bufferReset(pClient, false);
-        if (bufferFill(pClient, true)) {
-            // Read something, all good
-            character = (unsigned char) * (U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
-                                           pReceiveBuffer->readIndex);
-            pReceiveBuffer->readIndex++;
-            pClient->numConsecutiveAtTimeouts = 0;
-        } else {
-            // Timeout
-            if (pClient->debugOn) {
-                uPortLog("U_AT_CLIENT_%d-%d%s: timeout.\n",
-                         pClient->stream.type, U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
-                         pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)));
-            }
-            setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
-            consecutiveTimeout(pClient);
-        }
     }
 
     return character;
 }
 
+// Consume the part of a quoted string parameter that is already
+// in the receive buffer, up to but not including the closing
+// quote mark, copying it to pString if that is not NULL; at most
+// lengthMax bytes are consumed, zero meaning no limit.  Inside
+// quotes neither the delimiter nor the stop tag can occur, so
+// the span can be moved in one go rather than character by
+// character.  Returns the number of bytes consumed, which
+// will be zero if there is nothing buffered or the next
+// character is the closing quote mark.
+static size_t bufferReadQuotedSpan(const uAtClientInstance_t *pClient,
+                                   char *pString, size_t lengthMax)
+{
+    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
+    const char *pStart = U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
+                         pReceiveBuffer->readIndex;
+    const char *pQuote;
+    size_t length = 0;
+
+    if (pReceiveBuffer->length > pReceiveBuffer->readIndex) {
+        length = pReceiveBuffer->length - pReceiveBuffer->readIndex;
+        if ((lengthMax > 0) && (length > lengthMax)) {
+            length = lengthMax;
+        }
+        pQuote = (const char *) memchr(pStart, '\"', length);
+        if (pQuote != NULL) {
+            length = pQuote - pStart;
+        }
+        if ((pString != NULL) && (length > 0)) {
+            memcpy(pString, pStart, length);
+        }
+        pReceiveBuffer->readIndex += length;
+    }
+
+    return length;
+}
+
 // Look for pString at the start of the current receive buffer
 // without bringing more data into it, and if the string
 // is there consume it.
@@ -1764,7 +2458,7 @@ static bool bufferMatch(const uAtClientInstance_t *pClient,
                                pString, length) == 0)) {
             // Consume the matching part
             readIndex += length;
-            pReceiveBuffer->readIndex += readIndex;
+            pReceiveBuffer->readIndex = readIndex;
             found = true;
         }
     }
@@ -1821,30 +2515,44 @@ static void setScope(uAtClientInstance_t *pClient,
     }
 }
 
-// Consume characters until pString is found.
+// Consume characters until pString is found.  Rather than
+// reading character by character, what is already in the buffer
+// is searched with pMemStr() and more is only brought in if
+// pString is not there, keeping back just enough of the tail of
+// what has been searched that a partially received pString
+// is not lost.
 static bool consumeToString(uAtClientInstance_t *pClient,
                             const char *pString)
 {
-    size_t index = 0;
+    uAtClientReceiveBuffer_t *pReceiveBuffer;
     size_t length = strlen(pString);
-    int32_t character = 0;
-
-    while ((character >= 0) &&
-           (index < length)) {
-        character = bufferReadChar(pClient);
-        if (character >= 0) {
-            if (character == *(pString + index)) {
-                index++;
-            } else {
-                index = 0;
-                if (character == *pString) {
-                    index++;
-                }
+    const char *pStart;
+    const char *pPos = NULL;
+    size_t unread;
+    bool keepGoing = true;
+
+    while ((pPos == NULL) && keepGoing) {
+        // Note: the buffer may move when it is filled
+        pReceiveBuffer = pClient->pReceiveBuffer;
+        pStart = U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
+                 pReceiveBuffer->readIndex;
+        unread = pReceiveBuffer->length - pReceiveBuffer->readIndex;
+        pPos = pMemStr(pStart, unread, pString, length);
+        if (pPos != NULL) {
+            // Consume up to and including pString
+            pReceiveBuffer->readIndex += (pPos - pStart) + length;
+        } else {
+            // Consume all but the portion that may be the
+            // start of pString and bring more in
+            if (unread >= length) {
+                pReceiveBuffer->readIndex += unread - (length - 1);
             }
+            bufferRewind(pClient);
+            keepGoing = bufferFillOrTimeout(pClient);
         }
     }
 
-    return index == length;
+    return pPos != NULL;
 }
 
 // Consume characters until the stop tag is found.
@@ -1891,25 +2599,25 @@ static void informationResponseStop(uAtClientInstance_t *pClient)
     }
 }
 
-// Iterate through URCs and check if one of them matches the current
-// contents of the receive buffer. If a URC is matched, set the
-// scope to information response and, after the URC's handler has
-// returned, finish off the information response scope by consuming
+// Check if the URC handler in the given hash bucket matches the
+// current contents of the receive buffer. If a URC is matched, set
+// the scope to information response and, after the URC's handler
+// has returned, finish off the information response scope by consuming
 // up to CR/LF.
-static bool bufferMatchOneUrc(uAtClientInstance_t *pClient)
+static bool bufferMatchOneUrcInBucket(uAtClientInstance_t *pClient,
+                                      size_t bucketIndex)
 {
     size_t prefixLength = 0;
     bool found = false;
     int32_t now;
     uErrorCode_t savedError;
 
-    bufferRewind(pClient);
-
-    for (uAtClientUrc_t *pUrc = pClient->pUrcList;
+    for (uAtClientUrc_t *pUrc = pClient->pUrcBucket[bucketIndex];
          !found && (pUrc != NULL);
-         pUrc = pUrc->pNext) {
+         pUrc = pUrc->pNextInBucket) {
         prefixLength = pUrc->prefixLength;
-        if (pClient->pReceiveBuffer->length >= prefixLength) {
+        if (pClient->pReceiveBuffer->length -
+            pClient->pReceiveBuffer->readIndex >= prefixLength) {
             // Do the check ignoring nulls at the start in case
             // a URC is emitted near power-on which can suffer from
             // such nulls
@@ -1939,6 +2647,39 @@ static bool bufferMatchOneUrc(uAtClientInstance_t *pClient)
     return found;
 }
 
+// Check if one of the URCs matches the current contents of the
+// receive buffer, calling its handler if so.  Rather than
+// iterating through all of the URCs only those in the hash bucket
+// matching the start of the receive buffer, plus those with
+// prefixes too short to be hashed, are checked.
+static bool bufferMatchOneUrc(uAtClientInstance_t *pClient)
+{
+    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
+    const char *pData;
+    size_t length;
+    bool found = false;
+
+    bufferRewind(pClient);
+
+    // Skip any nulls for the purposes of working out the hash,
+    // see bufferMatch()
+    pData = U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) + pReceiveBuffer->readIndex;
+    length = pReceiveBuffer->length - pReceiveBuffer->readIndex;
+    while ((length > 0) && (*pData == 0)) {
+        pData++;
+        length--;
+    }
+
+    if (length >= U_AT_CLIENT_URC_HASH_KEY_LENGTH_BYTES) {
+        found = bufferMatchOneUrcInBucket(pClient, urcBucketIndex(pData, length));
+    }
+    if (!found) {
+        found = bufferMatchOneUrcInBucket(pClient, U_AT_CLIENT_URC_HASH_NUM_BUCKETS);
+    }
+
+    return found;
+}
+
 // Read a string parameter.
 // The mutex should be locked before this is called.
 static int32_t readString(uAtClientInstance_t *pClient,
@@ -1951,53 +2692,66 @@ static int32_t readString(uAtClientInstance_t *pClient,
     int32_t matchPos = 0;
     bool delimiterFound = false;
     bool inQuotes = false;
+    size_t spanLength;
     int32_t c;
 
     while (((lengthBytes == 0) || (lengthRead < ((int32_t) lengthBytes - 1) + matchPos)) &&
            (pClient->error == U_ERROR_COMMON_SUCCESS) &&
            !delimiterFound &&
            (ignoreStopTag || !pStopTag->found)) {
-        c = bufferReadChar(pClient);
-        if (c == -1) {
-            // Error
-            setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
-        } else if (!inQuotes && (c == pClient->delimiter)) {
-            // Reached delimiter
-            delimiterFound = true;
-        } else if (c == '\"') {
-            // Switch into or out of quotes
-            matchPos = 0;
-            inQuotes = !inQuotes;
-        } else {
-            if (!inQuotes && !ignoreStopTag &&
-                (pStopTag->pTagDef->length > 0)) {
-                // It could be a stop tag
-                if (c == *(pStopTag->pTagDef->pString + matchPos)) {
-                    matchPos++;
-                } else {
-                    // If it wasn't a stop tag, reset
-                    // the match position and check again
-                    // in case it is the start of a new stop tag
-                    matchPos = 0;
-                    if (c == *(pStopTag->pTagDef->pString)) {
+        spanLength = 0;
+        if (inQuotes) {
+            // Fast path: move whatever of the quoted string is
+            // already buffered in one go (matchPos is always
+            // zero when in quotes)
+            spanLength = bufferReadQuotedSpan(pClient,
+                                              pString != NULL ? pString + lengthRead : NULL,
+                                              lengthBytes > 0 ? lengthBytes - 1 - lengthRead : 0);
+            lengthRead += (int32_t) spanLength;
+        }
+        if (spanLength == 0) {
+            c = bufferReadChar(pClient);
+            if (c == -1) {
+                // Error
+                setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
+            } else if (!inQuotes && (c == pClient->delimiter)) {
+                // Reached delimiter
+                delimiterFound = true;
+            } else if (c == '\"') {
+                // Switch into or out of quotes
+                matchPos = 0;
+                inQuotes = !inQuotes;
+            } else {
+                if (!inQuotes && !ignoreStopTag &&
+                    (pStopTag->pTagDef->length > 0)) {
+                    // It could be a stop tag
+                    if (c == *(pStopTag->pTagDef->pString + matchPos)) {
                         matchPos++;
+                    } else {
+                        // If it wasn't a stop tag, reset
+                        // the match position and check again
+                        // in case it is the start of a new stop tag
+                        matchPos = 0;
+                        if (c == *(pStopTag->pTagDef->pString)) {
+                            matchPos++;
+                        }
                     }
+                    if (matchPos == (int32_t) pStopTag->pTagDef->length) {
+                        pStopTag->found = true;
+                        // Remove tag from string if it was matched
+                        lengthRead -= (int32_t) pStopTag->pTagDef->length - 1;
+                    }
+                } else {
+                    // Not anything
+                    matchPos = 0;
                 }
-                if (matchPos == (int32_t) pStopTag->pTagDef->length) {
-                    pStopTag->found = true;
-                    // Remove tag from string if it was matched
-                    lengthRead -= (int32_t) pStopTag->pTagDef->length - 1;
-                }
-            } else {
-                // Not anything
-                matchPos = 0;
-            }
-            if (!pStopTag->found) {
-                if (pString != NULL) {
-                    // Add the character to the string
-                    *(pString + lengthRead) = (char) c;
+                if (!pStopTag->found) {
+                    if (pString != NULL) {
+                        // Add the character to the string
+                        *(pString + lengthRead) = (char) c;
+                    }
+                    lengthRead++;
                 }
-                lengthRead++;
             }
         }
     }
@@ -2161,232 +2915,52 @@ static bool processResponse(uAtClientInstance_t *pClient,
                     prefixMatched = true;
                     processingDone = true;
                 } else {
-                    // No prefix match, check for a URC
-                    if (checkUrc && bufferMatchOneUrc(pClient)) {
-                        // Just loop again
-                    } else {
-                        // If no matches were found, see if there's
-                        // a CR/LF in the buffer with some characters
-                        // between it and where we are now to read
-                        pTmp = pMemStr(U_AT_CLIENT_DATA_BUFFER_PTR(pClient->pReceiveBuffer) +
-                                       pClient->pReceiveBuffer->readIndex,
-                                       pClient->pReceiveBuffer->length,
-                                       U_AT_CLIENT_CRLF, U_AT_CLIENT_CRLF_LENGTH_BYTES);
-                        if ((pTmp != NULL) &&
-                            (pTmp - U_AT_CLIENT_DATA_BUFFER_PTR(pClient->pReceiveBuffer)) > 0) {
-                            // There is a CR/LF after some stuff
-                            // to read and there was no prefix,
-                            // so return now so that the caller
-                            // can read the stuff
-                            if (pPrefix == NULL) {
-                                prefixMatched = true;
-                                processingDone = true;
-                            } else {
-                                // Just consume up to CR/LF
-                                consumeToString(pClient, U_AT_CLIENT_CRLF);
-                            }
-                        } else {
-                            // We might still bufferMatch something,
-                            // try to fill the buffer with more stuff
-                            if (!bufferFill(pClient, true)) {
-                                // If we don't get any data within
-                                // the timeout, set an error to
-                                // indicate the need for recovery
-                                setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
-                                consecutiveTimeout(pClient);
-                            } else {
-                                pClient->numConsecutiveAtTimeouts = 0;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    return prefixMatched;
-}
-
-// Write data to the stream.
-//
-// Design note concerning the wake-up handler
-// process below; first the needs:
-// - the wake-up handler must be allowed to call back
-//   into this AT interface, one level of recursion.
-// - the wake-up handler must be allowed to launch
-//   asynchronous callbacks that may also call into
-//   this AT interface.
-// - these asynchronous callbacks must be blocked
-//   from doing AT things while the wake-up process
-//   is occurring and then be allowed to continue
-//   once the wake-up has been completed.
-// Given those needs, the design here is: when wake-up
-// is required inWakeUpHandlerMutex is locked and
-// the current task ID saved before the wake-up function
-// is called. The U_AT_CLIENT_LOCK_CLIENT_MUTEX that
-// gates every AT client API call checks the current
-// task ID against this saved task ID and, if it
-// matches, it blocks against a separate wake-up mutex
-// rather than the normal mutex.  If the task ID does
-// not match then it _also_ blocks on inWakeUpHandlerMutex
-// before proceeding, hence holding off processing until
-// the wake-up process has completed.
-static size_t write(uAtClientInstance_t *pClient,
-                    const char *pData, size_t length,
-                    bool andFlush)
-{
-    int32_t thisLengthWritten = 0;
-    size_t lengthToWrite;
-    const char *pDataStart = pData;
-    const char *pDataToWrite = pData;
-    // cppcheck insists that pDataStart + length can be
-    // out of bounds if length is 23 when being called
-    // from uAtClientWriteUint64(), where length is checked
-    // against the size of numberString, which is 24.
-    // I can't see how that's possible: maybe the
-    // the ORing with andFlush below is confusing it?
-    // codechecker_suppress [cppcheck-pointerOutOfBoundsCond] "pDataStart + length is not out of bounds"
-    const char *pDataEnd = pDataStart + length;
-    int32_t savedLockTimeMs;
-    int32_t wakeUpDurationMs = 0;
-    uAtClientScope_t savedScope;
-    uAtClientTag_t savedStopTag;
-    bool savedDelimiterRequired;
-    uAtClientDeviceError_t savedDeviceError;
-    uDeviceSerial_t *pDeviceSerial;
-
-    while (((pData < pDataEnd) || andFlush) &&
-           (pClient->error == U_ERROR_COMMON_SUCCESS)) {
-        lengthToWrite = length - (pData - pDataStart);
-        if ((pClient->pWakeUp != NULL) && (pClient->lastTxTimeMs >= 0) &&
-            (uPortGetTickTimeMs() - pClient->lastTxTimeMs > pClient->pWakeUp->inactivityTimeoutMs) &&
-            (uPortMutexTryLock(pClient->pWakeUp->inWakeUpHandlerMutex, 0) == 0)) {
-            // We have a wake-up handler, the inactivity timeout
-            // has expired and we've managed to lock the wake-up
-            // handler mutex (if we aren't able to lock the wake-up
-            // handler mutex  then we must already be in the wake-up
-            // handler, having recursed, so can just continue); now
-            // we need to call the wake-up handler function.
-            // Set wakeUpTask to the current task handle so
-            // that any future calls can be locked against the
-            // separate pWakeUp->mutex if they come from the task
-            // we're in at the moment, the one dealing with the wake-up
-            uPortTaskGetHandle(&(pClient->pWakeUp->wakeUpTask));
-            // The pClient->mutex will have been locked on the way
-            // into here by U_AT_CLIENT_LOCK_CLIENT_MUTEX.
-            // Remember the lock time and measure how long
-            // waking-up takes in order to correct for it
-            savedLockTimeMs = pClient->lockTimeMs;
-            wakeUpDurationMs = uPortGetTickTimeMs();
-            // Remember the dynamic things that the
-            // wake-up handler might overwrite
-            savedScope = pClient->scope;
-            savedStopTag = pClient->stopTag;
-            savedDelimiterRequired = pClient->delimiterRequired;
-            savedDeviceError = pClient->deviceError;
-            // Reset the scope, stopTag and delimiterRequired
-            pClient->scope = U_AT_CLIENT_SCOPE_NONE;
-            pClient->stopTag.pTagDef = &gNoStopTag;
-            pClient->stopTag.found = false;
-            pClient->delimiterRequired = false;
-            // Now actually call the wake-up callback which may recurse
-            // back into here
-            if (pClient->pWakeUp->pHandler((uAtClientHandle_t) pClient,
-                                           pClient->pWakeUp->pParam) != 0) {
-                setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
-            }
-            // At this point all of the calls back into here
-            // performed as part of the wake-up process will have
-            // been completed; there may have been calls from other
-            // tasks but they will have been blocked on the normal
-            // mutex before reaching here.
-            // We can now set the wakeUpTask back to NULL and all
-            // blocking will be on the normal mutex again
-            pClient->pWakeUp->wakeUpTask = NULL;
-            // Put all the saved things back
-            pClient->scope = savedScope;
-            pClient->stopTag = savedStopTag;
-            pClient->delimiterRequired = savedDelimiterRequired;
-            pClient->deviceError = savedDeviceError;
-            // Set the adjusted lock time, allowing for potential
-            // wrap in uPortGetTickTimeMs()
-            wakeUpDurationMs = uPortGetTickTimeMs() - wakeUpDurationMs;
-            if (wakeUpDurationMs > 0) {
-                pClient->lockTimeMs = savedLockTimeMs + wakeUpDurationMs;
-            } else {
-                pClient->lockTimeMs = uPortGetTickTimeMs();
-            }
-            // We are no longer in the wake-up handler
-            uPortMutexUnlock(pClient->pWakeUp->inWakeUpHandlerMutex);
-        }
-
-        if (pClient->error == U_ERROR_COMMON_SUCCESS) {
-            if (pClient->pInterceptTx != NULL) {
-                if (pData < pDataEnd) {
-                    // Call the intercept function
-                    pDataToWrite = pClient->pInterceptTx((uAtClientHandle_t) pClient,
-                                                         &pData, &lengthToWrite,
-                                                         pClient->pInterceptTxContext);
-                } else {
-                    // andFlush must be true: call the intercept
-                    // function again with NULL to flush it out
-                    pDataToWrite = pClient->pInterceptTx((uAtClientHandle_t) pClient,
-                                                         NULL, &lengthToWrite,
-                                                         pClient->pInterceptTxContext);
-                    andFlush = false;
-                }
-            } else {
-                // If there is no intercept function then move pData
-                // on, plus clear andFlush, to indicate that we're done
-                pData = pDataEnd;
-                andFlush = false;
-            }
-            if ((pDataToWrite == NULL) && (lengthToWrite > 0)) {
-                setError(pClient, U_ERROR_COMMON_UNKNOWN);
-            }
-            while ((lengthToWrite > 0) &&
-                   (pDataToWrite != NULL) &&
-                   (pClient->error == U_ERROR_COMMON_SUCCESS)) {
-                // Send the data
-                switch (pClient->stream.type) {
-                    case U_AT_CLIENT_STREAM_TYPE_UART:
-                        thisLengthWritten = uPortUartWrite(pClient->stream.handle.int32,
-                                                           pDataToWrite, lengthToWrite);
-                        break;
-                    case U_AT_CLIENT_STREAM_TYPE_VIRTUAL_SERIAL:
-                        pDeviceSerial = pClient->stream.handle.pDeviceSerial;
-                        thisLengthWritten = pDeviceSerial->write(pDeviceSerial,
-                                                                 pDataToWrite, lengthToWrite);
-                        break;
-                    // Write handled in intercept
-                    case U_AT_CLIENT_STREAM_TYPE_EDM:
-                        break;
-                    default:
-                        break;
-                }
-                if (thisLengthWritten > 0) {
-                    pDataToWrite += thisLengthWritten;
-                    lengthToWrite -= thisLengthWritten;
-                    pClient->lastTxTimeMs = uPortGetTickTimeMs();
-                } else {
-                    setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
+                    // No prefix match, check for a URC
+                    if (checkUrc && bufferMatchOneUrc(pClient)) {
+                        // Just loop again
+                    } else {
+                        // If no matches were found, see if there's
+                        // a CR/LF in the buffer with some characters
+                        // between it and where we are now to read
+                        pTmp = pMemStr(U_AT_CLIENT_DATA_BUFFER_PTR(pClient->pReceiveBuffer) +
+                                       pClient->pReceiveBuffer->readIndex,
+                                       pClient->pReceiveBuffer->length -
+                                       pClient->pReceiveBuffer->readIndex,
+                                       U_AT_CLIENT_CRLF, U_AT_CLIENT_CRLF_LENGTH_BYTES);
+                        if ((pTmp != NULL) &&
+                            (pTmp - (U_AT_CLIENT_DATA_BUFFER_PTR(pClient->pReceiveBuffer) +
+                                     pClient->pReceiveBuffer->readIndex)) > 0) {
+                            // There is a CR/LF after some stuff
+                            // to read and there was no prefix,
+                            // so return now so that the caller
+                            // can read the stuff
+                            if (pPrefix == NULL) {
+                                prefixMatched = true;
+                                processingDone = true;
+                            } else {
+                                // Just consume up to CR/LF
+                                consumeToString(pClient, U_AT_CLIENT_CRLF);
+                            }
+                        } else {
+                            // We might still bufferMatch something,
+                            // try to fill the buffer with more stuff
+                            if (!bufferFill(pClient, true)) {
+                                // If we don't get any data within
+                                // the timeout, set an error to
+                                // indicate the need for recovery
+                                setError(pClient, U_ERROR_COMMON_DEVICE_ERROR);
+                                consecutiveTimeout(pClient);
+                            } else {
+                                pClient->numConsecutiveAtTimeouts = 0;
+                            }
+                        }
+                    }
                 }
             }
         }
     }
 
-    // If there is an intercept function it may be that
-    // the length written is longer or shorter than
-    // passed in so it is not easily possible to printAt()
-    // exactly what was written, we can only check
-    // if *everything* was written
-    if (pClient->error == U_ERROR_COMMON_SUCCESS) {
-        printAt(pClient, pDataStart, length, true);
-    } else {
-        length = 0;
-    }
-
-    return length;
+    return prefixMatched;
 }
 
 // Do common checks before sending parameters
@@ -2483,6 +3057,9 @@ static void unlockNoDataCheck(uAtClientInstance_t *pClient,
             pClient->atTimeoutSavedMs = -1;
         }
 
+        // Give back any receive buffer space that is no longer needed
+        bufferShrinkIfIdle(pClient);
+
         if (pClient->pActivityPin != NULL) {
             // If an activity pin is set then switch it off
             while (uPortGetTickTimeMs() - pClient->pActivityPin->lastToggleTime <
@@ -2568,23 +3145,9 @@ static int32_t uint64ToString(char *pBuffer, size_t length,
 static int32_t getReceiveSizeForUrc(const uAtClientInstance_t *pClient)
 {
     int32_t receiveSize = 0;
-    uDeviceSerial_t *pDeviceSerial;
 
     if (processAsync(pClient->magicNumber)) {
-        switch (pClient->stream.type) {
-            case U_AT_CLIENT_STREAM_TYPE_UART:
-                receiveSize = uPortUartGetReceiveSize(pClient->stream.handle.int32);
-                break;
-            case U_AT_CLIENT_STREAM_TYPE_VIRTUAL_SERIAL:
-                pDeviceSerial = pClient->stream.handle.pDeviceSerial;
-                receiveSize = pDeviceSerial->getReceiveSize(pDeviceSerial);
-                break;
-            case U_AT_CLIENT_STREAM_TYPE_EDM:
-                receiveSize = uShortRangeEdmStreamAtGetReceiveSize(pClient->stream.handle.int32);
-                break;
-            default:
-                break;
-        }
+        receiveSize = U_AT_CLIENT_STREAM_FUNCTIONS(pClient)->pGetReceiveSize(&(pClient->stream));
     }
 
     return receiveSize;
@@ -2596,7 +3159,6 @@ static void urcCallback(const uAtClientStreamHandle_t *pStream,
                         uint32_t eventBitmask, void *pParameters)
 {
     uAtClientInstance_t *pClient;
-    uAtClientReceiveBuffer_t *pReceiveBuffer;
     uPortMutexHandle_t streamMutex;
     int32_t sizeOrError;
     int32_t x;
@@ -2628,10 +3190,13 @@ static void urcCallback(const uAtClientStreamHandle_t *pStream,
                     // and be processing it, in which case just return.
                     streamMutex = tryLock(pClient);
                     if (streamMutex != NULL) {
-                        // Loop until no received characters left to process
-                        pReceiveBuffer = pClient->pReceiveBuffer;
+                        U_LOG_RAM_TRACE_BEGIN(U_LOG_RAM_EVENT_AT_CLIENT_URC,
+                                              U_AT_CLIENT_HANDLE_FOR_PRINT(pClient));
+                        // Loop until no received characters left to process;
+                        // note that pClient->pReceiveBuffer is used directly
+                        // throughout since the buffer may move as it is filled
                         while (((sizeOrError = getReceiveSizeForUrc(pClient)) > 0) ||
-                               (pReceiveBuffer->readIndex < pReceiveBuffer->length)) {
+                               (pClient->pReceiveBuffer->readIndex < pClient->pReceiveBuffer->length)) {
                             if (pClient->debugOn) {
                                 uPortLog("U_AT_CLIENT_%d-%d%s: possible URC data readable %d,"
                                          " already buffered %u.\n",
@@ -2639,7 +3204,7 @@ static void urcCallback(const uAtClientStreamHandle_t *pStream,
                                          U_AT_CLIENT_HANDLE_FOR_PRINT(pClient),
                                          pPrintTimestamp(" ", NULL, timestampBuffer, sizeof(timestampBuffer)),
                                          sizeOrError,
-                                         pReceiveBuffer->length - pReceiveBuffer->readIndex);
+                                         pClient->pReceiveBuffer->length - pClient->pReceiveBuffer->readIndex);
                             }
                             pClient->scope = U_AT_CLIENT_SCOPE_NONE;
                             for (size_t x = 0; x < U_AT_CLIENT_URC_DATA_LOOP_GUARD; x++) {
@@ -2648,15 +3213,16 @@ static void urcCallback(const uAtClientStreamHandle_t *pStream,
                                     // If there's a bufferMatch, see if more data is available
                                     sizeOrError = getReceiveSizeForUrc(pClient);
                                     if ((sizeOrError <= 0) &&
-                                        (pReceiveBuffer->readIndex >=
-                                         pReceiveBuffer->dataBufferSize)) {
+                                        (pClient->pReceiveBuffer->readIndex >=
+                                         pClient->pReceiveBuffer->dataBufferSize)) {
                                         // We have no more data to process, leave this loop
                                         break;
                                     }
                                     // If no bufferMatch was found, look for CR/LF
-                                } else if (pMemStr(U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
-                                                   pReceiveBuffer->readIndex,
-                                                   pReceiveBuffer->length,
+                                } else if (pMemStr(U_AT_CLIENT_DATA_BUFFER_PTR(pClient->pReceiveBuffer) +
+                                                   pClient->pReceiveBuffer->readIndex,
+                                                   pClient->pReceiveBuffer->length -
+                                                   pClient->pReceiveBuffer->readIndex,
                                                    U_AT_CLIENT_CRLF, U_AT_CLIENT_CRLF_LENGTH_BYTES) != NULL) {
                                     // Consume everything up to the CR/LF
                                     consumeToString(pClient, U_AT_CLIENT_CRLF);
@@ -2688,6 +3254,7 @@ static void urcCallback(const uAtClientStreamHandle_t *pStream,
                         // checking for more data, which would try
                         // to queue stuff on this task and I'm not
                         // sure that's safe
+                        U_LOG_RAM_TRACE_END(U_LOG_RAM_EVENT_AT_CLIENT_URC, 0);
                         unlockNoDataCheck(pClient, streamMutex);
 
                         x = uPortEventQueueGetFree(gEventQueueHandle);
@@ -2746,6 +3313,27 @@ static void urcCallbackDeviceSerial(uDeviceSerial_t *pDeviceSerial, uint32_t eve
     urcCallback(&stream, eventBitmask, pParameters);
 }
 
+// Send a callback to the given event queue; gMutexEventQueue
+// must be locked before this is called.
+static int32_t callbackSend(int32_t eventQueueHandle,
+                            uAtClientHandle_t atHandle,
+                            void (*pCallback) (uAtClientHandle_t, void *),
+                            void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uAtClientCallback_t cb = {0}; // Keep Valgrind happy (otherwise the last four bytes will be uninitialised)
+
+    if (pCallback != NULL) {
+        cb.pFunction = pCallback;
+        cb.atHandle = atHandle;
+        cb.pParam = pCallbackParam;
+        cb.atClientMagicNumber = ((uAtClientInstance_t *) atHandle)->magicNumber;
+        errorCode = uPortEventQueueSend(eventQueueHandle, &cb, sizeof(cb));
+    }
+
+    return errorCode;
+}
+
 // Callback for the event queue.
 static void eventQueueCallback(void *pParameters, size_t paramLength)
 {
@@ -2773,7 +3361,11 @@ static uAtClientHandle_t clientAdd(const uAtClientStreamHandle_t *pStream,
 
     // Check parameters
     if ((receiveBufferSize > U_AT_CLIENT_BUFFER_OVERHEAD_BYTES) &&
+#ifdef U_AT_CLIENT_STREAM_TYPE_ONLY
+        (pStream->type == U_AT_CLIENT_STREAM_TYPE_ONLY)) {
+#else
         (pStream->type < U_AT_CLIENT_STREAM_TYPE_MAX)) {
+#endif
         // See if there's already an AT client for this stream and
         // also check that we have room for another entry in the
         // magic number array
@@ -2801,6 +3393,7 @@ static uAtClientHandle_t clientAdd(const uAtClientStreamHandle_t *pStream,
                         // the event handlers which might call us
                         pClient->newSendNextTime = true;
                         pClient->stream = *pStream;
+                        pClient->pStreamFunctions = &(gStreamFunctions[pStream->type]);
                         pClient->atTimeoutMs = U_AT_CLIENT_DEFAULT_TIMEOUT_MS;
                         pClient->atTimeoutSavedMs = -1;
                         pClient->delimiter = U_AT_CLIENT_DEFAULT_DELIMITER;
@@ -2815,6 +3408,8 @@ static uAtClientHandle_t clientAdd(const uAtClientStreamHandle_t *pStream,
                         // Set up the buffer and its protection markers
                         pClient->pReceiveBuffer->dataBufferSize = receiveBufferSize -
                                                                   U_AT_CLIENT_BUFFER_OVERHEAD_BYTES;
+                        pClient->receiveBufferSizeInitial = pClient->pReceiveBuffer->dataBufferSize;
+                        pClient->receiveBufferSizeMax = pClient->receiveBufferSizeInitial;
                         bufferReset(pClient, true);
                         memcpy(pClient->pReceiveBuffer->mk0, U_AT_CLIENT_MARKER,
                                U_AT_CLIENT_MARKER_SIZE);
@@ -2932,6 +3527,26 @@ int32_t uAtClientInit()
             if (errorCodeOrHandle == 0) {
                 // Create the mutex that protects the linked list
                 errorCodeOrHandle = uPortMutexCreate(&gMutex);
+#if U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH > 0
+                if (errorCodeOrHandle == 0) {
+                    // Create an event queue for priority callbacks
+                    errorCodeOrHandle = uPortEventQueueOpen(eventQueueCallback,
+                                                            "atCallbacksPri",
+                                                            sizeof(uAtClientCallback_t),
+                                                            U_AT_CLIENT_PRIORITY_CALLBACK_TASK_STACK_SIZE_BYTES,
+                                                            U_AT_CLIENT_PRIORITY_CALLBACK_TASK_PRIORITY,
+                                                            U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH);
+                    if (errorCodeOrHandle >= 0) {
+                        gEventQueueHandlePriority = errorCodeOrHandle;
+                        errorCodeOrHandle = 0;
+                    } else {
+                        // Failed, release the mutex that protects
+                        // the linked list again
+                        uPortMutexDelete(gMutex);
+                        gMutex = NULL;
+                    }
+                }
+#endif
                 if (errorCodeOrHandle == 0) {
 #ifdef U_AT_CLIENT_PRINT_WITH_TIMESTAMP
                     // The user wants timestamps
@@ -2971,6 +3586,9 @@ void uAtClientDeinit()
         U_PORT_MUTEX_LOCK(gMutexEventQueue);
         // Release the callbacks event queue
         uPortEventQueueClose(gEventQueueHandle);
+#if U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH > 0
+        uPortEventQueueClose(gEventQueueHandlePriority);
+#endif
 
         // Delete the mutexes
         U_PORT_MUTEX_UNLOCK(gMutexEventQueue);
@@ -3010,6 +3628,139 @@ uAtClientHandle_t uAtClientAddExt(const uAtClientStreamHandle_t *pStream,
     return clientAdd(pStream, pReceiveBuffer, receiveBufferSize);
 }
 
+// Allow the receive buffer of an AT client to grow.
+int32_t uAtClientReceiveBufferSizeMaxSet(uAtClientHandle_t atHandle,
+                                         size_t receiveBufferSizeMax)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+
+    if (pClient != NULL) {
+
+        U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        if (pClient->pReceiveBuffer->isMalloced) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            pClient->receiveBufferSizeMax = pClient->receiveBufferSizeInitial;
+            if (receiveBufferSizeMax > pClient->receiveBufferSizeInitial +
+                U_AT_CLIENT_BUFFER_OVERHEAD_BYTES) {
+                pClient->receiveBufferSizeMax = receiveBufferSizeMax -
+                                                U_AT_CLIENT_BUFFER_OVERHEAD_BYTES;
+            }
+        }
+
+        U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+    }
+
+    return errorCode;
+}
+
+// Get the current size of the receive buffer of an AT client.
+int32_t uAtClientReceiveBufferSizeGet(uAtClientHandle_t atHandle)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+
+    if (pClient != NULL) {
+        errorCodeOrSize = (int32_t) (pClient->pReceiveBuffer->dataBufferSize +
+                                     U_AT_CLIENT_BUFFER_OVERHEAD_BYTES);
+    }
+
+    return errorCodeOrSize;
+}
+
+// Get the high-water mark of the receive buffer of an AT client.
+int32_t uAtClientReceiveBufferHighWaterMarkGet(uAtClientHandle_t atHandle)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+
+    if (pClient != NULL) {
+        errorCodeOrSize = (int32_t) (pClient->receiveBufferHighWaterMark +
+                                     U_AT_CLIENT_BUFFER_OVERHEAD_BYTES);
+    }
+
+    return errorCodeOrSize;
+}
+
+// Get the per-command statistics of an AT client.
+int32_t uAtClientStatsGet(uAtClientHandle_t atHandle,
+                          uAtClientStats_t *pStats,
+                          size_t numStats)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+    int32_t target;
+    int32_t total;
+    size_t bin;
+
+    errorCodeOrCount = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    if ((pClient != NULL) && ((pStats != NULL) || (numStats == 0))) {
+
+        U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+        if (numStats > pClient->numStats) {
+            numStats = pClient->numStats;
+        }
+        for (size_t x = 0; x < numStats; x++) {
+            *pStats = pClient->stats[x];
+            if (pStats->count > 0) {
+                pStats->meanMs = (int32_t) (pStats->totalMs / pStats->count);
+                // Find the bin in which the 99th percentile falls
+                // and take its upper limit, bounded by the maximum
+                target = pStats->count - (pStats->count / 100);
+                total = 0;
+                bin = 0;
+                while ((bin < U_AT_CLIENT_STATS_HISTOGRAM_NUM_BINS - 1) &&
+                       (total + pStats->histogram[bin] < target)) {
+                    total += pStats->histogram[bin];
+                    bin++;
+                }
+                pStats->p99Ms = pStats->maxMs;
+                if ((bin < U_AT_CLIENT_STATS_HISTOGRAM_NUM_BINS - 1) &&
+                    ((1 << bin) - 1 < pStats->p99Ms)) {
+                    pStats->p99Ms = (1 << bin) - 1;
+                }
+            } else {
+                pStats->minMs = 0;
+            }
+            pStats++;
+        }
+        errorCodeOrCount = (int32_t) pClient->numStats;
+
+        U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+    }
+#else
+    (void) atHandle;
+    (void) pStats;
+    (void) numStats;
+#endif
+
+    return errorCodeOrCount;
+}
+
+// Reset the per-command statistics of an AT client.
+void uAtClientStatsReset(uAtClientHandle_t atHandle)
+{
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+
+    if (pClient != NULL) {
+
+        U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+        pClient->numStats = 0;
+        pClient->pStatsCurrent = NULL;
+
+        U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+    }
+#else
+    (void) atHandle;
+#endif
+}
+
 // Tell an AT client to throw away asynchronous events.
 void uAtClientIgnoreAsync(uAtClientHandle_t atHandle)
 {
@@ -3201,13 +3952,18 @@ void uAtClientLock(uAtClientHandle_t atHandle)
 {
     uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
     uPortMutexHandle_t streamMutex;
+    bool traced;
 
     // IMPORTANT: this can't lock pClient->mutex as it
     // needs to wait on the stream mutex and if it locked
     // pClient->mutex that would prevent uAtClientUnlock()
     // from working.
     if ((pClient != NULL) && (pClient->streamMutex != NULL)) {
+        traced = uTraceStagePush(U_TRACE_STAGE_AT_LOCK_WAIT);
         streamMutex = streamLock(pClient);
+        if (traced) {
+            uTraceStagePop();
+        }
         mutexStackPush(&(pClient->lockedStreamMutexStack), streamMutex);
         if (pClient->pActivityPin != NULL) {
             while (uPortGetTickTimeMs() - pClient->pActivityPin->lastToggleTime <
@@ -3223,6 +3979,8 @@ void uAtClientLock(uAtClientHandle_t atHandle)
         }
         clearError(pClient);
         pClient->lockTimeMs = uPortGetTickTimeMs();
+        U_LOG_RAM_TRACE_BEGIN(U_LOG_RAM_EVENT_AT_CLIENT_LOCK,
+                              U_AT_CLIENT_HANDLE_FOR_PRINT(pClient));
     }
 }
 
@@ -3264,8 +4022,22 @@ int32_t uAtClientUnlock(uAtClientHandle_t atHandle)
 
     U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
 
+#if U_AT_CLIENT_TX_BUFFER_LENGTH_BYTES > 0
+    // Make sure nothing is left behind
+    txBufferFlush(pClient, false);
+#endif
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    // In case there was no uAtClientResponseStop()
+    statsStop(pClient);
+#endif
+    if (pClient->traceInResponse) {
+        uTraceStagePop();
+        pClient->traceInResponse = false;
+    }
+
     streamMutex = mutexStackPop(&(pClient->lockedStreamMutexStack));
     if (streamMutex != NULL) {
+        U_LOG_RAM_TRACE_END(U_LOG_RAM_EVENT_AT_CLIENT_LOCK, (int32_t) pClient->error);
         unlockNoDataCheck(pClient, streamMutex);
 
         switch (pClient->stream.type) {
@@ -3351,6 +4123,9 @@ void uAtClientCommandStart(uAtClientHandle_t atHandle,
         // Note: allow pCommand to be NULL here only
         // because that is useful during testing
         if (pCommand != NULL) {
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+            statsStart(pClient, pCommand);
+#endif
             write(pClient, pCommand, strlen(pCommand), false);
         }
     }
@@ -3358,6 +4133,32 @@ void uAtClientCommandStart(uAtClientHandle_t atHandle,
     U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
 }
 
+// Append a further command to the current AT command line.
+void uAtClientCommandAppend(uAtClientHandle_t atHandle,
+                            const char *pCommand)
+{
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+
+    U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+    if ((pClient->error == U_ERROR_COMMON_SUCCESS) &&
+        (pCommand != NULL)) {
+        // Allow the caller to pass in a complete "AT+BLAH"
+        // since that is what they will have to hand: the
+        // "AT" prefix only appears once on a command line
+        if ((*pCommand == 'A') && (*(pCommand + 1) == 'T')) {
+            pCommand += 2;
+        }
+        // The separator between commands on a line is a semicolon;
+        // the next command gets no parameter delimiter at first
+        write(pClient, ";", 1, false);
+        write(pClient, pCommand, strlen(pCommand), false);
+        pClient->delimiterRequired = false;
+    }
+
+    U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+}
+
 // Write an integer parameter.
 void uAtClientWriteInt(uAtClientHandle_t atHandle,
                        int32_t param)
@@ -3453,6 +4254,35 @@ size_t uAtClientWriteBytes(uAtClientHandle_t atHandle,
     return writeLength;
 }
 
+// Write a list of byte sequences.
+size_t uAtClientWriteVec(uAtClientHandle_t atHandle,
+                         const uAtClientIoVec_t *pIoVec,
+                         size_t ioVecCount,
+                         bool standalone)
+{
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+    size_t writeLength = 0;
+
+    U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+    if ((pIoVec != NULL) &&
+        (standalone || writeCheckAndDelimit(pClient)) &&
+        (pClient->error == U_ERROR_COMMON_SUCCESS)) {
+        for (size_t x = 0; (x < ioVecCount) &&
+             (pClient->error == U_ERROR_COMMON_SUCCESS); x++) {
+            // write() will set device error if there's a problem;
+            // if this is a standalone write, flush after the last one
+            writeLength += write(pClient, (pIoVec + x)->pData,
+                                 (pIoVec + x)->length,
+                                 standalone && (x == ioVecCount - 1));
+        }
+    }
+
+    U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+
+    return writeLength;
+}
+
 void uAtClientWritePartialString(uAtClientHandle_t atHandle,
                                  bool isFirst,
                                  const char *pParam)
@@ -3526,6 +4356,12 @@ int32_t uAtClientResponseStart(uAtClientHandle_t atHandle,
         }
         setScope(pClient, U_AT_CLIENT_SCOPE_NONE);
 
+        // Time from here until uAtClientResponseStop() counts
+        // as waiting for the module's response
+        if (!pClient->traceInResponse) {
+            pClient->traceInResponse = uTraceStagePush(U_TRACE_STAGE_AT_RESPONSE);
+        }
+
         // Bring as much data into the buffer as possible
         // but without blocking
         bufferRewind(pClient);
@@ -3702,6 +4538,92 @@ int32_t uAtClientReadBytes(uAtClientHandle_t atHandle,
     return lengthRead;
 }
 
+// Borrow bytes from the receive buffer.
+int32_t uAtClientReadBytesInPlace(uAtClientHandle_t atHandle,
+                                  const char **ppData,
+                                  size_t lengthBytes)
+{
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+    uAtClientReceiveBuffer_t *pReceiveBuffer;
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    size_t length;
+
+    U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+    if ((ppData != NULL) && (pClient->stopTag.pTagDef == &gNoStopTag)) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+        if ((pClient->error == U_ERROR_COMMON_SUCCESS) &&
+            bufferEnsureUnread(pClient)) {
+            pReceiveBuffer = pClient->pReceiveBuffer;
+            length = pReceiveBuffer->length - pReceiveBuffer->readIndex;
+            if (length > lengthBytes) {
+                length = lengthBytes;
+            }
+            *ppData = U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
+                      pReceiveBuffer->readIndex;
+            errorCodeOrLength = (int32_t) length;
+        }
+    }
+
+    U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+
+    return errorCodeOrLength;
+}
+
+// Consume bytes borrowed with uAtClientReadBytesInPlace().
+void uAtClientReadBytesInPlaceRelease(uAtClientHandle_t atHandle,
+                                      size_t lengthBytes)
+{
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
+
+    U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+    if (lengthBytes > pReceiveBuffer->length - pReceiveBuffer->readIndex) {
+        lengthBytes = pReceiveBuffer->length - pReceiveBuffer->readIndex;
+    }
+    pReceiveBuffer->readIndex += lengthBytes;
+
+    U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+}
+
+// Read whatever raw bytes are available without waiting.
+int32_t uAtClientReadBytesAvailable(uAtClientHandle_t atHandle,
+                                    char *pBuffer,
+                                    size_t lengthBytes)
+{
+    uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
+    uAtClientReceiveBuffer_t *pReceiveBuffer;
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+    size_t length;
+
+    U_AT_CLIENT_LOCK_CLIENT_MUTEX(pClient);
+
+    if (pClient->error == U_ERROR_COMMON_SUCCESS) {
+        if (pClient->pReceiveBuffer->readIndex >= pClient->pReceiveBuffer->length) {
+            // Nothing left in the buffer, see if the stream has more
+            bufferReset(pClient, false);
+            bufferFill(pClient, false);
+        }
+        // The buffer may have moved
+        pReceiveBuffer = pClient->pReceiveBuffer;
+        length = pReceiveBuffer->length - pReceiveBuffer->readIndex;
+        if (length > lengthBytes) {
+            length = lengthBytes;
+        }
+        if ((pBuffer != NULL) && (length > 0)) {
+            memcpy(pBuffer, U_AT_CLIENT_DATA_BUFFER_PTR(pReceiveBuffer) +
+                   pReceiveBuffer->readIndex, length);
+        }
+        pReceiveBuffer->readIndex += length;
+        errorCodeOrLength = (int32_t) length;
+    }
+
+    U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
+
+    return errorCodeOrLength;
+}
+
 int32_t uAtClientReadHexData(uAtClientHandle_t atHandle,
                              uint8_t *pData,
                              uint8_t lengthBytes)
@@ -3715,7 +4637,7 @@ int32_t uAtClientReadHexData(uAtClientHandle_t atHandle,
                                             strSize,
                                             false);
         if (errorOrLength > 0) {
-            errorOrLength = uHexToBin(pHexStr, strlen(pHexStr), (char *)pData);
+            errorOrLength = (int32_t) uHexToBin(pHexStr, errorOrLength, (char *)pData);
         }
         uPortFree(pHexStr);
     } else {
@@ -3742,6 +4664,15 @@ void uAtClientResponseStop(uAtClientHandle_t atHandle)
 
     pClient->lastResponseStopMs = uPortGetTickTimeMs();
 
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    statsStop(pClient);
+#endif
+
+    if (pClient->traceInResponse) {
+        uTraceStagePop();
+        pClient->traceInResponse = false;
+    }
+
     U_AT_CLIENT_UNLOCK_CLIENT_MUTEX(pClient);
 }
 
@@ -3856,7 +4787,6 @@ int32_t uAtClientWaitCharacter(uAtClientHandle_t atHandle,
 {
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
     uAtClientInstance_t *pClient = (uAtClientInstance_t *) atHandle;
-    uAtClientReceiveBuffer_t *pReceiveBuffer = pClient->pReceiveBuffer;
     int32_t stopTimeMs;
     bool urcFound;
 
@@ -3909,7 +4839,7 @@ int32_t uAtClientWaitCharacter(uAtClientHandle_t atHandle,
                 } else {
                     // Remove the processed stuff from the buffer
                     bufferRewind(pClient);
-                    if (pReceiveBuffer->length == 0) {
+                    if (pClient->pReceiveBuffer->readIndex >= pClient->pReceiveBuffer->length) {
                         // If there's nothing left, try to get more stuff
                         if (!bufferFill(pClient, true)) {
                             // If we don't get any data within
@@ -3950,6 +4880,7 @@ int32_t uAtClientSetUrcHandler(uAtClientHandle_t atHandle,
     uAtClientUrc_t *pUrc = NULL;
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
     size_t prefixLength;
+    size_t bucketIndex;
     char *pDest;
 #if U_CFG_ENABLE_LOGGING
     char timestampBuffer[U_AT_CLIENT_PRINT_TIMESTAMP_BUFFER_SIZE_BYTES];
@@ -4006,6 +4937,9 @@ int32_t uAtClientSetUrcHandler(uAtClientHandle_t atHandle,
 
         pUrc->pNext = pClient->pUrcList;
         pClient->pUrcList = pUrc;
+        bucketIndex = urcBucketIndex(pUrc->pPrefix, pUrc->prefixLength);
+        pUrc->pNextInBucket = pClient->pUrcBucket[bucketIndex];
+        pClient->pUrcBucket[bucketIndex] = pUrc;
 
         U_PORT_MUTEX_UNLOCK(pClient->urcPermittedMutex);
     }
@@ -4037,6 +4971,7 @@ void uAtClientRemoveUrcHandler(uAtClientHandle_t atHandle,
             } else {
                 pClient->pUrcList = pCurrent->pNext;
             }
+            urcBucketRemove(pClient, pCurrent);
 
             U_PORT_MUTEX_UNLOCK(pClient->urcPermittedMutex);
 
@@ -4138,18 +5073,35 @@ int32_t uAtClientCallback(uAtClientHandle_t atHandle,
                           void (*pCallback) (uAtClientHandle_t, void *),
                           void *pCallbackParam)
 {
-    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-    uAtClientCallback_t cb = {0}; // Keep Valgrind happy (otherwise the last four bytes will be uninitialised)
+    int32_t errorCode;
 
     U_PORT_MUTEX_LOCK(gMutexEventQueue);
 
-    if (pCallback != NULL) {
-        cb.pFunction = pCallback;
-        cb.atHandle = atHandle;
-        cb.pParam = pCallbackParam;
-        cb.atClientMagicNumber = ((uAtClientInstance_t *) atHandle)->magicNumber;
-        errorCode = uPortEventQueueSend(gEventQueueHandle, &cb, sizeof(cb));
-    }
+    errorCode = callbackSend(gEventQueueHandle, atHandle,
+                             pCallback, pCallbackParam);
+
+    U_PORT_MUTEX_UNLOCK(gMutexEventQueue);
+
+    return errorCode;
+}
+
+// Make a callback resulting from a URC on the priority queue.
+int32_t uAtClientCallbackPriority(uAtClientHandle_t atHandle,
+                                  void (*pCallback) (uAtClientHandle_t, void *),
+                                  void *pCallbackParam)
+{
+    int32_t errorCode;
+    int32_t eventQueueHandle;
+
+    U_PORT_MUTEX_LOCK(gMutexEventQueue);
+
+#if U_AT_CLIENT_PRIORITY_CALLBACK_QUEUE_LENGTH > 0
+    eventQueueHandle = gEventQueueHandlePriority;
+#else
+    eventQueueHandle = gEventQueueHandle;
+#endif
+    errorCode = callbackSend(eventQueueHandle, atHandle,
+                             pCallback, pCallbackParam);
 
     U_PORT_MUTEX_UNLOCK(gMutexEventQueue);
 
@@ -38,6 +38,9 @@
 #include "string.h"    // strlen(), memcmp()
 #include "stdio.h"     // snprintf()
 #include "ctype.h"     // isprint()
+#ifdef __linux__
+# include "time.h"     // clock()
+#endif
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -57,10 +60,16 @@
 
 #include "u_test_util_resource_check.h"
 
+#include "u_trace.h"
+
 #include "u_at_client.h"
 #include "u_at_client_test.h"
 #include "u_at_client_test_data.h"
 
+#ifdef __linux__
+# include "u_port_module_emulator.h"
+#endif
+
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
@@ -136,6 +145,21 @@
  * we need room for initial and trailing line endings. */
 #define U_AT_CLIENT_TEST_AT_BUFFER_LENGTH_BYTES (256 + 4 + U_AT_CLIENT_BUFFER_OVERHEAD_BYTES)
 
+#ifndef U_AT_CLIENT_TEST_EMULATOR_NUM
+/** The number of AT command/response pairs to run against the
+ * module emulator (Linux only).
+ */
+# define U_AT_CLIENT_TEST_EMULATOR_NUM 100
+#endif
+
+#ifndef U_AT_CLIENT_TEST_EMULATOR_BAUD_RATE
+/** The baud rate at which the module emulator (Linux only) should
+ * pace its responses; zero for as fast as possible, which gives
+ * the cleanest measure of the host-side cost of the AT client.
+ */
+# define U_AT_CLIENT_TEST_EMULATOR_BAUD_RATE 0
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -180,6 +204,13 @@ static char gAtServerBuffer[1024];
  */
 static const char *gpInterceptTxDataLast = NULL;
 
+#  if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+/** Somewhere to put the AT client statistics, static to keep
+ * it off the stack.
+ */
+static uAtClientStats_t gStats[U_AT_CLIENT_STATS_NUM_COMMANDS];
+#  endif
+
 # endif
 #endif
 
@@ -858,6 +889,29 @@ static char *pInterceptRx(uAtClientHandle_t atHandle,
 # endif
 #endif
 
+#ifdef __linux__
+
+// URC handler for the module emulator test.
+static void emulatorUrcHandler(uAtClientHandle_t atClientHandle, void *pParameters)
+{
+    volatile int32_t *pCount = (volatile int32_t *) pParameters;
+
+    // Socket and length, as in a SARA +UUSORD URC
+    if ((uAtClientReadInt(atClientHandle) == 0) &&
+        (uAtClientReadInt(atClientHandle) == 12)) {
+        (*pCount)++;
+    }
+}
+
+// Trace callback for the module emulator test: keeps a copy.
+static void emulatorTraceCallback(const uTraceOperation_t *pOperation,
+                                  void *pCallbackParam)
+{
+    *((uTraceOperation_t *) pCallbackParam) = *pOperation;
+}
+
+#endif
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: MISC
  * -------------------------------------------------------------- */
@@ -1137,6 +1191,27 @@ U_PORT_TEST_FUNCTION("[atClient]", "atClientConfiguration")
     U_TEST_PRINT_LINE("delay is now %d ms.", x);
     U_PORT_TEST_ASSERT(x == U_AT_CLIENT_DEFAULT_DELAY_MS + 1);
 
+    x = uAtClientReceiveBufferSizeGet(atClientHandle);
+    U_TEST_PRINT_LINE("receive buffer is %d bytes.", x);
+    U_PORT_TEST_ASSERT(x == U_AT_CLIENT_TEST_AT_BUFFER_LENGTH_BYTES);
+    x = uAtClientReceiveBufferHighWaterMarkGet(atClientHandle);
+    U_TEST_PRINT_LINE("receive buffer high-water mark is %d bytes.", x);
+    U_PORT_TEST_ASSERT((x >= (int32_t) U_AT_CLIENT_BUFFER_OVERHEAD_BYTES) &&
+                       (x <= U_AT_CLIENT_TEST_AT_BUFFER_LENGTH_BYTES));
+    U_PORT_TEST_ASSERT(uAtClientReceiveBufferSizeMaxSet(atClientHandle,
+                                                        U_AT_CLIENT_TEST_AT_BUFFER_LENGTH_BYTES * 2) == 0);
+    // Growth is on demand so the size should not have changed
+    U_PORT_TEST_ASSERT(uAtClientReceiveBufferSizeGet(atClientHandle) ==
+                       U_AT_CLIENT_TEST_AT_BUFFER_LENGTH_BYTES);
+
+    x = uAtClientStatsGet(atClientHandle, NULL, 0);
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    U_TEST_PRINT_LINE("statistics held for %d command(s).", x);
+    U_PORT_TEST_ASSERT(x == 0);
+#else
+    U_PORT_TEST_ASSERT(x == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
+#endif
+
     // Can't do much with this other than set it
     U_TEST_PRINT_LINE("setting consecutive AT timeout callback...");
     uAtClientTimeoutCallbackSet(atClientHandle,
@@ -1188,6 +1263,7 @@ U_PORT_TEST_FUNCTION("[atClient]", "atClientCommandSet1")
     char t = 'T';
     char r = 'R';
     bool restoreStopTag;
+    bool statsOk = true;
     int32_t resourceCount;
 
     memset(&checkCommandResponse, 0, sizeof(checkCommandResponse));
@@ -1506,6 +1582,24 @@ U_PORT_TEST_FUNCTION("[atClient]", "atClientCommandSet1")
                           checkUrc.lastError);
     }
 
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    // Print out the command statistics and check that they are sane
+    y = uAtClientStatsGet(atClientHandle, gStats, sizeof(gStats) / sizeof(gStats[0]));
+    U_TEST_PRINT_LINE("statistics held for %d command(s).", y);
+    statsOk = (y > 0);
+    for (int32_t z = 0; (z < y) && (z < (int32_t) (sizeof(gStats) / sizeof(gStats[0]))); z++) {
+        U_TEST_PRINT_LINE("\"%s\" x %d, %d timeout(s), min/mean/p99/max %d/%d/%d/%d ms,"
+                          " %d/%d byte(s) tx/rx.", gStats[z].prefix, gStats[z].count,
+                          gStats[z].timeoutCount, gStats[z].minMs, gStats[z].meanMs,
+                          gStats[z].p99Ms, gStats[z].maxMs, gStats[z].txBytes,
+                          gStats[z].rxBytes);
+        if ((gStats[z].count <= 0) || (gStats[z].minMs > gStats[z].meanMs) ||
+            (gStats[z].meanMs > gStats[z].maxMs) || (gStats[z].p99Ms > gStats[z].maxMs)) {
+            statsOk = false;
+        }
+    }
+#endif
+
     // Check the stack extents for the URC and callbacks tasks
     checkStackExtents(atClientHandle);
 
@@ -1522,6 +1616,7 @@ U_PORT_TEST_FUNCTION("[atClient]", "atClientCommandSet1")
     // Fail the test if an error occurred: doing this here
     // rather than asserting above so that clean-up happens
     // and hence we don't end up with mutexes left locked
+    U_PORT_TEST_ASSERT(statsOk);
     U_PORT_TEST_ASSERT(checkCommandResponse.commandPassIndex == x);
     U_PORT_TEST_ASSERT(checkCommandResponse.responsePassIndex == x);
     U_PORT_TEST_ASSERT(checkCommandResponse.commandLastError == 0);
@@ -1711,6 +1806,189 @@ U_PORT_TEST_FUNCTION("[atClient]", "atClientCommandSet2")
 # endif
 #endif
 
+#ifdef __linux__
+/** Run the AT client against the module emulator, with a
+ * SARA-like script of responses and URCs, measuring how much host
+ * CPU each AT command/response costs; no hardware is required.
+ */
+U_PORT_TEST_FUNCTION("[atClient]", "atClientEmulator")
+{
+    // The script: the responses and URCs of a SARA module
+    const uPortModuleEmulatorRule_t rules[] = {
+        {"AT+CSQ", "\r\n+CSQ: 20,99\r\n\r\nOK\r\n", 0, NULL, 0},
+        {"AT+USOWR=", "\r\n+USOWR: 0,12\r\n\r\nOK\r\n", 0, "\r\n+UUSORD: 0,12\r\n", 1},
+        {"AT+CGMR", "\r\n11.40\r\n\r\nOK\r\n", 0, NULL, 0}
+    };
+    const uPortModuleEmulatorCfg_t cfg = {
+        .pRules = rules, .numRules = sizeof(rules) / sizeof(rules[0]),
+        .pDefaultResponse = "\r\nERROR\r\n", .defaultDelayMs = 0,
+        .baudRate = U_AT_CLIENT_TEST_EMULATOR_BAUD_RATE, .echo = false
+    };
+    char deviceName[U_PORT_MODULE_EMULATOR_DEVICE_NAME_MAX_LENGTH_BYTES];
+    uPortModuleEmulatorStats_t stats;
+    int32_t emulatorHandle;
+    uAtClientHandle_t atClientHandle;
+    uAtClientStreamHandle_t stream;
+    volatile int32_t urcCount = 0;
+    int32_t numUrcs = 0;
+    int32_t startTimeMs;
+    int32_t timeMs;
+    clock_t startClock;
+    int64_t cpuUs;
+    int32_t y;
+    uPortUartStats_t uartStats;
+    uTraceOperation_t trace = {0};
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    emulatorHandle = uPortModuleEmulatorStart(&cfg, deviceName);
+    U_TEST_PRINT_LINE("module emulator started on \"%s\", handle %d.",
+                      deviceName, emulatorHandle);
+    U_PORT_TEST_ASSERT(emulatorHandle >= 0);
+    U_PORT_TEST_ASSERT(uPortUartPrefix(deviceName) == 0);
+    gUartAHandle = uPortUartOpen(-1, 115200, NULL, U_CFG_TEST_UART_BUFFER_LENGTH_BYTES,
+                                 -1, -1, -1, -1);
+    U_PORT_TEST_ASSERT(gUartAHandle >= 0);
+
+    U_PORT_TEST_ASSERT(uAtClientInit() == 0);
+    stream.handle.int32 = gUartAHandle;
+    stream.type = U_AT_CLIENT_STREAM_TYPE_UART;
+    atClientHandle = uAtClientAddExt(&stream, NULL, U_AT_CLIENT_TEST_AT_BUFFER_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(atClientHandle != NULL);
+    U_PORT_TEST_ASSERT(uAtClientSetUrcHandler(atClientHandle, "+UUSORD:",
+                                              emulatorUrcHandler,
+                                              (void *) &urcCount) == 0);
+    // The emulator doesn't need a gap between AT commands
+    uAtClientDelaySet(atClientHandle, 0);
+
+    U_TEST_PRINT_LINE("running %d AT command(s) against the emulator...",
+                      U_AT_CLIENT_TEST_EMULATOR_NUM);
+    startTimeMs = uPortGetTickTimeMs();
+    startClock = clock();
+    for (size_t x = 0; x < U_AT_CLIENT_TEST_EMULATOR_NUM; x++) {
+        uAtClientLock(atClientHandle);
+        if (x % 2 == 0) {
+            uAtClientCommandStart(atClientHandle, "AT+CSQ");
+            uAtClientCommandStop(atClientHandle);
+            uAtClientResponseStart(atClientHandle, "+CSQ:");
+            U_PORT_TEST_ASSERT(uAtClientReadInt(atClientHandle) == 20);
+            U_PORT_TEST_ASSERT(uAtClientReadInt(atClientHandle) == 99);
+        } else {
+            uAtClientCommandStart(atClientHandle, "AT+USOWR=");
+            uAtClientWriteInt(atClientHandle, 0);
+            uAtClientWriteInt(atClientHandle, 12);
+            uAtClientWriteString(atClientHandle, "0123456789AB", true);
+            uAtClientCommandStop(atClientHandle);
+            uAtClientResponseStart(atClientHandle, "+USOWR:");
+            U_PORT_TEST_ASSERT(uAtClientReadInt(atClientHandle) == 0);
+            U_PORT_TEST_ASSERT(uAtClientReadInt(atClientHandle) == 12);
+            numUrcs++;
+        }
+        uAtClientResponseStop(atClientHandle);
+        y = uAtClientUnlock(atClientHandle);
+        U_PORT_TEST_ASSERT(y == 0);
+    }
+    // Wait for the last URC
+    timeMs = uPortGetTickTimeMs();
+    while ((urcCount < numUrcs) && (uPortGetTickTimeMs() - timeMs < 5000)) {
+        uPortTaskBlock(1);
+    }
+    timeMs = uPortGetTickTimeMs() - startTimeMs;
+    // Note: this is the CPU time of the whole process,
+    // which includes the (small) share of the emulator
+    cpuUs = ((int64_t) (clock() - startClock) * 1000000) / CLOCKS_PER_SEC;
+
+    U_PORT_TEST_ASSERT(uPortModuleEmulatorGetStats(emulatorHandle, &stats) == 0);
+    U_TEST_PRINT_LINE("%d command(s) in %d ms, %d of %d URC(s); emulator received %d"
+                      " command(s), %d unmatched, %d byte(s) in, %d byte(s) out.",
+                      U_AT_CLIENT_TEST_EMULATOR_NUM, timeMs, urcCount, numUrcs,
+                      stats.commandCount, stats.unmatchedCount, stats.bytesReceived,
+                      stats.bytesSent);
+    uPortLog(U_TEST_PREFIX "{\"test\":\"atClientEmulator\",\"baudRate\":%d,"
+             "\"commands\":%d,\"wallMs\":%d,\"cpuUs\":%d,\"cpuUsPerCommand\":%d}\n",
+             U_AT_CLIENT_TEST_EMULATOR_BAUD_RATE, U_AT_CLIENT_TEST_EMULATOR_NUM, timeMs,
+             (int32_t) cpuUs, (int32_t) (cpuUs / U_AT_CLIENT_TEST_EMULATOR_NUM));
+    U_PORT_TEST_ASSERT(urcCount == numUrcs);
+    U_PORT_TEST_ASSERT(stats.commandCount == U_AT_CLIENT_TEST_EMULATOR_NUM);
+    U_PORT_TEST_ASSERT(stats.unmatchedCount == 0);
+
+    // Check that an unscripted command gets the default response
+    // and that an injected URC is delivered
+    uAtClientLock(atClientHandle);
+    uAtClientCommandStart(atClientHandle, "AT+UNKNOWN");
+    uAtClientCommandStopReadResponse(atClientHandle);
+    U_PORT_TEST_ASSERT(uAtClientUnlock(atClientHandle) < 0);
+    numUrcs++;
+    U_PORT_TEST_ASSERT(uPortModuleEmulatorSendUrc(emulatorHandle,
+                                                  "\r\n+UUSORD: 0,12\r\n") == 0);
+    startTimeMs = uPortGetTickTimeMs();
+    while ((urcCount < numUrcs) && (uPortGetTickTimeMs() - startTimeMs < 5000)) {
+        uPortTaskBlock(10);
+    }
+    U_PORT_TEST_ASSERT(urcCount == numUrcs);
+    U_PORT_TEST_ASSERT(uPortModuleEmulatorGetStats(emulatorHandle, &stats) == 0);
+    U_PORT_TEST_ASSERT(stats.unmatchedCount == 1);
+
+    // The UART statistics must agree with the emulator and,
+    // with the AT client keeping up, nothing should be lost
+    U_PORT_TEST_ASSERT(uPortUartStatsGet(gUartAHandle, &uartStats) == 0);
+    U_TEST_PRINT_LINE("UART: %d byte(s) in, %d byte(s) out, %d overrun(s), %d framing"
+                      " error(s), buffer full %d time(s) for %d ms.",
+                      uartStats.bytesReceived, uartStats.bytesSent, uartStats.overrunCount,
+                      uartStats.framingErrorCount, uartStats.bufferFullCount,
+                      uartStats.bufferFullTimeMs);
+    U_PORT_TEST_ASSERT(uartStats.bytesReceived == stats.bytesSent);
+    U_PORT_TEST_ASSERT(uartStats.bytesSent == stats.bytesReceived);
+    U_PORT_TEST_ASSERT(uartStats.overrunCount == 0);
+    U_PORT_TEST_ASSERT(uartStats.bufferFullCount == 0);
+    U_PORT_TEST_ASSERT(uPortUartStatsReset(gUartAHandle) == 0);
+    U_PORT_TEST_ASSERT(uPortUartStatsGet(gUartAHandle, &uartStats) == 0);
+    U_PORT_TEST_ASSERT((uartStats.bytesReceived == 0) && (uartStats.bytesSent == 0));
+
+    // Trace an AT command: each AT stage should be entered once
+    uTraceCallbackSet(emulatorTraceCallback, &trace);
+    y = uTraceOperationStart("AT+CSQ");
+    U_PORT_TEST_ASSERT(y >= 0);
+    uAtClientLock(atClientHandle);
+    uAtClientCommandStart(atClientHandle, "AT+CSQ");
+    uAtClientCommandStop(atClientHandle);
+    uAtClientResponseStart(atClientHandle, "+CSQ:");
+    U_PORT_TEST_ASSERT(uAtClientReadInt(atClientHandle) == 20);
+    uAtClientResponseStop(atClientHandle);
+    uTraceOperationStop(y, uAtClientUnlock(atClientHandle));
+    uTraceCallbackSet(NULL, NULL);
+    U_TEST_PRINT_LINE("AT+CSQ took %d us: lock wait %d us, write %d us, response %d us.",
+                      trace.durationUs, trace.stageUs[U_TRACE_STAGE_AT_LOCK_WAIT],
+                      trace.stageUs[U_TRACE_STAGE_AT_WRITE],
+                      trace.stageUs[U_TRACE_STAGE_AT_RESPONSE]);
+    U_PORT_TEST_ASSERT(trace.result == 0);
+    U_PORT_TEST_ASSERT(trace.stageCount[U_TRACE_STAGE_AT_LOCK_WAIT] == 1);
+    U_PORT_TEST_ASSERT(trace.stageCount[U_TRACE_STAGE_AT_WRITE] >= 1);
+    U_PORT_TEST_ASSERT(trace.stageCount[U_TRACE_STAGE_AT_RESPONSE] == 1);
+    U_PORT_TEST_ASSERT(trace.stageUs[U_TRACE_STAGE_AT_RESPONSE] > 0);
+
+    uAtClientRemove(atClientHandle);
+    uAtClientDeinit();
+    uPortUartClose(gUartAHandle);
+    gUartAHandle = -1;
+    uPortModuleEmulatorStop(emulatorHandle);
+    U_PORT_TEST_ASSERT(uPortModuleEmulatorGetStats(emulatorHandle, &stats) < 0);
+
+    uPortDeinit();
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+#endif // #ifdef __linux__
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
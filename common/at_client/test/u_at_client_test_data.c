@@ -1101,6 +1101,21 @@ static int32_t handleMiscUseLast(uAtClientHandle_t atClientHandle,
         }
     }
 
+    if (lastError == 0) {
+        U_TEST_PRINT_LINE_X("checking that uAtClientCallbackPriority() works.", index + 1);
+
+        // Make a priority AT callback
+        callbackCalled = false;
+        lastError = uAtClientCallbackPriority(atClientHandle, atCallback,
+                                              (void *) &callbackCalled);
+        // Yield so that it can run, then check that it has run
+        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        if (!callbackCalled) {
+            U_TEST_PRINT_LINE_X("priority callback didn't execute.", index + 1);
+            lastError = 3;
+        }
+    }
+
     return lastError;
 }
 
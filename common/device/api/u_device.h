@@ -44,6 +44,13 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_DEVICE_OPEN_PARALLEL_MAX_NUM
+/** The maximum number of devices that may be opened in one call
+ * to uDeviceOpenParallel().
+ */
+# define U_DEVICE_OPEN_PARALLEL_MAX_NUM 4
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -360,6 +367,23 @@ typedef struct {
        this structure must be set to 1 or higher". */
 } uDeviceCfg_t;
 
+/** Callback called by uDeviceOpenParallel() when all of the devices
+ * have been opened, or have failed to open.
+ *
+ * @param errorCode            zero if all of the devices were opened
+ *                             successfully, else the first negative
+ *                             error code that occurred.
+ * @param[in] pDeviceHandles   the pDeviceHandles array passed to
+ *                             uDeviceOpenParallel().
+ * @param numDevices           the number of entries in pDeviceHandles.
+ * @param[in] pCallbackParam   the pCallbackParam passed to
+ *                             uDeviceOpenParallel().
+ */
+typedef void (*uDeviceOpenCallback_t)(int32_t errorCode,
+                                      uDeviceHandle_t *pDeviceHandles,
+                                      size_t numDevices,
+                                      void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -409,6 +433,57 @@ int32_t uDeviceGetDefaults(uDeviceType_t deviceType,
 int32_t uDeviceOpen(const uDeviceCfg_t *pDeviceCfg,
                     uDeviceHandle_t *pDeviceHandle);
 
+/** Open several device instances at the same time, e.g. a cellular
+ * module, a short range module and a GNSS chip, each on its own task,
+ * so that their power-on sequences overlap rather than following
+ * one after the other as they would with repeated calls to
+ * uDeviceOpen().  Each task has a stack of
+ * U_DEVICE_OPEN_TASK_STACK_SIZE_BYTES (see u_device.c).  The other
+ * functions of this API are locked out until all of the opens have
+ * completed.
+ *
+ * If one device fails to open the others are still opened: check
+ * pDeviceHandles to see which were successful and close those
+ * with uDeviceClose() if you wish to give up.
+ *
+ * @param[in] pDeviceCfgs      an array of numDevices device
+ *                             configurations, cannot be NULL; if
+ *                             pCallback is non-NULL this array
+ *                             must remain valid until pCallback
+ *                             has been called.
+ * @param[out] pDeviceHandles  an array of numDevices places to put
+ *                             the device handles, in the same order
+ *                             as pDeviceCfgs; the entry for a device
+ *                             that failed to open will be NULL.
+ *                             Cannot be NULL and, if pCallback is
+ *                             non-NULL, must remain valid until
+ *                             pCallback has been called.
+ * @param numDevices           the number of devices to open, at most
+ *                             #U_DEVICE_OPEN_PARALLEL_MAX_NUM.
+ * @param[in] pCallback        if NULL this function blocks until
+ *                             all of the devices have been opened,
+ *                             else it returns immediately and
+ *                             pCallback is called, from another task,
+ *                             when all of the opens have completed;
+ *                             the parameters of the callback are
+ *                             the first error that occurred (zero if
+ *                             all succeeded), pDeviceHandles,
+ *                             numDevices and pCallbackParam.
+ * @param[in] pCallbackParam   user parameter passed to pCallback.
+ * @return                     in the blocking case zero if all of
+ *                             the devices were opened successfully,
+ *                             else the first negative error code
+ *                             that occurred; in the non-blocking case
+ *                             zero if the opens were started
+ *                             successfully, else a negative error code
+ *                             (and pCallback will not be called).
+ */
+int32_t uDeviceOpenParallel(const uDeviceCfg_t *pDeviceCfgs,
+                            uDeviceHandle_t *pDeviceHandles,
+                            size_t numDevices,
+                            uDeviceOpenCallback_t pCallback,
+                            void *pCallbackParam);
+
 /** Close an open device instance, optionally powering it down.
  *
  * Note: when a device is closed not all memory associated with it
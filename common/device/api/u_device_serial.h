@@ -71,7 +71,7 @@ extern "C" {
 
 /** The version of this API.
  */
-#define U_DEVICE_SERIAL_VERSION 2
+#define U_DEVICE_SERIAL_VERSION 3
 
 /** The event which means that received data is available; this
  * will be sent if the receive buffer goes from empty to containing
@@ -392,6 +392,97 @@ typedef int32_t (*uDeviceSerialDiscardOnOverflow_t)(struct uDeviceSerial_t *pDev
  */
 typedef bool (*uDeviceSerialIsDiscardOnOverflowEnabled_t)(struct uDeviceSerial_t *pDeviceSerial);
 
+/** A buffer to read into, one of the array passed to
+ * #uDeviceSerialReadVector_t.
+ */
+typedef struct {
+    void *pBuffer;
+    size_t sizeBytes;
+} uDeviceSerialReadBuffer_t;
+
+/** A buffer to write from, one of the array passed to
+ * #uDeviceSerialWriteVector_t.
+ */
+typedef struct {
+    const void *pBuffer;
+    size_t sizeBytes;
+} uDeviceSerialWriteBuffer_t;
+
+/** Read from the given serial device into several buffers,
+ * non-blocking, filling each buffer in turn: up to the total
+ * size of the buffers of data already in the serial buffer will
+ * be returned.  If this is not implemented by the serial device
+ * a default implementation which calls #uDeviceSerialRead_t for
+ * each buffer is used.
+ *
+ * This function is only present in #U_DEVICE_SERIAL_VERSION 3 and later
+ *
+ * @param pDeviceSerial   the serial device; cannot be NULL.
+ * @param[in] pBuffers    an array of numBuffers buffers to read into.
+ * @param numBuffers      the number of entries in pBuffers.
+ * @return                the total number of bytes received else
+ *                        negative error code.
+ */
+typedef int32_t (*uDeviceSerialReadVector_t)(struct uDeviceSerial_t *pDeviceSerial,
+                                             const uDeviceSerialReadBuffer_t *pBuffers,
+                                             size_t numBuffers);
+
+/** Write several buffers to the given serial device, e.g. a header
+ * and a body, without having to first copy them into one.  Will
+ * block until all of the data has been written or an error has
+ * occurred.  If this is not implemented by the serial device a
+ * default implementation which calls #uDeviceSerialWrite_t for
+ * each buffer is used.
+ *
+ * This function is only present in #U_DEVICE_SERIAL_VERSION 3 and later
+ *
+ * @param pDeviceSerial   the serial device; cannot be NULL.
+ * @param[in] pBuffers    an array of numBuffers buffers to write.
+ * @param numBuffers      the number of entries in pBuffers.
+ * @return                the total number of bytes sent or negative
+ *                        error code.
+ */
+typedef int32_t (*uDeviceSerialWriteVector_t)(struct uDeviceSerial_t *pDeviceSerial,
+                                              const uDeviceSerialWriteBuffer_t *pBuffers,
+                                              size_t numBuffers);
+
+/** Get a pointer to the received data that is next to be read,
+ * inside the receive buffer of the serial device, so that it can
+ * be processed without being copied out first; call
+ * #uDeviceSerialConsume_t to remove it from the receive buffer
+ * when done.  The number of bytes returned may be less than
+ * #uDeviceSerialGetReceiveSize_t if the received data wraps
+ * around the end of a ring buffer: consume what is returned and
+ * call this again for the remainder.  The data remains valid until
+ * it is consumed or the device is closed; there must be only one
+ * reader.  Where this is not supported #U_ERROR_COMMON_NOT_IMPLEMENTED
+ * will be returned and #uDeviceSerialRead_t should be used instead.
+ *
+ * This function is only present in #U_DEVICE_SERIAL_VERSION 3 and later
+ *
+ * @param pDeviceSerial   the serial device; cannot be NULL.
+ * @param[out] ppData     a place to put a pointer to the received
+ *                        data; cannot be NULL.
+ * @return                the number of contiguous bytes at *ppData,
+ *                        which may be zero, else negative error code.
+ */
+typedef int32_t (*uDeviceSerialPeek_t)(struct uDeviceSerial_t *pDeviceSerial,
+                                       const void **ppData);
+
+/** Remove data that was obtained with #uDeviceSerialPeek_t from
+ * the receive buffer of a serial device.
+ *
+ * This function is only present in #U_DEVICE_SERIAL_VERSION 3 and later
+ *
+ * @param pDeviceSerial   the serial device; cannot be NULL.
+ * @param sizeBytes       the number of bytes to remove, no more than
+ *                        was returned by #uDeviceSerialPeek_t.
+ * @return                the number of bytes removed else negative
+ *                        error code.
+ */
+typedef int32_t (*uDeviceSerialConsume_t)(struct uDeviceSerial_t *pDeviceSerial,
+                                          size_t sizeBytes);
+
 /* ----------------------------------------------------------------
  * TYPES: VECTOR TABLE
  * -------------------------------------------------------------- */
@@ -418,6 +509,10 @@ typedef struct uDeviceSerial_t {
     uDeviceSerialCtsResume_t ctsResume;
     uDeviceSerialDiscardOnOverflow_t discardOnOverflow;
     uDeviceSerialIsDiscardOnOverflowEnabled_t isDiscardOnOverflowEnabled;
+    uDeviceSerialReadVector_t readVector;
+    uDeviceSerialWriteVector_t writeVector;
+    uDeviceSerialPeek_t peek;
+    uDeviceSerialConsume_t consume;
 } uDeviceSerial_t;
 
 /** The initialisation callback; this should populate the table
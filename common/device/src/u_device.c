@@ -25,10 +25,14 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"   //
+#include "string.h"    // memset()
+
+#include "u_cfg_os_platform_specific.h"
 
 #include "u_error_common.h"
 
 #include "u_port_os.h"
+#include "u_port_heap.h"
 
 #include "u_device.h"
 #include "u_device_shared.h"
@@ -55,10 +59,51 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_DEVICE_OPEN_TASK_STACK_SIZE_BYTES
+/** The stack size of each of the tasks used by
+ * uDeviceOpenParallel(): a device open runs the same code as
+ * uDeviceOpen() would in the calling task, including the AT
+ * client and the power-on sequence, hence this is the same as
+ * the stack allowed for the GNSS position task.
+ */
+# define U_DEVICE_OPEN_TASK_STACK_SIZE_BYTES (1024 * 5)
+#endif
+
+#ifndef U_DEVICE_OPEN_TASK_PRIORITY
+/** The priority of each of the tasks used by uDeviceOpenParallel().
+ */
+# define U_DEVICE_OPEN_TASK_PRIORITY (U_CFG_OS_PRIORITY_MIN + 2)
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+struct uDeviceOpenContext_t;
+
+/** The parameter passed to each of the tasks that opens a device
+ * for uDeviceOpenParallel().
+ */
+typedef struct {
+    struct uDeviceOpenContext_t *pContext;
+    size_t index;
+} uDeviceOpenTaskParameter_t;
+
+/** Context for uDeviceOpenParallel(), allocated together with one
+ * uDeviceOpenTaskParameter_t per device.
+ */
+typedef struct uDeviceOpenContext_t {
+    const uDeviceCfg_t *pDeviceCfgs;
+    uDeviceHandle_t *pDeviceHandles;
+    size_t numDevices;
+    uDeviceOpenCallback_t pCallback;
+    void *pCallbackParam;
+    uPortMutexHandle_t mutex; // Protects numRunning and errorCode
+    size_t numRunning;
+    int32_t errorCode;
+    uDeviceOpenTaskParameter_t *pTaskParameters;
+} uDeviceOpenContext_t;
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
@@ -67,6 +112,160 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Forward declaration of the injection hook, see below.
+int32_t uDeviceCallback(const char *pOperationType,
+                        void *pOperationParam1,
+                        void *pOperationParam2);
+
+// Open a device: the caller must have called uDeviceLock(), or
+// must be running on behalf of something that has.
+static int32_t deviceOpen(const uDeviceCfg_t *pDeviceCfg, uDeviceHandle_t *pDeviceHandle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (pDeviceCfg != NULL) {
+        errorCode = uDeviceCallback("open", (void *)pDeviceCfg->deviceType, NULL);
+    }
+
+    if (errorCode == 0) {
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pDeviceCfg->version == 0) && (pDeviceHandle != NULL)) {
+            switch (pDeviceCfg->deviceType) {
+                case U_DEVICE_TYPE_CELL:
+                    errorCode = uDevicePrivateCellAdd(pDeviceCfg, pDeviceHandle);
+                    if (errorCode == 0) {
+                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgCell.moduleType;
+                    }
+                    break;
+                case U_DEVICE_TYPE_GNSS:
+                    errorCode = uDevicePrivateGnssAdd(pDeviceCfg, pDeviceHandle);
+                    if (errorCode == 0) {
+                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgGnss.moduleType;
+                    }
+                    break;
+                case U_DEVICE_TYPE_SHORT_RANGE:
+                    errorCode = uDevicePrivateShortRangeAdd(pDeviceCfg, pDeviceHandle);
+                    if (errorCode == 0) {
+                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgSho.moduleType;
+                    }
+                    break;
+                case U_DEVICE_TYPE_SHORT_RANGE_OPEN_CPU:
+                    errorCode = uDevicePrivateShortRangeOpenCpuAdd(pDeviceCfg, pDeviceHandle);
+                    if (errorCode == 0) {
+                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgSho.moduleType;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Task that opens one of the devices for uDeviceOpenParallel().
+static void openTask(void *pParameter)
+{
+    uDeviceOpenTaskParameter_t *pTaskParameter = (uDeviceOpenTaskParameter_t *) pParameter;
+    uDeviceOpenContext_t *pContext = pTaskParameter->pContext;
+    size_t index = pTaskParameter->index;
+    int32_t errorCode;
+
+    errorCode = deviceOpen(&(pContext->pDeviceCfgs[index]),
+                           &(pContext->pDeviceHandles[index]));
+
+    U_PORT_MUTEX_LOCK(pContext->mutex);
+
+    if ((errorCode < 0) && (pContext->errorCode == 0)) {
+        pContext->errorCode = errorCode;
+    }
+    pContext->numRunning--;
+
+    U_PORT_MUTEX_UNLOCK(pContext->mutex);
+
+    // Delete ourselves: pContext must not be touched
+    // after this point as it may already have been freed
+    uPortTaskDelete(NULL);
+}
+
+// Open all of the devices in pContext, one task per device,
+// returning when they have all been opened or have failed.
+static int32_t openAll(uDeviceOpenContext_t *pContext)
+{
+    int32_t errorCode;
+    uPortTaskHandle_t taskHandle;
+    size_t numRunning = 1;
+
+    // Lock the device API for the duration; the device-specific
+    // APIs underneath each have their own mutex, which is what
+    // allows the opens to proceed in parallel
+    errorCode = uDeviceLock();
+    if (errorCode == 0) {
+        for (size_t x = 0; x < pContext->numDevices; x++) {
+            pContext->pDeviceHandles[x] = NULL;
+            pContext->pTaskParameters[x].pContext = pContext;
+            pContext->pTaskParameters[x].index = x;
+            U_PORT_MUTEX_LOCK(pContext->mutex);
+            pContext->numRunning++;
+            U_PORT_MUTEX_UNLOCK(pContext->mutex);
+            errorCode = uPortTaskCreate(openTask, "deviceOpen",
+                                        U_DEVICE_OPEN_TASK_STACK_SIZE_BYTES,
+                                        (void *) &(pContext->pTaskParameters[x]),
+                                        U_DEVICE_OPEN_TASK_PRIORITY,
+                                        &taskHandle);
+            if (errorCode != 0) {
+                U_PORT_MUTEX_LOCK(pContext->mutex);
+                pContext->numRunning--;
+                if (pContext->errorCode == 0) {
+                    pContext->errorCode = errorCode;
+                }
+                U_PORT_MUTEX_UNLOCK(pContext->mutex);
+            }
+        }
+
+        // Wait for all of the tasks to finish
+        while (numRunning > 0) {
+            U_PORT_MUTEX_LOCK(pContext->mutex);
+            numRunning = pContext->numRunning;
+            U_PORT_MUTEX_UNLOCK(pContext->mutex);
+            if (numRunning > 0) {
+                uPortTaskBlock(U_CFG_OS_YIELD_MS);
+            }
+        }
+
+        errorCode = pContext->errorCode;
+
+        // ...and done
+        uDeviceUnlock();
+    }
+
+    return errorCode;
+}
+
+// Free a context created by uDeviceOpenParallel().
+static void contextFree(uDeviceOpenContext_t *pContext)
+{
+    uPortMutexDelete(pContext->mutex);
+    uPortFree(pContext);
+}
+
+// Task that runs openAll() and then calls the user's callback,
+// for the non-blocking case of uDeviceOpenParallel().
+static void openAllTask(void *pParameter)
+{
+    uDeviceOpenContext_t *pContext = (uDeviceOpenContext_t *) pParameter;
+    int32_t errorCode;
+
+    errorCode = openAll(pContext);
+    pContext->pCallback(errorCode, pContext->pDeviceHandles,
+                        pContext->numDevices, pContext->pCallbackParam);
+    contextFree(pContext);
+
+    // Delete ourselves
+    uPortTaskDelete(NULL);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -258,45 +457,61 @@ int32_t uDeviceOpen(const uDeviceCfg_t *pDeviceCfg, uDeviceHandle_t *pDeviceHand
     // Lock the API
     int32_t errorCode = uDeviceLock();
 
-    if (errorCode == 0 && pDeviceCfg != NULL) {
-        errorCode = uDeviceCallback("open", (void *)pDeviceCfg->deviceType, NULL);
+    if (errorCode == 0) {
+        errorCode = deviceOpen(pDeviceCfg, pDeviceHandle);
+
+        // ...and done
+        uDeviceUnlock();
     }
 
-    if (errorCode == 0) {
-        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-        if ((pDeviceCfg != NULL) && (pDeviceCfg->version == 0) && (pDeviceHandle != NULL)) {
-            switch (pDeviceCfg->deviceType) {
-                case U_DEVICE_TYPE_CELL:
-                    errorCode = uDevicePrivateCellAdd(pDeviceCfg, pDeviceHandle);
-                    if (errorCode == 0) {
-                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgCell.moduleType;
-                    }
-                    break;
-                case U_DEVICE_TYPE_GNSS:
-                    errorCode = uDevicePrivateGnssAdd(pDeviceCfg, pDeviceHandle);
-                    if (errorCode == 0) {
-                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgGnss.moduleType;
-                    }
-                    break;
-                case U_DEVICE_TYPE_SHORT_RANGE:
-                    errorCode = uDevicePrivateShortRangeAdd(pDeviceCfg, pDeviceHandle);
-                    if (errorCode == 0) {
-                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgSho.moduleType;
-                    }
-                    break;
-                case U_DEVICE_TYPE_SHORT_RANGE_OPEN_CPU:
-                    errorCode = uDevicePrivateShortRangeOpenCpuAdd(pDeviceCfg, pDeviceHandle);
-                    if (errorCode == 0) {
-                        U_DEVICE_INSTANCE(*pDeviceHandle)->moduleType = pDeviceCfg->deviceCfg.cfgSho.moduleType;
+    return errorCode;
+}
+
+int32_t uDeviceOpenParallel(const uDeviceCfg_t *pDeviceCfgs,
+                            uDeviceHandle_t *pDeviceHandles,
+                            size_t numDevices,
+                            uDeviceOpenCallback_t pCallback,
+                            void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uDeviceOpenContext_t *pContext;
+    uPortTaskHandle_t taskHandle;
+
+    if ((pDeviceCfgs != NULL) && (pDeviceHandles != NULL) &&
+        (numDevices > 0) && (numDevices <= U_DEVICE_OPEN_PARALLEL_MAX_NUM)) {
+        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        pContext = (uDeviceOpenContext_t *) pUPortMalloc(sizeof(uDeviceOpenContext_t) +
+                                                         (sizeof(uDeviceOpenTaskParameter_t) *
+                                                          numDevices));
+        if (pContext != NULL) {
+            memset(pContext, 0, sizeof(*pContext));
+            pContext->pDeviceCfgs = pDeviceCfgs;
+            pContext->pDeviceHandles = pDeviceHandles;
+            pContext->numDevices = numDevices;
+            pContext->pCallback = pCallback;
+            pContext->pCallbackParam = pCallbackParam;
+            pContext->pTaskParameters = (uDeviceOpenTaskParameter_t *) (pContext + 1);
+            errorCode = uPortMutexCreate(&(pContext->mutex));
+            if (errorCode == 0) {
+                if (pCallback == NULL) {
+                    // Blocking
+                    errorCode = openAll(pContext);
+                    contextFree(pContext);
+                } else {
+                    // Non-blocking: openAllTask() will free the context
+                    errorCode = uPortTaskCreate(openAllTask, "deviceOpenAll",
+                                                U_DEVICE_OPEN_TASK_STACK_SIZE_BYTES,
+                                                (void *) pContext,
+                                                U_DEVICE_OPEN_TASK_PRIORITY,
+                                                &taskHandle);
+                    if (errorCode != 0) {
+                        contextFree(pContext);
                     }
-                    break;
-                default:
-                    break;
+                }
+            } else {
+                uPortFree(pContext);
             }
         }
-
-        // ...and done
-        uDeviceUnlock();
     }
 
     return errorCode;
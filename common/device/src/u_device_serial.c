@@ -122,6 +122,71 @@ static int32_t serialDefaultDiscardOnOverflow(struct uDeviceSerial_t *pDeviceSer
     return (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED;
 }
 
+// Default vectored read: call read() for each buffer, stopping
+// when one isn't filled since the receive buffer is then empty.
+static int32_t serialDefaultReadVector(struct uDeviceSerial_t *pDeviceSerial,
+                                       const uDeviceSerialReadBuffer_t *pBuffers,
+                                       size_t numBuffers)
+{
+    int32_t sizeOrErrorCode = 0;
+    int32_t thisSize = 0;
+
+    for (size_t x = 0; (x < numBuffers) && (thisSize >= 0); x++) {
+        thisSize = pDeviceSerial->read(pDeviceSerial, pBuffers[x].pBuffer,
+                                       pBuffers[x].sizeBytes);
+        if (thisSize >= 0) {
+            sizeOrErrorCode += thisSize;
+            if (thisSize < (int32_t) pBuffers[x].sizeBytes) {
+                thisSize = -1;
+            }
+        } else if (sizeOrErrorCode == 0) {
+            sizeOrErrorCode = thisSize;
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+
+// Default vectored write: call write() for each buffer.
+static int32_t serialDefaultWriteVector(struct uDeviceSerial_t *pDeviceSerial,
+                                        const uDeviceSerialWriteBuffer_t *pBuffers,
+                                        size_t numBuffers)
+{
+    int32_t sizeOrErrorCode = 0;
+    int32_t thisSize = 0;
+
+    for (size_t x = 0; (x < numBuffers) && (thisSize >= 0); x++) {
+        thisSize = pDeviceSerial->write(pDeviceSerial, pBuffers[x].pBuffer,
+                                        pBuffers[x].sizeBytes);
+        if (thisSize >= 0) {
+            sizeOrErrorCode += thisSize;
+            if (thisSize < (int32_t) pBuffers[x].sizeBytes) {
+                thisSize = -1;
+            }
+        } else if (sizeOrErrorCode == 0) {
+            sizeOrErrorCode = thisSize;
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+
+static int32_t serialDefaultPeek(struct uDeviceSerial_t *pDeviceSerial,
+                                 const void **ppData)
+{
+    (void) pDeviceSerial;
+    (void) ppData;
+    return (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED;
+}
+
+static int32_t serialDefaultConsume(struct uDeviceSerial_t *pDeviceSerial,
+                                    size_t sizeBytes)
+{
+    (void) pDeviceSerial;
+    (void) sizeBytes;
+    return (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED;
+}
+
 static void serialDefaultVoid(struct uDeviceSerial_t *pDeviceSerial)
 {
     (void) pDeviceSerial;
@@ -176,6 +241,10 @@ static void init(uInterfaceTable_t pInterfaceTable, void *pInitParam)
     pDeviceSerial->ctsResume = serialDefaultVoid;
     pDeviceSerial->discardOnOverflow = serialDefaultDiscardOnOverflow;
     pDeviceSerial->isDiscardOnOverflowEnabled = serialDefaultBool;
+    pDeviceSerial->readVector = serialDefaultReadVector;
+    pDeviceSerial->writeVector = serialDefaultWriteVector;
+    pDeviceSerial->peek = serialDefaultPeek;
+    pDeviceSerial->consume = serialDefaultConsume;
 
     if (pInit != NULL) {
         pInit(pInterfaceTable);
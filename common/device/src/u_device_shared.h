@@ -83,6 +83,11 @@ typedef struct {
     uDeviceType_t deviceType;   /**< type of device. */
     int32_t moduleType;         /**< module identification (when applicable). */
     void *pContext;             /**< private instance data for the device. */
+    void *pApiInstance;         /**< the instance of the API that owns the device
+                                     (e.g. a uCellPrivateInstance_t), set when
+                                     that API adds the device so that it can find
+                                     its instance from the device handle without
+                                     searching a list. */
     uDeviceNetworkData_t networkData[U_DEVICE_NETWORKS_MAX_NUM]; /**< network cfg and private data. */
     // Note: In the future structs of function pointers for socket, MQTT etc.
     // implementations may be added here.
@@ -32,6 +32,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memcpy(), memcmp()
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -118,6 +119,15 @@ typedef struct {
 
 #endif
 
+/** Context data for the vectored serial device test: a buffer
+ * which is written to and then read back.
+ */
+typedef struct {
+    char buffer[64];
+    size_t length;
+    size_t readOffset;
+} uDeviceTestMemorySerialContext_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -368,6 +378,50 @@ static void interfaceSerialInit(struct uDeviceSerial_t *pDeviceSerial)
 
 #endif
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: FOR THE VECTORED SERIAL TEST
+ * -------------------------------------------------------------- */
+
+// Write to a memory-backed serial device.
+static int32_t memorySerialWrite(struct uDeviceSerial_t *pDeviceSerial,
+                                 const void *pBuffer, size_t sizeBytes)
+{
+    uDeviceTestMemorySerialContext_t *pContext = (uDeviceTestMemorySerialContext_t *)
+                                                 pUInterfaceContext(pDeviceSerial);
+
+    if (sizeBytes > sizeof(pContext->buffer) - pContext->length) {
+        sizeBytes = sizeof(pContext->buffer) - pContext->length;
+    }
+    memcpy(pContext->buffer + pContext->length, pBuffer, sizeBytes);
+    pContext->length += sizeBytes;
+
+    return (int32_t) sizeBytes;
+}
+
+// Read from a memory-backed serial device.
+static int32_t memorySerialRead(struct uDeviceSerial_t *pDeviceSerial,
+                                void *pBuffer, size_t sizeBytes)
+{
+    uDeviceTestMemorySerialContext_t *pContext = (uDeviceTestMemorySerialContext_t *)
+                                                 pUInterfaceContext(pDeviceSerial);
+
+    if (sizeBytes > pContext->length - pContext->readOffset) {
+        sizeBytes = pContext->length - pContext->readOffset;
+    }
+    memcpy(pBuffer, pContext->buffer + pContext->readOffset, sizeBytes);
+    pContext->readOffset += sizeBytes;
+
+    return (int32_t) sizeBytes;
+}
+
+// Populate a memory-backed serial device with read and write only,
+// so that the default vectored functions are used.
+static void memorySerialInit(struct uDeviceSerial_t *pDeviceSerial)
+{
+    pDeviceSerial->read = memorySerialRead;
+    pDeviceSerial->write = memorySerialWrite;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -491,4 +545,60 @@ U_PORT_TEST_FUNCTION("[device]", "deviceSerialCleanup")
 
 #endif
 
+/** Test the default vectored read/write functions of a serial device
+ * and that peek is reported as not implemented.
+ */
+U_PORT_TEST_FUNCTION("[device]", "deviceSerialVector")
+{
+    int32_t resourceCount;
+    uDeviceSerial_t *pDeviceSerial;
+    const char *pExpected = "headerbodytrailer";
+    uDeviceSerialWriteBuffer_t writeBuffers[] = {{"header", 6},
+        {"body", 4},
+        {"", 0},
+        {"trailer", 7}
+    };
+    char first[4];
+    char second[32];
+    uDeviceSerialReadBuffer_t readBuffers[] = {{first, sizeof(first)},
+        {second, sizeof(second)}
+    };
+    const void *pData = NULL;
+
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    uPortInit();
+
+    pDeviceSerial = pUDeviceSerialCreate(memorySerialInit,
+                                         sizeof(uDeviceTestMemorySerialContext_t));
+    U_PORT_TEST_ASSERT(pDeviceSerial != NULL);
+    U_PORT_TEST_ASSERT(uInterfaceVersion(pDeviceSerial) == U_DEVICE_SERIAL_VERSION);
+
+    U_PORT_TEST_ASSERT(pDeviceSerial->writeVector(pDeviceSerial, writeBuffers,
+                                                  sizeof(writeBuffers) /
+                                                  sizeof(writeBuffers[0])) == 17);
+    U_PORT_TEST_ASSERT(pDeviceSerial->readVector(pDeviceSerial, readBuffers,
+                                                 sizeof(readBuffers) /
+                                                 sizeof(readBuffers[0])) == 17);
+    U_PORT_TEST_ASSERT(memcmp(first, pExpected, sizeof(first)) == 0);
+    U_PORT_TEST_ASSERT(memcmp(second, pExpected + sizeof(first), 17 - sizeof(first)) == 0);
+    // Nothing left
+    U_PORT_TEST_ASSERT(pDeviceSerial->readVector(pDeviceSerial, readBuffers, 1) == 0);
+
+    U_PORT_TEST_ASSERT(pDeviceSerial->peek(pDeviceSerial,
+                                           &pData) == (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED);
+    U_PORT_TEST_ASSERT(pDeviceSerial->consume(pDeviceSerial,
+                                              1) == (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED);
+
+    uDeviceSerialDelete(pDeviceSerial);
+
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 // End of file
\ No newline at end of file
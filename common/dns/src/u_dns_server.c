@@ -63,6 +63,29 @@
 # define U_DNS_TTL 600
 #endif
 
+#ifndef U_DNS_SERVER_POLL_INTERVAL_MS
+/** How long to wait between checks for incoming requests once all
+ * of those that have arrived have been answered.
+ */
+# define U_DNS_SERVER_POLL_INTERVAL_MS 100
+#endif
+
+#ifndef U_DNS_SERVER_MAX_REQUESTS_PER_POLL
+/** The maximum number of requests to answer in one go before
+ * waiting and checking the keep-going callback again.
+ */
+# define U_DNS_SERVER_MAX_REQUESTS_PER_POLL 16
+#endif
+
+#ifndef U_DNS_SERVER_LOG_QUERIES
+/** Set this to 1 to print the name in each query that is answered;
+ * off by default since printing every lookup slows down the
+ * answering of the bursts of queries that a client makes on
+ * connecting.
+ */
+# define U_DNS_SERVER_LOG_QUERIES 0
+#endif
+
 #define DNS_QR_QUERY      0
 #define DNS_QR_RESPONSE   1
 #define DNS_OPCODE_QUERY  0
@@ -129,6 +152,51 @@ static uint32_t htonl(uint32_t x)
     return retVal;
 }
 
+// Return the length of the single question at pQuestion, including
+// the query type and class, or -1 if it is not all there.
+static int32_t questionLength(const uint8_t *pQuestion, int32_t length)
+{
+    int32_t x = 0;
+
+    // Walk the labels of the name to find its end
+    while ((x < length) && (pQuestion[x] != 0)) {
+        x += pQuestion[x] + 1;
+    }
+    // Add the terminating zero, the type and the class
+    x += 5;
+    if (x > length) {
+        x = -1;
+    }
+
+    return x;
+}
+
+#if U_DNS_SERVER_LOG_QUERIES
+// Print the name in a valid question.
+static void logName(const uint8_t *pQuestion)
+{
+    char name[100];
+    size_t length = 0;
+    uint8_t labelLength;
+
+    name[0] = 0;
+    while (*pQuestion != 0) {
+        labelLength = *pQuestion;
+        if (sizeof(name) - length > (size_t) labelLength + 1) {
+            memcpy(name + length, pQuestion + 1, labelLength);
+            length += labelLength;
+            name[length++] = '.';
+            name[length] = 0;
+        }
+        pQuestion += labelLength + 1;
+    }
+    if (length > 0) {
+        name[length - 1] = 0;
+    }
+    uPortLog("U_DNS lookup: %s\n", name);
+}
+#endif
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -141,9 +209,20 @@ int32_t uDnsServer(uDeviceHandle_t deviceHandle,
     uSockStringToAddress(pIpAddr, &lookupAddr);
     // Address in network endian format
     uint32_t netAddr = htonl(lookupAddr.ipAddress.address.ipv4);
-    uint8_t netAddrLen = sizeof(netAddr);
     // Time to live for the response in seconds
     uint32_t ttl = htonl(U_DNS_TTL);
+    // The answer is the same for every query, since any requested
+    // name maps to the address specified by pIpAddr, hence it is
+    // built once here and only copied in after each question
+    uint8_t answer[16] = {
+        0xC0, 0x0C,  // Answer name is a pointer to the name at offset 12
+        0, 1,        // Answer is type A query (host address)
+        0, 1         // Answer is class IN (Internet address)
+    };
+    memcpy(answer + 6, (uint8_t *)&ttl, sizeof(ttl));
+    answer[10] = 0;
+    answer[11] = sizeof(netAddr);
+    memcpy(answer + 12, (uint8_t *)&netAddr, sizeof(netAddr));
 
     int32_t sock = uSockCreate(deviceHandle,
                                U_SOCK_TYPE_DGRAM,
@@ -161,96 +240,66 @@ int32_t uDnsServer(uDeviceHandle_t deviceHandle,
     memset(buff, 0, sizeof(buff));
     uPortLog("U_DNS: server started\n");
     while (true) {
-        int32_t errOrCnt = uSockReceiveFrom(sock,
-                                            &remoteAddr,
-                                            buff,
-                                            sizeof(buff));
-        if (errOrCnt > (int32_t)sizeof(uDnsHeader_t)) {
-            // Incoming request
-            uDnsHeader_t *pHeader = (uDnsHeader_t *)buff;
-            bool valid =
-                pHeader->QR == DNS_QR_QUERY &&
-                pHeader->OPCode == DNS_OPCODE_QUERY &&
-                ntohs(pHeader->QDCount) == 1 &&
-                pHeader->ANCount == 0 &&
-                pHeader->NSCount == 0 &&
-                pHeader->ARCount == 0;
-            if (valid) {
-                // Create a response which maps any requested name
-                // to the address specified by pIpAddr
-                pHeader->QR = DNS_QR_RESPONSE;
-                pHeader->ANCount = pHeader->QDCount;
-                uint8_t *pData = buff + sizeof(uDnsHeader_t);
-                // Need to parse the query name even if it is ignored
-                // in order to get the correct position for the response ip.
-                // Also print the name for debugging purposes.
-                char name[100];
-                memset(name, 0, sizeof(name));
-                int32_t remain = errOrCnt - sizeof(uDnsHeader_t);
-                while (remain > 0 && *pData != 0) {
-                    uint8_t len = *pData + 1;
-                    if (len > remain) {
-                        valid = false;
-                        break;
-                    }
-                    if (sizeof(name) - strlen(name) > len) {
-                        strncat(name, (char *)(pData + 1), len - 1);
-                        strcat(name, ".");
-                    }
-                    remain -= len;
-                    pData += len;
-                }
-                if (strlen(name)) {
-                    name[strlen(name) - 1] = 0;
-                }
+        int32_t errOrCnt;
+        int32_t numRequests = 0;
+        // Deal with everything that has arrived, e.g. a burst of
+        // connectivity checks from a newly joined client, before
+        // waiting again
+        do {
+            errOrCnt = uSockReceiveFrom(sock,
+                                        &remoteAddr,
+                                        buff,
+                                        sizeof(buff));
+            if (errOrCnt > (int32_t)sizeof(uDnsHeader_t)) {
+                // Incoming request
+                numRequests++;
+                uDnsHeader_t *pHeader = (uDnsHeader_t *)buff;
+                uint8_t *pQuestion = buff + sizeof(uDnsHeader_t);
+                int32_t length = -1;
+                bool valid =
+                    pHeader->QR == DNS_QR_QUERY &&
+                    pHeader->OPCode == DNS_OPCODE_QUERY &&
+                    ntohs(pHeader->QDCount) == 1 &&
+                    pHeader->ANCount == 0 &&
+                    pHeader->NSCount == 0 &&
+                    pHeader->ARCount == 0;
                 if (valid) {
-                    uPortLog("U_DNS lookup: %s\n", name);
+                    // Only the length of the question is needed, the
+                    // question itself is sent back as it is
+                    length = questionLength(pQuestion, errOrCnt - sizeof(uDnsHeader_t));
+                    // Make sure we have space for the answer as well in the buffer
+                    valid = (length > 0) &&
+                            (sizeof(uDnsHeader_t) + length + sizeof(answer) <= sizeof(buff));
                 }
-
-                // Make sure we have space for the address as well in the buffer
-                valid = valid && (((pData - buff) + 21) < sizeof(buff));
-
                 if (valid) {
-                    // Skip remaining
-                    pData += 5;
-                    // Answer name is a pointer
-                    *(pData++) = 0xC0;
-                    // Pointer is to the name at offset
-                    *(pData++) = 0x0C;
-                    // Answer is type A query (host address)
-                    *(pData++) = 0;
-                    *(pData++) = 1;
-                    // Answer is class IN (Internet address)
-                    *(pData++) = 0;
-                    *(pData++) = 1;
-                    // TTL
-                    memcpy(pData, (uint8_t *)&ttl, sizeof(ttl));
-                    pData += sizeof(ttl);
-                    // The fixed lookup address
-                    *(pData++) = 0;
-                    *(pData++) = netAddrLen;
-                    memcpy(pData, (uint8_t *)&netAddr, netAddrLen);
-                    pData += netAddrLen;
-                    uSockSendTo(sock, &remoteAddr, buff, pData - buff);
+#if U_DNS_SERVER_LOG_QUERIES
+                    logName(pQuestion);
+#endif
+                    // Patch the query into a response in place, keeping
+                    // the transaction ID and the question
+                    pHeader->QR = DNS_QR_RESPONSE;
+                    pHeader->ANCount = pHeader->QDCount;
+                    memcpy(pQuestion + length, answer, sizeof(answer));
+                    uSockSendTo(sock, &remoteAddr, buff,
+                                sizeof(uDnsHeader_t) + length + sizeof(answer));
+                } else {
+                    // Send an error response
+                    int32_t dnsError =
+                        pHeader->OPCode != DNS_OPCODE_QUERY ?
+                        DNS_NOTIMPL_ERROR :
+                        DNS_FORM_ERROR;
+                    pHeader->QR = DNS_QR_RESPONSE;
+                    pHeader->RCode = (unsigned char)dnsError;
+                    pHeader->QDCount = 0;
+                    pHeader->ANCount = 0;
+                    pHeader->NSCount = 0;
+                    pHeader->ARCount = 0;
+                    uPortLog("U_DNS: Unhandled request: %d\n", dnsError);
+                    uSockSendTo(sock, &remoteAddr, pHeader, sizeof(uDnsHeader_t));
                 }
             }
-            if (!valid) {
-                // Send an error response
-                int32_t dnsError =
-                    pHeader->OPCode != DNS_OPCODE_QUERY ?
-                    DNS_NOTIMPL_ERROR :
-                    DNS_FORM_ERROR;
-                pHeader->QR = DNS_QR_RESPONSE;
-                pHeader->RCode = (unsigned char)dnsError;
-                pHeader->QDCount = 0;
-                pHeader->ANCount = 0;
-                pHeader->NSCount = 0;
-                pHeader->ARCount = 0;
-                uPortLog("U_DNS: Unhandled request: %d\n", dnsError);
-                uSockSendTo(sock, &remoteAddr, pHeader, sizeof(uDnsHeader_t));
-            }
-        }
-        uPortTaskBlock(100);
+        } while ((errOrCnt > 0) && (numRequests < U_DNS_SERVER_MAX_REQUESTS_PER_POLL));
+        uPortTaskBlock(U_DNS_SERVER_POLL_INTERVAL_MS);
         if (cb != NULL && !cb(deviceHandle)) {
             break;
         }
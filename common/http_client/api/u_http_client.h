@@ -100,6 +100,28 @@ typedef void (uHttpClientResponseCallback_t)(uDeviceHandle_t devHandle,
                                              size_t responseSize,
                                              void *pResponseCallbackParam);
 
+/** Callback that will be called with each block of HTTP response body
+ * data by uHttpClientGetRequestStream().
+ *
+ * @param devHandle        the device handle.
+ * @param[in] pData        a pointer to the block of body data; this is
+ *                         the pBuffer passed to uHttpClientGetRequestStream()
+ *                         and is only valid for the duration of the call.
+ * @param size             the number of bytes at pData, never more than
+ *                         the buffer size passed to
+ *                         uHttpClientGetRequestStream().
+ * @param[in,out] pParam   the pBodyCallbackParam pointer that was passed
+ *                         to uHttpClientGetRequestStream().
+ * @return                 true to carry on receiving body data, false
+ *                         to stop; if false is returned this callback
+ *                         will not be called again for this request
+ *                         though the request itself will still complete
+ *                         in the normal way.
+ */
+typedef bool (uHttpClientBodyCallback_t)(uDeviceHandle_t devHandle,
+                                         const char *pData, size_t size,
+                                         void *pParam);
+
 /** HTTP client connection information.  Note that the maximum length
  * of the string fields may differ between modules.
  * NOTE: if this structure is modified be sure to modify
@@ -206,6 +228,10 @@ typedef struct {
     char *pResponse;       /* set when a HTTP POST, GET or HEAD is being carried out. */
     size_t *pResponseSize; /* set when a HTTP POST, GET or HEAD is being carried out. */
     char *pContentType;    /* set when a HTTP POST or GET is being carried out. */
+    uHttpClientBodyCallback_t *pBodyCallback; /* set when a streamed HTTP GET is being carried out. */
+    void *pBodyCallbackParam;                 /* set when a streamed HTTP GET is being carried out. */
+    size_t bodyBufferSize;                    /* set when a streamed HTTP GET is being carried out. */
+    bool bodyStopped;                         /* set when pBodyCallback has returned false. */
 } uHttpClientContext_t;
 
 /* ----------------------------------------------------------------
@@ -426,6 +452,61 @@ int32_t uHttpClientGetRequest(uHttpClientContext_t *pContext,
                               char *pResponseBody, size_t *pSize,
                               char *pContentType);
 
+/** Make an HTTP GET request, streaming the response body to a callback
+ * in blocks rather than requiring storage for the whole of it; this
+ * allows a response of many hundreds of kilobytes to be processed using
+ * a buffer of, say, 2 kbytes.  Behaviour is otherwise as
+ * uHttpClientGetRequest(), i.e. blocking or non-blocking depending on
+ * pResponseCallback in the pConnection structure passed to
+ * pUHttpClientOpen().
+ *
+ * Only one HTTP request, of any kind, may be outstanding at a time.
+ *
+ * Note that, for a cellular module, the module stores the whole HTTP
+ * response in its file system before indicating that it has arrived,
+ * hence pBodyCallback will only begin to be called once the download
+ * has completed, the blocks then being read from the module's file
+ * system; for Wi-Fi the blocks are delivered as the response fragments
+ * arrive from the module.  pBodyCallback is called from the context
+ * of the HTTP response handling task so it should not block
+ * and should not call back into this API.
+ *
+ * @param[in] pContext            a pointer to the internal HTTP context
+ *                                structure that was originally returned by
+ *                                pUHttpClientOpen().
+ * @param[in] pPath               the null-terminated path on the HTTP server
+ *                                to GET the data from, for example
+ *                                "/thing/download/1.bin"; cannot be NULL.
+ * @param[in] pBuffer             the buffer into which each block of body
+ *                                data is read before pBodyCallback is called;
+ *                                cannot be NULL.  In the non-blocking case this
+ *                                storage MUST REMAIN VALID until
+ *                                pResponseCallback is called.
+ * @param[in,out] pSize           on entry the amount of storage at pBuffer,
+ *                                must be greater than zero; on return, in the
+ *                                blocking case, the total amount of body data
+ *                                passed to pBodyCallback (in the non-blocking
+ *                                case the response callback function is
+ *                                instead given this amount).
+ * @param[in] pBodyCallback       the callback to be called with each block of
+ *                                body data; cannot be NULL.
+ * @param[in] pBodyCallbackParam  a parameter that will be passed to
+ *                                pBodyCallback; may be NULL.
+ * @param[out] pContentType       a place to put the content type of the
+ *                                response, as for uHttpClientGetRequest();
+ *                                AT LEAST #U_HTTP_CLIENT_CONTENT_TYPE_LENGTH_BYTES
+ *                                of storage must be provided.
+ * @return                        in the blocking case the HTTP status code or
+ *                                negative error code; in the non-blocking case
+ *                                zero or negative error code.
+ */
+int32_t uHttpClientGetRequestStream(uHttpClientContext_t *pContext,
+                                    const char *pPath,
+                                    char *pBuffer, size_t *pSize,
+                                    uHttpClientBodyCallback_t *pBodyCallback,
+                                    void *pBodyCallbackParam,
+                                    char *pContentType);
+
 /** Make a request for an HTTP header.  If this is a blocking call (i.e.
  * pResponseCallback in the pConnection structure passed to pUHttpClientOpen()
  * was NULL) and a pKeepGoingCallback() was provided in pConnection then
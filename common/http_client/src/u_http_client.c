@@ -281,6 +281,41 @@ static int32_t cellFileResponseReadHead(uDeviceHandle_t cellHandle,
     return errorCodeOrSize;
 }
 
+// Read the body of an HTTP response from file in the cellular
+// case, passing it to the body callback block by block; returns
+// the amount of data passed to the body callback.
+static int32_t cellFileResponseReadBodyStream(uDeviceHandle_t cellHandle,
+                                              const char *pFileNameResponse,
+                                              size_t offset,
+                                              uHttpClientContext_t *pContext)
+{
+    int32_t thisSize;
+    int32_t totalSize = 0;
+
+    do {
+        thisSize = U_HTTP_CLIENT_CELL_FILE_CHUNK_LENGTH;
+        if (thisSize > (int32_t) pContext->bodyBufferSize) {
+            thisSize = (int32_t) pContext->bodyBufferSize;
+        }
+        // Each block goes to the start of the user's buffer
+        thisSize = uCellFileBlockRead(cellHandle, pFileNameResponse,
+                                      pContext->pResponse,
+                                      offset + totalSize, thisSize);
+        if (thisSize > 0) {
+            totalSize += thisSize;
+            if (!pContext->pBodyCallback(cellHandle, pContext->pResponse,
+                                         (size_t) thisSize,
+                                         pContext->pBodyCallbackParam)) {
+                // The user has had enough
+                pContext->bodyStopped = true;
+                thisSize = 0;
+            }
+        }
+    } while (thisSize > 0);
+
+    return totalSize;
+}
+
 // Callback for HTTP responses in the cellular case.
 static void cellCallback(uDeviceHandle_t cellHandle, int32_t httpHandle,
                          uCellHttpRequest_t requestType, bool error,
@@ -338,22 +373,30 @@ static void cellCallback(uDeviceHandle_t cellHandle, int32_t httpHandle,
                                 // however it puts some stress on the AT interface
                                 // and so here we chunk it.
                                 offset += (size_t) responseSize + 4; // +4 for "\r\n\r\n"
-                                do {
-                                    thisSize = U_HTTP_CLIENT_CELL_FILE_CHUNK_LENGTH;
-                                    if (thisSize > ((int32_t) *pContext->pResponseSize) - totalSize) {
-                                        thisSize = ((int32_t) * pContext->pResponseSize) - totalSize;
-                                    }
-                                    if (thisSize > 0) {
-                                        thisSize = uCellFileBlockRead(cellHandle,
-                                                                      pFileNameResponse,
-                                                                      pContext->pResponse + totalSize,
-                                                                      offset + totalSize,
-                                                                      thisSize);
+                                if ((requestType == U_CELL_HTTP_REQUEST_GET) &&
+                                    (pContext->pBodyCallback != NULL)) {
+                                    totalSize = cellFileResponseReadBodyStream(cellHandle,
+                                                                               pFileNameResponse,
+                                                                               offset,
+                                                                               pContext);
+                                } else {
+                                    do {
+                                        thisSize = U_HTTP_CLIENT_CELL_FILE_CHUNK_LENGTH;
+                                        if (thisSize > ((int32_t) *pContext->pResponseSize) - totalSize) {
+                                            thisSize = ((int32_t) * pContext->pResponseSize) - totalSize;
+                                        }
                                         if (thisSize > 0) {
-                                            totalSize += thisSize;
+                                            thisSize = uCellFileBlockRead(cellHandle,
+                                                                          pFileNameResponse,
+                                                                          pContext->pResponse + totalSize,
+                                                                          offset + totalSize,
+                                                                          thisSize);
+                                            if (thisSize > 0) {
+                                                totalSize += thisSize;
+                                            }
                                         }
-                                    }
-                                } while (thisSize > 0);
+                                    } while (thisSize > 0);
+                                }
                                 responseSize = totalSize;
                             }
                             break;
@@ -603,6 +646,9 @@ static void clearLastRequest(uHttpClientContext_t *pContext)
     pContext->pResponse = NULL;
     pContext->pResponseSize = NULL;
     pContext->pContentType = NULL;
+    pContext->pBodyCallback = NULL;
+    pContext->pBodyCallbackParam = NULL;
+    pContext->bodyBufferSize = 0;
     pContext->lastRequestTimeMs = -1;
     pContext->statusCodeOrError = 0;
     uPortSemaphoreGive((uPortSemaphoreHandle_t) pContext->semaphoreHandle);
@@ -648,6 +694,10 @@ static void entryFunctionRequest(uHttpClientContext_t *pContext, int32_t *pError
                 // and carry on with this one
                 clearLastRequest(pContext);
             }
+            // Streaming of the body is only ever set up
+            // explicitly, request by request
+            pContext->pBodyCallback = NULL;
+            pContext->bodyStopped = false;
         }
     }
 
@@ -965,6 +1015,60 @@ int32_t uHttpClientGetRequest(uHttpClientContext_t *pContext,
     return errorCode;
 }
 
+// Make an HTTP GET request, streaming the body to a callback.
+int32_t uHttpClientGetRequestStream(uHttpClientContext_t *pContext,
+                                    const char *pPath,
+                                    char *pBuffer, size_t *pSize,
+                                    uHttpClientBodyCallback_t *pBodyCallback,
+                                    void *pBodyCallbackParam,
+                                    char *pContentType)
+{
+    int32_t errorCode;
+
+    U_HTTP_CLIENT_REQUEST_ENTRY_FUNCTION(pContext, &errorCode, false);
+
+    if (errorCode == 0) {
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pPath != NULL) && (pBuffer != NULL) && (pSize != NULL) &&
+            (*pSize > 0) && (pBodyCallback != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            pContext->pResponse = pBuffer;
+            pContext->pResponseSize = pSize;
+            pContext->pContentType = pContentType;
+            pContext->pBodyCallback = pBodyCallback;
+            pContext->pBodyCallbackParam = pBodyCallbackParam;
+            pContext->bodyBufferSize = *pSize;
+            if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
+                errorCode = uCellHttpRequest(pContext->devHandle,
+                                             ((uHttpClientContextCell_t *) pContext->pPriv)->httpHandle,
+                                             U_CELL_HTTP_REQUEST_GET, pPath,
+                                             NULL, NULL, NULL);
+            } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
+                errorCode = uWifiHttpRequestEx(pContext->devHandle,
+                                               ((uHttpClientContextWifi_t *) pContext->pPriv)->httpHandle,
+                                               U_WIFI_HTTP_REQUEST_GET_BINARY,
+                                               pPath, NULL, 0, NULL);
+            }
+            if (errorCode == 0) {
+                // Handle blocking
+                errorCode = block((volatile uHttpClientContext_t *) pContext);
+            } else {
+                // Make sure to forget the user's pointers on error
+                pContext->pResponse = NULL;
+                pContext->pResponseSize = NULL;
+                pContext->pContentType = NULL;
+                pContext->pBodyCallback = NULL;
+                pContext->pBodyCallbackParam = NULL;
+                pContext->bodyBufferSize = 0;
+            }
+        }
+    }
+
+    U_HTTP_CLIENT_REQUEST_EXIT_FUNCTION(pContext, errorCode);
+
+    return errorCode;
+}
+
 // Make an HTTP HEAD request.
 int32_t uHttpClientHeadRequest(uHttpClientContext_t *pContext,
                                const char *pPath,
@@ -149,6 +149,14 @@
                                               U_HTTP_CLIENT_TEST_RESPONSE_TIMEOUT_EXTRA_SECONDS)
 #endif
 
+#ifndef HTTP_CLIENT_TEST_STREAM_BLOCK_SIZE_BYTES
+/** The size of the block buffer used when testing
+ * uHttpClientGetRequestStream(); deliberately small so that
+ * the body arrives in many blocks.
+ */
+# define HTTP_CLIENT_TEST_STREAM_BLOCK_SIZE_BYTES 256
+#endif
+
 #ifndef HTTP_CLIENT_TEST_MAX_TRIES_FLOW_CONTROL
 /** How many times to try a PUT/POST operation if the response
  * appears to be truncated and this may be because RTS flow
@@ -224,6 +232,18 @@ static size_t gSizeDataBufferIn = 0;
  */
 static char *gpContentTypeBuffer = NULL;
 
+/** The block buffer for uHttpClientGetRequestStream().
+ */
+static char gStreamBlockBuffer[HTTP_CLIENT_TEST_STREAM_BLOCK_SIZE_BYTES];
+
+/** How much of gpDataBufferIn has been filled by the body callback.
+ */
+static size_t gStreamOffset = 0;
+
+/** The amount of storage at gpDataBufferIn for the body callback.
+ */
+static size_t gStreamLimit = 0;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -327,6 +347,26 @@ static void httpCallback(uDeviceHandle_t devHandle,
     }
 }
 
+// Body callback for uHttpClientGetRequestStream(): re-assemble
+// the blocks in gpDataBufferIn so that they can be checked.
+static bool bodyCallback(uDeviceHandle_t devHandle, const char *pData,
+                         size_t size, void *pParam)
+{
+    bool keepGoing = false;
+
+    (void) devHandle;
+    (void) pParam;
+
+    if ((size <= sizeof(gStreamBlockBuffer)) &&
+        (gStreamOffset + size <= gStreamLimit)) {
+        memcpy(gpDataBufferIn + gStreamOffset, pData, size);
+        gStreamOffset += size;
+        keepGoing = true;
+    }
+
+    return keepGoing;
+}
+
 // Fill a buffer with binary 0 to 255.
 static void bufferFill(char *pBuffer, size_t size)
 {
@@ -809,14 +849,20 @@ U_PORT_TEST_FUNCTION("[httpClient]", "httpClient")
                                         (deviceType == U_DEVICE_TYPE_SHORT_RANGE)) {
                                         checkBinary = false;
                                     }
+                                    // This time stream the body in small blocks
+                                    // and re-assemble it in gpDataBufferIn
                                     memset(gpDataBufferIn, 0xFF, uHttpClientTestDataSizeBytes);
                                     memset(gpContentTypeBuffer, 0xFF, U_HTTP_CLIENT_CONTENT_TYPE_LENGTH_BYTES);
-                                    gSizeDataBufferIn = uHttpClientTestDataSizeBytes;
-                                    U_TEST_PRINT_LINE("GET of %s...", pathBuffer);
-                                    errorOrStatusCode = uHttpClientGetRequest(gpHttpContext[y],
-                                                                              pathBuffer, gpDataBufferIn,
-                                                                              &gSizeDataBufferIn,
-                                                                              gpContentTypeBuffer);
+                                    gStreamOffset = 0;
+                                    gStreamLimit = uHttpClientTestDataSizeBytes;
+                                    gSizeDataBufferIn = sizeof(gStreamBlockBuffer);
+                                    U_TEST_PRINT_LINE("streamed GET of %s...", pathBuffer);
+                                    errorOrStatusCode = uHttpClientGetRequestStream(gpHttpContext[y],
+                                                                                    pathBuffer,
+                                                                                    gStreamBlockBuffer,
+                                                                                    &gSizeDataBufferIn,
+                                                                                    bodyCallback, NULL,
+                                                                                    gpContentTypeBuffer);
                                     break;
                                 case U_HTTP_CLIENT_TEST_OPERATION_DELETE_POST:
                                     // Finally DELETE the file again
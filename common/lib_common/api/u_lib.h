@@ -42,6 +42,9 @@ extern "C" {
 #define U_LIB_HDR_FLAG_VALIDATION           (1<<1)
 /** Indicates that the library uses malloc and free */
 #define U_LIB_HDR_FLAG_NEEDS_MALLOC         (1<<2)
+/** Indicates that the function table is laid out as a hash table,
+ * see U_LIB_I_FDESC_HASH_BITPOS; set by genlibhdr.py */
+#define U_LIB_HDR_FLAG_SYM_HASH             (1<<3)
 
 /** On what bit position in flags the arch resides */
 #define U_LIB_HDR_FLAG_ARCH_BITPOS          (4)
@@ -168,7 +171,9 @@ int uLibProbe(uLibHdl_t *pHdl, uLibHdr_t *pHdr, const void *puLib);
  * @param puLib Address of library blob
  * @param pLibc Struct with pointers to utility functions. See uLibLibc_t for adding more functions.
  * @param flags Passed to library internal open function, ignored by handler
- * @param pRelocate Relocate the library code to this address. Use NULL if no relocation is needed.
+ * @param pRelocate Relocate the library code to this address. Use NULL if no relocation is needed,
+ * in which case the library code is executed in place, e.g. directly from flash,
+ * and costs no RAM other than what the library itself allocates.
  * @return U_ERROR_COMMON_SUCCESS if OK, else error code
  */
 int uLibOpen(uLibHdl_t *pHdl, const void *puLib,
@@ -209,6 +214,31 @@ int uLibClose(uLibHdl_t *pHdl);
  */
 void *uLibSym(uLibHdl_t *pHdl, const char *sym);
 
+/**
+ * Returns call addresses for several symbols in one call, e.g. to
+ * populate a struct of function pointers:
+ *
+ * @code
+ * <code>
+ * struct {
+ *   int (*libFibCalc)(void *ctx, int series);
+ *   int (*libFibLastRes)(void *ctx);
+ * } fib;
+ * const char *syms[] = {"libFibCalc", "libFibLastRes"};
+ * res = uLibSyms(&libHdl, syms, (void **) &fib, 2);
+ * </code>
+ * @endcode
+ *
+ * @param pHdl Pointer to library handle struct.
+ * @param pSyms Array of function symbol names to find.
+ * @param ppFuncs Array to populate with the function addresses, in the
+ * same order as pSyms; an entry is NULL if the symbol was not found.
+ * @param count Number of entries in pSyms and ppFuncs.
+ * @return U_ERROR_COMMON_SUCCESS if all symbols were found, else error code
+ */
+int uLibSyms(uLibHdl_t *pHdl, const char *const *pSyms, void **ppFuncs,
+             uint32_t count);
+
 /**
  * Returns and clears last error for given library.
  * @param pHdl Pointer to library handle struct.
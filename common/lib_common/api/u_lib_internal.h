@@ -41,6 +41,15 @@ extern "C" {
 #define U_LIB_I_FDESC_FLAG_INIT            (1<<1)
 /** Library finaliser function */
 #define U_LIB_I_FDESC_FLAG_FINI            (1<<2)
+/** On what bit position in the function table entry flags the hash
+ * of the name resides; if U_LIB_HDR_FLAG_SYM_HASH is set in the
+ * library header the entry for a name is searched for starting at
+ * index (hash % count), moving forward, wrapping, until found.  The
+ * hash is the 32-bit FNV-1a hash of the name with its upper and lower
+ * 16 bits XORed together, see genlibhdr.py. */
+#define U_LIB_I_FDESC_HASH_BITPOS          (16)
+/** Mask for the hash in the function table entry flags */
+#define U_LIB_I_FDESC_HASH_MASK            (0xffff)
 
 /** ubxlib initialiser function name, recognised by python script genlibhdr.py */
 #define U_LIB_I_OPEN_FUNC                  ___libOpen
@@ -9,17 +9,47 @@ Input is read from a file. This file should be generated something like this:
 
 $ objdump -tj .text mylibrary.elf > mylibrary.sym
 
+The section headers may be appended to the same file:
+
+$ objdump -h mylibrary.elf >> mylibrary.sym
+
+...in which case a warning is emitted if the library has writable data
+or a global offset table: only .text and .rodata are put into the library
+blob, which is executed where it lies (e.g. in place, in flash) or
+wherever it is relocated to, and no fix-ups are applied.
+
 """
 
 import sys
 import os
 import re
 
+def symHash(symName):
+  """ Hash of a symbol name, must match symHash() in u_lib_handler.c """
+  hash = 2166136261
+  for b in symName.encode():
+    hash = ((hash ^ b) * 16777619) & 0xffffffff
+  return ((hash >> 16) ^ hash) & 0xffff
+
+def hashOrder(syms):
+  """
+  Order the symbols as an open-addressed hash table of the same size
+  as the number of symbols, so that uLibSym() finds a symbol at, or
+  shortly after, index (hash % count).
+  """
+  table = [None] * len(syms)
+  for symName in syms:
+    ix = symHash(symName) % len(syms)
+    while table[ix] != None:
+      ix = (ix + 1) % len(syms)
+    table[ix] = symName
+  return table
+
 def emit(name, version, flags, length, syms):
   """ Emit source code for symbols """
   print("/* autogenerated C file */")
   emitBegin(name, version, flags, length, syms)
-  for symName in syms:
+  for symName in hashOrder(syms):
     emitEntry(symName, syms[symName])
   emitEnd(name, version, flags, length, syms)
 
@@ -31,7 +61,7 @@ def emitBegin(name, version, flags, length, syms):
   print("    .magic = 0xc01df00d,")
   print('    .name = "{}",'.format(name))
   print("    .version = {},".format(version))
-  print("    .flags = {} | (U_LIB_ARCH << U_LIB_HDR_FLAG_ARCH_BITPOS),".format(flags))
+  print("    .flags = {} | U_LIB_HDR_FLAG_SYM_HASH | (U_LIB_ARCH << U_LIB_HDR_FLAG_ARCH_BITPOS),".format(flags))
   print("    .count = {},".format(len(syms)))
   print("    .length = {},".format(length))
   print("};")
@@ -46,7 +76,8 @@ def emitEntry(symName, symProps):
     flags = flags | (1<<1) # library initialiser
   if symName == "___libClose":
     flags = flags | (1<<2) # library finaliser
-  print('    {} .name = "{}", .offset = {}, .flags = {} {},'.format("{", symName, symProps["offset"], flags, "}"))
+  flags = flags | (symHash(symName) << 16) # hash, U_LIB_I_FDESC_HASH_BITPOS
+  print('    {} .name = "{}", .offset = {}, .flags = 0x{:08x} {},'.format("{", symName, symProps["offset"], flags, "}"))
 
 def emitEnd(name, version, flags, length, syms):
   """ Emit source code for symbols: end """
@@ -87,6 +118,10 @@ def main():
     textOffset = 0
     pentry = re.compile(r'([0-9A-Fa-f]{8,16})\s([g|l]).....(.)\s\.text\s*([0-9A-Fa-f]{8,16})\s(.*)')
     pextra = re.compile(r'(\w+)\s*=\s*(\w+)')
+    # section headers, as given by objdump -h, ex:
+    #   Idx Name          Size      VMA       LMA       File off  Algn
+    #     2 .got          0000000c  000001c8  000001c8  000001c8  2**2
+    psection = re.compile(r'\s*\d+\s+(\.\S+)\s+([0-9A-Fa-f]{8,16})\s')
 
     for line in fp:
       # is this an objdump entry?
@@ -99,6 +134,13 @@ def main():
           # found a symbol, put it in dict at given address - .text offset
           syms[m.group(5)] = {"offset":int(m.group(1),16)-textOffset,"type":m.group(3),"len":int(m.group(4),16)}
         continue
+      # or a section header?
+      m = psection.match(line)
+      if m != None:
+        if int(m.group(2),16) > 0 and re.match(r'\.(data|bss|got)', m.group(1)):
+          print("WARNING: section {} is not supported in a library, keep state".format(m.group(1)) +
+                " in the context allocated by the open function instead.", file=sys.stderr)
+        continue
       # or is this mayhap some extra info?
       m = pextra.match(line)
       if m != None:
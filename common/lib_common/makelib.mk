@@ -128,6 +128,7 @@ $(library_descr_c): $(library_code_sym)
 $(library_code_sym): $(library_code_elf) $(library_code_bin)
 	@echo "* Dumping library symbols"
 	$(v)$(OBJDUMP) -tj .text $< > $@
+	$(v)$(OBJDUMP) -h $< >> $@
 	$(v)echo name = $(NAME) >> $@
 	$(v)echo version = $(LIB_VERSION) >> $@
 	$(v)echo flags = $(LIB_FLAGS) >> $@
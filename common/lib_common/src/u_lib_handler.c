@@ -26,11 +26,53 @@
 #include "u_lib_internal.h"
 #include "u_error_common.h"
 #include "string.h"
+#include "stdbool.h"
 
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Hash of a symbol name, must match that of genlibhdr.py.
+static uint32_t symHash(const char *sym)
+{
+    uint32_t hash = 2166136261U;
+    while (*sym != 0) {
+        hash ^= (uint8_t) *sym;
+        hash *= 16777619U;
+        sym++;
+    }
+    return ((hash >> 16) ^ hash) & U_LIB_I_FDESC_HASH_MASK;
+}
+
+// Return the index of the function descriptor for the given symbol,
+// or -1 if it is not found.
+static int findSym(const uLibDescriptor_t *pDescr, const char *sym)
+{
+    uint32_t count = pDescr->hdr.count;
+    bool hashed = (pDescr->hdr.flags & U_LIB_HDR_FLAG_SYM_HASH) != 0;
+    uint32_t hash = 0;
+    uint32_t start = 0;
+    uint32_t ix;
+    uint32_t flags;
+
+    if (hashed && (count > 0)) {
+        // The entry will be at, or shortly after, its hash slot
+        hash = symHash(sym);
+        start = hash % count;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        ix = (start + i) % count;
+        flags = pDescr->funcs[ix].flags;
+        if (((flags & (U_LIB_I_FDESC_FLAG_INIT | U_LIB_I_FDESC_FLAG_FINI |
+                       U_LIB_I_FDESC_FLAG_FUNCTION)) == U_LIB_I_FDESC_FLAG_FUNCTION) &&
+            (!hashed || (((flags >> U_LIB_I_FDESC_HASH_BITPOS) & U_LIB_I_FDESC_HASH_MASK) == hash)) &&
+            strcmp(sym, pDescr->funcs[ix].name) == 0) {
+            return (int) ix;
+        }
+    }
+    return -1;
+}
+
 static uint8_t *getCallAddress(uLibHdl_t *pHdl, uint32_t funcIx)
 {
     uLibDescriptor_t *pDescr = (uLibDescriptor_t *)pHdl->puLibDescr;
@@ -163,19 +205,43 @@ void *uLibSym(uLibHdl_t *pHdl, const char *sym)
         return 0;
     }
 
-    uLibDescriptor_t *pDescr = (uLibDescriptor_t *)pHdl->puLibDescr;
-    for (uint32_t i = 0; i < pDescr->hdr.count; i++) {
-        if (((pDescr->funcs[i].flags & (U_LIB_I_FDESC_FLAG_INIT | U_LIB_I_FDESC_FLAG_FINI |
-                                        U_LIB_I_FDESC_FLAG_FUNCTION))
-             == U_LIB_I_FDESC_FLAG_FUNCTION) &&
-            strcmp(sym, pDescr->funcs[i].name) == 0) {
-            return (void *)getCallAddress(pHdl, i);
-        }
+    int ix = findSym((uLibDescriptor_t *)pHdl->puLibDescr, sym);
+    if (ix >= 0) {
+        return (void *)getCallAddress(pHdl, (uint32_t) ix);
     }
     pHdl->error = U_ERROR_COMMON_NOT_FOUND;
     return 0;
 }
 
+int uLibSyms(uLibHdl_t *pHdl, const char *const *pSyms, void **ppFuncs,
+             uint32_t count)
+{
+    int res = U_ERROR_COMMON_SUCCESS;
+    if (pHdl == 0) {
+        return U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+    if (pHdl->puLibDescr == 0) {
+        return U_ERROR_COMMON_NOT_INITIALISED;
+    }
+    if ((pSyms == 0 || ppFuncs == 0) && count > 0) {
+        return U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        ppFuncs[i] = 0;
+        int ix = -1;
+        if (pSyms[i] != 0) {
+            ix = findSym((uLibDescriptor_t *)pHdl->puLibDescr, pSyms[i]);
+        }
+        if (ix >= 0) {
+            ppFuncs[i] = (void *)getCallAddress(pHdl, (uint32_t) ix);
+        } else {
+            res = U_ERROR_COMMON_NOT_FOUND;
+        }
+    }
+    return res;
+}
+
 int uLibError(uLibHdl_t *pHdl)
 {
     if (pHdl == 0) {
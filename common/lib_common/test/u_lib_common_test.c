@@ -160,6 +160,24 @@ static int32_t runLibTest(void)
     uPortLogF("@libFibTestLastRes:   %p\n", libFibTestLastRes);
     uPortLogF("@libFibTestHelloWorld:%p\n\n", libFibTestHelloWorld);
 
+    // the function table should have been generated as a hash table
+    U_PORT_TEST_ASSERT((libHdr.flags & U_LIB_HDR_FLAG_SYM_HASH) == U_LIB_HDR_FLAG_SYM_HASH);
+    U_PORT_TEST_ASSERT(uLibSym(&libHdl, "libFibTestNotThere") == NULL);
+    U_PORT_TEST_ASSERT(uLibError(&libHdl) == U_ERROR_COMMON_NOT_FOUND);
+
+    // look up the same addresses again, all in one go
+    struct {
+        int (*libFibTestCalc)(void *ctx, int series);
+        int (*libFibTestLastRes)(void *ctx);
+        const char *(*libFibTestHelloWorld)(void *ctx);
+    } libFibTest;
+    const char *libFibTestSyms[] = {"libFibTestCalc", "libFibTestLastRes", "libFibTestHelloWorld"};
+    res = uLibSyms(&libHdl, libFibTestSyms, (void **) &libFibTest, 3);
+    U_PORT_TEST_ASSERT(res == U_ERROR_COMMON_SUCCESS);
+    U_PORT_TEST_ASSERT(libFibTest.libFibTestCalc == libFibTestCalc);
+    U_PORT_TEST_ASSERT(libFibTest.libFibTestLastRes == libFibTestLastRes);
+    U_PORT_TEST_ASSERT(libFibTest.libFibTestHelloWorld == libFibTestHelloWorld);
+
     // start calling the library
     int libFibTestResult = libFibTestCalc(libHdl.ictx, 102);
     U_PORT_TEST_ASSERT(libFibTestResult == FIB_102);
@@ -51,6 +51,13 @@ extern "C" {
 # define U_LOCATION_TIMEOUT_SECONDS 240
 #endif
 
+#ifndef U_LOCATION_FUSION_MAX_SOURCES
+/** The maximum number of sources that uLocationGetFused() can run
+ * at the same time, e.g. GNSS, Wi-Fi and Cell Locate.
+ */
+# define U_LOCATION_FUSION_MAX_SOURCES 3
+#endif
+
 #ifndef U_LOCATION_CLOUD_LOCATE_SVS_THRESHOLD
 /** The number of satellites to request as being visible and
  * meet the criter for RRLP information to be valid for
@@ -117,7 +124,8 @@ extern "C" {
                                      NULL, NULL,                                                \
                                      U_LOCATION_CLOUD_LOCATE_RRLP_DATA_LENGTH_BYTES,            \
                                      U_LOCATION_ACCESS_POINTS_FILTER_DEFAULT,                   \
-                                     U_LOCATION_RSSI_DBM_FILTER_DEFAULT}
+                                     U_LOCATION_RSSI_DBM_FILTER_DEFAULT,                        \
+                                     -1}
 #endif
 
 /* ----------------------------------------------------------------
@@ -246,6 +254,19 @@ typedef struct {
     int32_t rssiDbmFilter;      /**< ignore Wi-Fi access points with received
                                      signal strength less than this,
                                      range -100 dBm to 0 dBm. */
+
+    /* The following field is ONLY used by U_LOCATION_TYPE_CLOUD_CELL_LOCATE. */
+
+    int32_t cellLocateCacheMaxAgeSeconds; /**< if greater than zero, a fix
+                                               obtained on the current serving
+                                               cell no more than this many
+                                               seconds ago will be returned
+                                               without a new request being
+                                               made to the Cell Locate service,
+                                               see uCellLocSetCacheMaxAge();
+                                               zero switches this off, use -1
+                                               (the default) to leave the
+                                               setting as it is. */
 } uLocationAssist_t;
 
 /** Definition of a location.
@@ -274,6 +295,51 @@ typedef struct {
                           if this is not available -1 will be returned. */
 } uLocation_t;
 
+/** A compact form of #uLocation_t, 28 bytes rather than 40, for
+ * keeping many locations in RAM; convert with uLocationPack() and
+ * uLocationUnpack().  The contents are as for #uLocation_t except
+ * that the time is held in 32 bits, so only the years 1970 to 2105
+ * can be represented, and svs in 8 bits.
+ */
+typedef struct {
+    int32_t latitudeX1e7;  /**< as #uLocation_t. */
+    int32_t longitudeX1e7; /**< as #uLocation_t. */
+    int32_t altitudeMillimetres; /**< as #uLocation_t. */
+    int32_t radiusMillimetres; /**< as #uLocation_t. */
+    int32_t speedMillimetresPerSecond; /**< as #uLocation_t. */
+    uint32_t timeUtc; /**< as #uLocation_t, UINT32_MAX if not available. */
+    uint8_t type; /**< the #uLocationType_t. */
+    uint8_t svs;  /**< as #uLocation_t, UINT8_MAX if not known. */
+} uLocationPacked_t;
+
+/** A circular geofence, for uLocationPackedInCircle().
+ */
+typedef struct {
+    int32_t latitudeX1e7;  /**< the latitude of the centre in ten
+                                millionths of a degree. */
+    int32_t longitudeX1e7; /**< the longitude of the centre in ten
+                                millionths of a degree. */
+    int32_t radiusMillimetres; /**< the radius in millimetres. */
+} uLocationCircle_t;
+
+/** A source of location for uLocationGetFused(): the parameters
+ * are those that would be passed to uLocationGetStart().
+ */
+typedef struct {
+    uDeviceHandle_t devHandle; /**< the device handle to use; each
+                                    source must have a different device
+                                    handle. */
+    uLocationType_t type;      /**< the type of location fix to perform,
+                                    anything supported by uLocationGetStart(). */
+    const uLocationAssist_t *pLocationAssist; /**< additional information
+                                                   for the location
+                                                   establishment process,
+                                                   may be NULL. */
+    const char *pAuthenticationTokenStr; /**< the null-terminated
+                                              authentication token required
+                                              by some cloud services. */
+} uLocationFusionSource_t;
+
 /** The possible states a location establishment
  * attempt can be in.
  */
@@ -554,6 +620,52 @@ int32_t uLocationGetContinuousStart(uDeviceHandle_t devHandle,
                                                        int32_t errorCode,
                                                        const uLocation_t *pLocation));
 
+/** Get the current location from whichever of several sources is
+ * quickest to provide a fix of the required accuracy.  For instance,
+ * GNSS, Wi-Fi and Cell Locate may be started at the same time so that,
+ * indoors, a Wi-Fi or Cell Locate fix is returned while, outdoors, a
+ * GNSS fix may arrive first.  All of the sources are started with
+ * uLocationGetStart() and, as soon as one of them provides a fix with
+ * a radius no larger than maxRadiusMillimetres, the others are
+ * cancelled with uLocationGetStop() and that fix is returned.  If no
+ * fix meets the accuracy required within maxLatencyMs, or all of the
+ * sources have finished, the most accurate fix obtained, if any, is
+ * returned instead: check radiusMillimetres in pLocation to tell.
+ * uNetworkInterfaceUp() must have been called on each device handle.
+ *
+ * Since uLocationGetStart() is used, the restrictions of that function
+ * apply, e.g. #U_LOCATION_TYPE_CLOUD_CLOUD_LOCATE is not supported.
+ * Only one call to this function may be in progress at any one time
+ * and no other asynchronous location request should be in progress on
+ * any of the device handles.  This function is blocking.
+ *
+ * @param[in] pSources            an array of the sources to use, cannot
+ *                                be NULL.
+ * @param numSources              the number of entries at pSources, at
+ *                                most #U_LOCATION_FUSION_MAX_SOURCES.
+ * @param maxRadiusMillimetres    the accuracy required: a fix with a radius
+ *                                no larger than this ends the attempt;
+ *                                use -1 to accept the first fix of any
+ *                                accuracy.
+ * @param maxLatencyMs            the longest time to wait for a fix of
+ *                                the required accuracy; use -1 for
+ *                                #U_LOCATION_TIMEOUT_SECONDS.
+ * @param[out] pLocation          a place to put the location; may be NULL.
+ * @param[in] pKeepGoingCallback  a callback function that may be used to
+ *                                terminate the attempt early, in which
+ *                                case the most accurate fix so far, if any,
+ *                                is returned; it is passed the device
+ *                                handle of the first source.  May be NULL.
+ * @return                        zero on success or negative error code
+ *                                on failure.
+ */
+int32_t uLocationGetFused(const uLocationFusionSource_t *pSources,
+                          size_t numSources,
+                          int32_t maxRadiusMillimetres,
+                          int32_t maxLatencyMs,
+                          uLocation_t *pLocation,
+                          bool (*pKeepGoingCallback) (uDeviceHandle_t));
+
 /** Get the current status of a location establishment attempt.
  *
  * @param devHandle      the device handle to use.
@@ -573,6 +685,45 @@ int32_t uLocationGetStatus(uDeviceHandle_t devHandle);
  */
 void uLocationGetStop(uDeviceHandle_t devHandle);
 
+/** Convert a location into the compact form.  The conversion is
+ * lossless: should any field not be representable in the compact
+ * form an error is returned.
+ *
+ * @param[in] pLocation  the location to convert, cannot be NULL.
+ * @param[out] pPacked   a place to put the compact form, cannot
+ *                       be NULL; not written-to on error.
+ * @return               zero on success else negative error code.
+ */
+int32_t uLocationPack(const uLocation_t *pLocation, uLocationPacked_t *pPacked);
+
+/** Convert a location from the compact form.
+ *
+ * @param[in] pPacked     the compact form, cannot be NULL.
+ * @param[out] pLocation  a place to put the location, cannot be NULL.
+ */
+void uLocationUnpack(const uLocationPacked_t *pPacked, uLocation_t *pLocation);
+
+/** Check which of an array of locations in compact form lie within
+ * a circle.  Distances are worked out in integer arithmetic on a
+ * flat projection about the centre of the circle, taking the earth
+ * as a sphere; this is good to around 1% for circles of up to a
+ * few hundred kilometres that do not include a pole.
+ *
+ * @param[in] pLocations  an array of numLocations locations; may be
+ *                        NULL only if numLocations is zero.
+ * @param numLocations    the number of entries at pLocations.
+ * @param[in] pCircle     the circle, cannot be NULL.
+ * @param[out] pInside    an array of numLocations entries, set to
+ *                        true for each location that lies within
+ *                        the circle, else false; may be NULL.
+ * @return                the number of locations that lie within
+ *                        the circle, else negative error code.
+ */
+int32_t uLocationPackedInCircle(const uLocationPacked_t *pLocations,
+                                size_t numLocations,
+                                const uLocationCircle_t *pCircle,
+                                bool *pInside);
+
 #ifdef __cplusplus
 }
 #endif
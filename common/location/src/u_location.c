@@ -32,6 +32,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memset()
 
 #include "u_cfg_os_platform_specific.h"  // For U_CFG_OS_YIELD_MS
 
@@ -39,6 +40,7 @@
 
 #include "u_device_shared.h"
 
+#include "u_port.h"
 #include "u_port_os.h"
 #include "u_port_heap.h"
 
@@ -67,14 +69,66 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_LOCATION_FUSION_POLL_INTERVAL_MS
+/** How often uLocationGetFused() checks for the results
+ * of its sources.
+ */
+# define U_LOCATION_FUSION_POLL_INTERVAL_MS 100
+#endif
+
+/** The length of a ten millionth of a degree of arc on the surface
+ * of the earth, taken as a sphere of radius 6371 km, in units of
+ * 1/10000th of a millimetre, used by uLocationPackedInCircle().
+ */
+#define U_LOCATION_MM_X1E4_PER_DEGREE_X1E7 111195
+
+/** Ten million.
+ */
+#define U_LOCATION_X1E7 10000000
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The result from one source of a uLocationGetFused().
+ */
+typedef struct {
+    uDeviceHandle_t devHandle;
+    int32_t errorCode;
+    uLocation_t location;
+    volatile bool done;
+} uLocationFusionResult_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/** The results of the sources of a uLocationGetFused(); static
+ * rather than on the stack or heap so that a callback which
+ * arrives late can do no harm.
+ */
+static uLocationFusionResult_t gFusionResult[U_LOCATION_FUSION_MAX_SOURCES];
+
+/** Set while a uLocationGetFused() is in progress.
+ */
+static volatile bool gFusionActive = false;
+
+/** The cosine of each whole degree from 0 to 90, times 65536
+ * (saturated at 65535), used by uLocationPackedInCircle().
+ */
+static const uint16_t gCosDegreeQ16[] = {
+    65535, 65526, 65496, 65446, 65376, 65287, 65177, 65048, 64898, 64729,
+    64540, 64332, 64104, 63856, 63589, 63303, 62997, 62672, 62328, 61966,
+    61584, 61183, 60764, 60326, 59870, 59396, 58903, 58393, 57865, 57319,
+    56756, 56175, 55578, 54963, 54332, 53684, 53020, 52339, 51643, 50931,
+    50203, 49461, 48703, 47930, 47143, 46341, 45525, 44695, 43852, 42995,
+    42126, 41243, 40348, 39441, 38521, 37590, 36647, 35693, 34729, 33754,
+    32768, 31772, 30767, 29753, 28729, 27697, 26656, 25607, 24550, 23486,
+    22415, 21336, 20252, 19161, 18064, 16962, 15855, 14742, 13626, 12505,
+    11380, 10252, 9121, 7987, 6850, 5712, 4572, 3430, 2287, 1144,
+    0
+};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTION PROTOTYPES
  * -------------------------------------------------------------- */
@@ -91,6 +145,62 @@ static int32_t startAsync(uDeviceHandle_t devHandle, int32_t desiredRateMs,
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Return the cosine of a latitude times 65536, by linear
+// interpolation between whole degrees.
+static int64_t cosLatitudeQ16(int32_t latitudeX1e7)
+{
+    int64_t latitude = latitudeX1e7;
+    int64_t cosQ16 = 0;
+    int32_t degrees;
+    int64_t fraction;
+
+    if (latitude < 0) {
+        latitude = -latitude;
+    }
+    degrees = (int32_t) (latitude / U_LOCATION_X1E7);
+    fraction = latitude % U_LOCATION_X1E7;
+    if (degrees < 90) {
+        cosQ16 = gCosDegreeQ16[degrees] -
+                 (((gCosDegreeQ16[degrees] - gCosDegreeQ16[degrees + 1]) * fraction) /
+                  U_LOCATION_X1E7);
+    }
+
+    return cosQ16;
+}
+
+// Callback for the sources of uLocationGetFused().
+static void fusionCallback(uDeviceHandle_t devHandle,
+                           int32_t errorCode,
+                           const uLocation_t *pLocation)
+{
+    uLocationFusionResult_t *pResult;
+
+    for (size_t x = 0; gFusionActive && (x < U_LOCATION_FUSION_MAX_SOURCES); x++) {
+        pResult = &(gFusionResult[x]);
+        if ((pResult->devHandle == devHandle) && !pResult->done) {
+            pResult->errorCode = errorCode;
+            if ((errorCode == 0) && (pLocation != NULL)) {
+                pResult->location = *pLocation;
+            } else if (errorCode == 0) {
+                pResult->errorCode = (int32_t) U_ERROR_COMMON_UNKNOWN;
+            }
+            pResult->done = true;
+        }
+    }
+}
+
+// Return true if the fix at pLocation is more accurate than
+// that at pBest, which may be NULL; an unknown radius is taken
+// to be the least accurate.
+static bool fusionIsMoreAccurate(const uLocation_t *pLocation,
+                                 const uLocation_t *pBest)
+{
+    return (pBest == NULL) ||
+           ((pLocation->radiusMillimetres >= 0) &&
+            ((pBest->radiusMillimetres < 0) ||
+             (pLocation->radiusMillimetres < pBest->radiusMillimetres)));
+}
+
 // Configure Cell Locate.
 static int32_t cellLocConfigure(uDeviceHandle_t cellHandle,
                                 int32_t desiredRateMs,
@@ -115,6 +225,10 @@ static int32_t cellLocConfigure(uDeviceHandle_t cellHandle,
         if (desiredTimeoutSeconds >= 0) {
             uCellLocSetDesiredFixTimeout(cellHandle, desiredTimeoutSeconds);
         }
+        if (pLocationAssist->cellLocateCacheMaxAgeSeconds >= 0) {
+            uCellLocSetCacheMaxAge(cellHandle,
+                                   pLocationAssist->cellLocateCacheMaxAgeSeconds);
+        }
     }
 
     if (pAuthenticationTokenStr != NULL) {
@@ -587,6 +701,113 @@ int32_t uLocationGetContinuousStart(uDeviceHandle_t devHandle,
     return errorCode;
 }
 
+// Get the current location from the first of several sources.
+int32_t uLocationGetFused(const uLocationFusionSource_t *pSources,
+                          size_t numSources,
+                          int32_t maxRadiusMillimetres,
+                          int32_t maxLatencyMs,
+                          uLocation_t *pLocation,
+                          bool (*pKeepGoingCallback) (uDeviceHandle_t))
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    const uLocation_t *pBest = NULL;
+    bool claimed = false;
+    bool finished = false;
+    size_t numDone;
+    int32_t startTimeMs;
+
+    if (gULocationMutex != NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+        U_PORT_MUTEX_LOCK(gULocationMutex);
+
+        if ((pSources != NULL) && (numSources > 0) &&
+            (numSources <= U_LOCATION_FUSION_MAX_SOURCES)) {
+            errorCode = (int32_t) U_ERROR_COMMON_BUSY;
+            if (!gFusionActive) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                memset(gFusionResult, 0, sizeof(gFusionResult));
+                for (size_t x = 0; x < numSources; x++) {
+                    for (size_t y = 0; y < x; y++) {
+                        if (pSources[y].devHandle == pSources[x].devHandle) {
+                            // Results are told apart by device handle
+                            errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+                        }
+                    }
+                    gFusionResult[x].devHandle = pSources[x].devHandle;
+                }
+                if (errorCode == 0) {
+                    gFusionActive = true;
+                    claimed = true;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gULocationMutex);
+
+        if (claimed) {
+            if (maxLatencyMs < 0) {
+                maxLatencyMs = U_LOCATION_TIMEOUT_SECONDS * 1000;
+            }
+            startTimeMs = uPortGetTickTimeMs();
+            // Start all of the sources at once; one that cannot be
+            // started is simply done
+            for (size_t x = 0; x < numSources; x++) {
+                errorCode = uLocationGetStart(pSources[x].devHandle, pSources[x].type,
+                                              pSources[x].pLocationAssist,
+                                              pSources[x].pAuthenticationTokenStr,
+                                              fusionCallback);
+                if (errorCode != 0) {
+                    gFusionResult[x].errorCode = errorCode;
+                    gFusionResult[x].done = true;
+                }
+            }
+            while (!finished) {
+                numDone = 0;
+                for (size_t x = 0; x < numSources; x++) {
+                    if (gFusionResult[x].done) {
+                        numDone++;
+                        if ((gFusionResult[x].errorCode == 0) &&
+                            fusionIsMoreAccurate(&(gFusionResult[x].location), pBest)) {
+                            pBest = &(gFusionResult[x].location);
+                        }
+                    }
+                }
+                if (((pBest != NULL) && ((maxRadiusMillimetres < 0) ||
+                                         ((pBest->radiusMillimetres >= 0) &&
+                                          (pBest->radiusMillimetres <= maxRadiusMillimetres)))) ||
+                    (numDone == numSources) ||
+                    (uPortGetTickTimeMs() - startTimeMs >= maxLatencyMs) ||
+                    ((pKeepGoingCallback != NULL) && !pKeepGoingCallback(pSources[0].devHandle))) {
+                    finished = true;
+                } else {
+                    uPortTaskBlock(U_LOCATION_FUSION_POLL_INTERVAL_MS);
+                }
+            }
+            // Cancel the sources that are still going
+            for (size_t x = 0; x < numSources; x++) {
+                if (!gFusionResult[x].done) {
+                    uLocationGetStop(pSources[x].devHandle);
+                }
+            }
+            gFusionActive = false;
+            if (pBest != NULL) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if (pLocation != NULL) {
+                    *pLocation = *pBest;
+                }
+            } else if (numDone == numSources) {
+                // Report the error from the first source
+                errorCode = gFusionResult[0].errorCode;
+            } else {
+                errorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
 // Get the current status of a location establishment attempt.
 int32_t uLocationGetStatus(uDeviceHandle_t devHandle)
 {
@@ -642,4 +863,100 @@ void uLocationGetStop(uDeviceHandle_t devHandle)
     }
 }
 
+// Convert a location into the compact form.
+int32_t uLocationPack(const uLocation_t *pLocation, uLocationPacked_t *pPacked)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pLocation != NULL) && (pPacked != NULL) &&
+        (pLocation->type >= 0) && (pLocation->type <= (int32_t) UINT8_MAX) &&
+        (pLocation->svs >= -1) && (pLocation->svs < (int32_t) UINT8_MAX) &&
+        (pLocation->timeUtc >= -1) && (pLocation->timeUtc < (int64_t) UINT32_MAX)) {
+        pPacked->latitudeX1e7 = pLocation->latitudeX1e7;
+        pPacked->longitudeX1e7 = pLocation->longitudeX1e7;
+        pPacked->altitudeMillimetres = pLocation->altitudeMillimetres;
+        pPacked->radiusMillimetres = pLocation->radiusMillimetres;
+        pPacked->speedMillimetresPerSecond = pLocation->speedMillimetresPerSecond;
+        pPacked->timeUtc = UINT32_MAX;
+        if (pLocation->timeUtc >= 0) {
+            pPacked->timeUtc = (uint32_t) pLocation->timeUtc;
+        }
+        pPacked->type = (uint8_t) pLocation->type;
+        pPacked->svs = UINT8_MAX;
+        if (pLocation->svs >= 0) {
+            pPacked->svs = (uint8_t) pLocation->svs;
+        }
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Convert a location from the compact form.
+void uLocationUnpack(const uLocationPacked_t *pPacked, uLocation_t *pLocation)
+{
+    pLocation->type = (uLocationType_t) pPacked->type;
+    pLocation->latitudeX1e7 = pPacked->latitudeX1e7;
+    pLocation->longitudeX1e7 = pPacked->longitudeX1e7;
+    pLocation->altitudeMillimetres = pPacked->altitudeMillimetres;
+    pLocation->radiusMillimetres = pPacked->radiusMillimetres;
+    pLocation->speedMillimetresPerSecond = pPacked->speedMillimetresPerSecond;
+    pLocation->svs = -1;
+    if (pPacked->svs != UINT8_MAX) {
+        pLocation->svs = pPacked->svs;
+    }
+    pLocation->timeUtc = -1;
+    if (pPacked->timeUtc != UINT32_MAX) {
+        pLocation->timeUtc = pPacked->timeUtc;
+    }
+}
+
+// Check which of an array of compact locations lie within a circle.
+int32_t uLocationPackedInCircle(const uLocationPacked_t *pLocations,
+                                size_t numLocations,
+                                const uLocationCircle_t *pCircle,
+                                bool *pInside)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int64_t cosQ16;
+    int64_t radius;
+    int64_t radiusSquared;
+    int64_t x;
+    int64_t y;
+    bool inside;
+
+    if (((pLocations != NULL) || (numLocations == 0)) &&
+        (pCircle != NULL) && (pCircle->radiusMillimetres >= 0)) {
+        errorCodeOrCount = 0;
+        // Everything is done in ten millionths of a degree of
+        // latitude: work out the radius in those units and the
+        // factor by which longitude shrinks at the centre once,
+        // outside the loop
+        cosQ16 = cosLatitudeQ16(pCircle->latitudeX1e7);
+        radius = (((int64_t) pCircle->radiusMillimetres) * 10000) /
+                 U_LOCATION_MM_X1E4_PER_DEGREE_X1E7;
+        radiusSquared = radius * radius;
+        for (size_t z = 0; z < numLocations; z++) {
+            y = ((int64_t) pLocations[z].latitudeX1e7) - pCircle->latitudeX1e7;
+            x = ((int64_t) pLocations[z].longitudeX1e7) - pCircle->longitudeX1e7;
+            // Take the short way round
+            if (x > 180LL * U_LOCATION_X1E7) {
+                x -= 360LL * U_LOCATION_X1E7;
+            } else if (x < -180LL * U_LOCATION_X1E7) {
+                x += 360LL * U_LOCATION_X1E7;
+            }
+            x = (x * cosQ16) / 65536;
+            inside = (x * x) + (y * y) <= radiusSquared;
+            if (inside) {
+                errorCodeOrCount++;
+            }
+            if (pInside != NULL) {
+                pInside[z] = inside;
+            }
+        }
+    }
+
+    return errorCodeOrCount;
+}
+
 // End of file
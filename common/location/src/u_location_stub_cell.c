@@ -59,6 +59,13 @@ U_WEAK void uCellLocSetDesiredFixTimeout(uDeviceHandle_t cellHandle,
     (void) fixTimeoutSeconds;
 }
 
+U_WEAK void uCellLocSetCacheMaxAge(uDeviceHandle_t cellHandle,
+                                   int32_t maxAgeSeconds)
+{
+    (void) cellHandle;
+    (void) maxAgeSeconds;
+}
+
 U_WEAK void uCellLocSetGnssEnable(uDeviceHandle_t cellHandle, bool onNotOff)
 {
     (void) cellHandle;
@@ -723,6 +723,61 @@ static void testContinuous(uDeviceHandle_t devHandle,
     }
 }
 
+// Test getting location from all of the networks at once: a source
+// is made of the first location type of each device that
+// uLocationGetStart() supports.
+static void testFused(uNetworkTestList_t *pList)
+{
+    uLocationFusionSource_t sources[U_LOCATION_FUSION_MAX_SOURCES];
+    size_t numSources = 0;
+    const uLocationTestCfgList_t *pLocationCfgList;
+    const uLocationTestCfg_t *pLocationCfg;
+    bool added;
+    uLocation_t location;
+    int32_t startTimeMs;
+    int32_t errorCode;
+
+    U_PORT_TEST_ASSERT(uLocationGetFused(NULL, 1, -1, -1, &location, NULL) < 0);
+    for (uNetworkTestList_t *pTmp = pList;
+         (pTmp != NULL) && (numSources < U_LOCATION_FUSION_MAX_SOURCES);
+         pTmp = pTmp->pNext) {
+        added = false;
+        for (size_t y = 0; y < numSources; y++) {
+            if (sources[y].devHandle == *pTmp->pDevHandle) {
+                // E.g. GNSS inside a cellular module
+                added = true;
+            }
+        }
+        pLocationCfgList = gpULocationTestCfg[pTmp->networkType];
+        for (size_t y = 0; (y < pLocationCfgList->numEntries) && !added; y++) {
+            pLocationCfg = pLocationCfgList->pCfgData[y];
+            if (pLocationCfg->locationType != U_LOCATION_TYPE_CLOUD_CLOUD_LOCATE) {
+                sources[numSources].devHandle = *pTmp->pDevHandle;
+                sources[numSources].type = pLocationCfg->locationType;
+                sources[numSources].pLocationAssist = pLocationCfg->pLocationAssist;
+                sources[numSources].pAuthenticationTokenStr = pLocationCfg->pAuthenticationTokenStr;
+                U_TEST_PRINT_LINE("fused source %d is %s on %s.", numSources,
+                                  gpULocationTestTypeStr[pLocationCfg->locationType],
+                                  gpUNetworkTestTypeName[pTmp->networkType]);
+                numSources++;
+                added = true;
+            }
+        }
+    }
+
+    if (numSources > 0) {
+        uLocationTestResetLocation(&location);
+        startTimeMs = uPortGetTickTimeMs();
+        errorCode = uLocationGetFused(sources, numSources, -1, -1, &location, NULL);
+        U_TEST_PRINT_LINE("fused location took %d second(s), error code %d.",
+                          (uPortGetTickTimeMs() - startTimeMs) / 1000, errorCode);
+        U_PORT_TEST_ASSERT(errorCode == 0);
+        uLocationTestPrintLocation(&location);
+        U_PORT_TEST_ASSERT(location.latitudeX1e7 > INT_MIN);
+        U_PORT_TEST_ASSERT(location.longitudeX1e7 > INT_MIN);
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -859,6 +914,9 @@ U_PORT_TEST_FUNCTION("[location]", "locationBasic")
         }
     }
 
+    // Now get location from all of them at once
+    testFused(pList);
+
     if (gpHttpContext != NULL) {
         uHttpClientClose(gpHttpContext);
         gpHttpContext = NULL;
@@ -893,6 +951,78 @@ U_PORT_TEST_FUNCTION("[location]", "locationBasic")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Test the compact form of location and the circular geofence
+ * check, which need no device.
+ */
+U_PORT_TEST_FUNCTION("[location]", "locationPacked")
+{
+    uLocation_t location;
+    uLocation_t unpacked;
+    uLocationPacked_t packed[4];
+    uLocationCircle_t circle = {.latitudeX1e7 = 600000000,
+                                .longitudeX1e7 = 1799990000,
+                                .radiusMillimetres = 1000000
+                               };
+    bool inside[4];
+
+    U_TEST_PRINT_LINE("testing compact location.");
+
+    // memset() so that memcmp() can be used, padding included
+    memset(&location, 0, sizeof(location));
+    memset(&unpacked, 0, sizeof(unpacked));
+    location.type = U_LOCATION_TYPE_GNSS;
+    location.latitudeX1e7 = 521234567;
+    location.longitudeX1e7 = -12345678;
+    location.altitudeMillimetres = INT_MIN;
+    location.radiusMillimetres = -1;
+    location.speedMillimetresPerSecond = 1234;
+    location.svs = 12;
+    location.timeUtc = 1700000000LL;
+
+    // Round trip, including the "unknown" values
+    U_PORT_TEST_ASSERT(uLocationPack(&location, &(packed[0])) == 0);
+    uLocationUnpack(&(packed[0]), &unpacked);
+    U_PORT_TEST_ASSERT(memcmp(&unpacked, &location, sizeof(location)) == 0);
+    location.svs = -1;
+    location.timeUtc = -1;
+    U_PORT_TEST_ASSERT(uLocationPack(&location, &(packed[0])) == 0);
+    uLocationUnpack(&(packed[0]), &unpacked);
+    U_PORT_TEST_ASSERT(memcmp(&unpacked, &location, sizeof(location)) == 0);
+    // Things that won't fit
+    location.timeUtc = 1LL << 32;
+    U_PORT_TEST_ASSERT(uLocationPack(&location, &(packed[0])) < 0);
+    location.timeUtc = -1;
+    location.svs = 255;
+    U_PORT_TEST_ASSERT(uLocationPack(&location, &(packed[0])) < 0);
+    U_PORT_TEST_ASSERT(uLocationPack(NULL, &(packed[0])) < 0);
+
+    // A 1 km circle at 60 degrees north, where a degree of longitude
+    // is half as long as it is at the equator, close to the
+    // 180th meridian so that the wrap is tested
+    memset(packed, 0, sizeof(packed));
+    // 500 m north: inside
+    packed[0].latitudeX1e7 = circle.latitudeX1e7 + 44966;
+    packed[0].longitudeX1e7 = circle.longitudeX1e7;
+    // 800 m east, across the 180th meridian: inside
+    packed[1].latitudeX1e7 = circle.latitudeX1e7;
+    packed[1].longitudeX1e7 = -1799866109;
+    // 1200 m west: outside, though it would be inside were the
+    // shrinking of longitude not taken into account
+    packed[2].latitudeX1e7 = circle.latitudeX1e7;
+    packed[2].longitudeX1e7 = circle.longitudeX1e7 - 215837;
+    // 1100 m south: outside
+    packed[3].latitudeX1e7 = circle.latitudeX1e7 - 98925;
+    packed[3].longitudeX1e7 = circle.longitudeX1e7;
+    U_PORT_TEST_ASSERT(uLocationPackedInCircle(packed, 4, &circle, inside) == 2);
+    U_PORT_TEST_ASSERT(inside[0] && inside[1] && !inside[2] && !inside[3]);
+    U_PORT_TEST_ASSERT(uLocationPackedInCircle(packed, 4, &circle, NULL) == 2);
+    U_PORT_TEST_ASSERT(uLocationPackedInCircle(NULL, 0, &circle, NULL) == 0);
+    U_PORT_TEST_ASSERT(uLocationPackedInCircle(packed, 4, NULL, NULL) < 0);
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
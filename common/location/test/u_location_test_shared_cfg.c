@@ -85,7 +85,8 @@ static uLocationAssist_t gLocationAssistCellLocate = {500000, // desiredAccuracy
                                                       true,   // disable GNSS for Cell Locate so that
                                                       // a GNSS network can use it
                                                       -1, -1, -1, -1, NULL, NULL, -1,
-                                                      -1, -1 // Wifi parameters are irrelevant
+                                                      -1, -1, // Wifi parameters are irrelevant
+                                                      -1 // Leave the Cell Locate cache as it is
                                                       };
 
 /** Location configuration for Cell Locate.
@@ -112,7 +113,8 @@ static uLocationAssist_t gLocationAssistCloudLocate = {-1,   // desiredAccuracyM
                                                        U_PORT_STRINGIFY_QUOTED(U_CFG_APP_CLOUD_LOCATE_MQTT_CLIENT_ID),
                                                        NULL,  // mqttClientContext must be filled in later
                                                        U_LOCATION_TEST_CLOUD_LOCATE_RRLP_DATA_LENGTH_BYTES,
-                                                       -1, -1 // Wifi parameters are irrelevant
+                                                       -1, -1, // Wifi parameters are irrelevant
+                                                       -1 // Cell Locate only: irrelevant
                                                        };
 
 /** Location configuration for Cloud Locate.
@@ -159,7 +161,8 @@ static uLocationAssist_t gLocationAssistWifi  = {-1,    // desiredAccuracyMillim
                                                  NULL, NULL,    // MQTT is irrelevant
                                                  -1,
                                                  U_LOCATION_TEST_ACCESS_POINTS_FILTER,
-                                                 U_LOCATION_TEST_RSSI_DBM_FILTER
+                                                 U_LOCATION_TEST_RSSI_DBM_FILTER,
+                                                 -1 // Cell Locate only: irrelevant
                                                  };
 #endif
 
@@ -54,6 +54,50 @@ extern "C" {
 # define U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS 120
 #endif
 
+#ifndef U_MQTT_CLIENT_QUEUE_TASK_STACK_SIZE_BYTES
+/** The stack size of the task that drains the outbound queue,
+ * see uMqttClientSetQueueOn().
+ */
+# define U_MQTT_CLIENT_QUEUE_TASK_STACK_SIZE_BYTES 2304
+#endif
+
+#ifndef U_MQTT_CLIENT_QUEUE_TASK_PRIORITY
+/** The priority of the task that drains the outbound queue,
+ * see uMqttClientSetQueueOn().
+ */
+# define U_MQTT_CLIENT_QUEUE_TASK_PRIORITY U_CFG_OS_APP_TASK_PRIORITY
+#endif
+
+#ifndef U_MQTT_CLIENT_TOPIC_CALLBACK_TOPIC_NAME_MAX_LENGTH_BYTES
+/** The maximum length of topic name that can be passed to a
+ * callback set with uMqttClientSetTopicCallback(), not including
+ * the null terminator.
+ */
+# define U_MQTT_CLIENT_TOPIC_CALLBACK_TOPIC_NAME_MAX_LENGTH_BYTES 256
+#endif
+
+#ifndef U_MQTT_CLIENT_TOPIC_CALLBACK_MESSAGE_MAX_LENGTH_BYTES
+/** The maximum length of message that can be passed to a
+ * callback set with uMqttClientSetTopicCallback(); longer
+ * messages are truncated.
+ */
+# define U_MQTT_CLIENT_TOPIC_CALLBACK_MESSAGE_MAX_LENGTH_BYTES 1024
+#endif
+
+#ifndef U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_STACK_SIZE_BYTES
+/** The stack size of the task that reads messages and calls the
+ * callbacks set with uMqttClientSetTopicCallback().
+ */
+# define U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_STACK_SIZE_BYTES 2304
+#endif
+
+#ifndef U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_PRIORITY
+/** The priority of the task that reads messages and calls the
+ * callbacks set with uMqttClientSetTopicCallback().
+ */
+# define U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_PRIORITY U_CFG_OS_APP_TASK_PRIORITY
+#endif
+
 /** The defaults for an MQTT connection, see #uMqttClientConnection_t.
  * Whenever an instance of uMqttClientConnection_t is created it
  * should be assigned to this to ensure the correct default
@@ -201,6 +245,8 @@ typedef struct {
     uSecurityTlsContext_t *pSecurityContext;
     int32_t totalMessagesSent;      /* Total messages sent from MQTT client */
     int32_t totalMessagesReceived;  /* Total messages received by MQTT client */
+    void *pQueue; /* The outbound queue, see uMqttClientSetQueueOn(), NULL if off */
+    void *pDispatch; /* Per-topic callbacks, see uMqttClientSetTopicCallback() */
 } uMqttClientContext_t;
 
 /* ----------------------------------------------------------------
@@ -316,12 +362,68 @@ bool uMqttClientIsConnected(const uMqttClientContext_t *pContext);
  *                            a previous callback.
  * @param[in] pCallbackParam  this value will be passed to pCallback
  *                            as the second parameter.
- * @return                    zero on success else negative error code.
+ * @return                    zero on success else negative error code;
+ *                            #U_ERROR_COMMON_BUSY is returned if
+ *                            callbacks have been set with
+ *                            uMqttClientSetTopicCallback().
  */
 int32_t uMqttClientSetMessageCallback(const uMqttClientContext_t *pContext,
                                       void (*pCallback) (int32_t, void *),
                                       void *pCallbackParam);
 
+/** Set a callback to be called with each new message whose topic
+ * matches the given topic filter; an alternative to
+ * uMqttClientSetMessageCallback() which saves the application from
+ * reading each message and comparing its topic name.  Topic filters
+ * may include the MQTT wildcards "+" (matches one level) and "#"
+ * (matches any number of levels, must be last), e.g. "sensor/+/temp"
+ * or "sensor/#"; the filters are held in a tree, one node per
+ * level, so the cost of finding the callbacks for a message depends
+ * on the length of its topic name, not on the number of filters.
+ * Where more than one filter matches a message, each of their
+ * callbacks is called.  Setting a callback does not subscribe to
+ * the topic, use uMqttClientSubscribe() for that.
+ *
+ * Once a callback has been set this MQTT client reads each message
+ * itself, in a task of its own, into a buffer that is allocated once,
+ * so the application need not call uMqttClientMessageRead(); a message
+ * whose topic matches no filter is read and discarded.  Hence this
+ * cannot be used at the same time as uMqttClientSetMessageCallback():
+ * setting the first topic callback replaces any callback set with
+ * uMqttClientSetMessageCallback().  Messages longer than
+ * #U_MQTT_CLIENT_TOPIC_CALLBACK_MESSAGE_MAX_LENGTH_BYTES are passed
+ * to the callback truncated.  The callbacks are called from the
+ * message-reading task, which has a stack of
+ * #U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_STACK_SIZE_BYTES; a callback may
+ * call the other functions of this API (e.g. to publish a response)
+ * except this one.  The task is stopped by uMqttClientClose().
+ *
+ * @param[in] pContext         a pointer to the internal MQTT context
+ *                             structure that was originally returned
+ *                             by pUMqttClientOpen().
+ * @param[in] pTopicFilterStr  the null-terminated topic filter; cannot
+ *                             be NULL.
+ * @param[in] pCallback        the callback; the parameters are the
+ *                             null-terminated topic name of the
+ *                             message, the message, the length of the
+ *                             message, its QoS and pCallbackParam; the
+ *                             topic name and message are only valid
+ *                             for the duration of the call.  Use NULL
+ *                             to remove a previously set callback.
+ *                             Setting a callback for a topic filter
+ *                             that already has one replaces it.
+ * @param[in] pCallbackParam   this value will be passed to pCallback.
+ * @return                     zero on success else negative error code.
+ */
+int32_t uMqttClientSetTopicCallback(uMqttClientContext_t *pContext,
+                                    const char *pTopicFilterStr,
+                                    void (*pCallback) (const char *,
+                                                       const char *,
+                                                       size_t,
+                                                       uMqttQos_t,
+                                                       void *),
+                                    void *pCallbackParam);
+
 /** Get the current number of unread messages.
  *
  * @param[in] pContext  a pointer to the internal MQTT context
@@ -378,6 +480,33 @@ int32_t uMqttClientSetDisconnectCallback(const uMqttClientContext_t *pContext,
                                          void (*pCallback) (int32_t, void *),
                                          void *pCallbackParam);
 
+/** Set a callback to be called when a publish completes, putting
+ * uMqttClientPublish() into asynchronous mode: uMqttClientPublish()
+ * then returns a non-negative message ID as soon as the message has
+ * been accepted for sending, rather than waiting for the broker, so
+ * that a number of publishes may be pipelined; pCallback is called
+ * with the message ID and the outcome when each publish completes.
+ * When the in-flight window is full uMqttClientPublish() returns
+ * #U_ERROR_COMMON_BUSY: wait for a callback and try again.  Supported
+ * for MQTT on cellular, see uCellMqttSetPublishCallback(), and on
+ * Wi-Fi, see uWifiMqttSetPublishCallback(), for the details.
+ *
+ * @param[in] pContext       a pointer to the internal MQTT context
+ *                           structure that was originally returned
+ *                           by pUMqttClientOpen().
+ * @param[in] pCallback      the callback. The first parameter is the
+ *                           message ID, as returned by
+ *                           uMqttClientPublish(), the second parameter
+ *                           is zero on success else negative error code,
+ *                           the third parameter is pCallbackParam. Use
+ *                           NULL to return to synchronous mode.
+ * @param[in] pCallbackParam this value will be passed to pCallback.
+ * @return                   zero on success else negative error code.
+ */
+int32_t uMqttClientSetPublishCallback(const uMqttClientContext_t *pContext,
+                                      void (*pCallback) (int32_t, int32_t, void *),
+                                      void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: MQTT ONLY
  * -------------------------------------------------------------- */
@@ -417,7 +546,16 @@ int32_t uMqttClientSetDisconnectCallback(const uMqttClientContext_t *pContext,
  *                          an empty message (pMessage NULL,
  *                          messageSizeBytes zero) with retain
  *                          set to true.
- * @return                  zero on success else negative error code.
+ * @return                  zero on success else negative error code;
+ *                          if a publish callback has been set with
+ *                          uMqttClientSetPublishCallback() then, on
+ *                          success, the non-negative message ID is
+ *                          returned instead of zero and
+ *                          #U_ERROR_COMMON_BUSY is returned if too
+ *                          many publishes are already in flight.
+ *                          If the outbound queue is on (see
+ *                          uMqttClientSetQueueOn()) zero is also
+ *                          returned when the message has been queued.
  */
 int32_t uMqttClientPublish(uMqttClientContext_t *pContext,
                            const char *pTopicNameStr,
@@ -425,6 +563,84 @@ int32_t uMqttClientPublish(uMqttClientContext_t *pContext,
                            size_t messageSizeBytes,
                            uMqttQos_t qos, bool retain);
 
+/** MQTT only: switch on an outbound queue for this MQTT client.
+ * With the queue on, a message passed to uMqttClientPublish() while
+ * there is no MQTT connection (or which fails because the connection
+ * has just been lost) is stored rather than being rejected, and
+ * uMqttClientPublish() returns zero.  Once the connection is back
+ * (i.e. after a successful uMqttClientConnect()) the queued messages
+ * are published, oldest first, by a task of its own, with a gap of
+ * drainIntervalMs between each one so as not to swamp the link
+ * (and the broker) on reconnection; while there is anything in the
+ * queue new messages join the back of it, so that ordering is
+ * preserved.  Should a queued publish fail while connected, draining
+ * resumes with the next call to uMqttClientPublish() or
+ * uMqttClientConnect().
+ *
+ * Messages are stored in RAM, ramSizeBytes of it; for a cellular
+ * device a file on the module's file system may also be given: when
+ * the RAM is full, messages are appended to that file, up to
+ * spillSizeBytes, and are published from there once the RAM has been
+ * emptied.  The file is not deleted by uMqttClientSetQueueOff() or
+ * uMqttClientClose() so messages stored in it survive a restart of
+ * this MCU: when uMqttClientSetQueueOn() finds the file it will
+ * queue its contents for publishing.  Each message occupies a header
+ * of 8 bytes plus the length of its topic name plus its length.
+ *
+ * Messages sent through the queue are published with the same
+ * [MQTT] function as uMqttClientPublish(): if a publish callback is
+ * set with uMqttClientSetPublishCallback() it will be called for them
+ * as normal.  Not supported for MQTT-SN.
+ *
+ * @param[in] pContext          a pointer to the internal MQTT context
+ *                              structure that was originally returned
+ *                              by pUMqttClientOpen().
+ * @param ramSizeBytes          the amount of RAM to allocate for the
+ *                              queue; must be at least large enough
+ *                              for one message.
+ * @param[in] pSpillFileNameStr the null-terminated name of a file on the
+ *                              module's file system to which messages
+ *                              should be written when the RAM is full;
+ *                              may be NULL, must be NULL if this is
+ *                              not a cellular device.
+ * @param spillSizeBytes        the maximum size of the file at
+ *                              pSpillFileNameStr; ignored if
+ *                              pSpillFileNameStr is NULL.
+ * @param drainIntervalMs       the interval between publishing each
+ *                              queued message once the connection has
+ *                              returned, in milliseconds; may be zero.
+ * @return                      zero on success else negative error
+ *                              code; an error is returned if the queue
+ *                              is already on.
+ */
+int32_t uMqttClientSetQueueOn(uMqttClientContext_t *pContext,
+                              size_t ramSizeBytes,
+                              const char *pSpillFileNameStr,
+                              size_t spillSizeBytes,
+                              int32_t drainIntervalMs);
+
+/** MQTT only: switch off the outbound queue, discarding any
+ * messages in RAM that have not yet been published; any messages
+ * in the spill file are left there (see uMqttClientSetQueueOn()).
+ * The queue is also switched off by uMqttClientClose().
+ *
+ * @param[in] pContext  a pointer to the internal MQTT context
+ *                      structure that was originally returned
+ *                      by pUMqttClientOpen().
+ */
+void uMqttClientSetQueueOff(uMqttClientContext_t *pContext);
+
+/** MQTT only: get the number of messages waiting in the outbound
+ * queue, see uMqttClientSetQueueOn().
+ *
+ * @param[in] pContext  a pointer to the internal MQTT context
+ *                      structure that was originally returned
+ *                      by pUMqttClientOpen().
+ * @return              the number of messages waiting to be
+ *                      published, else negative error code.
+ */
+int32_t uMqttClientGetQueueCount(const uMqttClientContext_t *pContext);
+
 /** MQTT only: subscribe to an MQTT topic. If pKeepGoingCallback()
  * inside the pConnection structure passed to uMqttClientConnect()
  * was non-NULL it will be called while this function is waiting
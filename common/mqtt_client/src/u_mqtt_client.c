@@ -49,28 +49,106 @@
 #include "stdbool.h"
 #include "string.h"    // strlen(), strncpy(), memset()
 
+#include "u_cfg_os_platform_specific.h" // U_CFG_OS_APP_TASK_PRIORITY
+
 #include "u_error_common.h"
 
 #include "u_device_shared.h"
 
 #include "u_port_os.h"
 #include "u_port_heap.h"
+#include "u_port_event_queue.h"
+
+#include "u_ringbuffer.h"
+#include "u_trace.h"
 
 #include "u_mqtt_common.h"
 #include "u_mqtt_client.h"
 
 #include "u_cell_sec_tls.h"
 #include "u_cell_mqtt.h"
+#include "u_cell_file.h"
 #include "u_wifi_mqtt.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The length of the event queue used to trigger draining of
+ * the outbound queue; only one event is ever outstanding.
+ */
+#define U_MQTT_CLIENT_QUEUE_EVENT_QUEUE_LENGTH 1
+
+/** The length of the event queue used to trigger the reading of
+ * messages for dispatch to topic callbacks: at most one event is
+ * outstanding while another is being handled.
+ */
+#define U_MQTT_CLIENT_DISPATCH_EVENT_QUEUE_LENGTH 2
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The header stored in front of each message in the outbound
+ * queue, in RAM or in the spill file; the topic name, without a
+ * terminator, follows and then the message.
+ */
+typedef struct {
+    uint16_t topicNameLength;
+    uint8_t qos;
+    uint8_t retain;
+    uint32_t messageSizeBytes;
+} uMqttClientQueueHeader_t;
+
+/** The outbound queue, see uMqttClientSetQueueOn(); messages in RAM
+ * are always older than those in the spill file since, once the
+ * spill file is in use, new messages are added to it until
+ * it has been emptied.
+ */
+typedef struct {
+    uRingBuffer_t ringBuffer;
+    char *pLinearBuffer;
+    size_t ramCount;
+    char *pSpillFileNameStr;
+    size_t spillSizeBytes;
+    size_t spillReadOffset;
+    size_t spillWriteOffset;
+    size_t spillCount;
+    int32_t drainIntervalMs;
+    int32_t eventQueueHandle;
+    bool drainPending;
+    volatile bool stop;
+} uMqttClientQueue_t;
+
+/** A node in the tree of topic filters used to dispatch messages
+ * to the callbacks set with uMqttClientSetTopicCallback(): there is
+ * one node per level of a topic filter, the siblings pointed-to by
+ * pNext being alternatives at the same level.
+ */
+typedef struct uMqttClientTopicNode_t {
+    struct uMqttClientTopicNode_t *pNext;
+    struct uMqttClientTopicNode_t *pChild;
+    const char *pLevel; /**< not null-terminated, stored after the node. */
+    size_t levelLength;
+    void (*pCallback) (const char *, const char *, size_t, uMqttQos_t, void *);
+    void *pCallbackParam;
+} uMqttClientTopicNode_t;
+
+/** The context for message dispatch to topic callbacks.
+ */
+typedef struct {
+    uPortMutexHandle_t mutex; /**< protects the tree, held while
+                                   the callbacks are called. */
+    uMqttClientTopicNode_t *pTree;
+    size_t numCallbacks;
+    bool indicationsTaken; /**< true if dispatchIndicationCallback()
+                                is hooked into the underlying API. */
+    int32_t eventQueueHandle;
+    volatile bool readPending;
+    char *pTopicNameStr;
+    char *pMessage;
+} uMqttClientDispatch_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -148,6 +226,591 @@ static int32_t cellConnect(uDeviceHandle_t devHandle,
     return errorCode;
 }
 
+/** Determine whether an MQTT session is active.
+ * The mutex for this session must be locked before this is called.
+ */
+static bool isConnected(const uMqttClientContext_t *pContext)
+{
+    bool connected = false;
+
+    if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
+        connected = uCellMqttIsConnected(pContext->devHandle);
+    } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
+        connected = uWifiMqttIsConnected(pContext);
+    }
+
+    return connected;
+}
+
+/** Publish an MQTT message with the underlying API.
+ * The mutex for this session must be locked before this is called.
+ */
+static int32_t publishNow(uMqttClientContext_t *pContext,
+                          const char *pTopicNameStr,
+                          const char *pMessage,
+                          size_t messageSizeBytes,
+                          uMqttQos_t qos, bool retain)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    bool traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
+
+    if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
+        errorCode = uCellMqttPublish(pContext->devHandle,
+                                     pTopicNameStr,
+                                     pMessage, messageSizeBytes,
+                                     (uCellMqttQos_t) qos, retain);
+    } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
+        errorCode = uWifiMqttPublish(pContext,
+                                     pTopicNameStr,
+                                     pMessage, messageSizeBytes,
+                                     (uMqttQos_t)qos, retain);
+    }
+    if (traced) {
+        uTraceStagePop();
+    }
+    // A non-negative value is a message ID in asynchronous mode
+    if (errorCode >= 0) {
+        pContext->totalMessagesSent++;
+    }
+
+    return errorCode;
+}
+
+/** Add a message to the back of the outbound queue.
+ * The mutex for this session must be locked before this is called.
+ */
+static int32_t queueAdd(const uMqttClientContext_t *pContext,
+                        uMqttClientQueue_t *pQueue,
+                        const char *pTopicNameStr,
+                        const char *pMessage,
+                        size_t messageSizeBytes,
+                        uMqttQos_t qos, bool retain)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+    uMqttClientQueueHeader_t header;
+    size_t recordSize;
+    char *pRecord;
+
+    header.topicNameLength = (uint16_t) strlen(pTopicNameStr);
+    header.qos = (uint8_t) qos;
+    header.retain = (uint8_t) retain;
+    header.messageSizeBytes = (uint32_t) messageSizeBytes;
+    recordSize = sizeof(header) + header.topicNameLength + messageSizeBytes;
+    if ((pQueue->spillCount == 0) &&
+        (uRingBufferAvailableSize(&(pQueue->ringBuffer)) >= recordSize)) {
+        // There is room in RAM
+        uRingBufferAdd(&(pQueue->ringBuffer), (const char *) &header, sizeof(header));
+        uRingBufferAdd(&(pQueue->ringBuffer), pTopicNameStr, header.topicNameLength);
+        if (messageSizeBytes > 0) {
+            uRingBufferAdd(&(pQueue->ringBuffer), pMessage, messageSizeBytes);
+        }
+        pQueue->ramCount++;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    } else if ((pQueue->pSpillFileNameStr != NULL) &&
+               (pQueue->spillWriteOffset + recordSize <= pQueue->spillSizeBytes)) {
+        // Append the message to the spill file, in one go
+        pRecord = (char *) pUPortMalloc(recordSize);
+        if (pRecord != NULL) {
+            memcpy(pRecord, &header, sizeof(header));
+            memcpy(pRecord + sizeof(header), pTopicNameStr, header.topicNameLength);
+            if (messageSizeBytes > 0) {
+                memcpy(pRecord + sizeof(header) + header.topicNameLength,
+                       pMessage, messageSizeBytes);
+            }
+            errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+            if (uCellFileWrite(pContext->devHandle, pQueue->pSpillFileNameStr,
+                               pRecord, recordSize) == (int32_t) recordSize) {
+                pQueue->spillWriteOffset += recordSize;
+                pQueue->spillCount++;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+            uPortFree(pRecord);
+        }
+    }
+
+    return errorCode;
+}
+
+/** Read the message at the front of the outbound queue, without
+ * removing it, into a buffer allocated by this function that the
+ * caller must free; the topic name in the buffer is followed by a
+ * terminator and then the message.  Returns the size of the stored
+ * record or negative error code.
+ * The mutex for this session must be locked before this is called.
+ */
+static int32_t queuePeek(const uMqttClientContext_t *pContext,
+                         uMqttClientQueue_t *pQueue,
+                         uMqttClientQueueHeader_t *pHeader,
+                         char **ppBuffer)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+    size_t length = 0;
+
+    if (pQueue->ramCount > 0) {
+        if (uRingBufferPeek(&(pQueue->ringBuffer), (char *) pHeader,
+                            sizeof(*pHeader), 0) == sizeof(*pHeader)) {
+            length = pHeader->topicNameLength + pHeader->messageSizeBytes;
+            errorCodeOrSize = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            *ppBuffer = (char *) pUPortMalloc(length + 1);
+            if (*ppBuffer != NULL) {
+                uRingBufferPeek(&(pQueue->ringBuffer), *ppBuffer,
+                                pHeader->topicNameLength, sizeof(*pHeader));
+                uRingBufferPeek(&(pQueue->ringBuffer),
+                                *ppBuffer + pHeader->topicNameLength + 1,
+                                pHeader->messageSizeBytes,
+                                sizeof(*pHeader) + pHeader->topicNameLength);
+                errorCodeOrSize = (int32_t) (sizeof(*pHeader) + length);
+            }
+        }
+    } else if (uCellFileBlockRead(pContext->devHandle, pQueue->pSpillFileNameStr,
+                                  (char *) pHeader, pQueue->spillReadOffset,
+                                  sizeof(*pHeader)) == sizeof(*pHeader)) {
+        length = pHeader->topicNameLength + pHeader->messageSizeBytes;
+        errorCodeOrSize = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        *ppBuffer = (char *) pUPortMalloc(length + 1);
+        if (*ppBuffer != NULL) {
+            errorCodeOrSize = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+            if ((uCellFileBlockRead(pContext->devHandle, pQueue->pSpillFileNameStr,
+                                    *ppBuffer, pQueue->spillReadOffset + sizeof(*pHeader),
+                                    pHeader->topicNameLength) == pHeader->topicNameLength) &&
+                ((pHeader->messageSizeBytes == 0) ||
+                 (uCellFileBlockRead(pContext->devHandle, pQueue->pSpillFileNameStr,
+                                     *ppBuffer + pHeader->topicNameLength + 1,
+                                     pQueue->spillReadOffset + sizeof(*pHeader) +
+                                     pHeader->topicNameLength,
+                                     pHeader->messageSizeBytes) == (int32_t) pHeader->messageSizeBytes))) {
+                errorCodeOrSize = (int32_t) (sizeof(*pHeader) + length);
+            }
+        }
+    }
+    if ((errorCodeOrSize > 0) && (*ppBuffer != NULL)) {
+        // Terminate the topic name
+        *(*ppBuffer + pHeader->topicNameLength) = 0;
+    }
+
+    return errorCodeOrSize;
+}
+
+/** Remove the message at the front of the outbound queue.
+ * The mutex for this session must be locked before this is called.
+ */
+static void queueRemove(const uMqttClientContext_t *pContext,
+                        uMqttClientQueue_t *pQueue,
+                        size_t recordSize)
+{
+    if (pQueue->ramCount > 0) {
+        uRingBufferRead(&(pQueue->ringBuffer), NULL, recordSize);
+        pQueue->ramCount--;
+    } else if (pQueue->spillCount > 0) {
+        pQueue->spillReadOffset += recordSize;
+        pQueue->spillCount--;
+        if (pQueue->spillCount == 0) {
+            // All sent: start the spill file afresh
+            uCellFileDelete(pContext->devHandle, pQueue->pSpillFileNameStr);
+            pQueue->spillReadOffset = 0;
+            pQueue->spillWriteOffset = 0;
+        }
+    }
+}
+
+/** Count the messages left in a spill file from a previous
+ * session; if the file does not make sense it is deleted.
+ * The mutex for this session must be locked before this is called.
+ */
+static void queueSpillFileRecover(const uMqttClientContext_t *pContext,
+                                  uMqttClientQueue_t *pQueue)
+{
+    uMqttClientQueueHeader_t header;
+    int32_t fileSize;
+    size_t offset = 0;
+    size_t count = 0;
+    bool readOk = true;
+
+    fileSize = uCellFileSize(pContext->devHandle, pQueue->pSpillFileNameStr);
+    if (fileSize > 0) {
+        while (readOk && (offset + sizeof(header) <= (size_t) fileSize)) {
+            readOk = (uCellFileBlockRead(pContext->devHandle, pQueue->pSpillFileNameStr,
+                                         (char *) &header, offset,
+                                         sizeof(header)) == sizeof(header));
+            if (readOk) {
+                offset += sizeof(header) + header.topicNameLength + header.messageSizeBytes;
+                count++;
+            }
+        }
+        if (readOk && (offset == (size_t) fileSize)) {
+            pQueue->spillWriteOffset = offset;
+            pQueue->spillCount = count;
+        } else {
+            // A partial record, maybe from a power-cut
+            uCellFileDelete(pContext->devHandle, pQueue->pSpillFileNameStr);
+        }
+    }
+}
+
+/** Kick the task that drains the outbound queue, if there is
+ * something to do and it is not already running.
+ * The mutex for this session must be locked before this is called.
+ */
+static void queueDrainTrigger(uMqttClientContext_t *pContext,
+                              uMqttClientQueue_t *pQueue)
+{
+    if (!pQueue->drainPending && !pQueue->stop &&
+        (pQueue->ramCount + pQueue->spillCount > 0) && isConnected(pContext)) {
+        // Only one event is ever outstanding so this will not block
+        pQueue->drainPending = true;
+        if (uPortEventQueueSend(pQueue->eventQueueHandle, &pContext,
+                                sizeof(pContext)) != 0) {
+            pQueue->drainPending = false;
+        }
+    }
+}
+
+/** Event handler that drains the outbound queue, the parameter
+ * is a pointer to the MQTT context.
+ */
+static void queueDrainCallback(void *pParam, size_t paramLength)
+{
+    uMqttClientContext_t *pContext = *((uMqttClientContext_t **) pParam);
+    uMqttClientQueue_t *pQueue;
+    uMqttClientQueueHeader_t header;
+    char *pBuffer;
+    int32_t recordSize;
+    int32_t drainIntervalMs = 0;
+    bool keepGoing = true;
+
+    (void) paramLength;
+
+    while (keepGoing) {
+        keepGoing = false;
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        pQueue = (uMqttClientQueue_t *) pContext->pQueue;
+        if (pQueue != NULL) {
+            if (!pQueue->stop && (pQueue->ramCount + pQueue->spillCount > 0) &&
+                isConnected(pContext)) {
+                pBuffer = NULL;
+                recordSize = queuePeek(pContext, pQueue, &header, &pBuffer);
+                if ((recordSize > 0) &&
+                    (publishNow(pContext, pBuffer,
+                                pBuffer + header.topicNameLength + 1,
+                                header.messageSizeBytes,
+                                (uMqttQos_t) header.qos,
+                                header.retain != 0) >= 0)) {
+                    queueRemove(pContext, pQueue, (size_t) recordSize);
+                    keepGoing = (pQueue->ramCount + pQueue->spillCount > 0);
+                }
+                uPortFree(pBuffer);
+            }
+            if (!keepGoing) {
+                pQueue->drainPending = false;
+            }
+            drainIntervalMs = pQueue->drainIntervalMs;
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        if (keepGoing && (drainIntervalMs > 0)) {
+            // Rate limit
+            uPortTaskBlock(drainIntervalMs);
+        }
+    }
+}
+
+/** Switch the outbound queue off and free it.
+ * The mutex for this session must NOT be locked when this is
+ * called, since the drain task has to be able to finish.
+ */
+static void queueOff(uMqttClientContext_t *pContext)
+{
+    uMqttClientQueue_t *pQueue;
+
+    U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+    pQueue = (uMqttClientQueue_t *) pContext->pQueue;
+    if (pQueue != NULL) {
+        pQueue->stop = true;
+    }
+    U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+    if (pQueue != NULL) {
+        // This waits for the drain task to exit
+        uPortEventQueueClose(pQueue->eventQueueHandle);
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+        pContext->pQueue = NULL;
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        uRingBufferDelete(&(pQueue->ringBuffer));
+        uPortFree(pQueue->pLinearBuffer);
+        uPortFree(pQueue->pSpillFileNameStr);
+        uPortFree(pQueue);
+    }
+}
+
+/** Check that a topic filter is valid: a wildcard must occupy
+ * a whole level and "#" may only be the last level.
+ */
+static bool topicFilterIsValid(const char *pTopicFilterStr)
+{
+    bool isValid = (*pTopicFilterStr != 0);
+    const char *pLevel = pTopicFilterStr;
+    const char *pEnd;
+    size_t length;
+
+    while (isValid && (pLevel != NULL)) {
+        pEnd = strchr(pLevel, '/');
+        length = (pEnd != NULL) ? (size_t) (pEnd - pLevel) : strlen(pLevel);
+        for (size_t x = 0; (x < length) && isValid; x++) {
+            if ((*(pLevel + x) == '+') || (*(pLevel + x) == '#')) {
+                isValid = (length == 1) && ((*pLevel == '+') || (pEnd == NULL));
+            }
+        }
+        pLevel = (pEnd != NULL) ? pEnd + 1 : NULL;
+    }
+
+    return isValid;
+}
+
+/** Find the node in the topic filter tree for a topic filter,
+ * optionally creating it (and any missing parents); returns NULL
+ * if the node is not found or cannot be created.
+ */
+static uMqttClientTopicNode_t *pTopicNodeFind(uMqttClientTopicNode_t **ppList,
+                                              const char *pTopicFilterStr,
+                                              bool create)
+{
+    uMqttClientTopicNode_t *pNode = NULL;
+    const char *pLevel = pTopicFilterStr;
+    const char *pEnd;
+    size_t length;
+
+    while ((ppList != NULL) && (pLevel != NULL)) {
+        pEnd = strchr(pLevel, '/');
+        length = (pEnd != NULL) ? (size_t) (pEnd - pLevel) : strlen(pLevel);
+        pNode = *ppList;
+        while ((pNode != NULL) &&
+               ((pNode->levelLength != length) ||
+                (memcmp(pNode->pLevel, pLevel, length) != 0))) {
+            pNode = pNode->pNext;
+        }
+        if ((pNode == NULL) && create) {
+            // Store the level after the node, in the same allocation
+            pNode = (uMqttClientTopicNode_t *) pUPortMalloc(sizeof(*pNode) + length);
+            if (pNode != NULL) {
+                memset(pNode, 0, sizeof(*pNode));
+                memcpy((char *) (pNode + 1), pLevel, length);
+                pNode->pLevel = (const char *) (pNode + 1);
+                pNode->levelLength = length;
+                pNode->pNext = *ppList;
+                *ppList = pNode;
+            }
+        }
+        ppList = (pNode != NULL) ? &(pNode->pChild) : NULL;
+        pLevel = (pEnd != NULL) ? pEnd + 1 : NULL;
+    }
+
+    return pNode;
+}
+
+/** Remove any nodes from the topic filter tree that have neither
+ * a callback nor children.
+ */
+static void topicNodePrune(uMqttClientTopicNode_t **ppList)
+{
+    uMqttClientTopicNode_t *pNode;
+
+    while (*ppList != NULL) {
+        pNode = *ppList;
+        topicNodePrune(&(pNode->pChild));
+        if ((pNode->pCallback == NULL) && (pNode->pChild == NULL)) {
+            *ppList = pNode->pNext;
+            uPortFree(pNode);
+        } else {
+            ppList = &(pNode->pNext);
+        }
+    }
+}
+
+/** Free a list of nodes in the topic filter tree, and all
+ * their children.
+ */
+static void topicNodeFree(uMqttClientTopicNode_t *pList)
+{
+    uMqttClientTopicNode_t *pNext;
+
+    while (pList != NULL) {
+        pNext = pList->pNext;
+        topicNodeFree(pList->pChild);
+        uPortFree(pList);
+        pList = pNext;
+    }
+}
+
+/** Call the callback of a node, if there is one.
+ */
+static void topicNodeCall(const uMqttClientTopicNode_t *pNode,
+                          const char *pTopicNameStr,
+                          const char *pMessage, size_t messageSizeBytes,
+                          uMqttQos_t qos)
+{
+    if (pNode->pCallback != NULL) {
+        pNode->pCallback(pTopicNameStr, pMessage, messageSizeBytes,
+                         qos, pNode->pCallbackParam);
+    }
+}
+
+/** Call the callbacks of all of the topic filters in the list that
+ * match the topic name from pLevel onwards; first is true if pLevel
+ * is the first level of the topic name, since wildcards do not
+ * match topic names beginning with '$' (e.g. "$SYS").
+ */
+static void topicMatch(const uMqttClientTopicNode_t *pList,
+                       const char *pLevel, bool first,
+                       const char *pTopicNameStr,
+                       const char *pMessage, size_t messageSizeBytes,
+                       uMqttQos_t qos)
+{
+    const char *pEnd = strchr(pLevel, '/');
+    size_t length = (pEnd != NULL) ? (size_t) (pEnd - pLevel) : strlen(pLevel);
+    bool wildcardAllowed = !first || (*pLevel != '$');
+    const uMqttClientTopicNode_t *pChild;
+
+    for (const uMqttClientTopicNode_t *pNode = pList; pNode != NULL; pNode = pNode->pNext) {
+        if ((pNode->levelLength == 1) && (*pNode->pLevel == '#')) {
+            if (wildcardAllowed) {
+                // Matches everything from here on
+                topicNodeCall(pNode, pTopicNameStr, pMessage, messageSizeBytes, qos);
+            }
+        } else if (((pNode->levelLength == 1) && (*pNode->pLevel == '+') && wildcardAllowed) ||
+                   ((pNode->levelLength == length) &&
+                    (memcmp(pNode->pLevel, pLevel, length) == 0))) {
+            if (pEnd != NULL) {
+                // Move on to the next level
+                topicMatch(pNode->pChild, pEnd + 1, false, pTopicNameStr,
+                           pMessage, messageSizeBytes, qos);
+            } else {
+                // Last level of the topic name
+                topicNodeCall(pNode, pTopicNameStr, pMessage, messageSizeBytes, qos);
+                // "a/#" also matches "a"
+                for (pChild = pNode->pChild; pChild != NULL; pChild = pChild->pNext) {
+                    if ((pChild->levelLength == 1) && (*pChild->pLevel == '#')) {
+                        topicNodeCall(pChild, pTopicNameStr, pMessage, messageSizeBytes, qos);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Event handler that reads messages and dispatches them to the
+ * topic callbacks, the parameter is a pointer to the MQTT context.
+ */
+static void dispatchCallback(void *pParam, size_t paramLength)
+{
+    uMqttClientContext_t *pContext = *((uMqttClientContext_t **) pParam);
+    uMqttClientDispatch_t *pDispatch = (uMqttClientDispatch_t *) pContext->pDispatch;
+    size_t messageSizeBytes;
+    uMqttQos_t qos;
+    int32_t errorCode = 0;
+
+    (void) paramLength;
+
+    if (pDispatch != NULL) {
+        // Clear this first so that a message arriving from now on
+        // triggers another read
+        pDispatch->readPending = false;
+        while ((errorCode == 0) && (pDispatch->numCallbacks > 0) &&
+               (uMqttClientGetUnread(pContext) > 0)) {
+            messageSizeBytes = U_MQTT_CLIENT_TOPIC_CALLBACK_MESSAGE_MAX_LENGTH_BYTES;
+            qos = U_MQTT_QOS_AT_MOST_ONCE;
+            errorCode = uMqttClientMessageRead(pContext, pDispatch->pTopicNameStr,
+                                               U_MQTT_CLIENT_TOPIC_CALLBACK_TOPIC_NAME_MAX_LENGTH_BYTES + 1,
+                                               pDispatch->pMessage, &messageSizeBytes,
+                                               &qos);
+            if (errorCode == (int32_t) U_ERROR_COMMON_TRUNCATED) {
+                // Deliver what we have
+                errorCode = 0;
+            }
+            if (errorCode == 0) {
+                U_PORT_MUTEX_LOCK(pDispatch->mutex);
+                topicMatch(pDispatch->pTree, pDispatch->pTopicNameStr, true,
+                           pDispatch->pTopicNameStr, pDispatch->pMessage,
+                           messageSizeBytes, qos);
+                U_PORT_MUTEX_UNLOCK(pDispatch->mutex);
+            }
+        }
+    }
+}
+
+/** Message indication callback, hooked into the underlying API
+ * while there are topic callbacks, the parameter being the MQTT
+ * context; the reading of messages is not done here but by
+ * dispatchCallback() in its own task.
+ */
+static void dispatchIndicationCallback(int32_t numUnread, void *pParam)
+{
+    uMqttClientContext_t *pContext = (uMqttClientContext_t *) pParam;
+    uMqttClientDispatch_t *pDispatch = (uMqttClientDispatch_t *) pContext->pDispatch;
+
+    if ((numUnread > 0) && (pDispatch != NULL) && (pDispatch->numCallbacks > 0) &&
+        !pDispatch->readPending) {
+        pDispatch->readPending = true;
+        if (uPortEventQueueSend(pDispatch->eventQueueHandle, &pContext,
+                                sizeof(pContext)) != 0) {
+            pDispatch->readPending = false;
+        }
+    }
+}
+
+/** Set the message indication callback of the underlying API.
+ * The mutex for this session must be locked before this is called.
+ */
+static int32_t setMessageCallback(const uMqttClientContext_t *pContext,
+                                  void (*pCallback) (int32_t, void *),
+                                  void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+
+    if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
+        errorCode = uCellMqttSetMessageCallback(pContext->devHandle,
+                                                pCallback,
+                                                pCallbackParam);
+    } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
+        errorCode = uWifiMqttSetMessageCallback(pContext,
+                                                pCallback,
+                                                pCallbackParam);
+    }
+
+    return errorCode;
+}
+
+/** Stop message dispatch to topic callbacks and free the context.
+ * The mutex for this session must NOT be locked when this is
+ * called, since the dispatch task has to be able to finish.
+ */
+static void dispatchOff(uMqttClientContext_t *pContext)
+{
+    uMqttClientDispatch_t *pDispatch = (uMqttClientDispatch_t *) pContext->pDispatch;
+
+    if (pDispatch != NULL) {
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+        if (pDispatch->indicationsTaken) {
+            setMessageCallback(pContext, NULL, NULL);
+        }
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        // This waits for the dispatch task to exit
+        uPortEventQueueClose(pDispatch->eventQueueHandle);
+        pContext->pDispatch = NULL;
+
+        topicNodeFree(pDispatch->pTree);
+        uPortMutexDelete(pDispatch->mutex);
+        uPortFree(pDispatch->pTopicNameStr);
+        uPortFree(pDispatch->pMessage);
+        uPortFree(pDispatch);
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: MQTT AND MQTT-SN
  * -------------------------------------------------------------- */
@@ -237,6 +900,11 @@ void uMqttClientClose(uMqttClientContext_t *pContext)
 {
     if (pContext != NULL) {
 
+        // Stop the outbound queue and message dispatch
+        // first, outside the mutex
+        queueOff(pContext);
+        dispatchOff(pContext);
+
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
         if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
@@ -262,12 +930,15 @@ int32_t uMqttClientConnect(uMqttClientContext_t *pContext,
                            const uMqttClientConnection_t *pConnection)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t traceHandle = uTraceOperationStart("uMqttClientConnect");
+    bool traced;
 
     if ((pContext != NULL) && (pConnection != NULL)) {
         errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
+        traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
         if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
             errorCode = cellConnect(pContext->devHandle,
                                     pConnection,
@@ -282,10 +953,20 @@ int32_t uMqttClientConnect(uMqttClientContext_t *pContext,
 
             errorCode = uWifiMqttConnect(pContext, pConnection);
         }
+        if (traced) {
+            uTraceStagePop();
+        }
+
+        if ((errorCode == 0) && (pContext->pQueue != NULL)) {
+            // Send anything that was queued while we were away
+            queueDrainTrigger(pContext, (uMqttClientQueue_t *) pContext->pQueue);
+        }
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
     }
 
+    uTraceOperationStop(traceHandle, errorCode);
+
     return errorCode;
 }
 
@@ -314,22 +995,18 @@ int32_t uMqttClientDisconnect(const uMqttClientContext_t *pContext)
 // Determine whether an MQTT session is active or not.
 bool uMqttClientIsConnected(const uMqttClientContext_t *pContext)
 {
-    bool isConnected = false;
+    bool connected = false;
 
     if (pContext != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
-        if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
-            isConnected = uCellMqttIsConnected(pContext->devHandle);
-        } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
-            isConnected = uWifiMqttIsConnected(pContext);
-        }
+        connected = isConnected(pContext);
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
     }
 
-    return isConnected;
+    return connected;
 }
 
 // Set a callback to be called on new message arrival.
@@ -340,18 +1017,16 @@ int32_t uMqttClientSetMessageCallback(const uMqttClientContext_t *pContext,
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
 
     if (pContext != NULL) {
-        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        errorCode = (int32_t) U_ERROR_COMMON_BUSY;
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
-        if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
-            errorCode = uCellMqttSetMessageCallback(pContext->devHandle,
-                                                    pCallback,
-                                                    pCallbackParam);
-        } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
-            errorCode = uWifiMqttSetMessageCallback(pContext,
-                                                    pCallback,
-                                                    pCallbackParam);
+        if ((pContext->pDispatch == NULL) ||
+            (((uMqttClientDispatch_t *) pContext->pDispatch)->numCallbacks == 0)) {
+            errorCode = setMessageCallback(pContext, pCallback, pCallbackParam);
+            if ((errorCode == 0) && (pContext->pDispatch != NULL)) {
+                ((uMqttClientDispatch_t *) pContext->pDispatch)->indicationsTaken = false;
+            }
         }
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
@@ -360,6 +1035,125 @@ int32_t uMqttClientSetMessageCallback(const uMqttClientContext_t *pContext,
     return errorCode;
 }
 
+// Set a callback for messages matching a topic filter.
+int32_t uMqttClientSetTopicCallback(uMqttClientContext_t *pContext,
+                                    const char *pTopicFilterStr,
+                                    void (*pCallback) (const char *,
+                                                       const char *,
+                                                       size_t,
+                                                       uMqttQos_t,
+                                                       void *),
+                                    void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uMqttClientDispatch_t *pDispatch;
+    uMqttClientTopicNode_t *pNode;
+    bool takeOver = false;
+
+    if ((pContext != NULL) && (pTopicFilterStr != NULL) &&
+        topicFilterIsValid(pTopicFilterStr)) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pDispatch = (uMqttClientDispatch_t *) pContext->pDispatch;
+        if ((pDispatch == NULL) && (pCallback != NULL)) {
+            // First time: set up the dispatch context, including the
+            // buffers that every message is read into
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pDispatch = (uMqttClientDispatch_t *) pUPortMalloc(sizeof(*pDispatch));
+            if (pDispatch != NULL) {
+                memset(pDispatch, 0, sizeof(*pDispatch));
+                pDispatch->eventQueueHandle = -1;
+                pDispatch->pTopicNameStr = (char *) pUPortMalloc(U_MQTT_CLIENT_TOPIC_CALLBACK_TOPIC_NAME_MAX_LENGTH_BYTES + 1);
+                pDispatch->pMessage = (char *) pUPortMalloc(U_MQTT_CLIENT_TOPIC_CALLBACK_MESSAGE_MAX_LENGTH_BYTES);
+                if ((pDispatch->pTopicNameStr != NULL) && (pDispatch->pMessage != NULL) &&
+                    (uPortMutexCreate(&(pDispatch->mutex)) == 0)) {
+                    errorCode = uPortEventQueueOpen(dispatchCallback,
+                                                    "mqttDispatch",
+                                                    sizeof(uMqttClientContext_t *),
+                                                    U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_STACK_SIZE_BYTES,
+                                                    U_MQTT_CLIENT_TOPIC_CALLBACK_TASK_PRIORITY,
+                                                    U_MQTT_CLIENT_DISPATCH_EVENT_QUEUE_LENGTH);
+                    if (errorCode >= 0) {
+                        pDispatch->eventQueueHandle = errorCode;
+                        pContext->pDispatch = pDispatch;
+                        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    }
+                }
+                if (errorCode != 0) {
+                    // Clean up on error
+                    if (pDispatch->mutex != NULL) {
+                        uPortMutexDelete(pDispatch->mutex);
+                    }
+                    uPortFree(pDispatch->pTopicNameStr);
+                    uPortFree(pDispatch->pMessage);
+                    uPortFree(pDispatch);
+                    pDispatch = NULL;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        if (pDispatch != NULL) {
+            // Note: the session mutex must not be held while the
+            // dispatch mutex is taken since the dispatch mutex is held
+            // while the callbacks are called and a callback may call
+            // into this API
+            U_PORT_MUTEX_LOCK(pDispatch->mutex);
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pNode = pTopicNodeFind(&(pDispatch->pTree), pTopicFilterStr,
+                                   pCallback != NULL);
+            if (pNode != NULL) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if ((pNode->pCallback == NULL) && (pCallback != NULL)) {
+                    pDispatch->numCallbacks++;
+                    // Take over message indications if this is the first
+                    takeOver = (pDispatch->numCallbacks == 1);
+                } else if ((pNode->pCallback != NULL) && (pCallback == NULL)) {
+                    // When the last callback goes dispatchIndicationCallback()
+                    // is left in place but no longer reads messages
+                    pDispatch->numCallbacks--;
+                }
+                pNode->pCallback = pCallback;
+                pNode->pCallbackParam = pCallbackParam;
+            } else if (pCallback == NULL) {
+                // Nothing to remove
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+            // Tidy away any nodes that are no longer needed
+            topicNodePrune(&(pDispatch->pTree));
+            U_PORT_MUTEX_UNLOCK(pDispatch->mutex);
+
+            if (takeOver) {
+                U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+                errorCode = setMessageCallback(pContext, dispatchIndicationCallback,
+                                               pContext);
+                pDispatch->indicationsTaken = (errorCode == 0);
+                U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+                if (errorCode != 0) {
+                    // Undo the addition
+                    U_PORT_MUTEX_LOCK(pDispatch->mutex);
+                    pNode = pTopicNodeFind(&(pDispatch->pTree), pTopicFilterStr, false);
+                    if ((pNode != NULL) && (pNode->pCallback != NULL)) {
+                        pNode->pCallback = NULL;
+                        pDispatch->numCallbacks--;
+                        topicNodePrune(&(pDispatch->pTree));
+                    }
+                    U_PORT_MUTEX_UNLOCK(pDispatch->mutex);
+                }
+            }
+            if (errorCode == 0) {
+                // In case there are messages waiting already
+                dispatchIndicationCallback(1, pContext);
+            }
+        }
+    }
+
+    return errorCode;
+}
+
 // Get the current number of unread messages.
 int32_t uMqttClientGetUnread(const uMqttClientContext_t *pContext)
 {
@@ -454,6 +1248,34 @@ int32_t uMqttClientSetDisconnectCallback(const uMqttClientContext_t *pContext,
     return errorCode;
 }
 
+// Set a callback for when an asynchronous publish completes.
+int32_t uMqttClientSetPublishCallback(const uMqttClientContext_t *pContext,
+                                      void (*pCallback) (int32_t, int32_t, void *),
+                                      void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (pContext != NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
+            errorCode = uCellMqttSetPublishCallback(pContext->devHandle,
+                                                    pCallback,
+                                                    pCallbackParam);
+        } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
+            errorCode = uWifiMqttSetPublishCallback(pContext,
+                                                    pCallback,
+                                                    pCallbackParam);
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+    }
+
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: MQTT ONLY
  * -------------------------------------------------------------- */
@@ -466,48 +1288,167 @@ int32_t uMqttClientPublish(uMqttClientContext_t *pContext,
                            uMqttQos_t qos, bool retain)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uMqttClientQueue_t *pQueue;
+    int32_t traceHandle = uTraceOperationStart("uMqttClientPublish");
 
     if ((pContext != NULL) && (pTopicNameStr != NULL) &&
         // If retain is true an empty message sent to the broker means
         // "clear the single allowed retained message from the topic"
         (retain || ((pMessage != NULL) && (messageSizeBytes > 0)))) {
-        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
-        if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
-            errorCode = uCellMqttPublish(pContext->devHandle,
-                                         pTopicNameStr,
-                                         pMessage, messageSizeBytes,
-                                         (uCellMqttQos_t) qos, retain);
-        } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
-            errorCode = uWifiMqttPublish(pContext,
-                                         pTopicNameStr,
-                                         pMessage, messageSizeBytes,
-                                         (uMqttQos_t)qos, retain);
+        pQueue = (uMqttClientQueue_t *) pContext->pQueue;
+        if ((pQueue != NULL) &&
+            ((pQueue->ramCount + pQueue->spillCount > 0) || !isConnected(pContext))) {
+            // Keep messages in order: if anything is already
+            // queued, or there is no connection, join the queue
+            errorCode = queueAdd(pContext, pQueue, pTopicNameStr,
+                                 pMessage, messageSizeBytes, qos, retain);
+        } else {
+            errorCode = publishNow(pContext, pTopicNameStr,
+                                   pMessage, messageSizeBytes, qos, retain);
+            if ((errorCode < 0) && (pQueue != NULL) && !isConnected(pContext)) {
+                // The connection went while we were publishing
+                errorCode = queueAdd(pContext, pQueue, pTopicNameStr,
+                                     pMessage, messageSizeBytes, qos, retain);
+            }
         }
-        if (errorCode == 0) {
-            pContext->totalMessagesSent++;
+        if (pQueue != NULL) {
+            queueDrainTrigger(pContext, pQueue);
         }
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
     }
 
+    uTraceOperationStop(traceHandle, errorCode);
+
     return errorCode;
 }
 
+// Switch on the outbound queue.
+int32_t uMqttClientSetQueueOn(uMqttClientContext_t *pContext,
+                              size_t ramSizeBytes,
+                              const char *pSpillFileNameStr,
+                              size_t spillSizeBytes,
+                              int32_t drainIntervalMs)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uMqttClientQueue_t *pQueue = NULL;
+
+    if ((pContext != NULL) && (ramSizeBytes > sizeof(uMqttClientQueueHeader_t)) &&
+        (drainIntervalMs >= 0) &&
+        ((pSpillFileNameStr == NULL) ||
+         (strlen(pSpillFileNameStr) <= U_CELL_FILE_NAME_MAX_LENGTH))) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        if (pContext->pQueue == NULL) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if ((pSpillFileNameStr == NULL) ||
+                U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                pQueue = (uMqttClientQueue_t *) pUPortMalloc(sizeof(*pQueue));
+            }
+            if (pQueue != NULL) {
+                memset(pQueue, 0, sizeof(*pQueue));
+                pQueue->eventQueueHandle = -1;
+                pQueue->drainIntervalMs = drainIntervalMs;
+                pQueue->spillSizeBytes = spillSizeBytes;
+                // +1 since one byte of a ring buffer is never used
+                pQueue->pLinearBuffer = (char *) pUPortMalloc(ramSizeBytes + 1);
+                if ((pQueue->pLinearBuffer != NULL) &&
+                    (uRingBufferCreate(&(pQueue->ringBuffer), pQueue->pLinearBuffer,
+                                       ramSizeBytes + 1) == 0)) {
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    if (pSpillFileNameStr != NULL) {
+                        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                        pQueue->pSpillFileNameStr = (char *) pUPortMalloc(strlen(pSpillFileNameStr) + 1);
+                        if (pQueue->pSpillFileNameStr != NULL) {
+                            strncpy(pQueue->pSpillFileNameStr, pSpillFileNameStr,
+                                    strlen(pSpillFileNameStr) + 1);
+                            // Pick up anything left from last time
+                            queueSpillFileRecover(pContext, pQueue);
+                            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                        }
+                    }
+                    if (errorCode == 0) {
+                        errorCode = uPortEventQueueOpen(queueDrainCallback,
+                                                        "mqttQueue",
+                                                        sizeof(uMqttClientContext_t *),
+                                                        U_MQTT_CLIENT_QUEUE_TASK_STACK_SIZE_BYTES,
+                                                        U_MQTT_CLIENT_QUEUE_TASK_PRIORITY,
+                                                        U_MQTT_CLIENT_QUEUE_EVENT_QUEUE_LENGTH);
+                        if (errorCode >= 0) {
+                            pQueue->eventQueueHandle = errorCode;
+                            pContext->pQueue = pQueue;
+                            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                            // In case there's something to send already
+                            queueDrainTrigger(pContext, pQueue);
+                        }
+                    }
+                }
+                if (errorCode != 0) {
+                    // Clean up on error
+                    uRingBufferDelete(&(pQueue->ringBuffer));
+                    uPortFree(pQueue->pLinearBuffer);
+                    uPortFree(pQueue->pSpillFileNameStr);
+                    uPortFree(pQueue);
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+    }
+
+    return errorCode;
+}
+
+// Switch off the outbound queue.
+void uMqttClientSetQueueOff(uMqttClientContext_t *pContext)
+{
+    if (pContext != NULL) {
+        queueOff(pContext);
+    }
+}
+
+// Get the number of messages in the outbound queue.
+int32_t uMqttClientGetQueueCount(const uMqttClientContext_t *pContext)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    const uMqttClientQueue_t *pQueue;
+
+    if (pContext != NULL) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+
+        errorCodeOrCount = 0;
+        pQueue = (const uMqttClientQueue_t *) pContext->pQueue;
+        if (pQueue != NULL) {
+            errorCodeOrCount = (int32_t) (pQueue->ramCount + pQueue->spillCount);
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
+    }
+
+    return errorCodeOrCount;
+}
+
 // Subscribe to an MQTT topic.
 int32_t uMqttClientSubscribe(const uMqttClientContext_t *pContext,
                              const char *pTopicFilterStr,
                              uMqttQos_t maxQos)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t traceHandle = uTraceOperationStart("uMqttClientSubscribe");
+    bool traced;
 
     if ((pContext != NULL) && (pTopicFilterStr != NULL)) {
         errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
+        traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
         if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
             errorCode = uCellMqttSubscribe(pContext->devHandle,
                                            pTopicFilterStr,
@@ -517,10 +1458,15 @@ int32_t uMqttClientSubscribe(const uMqttClientContext_t *pContext,
                                            pTopicFilterStr,
                                            (uMqttQos_t)maxQos);
         }
+        if (traced) {
+            uTraceStagePop();
+        }
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
     }
 
+    uTraceOperationStop(traceHandle, errorCode);
+
     return errorCode;
 }
 
@@ -529,22 +1475,30 @@ int32_t uMqttClientUnsubscribe(const uMqttClientContext_t *pContext,
                                const char *pTopicFilterStr)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t traceHandle = uTraceOperationStart("uMqttClientUnsubscribe");
+    bool traced;
 
     if ((pContext != NULL) && (pTopicFilterStr != NULL)) {
         errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
+        traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
         if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
             errorCode = uCellMqttUnsubscribe(pContext->devHandle,
                                              pTopicFilterStr);
         } else if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_SHORT_RANGE)) {
             errorCode = uWifiMqttUnsubscribe(pContext, pTopicFilterStr);
         }
+        if (traced) {
+            uTraceStagePop();
+        }
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
     }
 
+    uTraceOperationStop(traceHandle, errorCode);
+
     return errorCode;
 }
 
@@ -557,6 +1511,8 @@ int32_t uMqttClientMessageRead(uMqttClientContext_t *pContext,
                                uMqttQos_t *pQos)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t traceHandle = uTraceOperationStart("uMqttClientMessageRead");
+    bool traced;
 
     if ((pContext != NULL) && (pTopicNameStr != NULL) &&
         (topicNameSizeBytes > 0) &&
@@ -565,6 +1521,7 @@ int32_t uMqttClientMessageRead(uMqttClientContext_t *pContext,
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) (pContext->mutexHandle));
 
+        traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
         if (U_DEVICE_IS_TYPE(pContext->devHandle, U_DEVICE_TYPE_CELL)) {
             errorCode = uCellMqttMessageRead(pContext->devHandle,
                                              pTopicNameStr,
@@ -580,6 +1537,9 @@ int32_t uMqttClientMessageRead(uMqttClientContext_t *pContext,
                                              pMessageSizeBytes,
                                              (uMqttQos_t *) pQos);
         }
+        if (traced) {
+            uTraceStagePop();
+        }
         if ((errorCode == 0) || (errorCode == (int32_t) U_ERROR_COMMON_TRUNCATED)) {
             pContext->totalMessagesReceived++;
         }
@@ -587,6 +1547,8 @@ int32_t uMqttClientMessageRead(uMqttClientContext_t *pContext,
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) (pContext->mutexHandle));
     }
 
+    uTraceOperationStop(traceHandle, errorCode);
+
     return errorCode;
 }
 
@@ -39,6 +39,7 @@
 #include "u_error_common.h"
 #include "u_device.h"
 #include "u_cell_mqtt.h"
+#include "u_cell_file.h"
 
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
@@ -165,6 +166,16 @@ U_WEAK int32_t uCellMqttSetDisconnectCallback(uDeviceHandle_t cellHandle,
     return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 }
 
+U_WEAK int32_t uCellMqttSetPublishCallback(uDeviceHandle_t cellHandle,
+                                           void (*pCallback) (int32_t, int32_t, void *),
+                                           void *pCallbackParam)
+{
+    (void) cellHandle;
+    (void) pCallback;
+    (void) pCallbackParam;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 U_WEAK bool uCellMqttIsSupported(uDeviceHandle_t cellHandle)
 {
     (void) cellHandle;
@@ -322,4 +333,46 @@ U_WEAK int32_t uCellMqttSnSetWillParameters(uDeviceHandle_t cellHandle,
     return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 }
 
+U_WEAK int32_t uCellFileWrite(uDeviceHandle_t cellHandle,
+                              const char *pFileName,
+                              const char *pData,
+                              size_t dataSize)
+{
+    (void) cellHandle;
+    (void) pFileName;
+    (void) pData;
+    (void) dataSize;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+U_WEAK int32_t uCellFileSize(uDeviceHandle_t cellHandle,
+                             const char *pFileName)
+{
+    (void) cellHandle;
+    (void) pFileName;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+U_WEAK int32_t uCellFileBlockRead(uDeviceHandle_t cellHandle,
+                                  const char *pFileName,
+                                  char *pData,
+                                  size_t offset,
+                                  size_t dataSize)
+{
+    (void) cellHandle;
+    (void) pFileName;
+    (void) pData;
+    (void) offset;
+    (void) dataSize;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+U_WEAK int32_t uCellFileDelete(uDeviceHandle_t cellHandle,
+                               const char *pFileName)
+{
+    (void) cellHandle;
+    (void) pFileName;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 // End of file
@@ -42,6 +42,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "stdlib.h"    // strtol(), qsort()
 #include "stdio.h"     // snprintf()
 #include "string.h"    // strcmp(), memcmp()
 
@@ -131,12 +132,44 @@
 # define U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES 126
 #endif
 
+#ifndef U_MQTT_CLIENT_TEST_PUBLISH_PIPELINE_COUNT
+/** The number of messages to publish back-to-back when
+ * testing asynchronous publish.
+ */
+# define U_MQTT_CLIENT_TEST_PUBLISH_PIPELINE_COUNT 3
+#endif
+
 #ifndef U_MQTT_CLIENT_TEST_READ_MESSAGE_MAX_LENGTH_BYTES
 /** Maximum length for reading a message from the broker.
  */
 # define U_MQTT_CLIENT_TEST_READ_MESSAGE_MAX_LENGTH_BYTES 1024
 #endif
 
+#ifndef U_MQTT_CLIENT_TEST_BENCHMARK_NUM
+/** The number of messages to publish at each QoS if
+ * U_MQTT_CLIENT_TEST_BENCHMARK is defined.
+ */
+# define U_MQTT_CLIENT_TEST_BENCHMARK_NUM 20
+#endif
+
+#ifndef U_MQTT_CLIENT_TEST_BENCHMARK_TIMEOUT_SECONDS
+/** How long to wait for the benchmark messages at a given QoS to
+ * be published and received back if U_MQTT_CLIENT_TEST_BENCHMARK
+ * is defined.
+ */
+# define U_MQTT_CLIENT_TEST_BENCHMARK_TIMEOUT_SECONDS 120
+#endif
+
+/** The number of characters at the start of each benchmark message
+ * that carry its sequence number.
+ */
+#define U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH 8
+
+/** The prefix for the lines of JSON benchmark results, so that they
+ * can be picked out of the log.
+ */
+#define U_MQTT_CLIENT_TEST_BENCHMARK_PREFIX "U_MQTT_CLIENT_TEST_BENCHMARK: "
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -173,6 +206,43 @@ static bool gDisconnectCallbackCalled;
  */
 static int32_t gNumUnread;
 
+/** The number of times publishCallback() has been called.
+ */
+static volatile int32_t gPublishCallbackCount;
+
+/** The number of times publishCallback() has been called
+ * with an error.
+ */
+static volatile int32_t gPublishCallbackErrorCount;
+
+/** The number of times topicCallback() has been called, indexed
+ * by its parameter.
+ */
+static volatile int32_t gTopicCallbackCount[3];
+
+/** The message size last passed to topicCallback().
+ */
+static volatile size_t gTopicCallbackMessageSizeBytes;
+
+#ifdef U_MQTT_CLIENT_TEST_BENCHMARK
+/** The time at which each benchmark message was published.
+ */
+static int32_t gBenchmarkTxTimeMs[U_MQTT_CLIENT_TEST_BENCHMARK_NUM];
+
+/** The publish-to-receive latency of each benchmark message,
+ * -1 if it has not been received.
+ */
+static volatile int32_t gBenchmarkLatencyMs[U_MQTT_CLIENT_TEST_BENCHMARK_NUM];
+
+/** The number of distinct benchmark messages received.
+ */
+static volatile int32_t gBenchmarkRxCount;
+
+/** The number of benchmark messages received more than once.
+ */
+static volatile int32_t gBenchmarkDuplicateCount;
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -259,6 +329,173 @@ static void disconnectCallback(int32_t errorCode, void *pParam)
     gDisconnectCallbackCalled = true;
 }
 
+// Callback for asynchronous publish completion.
+static void publishCallback(int32_t messageId, int32_t errorCode, void *pParam)
+{
+    (void) pParam;
+
+    U_TEST_PRINT_LINE_MQTT("publishCallback() called for message ID %d, error code %d.",
+                           messageId, errorCode);
+
+    if (errorCode != 0) {
+        gPublishCallbackErrorCount++;
+    }
+    gPublishCallbackCount++;
+}
+
+// Callback for messages matching a topic filter.
+static void topicCallback(const char *pTopicNameStr, const char *pMessage,
+                          size_t messageSizeBytes, uMqttQos_t qos, void *pParam)
+{
+    size_t index = (size_t) pParam;
+
+    (void) pMessage;
+
+    U_TEST_PRINT_LINE_MQTT("topicCallback() %d called for topic \"%s\", %d byte(s), QoS %d.",
+                           index, pTopicNameStr, messageSizeBytes, qos);
+
+    gTopicCallbackMessageSizeBytes = messageSizeBytes;
+    gTopicCallbackCount[index]++;
+}
+
+#ifdef U_MQTT_CLIENT_TEST_BENCHMARK
+
+// Callback for benchmark messages, which begin with a sequence number.
+static void benchmarkTopicCallback(const char *pTopicNameStr, const char *pMessage,
+                                   size_t messageSizeBytes, uMqttQos_t qos, void *pParam)
+{
+    int32_t rxTimeMs = uPortGetTickTimeMs();
+    char buffer[U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH + 1];
+    int32_t sequence;
+
+    (void) pTopicNameStr;
+    (void) qos;
+    (void) pParam;
+
+    if (messageSizeBytes >= U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH) {
+        memcpy(buffer, pMessage, U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH);
+        buffer[U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH] = 0;
+        sequence = strtol(buffer, NULL, 10);
+        if ((sequence >= 0) && (sequence < U_MQTT_CLIENT_TEST_BENCHMARK_NUM)) {
+            if (gBenchmarkLatencyMs[sequence] < 0) {
+                gBenchmarkLatencyMs[sequence] = rxTimeMs - gBenchmarkTxTimeMs[sequence];
+                gBenchmarkRxCount++;
+            } else {
+                gBenchmarkDuplicateCount++;
+            }
+        }
+    }
+}
+
+// Compare two int32_t's, for qsort().
+static int compareInt32(const void *p1, const void *p2)
+{
+    return *((const int32_t *) p1) - *((const int32_t *) p2);
+}
+
+// Publish U_MQTT_CLIENT_TEST_BENCHMARK_NUM messages at the given
+// QoS to pTopic, which we are subscribed to, and print how fast
+// they could be published, how long they took to come back and
+// how many were lost.
+static void benchmarkQos(uMqttClientContext_t *pContext, const char *pNetworkName,
+                         const char *pTopic, char *pMessage, uMqttQos_t qos)
+{
+    int32_t latencyMs[U_MQTT_CLIENT_TEST_BENCHMARK_NUM];
+    size_t numLatencies = 0;
+    int32_t percentile[3] = {50, 90, 99};
+    int32_t startTimeMs;
+    int32_t publishMs = -1;
+    int32_t published = 0;
+    int32_t errorCode;
+    bool async;
+    char buffer[U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH + 1];
+
+    for (size_t x = 0; x < U_MQTT_CLIENT_TEST_BENCHMARK_NUM; x++) {
+        gBenchmarkLatencyMs[x] = -1;
+    }
+    gBenchmarkRxCount = 0;
+    gBenchmarkDuplicateCount = 0;
+    gPublishCallbackCount = 0;
+    gPublishCallbackErrorCount = 0;
+    // Pipeline the publishes where that is supported
+    async = (uMqttClientSetPublishCallback(pContext, publishCallback, NULL) == 0);
+
+    U_TEST_PRINT_LINE_MQTT("benchmarking %d %s publish(es) at QoS %d...",
+                           U_MQTT_CLIENT_TEST_BENCHMARK_NUM,
+                           async ? "asynchronous" : "synchronous", qos);
+    startTimeMs = uPortGetTickTimeMs();
+    gStopTimeMs = startTimeMs + (U_MQTT_CLIENT_TEST_BENCHMARK_TIMEOUT_SECONDS * 1000);
+    for (int32_t x = 0; (x < U_MQTT_CLIENT_TEST_BENCHMARK_NUM) &&
+         (uPortGetTickTimeMs() < gStopTimeMs); x++) {
+        // Put the sequence number at the start of the message
+        snprintf(buffer, sizeof(buffer), "%0*d",
+                 U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH, (int) x);
+        memcpy(pMessage, buffer, U_MQTT_CLIENT_TEST_BENCHMARK_SEQUENCE_LENGTH);
+        do {
+            gBenchmarkTxTimeMs[x] = uPortGetTickTimeMs();
+            errorCode = uMqttClientPublish(pContext, pTopic, pMessage,
+                                           U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES,
+                                           qos, false);
+            if (errorCode == (int32_t) U_ERROR_COMMON_BUSY) {
+                // In-flight window is full, wait for a completion
+                uPortTaskBlock(10);
+            }
+        } while ((errorCode == (int32_t) U_ERROR_COMMON_BUSY) &&
+                 (uPortGetTickTimeMs() < gStopTimeMs));
+        if (errorCode >= 0) {
+            published++;
+        }
+    }
+    if (async) {
+        while ((gPublishCallbackCount < published) && (uPortGetTickTimeMs() < gStopTimeMs)) {
+            uPortTaskBlock(10);
+        }
+        published -= gPublishCallbackErrorCount;
+        U_PORT_TEST_ASSERT(uMqttClientSetPublishCallback(pContext, NULL, NULL) == 0);
+    }
+    publishMs = uPortGetTickTimeMs() - startTimeMs;
+    U_TEST_PRINT_LINE_MQTT("%d message(s) published in %d ms.", published, publishMs);
+    U_PORT_TEST_ASSERT(published > 0);
+
+    // Wait for what is coming back
+    while ((gBenchmarkRxCount < published) && (uPortGetTickTimeMs() < gStopTimeMs)) {
+        uPortTaskBlock(100);
+    }
+    // Allow a little longer for duplicates
+    uPortTaskBlock(1000);
+    U_TEST_PRINT_LINE_MQTT("%d message(s) received back, %d duplicate(s).",
+                           gBenchmarkRxCount, gBenchmarkDuplicateCount);
+    U_PORT_TEST_ASSERT(gBenchmarkRxCount > 0);
+
+    for (size_t x = 0; x < U_MQTT_CLIENT_TEST_BENCHMARK_NUM; x++) {
+        if (gBenchmarkLatencyMs[x] >= 0) {
+            latencyMs[numLatencies] = gBenchmarkLatencyMs[x];
+            numLatencies++;
+        }
+    }
+    // Nearest-rank percentiles
+    qsort(latencyMs, numLatencies, sizeof(latencyMs[0]), compareInt32);
+    for (size_t x = 0; x < sizeof(percentile) / sizeof(percentile[0]); x++) {
+        percentile[x] = latencyMs[((percentile[x] * (int32_t) numLatencies) + 99) / 100 - 1];
+    }
+    if (publishMs <= 0) {
+        publishMs = 1;
+    }
+    uPortLog(U_MQTT_CLIENT_TEST_BENCHMARK_PREFIX "{\"network\":\"%s\",\"qos\":%d,"
+             "\"async\":%s,\"messageBytes\":%d,\"num\":%d,\"published\":%d,"
+             "\"publishMs\":%d,\"publishPerSecondX10\":%d,\"received\":%d,"
+             "\"lost\":%d,\"duplicates\":%d,\"latencyMinMs\":%d,"
+             "\"latencyP50Ms\":%d,\"latencyP90Ms\":%d,\"latencyP99Ms\":%d,"
+             "\"latencyMaxMs\":%d}\n", pNetworkName, qos, async ? "true" : "false",
+             U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES, U_MQTT_CLIENT_TEST_BENCHMARK_NUM,
+             published, publishMs, (published * 10000) / publishMs, gBenchmarkRxCount,
+             U_MQTT_CLIENT_TEST_BENCHMARK_NUM - gBenchmarkRxCount, gBenchmarkDuplicateCount,
+             latencyMs[0], percentile[0], percentile[1], percentile[2],
+             latencyMs[numLatencies - 1]);
+}
+
+#endif // #ifdef U_MQTT_CLIENT_TEST_BENCHMARK
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -521,6 +758,47 @@ U_PORT_TEST_FUNCTION("[mqttClient]", "mqttClient")
                     U_TEST_PRINT_LINE_MQTT("attempting to read a message when there are none returned %d.", y);
                     U_PORT_TEST_ASSERT(y == (int32_t) U_ERROR_COMMON_EMPTY);
 
+                    // Check that messages are dispatched to topic callbacks:
+                    // one exact, one wildcard and one that should not match
+                    U_TEST_PRINT_LINE_MQTT("testing topic callbacks...");
+                    memset((void *) gTopicCallbackCount, 0, sizeof(gTopicCallbackCount));
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, pTopicOut,
+                                                                   topicCallback, (void *) 0) == 0);
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, "#",
+                                                                   topicCallback, (void *) 1) == 0);
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, "ubx_nomatch/+",
+                                                                   topicCallback, (void *) 2) == 0);
+                    // Invalid filters
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, "a/#/b",
+                                                                   topicCallback, NULL) < 0);
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, "a+",
+                                                                   topicCallback, NULL) < 0);
+                    // Can't have both kinds of callback
+                    U_PORT_TEST_ASSERT(uMqttClientSetMessageCallback(gpMqttContextA,
+                                                                     messageIndicationCallback,
+                                                                     &gNumUnread) == (int32_t) U_ERROR_COMMON_BUSY);
+                    gStopTimeMs = uPortGetTickTimeMs() + (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000);
+                    U_PORT_TEST_ASSERT(uMqttClientPublish(gpMqttContextA, pTopicOut, pMessageOut,
+                                                          U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES,
+                                                          U_MQTT_QOS_AT_LEAST_ONCE, false) == 0);
+                    startTimeMs = uPortGetTickTimeMs();
+                    while (((gTopicCallbackCount[0] == 0) || (gTopicCallbackCount[1] == 0)) &&
+                           (uPortGetTickTimeMs() - startTimeMs < (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000))) {
+                        uPortTaskBlock(100);
+                    }
+                    U_PORT_TEST_ASSERT(gTopicCallbackCount[0] == 1);
+                    U_PORT_TEST_ASSERT(gTopicCallbackCount[1] == 1);
+                    U_PORT_TEST_ASSERT(gTopicCallbackCount[2] == 0);
+                    U_PORT_TEST_ASSERT(gTopicCallbackMessageSizeBytes == U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES);
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, pTopicOut, NULL, NULL) == 0);
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, "#", NULL, NULL) == 0);
+                    U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, "ubx_nomatch/+",
+                                                                   NULL, NULL) == 0);
+                    // Put the message indication callback back
+                    U_PORT_TEST_ASSERT(uMqttClientSetMessageCallback(gpMqttContextA,
+                                                                     messageIndicationCallback,
+                                                                     &gNumUnread) == 0);
+
                     // Check that we can send an empty message with the retain flag set to true,
                     // which can be used to remove the single-allowed retained message from a topic.
                     U_TEST_PRINT_LINE_MQTT("attempting to send a NULL message with retain set.", y);
@@ -543,6 +821,40 @@ U_PORT_TEST_FUNCTION("[mqttClient]", "mqttClient")
                                   (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000);
                     U_PORT_TEST_ASSERT(uMqttClientUnsubscribe(gpMqttContextA, pTopicOut) == 0);
 
+                    // Check that publishes can be pipelined, where supported
+                    gPublishCallbackCount = 0;
+                    gPublishCallbackErrorCount = 0;
+                    y = uMqttClientSetPublishCallback(gpMqttContextA, publishCallback, NULL);
+                    if (y == 0) {
+                        U_TEST_PRINT_LINE_MQTT("publishing %d message(s) asynchronously...",
+                                               U_MQTT_CLIENT_TEST_PUBLISH_PIPELINE_COUNT);
+                        startTimeMs = uPortGetTickTimeMs();
+                        z = -1;
+                        for (size_t x = 0; x < U_MQTT_CLIENT_TEST_PUBLISH_PIPELINE_COUNT; x++) {
+                            y = uMqttClientPublish(gpMqttContextA, pTopicOut, pMessageOut,
+                                                   U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES,
+                                                   U_MQTT_QOS_AT_LEAST_ONCE, false);
+                            U_TEST_PRINT_LINE_MQTT("asynchronous publish returned %d after %d ms.", y,
+                                                   (int32_t) (uPortGetTickTimeMs() - startTimeMs));
+                            // Message IDs must be non-negative and go up
+                            U_PORT_TEST_ASSERT(y > z);
+                            z = y;
+                        }
+                        while ((gPublishCallbackCount < U_MQTT_CLIENT_TEST_PUBLISH_PIPELINE_COUNT) &&
+                               (uPortGetTickTimeMs() - startTimeMs < (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000))) {
+                            uPortTaskBlock(100);
+                        }
+                        U_TEST_PRINT_LINE_MQTT("%d asynchronous publish(es) completed after %d ms.",
+                                               gPublishCallbackCount,
+                                               (int32_t) (uPortGetTickTimeMs() - startTimeMs));
+                        U_PORT_TEST_ASSERT(gPublishCallbackCount == U_MQTT_CLIENT_TEST_PUBLISH_PIPELINE_COUNT);
+                        U_PORT_TEST_ASSERT(gPublishCallbackErrorCount == 0);
+                        U_PORT_TEST_ASSERT(uMqttClientSetPublishCallback(gpMqttContextA, NULL, NULL) == 0);
+                    } else {
+                        U_TEST_PRINT_LINE_MQTT("asynchronous publish is not supported.");
+                        U_PORT_TEST_ASSERT(y == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
+                    }
+
                     // Remove the callback
                     U_PORT_TEST_ASSERT(uMqttClientSetMessageCallback(gpMqttContextA,
                                                                      NULL, NULL) == 0);
@@ -558,6 +870,37 @@ U_PORT_TEST_FUNCTION("[mqttClient]", "mqttClient")
                         // dropped unexpectedly
                         U_PORT_TEST_ASSERT(gDisconnectCallbackCalled);
                     }
+
+                    // Check that messages published while disconnected
+                    // are queued and then sent on reconnection
+                    U_TEST_PRINT_LINE_MQTT("testing the outbound queue...");
+                    U_PORT_TEST_ASSERT(uMqttClientSetQueueOn(gpMqttContextA,
+                                                             (U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES +
+                                                              100) * 2,
+                                                             NULL, 0, 100) == 0);
+                    U_PORT_TEST_ASSERT(uMqttClientGetQueueCount(gpMqttContextA) == 0);
+                    for (size_t x = 0; x < 2; x++) {
+                        U_PORT_TEST_ASSERT(uMqttClientPublish(gpMqttContextA, pTopicOut, pMessageOut,
+                                                              U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES,
+                                                              U_MQTT_QOS_AT_LEAST_ONCE, false) == 0);
+                    }
+                    U_PORT_TEST_ASSERT(uMqttClientGetQueueCount(gpMqttContextA) == 2);
+                    y = uMqttClientGetTotalMessagesSent(gpMqttContextA);
+                    gStopTimeMs = uPortGetTickTimeMs() +
+                                  (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000);
+                    U_PORT_TEST_ASSERT(uMqttClientConnect(gpMqttContextA, &connection) == 0);
+                    startTimeMs = uPortGetTickTimeMs();
+                    while ((uMqttClientGetQueueCount(gpMqttContextA) > 0) &&
+                           (uPortGetTickTimeMs() - startTimeMs < (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000))) {
+                        uPortTaskBlock(100);
+                    }
+                    U_TEST_PRINT_LINE_MQTT("outbound queue drained after %d ms.",
+                                           (int32_t) (uPortGetTickTimeMs() - startTimeMs));
+                    U_PORT_TEST_ASSERT(uMqttClientGetQueueCount(gpMqttContextA) == 0);
+                    U_PORT_TEST_ASSERT(uMqttClientGetTotalMessagesSent(gpMqttContextA) == y + 2);
+                    uMqttClientSetQueueOff(gpMqttContextA);
+                    U_PORT_TEST_ASSERT(uMqttClientDisconnect(gpMqttContextA) == 0);
+                    uPortTaskBlock(U_CFG_OS_YIELD_MS);
                 } else {
                     if (noTls) {
                         U_TEST_PRINT_LINE_MQTT("connection failed after %d ms,"
@@ -993,6 +1336,122 @@ U_PORT_TEST_FUNCTION("[mqttClient]", "mqttClientSn")
 
 #endif // #ifndef U_CFG_TEST_MQTT_CLIENT_SN_DISABLE_CONNECTIVITY_TEST
 
+#ifdef U_MQTT_CLIENT_TEST_BENCHMARK
+/** Benchmark MQTT, only compiled if U_MQTT_CLIENT_TEST_BENCHMARK
+ * is defined: for each of QoS 0, 1 and 2, publish
+ * U_MQTT_CLIENT_TEST_BENCHMARK_NUM messages, as fast as they will
+ * go (pipelined if asynchronous publish is supported), to a topic
+ * that we are subscribed to, measuring the publish rate, the
+ * publish-to-receive latency and the number of messages lost.  The
+ * results are printed as lines of JSON, each beginning with
+ * U_MQTT_CLIENT_TEST_BENCHMARK_PREFIX, so that they can be tracked
+ * from one ubxlib release to the next.
+ */
+U_PORT_TEST_FUNCTION("[mqttClient]", "mqttClientBenchmark")
+{
+    uNetworkTestList_t *pList;
+    uDeviceHandle_t devHandle;
+    uMqttClientConnection_t connection = U_MQTT_CLIENT_CONNECTION_DEFAULT;
+    char *pTopic;
+    char *pMessage;
+    int32_t y;
+    size_t s;
+
+    // In case a previous test failed
+    uNetworkTestCleanUp();
+
+    // Do the standard preamble
+    pList = pStdPreamble(false);
+
+    // Repeat for all bearers
+    for (uNetworkTestList_t *pTmp = pList; pTmp != NULL; pTmp = pTmp->pNext) {
+        devHandle = *pTmp->pDevHandle;
+
+        // Get a unique number we can use to stop parallel
+        // tests colliding at the MQTT broker
+        U_PORT_TEST_ASSERT(uSecurityGetSerialNumber(devHandle,
+                                                    gSerialNumber) > 0);
+        pTopic = (char *) pUPortMalloc(U_MQTT_CLIENT_TEST_READ_TOPIC_MAX_LENGTH_BYTES);
+        U_PORT_TEST_ASSERT(pTopic != NULL);
+        pMessage = (char *) pUPortMalloc(U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES);
+        U_PORT_TEST_ASSERT(pMessage != NULL);
+        snprintf(pTopic, U_MQTT_CLIENT_TEST_READ_TOPIC_MAX_LENGTH_BYTES,
+                 "ubx_test/%s/benchmark", gSerialNumber);
+        // Fill the message with printable characters
+        s = 0;
+        y = U_MQTT_CLIENT_TEST_PUBLISH_MAX_LENGTH_BYTES;
+        while (y > 0) {
+            size_t z = sizeof(gSendData) - 1; // -1 to remove the terminator
+            if (z > (size_t) y) {
+                z = y;
+            }
+            memcpy(pMessage + s, gSendData, z);
+            y -= z;
+            s += z;
+        }
+
+        U_TEST_PRINT_LINE_MQTT("bringing up %s...",
+                               gpUNetworkTestTypeName[pTmp->networkType]);
+        U_PORT_TEST_ASSERT(uNetworkInterfaceUp(devHandle,
+                                               pTmp->networkType,
+                                               pTmp->pNetworkCfg) == 0);
+        gpMqttContextA = pUMqttClientOpen(devHandle, NULL);
+        U_PORT_TEST_ASSERT(gpMqttContextA != NULL);
+        connection.pBrokerNameStr = U_PORT_STRINGIFY_QUOTED(U_MQTT_CLIENT_TEST_MQTT_BROKER_URL);
+#ifdef U_MQTT_CLIENT_TEST_MQTT_USERNAME
+        connection.pUserNameStr = U_PORT_STRINGIFY_QUOTED(U_MQTT_CLIENT_TEST_MQTT_USERNAME),
+#endif
+#ifdef U_MQTT_CLIENT_TEST_MQTT_PASSWORD
+        connection.pPasswordStr = U_PORT_STRINGIFY_QUOTED(U_MQTT_CLIENT_TEST_MQTT_PASSWORD),
+#endif
+        connection.pKeepGoingCallback = keepGoingCallback;
+        U_TEST_PRINT_LINE_MQTT("connecting to \"%s\"...", connection.pBrokerNameStr);
+        gStopTimeMs = uPortGetTickTimeMs() + (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000);
+        U_PORT_TEST_ASSERT(uMqttClientConnect(gpMqttContextA, &connection) == 0);
+
+        // Loop back: subscribe at the highest QoS so that each message
+        // comes back at the QoS it was published with and have them
+        // delivered straight to a callback
+        U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, pTopic,
+                                                       benchmarkTopicCallback, NULL) == 0);
+        gStopTimeMs = uPortGetTickTimeMs() + (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000);
+        U_PORT_TEST_ASSERT(uMqttClientSubscribe(gpMqttContextA, pTopic,
+                                                U_MQTT_QOS_EXACTLY_ONCE) >= 0);
+
+        for (int32_t q = (int32_t) U_MQTT_QOS_AT_MOST_ONCE; q < (int32_t) U_MQTT_QOS_MAX_NUM; q++) {
+            benchmarkQos(gpMqttContextA, gpUNetworkTestTypeName[pTmp->networkType],
+                         pTopic, pMessage, (uMqttQos_t) q);
+        }
+
+        gStopTimeMs = uPortGetTickTimeMs() + (U_MQTT_CLIENT_RESPONSE_WAIT_SECONDS * 1000);
+        U_PORT_TEST_ASSERT(uMqttClientUnsubscribe(gpMqttContextA, pTopic) == 0);
+        U_PORT_TEST_ASSERT(uMqttClientSetTopicCallback(gpMqttContextA, pTopic, NULL, NULL) == 0);
+        U_PORT_TEST_ASSERT(uMqttClientDisconnect(gpMqttContextA) == 0);
+        uMqttClientClose(gpMqttContextA);
+        gpMqttContextA = NULL;
+        uPortEventQueueCleanUp();
+
+        U_TEST_PRINT_LINE_MQTT("taking down %s...",
+                               gpUNetworkTestTypeName[pTmp->networkType]);
+        U_PORT_TEST_ASSERT(uNetworkInterfaceDown(devHandle,
+                                                 pTmp->networkType) == 0);
+        uPortFree(pMessage);
+        uPortFree(pTopic);
+    }
+
+    // Close the devices once more and free the list
+    for (uNetworkTestList_t *pTmp = pList; pTmp != NULL; pTmp = pTmp->pNext) {
+        if (*pTmp->pDevHandle != NULL) {
+            U_TEST_PRINT_LINE_MQTT("closing device %s...",
+                                   gpUNetworkTestDeviceTypeName[pTmp->pDeviceCfg->deviceType]);
+            U_PORT_TEST_ASSERT(uDeviceClose(*pTmp->pDevHandle, false) == 0);
+            *pTmp->pDevHandle = NULL;
+        }
+    }
+    uNetworkTestListFree();
+}
+#endif // #ifdef U_MQTT_CLIENT_TEST_BENCHMARK
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
@@ -0,0 +1,210 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_NETWORK_FAILOVER_H_
+#define _U_NETWORK_FAILOVER_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+#include "u_device.h"
+#include "u_network.h"
+
+/** \addtogroup network Network
+ *  @{
+ */
+
+/** @file
+ * @brief Failover between two network interfaces, e.g. Wi-Fi as the
+ * primary and cellular as the secondary.  Both interfaces are brought
+ * up and kept up: the one not in use is a hot standby, so that when
+ * the network status callback (see uNetworkSetStatusCallback()) reports
+ * that the active interface has been lost the switch to the standby
+ * interface needs no network registration and is immediate.  A standby
+ * cellular interface may be put into 3GPP power saving (PSM), in
+ * which it remains registered with the network but draws little power.
+ *
+ * A socket or an MQTT session is bound to the device it was created
+ * on and cannot be moved while connected; the application re-homes
+ * its sessions in the failover callback, e.g.:
+ *
+ * ```
+ * static void myFailoverCallback(uDeviceHandle_t devHandle,
+ *                                uNetworkType_t netType,
+ *                                void *pCallbackParam)
+ * {
+ *     // Close the sockets/MQTT client on the old device, then:
+ *     gSock = uSockCreate(devHandle, U_SOCK_TYPE_STREAM,
+ *                         U_SOCK_PROTOCOL_TCP);
+ *     uSockConnect(gSock, &gRemoteAddress);
+ *     // ...or gpMqtt = pUMqttClientOpen(devHandle, NULL) and
+ *     // uMqttClientConnect(gpMqtt, &gConnection), etc.
+ * }
+ * ```
+ *
+ * Unlike the callback of uNetworkSetStatusCallback(), the failover
+ * callback is called from a task of this API and so MAY call other
+ * ubxlib APIs.
+ *
+ * These functions are thread-safe; there can be only one failover
+ * instance at a time.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_NETWORK_FAILOVER_TASK_STACK_SIZE_BYTES
+/** The stack size of the task in which the failover callback
+ * is called; it needs to be large enough for the callback to
+ * open sockets or an MQTT client on the new interface.
+ */
+# define U_NETWORK_FAILOVER_TASK_STACK_SIZE_BYTES (1024 * 5)
+#endif
+
+#ifndef U_NETWORK_FAILOVER_RETRY_INTERVAL_MS
+/** How long to wait between attempts to bring a lost Wi-Fi
+ * or BLE interface back up; cellular needs no help here, the
+ * module tries to regain service by itself.
+ */
+# define U_NETWORK_FAILOVER_RETRY_INTERVAL_MS 10000
+#endif
+
+#ifndef U_NETWORK_FAILOVER_PSM_ACTIVE_TIME_SECONDS
+/** The active time to request when a standby cellular interface
+ * is put into 3GPP power saving; this must be no less than
+ * U_CELL_POWER_SAVING_UART_INACTIVITY_TIMEOUT_SECONDS (see
+ * u_cell_pwr.h).
+ */
+# define U_NETWORK_FAILOVER_PSM_ACTIVE_TIME_SECONDS 60
+#endif
+
+#ifndef U_NETWORK_FAILOVER_PSM_PERIODIC_WAKEUP_SECONDS
+/** The periodic wake-up time to request when a standby cellular
+ * interface is put into 3GPP power saving.
+ */
+# define U_NETWORK_FAILOVER_PSM_PERIODIC_WAKEUP_SECONDS 3600
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** One of the two interfaces managed by the failover API.
+ */
+typedef struct {
+    uDeviceHandle_t devHandle;  /**< the device carrying the network,
+                                     as returned by uDeviceOpen(). */
+    uNetworkType_t netType;     /**< the network type, must be
+                                     #U_NETWORK_TYPE_CELL,
+                                     #U_NETWORK_TYPE_WIFI or
+                                     #U_NETWORK_TYPE_BLE. */
+    const void *pCfg;           /**< the network configuration, exactly
+                                     as for uNetworkInterfaceUp(); may
+                                     be NULL if the interface has
+                                     already been brought up. */
+    bool standbyPowerSaving;    /**< if true and netType is
+                                     #U_NETWORK_TYPE_CELL, 3GPP power
+                                     saving is requested while this
+                                     interface is the standby and
+                                     switched off while it is active;
+                                     ignored for other network
+                                     types. */
+} uNetworkFailoverInterface_t;
+
+/** Failover callback, called when the active interface changes.
+ *
+ * @param devHandle       the device carrying the interface that is
+ *                        now active.
+ * @param netType         the network type of the interface that is
+ *                        now active.
+ * @param pCallbackParam  the pCallbackParam passed to
+ *                        uNetworkFailoverStart().
+ */
+typedef void (*uNetworkFailoverCallback_t)(uDeviceHandle_t devHandle,
+                                           uNetworkType_t netType,
+                                           void *pCallbackParam);
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Start failover: bring up both interfaces, the primary then the
+ * secondary, make the primary the active interface and keep the
+ * secondary as a hot standby.  If the primary cannot be brought up
+ * but the secondary can, the secondary is made active and the primary
+ * is retried in the background (cellular is left to recover by itself).
+ * This function uses uNetworkSetStatusCallback() on both interfaces;
+ * do not set a status callback on them yourself while failover is
+ * running.
+ *
+ * @param[in] pPrimary        the preferred interface, cannot be NULL;
+ *                            the structure is copied.
+ * @param[in] pSecondary      the standby interface, cannot be NULL and
+ *                            must be a different device or network
+ *                            type to pPrimary; the structure is copied.
+ * @param failBack            if true then, when the primary interface
+ *                            returns while the secondary is active,
+ *                            the primary is made active once more.
+ * @param[in] pCallback       called when the active interface changes,
+ *                            may be NULL.
+ * @param[in] pCallbackParam  passed to pCallback, may be NULL.
+ * @return                    zero on success, else negative error code;
+ *                            #U_ERROR_COMMON_BUSY if failover is already
+ *                            running.
+ */
+int32_t uNetworkFailoverStart(const uNetworkFailoverInterface_t *pPrimary,
+                              const uNetworkFailoverInterface_t *pSecondary,
+                              bool failBack,
+                              uNetworkFailoverCallback_t pCallback,
+                              void *pCallbackParam);
+
+/** Get the interface that is currently active.
+ *
+ * @param[out] pDevHandle  a place to put the handle of the device
+ *                         carrying the active interface, may be NULL.
+ * @param[out] pNetType    a place to put the network type of the
+ *                         active interface, may be NULL.
+ * @return                 zero on success, #U_ERROR_COMMON_NOT_FOUND
+ *                         if neither interface is currently up, or
+ *                         another negative error code if failover is
+ *                         not running.
+ */
+int32_t uNetworkFailoverGetActive(uDeviceHandle_t *pDevHandle,
+                                  uNetworkType_t *pNetType);
+
+/** Stop failover: remove the status callbacks from both interfaces
+ * and free resources.  The interfaces are left as they are; take
+ * them down with uNetworkInterfaceDown() in the usual way if
+ * required.
+ */
+void uNetworkFailoverStop();
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_NETWORK_FAILOVER_H_
+
+// End of file
@@ -0,0 +1,436 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Implementation of failover between two network interfaces
+ * with one held as a hot standby.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_cfg_os_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_port_event_queue.h"
+
+#include "u_device_shared.h"
+
+#include "u_cell_net.h" // uCellNetGetActiveRat()
+#include "u_cell_pwr.h" // uCellPwrSetRequested3gppPowerSaving()
+
+#include "u_network.h"
+#include "u_network_failover.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_NETWORK_FAILOVER_TASK_PRIORITY
+/** The priority of the task in which the failover callback
+ * is called.
+ */
+# define U_NETWORK_FAILOVER_TASK_PRIORITY (U_CFG_OS_PRIORITY_MIN + 2)
+#endif
+
+#ifndef U_NETWORK_FAILOVER_QUEUE_LENGTH
+/** The number of status changes that can be queued for the
+ * failover task.
+ */
+# define U_NETWORK_FAILOVER_QUEUE_LENGTH 8
+#endif
+
+/** The interval at which a wait for a retry checks if failover
+ * is being stopped.
+ */
+#define U_NETWORK_FAILOVER_STOP_CHECK_INTERVAL_MS 100
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** The state of one of the two interfaces.
+ */
+typedef struct {
+    uNetworkFailoverInterface_t interface;
+    bool isUp;
+} uNetworkFailoverState_t;
+
+/** Everything the failover API needs to know about, index 0
+ * in the state array being the primary interface.
+ */
+typedef struct {
+    uPortMutexHandle_t mutex;
+    int32_t eventQueueHandle;
+    uNetworkFailoverState_t state[2];
+    int32_t activeIndex; // -1 if neither interface is up
+    bool failBack;
+    uNetworkFailoverCallback_t pCallback;
+    void *pCallbackParam;
+    volatile bool stopping;
+} uNetworkFailoverContext_t;
+
+/** A status change, as sent to the event queue.
+ */
+typedef struct {
+    uNetworkFailoverContext_t *pContext;
+    int32_t index;
+    bool isUp;
+} uNetworkFailoverEvent_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The one and only failover context, protected by uDeviceLock().
+ */
+static uNetworkFailoverContext_t *gpContext = NULL;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Return true if the given network type can be failed-over.
+static bool netTypeIsSupported(uNetworkType_t netType)
+{
+    return (netType == U_NETWORK_TYPE_CELL) ||
+           (netType == U_NETWORK_TYPE_WIFI) ||
+           (netType == U_NETWORK_TYPE_BLE);
+}
+
+// Request 3GPP power saving on a standby cellular interface and
+// switch it off on an active one, where the application asked
+// for that.  Errors are ignored: not all RATs support power saving.
+static void setPowerSaving(uNetworkFailoverContext_t *pContext,
+                           int32_t activeIndex)
+{
+    const uNetworkFailoverInterface_t *pInterface;
+    uCellNetRat_t rat;
+
+    for (size_t x = 0; x < sizeof(pContext->state) / sizeof(pContext->state[0]); x++) {
+        pInterface = &(pContext->state[x].interface);
+        if (pInterface->standbyPowerSaving &&
+            (pInterface->netType == U_NETWORK_TYPE_CELL)) {
+            rat = uCellNetGetActiveRat(pInterface->devHandle);
+            if (rat > U_CELL_NET_RAT_UNKNOWN_OR_NOT_USED) {
+                uCellPwrSetRequested3gppPowerSaving(pInterface->devHandle, rat,
+                                                    (int32_t) x != activeIndex,
+                                                    U_NETWORK_FAILOVER_PSM_ACTIVE_TIME_SECONDS,
+                                                    U_NETWORK_FAILOVER_PSM_PERIODIC_WAKEUP_SECONDS);
+            }
+        }
+    }
+}
+
+// Network status callback for both interfaces: this is called
+// in the context of the underlying API and so simply forwards
+// the status change to our event queue.
+static void statusCallback(uDeviceHandle_t devHandle,
+                           uNetworkType_t netType,
+                           bool isUp,
+                           uNetworkStatus_t *pStatus,
+                           void *pParameter)
+{
+    uNetworkFailoverContext_t *pContext = (uNetworkFailoverContext_t *) pParameter;
+    uNetworkFailoverEvent_t event;
+
+    (void) pStatus;
+
+    if ((pContext != NULL) && !pContext->stopping) {
+        event.pContext = pContext;
+        event.index = -1;
+        event.isUp = isUp;
+        for (size_t x = 0; x < sizeof(pContext->state) / sizeof(pContext->state[0]); x++) {
+            if ((pContext->state[x].interface.devHandle == devHandle) &&
+                (pContext->state[x].interface.netType == netType)) {
+                event.index = (int32_t) x;
+            }
+        }
+        if (event.index >= 0) {
+            uPortEventQueueSend(pContext->eventQueueHandle, &event, sizeof(event));
+        }
+    }
+}
+
+// Event handler, running in our own task, that decides which
+// interface should be active, calls the application and tries
+// to bring lost Wi-Fi and BLE interfaces back up.
+static void eventHandler(void *pParam, size_t paramLength)
+{
+    uNetworkFailoverEvent_t event = *((uNetworkFailoverEvent_t *) pParam);
+    uNetworkFailoverContext_t *pContext = event.pContext;
+    uNetworkFailoverInterface_t *pInterface = &(pContext->state[event.index].interface);
+    uNetworkFailoverInterface_t *pActiveInterface = NULL;
+    int32_t activeIndex = -1;
+    int32_t otherIndex = 1 - event.index;
+    bool retry = false;
+
+    (void) paramLength;
+
+    U_PORT_MUTEX_LOCK(pContext->mutex);
+
+    if (!pContext->stopping) {
+        pContext->state[event.index].isUp = event.isUp;
+        activeIndex = pContext->activeIndex;
+        if (event.isUp) {
+            if ((activeIndex < 0) ||
+                ((event.index == 0) && (activeIndex != 0) && pContext->failBack)) {
+                pContext->activeIndex = event.index;
+            }
+        } else {
+            if (activeIndex == event.index) {
+                pContext->activeIndex = -1;
+                if (pContext->state[otherIndex].isUp) {
+                    // The standby is already up, so this is all it takes
+                    pContext->activeIndex = otherIndex;
+                }
+            }
+            // Cellular tries to regain service by itself
+            retry = (pInterface->netType != U_NETWORK_TYPE_CELL);
+        }
+        if ((pContext->activeIndex >= 0) && (pContext->activeIndex != activeIndex)) {
+            pActiveInterface = &(pContext->state[pContext->activeIndex].interface);
+        }
+        activeIndex = pContext->activeIndex;
+    }
+
+    U_PORT_MUTEX_UNLOCK(pContext->mutex);
+
+    if (pActiveInterface != NULL) {
+        setPowerSaving(pContext, activeIndex);
+        if (pContext->pCallback != NULL) {
+            pContext->pCallback(pActiveInterface->devHandle,
+                                pActiveInterface->netType,
+                                pContext->pCallbackParam);
+        }
+    }
+
+    if (retry) {
+        for (int32_t x = 0; (x < U_NETWORK_FAILOVER_RETRY_INTERVAL_MS) && !pContext->stopping;
+             x += U_NETWORK_FAILOVER_STOP_CHECK_INTERVAL_MS) {
+            uPortTaskBlock(U_NETWORK_FAILOVER_STOP_CHECK_INTERVAL_MS);
+        }
+        if (!pContext->stopping && !pContext->state[event.index].isUp) {
+            event.isUp = (uNetworkInterfaceUp(pInterface->devHandle,
+                                              pInterface->netType, NULL) == 0);
+            if (event.isUp) {
+                // Make sure that the status callback is still attached
+                uNetworkSetStatusCallback(pInterface->devHandle, pInterface->netType,
+                                          statusCallback, pContext);
+            }
+            // Feed the result back in: on success this makes the
+            // interface available again, on failure it schedules
+            // another retry
+            if (!pContext->stopping) {
+                uPortEventQueueSend(pContext->eventQueueHandle, &event, sizeof(event));
+            }
+        }
+    }
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Start failover.
+int32_t uNetworkFailoverStart(const uNetworkFailoverInterface_t *pPrimary,
+                              const uNetworkFailoverInterface_t *pSecondary,
+                              bool failBack,
+                              uNetworkFailoverCallback_t pCallback,
+                              void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t upErrorCode = 0;
+    uNetworkFailoverContext_t *pContext = NULL;
+    const uNetworkFailoverInterface_t *pInterface;
+    uNetworkFailoverEvent_t event;
+    int32_t x;
+
+    if ((pPrimary != NULL) && (pSecondary != NULL) &&
+        netTypeIsSupported(pPrimary->netType) &&
+        netTypeIsSupported(pSecondary->netType) &&
+        ((pPrimary->devHandle != pSecondary->devHandle) ||
+         (pPrimary->netType != pSecondary->netType))) {
+        errorCode = uDeviceLock();
+        if (errorCode == 0) {
+            errorCode = (int32_t) U_ERROR_COMMON_BUSY;
+            if (gpContext == NULL) {
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                pContext = (uNetworkFailoverContext_t *) pUPortMalloc(sizeof(*pContext));
+                if (pContext != NULL) {
+                    memset(pContext, 0, sizeof(*pContext));
+                    pContext->state[0].interface = *pPrimary;
+                    pContext->state[1].interface = *pSecondary;
+                    pContext->activeIndex = -1;
+                    pContext->failBack = failBack;
+                    pContext->pCallback = pCallback;
+                    pContext->pCallbackParam = pCallbackParam;
+                    errorCode = uPortMutexCreate(&(pContext->mutex));
+                    if (errorCode == 0) {
+                        x = uPortEventQueueOpen(eventHandler, "netFailover",
+                                                sizeof(uNetworkFailoverEvent_t),
+                                                U_NETWORK_FAILOVER_TASK_STACK_SIZE_BYTES,
+                                                U_NETWORK_FAILOVER_TASK_PRIORITY,
+                                                U_NETWORK_FAILOVER_QUEUE_LENGTH);
+                        if (x >= 0) {
+                            pContext->eventQueueHandle = x;
+                            gpContext = pContext;
+                        } else {
+                            errorCode = x;
+                            uPortMutexDelete(pContext->mutex);
+                        }
+                    }
+                    if (errorCode != 0) {
+                        uPortFree(pContext);
+                        pContext = NULL;
+                    }
+                }
+            }
+            uDeviceUnlock();
+        }
+
+        if (pContext != NULL) {
+            // Bring both interfaces up, outside the device lock
+            // since the network API takes it
+            for (x = 0; x < (int32_t) (sizeof(pContext->state) / sizeof(pContext->state[0])); x++) {
+                pInterface = &(pContext->state[x].interface);
+                errorCode = uNetworkInterfaceUp(pInterface->devHandle,
+                                                pInterface->netType,
+                                                pInterface->pCfg);
+                if (errorCode == 0) {
+                    errorCode = uNetworkSetStatusCallback(pInterface->devHandle,
+                                                          pInterface->netType,
+                                                          statusCallback, pContext);
+                    U_PORT_MUTEX_LOCK(pContext->mutex);
+                    pContext->state[x].isUp = (errorCode == 0);
+                    U_PORT_MUTEX_UNLOCK(pContext->mutex);
+                }
+                if ((errorCode != 0) && (upErrorCode == 0)) {
+                    upErrorCode = errorCode;
+                }
+            }
+
+            U_PORT_MUTEX_LOCK(pContext->mutex);
+
+            if (pContext->activeIndex < 0) {
+                if (pContext->state[0].isUp) {
+                    pContext->activeIndex = 0;
+                } else if (pContext->state[1].isUp) {
+                    pContext->activeIndex = 1;
+                }
+            }
+            x = pContext->activeIndex;
+
+            U_PORT_MUTEX_UNLOCK(pContext->mutex);
+
+            errorCode = upErrorCode;
+            if (x >= 0) {
+                errorCode = 0;
+                setPowerSaving(pContext, x);
+                if (!pContext->state[0].isUp &&
+                    (pContext->state[0].interface.netType != U_NETWORK_TYPE_CELL)) {
+                    // Have the event task retry the primary
+                    event.pContext = pContext;
+                    event.index = 0;
+                    event.isUp = false;
+                    uPortEventQueueSend(pContext->eventQueueHandle, &event, sizeof(event));
+                }
+            } else {
+                uNetworkFailoverStop();
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Get the active interface.
+int32_t uNetworkFailoverGetActive(uDeviceHandle_t *pDevHandle,
+                                  uNetworkType_t *pNetType)
+{
+    int32_t errorCode = uDeviceLock();
+    const uNetworkFailoverInterface_t *pInterface;
+
+    if (errorCode == 0) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+        if (gpContext != NULL) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+
+            U_PORT_MUTEX_LOCK(gpContext->mutex);
+
+            if (gpContext->activeIndex >= 0) {
+                pInterface = &(gpContext->state[gpContext->activeIndex].interface);
+                if (pDevHandle != NULL) {
+                    *pDevHandle = pInterface->devHandle;
+                }
+                if (pNetType != NULL) {
+                    *pNetType = pInterface->netType;
+                }
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+
+            U_PORT_MUTEX_UNLOCK(gpContext->mutex);
+        }
+        uDeviceUnlock();
+    }
+
+    return errorCode;
+}
+
+// Stop failover.
+void uNetworkFailoverStop()
+{
+    uNetworkFailoverContext_t *pContext = NULL;
+    const uNetworkFailoverInterface_t *pInterface;
+
+    if (uDeviceLock() == 0) {
+        pContext = gpContext;
+        gpContext = NULL;
+        uDeviceUnlock();
+    }
+
+    if (pContext != NULL) {
+        U_PORT_MUTEX_LOCK(pContext->mutex);
+        pContext->stopping = true;
+        U_PORT_MUTEX_UNLOCK(pContext->mutex);
+        for (size_t x = 0; x < sizeof(pContext->state) / sizeof(pContext->state[0]); x++) {
+            pInterface = &(pContext->state[x].interface);
+            uNetworkSetStatusCallback(pInterface->devHandle, pInterface->netType,
+                                      NULL, NULL);
+        }
+        // This waits for the event task to finish
+        uPortEventQueueClose(pContext->eventQueueHandle);
+        uPortMutexDelete(pContext->mutex);
+        uPortFree(pContext);
+    }
+}
+
+// End of file
@@ -37,6 +37,7 @@
 #include "u_network.h"
 #include "u_network_config_cell.h"
 #include "u_network_private_cell.h"
+#include "u_cell_net.h"
 
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
@@ -171,6 +172,26 @@ U_WEAK int32_t uCellCfgGetGnssProfile(uDeviceHandle_t cellHandle,
     return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 }
 
+U_WEAK uCellNetRat_t uCellNetGetActiveRat(uDeviceHandle_t cellHandle)
+{
+    (void) cellHandle;
+    return (uCellNetRat_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+U_WEAK int32_t uCellPwrSetRequested3gppPowerSaving(uDeviceHandle_t cellHandle,
+                                                   uCellNetRat_t rat,
+                                                   bool onNotOff,
+                                                   int32_t activeTimeSeconds,
+                                                   int32_t periodicWakeupSeconds)
+{
+    (void) cellHandle;
+    (void) rat;
+    (void) onNotOff;
+    (void) activeTimeSeconds;
+    (void) periodicWakeupSeconds;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 // End of file
 
 
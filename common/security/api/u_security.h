@@ -64,6 +64,37 @@ extern "C" {
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The items that may be read by uSecurityZtpRead(), in the order
+ * in which they are read.
+ */
+typedef enum {
+    U_SECURITY_ZTP_ITEM_DEVICE_CERTIFICATE = 0,
+    U_SECURITY_ZTP_ITEM_PRIVATE_KEY = 1,
+    U_SECURITY_ZTP_ITEM_CERTIFICATE_AUTHORITIES = 2,
+    U_SECURITY_ZTP_ITEM_MAX_NUM
+} uSecurityZtpItem_t;
+
+/** Callback for uSecurityZtpRead(), called with each chunk of
+ * each ZTP item.
+ *
+ * @param devHandle       the handle of the device.
+ * @param item            the item the chunk belongs to.
+ * @param[in] pData       the chunk of data in PEM format, NOT
+ *                        null-terminated; this is only valid for
+ *                        the duration of the callback, copy it if
+ *                        it is needed afterwards.
+ * @param size            the number of bytes at pData, may be zero.
+ * @param isLast          true if this is the last chunk of the item.
+ * @param pCallbackParam  the pCallbackParam passed to
+ *                        uSecurityZtpRead().
+ */
+typedef void (*uSecurityZtpCallback_t)(uDeviceHandle_t devHandle,
+                                       uSecurityZtpItem_t item,
+                                       const char *pData,
+                                       size_t size,
+                                       bool isLast,
+                                       void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: INFORMATION
  * -------------------------------------------------------------- */
@@ -307,6 +338,40 @@ int32_t uSecurityZtpGetCertificateAuthorities(uDeviceHandle_t devHandle,
                                               char *pData,
                                               size_t dataSizeBytes);
 
+/** Read all of the ZTP items, i.e. the device public certificate,
+ * the device private key and the certificate authorities, in that
+ * order, streaming each of them to pCallback in chunks.  This
+ * is quicker than calling uSecurityZtpGetDeviceCertificate(),
+ * uSecurityZtpGetPrivateKey() and
+ * uSecurityZtpGetCertificateAuthorities() twice each (once for
+ * the size and once for the data) and needs no storage for the
+ * items: the chunks are passed to pCallback directly from the
+ * receive buffer of the interface to the module, so that, for
+ * instance, the certificates can be written straight to a secure
+ * store or handed to a TLS stack as they arrive.  This feature is
+ * only supported if the Zero Touch Provisioning feature is enabled
+ * for your module.
+ *
+ * pCallback is called from within this API with the interface to
+ * the module locked: it must not call any other API of the device.
+ *
+ * In order to avoid character loss it is recommended that
+ * flow control lines are connected on the interface to the
+ * module.
+ *
+ * @param devHandle           the handle of the instance to be used,
+ *                            for example obtained using uDeviceOpen().
+ * @param[in] pCallback       the callback that will receive the
+ *                            data; cannot be NULL.
+ * @param[in] pCallbackParam  passed to pCallback, may be NULL.
+ * @return                    on success the total number of bytes
+ *                            passed to pCallback, else negative
+ *                            error code.
+ */
+int32_t uSecurityZtpRead(uDeviceHandle_t devHandle,
+                         uSecurityZtpCallback_t pCallback,
+                         void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: PRE-SHARED KEY GENERATION
  * -------------------------------------------------------------- */
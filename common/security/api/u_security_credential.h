@@ -88,6 +88,10 @@ extern "C" {
  */
 #define U_SECURITY_CREDENTIAL_MD5_LENGTH_BYTES 16
 
+/** The length of a SHA-256 hash.
+ */
+#define U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES 32
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -124,6 +128,20 @@ typedef struct {
     int64_t expirationUtc;
 } uSecurityCredential_t;
 
+/** The fingerprint of a stored security credential, as populated
+ * by uSecurityCredentialStoreIfChanged(); the application may keep
+ * this in non-volatile storage so that an unchanged credential need
+ * not be uploaded to the module again, e.g. at every boot.
+ */
+typedef struct {
+    /** The SHA-256 hash of the credential contents (and password,
+        if there is one) exactly as given to the module. */
+    char sha256[U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES];
+    /** The MD5 hash of the DER-format credential as reported by
+        the module when it was stored. */
+    char md5[U_SECURITY_CREDENTIAL_MD5_LENGTH_BYTES];
+} uSecurityCredentialFingerprint_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -224,6 +242,49 @@ int32_t uSecurityCredentialStore(uDeviceHandle_t devHandle,
                                  const char *pPassword,
                                  char *pMd5);
 
+/** As uSecurityCredentialStore() but the X.509 certificate or security
+ * key is only uploaded to the module if it is not already there.
+ * The SHA-256 hash of pContents (and pPassword) is compared with that
+ * in *pFingerprint and, if they match, the MD5 hash of the credential
+ * currently stored in the module under pName is read and compared with
+ * that in *pFingerprint; only if either differs is the credential
+ * uploaded, after which *pFingerprint is updated.  Reading the MD5
+ * hash is a single, short, AT command, hence this saves the time taken
+ * to upload an unchanged credential; the module can only report an
+ * MD5 hash of the DER-format credential it holds, which cannot be
+ * compared directly with a PEM-format credential on the host, which is
+ * why the fingerprint is required.
+ *
+ * @param devHandle              the handle of the instance to be used,
+ *                               for example obtained using uDeviceOpen().
+ * @param type                   the type of credential to be stored.
+ * @param pName                  the null-terminated name for the
+ *                               X.509 certificate or security key, as
+ *                               for uSecurityCredentialStore().
+ * @param pContents              a pointer to the X.509 certificate or
+ *                               security key to be stored; cannot be NULL.
+ * @param size                   the number of bytes at pContents,
+ *                               maximum value
+ *                               #U_SECURITY_CREDENTIAL_MAX_LENGTH_BYTES.
+ * @param pPassword              the password for a PKCS8 encrypted private
+ *                               key, as for uSecurityCredentialStore();
+ *                               may be NULL.
+ * @param[in,out] pFingerprint   the fingerprint from a previous call for
+ *                               this credential, which will be updated if
+ *                               the credential is stored; if there was no
+ *                               previous call, zero it.  Cannot be NULL.
+ * @return                       zero if the credential was stored, 1 if
+ *                               the credential was unchanged and so was
+ *                               not stored, else negative error code.
+ */
+int32_t uSecurityCredentialStoreIfChanged(uDeviceHandle_t devHandle,
+                                          uSecurityCredentialType_t type,
+                                          const char *pName,
+                                          const char *pContents,
+                                          size_t size,
+                                          const char *pPassword,
+                                          uSecurityCredentialFingerprint_t *pFingerprint);
+
 /** As uSecurityCredentialStore() but can be used ONLY with cellular modules
  * where you have already stored a certificate in the file system of the
  * cellular module and you want to import that certificate into the security
@@ -357,8 +357,12 @@ typedef struct {
                            negotiation, maximum length #U_SECURITY_TLS_SNI_MAX_LENGTH_BYTES;
                            this is optional on cellular modules while for Wifi modules it
                            is set automatically if the connect string is a URL. */
-    bool enableSessionResumption; /**< set to true to enable session resumption; currently
-                                       only false is supported. */
+    bool enableSessionResumption; /**< set to true to enable TLS session resumption,
+                                       where the module supports it, which avoids
+                                       a full handshake when reconnecting to the
+                                       same server; supported on cellular modules
+                                       only, see the AT+USECPRF=13 command in the
+                                       AT manual for your module. */
     bool useDeviceCertificate; /**< if this is set to true then pClientCertificateName should
                                     be set to NULL and instead, for a module that supports
                                     u-blox security and has been security sealed, the device
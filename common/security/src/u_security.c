@@ -85,6 +85,12 @@
  *                                             char *pData,
  *                                             size_t dataSizeBytes);
  *
+ * Read all of the ZTP items in chunks (optional):
+ *
+ * int32_t uXxxSecZtpRead(int32_t handle,
+ *                        uXxxSecZtpCallback_t pCallback,
+ *                        void *pCallbackParam);
+ *
  * Perform end to end encryption on a block of data (optional):
  *
  * Trigger a security heartbeat (optional):
@@ -121,6 +127,13 @@
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Context for ztpCallback().
+ */
+typedef struct {
+    uSecurityZtpCallback_t pCallback;
+    void *pCallbackParam;
+} uSecurityZtpContext_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -129,6 +142,18 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Callback for uCellSecZtpRead(), passes the chunk on to the
+// callback of uSecurityZtpRead().
+static void ztpCallback(uDeviceHandle_t devHandle, int32_t item,
+                        const char *pData, size_t size, bool isLast,
+                        void *pCallbackParam)
+{
+    uSecurityZtpContext_t *pContext = (uSecurityZtpContext_t *) pCallbackParam;
+
+    pContext->pCallback(devHandle, (uSecurityZtpItem_t) item,
+                        pData, size, isLast, pContext->pCallbackParam);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: INFORMATION
  * -------------------------------------------------------------- */
@@ -287,6 +312,26 @@ int32_t uSecurityZtpGetCertificateAuthorities(uDeviceHandle_t devHandle,
     return errorCodeOrSize;
 }
 
+// Read all of the ZTP items in chunks.
+int32_t uSecurityZtpRead(uDeviceHandle_t devHandle,
+                         uSecurityZtpCallback_t pCallback,
+                         void *pCallbackParam)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uSecurityZtpContext_t context;
+
+    if (pCallback != NULL) {
+        errorCodeOrSize = (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED;
+        if (U_DEVICE_IS_TYPE(devHandle, U_DEVICE_TYPE_CELL)) {
+            context.pCallback = pCallback;
+            context.pCallbackParam = pCallbackParam;
+            errorCodeOrSize = uCellSecZtpRead(devHandle, ztpCallback, &context);
+        }
+    }
+
+    return errorCodeOrSize;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: PRE-SHARED KEY GENERATION
  * -------------------------------------------------------------- */
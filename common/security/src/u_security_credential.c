@@ -36,7 +36,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // strlen(), strtol()
+#include "string.h"    // strlen(), strtol(), memcpy(), memcmp()
 #include "time.h"      // struct tm
 #include "ctype.h"     // isprint(), isblank()
 
@@ -49,6 +49,7 @@
 #include "u_port.h"
 #include "u_port_os.h"
 #include "u_port_heap.h"
+#include "u_port_crypto.h"
 
 #include "u_at_client.h"
 
@@ -317,6 +318,30 @@ static size_t stripWhitespace(char *pString, size_t stringLength)
     return newLength;
 }
 
+// Work out the SHA-256 hash of the contents of a credential
+// and, if there is one, its password.
+static int32_t contentsSha256(const char *pContents, size_t size,
+                              const char *pPassword, char *pSha256)
+{
+    int32_t errorCode = uPortCryptoSha256(pContents, size, pSha256);
+    char buffer[U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES +
+                U_SECURITY_CREDENTIAL_PASSWORD_MAX_LENGTH_BYTES];
+    size_t passwordLength;
+
+    if ((errorCode == 0) && (pPassword != NULL)) {
+        // Fold the password in so that a change of
+        // password alone also counts as a change
+        passwordLength = strlen(pPassword);
+        memcpy(buffer, pSha256, U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES);
+        memcpy(buffer + U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES, pPassword, passwordLength);
+        errorCode = uPortCryptoSha256(buffer,
+                                      U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES + passwordLength,
+                                      pSha256);
+    }
+
+    return errorCode;
+}
+
 // Store an X.509 certificate or security key from buffer or file.
 static int32_t securityCredentialStoreOrImport(uDeviceHandle_t devHandle,
                                                uSecurityCredentialType_t type,
@@ -441,6 +466,48 @@ int32_t uSecurityCredentialStore(uDeviceHandle_t devHandle,
                                            pPassword, pMd5);
 }
 
+// Store the given X.509 certificate or security key only if it
+// is not already there.
+int32_t uSecurityCredentialStoreIfChanged(uDeviceHandle_t devHandle,
+                                          uSecurityCredentialType_t type,
+                                          const char *pName,
+                                          const char *pContents,
+                                          size_t size,
+                                          const char *pPassword,
+                                          uSecurityCredentialFingerprint_t *pFingerprint)
+{
+    int32_t errorCodeOrUnchanged = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    char sha256[U_SECURITY_CREDENTIAL_SHA256_LENGTH_BYTES];
+    char md5[U_SECURITY_CREDENTIAL_MD5_LENGTH_BYTES];
+
+    // The remaining parameters are checked by uSecurityCredentialStore()
+    if ((pContents != NULL) && (size > 0) &&
+        (size <= U_SECURITY_CREDENTIAL_MAX_LENGTH_BYTES) &&
+        ((pPassword == NULL) ||
+         (strlen(pPassword) <= U_SECURITY_CREDENTIAL_PASSWORD_MAX_LENGTH_BYTES)) &&
+        (pFingerprint != NULL)) {
+        errorCodeOrUnchanged = contentsSha256(pContents, size, pPassword, sha256);
+        if (errorCodeOrUnchanged == 0) {
+            if ((memcmp(sha256, pFingerprint->sha256, sizeof(sha256)) == 0) &&
+                (uSecurityCredentialGetHash(devHandle, type, pName, md5) == 0) &&
+                (memcmp(md5, pFingerprint->md5, sizeof(md5)) == 0)) {
+                // The module already has this credential
+                errorCodeOrUnchanged = 1;
+            } else {
+                errorCodeOrUnchanged = uSecurityCredentialStore(devHandle, type, pName,
+                                                                pContents, size,
+                                                                pPassword, md5);
+                if (errorCodeOrUnchanged == 0) {
+                    memcpy(pFingerprint->sha256, sha256, sizeof(pFingerprint->sha256));
+                    memcpy(pFingerprint->md5, md5, sizeof(pFingerprint->md5));
+                }
+            }
+        }
+    }
+
+    return errorCodeOrUnchanged;
+}
+
 // Import the given X.509 certificate or security key from a file.
 int32_t uSecurityCredentialImportFromFile(uDeviceHandle_t devHandle,
                                           uSecurityCredentialType_t type,
@@ -121,6 +121,16 @@ U_WEAK int32_t uCellSecZtpGetCertificateAuthorities(uDeviceHandle_t cellHandle,
     return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 }
 
+U_WEAK int32_t uCellSecZtpRead(uDeviceHandle_t cellHandle,
+                               uCellSecZtpCallback_t pCallback,
+                               void *pCallbackParam)
+{
+    (void) cellHandle;
+    (void) pCallback;
+    (void) pCallbackParam;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 U_WEAK int32_t uCellSecPskGenerate(uDeviceHandle_t cellHandle,
                                    size_t pskSizeBytes, char *pPsk,
                                    char *pPskId)
@@ -110,14 +110,76 @@ static bool checkConfig(const uSecurityTlsSettings_t *pSettings)
          (strlen(pSettings->pExpectedServerUrl) <=
           U_SECURITY_TLS_EXPECTED_SERVER_URL_MAX_LENGTH_BYTES)) &&
         ((pSettings->pSni == NULL) || (strlen(pSettings->pSni) <=
-                                       U_SECURITY_TLS_SNI_MAX_LENGTH_BYTES)) &&
-        !pSettings->enableSessionResumption) {
+                                       U_SECURITY_TLS_SNI_MAX_LENGTH_BYTES))) {
         isGood = true;
     }
 
     return isGood;
 }
 
+// Add a sequence of bytes to an FNV-1a hash.
+static uint32_t hashAdd(uint32_t hash, const void *pData, size_t size)
+{
+    const uint8_t *pByte = (const uint8_t *) pData;
+
+    for (size_t x = 0; x < size; x++) {
+        hash ^= *(pByte + x);
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+// Add a string, which may be NULL, to an FNV-1a hash.
+static uint32_t hashAddString(uint32_t hash, const char *pString)
+{
+    // Include the terminator so that the boundary between
+    // strings counts, and mark NULL as different to empty
+    if (pString != NULL) {
+        hash = hashAdd(hash, pString, strlen(pString) + 1);
+    } else {
+        hash = hashAdd(hash, "\xff", 1);
+    }
+
+    return hash;
+}
+
+// Work out a key that identifies the complete set of settings
+// that would be applied to a cellular security profile.
+static uint32_t settingsKeyGet(const uSecurityTlsSettings_t *pSettings)
+{
+    uint32_t hash = 2166136261UL;
+    int32_t value[7];
+
+    value[0] = (int32_t) pSettings->tlsVersionMin;
+    value[1] = (int32_t) pSettings->certificateCheck;
+    value[2] = (int32_t) pSettings->pskGeneratedByRoT;
+    value[3] = (int32_t) pSettings->enableSessionResumption;
+    value[4] = (int32_t) pSettings->useDeviceCertificate;
+    value[5] = (int32_t) pSettings->includeCaCertificates;
+    value[6] = (int32_t) pSettings->cipherSuites.num;
+    hash = hashAdd(hash, value, sizeof(value));
+    hash = hashAdd(hash, pSettings->cipherSuites.suite,
+                   pSettings->cipherSuites.num * sizeof(pSettings->cipherSuites.suite[0]));
+    hash = hashAddString(hash, pSettings->pRootCaCertificateName);
+    hash = hashAddString(hash, pSettings->pClientCertificateName);
+    hash = hashAddString(hash, pSettings->pClientPrivateKeyName);
+    hash = hashAddString(hash, pSettings->pClientPrivateKeyPassword);
+    hash = hashAddString(hash, pSettings->pExpectedServerUrl);
+    hash = hashAddString(hash, pSettings->pSni);
+    value[0] = (int32_t) pSettings->psk.size;
+    value[1] = (int32_t) pSettings->pskId.size;
+    hash = hashAdd(hash, value, sizeof(value[0]) * 2);
+    if (pSettings->psk.pBin != NULL) {
+        hash = hashAdd(hash, pSettings->psk.pBin, pSettings->psk.size);
+    }
+    if (pSettings->pskId.pBin != NULL) {
+        hash = hashAdd(hash, pSettings->pskId.pBin, pSettings->pskId.size);
+    }
+
+    return hash;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -133,6 +195,8 @@ uSecurityTlsContext_t *pUSecurityTlsAdd(uDeviceHandle_t devHandle,
     const char *pClientCertificateName = NULL;
     const char *pClientPrivateKeyName = NULL;
     bool certificateCheckOn = false;
+    bool profileIsConfigured = false;
+    uint32_t settingsKey = 0;
     uSecurityTlsVersion_t tlsVersionMin = U_SECURITY_TLS_VERSION_ANY;
 
     if ((errorCode == 0) && (pContext != NULL)) {
@@ -175,13 +239,22 @@ uSecurityTlsContext_t *pUSecurityTlsAdd(uDeviceHandle_t devHandle,
                 }
             } else if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
                 errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-                // Allocate a cellular security context with
-                // default settings
-                pNetworkSpecific = (void *) pUCellSecSecTlsAdd(devHandle);
+                if (pSettings != NULL) {
+                    // Allocate a cellular security context, re-using
+                    // a profile already configured with these settings
+                    // if there is one, saving the AT commands
+                    settingsKey = settingsKeyGet(pSettings);
+                    pNetworkSpecific = (void *) pUCellSecSecTlsAddCached(devHandle, settingsKey,
+                                                                         &profileIsConfigured);
+                } else {
+                    // Allocate a cellular security context with
+                    // default settings
+                    pNetworkSpecific = (void *) pUCellSecSecTlsAdd(devHandle);
+                }
                 if (pNetworkSpecific == NULL) {
                     errorCode = uCellSecTlsResetLastError();
                 } else {
-                    if (pSettings != NULL) {
+                    if ((pSettings != NULL) && !profileIsConfigured) {
                         // Looks like some specific settings have been
                         // requested: set them
                         if (pSettings->tlsVersionMin != U_SECURITY_TLS_VERSION_ANY) {
@@ -245,6 +318,17 @@ uSecurityTlsContext_t *pUSecurityTlsAdd(uDeviceHandle_t devHandle,
                             errorCode = uCellSecTlsUseDeviceCertificateSet((uCellSecTlsContext_t *) pNetworkSpecific,
                                                                            pSettings->includeCaCertificates);
                         }
+                        if ((errorCode == 0) && (pSettings->enableSessionResumption)) {
+                            // Switch on TLS session resumption
+                            errorCode = uCellSecTlsSessionResumptionSet((uCellSecTlsContext_t *) pNetworkSpecific,
+                                                                        true);
+                        }
+                        if (errorCode == 0) {
+                            // Remember that the profile is now configured
+                            // with these settings so that it can be re-used
+                            uCellSecTlsSettingsKeySet((uCellSecTlsContext_t *) pNetworkSpecific,
+                                                      settingsKey);
+                        }
                     }
                 }
             } else if (devType < 0) {
@@ -51,6 +51,24 @@ U_WEAK uCellSecTlsContext_t *pUCellSecSecTlsAdd(uDeviceHandle_t cellHandle)
     return NULL;
 }
 
+U_WEAK uCellSecTlsContext_t *pUCellSecSecTlsAddCached(uDeviceHandle_t cellHandle,
+                                                      uint32_t settingsKey,
+                                                      bool *pIsConfigured)
+{
+    (void) cellHandle;
+    (void) settingsKey;
+    (void) pIsConfigured;
+    return NULL;
+}
+
+U_WEAK int32_t uCellSecTlsSettingsKeySet(const uCellSecTlsContext_t *pContext,
+                                         uint32_t settingsKey)
+{
+    (void) pContext;
+    (void) settingsKey;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 U_WEAK void uCellSecTlsRemove(uCellSecTlsContext_t *pContext)
 {
     (void) pContext;
@@ -109,6 +127,14 @@ U_WEAK int32_t uCellSecTlsUseDeviceCertificateSet(const uCellSecTlsContext_t *pC
     return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
 }
 
+U_WEAK int32_t uCellSecTlsSessionResumptionSet(const uCellSecTlsContext_t *pContext,
+                                               bool onNotOff)
+{
+    (void) pContext;
+    (void) onNotOff;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 U_WEAK int32_t uCellSecTlsCipherSuiteAdd(const uCellSecTlsContext_t *pContext,
                                          int32_t ianaNumber)
 {
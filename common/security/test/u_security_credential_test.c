@@ -32,7 +32,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // strcmp()
+#include "string.h"    // strcmp(), memset(), memcmp()
 
 #include "u_cfg_sw.h"
 #include "u_cfg_app_platform_specific.h"
@@ -214,6 +214,7 @@ U_PORT_TEST_FUNCTION("[securityCredential]", "securityCredentialTest")
     uDeviceHandle_t devHandle = NULL;
     int32_t resourceCount;
     uSecurityCredential_t credential;
+    uSecurityCredentialFingerprint_t fingerprint;
     int32_t otherCredentialCount;
     int32_t z;
     char hash[U_SECURITY_CREDENTIAL_MD5_LENGTH_BYTES];
@@ -295,6 +296,31 @@ U_PORT_TEST_FUNCTION("[securityCredential]", "securityCredentialTest")
             U_PORT_TEST_ASSERT((uint8_t) buffer[y] == hash[y]);
         }
 
+        // Check that storing only if changed skips an unchanged certificate
+        U_TEST_PRINT_LINE_X("storing certificate only if changed...", x);
+        memset(&fingerprint, 0, sizeof(fingerprint));
+        U_PORT_TEST_ASSERT(uSecurityCredentialStoreIfChanged(devHandle,
+                                                             U_SECURITY_CREDENTIAL_CLIENT_X509,
+                                                             "ubxlib_test_cert",
+                                                             (const char *) gUSecurityCredentialTestClientX509Pem,
+                                                             gUSecurityCredentialTestClientX509PemSize,
+                                                             NULL, &fingerprint) == 0);
+        U_PORT_TEST_ASSERT(memcmp(fingerprint.md5, hash, sizeof(fingerprint.md5)) == 0);
+        U_PORT_TEST_ASSERT(uSecurityCredentialStoreIfChanged(devHandle,
+                                                             U_SECURITY_CREDENTIAL_CLIENT_X509,
+                                                             "ubxlib_test_cert",
+                                                             (const char *) gUSecurityCredentialTestClientX509Pem,
+                                                             gUSecurityCredentialTestClientX509PemSize,
+                                                             NULL, &fingerprint) == 1);
+        // A different fingerprint must cause the certificate to be stored
+        fingerprint.sha256[0] = (char) ~fingerprint.sha256[0];
+        U_PORT_TEST_ASSERT(uSecurityCredentialStoreIfChanged(devHandle,
+                                                             U_SECURITY_CREDENTIAL_CLIENT_X509,
+                                                             "ubxlib_test_cert",
+                                                             (const char *) gUSecurityCredentialTestClientX509Pem,
+                                                             gUSecurityCredentialTestClientX509PemSize,
+                                                             NULL, &fingerprint) == 0);
+
         // Check that the certificate is listed
         U_TEST_PRINT_LINE_X("listing credentials...", x);
         z = 0;
@@ -115,6 +115,26 @@ static bool keepGoingCallback()
 }
 #endif
 
+// Callback for uSecurityZtpRead(): add up the size of each item.
+static void ztpReadCallback(uDeviceHandle_t devHandle,
+                            uSecurityZtpItem_t item,
+                            const char *pData, size_t size,
+                            bool isLast, void *pCallbackParam)
+{
+    int32_t *pSize = (int32_t *) pCallbackParam;
+
+    (void) devHandle;
+    (void) pData;
+    U_PORT_TEST_ASSERT(item < U_SECURITY_ZTP_ITEM_MAX_NUM);
+    // Once the last chunk has arrived the size goes
+    // negative so that we can tell
+    U_PORT_TEST_ASSERT(*(pSize + item) >= 0);
+    *(pSize + item) += (int32_t) size;
+    if (isLast) {
+        *(pSize + item) = -*(pSize + item) - 1;
+    }
+}
+
 // Standard preamble for all security tests
 static uNetworkTestList_t *pStdPreamble()
 {
@@ -428,6 +448,8 @@ U_PORT_TEST_FUNCTION("[security]", "securityZtp")
     int32_t z;
     int32_t resourceCount;
     char *pData;
+    int32_t itemSize[U_SECURITY_ZTP_ITEM_MAX_NUM];
+    int32_t streamedSize[U_SECURITY_ZTP_ITEM_MAX_NUM];
 
     // In case a previous test failed
     uNetworkTestCleanUp();
@@ -452,6 +474,7 @@ U_PORT_TEST_FUNCTION("[security]", "securityZtp")
             U_TEST_PRINT_LINE("waiting for seal status...");
             if (uSecurityIsSealed(devHandle)) {
                 U_TEST_PRINT_LINE("device is sealed.");
+                memset(itemSize, 0, sizeof(itemSize));
 
                 // First get the size of the device public certificate
                 y = uSecurityZtpGetDeviceCertificate(devHandle, NULL, 0);
@@ -466,6 +489,7 @@ U_PORT_TEST_FUNCTION("[security]", "securityZtp")
                     U_TEST_PRINT_LINE("getting device public X.509 certificate...", y);
                     z = uSecurityZtpGetDeviceCertificate(devHandle, pData, y);
                     U_PORT_TEST_ASSERT(z == y);
+                    itemSize[U_SECURITY_ZTP_ITEM_DEVICE_CERTIFICATE] = z - 1;
                     // Can't really check the data but can check that it is
                     // of the correct length
                     U_PORT_TEST_ASSERT((int32_t)strlen(pData) == z - 1);
@@ -487,6 +511,7 @@ U_PORT_TEST_FUNCTION("[security]", "securityZtp")
                     U_TEST_PRINT_LINE("getting private key...", y);
                     z = uSecurityZtpGetPrivateKey(devHandle, pData, y);
                     U_PORT_TEST_ASSERT(z == y);
+                    itemSize[U_SECURITY_ZTP_ITEM_PRIVATE_KEY] = z - 1;
                     // Can't really check the data but can check that it is
                     // of the correct length
                     U_PORT_TEST_ASSERT((int32_t)strlen(pData) == z - 1);
@@ -508,6 +533,7 @@ U_PORT_TEST_FUNCTION("[security]", "securityZtp")
                     U_TEST_PRINT_LINE("getting X.509 certificate authorities...", y);
                     z = uSecurityZtpGetCertificateAuthorities(devHandle, pData, y);
                     U_PORT_TEST_ASSERT(z == y);
+                    itemSize[U_SECURITY_ZTP_ITEM_CERTIFICATE_AUTHORITIES] = z - 1;
                     // Can't really check the data but can check that it is
                     // of the correct length
                     U_PORT_TEST_ASSERT((int32_t)strlen(pData) == z - 1);
@@ -515,6 +541,24 @@ U_PORT_TEST_FUNCTION("[security]", "securityZtp")
                 } else {
                     U_TEST_PRINT_LINE("module does not support reading certificate authorities.");
                 }
+
+                // Now read all of them in one go
+                memset(streamedSize, 0, sizeof(streamedSize));
+                U_TEST_PRINT_LINE("reading all ZTP items in one go...");
+                y = uSecurityZtpRead(devHandle, ztpReadCallback, streamedSize);
+                U_TEST_PRINT_LINE("%d byte(s) read.", y);
+                U_PORT_TEST_ASSERT((y >= 0) || (y == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED));
+                if (y >= 0) {
+                    z = 0;
+                    for (size_t x = 0; x < U_SECURITY_ZTP_ITEM_MAX_NUM; x++) {
+                        // All items must have been completed
+                        U_PORT_TEST_ASSERT(streamedSize[x] < 0);
+                        streamedSize[x] = -streamedSize[x] - 1;
+                        U_PORT_TEST_ASSERT(streamedSize[x] == itemSize[x]);
+                        z += streamedSize[x];
+                    }
+                    U_PORT_TEST_ASSERT(z == y);
+                }
             } else {
                 U_TEST_PRINT_LINE("this device supports u-blox security but has"
                                   " not been security sealed, no testing of reading"
@@ -42,6 +42,37 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_SHORT_RANGE_EDM_STREAM_MAX_NUM
+/** The maximum number of EDM streams that may be open at any
+ * one time, i.e. the number of short range modules that may
+ * be used at once; each stream has its own parser, memory pool
+ * and event queue.
+ */
+# define U_SHORT_RANGE_EDM_STREAM_MAX_NUM 2
+#endif
+
+/** The number of bytes that must be free in front of the data
+ * passed to uShortRangeEdmStreamWriteZeroCopy(), the size of an
+ * EDM data packet header.
+ */
+#define U_SHORT_RANGE_EDM_STREAM_WRITE_HEADROOM_BYTES 6
+
+/** The number of bytes that must be free after the data passed
+ * to uShortRangeEdmStreamWriteZeroCopy(), the size of an EDM
+ * packet tail.
+ */
+#define U_SHORT_RANGE_EDM_STREAM_WRITE_TAILROOM_BYTES 1
+
+#ifndef U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES
+/** The largest amount of data that uShortRangeEdmStreamWrite()
+ * or uShortRangeEdmStreamWriteZeroCopy() will put into a single
+ * EDM data packet: a larger write is split into as many packets
+ * as necessary, written to the UART back to back.  The default,
+ * and the maximum, is the most that an EDM data packet can carry.
+ */
+# define U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES 0xFFC
+#endif
+
 #ifndef U_EDM_STREAM_EVENT_QUEUE_SIZE
 #define U_EDM_STREAM_EVENT_QUEUE_SIZE 20
 #endif
@@ -81,12 +112,15 @@ typedef void (*uEdmDataEventCallback_t)(int32_t edmStreamHandle,
  */
 int32_t uShortRangeEdmStreamInit();
 
-/** Shutdown stream handling.
+/** Shutdown stream handling; this does nothing while any stream
+ * remains open, so that it is safe for the user of one stream to
+ * call this while other streams are in use.
  */
 void uShortRangeEdmStreamDeinit();
 
 /** Open an instance. Needs an open UART instance that is not accessed
- * by any other module.
+ * by any other module.  Up to #U_SHORT_RANGE_EDM_STREAM_MAX_NUM
+ * instances, each on a different UART, may be open at once.
  *
  * @param uartHandle       the UART HW block to use.
  * @return                 a stream handle else negative
@@ -149,7 +183,13 @@ int32_t uShortRangeEdmStreamAtRead(int32_t handle, void *pBuffer,
                                    size_t sizeBytes);
 
 /** Write to the given interface on given channel.  Will block until
- * all of the data has been written or an error has occurred.
+ * all of the data has been written or an error has occurred.  There
+ * is no limit on sizeBytes: the data is sent in EDM packets of up to
+ * #U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES (or, for a
+ * Bluetooth connection, the frame size of the connection if that
+ * is smaller), each passed to the UART as soon as the last has
+ * been, hardware flow control on the UART pacing the data to the
+ * rate at which the module can accept it.
  *
  * @param handle      the handle of the stream instance.
  * @param channel     the number of for the connection channel given in
@@ -166,6 +206,31 @@ int32_t uShortRangeEdmStreamWrite(int32_t handle, int32_t channel,
                                   const void *pBuffer, size_t sizeBytes,
                                   uint32_t timeoutMs);
 
+/** As uShortRangeEdmStreamWrite() but the EDM packets are built
+ * in place in the caller's buffer, so that each is written to the
+ * UART in one go without being copied.  pBuffer must point to
+ * #U_SHORT_RANGE_EDM_STREAM_WRITE_HEADROOM_BYTES of free space,
+ * followed by the sizeBytes of data to send, followed by
+ * #U_SHORT_RANGE_EDM_STREAM_WRITE_TAILROOM_BYTES of free space.
+ * The free space is overwritten but the data is unchanged on return.
+ *
+ * @param handle      the handle of the stream instance.
+ * @param channel     the number of for the connection channel given in
+ *                    the connected event callback.
+ * @param[in] pBuffer a pointer to the headroom in front of the data
+ *                    to send; cannot be NULL.
+ * @param sizeBytes   the number of bytes of data to send, not
+ *                    including the headroom or tailroom.
+ * @param timeoutMs   timeout in ms. If timeout is reached, sending is
+ *                    interrupted and the actual number of bytes sent returned.
+ *                    Reaching timeout is not considered an error.
+ * @return            the number of bytes of data sent or negative
+ *                    error code.
+ */
+int32_t uShortRangeEdmStreamWriteZeroCopy(int32_t handle, int32_t channel,
+                                          char *pBuffer, size_t sizeBytes,
+                                          uint32_t timeoutMs);
+
 /** Set a callback to be called when an AT event occurs.
  * pFunction will be called asynchronously in its own task.
  *
@@ -22,6 +22,7 @@
  * please keep #includes to your .c files. */
 
 #include "u_compiler.h"
+#include "u_ringbuffer.h"
 
 /** \addtogroup _short-range
  *  @{
@@ -41,6 +42,45 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The number of size classes in a pbuf pool.  Size class 0 holds
+ * pbufs of U_SHORT_RANGE_EDM_BLK_SIZE bytes, which is what
+ * uShortRangePbufAlloc() returns, size classes 1 and 2 hold the
+ * larger pbufs configured below; uShortRangePbufAllocSize() picks
+ * the size class that suits the amount of data to be stored, so
+ * that a large EDM packet, e.g. a TCP segment, is held in a short
+ * chain of large pbufs rather than a long chain of small ones.
+ * As with all memory pools, the memory for a size class is only
+ * allocated when the first pbuf is taken from it.
+ */
+#define U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES 3
+
+#ifndef U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_SIZE
+/** The size of the data area of a pbuf in size class 1.
+ */
+# define U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_SIZE 256
+#endif
+
+#ifndef U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_COUNT
+/** The number of pbufs in size class 1; set this to zero to
+ * remove size class 1.
+ */
+# define U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_COUNT 8
+#endif
+
+#ifndef U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE
+/** The size of the data area of a pbuf in size class 2; must be
+ * larger than #U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_SIZE.
+ */
+# define U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE 1024
+#endif
+
+#ifndef U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_COUNT
+/** The number of pbufs in size class 2; set this to zero to
+ * remove size class 2.
+ */
+# define U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_COUNT 4
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -88,18 +128,75 @@ typedef struct uShortRangePktList_t {
     int32_t pktCount;
 } uShortRangePktList_t;
 
+/** Run-time statistics for one size class of a pbuf pool, as
+ * returned by uShortRangePbufGetStats(); intended to help with
+ * setting the geometry of the pool.
+ */
+typedef struct {
+    size_t blockSizeBytes;    /**< the size of the data area of each pbuf. */
+    int32_t numBlocks;        /**< the number of pbufs in the size class. */
+    int32_t numBlocksUsed;    /**< the number of pbufs currently in use. */
+    int32_t numBlocksUsedMax; /**< the largest number of pbufs that have
+                                   been in use at any one time. */
+    int32_t numAllocs;        /**< the number of pbufs taken from the
+                                   size class. */
+    int32_t numFrees;         /**< the number of pbufs returned to the
+                                   size class. */
+    int32_t numAllocFails;    /**< the number of times a pbuf was asked
+                                   for when the size class was empty. */
+} uShortRangePbufStats_t;
+
+/** Run-time statistics for the pbuf lists of a pbuf pool, as
+ * returned by uShortRangePbufGetListStats(); together with
+ * uShortRangePbufGetStats() these give the number of pbufs a
+ * packet typically needs and hence how many pbufs a product
+ * should have, e.g. #U_SHORT_RANGE_EDM_BLK_COUNT.
+ */
+typedef struct {
+    int32_t numLists;           /**< the number of pbuf lists allocated. */
+    int32_t numListsUsed;       /**< the number of pbuf lists currently
+                                     in use. */
+    int32_t numListsUsedMax;    /**< the largest number of pbuf lists that
+                                     have been in use at any one time. */
+    int32_t numListAllocFails;  /**< the number of times a pbuf list was
+                                     asked for when there were none left. */
+    int32_t numPbufs;           /**< the number of pbufs appended to those
+                                     pbuf lists. */
+    int32_t averageLengthX100;  /**< the average number of pbufs in a pbuf
+                                     list, i.e. the average chain length,
+                                     multiplied by 100. */
+} uShortRangePbufListStats_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
 
 /** Initialize the memory pool for shortrange; it is always safe
  * to call this, even if the memory pool might have already been
- * initialised.
+ * initialised.  This is the same as calling
+ * uShortRangeMemPoolInitPool() with pool 0.
  *
  * @return zero on success else negative error code.
  */
 int32_t uShortRangeMemPoolInit(void);
 
+/** Initialize one of the memory pools for shortrange: there is
+ * one pool for each EDM stream, so that a stream that is busy
+ * cannot starve the others of memory, up to
+ * #U_SHORT_RANGE_EDM_STREAM_MAX_NUM.  It is always safe to call
+ * this, even if the memory pool might have already been initialised.
+ *
+ * @param pool the pool to initialise, counting from zero.
+ * @return     zero on success else negative error code.
+ */
+int32_t uShortRangeMemPoolInitPool(int32_t pool);
+
+/** Release one of the memory pools for shortrange.
+ *
+ * @param pool the pool to release, counting from zero.
+ */
+void uShortRangeMemPoolDeInitPool(int32_t pool);
+
 /** Release all the associated memory pools for shortrange.
  */
 void uShortRangeMemPoolDeInit(void);
@@ -115,6 +212,54 @@ void uShortRangeMemPoolDeInit(void);
  */
 int32_t uShortRangePbufAlloc(uShortRangePbuf_t **ppBuf);
 
+/** As uShortRangePbufAlloc() but allocating from the given pool,
+ * see uShortRangeMemPoolInitPool(); a pbuf allocated in this way
+ * is freed in the same way as any other, it is not necessary
+ * to know which pool it came from.
+ *
+ * @param pool       the pool to allocate from.
+ * @param[out] ppBuf a double pointer to destination pbuf.
+ * @return           data size of the returned pbuf, on failure negative
+ *                   error code.
+ */
+int32_t uShortRangePbufAllocPool(int32_t pool, uShortRangePbuf_t **ppBuf);
+
+/** As uShortRangePbufAllocPool() but choosing the size class
+ * of the pbuf according to the amount of data that is to be put
+ * in it: the smallest size class with pbufs large enough to hold
+ * sizeBytes is used, or the largest size class if none are,
+ * falling back to smaller, and then larger, size classes if that
+ * size class is empty; see #U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES.
+ *
+ * @param pool       the pool to allocate from.
+ * @param sizeBytes  the amount of data to be stored.
+ * @param[out] ppBuf a double pointer to destination pbuf.
+ * @return           data size of the returned pbuf, which may be
+ *                   smaller or larger than sizeBytes, on failure
+ *                   negative error code.
+ */
+int32_t uShortRangePbufAllocSize(int32_t pool, size_t sizeBytes,
+                                 uShortRangePbuf_t **ppBuf);
+
+/** Get the run-time statistics for a size class of a pbuf pool.
+ *
+ * @param pool        the pool.
+ * @param sizeClass   the size class, from 0 to
+ *                    #U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES - 1.
+ * @param[out] pStats a place to put the statistics; cannot be NULL.
+ * @return            zero on success else negative error code.
+ */
+int32_t uShortRangePbufGetStats(int32_t pool, int32_t sizeClass,
+                                uShortRangePbufStats_t *pStats);
+
+/** Get the run-time statistics for the pbuf lists of a pbuf pool.
+ *
+ * @param pool        the pool.
+ * @param[out] pStats a place to put the statistics; cannot be NULL.
+ * @return            zero on success else negative error code.
+ */
+int32_t uShortRangePbufGetListStats(int32_t pool, uShortRangePbufListStats_t *pStats);
+
 /** Allocate memory for pbuf list from the pbuf list
  * memory pool. Refer to gPBufListPool in u_short_range_pbuf.c
  * Memory pool should have been initialized before using this
@@ -125,6 +270,14 @@ int32_t uShortRangePbufAlloc(uShortRangePbuf_t **ppBuf);
  */
 uShortRangePbufList_t *pUShortRangePbufListAlloc(void);
 
+/** As pUShortRangePbufListAlloc() but allocating from the given
+ * pool, see uShortRangeMemPoolInitPool().
+ *
+ * @param pool the pool to allocate from.
+ * @return     pointer to uShortRangePbufList_t or NULL.
+ */
+uShortRangePbufList_t *pUShortRangePbufListAllocPool(int32_t pool);
+
 /** Put the allocated memory for pbufs and packet in to their
  * free list of respective pool.
  *
@@ -150,6 +303,17 @@ int32_t uShortRangePbufListAppend(uShortRangePbufList_t *pBufList, uShortRangePb
  */
 size_t uShortRangePbufListConsumeData(uShortRangePbufList_t *pBufList, char *pData, size_t len);
 
+/** As uShortRangePbufListConsumeData() but moving as much data as
+ * will fit into a ring buffer; pbufs that are emptied are put back
+ * in their pool.
+ *
+ * @param[in] pBufList     pointer to the pbuf list.
+ * @param[in] pRingBuffer  pointer to the destination ring buffer.
+ * @return                 moved length.
+ */
+size_t uShortRangePbufListConsumeDataToRingBuffer(uShortRangePbufList_t *pBufList,
+                                                  uRingBuffer_t *pRingBuffer);
+
 /** Link a new pbuf list to the existing pbuf list.
  *  The pointer allocated for the new pbuf list from the pbuf list pool
  *  will be added to its free list.
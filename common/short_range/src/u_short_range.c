@@ -171,6 +171,14 @@ static void removeShortRangeInstance(uShortRangePrivateInstance_t *pInstance)
         }
     }
 
+    // The Wifi scan and location caches are allocated in wifi but,
+    // since they are just memory, they are most simply freed here
+    // with the instance
+    uPortFree(pInstance->pWifiScanCache);
+    uPortFree(pInstance->pLocCache);
+    if (pInstance->wifiScanCacheMutex != NULL) {
+        uPortMutexDelete(pInstance->wifiScanCacheMutex);
+    }
     uPortFree(pInstance);
 }
 
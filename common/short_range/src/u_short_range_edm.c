@@ -54,41 +54,36 @@
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
-typedef enum {
-    EDM_PARSER_STATE_PARSE_START_BYTE,
-    EDM_PARSER_STATE_PARSE_PAYLOAD_LENGTH,
-    EDM_PARSER_STATE_PARSE_HEADER_LENGTH,
-    EDM_PARSER_STATE_ALLOCATE_PBUFLIST,
-    EDM_PARSER_STATE_ALLOCATE_PAYLOAD,
-    EDM_PARSER_STATE_ACCUMULATE_PAYLOAD,
-    EDM_PARSER_STATE_PARSE_TAIL_BYTE,
-    EDM_PARSER_STATE_WAIT_FOR_EVENT_PROCESSING
-} edmParserState_t;
 
 /* ----------------------------------------------------------------
  * STATIC PROTOTYPES
  * -------------------------------------------------------------- */
 static int32_t getBtProfile(char value, uShortRangeBtProfile_t *profile);
 static int32_t getIpProtocol(char value, uShortRangeIpProtocol_t *protocol);
-static uShortRangeEdmEvent_t *allocateEdmEvent(void);
-static uShortRangeEdmEvent_t *parseConnectBtEvent(uint8_t channel, char *buffer,
+static uShortRangeEdmEvent_t *parseConnectBtEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                  uint8_t channel, char *buffer,
                                                   uint16_t payloadLength);
-static uShortRangeEdmEvent_t *parseConnectIpv4Event(uint8_t channel, char *buffer,
+static uShortRangeEdmEvent_t *parseConnectIpv4Event(uShortRangeEdmEvent_t *pEventStorage,
+                                                    uint8_t channel, char *buffer,
                                                     uint16_t payloadLength);
-static uShortRangeEdmEvent_t *parseConnectIpv6Event(uint8_t channel, char *buffer,
+static uShortRangeEdmEvent_t *parseConnectIpv6Event(uShortRangeEdmEvent_t *pEventStorage,
+                                                    uint8_t channel, char *buffer,
                                                     uint16_t payloadLength);
-static uShortRangeEdmEvent_t *parseConnectEvent(uint8_t channel, uShortRangePbufList_t *pBufList);
-static uShortRangeEdmEvent_t *parseDisconnectEvent(uint8_t channel);
-static uShortRangeEdmEvent_t *parseDataEvent(uint8_t channel, uShortRangePbufList_t *pBufList);
-static uShortRangeEdmEvent_t *parseAtResponseOrEvent(uShortRangePbufList_t *pBufList);
-static uShortRangeEdmEvent_t *parseEdmPayload(uint16_t idAndType, uint8_t channel,
+static uShortRangeEdmEvent_t *parseConnectEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                uint8_t channel, uShortRangePbufList_t *pBufList);
+static uShortRangeEdmEvent_t *parseDisconnectEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                   uint8_t channel);
+static uShortRangeEdmEvent_t *parseDataEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                             uint8_t channel, uShortRangePbufList_t *pBufList);
+static uShortRangeEdmEvent_t *parseAtResponseOrEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                     uShortRangePbufList_t *pBufList);
+static uShortRangeEdmEvent_t *parseEdmPayload(uShortRangeEdmEvent_t *pEventStorage,
+                                              uint16_t idAndType, uint8_t channel,
                                               uShortRangePbufList_t *pBufList);
 
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
-static edmParserState_t gEdmParserState = EDM_PARSER_STATE_PARSE_START_BYTE;
-static uShortRangePbufList_t *gCurPBufList = NULL;
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -130,14 +125,8 @@ static int32_t getIpProtocol(char value, uShortRangeIpProtocol_t *pProtocol)
     return U_SHORT_RANGE_EDM_OK;
 }
 
-static uShortRangeEdmEvent_t *allocateEdmEvent(void)
-{
-    static uShortRangeEdmEvent_t gEdmEvent;
-
-    return &gEdmEvent;
-}
-
-static uShortRangeEdmEvent_t *parseConnectBtEvent(uint8_t channel, char *pBuffer,
+static uShortRangeEdmEvent_t *parseConnectBtEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                  uint8_t channel, char *pBuffer,
                                                   uint16_t payloadLength)
 {
     uShortRangeEdmEvent_t *pEvent = NULL;
@@ -146,7 +135,7 @@ static uShortRangeEdmEvent_t *parseConnectBtEvent(uint8_t channel, char *pBuffer
 
     if ((payloadLength == 10) && (result == U_SHORT_RANGE_EDM_OK)) {
         uShortRangeEdmConnectionEventBt_t *pEvtData;
-        pEvent = allocateEdmEvent();
+        pEvent = pEventStorage;
         pEvent->type = U_SHORT_RANGE_EDM_EVENT_CONNECT_BT;
         pEvtData = &pEvent->params.btConnectEvent;
         pEvtData->channel = channel;
@@ -159,7 +148,8 @@ static uShortRangeEdmEvent_t *parseConnectBtEvent(uint8_t channel, char *pBuffer
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseConnectIpv4Event(uint8_t channel, char *pBuffer,
+static uShortRangeEdmEvent_t *parseConnectIpv4Event(uShortRangeEdmEvent_t *pEventStorage,
+                                                    uint8_t channel, char *pBuffer,
                                                     uint16_t payloadLength)
 {
     uShortRangeEdmEvent_t *pEvent = NULL;
@@ -168,7 +158,7 @@ static uShortRangeEdmEvent_t *parseConnectIpv4Event(uint8_t channel, char *pBuff
 
     if ((payloadLength == 14) && (result == U_SHORT_RANGE_EDM_OK)) {
         uShortRangeEdmConnectionEventIpv4_t *pEvtData;
-        pEvent = allocateEdmEvent();
+        pEvent = pEventStorage;
         pEvent->type = U_SHORT_RANGE_EDM_EVENT_CONNECT_IPv4;
         pEvtData = &pEvent->params.ipv4ConnectEvent;
         pEvtData->channel = channel;
@@ -186,7 +176,8 @@ static uShortRangeEdmEvent_t *parseConnectIpv4Event(uint8_t channel, char *pBuff
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseConnectIpv6Event(uint8_t channel, char *pBuffer,
+static uShortRangeEdmEvent_t *parseConnectIpv6Event(uShortRangeEdmEvent_t *pEventStorage,
+                                                    uint8_t channel, char *pBuffer,
                                                     uint16_t payloadLength)
 {
     uShortRangeEdmEvent_t *pEvent = NULL;
@@ -195,7 +186,7 @@ static uShortRangeEdmEvent_t *parseConnectIpv6Event(uint8_t channel, char *pBuff
 
     if ((payloadLength == 38) && (result == U_SHORT_RANGE_EDM_OK)) {
         uShortRangeEdmConnectionEventIpv6_t *pEvtData;
-        pEvent = allocateEdmEvent();
+        pEvent = pEventStorage;
         pEvent->type = U_SHORT_RANGE_EDM_EVENT_CONNECT_IPv6;
         pEvtData = &pEvent->params.ipv6ConnectEvent;
         pEvtData->channel = channel;
@@ -213,7 +204,8 @@ static uShortRangeEdmEvent_t *parseConnectIpv6Event(uint8_t channel, char *pBuff
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseConnectEvent(uint8_t channel, uShortRangePbufList_t *pBufList)
+static uShortRangeEdmEvent_t *parseConnectEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                uint8_t channel, uShortRangePbufList_t *pBufList)
 {
     uShortRangeEdmEvent_t *pEvent = NULL;
     uint16_t payloadLength = 0;
@@ -229,15 +221,15 @@ static uShortRangeEdmEvent_t *parseConnectEvent(uint8_t channel, uShortRangePbuf
         switch (type) {
 
             case U_SHORT_RANGE_EDM_CONNECTION_TYPE_BT:
-                pEvent = parseConnectBtEvent(channel, pBuffer, payloadLength);
+                pEvent = parseConnectBtEvent(pEventStorage, channel, pBuffer, payloadLength);
                 break;
 
             case U_SHORT_RANGE_EDM_CONNECTION_TYPE_IPv4:
-                pEvent = parseConnectIpv4Event(channel, pBuffer, payloadLength);
+                pEvent = parseConnectIpv4Event(pEventStorage, channel, pBuffer, payloadLength);
                 break;
 
             case U_SHORT_RANGE_EDM_CONNECTION_TYPE_IPv6:
-                pEvent = parseConnectIpv6Event(channel, pBuffer, payloadLength);
+                pEvent = parseConnectIpv6Event(pEventStorage, channel, pBuffer, payloadLength);
                 break;
 
             default:
@@ -248,23 +240,25 @@ static uShortRangeEdmEvent_t *parseConnectEvent(uint8_t channel, uShortRangePbuf
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseDisconnectEvent(uint8_t channel)
+static uShortRangeEdmEvent_t *parseDisconnectEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                   uint8_t channel)
 {
     uShortRangeEdmEvent_t *pEvent;
 
-    pEvent = allocateEdmEvent();
+    pEvent = pEventStorage;
     pEvent->type = U_SHORT_RANGE_EDM_EVENT_DISCONNECT;
     pEvent->params.disconnectEvent.channel = channel;
 
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseDataEvent(uint8_t channel, uShortRangePbufList_t *pBufList)
+static uShortRangeEdmEvent_t *parseDataEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                             uint8_t channel, uShortRangePbufList_t *pBufList)
 {
     uShortRangeEdmEvent_t *pEvent = NULL;
 
     if ((pBufList != NULL) && (pBufList->totalLen > 0)) {
-        pEvent = allocateEdmEvent();
+        pEvent = pEventStorage;
         pEvent->type = U_SHORT_RANGE_EDM_EVENT_DATA;
         pEvent->params.dataEvent.channel = channel;
         pEvent->params.dataEvent.pBufList = pBufList;
@@ -273,15 +267,17 @@ static uShortRangeEdmEvent_t *parseDataEvent(uint8_t channel, uShortRangePbufLis
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseAtResponseOrEvent(uShortRangePbufList_t *pBufList)
+static uShortRangeEdmEvent_t *parseAtResponseOrEvent(uShortRangeEdmEvent_t *pEventStorage,
+                                                     uShortRangePbufList_t *pBufList)
 {
-    uShortRangeEdmEvent_t *pEvent = allocateEdmEvent();
+    uShortRangeEdmEvent_t *pEvent = pEventStorage;
     pEvent->type = U_SHORT_RANGE_EDM_EVENT_AT;
     pEvent->params.atEvent.pBufList = pBufList;
     return pEvent;
 }
 
-static uShortRangeEdmEvent_t *parseEdmPayload(uint16_t idAndType, uint8_t channel,
+static uShortRangeEdmEvent_t *parseEdmPayload(uShortRangeEdmEvent_t *pEventStorage,
+                                              uint16_t idAndType, uint8_t channel,
                                               uShortRangePbufList_t *pBufList)
 {
     uShortRangeEdmEvent_t *pEvent = NULL;
@@ -289,26 +285,26 @@ static uShortRangeEdmEvent_t *parseEdmPayload(uint16_t idAndType, uint8_t channe
     switch (idAndType) {
 
         case U_SHORT_RANGE_EDM_TYPE_CONNECT_EVENT:
-            pEvent = parseConnectEvent(channel, pBufList);
+            pEvent = parseConnectEvent(pEventStorage, channel, pBufList);
             uShortRangePbufListFree(pBufList);
             break;
 
         case U_SHORT_RANGE_EDM_TYPE_DISCONNECT_EVENT:
-            pEvent = parseDisconnectEvent(channel);
+            pEvent = parseDisconnectEvent(pEventStorage, channel);
             uShortRangePbufListFree(pBufList);
             break;
 
         case U_SHORT_RANGE_EDM_TYPE_DATA_EVENT:
-            pEvent = parseDataEvent(channel, pBufList);
+            pEvent = parseDataEvent(pEventStorage, channel, pBufList);
             break;
 
         case U_SHORT_RANGE_EDM_TYPE_AT_RESPONSE:
         case U_SHORT_RANGE_EDM_TYPE_AT_EVENT:
-            pEvent = parseAtResponseOrEvent(pBufList);
+            pEvent = parseAtResponseOrEvent(pEventStorage, pBufList);
             break;
 
         case U_SHORT_RANGE_EDM_TYPE_START_EVENT:
-            pEvent = allocateEdmEvent();
+            pEvent = pEventStorage;
             pEvent->type = U_SHORT_RANGE_EDM_EVENT_STARTUP;
             break;
         //lint -e825
@@ -325,86 +321,90 @@ static uShortRangeEdmEvent_t *parseEdmPayload(uint16_t idAndType, uint8_t channe
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
-bool uShortRangeEdmParserReady(void)
+void uShortRangeEdmParserInit(uShortRangeEdmParser_t *pParser, int32_t pool)
+{
+    memset(pParser, 0, sizeof(*pParser));
+    pParser->state = EDM_PARSER_STATE_PARSE_START_BYTE;
+    pParser->pool = pool;
+}
+
+bool uShortRangeEdmParserReady(const uShortRangeEdmParser_t *pParser)
 {
-    return (gEdmParserState != EDM_PARSER_STATE_WAIT_FOR_EVENT_PROCESSING);
+    return (pParser->state != EDM_PARSER_STATE_WAIT_FOR_EVENT_PROCESSING);
 }
 
-void uShortRangeEdmResetParser(void)
+void uShortRangeEdmResetParser(uShortRangeEdmParser_t *pParser)
 {
-    gEdmParserState = EDM_PARSER_STATE_PARSE_START_BYTE;
+    pParser->state = EDM_PARSER_STATE_PARSE_START_BYTE;
 }
 
-bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pMemAvailable)
+bool uShortRangeEdmParse(uShortRangeEdmParser_t *pParser, char c,
+                         uShortRangeEdmEvent_t **ppResultEvent, bool *pMemAvailable)
 {
-    edmParserState_t newState = gEdmParserState;
-    static uint16_t payloadLength;
-    static uShortRangePbuf_t *pBuf;
-    static int32_t pBufSize;
-    static char header[U_SHORT_RANGE_EDM_HEADER_SIZE];
-    static uint32_t headerIndex;
-    static uint16_t idAndType;
-    static uint8_t channel;
+    uShortRangeEdmParserState_t newState = pParser->state;
+    uShortRangePbuf_t *pBuf = pParser->pBuf;
+    char *header = pParser->header;
     bool charConsumed = false;
     int32_t result;
 
     *pMemAvailable = true;
-    switch (gEdmParserState) {
+    switch (pParser->state) {
 
         case EDM_PARSER_STATE_PARSE_START_BYTE:
             if (c == U_SHORT_RANGE_EDM_HEAD) {
-                headerIndex = 0;
+                pParser->headerIndex = 0;
                 newState = EDM_PARSER_STATE_PARSE_PAYLOAD_LENGTH;
             }
             charConsumed = true;
             break;
 
         case EDM_PARSER_STATE_PARSE_PAYLOAD_LENGTH:
-            if (headerIndex == 0) {
-                payloadLength = (uint16_t)(uint8_t)c << 8;
-                headerIndex++;
+            if (pParser->headerIndex == 0) {
+                pParser->payloadLength = (uint16_t)(uint8_t)c << 8;
+                pParser->headerIndex++;
             } else {
-                payloadLength |= (uint16_t)(uint8_t)c;
-                if (payloadLength < 2) {
+                pParser->payloadLength |= (uint16_t)(uint8_t)c;
+                if (pParser->payloadLength < 2) {
                     // Something is wrong, start over
                     newState = EDM_PARSER_STATE_PARSE_START_BYTE;
                 } else {
-                    headerIndex = 0;
+                    pParser->headerIndex = 0;
                     newState = EDM_PARSER_STATE_PARSE_HEADER_LENGTH;
                 }
             }
             charConsumed = true;
             break;
         case EDM_PARSER_STATE_PARSE_HEADER_LENGTH:
-            header[headerIndex++] = c;
-            payloadLength--;
+            header[pParser->headerIndex++] = c;
+            pParser->payloadLength--;
 
-            if (headerIndex == 2) {
+            if (pParser->headerIndex == 2) {
 
-                idAndType = ((uint16_t)(uint8_t)header[0] << 8) | (uint16_t)(uint8_t)header[1];
+                pParser->idAndType = ((uint16_t)(uint8_t)header[0] << 8) |
+                                     (uint16_t)(uint8_t)header[1];
 
-                if ((idAndType == U_SHORT_RANGE_EDM_TYPE_AT_RESPONSE) ||
-                    (idAndType == U_SHORT_RANGE_EDM_TYPE_AT_EVENT)    ||
-                    (idAndType == U_SHORT_RANGE_EDM_TYPE_START_EVENT) ||
-                    (idAndType == U_SHORT_RANGE_EDM_TYPE_AT_REQUEST)) {
+                if ((pParser->idAndType == U_SHORT_RANGE_EDM_TYPE_AT_RESPONSE) ||
+                    (pParser->idAndType == U_SHORT_RANGE_EDM_TYPE_AT_EVENT)    ||
+                    (pParser->idAndType == U_SHORT_RANGE_EDM_TYPE_START_EVENT) ||
+                    (pParser->idAndType == U_SHORT_RANGE_EDM_TYPE_AT_REQUEST)) {
 
                     // Channel does not exist for these types so
                     // fill in -1
-                    header[headerIndex++] = -1;
+                    header[pParser->headerIndex++] = -1;
                 }
             }
 
-            if (headerIndex == U_SHORT_RANGE_EDM_HEADER_SIZE) {
-                channel = header[2];
-                // gCurPBufChain should always be NULL here
+            if (pParser->headerIndex == U_SHORT_RANGE_EDM_HEADER_SIZE) {
+                pParser->channel = header[2];
+                // pCurPBufList should always be NULL here
                 // If it's not we have a leak
-                U_ASSERT(gCurPBufList == NULL);
+                U_ASSERT(pParser->pCurPBufList == NULL);
                 pBuf = NULL;
                 newState = EDM_PARSER_STATE_ALLOCATE_PBUFLIST;
                 // For disconnect event there is no payload
                 // so directly head to parse tail byte
-                if ((idAndType == U_SHORT_RANGE_EDM_TYPE_DISCONNECT_EVENT) ||
-                    (idAndType == U_SHORT_RANGE_EDM_TYPE_START_EVENT)) {
+                if ((pParser->idAndType == U_SHORT_RANGE_EDM_TYPE_DISCONNECT_EVENT) ||
+                    (pParser->idAndType == U_SHORT_RANGE_EDM_TYPE_START_EVENT)) {
                     newState = EDM_PARSER_STATE_PARSE_TAIL_BYTE;
                 }
             }
@@ -415,9 +415,9 @@ bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pM
 
             // if allocation fails stay back until
             // we have some free memory in their respective pool
-            gCurPBufList = pUShortRangePbufListAlloc();
-            if (gCurPBufList != NULL) {
-                gCurPBufList->edmChannel = channel;
+            pParser->pCurPBufList = pUShortRangePbufListAllocPool(pParser->pool);
+            if (pParser->pCurPBufList != NULL) {
+                pParser->pCurPBufList->edmChannel = pParser->channel;
                 newState = EDM_PARSER_STATE_ALLOCATE_PAYLOAD;
             } else {
                 *pMemAvailable = false; // remain at same state, try again later
@@ -430,9 +430,12 @@ bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pM
 
             // if allocation fails stay back until
             // we have some free memory in their respective pool
-            pBufSize = uShortRangePbufAlloc(&pBuf);
-            if (pBufSize > 0) {
-                headerIndex = 0;
+            // Size the pbuf to the remaining payload so that a large
+            // packet is held in a short chain of large pbufs
+            pParser->pBufSize = uShortRangePbufAllocSize(pParser->pool, pParser->payloadLength,
+                                                         &pBuf);
+            if (pParser->pBufSize > 0) {
+                pParser->headerIndex = 0;
                 newState = EDM_PARSER_STATE_ACCUMULATE_PAYLOAD;
             } else {
                 *pMemAvailable = false; // remain at same state, try again later
@@ -443,20 +446,20 @@ bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pM
 
         case EDM_PARSER_STATE_ACCUMULATE_PAYLOAD:
 
-            U_ASSERT(pBufSize > 0);
+            U_ASSERT(pParser->pBufSize > 0);
             U_ASSERT(pBuf != NULL);
-            U_ASSERT(pBuf->length < pBufSize);
+            U_ASSERT(pBuf->length < pParser->pBufSize);
 
             pBuf->data[pBuf->length++] = c;
-            payloadLength--;
+            pParser->payloadLength--;
 
-            if ((pBuf->length == pBufSize) ||
-                (payloadLength == 0)) {
-                result = uShortRangePbufListAppend(gCurPBufList, pBuf);
+            if ((pBuf->length == pParser->pBufSize) ||
+                (pParser->payloadLength == 0)) {
+                result = uShortRangePbufListAppend(pParser->pCurPBufList, pBuf);
                 U_ASSERT(result == 0);
-                if (payloadLength == 0) {
+                if (pParser->payloadLength == 0) {
                     newState = EDM_PARSER_STATE_PARSE_TAIL_BYTE;
-                } else if (pBuf->length == pBufSize) {
+                } else if (pBuf->length == pParser->pBufSize) {
                     // we have some more data coming in
                     // so allocate memory for payload
                     newState = EDM_PARSER_STATE_ALLOCATE_PAYLOAD;
@@ -470,7 +473,8 @@ bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pM
             newState = EDM_PARSER_STATE_PARSE_START_BYTE;
             if (c == U_SHORT_RANGE_EDM_TAIL) {
                 if (ppResultEvent != NULL) {
-                    *ppResultEvent = parseEdmPayload(idAndType, channel, gCurPBufList);
+                    *ppResultEvent = parseEdmPayload(&(pParser->event), pParser->idAndType,
+                                                     pParser->channel, pParser->pCurPBufList);
                     if (*ppResultEvent == NULL) {
                         // No event was generated
                         // Reset parser
@@ -482,9 +486,9 @@ bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pM
             }
             if (newState == EDM_PARSER_STATE_PARSE_START_BYTE) {
                 // Always de-allocate the buffer when we reset the parser
-                uShortRangePbufListFree(gCurPBufList);
+                uShortRangePbufListFree(pParser->pCurPBufList);
             }
-            gCurPBufList = NULL;
+            pParser->pCurPBufList = NULL;
             charConsumed = true;
             break;
 
@@ -496,7 +500,8 @@ bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pM
             break;
     }
 
-    gEdmParserState = newState;
+    pParser->pBuf = pBuf;
+    pParser->state = newState;
 
     return charConsumed;
 }
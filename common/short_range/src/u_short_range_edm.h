@@ -45,8 +45,20 @@
 //lint -esym(755, U_SHORT_RANGE_EDM_MTU_IP_MAX_SIZE) Suppress lack of a reference
 #define U_SHORT_RANGE_EDM_MTU_IP_MAX_SIZE     635
 #define U_SHORT_RANGE_EDM_HEADER_SIZE         3 // (ID + TYPE)(2 bytes)  + CHANNEL ID (1 byte)
-#define U_SHORT_RANGE_EDM_BLK_SIZE            64
-#define U_SHORT_RANGE_EDM_BLK_COUNT           (U_SHORT_RANGE_EDM_MAX_SIZE / U_SHORT_RANGE_EDM_BLK_SIZE)
+
+#ifndef U_SHORT_RANGE_EDM_BLK_SIZE
+/** The size of the data area of a pbuf in the smallest (and
+ * default) size class of a pbuf pool, see u_short_range_pbuf.h.
+ */
+# define U_SHORT_RANGE_EDM_BLK_SIZE           64
+#endif
+
+#ifndef U_SHORT_RANGE_EDM_BLK_COUNT
+/** The number of pbufs in the smallest size class of a pbuf pool,
+ * by default enough to hold the largest EDM packet.
+ */
+# define U_SHORT_RANGE_EDM_BLK_COUNT          (U_SHORT_RANGE_EDM_MAX_SIZE / U_SHORT_RANGE_EDM_BLK_SIZE)
+#endif
 
 typedef enum {
     U_SHORT_RANGE_EDM_EVENT_CONNECT_BT,
@@ -99,6 +111,43 @@ typedef struct {
     } params;
 } uShortRangeEdmEvent_t;
 
+typedef enum {
+    EDM_PARSER_STATE_PARSE_START_BYTE,
+    EDM_PARSER_STATE_PARSE_PAYLOAD_LENGTH,
+    EDM_PARSER_STATE_PARSE_HEADER_LENGTH,
+    EDM_PARSER_STATE_ALLOCATE_PBUFLIST,
+    EDM_PARSER_STATE_ALLOCATE_PAYLOAD,
+    EDM_PARSER_STATE_ACCUMULATE_PAYLOAD,
+    EDM_PARSER_STATE_PARSE_TAIL_BYTE,
+    EDM_PARSER_STATE_WAIT_FOR_EVENT_PROCESSING
+} uShortRangeEdmParserState_t;
+
+/** The state of an EDM parser, one per EDM stream; the contents
+ * are internal to u_short_range_edm.c.
+ */
+typedef struct {
+    uShortRangeEdmParserState_t state;
+    int32_t pool; /**< the pbuf pool to allocate from, see uShortRangeMemPoolInitPool(). */
+    uShortRangePbufList_t *pCurPBufList;
+    uint16_t payloadLength;
+    uShortRangePbuf_t *pBuf;
+    int32_t pBufSize;
+    char header[U_SHORT_RANGE_EDM_HEADER_SIZE];
+    uint32_t headerIndex;
+    uint16_t idAndType;
+    uint8_t channel;
+    uShortRangeEdmEvent_t event; /**< storage for the event handed out by uShortRangeEdmParse(). */
+} uShortRangeEdmParser_t;
+
+/**
+ *
+ * @brief Initialise an EDM parser.
+ *
+ * @param[out] pParser pointer to the parser.
+ * @param pool         the pbuf pool that the parser should allocate from.
+ */
+void uShortRangeEdmParserInit(uShortRangeEdmParser_t *pParser, int32_t pool);
+
 /**
  *
  * @brief Check if EDM parser is available
@@ -108,14 +157,14 @@ typedef struct {
  *
  * @return True if EDM parser is available
  */
-bool uShortRangeEdmParserReady(void);
+bool uShortRangeEdmParserReady(const uShortRangeEdmParser_t *pParser);
 
 /**
  *
  * @brief Reset the parser. Do this every time the latest EDM event
  *        has been processed to make the parser available again.
  */
-void uShortRangeEdmResetParser(void);
+void uShortRangeEdmResetParser(uShortRangeEdmParser_t *pParser);
 
 /**
  *
@@ -125,6 +174,8 @@ void uShortRangeEdmResetParser(void);
  *        Check if parser is available with uShortRangeEdmParserAvailable
  *        If a packet is invalid it will be silently dropped.
  *
+ * @param[in,out] pParser the parser.
+ *
  * @param c Input character.
  *
  * @param[out] ppResultEvent Address of pointer to event, NULL if no event was generated
@@ -135,7 +186,8 @@ void uShortRangeEdmResetParser(void);
  *
  * @return True when input character c is consumed else false.
  */
-bool uShortRangeEdmParse(char c, uShortRangeEdmEvent_t **ppResultEvent, bool *pMemAvailable);
+bool uShortRangeEdmParse(uShortRangeEdmParser_t *pParser, char c,
+                         uShortRangeEdmEvent_t **ppResultEvent, bool *pMemAvailable);
 
 /**
  *
@@ -63,7 +63,23 @@
 #define U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH  200
 // TODO: is this value correct?
 #define U_SHORT_RANGE_EDM_STREAM_AT_RESPONSE_LENGTH 500
-#define U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS    9
+#ifndef U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS
+/** The number of connections, of any type, that an EDM stream
+ * can carry at one time.
+ */
+# define U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS   9
+#endif
+#define U_SHORT_RANGE_EDM_STREAM_RX_BUFFER_LENGTH   128
+
+#if (U_SHORT_RANGE_EDM_STREAM_WRITE_HEADROOM_BYTES != U_SHORT_RANGE_EDM_DATA_HEAD_SIZE) || \
+    (U_SHORT_RANGE_EDM_STREAM_WRITE_TAILROOM_BYTES != U_SHORT_RANGE_EDM_TAIL_SIZE)
+# error U_SHORT_RANGE_EDM_STREAM_WRITE_HEADROOM_BYTES/TAILROOM_BYTES do not match the EDM packet format
+#endif
+
+#if (U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES > U_SHORT_RANGE_EDM_MAX_SIZE) || \
+    (U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES <= 0)
+# error U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES must be between 1 and U_SHORT_RANGE_EDM_MAX_SIZE
+#endif
 
 #ifndef U_EDM_STREAM_TASK_STACK_SIZE_BYTES
 #define U_EDM_STREAM_TASK_STACK_SIZE_BYTES  U_AT_CLIENT_URC_TASK_STACK_SIZE_BYTES
@@ -151,6 +167,7 @@ typedef struct {
 } uShortRangeEdmStreamDataEvent_t;
 
 typedef struct {
+    int32_t handle; // The EDM stream that the event belongs to
     uShortRangeEdmStreamEventType_t type;
     union {
         // no content in at event       at;
@@ -199,6 +216,11 @@ typedef struct uEdmStreamInstance_t {
     int32_t atResponseLength;
     int32_t atResponseRead;
     uShortRangeEdmStreamConnections_t connections[U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS];
+    uShortRangeEdmParser_t parser;
+    // We don't want to read one character at a time from the UART
+    // driver, instead we read into this buffer and consume from it
+    char rxBuffer[U_SHORT_RANGE_EDM_STREAM_RX_BUFFER_LENGTH];
+    size_t rxBufferLength;
 } uShortRangeEdmStreamInstance_t;
 
 /* ----------------------------------------------------------------
@@ -206,7 +228,7 @@ typedef struct uEdmStreamInstance_t {
  * -------------------------------------------------------------- */
 
 static uPortMutexHandle_t gMutex = NULL;
-static uShortRangeEdmStreamInstance_t gEdmStream;
+static uShortRangeEdmStreamInstance_t gEdmStream[U_SHORT_RANGE_EDM_STREAM_MAX_NUM];
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -274,14 +296,29 @@ static const char *getProtocolText(uShortRangeIpProtocol_t protocol)
 
 #endif
 
+// Get the stream instance for the given handle, NULL if there
+// is no such open stream.
+static uShortRangeEdmStreamInstance_t *pGetInstance(int32_t handle)
+{
+    uShortRangeEdmStreamInstance_t *pInstance = NULL;
+
+    if ((handle >= 0) && (handle < U_SHORT_RANGE_EDM_STREAM_MAX_NUM) &&
+        (gEdmStream[handle].handle == handle)) {
+        pInstance = &(gEdmStream[handle]);
+    }
+
+    return pInstance;
+}
+
 // Find connection from channel, use -1 to get the first free slot
-static uShortRangeEdmStreamConnections_t *findConnection(int32_t channel)
+static uShortRangeEdmStreamConnections_t *findConnection(uShortRangeEdmStreamInstance_t *pInstance,
+                                                         int32_t channel)
 {
     uShortRangeEdmStreamConnections_t *pConnection = NULL;
 
     for (uint32_t i = 0; i < U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS; i++) {
-        if (gEdmStream.connections[i].channel == channel) {
-            pConnection = &gEdmStream.connections[i];
+        if (pInstance->connections[i].channel == channel) {
+            pConnection = &pInstance->connections[i];
             break;
         }
     }
@@ -289,11 +326,29 @@ static uShortRangeEdmStreamConnections_t *findConnection(int32_t channel)
     return pConnection;
 }
 
-static void processedEvent(void)
+// Return the amount of the remaining data to put in the next EDM
+// data packet on the given connection.
+static int32_t getSegmentSize(const uShortRangeEdmStreamConnections_t *pConnection,
+                              int32_t remaining)
+{
+    int32_t size = remaining;
+
+    if (size > U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES) {
+        size = U_SHORT_RANGE_EDM_STREAM_WRITE_SEGMENT_MAX_BYTES;
+    }
+    if ((pConnection->type == U_SHORT_RANGE_CONNECTION_TYPE_BT) &&
+        (size > pConnection->bt.frameSize)) {
+        size = pConnection->bt.frameSize;
+    }
+
+    return size;
+}
+
+static void processedEvent(uShortRangeEdmStreamInstance_t *pInstance)
 {
     int32_t sendErrorCode;
 
-    uShortRangeEdmResetParser();
+    uShortRangeEdmResetParser(&(pInstance->parser));
     // Trigger an event from the uart to get parsing going again
     // First use the "try" version so as not to block, which can
     // lead to mutex lock-outs if the queue is full: if the "try"
@@ -301,62 +356,66 @@ static void processedEvent(void)
     // to the blocking version; there is no danger here since,
     // if there are already events in the UART queue, the URC
     // callback will certainly be run anyway.
-    sendErrorCode = uPortUartEventTrySend(gEdmStream.uartHandle,
+    sendErrorCode = uPortUartEventTrySend(pInstance->uartHandle,
                                           U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED,
                                           0);
     if ((sendErrorCode == (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED) ||
         (sendErrorCode == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED)) {
-        uPortUartEventSend(gEdmStream.uartHandle,
+        uPortUartEventSend(pInstance->uartHandle,
                            U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED);
     }
 }
 
-static void atEventHandler(void)
+static void atEventHandler(uShortRangeEdmStreamInstance_t *pInstance)
 {
-    if (gEdmStream.pAtCallback != NULL) {
-        gEdmStream.pAtCallback(gEdmStream.handle,
+    if (pInstance->pAtCallback != NULL) {
+        pInstance->pAtCallback(pInstance->handle,
                                U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED,
-                               gEdmStream.pAtCallbackParam);
+                               pInstance->pAtCallbackParam);
     }
     // This event is not fully processed until uShortRangeEdmStreamAtRead has been called
     // and all event data been read out
 }
 
 // Event handler, calls the user's event callback.
-static void btEventHandler(uShortRangeEdmStreamBtEvent_t *pBtEvent)
+static void btEventHandler(uShortRangeEdmStreamInstance_t *pInstance,
+                           uShortRangeEdmStreamBtEvent_t *pBtEvent)
 {
-    if (gEdmStream.pBtEventCallback != NULL) {
-        gEdmStream.pBtEventCallback(gEdmStream.handle, pBtEvent->channel, pBtEvent->type,
-                                    &pBtEvent->conData, gEdmStream.pBtEventCallbackParam);
+    if (pInstance->pBtEventCallback != NULL) {
+        pInstance->pBtEventCallback(pInstance->handle, pBtEvent->channel, pBtEvent->type,
+                                    &pBtEvent->conData, pInstance->pBtEventCallbackParam);
     }
     uEdmChLogLine(LOG_CH_BT, "processed");
-    processedEvent();
+    processedEvent(pInstance);
 }
 
 // Event handler, calls the user's event callback.
-static void ipEventHandler(uShortRangeEdmStreamIpEvent_t *pIpEvent)
+static void ipEventHandler(uShortRangeEdmStreamInstance_t *pInstance,
+                           uShortRangeEdmStreamIpEvent_t *pIpEvent)
 {
-    if (gEdmStream.pIpEventCallback != NULL) {
-        gEdmStream.pIpEventCallback(gEdmStream.handle, pIpEvent->channel, pIpEvent->type,
-                                    &pIpEvent->conData, gEdmStream.pIpEventCallbackParam);
+    if (pInstance->pIpEventCallback != NULL) {
+        pInstance->pIpEventCallback(pInstance->handle, pIpEvent->channel, pIpEvent->type,
+                                    &pIpEvent->conData, pInstance->pIpEventCallbackParam);
     }
 
     uEdmChLogLine(LOG_CH_IP, "processed");
-    processedEvent();
+    processedEvent(pInstance);
 }
 
 // Event handler, calls the user's event callback.
-static void mqttEventHandler(uShortRangeEdmStreamIpEvent_t *pMqttEvent)
+static void mqttEventHandler(uShortRangeEdmStreamInstance_t *pInstance,
+                             uShortRangeEdmStreamIpEvent_t *pMqttEvent)
 {
-    if (gEdmStream.pMqttEventCallback != NULL) {
-        gEdmStream.pMqttEventCallback(gEdmStream.handle, pMqttEvent->channel, pMqttEvent->type,
-                                      &pMqttEvent->conData, gEdmStream.pMqttEventCallbackParam);
+    if (pInstance->pMqttEventCallback != NULL) {
+        pInstance->pMqttEventCallback(pInstance->handle, pMqttEvent->channel, pMqttEvent->type,
+                                      &pMqttEvent->conData, pInstance->pMqttEventCallbackParam);
     }
     uEdmChLogLine(LOG_CH_IP, "processed");
-    processedEvent();
+    processedEvent(pInstance);
 }
 
-static void dataEventHandler(uShortRangeEdmStreamDataEvent_t *pDataEvent)
+static void dataEventHandler(uShortRangeEdmStreamInstance_t *pInstance,
+                             uShortRangeEdmStreamDataEvent_t *pDataEvent)
 {
     uShortRangeEdmStreamConnections_t *pConnection;
     volatile uEdmDataEventCallback_t pDataCallback = NULL;
@@ -364,26 +423,26 @@ static void dataEventHandler(uShortRangeEdmStreamDataEvent_t *pDataEvent)
     volatile int32_t edmStreamHandle = -1;
 
     uPortMutexLock(gMutex);
-    pConnection = findConnection(pDataEvent->channel);
+    pConnection = findConnection(pInstance, pDataEvent->channel);
 
     if (pConnection != NULL) {
-        edmStreamHandle = gEdmStream.handle;
+        edmStreamHandle = pInstance->handle;
 
         switch (pConnection->type) {
 
             case U_SHORT_RANGE_CONNECTION_TYPE_BT:
-                pDataCallback = gEdmStream.pBtDataCallback;
-                pCallbackParam = gEdmStream.pBtDataCallbackParam;
+                pDataCallback = pInstance->pBtDataCallback;
+                pCallbackParam = pInstance->pBtDataCallbackParam;
                 break;
 
             case U_SHORT_RANGE_CONNECTION_TYPE_IP:
-                pDataCallback = gEdmStream.pIpDataCallback;
-                pCallbackParam = gEdmStream.pIpDataCallbackParam;
+                pDataCallback = pInstance->pIpDataCallback;
+                pCallbackParam = pInstance->pIpDataCallbackParam;
                 break;
 
             case U_SHORT_RANGE_CONNECTION_TYPE_MQTT:
-                pDataCallback = gEdmStream.pMqttDataCallback;
-                pCallbackParam = gEdmStream.pMqttDataCallbackParam;
+                pDataCallback = pInstance->pMqttDataCallback;
+                pCallbackParam = pInstance->pMqttDataCallbackParam;
                 break;
 
             case U_SHORT_RANGE_CONNECTION_TYPE_INVALID:
@@ -403,39 +462,43 @@ static void dataEventHandler(uShortRangeEdmStreamDataEvent_t *pDataEvent)
     }
 
     uEdmChLogLine(LOG_CH_DATA, "processed");
-    processedEvent();
+    processedEvent(pInstance);
     uPortMutexUnlock(gMutex);
 }
 
 static void eventHandler(void *pParam, size_t paramLength)
 {
     uShortRangeEdmStreamEvent_t *pEvent = (uShortRangeEdmStreamEvent_t *)pParam;
+    uShortRangeEdmStreamInstance_t *pInstance = NULL;
     (void)paramLength;
 
-    if (pEvent == NULL) {
+    if (pEvent != NULL) {
+        pInstance = pGetInstance(pEvent->handle);
+    }
+    if (pInstance == NULL) {
         return;
     }
 
     switch (pEvent->type) {
 
         case U_SHORT_RANGE_EDM_STREAM_EVENT_AT:
-            atEventHandler();
+            atEventHandler(pInstance);
             break;
 
         case U_SHORT_RANGE_EDM_STREAM_EVENT_BT:
-            btEventHandler(&(pEvent->bt));
+            btEventHandler(pInstance, &(pEvent->bt));
             break;
 
         case U_SHORT_RANGE_EDM_STREAM_EVENT_IP:
-            ipEventHandler(&(pEvent->ip));
+            ipEventHandler(pInstance, &(pEvent->ip));
             break;
 
         case U_SHORT_RANGE_EDM_STREAM_EVENT_MQTT:
-            mqttEventHandler(&(pEvent->mqtt));
+            mqttEventHandler(pInstance, &(pEvent->mqtt));
             break;
 
         case U_SHORT_RANGE_EDM_STREAM_EVENT_DATA:
-            dataEventHandler(&(pEvent->data));
+            dataEventHandler(pInstance, &(pEvent->data));
             break;
 
         default:
@@ -443,26 +506,28 @@ static void eventHandler(void *pParam, size_t paramLength)
     }
 }
 
-static bool enqueueEdmAtEvent(uShortRangeEdmEvent_t *pEvent)
+static bool enqueueEdmAtEvent(uShortRangeEdmStreamInstance_t *pInstance,
+                              uShortRangeEdmEvent_t *pEvent)
 {
     bool success = false;
     uShortRangeEdmStreamEvent_t event = {0}; // Keep Valgrind happy
 
     uShortRangePbufList_t *pBufList = pEvent->params.atEvent.pBufList;
-    gEdmStream.atResponseLength = (int32_t)pBufList->totalLen;
-    gEdmStream.atResponseRead = 0;
-    uShortRangePbufListConsumeData(pBufList, gEdmStream.pAtResponseBuffer,
-                                   gEdmStream.atResponseLength);
+    pInstance->atResponseLength = (int32_t)pBufList->totalLen;
+    pInstance->atResponseRead = 0;
+    uShortRangePbufListConsumeData(pBufList, pInstance->pAtResponseBuffer,
+                                   pInstance->atResponseLength);
     uShortRangePbufListFree(pBufList);
 
 #ifdef U_CFG_SHORT_RANGE_EDM_STREAM_DEBUG
     uEdmChLogStart(LOG_CH_AT_RX, "\"");
-    dumpAtData(gEdmStream.pAtResponseBuffer, gEdmStream.atResponseLength);
+    dumpAtData(pInstance->pAtResponseBuffer, pInstance->atResponseLength);
     uEdmChLogEnd("\"");
 #endif
 
+    event.handle = pInstance->handle;
     event.type = U_SHORT_RANGE_EDM_STREAM_EVENT_AT;
-    if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+    if (uPortEventQueueSend(pInstance->eventQueueHandle,
                             &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
         success = true;
     } else {
@@ -472,18 +537,20 @@ static bool enqueueEdmAtEvent(uShortRangeEdmEvent_t *pEvent)
     return success;
 }
 
-static bool enqueueEdmConnectBtEvent(uShortRangeEdmEvent_t *pEvent)
+static bool enqueueEdmConnectBtEvent(uShortRangeEdmStreamInstance_t *pInstance,
+                                     uShortRangeEdmEvent_t *pEvent)
 {
     bool success = false;
 
     uShortRangeEdmStreamConnections_t *pConnection =
-        findConnection(pEvent->params.btConnectEvent.channel);
+        findConnection(pInstance, pEvent->params.btConnectEvent.channel);
 
     if (pConnection == NULL) {
-        pConnection = findConnection(-1);
+        pConnection = findConnection(pInstance, -1);
     }
     if (pConnection != NULL) {
         uShortRangeEdmStreamEvent_t event = {0}; // Keep Valgrind happy
+        event.handle = pInstance->handle;
         pConnection->channel = pEvent->params.btConnectEvent.channel;
         pConnection->type = U_SHORT_RANGE_CONNECTION_TYPE_BT;
         pConnection->bt.frameSize = pEvent->params.btConnectEvent.connection.framesize;
@@ -499,7 +566,7 @@ static bool enqueueEdmConnectBtEvent(uShortRangeEdmEvent_t *pEvent)
         uEdmChLogEnd("");
 #endif
 
-        if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+        if (uPortEventQueueSend(pInstance->eventQueueHandle,
                                 &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
             success = true;
         } else {
@@ -510,20 +577,22 @@ static bool enqueueEdmConnectBtEvent(uShortRangeEdmEvent_t *pEvent)
     return success;
 }
 
-static bool enqueueEdmConnectIpv4Event(uShortRangeEdmEvent_t *pEvent)
+static bool enqueueEdmConnectIpv4Event(uShortRangeEdmStreamInstance_t *pInstance,
+                                       uShortRangeEdmEvent_t *pEvent)
 {
     bool success = false;
 
     uShortRangeEdmStreamConnections_t *pConnection =
-        findConnection(pEvent->params.ipv4ConnectEvent.channel);
+        findConnection(pInstance, pEvent->params.ipv4ConnectEvent.channel);
 
     if (pConnection == NULL) {
-        pConnection = findConnection(-1);
+        pConnection = findConnection(pInstance, -1);
     }
     if (pConnection != NULL) {
         uShortRangeEdmStreamEvent_t event = {0}; // Keep Valgrind happy
         uShortRangeEdmConnectionEventIpv4_t *ipv4Evt = &pEvent->params.ipv4ConnectEvent;
         uShortRangeIpProtocol_t protocol = ipv4Evt->connection.protocol;
+        event.handle = pInstance->handle;
         // IPv4 events are generated by TCP, UDP and MQTT connections
         // Since MQTT and TCP/UDP have separate callbacks we need to
         // check whether the protocol is MQTT or TCP/UDP here
@@ -559,7 +628,7 @@ static bool enqueueEdmConnectIpv4Event(uShortRangeEdmEvent_t *pEvent)
                           rIp[0], rIp[1], rIp[2], rIp[3], rPort);
 #endif
 
-            if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+            if (uPortEventQueueSend(pInstance->eventQueueHandle,
                                     &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
                 success = true;
             } else {
@@ -571,20 +640,22 @@ static bool enqueueEdmConnectIpv4Event(uShortRangeEdmEvent_t *pEvent)
     return success;
 }
 
-static bool enqueueEdmConnectIpv6Event(uShortRangeEdmEvent_t *pEvent)
+static bool enqueueEdmConnectIpv6Event(uShortRangeEdmStreamInstance_t *pInstance,
+                                       uShortRangeEdmEvent_t *pEvent)
 {
     bool success = false;
 
     uShortRangeEdmStreamConnections_t *pConnection =
-        findConnection(pEvent->params.ipv6ConnectEvent.channel);
+        findConnection(pInstance, pEvent->params.ipv6ConnectEvent.channel);
 
     if (pConnection == NULL) {
-        pConnection = findConnection(-1);
+        pConnection = findConnection(pInstance, -1);
     }
     if (pConnection != NULL) {
         uShortRangeEdmStreamEvent_t event = {0};
         uShortRangeEdmConnectionEventIpv6_t *ipv6Evt = &pEvent->params.ipv6ConnectEvent;
         uShortRangeIpProtocol_t protocol = ipv6Evt->connection.protocol;
+        event.handle = pInstance->handle;
         // IPv4 events are generated by TCP, UDP and MQTT connections
         // Since MQTT and TCP/UDP have separate callbacks we need to
         // check whether the protocol is MQTT or TCP/UDP here
@@ -615,7 +686,7 @@ static bool enqueueEdmConnectIpv6Event(uShortRangeEdmEvent_t *pEvent)
                           event.ip.channel, protocolTxt, lPort, rPort);
 #endif
 
-            if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+            if (uPortEventQueueSend(pInstance->eventQueueHandle,
                                     &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
                 success = true;
             } else {
@@ -627,15 +698,17 @@ static bool enqueueEdmConnectIpv6Event(uShortRangeEdmEvent_t *pEvent)
     return success;
 }
 
-static bool enqueueEdmDisconnectEvent(uShortRangeEdmEvent_t *pEvent)
+static bool enqueueEdmDisconnectEvent(uShortRangeEdmStreamInstance_t *pInstance,
+                                      uShortRangeEdmEvent_t *pEvent)
 {
     bool success = false;
 
     uint8_t channel = pEvent->params.disconnectEvent.channel;
-    uShortRangeEdmStreamConnections_t *pConnection = findConnection(channel);
+    uShortRangeEdmStreamConnections_t *pConnection = findConnection(pInstance, channel);
 
     if (pConnection != NULL) {
         uShortRangeEdmStreamEvent_t event = {0}; // Keep Valgrind happy
+        event.handle = pInstance->handle;
         switch (pConnection->type) {
             case U_SHORT_RANGE_CONNECTION_TYPE_BT:
                 event.type = U_SHORT_RANGE_EDM_STREAM_EVENT_BT;
@@ -644,7 +717,7 @@ static bool enqueueEdmDisconnectEvent(uShortRangeEdmEvent_t *pEvent)
 #ifdef U_CFG_SHORT_RANGE_EDM_STREAM_DEBUG
                 uEdmChLogLine(LOG_CH_BT, "ch: %d, disconnect", channel);
 #endif
-                if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+                if (uPortEventQueueSend(pInstance->eventQueueHandle,
                                         &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
                     success = true;
                 } else {
@@ -659,7 +732,7 @@ static bool enqueueEdmDisconnectEvent(uShortRangeEdmEvent_t *pEvent)
 #ifdef U_CFG_SHORT_RANGE_EDM_STREAM_DEBUG
                 uEdmChLogLine(LOG_CH_IP, "ch: %d, disconnect", channel);
 #endif
-                if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+                if (uPortEventQueueSend(pInstance->eventQueueHandle,
                                         &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
                     success = true;
                 } else {
@@ -674,7 +747,7 @@ static bool enqueueEdmDisconnectEvent(uShortRangeEdmEvent_t *pEvent)
 #ifdef U_CFG_SHORT_RANGE_EDM_STREAM_DEBUG
                 uEdmChLogLine(LOG_CH_IP, "ch: %d, disconnect", channel);
 #endif
-                if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+                if (uPortEventQueueSend(pInstance->eventQueueHandle,
                                         &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
                     success = true;
                 } else {
@@ -692,11 +765,13 @@ static bool enqueueEdmDisconnectEvent(uShortRangeEdmEvent_t *pEvent)
     return success;
 }
 
-static bool enqueueEdmDataEvent(uShortRangeEdmEvent_t *pEvent)
+static bool enqueueEdmDataEvent(uShortRangeEdmStreamInstance_t *pInstance,
+                                uShortRangeEdmEvent_t *pEvent)
 {
     bool success = false;
 
     uShortRangeEdmStreamEvent_t event = {0}; // Keep Valgrind happy
+    event.handle = pInstance->handle;
     event.type = U_SHORT_RANGE_EDM_STREAM_EVENT_DATA;
     event.data.channel = pEvent->params.dataEvent.channel;
     event.data.pBufList = pEvent->params.dataEvent.pBufList;
@@ -713,7 +788,7 @@ static bool enqueueEdmDataEvent(uShortRangeEdmEvent_t *pEvent)
 # endif
 #endif
     }
-    if (uPortEventQueueSend(gEdmStream.eventQueueHandle,
+    if (uPortEventQueueSend(pInstance->eventQueueHandle,
                             &event, sizeof(uShortRangeEdmStreamEvent_t)) == 0) {
         success = true;
     } else {
@@ -723,34 +798,35 @@ static bool enqueueEdmDataEvent(uShortRangeEdmEvent_t *pEvent)
     return success;
 }
 
-static void processEdmEvent(uShortRangeEdmEvent_t *pEvent)
+static void processEdmEvent(uShortRangeEdmStreamInstance_t *pInstance,
+                            uShortRangeEdmEvent_t *pEvent)
 {
     bool enqueued = false;
 
     switch (pEvent->type) {
 
         case U_SHORT_RANGE_EDM_EVENT_AT:
-            enqueued = enqueueEdmAtEvent(pEvent);
+            enqueued = enqueueEdmAtEvent(pInstance, pEvent);
             break;
 
         case U_SHORT_RANGE_EDM_EVENT_CONNECT_BT:
-            enqueued = enqueueEdmConnectBtEvent(pEvent);
+            enqueued = enqueueEdmConnectBtEvent(pInstance, pEvent);
             break;
 
         case U_SHORT_RANGE_EDM_EVENT_DISCONNECT:
-            enqueued = enqueueEdmDisconnectEvent(pEvent);
+            enqueued = enqueueEdmDisconnectEvent(pInstance, pEvent);
             break;
 
         case U_SHORT_RANGE_EDM_EVENT_DATA:
-            enqueued = enqueueEdmDataEvent(pEvent);
+            enqueued = enqueueEdmDataEvent(pInstance, pEvent);
             break;
 
         case U_SHORT_RANGE_EDM_EVENT_CONNECT_IPv4:
-            enqueued = enqueueEdmConnectIpv4Event(pEvent);
+            enqueued = enqueueEdmConnectIpv4Event(pInstance, pEvent);
             break;
 
         case U_SHORT_RANGE_EDM_EVENT_CONNECT_IPv6:
-            enqueued = enqueueEdmConnectIpv6Event(pEvent);
+            enqueued = enqueueEdmConnectIpv6Event(pInstance, pEvent);
             break;
 
         case U_SHORT_RANGE_EDM_EVENT_INVALID: /* Intentional fallthrough */
@@ -762,69 +838,75 @@ static void processEdmEvent(uShortRangeEdmEvent_t *pEvent)
 
     if (!enqueued) {
         /* No event was enqueued to the event queue so we simply consume the event */
-        processedEvent();
+        processedEvent(pInstance);
     }
 }
 
 static void uartCallback(int32_t uartHandle, uint32_t eventBitmask,
                          void *pParameters)
 {
-    (void)pParameters;
+    uShortRangeEdmStreamInstance_t *pInstance = (uShortRangeEdmStreamInstance_t *) pParameters;
     bool memAvailable = true;
 
-    if ((gEdmStream.uartHandle == uartHandle) &&
-        !gEdmStream.ignoreUartCallback &&
+    if ((pInstance != NULL) &&
+        (pInstance->uartHandle == uartHandle) &&
+        !pInstance->ignoreUartCallback &&
         (eventBitmask == U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
         bool uartEmpty = false;
+        char *pBuffer = pInstance->rxBuffer;
         // We don't want to read one character at the time from the uart driver since that will be
         // quite an overhead when pumping a lot of data. Instead we read into a buffer
         // and then comsume characters from that. But we might not consume all read characters
         // before an EDM-event is generated by the parser which makes the parser unavailable
         // and we have to leave this callback. When the parser later is available this
         // uart-event will be placed on the queue again so that we come back here.
-        // We thus need a static buffer, and if there are unparsed characters left in it we move
-        // them to the beginning of the buffer befor leaving (instead of using a ring buffer).
+        // We thus need a buffer per instance, and if there are unparsed characters left in it
+        // we move them to the beginning of the buffer befor leaving (instead of using a ring
+        // buffer).
         U_PORT_MUTEX_LOCK(gMutex);
-        while (!uartEmpty && uShortRangeEdmParserReady() && memAvailable) {
+        U_LOG_RAM_TRACE_BEGIN(U_LOG_RAM_EVENT_EDM_RECEIVE, (int32_t) pInstance->rxBufferLength);
+        while (!uartEmpty && uShortRangeEdmParserReady(&(pInstance->parser)) && memAvailable) {
             // Loop until we couldn't read any more characters from uart
             // or EDM parser is unavailable
             // or no pbuf memory is available
-            static char buffer[128];
-            static size_t charsInBuffer = 0;
             size_t consumed = 0;
 
             // Check if there are any existing characters in the buffer and parse them
-            while (uShortRangeEdmParserReady() && (consumed < charsInBuffer) && memAvailable) {
-                //lint -esym(727, buffer)
+            while (uShortRangeEdmParserReady(&(pInstance->parser)) &&
+                   (consumed < pInstance->rxBufferLength) && memAvailable) {
                 uShortRangeEdmEvent_t *pEvent = NULL;
                 // when there is no memory available in the pool to intake
                 // the data, this call would return false.In such
                 // cases hardware flow control will be triggered if
                 // UART H/W Rx FIFO is full.
-                if (uShortRangeEdmParse(buffer[consumed], &pEvent, &memAvailable)) {
+                if (uShortRangeEdmParse(&(pInstance->parser), pBuffer[consumed],
+                                        &pEvent, &memAvailable)) {
                     consumed++;
                 }
                 if (pEvent != NULL) {
-                    processEdmEvent(pEvent);
+                    processEdmEvent(pInstance, pEvent);
                 }
             }
             // Move unparsed data to beginning of buffer
-            if ((consumed > 0) && (charsInBuffer - consumed) > 0) {
-                memmove(buffer, buffer + consumed, charsInBuffer - consumed);
+            if ((consumed > 0) && (pInstance->rxBufferLength - consumed) > 0) {
+                memmove(pBuffer, pBuffer + consumed, pInstance->rxBufferLength - consumed);
             }
-            charsInBuffer -= consumed;
+            pInstance->rxBufferLength -= consumed;
 
             // Read as much as possible from uart into rest of buffer
-            if (charsInBuffer < sizeof buffer) {
-                int32_t sizeOrError = uPortUartRead(gEdmStream.uartHandle, buffer + charsInBuffer,
-                                                    sizeof buffer - charsInBuffer);
+            if (pInstance->rxBufferLength < sizeof(pInstance->rxBuffer)) {
+                int32_t sizeOrError = uPortUartRead(pInstance->uartHandle,
+                                                    pBuffer + pInstance->rxBufferLength,
+                                                    sizeof(pInstance->rxBuffer) -
+                                                    pInstance->rxBufferLength);
                 if (sizeOrError > 0) {
-                    charsInBuffer += sizeOrError;
+                    pInstance->rxBufferLength += sizeOrError;
                 } else {
                     uartEmpty = true;
                 }
             }
         }
+        U_LOG_RAM_TRACE_END(U_LOG_RAM_EVENT_EDM_RECEIVE, (int32_t) pInstance->rxBufferLength);
         U_PORT_MUTEX_UNLOCK(gMutex);
     }
 }
@@ -840,11 +922,12 @@ static void flushUart(int32_t uartHandle)
     }
 }
 
-static int32_t uartWrite(const void *pData, size_t length)
+static int32_t uartWrite(const uShortRangeEdmStreamInstance_t *pEdmStream,
+                         const void *pData, size_t length)
 {
     int32_t x = 0;
     if (pData != NULL) {
-        x = uPortUartWrite(gEdmStream.uartHandle, pData, length);
+        x = uPortUartWrite(pEdmStream->uartHandle, pData, length);
     }
     return x;
 }
@@ -869,8 +952,9 @@ static int32_t edmSend(const uShortRangeEdmStreamInstance_t *pEdmStream)
             dumpAtData(pEdmStream->pAtCommandBuffer, pEdmStream->atCommandCurrent);
             uEdmChLogEnd("\"");
 #endif
+            U_LOG_RAM_TRACE(U_LOG_RAM_EVENT_EDM_SEND, sizeOrError);
             while (written < (uint32_t) sizeOrError) {
-                written += uartWrite((void *) (pPacket + written),
+                written += uartWrite(pEdmStream, (void *) (pPacket + written),
                                      (uint32_t) sizeOrError - written);
             }
         }
@@ -888,38 +972,38 @@ static const char *pInterceptTx(uAtClientHandle_t atHandle,
                                 size_t *pLength,
                                 void *pContext)
 {
+    uShortRangeEdmStreamInstance_t *pInstance = (uShortRangeEdmStreamInstance_t *) pContext;
     int32_t x = 0;
 
-    (void) pContext;
     (void) atHandle;
 
     if ((*pLength != 0) || (ppData == NULL)) {
         if (ppData == NULL) {
             // We're being flushed, create and send EDM packet
-            edmSend(&gEdmStream);
+            edmSend(pInstance);
             // Reset buffer
-            gEdmStream.atCommandCurrent = 0;
+            pInstance->atCommandCurrent = 0;
         } else {
             // Send any whole buffer's worths we have
-            while ((*pLength + gEdmStream.atCommandCurrent > U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH) &&
+            while ((*pLength + pInstance->atCommandCurrent > U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH) &&
                    (x >= 0)) {
-                x = U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH - gEdmStream.atCommandCurrent;
-                memcpy(gEdmStream.pAtCommandBuffer + gEdmStream.atCommandCurrent, *ppData, x);
+                x = U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH - pInstance->atCommandCurrent;
+                memcpy(pInstance->pAtCommandBuffer + pInstance->atCommandCurrent, *ppData, x);
                 *pLength -= x;
                 *ppData += x;
-                gEdmStream.atCommandCurrent = U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH;
+                pInstance->atCommandCurrent = U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH;
                 // Send a chunk
-                x = edmSend(&gEdmStream);
+                x = edmSend(pInstance);
                 if (x < 0) {
                     // Error recovery: tell the caller we've consumed the lot
                     *ppData += *pLength;
                     *pLength = 0;
                 }
-                gEdmStream.atCommandCurrent = 0;
+                pInstance->atCommandCurrent = 0;
             }
             // Copy in any partial buffer, will be sent when we are flushed
-            memcpy(gEdmStream.pAtCommandBuffer + gEdmStream.atCommandCurrent, *ppData, *pLength);
-            gEdmStream.atCommandCurrent += (int32_t) * pLength;
+            memcpy(pInstance->pAtCommandBuffer + pInstance->atCommandCurrent, *ppData, *pLength);
+            pInstance->atCommandCurrent += (int32_t) * pLength;
             // Tell the caller what we've consumed.
             *ppData += *pLength;
         }
@@ -946,102 +1030,161 @@ int32_t uShortRangeEdmStreamInit()
         if (errorCodeOrHandle == U_ERROR_COMMON_SUCCESS) {
             errorCodeOrHandle = (uErrorCode_t)uShortRangeMemPoolInit();
         }
-        gEdmStream.handle = -1;
-        gEdmStream.ignoreUartCallback = false;
+        for (int32_t x = 0; x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM; x++) {
+            gEdmStream[x].handle = -1;
+            gEdmStream[x].uartHandle = -1;
+            gEdmStream[x].eventQueueHandle = -1;
+            gEdmStream[x].ignoreUartCallback = false;
+            uShortRangeEdmParserInit(&(gEdmStream[x].parser), x);
+        }
     }
 
-    uShortRangeEdmResetParser();
-
     return (int32_t) errorCodeOrHandle;
 }
 
 void uShortRangeEdmStreamDeinit()
 {
-    uShortRangeEdmResetParser();
+    bool streamOpen = false;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
-        uShortRangeMemPoolDeInit();
 
-        if (gEdmStream.eventQueueHandle >= 0) {
-            uPortEventQueueClose(gEdmStream.eventQueueHandle);
+        for (size_t x = 0; x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM; x++) {
+            if (gEdmStream[x].handle >= 0) {
+                streamOpen = true;
+            }
+        }
+
+        // Only tidy up once there are no streams left open, since
+        // the user of each stream will call this
+        if (!streamOpen) {
+            uShortRangeMemPoolDeInit();
+            for (int32_t x = 0; x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM; x++) {
+                if (gEdmStream[x].eventQueueHandle >= 0) {
+                    uPortEventQueueClose(gEdmStream[x].eventQueueHandle);
+                }
+                gEdmStream[x].eventQueueHandle = -1;
+                uShortRangeEdmParserInit(&(gEdmStream[x].parser), x);
+            }
         }
-        gEdmStream.eventQueueHandle = -1;
 
         U_PORT_MUTEX_UNLOCK(gMutex);
-        uPortMutexDelete(gMutex);
-        gMutex = NULL;
+
+        if (!streamOpen) {
+            uPortMutexDelete(gMutex);
+            gMutex = NULL;
+        }
     }
 }
 
 int32_t uShortRangeEdmStreamOpen(int32_t uartHandle)
 {
     uErrorCode_t handleOrErrorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    uShortRangeEdmStreamInstance_t *pInstance = NULL;
+    int32_t handle = -1;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
         handleOrErrorCode = U_ERROR_COMMON_INVALID_PARAMETER;
 
-        if (uartHandle >= 0 && gEdmStream.handle == -1) {
+        if (uartHandle >= 0) {
+            // Find a free instance, making sure that the UART
+            // is not already in use by another one
+            for (int32_t x = 0; (x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM) &&
+                 (handleOrErrorCode == U_ERROR_COMMON_INVALID_PARAMETER); x++) {
+                if (gEdmStream[x].handle == -1) {
+                    if (handle < 0) {
+                        handle = x;
+                    }
+                } else if (gEdmStream[x].uartHandle == uartHandle) {
+                    handleOrErrorCode = U_ERROR_COMMON_BUSY;
+                }
+            }
+            if (handleOrErrorCode == U_ERROR_COMMON_INVALID_PARAMETER) {
+                handleOrErrorCode = U_ERROR_COMMON_NO_MEMORY;
+                if (handle >= 0) {
+                    pInstance = &(gEdmStream[handle]);
+                    // Each stream has its own pbuf pool, so that one
+                    // stream cannot starve another of memory
+                    handleOrErrorCode = (uErrorCode_t) uShortRangeMemPoolInitPool(handle);
+                }
+            }
+        }
+
+        if ((pInstance != NULL) && (handleOrErrorCode == U_ERROR_COMMON_SUCCESS)) {
 
             int32_t errorCode = uPortUartEventCallbackSet(uartHandle,
                                                           U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED,
-                                                          uartCallback, NULL,
+                                                          uartCallback, pInstance,
                                                           U_EDM_STREAM_TASK_STACK_SIZE_BYTES,
                                                           U_EDM_STREAM_TASK_PRIORITY);
 
+            handleOrErrorCode = U_ERROR_COMMON_INVALID_PARAMETER;
             if (errorCode == 0) {
-                gEdmStream.pAtCommandBuffer = (char *)pUPortMalloc(U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH);
-                memset(gEdmStream.pAtCommandBuffer, 0, U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH);
-                gEdmStream.pAtResponseBuffer = (char *)pUPortMalloc(U_SHORT_RANGE_EDM_STREAM_AT_RESPONSE_LENGTH);
-                memset(gEdmStream.pAtResponseBuffer, 0, U_SHORT_RANGE_EDM_STREAM_AT_RESPONSE_LENGTH);
-                if (gEdmStream.pAtCommandBuffer == NULL ||
-                    gEdmStream.pAtResponseBuffer == NULL) {
+                pInstance->pAtCommandBuffer = (char *)pUPortMalloc(U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH);
+                pInstance->pAtResponseBuffer = (char *)pUPortMalloc(U_SHORT_RANGE_EDM_STREAM_AT_RESPONSE_LENGTH);
+                if (pInstance->pAtCommandBuffer == NULL ||
+                    pInstance->pAtResponseBuffer == NULL) {
                     handleOrErrorCode = U_ERROR_COMMON_NO_MEMORY;
+                    uPortFree(pInstance->pAtCommandBuffer);
+                    pInstance->pAtCommandBuffer = NULL;
+                    uPortFree(pInstance->pAtResponseBuffer);
+                    pInstance->pAtResponseBuffer = NULL;
                     uPortUartEventCallbackRemove(uartHandle);
                 } else {
-                    gEdmStream.eventQueueHandle
+                    memset(pInstance->pAtCommandBuffer, 0, U_SHORT_RANGE_EDM_STREAM_AT_COMMAND_LENGTH);
+                    memset(pInstance->pAtResponseBuffer, 0, U_SHORT_RANGE_EDM_STREAM_AT_RESPONSE_LENGTH);
+                    pInstance->eventQueueHandle
                         = uPortEventQueueOpen(eventHandler, "eventEdmStream",
                                               sizeof(uShortRangeEdmStreamEvent_t),
                                               U_EDM_STREAM_TASK_STACK_SIZE_BYTES,
                                               U_EDM_STREAM_TASK_PRIORITY,
                                               U_EDM_STREAM_EVENT_QUEUE_SIZE);
-                    if (gEdmStream.eventQueueHandle < 0) {
-                        gEdmStream.eventQueueHandle = -1;
+                    if (pInstance->eventQueueHandle < 0) {
+                        pInstance->eventQueueHandle = -1;
                     }
 
-                    gEdmStream.handle = 0;
-                    gEdmStream.uartHandle = uartHandle;
-                    gEdmStream.atHandle = NULL;
-                    gEdmStream.pAtCallback = NULL;
-                    gEdmStream.pAtCallbackParam = NULL;
-                    gEdmStream.pBtEventCallback = NULL;
-                    gEdmStream.pBtEventCallbackParam = NULL;
-                    gEdmStream.pBtDataCallback = NULL;
-                    gEdmStream.pBtDataCallbackParam = NULL;
-                    gEdmStream.pIpEventCallback = NULL;
-                    gEdmStream.pIpEventCallbackParam = NULL;
-                    gEdmStream.pIpDataCallback = NULL;
-                    gEdmStream.pIpDataCallbackParam = NULL;
-                    gEdmStream.pMqttEventCallback = NULL;
-                    gEdmStream.pMqttEventCallbackParam = NULL;
-                    gEdmStream.pMqttDataCallback = NULL;
-                    gEdmStream.pMqttDataCallbackParam = NULL;
-                    gEdmStream.atCommandCurrent = 0;
+                    pInstance->handle = handle;
+                    pInstance->uartHandle = uartHandle;
+                    pInstance->ignoreUartCallback = false;
+                    pInstance->atHandle = NULL;
+                    pInstance->pAtCallback = NULL;
+                    pInstance->pAtCallbackParam = NULL;
+                    pInstance->pBtEventCallback = NULL;
+                    pInstance->pBtEventCallbackParam = NULL;
+                    pInstance->pBtDataCallback = NULL;
+                    pInstance->pBtDataCallbackParam = NULL;
+                    pInstance->pIpEventCallback = NULL;
+                    pInstance->pIpEventCallbackParam = NULL;
+                    pInstance->pIpDataCallback = NULL;
+                    pInstance->pIpDataCallbackParam = NULL;
+                    pInstance->pMqttEventCallback = NULL;
+                    pInstance->pMqttEventCallbackParam = NULL;
+                    pInstance->pMqttDataCallback = NULL;
+                    pInstance->pMqttDataCallbackParam = NULL;
+                    pInstance->atCommandCurrent = 0;
+                    pInstance->atResponseLength = 0;
+                    pInstance->atResponseRead = 0;
+                    pInstance->rxBufferLength = 0;
+                    uShortRangeEdmParserInit(&(pInstance->parser), handle);
 
                     for (uint32_t i = 0; i < U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS; i++) {
-                        gEdmStream.connections[i].channel = -1;
-                        gEdmStream.connections[i].type = U_SHORT_RANGE_CONNECTION_TYPE_INVALID;
+                        pInstance->connections[i].channel = -1;
+                        pInstance->connections[i].type = U_SHORT_RANGE_CONNECTION_TYPE_INVALID;
                     }
 
-                    handleOrErrorCode = (uErrorCode_t)gEdmStream.handle;
+                    handleOrErrorCode = (uErrorCode_t)pInstance->handle;
                     flushUart(uartHandle);
                 }
             }
+            if ((handleOrErrorCode < 0) && (handle > 0)) {
+                // Pool 0 stays until deinitialisation, the others
+                // only exist while their stream is open
+                uShortRangeMemPoolDeInitPool(handle);
+            }
         }
-        uShortRangeEdmResetParser();
         U_PORT_MUTEX_UNLOCK(gMutex);
     }
 
@@ -1050,51 +1193,64 @@ int32_t uShortRangeEdmStreamOpen(int32_t uartHandle)
 
 void uShortRangeEdmStreamClose(int32_t handle)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
+
     if (gMutex != NULL) {
-        gEdmStream.ignoreUartCallback = true;
+        pInstance = pGetInstance(handle);
+        if (pInstance != NULL) {
+            pInstance->ignoreUartCallback = true;
+        }
         uPortMutexLock(gMutex);
 
-        if ((handle != -1) && (handle == gEdmStream.handle)) {
-            gEdmStream.handle = -1;
-            if (gEdmStream.uartHandle >= 0) {
-                uPortUartEventCallbackRemove(gEdmStream.uartHandle);
+        if ((pInstance != NULL) && (handle == pInstance->handle)) {
+            pInstance->handle = -1;
+            if (pInstance->uartHandle >= 0) {
+                uPortUartEventCallbackRemove(pInstance->uartHandle);
             }
-            gEdmStream.uartHandle = -1;
-            if (gEdmStream.eventQueueHandle >= 0) {
-                uPortEventQueueClose(gEdmStream.eventQueueHandle);
+            pInstance->uartHandle = -1;
+            if (pInstance->eventQueueHandle >= 0) {
+                uPortEventQueueClose(pInstance->eventQueueHandle);
             }
-            gEdmStream.eventQueueHandle = -1;
-            if (gEdmStream.atHandle != NULL) {
-                uAtClientStreamInterceptTx(gEdmStream.atHandle, NULL, NULL);
+            pInstance->eventQueueHandle = -1;
+            if (pInstance->atHandle != NULL) {
+                uAtClientStreamInterceptTx(pInstance->atHandle, NULL, NULL);
             }
-            gEdmStream.atHandle = NULL;
-            gEdmStream.pAtCallback = NULL;
-            gEdmStream.pAtCallbackParam = NULL;
-            gEdmStream.pBtEventCallback = NULL;
-            gEdmStream.pBtEventCallbackParam = NULL;
-            gEdmStream.pBtDataCallback = NULL;
-            gEdmStream.pBtDataCallbackParam = NULL;
-            gEdmStream.pIpEventCallback = NULL;
-            gEdmStream.pIpEventCallbackParam = NULL;
-            gEdmStream.pIpDataCallback = NULL;
-            gEdmStream.pIpDataCallbackParam = NULL;
-            gEdmStream.pMqttEventCallback = NULL;
-            gEdmStream.pMqttEventCallbackParam = NULL;
-            gEdmStream.pMqttDataCallback = NULL;
-            gEdmStream.pMqttDataCallbackParam = NULL;
-            uPortFree(gEdmStream.pAtCommandBuffer);
-            gEdmStream.pAtCommandBuffer = NULL;
-            uPortFree(gEdmStream.pAtResponseBuffer);
-            gEdmStream.pAtResponseBuffer = NULL;
+            pInstance->atHandle = NULL;
+            pInstance->pAtCallback = NULL;
+            pInstance->pAtCallbackParam = NULL;
+            pInstance->pBtEventCallback = NULL;
+            pInstance->pBtEventCallbackParam = NULL;
+            pInstance->pBtDataCallback = NULL;
+            pInstance->pBtDataCallbackParam = NULL;
+            pInstance->pIpEventCallback = NULL;
+            pInstance->pIpEventCallbackParam = NULL;
+            pInstance->pIpDataCallback = NULL;
+            pInstance->pIpDataCallbackParam = NULL;
+            pInstance->pMqttEventCallback = NULL;
+            pInstance->pMqttEventCallbackParam = NULL;
+            pInstance->pMqttDataCallback = NULL;
+            pInstance->pMqttDataCallbackParam = NULL;
+            uPortFree(pInstance->pAtCommandBuffer);
+            pInstance->pAtCommandBuffer = NULL;
+            uPortFree(pInstance->pAtResponseBuffer);
+            pInstance->pAtResponseBuffer = NULL;
             for (uint32_t i = 0; i < U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS; i++) {
-                gEdmStream.connections[i].channel = -1;
-                gEdmStream.connections[i].type = U_SHORT_RANGE_CONNECTION_TYPE_INVALID;
+                pInstance->connections[i].channel = -1;
+                pInstance->connections[i].type = U_SHORT_RANGE_CONNECTION_TYPE_INVALID;
+            }
+            pInstance->rxBufferLength = 0;
+            uShortRangeEdmResetParser(&(pInstance->parser));
+            if (handle > 0) {
+                // Pool 0 stays until deinitialisation, the others
+                // only exist while their stream is open
+                uShortRangeMemPoolDeInitPool(handle);
             }
         }
 
-        uShortRangeEdmResetParser();
         uPortMutexUnlock(gMutex);
-        gEdmStream.ignoreUartCallback = false;
+        if (pInstance != NULL) {
+            pInstance->ignoreUartCallback = false;
+        }
     }
 }
 
@@ -1103,16 +1259,18 @@ int32_t uShortRangeEdmStreamAtCallbackSet(int32_t handle,
                                           uEdmAtEventCallback_t pFunction,
                                           void *pParam)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-        if ((handle == gEdmStream.handle) && (pFunction != NULL)) {
-            gEdmStream.pAtCallback = pFunction;
-            gEdmStream.pAtCallbackParam = pParam;
+        if ((pInstance != NULL) && (pFunction != NULL)) {
+            pInstance->pAtCallback = pFunction;
+            pInstance->pAtCallbackParam = pParam;
             errorCode = U_ERROR_COMMON_SUCCESS;
         }
 
@@ -1126,21 +1284,23 @@ int32_t uShortRangeEdmStreamIpEventCallbackSet(int32_t handle,
                                                uEdmIpConnectionStatusCallback_t pFunction,
                                                void *pParam)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-        if (handle == gEdmStream.handle) {
-            if (pFunction != NULL && gEdmStream.pIpEventCallback == NULL) {
-                gEdmStream.pIpEventCallback = pFunction;
-                gEdmStream.pIpEventCallbackParam = pParam;
+        if (pInstance != NULL) {
+            if (pFunction != NULL && pInstance->pIpEventCallback == NULL) {
+                pInstance->pIpEventCallback = pFunction;
+                pInstance->pIpEventCallbackParam = pParam;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             } else if (pFunction == NULL) {
-                gEdmStream.pIpEventCallback = NULL;
-                gEdmStream.pIpEventCallbackParam = NULL;
+                pInstance->pIpEventCallback = NULL;
+                pInstance->pIpEventCallbackParam = NULL;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             }
         }
@@ -1162,21 +1322,23 @@ int32_t uShortRangeEdmStreamMqttEventCallbackSet(int32_t handle,
                                                  uEdmIpConnectionStatusCallback_t pFunction,
                                                  void *pParam)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-        if (handle == gEdmStream.handle) {
-            if (pFunction != NULL && gEdmStream.pMqttEventCallback == NULL) {
-                gEdmStream.pMqttEventCallback = pFunction;
-                gEdmStream.pMqttEventCallbackParam = pParam;
+        if (pInstance != NULL) {
+            if (pFunction != NULL && pInstance->pMqttEventCallback == NULL) {
+                pInstance->pMqttEventCallback = pFunction;
+                pInstance->pMqttEventCallbackParam = pParam;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             } else if (pFunction == NULL) {
-                gEdmStream.pMqttEventCallback = NULL;
-                gEdmStream.pMqttEventCallbackParam = NULL;
+                pInstance->pMqttEventCallback = NULL;
+                pInstance->pMqttEventCallbackParam = NULL;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             }
         }
@@ -1199,21 +1361,23 @@ int32_t uShortRangeEdmStreamBtEventCallbackSet(int32_t handle,
                                                uEdmBtConnectionStatusCallback_t pFunction,
                                                void *pParam)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-        if (handle == gEdmStream.handle) {
-            if (pFunction != NULL && gEdmStream.pBtEventCallback == NULL) {
-                gEdmStream.pBtEventCallback = pFunction;
-                gEdmStream.pBtEventCallbackParam = pParam;
+        if (pInstance != NULL) {
+            if (pFunction != NULL && pInstance->pBtEventCallback == NULL) {
+                pInstance->pBtEventCallback = pFunction;
+                pInstance->pBtEventCallbackParam = pParam;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             } else if (pFunction == NULL) {
-                gEdmStream.pBtEventCallback = NULL;
-                gEdmStream.pBtEventCallbackParam = NULL;
+                pInstance->pBtEventCallback = NULL;
+                pInstance->pBtEventCallbackParam = NULL;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             }
 
@@ -1237,48 +1401,50 @@ int32_t uShortRangeEdmStreamDataEventCallbackSet(int32_t handle,
                                                  uEdmDataEventCallback_t pFunction,
                                                  void *pParam)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-        if (handle == gEdmStream.handle) {
+        if (pInstance != NULL) {
             switch (type) {
 
                 case U_SHORT_RANGE_CONNECTION_TYPE_BT:
-                    if (pFunction != NULL && gEdmStream.pBtDataCallback == NULL) {
-                        gEdmStream.pBtDataCallback = pFunction;
-                        gEdmStream.pBtDataCallbackParam = pParam;
+                    if (pFunction != NULL && pInstance->pBtDataCallback == NULL) {
+                        pInstance->pBtDataCallback = pFunction;
+                        pInstance->pBtDataCallbackParam = pParam;
                         errorCode = U_ERROR_COMMON_SUCCESS;
                     } else if (pFunction == NULL) {
-                        gEdmStream.pBtDataCallback = NULL;
-                        gEdmStream.pBtDataCallbackParam = NULL;
+                        pInstance->pBtDataCallback = NULL;
+                        pInstance->pBtDataCallbackParam = NULL;
                         errorCode = U_ERROR_COMMON_SUCCESS;
                     }
                     break;
 
                 case U_SHORT_RANGE_CONNECTION_TYPE_IP:
-                    if (pFunction != NULL && gEdmStream.pIpDataCallback == NULL) {
-                        gEdmStream.pIpDataCallback = pFunction;
-                        gEdmStream.pIpDataCallbackParam = pParam;
+                    if (pFunction != NULL && pInstance->pIpDataCallback == NULL) {
+                        pInstance->pIpDataCallback = pFunction;
+                        pInstance->pIpDataCallbackParam = pParam;
                         errorCode = U_ERROR_COMMON_SUCCESS;
                     } else if (pFunction == NULL) {
-                        gEdmStream.pIpDataCallback = NULL;
-                        gEdmStream.pIpDataCallbackParam = NULL;
+                        pInstance->pIpDataCallback = NULL;
+                        pInstance->pIpDataCallbackParam = NULL;
                         errorCode = U_ERROR_COMMON_SUCCESS;
                     }
                     break;
 
                 case U_SHORT_RANGE_CONNECTION_TYPE_MQTT:
-                    if (pFunction != NULL && gEdmStream.pMqttDataCallback == NULL) {
-                        gEdmStream.pMqttDataCallback = pFunction;
-                        gEdmStream.pMqttDataCallbackParam = pParam;
+                    if (pFunction != NULL && pInstance->pMqttDataCallback == NULL) {
+                        pInstance->pMqttDataCallback = pFunction;
+                        pInstance->pMqttDataCallbackParam = pParam;
                         errorCode = U_ERROR_COMMON_SUCCESS;
                     } else if (pFunction == NULL) {
-                        gEdmStream.pMqttDataCallback = NULL;
-                        gEdmStream.pMqttDataCallbackParam = NULL;
+                        pInstance->pMqttDataCallback = NULL;
+                        pInstance->pMqttDataCallbackParam = NULL;
                         errorCode = U_ERROR_COMMON_SUCCESS;
                     }
                     break;
@@ -1305,27 +1471,32 @@ void uShortRangeEdmStreamDataEventCallbackRemove(int32_t handle,
 
 void uShortRangeEdmStreamSetAtHandle(int32_t handle, void *atHandle)
 {
-    if (handle == gEdmStream.handle) {
-        uAtClientStreamInterceptTx(atHandle, pInterceptTx, NULL);
-        gEdmStream.atHandle = atHandle;
+    uShortRangeEdmStreamInstance_t *pInstance = pGetInstance(handle);
+
+    if (pInstance != NULL) {
+        // The instance is the context for pInterceptTx()
+        uAtClientStreamInterceptTx(atHandle, pInterceptTx, (void *) pInstance);
+        pInstance->atHandle = atHandle;
     }
 }
 
 int32_t uShortRangeEdmStreamAtWrite(int32_t handle, const void *pBuffer,
                                     size_t sizeBytes)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
         sizeOrErrorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
-        if (gEdmStream.handle == handle && pBuffer != NULL && sizeBytes != 0) {
+        if (pInstance != NULL && pBuffer != NULL && sizeBytes != 0) {
             int32_t result;
             uint32_t sent = 0;
 
             do {
-                result = uartWrite(pBuffer, sizeBytes);
+                result = uartWrite(pInstance, pBuffer, sizeBytes);
                 if (result > 0) {
                     sent += result;
                 }
@@ -1343,28 +1514,31 @@ int32_t uShortRangeEdmStreamAtWrite(int32_t handle, const void *pBuffer,
 int32_t uShortRangeEdmStreamAtRead(int32_t handle, void *pBuffer,
                                    size_t sizeBytes)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
-        if (!gEdmStream.ignoreUartCallback) {
+        pInstance = pGetInstance(handle);
+        if ((pInstance == NULL) || !pInstance->ignoreUartCallback) {
             U_PORT_MUTEX_LOCK(gMutex);
+            pInstance = pGetInstance(handle);
 
             sizeOrErrorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
-            if (gEdmStream.handle == handle && pBuffer != NULL && sizeBytes != 0) {
-                sizeOrErrorCode = (int32_t)(gEdmStream.atResponseLength - gEdmStream.atResponseRead);
+            if (pInstance != NULL && pBuffer != NULL && sizeBytes != 0) {
+                sizeOrErrorCode = (int32_t)(pInstance->atResponseLength - pInstance->atResponseRead);
                 if (sizeOrErrorCode > 0) {
                     if (sizeBytes < (uint32_t)sizeOrErrorCode) {
                         sizeOrErrorCode = (int32_t)sizeBytes;
                     }
-                    memcpy(pBuffer, gEdmStream.pAtResponseBuffer + gEdmStream.atResponseRead, sizeOrErrorCode);
-                    gEdmStream.atResponseRead += sizeOrErrorCode;
+                    memcpy(pBuffer, pInstance->pAtResponseBuffer + pInstance->atResponseRead, sizeOrErrorCode);
+                    pInstance->atResponseRead += sizeOrErrorCode;
 
-                    if (gEdmStream.atResponseRead >= gEdmStream.atResponseLength) {
-                        gEdmStream.atResponseLength = 0;
-                        gEdmStream.atResponseRead = 0;
+                    if (pInstance->atResponseRead >= pInstance->atResponseLength) {
+                        pInstance->atResponseLength = 0;
+                        pInstance->atResponseRead = 0;
                         uEdmChLogLine(LOG_CH_AT_RX, "processed");
-                        processedEvent();
+                        processedEvent(pInstance);
                     }
                 }
             }
@@ -1382,14 +1556,16 @@ int32_t uShortRangeEdmStreamWrite(int32_t handle, int32_t channel,
                                   const void *pBuffer, size_t sizeBytes,
                                   uint32_t timeoutMs)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
         sizeOrErrorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
-        if (gEdmStream.handle == handle && channel >= 0 &&
+        if (pInstance != NULL && channel >= 0 &&
             (pBuffer != NULL || sizeBytes == 0)) {
-            uShortRangeEdmStreamConnections_t *pConnection = findConnection(channel);
+            uShortRangeEdmStreamConnections_t *pConnection = findConnection(pInstance, channel);
             if (pConnection != NULL) {
                 int32_t sent;
                 int32_t send;
@@ -1400,12 +1576,7 @@ int32_t uShortRangeEdmStreamWrite(int32_t handle, int32_t channel,
                 int64_t endTime;
 
                 do {
-                    send = ((int32_t)sizeBytes - sizeOrErrorCode);
-                    if (pConnection->type == U_SHORT_RANGE_CONNECTION_TYPE_BT) {
-                        if (((int32_t)sizeBytes - sizeOrErrorCode) > pConnection->bt.frameSize) {
-                            send = pConnection->bt.frameSize;
-                        }
-                    }
+                    send = getSegmentSize(pConnection, (int32_t)sizeBytes - sizeOrErrorCode);
 
 #ifdef U_CFG_SHORT_RANGE_EDM_STREAM_DEBUG
 # ifdef U_CFG_SHORT_RANGE_EDM_STREAM_DEBUG_DUMP_DATA
@@ -1418,10 +1589,11 @@ int32_t uShortRangeEdmStreamWrite(int32_t handle, int32_t channel,
 #endif
 
                     (void)uShortRangeEdmZeroCopyHeadData((uint8_t)channel, send, (char *)&head[0]);
-                    sent = uartWrite((void *)&head[0], U_SHORT_RANGE_EDM_DATA_HEAD_SIZE);
-                    sent += uartWrite((const void *)((const char *)pBuffer + sizeOrErrorCode), send);
+                    sent = uartWrite(pInstance, (void *)&head[0], U_SHORT_RANGE_EDM_DATA_HEAD_SIZE);
+                    sent += uartWrite(pInstance, (const void *)((const char *)pBuffer + sizeOrErrorCode),
+                                      send);
                     (void)uShortRangeEdmZeroCopyTail((char *)&tail[0]);
-                    sent += uartWrite((void *)&tail[0], U_SHORT_RANGE_EDM_TAIL_SIZE);
+                    sent += uartWrite(pInstance, (void *)&tail[0], U_SHORT_RANGE_EDM_TAIL_SIZE);
 
                     if (sent != (send + U_SHORT_RANGE_EDM_DATA_HEAD_SIZE + U_SHORT_RANGE_EDM_TAIL_SIZE)) {
                         sizeOrErrorCode = (int32_t)U_ERROR_COMMON_DEVICE_ERROR;
@@ -1440,22 +1612,79 @@ int32_t uShortRangeEdmStreamWrite(int32_t handle, int32_t channel,
     return sizeOrErrorCode;
 }
 
+int32_t uShortRangeEdmStreamWriteZeroCopy(int32_t handle, int32_t channel,
+                                          char *pBuffer, size_t sizeBytes,
+                                          uint32_t timeoutMs)
+{
+    int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    uShortRangeEdmStreamInstance_t *pInstance;
+    uShortRangeEdmStreamConnections_t *pConnection;
+    char saved[U_SHORT_RANGE_EDM_DATA_HEAD_SIZE + U_SHORT_RANGE_EDM_TAIL_SIZE];
+    char *pPacket;
+    int32_t send;
+    int32_t length;
+    int64_t startTime;
+
+    if (gMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
+
+        sizeOrErrorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pInstance != NULL) && (channel >= 0) && (pBuffer != NULL)) {
+            pConnection = findConnection(pInstance, channel);
+            if (pConnection != NULL) {
+                sizeOrErrorCode = 0;
+                startTime = uPortGetTickTimeMs();
+                do {
+                    send = getSegmentSize(pConnection, (int32_t)sizeBytes - sizeOrErrorCode);
+                    uEdmChLogLine(LOG_CH_DATA, "TX (%d bytes, zero copy)", send);
+                    // The header goes in the headroom or, for the second
+                    // and subsequent packets, over data that has already
+                    // been sent, and the tail over the first byte of the
+                    // data after this packet; save what was there so
+                    // that it can be put back afterwards
+                    pPacket = pBuffer + sizeOrErrorCode;
+                    length = U_SHORT_RANGE_EDM_DATA_HEAD_SIZE + send + U_SHORT_RANGE_EDM_TAIL_SIZE;
+                    memcpy(saved, pPacket, U_SHORT_RANGE_EDM_DATA_HEAD_SIZE);
+                    saved[U_SHORT_RANGE_EDM_DATA_HEAD_SIZE] = *(pPacket + length - 1);
+                    (void)uShortRangeEdmZeroCopyHeadData((uint8_t)channel, send, pPacket);
+                    (void)uShortRangeEdmZeroCopyTail(pPacket + length - 1);
+                    if (uartWrite(pInstance, pPacket, length) == length) {
+                        sizeOrErrorCode += send;
+                    } else {
+                        sizeOrErrorCode = (int32_t)U_ERROR_COMMON_DEVICE_ERROR;
+                    }
+                    memcpy(pPacket, saved, U_SHORT_RANGE_EDM_DATA_HEAD_SIZE);
+                    *(pPacket + length - 1) = saved[U_SHORT_RANGE_EDM_DATA_HEAD_SIZE];
+                } while ((sizeOrErrorCode >= 0) && ((int32_t)sizeBytes > sizeOrErrorCode) &&
+                         (uPortGetTickTimeMs() - startTime < timeoutMs));
+            }
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
 int32_t uShortRangeEdmStreamAtEventSend(int32_t handle, uint32_t eventBitMap)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-        if ((handle == 0) &&
-            (gEdmStream.eventQueueHandle >= 0) &&
+        if ((pInstance != NULL) &&
+            (pInstance->eventQueueHandle >= 0) &&
             // The only event we support right now
             (eventBitMap == U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
             uShortRangeEdmStreamEvent_t event = {0}; // Keep Valgrind happy
+            event.handle = handle;
             event.type = U_SHORT_RANGE_EDM_STREAM_EVENT_AT;
-            errorCode = uPortEventQueueSend(gEdmStream.eventQueueHandle,
+            errorCode = uPortEventQueueSend(pInstance->eventQueueHandle,
                                             &event, sizeof(uShortRangeEdmStreamEvent_t));
             if (errorCode != 0) {
                 uPortLog("U_SHO_EDM_STREAM: Failed to enqueue message\n");
@@ -1470,15 +1699,17 @@ int32_t uShortRangeEdmStreamAtEventSend(int32_t handle, uint32_t eventBitMap)
 
 bool uShortRangeEdmStreamAtEventIsCallback(int32_t handle)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     bool isEventCallback = false;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
-        if ((handle == gEdmStream.handle) &&
-            (gEdmStream.eventQueueHandle >= 0)) {
-            isEventCallback = uPortEventQueueIsTask(gEdmStream.eventQueueHandle);
+        if ((pInstance != NULL) &&
+            (pInstance->eventQueueHandle >= 0)) {
+            isEventCallback = uPortEventQueueIsTask(pInstance->eventQueueHandle);
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
@@ -1489,12 +1720,14 @@ bool uShortRangeEdmStreamAtEventIsCallback(int32_t handle)
 
 void uShortRangeEdmStreamAtCallbackRemove(int32_t handle)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
-        if (handle == gEdmStream.handle) {
-            gEdmStream.pAtCallback = NULL;
+        if (pInstance != NULL) {
+            pInstance->pAtCallback = NULL;
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
@@ -1504,16 +1737,18 @@ void uShortRangeEdmStreamAtCallbackRemove(int32_t handle)
 
 int32_t uShortRangeEdmStreamAtEventStackMinFree(int32_t handle)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-        if ((handle == gEdmStream.handle) &&
-            (gEdmStream.eventQueueHandle >= 0)) {
-            sizeOrErrorCode = uPortEventQueueStackMinFree(gEdmStream.eventQueueHandle);
+        if ((pInstance != NULL) &&
+            (pInstance->eventQueueHandle >= 0)) {
+            sizeOrErrorCode = uPortEventQueueStackMinFree(pInstance->eventQueueHandle);
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
@@ -1524,15 +1759,17 @@ int32_t uShortRangeEdmStreamAtEventStackMinFree(int32_t handle)
 
 int32_t uShortRangeEdmStreamAtGetReceiveSize(int32_t handle)
 {
+    uShortRangeEdmStreamInstance_t *pInstance;
     int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
 
     if (gMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gMutex);
+        pInstance = pGetInstance(handle);
 
         sizeOrErrorCode = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
-        if (handle == gEdmStream.handle) {
-            sizeOrErrorCode = gEdmStream.atResponseLength - gEdmStream.atResponseRead;
+        if (pInstance != NULL) {
+            sizeOrErrorCode = pInstance->atResponseLength - pInstance->atResponseRead;
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
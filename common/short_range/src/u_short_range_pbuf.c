@@ -28,6 +28,7 @@
 #include "u_short_range_module_type.h"
 #include "u_short_range.h"
 #include "u_short_range_edm.h"
+#include "u_short_range_edm_stream.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -39,10 +40,32 @@
 #ifndef U_SHORT_RANGE_PBUF_COUNT
 #define U_SHORT_RANGE_PBUF_COUNT      (32)
 #endif
+
+#ifndef U_SHORT_RANGE_PBUF_FREE_BATCH_SIZE
+// The most pbufs of a chain that are gathered up to be
+// returned to their memory pool in one go.
+#define U_SHORT_RANGE_PBUF_FREE_BATCH_SIZE (8)
+#endif
+
+#if (U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_SIZE <= U_SHORT_RANGE_EDM_BLK_SIZE) || \
+    (U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE <= U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_SIZE)
+# error The pbuf size classes must be in ascending order of size.
+#endif
+
+#if U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE > 0xFFFF
+# error U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE must fit in the uint16_t length of a pbuf.
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The geometry of a size class of a pbuf pool.
+ */
+typedef struct {
+    size_t blockSizeBytes; /**< the size of the data area of a pbuf. */
+    int32_t numBlocks;
+} uShortRangePbufSizeClass_t;
 
 /* ----------------------------------------------------------------
  * STATIC PROTOTYPES
@@ -52,49 +75,123 @@
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
-static uMemPoolDesc_t gPBufListPool = {0};
-static uMemPoolDesc_t gPBufPool = {0};
+/** The geometry of the size classes of a pbuf pool, smallest first.
+ */
+static const uShortRangePbufSizeClass_t gSizeClass[U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES] = {
+    {U_SHORT_RANGE_EDM_BLK_SIZE, U_SHORT_RANGE_EDM_BLK_COUNT},
+    {U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_SIZE, U_SHORT_RANGE_PBUF_SIZE_CLASS_1_BLK_COUNT},
+    {U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE, U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_COUNT}
+};
+
+/** One pbuf list pool and one pbuf pool, made up of a memory pool
+ * for each size class, for each EDM stream, indexed by the pool
+ * number.
+ */
+static uMemPoolDesc_t gPBufListPool[U_SHORT_RANGE_EDM_STREAM_MAX_NUM] = {0};
+static uMemPoolDesc_t gPBufPool[U_SHORT_RANGE_EDM_STREAM_MAX_NUM][U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES]
+    = {0};
+
+/** The number of pbufs appended to the pbuf lists of each pool, the
+ * rest of the statistics are kept by the memory pools themselves.
+ */
+static int32_t gPBufListNumPbufs[U_SHORT_RANGE_EDM_STREAM_MAX_NUM] = {0};
 
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Find the pool, out of the numPools pools at pPools, that pMem
+// came from, checking pool 0 first since that is by far the most
+// likely; returns NULL if pMem is from none of them.
+static uMemPoolDesc_t *pFindPool(uMemPoolDesc_t *pPools, size_t numPools, const void *pMem)
+{
+    uMemPoolDesc_t *pPool = NULL;
+
+    for (size_t x = 0; (x < numPools) && (pPool == NULL); x++) {
+        if (uMemPoolContains(&(pPools[x]), pMem)) {
+            pPool = &(pPools[x]);
+        }
+    }
+
+    return pPool;
+}
+
+// Take a pbuf from the given size class of the given pool.
+static uShortRangePbuf_t *pAllocFromSizeClass(int32_t pool, int32_t sizeClass)
+{
+    uShortRangePbuf_t *pBuf;
+
+    pBuf = (uShortRangePbuf_t *)uMemPoolAllocMem(&(gPBufPool[pool][sizeClass]));
+    if (pBuf != NULL) {
+        pBuf->length = 0;
+        pBuf->pNext = NULL;
+    }
+
+    return pBuf;
+}
+
+// Free a pbuf or a whole chain of them; consecutive pbufs of a chain
+// from the same memory pool are freed in one batch.
 static void freePbuf(uShortRangePbuf_t *pBuf, bool freeWholeChain)
 {
-    if (freeWholeChain) {
-        while (pBuf != NULL) {
-            uShortRangePbuf_t *pNext = pBuf->pNext;
-            // Basic sanity check - pbuf length should never be longer than pool block size
-            U_ASSERT(pBuf->length <= gPBufPool.blockSize);
-            uMemPoolFreeMem(&gPBufPool, pBuf);
+    uShortRangePbuf_t *pNext;
+    uMemPoolDesc_t *pMemPool;
+    uMemPoolDesc_t *pBatchPool = NULL;
+    void *pBatch[U_SHORT_RANGE_PBUF_FREE_BATCH_SIZE];
+    int32_t batchCount = 0;
+
+    while (pBuf != NULL) {
+        pNext = pBuf->pNext;
+        pMemPool = pFindPool(&(gPBufPool[0][0]),
+                             U_SHORT_RANGE_EDM_STREAM_MAX_NUM * U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES,
+                             pBuf);
+        // Basic sanity check - pbuf length should never be longer than pool block size
+        U_ASSERT((pMemPool == NULL) ||
+                 (pBuf->length <= pMemPool->blockSize - sizeof(uShortRangePbuf_t)));
+        if ((batchCount > 0) &&
+            ((pMemPool != pBatchPool) || (batchCount >= U_SHORT_RANGE_PBUF_FREE_BATCH_SIZE))) {
+            uMemPoolFreeBatch(pBatchPool, pBatch, batchCount);
+            batchCount = 0;
+        }
+        pBatchPool = pMemPool;
+        pBatch[batchCount] = pBuf;
+        batchCount++;
+        pBuf = NULL;
+        if (freeWholeChain) {
             pBuf = pNext;
         }
-    } else if (pBuf != NULL) {
-        // Basic sanity check - pbuf length should never be longer than pool block size
-        U_ASSERT(pBuf->length <= gPBufPool.blockSize);
-        uMemPoolFreeMem(&gPBufPool, pBuf);
     }
+    uMemPoolFreeBatch(pBatchPool, pBatch, batchCount);
 }
 
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
 
-int32_t uShortRangeMemPoolInit(void)
+int32_t uShortRangeMemPoolInitPool(int32_t pool)
 {
-    int32_t err = (int32_t)U_ERROR_COMMON_SUCCESS;
-
-    if ((gPBufListPool.mutex == NULL) && (gPBufPool.mutex == NULL)) {
-        err = uMemPoolInit(&gPBufListPool, sizeof(uShortRangePbufList_t),
-                           U_SHORT_RANGE_PBUFLIST_COUNT);
-
-        if (err == 0) {
-            err = uMemPoolInit(&gPBufPool, sizeof(uShortRangePbuf_t) + U_SHORT_RANGE_EDM_BLK_SIZE,
-                               U_SHORT_RANGE_EDM_BLK_COUNT);
+    int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
 
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM)) {
+        err = (int32_t)U_ERROR_COMMON_SUCCESS;
+        if ((gPBufListPool[pool].mutex == NULL) && (gPBufPool[pool][0].mutex == NULL)) {
+            // The pools are lock-free so that the EDM parser and the
+            // tasks reading from and writing to the streams don't
+            // serialise on a pool mutex
+            err = uMemPoolInitFlags(&(gPBufListPool[pool]), sizeof(uShortRangePbufList_t),
+                                    U_SHORT_RANGE_PBUFLIST_COUNT, U_MEMPOOL_FLAG_LOCK_FREE);
+            gPBufListNumPbufs[pool] = 0;
+            for (size_t x = 0; (x < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES) &&
+                 (err == (int32_t)U_ERROR_COMMON_SUCCESS); x++) {
+                // A size class with no blocks is simply left out
+                if (gSizeClass[x].numBlocks > 0) {
+                    err = uMemPoolInitFlags(&(gPBufPool[pool][x]),
+                                            sizeof(uShortRangePbuf_t) + gSizeClass[x].blockSizeBytes,
+                                            gSizeClass[x].numBlocks, U_MEMPOOL_FLAG_LOCK_FREE);
+                }
+            }
             if (err != (int32_t)U_ERROR_COMMON_SUCCESS) {
-                uMemPoolDeinit(&gPBufListPool);
-                // Deinit will also set the mutex to NULL again
+                uShortRangeMemPoolDeInitPool(pool);
             }
         }
     }
@@ -102,49 +199,169 @@ int32_t uShortRangeMemPoolInit(void)
     return err;
 }
 
+void uShortRangeMemPoolDeInitPool(int32_t pool)
+{
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM)) {
+        for (size_t x = 0; x < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES; x++) {
+            uMemPoolDeinit(&(gPBufPool[pool][x]));
+        }
+        uMemPoolDeinit(&(gPBufListPool[pool]));
+        // Deinit will also set the mutex to NULL again
+    }
+}
+
+int32_t uShortRangeMemPoolInit(void)
+{
+    return uShortRangeMemPoolInitPool(0);
+}
+
 void uShortRangeMemPoolDeInit(void)
 {
-    uMemPoolDeinit(&gPBufPool);
-    uMemPoolDeinit(&gPBufListPool);
-    // Deinit will also set the mutex to NULL again
+    for (int32_t x = 0; x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM; x++) {
+        uShortRangeMemPoolDeInitPool(x);
+    }
 }
 
-int32_t uShortRangePbufAlloc(uShortRangePbuf_t **ppBuf)
+int32_t uShortRangePbufAllocPool(int32_t pool, uShortRangePbuf_t **ppBuf)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-    *ppBuf = (uShortRangePbuf_t *)uMemPoolAllocMem(&gPBufPool);
+
+    *ppBuf = NULL;
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM)) {
+        *ppBuf = pAllocFromSizeClass(pool, 0);
+    }
     if (*ppBuf != NULL) {
-        (*ppBuf)->length = 0;
-        (*ppBuf)->pNext = NULL;
-        errorCode = gPBufPool.blockSize - sizeof(uShortRangePbuf_t);
+        errorCode = U_SHORT_RANGE_EDM_BLK_SIZE;
     }
     return errorCode;
 }
 
-uShortRangePbufList_t *pUShortRangePbufListAlloc(void)
+int32_t uShortRangePbufAllocSize(int32_t pool, size_t sizeBytes,
+                                 uShortRangePbuf_t **ppBuf)
 {
-    uShortRangePbufList_t *pList;
-    pList = (uShortRangePbufList_t *)uMemPoolAllocMem(&gPBufListPool);
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+    int32_t sizeClass = 0;
+
+    *ppBuf = NULL;
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM)) {
+        // Find the smallest size class that will hold sizeBytes,
+        // else the largest size class there is
+        for (int32_t x = 0; x < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES; x++) {
+            if (gSizeClass[x].numBlocks > 0) {
+                sizeClass = x;
+                if (gSizeClass[x].blockSizeBytes >= sizeBytes) {
+                    break;
+                }
+            }
+        }
+        // Try that, then the smaller size classes, then the larger ones
+        for (int32_t x = sizeClass; (x >= 0) && (*ppBuf == NULL); x--) {
+            *ppBuf = pAllocFromSizeClass(pool, x);
+            if (*ppBuf != NULL) {
+                errorCode = (int32_t) gSizeClass[x].blockSizeBytes;
+            }
+        }
+        for (int32_t x = sizeClass + 1; (x < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES) &&
+             (*ppBuf == NULL); x++) {
+            *ppBuf = pAllocFromSizeClass(pool, x);
+            if (*ppBuf != NULL) {
+                errorCode = (int32_t) gSizeClass[x].blockSizeBytes;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+int32_t uShortRangePbufGetStats(int32_t pool, int32_t sizeClass,
+                                uShortRangePbufStats_t *pStats)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uMemPoolStats_t memPoolStats;
+
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM) &&
+        (sizeClass >= 0) && (sizeClass < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES) &&
+        (pStats != NULL)) {
+        uMemPoolGetStats(&(gPBufPool[pool][sizeClass]), &memPoolStats);
+        pStats->blockSizeBytes = gSizeClass[sizeClass].blockSizeBytes;
+        pStats->numBlocks = gSizeClass[sizeClass].numBlocks;
+        pStats->numBlocksUsed = memPoolStats.usedBlockCount;
+        pStats->numBlocksUsedMax = memPoolStats.usedBlockCountMax;
+        pStats->numAllocs = memPoolStats.allocCount;
+        pStats->numFrees = memPoolStats.freeCount;
+        pStats->numAllocFails = memPoolStats.allocFailCount;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+int32_t uShortRangePbufGetListStats(int32_t pool, uShortRangePbufListStats_t *pStats)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uMemPoolStats_t memPoolStats;
+
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM) && (pStats != NULL)) {
+        uMemPoolGetStats(&(gPBufListPool[pool]), &memPoolStats);
+        pStats->numLists = memPoolStats.allocCount;
+        pStats->numListsUsed = memPoolStats.usedBlockCount;
+        pStats->numListsUsedMax = memPoolStats.usedBlockCountMax;
+        pStats->numListAllocFails = memPoolStats.allocFailCount;
+        pStats->numPbufs = gPBufListNumPbufs[pool];
+        pStats->averageLengthX100 = 0;
+        if (pStats->numLists > 0) {
+            pStats->averageLengthX100 = (int32_t) (((int64_t) pStats->numPbufs * 100) /
+                                                   pStats->numLists);
+        }
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+int32_t uShortRangePbufAlloc(uShortRangePbuf_t **ppBuf)
+{
+    return uShortRangePbufAllocPool(0, ppBuf);
+}
+
+uShortRangePbufList_t *pUShortRangePbufListAllocPool(int32_t pool)
+{
+    uShortRangePbufList_t *pList = NULL;
+
+    if ((pool >= 0) && (pool < U_SHORT_RANGE_EDM_STREAM_MAX_NUM)) {
+        pList = (uShortRangePbufList_t *)uMemPoolAllocMem(&(gPBufListPool[pool]));
+    }
     if (pList != NULL) {
         memset(pList, 0, sizeof(uShortRangePbufList_t));
     }
     return pList;
 }
 
+uShortRangePbufList_t *pUShortRangePbufListAlloc(void)
+{
+    return pUShortRangePbufListAllocPool(0);
+}
+
 void uShortRangePbufListFree(uShortRangePbufList_t *pBufList)
 {
     if (pBufList != NULL) {
         freePbuf(pBufList->pBufHead, true);
         pBufList->totalLen = 0;
-        uMemPoolFreeMem(&gPBufListPool, pBufList);
+        uMemPoolFreeMem(pFindPool(gPBufListPool, U_SHORT_RANGE_EDM_STREAM_MAX_NUM, pBufList),
+                        pBufList);
     }
 }
 
 int32_t uShortRangePbufListAppend(uShortRangePbufList_t *pBufList, uShortRangePbuf_t *pBuf)
 {
     int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+    uMemPoolDesc_t *pMemPool;
 
     if ((pBuf != NULL) && (pBufList != NULL)) {
+        pMemPool = pFindPool(gPBufListPool, U_SHORT_RANGE_EDM_STREAM_MAX_NUM, pBufList);
+        if (pMemPool != NULL) {
+            gPBufListNumPbufs[pMemPool - gPBufListPool]++;
+        }
         if (pBufList->pBufHead == NULL) {
             pBufList->pBufHead = pBuf;
         } else {
@@ -174,7 +391,8 @@ void uShortRangePbufListMerge(uShortRangePbufList_t *pOldList, uShortRangePbufLi
             *pOldList = *pNewList;
         }
 
-        uMemPoolFreeMem(&gPBufListPool, pNewList);
+        uMemPoolFreeMem(pFindPool(gPBufListPool, U_SHORT_RANGE_EDM_STREAM_MAX_NUM, pNewList),
+                        pNewList);
     }
 }
 
@@ -188,8 +406,8 @@ size_t uShortRangePbufListConsumeData(uShortRangePbufList_t *pBufList, char *pDa
     if ((pBufList != NULL) && (pData != NULL)) {
 
         for (pTemp = pBufList->pBufHead; (len != 0 && pTemp != NULL); pTemp = pNext) {
-            // Basic sanity check - pbuf length should never be longer than pool block size
-            U_ASSERT(pTemp->length <= gPBufPool.blockSize);
+            // Basic sanity check - pbuf length should never be longer than the largest block
+            U_ASSERT(pTemp->length <= U_SHORT_RANGE_PBUF_SIZE_CLASS_2_BLK_SIZE);
 
             if (pTemp->length <= len) {
                 // Copy the data to the given buffer
@@ -220,6 +438,46 @@ size_t uShortRangePbufListConsumeData(uShortRangePbufList_t *pBufList, char *pDa
     return copiedLen;
 }
 
+size_t uShortRangePbufListConsumeDataToRingBuffer(uShortRangePbufList_t *pBufList,
+                                                  uRingBuffer_t *pRingBuffer)
+{
+    size_t movedLen = 0;
+    size_t space;
+    size_t len;
+    uShortRangePbuf_t *pTemp;
+
+    if ((pBufList != NULL) && (pRingBuffer != NULL)) {
+        space = uRingBufferAvailableSize(pRingBuffer);
+        pTemp = pBufList->pBufHead;
+        while ((pTemp != NULL) && (space > 0)) {
+            len = pTemp->length;
+            if (len > space) {
+                len = space;
+            }
+            if (!uRingBufferAdd(pRingBuffer, &pTemp->data[0], len)) {
+                break;
+            }
+            movedLen += len;
+            space -= len;
+            pBufList->totalLen -= (uint16_t)len;
+            if (len == pTemp->length) {
+                // We are done with this pbuf - put it back in the pool
+                pBufList->pBufHead = pTemp->pNext;
+                if (pBufList->pBufHead == NULL) {
+                    pBufList->pBufTail = NULL;
+                }
+                freePbuf(pTemp, false);
+            } else {
+                // Partial move: move the remaining data to start
+                pTemp->length -= (uint16_t)len;
+                memmove(&pTemp->data[0], &pTemp->data[len], pTemp->length);
+            }
+            pTemp = pBufList->pBufHead;
+        }
+    }
+
+    return movedLen;
+}
 
 int32_t uShortRangePktListAppend(uShortRangePktList_t *pPktList,
                                  uShortRangePbufList_t *pPbufList)
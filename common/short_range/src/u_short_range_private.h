@@ -156,6 +156,13 @@ typedef struct uShortRangePrivateInstance_t {
     uWifiHttpCallback_t *pWifiHttpCallBack;
     uPortMutexHandle_t locMutex;
     volatile void *pLocContext;
+    void *pLocCache; /**< the location cache, owned by u_wifi_loc.c. */
+    uPortMutexHandle_t wifiScanCacheMutex;
+    void *pWifiScanCache; /**< the Wifi scan cache, owned by u_wifi.c. */
+    uint32_t wifiStaCfgHash; /**< hash of the Wifi station settings last
+                                  written by u_wifi.c, zero if not known. */
+    int32_t wifiStaCfgTicksLastRestart; /**< ticksLastRestart when
+                                             wifiStaCfgHash was written. */
     struct uShortRangePrivateInstance_t *pNext;
 } uShortRangePrivateInstance_t;
 
@@ -50,8 +50,10 @@
 #include "u_port_debug.h"
 #include "u_test_util_resource_check.h"
 #include "u_mempool.h"
+#include "u_ringbuffer.h"
 #include "u_short_range_pbuf.h"
 #include "u_short_range_edm.h" // For U_SHORT_RANGE_EDM_BLK_SIZE
+#include "u_short_range_edm_stream.h" // For U_SHORT_RANGE_EDM_STREAM_MAX_NUM
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -265,4 +267,212 @@ U_PORT_TEST_FUNCTION("[pbuf]", "pbufPktList")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Check that the per-EDM-stream pools are independent of one
+ * another and that a pbuf can be freed without knowing which
+ * pool it came from.
+ */
+U_PORT_TEST_FUNCTION("[pbuf]", "pbufPools")
+{
+    int32_t resourceCount;
+    int32_t pool = U_SHORT_RANGE_EDM_STREAM_MAX_NUM - 1;
+    uShortRangePbufList_t *pPbufList;
+    uShortRangePbuf_t *pBuf;
+    int32_t numOfBlks = 0;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    U_PORT_TEST_ASSERT(uShortRangeMemPoolInit() == (int32_t)U_ERROR_COMMON_SUCCESS);
+    U_PORT_TEST_ASSERT(uShortRangeMemPoolInitPool(pool) == (int32_t)U_ERROR_COMMON_SUCCESS);
+    U_PORT_TEST_ASSERT(uShortRangeMemPoolInitPool(U_SHORT_RANGE_EDM_STREAM_MAX_NUM) < 0);
+    U_PORT_TEST_ASSERT(uShortRangePbufAllocPool(-1, &pBuf) < 0);
+    U_PORT_TEST_ASSERT(pBuf == NULL);
+
+    // Use up the whole of the last pool, putting the pbufs
+    // in a list allocated from pool 0
+    pPbufList = pUShortRangePbufListAlloc();
+    U_PORT_TEST_ASSERT(pPbufList != NULL);
+    while (uShortRangePbufAllocPool(pool, &pBuf) > 0) {
+        pBuf->length = 1;
+        U_PORT_TEST_ASSERT(uShortRangePbufListAppend(pPbufList, pBuf) == 0);
+        numOfBlks++;
+    }
+    U_TEST_PRINT_LINE("%d pbuf(s) in pool %d.", numOfBlks, pool);
+    U_PORT_TEST_ASSERT(numOfBlks == U_SHORT_RANGE_EDM_BLK_COUNT);
+    U_PORT_TEST_ASSERT(pUShortRangePbufListAllocPool(pool) != NULL);
+
+    if (pool > 0) {
+        // Pool 0 should be unaffected
+        U_PORT_TEST_ASSERT(uShortRangePbufAlloc(&pBuf) == U_SHORT_RANGE_EDM_BLK_SIZE);
+        pBuf->length = 1;
+        U_PORT_TEST_ASSERT(uShortRangePbufListAppend(pPbufList, pBuf) == 0);
+    }
+
+    // Freeing the list should return every pbuf to its own pool
+    uShortRangePbufListFree(pPbufList);
+    U_PORT_TEST_ASSERT(uShortRangePbufAllocPool(pool, &pBuf) == U_SHORT_RANGE_EDM_BLK_SIZE);
+    pPbufList = pUShortRangePbufListAlloc();
+    U_PORT_TEST_ASSERT(pPbufList != NULL);
+    U_PORT_TEST_ASSERT(uShortRangePbufListAppend(pPbufList, pBuf) == 0);
+    uShortRangePbufListFree(pPbufList);
+
+    uShortRangeMemPoolDeInit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test that pbufs are taken from the size class that suits the
+ * amount of data and that the statistics follow.
+ */
+U_PORT_TEST_FUNCTION("[pbuf]", "pbufSizeClasses")
+{
+    int32_t resourceCount;
+    uShortRangePbufList_t *pPbufList;
+    uShortRangePbuf_t *pBuf;
+    uShortRangePbufStats_t stats[U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES];
+    uShortRangePbufListStats_t listStats;
+    int32_t sizeBytes;
+    int32_t numOfBlks = 0;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    U_PORT_TEST_ASSERT(uShortRangeMemPoolInit() == (int32_t)U_ERROR_COMMON_SUCCESS);
+    U_PORT_TEST_ASSERT(uShortRangePbufGetStats(0, U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES,
+                                               &(stats[0])) < 0);
+    for (int32_t x = 0; x < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES; x++) {
+        U_PORT_TEST_ASSERT(uShortRangePbufGetStats(0, x, &(stats[x])) == 0);
+        U_TEST_PRINT_LINE("size class %d: %d pbuf(s) of %d byte(s).", x,
+                          stats[x].numBlocks, (int32_t) stats[x].blockSizeBytes);
+        U_PORT_TEST_ASSERT((stats[x].numBlocksUsed == 0) && (stats[x].numAllocs == 0));
+    }
+    U_PORT_TEST_ASSERT(stats[0].blockSizeBytes == U_SHORT_RANGE_EDM_BLK_SIZE);
+
+    // A small amount of data should come from size class 0,
+    // a packet the size of a TCP segment should need only the
+    // large pbufs
+    pPbufList = pUShortRangePbufListAlloc();
+    U_PORT_TEST_ASSERT(pPbufList != NULL);
+    U_PORT_TEST_ASSERT(uShortRangePbufAllocSize(0, 10, &pBuf) == U_SHORT_RANGE_EDM_BLK_SIZE);
+    pBuf->length = 10;
+    U_PORT_TEST_ASSERT(uShortRangePbufListAppend(pPbufList, pBuf) == 0);
+    for (int32_t remaining = 1400; remaining > 0; remaining -= sizeBytes) {
+        sizeBytes = uShortRangePbufAllocSize(0, remaining, &pBuf);
+        U_PORT_TEST_ASSERT(sizeBytes > 0);
+        if (sizeBytes > remaining) {
+            sizeBytes = remaining;
+        }
+        pBuf->length = (uint16_t) sizeBytes;
+        U_PORT_TEST_ASSERT(uShortRangePbufListAppend(pPbufList, pBuf) == 0);
+        numOfBlks++;
+    }
+    U_TEST_PRINT_LINE("1400 bytes took %d pbuf(s).", numOfBlks);
+    U_PORT_TEST_ASSERT(numOfBlks < (1400 / U_SHORT_RANGE_EDM_BLK_SIZE));
+    U_PORT_TEST_ASSERT(pPbufList->totalLen == 1410);
+    U_PORT_TEST_ASSERT(uShortRangePbufGetStats(0, 0, &(stats[0])) == 0);
+    U_PORT_TEST_ASSERT((stats[0].numBlocksUsed == 1) && (stats[0].numAllocs == 1));
+    U_PORT_TEST_ASSERT(uShortRangePbufGetListStats(0, &listStats) == 0);
+    U_TEST_PRINT_LINE("%d pbuf list(s), average chain length %d.%02d.", listStats.numLists,
+                      listStats.averageLengthX100 / 100, listStats.averageLengthX100 % 100);
+    U_PORT_TEST_ASSERT((listStats.numLists == 1) && (listStats.numListsUsed == 1));
+    U_PORT_TEST_ASSERT(listStats.numPbufs == numOfBlks + 1);
+    U_PORT_TEST_ASSERT(listStats.averageLengthX100 == (numOfBlks + 1) * 100);
+
+    // Free the lot: nothing should be in use but the peak
+    // should be remembered
+    uShortRangePbufListFree(pPbufList);
+    U_PORT_TEST_ASSERT(uShortRangePbufGetListStats(0, &listStats) == 0);
+    U_PORT_TEST_ASSERT((listStats.numListsUsed == 0) && (listStats.numListsUsedMax == 1));
+    numOfBlks = 0;
+    for (int32_t x = 0; x < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES; x++) {
+        U_PORT_TEST_ASSERT(uShortRangePbufGetStats(0, x, &(stats[x])) == 0);
+        U_PORT_TEST_ASSERT(stats[x].numBlocksUsed == 0);
+        U_PORT_TEST_ASSERT(stats[x].numFrees == stats[x].numAllocs);
+        U_PORT_TEST_ASSERT(stats[x].numBlocksUsedMax <= stats[x].numAllocs);
+        numOfBlks += stats[x].numBlocksUsedMax;
+    }
+    U_PORT_TEST_ASSERT(numOfBlks > 1);
+
+    uShortRangeMemPoolDeInit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test moving data from a pbuf list into a ring buffer.
+ */
+U_PORT_TEST_FUNCTION("[pbuf]", "pbufToRingBuffer")
+{
+    int32_t resourceCount;
+    uShortRangePbufList_t *pPbufList;
+    uShortRangePbuf_t *pBuf;
+    uRingBuffer_t ringBuffer;
+    // Room for a pbuf and a half, +1 for pointer-wrap
+    char linearBuffer[U_SHORT_RANGE_EDM_BLK_SIZE + (U_SHORT_RANGE_EDM_BLK_SIZE / 2) + 1];
+    char buffer[U_SHORT_RANGE_EDM_BLK_SIZE * 3];
+    size_t totalLen = 0;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    U_PORT_TEST_ASSERT(uShortRangeMemPoolInit() == (int32_t)U_ERROR_COMMON_SUCCESS);
+    U_PORT_TEST_ASSERT(uRingBufferCreate(&ringBuffer, linearBuffer, sizeof(linearBuffer)) == 0);
+
+    // Three pbufs full of a counting pattern
+    pPbufList = pUShortRangePbufListAlloc();
+    U_PORT_TEST_ASSERT(pPbufList != NULL);
+    for (size_t x = 0; x < 3; x++) {
+        U_PORT_TEST_ASSERT(uShortRangePbufAlloc(&pBuf) == U_SHORT_RANGE_EDM_BLK_SIZE);
+        for (size_t y = 0; y < U_SHORT_RANGE_EDM_BLK_SIZE; y++) {
+            pBuf->data[pBuf->length++] = (char) totalLen++;
+        }
+        U_PORT_TEST_ASSERT(uShortRangePbufListAppend(pPbufList, pBuf) == 0);
+    }
+
+    // Only a pbuf and a half should fit, the second pbuf being split
+    U_PORT_TEST_ASSERT(uShortRangePbufListConsumeDataToRingBuffer(pPbufList, &ringBuffer) ==
+                       sizeof(linearBuffer) - 1);
+    U_PORT_TEST_ASSERT(pPbufList->totalLen == totalLen - (sizeof(linearBuffer) - 1));
+    U_PORT_TEST_ASSERT(uShortRangePbufListConsumeDataToRingBuffer(pPbufList, &ringBuffer) == 0);
+
+    // Empty the ring buffer and move the rest through it: the
+    // data should come out in order
+    totalLen = uRingBufferRead(&ringBuffer, buffer, sizeof(buffer));
+    while (pPbufList->totalLen > 0) {
+        U_PORT_TEST_ASSERT(uShortRangePbufListConsumeDataToRingBuffer(pPbufList, &ringBuffer) > 0);
+        totalLen += uRingBufferRead(&ringBuffer, buffer + totalLen, sizeof(buffer) - totalLen);
+    }
+    U_PORT_TEST_ASSERT(totalLen == sizeof(buffer));
+    for (size_t x = 0; x < totalLen; x++) {
+        U_PORT_TEST_ASSERT(buffer[x] == (char) x);
+    }
+    U_PORT_TEST_ASSERT(pPbufList->pBufHead == NULL);
+    uShortRangePbufListFree(pPbufList);
+
+    uRingBufferDelete(&ringBuffer);
+    uShortRangeMemPoolDeInit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 // End of file
@@ -77,6 +77,41 @@ extern "C" {
 # define U_SOCK_CLOSE_TIMEOUT_SECONDS 60
 #endif
 
+#ifndef U_SOCK_DNS_CACHE_NUM_ENTRIES
+/** The number of entries in the cache of host name look-ups
+ * kept by uSockGetHostByName(); when the cache is full the
+ * oldest entry is replaced.  Set this to 0 to switch the cache
+ * off.
+ */
+# define U_SOCK_DNS_CACHE_NUM_ENTRIES 4
+#endif
+
+#ifndef U_SOCK_DNS_CACHE_TTL_SECONDS
+/** How long a successful host name look-up remains in the
+ * cache of uSockGetHostByName().  The modules do not report the
+ * time-to-live of the DNS record so this should be kept below
+ * the time-to-live of the records of the hosts you look up.
+ */
+# define U_SOCK_DNS_CACHE_TTL_SECONDS 300
+#endif
+
+#ifndef U_SOCK_DNS_CACHE_NEGATIVE_TTL_SECONDS
+/** How long a failed host name look-up, one where the host was
+ * not found, remains in the cache of uSockGetHostByName(); other
+ * failures (e.g. a timeout) are not cached.  Set this to 0 to
+ * switch off negative caching.
+ */
+# define U_SOCK_DNS_CACHE_NEGATIVE_TTL_SECONDS 30
+#endif
+
+#ifndef U_SOCK_DNS_CACHE_HOST_NAME_MAX_LENGTH_BYTES
+/** The longest host name that will be stored in the cache
+ * of uSockGetHostByName(), not including the null terminator;
+ * look-ups of longer host names are not cached.
+ */
+# define U_SOCK_DNS_CACHE_HOST_NAME_MAX_LENGTH_BYTES 64
+#endif
+
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS: SOCKET OPTIONS FOR SOCKET LEVEL (-1)
  * -------------------------------------------------------------- */
@@ -190,6 +225,22 @@ extern "C" {
  */
 #define U_SOCK_OPT_NO_CHECK     0x100a
 
+/** Socket option: u-blox specific, NOT part of the BSD
+ * sockets API, currently only supported on cellular TCP
+ * sockets.  The option value is an int32_t: set it to 1
+ * to put a connected socket into direct-link (transparent)
+ * mode, where the serial interface to the module is handed
+ * to the socket and uSockRead()/uSockWrite() move data with
+ * no per-chunk AT command overhead, or 0 to return the
+ * serial interface to AT command mode.  While in direct-link
+ * mode the AT interface is held locked: nothing else
+ * (including URCs) can use it and all operations on the
+ * socket, including leaving direct-link mode, MUST be made
+ * from the task that entered it.  Closing the socket also
+ * leaves direct-link mode.
+ */
+#define U_SOCK_OPT_DIRECT_LINK  0x8001
+
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS: SOCKET OPTIONS FOR IP LEVEL (0)
  * -------------------------------------------------------------- */
@@ -285,10 +336,9 @@ extern "C" {
 
 /** Determine if the bit corresponding to a given file descriptor is set.
  */
-#define U_SOCK_FD_ISSET(d, pSet) if (((d) >= 0) &&                           \
-                                     ((d) < U_SOCK_DESCRIPTOR_SET_SIZE)) {   \
-                                     (*(pSet))[(d) / 8] & (1 << ((d) & 7));  \
-                                 }
+#define U_SOCK_FD_ISSET(d, pSet) ((((d) >= 0) &&                                \
+                                   ((d) < U_SOCK_DESCRIPTOR_SET_SIZE)) &&    \
+                                  (((*(pSet))[(d) / 8] & (1 << ((d) & 7))) != 0))
 
 /* ----------------------------------------------------------------
  * TYPES
@@ -360,6 +410,43 @@ typedef struct {
     int32_t lingerSeconds;  //<! linger time in seconds.
 } uSockLinger_t;
 
+/** Statistics for a socket, as returned by uSockStatsGet().
+ * The average time taken by a write is writeTimeTotalMs / numWrites,
+ * and likewise for reads.  Reads include uSockReceiveFrom() and writes
+ * include uSockSendTo().
+ */
+typedef struct {
+    int32_t bytesSent;        //<! the number of bytes sent.
+    int32_t bytesReceived;    //<! the number of bytes received.
+    int32_t numWrites;        //<! the number of calls that tried to send data.
+    int32_t numReads;         //<! the number of calls that tried to receive data.
+    int32_t numWouldBlock;    //<! the number of calls that gave #U_SOCK_EWOULDBLOCK.
+    int32_t writeTimeTotalMs; //<! the total time spent in writes.
+    int32_t writeTimePeakMs;  //<! the longest time spent in a single write.
+    int32_t readTimeTotalMs;  //<! the total time spent in reads.
+    int32_t readTimePeakMs;   //<! the longest time spent in a single read.
+    int32_t blockedTimeMs;    //<! the part of readTimeTotalMs spent waiting for data.
+} uSockStats_t;
+
+/** One entry in a uSockReadBatch() call.
+ */
+typedef struct {
+    uSockDescriptor_t descriptor; //<! the descriptor of the socket to read from.
+    void *pData;                  //<! a buffer in which to put the received data.
+    size_t dataSizeBytes;         //<! the number of bytes of storage at pData.
+    int32_t negErrnoOrSize;       //<! output: bytes received or negated U_SOCK_Exxx.
+} uSockReadBatch_t;
+
+/** One datagram in a uSockSendToBatch() or uSockReceiveFromBatch()
+ * call.
+ */
+typedef struct {
+    uSockAddress_t *pAddress; //<! the remote address to send to/received from.
+    void *pData;              //<! the datagram to send or a buffer to receive into.
+    size_t dataSizeBytes;     //<! the datagram length or the storage at pData.
+    int32_t negErrnoOrSize;   //<! output: bytes sent/received or negated U_SOCK_Exxx.
+} uSockDatagram_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: CREATE/OPEN/CLOSE/CLEAN-UP
  * -------------------------------------------------------------- */
@@ -386,6 +473,14 @@ int32_t uSockCreate(uDeviceHandle_t devHandle, uSockType_t type,
  * IMPORTANT: where the underlying transport is cellular this function
  * may not return for up to #U_CELL_SOCK_DNS_LOOKUP_TIME_SECONDS.
  *
+ * The exception is a non-blocking (see uSockBlockingSet()) TCP socket
+ * on a cellular module that supports asynchronous connection: then
+ * this function returns immediately with errno #U_SOCK_EINPROGRESS
+ * and uSockSelect() will report the socket as writeable once the
+ * connection attempt is complete.  Calling this function again while
+ * the attempt is in progress gives #U_SOCK_EALREADY; if the attempt
+ * failed the next call returns the reason in errno.
+ *
  * @param descriptor     the descriptor of the socket.
  * @param pRemoteAddress the address of the remote host to connect
  *                       to.
@@ -574,6 +669,51 @@ int32_t uSockReceiveFrom(uSockDescriptor_t descriptor,
                          uSockAddress_t *pRemoteAddress,
                          void *pData, size_t dataSizeBytes);
 
+/** Send several datagrams, the equivalent of sendmmsg().  On a
+ * cellular module all of the datagrams are sent while holding the
+ * AT interface once, rather than once per uSockSendTo(), which
+ * cuts the overhead of sending bursts of small datagrams; on other
+ * underlying transports the datagrams are sent one at a time.
+ * Sending stops at the first datagram that fails.
+ *
+ * @param descriptor       the descriptor of the socket.
+ * @param[in,out] pDatagrams the datagrams to send; the pAddress
+ *                         field of each may be NULL, in which case
+ *                         the address from the uSockConnect() call
+ *                         is used, and the outcome of each is
+ *                         written to its negErrnoOrSize field; each
+ *                         datagram must contain at least one byte.
+ * @param numDatagrams     the number of entries at pDatagrams.
+ * @return                 on success the number of datagrams sent
+ *                         else negative error code (and errno will
+ *                         also be set to a value from u_sock_errno.h).
+ */
+int32_t uSockSendToBatch(uSockDescriptor_t descriptor,
+                         uSockDatagram_t *pDatagrams,
+                         size_t numDatagrams);
+
+/** Receive several datagrams, the equivalent of recvmmsg().  If
+ * the socket is blocking this waits, as uSockReceiveFrom() would,
+ * for the first datagram only; any further datagrams already
+ * waiting are then collected without blocking, on a cellular
+ * module all under one hold of the AT interface.
+ *
+ * @param descriptor       the descriptor of the socket.
+ * @param[in,out] pDatagrams buffers for the datagrams; the pAddress
+ *                         field of each may be NULL, else the address
+ *                         of the sender is written there, and the
+ *                         outcome of each is written to its
+ *                         negErrnoOrSize field.  Entries after the
+ *                         last datagram received are not touched.
+ * @param numDatagrams     the number of entries at pDatagrams.
+ * @return                 on success the number of datagrams received
+ *                         else negative error code (and errno will
+ *                         also be set to a value from u_sock_errno.h).
+ */
+int32_t uSockReceiveFromBatch(uSockDescriptor_t descriptor,
+                              uSockDatagram_t *pDatagrams,
+                              size_t numDatagrams);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: STREAM (TCP)
  * -------------------------------------------------------------- */
@@ -604,6 +744,23 @@ int32_t uSockWrite(uSockDescriptor_t descriptor,
 int32_t uSockRead(uSockDescriptor_t descriptor,
                   void *pData, size_t dataSizeBytes);
 
+/** Receive whatever data is waiting on several connected TCP sockets,
+ * e.g. those that uSockSelect() has reported as readable, in one
+ * call.  Where the sockets are on a cellular module the AT interface
+ * is locked just once for all of that module's sockets, rather than
+ * once per uSockRead().  This never blocks, whatever the
+ * uSockBlockingSet() setting of the sockets: a socket with nothing
+ * to read is given #U_SOCK_EWOULDBLOCK.
+ *
+ * @param[in,out] pBatch the sockets and buffers; the outcome of each
+ *                       is written to its negErrnoOrSize field.
+ * @param numItems       the number of entries at pBatch.
+ * @return               the total number of bytes received else
+ *                       negative error code (and errno will also be
+ *                       set to a value from u_sock_errno.h).
+ */
+int32_t uSockReadBatch(uSockReadBatch_t *pBatch, size_t numItems);
+
 /** Prepare a TCP socket for being closed.
  * This is provided for BSD socket compatibility however
  * it may not be used under the hood other than to prevent
@@ -707,6 +864,13 @@ int32_t uSockAccept(uSockDescriptor_t descriptor,
                     uSockAddress_t *pRemoteAddress);
 
 /** Select: wait for one of a set of sockets to become unblocked.
+ *
+ * This does not poll: it sleeps until the underlying layer reports
+ * received data or a socket closure, or the timeout expires.
+ * Open sockets are always writeable, since a write waits for the
+ * underlying layer itself, and a descriptor which is no longer
+ * open is marked as both readable and in exception, so that the
+ * application finds out on its next call.
  *
  * @param maxDescriptor         the highest numbered descriptor in the
  *                              sets that follow to select on + 1.
@@ -720,6 +884,7 @@ int32_t uSockAccept(uSockDescriptor_t descriptor,
  *                              exceptional conditions. May be NULL.
  * @param timeMs                the timeout for the select operation
  *                              in milliseconds.
+ *
  * @return                      a positive value if an unblock
  *                              occurred, zero on timeout, negative
  *                              on any other error.  Use
@@ -741,6 +906,18 @@ int32_t uSockSelect(int32_t maxDescriptor,
 
 int32_t uSockGetTotalBytesSent(uSockDescriptor_t descriptor);
 
+/** Get the statistics of a socket: throughput, number of calls and
+ * the time they took, useful for finding out where a data pipeline
+ * is stalling.  The statistics cover the lifetime of the socket.
+ *
+ * @param descriptor  the descriptor of the socket.
+ * @param pStats      a place to put the statistics; cannot be NULL.
+ * @return            zero on success else negative error code (and
+ *                    errno will also be set to a value from
+ *                    u_sock_errno.h).
+ */
+int32_t uSockStatsGet(uSockDescriptor_t descriptor, uSockStats_t *pStats);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: FINDING ADDRESSES
  * -------------------------------------------------------------- */
@@ -791,6 +968,17 @@ int32_t uSockGetLocalAddress(uSockDescriptor_t descriptor,
 int32_t uSockGetHostByName(uDeviceHandle_t devHandle, const char *pHostName,
                            uSockIpAddress_t *pHostIpAddress);
 
+/** Flush the cache of host name look-ups kept by
+ * uSockGetHostByName() (see #U_SOCK_DNS_CACHE_NUM_ENTRIES), e.g.
+ * because a host is known to have moved or the network has
+ * changed.
+ *
+ * @param devHandle  the handle of the network whose cached
+ *                   look-ups should be flushed; use NULL to
+ *                   flush the whole cache.
+ */
+void uSockGetHostByNameCacheFlush(uDeviceHandle_t devHandle);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: ADDRESS CONVERSION
  * -------------------------------------------------------------- */
@@ -315,6 +315,7 @@
 #include "stdint.h"        // int32_t etc.
 #include "stdbool.h"
 #include "string.h"        // strlen(), strchr(), strtol()
+#include "ctype.h"         // tolower()
 #include "stdio.h"         // snprintf()
 #include "sys/time.h"      // mktime() and struct timeval in most cases
 
@@ -333,6 +334,8 @@
 #include "u_port_heap.h"
 #include "u_port_debug.h"
 
+#include "u_trace.h"
+
 #include "u_sock.h"
 #include "u_sock_security.h"
 #include "u_sock_errno.h"
@@ -356,6 +359,10 @@
 # define U_SOCK_NUM_STATIC_SOCKETS     7
 #endif
 
+/** The entry in gpContainerTable[] for a socket descriptor.
+ */
+#define U_SOCK_DESCRIPTOR_SLOT(d) ((size_t) (d) % U_SOCK_MAX_NUM_SOCKETS)
+
 /** Increment a socket descriptor.
  */
 #define U_SOCK_INC_DESCRIPTOR(d)  (d)++;         \
@@ -371,6 +378,7 @@
  */
 typedef enum {
     U_SOCK_STATE_CREATED,   /**< Freshly created, unsullied. */
+    U_SOCK_STATE_CONNECTING, /**< Non-blocking TCP connect in progress. */
     U_SOCK_STATE_CONNECTED, /**< TCP connected or UDP has an address. */
     U_SOCK_STATE_SHUTDOWN_FOR_READ,  /**< Block all reads. */
     U_SOCK_STATE_SHUTDOWN_FOR_WRITE, /**< Block all writes. */
@@ -397,13 +405,19 @@ typedef struct {
     uSockState_t state;
     uSockAddress_t remoteAddress;
     int64_t receiveTimeoutMs;
-    int32_t bytesSent;
+    uSockStats_t stats;
+    int32_t connectErrno; /**< The failure of a non-blocking connect,
+                               to be reported by uSockConnect(). */
     uSecurityTlsContext_t *pSecurityContext;
     void (*pDataCallback) (void *);
     void *pDataCallbackParameter;
     void (*pClosedCallback) (void *);
     void *pClosedCallbackParameter;
     bool blocking; // At end to optimise structure packing
+    bool dataSignalled; /**< Set when the underlying layer indicates
+                             that data has arrived, cleared when a
+                             receive finds nothing; used by
+                             uSockSelect(). */
 } uSockSocket_t;
 
 /** A socket container.
@@ -416,6 +430,27 @@ typedef struct uSockContainer_t {
     bool isStatic; // At end to optimise structure packing
 } uSockContainer_t;
 
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+/** An entry in the cache of host name look-ups.
+ */
+typedef struct {
+    uDeviceHandle_t devHandle; /**< NULL if the entry is not in use. */
+    char hostName[U_SOCK_DNS_CACHE_HOST_NAME_MAX_LENGTH_BYTES + 1];
+    uSockIpAddress_t ipAddress;
+    int32_t errnoLocal;        /**< U_SOCK_ENONE for a successful look-up,
+                                    else the errno of a failed one. */
+    int32_t timeMs;            /**< when the entry was stored. */
+} uSockDnsCacheEntry_t;
+#endif
+
+/** Something waiting in uSockSelect(): the semaphore is given
+ * whenever an event that might unblock a socket occurs.
+ */
+typedef struct uSockSelectWaiter_t {
+    uPortSemaphoreHandle_t semaphoreHandle;
+    struct uSockSelectWaiter_t *pNext;
+} uSockSelectWaiter_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -436,6 +471,13 @@ static uPortMutexHandle_t gMutexCallbacks = NULL;
  */
 static uSockContainer_t *gpContainerListHead = NULL;
 
+/** Direct-indexed table of the containers in the list, indexed
+ * by U_SOCK_DESCRIPTOR_SLOT(descriptor), so that finding a socket
+ * does not mean walking the list; descriptors are only ever handed
+ * out where their slot is free.
+ */
+static uSockContainer_t *gpContainerTable[U_SOCK_MAX_NUM_SOCKETS] = {0};
+
 /** The next descriptor to use.
  */
 static uSockDescriptor_t gNextDescriptor = 0;
@@ -444,6 +486,17 @@ static uSockDescriptor_t gNextDescriptor = 0;
  */
 static uSockContainer_t gStaticContainers[U_SOCK_NUM_STATIC_SOCKETS];
 
+/** Root of the list of tasks waiting in uSockSelect(), protected
+ * by gMutexCallbacks.
+ */
+static uSockSelectWaiter_t *gpSelectWaiterListHead = NULL;
+
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+/** The cache of host name look-ups, protected by gMutexContainer.
+ */
+static uSockDnsCacheEntry_t gDnsCache[U_SOCK_DNS_CACHE_NUM_ENTRIES] = {0};
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: MISC
  * -------------------------------------------------------------- */
@@ -531,6 +584,11 @@ static void deinitButNotMutex()
         uCellSockDeinit();
         uWifiSockDeinit();
 
+        memset(gpContainerTable, 0, sizeof(gpContainerTable));
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+        memset(gDnsCache, 0, sizeof(gDnsCache));
+#endif
+
         gInitialised = false;
     }
 }
@@ -545,15 +603,14 @@ static void deinitButNotMutex()
 static uSockContainer_t *pContainerFindByDescriptor(uSockDescriptor_t descriptor)
 {
     uSockContainer_t *pContainer = NULL;
-    uSockContainer_t *pContainerThis = gpContainerListHead;
 
-    while ((pContainerThis != NULL) &&
-           (pContainer == NULL)) {
-        if ((pContainerThis->descriptor == descriptor) &&
-            (pContainerThis->socket.state != U_SOCK_STATE_CLOSED)) {
-            pContainer = pContainerThis;
+    if (descriptor >= 0) {
+        pContainer = gpContainerTable[U_SOCK_DESCRIPTOR_SLOT(descriptor)];
+        if ((pContainer != NULL) &&
+            ((pContainer->descriptor != descriptor) ||
+             (pContainer->socket.state == U_SOCK_STATE_CLOSED))) {
+            pContainer = NULL;
         }
-        pContainerThis = pContainerThis->pNext;
     }
 
     return pContainer;
@@ -568,22 +625,47 @@ static uSockContainer_t *pContainerFindByDeviceHandle(uDeviceHandle_t devHandle,
                                                       int32_t sockHandle)
 {
     uSockContainer_t *pContainer = NULL;
-    uSockContainer_t *pContainerThis = gpContainerListHead;
-
-    while ((pContainerThis != NULL) &&
-           (pContainer == NULL)) {
-        if ((pContainerThis->socket.devHandle == devHandle) &&
+    uSockContainer_t *pContainerThis;
+
+    // The socket handles come from two different underlying
+    // layers so can't be used as an index; the table is
+    // small and contiguous though, no list-walking required
+    for (size_t x = 0; (x < sizeof(gpContainerTable) / sizeof(gpContainerTable[0])) &&
+         (pContainer == NULL); x++) {
+        pContainerThis = gpContainerTable[x];
+        if ((pContainerThis != NULL) &&
+            (pContainerThis->socket.devHandle == devHandle) &&
             ((pContainerThis->socket.sockHandle == sockHandle) ||
              (pContainerThis->socket.sockHandle < 0)) &&
             (pContainerThis->socket.state != U_SOCK_STATE_CLOSED)) {
             pContainer = pContainerThis;
         }
-        pContainerThis = pContainerThis->pNext;
     }
 
     return pContainer;
 }
 
+// Return true if the slot in gpContainerTable[] for the given
+// descriptor is available.
+// This does NOT lock the mutex, you need to do that.
+static bool descriptorSlotIsFree(uSockDescriptor_t descriptor)
+{
+    const uSockContainer_t *pContainer = gpContainerTable[U_SOCK_DESCRIPTOR_SLOT(descriptor)];
+
+    return (pContainer == NULL) || (pContainer->socket.state == U_SOCK_STATE_CLOSED);
+}
+
+// Remove a container from gpContainerTable[], if it is there.
+// This does NOT lock the mutex, you need to do that.
+static void containerTableRemove(const uSockContainer_t *pContainer)
+{
+    size_t slot = U_SOCK_DESCRIPTOR_SLOT(pContainer->descriptor);
+
+    if (gpContainerTable[slot] == pContainer) {
+        gpContainerTable[slot] = NULL;
+    }
+}
+
 // Determine the number of non-closed sockets.
 // This does NOT lock the mutex, you need to do that.
 static size_t numContainersInUse()
@@ -636,7 +718,11 @@ static uSockContainer_t *pSockContainerCreate(uSockDescriptor_t descriptor,
 
     // Set up the new container and socket
     if (pContainer != NULL) {
+        // A re-used container may still be in the table
+        // under its old descriptor
+        containerTableRemove(pContainer);
         pContainer->descriptor = descriptor;
+        gpContainerTable[U_SOCK_DESCRIPTOR_SLOT(descriptor)] = pContainer;
         memset(&(pContainer->socket), 0, sizeof(pContainer->socket));
         pContainer->socket.type = type;
         pContainer->socket.protocol = protocol;
@@ -650,6 +736,8 @@ static uSockContainer_t *pSockContainerCreate(uSockDescriptor_t descriptor,
         pContainer->socket.pDataCallbackParameter = NULL;
         pContainer->socket.pClosedCallback = NULL;
         pContainer->socket.pClosedCallbackParameter = NULL;
+        pContainer->socket.dataSignalled = false;
+        pContainer->socket.connectErrno = U_SOCK_ENONE;
     }
 
     return pContainer;
@@ -660,36 +748,34 @@ static uSockContainer_t *pSockContainerCreate(uSockDescriptor_t descriptor,
 // This does NOT lock the mutex, you need to do that.
 static bool containerFree(uSockDescriptor_t descriptor)
 {
-    uSockContainer_t **ppContainer = NULL;
-    uSockContainer_t **ppContainerThis = &gpContainerListHead;
+    uSockContainer_t *pContainer = NULL;
     bool success = false;
 
-    while ((*ppContainerThis != NULL) &&
-           (ppContainer == NULL)) {
-        if ((*ppContainerThis)->descriptor == descriptor) {
-            ppContainer = ppContainerThis;
-        } else {
-            ppContainerThis = &((*ppContainerThis)->pNext);
-        }
+    if (descriptor >= 0) {
+        pContainer = gpContainerTable[U_SOCK_DESCRIPTOR_SLOT(descriptor)];
     }
-
-    if ((ppContainer != NULL) && (*ppContainer != NULL)) {
-        if (!(*ppContainer)->isStatic) {
+    if ((pContainer != NULL) && (pContainer->descriptor == descriptor)) {
+        containerTableRemove(pContainer);
+        if (!pContainer->isStatic) {
             // If we found it, and it wasn't static, free it
             // If there is a previous container, move its pNext
-            if ((*ppContainer)->pPrevious != NULL) {
-                (*ppContainer)->pPrevious->pNext = (*ppContainer)->pNext;
+            if (pContainer->pPrevious != NULL) {
+                pContainer->pPrevious->pNext = pContainer->pNext;
+            } else {
+                // Must be at the start of the list
+                gpContainerListHead = pContainer->pNext;
             }
             // If there is a next container, move its pPrevious
-            if ((*ppContainer)->pNext != NULL) {
-                (*ppContainer)->pNext->pPrevious = (*ppContainer)->pPrevious;
+            if (pContainer->pNext != NULL) {
+                pContainer->pNext->pPrevious = pContainer->pPrevious;
             }
 
-            // Free the memory and NULL the pointer
-            uPortFree(*ppContainer);
-            *ppContainer = NULL;
+            // Free the memory
+            uPortFree(pContainer);
         } else {
-            // Nothing to do for a static container,
+            // Nothing to do for a static container
+            // except to make it available again
+            pContainer->socket.state = U_SOCK_STATE_CLOSED;
         }
 
         success = true;
@@ -702,6 +788,18 @@ static bool containerFree(uSockDescriptor_t descriptor)
  * STATIC FUNCTIONS: CALLBACKS
  * -------------------------------------------------------------- */
 
+// Wake up everyone waiting in uSockSelect().
+// gMutexCallbacks must be locked before this is called.
+static void selectWake()
+{
+    uSockSelectWaiter_t *pWaiter = gpSelectWaiterListHead;
+
+    while (pWaiter != NULL) {
+        uPortSemaphoreGive(pWaiter->semaphoreHandle);
+        pWaiter = pWaiter->pNext;
+    }
+}
+
 // Callback for when local socket closures at the underlying
 // cell/wifi socket layer happen asynchronously, either
 // due to local closure or by the remote host
@@ -727,6 +825,37 @@ static void closedCallback(uDeviceHandle_t devHandle,
         // context
         uSecurityTlsRemove(pContainer->socket.pSecurityContext);
         pContainer->socket.pSecurityContext = NULL;
+        selectWake();
+        U_PORT_MUTEX_UNLOCK(gMutexCallbacks);
+    }
+}
+
+// Callback for when a non-blocking connect at the underlying
+// cell/wifi socket layer completes.
+static void connectCallback(uDeviceHandle_t devHandle,
+                            int32_t sockHandle, int32_t errnoConnect)
+{
+    uSockContainer_t *pContainer;
+
+    // Don't lock the container mutex here, for the
+    // same reason as in closedCallback()
+    pContainer = pContainerFindByDeviceHandle(devHandle,
+                                              sockHandle);
+    if ((pContainer != NULL) &&
+        (pContainer->socket.state == U_SOCK_STATE_CONNECTING)) {
+        if (errnoConnect == U_SOCK_ENONE) {
+            pContainer->socket.state = U_SOCK_STATE_CONNECTED;
+        } else {
+            // Back to square one, with the error
+            // kept for uSockConnect() to report
+            pContainer->socket.connectErrno = errnoConnect;
+            pContainer->socket.state = U_SOCK_STATE_CREATED;
+        }
+        uPortLog("U_SOCK: non-blocking connect of network handle 0x%08x,"
+                 " socket handle %d, completed with errno %d.\n",
+                 devHandle, sockHandle, errnoConnect);
+        U_PORT_MUTEX_LOCK(gMutexCallbacks);
+        selectWake();
         U_PORT_MUTEX_UNLOCK(gMutexCallbacks);
     }
 }
@@ -745,9 +874,11 @@ static void dataCallback(uDeviceHandle_t devHandle,
                                               sockHandle);
     if (pContainer != NULL) {
         U_PORT_MUTEX_LOCK(gMutexCallbacks);
+        pContainer->socket.dataSignalled = true;
         if (pContainer->socket.pDataCallback != NULL) {
             pContainer->socket.pDataCallback(pContainer->socket.pDataCallbackParameter);
         }
+        selectWake();
         U_PORT_MUTEX_UNLOCK(gMutexCallbacks);
     }
 }
@@ -1069,6 +1200,96 @@ static void printSocketOption(const void *pOptionValue,
 #endif
 }
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: DNS CACHE
+ * -------------------------------------------------------------- */
+
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+
+// Compare two host names, which are case-insensitive.
+static bool hostNameIsEqual(const char *pHostName1, const char *pHostName2)
+{
+    while ((*pHostName1 != 0) &&
+           (tolower((unsigned char) *pHostName1) == tolower((unsigned char) *pHostName2))) {
+        pHostName1++;
+        pHostName2++;
+    }
+
+    return *pHostName1 == *pHostName2;
+}
+
+// Return true if a cache entry has expired.
+static bool dnsCacheEntryHasExpired(const uSockDnsCacheEntry_t *pEntry)
+{
+    int32_t ttlSeconds = U_SOCK_DNS_CACHE_TTL_SECONDS;
+
+    if (pEntry->errnoLocal != U_SOCK_ENONE) {
+        ttlSeconds = U_SOCK_DNS_CACHE_NEGATIVE_TTL_SECONDS;
+    }
+
+    return uPortGetTickTimeMs() - pEntry->timeMs >= ttlSeconds * 1000;
+}
+
+// Find a host name in the cache, expiring it if it has timed out.
+// gMutexContainer should be locked before this is called.
+static uSockDnsCacheEntry_t *pDnsCacheFind(uDeviceHandle_t devHandle,
+                                           const char *pHostName)
+{
+    uSockDnsCacheEntry_t *pEntry = NULL;
+
+    for (size_t x = 0; (x < sizeof(gDnsCache) / sizeof(gDnsCache[0])) &&
+         (pEntry == NULL); x++) {
+        if ((gDnsCache[x].devHandle == devHandle) &&
+            hostNameIsEqual(gDnsCache[x].hostName, pHostName)) {
+            if (dnsCacheEntryHasExpired(&(gDnsCache[x]))) {
+                gDnsCache[x].devHandle = NULL;
+            } else {
+                pEntry = &(gDnsCache[x]);
+            }
+        }
+    }
+
+    return pEntry;
+}
+
+// Add the outcome of a look-up to the cache, replacing a free
+// entry or, failing that, the oldest.
+// gMutexContainer should be locked before this is called.
+static void dnsCacheAdd(uDeviceHandle_t devHandle, const char *pHostName,
+                        const uSockIpAddress_t *pIpAddress,
+                        int32_t errnoLocal)
+{
+    uSockDnsCacheEntry_t *pEntry = NULL;
+    int32_t nowMs = uPortGetTickTimeMs();
+    size_t hostNameLength = strlen(pHostName);
+
+    if ((hostNameLength <= U_SOCK_DNS_CACHE_HOST_NAME_MAX_LENGTH_BYTES) &&
+        ((errnoLocal == U_SOCK_ENONE) ||
+         (((errnoLocal == U_SOCK_ENXIO) || (errnoLocal == U_SOCK_EHOSTUNREACH)) &&
+          (U_SOCK_DNS_CACHE_NEGATIVE_TTL_SECONDS > 0)))) {
+        for (size_t x = 0; x < sizeof(gDnsCache) / sizeof(gDnsCache[0]); x++) {
+            if (gDnsCache[x].devHandle == NULL) {
+                pEntry = &(gDnsCache[x]);
+                break;
+            }
+            if ((pEntry == NULL) ||
+                (nowMs - gDnsCache[x].timeMs > nowMs - pEntry->timeMs)) {
+                pEntry = &(gDnsCache[x]);
+            }
+        }
+        pEntry->devHandle = devHandle;
+        memcpy(pEntry->hostName, pHostName, hostNameLength + 1);
+        memset(&(pEntry->ipAddress), 0, sizeof(pEntry->ipAddress));
+        if (pIpAddress != NULL) {
+            pEntry->ipAddress = *pIpAddress;
+        }
+        pEntry->errnoLocal = errnoLocal;
+        pEntry->timeMs = nowMs;
+    }
+}
+
+#endif // #if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: Creating
  * -------------------------------------------------------------- */
@@ -1107,7 +1328,7 @@ static int32_t uSockCreateEx(uDeviceHandle_t devHandle,
             while (descriptorOrError < 0) {
                 // Try the descriptor value, making sure
                 // each time that it can't be found.
-                if (pContainerFindByDescriptor(descriptor) == NULL) {
+                if (descriptorSlotIsFree(descriptor)) {
                     gNextDescriptor = descriptor;
                     U_SOCK_INC_DESCRIPTOR(gNextDescriptor);
                     // Found a free descriptor, now try to
@@ -1168,7 +1389,17 @@ static int32_t uSockCreateEx(uDeviceHandle_t devHandle,
                         // as it was already set above
                         pContainer->socket.sockHandle = sockHandle;
                         pContainer->socket.devHandle = devHandle;
-                        pContainer->socket.bytesSent = 0;
+                        memset(&(pContainer->socket.stats), 0,
+                               sizeof(pContainer->socket.stats));
+                        // Always have the underlying layer tell us
+                        // about received data, for uSockSelect()
+                        if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
+                            uCellSockRegisterCallbackData(devHandle, sockHandle,
+                                                          dataCallback);
+                        } else if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
+                            uWifiSockRegisterCallbackData(devHandle, sockHandle,
+                                                          dataCallback);
+                        }
                         uPortLog("U_SOCK: socket created, descriptor %d,"
                                  " network handle 0x%08x, socket handle %d.\n",
                                  descriptorOrError, devHandle, sockHandle);
@@ -1196,12 +1427,47 @@ static int32_t uSockCreateEx(uDeviceHandle_t devHandle,
     return descriptorOrError;
 }
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: STATISTICS
+ * -------------------------------------------------------------- */
+
+// Account for a call to the underlying layer, returning what
+// that call returned: a size or a negated value of U_SOCK_Exxx.
+static int32_t statsUpdate(uSockStats_t *pStats, bool isWrite,
+                           int32_t negErrnoOrSize, int32_t timeMs)
+{
+    if (negErrnoOrSize == -U_SOCK_EWOULDBLOCK) {
+        pStats->numWouldBlock++;
+    }
+    if (isWrite) {
+        pStats->numWrites++;
+        pStats->writeTimeTotalMs += timeMs;
+        if (timeMs > pStats->writeTimePeakMs) {
+            pStats->writeTimePeakMs = timeMs;
+        }
+        if (negErrnoOrSize > 0) {
+            pStats->bytesSent += negErrnoOrSize;
+        }
+    } else {
+        pStats->numReads++;
+        pStats->readTimeTotalMs += timeMs;
+        if (timeMs > pStats->readTimePeakMs) {
+            pStats->readTimePeakMs = timeMs;
+        }
+        if (negErrnoOrSize > 0) {
+            pStats->bytesReceived += negErrnoOrSize;
+        }
+    }
+
+    return negErrnoOrSize;
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: RECEIVING
  * -------------------------------------------------------------- */
 
 // Receive data on a socket, either UDP or TCP.
-static int32_t receive(const uSockContainer_t *pContainer,
+static int32_t receive(uSockContainer_t *pContainer,
                        uSockAddress_t *pRemoteAddress,
                        void *pData, size_t dataSizeBytes)
 {
@@ -1209,11 +1475,17 @@ static int32_t receive(const uSockContainer_t *pContainer,
     int32_t sockHandle = pContainer->socket.sockHandle;
     int32_t negErrnoOrSize = -U_SOCK_ENOSYS;
     int32_t startTimeMs = uPortGetTickTimeMs();
+    int32_t blockStartTimeMs;
     int32_t devType = uDeviceGetDeviceType(devHandle);
+    bool traced;
 
     // Run around the loop until a packet of data turns up
     // or we time out or just once if we're non-blocking.
     do {
+        // Clear the indication for uSockSelect() before looking,
+        // so that any data arriving from here on is not missed
+        pContainer->socket.dataSignalled = false;
+        traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
         if ((pContainer->socket.protocol == U_SOCK_PROTOCOL_UDP) &&
             (pContainer->socket.pSecurityContext == NULL)) {
             // UDP style
@@ -1244,16 +1516,138 @@ static int32_t receive(const uSockContainer_t *pContainer,
                                                dataSizeBytes);
             }
         }
+        if (traced) {
+            uTraceStagePop();
+        }
         if (negErrnoOrSize < 0) {
             // Yield for the poll interval
+            blockStartTimeMs = uPortGetTickTimeMs();
             uPortTaskBlock(U_SOCK_RECEIVE_POLL_INTERVAL_MS);
+            pContainer->socket.stats.blockedTimeMs += uPortGetTickTimeMs() - blockStartTimeMs;
         }
     } while ((negErrnoOrSize < 0) &&
              (pContainer->socket.blocking) &&
              (uPortGetTickTimeMs() - startTimeMs <
               pContainer->socket.receiveTimeoutMs));
 
-    return negErrnoOrSize;
+    if (negErrnoOrSize >= 0) {
+        // There may be more where that came from
+        pContainer->socket.dataSignalled = true;
+    }
+
+    return statsUpdate(&(pContainer->socket.stats), false, negErrnoOrSize,
+                       uPortGetTickTimeMs() - startTimeMs);
+}
+
+// Read a batch of sockets which are all on the same cellular
+// module, given the indexes of their entries in pBatch.
+// This does NOT lock the mutex, you need to do that.
+static void readBatchCell(uDeviceHandle_t devHandle, uSockReadBatch_t *pBatch,
+                          const size_t *pIndex, size_t numIndexes)
+{
+    uCellSockReadBatch_t cellBatch[U_SOCK_MAX_NUM_SOCKETS];
+    uSockContainer_t *pContainer;
+    uSockReadBatch_t *pItem;
+    int32_t startTimeMs;
+    int32_t timeMs;
+
+    for (size_t x = 0; x < numIndexes; x++) {
+        pItem = pBatch + pIndex[x];
+        pContainer = pContainerFindByDescriptor(pItem->descriptor);
+        cellBatch[x].sockHandle = pContainer->socket.sockHandle;
+        cellBatch[x].pData = pItem->pData;
+        cellBatch[x].dataSizeBytes = pItem->dataSizeBytes;
+        cellBatch[x].negErrnoOrSize = -U_SOCK_ENOSYS;
+        // As in receive(), clear this before looking
+        pContainer->socket.dataSignalled = false;
+    }
+    startTimeMs = uPortGetTickTimeMs();
+    uCellSockReadBatch(devHandle, cellBatch, numIndexes);
+    // Share the time out between the sockets for the statistics
+    timeMs = (uPortGetTickTimeMs() - startTimeMs) / (int32_t) numIndexes;
+    for (size_t x = 0; x < numIndexes; x++) {
+        pItem = pBatch + pIndex[x];
+        pContainer = pContainerFindByDescriptor(pItem->descriptor);
+        pItem->negErrnoOrSize = cellBatch[x].negErrnoOrSize;
+        if (pItem->negErrnoOrSize >= 0) {
+            pContainer->socket.dataSignalled = true;
+        }
+        statsUpdate(&(pContainer->socket.stats), false,
+                    pItem->negErrnoOrSize, timeMs);
+    }
+}
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: SELECT
+ * -------------------------------------------------------------- */
+
+// Return true if the given descriptor is in a descriptor set.
+static bool descriptorIsSet(uSockDescriptor_t descriptor,
+                            const uSockDescriptorSet_t *pSet)
+{
+    return (pSet != NULL) &&
+           (((*pSet)[descriptor / 8] & (1 << (descriptor & 7))) != 0);
+}
+
+// Check which of the descriptors in the given sets are unblocked,
+// setting them in the output sets (which must have been zeroed)
+// and returning the number of descriptors set, in the same way
+// as select() would.  A descriptor that is no longer open is
+// reported as readable and in exception, so that the application
+// finds out on its next call.
+// This does NOT lock the mutex, you need to do that.
+static int32_t selectCheck(int32_t maxDescriptor,
+                           const uSockDescriptorSet_t *pReadSet,
+                           const uSockDescriptorSet_t *pWriteSet,
+                           const uSockDescriptorSet_t *pExceptSet,
+                           uSockDescriptorSet_t *pReadSetOut,
+                           uSockDescriptorSet_t *pWriteSetOut,
+                           uSockDescriptorSet_t *pExceptSetOut)
+{
+    int32_t numUnblocked = 0;
+    const uSockContainer_t *pContainer;
+    uSockState_t state;
+
+    for (uSockDescriptor_t d = 0; d < maxDescriptor; d++) {
+        if (descriptorIsSet(d, pReadSet) || descriptorIsSet(d, pWriteSet) ||
+            descriptorIsSet(d, pExceptSet)) {
+            pContainer = pContainerFindByDescriptor(d);
+            state = U_SOCK_STATE_CLOSED;
+            if (pContainer != NULL) {
+                state = pContainer->socket.state;
+            }
+            // Readable if there is data or a read would
+            // return an error straight away
+            if (descriptorIsSet(d, pReadSet) &&
+                ((state == U_SOCK_STATE_CLOSED) ||
+                 (state == U_SOCK_STATE_CLOSING) ||
+                 (state == U_SOCK_STATE_SHUTDOWN_FOR_READ) ||
+                 (state == U_SOCK_STATE_SHUTDOWN_FOR_READ_WRITE) ||
+                 ((pContainer != NULL) && pContainer->socket.dataSignalled))) {
+                U_SOCK_FD_SET(d, pReadSetOut);
+                numUnblocked++;
+            }
+            // Writes are performed by the underlying layer
+            // while we wait, so a socket that can be written
+            // to is always writeable; so is one where a non-blocking
+            // connect has failed, to wake the application up
+            if (descriptorIsSet(d, pWriteSet) &&
+                ((state == U_SOCK_STATE_CONNECTED) ||
+                 (state == U_SOCK_STATE_SHUTDOWN_FOR_READ) ||
+                 ((state == U_SOCK_STATE_CREATED) &&
+                  ((pContainer->socket.protocol == U_SOCK_PROTOCOL_UDP) ||
+                   (pContainer->socket.connectErrno != U_SOCK_ENONE))))) {
+                U_SOCK_FD_SET(d, pWriteSetOut);
+                numUnblocked++;
+            }
+            if (descriptorIsSet(d, pExceptSet) && (state == U_SOCK_STATE_CLOSED)) {
+                U_SOCK_FD_SET(d, pExceptSetOut);
+                numUnblocked++;
+            }
+        }
+    }
+
+    return numUnblocked;
 }
 
 /* ----------------------------------------------------------------
@@ -1275,10 +1669,13 @@ int32_t uSockConnect(uSockDescriptor_t descriptor,
     uSockContainer_t *pContainer = NULL;
     uDeviceHandle_t devHandle;
     int32_t sockHandle;
+    int32_t traceHandle;
+    bool traced;
 #if U_CFG_ENABLE_LOGGING
     char buffer[U_SOCK_ADDRESS_STRING_MAX_LENGTH_BYTES];
 #endif
 
+    traceHandle = uTraceOperationStart("uSockConnect");
     errnoLocal = init();
     if (errnoLocal == U_SOCK_ENONE) {
         errnoLocal = U_SOCK_EINVAL;
@@ -1292,7 +1689,14 @@ int32_t uSockConnect(uSockDescriptor_t descriptor,
             errnoLocal = U_SOCK_EBADF;
             if (pContainer != NULL) {
                 errnoLocal = U_SOCK_EPERM;
-                if (pContainer->socket.state == U_SOCK_STATE_CREATED) {
+                if (pContainer->socket.state == U_SOCK_STATE_CONNECTING) {
+                    errnoLocal = U_SOCK_EALREADY;
+                } else if ((pContainer->socket.state == U_SOCK_STATE_CREATED) &&
+                           (pContainer->socket.connectErrno != U_SOCK_ENONE)) {
+                    // A non-blocking connect failed: report it, once
+                    errnoLocal = pContainer->socket.connectErrno;
+                    pContainer->socket.connectErrno = U_SOCK_ENONE;
+                } else if (pContainer->socket.state == U_SOCK_STATE_CREATED) {
                     // We have found the container and it is
                     // in the right state, talk to the underlying
                     // cell/wifi socket layer to make the connection
@@ -1307,15 +1711,35 @@ int32_t uSockConnect(uSockDescriptor_t descriptor,
                                              buffer, sizeof(buffer)),
                              buffer);
                     int32_t devType = uDeviceGetDeviceType(devHandle);
+                    traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
                     if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
-                        errorCode = uCellSockConnect(devHandle,
-                                                     sockHandle,
-                                                     pRemoteAddress);
+                        if (!pContainer->socket.blocking) {
+                            // Try not to hang around; the state is
+                            // set first as the callback may be quick
+                            pContainer->socket.state = U_SOCK_STATE_CONNECTING;
+                            errorCode = uCellSockConnectAsync(devHandle,
+                                                              sockHandle,
+                                                              pRemoteAddress,
+                                                              connectCallback);
+                            if ((errorCode != -U_SOCK_EINPROGRESS) &&
+                                (pContainer->socket.state == U_SOCK_STATE_CONNECTING)) {
+                                pContainer->socket.state = U_SOCK_STATE_CREATED;
+                            }
+                        }
+                        if (errorCode == -U_SOCK_ENOSYS) {
+                            // Not supported, do it the blocking way
+                            errorCode = uCellSockConnect(devHandle,
+                                                         sockHandle,
+                                                         pRemoteAddress);
+                        }
                     } else if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
                         errorCode = uWifiSockConnect(devHandle,
                                                      sockHandle,
                                                      pRemoteAddress);
                     }
+                    if (traced) {
+                        uTraceStagePop();
+                    }
 
                     if (errorCode == 0) {
                         // All is good
@@ -1331,6 +1755,17 @@ int32_t uSockConnect(uSockDescriptor_t descriptor,
                                                  true, buffer,
                                                  sizeof(buffer)),
                                  buffer);
+                    } else if (errorCode == -U_SOCK_EINPROGRESS) {
+                        // Non-blocking connection under way,
+                        // connectCallback() will finish it off
+                        memcpy(&pContainer->socket.remoteAddress,
+                               pRemoteAddress,
+                               sizeof(pContainer->socket.remoteAddress));
+                        errnoLocal = U_SOCK_EINPROGRESS;
+                        uPortLog("U_SOCK: socket with descriptor %d, network"
+                                 " handle 0x%08x, socket handle %d, is "
+                                 " connecting.\n", descriptor, devHandle,
+                                 sockHandle);
                     } else {
                         // Set errno
                         errnoLocal = -errorCode;
@@ -1355,6 +1790,8 @@ int32_t uSockConnect(uSockDescriptor_t descriptor,
         errorCode = (int32_t) U_ERROR_COMMON_BSD_ERROR;
     }
 
+    uTraceOperationStop(traceHandle, errorCode);
+
     return errorCode;
 }
 
@@ -1492,6 +1929,7 @@ void uSockCleanUp()
                     devHandle = pContainer->socket.devHandle;
 
                     // Free the memory
+                    containerTableRemove(pContainer);
                     uPortFree(pContainer);
                     // Move to the next entry
                     pContainer = pTmp;
@@ -1581,6 +2019,7 @@ void uSockDeinit()
                 pTmp = pContainer->pNext;
 
                 // Free the memory
+                containerTableRemove(pContainer);
                 uPortFree(pContainer);
                 // Move to the next entry
                 pContainer = pTmp;
@@ -1991,7 +2430,11 @@ int32_t uSockSendTo(uSockDescriptor_t descriptor,
     uSockContainer_t *pContainer = NULL;
     uDeviceHandle_t devHandle;
     int32_t sockHandle;
+    int32_t startTimeMs;
+    int32_t traceHandle;
+    bool traced;
 
+    traceHandle = uTraceOperationStart("uSockSendTo");
     errnoLocal = init();
     if (errnoLocal == U_SOCK_ENONE) {
 
@@ -2045,26 +2488,27 @@ int32_t uSockSendTo(uSockDescriptor_t descriptor,
                             devHandle = pContainer->socket.devHandle;
                             sockHandle = pContainer->socket.sockHandle;
                             errorCodeOrSize = -U_SOCK_ENOSYS;
+                            startTimeMs = uPortGetTickTimeMs();
                             int32_t devType = uDeviceGetDeviceType(devHandle);
+                            traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
                             if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
                                 errorCodeOrSize = uCellSockSendTo(devHandle,
                                                                   sockHandle,
                                                                   pRemoteAddress,
                                                                   pData,
                                                                   dataSizeBytes);
-                                if (errorCodeOrSize > 0) {
-                                    pContainer->socket.bytesSent += errorCodeOrSize;
-                                }
                             } else if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
                                 errorCodeOrSize = uWifiSockSendTo(devHandle,
                                                                   sockHandle,
                                                                   pRemoteAddress,
                                                                   pData,
                                                                   dataSizeBytes);
-                                if (errorCodeOrSize > 0) {
-                                    pContainer->socket.bytesSent += errorCodeOrSize;
-                                }
                             }
+                            if (traced) {
+                                uTraceStagePop();
+                            }
+                            statsUpdate(&(pContainer->socket.stats), true, errorCodeOrSize,
+                                        uPortGetTickTimeMs() - startTimeMs);
 
                             if (errorCodeOrSize < 0) {
                                 // Set errno
@@ -2085,9 +2529,144 @@ int32_t uSockSendTo(uSockDescriptor_t descriptor,
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_BSD_ERROR;
     }
 
+    uTraceOperationStop(traceHandle, errorCodeOrSize);
+
     return errorCodeOrSize;
 }
 
+// Send several datagrams.
+int32_t uSockSendToBatch(uSockDescriptor_t descriptor,
+                         uSockDatagram_t *pDatagrams,
+                         size_t numDatagrams)
+{
+    int32_t errorCodeOrNum = (int32_t) U_ERROR_COMMON_SUCCESS;
+    int32_t errnoLocal;
+    uSockContainer_t *pContainer = NULL;
+    uSockDatagram_t *pDatagram;
+    uDeviceHandle_t devHandle;
+    int32_t sockHandle;
+    int32_t devType;
+    int32_t startTimeMs;
+    int32_t timeMs;
+    int32_t numSent = 0;
+    size_t numDone = 0;
+    bool keepGoing = true;
+
+    errnoLocal = init();
+    if (errnoLocal == U_SOCK_ENONE) {
+
+        U_PORT_MUTEX_LOCK(gMutexContainer);
+
+        // Find the container
+        errnoLocal = U_SOCK_EBADF;
+        pContainer = pContainerFindByDescriptor(descriptor);
+        if (pContainer != NULL) {
+            errnoLocal = U_SOCK_EPROTOTYPE;
+            // As for uSockSendTo(), it is OK to send UDP packets
+            // on a TCP socket
+            if ((pContainer->socket.protocol == U_SOCK_PROTOCOL_UDP) ||
+                (pContainer->socket.protocol == U_SOCK_PROTOCOL_TCP)) {
+                errnoLocal = U_SOCK_ESHUTDOWN;
+                if ((pContainer->socket.state != U_SOCK_STATE_SHUTDOWN_FOR_WRITE) &&
+                    (pContainer->socket.state != U_SOCK_STATE_SHUTDOWN_FOR_READ_WRITE)) {
+                    errnoLocal = U_SOCK_ENOTCONN;
+                    if (pContainer->socket.state != U_SOCK_STATE_CLOSING) {
+                        errnoLocal = U_SOCK_EINVAL;
+                        if ((pDatagrams != NULL) || (numDatagrams == 0)) {
+                            errnoLocal = U_SOCK_ENONE;
+                        }
+                    }
+                }
+            }
+            // Check the datagrams
+            for (size_t x = 0; (x < numDatagrams) && (errnoLocal == U_SOCK_ENONE); x++) {
+                pDatagram = pDatagrams + x;
+                if ((pDatagram->pData == NULL) || (pDatagram->dataSizeBytes == 0)) {
+                    errnoLocal = U_SOCK_EINVAL;
+                } else if (pDatagram->pAddress == NULL) {
+                    errnoLocal = U_SOCK_EDESTADDRREQ;
+                    if (pContainer->socket.state == U_SOCK_STATE_CONNECTED) {
+                        // As for uSockSendTo(), use the stored address,
+                        // putting it back to NULL when done
+                        pDatagram->pAddress = &(pContainer->socket.remoteAddress);
+                        errnoLocal = U_SOCK_ENONE;
+                    }
+                }
+            }
+            if ((errnoLocal == U_SOCK_ENONE) && (numDatagrams > 0)) {
+                devHandle = pContainer->socket.devHandle;
+                sockHandle = pContainer->socket.sockHandle;
+                devType = uDeviceGetDeviceType(devHandle);
+                startTimeMs = uPortGetTickTimeMs();
+                if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
+                    errorCodeOrNum = uCellSockSendToBatch(devHandle, sockHandle,
+                                                          pDatagrams, numDatagrams);
+                    // The datagrams that were tried are the ones
+                    // sent plus the one that failed, if any
+                    numDone = 1;
+                    if (errorCodeOrNum > 0) {
+                        numDone = (size_t) errorCodeOrNum;
+                        if (numDone < numDatagrams) {
+                            numDone++;
+                        }
+                    }
+                } else {
+                    // Nothing to batch with, send them one at a time
+                    for (size_t x = 0; (x < numDatagrams) && keepGoing; x++) {
+                        pDatagram = pDatagrams + x;
+                        pDatagram->negErrnoOrSize = -U_SOCK_ENOSYS;
+                        if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
+                            pDatagram->negErrnoOrSize = uWifiSockSendTo(devHandle,
+                                                                        sockHandle,
+                                                                        pDatagram->pAddress,
+                                                                        pDatagram->pData,
+                                                                        pDatagram->dataSizeBytes);
+                        }
+                        numDone++;
+                        if (pDatagram->negErrnoOrSize >= 0) {
+                            numSent++;
+                        } else {
+                            // Stop at the first failure, reporting
+                            // it only if nothing was sent
+                            errorCodeOrNum = pDatagram->negErrnoOrSize;
+                            keepGoing = false;
+                        }
+                    }
+                    if (numSent > 0) {
+                        errorCodeOrNum = numSent;
+                    }
+                }
+                // Share the time out between the datagrams for
+                // the statistics
+                timeMs = (uPortGetTickTimeMs() - startTimeMs) / (int32_t) numDone;
+                for (size_t x = 0; x < numDone; x++) {
+                    statsUpdate(&(pContainer->socket.stats), true,
+                                pDatagrams[x].negErrnoOrSize, timeMs);
+                }
+                if (errorCodeOrNum < 0) {
+                    // Set errno
+                    errnoLocal = -errorCodeOrNum;
+                }
+            }
+            for (size_t x = 0; (pDatagrams != NULL) && (x < numDatagrams); x++) {
+                if (pDatagrams[x].pAddress == &(pContainer->socket.remoteAddress)) {
+                    pDatagrams[x].pAddress = NULL;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutexContainer);
+    }
+
+    if (errnoLocal != U_SOCK_ENONE) {
+        // Write the errno
+        errno = errnoLocal;
+        errorCodeOrNum = (int32_t) U_ERROR_COMMON_BSD_ERROR;
+    }
+
+    return errorCodeOrNum;
+}
+
 int32_t uSockGetTotalBytesSent(uSockDescriptor_t descriptor)
 {
     int32_t errorCodeOrTotalBytesSent = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
@@ -2096,12 +2675,47 @@ int32_t uSockGetTotalBytesSent(uSockDescriptor_t descriptor)
     pContainer = pContainerFindByDescriptor(descriptor);
 
     if (pContainer != NULL) {
-        errorCodeOrTotalBytesSent = pContainer->socket.bytesSent;
+        errorCodeOrTotalBytesSent = pContainer->socket.stats.bytesSent;
     }
 
     return errorCodeOrTotalBytesSent;
 }
 
+// Get the statistics of a socket.
+int32_t uSockStatsGet(uSockDescriptor_t descriptor, uSockStats_t *pStats)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    int32_t errnoLocal;
+    uSockContainer_t *pContainer = NULL;
+
+    errnoLocal = init();
+    if (errnoLocal == U_SOCK_ENONE) {
+        errnoLocal = U_SOCK_EINVAL;
+        if (pStats != NULL) {
+
+            U_PORT_MUTEX_LOCK(gMutexContainer);
+
+            // Find the container
+            errnoLocal = U_SOCK_EBADF;
+            pContainer = pContainerFindByDescriptor(descriptor);
+            if (pContainer != NULL) {
+                memcpy(pStats, &(pContainer->socket.stats), sizeof(*pStats));
+                errnoLocal = U_SOCK_ENONE;
+            }
+
+            U_PORT_MUTEX_UNLOCK(gMutexContainer);
+        }
+    }
+
+    if (errnoLocal != U_SOCK_ENONE) {
+        // Write the errno
+        errno = errnoLocal;
+        errorCode = (int32_t) U_ERROR_COMMON_BSD_ERROR;
+    }
+
+    return errorCode;
+}
+
 // Receive a single datagram from the given host.
 int32_t uSockReceiveFrom(uSockDescriptor_t descriptor,
                          uSockAddress_t *pRemoteAddress,
@@ -2110,7 +2724,9 @@ int32_t uSockReceiveFrom(uSockDescriptor_t descriptor,
     int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_SUCCESS;
     int32_t errnoLocal;
     uSockContainer_t *pContainer = NULL;
+    int32_t traceHandle;
 
+    traceHandle = uTraceOperationStart("uSockReceiveFrom");
     errnoLocal = init();
     if (errnoLocal == U_SOCK_ENONE) {
 
@@ -2163,9 +2779,133 @@ int32_t uSockReceiveFrom(uSockDescriptor_t descriptor,
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_BSD_ERROR;
     }
 
+    uTraceOperationStop(traceHandle, errorCodeOrSize);
+
     return errorCodeOrSize;
 }
 
+// Receive several datagrams.
+int32_t uSockReceiveFromBatch(uSockDescriptor_t descriptor,
+                              uSockDatagram_t *pDatagrams,
+                              size_t numDatagrams)
+{
+    int32_t errorCodeOrNum = (int32_t) U_ERROR_COMMON_SUCCESS;
+    int32_t errnoLocal;
+    uSockContainer_t *pContainer = NULL;
+    uSockDatagram_t *pDatagram;
+    uDeviceHandle_t devHandle;
+    int32_t startTimeMs;
+    int32_t timeMs;
+    int32_t numReceived = 0;
+    bool blocking;
+
+    errnoLocal = init();
+    if (errnoLocal == U_SOCK_ENONE) {
+
+        U_PORT_MUTEX_LOCK(gMutexContainer);
+
+        // Find the container
+        errnoLocal = U_SOCK_EBADF;
+        pContainer = pContainerFindByDescriptor(descriptor);
+        if (pContainer != NULL) {
+            errnoLocal = U_SOCK_EPROTOTYPE;
+            // As for uSockReceiveFrom(), it is OK to receive
+            // UDP-style on a TCP socket
+            if ((pContainer->socket.protocol == U_SOCK_PROTOCOL_UDP) ||
+                (pContainer->socket.protocol == U_SOCK_PROTOCOL_TCP)) {
+                errnoLocal = U_SOCK_ENOTCONN;
+                if (pContainer->socket.state != U_SOCK_STATE_CLOSING) {
+                    errnoLocal = U_SOCK_ESHUTDOWN;
+                    if ((pContainer->socket.state != U_SOCK_STATE_SHUTDOWN_FOR_READ) &&
+                        (pContainer->socket.state != U_SOCK_STATE_SHUTDOWN_FOR_READ_WRITE)) {
+                        errnoLocal = U_SOCK_EINVAL;
+                        if ((pDatagrams != NULL) || (numDatagrams == 0)) {
+                            errnoLocal = U_SOCK_ENONE;
+                        }
+                    }
+                }
+            }
+            // Check the buffers
+            for (size_t x = 0; (x < numDatagrams) && (errnoLocal == U_SOCK_ENONE); x++) {
+                pDatagram = pDatagrams + x;
+                if ((pDatagram->pData == NULL) || (pDatagram->dataSizeBytes == 0)) {
+                    errnoLocal = U_SOCK_EINVAL;
+                }
+            }
+            if ((errnoLocal == U_SOCK_ENONE) && (numDatagrams > 0)) {
+                // The first datagram is received exactly as
+                // uSockReceiveFrom() would, blocking if required
+                pDatagram = pDatagrams;
+                pDatagram->negErrnoOrSize = receive(pContainer, pDatagram->pAddress,
+                                                    pDatagram->pData,
+                                                    pDatagram->dataSizeBytes);
+                errorCodeOrNum = pDatagram->negErrnoOrSize;
+                if (pDatagram->negErrnoOrSize >= 0) {
+                    numReceived = 1;
+                    devHandle = pContainer->socket.devHandle;
+                    if (numDatagrams == 1) {
+                        // Nothing more to do
+                    } else if ((uDeviceGetDeviceType(devHandle) == (int32_t) U_DEVICE_TYPE_CELL) &&
+                               (pContainer->socket.protocol == U_SOCK_PROTOCOL_UDP) &&
+                               (pContainer->socket.pSecurityContext == NULL)) {
+                        // Collect whatever else is waiting under
+                        // a single AT lock
+                        pDatagrams[1].negErrnoOrSize = -U_SOCK_ENOSYS;
+                        startTimeMs = uPortGetTickTimeMs();
+                        errorCodeOrNum = uCellSockReceiveFromBatch(devHandle,
+                                                                   pContainer->socket.sockHandle,
+                                                                   pDatagrams + 1,
+                                                                   numDatagrams - 1);
+                        if (errorCodeOrNum > 0) {
+                            numReceived += errorCodeOrNum;
+                        }
+                        // The reads are those that received a datagram
+                        // plus the one that ended the batch, if any
+                        timeMs = (uPortGetTickTimeMs() - startTimeMs) / numReceived;
+                        for (int32_t x = 1; (x <= numReceived) &&
+                             (x < (int32_t) numDatagrams); x++) {
+                            statsUpdate(&(pContainer->socket.stats), false,
+                                        pDatagrams[x].negErrnoOrSize, timeMs);
+                        }
+                    } else {
+                        // Nothing to batch with, do the rest one
+                        // at a time without blocking
+                        blocking = pContainer->socket.blocking;
+                        pContainer->socket.blocking = false;
+                        for (size_t x = 1; (x < numDatagrams) &&
+                             (x == (size_t) numReceived); x++) {
+                            pDatagram = pDatagrams + x;
+                            pDatagram->negErrnoOrSize = receive(pContainer,
+                                                                pDatagram->pAddress,
+                                                                pDatagram->pData,
+                                                                pDatagram->dataSizeBytes);
+                            if (pDatagram->negErrnoOrSize >= 0) {
+                                numReceived++;
+                            }
+                        }
+                        pContainer->socket.blocking = blocking;
+                    }
+                    errorCodeOrNum = numReceived;
+                }
+                if (errorCodeOrNum < 0) {
+                    // Set errno
+                    errnoLocal = -errorCodeOrNum;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutexContainer);
+    }
+
+    if (errnoLocal != U_SOCK_ENONE) {
+        // Write the errno
+        errno = errnoLocal;
+        errorCodeOrNum = (int32_t) U_ERROR_COMMON_BSD_ERROR;
+    }
+
+    return errorCodeOrNum;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: STREAM (TCP)
  * -------------------------------------------------------------- */
@@ -2179,7 +2919,11 @@ int32_t uSockWrite(uSockDescriptor_t descriptor,
     uSockContainer_t *pContainer = NULL;
     uDeviceHandle_t devHandle;
     int32_t sockHandle;
+    int32_t startTimeMs;
+    int32_t traceHandle;
+    bool traced;
 
+    traceHandle = uTraceOperationStart("uSockWrite");
     errnoLocal = init();
     if (errnoLocal == U_SOCK_ENONE) {
 
@@ -2205,24 +2949,25 @@ int32_t uSockWrite(uSockDescriptor_t descriptor,
                         devHandle = pContainer->socket.devHandle;
                         sockHandle = pContainer->socket.sockHandle;
                         errorCodeOrSize = -U_SOCK_ENOSYS;
+                        startTimeMs = uPortGetTickTimeMs();
                         int32_t devType = uDeviceGetDeviceType(devHandle);
+                        traced = uTraceStagePush(U_TRACE_STAGE_SERVICE);
                         if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
                             errorCodeOrSize = uCellSockWrite(devHandle,
                                                              sockHandle,
                                                              pData,
                                                              dataSizeBytes);
-                            if (errorCodeOrSize > 0) {
-                                pContainer->socket.bytesSent += errorCodeOrSize;
-                            }
                         } else if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
                             errorCodeOrSize = uWifiSockWrite(devHandle,
                                                              sockHandle,
                                                              pData,
                                                              dataSizeBytes);
-                            if (errorCodeOrSize > 0) {
-                                pContainer->socket.bytesSent += errorCodeOrSize;
-                            }
                         }
+                        if (traced) {
+                            uTraceStagePop();
+                        }
+                        statsUpdate(&(pContainer->socket.stats), true, errorCodeOrSize,
+                                    uPortGetTickTimeMs() - startTimeMs);
 
                         if (errorCodeOrSize < 0) {
                             // Set errno
@@ -2254,6 +2999,8 @@ int32_t uSockWrite(uSockDescriptor_t descriptor,
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_BSD_ERROR;
     }
 
+    uTraceOperationStop(traceHandle, errorCodeOrSize);
+
     return errorCodeOrSize;
 }
 
@@ -2264,7 +3011,9 @@ int32_t uSockRead(uSockDescriptor_t descriptor,
     int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_SUCCESS;
     int32_t errnoLocal;
     uSockContainer_t *pContainer = NULL;
+    int32_t traceHandle;
 
+    traceHandle = uTraceOperationStart("uSockRead");
     errnoLocal = init();
     if (errnoLocal == U_SOCK_ENONE) {
 
@@ -2316,6 +3065,104 @@ int32_t uSockRead(uSockDescriptor_t descriptor,
         errorCodeOrSize = (int32_t) U_ERROR_COMMON_BSD_ERROR;
     }
 
+    uTraceOperationStop(traceHandle, errorCodeOrSize);
+
+    return errorCodeOrSize;
+}
+
+// Receive data on several sockets.
+int32_t uSockReadBatch(uSockReadBatch_t *pBatch, size_t numItems)
+{
+    int32_t errorCodeOrSize = (int32_t) U_ERROR_COMMON_SUCCESS;
+    int32_t errnoLocal;
+    uSockContainer_t *pContainer;
+    uSockReadBatch_t *pItem;
+    uDeviceHandle_t devHandle;
+    size_t index[U_SOCK_MAX_NUM_SOCKETS];
+    size_t numIndexes;
+    bool blocking;
+
+    errnoLocal = init();
+    if (errnoLocal == U_SOCK_ENONE) {
+        errnoLocal = U_SOCK_EINVAL;
+        if ((pBatch != NULL) || (numItems == 0)) {
+            errnoLocal = U_SOCK_ENONE;
+
+            U_PORT_MUTEX_LOCK(gMutexContainer);
+
+            // Check each entry, marking those still to be
+            // done with U_SOCK_EINPROGRESS
+            for (size_t x = 0; x < numItems; x++) {
+                pItem = pBatch + x;
+                pItem->negErrnoOrSize = -U_SOCK_EBADF;
+                pContainer = pContainerFindByDescriptor(pItem->descriptor);
+                if (pContainer != NULL) {
+                    pItem->negErrnoOrSize = -U_SOCK_EINVAL;
+                    if ((pItem->pData != NULL) && (pItem->dataSizeBytes > 0) &&
+                        (pItem->dataSizeBytes <= INT_MAX)) {
+                        pItem->negErrnoOrSize = -U_SOCK_ENOTCONN;
+                        if ((pContainer->socket.state == U_SOCK_STATE_CONNECTED) &&
+                            (pContainer->socket.protocol == U_SOCK_PROTOCOL_TCP)) {
+                            pItem->negErrnoOrSize = -U_SOCK_EINPROGRESS;
+                        }
+                    }
+                }
+            }
+
+            // Now do them, all the sockets of a cellular module
+            // together so that it can use one AT lock for them
+            for (size_t x = 0; x < numItems; x++) {
+                pItem = pBatch + x;
+                if (pItem->negErrnoOrSize == -U_SOCK_EINPROGRESS) {
+                    pContainer = pContainerFindByDescriptor(pItem->descriptor);
+                    devHandle = pContainer->socket.devHandle;
+                    if (uDeviceGetDeviceType(devHandle) == (int32_t) U_DEVICE_TYPE_CELL) {
+                        numIndexes = 0;
+                        for (size_t y = x; y < numItems; y++) {
+                            // Only entries marked U_SOCK_EINPROGRESS are
+                            // known to have a container
+                            pContainer = NULL;
+                            if (pBatch[y].negErrnoOrSize == -U_SOCK_EINPROGRESS) {
+                                pContainer = pContainerFindByDescriptor(pBatch[y].descriptor);
+                            }
+                            if ((pContainer != NULL) &&
+                                (pContainer->socket.devHandle == devHandle)) {
+                                index[numIndexes] = y;
+                                numIndexes++;
+                                if (numIndexes >= sizeof(index) / sizeof(index[0])) {
+                                    readBatchCell(devHandle, pBatch, index, numIndexes);
+                                    numIndexes = 0;
+                                }
+                            }
+                        }
+                        if (numIndexes > 0) {
+                            readBatchCell(devHandle, pBatch, index, numIndexes);
+                        }
+                    } else {
+                        // No batching for anything else, just
+                        // have a single non-blocking go
+                        blocking = pContainer->socket.blocking;
+                        pContainer->socket.blocking = false;
+                        pItem->negErrnoOrSize = receive(pContainer, NULL, pItem->pData,
+                                                        pItem->dataSizeBytes);
+                        pContainer->socket.blocking = blocking;
+                    }
+                }
+                if (pItem->negErrnoOrSize > 0) {
+                    errorCodeOrSize += pItem->negErrnoOrSize;
+                }
+            }
+
+            U_PORT_MUTEX_UNLOCK(gMutexContainer);
+        }
+    }
+
+    if (errnoLocal != U_SOCK_ENONE) {
+        // Write the errno
+        errno = errnoLocal;
+        errorCodeOrSize = (int32_t) U_ERROR_COMMON_BSD_ERROR;
+    }
+
     return errorCodeOrSize;
 }
 
@@ -2642,14 +3489,85 @@ int32_t uSockSelect(int32_t maxDescriptor,
                     uSockDescriptorSet_t *pExceptDescriptorSet,
                     int32_t timeMs)
 {
-    // TODO
-    (void) maxDescriptor;
-    (void) pReadDescriptorSet;
-    (void) pWriteDescriptoreSet;
-    (void) pExceptDescriptorSet;
-    (void) timeMs;
-    errno = U_SOCK_ENOSYS;
-    return (int32_t) U_ERROR_COMMON_NOT_IMPLEMENTED;
+    int32_t errorCodeOrNumUnblocked = (int32_t) U_ERROR_COMMON_SUCCESS;
+    int32_t errnoLocal;
+    uSockSelectWaiter_t waiter = {0};
+    uSockSelectWaiter_t **ppWaiter;
+    uSockDescriptorSet_t readSet;
+    uSockDescriptorSet_t writeSet;
+    uSockDescriptorSet_t exceptSet;
+    int32_t startTimeMs;
+
+    errnoLocal = init();
+    if (errnoLocal == U_SOCK_ENONE) {
+        errnoLocal = U_SOCK_EINVAL;
+        if ((maxDescriptor >= 0) && (maxDescriptor <= U_SOCK_DESCRIPTOR_SET_SIZE) &&
+            (timeMs >= 0)) {
+            errnoLocal = U_SOCK_ENOMEM;
+            if (uPortSemaphoreCreate(&(waiter.semaphoreHandle), 0, 1) == 0) {
+                errnoLocal = U_SOCK_ENONE;
+                // Join the list of waiters before the first check
+                // so that no event can be missed in between
+                U_PORT_MUTEX_LOCK(gMutexCallbacks);
+                waiter.pNext = gpSelectWaiterListHead;
+                gpSelectWaiterListHead = &waiter;
+                U_PORT_MUTEX_UNLOCK(gMutexCallbacks);
+
+                startTimeMs = uPortGetTickTimeMs();
+                do {
+                    U_SOCK_FD_ZERO(&readSet);
+                    U_SOCK_FD_ZERO(&writeSet);
+                    U_SOCK_FD_ZERO(&exceptSet);
+                    U_PORT_MUTEX_LOCK(gMutexContainer);
+                    errorCodeOrNumUnblocked = selectCheck(maxDescriptor,
+                                                          pReadDescriptorSet,
+                                                          pWriteDescriptoreSet,
+                                                          pExceptDescriptorSet,
+                                                          &readSet, &writeSet,
+                                                          &exceptSet);
+                    U_PORT_MUTEX_UNLOCK(gMutexContainer);
+                    if (errorCodeOrNumUnblocked == 0) {
+                        // Sleep until a data or closed callback
+                        // wakes us up or the time runs out
+                        uPortSemaphoreTryTake(waiter.semaphoreHandle,
+                                              timeMs - (uPortGetTickTimeMs() - startTimeMs));
+                    }
+                } while ((errorCodeOrNumUnblocked == 0) &&
+                         (uPortGetTickTimeMs() - startTimeMs < timeMs));
+
+                // Leave the list of waiters
+                U_PORT_MUTEX_LOCK(gMutexCallbacks);
+                ppWaiter = &gpSelectWaiterListHead;
+                while ((*ppWaiter != NULL) && (*ppWaiter != &waiter)) {
+                    ppWaiter = &((*ppWaiter)->pNext);
+                }
+                if (*ppWaiter != NULL) {
+                    *ppWaiter = waiter.pNext;
+                }
+                U_PORT_MUTEX_UNLOCK(gMutexCallbacks);
+                uPortSemaphoreDelete(waiter.semaphoreHandle);
+
+                // Hand back the results
+                if (pReadDescriptorSet != NULL) {
+                    memcpy(*pReadDescriptorSet, readSet, sizeof(readSet));
+                }
+                if (pWriteDescriptoreSet != NULL) {
+                    memcpy(*pWriteDescriptoreSet, writeSet, sizeof(writeSet));
+                }
+                if (pExceptDescriptorSet != NULL) {
+                    memcpy(*pExceptDescriptorSet, exceptSet, sizeof(exceptSet));
+                }
+            }
+        }
+    }
+
+    if (errnoLocal != U_SOCK_ENONE) {
+        // Write the errno
+        errno = errnoLocal;
+        errorCodeOrNumUnblocked = (int32_t) U_ERROR_COMMON_BSD_ERROR;
+    }
+
+    return errorCodeOrNumUnblocked;
 }
 
 /* ----------------------------------------------------------------
@@ -2771,22 +3689,44 @@ int32_t uSockGetHostByName(uDeviceHandle_t devHandle,
             U_PORT_MUTEX_LOCK(gMutexContainer);
 
             int32_t devType = uDeviceGetDeviceType(devHandle);
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+            uSockDnsCacheEntry_t *pEntry = NULL;
 
-            // Talk to the underlying cell/wifi
-            // socket layer to do the DNS look-up.
-            // uXxxSockGetHostByName() returns a negated
-            // value from the U_SOCK_Exxx list.
-            errnoLocal = U_SOCK_ENOSYS;
-            if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
-                errnoLocal = -uCellSockGetHostByName(devHandle,
-                                                     pHostName,
-                                                     pHostIpAddress);
-            } else if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
-                errnoLocal = -uWifiSockGetHostByName(devHandle,
-                                                     pHostName,
-                                                     pHostIpAddress);
+            if (devType >= 0) {
+                pEntry = pDnsCacheFind(devHandle, pHostName);
             }
 
+            if (pEntry != NULL) {
+                // Answer from the cache, no need to bother the module
+                errnoLocal = pEntry->errnoLocal;
+                if (errnoLocal == U_SOCK_ENONE) {
+                    *pHostIpAddress = pEntry->ipAddress;
+                }
+            } else {
+#endif
+                // Talk to the underlying cell/wifi
+                // socket layer to do the DNS look-up.
+                // uXxxSockGetHostByName() returns a negated
+                // value from the U_SOCK_Exxx list.
+                errnoLocal = U_SOCK_ENOSYS;
+                if (devType == (int32_t) U_DEVICE_TYPE_CELL) {
+                    errnoLocal = -uCellSockGetHostByName(devHandle,
+                                                         pHostName,
+                                                         pHostIpAddress);
+                } else if (devType == (int32_t) U_DEVICE_TYPE_SHORT_RANGE) {
+                    errnoLocal = -uWifiSockGetHostByName(devHandle,
+                                                         pHostName,
+                                                         pHostIpAddress);
+                }
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+                if (devType >= 0) {
+                    dnsCacheAdd(devHandle, pHostName,
+                                errnoLocal == U_SOCK_ENONE ? pHostIpAddress : NULL,
+                                errnoLocal);
+                }
+            }
+#endif
+
             U_PORT_MUTEX_UNLOCK(gMutexContainer);
         }
     }
@@ -2800,6 +3740,27 @@ int32_t uSockGetHostByName(uDeviceHandle_t devHandle,
     return errorCode;
 }
 
+// Flush the cache of host name look-ups.
+void uSockGetHostByNameCacheFlush(uDeviceHandle_t devHandle)
+{
+#if U_SOCK_DNS_CACHE_NUM_ENTRIES > 0
+    if (gMutexContainer != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutexContainer);
+
+        for (size_t x = 0; x < sizeof(gDnsCache) / sizeof(gDnsCache[0]); x++) {
+            if ((devHandle == NULL) || (gDnsCache[x].devHandle == devHandle)) {
+                gDnsCache[x].devHandle = NULL;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutexContainer);
+    }
+#else
+    (void) devHandle;
+#endif
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: ADDRESS CONVERSION
  * -------------------------------------------------------------- */
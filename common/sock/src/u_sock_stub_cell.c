@@ -81,6 +81,19 @@ U_WEAK int32_t uCellSockConnect(uDeviceHandle_t cellHandle,
     return -U_SOCK_ENOSYS;
 }
 
+U_WEAK int32_t uCellSockConnectAsync(uDeviceHandle_t cellHandle,
+                                     int32_t sockHandle,
+                                     const uSockAddress_t *pRemoteAddress,
+                                     void (*pCallback) (uDeviceHandle_t,
+                                                        int32_t, int32_t))
+{
+    (void) cellHandle;
+    (void) sockHandle;
+    (void) pRemoteAddress;
+    (void) pCallback;
+    return -U_SOCK_ENOSYS;
+}
+
 U_WEAK int32_t uCellSockClose(uDeviceHandle_t cellHandle,
                               int32_t sockHandle,
                               void (*pCallback) (uDeviceHandle_t,
@@ -182,6 +195,30 @@ U_WEAK int32_t uCellSockReceiveFrom(uDeviceHandle_t cellHandle,
     return -U_SOCK_ENOSYS;
 }
 
+U_WEAK int32_t uCellSockSendToBatch(uDeviceHandle_t cellHandle,
+                                    int32_t sockHandle,
+                                    uSockDatagram_t *pDatagrams,
+                                    size_t numDatagrams)
+{
+    (void) cellHandle;
+    (void) sockHandle;
+    (void) pDatagrams;
+    (void) numDatagrams;
+    return -U_SOCK_ENOSYS;
+}
+
+U_WEAK int32_t uCellSockReceiveFromBatch(uDeviceHandle_t cellHandle,
+                                         int32_t sockHandle,
+                                         uSockDatagram_t *pDatagrams,
+                                         size_t numDatagrams)
+{
+    (void) cellHandle;
+    (void) sockHandle;
+    (void) pDatagrams;
+    (void) numDatagrams;
+    return -U_SOCK_ENOSYS;
+}
+
 U_WEAK int32_t uCellSockWrite(uDeviceHandle_t cellHandle,
                               int32_t sockHandle,
                               const void *pData, size_t dataSizeBytes)
@@ -204,6 +241,16 @@ U_WEAK int32_t uCellSockRead(uDeviceHandle_t cellHandle,
     return -U_SOCK_ENOSYS;
 }
 
+U_WEAK int32_t uCellSockReadBatch(uDeviceHandle_t cellHandle,
+                                  uCellSockReadBatch_t *pBatch,
+                                  size_t numItems)
+{
+    (void) cellHandle;
+    (void) pBatch;
+    (void) numItems;
+    return -U_SOCK_ENOSYS;
+}
+
 U_WEAK void uCellSockRegisterCallbackData(uDeviceHandle_t cellHandle,
                                           int32_t sockHandle,
                                           void (*pCallback) (uDeviceHandle_t,
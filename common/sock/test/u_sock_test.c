@@ -69,6 +69,10 @@
 #include "u_network.h"                  // In order to provide a comms
 #include "u_network_test_shared_cfg.h"  // path for the socket
 
+#if defined(U_SOCK_TEST_BENCHMARK) && defined(U_CFG_TEST_CELL_MODULE_TYPE)
+# include "u_cell_sock.h" // For uCellSockHexModeOn()/uCellSockHexModeOff()
+#endif
+
 #include "u_security_tls.h" // For uSecurityTlsCleanUp()
 
 #include "u_sock_errno.h" // For U_SOCK_EWOULDBLOCK
@@ -168,6 +172,56 @@
 # define U_SOCK_TEST_TIME_MARGIN_MINUS_MS 100
 #endif
 
+#ifndef U_SOCK_TEST_BENCHMARK_PAYLOAD_SIZES
+/** The payload sizes to benchmark with if U_SOCK_TEST_BENCHMARK
+ * is defined, a comma-separated list: for TCP this is the size of
+ * each uSockWrite(), for UDP the size of the datagram, limited to
+ * U_SOCK_TEST_MAX_UDP_PACKET_SIZE.
+ */
+# define U_SOCK_TEST_BENCHMARK_PAYLOAD_SIZES 64, 256, 1024
+#endif
+
+#ifndef U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES
+/** The amount of data to send up to, and receive back from, the
+ * TCP echo server when measuring TCP throughput if
+ * U_SOCK_TEST_BENCHMARK is defined.
+ */
+# define U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES (1024 * 16)
+#endif
+
+#ifndef U_SOCK_TEST_BENCHMARK_TCP_TIMEOUT_MS
+/** How long to allow for a TCP throughput measurement if
+ * U_SOCK_TEST_BENCHMARK is defined.
+ */
+# define U_SOCK_TEST_BENCHMARK_TCP_TIMEOUT_MS 120000
+#endif
+
+#ifndef U_SOCK_TEST_BENCHMARK_UDP_NUM
+/** The number of UDP round trips to time, for each payload size,
+ * if U_SOCK_TEST_BENCHMARK is defined.
+ */
+# define U_SOCK_TEST_BENCHMARK_UDP_NUM 20
+#endif
+
+#ifndef U_SOCK_TEST_BENCHMARK_UDP_TIMEOUT_MS
+/** How long to wait for a UDP packet to be echoed back before
+ * it is considered lost if U_SOCK_TEST_BENCHMARK is defined.
+ */
+# define U_SOCK_TEST_BENCHMARK_UDP_TIMEOUT_MS 5000
+#endif
+
+#ifndef U_SOCK_TEST_BENCHMARK_CONNECT_NUM
+/** The number of TCP connections to time if U_SOCK_TEST_BENCHMARK
+ * is defined.
+ */
+# define U_SOCK_TEST_BENCHMARK_CONNECT_NUM 3
+#endif
+
+/** The prefix for the lines of JSON benchmark results, so that they
+ * can be picked out of the log.
+ */
+#define U_SOCK_TEST_BENCHMARK_PREFIX "U_SOCK_TEST_BENCHMARK: "
+
 // Do some cross-checking
 #ifdef U_AT_CLIENT_URC_TASK_PRIORITY
 # if (U_AT_CLIENT_URC_TASK_PRIORITY) <= (U_SOCK_TEST_TASK_PRIORITY)
@@ -276,6 +330,12 @@ static const uSockTestPortRemoval_t gTestAddressPortRemoval[] = {
     {"fred.com:65535", 65535, "fred.com"}
 };
 
+#ifdef U_SOCK_TEST_BENCHMARK
+/** The payload sizes to benchmark with.
+ */
+static const size_t gBenchmarkPayloadSize[] = {U_SOCK_TEST_BENCHMARK_PAYLOAD_SIZES};
+#endif
+
 /** Data to exchange.
  */
 static const char gSendData[] =  "_____0000:0123456789012345678901234567890123456789"
@@ -779,6 +839,234 @@ static void osCleanup()
         gTestConfig.eventQueueHandle = -1;
     }
 }
+#ifdef U_SOCK_TEST_BENCHMARK
+
+// Compare two int32_t's, for qsort().
+static int compareInt32(const void *p1, const void *p2)
+{
+    return *((const int32_t *) p1) - *((const int32_t *) p2);
+}
+
+// Connect a TCP socket, returning the time it took in milliseconds.
+static int32_t benchmarkConnect(uSockDescriptor_t descriptor,
+                                const uSockAddress_t *pRemoteAddress)
+{
+    int32_t errorCode = -1;
+    int32_t startTimeMs = 0;
+
+    // Connections can fail so allow this a few goes;
+    // only the successful go is timed
+    for (size_t x = 0; (x < 2) && (errorCode < 0); x++) {
+        startTimeMs = uPortGetTickTimeMs();
+        errorCode = uSockConnect(descriptor, pRemoteAddress);
+        if (errorCode < 0) {
+            errno = 0;
+        }
+    }
+    U_PORT_TEST_ASSERT(errorCode == 0);
+
+    return uPortGetTickTimeMs() - startTimeMs;
+}
+
+// Close a TCP socket, waiting for it to be closed.
+static void benchmarkClose(uSockDescriptor_t descriptor)
+{
+    bool closedCallbackCalled = false;
+
+    uSockRegisterCallbackClosed(descriptor, setBoolCallback,
+                                &closedCallbackCalled);
+    U_PORT_TEST_ASSERT(uSockClose(descriptor) == 0);
+    for (size_t x = 0; (x < U_SOCK_TEST_TCP_CLOSE_SECONDS) &&
+         !closedCallbackCalled; x++) {
+        uPortTaskBlock(1000);
+    }
+    U_PORT_TEST_ASSERT(closedCallbackCalled);
+}
+
+// Measure how long TCP connections take to set up.
+static void benchmarkTcpConnect(uDeviceHandle_t devHandle,
+                                const uSockAddress_t *pRemoteAddress,
+                                const char *pNetworkName,
+                                const char *pModeName)
+{
+    uSockDescriptor_t descriptor;
+    int32_t timeMs;
+    int32_t totalMs = 0;
+    int32_t minMs = INT32_MAX;
+    int32_t maxMs = 0;
+
+    U_TEST_PRINT_LINE("timing %d TCP connection(s)...", U_SOCK_TEST_BENCHMARK_CONNECT_NUM);
+    for (size_t x = 0; x < U_SOCK_TEST_BENCHMARK_CONNECT_NUM; x++) {
+        descriptor = uSockCreate(devHandle, U_SOCK_TYPE_STREAM, U_SOCK_PROTOCOL_TCP);
+        U_PORT_TEST_ASSERT(descriptor >= 0);
+        timeMs = benchmarkConnect(descriptor, pRemoteAddress);
+        totalMs += timeMs;
+        if (timeMs < minMs) {
+            minMs = timeMs;
+        }
+        if (timeMs > maxMs) {
+            maxMs = timeMs;
+        }
+        benchmarkClose(descriptor);
+    }
+
+    uPortLog(U_SOCK_TEST_BENCHMARK_PREFIX "{\"network\":\"%s\",\"mode\":\"%s\","
+             "\"test\":\"tcpConnect\",\"num\":%d,\"minMs\":%d,\"averageMs\":%d,"
+             "\"maxMs\":%d}\n", pNetworkName, pModeName,
+             U_SOCK_TEST_BENCHMARK_CONNECT_NUM, minMs,
+             totalMs / U_SOCK_TEST_BENCHMARK_CONNECT_NUM, maxMs);
+}
+
+// Measure TCP throughput, up to and back from the echo server,
+// writing payloadSize bytes at a time.
+static void benchmarkTcpThroughput(uDeviceHandle_t devHandle,
+                                   const uSockAddress_t *pRemoteAddress,
+                                   const char *pNetworkName,
+                                   const char *pModeName,
+                                   const char *pTxBuffer,
+                                   char *pRxBuffer,
+                                   size_t payloadSize)
+{
+    uSockDescriptor_t descriptor;
+    size_t sent = 0;
+    size_t received = 0;
+    int32_t startTimeMs;
+    int32_t upMs = -1;
+    int32_t downMs = -1;
+    int32_t x;
+    bool progress;
+
+    U_TEST_PRINT_LINE("timing %d byte(s) of TCP echo, %d byte(s) at a time...",
+                      U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES, payloadSize);
+    descriptor = uSockCreate(devHandle, U_SOCK_TYPE_STREAM, U_SOCK_PROTOCOL_TCP);
+    U_PORT_TEST_ASSERT(descriptor >= 0);
+    benchmarkConnect(descriptor, pRemoteAddress);
+    // Send and receive at the same time, so that the
+    // echoed data does not back-up
+    uSockBlockingSet(descriptor, false);
+    startTimeMs = uPortGetTickTimeMs();
+    while ((received < U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES) &&
+           (uPortGetTickTimeMs() - startTimeMs < U_SOCK_TEST_BENCHMARK_TCP_TIMEOUT_MS)) {
+        progress = false;
+        if (sent < U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES) {
+            x = U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES - sent;
+            if (x > (int32_t) payloadSize) {
+                x = (int32_t) payloadSize;
+            }
+            x = uSockWrite(descriptor, pTxBuffer, x);
+            if (x > 0) {
+                sent += x;
+                progress = true;
+                if (sent == U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES) {
+                    upMs = uPortGetTickTimeMs() - startTimeMs;
+                }
+            }
+        }
+        x = uSockRead(descriptor, pRxBuffer, payloadSize);
+        if (x > 0) {
+            received += x;
+            progress = true;
+        }
+        errno = 0;
+        if (!progress) {
+            uPortTaskBlock(10);
+        }
+    }
+    if (received == U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES) {
+        downMs = uPortGetTickTimeMs() - startTimeMs;
+    }
+    U_TEST_PRINT_LINE("%d byte(s) sent in %d ms, %d byte(s) received in %d ms.",
+                      sent, upMs, received, downMs);
+    benchmarkClose(descriptor);
+    U_PORT_TEST_ASSERT(upMs > 0);
+    U_PORT_TEST_ASSERT(downMs > 0);
+
+    // Bytes * 8 / milliseconds is kbits/s
+    uPortLog(U_SOCK_TEST_BENCHMARK_PREFIX "{\"network\":\"%s\",\"mode\":\"%s\","
+             "\"test\":\"tcpThroughput\",\"payloadBytes\":%d,\"totalBytes\":%d,"
+             "\"upMs\":%d,\"downMs\":%d,\"upKbps\":%d,\"downKbps\":%d}\n",
+             pNetworkName, pModeName, payloadSize, U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES,
+             upMs, downMs, (U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES * 8) / upMs,
+             (U_SOCK_TEST_BENCHMARK_TCP_SIZE_BYTES * 8) / downMs);
+}
+
+// Measure UDP round-trip times to the echo server.
+static void benchmarkUdpLatency(uDeviceHandle_t devHandle,
+                                const uSockAddress_t *pRemoteAddress,
+                                const char *pNetworkName,
+                                const char *pModeName,
+                                char *pTxBuffer,
+                                char *pRxBuffer,
+                                size_t payloadSize)
+{
+    uSockDescriptor_t descriptor;
+    struct timeval timeout;
+    int32_t rttMs[U_SOCK_TEST_BENCHMARK_UDP_NUM];
+    size_t numRtts = 0;
+    int32_t startTimeMs;
+    int32_t x;
+    bool echoed;
+    int32_t percentile[3] = {50, 90, 99};
+
+    if (payloadSize > U_SOCK_TEST_MAX_UDP_PACKET_SIZE) {
+        payloadSize = U_SOCK_TEST_MAX_UDP_PACKET_SIZE;
+    }
+    // Room for the sequence number
+    if (payloadSize < sizeof(uint32_t)) {
+        payloadSize = sizeof(uint32_t);
+    }
+    U_TEST_PRINT_LINE("timing %d UDP round trip(s) of %d byte(s)...",
+                      U_SOCK_TEST_BENCHMARK_UDP_NUM, payloadSize);
+    descriptor = uSockCreate(devHandle, U_SOCK_TYPE_DGRAM, U_SOCK_PROTOCOL_UDP);
+    U_PORT_TEST_ASSERT(descriptor >= 0);
+    timeout.tv_sec = U_SOCK_TEST_BENCHMARK_UDP_TIMEOUT_MS / 1000;
+    timeout.tv_usec = (U_SOCK_TEST_BENCHMARK_UDP_TIMEOUT_MS % 1000) * 1000;
+    U_PORT_TEST_ASSERT(uSockOptionSet(descriptor, U_SOCK_OPT_LEVEL_SOCK,
+                                      U_SOCK_OPT_RCVTIMEO,
+                                      (void *) &timeout, sizeof(timeout)) == 0);
+    for (uint32_t y = 0; y < U_SOCK_TEST_BENCHMARK_UDP_NUM; y++) {
+        // Put a sequence number at the start of the packet
+        // so that a late echo of a previous packet is not
+        // mistaken for this one
+        memcpy(pTxBuffer, &y, sizeof(y));
+        startTimeMs = uPortGetTickTimeMs();
+        echoed = false;
+        if (uSockSendTo(descriptor, pRemoteAddress, pTxBuffer,
+                        payloadSize) == (int32_t) payloadSize) {
+            while (!echoed &&
+                   (uPortGetTickTimeMs() - startTimeMs < U_SOCK_TEST_BENCHMARK_UDP_TIMEOUT_MS)) {
+                x = uSockReceiveFrom(descriptor, NULL, pRxBuffer, payloadSize);
+                echoed = (x == (int32_t) payloadSize) &&
+                         (memcmp(pRxBuffer, pTxBuffer, sizeof(y)) == 0);
+            }
+        }
+        errno = 0;
+        if (echoed) {
+            rttMs[numRtts] = uPortGetTickTimeMs() - startTimeMs;
+            numRtts++;
+        }
+    }
+    U_PORT_TEST_ASSERT(uSockClose(descriptor) == 0);
+    U_TEST_PRINT_LINE("%d of %d UDP packet(s) were echoed.", numRtts,
+                      U_SOCK_TEST_BENCHMARK_UDP_NUM);
+    U_PORT_TEST_ASSERT(numRtts > 0);
+
+    // Nearest-rank percentiles
+    qsort(rttMs, numRtts, sizeof(rttMs[0]), compareInt32);
+    for (size_t y = 0; y < sizeof(percentile) / sizeof(percentile[0]); y++) {
+        x = ((percentile[y] * (int32_t) numRtts) + 99) / 100;
+        percentile[y] = rttMs[x - 1];
+    }
+    uPortLog(U_SOCK_TEST_BENCHMARK_PREFIX "{\"network\":\"%s\",\"mode\":\"%s\","
+             "\"test\":\"udpLatency\",\"payloadBytes\":%d,\"num\":%d,\"lost\":%d,"
+             "\"p50Ms\":%d,\"p90Ms\":%d,\"p99Ms\":%d,\"maxMs\":%d}\n",
+             pNetworkName, pModeName, payloadSize, U_SOCK_TEST_BENCHMARK_UDP_NUM,
+             U_SOCK_TEST_BENCHMARK_UDP_NUM - numRtts, percentile[0], percentile[1],
+             percentile[2], rttMs[numRtts - 1]);
+}
+
+#endif // #ifdef U_SOCK_TEST_BENCHMARK
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -967,6 +1255,20 @@ U_PORT_TEST_FUNCTION("[sock]", "sockBasicUdp")
                                               &(remoteAddress.ipAddress)) == 0);
         heapSockInitLoss -= uPortGetHeapFree();
 
+        // A second look-up should be answered from the cache
+        // with the same address, and so should one after the
+        // cache has been flushed, though not from the cache
+        memset(&address, 0, sizeof(address));
+        U_PORT_TEST_ASSERT(uSockGetHostByName(devHandle,
+                                              U_SOCK_TEST_ECHO_UDP_SERVER_DOMAIN_NAME,
+                                              &(address.ipAddress)) == 0);
+        U_PORT_TEST_ASSERT(memcmp(&(address.ipAddress), &(remoteAddress.ipAddress),
+                                  sizeof(address.ipAddress)) == 0);
+        uSockGetHostByNameCacheFlush(devHandle);
+        U_PORT_TEST_ASSERT(uSockGetHostByName(devHandle,
+                                              U_SOCK_TEST_ECHO_UDP_SERVER_DOMAIN_NAME,
+                                              &(address.ipAddress)) == 0);
+
         // Add the port number we will use
         remoteAddress.port = U_SOCK_TEST_ECHO_UDP_SERVER_PORT;
 
@@ -1120,6 +1422,10 @@ U_PORT_TEST_FUNCTION("[sock]", "sockBasicTcp")
     int32_t heapUsed;
     int32_t heapSockInitLoss = 0;
     int32_t heapXxxSockInitLoss = 0;
+    uSockDescriptorSet_t readSet;
+    uSockDescriptorSet_t writeSet;
+    uSockStats_t stats;
+    uSockReadBatch_t batch;
 
     // Call clean up to release OS resources that may
     // have been left hanging by a previous failed test
@@ -1237,6 +1543,15 @@ U_PORT_TEST_FUNCTION("[sock]", "sockBasicTcp")
         // Check if the uSockTotalBytesSent() matches value of sizeBytes
         U_PORT_TEST_ASSERT(uSockGetTotalBytesSent(descriptor) == (int32_t)sizeBytes);
 
+        // The echo should wake up a select on the socket
+        U_SOCK_FD_ZERO(&readSet);
+        U_SOCK_FD_SET(descriptor, &readSet);
+        U_SOCK_FD_ZERO(&writeSet);
+        U_SOCK_FD_SET(descriptor, &writeSet);
+        U_PORT_TEST_ASSERT(uSockSelect(descriptor + 1, &readSet, &writeSet,
+                                       NULL, 20000) > 0);
+        U_PORT_TEST_ASSERT(U_SOCK_FD_ISSET(descriptor, &writeSet));
+
         // ...and capture them all again afterwards
         pDataReceived = (char *) pUPortMalloc((sizeof(gSendData) - 1) +
                                               (U_SOCK_TEST_GUARD_LENGTH_SIZE_BYTES * 2));
@@ -1277,6 +1592,28 @@ U_PORT_TEST_FUNCTION("[sock]", "sockBasicTcp")
                                                 pDataReceived,
                                                 sizeBytes));
 
+        // Check that the statistics add up
+        U_PORT_TEST_ASSERT(uSockStatsGet(descriptor, &stats) == 0);
+        U_PORT_TEST_ASSERT(stats.bytesSent == (int32_t) sizeBytes);
+        U_PORT_TEST_ASSERT(stats.bytesReceived == (int32_t) sizeBytes);
+        U_PORT_TEST_ASSERT(stats.numWrites > 0);
+        U_PORT_TEST_ASSERT(stats.numReads > 0);
+        U_PORT_TEST_ASSERT(stats.writeTimePeakMs <= stats.writeTimeTotalMs);
+        U_PORT_TEST_ASSERT(stats.blockedTimeMs <= stats.readTimeTotalMs);
+
+        // Everything has been read so a batched read should
+        // return nothing
+        batch.descriptor = descriptor;
+        batch.pData = pDataReceived + U_SOCK_TEST_GUARD_LENGTH_SIZE_BYTES;
+        batch.dataSizeBytes = sizeof(gSendData) - 1;
+        batch.negErrnoOrSize = 0;
+        errorCode = uSockReadBatch(&batch, 1);
+        U_TEST_PRINT_LINE("uSockReadBatch() returned %d, item %d.", errorCode,
+                          batch.negErrnoOrSize);
+        U_PORT_TEST_ASSERT(errorCode == 0);
+        U_PORT_TEST_ASSERT(batch.negErrnoOrSize <= 0);
+        U_PORT_TEST_ASSERT(errno == 0);
+
         U_TEST_PRINT_LINE("shutting down socket for read...");
         errorCode = uSockShutdown(descriptor,
                                   U_SOCK_SHUTDOWN_READ);
@@ -1494,6 +1831,7 @@ U_PORT_TEST_FUNCTION("[sock]", "sockOptionsSetGet")
     size_t *pLength;
     struct timeval timeout;
     char *pData[1];
+    uSockDatagram_t datagrams[2];
     int32_t startTimeMs;
     int32_t timeoutMs;
     int32_t elapsedMs;
@@ -1604,6 +1942,26 @@ U_PORT_TEST_FUNCTION("[sock]", "sockOptionsSetGet")
         U_PORT_TEST_ASSERT(elapsedMs < timeoutMs +
                            U_SOCK_TEST_TIME_MARGIN_PLUS_MS);
 
+        // A batched receive of nothing should fail in the same way
+        for (size_t x = 0; x < sizeof(datagrams) / sizeof(datagrams[0]); x++) {
+            datagrams[x].pAddress = NULL;
+            datagrams[x].pData = pData;
+            datagrams[x].dataSizeBytes = sizeof(pData);
+            datagrams[x].negErrnoOrSize = 0;
+        }
+        U_PORT_TEST_ASSERT(uSockReceiveFromBatch(descriptor, datagrams,
+                                                 sizeof(datagrams) /
+                                                 sizeof(datagrams[0])) < 0);
+        U_PORT_TEST_ASSERT(errno == U_SOCK_EWOULDBLOCK);
+        U_PORT_TEST_ASSERT(datagrams[0].negErrnoOrSize == -U_SOCK_EWOULDBLOCK);
+        errno = 0;
+        datagrams[1].pData = NULL;
+        U_PORT_TEST_ASSERT(uSockReceiveFromBatch(descriptor, datagrams,
+                                                 sizeof(datagrams) /
+                                                 sizeof(datagrams[0])) < 0);
+        U_PORT_TEST_ASSERT(errno == U_SOCK_EINVAL);
+        errno = 0;
+
         // Close the UDP socket
         U_PORT_TEST_ASSERT(uSockClose(descriptor) == 0);
         uSockCleanUp();
@@ -2750,6 +3108,119 @@ U_PORT_TEST_FUNCTION("[sock]", "sockAsyncTcpEcho")
     uNetworkTestListFree();
 }
 
+#ifdef U_SOCK_TEST_BENCHMARK
+/** Benchmark sockets against the echo servers, only compiled if
+ * U_SOCK_TEST_BENCHMARK is defined: TCP connection set-up time,
+ * TCP throughput and UDP round-trip time are measured for each
+ * payload size in U_SOCK_TEST_BENCHMARK_PAYLOAD_SIZES and, for
+ * cellular, in both binary and hex mode.  The results are printed
+ * as lines of JSON, each beginning with
+ * U_SOCK_TEST_BENCHMARK_PREFIX, so that they can be tracked from
+ * one ubxlib release to the next.
+ */
+U_PORT_TEST_FUNCTION("[sock]", "sockBenchmark")
+{
+    uNetworkTestList_t *pList;
+    uDeviceHandle_t devHandle;
+    uSockAddress_t tcpAddress;
+    uSockAddress_t udpAddress;
+    const char *pModeName[] = {"binary", "hex"};
+    size_t numModes;
+    size_t maxPayloadSize = U_SOCK_TEST_MAX_UDP_PACKET_SIZE;
+    char *pTxBuffer;
+    char *pRxBuffer;
+
+    // Call clean up to release OS resources that may
+    // have been left hanging by a previous failed test
+    osCleanup();
+
+    // Do the standard preamble to make sure there is
+    // a network underneath us
+    pList = pStdPreamble();
+
+    for (size_t x = 0; x < sizeof(gBenchmarkPayloadSize) / sizeof(gBenchmarkPayloadSize[0]); x++) {
+        if (gBenchmarkPayloadSize[x] > maxPayloadSize) {
+            maxPayloadSize = gBenchmarkPayloadSize[x];
+        }
+    }
+    pTxBuffer = (char *) pUPortMalloc(maxPayloadSize);
+    U_PORT_TEST_ASSERT(pTxBuffer != NULL);
+    pRxBuffer = (char *) pUPortMalloc(maxPayloadSize);
+    U_PORT_TEST_ASSERT(pRxBuffer != NULL);
+    // Binary data, all possible values
+    for (size_t x = 0; x < maxPayloadSize; x++) {
+        *(pTxBuffer + x) = (char) x;
+    }
+
+    // Repeat for all bearers
+    for (uNetworkTestList_t *pTmp = pList; pTmp != NULL; pTmp = pTmp->pNext) {
+        devHandle = *pTmp->pDevHandle;
+        U_TEST_PRINT_LINE("benchmarking sockets on %s.",
+                          gpUNetworkTestTypeName[pTmp->networkType]);
+        U_PORT_TEST_ASSERT(uSockGetHostByName(devHandle,
+                                              U_SOCK_TEST_ECHO_TCP_SERVER_DOMAIN_NAME,
+                                              &(tcpAddress.ipAddress)) == 0);
+        tcpAddress.port = U_SOCK_TEST_ECHO_TCP_SERVER_PORT;
+        U_PORT_TEST_ASSERT(uSockGetHostByName(devHandle,
+                                              U_SOCK_TEST_ECHO_UDP_SERVER_DOMAIN_NAME,
+                                              &(udpAddress.ipAddress)) == 0);
+        udpAddress.port = U_SOCK_TEST_ECHO_UDP_SERVER_PORT;
+
+        // Only cellular has a hex mode
+        numModes = 1;
+#ifdef U_CFG_TEST_CELL_MODULE_TYPE
+        if (pTmp->networkType == U_NETWORK_TYPE_CELL) {
+            numModes = 2;
+        }
+#endif
+        for (size_t m = 0; m < numModes; m++) {
+#ifdef U_CFG_TEST_CELL_MODULE_TYPE
+            if (pTmp->networkType == U_NETWORK_TYPE_CELL) {
+                if (m == 0) {
+                    U_PORT_TEST_ASSERT(uCellSockHexModeOff(devHandle) == 0);
+                } else {
+                    U_PORT_TEST_ASSERT(uCellSockHexModeOn(devHandle) == 0);
+                }
+            }
+#endif
+            benchmarkTcpConnect(devHandle, &tcpAddress,
+                                gpUNetworkTestTypeName[pTmp->networkType],
+                                pModeName[m]);
+            for (size_t x = 0; x < sizeof(gBenchmarkPayloadSize) / sizeof(gBenchmarkPayloadSize[0]); x++) {
+                benchmarkTcpThroughput(devHandle, &tcpAddress,
+                                       gpUNetworkTestTypeName[pTmp->networkType],
+                                       pModeName[m], pTxBuffer, pRxBuffer,
+                                       gBenchmarkPayloadSize[x]);
+                benchmarkUdpLatency(devHandle, &udpAddress,
+                                    gpUNetworkTestTypeName[pTmp->networkType],
+                                    pModeName[m], pTxBuffer, pRxBuffer,
+                                    gBenchmarkPayloadSize[x]);
+            }
+        }
+#ifdef U_CFG_TEST_CELL_MODULE_TYPE
+        if (pTmp->networkType == U_NETWORK_TYPE_CELL) {
+            U_PORT_TEST_ASSERT(uCellSockHexModeOff(devHandle) == 0);
+        }
+#endif
+        uSockCleanUp();
+    }
+
+    uPortFree(pRxBuffer);
+    uPortFree(pTxBuffer);
+
+    // Remove each network type
+    for (uNetworkTestList_t *pTmp = pList; pTmp != NULL; pTmp = pTmp->pNext) {
+        U_TEST_PRINT_LINE("taking down %s...",
+                          gpUNetworkTestTypeName[pTmp->networkType]);
+        U_PORT_TEST_ASSERT(uNetworkInterfaceDown(*pTmp->pDevHandle,
+                                                 pTmp->networkType) == 0);
+    }
+
+    // To speed things up, do not close the device
+    uNetworkTestListFree();
+}
+#endif // #ifdef U_SOCK_TEST_BENCHMARK
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
@@ -41,7 +41,8 @@
  * mesages can be spread across PMP messages, starting in one
  * and ending in another.  In order to use these validation
  * functions the SPARTN messages must first be extracted from
- * the PMP messages.
+ * the PMP messages; the SPARTN stream functions,
+ * uSpartnStreamInit() etc., are provided for this purpose.
  */
 
 #ifdef __cplusplus
@@ -56,10 +57,113 @@ extern "C" {
  */
 #define U_SPARTN_MESSAGE_LENGTH_MAX_BYTES (4 + 8 + 1024 + 64 + 4)
 
+#ifndef U_SPARTN_ROUTER_NUM_ENTRIES
+/** The number of recently seen messages that a SPARTN router
+ * remembers in order to detect duplicates; each costs 12 bytes
+ * of RAM in #uSpartnRouter_t.  The messages from any one source
+ * arrive in bursts, a few seconds apart, of up to a few tens of
+ * messages, so this should be large enough to cover the worst-case
+ * offset between your sources in messages.
+ */
+# define U_SPARTN_ROUTER_NUM_ENTRIES 32
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The callback that is called by uSpartnStreamAdd() with each
+ * complete, validated, SPARTN message.
+ *
+ * @param[in] pMessage        a pointer to the message, TF001 to
+ *                            TF018, still encrypted; this is only
+ *                            valid for the duration of the callback,
+ *                            copy it if you need it afterwards.
+ * @param size                the number of bytes at pMessage.
+ * @param[in] pCallbackParam  the pCallbackParam that was passed to
+ *                            uSpartnStreamInit().
+ */
+typedef void (uSpartnStreamCallback_t)(const char *pMessage, size_t size,
+                                       void *pCallbackParam);
+
+/** A SPARTN stream, used to reassemble SPARTN messages from data
+ * that arrives in arbitrary chunks.  The memory for this structure
+ * is supplied by the application; it is quite large, since it must
+ * be able to hold a message of #U_SPARTN_MESSAGE_LENGTH_MAX_BYTES.
+ * The contents are internal, please use the SPARTN stream functions
+ * to get to them.
+ */
+typedef struct {
+    uSpartnStreamCallback_t *pCallback;
+    void *pCallbackParam;
+    size_t length;              /**< the number of bytes in buffer. */
+    int32_t messageLength;      /**< the length of the message that
+                                     begins at the start of buffer,
+                                     zero if not yet known. */
+    size_t numBytesDiscarded;   /**< the number of bytes thrown away. */
+    char buffer[U_SPARTN_MESSAGE_LENGTH_MAX_BYTES];
+} uSpartnStream_t;
+
+/** The fields of a SPARTN message header that identify the
+ * message, as decoded by uSpartnGetHeader().
+ */
+typedef struct {
+    uint8_t type;      /**< the message type, TF002, e.g. 0 for OCB,
+                            1 for HPAC, 2 for GAD. */
+    uint8_t subtype;   /**< the message sub-type, TF007, e.g. the GNSS
+                            system for OCB and HPAC messages. */
+    bool timeTag32;    /**< true if the GNSS time tag is a 32-bit
+                            one, TF008. */
+    uint32_t timeTag;  /**< the GNSS time tag, TF009: if timeTag32 is
+                            true this is in seconds since
+                            2010-01-01 00:00:00, else it is seconds
+                            within the current half day. */
+    uint32_t crc;      /**< the message CRC, TF018, as carried in the
+                            message, right-aligned. */
+    size_t size;       /**< the length of the whole message in bytes. */
+} uSpartnHeader_t;
+
+/** The callback that is called by uSpartnRouterAdd() with each
+ * message that has not been seen before.
+ *
+ * @param[in] pHeader         the decoded header of the message.
+ * @param[in] pMessage        a pointer to the message, TF001 to TF018;
+ *                            this is only valid for the duration of
+ *                            the callback.
+ * @param[in] pCallbackParam  the pCallbackParam that was passed to
+ *                            uSpartnRouterInit().
+ */
+typedef void (uSpartnRouterCallback_t)(const uSpartnHeader_t *pHeader,
+                                       const char *pMessage,
+                                       void *pCallbackParam);
+
+/** An entry in the list of recently seen messages of a SPARTN
+ * router.
+ */
+typedef struct {
+    uint32_t timeTag;
+    uint32_t crc;
+    uint8_t type;
+    uint8_t subtype;
+} uSpartnRouterEntry_t;
+
+/** A SPARTN router, used to pass on only one copy of each SPARTN
+ * message where the same messages arrive from more than one source,
+ * e.g. over IP and over L-band.  The memory for this structure
+ * is supplied by the application.  The contents are internal,
+ * please use the SPARTN router functions to get to them.
+ */
+typedef struct {
+    uSpartnRouterCallback_t *pCallback;
+    void *pCallbackParam;
+    size_t numEntries;     /**< the number of entries in use. */
+    size_t numDuplicates;  /**< the number of messages dropped. */
+    uSpartnRouterEntry_t entry[U_SPARTN_ROUTER_NUM_ENTRIES]; /**< most
+                                                                  recently
+                                                                  seen
+                                                                  first. */
+} uSpartnRouter_t;
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -145,6 +249,127 @@ int32_t uSpartnDetect(const char *pBuffer, size_t bufferLengthBytes,
 int32_t uSpartnValidate(const char *pBuffer, size_t bufferLengthBytes,
                         const char **ppMessage);
 
+/** Initialise a SPARTN stream, which can then be given data in
+ * chunks of any size, e.g. as it is taken out of UBX-format PMP
+ * messages from a NEO-D9S, with uSpartnStreamAdd(); each complete,
+ * validated, SPARTN message will be passed to pCallback.  Data is
+ * held in the stream only while it might be part of a message: a
+ * partial header or message is carried over from one call to the
+ * next, so the data is not searched again from the start each time.
+ *
+ * These functions are not thread-safe: if you add data to a
+ * stream from more than one task, protect the stream with a
+ * mutex of your own.
+ *
+ * @param[in] pStream        a pointer to the stream, cannot be NULL.
+ * @param[in] pCallback      the callback to be called with each
+ *                           message; cannot be NULL.
+ * @param[in] pCallbackParam a parameter that will be passed to
+ *                           pCallback; may be NULL.
+ * @return                   zero on success else negative error code.
+ */
+int32_t uSpartnStreamInit(uSpartnStream_t *pStream,
+                          uSpartnStreamCallback_t *pCallback,
+                          void *pCallbackParam);
+
+/** Add data to a SPARTN stream.  pCallback, as passed to
+ * uSpartnStreamInit(), is called, from within this function, with
+ * any messages that this data completes.
+ *
+ * @param[in] pStream a pointer to the stream, cannot be NULL.
+ * @param[in] pData   the data to add; may be NULL only if size is zero.
+ * @param size        the number of bytes at pData.
+ * @return            on success the number of messages that were
+ *                    passed to pCallback during this call, else
+ *                    negative error code.
+ */
+int32_t uSpartnStreamAdd(uSpartnStream_t *pStream, const char *pData,
+                         size_t size);
+
+/** Reset a SPARTN stream, throwing away any partial message it holds,
+ * e.g. because the data source has been interrupted.
+ *
+ * @param[in] pStream a pointer to the stream, cannot be NULL.
+ */
+void uSpartnStreamReset(uSpartnStream_t *pStream);
+
+/** Get the number of bytes that a SPARTN stream has thrown away,
+ * since uSpartnStreamInit() was called, because they were not part
+ * of a valid SPARTN message; useful as an indication of link quality.
+ *
+ * @param[in] pStream a pointer to the stream, cannot be NULL.
+ * @return            the number of bytes thrown away.
+ */
+size_t uSpartnStreamGetBytesDiscarded(const uSpartnStream_t *pStream);
+
+/** Decode the fields of a SPARTN message header that identify
+ * the message: type, sub-type and GNSS time tag, plus the message
+ * CRC.  The whole message must be present; no message CRC check
+ * is carried out, for that use uSpartnValidate().
+ *
+ * @param[in] pMessage a pointer to the start of the message, TF001.
+ * @param size         the amount of data at pMessage.
+ * @param[out] pHeader a place to put the decoded header; cannot
+ *                     be NULL.
+ * @return             on success the length of the message, else
+ *                     negative error code; if size is not enough to
+ *                     hold the whole message #U_ERROR_COMMON_TIMEOUT
+ *                     will be returned.
+ */
+int32_t uSpartnGetHeader(const char *pMessage, size_t size,
+                         uSpartnHeader_t *pHeader);
+
+/** Initialise a SPARTN router. The router passes a message on to
+ * pCallback only if it is not one of the last
+ * #U_SPARTN_ROUTER_NUM_ENTRIES messages given to it, a message being
+ * identified by its type, sub-type, GNSS time tag and message CRC,
+ * so that, where the same SPARTN messages arrive from more than one
+ * source, each is sent to the GNSS chip only once.  pCallback is
+ * given the decoded header, so it may also route messages by type
+ * and sub-type, e.g. to drop those for GNSS systems that are not in
+ * use.  This function may also be used to forget all of the
+ * messages seen so far.
+ *
+ * These functions are not thread-safe: if you add messages to a
+ * router from more than one task, e.g. one per source, protect the
+ * router with a mutex of your own.
+ *
+ * @param[in] pRouter        a pointer to the router, cannot be NULL.
+ * @param[in] pCallback      the callback to be called with each message
+ *                           that is not a duplicate; cannot be NULL.
+ * @param[in] pCallbackParam a parameter that will be passed to
+ *                           pCallback; may be NULL.
+ * @return                   zero on success else negative error code.
+ */
+int32_t uSpartnRouterInit(uSpartnRouter_t *pRouter,
+                          uSpartnRouterCallback_t *pCallback,
+                          void *pCallbackParam);
+
+/** Add a message to a SPARTN router; pCallback, as passed to
+ * uSpartnRouterInit(), is called from within this function if the
+ * message is not a duplicate.  The message should already have
+ * been validated, e.g. by being delivered by the callback of
+ * uSpartnStreamAdd() or by uSpartnValidate().
+ *
+ * @param[in] pRouter  a pointer to the router, cannot be NULL.
+ * @param[in] pMessage a pointer to a single, complete, SPARTN
+ *                     message; cannot be NULL.
+ * @param size         the length of the message at pMessage.
+ * @return             1 if the message was passed to pCallback, 0 if
+ *                     it was dropped as a duplicate, else negative
+ *                     error code.
+ */
+int32_t uSpartnRouterAdd(uSpartnRouter_t *pRouter, const char *pMessage,
+                         size_t size);
+
+/** Get the number of messages that a SPARTN router has dropped as
+ * duplicates since uSpartnRouterInit() was called.
+ *
+ * @param[in] pRouter a pointer to the router, cannot be NULL.
+ * @return            the number of duplicates dropped.
+ */
+size_t uSpartnRouterGetNumDuplicates(const uSpartnRouter_t *pRouter);
+
 #ifdef __cplusplus
 }
 #endif
@@ -93,7 +93,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // memcpy()
+#include "string.h"    // memcpy(), memmove(), memchr()
 
 #include "u_error_common.h"
 
@@ -110,6 +110,13 @@
  */
 #define U_SPARTN_HEADER_LENGTH_MIN_BYTES (4 + 4)
 
+/** The maximum length of a SPARTN message header, TF001 to TF015,
+ * i.e. the minimum plus a 32-bit GNSS time tag plus the
+ * ENCRYPT/AUTH fields; once this much of a message is in hand
+ * the length of the message can always be determined.
+ */
+#define U_SPARTN_HEADER_LENGTH_MAX_BYTES (U_SPARTN_HEADER_LENGTH_MIN_BYTES + 2 + 2)
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -122,6 +129,142 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Decode a SPARTN message header that begins at the start of a
+// buffer, returning the length of the message, U_ERROR_COMMON_TIMEOUT
+// if there is not yet enough data to tell or U_ERROR_COMMON_NOT_FOUND
+// if the start of the buffer is not a SPARTN message header, and
+// supplying the message CRC position and type.
+static int32_t decodeHeaderAt(const uint8_t *pInput, size_t bufferLengthBytes,
+                              const char **ppMessageCrcStart,
+                              uSpartnCrcType_t *pMessageCrcType)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+    const uint8_t *pMessage;
+    uint8_t frameBuffer[4];
+    size_t lengthHeader;
+    size_t lengthBeyondHeader;
+    size_t crcType;
+
+    if (*pInput == 0x73) {
+        // Potentially a FRAME START
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
+        pMessage = pInput;
+        if (bufferLengthBytes >= U_SPARTN_HEADER_LENGTH_MIN_BYTES) {
+            // Have enough data to work on the header; confirm that this
+            // is a FRAME START by doing a frame CRC check on it
+            // Copy everything from FRAME START except TF001 into a buffer
+            memcpy(&frameBuffer, pInput + 1, 3);
+            frameBuffer[3] = 0;
+
+            // frameBuffer now contains, in order of bit-arrival:
+            //
+            // bytes:    |      0     |     1     |      2      |     3     |
+            // contents: |<---T7---><-----L10------->E1-MCT2-FC4|           |
+            // meaning:  |M       L M |           |L    M L  M L|           |
+
+            // Remove the frame CRC that is in the lower four
+            // bits of byte 2, giving us 20 bits in the buffer with
+            // zero-fill elsewhere
+            frameBuffer[2] &= 0xf0;
+            // Compute the CRC-4 over 24 bits and check it against the frame CRC (TF006)
+            if (uSpartnCrc4((const char *) frameBuffer, 3) == (*(pInput + 3) & 0x0f)) {
+                lengthHeader = U_SPARTN_HEADER_LENGTH_MIN_BYTES;
+                // So far so good, now parse the PAYLOAD DESCRIPTION to work out
+                // how long it is; check if the TF008 (GNSS time tag type) bit is set
+                if (*(pInput + 4) & 0x08) {
+                    // The GNSS time tag is 32 bits instead of 16, so account for that
+                    lengthHeader += 2;
+                }
+                // Work out the length beyond the message header
+                // First the length of the payload from the 10-bit TF003 field,
+                // which is splattered across the three bytes of frameBuffer
+                lengthBeyondHeader = ((((size_t) frameBuffer[0]) & 0x01) << 9) +
+                                     (((size_t) frameBuffer[1]) << 1) +
+                                     ((((size_t) frameBuffer[2]) & 0x80) >> 7);
+                // Add the length of the message CRC by looking at
+                // the 2-bit message CRC type field (TF005).  Since we have
+                // 0: CRC-8, 1: CRC-16, 2: CRC-24, 3: CRC-32 it is easy
+                // to calculate
+                crcType = (frameBuffer[2] & 0x30) >> 4;
+                lengthBeyondHeader += crcType + 1;
+                if (pMessageCrcType != NULL) {
+                    *pMessageCrcType = (uSpartnCrcType_t) crcType;
+                }
+                // Work out the additions as a consequence of encryption/authentication
+                // being switched on
+                if (frameBuffer[2] & 0x40) {
+                    // TF004 is set, so we need the ENCRYPT/AUTH fields to work
+                    // out the message length; see if they are in the buffer
+                    if ((int32_t) bufferLengthBytes - (int32_t) lengthHeader >= 2) {
+                        // The ENCRYPT/AUTH fields are in the buffer
+                        lengthHeader += 2;
+                        // To work out how big the AUTHENTICATION field is we
+                        // need to check if the authentication indicator field
+                        // (TF014) in PAYLOAD DESCRIPTION is greater than 1.
+                        // This is in the final byte of the header so we
+                        // can use lengthHeader, which is now pointing
+                        // at the start of the payload, to index to it
+                        if (((*(pInput + lengthHeader - 1) & 0x38) >> 3) > 1) {
+                            // AUTHENTICATION is present, find out how
+                            // big it is from the 3-bit authentication
+                            // length (TF015) at the beginning of the same
+                            // byte
+                            switch (*(pInput + lengthHeader - 1) & 0x07) {
+                                case 0: // 64 bits
+                                    lengthBeyondHeader += 64 / 8;
+                                    break;
+                                case 1: // 96 bits
+                                    lengthBeyondHeader += 96 / 8;
+                                    break;
+                                case 2: // 128 bits
+                                    lengthBeyondHeader += 128 / 8;
+                                    break;
+                                case 3: // 256 bits
+                                    lengthBeyondHeader += 256 / 8;
+                                    break;
+                                case 4: // 512 bits
+                                    lengthBeyondHeader += 512 / 8;
+                                    break;
+                                default:
+                                    // Error case: not a supported message
+                                    sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+                                    lengthHeader = 0;
+                                    break;
+                            }
+                        }
+                    } else {
+                        // Might be a message but we don't yet have enough
+                        // data to work out its length; set the length
+                        // of the header to zero to flag this
+                        lengthHeader = 0;
+                    }
+                }
+                if (lengthHeader > 0) {
+                    // We have a header length, so (a) there are no errors and (b)
+                    // we have all the data we need to determine the message length,
+                    // then we are done; otherwise sizeOrErrorCode is left at
+                    // U_ERROR_COMMON_TIMEOUT (or U_ERROR_COMMON_NOT_FOUND if there
+                    // was an error)
+                    sizeOrErrorCode = (int32_t) (lengthHeader + lengthBeyondHeader);
+                    if (ppMessageCrcStart != NULL) {
+                        *ppMessageCrcStart = (const char *) pMessage + lengthHeader + lengthBeyondHeader - (crcType + 1);
+                    }
+                }
+            } else {
+                // Not a SPARTN message
+                sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            }
+        } else {
+            // Might be a SPARTN message but we don't yet have all of
+            // the header and hence can't work out the message
+            // length; leave sizeOrErrorCode at U_ERROR_COMMON_TIMEOUT
+            // so that the caller knows we need more data
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+
 // Look for a SPARTN message header in a buffer and supply its position,
 // plus the message CRC position and type.
 static int32_t decodeHeader(const char *pBuffer, size_t bufferLengthBytes,
@@ -133,10 +276,6 @@ static int32_t decodeHeader(const char *pBuffer, size_t bufferLengthBytes,
     // Use a uint8_t pointer for maths, more certain of its behaviour than char
     const uint8_t *pInput = (const uint8_t *) pBuffer;
     const uint8_t *pMessage = NULL;
-    uint8_t frameBuffer[4];
-    size_t lengthHeader;
-    size_t lengthBeyondHeader;
-    size_t crcType;
 
     if (pInput != NULL) {
         sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
@@ -144,119 +283,10 @@ static int32_t decodeHeader(const char *pBuffer, size_t bufferLengthBytes,
                (bufferLengthBytes > 0)) {
             if (*pInput == 0x73) {
                 // Potentially a FRAME START
-                sizeOrErrorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
                 pMessage = pInput;
-                if (bufferLengthBytes >= U_SPARTN_HEADER_LENGTH_MIN_BYTES) {
-                    // Have enough data to work on the header; confirm that this
-                    // is a FRAME START by doing a frame CRC check on it
-                    // Copy everything from FRAME START except TF001 into a buffer
-                    memcpy(&frameBuffer, pInput + 1, 3);
-                    frameBuffer[3] = 0;
-
-                    // frameBuffer now contains, in order of bit-arrival:
-                    //
-                    // bytes:    |      0     |     1     |      2      |     3     |
-                    // contents: |<---T7---><-----L10------->E1-MCT2-FC4|           |
-                    // meaning:  |M       L M |           |L    M L  M L|           |
-
-                    // Remove the frame CRC that is in the lower four
-                    // bits of byte 2, giving us 20 bits in the buffer with
-                    // zero-fill elsewhere
-                    frameBuffer[2] &= 0xf0;
-                    // Compute the CRC-4 over 24 bits and check it against the frame CRC (TF006)
-                    if (uSpartnCrc4((const char *) frameBuffer, 3) == (*(pInput + 3) & 0x0f)) {
-                        lengthHeader = U_SPARTN_HEADER_LENGTH_MIN_BYTES;
-                        // So far so good, now parse the PAYLOAD DESCRIPTION to work out
-                        // how long it is; check if the TF008 (GNSS time tag type) bit is set
-                        if (*(pInput + 4) & 0x08) {
-                            // The GNSS time tag is 32 bits instead of 16, so account for that
-                            lengthHeader += 2;
-                        }
-                        // Work out the length beyond the message header
-                        // First the length of the payload from the 10-bit TF003 field,
-                        // which is splattered across the three bytes of frameBuffer
-                        lengthBeyondHeader = ((((size_t) frameBuffer[0]) & 0x01) << 9) +
-                                             (((size_t) frameBuffer[1]) << 1) +
-                                             ((((size_t) frameBuffer[2]) & 0x80) >> 7);
-                        // Add the length of the message CRC by looking at
-                        // the 2-bit message CRC type field (TF005).  Since we have
-                        // 0: CRC-8, 1: CRC-16, 2: CRC-24, 3: CRC-32 it is easy
-                        // to calculate
-                        crcType = (frameBuffer[2] & 0x30) >> 4;
-                        lengthBeyondHeader += crcType + 1;
-                        if (pMessageCrcType != NULL) {
-                            *pMessageCrcType = (uSpartnCrcType_t) crcType;
-                        }
-                        // Work out the additions as a consequence of encryption/authentication
-                        // being switched on
-                        if (frameBuffer[2] & 0x40) {
-                            // TF004 is set, so we need the ENCRYPT/AUTH fields to work
-                            // out the message length; see if they are in the buffer
-                            if ((int32_t) bufferLengthBytes - (int32_t) lengthHeader >= 2) {
-                                // The ENCRYPT/AUTH fields are in the buffer
-                                lengthHeader += 2;
-                                // To work out how big the AUTHENTICATION field is we
-                                // need to check if the authentication indicator field
-                                // (TF014) in PAYLOAD DESCRIPTION is greater than 1.
-                                // This is in the final byte of the header so we
-                                // can use lengthHeader, which is now pointing
-                                // at the start of the payload, to index to it
-                                if (((*(pInput + lengthHeader - 1) & 0x38) >> 3) > 1) {
-                                    // AUTHENTICATION is present, find out how
-                                    // big it is from the 3-bit authentication
-                                    // length (TF015) at the beginning of the same
-                                    // byte
-                                    switch (*(pInput + lengthHeader - 1) & 0x07) {
-                                        case 0: // 64 bits
-                                            lengthBeyondHeader += 64 / 8;
-                                            break;
-                                        case 1: // 96 bits
-                                            lengthBeyondHeader += 96 / 8;
-                                            break;
-                                        case 2: // 128 bits
-                                            lengthBeyondHeader += 128 / 8;
-                                            break;
-                                        case 3: // 256 bits
-                                            lengthBeyondHeader += 256 / 8;
-                                            break;
-                                        case 4: // 512 bits
-                                            lengthBeyondHeader += 512 / 8;
-                                            break;
-                                        default:
-                                            // Error case: not a supported message
-                                            sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
-                                            lengthHeader = 0;
-                                            break;
-                                    }
-                                }
-                            } else {
-                                // Might be a message but we don't yet have enough
-                                // data to work out its length; set the length
-                                // of the header to zero to flag this
-                                lengthHeader = 0;
-                            }
-                        }
-                        if (lengthHeader > 0) {
-                            // We have a header length, so (a) there are no errors and (b)
-                            // we have all the data we need to determine the message length,
-                            // then we are done; otherwise sizeOrErrorCode is left at
-                            // U_ERROR_COMMON_TIMEOUT (or U_ERROR_COMMON_NOT_FOUND if there
-                            // was an error)
-                            sizeOrErrorCode = (int32_t) (lengthHeader + lengthBeyondHeader);
-                            if (ppMessageCrcStart != NULL) {
-                                *ppMessageCrcStart = (const char *) pMessage + lengthHeader + lengthBeyondHeader - (crcType + 1);
-                            }
-                        }
-                    } else {
-                        // Not a SPARTN message
-                        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
-                    }
-                } else {
-                    // Might be a SPARTN message but we don't yet have all of
-                    // the header and hence can't work out the message
-                    // length; leave sizeOrErrorCode at U_ERROR_COMMON_TIMEOUT
-                    // so that the caller knows we need more data
-                }
+                sizeOrErrorCode = decodeHeaderAt(pInput, bufferLengthBytes,
+                                                 ppMessageCrcStart,
+                                                 pMessageCrcType);
             }
 
             // Move along
@@ -272,6 +302,29 @@ static int32_t decodeHeader(const char *pBuffer, size_t bufferLengthBytes,
     return sizeOrErrorCode;
 }
 
+// Remove count bytes from the start of the buffer of a stream and
+// then throw away anything before the next possible FRAME START
+// left in the buffer, counting what is thrown away as discarded.
+static void streamDrop(uSpartnStream_t *pStream, size_t count)
+{
+    const char *pStart;
+
+    if (count > pStream->length) {
+        count = pStream->length;
+    }
+    pStream->length -= count;
+    pStart = (const char *) memchr(pStream->buffer + count, 0x73, pStream->length);
+    if (pStart == NULL) {
+        pStream->numBytesDiscarded += pStream->length;
+        pStream->length = 0;
+    } else {
+        pStream->numBytesDiscarded += pStart - (pStream->buffer + count);
+        pStream->length -= pStart - (pStream->buffer + count);
+        memmove(pStream->buffer, pStart, pStream->length);
+    }
+    pStream->messageLength = 0;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -352,4 +405,262 @@ int32_t uSpartnValidate(const char *pBuffer, size_t bufferLengthBytes,
     return sizeOrErrorCode;
 }
 
+// Initialise a SPARTN stream.
+int32_t uSpartnStreamInit(uSpartnStream_t *pStream,
+                          uSpartnStreamCallback_t *pCallback,
+                          void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pStream != NULL) && (pCallback != NULL)) {
+        pStream->pCallback = pCallback;
+        pStream->pCallbackParam = pCallbackParam;
+        pStream->length = 0;
+        pStream->messageLength = 0;
+        pStream->numBytesDiscarded = 0;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Add data to a SPARTN stream.
+int32_t uSpartnStreamAdd(uSpartnStream_t *pStream, const char *pData,
+                         size_t size)
+{
+    int32_t errorCodeOrNumMessages = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    const char *pStart;
+    const char *pMessage;
+    size_t wanted;
+    size_t count;
+    int32_t x;
+    bool keepGoing = true;
+
+    if ((pStream != NULL) && (pStream->pCallback != NULL) &&
+        ((pData != NULL) || (size == 0))) {
+        errorCodeOrNumMessages = 0;
+        while (keepGoing) {
+            keepGoing = false;
+            if ((pStream->length == 0) && (size > 0)) {
+                // Nothing held: skip input up to the next possible FRAME START
+                pStart = (const char *) memchr(pData, 0x73, size);
+                if (pStart == NULL) {
+                    pStart = pData + size;
+                }
+                pStream->numBytesDiscarded += pStart - pData;
+                size -= pStart - pData;
+                pData = pStart;
+            }
+            // Top up the buffer from the input: only up to the maximum
+            // header length if the message length is not yet known,
+            // else up to the end of the message, so that nothing
+            // held is ever looked at twice unless it turns out to
+            // be bad
+            wanted = U_SPARTN_HEADER_LENGTH_MAX_BYTES;
+            if (pStream->messageLength > 0) {
+                wanted = (size_t) pStream->messageLength;
+            }
+            if (wanted > pStream->length) {
+                count = wanted - pStream->length;
+                if (count > size) {
+                    count = size;
+                }
+                memcpy(pStream->buffer + pStream->length, pData, count);
+                pStream->length += count;
+                pData += count;
+                size -= count;
+            }
+            if ((pStream->messageLength == 0) && (pStream->length > 0)) {
+                x = decodeHeaderAt((const uint8_t *) pStream->buffer, pStream->length,
+                                   NULL, NULL);
+                if ((x > 0) && (x <= (int32_t) sizeof(pStream->buffer))) {
+                    // Got a header, now we can collect the rest of the message
+                    pStream->messageLength = x;
+                    keepGoing = true;
+                } else if (x != (int32_t) U_ERROR_COMMON_TIMEOUT) {
+                    // Not a header, move on by one and look again
+                    pStream->numBytesDiscarded++;
+                    streamDrop(pStream, 1);
+                    keepGoing = true;
+                }
+                // Otherwise we need more data than there is
+            } else if ((pStream->messageLength > 0) &&
+                       (pStream->length >= (size_t) pStream->messageLength)) {
+                // Got the whole message, check it
+                if ((uSpartnValidate(pStream->buffer, pStream->messageLength,
+                                     &pMessage) == pStream->messageLength) &&
+                    (pMessage == pStream->buffer)) {
+                    pStream->pCallback(pStream->buffer, pStream->messageLength,
+                                       pStream->pCallbackParam);
+                    errorCodeOrNumMessages++;
+                    streamDrop(pStream, pStream->messageLength);
+                } else {
+                    // The header must have been a false positive,
+                    // move on by one and look again
+                    pStream->numBytesDiscarded++;
+                    streamDrop(pStream, 1);
+                }
+                keepGoing = true;
+            }
+        }
+    }
+
+    return errorCodeOrNumMessages;
+}
+
+// Reset a SPARTN stream.
+void uSpartnStreamReset(uSpartnStream_t *pStream)
+{
+    if (pStream != NULL) {
+        pStream->numBytesDiscarded += pStream->length;
+        pStream->length = 0;
+        pStream->messageLength = 0;
+    }
+}
+
+// Get the number of bytes a SPARTN stream has thrown away.
+size_t uSpartnStreamGetBytesDiscarded(const uSpartnStream_t *pStream)
+{
+    size_t numBytesDiscarded = 0;
+
+    if (pStream != NULL) {
+        numBytesDiscarded = pStream->numBytesDiscarded;
+    }
+
+    return numBytesDiscarded;
+}
+
+// Decode the identifying fields of a SPARTN message header.
+int32_t uSpartnGetHeader(const char *pMessage, size_t size,
+                         uSpartnHeader_t *pHeader)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    // Use a uint8_t pointer for maths, more certain of its behaviour than char
+    const uint8_t *pInput = (const uint8_t *) pMessage;
+    const uint8_t *pMessageCrcStart = NULL;
+
+    if ((pInput != NULL) && (size > 0) && (pHeader != NULL)) {
+        sizeOrErrorCode = decodeHeaderAt(pInput, size,
+                                         (const char **) &pMessageCrcStart, NULL);
+        if ((sizeOrErrorCode > 0) && ((size_t) sizeOrErrorCode > size)) {
+            sizeOrErrorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
+        }
+        if (sizeOrErrorCode > 0) {
+            // TF002, the message type, is the upper seven bits of
+            // the byte after the preamble
+            pHeader->type = *(pInput + 1) >> 1;
+            // The PAYLOAD DESCRIPTION begins with TF007, the 4-bit
+            // message sub-type, then TF008, the time tag type bit,
+            // then TF009, the GNSS time tag, of which the upper three
+            // bits are in the same byte
+            pHeader->subtype = *(pInput + 4) >> 4;
+            pHeader->timeTag32 = ((*(pInput + 4) & 0x08) != 0);
+            if (pHeader->timeTag32) {
+                pHeader->timeTag = (((uint32_t) (*(pInput + 4) & 0x07)) << 29) +
+                                   (((uint32_t) * (pInput + 5)) << 21) +
+                                   (((uint32_t) * (pInput + 6)) << 13) +
+                                   (((uint32_t) * (pInput + 7)) << 5) +
+                                   (((uint32_t) * (pInput + 8)) >> 3);
+            } else {
+                pHeader->timeTag = (((uint32_t) (*(pInput + 4) & 0x07)) << 13) +
+                                   (((uint32_t) * (pInput + 5)) << 5) +
+                                   (((uint32_t) * (pInput + 6)) >> 3);
+            }
+            // The message CRC runs from pMessageCrcStart to the end
+            // of the message, MSB first
+            pHeader->crc = 0;
+            while (pMessageCrcStart < pInput + sizeOrErrorCode) {
+                pHeader->crc = (pHeader->crc << 8) + *pMessageCrcStart;
+                pMessageCrcStart++;
+            }
+            pHeader->size = (size_t) sizeOrErrorCode;
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+
+// Initialise a SPARTN router.
+int32_t uSpartnRouterInit(uSpartnRouter_t *pRouter,
+                          uSpartnRouterCallback_t *pCallback,
+                          void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pRouter != NULL) && (pCallback != NULL)) {
+        pRouter->pCallback = pCallback;
+        pRouter->pCallbackParam = pCallbackParam;
+        pRouter->numEntries = 0;
+        pRouter->numDuplicates = 0;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Add a message to a SPARTN router.
+int32_t uSpartnRouterAdd(uSpartnRouter_t *pRouter, const char *pMessage,
+                         size_t size)
+{
+    int32_t errorCodeOrPassed = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uSpartnHeader_t header;
+    uSpartnRouterEntry_t entry;
+    uSpartnRouterEntry_t *pEntry;
+    size_t x = 0;
+
+    if ((pRouter != NULL) && (pRouter->pCallback != NULL) && (pMessage != NULL)) {
+        errorCodeOrPassed = uSpartnGetHeader(pMessage, size, &header);
+        if (errorCodeOrPassed == (int32_t) size) {
+            entry.type = header.type;
+            entry.subtype = header.subtype;
+            entry.timeTag = header.timeTag;
+            entry.crc = header.crc;
+            // Look for the message among those seen recently
+            pEntry = pRouter->entry;
+            while ((x < pRouter->numEntries) &&
+                   ((pEntry->type != entry.type) || (pEntry->subtype != entry.subtype) ||
+                    (pEntry->timeTag != entry.timeTag) || (pEntry->crc != entry.crc))) {
+                pEntry++;
+                x++;
+            }
+            errorCodeOrPassed = 0;
+            if (x < pRouter->numEntries) {
+                // A duplicate
+                pRouter->numDuplicates++;
+            } else {
+                // A new one: the oldest entry, if the list is full,
+                // will be pushed off the end below
+                if (pRouter->numEntries < sizeof(pRouter->entry) / sizeof(pRouter->entry[0])) {
+                    pRouter->numEntries++;
+                }
+                x = pRouter->numEntries - 1;
+                errorCodeOrPassed = 1;
+            }
+            // Whichever, move the message to the front of the list
+            memmove(&(pRouter->entry[1]), &(pRouter->entry[0]), x * sizeof(pRouter->entry[0]));
+            pRouter->entry[0] = entry;
+            if (errorCodeOrPassed > 0) {
+                pRouter->pCallback(&header, pMessage, pRouter->pCallbackParam);
+            }
+        } else if (errorCodeOrPassed >= 0) {
+            // Not a single SPARTN message
+            errorCodeOrPassed = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        }
+    }
+
+    return errorCodeOrPassed;
+}
+
+// Get the number of duplicates a SPARTN router has dropped.
+size_t uSpartnRouterGetNumDuplicates(const uSpartnRouter_t *pRouter)
+{
+    size_t numDuplicates = 0;
+
+    if (pRouter != NULL) {
+        numDuplicates = pRouter->numDuplicates;
+    }
+
+    return numDuplicates;
+}
+
 // End of file
@@ -32,6 +32,11 @@
 
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_error_common.h"
+
+#include "u_port_crypto.h" // uPortCryptoCrc()
 
 #include "u_spartn_crc.h"
 
@@ -39,6 +44,22 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#if (U_SPARTN_CRC_SLICE_BY != 1) && (U_SPARTN_CRC_SLICE_BY != 4) && (U_SPARTN_CRC_SLICE_BY != 8)
+# error U_SPARTN_CRC_SLICE_BY must be 1, 4 or 8.
+#endif
+
+/** The CRC16 polynomial.
+ */
+#define U_SPARTN_CRC_POLYNOMIAL_16 0x1021U
+
+/** The CRC24 Radix 64 polynomial.
+ */
+#define U_SPARTN_CRC_POLYNOMIAL_24 0x864CFBU
+
+/** The CRC32 polynomial.
+ */
+#define U_SPARTN_CRC_POLYNOMIAL_32 0x04C11DB7U
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -117,6 +138,8 @@ static const uint8_t u8Crc8Table[] = {
     0xE6U, 0xE1U, 0xE8U, 0xEFU, 0xFAU, 0xFDU, 0xF4U, 0xF3U
 };
 
+#if U_SPARTN_CRC_SLICE_BY == 1
+
 static const uint16_t u16Crc16Table[] = {
     0x0000U, 0x1021U, 0x2042U, 0x3063U, 0x4084U, 0x50A5U, 0x60C6U, 0x70E7U,
     0x8108U, 0x9129U, 0xA14AU, 0xB16BU, 0xC18CU, 0xD1ADU, 0xE1CEU, 0xF1EFU,
@@ -222,10 +245,973 @@ static const uint32_t u32Crc32Table[] = {
     0xAFB010B1U, 0xAB710D06U, 0xA6322BDFU, 0xA2F33668U, 0xBCB4666DU, 0xB8757BDAU, 0xB5365D03U, 0xB1F740B4U
 };
 
+#else
+
+/** The tables for slice-by-#U_SPARTN_CRC_SLICE_BY CRC16, CRC24 and CRC32:
+ * each is left-aligned in 32 bits, so that the same code can be used
+ * for all three, and table [n] is the CRC of a byte followed by n zero
+ * bytes; table [0] is hence the normal byte-wise table.
+ */
+static const uint32_t u32Crc16SliceTable[U_SPARTN_CRC_SLICE_BY][256] = {
+    {
+        0x00000000U, 0x10210000U, 0x20420000U, 0x30630000U, 0x40840000U, 0x50A50000U, 0x60C60000U, 0x70E70000U,
+        0x81080000U, 0x91290000U, 0xA14A0000U, 0xB16B0000U, 0xC18C0000U, 0xD1AD0000U, 0xE1CE0000U, 0xF1EF0000U,
+        0x12310000U, 0x02100000U, 0x32730000U, 0x22520000U, 0x52B50000U, 0x42940000U, 0x72F70000U, 0x62D60000U,
+        0x93390000U, 0x83180000U, 0xB37B0000U, 0xA35A0000U, 0xD3BD0000U, 0xC39C0000U, 0xF3FF0000U, 0xE3DE0000U,
+        0x24620000U, 0x34430000U, 0x04200000U, 0x14010000U, 0x64E60000U, 0x74C70000U, 0x44A40000U, 0x54850000U,
+        0xA56A0000U, 0xB54B0000U, 0x85280000U, 0x95090000U, 0xE5EE0000U, 0xF5CF0000U, 0xC5AC0000U, 0xD58D0000U,
+        0x36530000U, 0x26720000U, 0x16110000U, 0x06300000U, 0x76D70000U, 0x66F60000U, 0x56950000U, 0x46B40000U,
+        0xB75B0000U, 0xA77A0000U, 0x97190000U, 0x87380000U, 0xF7DF0000U, 0xE7FE0000U, 0xD79D0000U, 0xC7BC0000U,
+        0x48C40000U, 0x58E50000U, 0x68860000U, 0x78A70000U, 0x08400000U, 0x18610000U, 0x28020000U, 0x38230000U,
+        0xC9CC0000U, 0xD9ED0000U, 0xE98E0000U, 0xF9AF0000U, 0x89480000U, 0x99690000U, 0xA90A0000U, 0xB92B0000U,
+        0x5AF50000U, 0x4AD40000U, 0x7AB70000U, 0x6A960000U, 0x1A710000U, 0x0A500000U, 0x3A330000U, 0x2A120000U,
+        0xDBFD0000U, 0xCBDC0000U, 0xFBBF0000U, 0xEB9E0000U, 0x9B790000U, 0x8B580000U, 0xBB3B0000U, 0xAB1A0000U,
+        0x6CA60000U, 0x7C870000U, 0x4CE40000U, 0x5CC50000U, 0x2C220000U, 0x3C030000U, 0x0C600000U, 0x1C410000U,
+        0xEDAE0000U, 0xFD8F0000U, 0xCDEC0000U, 0xDDCD0000U, 0xAD2A0000U, 0xBD0B0000U, 0x8D680000U, 0x9D490000U,
+        0x7E970000U, 0x6EB60000U, 0x5ED50000U, 0x4EF40000U, 0x3E130000U, 0x2E320000U, 0x1E510000U, 0x0E700000U,
+        0xFF9F0000U, 0xEFBE0000U, 0xDFDD0000U, 0xCFFC0000U, 0xBF1B0000U, 0xAF3A0000U, 0x9F590000U, 0x8F780000U,
+        0x91880000U, 0x81A90000U, 0xB1CA0000U, 0xA1EB0000U, 0xD10C0000U, 0xC12D0000U, 0xF14E0000U, 0xE16F0000U,
+        0x10800000U, 0x00A10000U, 0x30C20000U, 0x20E30000U, 0x50040000U, 0x40250000U, 0x70460000U, 0x60670000U,
+        0x83B90000U, 0x93980000U, 0xA3FB0000U, 0xB3DA0000U, 0xC33D0000U, 0xD31C0000U, 0xE37F0000U, 0xF35E0000U,
+        0x02B10000U, 0x12900000U, 0x22F30000U, 0x32D20000U, 0x42350000U, 0x52140000U, 0x62770000U, 0x72560000U,
+        0xB5EA0000U, 0xA5CB0000U, 0x95A80000U, 0x85890000U, 0xF56E0000U, 0xE54F0000U, 0xD52C0000U, 0xC50D0000U,
+        0x34E20000U, 0x24C30000U, 0x14A00000U, 0x04810000U, 0x74660000U, 0x64470000U, 0x54240000U, 0x44050000U,
+        0xA7DB0000U, 0xB7FA0000U, 0x87990000U, 0x97B80000U, 0xE75F0000U, 0xF77E0000U, 0xC71D0000U, 0xD73C0000U,
+        0x26D30000U, 0x36F20000U, 0x06910000U, 0x16B00000U, 0x66570000U, 0x76760000U, 0x46150000U, 0x56340000U,
+        0xD94C0000U, 0xC96D0000U, 0xF90E0000U, 0xE92F0000U, 0x99C80000U, 0x89E90000U, 0xB98A0000U, 0xA9AB0000U,
+        0x58440000U, 0x48650000U, 0x78060000U, 0x68270000U, 0x18C00000U, 0x08E10000U, 0x38820000U, 0x28A30000U,
+        0xCB7D0000U, 0xDB5C0000U, 0xEB3F0000U, 0xFB1E0000U, 0x8BF90000U, 0x9BD80000U, 0xABBB0000U, 0xBB9A0000U,
+        0x4A750000U, 0x5A540000U, 0x6A370000U, 0x7A160000U, 0x0AF10000U, 0x1AD00000U, 0x2AB30000U, 0x3A920000U,
+        0xFD2E0000U, 0xED0F0000U, 0xDD6C0000U, 0xCD4D0000U, 0xBDAA0000U, 0xAD8B0000U, 0x9DE80000U, 0x8DC90000U,
+        0x7C260000U, 0x6C070000U, 0x5C640000U, 0x4C450000U, 0x3CA20000U, 0x2C830000U, 0x1CE00000U, 0x0CC10000U,
+        0xEF1F0000U, 0xFF3E0000U, 0xCF5D0000U, 0xDF7C0000U, 0xAF9B0000U, 0xBFBA0000U, 0x8FD90000U, 0x9FF80000U,
+        0x6E170000U, 0x7E360000U, 0x4E550000U, 0x5E740000U, 0x2E930000U, 0x3EB20000U, 0x0ED10000U, 0x1EF00000U
+    },
+    {
+        0x00000000U, 0x33310000U, 0x66620000U, 0x55530000U, 0xCCC40000U, 0xFFF50000U, 0xAAA60000U, 0x99970000U,
+        0x89A90000U, 0xBA980000U, 0xEFCB0000U, 0xDCFA0000U, 0x456D0000U, 0x765C0000U, 0x230F0000U, 0x103E0000U,
+        0x03730000U, 0x30420000U, 0x65110000U, 0x56200000U, 0xCFB70000U, 0xFC860000U, 0xA9D50000U, 0x9AE40000U,
+        0x8ADA0000U, 0xB9EB0000U, 0xECB80000U, 0xDF890000U, 0x461E0000U, 0x752F0000U, 0x207C0000U, 0x134D0000U,
+        0x06E60000U, 0x35D70000U, 0x60840000U, 0x53B50000U, 0xCA220000U, 0xF9130000U, 0xAC400000U, 0x9F710000U,
+        0x8F4F0000U, 0xBC7E0000U, 0xE92D0000U, 0xDA1C0000U, 0x438B0000U, 0x70BA0000U, 0x25E90000U, 0x16D80000U,
+        0x05950000U, 0x36A40000U, 0x63F70000U, 0x50C60000U, 0xC9510000U, 0xFA600000U, 0xAF330000U, 0x9C020000U,
+        0x8C3C0000U, 0xBF0D0000U, 0xEA5E0000U, 0xD96F0000U, 0x40F80000U, 0x73C90000U, 0x269A0000U, 0x15AB0000U,
+        0x0DCC0000U, 0x3EFD0000U, 0x6BAE0000U, 0x589F0000U, 0xC1080000U, 0xF2390000U, 0xA76A0000U, 0x945B0000U,
+        0x84650000U, 0xB7540000U, 0xE2070000U, 0xD1360000U, 0x48A10000U, 0x7B900000U, 0x2EC30000U, 0x1DF20000U,
+        0x0EBF0000U, 0x3D8E0000U, 0x68DD0000U, 0x5BEC0000U, 0xC27B0000U, 0xF14A0000U, 0xA4190000U, 0x97280000U,
+        0x87160000U, 0xB4270000U, 0xE1740000U, 0xD2450000U, 0x4BD20000U, 0x78E30000U, 0x2DB00000U, 0x1E810000U,
+        0x0B2A0000U, 0x381B0000U, 0x6D480000U, 0x5E790000U, 0xC7EE0000U, 0xF4DF0000U, 0xA18C0000U, 0x92BD0000U,
+        0x82830000U, 0xB1B20000U, 0xE4E10000U, 0xD7D00000U, 0x4E470000U, 0x7D760000U, 0x28250000U, 0x1B140000U,
+        0x08590000U, 0x3B680000U, 0x6E3B0000U, 0x5D0A0000U, 0xC49D0000U, 0xF7AC0000U, 0xA2FF0000U, 0x91CE0000U,
+        0x81F00000U, 0xB2C10000U, 0xE7920000U, 0xD4A30000U, 0x4D340000U, 0x7E050000U, 0x2B560000U, 0x18670000U,
+        0x1B980000U, 0x28A90000U, 0x7DFA0000U, 0x4ECB0000U, 0xD75C0000U, 0xE46D0000U, 0xB13E0000U, 0x820F0000U,
+        0x92310000U, 0xA1000000U, 0xF4530000U, 0xC7620000U, 0x5EF50000U, 0x6DC40000U, 0x38970000U, 0x0BA60000U,
+        0x18EB0000U, 0x2BDA0000U, 0x7E890000U, 0x4DB80000U, 0xD42F0000U, 0xE71E0000U, 0xB24D0000U, 0x817C0000U,
+        0x91420000U, 0xA2730000U, 0xF7200000U, 0xC4110000U, 0x5D860000U, 0x6EB70000U, 0x3BE40000U, 0x08D50000U,
+        0x1D7E0000U, 0x2E4F0000U, 0x7B1C0000U, 0x482D0000U, 0xD1BA0000U, 0xE28B0000U, 0xB7D80000U, 0x84E90000U,
+        0x94D70000U, 0xA7E60000U, 0xF2B50000U, 0xC1840000U, 0x58130000U, 0x6B220000U, 0x3E710000U, 0x0D400000U,
+        0x1E0D0000U, 0x2D3C0000U, 0x786F0000U, 0x4B5E0000U, 0xD2C90000U, 0xE1F80000U, 0xB4AB0000U, 0x879A0000U,
+        0x97A40000U, 0xA4950000U, 0xF1C60000U, 0xC2F70000U, 0x5B600000U, 0x68510000U, 0x3D020000U, 0x0E330000U,
+        0x16540000U, 0x25650000U, 0x70360000U, 0x43070000U, 0xDA900000U, 0xE9A10000U, 0xBCF20000U, 0x8FC30000U,
+        0x9FFD0000U, 0xACCC0000U, 0xF99F0000U, 0xCAAE0000U, 0x53390000U, 0x60080000U, 0x355B0000U, 0x066A0000U,
+        0x15270000U, 0x26160000U, 0x73450000U, 0x40740000U, 0xD9E30000U, 0xEAD20000U, 0xBF810000U, 0x8CB00000U,
+        0x9C8E0000U, 0xAFBF0000U, 0xFAEC0000U, 0xC9DD0000U, 0x504A0000U, 0x637B0000U, 0x36280000U, 0x05190000U,
+        0x10B20000U, 0x23830000U, 0x76D00000U, 0x45E10000U, 0xDC760000U, 0xEF470000U, 0xBA140000U, 0x89250000U,
+        0x991B0000U, 0xAA2A0000U, 0xFF790000U, 0xCC480000U, 0x55DF0000U, 0x66EE0000U, 0x33BD0000U, 0x008C0000U,
+        0x13C10000U, 0x20F00000U, 0x75A30000U, 0x46920000U, 0xDF050000U, 0xEC340000U, 0xB9670000U, 0x8A560000U,
+        0x9A680000U, 0xA9590000U, 0xFC0A0000U, 0xCF3B0000U, 0x56AC0000U, 0x659D0000U, 0x30CE0000U, 0x03FF0000U
+    },
+    {
+        0x00000000U, 0x37300000U, 0x6E600000U, 0x59500000U, 0xDCC00000U, 0xEBF00000U, 0xB2A00000U, 0x85900000U,
+        0xA9A10000U, 0x9E910000U, 0xC7C10000U, 0xF0F10000U, 0x75610000U, 0x42510000U, 0x1B010000U, 0x2C310000U,
+        0x43630000U, 0x74530000U, 0x2D030000U, 0x1A330000U, 0x9FA30000U, 0xA8930000U, 0xF1C30000U, 0xC6F30000U,
+        0xEAC20000U, 0xDDF20000U, 0x84A20000U, 0xB3920000U, 0x36020000U, 0x01320000U, 0x58620000U, 0x6F520000U,
+        0x86C60000U, 0xB1F60000U, 0xE8A60000U, 0xDF960000U, 0x5A060000U, 0x6D360000U, 0x34660000U, 0x03560000U,
+        0x2F670000U, 0x18570000U, 0x41070000U, 0x76370000U, 0xF3A70000U, 0xC4970000U, 0x9DC70000U, 0xAAF70000U,
+        0xC5A50000U, 0xF2950000U, 0xABC50000U, 0x9CF50000U, 0x19650000U, 0x2E550000U, 0x77050000U, 0x40350000U,
+        0x6C040000U, 0x5B340000U, 0x02640000U, 0x35540000U, 0xB0C40000U, 0x87F40000U, 0xDEA40000U, 0xE9940000U,
+        0x1DAD0000U, 0x2A9D0000U, 0x73CD0000U, 0x44FD0000U, 0xC16D0000U, 0xF65D0000U, 0xAF0D0000U, 0x983D0000U,
+        0xB40C0000U, 0x833C0000U, 0xDA6C0000U, 0xED5C0000U, 0x68CC0000U, 0x5FFC0000U, 0x06AC0000U, 0x319C0000U,
+        0x5ECE0000U, 0x69FE0000U, 0x30AE0000U, 0x079E0000U, 0x820E0000U, 0xB53E0000U, 0xEC6E0000U, 0xDB5E0000U,
+        0xF76F0000U, 0xC05F0000U, 0x990F0000U, 0xAE3F0000U, 0x2BAF0000U, 0x1C9F0000U, 0x45CF0000U, 0x72FF0000U,
+        0x9B6B0000U, 0xAC5B0000U, 0xF50B0000U, 0xC23B0000U, 0x47AB0000U, 0x709B0000U, 0x29CB0000U, 0x1EFB0000U,
+        0x32CA0000U, 0x05FA0000U, 0x5CAA0000U, 0x6B9A0000U, 0xEE0A0000U, 0xD93A0000U, 0x806A0000U, 0xB75A0000U,
+        0xD8080000U, 0xEF380000U, 0xB6680000U, 0x81580000U, 0x04C80000U, 0x33F80000U, 0x6AA80000U, 0x5D980000U,
+        0x71A90000U, 0x46990000U, 0x1FC90000U, 0x28F90000U, 0xAD690000U, 0x9A590000U, 0xC3090000U, 0xF4390000U,
+        0x3B5A0000U, 0x0C6A0000U, 0x553A0000U, 0x620A0000U, 0xE79A0000U, 0xD0AA0000U, 0x89FA0000U, 0xBECA0000U,
+        0x92FB0000U, 0xA5CB0000U, 0xFC9B0000U, 0xCBAB0000U, 0x4E3B0000U, 0x790B0000U, 0x205B0000U, 0x176B0000U,
+        0x78390000U, 0x4F090000U, 0x16590000U, 0x21690000U, 0xA4F90000U, 0x93C90000U, 0xCA990000U, 0xFDA90000U,
+        0xD1980000U, 0xE6A80000U, 0xBFF80000U, 0x88C80000U, 0x0D580000U, 0x3A680000U, 0x63380000U, 0x54080000U,
+        0xBD9C0000U, 0x8AAC0000U, 0xD3FC0000U, 0xE4CC0000U, 0x615C0000U, 0x566C0000U, 0x0F3C0000U, 0x380C0000U,
+        0x143D0000U, 0x230D0000U, 0x7A5D0000U, 0x4D6D0000U, 0xC8FD0000U, 0xFFCD0000U, 0xA69D0000U, 0x91AD0000U,
+        0xFEFF0000U, 0xC9CF0000U, 0x909F0000U, 0xA7AF0000U, 0x223F0000U, 0x150F0000U, 0x4C5F0000U, 0x7B6F0000U,
+        0x575E0000U, 0x606E0000U, 0x393E0000U, 0x0E0E0000U, 0x8B9E0000U, 0xBCAE0000U, 0xE5FE0000U, 0xD2CE0000U,
+        0x26F70000U, 0x11C70000U, 0x48970000U, 0x7FA70000U, 0xFA370000U, 0xCD070000U, 0x94570000U, 0xA3670000U,
+        0x8F560000U, 0xB8660000U, 0xE1360000U, 0xD6060000U, 0x53960000U, 0x64A60000U, 0x3DF60000U, 0x0AC60000U,
+        0x65940000U, 0x52A40000U, 0x0BF40000U, 0x3CC40000U, 0xB9540000U, 0x8E640000U, 0xD7340000U, 0xE0040000U,
+        0xCC350000U, 0xFB050000U, 0xA2550000U, 0x95650000U, 0x10F50000U, 0x27C50000U, 0x7E950000U, 0x49A50000U,
+        0xA0310000U, 0x97010000U, 0xCE510000U, 0xF9610000U, 0x7CF10000U, 0x4BC10000U, 0x12910000U, 0x25A10000U,
+        0x09900000U, 0x3EA00000U, 0x67F00000U, 0x50C00000U, 0xD5500000U, 0xE2600000U, 0xBB300000U, 0x8C000000U,
+        0xE3520000U, 0xD4620000U, 0x8D320000U, 0xBA020000U, 0x3F920000U, 0x08A20000U, 0x51F20000U, 0x66C20000U,
+        0x4AF30000U, 0x7DC30000U, 0x24930000U, 0x13A30000U, 0x96330000U, 0xA1030000U, 0xF8530000U, 0xCF630000U
+    },
+    {
+        0x00000000U, 0x76B40000U, 0xED680000U, 0x9BDC0000U, 0xCAF10000U, 0xBC450000U, 0x27990000U, 0x512D0000U,
+        0x85C30000U, 0xF3770000U, 0x68AB0000U, 0x1E1F0000U, 0x4F320000U, 0x39860000U, 0xA25A0000U, 0xD4EE0000U,
+        0x1BA70000U, 0x6D130000U, 0xF6CF0000U, 0x807B0000U, 0xD1560000U, 0xA7E20000U, 0x3C3E0000U, 0x4A8A0000U,
+        0x9E640000U, 0xE8D00000U, 0x730C0000U, 0x05B80000U, 0x54950000U, 0x22210000U, 0xB9FD0000U, 0xCF490000U,
+        0x374E0000U, 0x41FA0000U, 0xDA260000U, 0xAC920000U, 0xFDBF0000U, 0x8B0B0000U, 0x10D70000U, 0x66630000U,
+        0xB28D0000U, 0xC4390000U, 0x5FE50000U, 0x29510000U, 0x787C0000U, 0x0EC80000U, 0x95140000U, 0xE3A00000U,
+        0x2CE90000U, 0x5A5D0000U, 0xC1810000U, 0xB7350000U, 0xE6180000U, 0x90AC0000U, 0x0B700000U, 0x7DC40000U,
+        0xA92A0000U, 0xDF9E0000U, 0x44420000U, 0x32F60000U, 0x63DB0000U, 0x156F0000U, 0x8EB30000U, 0xF8070000U,
+        0x6E9C0000U, 0x18280000U, 0x83F40000U, 0xF5400000U, 0xA46D0000U, 0xD2D90000U, 0x49050000U, 0x3FB10000U,
+        0xEB5F0000U, 0x9DEB0000U, 0x06370000U, 0x70830000U, 0x21AE0000U, 0x571A0000U, 0xCCC60000U, 0xBA720000U,
+        0x753B0000U, 0x038F0000U, 0x98530000U, 0xEEE70000U, 0xBFCA0000U, 0xC97E0000U, 0x52A20000U, 0x24160000U,
+        0xF0F80000U, 0x864C0000U, 0x1D900000U, 0x6B240000U, 0x3A090000U, 0x4CBD0000U, 0xD7610000U, 0xA1D50000U,
+        0x59D20000U, 0x2F660000U, 0xB4BA0000U, 0xC20E0000U, 0x93230000U, 0xE5970000U, 0x7E4B0000U, 0x08FF0000U,
+        0xDC110000U, 0xAAA50000U, 0x31790000U, 0x47CD0000U, 0x16E00000U, 0x60540000U, 0xFB880000U, 0x8D3C0000U,
+        0x42750000U, 0x34C10000U, 0xAF1D0000U, 0xD9A90000U, 0x88840000U, 0xFE300000U, 0x65EC0000U, 0x13580000U,
+        0xC7B60000U, 0xB1020000U, 0x2ADE0000U, 0x5C6A0000U, 0x0D470000U, 0x7BF30000U, 0xE02F0000U, 0x969B0000U,
+        0xDD380000U, 0xAB8C0000U, 0x30500000U, 0x46E40000U, 0x17C90000U, 0x617D0000U, 0xFAA10000U, 0x8C150000U,
+        0x58FB0000U, 0x2E4F0000U, 0xB5930000U, 0xC3270000U, 0x920A0000U, 0xE4BE0000U, 0x7F620000U, 0x09D60000U,
+        0xC69F0000U, 0xB02B0000U, 0x2BF70000U, 0x5D430000U, 0x0C6E0000U, 0x7ADA0000U, 0xE1060000U, 0x97B20000U,
+        0x435C0000U, 0x35E80000U, 0xAE340000U, 0xD8800000U, 0x89AD0000U, 0xFF190000U, 0x64C50000U, 0x12710000U,
+        0xEA760000U, 0x9CC20000U, 0x071E0000U, 0x71AA0000U, 0x20870000U, 0x56330000U, 0xCDEF0000U, 0xBB5B0000U,
+        0x6FB50000U, 0x19010000U, 0x82DD0000U, 0xF4690000U, 0xA5440000U, 0xD3F00000U, 0x482C0000U, 0x3E980000U,
+        0xF1D10000U, 0x87650000U, 0x1CB90000U, 0x6A0D0000U, 0x3B200000U, 0x4D940000U, 0xD6480000U, 0xA0FC0000U,
+        0x74120000U, 0x02A60000U, 0x997A0000U, 0xEFCE0000U, 0xBEE30000U, 0xC8570000U, 0x538B0000U, 0x253F0000U,
+        0xB3A40000U, 0xC5100000U, 0x5ECC0000U, 0x28780000U, 0x79550000U, 0x0FE10000U, 0x943D0000U, 0xE2890000U,
+        0x36670000U, 0x40D30000U, 0xDB0F0000U, 0xADBB0000U, 0xFC960000U, 0x8A220000U, 0x11FE0000U, 0x674A0000U,
+        0xA8030000U, 0xDEB70000U, 0x456B0000U, 0x33DF0000U, 0x62F20000U, 0x14460000U, 0x8F9A0000U, 0xF92E0000U,
+        0x2DC00000U, 0x5B740000U, 0xC0A80000U, 0xB61C0000U, 0xE7310000U, 0x91850000U, 0x0A590000U, 0x7CED0000U,
+        0x84EA0000U, 0xF25E0000U, 0x69820000U, 0x1F360000U, 0x4E1B0000U, 0x38AF0000U, 0xA3730000U, 0xD5C70000U,
+        0x01290000U, 0x779D0000U, 0xEC410000U, 0x9AF50000U, 0xCBD80000U, 0xBD6C0000U, 0x26B00000U, 0x50040000U,
+        0x9F4D0000U, 0xE9F90000U, 0x72250000U, 0x04910000U, 0x55BC0000U, 0x23080000U, 0xB8D40000U, 0xCE600000U,
+        0x1A8E0000U, 0x6C3A0000U, 0xF7E60000U, 0x81520000U, 0xD07F0000U, 0xA6CB0000U, 0x3D170000U, 0x4BA30000U
+    },
+#if U_SPARTN_CRC_SLICE_BY == 8
+    {
+        0x00000000U, 0xAA510000U, 0x44830000U, 0xEED20000U, 0x89060000U, 0x23570000U, 0xCD850000U, 0x67D40000U,
+        0x022D0000U, 0xA87C0000U, 0x46AE0000U, 0xECFF0000U, 0x8B2B0000U, 0x217A0000U, 0xCFA80000U, 0x65F90000U,
+        0x045A0000U, 0xAE0B0000U, 0x40D90000U, 0xEA880000U, 0x8D5C0000U, 0x270D0000U, 0xC9DF0000U, 0x638E0000U,
+        0x06770000U, 0xAC260000U, 0x42F40000U, 0xE8A50000U, 0x8F710000U, 0x25200000U, 0xCBF20000U, 0x61A30000U,
+        0x08B40000U, 0xA2E50000U, 0x4C370000U, 0xE6660000U, 0x81B20000U, 0x2BE30000U, 0xC5310000U, 0x6F600000U,
+        0x0A990000U, 0xA0C80000U, 0x4E1A0000U, 0xE44B0000U, 0x839F0000U, 0x29CE0000U, 0xC71C0000U, 0x6D4D0000U,
+        0x0CEE0000U, 0xA6BF0000U, 0x486D0000U, 0xE23C0000U, 0x85E80000U, 0x2FB90000U, 0xC16B0000U, 0x6B3A0000U,
+        0x0EC30000U, 0xA4920000U, 0x4A400000U, 0xE0110000U, 0x87C50000U, 0x2D940000U, 0xC3460000U, 0x69170000U,
+        0x11680000U, 0xBB390000U, 0x55EB0000U, 0xFFBA0000U, 0x986E0000U, 0x323F0000U, 0xDCED0000U, 0x76BC0000U,
+        0x13450000U, 0xB9140000U, 0x57C60000U, 0xFD970000U, 0x9A430000U, 0x30120000U, 0xDEC00000U, 0x74910000U,
+        0x15320000U, 0xBF630000U, 0x51B10000U, 0xFBE00000U, 0x9C340000U, 0x36650000U, 0xD8B70000U, 0x72E60000U,
+        0x171F0000U, 0xBD4E0000U, 0x539C0000U, 0xF9CD0000U, 0x9E190000U, 0x34480000U, 0xDA9A0000U, 0x70CB0000U,
+        0x19DC0000U, 0xB38D0000U, 0x5D5F0000U, 0xF70E0000U, 0x90DA0000U, 0x3A8B0000U, 0xD4590000U, 0x7E080000U,
+        0x1BF10000U, 0xB1A00000U, 0x5F720000U, 0xF5230000U, 0x92F70000U, 0x38A60000U, 0xD6740000U, 0x7C250000U,
+        0x1D860000U, 0xB7D70000U, 0x59050000U, 0xF3540000U, 0x94800000U, 0x3ED10000U, 0xD0030000U, 0x7A520000U,
+        0x1FAB0000U, 0xB5FA0000U, 0x5B280000U, 0xF1790000U, 0x96AD0000U, 0x3CFC0000U, 0xD22E0000U, 0x787F0000U,
+        0x22D00000U, 0x88810000U, 0x66530000U, 0xCC020000U, 0xABD60000U, 0x01870000U, 0xEF550000U, 0x45040000U,
+        0x20FD0000U, 0x8AAC0000U, 0x647E0000U, 0xCE2F0000U, 0xA9FB0000U, 0x03AA0000U, 0xED780000U, 0x47290000U,
+        0x268A0000U, 0x8CDB0000U, 0x62090000U, 0xC8580000U, 0xAF8C0000U, 0x05DD0000U, 0xEB0F0000U, 0x415E0000U,
+        0x24A70000U, 0x8EF60000U, 0x60240000U, 0xCA750000U, 0xADA10000U, 0x07F00000U, 0xE9220000U, 0x43730000U,
+        0x2A640000U, 0x80350000U, 0x6EE70000U, 0xC4B60000U, 0xA3620000U, 0x09330000U, 0xE7E10000U, 0x4DB00000U,
+        0x28490000U, 0x82180000U, 0x6CCA0000U, 0xC69B0000U, 0xA14F0000U, 0x0B1E0000U, 0xE5CC0000U, 0x4F9D0000U,
+        0x2E3E0000U, 0x846F0000U, 0x6ABD0000U, 0xC0EC0000U, 0xA7380000U, 0x0D690000U, 0xE3BB0000U, 0x49EA0000U,
+        0x2C130000U, 0x86420000U, 0x68900000U, 0xC2C10000U, 0xA5150000U, 0x0F440000U, 0xE1960000U, 0x4BC70000U,
+        0x33B80000U, 0x99E90000U, 0x773B0000U, 0xDD6A0000U, 0xBABE0000U, 0x10EF0000U, 0xFE3D0000U, 0x546C0000U,
+        0x31950000U, 0x9BC40000U, 0x75160000U, 0xDF470000U, 0xB8930000U, 0x12C20000U, 0xFC100000U, 0x56410000U,
+        0x37E20000U, 0x9DB30000U, 0x73610000U, 0xD9300000U, 0xBEE40000U, 0x14B50000U, 0xFA670000U, 0x50360000U,
+        0x35CF0000U, 0x9F9E0000U, 0x714C0000U, 0xDB1D0000U, 0xBCC90000U, 0x16980000U, 0xF84A0000U, 0x521B0000U,
+        0x3B0C0000U, 0x915D0000U, 0x7F8F0000U, 0xD5DE0000U, 0xB20A0000U, 0x185B0000U, 0xF6890000U, 0x5CD80000U,
+        0x39210000U, 0x93700000U, 0x7DA20000U, 0xD7F30000U, 0xB0270000U, 0x1A760000U, 0xF4A40000U, 0x5EF50000U,
+        0x3F560000U, 0x95070000U, 0x7BD50000U, 0xD1840000U, 0xB6500000U, 0x1C010000U, 0xF2D30000U, 0x58820000U,
+        0x3D7B0000U, 0x972A0000U, 0x79F80000U, 0xD3A90000U, 0xB47D0000U, 0x1E2C0000U, 0xF0FE0000U, 0x5AAF0000U
+    },
+    {
+        0x00000000U, 0x45A00000U, 0x8B400000U, 0xCEE00000U, 0x06A10000U, 0x43010000U, 0x8DE10000U, 0xC8410000U,
+        0x0D420000U, 0x48E20000U, 0x86020000U, 0xC3A20000U, 0x0BE30000U, 0x4E430000U, 0x80A30000U, 0xC5030000U,
+        0x1A840000U, 0x5F240000U, 0x91C40000U, 0xD4640000U, 0x1C250000U, 0x59850000U, 0x97650000U, 0xD2C50000U,
+        0x17C60000U, 0x52660000U, 0x9C860000U, 0xD9260000U, 0x11670000U, 0x54C70000U, 0x9A270000U, 0xDF870000U,
+        0x35080000U, 0x70A80000U, 0xBE480000U, 0xFBE80000U, 0x33A90000U, 0x76090000U, 0xB8E90000U, 0xFD490000U,
+        0x384A0000U, 0x7DEA0000U, 0xB30A0000U, 0xF6AA0000U, 0x3EEB0000U, 0x7B4B0000U, 0xB5AB0000U, 0xF00B0000U,
+        0x2F8C0000U, 0x6A2C0000U, 0xA4CC0000U, 0xE16C0000U, 0x292D0000U, 0x6C8D0000U, 0xA26D0000U, 0xE7CD0000U,
+        0x22CE0000U, 0x676E0000U, 0xA98E0000U, 0xEC2E0000U, 0x246F0000U, 0x61CF0000U, 0xAF2F0000U, 0xEA8F0000U,
+        0x6A100000U, 0x2FB00000U, 0xE1500000U, 0xA4F00000U, 0x6CB10000U, 0x29110000U, 0xE7F10000U, 0xA2510000U,
+        0x67520000U, 0x22F20000U, 0xEC120000U, 0xA9B20000U, 0x61F30000U, 0x24530000U, 0xEAB30000U, 0xAF130000U,
+        0x70940000U, 0x35340000U, 0xFBD40000U, 0xBE740000U, 0x76350000U, 0x33950000U, 0xFD750000U, 0xB8D50000U,
+        0x7DD60000U, 0x38760000U, 0xF6960000U, 0xB3360000U, 0x7B770000U, 0x3ED70000U, 0xF0370000U, 0xB5970000U,
+        0x5F180000U, 0x1AB80000U, 0xD4580000U, 0x91F80000U, 0x59B90000U, 0x1C190000U, 0xD2F90000U, 0x97590000U,
+        0x525A0000U, 0x17FA0000U, 0xD91A0000U, 0x9CBA0000U, 0x54FB0000U, 0x115B0000U, 0xDFBB0000U, 0x9A1B0000U,
+        0x459C0000U, 0x003C0000U, 0xCEDC0000U, 0x8B7C0000U, 0x433D0000U, 0x069D0000U, 0xC87D0000U, 0x8DDD0000U,
+        0x48DE0000U, 0x0D7E0000U, 0xC39E0000U, 0x863E0000U, 0x4E7F0000U, 0x0BDF0000U, 0xC53F0000U, 0x809F0000U,
+        0xD4200000U, 0x91800000U, 0x5F600000U, 0x1AC00000U, 0xD2810000U, 0x97210000U, 0x59C10000U, 0x1C610000U,
+        0xD9620000U, 0x9CC20000U, 0x52220000U, 0x17820000U, 0xDFC30000U, 0x9A630000U, 0x54830000U, 0x11230000U,
+        0xCEA40000U, 0x8B040000U, 0x45E40000U, 0x00440000U, 0xC8050000U, 0x8DA50000U, 0x43450000U, 0x06E50000U,
+        0xC3E60000U, 0x86460000U, 0x48A60000U, 0x0D060000U, 0xC5470000U, 0x80E70000U, 0x4E070000U, 0x0BA70000U,
+        0xE1280000U, 0xA4880000U, 0x6A680000U, 0x2FC80000U, 0xE7890000U, 0xA2290000U, 0x6CC90000U, 0x29690000U,
+        0xEC6A0000U, 0xA9CA0000U, 0x672A0000U, 0x228A0000U, 0xEACB0000U, 0xAF6B0000U, 0x618B0000U, 0x242B0000U,
+        0xFBAC0000U, 0xBE0C0000U, 0x70EC0000U, 0x354C0000U, 0xFD0D0000U, 0xB8AD0000U, 0x764D0000U, 0x33ED0000U,
+        0xF6EE0000U, 0xB34E0000U, 0x7DAE0000U, 0x380E0000U, 0xF04F0000U, 0xB5EF0000U, 0x7B0F0000U, 0x3EAF0000U,
+        0xBE300000U, 0xFB900000U, 0x35700000U, 0x70D00000U, 0xB8910000U, 0xFD310000U, 0x33D10000U, 0x76710000U,
+        0xB3720000U, 0xF6D20000U, 0x38320000U, 0x7D920000U, 0xB5D30000U, 0xF0730000U, 0x3E930000U, 0x7B330000U,
+        0xA4B40000U, 0xE1140000U, 0x2FF40000U, 0x6A540000U, 0xA2150000U, 0xE7B50000U, 0x29550000U, 0x6CF50000U,
+        0xA9F60000U, 0xEC560000U, 0x22B60000U, 0x67160000U, 0xAF570000U, 0xEAF70000U, 0x24170000U, 0x61B70000U,
+        0x8B380000U, 0xCE980000U, 0x00780000U, 0x45D80000U, 0x8D990000U, 0xC8390000U, 0x06D90000U, 0x43790000U,
+        0x867A0000U, 0xC3DA0000U, 0x0D3A0000U, 0x489A0000U, 0x80DB0000U, 0xC57B0000U, 0x0B9B0000U, 0x4E3B0000U,
+        0x91BC0000U, 0xD41C0000U, 0x1AFC0000U, 0x5F5C0000U, 0x971D0000U, 0xD2BD0000U, 0x1C5D0000U, 0x59FD0000U,
+        0x9CFE0000U, 0xD95E0000U, 0x17BE0000U, 0x521E0000U, 0x9A5F0000U, 0xDFFF0000U, 0x111F0000U, 0x54BF0000U
+    },
+    {
+        0x00000000U, 0xB8610000U, 0x60E30000U, 0xD8820000U, 0xC1C60000U, 0x79A70000U, 0xA1250000U, 0x19440000U,
+        0x93AD0000U, 0x2BCC0000U, 0xF34E0000U, 0x4B2F0000U, 0x526B0000U, 0xEA0A0000U, 0x32880000U, 0x8AE90000U,
+        0x377B0000U, 0x8F1A0000U, 0x57980000U, 0xEFF90000U, 0xF6BD0000U, 0x4EDC0000U, 0x965E0000U, 0x2E3F0000U,
+        0xA4D60000U, 0x1CB70000U, 0xC4350000U, 0x7C540000U, 0x65100000U, 0xDD710000U, 0x05F30000U, 0xBD920000U,
+        0x6EF60000U, 0xD6970000U, 0x0E150000U, 0xB6740000U, 0xAF300000U, 0x17510000U, 0xCFD30000U, 0x77B20000U,
+        0xFD5B0000U, 0x453A0000U, 0x9DB80000U, 0x25D90000U, 0x3C9D0000U, 0x84FC0000U, 0x5C7E0000U, 0xE41F0000U,
+        0x598D0000U, 0xE1EC0000U, 0x396E0000U, 0x810F0000U, 0x984B0000U, 0x202A0000U, 0xF8A80000U, 0x40C90000U,
+        0xCA200000U, 0x72410000U, 0xAAC30000U, 0x12A20000U, 0x0BE60000U, 0xB3870000U, 0x6B050000U, 0xD3640000U,
+        0xDDEC0000U, 0x658D0000U, 0xBD0F0000U, 0x056E0000U, 0x1C2A0000U, 0xA44B0000U, 0x7CC90000U, 0xC4A80000U,
+        0x4E410000U, 0xF6200000U, 0x2EA20000U, 0x96C30000U, 0x8F870000U, 0x37E60000U, 0xEF640000U, 0x57050000U,
+        0xEA970000U, 0x52F60000U, 0x8A740000U, 0x32150000U, 0x2B510000U, 0x93300000U, 0x4BB20000U, 0xF3D30000U,
+        0x793A0000U, 0xC15B0000U, 0x19D90000U, 0xA1B80000U, 0xB8FC0000U, 0x009D0000U, 0xD81F0000U, 0x607E0000U,
+        0xB31A0000U, 0x0B7B0000U, 0xD3F90000U, 0x6B980000U, 0x72DC0000U, 0xCABD0000U, 0x123F0000U, 0xAA5E0000U,
+        0x20B70000U, 0x98D60000U, 0x40540000U, 0xF8350000U, 0xE1710000U, 0x59100000U, 0x81920000U, 0x39F30000U,
+        0x84610000U, 0x3C000000U, 0xE4820000U, 0x5CE30000U, 0x45A70000U, 0xFDC60000U, 0x25440000U, 0x9D250000U,
+        0x17CC0000U, 0xAFAD0000U, 0x772F0000U, 0xCF4E0000U, 0xD60A0000U, 0x6E6B0000U, 0xB6E90000U, 0x0E880000U,
+        0xABF90000U, 0x13980000U, 0xCB1A0000U, 0x737B0000U, 0x6A3F0000U, 0xD25E0000U, 0x0ADC0000U, 0xB2BD0000U,
+        0x38540000U, 0x80350000U, 0x58B70000U, 0xE0D60000U, 0xF9920000U, 0x41F30000U, 0x99710000U, 0x21100000U,
+        0x9C820000U, 0x24E30000U, 0xFC610000U, 0x44000000U, 0x5D440000U, 0xE5250000U, 0x3DA70000U, 0x85C60000U,
+        0x0F2F0000U, 0xB74E0000U, 0x6FCC0000U, 0xD7AD0000U, 0xCEE90000U, 0x76880000U, 0xAE0A0000U, 0x166B0000U,
+        0xC50F0000U, 0x7D6E0000U, 0xA5EC0000U, 0x1D8D0000U, 0x04C90000U, 0xBCA80000U, 0x642A0000U, 0xDC4B0000U,
+        0x56A20000U, 0xEEC30000U, 0x36410000U, 0x8E200000U, 0x97640000U, 0x2F050000U, 0xF7870000U, 0x4FE60000U,
+        0xF2740000U, 0x4A150000U, 0x92970000U, 0x2AF60000U, 0x33B20000U, 0x8BD30000U, 0x53510000U, 0xEB300000U,
+        0x61D90000U, 0xD9B80000U, 0x013A0000U, 0xB95B0000U, 0xA01F0000U, 0x187E0000U, 0xC0FC0000U, 0x789D0000U,
+        0x76150000U, 0xCE740000U, 0x16F60000U, 0xAE970000U, 0xB7D30000U, 0x0FB20000U, 0xD7300000U, 0x6F510000U,
+        0xE5B80000U, 0x5DD90000U, 0x855B0000U, 0x3D3A0000U, 0x247E0000U, 0x9C1F0000U, 0x449D0000U, 0xFCFC0000U,
+        0x416E0000U, 0xF90F0000U, 0x218D0000U, 0x99EC0000U, 0x80A80000U, 0x38C90000U, 0xE04B0000U, 0x582A0000U,
+        0xD2C30000U, 0x6AA20000U, 0xB2200000U, 0x0A410000U, 0x13050000U, 0xAB640000U, 0x73E60000U, 0xCB870000U,
+        0x18E30000U, 0xA0820000U, 0x78000000U, 0xC0610000U, 0xD9250000U, 0x61440000U, 0xB9C60000U, 0x01A70000U,
+        0x8B4E0000U, 0x332F0000U, 0xEBAD0000U, 0x53CC0000U, 0x4A880000U, 0xF2E90000U, 0x2A6B0000U, 0x920A0000U,
+        0x2F980000U, 0x97F90000U, 0x4F7B0000U, 0xF71A0000U, 0xEE5E0000U, 0x563F0000U, 0x8EBD0000U, 0x36DC0000U,
+        0xBC350000U, 0x04540000U, 0xDCD60000U, 0x64B70000U, 0x7DF30000U, 0xC5920000U, 0x1D100000U, 0xA5710000U
+    },
+    {
+        0x00000000U, 0x47D30000U, 0x8FA60000U, 0xC8750000U, 0x0F6D0000U, 0x48BE0000U, 0x80CB0000U, 0xC7180000U,
+        0x1EDA0000U, 0x59090000U, 0x917C0000U, 0xD6AF0000U, 0x11B70000U, 0x56640000U, 0x9E110000U, 0xD9C20000U,
+        0x3DB40000U, 0x7A670000U, 0xB2120000U, 0xF5C10000U, 0x32D90000U, 0x750A0000U, 0xBD7F0000U, 0xFAAC0000U,
+        0x236E0000U, 0x64BD0000U, 0xACC80000U, 0xEB1B0000U, 0x2C030000U, 0x6BD00000U, 0xA3A50000U, 0xE4760000U,
+        0x7B680000U, 0x3CBB0000U, 0xF4CE0000U, 0xB31D0000U, 0x74050000U, 0x33D60000U, 0xFBA30000U, 0xBC700000U,
+        0x65B20000U, 0x22610000U, 0xEA140000U, 0xADC70000U, 0x6ADF0000U, 0x2D0C0000U, 0xE5790000U, 0xA2AA0000U,
+        0x46DC0000U, 0x010F0000U, 0xC97A0000U, 0x8EA90000U, 0x49B10000U, 0x0E620000U, 0xC6170000U, 0x81C40000U,
+        0x58060000U, 0x1FD50000U, 0xD7A00000U, 0x90730000U, 0x576B0000U, 0x10B80000U, 0xD8CD0000U, 0x9F1E0000U,
+        0xF6D00000U, 0xB1030000U, 0x79760000U, 0x3EA50000U, 0xF9BD0000U, 0xBE6E0000U, 0x761B0000U, 0x31C80000U,
+        0xE80A0000U, 0xAFD90000U, 0x67AC0000U, 0x207F0000U, 0xE7670000U, 0xA0B40000U, 0x68C10000U, 0x2F120000U,
+        0xCB640000U, 0x8CB70000U, 0x44C20000U, 0x03110000U, 0xC4090000U, 0x83DA0000U, 0x4BAF0000U, 0x0C7C0000U,
+        0xD5BE0000U, 0x926D0000U, 0x5A180000U, 0x1DCB0000U, 0xDAD30000U, 0x9D000000U, 0x55750000U, 0x12A60000U,
+        0x8DB80000U, 0xCA6B0000U, 0x021E0000U, 0x45CD0000U, 0x82D50000U, 0xC5060000U, 0x0D730000U, 0x4AA00000U,
+        0x93620000U, 0xD4B10000U, 0x1CC40000U, 0x5B170000U, 0x9C0F0000U, 0xDBDC0000U, 0x13A90000U, 0x547A0000U,
+        0xB00C0000U, 0xF7DF0000U, 0x3FAA0000U, 0x78790000U, 0xBF610000U, 0xF8B20000U, 0x30C70000U, 0x77140000U,
+        0xAED60000U, 0xE9050000U, 0x21700000U, 0x66A30000U, 0xA1BB0000U, 0xE6680000U, 0x2E1D0000U, 0x69CE0000U,
+        0xFD810000U, 0xBA520000U, 0x72270000U, 0x35F40000U, 0xF2EC0000U, 0xB53F0000U, 0x7D4A0000U, 0x3A990000U,
+        0xE35B0000U, 0xA4880000U, 0x6CFD0000U, 0x2B2E0000U, 0xEC360000U, 0xABE50000U, 0x63900000U, 0x24430000U,
+        0xC0350000U, 0x87E60000U, 0x4F930000U, 0x08400000U, 0xCF580000U, 0x888B0000U, 0x40FE0000U, 0x072D0000U,
+        0xDEEF0000U, 0x993C0000U, 0x51490000U, 0x169A0000U, 0xD1820000U, 0x96510000U, 0x5E240000U, 0x19F70000U,
+        0x86E90000U, 0xC13A0000U, 0x094F0000U, 0x4E9C0000U, 0x89840000U, 0xCE570000U, 0x06220000U, 0x41F10000U,
+        0x98330000U, 0xDFE00000U, 0x17950000U, 0x50460000U, 0x975E0000U, 0xD08D0000U, 0x18F80000U, 0x5F2B0000U,
+        0xBB5D0000U, 0xFC8E0000U, 0x34FB0000U, 0x73280000U, 0xB4300000U, 0xF3E30000U, 0x3B960000U, 0x7C450000U,
+        0xA5870000U, 0xE2540000U, 0x2A210000U, 0x6DF20000U, 0xAAEA0000U, 0xED390000U, 0x254C0000U, 0x629F0000U,
+        0x0B510000U, 0x4C820000U, 0x84F70000U, 0xC3240000U, 0x043C0000U, 0x43EF0000U, 0x8B9A0000U, 0xCC490000U,
+        0x158B0000U, 0x52580000U, 0x9A2D0000U, 0xDDFE0000U, 0x1AE60000U, 0x5D350000U, 0x95400000U, 0xD2930000U,
+        0x36E50000U, 0x71360000U, 0xB9430000U, 0xFE900000U, 0x39880000U, 0x7E5B0000U, 0xB62E0000U, 0xF1FD0000U,
+        0x283F0000U, 0x6FEC0000U, 0xA7990000U, 0xE04A0000U, 0x27520000U, 0x60810000U, 0xA8F40000U, 0xEF270000U,
+        0x70390000U, 0x37EA0000U, 0xFF9F0000U, 0xB84C0000U, 0x7F540000U, 0x38870000U, 0xF0F20000U, 0xB7210000U,
+        0x6EE30000U, 0x29300000U, 0xE1450000U, 0xA6960000U, 0x618E0000U, 0x265D0000U, 0xEE280000U, 0xA9FB0000U,
+        0x4D8D0000U, 0x0A5E0000U, 0xC22B0000U, 0x85F80000U, 0x42E00000U, 0x05330000U, 0xCD460000U, 0x8A950000U,
+        0x53570000U, 0x14840000U, 0xDCF10000U, 0x9B220000U, 0x5C3A0000U, 0x1BE90000U, 0xD39C0000U, 0x944F0000U
+    },
+#endif
+};
+
+/** The slice tables for CRC24, see u32Crc16SliceTable.
+ */
+static const uint32_t u32Crc24SliceTable[U_SPARTN_CRC_SLICE_BY][256] = {
+    {
+        0x00000000U, 0x864CFB00U, 0x8AD50D00U, 0x0C99F600U, 0x93E6E100U, 0x15AA1A00U, 0x1933EC00U, 0x9F7F1700U,
+        0xA1813900U, 0x27CDC200U, 0x2B543400U, 0xAD18CF00U, 0x3267D800U, 0xB42B2300U, 0xB8B2D500U, 0x3EFE2E00U,
+        0xC54E8900U, 0x43027200U, 0x4F9B8400U, 0xC9D77F00U, 0x56A86800U, 0xD0E49300U, 0xDC7D6500U, 0x5A319E00U,
+        0x64CFB000U, 0xE2834B00U, 0xEE1ABD00U, 0x68564600U, 0xF7295100U, 0x7165AA00U, 0x7DFC5C00U, 0xFBB0A700U,
+        0x0CD1E900U, 0x8A9D1200U, 0x8604E400U, 0x00481F00U, 0x9F370800U, 0x197BF300U, 0x15E20500U, 0x93AEFE00U,
+        0xAD50D000U, 0x2B1C2B00U, 0x2785DD00U, 0xA1C92600U, 0x3EB63100U, 0xB8FACA00U, 0xB4633C00U, 0x322FC700U,
+        0xC99F6000U, 0x4FD39B00U, 0x434A6D00U, 0xC5069600U, 0x5A798100U, 0xDC357A00U, 0xD0AC8C00U, 0x56E07700U,
+        0x681E5900U, 0xEE52A200U, 0xE2CB5400U, 0x6487AF00U, 0xFBF8B800U, 0x7DB44300U, 0x712DB500U, 0xF7614E00U,
+        0x19A3D200U, 0x9FEF2900U, 0x9376DF00U, 0x153A2400U, 0x8A453300U, 0x0C09C800U, 0x00903E00U, 0x86DCC500U,
+        0xB822EB00U, 0x3E6E1000U, 0x32F7E600U, 0xB4BB1D00U, 0x2BC40A00U, 0xAD88F100U, 0xA1110700U, 0x275DFC00U,
+        0xDCED5B00U, 0x5AA1A000U, 0x56385600U, 0xD074AD00U, 0x4F0BBA00U, 0xC9474100U, 0xC5DEB700U, 0x43924C00U,
+        0x7D6C6200U, 0xFB209900U, 0xF7B96F00U, 0x71F59400U, 0xEE8A8300U, 0x68C67800U, 0x645F8E00U, 0xE2137500U,
+        0x15723B00U, 0x933EC000U, 0x9FA73600U, 0x19EBCD00U, 0x8694DA00U, 0x00D82100U, 0x0C41D700U, 0x8A0D2C00U,
+        0xB4F30200U, 0x32BFF900U, 0x3E260F00U, 0xB86AF400U, 0x2715E300U, 0xA1591800U, 0xADC0EE00U, 0x2B8C1500U,
+        0xD03CB200U, 0x56704900U, 0x5AE9BF00U, 0xDCA54400U, 0x43DA5300U, 0xC596A800U, 0xC90F5E00U, 0x4F43A500U,
+        0x71BD8B00U, 0xF7F17000U, 0xFB688600U, 0x7D247D00U, 0xE25B6A00U, 0x64179100U, 0x688E6700U, 0xEEC29C00U,
+        0x3347A400U, 0xB50B5F00U, 0xB992A900U, 0x3FDE5200U, 0xA0A14500U, 0x26EDBE00U, 0x2A744800U, 0xAC38B300U,
+        0x92C69D00U, 0x148A6600U, 0x18139000U, 0x9E5F6B00U, 0x01207C00U, 0x876C8700U, 0x8BF57100U, 0x0DB98A00U,
+        0xF6092D00U, 0x7045D600U, 0x7CDC2000U, 0xFA90DB00U, 0x65EFCC00U, 0xE3A33700U, 0xEF3AC100U, 0x69763A00U,
+        0x57881400U, 0xD1C4EF00U, 0xDD5D1900U, 0x5B11E200U, 0xC46EF500U, 0x42220E00U, 0x4EBBF800U, 0xC8F70300U,
+        0x3F964D00U, 0xB9DAB600U, 0xB5434000U, 0x330FBB00U, 0xAC70AC00U, 0x2A3C5700U, 0x26A5A100U, 0xA0E95A00U,
+        0x9E177400U, 0x185B8F00U, 0x14C27900U, 0x928E8200U, 0x0DF19500U, 0x8BBD6E00U, 0x87249800U, 0x01686300U,
+        0xFAD8C400U, 0x7C943F00U, 0x700DC900U, 0xF6413200U, 0x693E2500U, 0xEF72DE00U, 0xE3EB2800U, 0x65A7D300U,
+        0x5B59FD00U, 0xDD150600U, 0xD18CF000U, 0x57C00B00U, 0xC8BF1C00U, 0x4EF3E700U, 0x426A1100U, 0xC426EA00U,
+        0x2AE47600U, 0xACA88D00U, 0xA0317B00U, 0x267D8000U, 0xB9029700U, 0x3F4E6C00U, 0x33D79A00U, 0xB59B6100U,
+        0x8B654F00U, 0x0D29B400U, 0x01B04200U, 0x87FCB900U, 0x1883AE00U, 0x9ECF5500U, 0x9256A300U, 0x141A5800U,
+        0xEFAAFF00U, 0x69E60400U, 0x657FF200U, 0xE3330900U, 0x7C4C1E00U, 0xFA00E500U, 0xF6991300U, 0x70D5E800U,
+        0x4E2BC600U, 0xC8673D00U, 0xC4FECB00U, 0x42B23000U, 0xDDCD2700U, 0x5B81DC00U, 0x57182A00U, 0xD154D100U,
+        0x26359F00U, 0xA0796400U, 0xACE09200U, 0x2AAC6900U, 0xB5D37E00U, 0x339F8500U, 0x3F067300U, 0xB94A8800U,
+        0x87B4A600U, 0x01F85D00U, 0x0D61AB00U, 0x8B2D5000U, 0x14524700U, 0x921EBC00U, 0x9E874A00U, 0x18CBB100U,
+        0xE37B1600U, 0x6537ED00U, 0x69AE1B00U, 0xEFE2E000U, 0x709DF700U, 0xF6D10C00U, 0xFA48FA00U, 0x7C040100U,
+        0x42FA2F00U, 0xC4B6D400U, 0xC82F2200U, 0x4E63D900U, 0xD11CCE00U, 0x57503500U, 0x5BC9C300U, 0xDD853800U
+    },
+    {
+        0x00000000U, 0x668F4800U, 0xCD1E9000U, 0xAB91D800U, 0x1C71DB00U, 0x7AFE9300U, 0xD16F4B00U, 0xB7E00300U,
+        0x38E3B600U, 0x5E6CFE00U, 0xF5FD2600U, 0x93726E00U, 0x24926D00U, 0x421D2500U, 0xE98CFD00U, 0x8F03B500U,
+        0x71C76C00U, 0x17482400U, 0xBCD9FC00U, 0xDA56B400U, 0x6DB6B700U, 0x0B39FF00U, 0xA0A82700U, 0xC6276F00U,
+        0x4924DA00U, 0x2FAB9200U, 0x843A4A00U, 0xE2B50200U, 0x55550100U, 0x33DA4900U, 0x984B9100U, 0xFEC4D900U,
+        0xE38ED800U, 0x85019000U, 0x2E904800U, 0x481F0000U, 0xFFFF0300U, 0x99704B00U, 0x32E19300U, 0x546EDB00U,
+        0xDB6D6E00U, 0xBDE22600U, 0x1673FE00U, 0x70FCB600U, 0xC71CB500U, 0xA193FD00U, 0x0A022500U, 0x6C8D6D00U,
+        0x9249B400U, 0xF4C6FC00U, 0x5F572400U, 0x39D86C00U, 0x8E386F00U, 0xE8B72700U, 0x4326FF00U, 0x25A9B700U,
+        0xAAAA0200U, 0xCC254A00U, 0x67B49200U, 0x013BDA00U, 0xB6DBD900U, 0xD0549100U, 0x7BC54900U, 0x1D4A0100U,
+        0x41514B00U, 0x27DE0300U, 0x8C4FDB00U, 0xEAC09300U, 0x5D209000U, 0x3BAFD800U, 0x903E0000U, 0xF6B14800U,
+        0x79B2FD00U, 0x1F3DB500U, 0xB4AC6D00U, 0xD2232500U, 0x65C32600U, 0x034C6E00U, 0xA8DDB600U, 0xCE52FE00U,
+        0x30962700U, 0x56196F00U, 0xFD88B700U, 0x9B07FF00U, 0x2CE7FC00U, 0x4A68B400U, 0xE1F96C00U, 0x87762400U,
+        0x08759100U, 0x6EFAD900U, 0xC56B0100U, 0xA3E44900U, 0x14044A00U, 0x728B0200U, 0xD91ADA00U, 0xBF959200U,
+        0xA2DF9300U, 0xC450DB00U, 0x6FC10300U, 0x094E4B00U, 0xBEAE4800U, 0xD8210000U, 0x73B0D800U, 0x153F9000U,
+        0x9A3C2500U, 0xFCB36D00U, 0x5722B500U, 0x31ADFD00U, 0x864DFE00U, 0xE0C2B600U, 0x4B536E00U, 0x2DDC2600U,
+        0xD318FF00U, 0xB597B700U, 0x1E066F00U, 0x78892700U, 0xCF692400U, 0xA9E66C00U, 0x0277B400U, 0x64F8FC00U,
+        0xEBFB4900U, 0x8D740100U, 0x26E5D900U, 0x406A9100U, 0xF78A9200U, 0x9105DA00U, 0x3A940200U, 0x5C1B4A00U,
+        0x82A29600U, 0xE42DDE00U, 0x4FBC0600U, 0x29334E00U, 0x9ED34D00U, 0xF85C0500U, 0x53CDDD00U, 0x35429500U,
+        0xBA412000U, 0xDCCE6800U, 0x775FB000U, 0x11D0F800U, 0xA630FB00U, 0xC0BFB300U, 0x6B2E6B00U, 0x0DA12300U,
+        0xF365FA00U, 0x95EAB200U, 0x3E7B6A00U, 0x58F42200U, 0xEF142100U, 0x899B6900U, 0x220AB100U, 0x4485F900U,
+        0xCB864C00U, 0xAD090400U, 0x0698DC00U, 0x60179400U, 0xD7F79700U, 0xB178DF00U, 0x1AE90700U, 0x7C664F00U,
+        0x612C4E00U, 0x07A30600U, 0xAC32DE00U, 0xCABD9600U, 0x7D5D9500U, 0x1BD2DD00U, 0xB0430500U, 0xD6CC4D00U,
+        0x59CFF800U, 0x3F40B000U, 0x94D16800U, 0xF25E2000U, 0x45BE2300U, 0x23316B00U, 0x88A0B300U, 0xEE2FFB00U,
+        0x10EB2200U, 0x76646A00U, 0xDDF5B200U, 0xBB7AFA00U, 0x0C9AF900U, 0x6A15B100U, 0xC1846900U, 0xA70B2100U,
+        0x28089400U, 0x4E87DC00U, 0xE5160400U, 0x83994C00U, 0x34794F00U, 0x52F60700U, 0xF967DF00U, 0x9FE89700U,
+        0xC3F3DD00U, 0xA57C9500U, 0x0EED4D00U, 0x68620500U, 0xDF820600U, 0xB90D4E00U, 0x129C9600U, 0x7413DE00U,
+        0xFB106B00U, 0x9D9F2300U, 0x360EFB00U, 0x5081B300U, 0xE761B000U, 0x81EEF800U, 0x2A7F2000U, 0x4CF06800U,
+        0xB234B100U, 0xD4BBF900U, 0x7F2A2100U, 0x19A56900U, 0xAE456A00U, 0xC8CA2200U, 0x635BFA00U, 0x05D4B200U,
+        0x8AD70700U, 0xEC584F00U, 0x47C99700U, 0x2146DF00U, 0x96A6DC00U, 0xF0299400U, 0x5BB84C00U, 0x3D370400U,
+        0x207D0500U, 0x46F24D00U, 0xED639500U, 0x8BECDD00U, 0x3C0CDE00U, 0x5A839600U, 0xF1124E00U, 0x979D0600U,
+        0x189EB300U, 0x7E11FB00U, 0xD5802300U, 0xB30F6B00U, 0x04EF6800U, 0x62602000U, 0xC9F1F800U, 0xAF7EB000U,
+        0x51BA6900U, 0x37352100U, 0x9CA4F900U, 0xFA2BB100U, 0x4DCBB200U, 0x2B44FA00U, 0x80D52200U, 0xE65A6A00U,
+        0x6959DF00U, 0x0FD69700U, 0xA4474F00U, 0xC2C80700U, 0x75280400U, 0x13A74C00U, 0xB8369400U, 0xDEB9DC00U
+    },
+    {
+        0x00000000U, 0x8309D700U, 0x805F5500U, 0x03568200U, 0x86F25100U, 0x05FB8600U, 0x06AD0400U, 0x85A4D300U,
+        0x8BA85900U, 0x08A18E00U, 0x0BF70C00U, 0x88FEDB00U, 0x0D5A0800U, 0x8E53DF00U, 0x8D055D00U, 0x0E0C8A00U,
+        0x911C4900U, 0x12159E00U, 0x11431C00U, 0x924ACB00U, 0x17EE1800U, 0x94E7CF00U, 0x97B14D00U, 0x14B89A00U,
+        0x1AB41000U, 0x99BDC700U, 0x9AEB4500U, 0x19E29200U, 0x9C464100U, 0x1F4F9600U, 0x1C191400U, 0x9F10C300U,
+        0xA4746900U, 0x277DBE00U, 0x242B3C00U, 0xA722EB00U, 0x22863800U, 0xA18FEF00U, 0xA2D96D00U, 0x21D0BA00U,
+        0x2FDC3000U, 0xACD5E700U, 0xAF836500U, 0x2C8AB200U, 0xA92E6100U, 0x2A27B600U, 0x29713400U, 0xAA78E300U,
+        0x35682000U, 0xB661F700U, 0xB5377500U, 0x363EA200U, 0xB39A7100U, 0x3093A600U, 0x33C52400U, 0xB0CCF300U,
+        0xBEC07900U, 0x3DC9AE00U, 0x3E9F2C00U, 0xBD96FB00U, 0x38322800U, 0xBB3BFF00U, 0xB86D7D00U, 0x3B64AA00U,
+        0xCEA42900U, 0x4DADFE00U, 0x4EFB7C00U, 0xCDF2AB00U, 0x48567800U, 0xCB5FAF00U, 0xC8092D00U, 0x4B00FA00U,
+        0x450C7000U, 0xC605A700U, 0xC5532500U, 0x465AF200U, 0xC3FE2100U, 0x40F7F600U, 0x43A17400U, 0xC0A8A300U,
+        0x5FB86000U, 0xDCB1B700U, 0xDFE73500U, 0x5CEEE200U, 0xD94A3100U, 0x5A43E600U, 0x59156400U, 0xDA1CB300U,
+        0xD4103900U, 0x5719EE00U, 0x544F6C00U, 0xD746BB00U, 0x52E26800U, 0xD1EBBF00U, 0xD2BD3D00U, 0x51B4EA00U,
+        0x6AD04000U, 0xE9D99700U, 0xEA8F1500U, 0x6986C200U, 0xEC221100U, 0x6F2BC600U, 0x6C7D4400U, 0xEF749300U,
+        0xE1781900U, 0x6271CE00U, 0x61274C00U, 0xE22E9B00U, 0x678A4800U, 0xE4839F00U, 0xE7D51D00U, 0x64DCCA00U,
+        0xFBCC0900U, 0x78C5DE00U, 0x7B935C00U, 0xF89A8B00U, 0x7D3E5800U, 0xFE378F00U, 0xFD610D00U, 0x7E68DA00U,
+        0x70645000U, 0xF36D8700U, 0xF03B0500U, 0x7332D200U, 0xF6960100U, 0x759FD600U, 0x76C95400U, 0xF5C08300U,
+        0x1B04A900U, 0x980D7E00U, 0x9B5BFC00U, 0x18522B00U, 0x9DF6F800U, 0x1EFF2F00U, 0x1DA9AD00U, 0x9EA07A00U,
+        0x90ACF000U, 0x13A52700U, 0x10F3A500U, 0x93FA7200U, 0x165EA100U, 0x95577600U, 0x9601F400U, 0x15082300U,
+        0x8A18E000U, 0x09113700U, 0x0A47B500U, 0x894E6200U, 0x0CEAB100U, 0x8FE36600U, 0x8CB5E400U, 0x0FBC3300U,
+        0x01B0B900U, 0x82B96E00U, 0x81EFEC00U, 0x02E63B00U, 0x8742E800U, 0x044B3F00U, 0x071DBD00U, 0x84146A00U,
+        0xBF70C000U, 0x3C791700U, 0x3F2F9500U, 0xBC264200U, 0x39829100U, 0xBA8B4600U, 0xB9DDC400U, 0x3AD41300U,
+        0x34D89900U, 0xB7D14E00U, 0xB487CC00U, 0x378E1B00U, 0xB22AC800U, 0x31231F00U, 0x32759D00U, 0xB17C4A00U,
+        0x2E6C8900U, 0xAD655E00U, 0xAE33DC00U, 0x2D3A0B00U, 0xA89ED800U, 0x2B970F00U, 0x28C18D00U, 0xABC85A00U,
+        0xA5C4D000U, 0x26CD0700U, 0x259B8500U, 0xA6925200U, 0x23368100U, 0xA03F5600U, 0xA369D400U, 0x20600300U,
+        0xD5A08000U, 0x56A95700U, 0x55FFD500U, 0xD6F60200U, 0x5352D100U, 0xD05B0600U, 0xD30D8400U, 0x50045300U,
+        0x5E08D900U, 0xDD010E00U, 0xDE578C00U, 0x5D5E5B00U, 0xD8FA8800U, 0x5BF35F00U, 0x58A5DD00U, 0xDBAC0A00U,
+        0x44BCC900U, 0xC7B51E00U, 0xC4E39C00U, 0x47EA4B00U, 0xC24E9800U, 0x41474F00U, 0x4211CD00U, 0xC1181A00U,
+        0xCF149000U, 0x4C1D4700U, 0x4F4BC500U, 0xCC421200U, 0x49E6C100U, 0xCAEF1600U, 0xC9B99400U, 0x4AB04300U,
+        0x71D4E900U, 0xF2DD3E00U, 0xF18BBC00U, 0x72826B00U, 0xF726B800U, 0x742F6F00U, 0x7779ED00U, 0xF4703A00U,
+        0xFA7CB000U, 0x79756700U, 0x7A23E500U, 0xF92A3200U, 0x7C8EE100U, 0xFF873600U, 0xFCD1B400U, 0x7FD86300U,
+        0xE0C8A000U, 0x63C17700U, 0x6097F500U, 0xE39E2200U, 0x663AF100U, 0xE5332600U, 0xE665A400U, 0x656C7300U,
+        0x6B60F900U, 0xE8692E00U, 0xEB3FAC00U, 0x68367B00U, 0xED92A800U, 0x6E9B7F00U, 0x6DCDFD00U, 0xEEC42A00U
+    },
+    {
+        0x00000000U, 0x36095200U, 0x6C12A400U, 0x5A1BF600U, 0xD8254800U, 0xEE2C1A00U, 0xB437EC00U, 0x823EBE00U,
+        0x36066B00U, 0x000F3900U, 0x5A14CF00U, 0x6C1D9D00U, 0xEE232300U, 0xD82A7100U, 0x82318700U, 0xB438D500U,
+        0x6C0CD600U, 0x5A058400U, 0x001E7200U, 0x36172000U, 0xB4299E00U, 0x8220CC00U, 0xD83B3A00U, 0xEE326800U,
+        0x5A0ABD00U, 0x6C03EF00U, 0x36181900U, 0x00114B00U, 0x822FF500U, 0xB426A700U, 0xEE3D5100U, 0xD8340300U,
+        0xD819AC00U, 0xEE10FE00U, 0xB40B0800U, 0x82025A00U, 0x003CE400U, 0x3635B600U, 0x6C2E4000U, 0x5A271200U,
+        0xEE1FC700U, 0xD8169500U, 0x820D6300U, 0xB4043100U, 0x363A8F00U, 0x0033DD00U, 0x5A282B00U, 0x6C217900U,
+        0xB4157A00U, 0x821C2800U, 0xD807DE00U, 0xEE0E8C00U, 0x6C303200U, 0x5A396000U, 0x00229600U, 0x362BC400U,
+        0x82131100U, 0xB41A4300U, 0xEE01B500U, 0xD808E700U, 0x5A365900U, 0x6C3F0B00U, 0x3624FD00U, 0x002DAF00U,
+        0x367FA300U, 0x0076F100U, 0x5A6D0700U, 0x6C645500U, 0xEE5AEB00U, 0xD853B900U, 0x82484F00U, 0xB4411D00U,
+        0x0079C800U, 0x36709A00U, 0x6C6B6C00U, 0x5A623E00U, 0xD85C8000U, 0xEE55D200U, 0xB44E2400U, 0x82477600U,
+        0x5A737500U, 0x6C7A2700U, 0x3661D100U, 0x00688300U, 0x82563D00U, 0xB45F6F00U, 0xEE449900U, 0xD84DCB00U,
+        0x6C751E00U, 0x5A7C4C00U, 0x0067BA00U, 0x366EE800U, 0xB4505600U, 0x82590400U, 0xD842F200U, 0xEE4BA000U,
+        0xEE660F00U, 0xD86F5D00U, 0x8274AB00U, 0xB47DF900U, 0x36434700U, 0x004A1500U, 0x5A51E300U, 0x6C58B100U,
+        0xD8606400U, 0xEE693600U, 0xB472C000U, 0x827B9200U, 0x00452C00U, 0x364C7E00U, 0x6C578800U, 0x5A5EDA00U,
+        0x826AD900U, 0xB4638B00U, 0xEE787D00U, 0xD8712F00U, 0x5A4F9100U, 0x6C46C300U, 0x365D3500U, 0x00546700U,
+        0xB46CB200U, 0x8265E000U, 0xD87E1600U, 0xEE774400U, 0x6C49FA00U, 0x5A40A800U, 0x005B5E00U, 0x36520C00U,
+        0x6CFF4600U, 0x5AF61400U, 0x00EDE200U, 0x36E4B000U, 0xB4DA0E00U, 0x82D35C00U, 0xD8C8AA00U, 0xEEC1F800U,
+        0x5AF92D00U, 0x6CF07F00U, 0x36EB8900U, 0x00E2DB00U, 0x82DC6500U, 0xB4D53700U, 0xEECEC100U, 0xD8C79300U,
+        0x00F39000U, 0x36FAC200U, 0x6CE13400U, 0x5AE86600U, 0xD8D6D800U, 0xEEDF8A00U, 0xB4C47C00U, 0x82CD2E00U,
+        0x36F5FB00U, 0x00FCA900U, 0x5AE75F00U, 0x6CEE0D00U, 0xEED0B300U, 0xD8D9E100U, 0x82C21700U, 0xB4CB4500U,
+        0xB4E6EA00U, 0x82EFB800U, 0xD8F44E00U, 0xEEFD1C00U, 0x6CC3A200U, 0x5ACAF000U, 0x00D10600U, 0x36D85400U,
+        0x82E08100U, 0xB4E9D300U, 0xEEF22500U, 0xD8FB7700U, 0x5AC5C900U, 0x6CCC9B00U, 0x36D76D00U, 0x00DE3F00U,
+        0xD8EA3C00U, 0xEEE36E00U, 0xB4F89800U, 0x82F1CA00U, 0x00CF7400U, 0x36C62600U, 0x6CDDD000U, 0x5AD48200U,
+        0xEEEC5700U, 0xD8E50500U, 0x82FEF300U, 0xB4F7A100U, 0x36C91F00U, 0x00C04D00U, 0x5ADBBB00U, 0x6CD2E900U,
+        0x5A80E500U, 0x6C89B700U, 0x36924100U, 0x009B1300U, 0x82A5AD00U, 0xB4ACFF00U, 0xEEB70900U, 0xD8BE5B00U,
+        0x6C868E00U, 0x5A8FDC00U, 0x00942A00U, 0x369D7800U, 0xB4A3C600U, 0x82AA9400U, 0xD8B16200U, 0xEEB83000U,
+        0x368C3300U, 0x00856100U, 0x5A9E9700U, 0x6C97C500U, 0xEEA97B00U, 0xD8A02900U, 0x82BBDF00U, 0xB4B28D00U,
+        0x008A5800U, 0x36830A00U, 0x6C98FC00U, 0x5A91AE00U, 0xD8AF1000U, 0xEEA64200U, 0xB4BDB400U, 0x82B4E600U,
+        0x82994900U, 0xB4901B00U, 0xEE8BED00U, 0xD882BF00U, 0x5ABC0100U, 0x6CB55300U, 0x36AEA500U, 0x00A7F700U,
+        0xB49F2200U, 0x82967000U, 0xD88D8600U, 0xEE84D400U, 0x6CBA6A00U, 0x5AB33800U, 0x00A8CE00U, 0x36A19C00U,
+        0xEE959F00U, 0xD89CCD00U, 0x82873B00U, 0xB48E6900U, 0x36B0D700U, 0x00B98500U, 0x5AA27300U, 0x6CAB2100U,
+        0xD893F400U, 0xEE9AA600U, 0xB4815000U, 0x82880200U, 0x00B6BC00U, 0x36BFEE00U, 0x6CA41800U, 0x5AAD4A00U
+    },
+#if U_SPARTN_CRC_SLICE_BY == 8
+    {
+        0x00000000U, 0xD9FE8C00U, 0x35B1E300U, 0xEC4F6F00U, 0x6B63C600U, 0xB29D4A00U, 0x5ED22500U, 0x872CA900U,
+        0xD6C78C00U, 0x0F390000U, 0xE3766F00U, 0x3A88E300U, 0xBDA44A00U, 0x645AC600U, 0x8815A900U, 0x51EB2500U,
+        0x2BC3E300U, 0xF23D6F00U, 0x1E720000U, 0xC78C8C00U, 0x40A02500U, 0x995EA900U, 0x7511C600U, 0xACEF4A00U,
+        0xFD046F00U, 0x24FAE300U, 0xC8B58C00U, 0x114B0000U, 0x9667A900U, 0x4F992500U, 0xA3D64A00U, 0x7A28C600U,
+        0x5787C600U, 0x8E794A00U, 0x62362500U, 0xBBC8A900U, 0x3CE40000U, 0xE51A8C00U, 0x0955E300U, 0xD0AB6F00U,
+        0x81404A00U, 0x58BEC600U, 0xB4F1A900U, 0x6D0F2500U, 0xEA238C00U, 0x33DD0000U, 0xDF926F00U, 0x066CE300U,
+        0x7C442500U, 0xA5BAA900U, 0x49F5C600U, 0x900B4A00U, 0x1727E300U, 0xCED96F00U, 0x22960000U, 0xFB688C00U,
+        0xAA83A900U, 0x737D2500U, 0x9F324A00U, 0x46CCC600U, 0xC1E06F00U, 0x181EE300U, 0xF4518C00U, 0x2DAF0000U,
+        0xAF0F8C00U, 0x76F10000U, 0x9ABE6F00U, 0x4340E300U, 0xC46C4A00U, 0x1D92C600U, 0xF1DDA900U, 0x28232500U,
+        0x79C80000U, 0xA0368C00U, 0x4C79E300U, 0x95876F00U, 0x12ABC600U, 0xCB554A00U, 0x271A2500U, 0xFEE4A900U,
+        0x84CC6F00U, 0x5D32E300U, 0xB17D8C00U, 0x68830000U, 0xEFAFA900U, 0x36512500U, 0xDA1E4A00U, 0x03E0C600U,
+        0x520BE300U, 0x8BF56F00U, 0x67BA0000U, 0xBE448C00U, 0x39682500U, 0xE096A900U, 0x0CD9C600U, 0xD5274A00U,
+        0xF8884A00U, 0x2176C600U, 0xCD39A900U, 0x14C72500U, 0x93EB8C00U, 0x4A150000U, 0xA65A6F00U, 0x7FA4E300U,
+        0x2E4FC600U, 0xF7B14A00U, 0x1BFE2500U, 0xC200A900U, 0x452C0000U, 0x9CD28C00U, 0x709DE300U, 0xA9636F00U,
+        0xD34BA900U, 0x0AB52500U, 0xE6FA4A00U, 0x3F04C600U, 0xB8286F00U, 0x61D6E300U, 0x8D998C00U, 0x54670000U,
+        0x058C2500U, 0xDC72A900U, 0x303DC600U, 0xE9C34A00U, 0x6EEFE300U, 0xB7116F00U, 0x5B5E0000U, 0x82A08C00U,
+        0xD853E300U, 0x01AD6F00U, 0xEDE20000U, 0x341C8C00U, 0xB3302500U, 0x6ACEA900U, 0x8681C600U, 0x5F7F4A00U,
+        0x0E946F00U, 0xD76AE300U, 0x3B258C00U, 0xE2DB0000U, 0x65F7A900U, 0xBC092500U, 0x50464A00U, 0x89B8C600U,
+        0xF3900000U, 0x2A6E8C00U, 0xC621E300U, 0x1FDF6F00U, 0x98F3C600U, 0x410D4A00U, 0xAD422500U, 0x74BCA900U,
+        0x25578C00U, 0xFCA90000U, 0x10E66F00U, 0xC918E300U, 0x4E344A00U, 0x97CAC600U, 0x7B85A900U, 0xA27B2500U,
+        0x8FD42500U, 0x562AA900U, 0xBA65C600U, 0x639B4A00U, 0xE4B7E300U, 0x3D496F00U, 0xD1060000U, 0x08F88C00U,
+        0x5913A900U, 0x80ED2500U, 0x6CA24A00U, 0xB55CC600U, 0x32706F00U, 0xEB8EE300U, 0x07C18C00U, 0xDE3F0000U,
+        0xA417C600U, 0x7DE94A00U, 0x91A62500U, 0x4858A900U, 0xCF740000U, 0x168A8C00U, 0xFAC5E300U, 0x233B6F00U,
+        0x72D04A00U, 0xAB2EC600U, 0x4761A900U, 0x9E9F2500U, 0x19B38C00U, 0xC04D0000U, 0x2C026F00U, 0xF5FCE300U,
+        0x775C6F00U, 0xAEA2E300U, 0x42ED8C00U, 0x9B130000U, 0x1C3FA900U, 0xC5C12500U, 0x298E4A00U, 0xF070C600U,
+        0xA19BE300U, 0x78656F00U, 0x942A0000U, 0x4DD48C00U, 0xCAF82500U, 0x1306A900U, 0xFF49C600U, 0x26B74A00U,
+        0x5C9F8C00U, 0x85610000U, 0x692E6F00U, 0xB0D0E300U, 0x37FC4A00U, 0xEE02C600U, 0x024DA900U, 0xDBB32500U,
+        0x8A580000U, 0x53A68C00U, 0xBFE9E300U, 0x66176F00U, 0xE13BC600U, 0x38C54A00U, 0xD48A2500U, 0x0D74A900U,
+        0x20DBA900U, 0xF9252500U, 0x156A4A00U, 0xCC94C600U, 0x4BB86F00U, 0x9246E300U, 0x7E098C00U, 0xA7F70000U,
+        0xF61C2500U, 0x2FE2A900U, 0xC3ADC600U, 0x1A534A00U, 0x9D7FE300U, 0x44816F00U, 0xA8CE0000U, 0x71308C00U,
+        0x0B184A00U, 0xD2E6C600U, 0x3EA9A900U, 0xE7572500U, 0x607B8C00U, 0xB9850000U, 0x55CA6F00U, 0x8C34E300U,
+        0xDDDFC600U, 0x04214A00U, 0xE86E2500U, 0x3190A900U, 0xB6BC0000U, 0x6F428C00U, 0x830DE300U, 0x5AF36F00U
+    },
+    {
+        0x00000000U, 0x36EB3D00U, 0x6DD67A00U, 0x5B3D4700U, 0xDBACF400U, 0xED47C900U, 0xB67A8E00U, 0x8091B300U,
+        0x31151300U, 0x07FE2E00U, 0x5CC36900U, 0x6A285400U, 0xEAB9E700U, 0xDC52DA00U, 0x876F9D00U, 0xB184A000U,
+        0x622A2600U, 0x54C11B00U, 0x0FFC5C00U, 0x39176100U, 0xB986D200U, 0x8F6DEF00U, 0xD450A800U, 0xE2BB9500U,
+        0x533F3500U, 0x65D40800U, 0x3EE94F00U, 0x08027200U, 0x8893C100U, 0xBE78FC00U, 0xE545BB00U, 0xD3AE8600U,
+        0xC4544C00U, 0xF2BF7100U, 0xA9823600U, 0x9F690B00U, 0x1FF8B800U, 0x29138500U, 0x722EC200U, 0x44C5FF00U,
+        0xF5415F00U, 0xC3AA6200U, 0x98972500U, 0xAE7C1800U, 0x2EEDAB00U, 0x18069600U, 0x433BD100U, 0x75D0EC00U,
+        0xA67E6A00U, 0x90955700U, 0xCBA81000U, 0xFD432D00U, 0x7DD29E00U, 0x4B39A300U, 0x1004E400U, 0x26EFD900U,
+        0x976B7900U, 0xA1804400U, 0xFABD0300U, 0xCC563E00U, 0x4CC78D00U, 0x7A2CB000U, 0x2111F700U, 0x17FACA00U,
+        0x0EE46300U, 0x380F5E00U, 0x63321900U, 0x55D92400U, 0xD5489700U, 0xE3A3AA00U, 0xB89EED00U, 0x8E75D000U,
+        0x3FF17000U, 0x091A4D00U, 0x52270A00U, 0x64CC3700U, 0xE45D8400U, 0xD2B6B900U, 0x898BFE00U, 0xBF60C300U,
+        0x6CCE4500U, 0x5A257800U, 0x01183F00U, 0x37F30200U, 0xB762B100U, 0x81898C00U, 0xDAB4CB00U, 0xEC5FF600U,
+        0x5DDB5600U, 0x6B306B00U, 0x300D2C00U, 0x06E61100U, 0x8677A200U, 0xB09C9F00U, 0xEBA1D800U, 0xDD4AE500U,
+        0xCAB02F00U, 0xFC5B1200U, 0xA7665500U, 0x918D6800U, 0x111CDB00U, 0x27F7E600U, 0x7CCAA100U, 0x4A219C00U,
+        0xFBA53C00U, 0xCD4E0100U, 0x96734600U, 0xA0987B00U, 0x2009C800U, 0x16E2F500U, 0x4DDFB200U, 0x7B348F00U,
+        0xA89A0900U, 0x9E713400U, 0xC54C7300U, 0xF3A74E00U, 0x7336FD00U, 0x45DDC000U, 0x1EE08700U, 0x280BBA00U,
+        0x998F1A00U, 0xAF642700U, 0xF4596000U, 0xC2B25D00U, 0x4223EE00U, 0x74C8D300U, 0x2FF59400U, 0x191EA900U,
+        0x1DC8C600U, 0x2B23FB00U, 0x701EBC00U, 0x46F58100U, 0xC6643200U, 0xF08F0F00U, 0xABB24800U, 0x9D597500U,
+        0x2CDDD500U, 0x1A36E800U, 0x410BAF00U, 0x77E09200U, 0xF7712100U, 0xC19A1C00U, 0x9AA75B00U, 0xAC4C6600U,
+        0x7FE2E000U, 0x4909DD00U, 0x12349A00U, 0x24DFA700U, 0xA44E1400U, 0x92A52900U, 0xC9986E00U, 0xFF735300U,
+        0x4EF7F300U, 0x781CCE00U, 0x23218900U, 0x15CAB400U, 0x955B0700U, 0xA3B03A00U, 0xF88D7D00U, 0xCE664000U,
+        0xD99C8A00U, 0xEF77B700U, 0xB44AF000U, 0x82A1CD00U, 0x02307E00U, 0x34DB4300U, 0x6FE60400U, 0x590D3900U,
+        0xE8899900U, 0xDE62A400U, 0x855FE300U, 0xB3B4DE00U, 0x33256D00U, 0x05CE5000U, 0x5EF31700U, 0x68182A00U,
+        0xBBB6AC00U, 0x8D5D9100U, 0xD660D600U, 0xE08BEB00U, 0x601A5800U, 0x56F16500U, 0x0DCC2200U, 0x3B271F00U,
+        0x8AA3BF00U, 0xBC488200U, 0xE775C500U, 0xD19EF800U, 0x510F4B00U, 0x67E47600U, 0x3CD93100U, 0x0A320C00U,
+        0x132CA500U, 0x25C79800U, 0x7EFADF00U, 0x4811E200U, 0xC8805100U, 0xFE6B6C00U, 0xA5562B00U, 0x93BD1600U,
+        0x2239B600U, 0x14D28B00U, 0x4FEFCC00U, 0x7904F100U, 0xF9954200U, 0xCF7E7F00U, 0x94433800U, 0xA2A80500U,
+        0x71068300U, 0x47EDBE00U, 0x1CD0F900U, 0x2A3BC400U, 0xAAAA7700U, 0x9C414A00U, 0xC77C0D00U, 0xF1973000U,
+        0x40139000U, 0x76F8AD00U, 0x2DC5EA00U, 0x1B2ED700U, 0x9BBF6400U, 0xAD545900U, 0xF6691E00U, 0xC0822300U,
+        0xD778E900U, 0xE193D400U, 0xBAAE9300U, 0x8C45AE00U, 0x0CD41D00U, 0x3A3F2000U, 0x61026700U, 0x57E95A00U,
+        0xE66DFA00U, 0xD086C700U, 0x8BBB8000U, 0xBD50BD00U, 0x3DC10E00U, 0x0B2A3300U, 0x50177400U, 0x66FC4900U,
+        0xB552CF00U, 0x83B9F200U, 0xD884B500U, 0xEE6F8800U, 0x6EFE3B00U, 0x58150600U, 0x03284100U, 0x35C37C00U,
+        0x8447DC00U, 0xB2ACE100U, 0xE991A600U, 0xDF7A9B00U, 0x5FEB2800U, 0x69001500U, 0x323D5200U, 0x04D66F00U
+    },
+    {
+        0x00000000U, 0x3B918C00U, 0x77231800U, 0x4CB29400U, 0xEE463000U, 0xD5D7BC00U, 0x99652800U, 0xA2F4A400U,
+        0x5AC09B00U, 0x61511700U, 0x2DE38300U, 0x16720F00U, 0xB486AB00U, 0x8F172700U, 0xC3A5B300U, 0xF8343F00U,
+        0xB5813600U, 0x8E10BA00U, 0xC2A22E00U, 0xF933A200U, 0x5BC70600U, 0x60568A00U, 0x2CE41E00U, 0x17759200U,
+        0xEF41AD00U, 0xD4D02100U, 0x9862B500U, 0xA3F33900U, 0x01079D00U, 0x3A961100U, 0x76248500U, 0x4DB50900U,
+        0xED4E9700U, 0xD6DF1B00U, 0x9A6D8F00U, 0xA1FC0300U, 0x0308A700U, 0x38992B00U, 0x742BBF00U, 0x4FBA3300U,
+        0xB78E0C00U, 0x8C1F8000U, 0xC0AD1400U, 0xFB3C9800U, 0x59C83C00U, 0x6259B000U, 0x2EEB2400U, 0x157AA800U,
+        0x58CFA100U, 0x635E2D00U, 0x2FECB900U, 0x147D3500U, 0xB6899100U, 0x8D181D00U, 0xC1AA8900U, 0xFA3B0500U,
+        0x020F3A00U, 0x399EB600U, 0x752C2200U, 0x4EBDAE00U, 0xEC490A00U, 0xD7D88600U, 0x9B6A1200U, 0xA0FB9E00U,
+        0x5CD1D500U, 0x67405900U, 0x2BF2CD00U, 0x10634100U, 0xB297E500U, 0x89066900U, 0xC5B4FD00U, 0xFE257100U,
+        0x06114E00U, 0x3D80C200U, 0x71325600U, 0x4AA3DA00U, 0xE8577E00U, 0xD3C6F200U, 0x9F746600U, 0xA4E5EA00U,
+        0xE950E300U, 0xD2C16F00U, 0x9E73FB00U, 0xA5E27700U, 0x0716D300U, 0x3C875F00U, 0x7035CB00U, 0x4BA44700U,
+        0xB3907800U, 0x8801F400U, 0xC4B36000U, 0xFF22EC00U, 0x5DD64800U, 0x6647C400U, 0x2AF55000U, 0x1164DC00U,
+        0xB19F4200U, 0x8A0ECE00U, 0xC6BC5A00U, 0xFD2DD600U, 0x5FD97200U, 0x6448FE00U, 0x28FA6A00U, 0x136BE600U,
+        0xEB5FD900U, 0xD0CE5500U, 0x9C7CC100U, 0xA7ED4D00U, 0x0519E900U, 0x3E886500U, 0x723AF100U, 0x49AB7D00U,
+        0x041E7400U, 0x3F8FF800U, 0x733D6C00U, 0x48ACE000U, 0xEA584400U, 0xD1C9C800U, 0x9D7B5C00U, 0xA6EAD000U,
+        0x5EDEEF00U, 0x654F6300U, 0x29FDF700U, 0x126C7B00U, 0xB098DF00U, 0x8B095300U, 0xC7BBC700U, 0xFC2A4B00U,
+        0xB9A3AA00U, 0x82322600U, 0xCE80B200U, 0xF5113E00U, 0x57E59A00U, 0x6C741600U, 0x20C68200U, 0x1B570E00U,
+        0xE3633100U, 0xD8F2BD00U, 0x94402900U, 0xAFD1A500U, 0x0D250100U, 0x36B48D00U, 0x7A061900U, 0x41979500U,
+        0x0C229C00U, 0x37B31000U, 0x7B018400U, 0x40900800U, 0xE264AC00U, 0xD9F52000U, 0x9547B400U, 0xAED63800U,
+        0x56E20700U, 0x6D738B00U, 0x21C11F00U, 0x1A509300U, 0xB8A43700U, 0x8335BB00U, 0xCF872F00U, 0xF416A300U,
+        0x54ED3D00U, 0x6F7CB100U, 0x23CE2500U, 0x185FA900U, 0xBAAB0D00U, 0x813A8100U, 0xCD881500U, 0xF6199900U,
+        0x0E2DA600U, 0x35BC2A00U, 0x790EBE00U, 0x429F3200U, 0xE06B9600U, 0xDBFA1A00U, 0x97488E00U, 0xACD90200U,
+        0xE16C0B00U, 0xDAFD8700U, 0x964F1300U, 0xADDE9F00U, 0x0F2A3B00U, 0x34BBB700U, 0x78092300U, 0x4398AF00U,
+        0xBBAC9000U, 0x803D1C00U, 0xCC8F8800U, 0xF71E0400U, 0x55EAA000U, 0x6E7B2C00U, 0x22C9B800U, 0x19583400U,
+        0xE5727F00U, 0xDEE3F300U, 0x92516700U, 0xA9C0EB00U, 0x0B344F00U, 0x30A5C300U, 0x7C175700U, 0x4786DB00U,
+        0xBFB2E400U, 0x84236800U, 0xC891FC00U, 0xF3007000U, 0x51F4D400U, 0x6A655800U, 0x26D7CC00U, 0x1D464000U,
+        0x50F34900U, 0x6B62C500U, 0x27D05100U, 0x1C41DD00U, 0xBEB57900U, 0x8524F500U, 0xC9966100U, 0xF207ED00U,
+        0x0A33D200U, 0x31A25E00U, 0x7D10CA00U, 0x46814600U, 0xE475E200U, 0xDFE46E00U, 0x9356FA00U, 0xA8C77600U,
+        0x083CE800U, 0x33AD6400U, 0x7F1FF000U, 0x448E7C00U, 0xE67AD800U, 0xDDEB5400U, 0x9159C000U, 0xAAC84C00U,
+        0x52FC7300U, 0x696DFF00U, 0x25DF6B00U, 0x1E4EE700U, 0xBCBA4300U, 0x872BCF00U, 0xCB995B00U, 0xF008D700U,
+        0xBDBDDE00U, 0x862C5200U, 0xCA9EC600U, 0xF10F4A00U, 0x53FBEE00U, 0x686A6200U, 0x24D8F600U, 0x1F497A00U,
+        0xE77D4500U, 0xDCECC900U, 0x905E5D00U, 0xABCFD100U, 0x093B7500U, 0x32AAF900U, 0x7E186D00U, 0x4589E100U
+    },
+    {
+        0x00000000U, 0xF50BAF00U, 0x6C5BA500U, 0x99500A00U, 0xD8B74A00U, 0x2DBCE500U, 0xB4ECEF00U, 0x41E74000U,
+        0x37226F00U, 0xC229C000U, 0x5B79CA00U, 0xAE726500U, 0xEF952500U, 0x1A9E8A00U, 0x83CE8000U, 0x76C52F00U,
+        0x6E44DE00U, 0x9B4F7100U, 0x021F7B00U, 0xF714D400U, 0xB6F39400U, 0x43F83B00U, 0xDAA83100U, 0x2FA39E00U,
+        0x5966B100U, 0xAC6D1E00U, 0x353D1400U, 0xC036BB00U, 0x81D1FB00U, 0x74DA5400U, 0xED8A5E00U, 0x1881F100U,
+        0xDC89BC00U, 0x29821300U, 0xB0D21900U, 0x45D9B600U, 0x043EF600U, 0xF1355900U, 0x68655300U, 0x9D6EFC00U,
+        0xEBABD300U, 0x1EA07C00U, 0x87F07600U, 0x72FBD900U, 0x331C9900U, 0xC6173600U, 0x5F473C00U, 0xAA4C9300U,
+        0xB2CD6200U, 0x47C6CD00U, 0xDE96C700U, 0x2B9D6800U, 0x6A7A2800U, 0x9F718700U, 0x06218D00U, 0xF32A2200U,
+        0x85EF0D00U, 0x70E4A200U, 0xE9B4A800U, 0x1CBF0700U, 0x5D584700U, 0xA853E800U, 0x3103E200U, 0xC4084D00U,
+        0x3F5F8300U, 0xCA542C00U, 0x53042600U, 0xA60F8900U, 0xE7E8C900U, 0x12E36600U, 0x8BB36C00U, 0x7EB8C300U,
+        0x087DEC00U, 0xFD764300U, 0x64264900U, 0x912DE600U, 0xD0CAA600U, 0x25C10900U, 0xBC910300U, 0x499AAC00U,
+        0x511B5D00U, 0xA410F200U, 0x3D40F800U, 0xC84B5700U, 0x89AC1700U, 0x7CA7B800U, 0xE5F7B200U, 0x10FC1D00U,
+        0x66393200U, 0x93329D00U, 0x0A629700U, 0xFF693800U, 0xBE8E7800U, 0x4B85D700U, 0xD2D5DD00U, 0x27DE7200U,
+        0xE3D63F00U, 0x16DD9000U, 0x8F8D9A00U, 0x7A863500U, 0x3B617500U, 0xCE6ADA00U, 0x573AD000U, 0xA2317F00U,
+        0xD4F45000U, 0x21FFFF00U, 0xB8AFF500U, 0x4DA45A00U, 0x0C431A00U, 0xF948B500U, 0x6018BF00U, 0x95131000U,
+        0x8D92E100U, 0x78994E00U, 0xE1C94400U, 0x14C2EB00U, 0x5525AB00U, 0xA02E0400U, 0x397E0E00U, 0xCC75A100U,
+        0xBAB08E00U, 0x4FBB2100U, 0xD6EB2B00U, 0x23E08400U, 0x6207C400U, 0x970C6B00U, 0x0E5C6100U, 0xFB57CE00U,
+        0x7EBF0600U, 0x8BB4A900U, 0x12E4A300U, 0xE7EF0C00U, 0xA6084C00U, 0x5303E300U, 0xCA53E900U, 0x3F584600U,
+        0x499D6900U, 0xBC96C600U, 0x25C6CC00U, 0xD0CD6300U, 0x912A2300U, 0x64218C00U, 0xFD718600U, 0x087A2900U,
+        0x10FBD800U, 0xE5F07700U, 0x7CA07D00U, 0x89ABD200U, 0xC84C9200U, 0x3D473D00U, 0xA4173700U, 0x511C9800U,
+        0x27D9B700U, 0xD2D21800U, 0x4B821200U, 0xBE89BD00U, 0xFF6EFD00U, 0x0A655200U, 0x93355800U, 0x663EF700U,
+        0xA236BA00U, 0x573D1500U, 0xCE6D1F00U, 0x3B66B000U, 0x7A81F000U, 0x8F8A5F00U, 0x16DA5500U, 0xE3D1FA00U,
+        0x9514D500U, 0x601F7A00U, 0xF94F7000U, 0x0C44DF00U, 0x4DA39F00U, 0xB8A83000U, 0x21F83A00U, 0xD4F39500U,
+        0xCC726400U, 0x3979CB00U, 0xA029C100U, 0x55226E00U, 0x14C52E00U, 0xE1CE8100U, 0x789E8B00U, 0x8D952400U,
+        0xFB500B00U, 0x0E5BA400U, 0x970BAE00U, 0x62000100U, 0x23E74100U, 0xD6ECEE00U, 0x4FBCE400U, 0xBAB74B00U,
+        0x41E08500U, 0xB4EB2A00U, 0x2DBB2000U, 0xD8B08F00U, 0x9957CF00U, 0x6C5C6000U, 0xF50C6A00U, 0x0007C500U,
+        0x76C2EA00U, 0x83C94500U, 0x1A994F00U, 0xEF92E000U, 0xAE75A000U, 0x5B7E0F00U, 0xC22E0500U, 0x3725AA00U,
+        0x2FA45B00U, 0xDAAFF400U, 0x43FFFE00U, 0xB6F45100U, 0xF7131100U, 0x0218BE00U, 0x9B48B400U, 0x6E431B00U,
+        0x18863400U, 0xED8D9B00U, 0x74DD9100U, 0x81D63E00U, 0xC0317E00U, 0x353AD100U, 0xAC6ADB00U, 0x59617400U,
+        0x9D693900U, 0x68629600U, 0xF1329C00U, 0x04393300U, 0x45DE7300U, 0xB0D5DC00U, 0x2985D600U, 0xDC8E7900U,
+        0xAA4B5600U, 0x5F40F900U, 0xC610F300U, 0x331B5C00U, 0x72FC1C00U, 0x87F7B300U, 0x1EA7B900U, 0xEBAC1600U,
+        0xF32DE700U, 0x06264800U, 0x9F764200U, 0x6A7DED00U, 0x2B9AAD00U, 0xDE910200U, 0x47C10800U, 0xB2CAA700U,
+        0xC40F8800U, 0x31042700U, 0xA8542D00U, 0x5D5F8200U, 0x1CB8C200U, 0xE9B36D00U, 0x70E36700U, 0x85E8C800U
+    },
+#endif
+};
+
+/** The slice tables for CRC32, see u32Crc16SliceTable.
+ */
+static const uint32_t u32Crc32SliceTable[U_SPARTN_CRC_SLICE_BY][256] = {
+    {
+        0x00000000U, 0x04C11DB7U, 0x09823B6EU, 0x0D4326D9U, 0x130476DCU, 0x17C56B6BU, 0x1A864DB2U, 0x1E475005U,
+        0x2608EDB8U, 0x22C9F00FU, 0x2F8AD6D6U, 0x2B4BCB61U, 0x350C9B64U, 0x31CD86D3U, 0x3C8EA00AU, 0x384FBDBDU,
+        0x4C11DB70U, 0x48D0C6C7U, 0x4593E01EU, 0x4152FDA9U, 0x5F15ADACU, 0x5BD4B01BU, 0x569796C2U, 0x52568B75U,
+        0x6A1936C8U, 0x6ED82B7FU, 0x639B0DA6U, 0x675A1011U, 0x791D4014U, 0x7DDC5DA3U, 0x709F7B7AU, 0x745E66CDU,
+        0x9823B6E0U, 0x9CE2AB57U, 0x91A18D8EU, 0x95609039U, 0x8B27C03CU, 0x8FE6DD8BU, 0x82A5FB52U, 0x8664E6E5U,
+        0xBE2B5B58U, 0xBAEA46EFU, 0xB7A96036U, 0xB3687D81U, 0xAD2F2D84U, 0xA9EE3033U, 0xA4AD16EAU, 0xA06C0B5DU,
+        0xD4326D90U, 0xD0F37027U, 0xDDB056FEU, 0xD9714B49U, 0xC7361B4CU, 0xC3F706FBU, 0xCEB42022U, 0xCA753D95U,
+        0xF23A8028U, 0xF6FB9D9FU, 0xFBB8BB46U, 0xFF79A6F1U, 0xE13EF6F4U, 0xE5FFEB43U, 0xE8BCCD9AU, 0xEC7DD02DU,
+        0x34867077U, 0x30476DC0U, 0x3D044B19U, 0x39C556AEU, 0x278206ABU, 0x23431B1CU, 0x2E003DC5U, 0x2AC12072U,
+        0x128E9DCFU, 0x164F8078U, 0x1B0CA6A1U, 0x1FCDBB16U, 0x018AEB13U, 0x054BF6A4U, 0x0808D07DU, 0x0CC9CDCAU,
+        0x7897AB07U, 0x7C56B6B0U, 0x71159069U, 0x75D48DDEU, 0x6B93DDDBU, 0x6F52C06CU, 0x6211E6B5U, 0x66D0FB02U,
+        0x5E9F46BFU, 0x5A5E5B08U, 0x571D7DD1U, 0x53DC6066U, 0x4D9B3063U, 0x495A2DD4U, 0x44190B0DU, 0x40D816BAU,
+        0xACA5C697U, 0xA864DB20U, 0xA527FDF9U, 0xA1E6E04EU, 0xBFA1B04BU, 0xBB60ADFCU, 0xB6238B25U, 0xB2E29692U,
+        0x8AAD2B2FU, 0x8E6C3698U, 0x832F1041U, 0x87EE0DF6U, 0x99A95DF3U, 0x9D684044U, 0x902B669DU, 0x94EA7B2AU,
+        0xE0B41DE7U, 0xE4750050U, 0xE9362689U, 0xEDF73B3EU, 0xF3B06B3BU, 0xF771768CU, 0xFA325055U, 0xFEF34DE2U,
+        0xC6BCF05FU, 0xC27DEDE8U, 0xCF3ECB31U, 0xCBFFD686U, 0xD5B88683U, 0xD1799B34U, 0xDC3ABDEDU, 0xD8FBA05AU,
+        0x690CE0EEU, 0x6DCDFD59U, 0x608EDB80U, 0x644FC637U, 0x7A089632U, 0x7EC98B85U, 0x738AAD5CU, 0x774BB0EBU,
+        0x4F040D56U, 0x4BC510E1U, 0x46863638U, 0x42472B8FU, 0x5C007B8AU, 0x58C1663DU, 0x558240E4U, 0x51435D53U,
+        0x251D3B9EU, 0x21DC2629U, 0x2C9F00F0U, 0x285E1D47U, 0x36194D42U, 0x32D850F5U, 0x3F9B762CU, 0x3B5A6B9BU,
+        0x0315D626U, 0x07D4CB91U, 0x0A97ED48U, 0x0E56F0FFU, 0x1011A0FAU, 0x14D0BD4DU, 0x19939B94U, 0x1D528623U,
+        0xF12F560EU, 0xF5EE4BB9U, 0xF8AD6D60U, 0xFC6C70D7U, 0xE22B20D2U, 0xE6EA3D65U, 0xEBA91BBCU, 0xEF68060BU,
+        0xD727BBB6U, 0xD3E6A601U, 0xDEA580D8U, 0xDA649D6FU, 0xC423CD6AU, 0xC0E2D0DDU, 0xCDA1F604U, 0xC960EBB3U,
+        0xBD3E8D7EU, 0xB9FF90C9U, 0xB4BCB610U, 0xB07DABA7U, 0xAE3AFBA2U, 0xAAFBE615U, 0xA7B8C0CCU, 0xA379DD7BU,
+        0x9B3660C6U, 0x9FF77D71U, 0x92B45BA8U, 0x9675461FU, 0x8832161AU, 0x8CF30BADU, 0x81B02D74U, 0x857130C3U,
+        0x5D8A9099U, 0x594B8D2EU, 0x5408ABF7U, 0x50C9B640U, 0x4E8EE645U, 0x4A4FFBF2U, 0x470CDD2BU, 0x43CDC09CU,
+        0x7B827D21U, 0x7F436096U, 0x7200464FU, 0x76C15BF8U, 0x68860BFDU, 0x6C47164AU, 0x61043093U, 0x65C52D24U,
+        0x119B4BE9U, 0x155A565EU, 0x18197087U, 0x1CD86D30U, 0x029F3D35U, 0x065E2082U, 0x0B1D065BU, 0x0FDC1BECU,
+        0x3793A651U, 0x3352BBE6U, 0x3E119D3FU, 0x3AD08088U, 0x2497D08DU, 0x2056CD3AU, 0x2D15EBE3U, 0x29D4F654U,
+        0xC5A92679U, 0xC1683BCEU, 0xCC2B1D17U, 0xC8EA00A0U, 0xD6AD50A5U, 0xD26C4D12U, 0xDF2F6BCBU, 0xDBEE767CU,
+        0xE3A1CBC1U, 0xE760D676U, 0xEA23F0AFU, 0xEEE2ED18U, 0xF0A5BD1DU, 0xF464A0AAU, 0xF9278673U, 0xFDE69BC4U,
+        0x89B8FD09U, 0x8D79E0BEU, 0x803AC667U, 0x84FBDBD0U, 0x9ABC8BD5U, 0x9E7D9662U, 0x933EB0BBU, 0x97FFAD0CU,
+        0xAFB010B1U, 0xAB710D06U, 0xA6322BDFU, 0xA2F33668U, 0xBCB4666DU, 0xB8757BDAU, 0xB5365D03U, 0xB1F740B4U
+    },
+    {
+        0x00000000U, 0xD219C1DCU, 0xA0F29E0FU, 0x72EB5FD3U, 0x452421A9U, 0x973DE075U, 0xE5D6BFA6U, 0x37CF7E7AU,
+        0x8A484352U, 0x5851828EU, 0x2ABADD5DU, 0xF8A31C81U, 0xCF6C62FBU, 0x1D75A327U, 0x6F9EFCF4U, 0xBD873D28U,
+        0x10519B13U, 0xC2485ACFU, 0xB0A3051CU, 0x62BAC4C0U, 0x5575BABAU, 0x876C7B66U, 0xF58724B5U, 0x279EE569U,
+        0x9A19D841U, 0x4800199DU, 0x3AEB464EU, 0xE8F28792U, 0xDF3DF9E8U, 0x0D243834U, 0x7FCF67E7U, 0xADD6A63BU,
+        0x20A33626U, 0xF2BAF7FAU, 0x8051A829U, 0x524869F5U, 0x6587178FU, 0xB79ED653U, 0xC5758980U, 0x176C485CU,
+        0xAAEB7574U, 0x78F2B4A8U, 0x0A19EB7BU, 0xD8002AA7U, 0xEFCF54DDU, 0x3DD69501U, 0x4F3DCAD2U, 0x9D240B0EU,
+        0x30F2AD35U, 0xE2EB6CE9U, 0x9000333AU, 0x4219F2E6U, 0x75D68C9CU, 0xA7CF4D40U, 0xD5241293U, 0x073DD34FU,
+        0xBABAEE67U, 0x68A32FBBU, 0x1A487068U, 0xC851B1B4U, 0xFF9ECFCEU, 0x2D870E12U, 0x5F6C51C1U, 0x8D75901DU,
+        0x41466C4CU, 0x935FAD90U, 0xE1B4F243U, 0x33AD339FU, 0x04624DE5U, 0xD67B8C39U, 0xA490D3EAU, 0x76891236U,
+        0xCB0E2F1EU, 0x1917EEC2U, 0x6BFCB111U, 0xB9E570CDU, 0x8E2A0EB7U, 0x5C33CF6BU, 0x2ED890B8U, 0xFCC15164U,
+        0x5117F75FU, 0x830E3683U, 0xF1E56950U, 0x23FCA88CU, 0x1433D6F6U, 0xC62A172AU, 0xB4C148F9U, 0x66D88925U,
+        0xDB5FB40DU, 0x094675D1U, 0x7BAD2A02U, 0xA9B4EBDEU, 0x9E7B95A4U, 0x4C625478U, 0x3E890BABU, 0xEC90CA77U,
+        0x61E55A6AU, 0xB3FC9BB6U, 0xC117C465U, 0x130E05B9U, 0x24C17BC3U, 0xF6D8BA1FU, 0x8433E5CCU, 0x562A2410U,
+        0xEBAD1938U, 0x39B4D8E4U, 0x4B5F8737U, 0x994646EBU, 0xAE893891U, 0x7C90F94DU, 0x0E7BA69EU, 0xDC626742U,
+        0x71B4C179U, 0xA3AD00A5U, 0xD1465F76U, 0x035F9EAAU, 0x3490E0D0U, 0xE689210CU, 0x94627EDFU, 0x467BBF03U,
+        0xFBFC822BU, 0x29E543F7U, 0x5B0E1C24U, 0x8917DDF8U, 0xBED8A382U, 0x6CC1625EU, 0x1E2A3D8DU, 0xCC33FC51U,
+        0x828CD898U, 0x50951944U, 0x227E4697U, 0xF067874BU, 0xC7A8F931U, 0x15B138EDU, 0x675A673EU, 0xB543A6E2U,
+        0x08C49BCAU, 0xDADD5A16U, 0xA83605C5U, 0x7A2FC419U, 0x4DE0BA63U, 0x9FF97BBFU, 0xED12246CU, 0x3F0BE5B0U,
+        0x92DD438BU, 0x40C48257U, 0x322FDD84U, 0xE0361C58U, 0xD7F96222U, 0x05E0A3FEU, 0x770BFC2DU, 0xA5123DF1U,
+        0x189500D9U, 0xCA8CC105U, 0xB8679ED6U, 0x6A7E5F0AU, 0x5DB12170U, 0x8FA8E0ACU, 0xFD43BF7FU, 0x2F5A7EA3U,
+        0xA22FEEBEU, 0x70362F62U, 0x02DD70B1U, 0xD0C4B16DU, 0xE70BCF17U, 0x35120ECBU, 0x47F95118U, 0x95E090C4U,
+        0x2867ADECU, 0xFA7E6C30U, 0x889533E3U, 0x5A8CF23FU, 0x6D438C45U, 0xBF5A4D99U, 0xCDB1124AU, 0x1FA8D396U,
+        0xB27E75ADU, 0x6067B471U, 0x128CEBA2U, 0xC0952A7EU, 0xF75A5404U, 0x254395D8U, 0x57A8CA0BU, 0x85B10BD7U,
+        0x383636FFU, 0xEA2FF723U, 0x98C4A8F0U, 0x4ADD692CU, 0x7D121756U, 0xAF0BD68AU, 0xDDE08959U, 0x0FF94885U,
+        0xC3CAB4D4U, 0x11D37508U, 0x63382ADBU, 0xB121EB07U, 0x86EE957DU, 0x54F754A1U, 0x261C0B72U, 0xF405CAAEU,
+        0x4982F786U, 0x9B9B365AU, 0xE9706989U, 0x3B69A855U, 0x0CA6D62FU, 0xDEBF17F3U, 0xAC544820U, 0x7E4D89FCU,
+        0xD39B2FC7U, 0x0182EE1BU, 0x7369B1C8U, 0xA1707014U, 0x96BF0E6EU, 0x44A6CFB2U, 0x364D9061U, 0xE45451BDU,
+        0x59D36C95U, 0x8BCAAD49U, 0xF921F29AU, 0x2B383346U, 0x1CF74D3CU, 0xCEEE8CE0U, 0xBC05D333U, 0x6E1C12EFU,
+        0xE36982F2U, 0x3170432EU, 0x439B1CFDU, 0x9182DD21U, 0xA64DA35BU, 0x74546287U, 0x06BF3D54U, 0xD4A6FC88U,
+        0x6921C1A0U, 0xBB38007CU, 0xC9D35FAFU, 0x1BCA9E73U, 0x2C05E009U, 0xFE1C21D5U, 0x8CF77E06U, 0x5EEEBFDAU,
+        0xF33819E1U, 0x2121D83DU, 0x53CA87EEU, 0x81D34632U, 0xB61C3848U, 0x6405F994U, 0x16EEA647U, 0xC4F7679BU,
+        0x79705AB3U, 0xAB699B6FU, 0xD982C4BCU, 0x0B9B0560U, 0x3C547B1AU, 0xEE4DBAC6U, 0x9CA6E515U, 0x4EBF24C9U
+    },
+    {
+        0x00000000U, 0x01D8AC87U, 0x03B1590EU, 0x0269F589U, 0x0762B21CU, 0x06BA1E9BU, 0x04D3EB12U, 0x050B4795U,
+        0x0EC56438U, 0x0F1DC8BFU, 0x0D743D36U, 0x0CAC91B1U, 0x09A7D624U, 0x087F7AA3U, 0x0A168F2AU, 0x0BCE23ADU,
+        0x1D8AC870U, 0x1C5264F7U, 0x1E3B917EU, 0x1FE33DF9U, 0x1AE87A6CU, 0x1B30D6EBU, 0x19592362U, 0x18818FE5U,
+        0x134FAC48U, 0x129700CFU, 0x10FEF546U, 0x112659C1U, 0x142D1E54U, 0x15F5B2D3U, 0x179C475AU, 0x1644EBDDU,
+        0x3B1590E0U, 0x3ACD3C67U, 0x38A4C9EEU, 0x397C6569U, 0x3C7722FCU, 0x3DAF8E7BU, 0x3FC67BF2U, 0x3E1ED775U,
+        0x35D0F4D8U, 0x3408585FU, 0x3661ADD6U, 0x37B90151U, 0x32B246C4U, 0x336AEA43U, 0x31031FCAU, 0x30DBB34DU,
+        0x269F5890U, 0x2747F417U, 0x252E019EU, 0x24F6AD19U, 0x21FDEA8CU, 0x2025460BU, 0x224CB382U, 0x23941F05U,
+        0x285A3CA8U, 0x2982902FU, 0x2BEB65A6U, 0x2A33C921U, 0x2F388EB4U, 0x2EE02233U, 0x2C89D7BAU, 0x2D517B3DU,
+        0x762B21C0U, 0x77F38D47U, 0x759A78CEU, 0x7442D449U, 0x714993DCU, 0x70913F5BU, 0x72F8CAD2U, 0x73206655U,
+        0x78EE45F8U, 0x7936E97FU, 0x7B5F1CF6U, 0x7A87B071U, 0x7F8CF7E4U, 0x7E545B63U, 0x7C3DAEEAU, 0x7DE5026DU,
+        0x6BA1E9B0U, 0x6A794537U, 0x6810B0BEU, 0x69C81C39U, 0x6CC35BACU, 0x6D1BF72BU, 0x6F7202A2U, 0x6EAAAE25U,
+        0x65648D88U, 0x64BC210FU, 0x66D5D486U, 0x670D7801U, 0x62063F94U, 0x63DE9313U, 0x61B7669AU, 0x606FCA1DU,
+        0x4D3EB120U, 0x4CE61DA7U, 0x4E8FE82EU, 0x4F5744A9U, 0x4A5C033CU, 0x4B84AFBBU, 0x49ED5A32U, 0x4835F6B5U,
+        0x43FBD518U, 0x4223799FU, 0x404A8C16U, 0x41922091U, 0x44996704U, 0x4541CB83U, 0x47283E0AU, 0x46F0928DU,
+        0x50B47950U, 0x516CD5D7U, 0x5305205EU, 0x52DD8CD9U, 0x57D6CB4CU, 0x560E67CBU, 0x54679242U, 0x55BF3EC5U,
+        0x5E711D68U, 0x5FA9B1EFU, 0x5DC04466U, 0x5C18E8E1U, 0x5913AF74U, 0x58CB03F3U, 0x5AA2F67AU, 0x5B7A5AFDU,
+        0xEC564380U, 0xED8EEF07U, 0xEFE71A8EU, 0xEE3FB609U, 0xEB34F19CU, 0xEAEC5D1BU, 0xE885A892U, 0xE95D0415U,
+        0xE29327B8U, 0xE34B8B3FU, 0xE1227EB6U, 0xE0FAD231U, 0xE5F195A4U, 0xE4293923U, 0xE640CCAAU, 0xE798602DU,
+        0xF1DC8BF0U, 0xF0042777U, 0xF26DD2FEU, 0xF3B57E79U, 0xF6BE39ECU, 0xF766956BU, 0xF50F60E2U, 0xF4D7CC65U,
+        0xFF19EFC8U, 0xFEC1434FU, 0xFCA8B6C6U, 0xFD701A41U, 0xF87B5DD4U, 0xF9A3F153U, 0xFBCA04DAU, 0xFA12A85DU,
+        0xD743D360U, 0xD69B7FE7U, 0xD4F28A6EU, 0xD52A26E9U, 0xD021617CU, 0xD1F9CDFBU, 0xD3903872U, 0xD24894F5U,
+        0xD986B758U, 0xD85E1BDFU, 0xDA37EE56U, 0xDBEF42D1U, 0xDEE40544U, 0xDF3CA9C3U, 0xDD555C4AU, 0xDC8DF0CDU,
+        0xCAC91B10U, 0xCB11B797U, 0xC978421EU, 0xC8A0EE99U, 0xCDABA90CU, 0xCC73058BU, 0xCE1AF002U, 0xCFC25C85U,
+        0xC40C7F28U, 0xC5D4D3AFU, 0xC7BD2626U, 0xC6658AA1U, 0xC36ECD34U, 0xC2B661B3U, 0xC0DF943AU, 0xC10738BDU,
+        0x9A7D6240U, 0x9BA5CEC7U, 0x99CC3B4EU, 0x981497C9U, 0x9D1FD05CU, 0x9CC77CDBU, 0x9EAE8952U, 0x9F7625D5U,
+        0x94B80678U, 0x9560AAFFU, 0x97095F76U, 0x96D1F3F1U, 0x93DAB464U, 0x920218E3U, 0x906BED6AU, 0x91B341EDU,
+        0x87F7AA30U, 0x862F06B7U, 0x8446F33EU, 0x859E5FB9U, 0x8095182CU, 0x814DB4ABU, 0x83244122U, 0x82FCEDA5U,
+        0x8932CE08U, 0x88EA628FU, 0x8A839706U, 0x8B5B3B81U, 0x8E507C14U, 0x8F88D093U, 0x8DE1251AU, 0x8C39899DU,
+        0xA168F2A0U, 0xA0B05E27U, 0xA2D9ABAEU, 0xA3010729U, 0xA60A40BCU, 0xA7D2EC3BU, 0xA5BB19B2U, 0xA463B535U,
+        0xAFAD9698U, 0xAE753A1FU, 0xAC1CCF96U, 0xADC46311U, 0xA8CF2484U, 0xA9178803U, 0xAB7E7D8AU, 0xAAA6D10DU,
+        0xBCE23AD0U, 0xBD3A9657U, 0xBF5363DEU, 0xBE8BCF59U, 0xBB8088CCU, 0xBA58244BU, 0xB831D1C2U, 0xB9E97D45U,
+        0xB2275EE8U, 0xB3FFF26FU, 0xB19607E6U, 0xB04EAB61U, 0xB545ECF4U, 0xB49D4073U, 0xB6F4B5FAU, 0xB72C197DU
+    },
+    {
+        0x00000000U, 0xDC6D9AB7U, 0xBC1A28D9U, 0x6077B26EU, 0x7CF54C05U, 0xA098D6B2U, 0xC0EF64DCU, 0x1C82FE6BU,
+        0xF9EA980AU, 0x258702BDU, 0x45F0B0D3U, 0x999D2A64U, 0x851FD40FU, 0x59724EB8U, 0x3905FCD6U, 0xE5686661U,
+        0xF7142DA3U, 0x2B79B714U, 0x4B0E057AU, 0x97639FCDU, 0x8BE161A6U, 0x578CFB11U, 0x37FB497FU, 0xEB96D3C8U,
+        0x0EFEB5A9U, 0xD2932F1EU, 0xB2E49D70U, 0x6E8907C7U, 0x720BF9ACU, 0xAE66631BU, 0xCE11D175U, 0x127C4BC2U,
+        0xEAE946F1U, 0x3684DC46U, 0x56F36E28U, 0x8A9EF49FU, 0x961C0AF4U, 0x4A719043U, 0x2A06222DU, 0xF66BB89AU,
+        0x1303DEFBU, 0xCF6E444CU, 0xAF19F622U, 0x73746C95U, 0x6FF692FEU, 0xB39B0849U, 0xD3ECBA27U, 0x0F812090U,
+        0x1DFD6B52U, 0xC190F1E5U, 0xA1E7438BU, 0x7D8AD93CU, 0x61082757U, 0xBD65BDE0U, 0xDD120F8EU, 0x017F9539U,
+        0xE417F358U, 0x387A69EFU, 0x580DDB81U, 0x84604136U, 0x98E2BF5DU, 0x448F25EAU, 0x24F89784U, 0xF8950D33U,
+        0xD1139055U, 0x0D7E0AE2U, 0x6D09B88CU, 0xB164223BU, 0xADE6DC50U, 0x718B46E7U, 0x11FCF489U, 0xCD916E3EU,
+        0x28F9085FU, 0xF49492E8U, 0x94E32086U, 0x488EBA31U, 0x540C445AU, 0x8861DEEDU, 0xE8166C83U, 0x347BF634U,
+        0x2607BDF6U, 0xFA6A2741U, 0x9A1D952FU, 0x46700F98U, 0x5AF2F1F3U, 0x869F6B44U, 0xE6E8D92AU, 0x3A85439DU,
+        0xDFED25FCU, 0x0380BF4BU, 0x63F70D25U, 0xBF9A9792U, 0xA31869F9U, 0x7F75F34EU, 0x1F024120U, 0xC36FDB97U,
+        0x3BFAD6A4U, 0xE7974C13U, 0x87E0FE7DU, 0x5B8D64CAU, 0x470F9AA1U, 0x9B620016U, 0xFB15B278U, 0x277828CFU,
+        0xC2104EAEU, 0x1E7DD419U, 0x7E0A6677U, 0xA267FCC0U, 0xBEE502ABU, 0x6288981CU, 0x02FF2A72U, 0xDE92B0C5U,
+        0xCCEEFB07U, 0x108361B0U, 0x70F4D3DEU, 0xAC994969U, 0xB01BB702U, 0x6C762DB5U, 0x0C019FDBU, 0xD06C056CU,
+        0x3504630DU, 0xE969F9BAU, 0x891E4BD4U, 0x5573D163U, 0x49F12F08U, 0x959CB5BFU, 0xF5EB07D1U, 0x29869D66U,
+        0xA6E63D1DU, 0x7A8BA7AAU, 0x1AFC15C4U, 0xC6918F73U, 0xDA137118U, 0x067EEBAFU, 0x660959C1U, 0xBA64C376U,
+        0x5F0CA517U, 0x83613FA0U, 0xE3168DCEU, 0x3F7B1779U, 0x23F9E912U, 0xFF9473A5U, 0x9FE3C1CBU, 0x438E5B7CU,
+        0x51F210BEU, 0x8D9F8A09U, 0xEDE83867U, 0x3185A2D0U, 0x2D075CBBU, 0xF16AC60CU, 0x911D7462U, 0x4D70EED5U,
+        0xA81888B4U, 0x74751203U, 0x1402A06DU, 0xC86F3ADAU, 0xD4EDC4B1U, 0x08805E06U, 0x68F7EC68U, 0xB49A76DFU,
+        0x4C0F7BECU, 0x9062E15BU, 0xF0155335U, 0x2C78C982U, 0x30FA37E9U, 0xEC97AD5EU, 0x8CE01F30U, 0x508D8587U,
+        0xB5E5E3E6U, 0x69887951U, 0x09FFCB3FU, 0xD5925188U, 0xC910AFE3U, 0x157D3554U, 0x750A873AU, 0xA9671D8DU,
+        0xBB1B564FU, 0x6776CCF8U, 0x07017E96U, 0xDB6CE421U, 0xC7EE1A4AU, 0x1B8380FDU, 0x7BF43293U, 0xA799A824U,
+        0x42F1CE45U, 0x9E9C54F2U, 0xFEEBE69CU, 0x22867C2BU, 0x3E048240U, 0xE26918F7U, 0x821EAA99U, 0x5E73302EU,
+        0x77F5AD48U, 0xAB9837FFU, 0xCBEF8591U, 0x17821F26U, 0x0B00E14DU, 0xD76D7BFAU, 0xB71AC994U, 0x6B775323U,
+        0x8E1F3542U, 0x5272AFF5U, 0x32051D9BU, 0xEE68872CU, 0xF2EA7947U, 0x2E87E3F0U, 0x4EF0519EU, 0x929DCB29U,
+        0x80E180EBU, 0x5C8C1A5CU, 0x3CFBA832U, 0xE0963285U, 0xFC14CCEEU, 0x20795659U, 0x400EE437U, 0x9C637E80U,
+        0x790B18E1U, 0xA5668256U, 0xC5113038U, 0x197CAA8FU, 0x05FE54E4U, 0xD993CE53U, 0xB9E47C3DU, 0x6589E68AU,
+        0x9D1CEBB9U, 0x4171710EU, 0x2106C360U, 0xFD6B59D7U, 0xE1E9A7BCU, 0x3D843D0BU, 0x5DF38F65U, 0x819E15D2U,
+        0x64F673B3U, 0xB89BE904U, 0xD8EC5B6AU, 0x0481C1DDU, 0x18033FB6U, 0xC46EA501U, 0xA419176FU, 0x78748DD8U,
+        0x6A08C61AU, 0xB6655CADU, 0xD612EEC3U, 0x0A7F7474U, 0x16FD8A1FU, 0xCA9010A8U, 0xAAE7A2C6U, 0x768A3871U,
+        0x93E25E10U, 0x4F8FC4A7U, 0x2FF876C9U, 0xF395EC7EU, 0xEF171215U, 0x337A88A2U, 0x530D3ACCU, 0x8F60A07BU
+    },
+#if U_SPARTN_CRC_SLICE_BY == 8
+    {
+        0x00000000U, 0x490D678DU, 0x921ACF1AU, 0xDB17A897U, 0x20F48383U, 0x69F9E40EU, 0xB2EE4C99U, 0xFBE32B14U,
+        0x41E90706U, 0x08E4608BU, 0xD3F3C81CU, 0x9AFEAF91U, 0x611D8485U, 0x2810E308U, 0xF3074B9FU, 0xBA0A2C12U,
+        0x83D20E0CU, 0xCADF6981U, 0x11C8C116U, 0x58C5A69BU, 0xA3268D8FU, 0xEA2BEA02U, 0x313C4295U, 0x78312518U,
+        0xC23B090AU, 0x8B366E87U, 0x5021C610U, 0x192CA19DU, 0xE2CF8A89U, 0xABC2ED04U, 0x70D54593U, 0x39D8221EU,
+        0x036501AFU, 0x4A686622U, 0x917FCEB5U, 0xD872A938U, 0x2391822CU, 0x6A9CE5A1U, 0xB18B4D36U, 0xF8862ABBU,
+        0x428C06A9U, 0x0B816124U, 0xD096C9B3U, 0x999BAE3EU, 0x6278852AU, 0x2B75E2A7U, 0xF0624A30U, 0xB96F2DBDU,
+        0x80B70FA3U, 0xC9BA682EU, 0x12ADC0B9U, 0x5BA0A734U, 0xA0438C20U, 0xE94EEBADU, 0x3259433AU, 0x7B5424B7U,
+        0xC15E08A5U, 0x88536F28U, 0x5344C7BFU, 0x1A49A032U, 0xE1AA8B26U, 0xA8A7ECABU, 0x73B0443CU, 0x3ABD23B1U,
+        0x06CA035EU, 0x4FC764D3U, 0x94D0CC44U, 0xDDDDABC9U, 0x263E80DDU, 0x6F33E750U, 0xB4244FC7U, 0xFD29284AU,
+        0x47230458U, 0x0E2E63D5U, 0xD539CB42U, 0x9C34ACCFU, 0x67D787DBU, 0x2EDAE056U, 0xF5CD48C1U, 0xBCC02F4CU,
+        0x85180D52U, 0xCC156ADFU, 0x1702C248U, 0x5E0FA5C5U, 0xA5EC8ED1U, 0xECE1E95CU, 0x37F641CBU, 0x7EFB2646U,
+        0xC4F10A54U, 0x8DFC6DD9U, 0x56EBC54EU, 0x1FE6A2C3U, 0xE40589D7U, 0xAD08EE5AU, 0x761F46CDU, 0x3F122140U,
+        0x05AF02F1U, 0x4CA2657CU, 0x97B5CDEBU, 0xDEB8AA66U, 0x255B8172U, 0x6C56E6FFU, 0xB7414E68U, 0xFE4C29E5U,
+        0x444605F7U, 0x0D4B627AU, 0xD65CCAEDU, 0x9F51AD60U, 0x64B28674U, 0x2DBFE1F9U, 0xF6A8496EU, 0xBFA52EE3U,
+        0x867D0CFDU, 0xCF706B70U, 0x1467C3E7U, 0x5D6AA46AU, 0xA6898F7EU, 0xEF84E8F3U, 0x34934064U, 0x7D9E27E9U,
+        0xC7940BFBU, 0x8E996C76U, 0x558EC4E1U, 0x1C83A36CU, 0xE7608878U, 0xAE6DEFF5U, 0x757A4762U, 0x3C7720EFU,
+        0x0D9406BCU, 0x44996131U, 0x9F8EC9A6U, 0xD683AE2BU, 0x2D60853FU, 0x646DE2B2U, 0xBF7A4A25U, 0xF6772DA8U,
+        0x4C7D01BAU, 0x05706637U, 0xDE67CEA0U, 0x976AA92DU, 0x6C898239U, 0x2584E5B4U, 0xFE934D23U, 0xB79E2AAEU,
+        0x8E4608B0U, 0xC74B6F3DU, 0x1C5CC7AAU, 0x5551A027U, 0xAEB28B33U, 0xE7BFECBEU, 0x3CA84429U, 0x75A523A4U,
+        0xCFAF0FB6U, 0x86A2683BU, 0x5DB5C0ACU, 0x14B8A721U, 0xEF5B8C35U, 0xA656EBB8U, 0x7D41432FU, 0x344C24A2U,
+        0x0EF10713U, 0x47FC609EU, 0x9CEBC809U, 0xD5E6AF84U, 0x2E058490U, 0x6708E31DU, 0xBC1F4B8AU, 0xF5122C07U,
+        0x4F180015U, 0x06156798U, 0xDD02CF0FU, 0x940FA882U, 0x6FEC8396U, 0x26E1E41BU, 0xFDF64C8CU, 0xB4FB2B01U,
+        0x8D23091FU, 0xC42E6E92U, 0x1F39C605U, 0x5634A188U, 0xADD78A9CU, 0xE4DAED11U, 0x3FCD4586U, 0x76C0220BU,
+        0xCCCA0E19U, 0x85C76994U, 0x5ED0C103U, 0x17DDA68EU, 0xEC3E8D9AU, 0xA533EA17U, 0x7E244280U, 0x3729250DU,
+        0x0B5E05E2U, 0x4253626FU, 0x9944CAF8U, 0xD049AD75U, 0x2BAA8661U, 0x62A7E1ECU, 0xB9B0497BU, 0xF0BD2EF6U,
+        0x4AB702E4U, 0x03BA6569U, 0xD8ADCDFEU, 0x91A0AA73U, 0x6A438167U, 0x234EE6EAU, 0xF8594E7DU, 0xB15429F0U,
+        0x888C0BEEU, 0xC1816C63U, 0x1A96C4F4U, 0x539BA379U, 0xA878886DU, 0xE175EFE0U, 0x3A624777U, 0x736F20FAU,
+        0xC9650CE8U, 0x80686B65U, 0x5B7FC3F2U, 0x1272A47FU, 0xE9918F6BU, 0xA09CE8E6U, 0x7B8B4071U, 0x328627FCU,
+        0x083B044DU, 0x413663C0U, 0x9A21CB57U, 0xD32CACDAU, 0x28CF87CEU, 0x61C2E043U, 0xBAD548D4U, 0xF3D82F59U,
+        0x49D2034BU, 0x00DF64C6U, 0xDBC8CC51U, 0x92C5ABDCU, 0x692680C8U, 0x202BE745U, 0xFB3C4FD2U, 0xB231285FU,
+        0x8BE90A41U, 0xC2E46DCCU, 0x19F3C55BU, 0x50FEA2D6U, 0xAB1D89C2U, 0xE210EE4FU, 0x390746D8U, 0x700A2155U,
+        0xCA000D47U, 0x830D6ACAU, 0x581AC25DU, 0x1117A5D0U, 0xEAF48EC4U, 0xA3F9E949U, 0x78EE41DEU, 0x31E32653U
+    },
+    {
+        0x00000000U, 0x1B280D78U, 0x36501AF0U, 0x2D781788U, 0x6CA035E0U, 0x77883898U, 0x5AF02F10U, 0x41D82268U,
+        0xD9406BC0U, 0xC26866B8U, 0xEF107130U, 0xF4387C48U, 0xB5E05E20U, 0xAEC85358U, 0x83B044D0U, 0x989849A8U,
+        0xB641CA37U, 0xAD69C74FU, 0x8011D0C7U, 0x9B39DDBFU, 0xDAE1FFD7U, 0xC1C9F2AFU, 0xECB1E527U, 0xF799E85FU,
+        0x6F01A1F7U, 0x7429AC8FU, 0x5951BB07U, 0x4279B67FU, 0x03A19417U, 0x1889996FU, 0x35F18EE7U, 0x2ED9839FU,
+        0x684289D9U, 0x736A84A1U, 0x5E129329U, 0x453A9E51U, 0x04E2BC39U, 0x1FCAB141U, 0x32B2A6C9U, 0x299AABB1U,
+        0xB102E219U, 0xAA2AEF61U, 0x8752F8E9U, 0x9C7AF591U, 0xDDA2D7F9U, 0xC68ADA81U, 0xEBF2CD09U, 0xF0DAC071U,
+        0xDE0343EEU, 0xC52B4E96U, 0xE853591EU, 0xF37B5466U, 0xB2A3760EU, 0xA98B7B76U, 0x84F36CFEU, 0x9FDB6186U,
+        0x0743282EU, 0x1C6B2556U, 0x311332DEU, 0x2A3B3FA6U, 0x6BE31DCEU, 0x70CB10B6U, 0x5DB3073EU, 0x469B0A46U,
+        0xD08513B2U, 0xCBAD1ECAU, 0xE6D50942U, 0xFDFD043AU, 0xBC252652U, 0xA70D2B2AU, 0x8A753CA2U, 0x915D31DAU,
+        0x09C57872U, 0x12ED750AU, 0x3F956282U, 0x24BD6FFAU, 0x65654D92U, 0x7E4D40EAU, 0x53355762U, 0x481D5A1AU,
+        0x66C4D985U, 0x7DECD4FDU, 0x5094C375U, 0x4BBCCE0DU, 0x0A64EC65U, 0x114CE11DU, 0x3C34F695U, 0x271CFBEDU,
+        0xBF84B245U, 0xA4ACBF3DU, 0x89D4A8B5U, 0x92FCA5CDU, 0xD32487A5U, 0xC80C8ADDU, 0xE5749D55U, 0xFE5C902DU,
+        0xB8C79A6BU, 0xA3EF9713U, 0x8E97809BU, 0x95BF8DE3U, 0xD467AF8BU, 0xCF4FA2F3U, 0xE237B57BU, 0xF91FB803U,
+        0x6187F1ABU, 0x7AAFFCD3U, 0x57D7EB5BU, 0x4CFFE623U, 0x0D27C44BU, 0x160FC933U, 0x3B77DEBBU, 0x205FD3C3U,
+        0x0E86505CU, 0x15AE5D24U, 0x38D64AACU, 0x23FE47D4U, 0x622665BCU, 0x790E68C4U, 0x54767F4CU, 0x4F5E7234U,
+        0xD7C63B9CU, 0xCCEE36E4U, 0xE196216CU, 0xFABE2C14U, 0xBB660E7CU, 0xA04E0304U, 0x8D36148CU, 0x961E19F4U,
+        0xA5CB3AD3U, 0xBEE337ABU, 0x939B2023U, 0x88B32D5BU, 0xC96B0F33U, 0xD243024BU, 0xFF3B15C3U, 0xE41318BBU,
+        0x7C8B5113U, 0x67A35C6BU, 0x4ADB4BE3U, 0x51F3469BU, 0x102B64F3U, 0x0B03698BU, 0x267B7E03U, 0x3D53737BU,
+        0x138AF0E4U, 0x08A2FD9CU, 0x25DAEA14U, 0x3EF2E76CU, 0x7F2AC504U, 0x6402C87CU, 0x497ADFF4U, 0x5252D28CU,
+        0xCACA9B24U, 0xD1E2965CU, 0xFC9A81D4U, 0xE7B28CACU, 0xA66AAEC4U, 0xBD42A3BCU, 0x903AB434U, 0x8B12B94CU,
+        0xCD89B30AU, 0xD6A1BE72U, 0xFBD9A9FAU, 0xE0F1A482U, 0xA12986EAU, 0xBA018B92U, 0x97799C1AU, 0x8C519162U,
+        0x14C9D8CAU, 0x0FE1D5B2U, 0x2299C23AU, 0x39B1CF42U, 0x7869ED2AU, 0x6341E052U, 0x4E39F7DAU, 0x5511FAA2U,
+        0x7BC8793DU, 0x60E07445U, 0x4D9863CDU, 0x56B06EB5U, 0x17684CDDU, 0x0C4041A5U, 0x2138562DU, 0x3A105B55U,
+        0xA28812FDU, 0xB9A01F85U, 0x94D8080DU, 0x8FF00575U, 0xCE28271DU, 0xD5002A65U, 0xF8783DEDU, 0xE3503095U,
+        0x754E2961U, 0x6E662419U, 0x431E3391U, 0x58363EE9U, 0x19EE1C81U, 0x02C611F9U, 0x2FBE0671U, 0x34960B09U,
+        0xAC0E42A1U, 0xB7264FD9U, 0x9A5E5851U, 0x81765529U, 0xC0AE7741U, 0xDB867A39U, 0xF6FE6DB1U, 0xEDD660C9U,
+        0xC30FE356U, 0xD827EE2EU, 0xF55FF9A6U, 0xEE77F4DEU, 0xAFAFD6B6U, 0xB487DBCEU, 0x99FFCC46U, 0x82D7C13EU,
+        0x1A4F8896U, 0x016785EEU, 0x2C1F9266U, 0x37379F1EU, 0x76EFBD76U, 0x6DC7B00EU, 0x40BFA786U, 0x5B97AAFEU,
+        0x1D0CA0B8U, 0x0624ADC0U, 0x2B5CBA48U, 0x3074B730U, 0x71AC9558U, 0x6A849820U, 0x47FC8FA8U, 0x5CD482D0U,
+        0xC44CCB78U, 0xDF64C600U, 0xF21CD188U, 0xE934DCF0U, 0xA8ECFE98U, 0xB3C4F3E0U, 0x9EBCE468U, 0x8594E910U,
+        0xAB4D6A8FU, 0xB06567F7U, 0x9D1D707FU, 0x86357D07U, 0xC7ED5F6FU, 0xDCC55217U, 0xF1BD459FU, 0xEA9548E7U,
+        0x720D014FU, 0x69250C37U, 0x445D1BBFU, 0x5F7516C7U, 0x1EAD34AFU, 0x058539D7U, 0x28FD2E5FU, 0x33D52327U
+    },
+    {
+        0x00000000U, 0x4F576811U, 0x9EAED022U, 0xD1F9B833U, 0x399CBDF3U, 0x76CBD5E2U, 0xA7326DD1U, 0xE86505C0U,
+        0x73397BE6U, 0x3C6E13F7U, 0xED97ABC4U, 0xA2C0C3D5U, 0x4AA5C615U, 0x05F2AE04U, 0xD40B1637U, 0x9B5C7E26U,
+        0xE672F7CCU, 0xA9259FDDU, 0x78DC27EEU, 0x378B4FFFU, 0xDFEE4A3FU, 0x90B9222EU, 0x41409A1DU, 0x0E17F20CU,
+        0x954B8C2AU, 0xDA1CE43BU, 0x0BE55C08U, 0x44B23419U, 0xACD731D9U, 0xE38059C8U, 0x3279E1FBU, 0x7D2E89EAU,
+        0xC824F22FU, 0x87739A3EU, 0x568A220DU, 0x19DD4A1CU, 0xF1B84FDCU, 0xBEEF27CDU, 0x6F169FFEU, 0x2041F7EFU,
+        0xBB1D89C9U, 0xF44AE1D8U, 0x25B359EBU, 0x6AE431FAU, 0x8281343AU, 0xCDD65C2BU, 0x1C2FE418U, 0x53788C09U,
+        0x2E5605E3U, 0x61016DF2U, 0xB0F8D5C1U, 0xFFAFBDD0U, 0x17CAB810U, 0x589DD001U, 0x89646832U, 0xC6330023U,
+        0x5D6F7E05U, 0x12381614U, 0xC3C1AE27U, 0x8C96C636U, 0x64F3C3F6U, 0x2BA4ABE7U, 0xFA5D13D4U, 0xB50A7BC5U,
+        0x9488F9E9U, 0xDBDF91F8U, 0x0A2629CBU, 0x457141DAU, 0xAD14441AU, 0xE2432C0BU, 0x33BA9438U, 0x7CEDFC29U,
+        0xE7B1820FU, 0xA8E6EA1EU, 0x791F522DU, 0x36483A3CU, 0xDE2D3FFCU, 0x917A57EDU, 0x4083EFDEU, 0x0FD487CFU,
+        0x72FA0E25U, 0x3DAD6634U, 0xEC54DE07U, 0xA303B616U, 0x4B66B3D6U, 0x0431DBC7U, 0xD5C863F4U, 0x9A9F0BE5U,
+        0x01C375C3U, 0x4E941DD2U, 0x9F6DA5E1U, 0xD03ACDF0U, 0x385FC830U, 0x7708A021U, 0xA6F11812U, 0xE9A67003U,
+        0x5CAC0BC6U, 0x13FB63D7U, 0xC202DBE4U, 0x8D55B3F5U, 0x6530B635U, 0x2A67DE24U, 0xFB9E6617U, 0xB4C90E06U,
+        0x2F957020U, 0x60C21831U, 0xB13BA002U, 0xFE6CC813U, 0x1609CDD3U, 0x595EA5C2U, 0x88A71DF1U, 0xC7F075E0U,
+        0xBADEFC0AU, 0xF589941BU, 0x24702C28U, 0x6B274439U, 0x834241F9U, 0xCC1529E8U, 0x1DEC91DBU, 0x52BBF9CAU,
+        0xC9E787ECU, 0x86B0EFFDU, 0x574957CEU, 0x181E3FDFU, 0xF07B3A1FU, 0xBF2C520EU, 0x6ED5EA3DU, 0x2182822CU,
+        0x2DD0EE65U, 0x62878674U, 0xB37E3E47U, 0xFC295656U, 0x144C5396U, 0x5B1B3B87U, 0x8AE283B4U, 0xC5B5EBA5U,
+        0x5EE99583U, 0x11BEFD92U, 0xC04745A1U, 0x8F102DB0U, 0x67752870U, 0x28224061U, 0xF9DBF852U, 0xB68C9043U,
+        0xCBA219A9U, 0x84F571B8U, 0x550CC98BU, 0x1A5BA19AU, 0xF23EA45AU, 0xBD69CC4BU, 0x6C907478U, 0x23C71C69U,
+        0xB89B624FU, 0xF7CC0A5EU, 0x2635B26DU, 0x6962DA7CU, 0x8107DFBCU, 0xCE50B7ADU, 0x1FA90F9EU, 0x50FE678FU,
+        0xE5F41C4AU, 0xAAA3745BU, 0x7B5ACC68U, 0x340DA479U, 0xDC68A1B9U, 0x933FC9A8U, 0x42C6719BU, 0x0D91198AU,
+        0x96CD67ACU, 0xD99A0FBDU, 0x0863B78EU, 0x4734DF9FU, 0xAF51DA5FU, 0xE006B24EU, 0x31FF0A7DU, 0x7EA8626CU,
+        0x0386EB86U, 0x4CD18397U, 0x9D283BA4U, 0xD27F53B5U, 0x3A1A5675U, 0x754D3E64U, 0xA4B48657U, 0xEBE3EE46U,
+        0x70BF9060U, 0x3FE8F871U, 0xEE114042U, 0xA1462853U, 0x49232D93U, 0x06744582U, 0xD78DFDB1U, 0x98DA95A0U,
+        0xB958178CU, 0xF60F7F9DU, 0x27F6C7AEU, 0x68A1AFBFU, 0x80C4AA7FU, 0xCF93C26EU, 0x1E6A7A5DU, 0x513D124CU,
+        0xCA616C6AU, 0x8536047BU, 0x54CFBC48U, 0x1B98D459U, 0xF3FDD199U, 0xBCAAB988U, 0x6D5301BBU, 0x220469AAU,
+        0x5F2AE040U, 0x107D8851U, 0xC1843062U, 0x8ED35873U, 0x66B65DB3U, 0x29E135A2U, 0xF8188D91U, 0xB74FE580U,
+        0x2C139BA6U, 0x6344F3B7U, 0xB2BD4B84U, 0xFDEA2395U, 0x158F2655U, 0x5AD84E44U, 0x8B21F677U, 0xC4769E66U,
+        0x717CE5A3U, 0x3E2B8DB2U, 0xEFD23581U, 0xA0855D90U, 0x48E05850U, 0x07B73041U, 0xD64E8872U, 0x9919E063U,
+        0x02459E45U, 0x4D12F654U, 0x9CEB4E67U, 0xD3BC2676U, 0x3BD923B6U, 0x748E4BA7U, 0xA577F394U, 0xEA209B85U,
+        0x970E126FU, 0xD8597A7EU, 0x09A0C24DU, 0x46F7AA5CU, 0xAE92AF9CU, 0xE1C5C78DU, 0x303C7FBEU, 0x7F6B17AFU,
+        0xE4376989U, 0xAB600198U, 0x7A99B9ABU, 0x35CED1BAU, 0xDDABD47AU, 0x92FCBC6BU, 0x43050458U, 0x0C526C49U
+    },
+    {
+        0x00000000U, 0x5BA1DCCAU, 0xB743B994U, 0xECE2655EU, 0x6A466E9FU, 0x31E7B255U, 0xDD05D70BU, 0x86A40BC1U,
+        0xD48CDD3EU, 0x8F2D01F4U, 0x63CF64AAU, 0x386EB860U, 0xBECAB3A1U, 0xE56B6F6BU, 0x09890A35U, 0x5228D6FFU,
+        0xADD8A7CBU, 0xF6797B01U, 0x1A9B1E5FU, 0x413AC295U, 0xC79EC954U, 0x9C3F159EU, 0x70DD70C0U, 0x2B7CAC0AU,
+        0x79547AF5U, 0x22F5A63FU, 0xCE17C361U, 0x95B61FABU, 0x1312146AU, 0x48B3C8A0U, 0xA451ADFEU, 0xFFF07134U,
+        0x5F705221U, 0x04D18EEBU, 0xE833EBB5U, 0xB392377FU, 0x35363CBEU, 0x6E97E074U, 0x8275852AU, 0xD9D459E0U,
+        0x8BFC8F1FU, 0xD05D53D5U, 0x3CBF368BU, 0x671EEA41U, 0xE1BAE180U, 0xBA1B3D4AU, 0x56F95814U, 0x0D5884DEU,
+        0xF2A8F5EAU, 0xA9092920U, 0x45EB4C7EU, 0x1E4A90B4U, 0x98EE9B75U, 0xC34F47BFU, 0x2FAD22E1U, 0x740CFE2BU,
+        0x262428D4U, 0x7D85F41EU, 0x91679140U, 0xCAC64D8AU, 0x4C62464BU, 0x17C39A81U, 0xFB21FFDFU, 0xA0802315U,
+        0xBEE0A442U, 0xE5417888U, 0x09A31DD6U, 0x5202C11CU, 0xD4A6CADDU, 0x8F071617U, 0x63E57349U, 0x3844AF83U,
+        0x6A6C797CU, 0x31CDA5B6U, 0xDD2FC0E8U, 0x868E1C22U, 0x002A17E3U, 0x5B8BCB29U, 0xB769AE77U, 0xECC872BDU,
+        0x13380389U, 0x4899DF43U, 0xA47BBA1DU, 0xFFDA66D7U, 0x797E6D16U, 0x22DFB1DCU, 0xCE3DD482U, 0x959C0848U,
+        0xC7B4DEB7U, 0x9C15027DU, 0x70F76723U, 0x2B56BBE9U, 0xADF2B028U, 0xF6536CE2U, 0x1AB109BCU, 0x4110D576U,
+        0xE190F663U, 0xBA312AA9U, 0x56D34FF7U, 0x0D72933DU, 0x8BD698FCU, 0xD0774436U, 0x3C952168U, 0x6734FDA2U,
+        0x351C2B5DU, 0x6EBDF797U, 0x825F92C9U, 0xD9FE4E03U, 0x5F5A45C2U, 0x04FB9908U, 0xE819FC56U, 0xB3B8209CU,
+        0x4C4851A8U, 0x17E98D62U, 0xFB0BE83CU, 0xA0AA34F6U, 0x260E3F37U, 0x7DAFE3FDU, 0x914D86A3U, 0xCAEC5A69U,
+        0x98C48C96U, 0xC365505CU, 0x2F873502U, 0x7426E9C8U, 0xF282E209U, 0xA9233EC3U, 0x45C15B9DU, 0x1E608757U,
+        0x79005533U, 0x22A189F9U, 0xCE43ECA7U, 0x95E2306DU, 0x13463BACU, 0x48E7E766U, 0xA4058238U, 0xFFA45EF2U,
+        0xAD8C880DU, 0xF62D54C7U, 0x1ACF3199U, 0x416EED53U, 0xC7CAE692U, 0x9C6B3A58U, 0x70895F06U, 0x2B2883CCU,
+        0xD4D8F2F8U, 0x8F792E32U, 0x639B4B6CU, 0x383A97A6U, 0xBE9E9C67U, 0xE53F40ADU, 0x09DD25F3U, 0x527CF939U,
+        0x00542FC6U, 0x5BF5F30CU, 0xB7179652U, 0xECB64A98U, 0x6A124159U, 0x31B39D93U, 0xDD51F8CDU, 0x86F02407U,
+        0x26700712U, 0x7DD1DBD8U, 0x9133BE86U, 0xCA92624CU, 0x4C36698DU, 0x1797B547U, 0xFB75D019U, 0xA0D40CD3U,
+        0xF2FCDA2CU, 0xA95D06E6U, 0x45BF63B8U, 0x1E1EBF72U, 0x98BAB4B3U, 0xC31B6879U, 0x2FF90D27U, 0x7458D1EDU,
+        0x8BA8A0D9U, 0xD0097C13U, 0x3CEB194DU, 0x674AC587U, 0xE1EECE46U, 0xBA4F128CU, 0x56AD77D2U, 0x0D0CAB18U,
+        0x5F247DE7U, 0x0485A12DU, 0xE867C473U, 0xB3C618B9U, 0x35621378U, 0x6EC3CFB2U, 0x8221AAECU, 0xD9807626U,
+        0xC7E0F171U, 0x9C412DBBU, 0x70A348E5U, 0x2B02942FU, 0xADA69FEEU, 0xF6074324U, 0x1AE5267AU, 0x4144FAB0U,
+        0x136C2C4FU, 0x48CDF085U, 0xA42F95DBU, 0xFF8E4911U, 0x792A42D0U, 0x228B9E1AU, 0xCE69FB44U, 0x95C8278EU,
+        0x6A3856BAU, 0x31998A70U, 0xDD7BEF2EU, 0x86DA33E4U, 0x007E3825U, 0x5BDFE4EFU, 0xB73D81B1U, 0xEC9C5D7BU,
+        0xBEB48B84U, 0xE515574EU, 0x09F73210U, 0x5256EEDAU, 0xD4F2E51BU, 0x8F5339D1U, 0x63B15C8FU, 0x38108045U,
+        0x9890A350U, 0xC3317F9AU, 0x2FD31AC4U, 0x7472C60EU, 0xF2D6CDCFU, 0xA9771105U, 0x4595745BU, 0x1E34A891U,
+        0x4C1C7E6EU, 0x17BDA2A4U, 0xFB5FC7FAU, 0xA0FE1B30U, 0x265A10F1U, 0x7DFBCC3BU, 0x9119A965U, 0xCAB875AFU,
+        0x3548049BU, 0x6EE9D851U, 0x820BBD0FU, 0xD9AA61C5U, 0x5F0E6A04U, 0x04AFB6CEU, 0xE84DD390U, 0xB3EC0F5AU,
+        0xE1C4D9A5U, 0xBA65056FU, 0x56876031U, 0x0D26BCFBU, 0x8B82B73AU, 0xD0236BF0U, 0x3CC10EAEU, 0x6760D264U
+    },
+#endif
+};
+
+#endif // #if U_SPARTN_CRC_SLICE_BY == 1
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Have uPortCryptoCrc() perform a CRC, if U_SPARTN_CRC_USE_PORT_CRYPTO
+// is defined, returning true if it did so.
+static bool crcPort(uint32_t polynomial, size_t widthBits,
+                    uint32_t initialValue, const char *pData,
+                    size_t size, uint32_t *pCrc)
+{
+#ifdef U_SPARTN_CRC_USE_PORT_CRYPTO
+    return (uPortCryptoCrc(polynomial, widthBits, initialValue,
+                           pData, size, pCrc) == (int32_t) U_ERROR_COMMON_SUCCESS);
+#else
+    (void) polynomial;
+    (void) widthBits;
+    (void) initialValue;
+    (void) pData;
+    (void) size;
+    (void) pCrc;
+    return false;
+#endif
+}
+
+#if U_SPARTN_CRC_SLICE_BY == 1
+
+// The original byte-wise CRC16.
+static uint16_t crc16Bytewise(const char *pData, size_t size)
+{
+    // Initialize local variables
+    uint16_t u16TableRemainder;
+    uint16_t u16Remainder = 0; // Initial remainder
+    uint8_t  u8NumBitsInCrc = (8 * sizeof(uint16_t));
+    const uint8_t  *pU8Msg = (uint8_t *) pData;
+
+    // Compute the CRC value
+    // Divide each byte of the message by the corresponding polynomial
+    for (size_t x = 0; x < size; x++) {
+        u16TableRemainder = pU8Msg[x] ^ (u16Remainder >> (u8NumBitsInCrc - 8));
+        u16Remainder = u16Crc16Table[u16TableRemainder] ^ (u16Remainder << 8);
+    }
+
+    return u16Remainder;
+}
+
+// The original byte-wise CRC24 Radix 64.
+static uint32_t crc24Bytewise(const char *pData, size_t size)
+{
+    // Initialize local variables
+    uint32_t u32TableRemainder;
+    uint32_t u32Remainder = 0; // Initial remainder
+    uint8_t u8NumBitsInCrc = (8 * sizeof(uint8_t) * 3);
+    const uint8_t *pU8Msg = (uint8_t *) pData;
+
+    // Compute the CRC value
+    // Divide each byte of the message by the corresponding polynomial
+    for (size_t x = 0; x < size; x++) {
+        u32TableRemainder = pU8Msg[x] ^ (u32Remainder >> (u8NumBitsInCrc - 8));
+        u32Remainder = u32Crc24Table[u32TableRemainder] ^ (u32Remainder << 8);
+        u32Remainder = u32Remainder & 0x00FFFFFF; // Only interested in 24 bits
+    }
+
+    return u32Remainder;
+}
+
+// The original byte-wise CRC32, without the final XOR.
+static uint32_t crc32Bytewise(const char *pData, size_t size)
+{
+    // Initialize local variables
+    uint32_t u32TableRemainder;
+    uint32_t u32Remainder = 0xFFFFFFFFU; // Initial remainder
+    uint8_t u8NumBitsInCrc = (8 * sizeof(uint32_t));
+    const uint8_t *pU8Msg = (uint8_t *) pData;
+
+    // Compute the CRC value
+    // Divide each byte of the message by the corresponding polynomial
+    for (size_t x = 0; x < size; x++) {
+        u32TableRemainder = pU8Msg[x] ^ (u32Remainder >> (u8NumBitsInCrc - 8));
+        u32Remainder = u32Crc32Table[u32TableRemainder] ^ (u32Remainder << 8);
+    }
+
+    return u32Remainder;
+}
+
+#else
+
+// Perform a CRC of up to 32 bits, left-aligned in a 32-bit register,
+// U_SPARTN_CRC_SLICE_BY bytes at a time using the given slice
+// tables; the return value is also left-aligned.
+static uint32_t crcSliced(const uint32_t pTable[][256], uint32_t crc,
+                          const char *pData, size_t size)
+{
+    const uint8_t *pU8Msg = (const uint8_t *) pData;
+
+    while (size >= U_SPARTN_CRC_SLICE_BY) {
+        // The first four bytes of the message are combined with the
+        // remainder, any further bytes are looked-up directly
+        crc ^= (((uint32_t) pU8Msg[0]) << 24) | (((uint32_t) pU8Msg[1]) << 16) |
+               (((uint32_t) pU8Msg[2]) << 8) | pU8Msg[3];
+        crc = pTable[U_SPARTN_CRC_SLICE_BY - 1][crc >> 24] ^
+              pTable[U_SPARTN_CRC_SLICE_BY - 2][(crc >> 16) & 0xFF] ^
+              pTable[U_SPARTN_CRC_SLICE_BY - 3][(crc >> 8) & 0xFF] ^
+              pTable[U_SPARTN_CRC_SLICE_BY - 4][crc & 0xFF];
+# if U_SPARTN_CRC_SLICE_BY == 8
+        crc ^= pTable[3][pU8Msg[4]] ^ pTable[2][pU8Msg[5]] ^
+               pTable[1][pU8Msg[6]] ^ pTable[0][pU8Msg[7]];
+# endif
+        pU8Msg += U_SPARTN_CRC_SLICE_BY;
+        size -= U_SPARTN_CRC_SLICE_BY;
+    }
+
+    // Do any remainder the byte-wise way
+    while (size > 0) {
+        crc = pTable[0][(crc >> 24) ^ *pU8Msg] ^ (crc << 8);
+        pU8Msg++;
+        size--;
+    }
+
+    return crc;
+}
+
+#endif // #if U_SPARTN_CRC_SLICE_BY == 1
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -266,36 +1252,29 @@ uint8_t uSpartnCrc8(const char *pData, size_t size)
 
 uint16_t uSpartnCrc16(const char *pData, size_t size)
 {
-    // Initialize local variables
-    uint16_t u16TableRemainder;
-    uint16_t u16Remainder = 0; // Initial remainder
-    uint8_t  u8NumBitsInCrc = (8 * sizeof(uint16_t));
-    const uint8_t  *pU8Msg = (uint8_t *) pData;
+    uint32_t u32Remainder = 0;
 
-    // Compute the CRC value
-    // Divide each byte of the message by the corresponding polynomial
-    for (size_t x = 0; x < size; x++) {
-        u16TableRemainder = pU8Msg[x] ^ (u16Remainder >> (u8NumBitsInCrc - 8));
-        u16Remainder = u16Crc16Table[u16TableRemainder] ^ (u16Remainder << 8);
+    if (!crcPort(U_SPARTN_CRC_POLYNOMIAL_16, 16, 0, pData, size, &u32Remainder)) {
+#if U_SPARTN_CRC_SLICE_BY == 1
+        u32Remainder = crc16Bytewise(pData, size);
+#else
+        u32Remainder = crcSliced(u32Crc16SliceTable, 0, pData, size) >> 16;
+#endif
     }
 
-    return u16Remainder;
+    return (uint16_t) u32Remainder;
 }
 
 uint32_t uSpartnCrc24(const char *pData, size_t size)
 {
-    // Initialize local variables
-    uint32_t u32TableRemainder;
-    uint32_t u32Remainder = 0; // Initial remainder
-    uint8_t u8NumBitsInCrc = (8 * sizeof(uint8_t) * 3);
-    const uint8_t *pU8Msg = (uint8_t *) pData;
+    uint32_t u32Remainder = 0;
 
-    // Compute the CRC value
-    // Divide each byte of the message by the corresponding polynomial
-    for (size_t x = 0; x < size; x++) {
-        u32TableRemainder = pU8Msg[x] ^ (u32Remainder >> (u8NumBitsInCrc - 8));
-        u32Remainder = u32Crc24Table[u32TableRemainder] ^ (u32Remainder << 8);
-        u32Remainder = u32Remainder & 0x00FFFFFF; // Only interested in 24 bits
+    if (!crcPort(U_SPARTN_CRC_POLYNOMIAL_24, 24, 0, pData, size, &u32Remainder)) {
+#if U_SPARTN_CRC_SLICE_BY == 1
+        u32Remainder = crc24Bytewise(pData, size);
+#else
+        u32Remainder = crcSliced(u32Crc24SliceTable, 0, pData, size) >> 8;
+#endif
     }
 
     return u32Remainder;
@@ -303,18 +1282,15 @@ uint32_t uSpartnCrc24(const char *pData, size_t size)
 
 uint32_t uSpartnCrc32(const char *pData, size_t size)
 {
-    // Initialize local variables
-    uint32_t u32TableRemainder;
-    uint32_t u32Remainder = 0xFFFFFFFFU; // Initial remainder
-    uint8_t u8NumBitsInCrc = (8 * sizeof(uint32_t));
+    uint32_t u32Remainder = 0;
     uint32_t u32FinalXORValue = 0xFFFFFFFFU;
-    const uint8_t *pU8Msg = (uint8_t *) pData;
 
-    // Compute the CRC value
-    // Divide each byte of the message by the corresponding polynomial
-    for (size_t x = 0; x < size; x++) {
-        u32TableRemainder = pU8Msg[x] ^ (u32Remainder >> (u8NumBitsInCrc - 8));
-        u32Remainder = u32Crc32Table[u32TableRemainder] ^ (u32Remainder << 8);
+    if (!crcPort(U_SPARTN_CRC_POLYNOMIAL_32, 32, 0xFFFFFFFFU, pData, size, &u32Remainder)) {
+#if U_SPARTN_CRC_SLICE_BY == 1
+        u32Remainder = crc32Bytewise(pData, size);
+#else
+        u32Remainder = crcSliced(u32Crc32SliceTable, 0xFFFFFFFFU, pData, size);
+#endif
     }
 
     u32Remainder = u32Remainder ^ u32FinalXORValue;
@@ -82,6 +82,27 @@
 # define U_SPARTN_TEST_BUFFER_SIZE_BYTES (U_SPARTN_MESSAGE_LENGTH_MAX_BYTES + U_SPARTN_TEST_BUFFER_EXTRA_SIZE_BYTES)
 #endif
 
+#ifndef U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES
+/** The size of the buffer to run the CRCs over when measuring
+ * their throughput.
+ */
+# define U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES 1024
+#endif
+
+#ifndef U_SPARTN_TEST_CRC_SPEED_ITERATIONS
+/** The number of times to run each CRC over the buffer when
+ * measuring throughput.
+ */
+# define U_SPARTN_TEST_CRC_SPEED_ITERATIONS 100
+#endif
+
+#ifndef U_SPARTN_TEST_CRC_SPEED_CHECK_SIZE_BYTES
+/** The amount of the buffer to check, at every length, against
+ * a bit-wise CRC: at least twice the largest slice.
+ */
+# define U_SPARTN_TEST_CRC_SPEED_CHECK_SIZE_BYTES 40
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -103,6 +124,20 @@ typedef struct {
     uint32_t result;
 } uSpartnTest_t;
 
+/** Struct to hold what the SPARTN stream callback has seen.
+ */
+typedef struct {
+    size_t numMessages;
+    size_t numBadMessages;
+} uSpartnTestStream_t;
+
+/** Struct to hold what the SPARTN router callback has seen.
+ */
+typedef struct {
+    size_t numMessages;
+    uSpartnHeader_t lastHeader;
+} uSpartnTestRouter_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -183,7 +218,17 @@ static const uSpartnTestCrc_t gCrc32Ccitt = {
  */
 static const uSpartnTestCrc_t *gpTestData[] = {&gCrc4Ccitt, &gCrc8Ccitt, &gCrc16Ccitt, &gCrc32Ccitt};
 
-#ifndef __ZEPHYR__
+/** The sizes of chunk to feed to a SPARTN stream, cycled through.
+ */
+static const size_t gStreamChunkSize[] = {1, 2, 3, 7, 13, 64, 5, 200, 11, 1500, 4};
+
+/** Rubbish to put in front of a SPARTN message when testing a
+ * SPARTN stream, including things that look like the start of
+ * a message header.
+ */
+static const char gStreamRubbish[] = {0x00, 0x73, 0x01, 0x02, 0x03, 0x73, 0x73, 0x55,
+                                      (char) 0xaa, 0x12, 0x34, 0x56, 0x78, 0x73, 0x0f
+                                     };
 
 /** A shortish valid SPARTN message.
  */
@@ -222,8 +267,6 @@ static const char gpSpartnMessage[] = {
     0x8A, 0x27
 };
 
-#endif // __ZEPHYR__
-
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -249,6 +292,68 @@ static crc24 crc_octets(unsigned char *octets, size_t len)
     return crc & 0xFFFFFFL;
 }
 
+// A bit-wise, non-reflected, CRC of up to 32 bits, with no final XOR,
+// to check the table-driven ones against.
+static uint32_t crcBitwise(uint32_t polynomial, size_t widthBits,
+                           uint32_t crc, const char *pData, size_t size)
+{
+    uint32_t topBit = 1UL << (widthBits - 1);
+    uint32_t mask = (topBit << 1) - 1;
+
+    for (size_t x = 0; x < size; x++) {
+        crc ^= ((uint32_t) (uint8_t) pData[x]) << (widthBits - 8);
+        for (size_t y = 0; y < 8; y++) {
+            if ((crc & topBit) != 0) {
+                crc = (crc << 1) ^ polynomial;
+            } else {
+                crc <<= 1;
+            }
+        }
+        crc &= mask;
+    }
+
+    return crc;
+}
+
+// Return the throughput of a CRC in bytes per second, given the
+// time taken to do U_SPARTN_TEST_CRC_SPEED_ITERATIONS.
+static int32_t crcThroughput(int32_t timeMs)
+{
+    if (timeMs <= 0) {
+        timeMs = 1;
+    }
+
+    return (int32_t) ((((int64_t) U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES) *
+                       U_SPARTN_TEST_CRC_SPEED_ITERATIONS * 1000) / timeMs);
+}
+
+// Callback for the SPARTN stream: check that what we were given
+// is a valid message.
+static void streamCallback(const char *pMessage, size_t size,
+                           void *pCallbackParam)
+{
+    uSpartnTestStream_t *pTestStream = (uSpartnTestStream_t *) pCallbackParam;
+    const char *pValidated = NULL;
+
+    if ((uSpartnValidate(pMessage, size, &pValidated) == (int32_t) size) &&
+        (pValidated == pMessage)) {
+        pTestStream->numMessages++;
+    } else {
+        pTestStream->numBadMessages++;
+    }
+}
+
+// Callback for the SPARTN router: count what we were given.
+static void routerCallback(const uSpartnHeader_t *pHeader,
+                           const char *pMessage, void *pCallbackParam)
+{
+    uSpartnTestRouter_t *pTestRouter = (uSpartnTestRouter_t *) pCallbackParam;
+
+    (void) pMessage;
+    pTestRouter->numMessages++;
+    pTestRouter->lastHeader = *pHeader;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -316,6 +421,80 @@ U_PORT_TEST_FUNCTION("[spartn]", "spartnCrc")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Check CRC16, CRC24 and CRC32 at every length up to a few
+ * slices, so that whatever U_SPARTN_CRC_SLICE_BY is set to the
+ * sliced part and the byte-wise remainder are all covered, then
+ * measure their throughput.
+ *
+ * IMPORTANT: see notes in u_cfg_test_platform_specific.h for the
+ * naming rules that must be followed when using the
+ * U_PORT_TEST_FUNCTION() macro.
+ */
+U_PORT_TEST_FUNCTION("[spartn]", "spartnCrcSpeed")
+{
+    int32_t resourceCount;
+    char *pBuffer;
+    int32_t startTimeMs;
+    int32_t timeMs[3];
+    uint32_t crc = 0;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    pBuffer = (char *) pUPortMalloc(U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+    for (size_t x = 0; x < U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES; x++) {
+        *(pBuffer + x) = (char) ((x * 167) + (x >> 3));
+    }
+
+    U_TEST_PRINT_LINE("checking CRCs, U_SPARTN_CRC_SLICE_BY is %d.", U_SPARTN_CRC_SLICE_BY);
+    for (size_t x = 0; x <= U_SPARTN_TEST_CRC_SPEED_CHECK_SIZE_BYTES; x++) {
+        // Start at an odd offset to make sure that alignment doesn't matter
+        U_PORT_TEST_ASSERT(uSpartnCrc16(pBuffer + 1, x) ==
+                           crcBitwise(0x1021, 16, 0, pBuffer + 1, x));
+        U_PORT_TEST_ASSERT(uSpartnCrc24(pBuffer + 1, x) ==
+                           crcBitwise(0x864CFB, 24, 0, pBuffer + 1, x));
+        U_PORT_TEST_ASSERT(uSpartnCrc32(pBuffer + 1, x) ==
+                           (crcBitwise(0x04C11DB7, 32, 0xFFFFFFFF, pBuffer + 1, x) ^ 0xFFFFFFFF));
+    }
+
+    // Measure the throughput; crc is accumulated and printed
+    // so that the compiler can't optimise the calls away
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < U_SPARTN_TEST_CRC_SPEED_ITERATIONS; x++) {
+        crc += uSpartnCrc16(pBuffer, U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES);
+    }
+    timeMs[0] = uPortGetTickTimeMs() - startTimeMs;
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < U_SPARTN_TEST_CRC_SPEED_ITERATIONS; x++) {
+        crc += uSpartnCrc24(pBuffer, U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES);
+    }
+    timeMs[1] = uPortGetTickTimeMs() - startTimeMs;
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < U_SPARTN_TEST_CRC_SPEED_ITERATIONS; x++) {
+        crc += uSpartnCrc32(pBuffer, U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES);
+    }
+    timeMs[2] = uPortGetTickTimeMs() - startTimeMs;
+    U_TEST_PRINT_LINE("%d x %d byte(s) (sum of CRCs 0x%08x): CRC-16 %d ms (%d bytes/s),"
+                      " CRC-24 %d ms (%d bytes/s), CRC-32 %d ms (%d bytes/s).",
+                      U_SPARTN_TEST_CRC_SPEED_ITERATIONS, U_SPARTN_TEST_CRC_SPEED_SIZE_BYTES,
+                      crc, timeMs[0], crcThroughput(timeMs[0]), timeMs[1],
+                      crcThroughput(timeMs[1]), timeMs[2], crcThroughput(timeMs[2]));
+
+    uPortFree(pBuffer);
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 #ifndef __ZEPHYR__
 
 /** Testing of the SPARTN protocol utility functions against
@@ -454,6 +633,188 @@ U_PORT_TEST_FUNCTION("[spartn]", "spartnMessage")
 
 #endif // __ZEPHYR__
 
+/** Test reassembling SPARTN messages from a stream of chunks.
+ */
+U_PORT_TEST_FUNCTION("[spartn]", "spartnStream")
+{
+    int32_t resourceCount;
+    uSpartnStream_t *pStream;
+    uSpartnTestStream_t testStream = {0};
+    size_t offset = 0;
+    size_t numChunks = 0;
+    size_t numMessages = 0;
+    size_t size;
+    int32_t x;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    pStream = (uSpartnStream_t *) pUPortMalloc(sizeof(*pStream));
+    U_PORT_TEST_ASSERT(pStream != NULL);
+
+    U_PORT_TEST_ASSERT(uSpartnStreamInit(pStream, NULL, NULL) < 0);
+    U_PORT_TEST_ASSERT(uSpartnStreamInit(pStream, streamCallback, &testStream) == 0);
+    U_PORT_TEST_ASSERT(uSpartnStreamAdd(pStream, NULL, 1) < 0);
+    U_PORT_TEST_ASSERT(uSpartnStreamAdd(pStream, NULL, 0) == 0);
+
+    // Feed the whole of the test data through in chunks
+    // of varying size
+    U_TEST_PRINT_LINE("testing SPARTN stream.");
+    while (offset < gUSpartnTestDataSize) {
+        size = gStreamChunkSize[numChunks % (sizeof(gStreamChunkSize) /
+                                             sizeof(gStreamChunkSize[0]))];
+        if (size > gUSpartnTestDataSize - offset) {
+            size = gUSpartnTestDataSize - offset;
+        }
+        x = uSpartnStreamAdd(pStream, gUSpartnTestData + offset, size);
+        U_PORT_TEST_ASSERT(x >= 0);
+        numMessages += x;
+        offset += size;
+        numChunks++;
+    }
+    U_TEST_PRINT_LINE("%d message(s) out of %d from %d chunk(s), %d byte(s) discarded.",
+                      testStream.numMessages, gUSpartnTestDataNumMessages, numChunks,
+                      uSpartnStreamGetBytesDiscarded(pStream));
+    U_PORT_TEST_ASSERT(testStream.numMessages == gUSpartnTestDataNumMessages);
+    U_PORT_TEST_ASSERT(testStream.numBadMessages == 0);
+    U_PORT_TEST_ASSERT(numMessages == testStream.numMessages);
+
+    // Rubbish followed by a message delivered a byte at a time
+    testStream.numMessages = 0;
+    U_PORT_TEST_ASSERT(uSpartnStreamInit(pStream, streamCallback, &testStream) == 0);
+    U_PORT_TEST_ASSERT(uSpartnStreamAdd(pStream, gStreamRubbish, sizeof(gStreamRubbish)) == 0);
+    for (size_t y = 0; y < sizeof(gpSpartnMessage); y++) {
+        x = uSpartnStreamAdd(pStream, gpSpartnMessage + y, 1);
+        if (y < sizeof(gpSpartnMessage) - 1) {
+            U_PORT_TEST_ASSERT(x == 0);
+        } else {
+            U_PORT_TEST_ASSERT(x == 1);
+        }
+    }
+    U_PORT_TEST_ASSERT(testStream.numMessages == 1);
+    U_PORT_TEST_ASSERT(uSpartnStreamGetBytesDiscarded(pStream) == sizeof(gStreamRubbish));
+
+    // Reset half way through a message, which should then be lost,
+    // followed by a complete message
+    U_PORT_TEST_ASSERT(uSpartnStreamAdd(pStream, gpSpartnMessage,
+                                        sizeof(gpSpartnMessage) / 2) == 0);
+    uSpartnStreamReset(pStream);
+    U_PORT_TEST_ASSERT(uSpartnStreamAdd(pStream, gpSpartnMessage,
+                                        sizeof(gpSpartnMessage)) == 1);
+    U_PORT_TEST_ASSERT(testStream.numMessages == 2);
+    U_PORT_TEST_ASSERT(uSpartnStreamGetBytesDiscarded(pStream) ==
+                       sizeof(gStreamRubbish) + (sizeof(gpSpartnMessage) / 2));
+    U_PORT_TEST_ASSERT(testStream.numBadMessages == 0);
+
+    uPortFree(pStream);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test decoding SPARTN headers and dropping duplicate messages.
+ */
+U_PORT_TEST_FUNCTION("[spartn]", "spartnRouter")
+{
+    int32_t resourceCount;
+    uSpartnRouter_t *pRouter;
+    uSpartnTestRouter_t testRouter = {0};
+    uSpartnHeader_t header;
+    const char *pData = gUSpartnTestData;
+    size_t size = gUSpartnTestDataSize;
+    const char *pMessage[U_SPARTN_ROUTER_NUM_ENTRIES + 1];
+    size_t messageSize[U_SPARTN_ROUTER_NUM_ENTRIES + 1];
+    size_t numMessages = 0;
+    const char *pTmp;
+    int32_t x;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Decode the header of our shortish message: an HPAC message
+    // (type 1) for Galileo (sub-type 2) with a 32-bit time tag
+    U_PORT_TEST_ASSERT(uSpartnGetHeader(gpSpartnMessage, sizeof(gpSpartnMessage) - 1,
+                                        &header) == (int32_t) U_ERROR_COMMON_TIMEOUT);
+    U_PORT_TEST_ASSERT(uSpartnGetHeader(gpSpartnMessage, sizeof(gpSpartnMessage),
+                                        &header) == sizeof(gpSpartnMessage));
+    U_TEST_PRINT_LINE("message type %d, sub-type %d, time tag %u, CRC 0x%08x.",
+                      header.type, header.subtype, header.timeTag, header.crc);
+    U_PORT_TEST_ASSERT(header.type == 1);
+    U_PORT_TEST_ASSERT(header.subtype == 2);
+    U_PORT_TEST_ASSERT(header.timeTag32);
+    U_PORT_TEST_ASSERT(header.timeTag == 0x17e67a1e);
+    U_PORT_TEST_ASSERT(header.crc == 0xf18a27);
+    U_PORT_TEST_ASSERT(header.size == sizeof(gpSpartnMessage));
+
+    pRouter = (uSpartnRouter_t *) pUPortMalloc(sizeof(*pRouter));
+    U_PORT_TEST_ASSERT(pRouter != NULL);
+    U_PORT_TEST_ASSERT(uSpartnRouterInit(pRouter, NULL, NULL) < 0);
+    U_PORT_TEST_ASSERT(uSpartnRouterInit(pRouter, routerCallback, &testRouter) == 0);
+    // Only a single whole message should be accepted
+    U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, gpSpartnMessage,
+                                        sizeof(gpSpartnMessage) + 1) < 0);
+    U_PORT_TEST_ASSERT(testRouter.numMessages == 0);
+
+    // Give the router each message of the test data twice, as if
+    // from two sources, and check that each is passed on once;
+    // keep the first few for later
+    U_TEST_PRINT_LINE("testing SPARTN router.");
+    for (x = uSpartnValidate(pData, size, &pTmp); x > 0;
+         x = uSpartnValidate(pData, size, &pTmp)) {
+        U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pTmp, x) == 1);
+        U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pTmp, x) == 0);
+        U_PORT_TEST_ASSERT(testRouter.lastHeader.size == (size_t) x);
+        if (numMessages < sizeof(pMessage) / sizeof(pMessage[0])) {
+            pMessage[numMessages] = pTmp;
+            messageSize[numMessages] = x;
+        }
+        numMessages++;
+        size -= pTmp + x - pData;
+        pData = pTmp + x;
+    }
+    U_TEST_PRINT_LINE("%d message(s) out of %d passed on, %d duplicate(s) dropped.",
+                      testRouter.numMessages, gUSpartnTestDataNumMessages,
+                      uSpartnRouterGetNumDuplicates(pRouter));
+    U_PORT_TEST_ASSERT(numMessages == gUSpartnTestDataNumMessages);
+    U_PORT_TEST_ASSERT(testRouter.numMessages == gUSpartnTestDataNumMessages);
+    U_PORT_TEST_ASSERT(uSpartnRouterGetNumDuplicates(pRouter) == gUSpartnTestDataNumMessages);
+    U_PORT_TEST_ASSERT(numMessages > U_SPARTN_ROUTER_NUM_ENTRIES);
+
+    // Start again and check that the least recently seen message
+    // is the one forgotten
+    testRouter.numMessages = 0;
+    U_PORT_TEST_ASSERT(uSpartnRouterInit(pRouter, routerCallback, &testRouter) == 0);
+    for (size_t y = 0; y < U_SPARTN_ROUTER_NUM_ENTRIES; y++) {
+        U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pMessage[y], messageSize[y]) == 1);
+    }
+    // Refresh message 0, making message 1 the oldest
+    U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pMessage[0], messageSize[0]) == 0);
+    // Push message 1 off the end
+    U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pMessage[U_SPARTN_ROUTER_NUM_ENTRIES],
+                                        messageSize[U_SPARTN_ROUTER_NUM_ENTRIES]) == 1);
+    U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pMessage[0], messageSize[0]) == 0);
+    U_PORT_TEST_ASSERT(uSpartnRouterAdd(pRouter, pMessage[1], messageSize[1]) == 1);
+    U_PORT_TEST_ASSERT(testRouter.numMessages == U_SPARTN_ROUTER_NUM_ENTRIES + 2);
+    U_PORT_TEST_ASSERT(uSpartnRouterGetNumDuplicates(pRouter) == 2);
+
+    uPortFree(pRouter);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
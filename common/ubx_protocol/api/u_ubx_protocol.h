@@ -56,6 +56,60 @@ extern "C" {
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The state of a streamed UBX protocol message encode, see
+ * uUbxProtocolEncodeStart(); the contents are internal, please
+ * use the streamed encode functions to get to them.
+ */
+typedef struct {
+    uint32_t ca;                   /**< checksum A, only the bottom
+                                        eight bits are relevant. */
+    uint32_t cb;                   /**< checksum B, only the bottom
+                                        eight bits are relevant. */
+    size_t bodyLengthBytes;        /**< the length of body expected. */
+    size_t bodyLengthBytesAdded;   /**< the length of body so far. */
+} uUbxProtocolEncoder_t;
+
+/** The callback that is called by uUbxProtocolDecoderFeed() with
+ * each complete UBX protocol message that has a good checksum.
+ *
+ * @param messageClass        the UBX protocol message class.
+ * @param messageId           the UBX protocol message ID.
+ * @param[in] pBody           the message body, i.e. the pBuffer that
+ *                            was passed to uUbxProtocolDecoderInit();
+ *                            NULL if that was NULL.
+ * @param bodyLengthBytes     the length of the message body; this may
+ *                            be larger than the bufferSize that was
+ *                            passed to uUbxProtocolDecoderInit(), though
+ *                            only a maximum of bufferSize bytes will be
+ *                            at pBody.
+ * @param[in] pCallbackParam  the pCallbackParam that was passed to
+ *                            uUbxProtocolDecoderInit().
+ */
+typedef void (uUbxProtocolDecoderCallback_t)(int32_t messageClass, int32_t messageId,
+                                             const char *pBody, size_t bodyLengthBytes,
+                                             void *pCallbackParam);
+
+/** The state of a UBX protocol decoder, see uUbxProtocolDecoderInit();
+ * the contents are internal, please use the decoder functions to
+ * get to them.
+ */
+typedef struct {
+    uUbxProtocolDecoderCallback_t *pCallback;
+    void *pCallbackParam;
+    char *pBuffer;                   /**< where to put the message body. */
+    size_t bufferSize;               /**< the amount of storage at pBuffer. */
+    int32_t overheadByteCount;       /**< how far through the header and
+                                          checksum we are. */
+    int32_t messageClass;
+    int32_t messageId;
+    size_t expectedMessageByteCount; /**< the length of the body. */
+    size_t messageByteCount;         /**< the length of body so far. */
+    uint32_t ca;                     /**< checksum A, only the bottom
+                                          eight bits are relevant. */
+    uint32_t cb;                     /**< checksum B, only the bottom
+                                          eight bits are relevant. */
+} uUbxProtocolDecoder_t;
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -151,6 +205,65 @@ int32_t uUbxProtocolEncode(int32_t messageClass, int32_t messageId,
                            const char *pMessageBody, size_t messageBodyLengthBytes,
                            char *pBuffer);
 
+/** Begin a streamed encode of a UBX protocol message, for when the
+ * body is not all in one place, e.g. a large MGA or VALSET message
+ * that is being composed a piece at a time: this writes the
+ * #U_UBX_PROTOCOL_HEADER_LENGTH_BYTES of header to pBuffer, to be
+ * followed by calls to uUbxProtocolEncodeAdd() with each piece of the
+ * body and then a call to uUbxProtocolEncodeFinish() to write the
+ * two-byte checksum.  The header, the pieces of body and the checksum
+ * may be sent as they become available, no buffer large enough for
+ * the whole message is required.
+ *
+ * @param[out] pEncoder           a place to keep the state of the
+ *                                encode; cannot be NULL.
+ * @param messageClass            the UBX protocol message class.
+ * @param messageId               the UBX protocol message ID.
+ * @param messageBodyLengthBytes  the total length of the message body
+ *                                that will be passed to
+ *                                uUbxProtocolEncodeAdd().
+ * @param[out] pBuffer            a place to write the header; must be
+ *                                at least
+ *                                #U_UBX_PROTOCOL_HEADER_LENGTH_BYTES
+ *                                long.
+ * @return                        on success the number of bytes written
+ *                                to pBuffer, else negative error code.
+ */
+int32_t uUbxProtocolEncodeStart(uUbxProtocolEncoder_t *pEncoder,
+                                int32_t messageClass, int32_t messageId,
+                                size_t messageBodyLengthBytes, char *pBuffer);
+
+/** Add a piece of message body to a streamed encode begun with
+ * uUbxProtocolEncodeStart(); the body is not copied, it is only
+ * included in the checksum, the caller sends it.
+ *
+ * @param[in] pEncoder  the state of the encode, as passed to
+ *                      uUbxProtocolEncodeStart(); cannot be NULL.
+ * @param[in] pBody     the piece of message body; may be NULL only
+ *                      if size is zero.
+ * @param size          the length of pBody.
+ * @return              on success the total length of message body
+ *                      added so far, else negative error code, e.g.
+ *                      if more body is added than was given to
+ *                      uUbxProtocolEncodeStart().
+ */
+int32_t uUbxProtocolEncodeAdd(uUbxProtocolEncoder_t *pEncoder,
+                              const char *pBody, size_t size);
+
+/** Complete a streamed encode, writing the two-byte checksum that
+ * must follow the message body.
+ *
+ * @param[in] pEncoder  the state of the encode, as passed to
+ *                      uUbxProtocolEncodeStart(); cannot be NULL.
+ * @param[out] pBuffer  a place to write the checksum, must be at
+ *                      least two bytes long.
+ * @return              on success the number of bytes written to
+ *                      pBuffer, else negative error code, e.g. if
+ *                      not all of the message body has been added.
+ */
+int32_t uUbxProtocolEncodeFinish(uUbxProtocolEncoder_t *pEncoder,
+                                 char *pBuffer);
+
 /** Decode a UBX protocol message.  Call this function with a buffer
  * and it will return the first valid UBX format message it finds
  * in the buffer. ppBufferOut will be set to the first position in
@@ -229,6 +342,62 @@ int32_t uUbxProtocolDecode(const char *pBufferIn, size_t bufferLengthBytes,
                            char *pMessageBody, size_t maxMessageBodyLengthBytes,
                            const char **ppBufferOut);
 
+/** Initialise a UBX protocol decoder: unlike uUbxProtocolDecode(), which
+ * must be given a whole message at once, a decoder can be fed a stream
+ * of data in chunks of any size with uUbxProtocolDecoderFeed(); a message
+ * may be split across any number of chunks and each byte is looked at
+ * only once.  This is useful for an application that is consuming the
+ * raw stream from a GNSS chip, e.g. data read directly from its UART
+ * or from a log file of its output, where the reads do not fall on
+ * message boundaries.
+ *
+ * These functions are not thread-safe: if you feed a decoder from
+ * more than one task, protect it with a mutex of your own.
+ *
+ * @param[out] pDecoder      a place to keep the state of the decoder;
+ *                           cannot be NULL.
+ * @param[in] pBuffer        storage for the body of a message while it
+ *                           is being decoded; may be NULL if the message
+ *                           bodies are not of interest, in which case
+ *                           bufferSize must be zero.
+ * @param bufferSize         the amount of storage at pBuffer; message
+ *                           bodies beyond this length are truncated.
+ * @param[in] pCallback      the callback to be called with each message;
+ *                           cannot be NULL.
+ * @param[in] pCallbackParam a parameter that will be passed to pCallback;
+ *                           may be NULL.
+ * @return                   zero on success else negative error code.
+ */
+int32_t uUbxProtocolDecoderInit(uUbxProtocolDecoder_t *pDecoder,
+                                char *pBuffer, size_t bufferSize,
+                                uUbxProtocolDecoderCallback_t *pCallback,
+                                void *pCallbackParam);
+
+/** Feed data to a UBX protocol decoder; pCallback, as passed to
+ * uUbxProtocolDecoderInit(), is called from within this function with
+ * each message that the data completes, as soon as its checksum has
+ * been verified.  Any part-message at the end of the data is kept;
+ * the next call to this function carries on from there.
+ *
+ * @param[in] pDecoder  the decoder, as passed to
+ *                      uUbxProtocolDecoderInit(); cannot be NULL.
+ * @param[in] pData     the data; may be NULL only if size is zero.
+ * @param size          the number of bytes at pData.
+ * @return              on success the number of messages passed to
+ *                      pCallback during this call, else negative
+ *                      error code.
+ */
+int32_t uUbxProtocolDecoderFeed(uUbxProtocolDecoder_t *pDecoder,
+                                const char *pData, size_t size);
+
+/** Reset a UBX protocol decoder, throwing away any part-message that
+ * it holds, e.g. because the data source has been interrupted.
+ *
+ * @param[in] pDecoder  the decoder, as passed to
+ *                      uUbxProtocolDecoderInit(); cannot be NULL.
+ */
+void uUbxProtocolDecoderReset(uUbxProtocolDecoder_t *pDecoder);
+
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +53,172 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Update the UBX protocol (8-bit Fletcher) checksum over a block of
+// data.  Only the bottom eight bits of ca and cb matter, and these
+// are unaffected by wrap, hence neither need ever be reduced; this
+// allows four bytes to be taken at a time, since four steps of
+// ca += b, cb += ca amount to:
+//
+// cb += (4 * ca) + (4 * b0) + (3 * b1) + (2 * b2) + b3
+// ca += b0 + b1 + b2 + b3
+//
+// ...which breaks up the dependency of each step on the last.
+static void checksumUpdate(const uint8_t *pData, size_t size,
+                           uint32_t *pCa, uint32_t *pCb)
+{
+    uint32_t ca = *pCa;
+    uint32_t cb = *pCb;
+    uint32_t b0;
+    uint32_t b1;
+    uint32_t b2;
+    uint32_t b3;
+
+    while (size >= 4) {
+        b0 = *pData;
+        b1 = *(pData + 1);
+        b2 = *(pData + 2);
+        b3 = *(pData + 3);
+        cb += (ca << 2) + (b0 << 2) + (b1 * 3) + (b2 << 1) + b3;
+        ca += b0 + b1 + b2 + b3;
+        pData += 4;
+        size -= 4;
+    }
+    while (size > 0) {
+        ca += *pData;
+        cb += ca;
+        pData++;
+        size--;
+    }
+
+    *pCa = ca;
+    *pCb = cb;
+}
+
+// Run the UBX protocol decode state machine in pDecoder over the
+// given data, stopping when a complete message with a good checksum
+// has been decoded, returning the number of bytes consumed.  A
+// message body is written to pDecoder->pBuffer, up to a maximum of
+// pDecoder->bufferSize bytes.
+static size_t decodeStep(uUbxProtocolDecoder_t *pDecoder,
+                         const uint8_t *pInput, size_t size)
+{
+    size_t x = 0;
+    bool updateCrc = false;
+    size_t count;
+    size_t copyCount;
+
+    while ((x < size) &&
+           (pDecoder->overheadByteCount < U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES)) {
+        count = 1;
+        switch (pDecoder->overheadByteCount) {
+            case 0:
+                //lint -e{650} Suppress warning about 0xb5 being out of range for char
+                if (*pInput == 0xb5) {
+                    // Got first byte of header, increment count
+                    pDecoder->overheadByteCount++;
+                }
+                break;
+            case 1:
+                if (*pInput == 0x62) {
+                    // Got second byte of header, increment count
+                    pDecoder->overheadByteCount++;
+                } else if (*pInput != 0xb5) {
+                    // Not a valid message, start again
+                    pDecoder->overheadByteCount = 0;
+                }
+                break;
+            case 2:
+                // Got message class, store it, start CRC
+                // calculation and increment count
+                pDecoder->messageClass = *pInput;
+                pDecoder->ca = 0;
+                pDecoder->cb = 0;
+                updateCrc = true;
+                pDecoder->overheadByteCount++;
+                break;
+            case 3:
+                // Got message ID, store it, update CRC and
+                // increment count
+                pDecoder->messageId = *pInput;
+                updateCrc = true;
+                pDecoder->overheadByteCount++;
+                break;
+            case 4:
+                // Got first byte of length, store it, update
+                // CRC and increment count
+                pDecoder->expectedMessageByteCount = *pInput;
+                updateCrc = true;
+                pDecoder->overheadByteCount++;
+                break;
+            case 5:
+                // Got second byte of length, add it to the first,
+                // update CRC, increment count and reset the
+                // message byte count ready for the body to come next.
+                // Cast twice to keep Lint happy
+                pDecoder->expectedMessageByteCount += ((size_t) *pInput) << 8; // *NOPAD*
+                pDecoder->messageByteCount = 0;
+                updateCrc = true;
+                pDecoder->overheadByteCount++;
+                break;
+            case 6:
+                if (pDecoder->messageByteCount < pDecoder->expectedMessageByteCount) {
+                    // Take as much of the body as there is in the
+                    // buffer in one go, storing it and updating the CRC;
+                    // memmove() since it is permitted to decode back
+                    // into the input buffer
+                    count = pDecoder->expectedMessageByteCount - pDecoder->messageByteCount;
+                    if (count > size - x) {
+                        count = size - x;
+                    }
+                    if ((pDecoder->pBuffer != NULL) &&
+                        (pDecoder->messageByteCount < pDecoder->bufferSize)) {
+                        copyCount = pDecoder->bufferSize - pDecoder->messageByteCount;
+                        if (copyCount > count) {
+                            copyCount = count;
+                        }
+                        memmove(pDecoder->pBuffer + pDecoder->messageByteCount,
+                                pInput, copyCount);
+                    }
+                    checksumUpdate(pInput, count, &(pDecoder->ca), &(pDecoder->cb));
+                    pDecoder->messageByteCount += count;
+                } else {
+                    // First byte of CRC, check it
+                    if ((uint8_t) (pDecoder->ca & 0xff) == *pInput) {
+                        pDecoder->overheadByteCount++;
+                    } else {
+                        // Not a valid message, start again
+                        pDecoder->overheadByteCount = 0;
+                    }
+                }
+                break;
+            case 7:
+                // Second byte of CRC, check it
+                if ((uint8_t) (pDecoder->cb & 0xff) == *pInput) {
+                    pDecoder->overheadByteCount++;
+                } else {
+                    // Not a valid message, start again
+                    pDecoder->overheadByteCount = 0;
+                }
+                break;
+            default:
+                pDecoder->overheadByteCount = 0;
+                break;
+        }
+
+        if (updateCrc) {
+            pDecoder->ca += *pInput;
+            pDecoder->cb += pDecoder->ca;
+            updateCrc = false;
+        }
+
+        // Next byte(s)
+        pInput += count;
+        x += count;
+    }
+
+    return x;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -168,42 +334,89 @@ int32_t uUbxProtocolEncode(int32_t messageClass, int32_t messageId,
                            char *pBuffer)
 {
     int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-    // Use a uint8_t pointer for maths, more certain of its behaviour than char
-    uint8_t *pWrite = (uint8_t *) pBuffer;
-    int32_t ca = 0;
-    int32_t cb = 0;
+    uUbxProtocolEncoder_t encoder;
 
     if (((messageBodyLengthBytes == 0) || (pMessage != NULL)) &&
-        (pBuffer != NULL)) {
+        (pBuffer != NULL) &&
+        (uUbxProtocolEncodeStart(&encoder, messageClass, messageId,
+                                 messageBodyLengthBytes, pBuffer) >= 0)) {
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        if (pMessage != NULL) {
+            // Copy in the message body
+            memcpy(pBuffer, pMessage, messageBodyLengthBytes);
+            uUbxProtocolEncodeAdd(&encoder, pMessage, messageBodyLengthBytes);
+            pBuffer += messageBodyLengthBytes;
+        }
+        // Write in the CRC
+        if (uUbxProtocolEncodeFinish(&encoder, pBuffer) >= 0) {
+            errorCodeOrLength = (int32_t) (U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES + messageBodyLengthBytes);
+        }
+    }
+
+    return errorCodeOrLength;
+}
 
+// Begin a streamed encode of a UBX protocol message.
+int32_t uUbxProtocolEncodeStart(uUbxProtocolEncoder_t *pEncoder,
+                                int32_t messageClass, int32_t messageId,
+                                size_t messageBodyLengthBytes, char *pBuffer)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    // Use a uint8_t pointer for maths, more certain of its behaviour than char
+    uint8_t *pWrite = (uint8_t *) pBuffer;
+
+    if ((pEncoder != NULL) && (pBuffer != NULL) && (messageBodyLengthBytes <= 0xffff)) {
         // Complete the header
         *pWrite++ = 0xb5;
         *pWrite++ = 0x62;
         *pWrite++ = (uint8_t) messageClass;
         *pWrite++ = (uint8_t) messageId;
         *pWrite++ = (uint8_t) (messageBodyLengthBytes & (uint8_t) 0xff);
-        *pWrite++ = (uint8_t) (messageBodyLengthBytes >> 8);
+        *pWrite = (uint8_t) (messageBodyLengthBytes >> 8);
 
-        if (pMessage != NULL) {
-            // Copy in the message body
-            memcpy(pWrite, pMessage, messageBodyLengthBytes);
-            pWrite += messageBodyLengthBytes;
-        }
+        // The CRC starts with the variable elements of the header
+        pEncoder->ca = 0;
+        pEncoder->cb = 0;
+        checksumUpdate(((const uint8_t *) pBuffer) + 2, U_UBX_PROTOCOL_HEADER_LENGTH_BYTES - 2,
+                       &(pEncoder->ca), &(pEncoder->cb));
+        pEncoder->bodyLengthBytes = messageBodyLengthBytes;
+        pEncoder->bodyLengthBytesAdded = 0;
 
-        // Work out the CRC over the variable elements of the
-        // header and the body
-        pBuffer += 2;
-        for (size_t x = 0; x < messageBodyLengthBytes + 4; x++) {
-            ca += (uint8_t) *pBuffer; // *NOPAD*
-            cb += ca;
-            pBuffer++;
-        }
+        errorCodeOrLength = U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+    }
 
-        // Write in the CRC
-        *pWrite++ = (uint8_t) (ca & (uint8_t) 0xff);
-        *pWrite = (uint8_t) (cb & (uint8_t) 0xff);
+    return errorCodeOrLength;
+}
+
+// Add a piece of message body to a streamed encode.
+int32_t uUbxProtocolEncodeAdd(uUbxProtocolEncoder_t *pEncoder,
+                              const char *pBody, size_t size)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
 
-        errorCodeOrLength = (int32_t) (U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES + messageBodyLengthBytes);
+    if ((pEncoder != NULL) && ((pBody != NULL) || (size == 0)) &&
+        (size <= pEncoder->bodyLengthBytes - pEncoder->bodyLengthBytesAdded)) {
+        checksumUpdate((const uint8_t *) pBody, size, &(pEncoder->ca), &(pEncoder->cb));
+        pEncoder->bodyLengthBytesAdded += size;
+        errorCodeOrLength = (int32_t) pEncoder->bodyLengthBytesAdded;
+    }
+
+    return errorCodeOrLength;
+}
+
+// Complete a streamed encode of a UBX protocol message.
+int32_t uUbxProtocolEncodeFinish(uUbxProtocolEncoder_t *pEncoder,
+                                 char *pBuffer)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    // Use a uint8_t pointer for maths, more certain of its behaviour than char
+    uint8_t *pWrite = (uint8_t *) pBuffer;
+
+    if ((pEncoder != NULL) && (pBuffer != NULL) &&
+        (pEncoder->bodyLengthBytesAdded == pEncoder->bodyLengthBytes)) {
+        *pWrite++ = (uint8_t) (pEncoder->ca & (uint8_t) 0xff);
+        *pWrite = (uint8_t) (pEncoder->cb & (uint8_t) 0xff);
+        errorCodeOrLength = 2;
     }
 
     return errorCodeOrLength;
@@ -216,131 +429,93 @@ int32_t uUbxProtocolDecode(const char *pBufferIn, size_t bufferLengthBytes,
                            const char **ppBufferOut)
 {
     int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
-    // Use a uint8_t pointer for maths, more certain of its behaviour than char
-    const uint8_t *pInput = (const uint8_t *) pBufferIn;
-    int32_t overheadByteCount = 0;
-    bool updateCrc = false;
-    size_t expectedMessageByteCount = 0;
-    size_t messageByteCount = 0;
-    int32_t ca = 0;
-    int32_t cb = 0;
-
-    for (size_t x = 0; (x < bufferLengthBytes) &&
-         (overheadByteCount < U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES); x++) {
-        switch (overheadByteCount) {
-            case 0:
-                //lint -e{650} Suppress warning about 0xb5 being out of range for char
-                if (*pInput == 0xb5) {
-                    // Got first byte of header, increment count
-                    overheadByteCount++;
-                }
-                break;
-            case 1:
-                if (*pInput == 0x62) {
-                    // Got second byte of header, increment count
-                    overheadByteCount++;
-                } else {
-                    // Not a valid message, start again
-                    overheadByteCount = 0;
-                }
-                break;
-            case 2:
-                // Got message class, store it, start CRC
-                // calculation and increment count
-                if (pMessageClass != NULL) {
-                    *pMessageClass = *pInput;
-                }
-                ca = 0;
-                cb = 0;
-                updateCrc = true;
-                overheadByteCount++;
-                break;
-            case 3:
-                // Got message ID, store it, update CRC and
-                // increment count
-                if (pMessageId != NULL) {
-                    *pMessageId = *pInput;
-                }
-                updateCrc = true;
-                overheadByteCount++;
-                break;
-            case 4:
-                // Got first byte of length, store it, update
-                // CRC and increment count
-                expectedMessageByteCount = *pInput;
-                updateCrc = true;
-                overheadByteCount++;
-                break;
-            case 5:
-                // Got second byte of length, add it to the first,
-                // updat CRC, increment count and reset the
-                // message byte count ready for the body to come next.
-                // Cast twice to keep Lint happy
-                expectedMessageByteCount += ((size_t) *pInput) << 8; // *NOPAD*
-                messageByteCount = 0;
-                updateCrc = true;
-                overheadByteCount++;
-                break;
-            case 6:
-                if (messageByteCount < expectedMessageByteCount) {
-                    // Store the next byte of the message and
-                    // update CRC
-                    if ((pMessage != NULL) && (messageByteCount < maxMessageLengthBytes)) {
-                        *pMessage++ = (char) *pInput; // *NOPAD*
-                    }
-                    updateCrc = true;
-                    messageByteCount++;
-                } else {
-                    // First byte of CRC, check it
-                    ca &= 0xff;
-                    if ((uint8_t) ca == *pInput) {
-                        overheadByteCount++;
-                    } else {
-                        // Not a valid message, start again
-                        overheadByteCount = 0;
-                    }
-                }
-                break;
-            case 7:
-                // Second byte of CRC, check it
-                cb &= 0xff;
-                if ((uint8_t) cb == *pInput) {
-                    overheadByteCount++;
-                } else {
-                    // Not a valid message, start again
-                    overheadByteCount = 0;
-                }
-                break;
-            default:
-                overheadByteCount = 0;
-                break;
-        }
-
-        if (updateCrc) {
-            ca += *pInput;
-            cb += ca;
-            updateCrc = false;
-        }
+    uUbxProtocolDecoder_t decoder = {0};
+    size_t count = 0;
 
-        // Next byte
-        pInput++;
+    decoder.pBuffer = pMessage;
+    decoder.bufferSize = maxMessageLengthBytes;
+    if (pBufferIn != NULL) {
+        count = decodeStep(&decoder, (const uint8_t *) pBufferIn, bufferLengthBytes);
     }
 
-    if (overheadByteCount > 0) {
+    if (decoder.overheadByteCount > 0) {
         // We got some parts of the message overhead, so
         // could be a message
         sizeOrErrorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
-        if (overheadByteCount == U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) {
+        if (decoder.overheadByteCount == U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) {
             // We got all the overhead bytes, this is a complete message
-            sizeOrErrorCode = (int32_t) messageByteCount;
+            sizeOrErrorCode = (int32_t) decoder.messageByteCount;
+        }
+        if ((decoder.overheadByteCount > 2) && (pMessageClass != NULL)) {
+            *pMessageClass = decoder.messageClass;
+        }
+        if ((decoder.overheadByteCount > 3) && (pMessageId != NULL)) {
+            *pMessageId = decoder.messageId;
         }
     }
 
     if (ppBufferOut != NULL) {
-        *ppBufferOut =  (const char *) pInput;
+        *ppBufferOut = pBufferIn + count;
     }
 
     return sizeOrErrorCode;
 }
 
+// Initialise a UBX protocol decoder.
+int32_t uUbxProtocolDecoderInit(uUbxProtocolDecoder_t *pDecoder,
+                                char *pBuffer, size_t bufferSize,
+                                uUbxProtocolDecoderCallback_t *pCallback,
+                                void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pDecoder != NULL) && (pCallback != NULL) &&
+        ((pBuffer != NULL) || (bufferSize == 0))) {
+        memset(pDecoder, 0, sizeof(*pDecoder));
+        pDecoder->pBuffer = pBuffer;
+        pDecoder->bufferSize = bufferSize;
+        pDecoder->pCallback = pCallback;
+        pDecoder->pCallbackParam = pCallbackParam;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Feed data to a UBX protocol decoder.
+int32_t uUbxProtocolDecoderFeed(uUbxProtocolDecoder_t *pDecoder,
+                                const char *pData, size_t size)
+{
+    int32_t errorCodeOrNumMessages = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    size_t count;
+
+    if ((pDecoder != NULL) && (pDecoder->pCallback != NULL) &&
+        ((pData != NULL) || (size == 0))) {
+        errorCodeOrNumMessages = 0;
+        while (size > 0) {
+            count = decodeStep(pDecoder, (const uint8_t *) pData, size);
+            pData += count;
+            size -= count;
+            if (pDecoder->overheadByteCount == U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) {
+                // Got a whole message with a good checksum
+                pDecoder->pCallback(pDecoder->messageClass, pDecoder->messageId,
+                                    pDecoder->pBuffer, pDecoder->messageByteCount,
+                                    pDecoder->pCallbackParam);
+                errorCodeOrNumMessages++;
+                pDecoder->overheadByteCount = 0;
+            }
+        }
+    }
+
+    return errorCodeOrNumMessages;
+}
+
+// Reset a UBX protocol decoder.
+void uUbxProtocolDecoderReset(uUbxProtocolDecoder_t *pDecoder)
+{
+    if (pDecoder != NULL) {
+        pDecoder->overheadByteCount = 0;
+    }
+}
+
 // End of file
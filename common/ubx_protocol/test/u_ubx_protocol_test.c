@@ -68,10 +68,30 @@
 # define U_UBX_PROTOCOL_TEST_MAX_BODY_SIZE 1024
 #endif
 
+#ifndef U_UBX_PROTOCOL_TEST_DECODER_NUM_MESSAGES
+/** The number of messages to feed to the UBX protocol decoder.
+ */
+# define U_UBX_PROTOCOL_TEST_DECODER_NUM_MESSAGES 20
+#endif
+
+#ifndef U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE
+/** The size of body buffer to give the UBX protocol decoder, smaller
+ * than some of the messages so that truncation is tested.
+ */
+# define U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE 64
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Struct to track what the UBX protocol decoder callback has seen.
+ */
+typedef struct {
+    size_t numMessages;
+    size_t numErrors;
+} uUbxProtocolTestDecoder_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -80,6 +100,50 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// The UBX protocol checksum done the obvious way, a byte at a time,
+// as a reference: returns checksum A in the low byte and checksum B
+// in the high byte.
+static uint16_t checksumReference(const char *pData, size_t size)
+{
+    uint8_t ca = 0;
+    uint8_t cb = 0;
+
+    for (size_t x = 0; x < size; x++) {
+        ca = (uint8_t) (ca + (uint8_t) *(pData + x));
+        cb = (uint8_t) (cb + ca);
+    }
+
+    return (uint16_t) (((uint16_t) cb << 8) | ca);
+}
+
+// The body length of test message n for the decoder.
+static size_t decoderTestBodyLength(size_t n)
+{
+    return (n * 37) % (U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE * 2);
+}
+
+// Callback for the UBX protocol decoder: check that message n is
+// what was encoded.
+static void decoderCallback(int32_t messageClass, int32_t messageId,
+                            const char *pBody, size_t bodyLengthBytes,
+                            void *pCallbackParam)
+{
+    uUbxProtocolTestDecoder_t *pTestDecoder = (uUbxProtocolTestDecoder_t *) pCallbackParam;
+    size_t n = pTestDecoder->numMessages;
+
+    if ((messageClass != (int32_t) n) || (messageId != (int32_t) (0xff - n)) ||
+        (bodyLengthBytes != decoderTestBodyLength(n))) {
+        pTestDecoder->numErrors++;
+    }
+    for (size_t x = 0; (x < bodyLengthBytes) &&
+         (x < U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE); x++) {
+        if (*(pBody + x) != (char) (x + n)) {
+            pTestDecoder->numErrors++;
+        }
+    }
+    pTestDecoder->numMessages++;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -172,6 +236,173 @@ U_PORT_TEST_FUNCTION("[ubxProtocol]", "ubxProtocolBackToBack")
     uPortFree(pBuffer);
 }
 
+/** Test of the streamed UBX protocol encoder.
+ */
+U_PORT_TEST_FUNCTION("[ubxProtocol]", "ubxProtocolEncodeStream")
+{
+    uUbxProtocolEncoder_t encoder;
+    char *pBody;
+    char *pBuffer;
+    char *pStreamed;
+    size_t length;
+    size_t offset;
+    size_t chunkSize;
+    uint16_t checksum;
+
+    pBody = (char *) pUPortMalloc(U_UBX_PROTOCOL_TEST_MAX_BODY_SIZE);
+    U_PORT_TEST_ASSERT(pBody != NULL);
+    pBuffer = (char *) pUPortMalloc(U_UBX_PROTOCOL_TEST_MAX_BODY_SIZE +
+                                    U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+    pStreamed = (char *) pUPortMalloc(U_UBX_PROTOCOL_TEST_MAX_BODY_SIZE +
+                                      U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(pStreamed != NULL);
+
+    for (size_t x = 0; x < U_UBX_PROTOCOL_TEST_MAX_BODY_SIZE; x += 7) {
+        // Put something in the body that will wrap the checksums
+        for (size_t y = 0; y < x; y++) {
+            *(pBody + y) = (char) (0xff - (y * 13));
+        }
+        length = x + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES;
+        U_PORT_TEST_ASSERT(uUbxProtocolEncode(0x13, 0x40, pBody, x, pBuffer) == (int32_t) length);
+        // Check the checksum against the byte-at-a-time reference
+        checksum = checksumReference(pBuffer + 2, x + 4);
+        U_PORT_TEST_ASSERT(*(pBuffer + length - 2) == (char) checksum);
+        U_PORT_TEST_ASSERT(*(pBuffer + length - 1) == (char) (checksum >> 8));
+
+        // Do the same encode streamed, in chunks of varying size, the
+        // body pieces being copied in here as a caller would send them
+        memset(pStreamed, 0, length);
+        U_PORT_TEST_ASSERT(uUbxProtocolEncodeStart(&encoder, 0x13, 0x40, x,
+                                                   pStreamed) == U_UBX_PROTOCOL_HEADER_LENGTH_BYTES);
+        if (x > 0) {
+            // Not all added yet, so finishing must fail
+            U_PORT_TEST_ASSERT(uUbxProtocolEncodeFinish(&encoder, pStreamed) < 0);
+        }
+        offset = 0;
+        chunkSize = 1;
+        while (offset < x) {
+            if (chunkSize > x - offset) {
+                chunkSize = x - offset;
+            }
+            memcpy(pStreamed + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + offset,
+                   pBody + offset, chunkSize);
+            offset += chunkSize;
+            U_PORT_TEST_ASSERT(uUbxProtocolEncodeAdd(&encoder, pBody + offset - chunkSize,
+                                                     chunkSize) == (int32_t) offset);
+            chunkSize = (chunkSize % 13) + 1;
+        }
+        // Adding more than was said should fail
+        U_PORT_TEST_ASSERT(uUbxProtocolEncodeAdd(&encoder, pBody, 1) < 0);
+        U_PORT_TEST_ASSERT(uUbxProtocolEncodeFinish(&encoder,
+                                                    pStreamed + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + x) == 2);
+        U_PORT_TEST_ASSERT(memcmp(pStreamed, pBuffer, length) == 0);
+
+        // A message with its last byte missing is a partial message
+        U_PORT_TEST_ASSERT(uUbxProtocolDecode(pBuffer, length - 1, NULL, NULL,
+                                              NULL, 0, NULL) == (int32_t) U_ERROR_COMMON_TIMEOUT);
+        // ...and with a storage buffer smaller than the body the
+        // message should still be found
+        U_PORT_TEST_ASSERT(uUbxProtocolDecode(pBuffer, length, NULL, NULL,
+                                              pStreamed, x / 2, NULL) == (int32_t) x);
+        U_PORT_TEST_ASSERT(memcmp(pStreamed, pBody, x / 2) == 0);
+    }
+
+    // Free memory
+    uPortFree(pBody);
+    uPortFree(pBuffer);
+    uPortFree(pStreamed);
+}
+
+/** Test of the resumable UBX protocol decoder.
+ */
+U_PORT_TEST_FUNCTION("[ubxProtocol]", "ubxProtocolDecoder")
+{
+    uUbxProtocolDecoder_t decoder;
+    uUbxProtocolTestDecoder_t testDecoder = {0};
+    char *pBody;
+    char *pStream;
+    char bodyBuffer[U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE];
+    size_t streamLength = 0;
+    size_t length;
+    size_t offset = 0;
+    size_t chunkSize = 1;
+    size_t numMessages = 0;
+    int32_t x;
+
+    pBody = (char *) pUPortMalloc(U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE * 2);
+    U_PORT_TEST_ASSERT(pBody != NULL);
+    pStream = (char *) pUPortMalloc(U_UBX_PROTOCOL_TEST_DECODER_NUM_MESSAGES *
+                                    ((U_UBX_PROTOCOL_TEST_DECODER_BUFFER_SIZE * 2) +
+                                     U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES + 3));
+    U_PORT_TEST_ASSERT(pStream != NULL);
+
+    // Assemble a stream of messages with some rubbish, which includes
+    // things that look like the start of a header, between them; the
+    // rubbish can't include 0xb5 0x62 as this would be taken as a
+    // message header and the message following it lost
+    for (size_t n = 0; n < U_UBX_PROTOCOL_TEST_DECODER_NUM_MESSAGES; n++) {
+        length = decoderTestBodyLength(n);
+        for (size_t y = 0; y < length; y++) {
+            *(pBody + y) = (char) (y + n);
+        }
+        x = uUbxProtocolEncode((int32_t) n, (int32_t) (0xff - n), pBody, length,
+                               pStream + streamLength);
+        U_PORT_TEST_ASSERT(x == (int32_t) (length + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES));
+        streamLength += x;
+        *(pStream + streamLength) = (char) 0xb5;
+        streamLength++;
+        if (n % 2) {
+            *(pStream + streamLength) = (char) n;
+            streamLength++;
+            *(pStream + streamLength) = (char) 0xb5;
+            streamLength++;
+        }
+    }
+
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderInit(&decoder, NULL, 1, decoderCallback,
+                                               &testDecoder) < 0);
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderInit(&decoder, bodyBuffer, sizeof(bodyBuffer),
+                                               NULL, NULL) < 0);
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderInit(&decoder, bodyBuffer, sizeof(bodyBuffer),
+                                               decoderCallback, &testDecoder) == 0);
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderFeed(&decoder, NULL, 1) < 0);
+
+    // Feed the stream in chunks of varying size
+    while (offset < streamLength) {
+        if (chunkSize > streamLength - offset) {
+            chunkSize = streamLength - offset;
+        }
+        x = uUbxProtocolDecoderFeed(&decoder, pStream + offset, chunkSize);
+        U_PORT_TEST_ASSERT(x >= 0);
+        numMessages += x;
+        offset += chunkSize;
+        chunkSize = (chunkSize * 3) % 50 + 1;
+    }
+    U_TEST_PRINT_LINE("decoder found %d message(s) in %d byte(s).",
+                      testDecoder.numMessages, streamLength);
+    U_PORT_TEST_ASSERT(testDecoder.numMessages == U_UBX_PROTOCOL_TEST_DECODER_NUM_MESSAGES);
+    U_PORT_TEST_ASSERT(numMessages == testDecoder.numMessages);
+    U_PORT_TEST_ASSERT(testDecoder.numErrors == 0);
+
+    // Reset part way through a message: it should be lost but the
+    // next one should be found
+    length = decoderTestBodyLength(0) + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES + 1;
+    testDecoder.numMessages = 0;
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderFeed(&decoder, pStream, 3) == 0);
+    uUbxProtocolDecoderReset(&decoder);
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderFeed(&decoder, pStream + 3, length - 3) == 0);
+    testDecoder.numMessages = 1;
+    U_PORT_TEST_ASSERT(uUbxProtocolDecoderFeed(&decoder, pStream + length,
+                                               decoderTestBodyLength(1) +
+                                               U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) == 1);
+    U_PORT_TEST_ASSERT(testDecoder.numErrors == 0);
+
+    // Free memory
+    uPortFree(pBody);
+    uPortFree(pStream);
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
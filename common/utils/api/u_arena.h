@@ -0,0 +1,165 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_ARENA_H_
+#define _U_ARENA_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** @file
+ * @brief An arena: a block of memory from which scratch buffers
+ * are taken, by moving a pointer along, and which is then emptied
+ * in a single operation, e.g. at the end of a transaction.  Giving
+ * each API instance an arena for the temporary buffers it needs
+ * during a call, in place of pUPortMalloc()/uPortFree() every time,
+ * means that a long-running device does not fragment its heap.
+ *
+ * For example:
+ *
+ * ```
+ * uArena_t arena;
+ *
+ * uArenaInit(&arena, NULL, 1024);
+ * ...
+ * pCommand = (char *) pUArenaAlloc(&arena, 64);
+ * pResponse = (char *) pUArenaAlloc(&arena, 256);
+ * // Use pCommand and pResponse, then:
+ * uArenaReset(&arena);
+ * ...
+ * uArenaDeinit(&arena);
+ * ```
+ *
+ * These functions are NOT thread-safe: should that be required you
+ * must provide it with some form of mutex before the functions are
+ * called, or, better, give each task that needs one its own arena.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_ARENA_ALIGNMENT_BYTES
+/** The alignment of every buffer returned by pUArenaAlloc(); must
+ * be a power of two.
+ */
+# define U_ARENA_ALIGNMENT_BYTES 8
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** An arena; the contents are private, the structure is exposed
+ * only so that it may be statically allocated.
+ */
+typedef struct {
+    char *pBuffer;     /**< the memory of the arena. */
+    size_t size;       /**< the number of bytes at pBuffer. */
+    size_t used;       /**< the number of bytes handed out. */
+    size_t usedMax;    /**< the largest value that used has had. */
+    bool isAllocated;  /**< true if pBuffer came from pUPortMalloc(). */
+} uArena_t;
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Initialise an arena.
+ *
+ * @param[in] pArena   a pointer to the arena, cannot be NULL.
+ * @param[in] pBuffer  the memory for the arena, which must remain
+ *                     valid until uArenaDeinit() is called; use NULL
+ *                     to have it allocated with pUPortMalloc().
+ * @param size         the number of bytes at pBuffer or, if pBuffer
+ *                     is NULL, the number of bytes to allocate;
+ *                     cannot be zero.
+ * @return             zero on success else negative error code.
+ */
+int32_t uArenaInit(uArena_t *pArena, void *pBuffer, size_t size);
+
+/** Take a buffer from an arena; the buffer is aligned to
+ * #U_ARENA_ALIGNMENT_BYTES and is valid until the arena is
+ * reset or deinitialised.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ * @param size        the number of bytes required, cannot be zero.
+ * @return            a pointer to the buffer or NULL if there is
+ *                    not enough room left in the arena.
+ */
+void *pUArenaAlloc(uArena_t *pArena, size_t size);
+
+/** Get a mark that can be passed to uArenaResetToMark(), in order
+ * to release only those buffers taken after this call.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ * @return            the mark.
+ */
+size_t uArenaGetMark(const uArena_t *pArena);
+
+/** Release all of the buffers taken from an arena since the
+ * given mark was obtained.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ * @param mark        a mark returned by uArenaGetMark() since
+ *                    the arena was last reset to an earlier mark.
+ */
+void uArenaResetToMark(uArena_t *pArena, size_t mark);
+
+/** Release all of the buffers taken from an arena.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ */
+void uArenaReset(uArena_t *pArena);
+
+/** Get the number of bytes still free in an arena; since buffers
+ * are aligned, a buffer of this size will fit only if the last
+ * one taken was a multiple of #U_ARENA_ALIGNMENT_BYTES long.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ * @return            the number of bytes free.
+ */
+size_t uArenaGetFree(const uArena_t *pArena);
+
+/** Get the largest number of bytes that have been in use in an
+ * arena at any one time since it was initialised, useful when
+ * choosing its size.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ * @return            the high-water mark in bytes.
+ */
+size_t uArenaGetUsedMax(const uArena_t *pArena);
+
+/** Deinitialise an arena, freeing the memory if it was allocated
+ * by uArenaInit(); all of the buffers taken from it become invalid.
+ *
+ * @param[in] pArena  a pointer to the arena, cannot be NULL.
+ */
+void uArenaDeinit(uArena_t *pArena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _U_ARENA_H_
+
+// End of file
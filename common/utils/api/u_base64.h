@@ -28,6 +28,25 @@
 
 /** @file
  * @brief This header file defines base64 encode and decode functions.
+ * uBase64Encode() and uBase64Decode() work on a whole buffer at a
+ * time; the uBase64EncodeStream() and uBase64DecodeStream() functions
+ * keep state between calls so that data can be coded in chunks of
+ * any size, e.g. encoding a certificate a few tens of bytes at a time
+ * straight into uAtClientWriteBytes():
+ *
+ * ```
+ * uBase64EncodeStream_t stream;
+ * char buffer[U_BASE64_ENCODE_STREAM_LENGTH_MAX(48)];
+ * int32_t x;
+ *
+ * uBase64EncodeStreamInit(&stream);
+ * while ((length = readSome(pChunk, 48)) > 0) {
+ *     x = uBase64EncodeStream(&stream, pChunk, length, buffer, sizeof(buffer));
+ *     uAtClientWriteBytes(atHandle, buffer, x, true);
+ * }
+ * x = uBase64EncodeStreamFinish(&stream, buffer, sizeof(buffer));
+ * uAtClientWriteBytes(atHandle, buffer, x, true);
+ * ```
  */
 
 #ifdef __cplusplus
@@ -38,10 +57,44 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The most base 64 characters a call to uBase64EncodeStream()
+ * with binaryLengthBytes of data can write; this is also large
+ * enough for uBase64EncodeStreamFinish().
+ */
+#define U_BASE64_ENCODE_STREAM_LENGTH_MAX(binaryLengthBytes) \
+    ((((binaryLengthBytes) + 2) / 3) * 4)
+
+/** The most bytes a call to uBase64DecodeStream() with
+ * base64LengthBytes of base 64 characters can write; this is also
+ * large enough for uBase64DecodeStreamFinish().
+ */
+#define U_BASE64_DECODE_STREAM_LENGTH_MAX(base64LengthBytes) \
+    ((((base64LengthBytes) + 3) / 4) * 3)
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The state of a streaming base 64 encode; the contents are
+ * private, the structure is exposed only so that it may be
+ * allocated by the caller.
+ */
+typedef struct {
+    uint8_t carry[2];   /**< binary bytes not yet encoded. */
+    size_t carryLength; /**< the number of bytes in carry. */
+} uBase64EncodeStream_t;
+
+/** The state of a streaming base 64 decode; the contents are
+ * private, the structure is exposed only so that it may be
+ * allocated by the caller.
+ */
+typedef struct {
+    uint32_t accumulator; /**< the six-bit values of a partial quad. */
+    size_t count;         /**< the number of characters of the quad so far. */
+    size_t padCount;      /**< the number of '=' characters of the quad. */
+    bool done;            /**< true once a padded quad has been decoded. */
+} uBase64DecodeStream_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -87,6 +140,98 @@ int32_t uBase64Encode(const char *pBinary, size_t binaryLengthBytes,
 int32_t uBase64Decode(const char *pBase64, size_t base64LengthBytes,
                       char *pBinary, size_t binaryLengthBytes);
 
+/** Initialise the state of a streaming base 64 encode.
+ *
+ * @param[out] pStream  the state, cannot be NULL.
+ */
+void uBase64EncodeStreamInit(uBase64EncodeStream_t *pStream);
+
+/** Base 64 encode a chunk of binary data as part of a stream; up
+ * to two bytes may be held over to the next call, so the chunks may
+ * be of any length.
+ *
+ * @param[in] pStream       the state, initialised with
+ *                          uBase64EncodeStreamInit(), cannot be NULL.
+ * @param[in] pBinary       the binary data to be encoded.
+ * @param binaryLengthBytes the amount of binary data.
+ * @param[out] pBase64      a place to store the base 64 encoded data;
+ *                          no null-terminator is included.
+ * @param base64LengthBytes the amount of storage at pBase64, which
+ *                          need be no more than
+ *                          #U_BASE64_ENCODE_STREAM_LENGTH_MAX
+ *                          (binaryLengthBytes).
+ * @return                  the number of characters stored at pBase64,
+ *                          else negative error code, in which case
+ *                          nothing has been consumed;
+ *                          #U_ERROR_COMMON_NO_MEMORY if there is not
+ *                          enough storage at pBase64.
+ */
+int32_t uBase64EncodeStream(uBase64EncodeStream_t *pStream,
+                            const char *pBinary, size_t binaryLengthBytes,
+                            char *pBase64, size_t base64LengthBytes);
+
+/** Finish a streaming base 64 encode, writing out any bytes held
+ * over, with padding; pStream may then be used for a new stream.
+ *
+ * @param[in] pStream       the state, cannot be NULL.
+ * @param[out] pBase64      a place to store the base 64 encoded data.
+ * @param base64LengthBytes the amount of storage at pBase64; four
+ *                          is always enough.
+ * @return                  the number of characters stored at pBase64,
+ *                          zero or four, else negative error code.
+ */
+int32_t uBase64EncodeStreamFinish(uBase64EncodeStream_t *pStream,
+                                  char *pBase64, size_t base64LengthBytes);
+
+/** Initialise the state of a streaming base 64 decode.
+ *
+ * @param[out] pStream  the state, cannot be NULL.
+ */
+void uBase64DecodeStreamInit(uBase64DecodeStream_t *pStream);
+
+/** Decode a chunk of base 64 data as part of a stream; up to three
+ * characters may be held over to the next call, so the chunks may
+ * be of any length.  White space (e.g. the line breaks of a PEM
+ * file) is ignored.
+ *
+ * @param[in] pStream       the state, initialised with
+ *                          uBase64DecodeStreamInit(), cannot be NULL.
+ * @param[in] pBase64       the base 64 data to be decoded.
+ * @param base64LengthBytes the amount of base 64 data.
+ * @param[out] pBinary      a place to store the decoded data.
+ * @param binaryLengthBytes the amount of storage at pBinary, which
+ *                          need be no more than
+ *                          #U_BASE64_DECODE_STREAM_LENGTH_MAX
+ *                          (base64LengthBytes).
+ * @return                  the number of bytes stored at pBinary, else
+ *                          negative error code: #U_ERROR_COMMON_NO_MEMORY
+ *                          if there is not enough storage at pBinary,
+ *                          in which case nothing has been consumed,
+ *                          #U_ERROR_COMMON_BAD_DATA if pBase64 contains
+ *                          a character that is not base 64 or data
+ *                          after the padding, in which case the stream
+ *                          must be initialised again.
+ */
+int32_t uBase64DecodeStream(uBase64DecodeStream_t *pStream,
+                            const char *pBase64, size_t base64LengthBytes,
+                            char *pBinary, size_t binaryLengthBytes);
+
+/** Finish a streaming base 64 decode; unpadded base 64 is accepted,
+ * so any characters held over are decoded here.  pStream may then
+ * be used for a new stream.
+ *
+ * @param[in] pStream       the state, cannot be NULL.
+ * @param[out] pBinary      a place to store the decoded data.
+ * @param binaryLengthBytes the amount of storage at pBinary; three
+ *                          is always enough.
+ * @return                  the number of bytes stored at pBinary, else
+ *                          negative error code, #U_ERROR_COMMON_TRUNCATED
+ *                          if the base 64 data ended part-way through
+ *                          a byte.
+ */
+int32_t uBase64DecodeStreamFinish(uBase64DecodeStream_t *pStream,
+                                  char *pBinary, size_t binaryLengthBytes);
+
 #ifdef __cplusplus
 }
 #endif
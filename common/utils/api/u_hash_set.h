@@ -0,0 +1,123 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_HASH_SET_H_
+#define _U_HASH_SET_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** @file
+ * @brief A small set of pointers, e.g. for checking that a handle
+ * passed in to an API is one that the API handed out, in constant
+ * time rather than by searching a list.  The set uses open addressing
+ * with linear probing over storage provided by the caller, so adding
+ * to it and removing from it need no memory to be allocated.
+ *
+ * These functions are NOT thread-safe: should that be required you
+ * must provide it with some form of mutex before the functions are
+ * called.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** A hash set; the contents are private, the structure is exposed
+ * only so that it may be statically allocated.
+ */
+typedef struct {
+    const void **ppSlots; /**< the storage, numSlots entries. */
+    size_t numSlots;      /**< the number of slots, a power of two. */
+    size_t numEntries;    /**< the number of entries in the set. */
+} uHashSet_t;
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Initialise a hash set, making it empty.
+ *
+ * @param[in] pSet     a pointer to the hash set, cannot be NULL.
+ * @param[in] ppSlots  the storage for the set: an array of numSlots
+ *                     pointers which must remain valid for as long
+ *                     as the set is in use; cannot be NULL.
+ * @param numSlots     the number of entries at ppSlots, which must be
+ *                     a power of two; for the best performance there
+ *                     should be at least twice as many slots as the
+ *                     number of entries the set is expected to hold.
+ * @return             zero on success else negative error code.
+ */
+int32_t uHashSetInit(uHashSet_t *pSet, const void **ppSlots, size_t numSlots);
+
+/** Add an entry to a hash set; adding an entry that is already in
+ * the set is not an error.
+ *
+ * @param[in] pSet  a pointer to the hash set, cannot be NULL.
+ * @param[in] p     the entry to add, cannot be NULL.
+ * @return          zero on success, else negative error code,
+ *                  #U_ERROR_COMMON_NO_MEMORY if the set is full.
+ */
+int32_t uHashSetAdd(uHashSet_t *pSet, const void *p);
+
+/** Determine whether an entry is in a hash set.
+ *
+ * @param[in] pSet  a pointer to the hash set, cannot be NULL.
+ * @param[in] p     the entry to look for.
+ * @return          true if p is in the set.
+ */
+bool uHashSetContains(const uHashSet_t *pSet, const void *p);
+
+/** Remove an entry from a hash set.
+ *
+ * @param[in] pSet  a pointer to the hash set, cannot be NULL.
+ * @param[in] p     the entry to remove; note that the memory pointed
+ *                  to by p is not touched in any way.
+ * @return          true if the entry was removed, false if it was
+ *                  not in the set.
+ */
+bool uHashSetRemove(uHashSet_t *pSet, const void *p);
+
+/** Get the number of entries in a hash set.
+ *
+ * @param[in] pSet  a pointer to the hash set, cannot be NULL.
+ * @return          the number of entries.
+ */
+size_t uHashSetGetCount(const uHashSet_t *pSet);
+
+/** Remove all of the entries from a hash set.
+ *
+ * @param[in] pSet  a pointer to the hash set, cannot be NULL.
+ */
+void uHashSetClear(uHashSet_t *pSet);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _U_HASH_SET_H_
+
+// End of file
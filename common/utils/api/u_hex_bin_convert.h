@@ -61,6 +61,18 @@ extern "C" {
  */
 size_t uBinToHex(const char *pBin, size_t binLength, char *pHex);
 
+/** Convert a buffer into the ASCII hex equivalent in place, e.g.
+ * to hex-encode data that has been read into the buffer that is
+ * going to be sent.
+ *
+ * @param pBuffer   a pointer to a buffer that contains binLength
+ *                  bytes of binary and is at least twice binLength
+ *                  bytes long.
+ * @param binLength the number of bytes of binary at pBuffer.
+ * @return          the number of bytes of ASCII hex now at pBuffer.
+ */
+size_t uBinToHexInPlace(char *pBuffer, size_t binLength);
+
 /** Convert a buffer of ASCII hex into the binary equivalent.
  * If it is not possible to convert character (e.g. because
  * it is not valid ASCII hex) then conversion stops there.
@@ -68,7 +80,8 @@ size_t uBinToHex(const char *pBin, size_t binLength, char *pHex);
  * @param pHex      a pointer to the ASCII hex data.
  * @param hexLength the number of bytes pointed to by pHex.
  * @param pBin      a pointer to a buffer of length half hexLength
- *                  bytes to store the binary version.
+ *                  bytes to store the binary version; this may be
+ *                  the same as pHex to convert in place.
  * @return          the number of bytes at pBin.
  */
 size_t uHexToBin(const char *pHex, size_t hexLength, char *pBin);
@@ -21,6 +21,13 @@
  * @brief Linked list utilities.  These functions are NOT thread-safe:
  * should that be required you must provide it with some form of
  * mutex before the functions are called.
+ *
+ * Two forms of list are provided: uLinkedList_t, where each entry
+ * is a container allocated from the heap holding a pointer to
+ * the caller's data, and the intrusive uIntrusiveList_t, where the
+ * caller embeds a #uIntrusiveListNode_t in their own structure, so
+ * that adding to or removing from the list needs no memory to be
+ * allocated and removal takes the same time however long the list.
  */
 
 #ifdef __cplusplus
@@ -31,6 +38,21 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** Get a pointer to the structure of the given type that contains
+ * the #uIntrusiveListNode_t at pNode as the given member, e.g.:
+ *
+ * ```
+ * typedef struct {
+ *     int32_t handle;
+ *     uIntrusiveListNode_t node;
+ * } myInstance_t;
+ *
+ * myInstance_t *pInstance = U_INTRUSIVE_LIST_CONTAINER(pNode, myInstance_t, node);
+ * ```
+ */
+#define U_INTRUSIVE_LIST_CONTAINER(pNode, type, member) \
+    ((type *) (((char *) (pNode)) - offsetof(type, member)))
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -42,6 +64,21 @@ typedef struct uLinkedList_t {
     struct uLinkedList_t *pNext;
 } uLinkedList_t;
 
+/** A node of an intrusive list, to be embedded in the structure
+ * that is to be put on the list; it should be zeroed or passed
+ * through uIntrusiveListNodeInit() before use.
+ */
+typedef struct uIntrusiveListNode_t {
+    struct uIntrusiveListNode_t *pNext;
+    struct uIntrusiveListNode_t *pPrev;
+} uIntrusiveListNode_t;
+
+/** An intrusive list: this is a node of the list itself, linked
+ * circularly to the nodes that have been added to it; it must be
+ * passed through uIntrusiveListInit() before use.
+ */
+typedef uIntrusiveListNode_t uIntrusiveList_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -80,6 +117,76 @@ uLinkedList_t *pULinkedListFind(uLinkedList_t **ppList, void *p);
  */
 bool uLinkedListRemove(uLinkedList_t **ppList, void *p);
 
+/** Initialise an intrusive list, making it empty.  This function is
+ * NOT thread-safe.
+ *
+ * @param[in] pList  a pointer to the list, cannot be NULL.
+ */
+void uIntrusiveListInit(uIntrusiveList_t *pList);
+
+/** Initialise a node of an intrusive list, marking it as not being
+ * on a list; a node that has been zeroed needs no initialisation.
+ * This function is NOT thread-safe.
+ *
+ * @param[in] pNode  the node, cannot be NULL.
+ */
+void uIntrusiveListNodeInit(uIntrusiveListNode_t *pNode);
+
+/** Add a node to the end of an intrusive list.  This function is
+ * NOT thread-safe.
+ *
+ * @param[in] pList  a pointer to the list, cannot be NULL.
+ * @param[in] pNode  the node to add; cannot be NULL and must not
+ *                   already be on a list.
+ * @return           true if the node was added, false if it is
+ *                   already on a list.
+ */
+bool uIntrusiveListAdd(uIntrusiveList_t *pList, uIntrusiveListNode_t *pNode);
+
+/** Remove a node from whichever intrusive list it is on; no search
+ * is required.  This function is NOT thread-safe.
+ *
+ * @param[in] pNode  the node to remove, cannot be NULL.
+ * @return           true if the node was removed, false if it was
+ *                   not on a list.
+ */
+bool uIntrusiveListRemove(uIntrusiveListNode_t *pNode);
+
+/** Determine whether a node is on an intrusive list; no search is
+ * required.  This function is NOT thread-safe.
+ *
+ * @param[in] pNode  the node, cannot be NULL.
+ * @return           true if the node is on a list.
+ */
+bool uIntrusiveListNodeIsListed(const uIntrusiveListNode_t *pNode);
+
+/** Determine whether an intrusive list is empty.  This function is
+ * NOT thread-safe.
+ *
+ * @param[in] pList  a pointer to the list, cannot be NULL.
+ * @return           true if the list is empty.
+ */
+bool uIntrusiveListIsEmpty(const uIntrusiveList_t *pList);
+
+/** Get the first node of an intrusive list, e.g. to iterate over it
+ * with pUIntrusiveListNext().  This function is NOT thread-safe.
+ *
+ * @param[in] pList  a pointer to the list, cannot be NULL.
+ * @return           the first node, NULL if the list is empty.
+ */
+uIntrusiveListNode_t *pUIntrusiveListFirst(uIntrusiveList_t *pList);
+
+/** Get the node after the given one on an intrusive list.  This
+ * function is NOT thread-safe; if nodes are to be removed while
+ * iterating, get the next node before removing the current one.
+ *
+ * @param[in] pList  a pointer to the list, cannot be NULL.
+ * @param[in] pNode  a node on the list, cannot be NULL.
+ * @return           the next node, NULL if pNode is the last node.
+ */
+uIntrusiveListNode_t *pUIntrusiveListNext(uIntrusiveList_t *pList,
+                                          uIntrusiveListNode_t *pNode);
+
 #ifdef __cplusplus
 }
 #endif
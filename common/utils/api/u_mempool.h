@@ -29,8 +29,14 @@
 /** @file
  * @brief This header file defines a memory pool API, used internally by the short range
  * API for efficient EDM transport.  The API functions are thread-safe except for the
- * uMemPoolInit() and uMemPoolDeinit() APIs, which should not be called while any
- * of the other API calls are in progress.
+ * uMemPoolInit(), uMemPoolInitFlags() and uMemPoolDeinit() APIs, which should not be
+ * called while any of the other API calls are in progress.
+ *
+ * By default the blocks of a pool are kept on a mutex-protected free list and the
+ * memory of the pool is allocated on first use; a pool initialised with
+ * #U_MEMPOOL_FLAG_LOCK_FREE instead keeps its free blocks on a lock-free stack, so
+ * that tasks allocating and freeing blocks at the same time do not serialise
+ * on a mutex.
  */
 #ifdef __cplusplus
 extern "C" {
@@ -40,6 +46,24 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** Flag for uMemPoolInitFlags(): allocate the memory of the pool
+ * at initialisation rather than on the first call to
+ * uMemPoolAllocMem().
+ */
+#define U_MEMPOOL_FLAG_EAGER_INIT 0x01
+
+/** Flag for uMemPoolInitFlags(): keep the free blocks on a lock-free
+ * stack rather than a mutex-protected list; implies
+ * #U_MEMPOOL_FLAG_EAGER_INIT.  A lock-free pool may have no more
+ * than #U_MEMPOOL_LOCK_FREE_MAX_NUM_BLOCKS blocks.
+ */
+#define U_MEMPOOL_FLAG_LOCK_FREE 0x02
+
+/** The maximum number of blocks in a pool initialised with
+ * #U_MEMPOOL_FLAG_LOCK_FREE.
+ */
+#define U_MEMPOOL_LOCK_FREE_MAX_NUM_BLOCKS 0xFFFF
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -51,8 +75,33 @@ typedef struct {
     struct uMemPoolFree *pFreeList; /**< linked list of free blocks. */
     uint8_t *pBuffer; /**< data buffer (sub-divided into blocks). */
     uPortMutexHandle_t mutex; /**< mutex for thread protection. */
+    uint32_t flags; /**< the U_MEMPOOL_FLAG_xxx values the pool was initialised with. */
+    uint32_t freeHead; /**< lock-free pools only: the head of the free stack, an ABA
+                            tag in the upper 16 bits and the index plus one of the
+                            first free block in the lower 16 bits, zero if empty. */
+    int32_t usedBlockCountMax; /**< the largest value usedBlockCount has reached. */
+    int32_t allocCount; /**< the number of blocks allocated. */
+    int32_t freeCount; /**< the number of blocks freed. */
+    int32_t allocFailCount; /**< the number of allocation calls that could not be
+                                 met in full because the pool was empty. */
 } uMemPoolDesc_t;
 
+/** Run-time statistics of a memory pool, as returned by
+ * uMemPoolGetStats(); intended to help with sizing the pool.
+ */
+typedef struct {
+    uint32_t blockSize;        /**< the size of each block. */
+    int32_t totalBlockCount;   /**< the total number of blocks. */
+    int32_t usedBlockCount;    /**< the number of blocks currently in use. */
+    int32_t usedBlockCountMax; /**< the largest number of blocks that have
+                                    been in use at any one time. */
+    int32_t allocCount;        /**< the number of blocks allocated. */
+    int32_t freeCount;         /**< the number of blocks freed. */
+    int32_t allocFailCount;    /**< the number of allocation calls that could
+                                    not be met in full because the pool was
+                                    empty. */
+} uMemPoolStats_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -67,6 +116,19 @@ typedef struct {
  */
 int32_t uMemPoolInit(uMemPoolDesc_t *pMemPool, uint32_t blockSize, int32_t numOfBlks);
 
+/** Initialize memory pool with flags; uMemPoolInit() is the same as
+ *  calling this with flags of zero.
+ *
+ * @param pMemPool      pointer to empty memory pool.
+ * @param blockSize     size of each block.
+ * @param numOfBlks     Number of blocks each of blockSize.
+ * @param flags         a bitmap of U_MEMPOOL_FLAG_xxx values.
+ *
+ * @return              zero on success else negative error code.
+ */
+int32_t uMemPoolInitFlags(uMemPoolDesc_t *pMemPool, uint32_t blockSize,
+                          int32_t numOfBlks, uint32_t flags);
+
 /** Deinitialize memory pool. This API will free all the references to the block
  *  and the pool itself.
  *
@@ -92,12 +154,56 @@ void *uMemPoolAllocMem(uMemPoolDesc_t *pMemPool);
  */
 void uMemPoolFreeMem(uMemPoolDesc_t *pMemPool, void *ptr);
 
+/** Allocate up to count blocks from the given pool in one go; for a
+ *  lock-free pool this is a single atomic operation, for a
+ *  mutex-protected pool the mutex is taken only once.
+ *
+ * @param pMemPool      pointer to the memory pool.
+ * @param ppMem         an array of at least count entries in which
+ *                      to put the pointers to the blocks.
+ * @param count         the number of blocks wanted.
+ * @return              the number of blocks allocated, which may be
+ *                      less than count if the pool runs out.
+ */
+int32_t uMemPoolAllocBatch(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count);
+
+/** Free several blocks to the given pool in one go, see
+ *  uMemPoolAllocBatch().
+ *
+ * @param pMemPool      pointer to the memory pool.
+ * @param ppMem         an array of count pointers to blocks that
+ *                      came from pMemPool; NULL entries are ignored.
+ * @param count         the number of entries in ppMem.
+ */
+void uMemPoolFreeBatch(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count);
+
 /** Free all the memory references present in the given pool.
+ *  For a lock-free pool this must not be called while any other
+ *  API call on the pool is in progress.
  *
  * @param pMemPool      pointer to the memory pool.
  */
 void uMemPoolFreeAllMem(uMemPoolDesc_t *pMemPool);
 
+/** Check whether a block of memory came from the given pool, e.g.
+ * to find out which of several pools a block should be freed to.
+ *
+ * @param pMemPool      pointer to the memory pool.
+ * @param ptr           pointer to the block.
+ * @return              true if ptr lies within the memory of pMemPool.
+ */
+bool uMemPoolContains(uMemPoolDesc_t *pMemPool, const void *ptr);
+
+/** Get the run-time statistics of a memory pool; the statistics
+ * are reset by uMemPoolInit()/uMemPoolInitFlags(), not by
+ * uMemPoolFreeAllMem().
+ *
+ * @param pMemPool      pointer to the memory pool.
+ * @param[out] pStats   a place to put the statistics, cannot be NULL.
+ * @return              zero on success else negative error code.
+ */
+int32_t uMemPoolGetStats(uMemPoolDesc_t *pMemPool, uMemPoolStats_t *pStats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -29,7 +29,9 @@
 /** @file
  * @brief Ring buffer wrapper API for linear buffer.
  * All functions except uRingBufferCreate() and uRingBufferDelete()
- * are thread-safe.
+ * are thread-safe.  A ring buffer created with
+ * uRingBufferCreateLockFree() has no mutex: it is safe for exactly
+ * one producer and one consumer, see that function for the details.
  */
 
 #ifdef __cplusplus
@@ -99,8 +101,37 @@ typedef struct {
                                          as a result of add or forced add
                                          being unable to write into the
                                          ring buffer. */
+    int32_t slowestReadPointer;     /**< the index of the read pointer with
+                                         the most data behind it, which
+                                         is the one that limits uRingBufferAdd(),
+                                         or -1 if that needs to be worked out
+                                         again; only moving this read pointer
+                                         on (or the set of read pointers
+                                         changing) can make it wrong since an
+                                         add moves all of them back equally. */
+    bool isLockFree;                /**< true if the ring buffer was created
+                                         with uRingBufferCreateLockFree(),
+                                         in which case there is no mutex
+                                         and pDataWrite/pDataReadNormal
+                                         are accessed atomically. */
 } uRingBuffer_t;
 
+/** A contiguous span of data in a ring buffer, as returned by
+ * uRingBufferGetReadSpans().
+ */
+typedef struct {
+    const char *pData;
+    size_t length;
+} uRingBufferReadSpan_t;
+
+/** A contiguous span of free space in a ring buffer, as returned
+ * by uRingBufferGetWriteSpans().
+ */
+typedef struct {
+    char *pData;
+    size_t length;
+} uRingBufferWriteSpan_t;
+
 typedef void *uParseHandle_t; //!< Parser handle.
 
 /** Parser function prototype, used with uRingBufferParseHandle().
@@ -148,6 +179,37 @@ void uRingBufferDump(uRingBuffer_t *pRingBuffer);
 int32_t uRingBufferCreate(uRingBuffer_t *pRingBuffer, char *pLinearBuffer,
                           size_t size);
 
+/** Create a new ring buffer from a linear buffer for use by exactly
+ * one producer and one consumer, e.g. a callback that adds received
+ * data and a task that reads it.  No mutex is used: the write pointer
+ * is only ever moved by the producer, the read pointer only ever by
+ * the consumer, and each is published atomically to the other side
+ * after the data has been copied.
+ *
+ * The producer may call uRingBufferAdd(), uRingBufferForceAdd(),
+ * uRingBufferGetWriteSpans(), uRingBufferCommitWrite() and
+ * uRingBufferStatAddLoss(); the consumer may call uRingBufferRead(),
+ * uRingBufferPeek(), uRingBufferGetReadSpans(), uRingBufferCommitRead()
+ * and uRingBufferFlush(); either may call uRingBufferDataSize() and
+ * uRingBufferAvailableSize().  Since the producer
+ * cannot move the read pointer, uRingBufferForceAdd() behaves
+ * exactly as uRingBufferAdd() and uRingBufferStatReadLoss() always
+ * returns zero.  None of the other functions of this API, including
+ * those of the "handle" form, uRingBufferFlushValue(),
+ * uRingBufferReset() and uRingBufferDump(), may be used on such a
+ * ring buffer: they will do nothing.
+ *
+ * @param[in] pRingBuffer   a pointer to a ring buffer, cannot be NULL.
+ * @param[in] pLinearBuffer a pointer to the linear buffer.
+ * @param size              the size of the linear buffer in bytes; the
+ *                          ring buffer will be of maximum size this
+ *                          number minus one as one byte is used to
+ *                          prevent pointer-wrap.
+ * @return                  zero on success else negative error code.
+ */
+int32_t uRingBufferCreateLockFree(uRingBuffer_t *pRingBuffer, char *pLinearBuffer,
+                                  size_t size);
+
 /** Delete a ring buffer.
  *
  * @param[in] pRingBuffer   a pointer to the ring buffer, cannot be NULL.
@@ -271,6 +333,64 @@ size_t uRingBufferStatReadLoss(uRingBuffer_t *pRingBuffer);
  */
 size_t uRingBufferStatAddLoss(uRingBuffer_t *pRingBuffer);
 
+/* ----------------------------------------------------------------
+ * FUNCTIONS: SPANS
+ * -------------------------------------------------------------- */
+
+/** Get the data that uRingBufferRead() would return as up to two
+ * contiguous spans inside the ring buffer, the second being non-empty
+ * only if the data wraps, so that it can be scanned (e.g. with
+ * memchr()) or passed to a transmit function without being copied;
+ * call uRingBufferCommitRead() afterwards to consume what has been
+ * used.  The data pointed-to remains valid until it is consumed,
+ * unless uRingBufferForceAdd() pushes it out.  If
+ * uRingBufferSetReadRequiresHandle() is true then no data is returned.
+ *
+ * @param[in] pRingBuffer  a pointer to the ring buffer, cannot be NULL.
+ * @param[out] spans       a place to put the two spans, cannot be NULL;
+ *                         an unused span has zero length.
+ * @return                 the total number of bytes in the spans.
+ */
+size_t uRingBufferGetReadSpans(uRingBuffer_t *pRingBuffer,
+                               uRingBufferReadSpan_t spans[2]);
+
+/** Consume data from a ring buffer, as if it had been read with
+ * uRingBufferRead(), typically after uRingBufferGetReadSpans().
+ *
+ * @param[in] pRingBuffer  a pointer to the ring buffer, cannot be NULL.
+ * @param length           the number of bytes to consume.
+ * @return                 the number of bytes consumed, which will be
+ *                         less than length if there is less data than
+ *                         that in the ring buffer.
+ */
+size_t uRingBufferCommitRead(uRingBuffer_t *pRingBuffer, size_t length);
+
+/** Get the free space that uRingBufferAdd() could write to as up
+ * to two contiguous spans inside the ring buffer, the second being
+ * non-empty only if the free space wraps, so that a producer can
+ * receive directly into the ring buffer (e.g. by DMA or read());
+ * call uRingBufferCommitWrite() afterwards to add what has been
+ * written.  There must be only one producer of data while the spans
+ * are in use.
+ *
+ * @param[in] pRingBuffer  a pointer to the ring buffer, cannot be NULL.
+ * @param[out] spans       a place to put the two spans, cannot be NULL;
+ *                         an unused span has zero length.
+ * @return                 the total number of bytes in the spans.
+ */
+size_t uRingBufferGetWriteSpans(uRingBuffer_t *pRingBuffer,
+                                uRingBufferWriteSpan_t spans[2]);
+
+/** Add data that has been written into the spans returned by
+ * uRingBufferGetWriteSpans() to a ring buffer, spans[0] first.
+ *
+ * @param[in] pRingBuffer  a pointer to the ring buffer, cannot be NULL.
+ * @param length           the number of bytes written.
+ * @return                 the number of bytes added, which will be
+ *                         less than length if there is not room enough.
+ */
+size_t uRingBufferCommitWrite(uRingBuffer_t *pRingBuffer, size_t length);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: MULTIPLE READERS
  * -------------------------------------------------------------- */
@@ -409,6 +529,32 @@ size_t uRingBufferReadHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
 size_t uRingBufferPeekHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
                              char *pData, size_t length, size_t offset);
 
+/** Like uRingBufferPeekHandle() but, rather than copying the data,
+ * return a pointer to it inside the ring buffer.  The span ends
+ * after length bytes or where the ring buffer wraps, whichever is
+ * sooner, so call this again with offset increased by the returned
+ * length to get the remainder.  The data pointed-to is only
+ * guaranteed to remain unchanged while the read handle is locked
+ * (see uRingBufferLockReadHandle()) and no data is read using that
+ * handle.  To use this function the ring buffer must have been
+ * created by calling uRingBufferCreateWithReadHandle() rather than
+ * uRingBufferCreate().
+ *
+ * @param[in] pRingBuffer   a pointer to the ring buffer, cannot be NULL.
+ * @param handle            a read handle, as originally  returned by
+ *                          uRingBufferTakeReadHandle().
+ * @param[out] ppSpan       a place to put the pointer to the start of
+ *                          the span; cannot be NULL.
+ * @param length            the maximum length of the span.
+ * @param offset            the offset from the read pointer at which
+ *                          the span begins.
+ * @return                  the number of bytes in the span, zero if
+ *                          there is no data at offset.
+ */
+size_t uRingBufferPeekSpanHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
+                                 const char **ppSpan, size_t length,
+                                 size_t offset);
+
 /** Like uRingBufferDataSize() except for use by an entity that has
  * previously obtained a read handle by calling uRingBufferTakeReadHandle();
  * this mechanism should be employed if there is to be more than one consumer
@@ -486,6 +632,64 @@ size_t uRingBufferParseHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
  */
 bool uRingBufferGetByteUnprotected(uParseHandle_t parseHandle, void *p);
 
+/** Get the next byte from the ring buffer while in a parser function
+ * WITHOUT consuming it, e.g. so that a parser can decide which of a
+ * number of sub-parsers to hand over to.
+ *
+ * IMPORTANT: unlike all of the other ring-buffer functions, this function
+ * is NOT thread-safe, it is ONLY intended to be used from within a
+ * U_RING_BUFFER_PARSER_f function that will be called by uRingBufferParseHandle()
+ * (which adds thread-safety).
+ *
+ * @param parseHandle     the parser handle used to access the ring buffer.
+ * @param[out] p          pointer to store the byte or char.
+ * @return                false if no more data, true if peek of byte sucessful.
+ */
+bool uRingBufferPeekByteUnprotected(uParseHandle_t parseHandle, void *p);
+
+/** Get a block of bytes from the ring buffer while in a parser function;
+ * this is equivalent to calling uRingBufferGetByteUnprotected() length
+ * times but copies contiguous data in one go, which is significantly
+ * quicker for long fields.
+ *
+ * IMPORTANT: unlike all of the other ring-buffer functions, this function
+ * is NOT thread-safe, it is ONLY intended to be used from within a
+ * U_RING_BUFFER_PARSER_f function that will be called by uRingBufferParseHandle()
+ * (which adds thread-safety).
+ *
+ * @param parseHandle     the parser handle used to access the ring buffer.
+ * @param[out] p          pointer to storage of at least length bytes;
+ *                        may be NULL, in which case the bytes are
+ *                        simply skipped.
+ * @param length          the number of bytes to get.
+ * @return                the number of bytes got, which will be less
+ *                        than length if there is insufficient data.
+ */
+size_t uRingBufferGetBytesUnprotected(uParseHandle_t parseHandle, void *p,
+                                      size_t length);
+
+/** Get a pointer to the next contiguous span of bytes in the ring
+ * buffer while in a parser function, without copying them; the
+ * span ends either after length bytes or at the point where the
+ * ring buffer wraps, whichever is sooner, so a second call may be
+ * needed to get the remainder.  The span remains valid only until
+ * the parser function returns.
+ *
+ * IMPORTANT: unlike all of the other ring-buffer functions, this function
+ * is NOT thread-safe, it is ONLY intended to be used from within a
+ * U_RING_BUFFER_PARSER_f function that will be called by uRingBufferParseHandle()
+ * (which adds thread-safety).
+ *
+ * @param parseHandle     the parser handle used to access the ring buffer.
+ * @param[out] ppSpan     a place to put the pointer to the start of the
+ *                        span; cannot be NULL.
+ * @param length          the maximum number of bytes wanted.
+ * @return                the number of bytes in the span, zero if
+ *                        there is no more data.
+ */
+size_t uRingBufferGetSpanUnprotected(uParseHandle_t parseHandle, const char **ppSpan,
+                                     size_t length);
+
 /** Number of bytes in the ring buffer while in a parser function.
  *
  * IMPORTANT: unlike all of the other ring-buffer functions, this function
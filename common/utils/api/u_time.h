@@ -59,6 +59,35 @@ extern "C" {
  */
 bool uTimeIsLeapYear(int32_t year);
 
+/** Return the number of days from 1st January 1970 to the given
+ * date in the proleptic Gregorian calendar, in constant time.
+ * A month outside the range 1 to 12 is carried into the year and
+ * a day outside the month is carried into the following or
+ * preceding months, so e.g. month 13 of 2023 is January 2024.
+ *
+ * @param year  the year, e.g. 2023.
+ * @param month the month, 1 for January.
+ * @param day   the day of the month, starting at 1.
+ * @return      the number of days since 1st January 1970,
+ *              negative for an earlier date.
+ */
+int64_t uTimeDaysFromCivil(int32_t year, int32_t month, int32_t day);
+
+/** The reverse of uTimeDaysFromCivil(): return the date, in the
+ * proleptic Gregorian calendar, at the given number of days from
+ * 1st January 1970, in constant time.
+ *
+ * @param days         the number of days since 1st January 1970,
+ *                     may be negative.
+ * @param[out] pYear   a place to put the year, e.g. 2023; may be NULL.
+ * @param[out] pMonth  a place to put the month, 1 for January;
+ *                     may be NULL.
+ * @param[out] pDay    a place to put the day of the month, starting
+ *                     at 1; may be NULL.
+ */
+void uTimeCivilFromDays(int64_t days, int32_t *pYear, int32_t *pMonth,
+                        int32_t *pDay);
+
 /** Return the number of UTC seconds that have elapsed in
  * the given number of UTC months, months since the
  * start of 1970 (counting from zero), taking into account
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_TRACE_H_
+#define _U_TRACE_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** @file
+ * @brief Cross-layer tracing of an operation, e.g. a uSockWrite()
+ * or a uMqttClientPublish(): where an operation is traced, the
+ * time it takes is split between the layers it passes through
+ * (the API itself, the device-specific layer below it, waiting for
+ * the AT client lock, writing to the UART/stream and waiting for
+ * the response of the module) and reported to a callback when the
+ * operation completes.
+ *
+ * Since each operation is carried out entirely by the task that
+ * called the API, the trace context is associated with that task:
+ * nothing need be passed down through the layers, each layer simply
+ * calls uTraceStagePush() on the way into a stage and uTraceStagePop()
+ * on the way out, and time is attributed to whichever stage is at
+ * the top of the stack for the task.
+ *
+ * Tracing is off until uTraceCallbackSet() is called with a
+ * non-NULL callback; while it is off each of these functions
+ * returns after checking a single variable.  No memory is
+ * allocated and no OS resources are used.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_TRACE_MAX_NUM_OPERATIONS
+/** The maximum number of operations that may be traced at the same
+ * time, each in a different task; an operation started while this
+ * many are in progress is not traced.
+ */
+# define U_TRACE_MAX_NUM_OPERATIONS 4
+#endif
+
+#ifndef U_TRACE_STAGE_STACK_DEPTH
+/** The depth of the stack of stages of an operation; stages pushed
+ * beyond this depth are counted against the stage at the top.
+ */
+# define U_TRACE_STAGE_STACK_DEPTH 8
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** The stages an operation may pass through.
+ */
+typedef enum {
+    U_TRACE_STAGE_API,          /**< in the API that was called, e.g. u_sock
+                                     or u_mqtt_client, or anywhere not covered
+                                     by the stages below. */
+    U_TRACE_STAGE_SERVICE,      /**< in the device-specific layer below the
+                                     API, e.g. u_cell_sock or u_wifi_mqtt. */
+    U_TRACE_STAGE_AT_LOCK_WAIT, /**< waiting to lock the AT client. */
+    U_TRACE_STAGE_AT_WRITE,     /**< writing to the stream (e.g. the UART)
+                                     underneath the AT client. */
+    U_TRACE_STAGE_AT_RESPONSE,  /**< waiting for, and reading, the response
+                                     of the module to an AT command. */
+    U_TRACE_STAGE_MAX_NUM
+} uTraceStage_t;
+
+/** The report of a traced operation, passed to the callback.
+ */
+typedef struct {
+    const char *pName;      /**< the name of the operation, e.g. "uSockWrite". */
+    int32_t result;         /**< the return value of the operation. */
+    int64_t startTimeUs;    /**< when the operation started, as returned
+                                 by uPortGetTickTimeUs(). */
+    int32_t durationUs;     /**< the total duration of the operation. */
+    int32_t stageUs[U_TRACE_STAGE_MAX_NUM];    /**< the time spent in each stage,
+                                                    indexed by #uTraceStage_t,
+                                                    exclusive of any stages
+                                                    nested inside it; these add
+                                                    up to durationUs. */
+    int32_t stageCount[U_TRACE_STAGE_MAX_NUM]; /**< the number of times each stage
+                                                    was entered, e.g. the number of
+                                                    AT commands is given by
+                                                    #U_TRACE_STAGE_AT_LOCK_WAIT. */
+} uTraceOperation_t;
+
+/** The callback that receives the report of each traced operation;
+ * it is called in the task that carried out the operation, just
+ * before the API returns, and so should be quick.
+ */
+typedef void (*uTraceCallback_t)(const uTraceOperation_t *pOperation,
+                                 void *pCallbackParam);
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Switch tracing on or off.  Operations already in progress when
+ * tracing is switched off are not reported.
+ *
+ * @param pCallback       the callback that will receive the report of
+ *                        each traced operation; use NULL to switch
+ *                        tracing off.
+ * @param pCallbackParam  a parameter that will be passed to pCallback.
+ */
+void uTraceCallbackSet(uTraceCallback_t pCallback, void *pCallbackParam);
+
+/** Start tracing an operation in the calling task; called by an API
+ * on the way in.  If the task is already in a traced operation,
+ * e.g. because one API has called another, the outer operation
+ * continues and this one is not traced separately.
+ *
+ * @param[in] pName  the name of the operation, e.g. "uSockWrite"; must
+ *                   remain valid until uTraceOperationStop() returns.
+ * @return           a handle for the operation, to be passed to
+ *                   uTraceOperationStop(), else negative error code,
+ *                   e.g. if tracing is off; there is no need to check
+ *                   it, uTraceOperationStop() will ignore a negative
+ *                   handle.
+ */
+int32_t uTraceOperationStart(const char *pName);
+
+/** Stop tracing an operation and report it to the callback.
+ *
+ * @param handle  the handle returned by uTraceOperationStart().
+ * @param result  the return value of the operation.
+ */
+void uTraceOperationStop(int32_t handle, int32_t result);
+
+/** Enter a stage of the operation the calling task is in, if any.
+ *
+ * @param stage  the stage.
+ * @return       true if the stage was entered, in which case
+ *               uTraceStagePop() must be called on the way out,
+ *               false if the calling task is not in a traced
+ *               operation.
+ */
+bool uTraceStagePush(uTraceStage_t stage);
+
+/** Leave the stage most recently entered with uTraceStagePush() by
+ * the calling task.
+ */
+void uTraceStagePop();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _U_TRACE_H_
+
+// End of file
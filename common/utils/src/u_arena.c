@@ -0,0 +1,150 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Implementation of an arena for scratch memory.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_error_common.h"
+
+#include "u_port_os.h"
+#include "u_port_heap.h"
+
+#include "u_arena.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+int32_t uArenaInit(uArena_t *pArena, void *pBuffer, size_t size)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pArena != NULL) && (size > 0)) {
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pArena->pBuffer = (char *) pBuffer;
+        pArena->isAllocated = false;
+        if (pBuffer == NULL) {
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pArena->pBuffer = (char *) pUPortMalloc(size);
+            if (pArena->pBuffer != NULL) {
+                pArena->isAllocated = true;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+        pArena->size = 0;
+        if (pArena->pBuffer != NULL) {
+            pArena->size = size;
+        }
+        pArena->used = 0;
+        pArena->usedMax = 0;
+    }
+
+    return errorCode;
+}
+
+void *pUArenaAlloc(uArena_t *pArena, size_t size)
+{
+    void *pMem = NULL;
+    size_t padding;
+
+    if (size > 0) {
+        // Align the address, rather than the offset, since the
+        // buffer passed to uArenaInit() may not itself be aligned
+        padding = (size_t) (-((uintptr_t) (pArena->pBuffer + pArena->used))) &
+                  (U_ARENA_ALIGNMENT_BYTES - 1);
+        if ((pArena->used + padding <= pArena->size) &&
+            (size <= pArena->size - pArena->used - padding)) {
+            pMem = pArena->pBuffer + pArena->used + padding;
+            pArena->used += padding + size;
+            if (pArena->used > pArena->usedMax) {
+                pArena->usedMax = pArena->used;
+            }
+        }
+    }
+
+    return pMem;
+}
+
+size_t uArenaGetMark(const uArena_t *pArena)
+{
+    return pArena->used;
+}
+
+void uArenaResetToMark(uArena_t *pArena, size_t mark)
+{
+    if (mark < pArena->used) {
+        pArena->used = mark;
+    }
+}
+
+void uArenaReset(uArena_t *pArena)
+{
+    pArena->used = 0;
+}
+
+size_t uArenaGetFree(const uArena_t *pArena)
+{
+    return pArena->size - pArena->used;
+}
+
+size_t uArenaGetUsedMax(const uArena_t *pArena)
+{
+    return pArena->usedMax;
+}
+
+void uArenaDeinit(uArena_t *pArena)
+{
+    if (pArena->isAllocated) {
+        uPortFree(pArena->pBuffer);
+    }
+    pArena->pBuffer = NULL;
+    pArena->isAllocated = false;
+    pArena->size = 0;
+    pArena->used = 0;
+}
+
+// End of file
@@ -30,6 +30,9 @@
 
 #include "stddef.h"    // size_t
 #include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_error_common.h"
 
 #include "u_base64.h"
 
@@ -43,6 +46,14 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** Values in gDecode[] for characters that are not base 64: all
+ * have the top bit set so that a whole quad of characters can be
+ * checked with a single test.
+ */
+#define U_B64_BAD 0xFF
+#define U_B64_WS  0xFE
+#define U_B64_PAD 0xFD
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -51,10 +62,99 @@
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
+/** Table to map a base 64 character to its six-bit value.
+ */
+static const uint8_t gDecode[256] = {
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x00
+   U_B64_BAD,  U_B64_WS,  U_B64_WS, U_B64_BAD, U_B64_BAD,  U_B64_WS, U_B64_BAD, U_B64_BAD, // 0x08
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x10
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x18
+    U_B64_WS, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x20
+   U_B64_BAD, U_B64_BAD, U_B64_BAD,        62, U_B64_BAD, U_B64_BAD, U_B64_BAD,        63, // 0x28
+          52,        53,        54,        55,        56,        57,        58,        59, // 0x30
+          60,        61, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_PAD, U_B64_BAD, U_B64_BAD, // 0x38
+   U_B64_BAD,         0,         1,         2,         3,         4,         5,         6, // 0x40
+           7,         8,         9,        10,        11,        12,        13,        14, // 0x48
+          15,        16,        17,        18,        19,        20,        21,        22, // 0x50
+          23,        24,        25, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x58
+   U_B64_BAD,        26,        27,        28,        29,        30,        31,        32, // 0x60
+          33,        34,        35,        36,        37,        38,        39,        40, // 0x68
+          41,        42,        43,        44,        45,        46,        47,        48, // 0x70
+          49,        50,        51, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x78
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x80
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x88
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x90
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0x98
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xa0
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xa8
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xb0
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xb8
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xc0
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xc8
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xd0
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xd8
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xe0
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xe8
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, // 0xf0
+   U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD, U_B64_BAD  // 0xf8
+};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Encode three bytes into four base 64 characters.
+static void encodeTriple(const uint8_t *pIn, char *pOut)
+{
+    uint32_t x = (((uint32_t) pIn[0]) << 16) | (((uint32_t) pIn[1]) << 8) | pIn[2];
+
+    pOut[0] = b64[(x >> 18) & 0x3f];
+    pOut[1] = b64[(x >> 12) & 0x3f];
+    pOut[2] = b64[(x >> 6) & 0x3f];
+    pOut[3] = b64[x & 0x3f];
+}
+
+// Write out the three bytes of a complete quad.
+static void decodeQuad(uint32_t x, char *pOut)
+{
+    pOut[0] = (char) (x >> 16);
+    pOut[1] = (char) (x >> 8);
+    pOut[2] = (char) x;
+}
+
+// Decode a single base 64 character of a stream, moving *ppOut on
+// by any bytes written; returns zero or negative error code.
+static int32_t decodeChar(uBase64DecodeStream_t *pStream, uint8_t character, char **ppOut)
+{
+    int32_t errorCode = 0;
+    uint32_t x = gDecode[character];
+
+    if (x == U_B64_WS) {
+        // Ignore
+    } else if ((x == U_B64_BAD) || pStream->done ||
+               ((x == U_B64_PAD) && (pStream->count < 2)) ||
+               ((x != U_B64_PAD) && (pStream->padCount > 0))) {
+        errorCode = (int32_t) U_ERROR_COMMON_BAD_DATA;
+    } else {
+        if (x == U_B64_PAD) {
+            pStream->padCount++;
+            x = 0;
+        }
+        pStream->accumulator = (pStream->accumulator << 6) | x;
+        pStream->count++;
+        if (pStream->count == 4) {
+            decodeQuad(pStream->accumulator, *ppOut);
+            *ppOut += 3 - pStream->padCount;
+            pStream->done = (pStream->padCount > 0);
+            pStream->accumulator = 0;
+            pStream->count = 0;
+            pStream->padCount = 0;
+        }
+    }
+
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -101,4 +201,178 @@ int32_t uBase64Decode(const char *pBase64, size_t base64LengthBytes,
     return bytesDecoded;
 }
 
+// Initialise a streaming base 64 encode.
+void uBase64EncodeStreamInit(uBase64EncodeStream_t *pStream)
+{
+    pStream->carryLength = 0;
+}
+
+// Base 64 encode a chunk of a stream.
+int32_t uBase64EncodeStream(uBase64EncodeStream_t *pStream,
+                            const char *pBinary, size_t binaryLengthBytes,
+                            char *pBase64, size_t base64LengthBytes)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    const uint8_t *pIn = (const uint8_t *) pBinary;
+    uint8_t triple[3];
+    size_t length;
+    char *pOut = pBase64;
+
+    if ((pBinary != NULL) || (binaryLengthBytes == 0)) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        length = ((pStream->carryLength + binaryLengthBytes) / 3) * 4;
+        if ((length == 0) || ((pBase64 != NULL) && (base64LengthBytes >= length))) {
+            // Complete a triple with what was carried over first
+            if ((pStream->carryLength > 0) &&
+                (pStream->carryLength + binaryLengthBytes >= 3)) {
+                for (size_t x = 0; x < 3; x++) {
+                    if (x < pStream->carryLength) {
+                        triple[x] = pStream->carry[x];
+                    } else {
+                        triple[x] = *pIn;
+                        pIn++;
+                        binaryLengthBytes--;
+                    }
+                }
+                pStream->carryLength = 0;
+                encodeTriple(triple, pOut);
+                pOut += 4;
+            }
+            // The fast path: whole triples straight from the input
+            while ((pStream->carryLength == 0) && (binaryLengthBytes >= 3)) {
+                encodeTriple(pIn, pOut);
+                pIn += 3;
+                pOut += 4;
+                binaryLengthBytes -= 3;
+            }
+            // Keep what remains for next time
+            while (binaryLengthBytes > 0) {
+                pStream->carry[pStream->carryLength] = *pIn;
+                pStream->carryLength++;
+                pIn++;
+                binaryLengthBytes--;
+            }
+            errorCodeOrLength = (int32_t) (pOut - pBase64);
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Finish a streaming base 64 encode.
+int32_t uBase64EncodeStreamFinish(uBase64EncodeStream_t *pStream,
+                                  char *pBase64, size_t base64LengthBytes)
+{
+    int32_t errorCodeOrLength = 0;
+    uint8_t triple[3] = {0};
+
+    if (pStream->carryLength > 0) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        if ((pBase64 != NULL) && (base64LengthBytes >= 4)) {
+            for (size_t x = 0; x < pStream->carryLength; x++) {
+                triple[x] = pStream->carry[x];
+            }
+            encodeTriple(triple, pBase64);
+            pBase64[3] = '=';
+            if (pStream->carryLength == 1) {
+                pBase64[2] = '=';
+            }
+            pStream->carryLength = 0;
+            errorCodeOrLength = 4;
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Initialise a streaming base 64 decode.
+void uBase64DecodeStreamInit(uBase64DecodeStream_t *pStream)
+{
+    pStream->accumulator = 0;
+    pStream->count = 0;
+    pStream->padCount = 0;
+    pStream->done = false;
+}
+
+// Decode a chunk of a base 64 stream.
+int32_t uBase64DecodeStream(uBase64DecodeStream_t *pStream,
+                            const char *pBase64, size_t base64LengthBytes,
+                            char *pBinary, size_t binaryLengthBytes)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    const uint8_t *pIn = (const uint8_t *) pBase64;
+    const uint8_t *pEnd = pIn + base64LengthBytes;
+    char *pOut = pBinary;
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    uint32_t d;
+    bool quadIsClean;
+
+    if ((pBase64 != NULL) || (base64LengthBytes == 0)) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        // White space means this is pessimistic but it is simple
+        if (((pStream->count + base64LengthBytes) < 4) ||
+            ((pBinary != NULL) &&
+             (binaryLengthBytes >= ((pStream->count + base64LengthBytes) / 4) * 3))) {
+            errorCodeOrLength = 0;
+            while ((pIn < pEnd) && (errorCodeOrLength == 0)) {
+                quadIsClean = false;
+                if ((pStream->count == 0) && !pStream->done && (pEnd - pIn >= 4)) {
+                    a = gDecode[pIn[0]];
+                    b = gDecode[pIn[1]];
+                    c = gDecode[pIn[2]];
+                    d = gDecode[pIn[3]];
+                    quadIsClean = (((a | b | c | d) & 0x80) == 0);
+                }
+                if (quadIsClean) {
+                    // The fast path: a whole quad with nothing
+                    // special in it goes straight through
+                    decodeQuad((a << 18) | (b << 12) | (c << 6) | d, pOut);
+                    pOut += 3;
+                    pIn += 4;
+                } else {
+                    // The slow path, one character at a time
+                    errorCodeOrLength = decodeChar(pStream, *pIn, &pOut);
+                    pIn++;
+                }
+            }
+            if (errorCodeOrLength == 0) {
+                errorCodeOrLength = (int32_t) (pOut - pBinary);
+            }
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Finish a streaming base 64 decode.
+int32_t uBase64DecodeStreamFinish(uBase64DecodeStream_t *pStream,
+                                  char *pBinary, size_t binaryLengthBytes)
+{
+    int32_t errorCodeOrLength = 0;
+    size_t numChars = pStream->count - pStream->padCount;
+    char quad[3];
+
+    if (pStream->count > 0) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_TRUNCATED;
+        if (numChars > 1) {
+            // Incomplete: two characters make one byte, three make two
+            errorCodeOrLength = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            if ((pBinary != NULL) && (binaryLengthBytes >= numChars - 1)) {
+                decodeQuad(pStream->accumulator << (6 * (4 - pStream->count)), quad);
+                errorCodeOrLength = (int32_t) (numChars - 1);
+                for (int32_t x = 0; x < errorCodeOrLength; x++) {
+                    pBinary[x] = quad[x];
+                }
+            }
+        }
+    }
+    if (errorCodeOrLength >= 0) {
+        uBase64DecodeStreamInit(pStream);
+    }
+
+    return errorCodeOrLength;
+}
+
 // End of file
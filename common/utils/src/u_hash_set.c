@@ -0,0 +1,188 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Implementation of a small open-addressing hash set of
+ * pointers.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_error_common.h"
+
+#include "u_hash_set.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Get the slot at which p would ideally be stored: the low bits
+// of a pointer are usually zero because of alignment, hence the
+// bits are mixed before the mask is applied.
+static size_t homeSlot(const uHashSet_t *pSet, const void *p)
+{
+    uintptr_t x = (uintptr_t) p;
+    // Two shifts of 16 so as not to shift a 32-bit value by 32
+    uint32_t hash = (uint32_t) x ^ (uint32_t) ((x >> 16) >> 16);
+
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bUL;
+    hash ^= hash >> 16;
+
+    return hash & (pSet->numSlots - 1);
+}
+
+// Find the slot holding p, returning numSlots if it is not there.
+static size_t findSlot(const uHashSet_t *pSet, const void *p)
+{
+    size_t mask = pSet->numSlots - 1;
+    size_t slot = pSet->numSlots;
+    size_t x = homeSlot(pSet, p);
+
+    for (size_t y = 0; (y < pSet->numSlots) && (pSet->ppSlots[x] != NULL) &&
+         (slot == pSet->numSlots); y++) {
+        if (pSet->ppSlots[x] == p) {
+            slot = x;
+        }
+        x = (x + 1) & mask;
+    }
+
+    return slot;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+int32_t uHashSetInit(uHashSet_t *pSet, const void **ppSlots, size_t numSlots)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pSet != NULL) && (ppSlots != NULL) && (numSlots > 0) &&
+        ((numSlots & (numSlots - 1)) == 0)) {
+        pSet->ppSlots = ppSlots;
+        pSet->numSlots = numSlots;
+        uHashSetClear(pSet);
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+int32_t uHashSetAdd(uHashSet_t *pSet, const void *p)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    size_t mask;
+    size_t x;
+
+    if (p != NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        if (findSlot(pSet, p) == pSet->numSlots) {
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            if (pSet->numEntries < pSet->numSlots) {
+                // Not there and there is room: take the first
+                // empty slot from the home slot onwards
+                mask = pSet->numSlots - 1;
+                x = homeSlot(pSet, p);
+                while (pSet->ppSlots[x] != NULL) {
+                    x = (x + 1) & mask;
+                }
+                pSet->ppSlots[x] = p;
+                pSet->numEntries++;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+bool uHashSetContains(const uHashSet_t *pSet, const void *p)
+{
+    return (p != NULL) && (findSlot(pSet, p) < pSet->numSlots);
+}
+
+bool uHashSetRemove(uHashSet_t *pSet, const void *p)
+{
+    bool removed = false;
+    size_t mask = pSet->numSlots - 1;
+    size_t hole;
+    size_t x;
+    size_t home;
+
+    if (p != NULL) {
+        hole = findSlot(pSet, p);
+        if (hole < pSet->numSlots) {
+            // Rather than leave a marker behind, shift back any
+            // entry further along the run that would no longer be
+            // found with a hole between it and its home slot; the
+            // run ends at an empty slot or, if the set is full,
+            // after going all the way round
+            x = (hole + 1) & mask;
+            for (size_t y = 1; (y < pSet->numSlots) && (pSet->ppSlots[x] != NULL); y++) {
+                home = homeSlot(pSet, pSet->ppSlots[x]);
+                if (((x - home) & mask) >= ((x - hole) & mask)) {
+                    pSet->ppSlots[hole] = pSet->ppSlots[x];
+                    hole = x;
+                }
+                x = (x + 1) & mask;
+            }
+            pSet->ppSlots[hole] = NULL;
+            pSet->numEntries--;
+            removed = true;
+        }
+    }
+
+    return removed;
+}
+
+size_t uHashSetGetCount(const uHashSet_t *pSet)
+{
+    return pSet->numEntries;
+}
+
+void uHashSetClear(uHashSet_t *pSet)
+{
+    memset((void *) pSet->ppSlots, 0, pSet->numSlots * sizeof(pSet->ppSlots[0]));
+    pSet->numEntries = 0;
+}
+
+// End of file
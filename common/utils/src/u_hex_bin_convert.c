@@ -32,6 +32,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memcpy()
 
 #include "u_assert.h"
 
@@ -49,24 +50,97 @@
  * VARIABLES
  * -------------------------------------------------------------- */
 
-static const char gHex[] = {'0', '1', '2', '3', '4', '5', '6', '7',
-                            '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
-                           };
+/** The ASCII hex of every byte value, two characters per byte, so
+ * that a byte is converted with a single two-byte copy.
+ */
+static const char gByteToHex[] =
+    "000102030405060708090A0B0C0D0E0F"
+    "101112131415161718191A1B1C1D1E1F"
+    "202122232425262728292A2B2C2D2E2F"
+    "303132333435363738393A3B3C3D3E3F"
+    "404142434445464748494A4B4C4D4E4F"
+    "505152535455565758595A5B5C5D5E5F"
+    "606162636465666768696A6B6C6D6E6F"
+    "707172737475767778797A7B7C7D7E7F"
+    "808182838485868788898A8B8C8D8E8F"
+    "909192939495969798999A9B9C9D9E9F"
+    "A0A1A2A3A4A5A6A7A8A9AAABACADAEAF"
+    "B0B1B2B3B4B5B6B7B8B9BABBBCBDBEBF"
+    "C0C1C2C3C4C5C6C7C8C9CACBCCCDCECF"
+    "D0D1D2D3D4D5D6D7D8D9DADBDCDDDEDF"
+    "E0E1E2E3E4E5E6E7E8E9EAEBECEDEEEF"
+    "F0F1F2F3F4F5F6F7F8F9FAFBFCFDFEFF";
+
+/** Table to convert an ASCII hex character into its value,
+ * 0xff for a character that is not valid ASCII hex; indexed
+ * by the character as an unsigned char.
+ */
+static const unsigned char gHexToNibble[256] = {
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff
+};
 
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Write the ASCII hex of the byte c to pHex.
+static void byteToHex(unsigned char c, char *pHex)
+{
+    memcpy(pHex, &(gByteToHex[c * 2]), 2);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
 size_t uBinToHex(const char *pBin, size_t binLength, char *pHex)
 {
+    const unsigned char *pIn = (const unsigned char *) pBin;
+    size_t x = binLength;
+
     U_ASSERT(pHex != NULL);
 
-    for (size_t x = 0; x < binLength; x++) {
-        *pHex = gHex[((unsigned char) * pBin) >> 4];
-        pHex++;
-        *pHex = gHex[*pBin & 0x0f];
-        pHex++;
-        pBin++;
+    // Four bytes at a time, then the rest
+    for (; x >= 4; x -= 4) {
+        byteToHex(pIn[0], pHex);
+        byteToHex(pIn[1], pHex + 2);
+        byteToHex(pIn[2], pHex + 4);
+        byteToHex(pIn[3], pHex + 6);
+        pIn += 4;
+        pHex += 8;
+    }
+    for (; x > 0; x--) {
+        byteToHex(*pIn, pHex);
+        pIn++;
+        pHex += 2;
+    }
+
+    return binLength * 2;
+}
+
+size_t uBinToHexInPlace(char *pBuffer, size_t binLength)
+{
+    U_ASSERT(pBuffer != NULL);
+
+    // Work backwards so that each byte is read before its
+    // position is overwritten
+    for (size_t x = binLength; x > 0; x--) {
+        byteToHex((unsigned char) pBuffer[x - 1], pBuffer + ((x - 1) * 2));
     }
 
     return binLength * 2;
@@ -74,35 +148,43 @@ size_t uBinToHex(const char *pBin, size_t binLength, char *pHex)
 
 size_t uHexToBin(const char *pHex, size_t hexLength, char *pBin)
 {
-    bool success = true;
-    size_t length;
-    char z[2];
+    const unsigned char *pIn = (const unsigned char *) pHex;
+    size_t length = 0;
+    size_t numBytes = hexLength / 2;
+    unsigned char z0;
+    unsigned char z1;
+    unsigned char z2;
+    unsigned char z3;
+    bool valid = true;
 
     U_ASSERT(pBin != NULL);
 
-    for (length = 0; (length < hexLength / 2) && success; length++) {
-        z[0] = *pHex - '0';
-        pHex++;
-        z[1] = *pHex - '0';
-        pHex++;
-        for (size_t y = 0; (y < sizeof(z)) && success; y++) {
-            if (z[y] > 9) {
-                // Must be A to F or a to f
-                z[y] -= 'A' - '0';
-                z[y] += 10;
-            }
-            if (z[y] > 15) {
-                // Must be a to f
-                z[y] -= 'a' - 'A';
-            }
-            // Cast here to shut-up a warning under ESP-IDF
-            // which appears to have chars as unsigned and
-            // hence thinks the first condition is always true
-            success = ((signed char) z[y] >= 0) && (z[y] <= 15);
+    // Two bytes at a time, with a single validity check; the output
+    // never overtakes the input so pBin may be the same as pHex
+    while ((length + 2 <= numBytes) && valid) {
+        z0 = gHexToNibble[pIn[0]];
+        z1 = gHexToNibble[pIn[1]];
+        z2 = gHexToNibble[pIn[2]];
+        z3 = gHexToNibble[pIn[3]];
+        valid = ((z0 | z1 | z2 | z3) <= 0x0f);
+        if (valid) {
+            pBin[length] = (char) ((z0 << 4) | z1);
+            pBin[length + 1] = (char) ((z2 << 4) | z3);
+            length += 2;
+            pIn += 4;
         }
-        if (success) {
-            *pBin = (char) (((z[0] & 0x0f) << 4) | z[1]);
-            pBin++;
+    }
+    // Then one at a time, stopping at anything that is not valid
+    // ASCII hex
+    valid = true;
+    while ((length < numBytes) && valid) {
+        z0 = gHexToNibble[pIn[0]];
+        z1 = gHexToNibble[pIn[1]];
+        valid = ((z0 | z1) <= 0x0f);
+        if (valid) {
+            pBin[length] = (char) ((z0 << 4) | z1);
+            length++;
+            pIn += 2;
         }
     }
 
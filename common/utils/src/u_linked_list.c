@@ -104,4 +104,73 @@ bool uLinkedListRemove(uLinkedList_t **ppList, void *p)
     return false;
 }
 
+void uIntrusiveListInit(uIntrusiveList_t *pList)
+{
+    pList->pNext = pList;
+    pList->pPrev = pList;
+}
+
+void uIntrusiveListNodeInit(uIntrusiveListNode_t *pNode)
+{
+    pNode->pNext = NULL;
+    pNode->pPrev = NULL;
+}
+
+bool uIntrusiveListAdd(uIntrusiveList_t *pList, uIntrusiveListNode_t *pNode)
+{
+    bool added = false;
+
+    if (pNode->pNext == NULL) {
+        pNode->pNext = pList;
+        pNode->pPrev = pList->pPrev;
+        pList->pPrev->pNext = pNode;
+        pList->pPrev = pNode;
+        added = true;
+    }
+
+    return added;
+}
+
+bool uIntrusiveListRemove(uIntrusiveListNode_t *pNode)
+{
+    bool removed = false;
+
+    if (pNode->pNext != NULL) {
+        pNode->pPrev->pNext = pNode->pNext;
+        pNode->pNext->pPrev = pNode->pPrev;
+        pNode->pNext = NULL;
+        pNode->pPrev = NULL;
+        removed = true;
+    }
+
+    return removed;
+}
+
+bool uIntrusiveListNodeIsListed(const uIntrusiveListNode_t *pNode)
+{
+    return pNode->pNext != NULL;
+}
+
+bool uIntrusiveListIsEmpty(const uIntrusiveList_t *pList)
+{
+    return pList->pNext == pList;
+}
+
+uIntrusiveListNode_t *pUIntrusiveListFirst(uIntrusiveList_t *pList)
+{
+    return pUIntrusiveListNext(pList, pList);
+}
+
+uIntrusiveListNode_t *pUIntrusiveListNext(uIntrusiveList_t *pList,
+                                          uIntrusiveListNode_t *pNode)
+{
+    uIntrusiveListNode_t *pNext = pNode->pNext;
+
+    if (pNext == pList) {
+        pNext = NULL;
+    }
+
+    return pNext;
+}
+
 // End of file
@@ -33,6 +33,7 @@
 #include "stdbool.h"
 
 #include "u_cfg_sw.h"
+#include "u_compiler.h" // U_ATOMIC_xxx
 #include "u_assert.h"
 #include "u_port.h"
 #include "u_port_os.h"
@@ -64,6 +65,13 @@
 
 #define U_FENCE_MAGIC 0xBEEF
 
+// For a lock-free pool: the part of the free stack head, and of
+// the link stored in each free block, which is the index plus one
+// of a block (zero meaning none) and the increment applied to the
+// ABA tag in the rest of the head on every change.
+#define U_LOCK_FREE_LINK_MASK 0xFFFFUL
+#define U_LOCK_FREE_TAG_INCREMENT 0x10000UL
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -101,21 +109,238 @@ static void initFreeList(uMemPoolDesc_t *pMemPool)
     pMemPool->usedBlockCount = 0;
 }
 
+// Get a pointer to the block with the given index.
+static uint8_t *pBlock(const uMemPoolDesc_t *pMemPool, uint32_t index)
+{
+    return &pMemPool->pBuffer[index * U_REAL_BLOCK_SIZE(pMemPool->blockSize)];
+}
+
+// Get the lock-free link (index plus one) of a block of a pool.
+static uint32_t blockLink(const uMemPoolDesc_t *pMemPool, const void *pMem)
+{
+    U_ASSERT((const uint8_t *)pMem >= pMemPool->pBuffer);
+    U_ASSERT((const uint8_t *)pMem < (pMemPool->pBuffer + U_BUFFER_SIZE(pMemPool)));
+    return (uint32_t) (((const uint8_t *)pMem - pMemPool->pBuffer) /
+                       U_REAL_BLOCK_SIZE(pMemPool->blockSize)) + 1;
+}
+
+// Add the fence to a block that is being allocated.
+static void fenceSet(const uMemPoolDesc_t *pMemPool, void *pMem)
+{
+#if U_MEMPOOL_USE_BUF_FENCE
+    // Add the memory fence right after the user allocation
+    uint8_t *pDataPtr = (uint8_t *)pMem;
+    uint16_t *pMagic = (uint16_t *)&pDataPtr[pMemPool->blockSize];
+    *pMagic = U_FENCE_MAGIC;
+#else
+    (void) pMemPool;
+    (void) pMem;
+#endif
+}
+
+// Check and remove the fence of a block that is being freed.
+static void fenceCheck(const uMemPoolDesc_t *pMemPool, void *pMem)
+{
+    // Make sure the memory segment is within our buffer
+    U_ASSERT((uint8_t *)pMem >= pMemPool->pBuffer);
+    U_ASSERT((uint8_t *)pMem < (pMemPool->pBuffer + U_BUFFER_SIZE(pMemPool)));
+#if U_MEMPOOL_USE_BUF_FENCE
+    // Validate the magic number
+    uint8_t *pDataPtr = (uint8_t *)pMem;
+    uint16_t *pMagic = (uint16_t *)&pDataPtr[pMemPool->blockSize];
+    U_ASSERT(*pMagic == U_FENCE_MAGIC);
+    // Invalidate
+    *pMagic = 0;
+#endif
+}
+
+// Initialise the lock-free stack of free blocks: each free block
+// holds the link to the next free block in its first 32 bits.
+static void initFreeStack(uMemPoolDesc_t *pMemPool)
+{
+    uint32_t head;
+    uint32_t numBlocks = (uint32_t) pMemPool->totalBlockCount;
+
+    U_ASSERT(pMemPool->pBuffer != NULL);
+    for (uint32_t i = 0; i < numBlocks; i++) {
+        *((uint32_t *) pBlock(pMemPool, i)) = (i + 1 < numBlocks) ? i + 2 : 0;
+    }
+    // Keep the tag moving so that anything in flight fails its swap
+    head = U_ATOMIC_GET(&pMemPool->freeHead);
+    head = ((head & ~U_LOCK_FREE_LINK_MASK) + U_LOCK_FREE_TAG_INCREMENT) |
+           ((numBlocks > 0) ? 1 : 0);
+    U_ATOMIC_SET(&pMemPool->freeHead, head);
+    U_ATOMIC_SET(&pMemPool->usedBlockCount, 0);
+}
+
+// Pop up to count blocks from the lock-free stack of free blocks.
+static int32_t popLockFree(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count)
+{
+    uint32_t head;
+    uint32_t link;
+    uint32_t numBlocks = (uint32_t) pMemPool->totalBlockCount;
+    int32_t numPopped;
+    bool retry;
+
+    do {
+        retry = false;
+        numPopped = 0;
+        head = U_ATOMIC_GET(&pMemPool->freeHead);
+        link = head & U_LOCK_FREE_LINK_MASK;
+        // Walk down the stack; if another task pops any of these
+        // blocks meanwhile the links may be rubbish but the tag
+        // of the head will have changed and so the swap will fail
+        while ((numPopped < count) && (link != 0) && !retry) {
+            if (link > numBlocks) {
+                retry = true;
+            } else {
+                ppMem[numPopped] = pBlock(pMemPool, link - 1);
+                link = *((volatile uint32_t *) ppMem[numPopped]);
+                numPopped++;
+            }
+        }
+        if (!retry && (numPopped > 0)) {
+            retry = !U_ATOMIC_COMPARE_AND_SWAP(&pMemPool->freeHead, head,
+                                               ((head & ~U_LOCK_FREE_LINK_MASK) +
+                                                U_LOCK_FREE_TAG_INCREMENT) | link);
+        }
+    } while (retry);
+
+    return numPopped;
+}
+
+// Push count blocks, none of which may be NULL, onto the lock-free
+// stack of free blocks.
+static void pushLockFree(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count)
+{
+    uint32_t head;
+    volatile uint32_t *pLastLink;
+
+    // Chain the blocks together first, outside the atomic section
+    for (int32_t i = 0; i + 1 < count; i++) {
+        *((uint32_t *) ppMem[i]) = blockLink(pMemPool, ppMem[i + 1]);
+    }
+    pLastLink = (volatile uint32_t *) ppMem[count - 1];
+    do {
+        head = U_ATOMIC_GET(&pMemPool->freeHead);
+        *pLastLink = head & U_LOCK_FREE_LINK_MASK;
+    } while (!U_ATOMIC_COMPARE_AND_SWAP(&pMemPool->freeHead, head,
+                                        ((head & ~U_LOCK_FREE_LINK_MASK) +
+                                         U_LOCK_FREE_TAG_INCREMENT) |
+                                        blockLink(pMemPool, ppMem[0])));
+}
+
+// Keep the statistics for an allocation of numAllocated blocks
+// of the count that were asked for.
+static void statsAlloc(uMemPoolDesc_t *pMemPool, int32_t numAllocated, int32_t count)
+{
+    int32_t used;
+    int32_t usedMax;
+
+    if (numAllocated > 0) {
+        // U_ATOMIC_ADD() returns the old value
+        used = U_ATOMIC_ADD(&pMemPool->usedBlockCount, numAllocated) + numAllocated;
+        U_ATOMIC_ADD(&pMemPool->allocCount, numAllocated);
+        do {
+            usedMax = U_ATOMIC_GET(&pMemPool->usedBlockCountMax);
+        } while ((used > usedMax) &&
+                 !U_ATOMIC_COMPARE_AND_SWAP(&pMemPool->usedBlockCountMax, usedMax, used));
+    }
+    if (numAllocated < count) {
+        U_ATOMIC_ADD(&pMemPool->allocFailCount, 1);
+    }
+}
+
+// Keep the statistics for the freeing of count blocks.
+static void statsFree(uMemPoolDesc_t *pMemPool, int32_t count)
+{
+    U_ATOMIC_ADD(&pMemPool->usedBlockCount, -count);
+    U_ATOMIC_ADD(&pMemPool->freeCount, count);
+}
+
+// Allocate the buffer of a pool and initialise its free list/stack;
+// the mutex must be locked or the pool otherwise not in use.
+static void allocBuffer(uMemPoolDesc_t *pMemPool)
+{
+    pMemPool->pBuffer = (uint8_t *)pUPortMalloc(U_BUFFER_SIZE(pMemPool));
+    uPortLog("U_MEM_POOL: allocated buffer %p.\n", pMemPool->pBuffer);
+    if (pMemPool->pBuffer != NULL) {
+        if (pMemPool->flags & U_MEMPOOL_FLAG_LOCK_FREE) {
+            initFreeStack(pMemPool);
+        } else {
+            initFreeList(pMemPool);
+        }
+    }
+}
+
+// Allocate up to count blocks from a mutex-protected pool; the
+// mutex must be locked.
+static int32_t allocLocked(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count)
+{
+    int32_t numAllocated = 0;
+
+    // If this is the first allocation we need to allocate the buffer
+    if (pMemPool->pBuffer == NULL) {
+        allocBuffer(pMemPool);
+    }
+
+    // Grab the free memory available in the free list
+    while ((numAllocated < count) && (pMemPool->pFreeList != NULL)) {
+        ppMem[numAllocated] = pMemPool->pFreeList;
+        pMemPool->pFreeList = pMemPool->pFreeList->pNext;
+        numAllocated++;
+    }
+
+    return numAllocated;
+}
+
+// Free a block to a mutex-protected pool; the mutex must be locked.
+static void freeLocked(uMemPoolDesc_t *pMemPool, void *pMem)
+{
+    void *pMemNext;
+
+    fenceCheck(pMemPool, pMem);
+    // Add the freed memory reference before the head
+    pMemNext = pMemPool->pFreeList;
+    pMemPool->pFreeList = (uMemPoolFreeList_t *)pMem;
+    pMemPool->pFreeList->pNext = (uMemPoolFreeList_t *)pMemNext;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
 
 int32_t uMemPoolInit(uMemPoolDesc_t *pMemPool, uint32_t blockSize, int32_t blkCount)
+{
+    return uMemPoolInitFlags(pMemPool, blockSize, blkCount, 0);
+}
+
+int32_t uMemPoolInitFlags(uMemPoolDesc_t *pMemPool, uint32_t blockSize,
+                          int32_t blkCount, uint32_t flags)
 {
     int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
 
-    if ((pMemPool != NULL) && (blockSize >= sizeof(uMemPoolFreeList_t))) {
+    if (flags & U_MEMPOOL_FLAG_LOCK_FREE) {
+        flags |= U_MEMPOOL_FLAG_EAGER_INIT;
+    }
+    if ((pMemPool != NULL) && (blockSize >= sizeof(uMemPoolFreeList_t)) &&
+        (((flags & U_MEMPOOL_FLAG_LOCK_FREE) == 0) ||
+         ((blkCount > 0) && (blkCount <= U_MEMPOOL_LOCK_FREE_MAX_NUM_BLOCKS)))) {
         memset(pMemPool, 0, sizeof(uMemPoolDesc_t));
         pMemPool->blockSize = blockSize;
         pMemPool->usedBlockCount = 0;
         pMemPool->totalBlockCount = blkCount;
+        pMemPool->flags = flags;
 
         err = uPortMutexCreate(&pMemPool->mutex);
+        if ((err == 0) && (flags & U_MEMPOOL_FLAG_EAGER_INIT)) {
+            allocBuffer(pMemPool);
+            if (pMemPool->pBuffer == NULL) {
+                uPortMutexDelete(pMemPool->mutex);
+                memset(pMemPool, 0, sizeof(uMemPoolDesc_t));
+                err = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+            }
+        }
     }
 
     return err;
@@ -142,67 +367,72 @@ void *uMemPoolAllocMem(uMemPoolDesc_t *pMemPool)
 {
     void *pAllocMem = NULL;
 
-    if ((pMemPool != NULL) && (pMemPool->mutex != NULL)) {
-
-        U_PORT_MUTEX_LOCK(pMemPool->mutex);
+    uMemPoolAllocBatch(pMemPool, &pAllocMem, 1);
 
-        // If this is the first call to uMemPoolAllocMem we need to
-        // allocate the buffer
-        if (pMemPool->pBuffer == NULL) {
-            pMemPool->pBuffer = (uint8_t *)pUPortMalloc(U_BUFFER_SIZE(pMemPool));
-            uPortLog("U_MEM_POOL: allocated buffer %p.\n", pMemPool->pBuffer);
-            if (pMemPool->pBuffer != NULL) {
-                initFreeList(pMemPool);
-            }
-        }
+    return pAllocMem;
+}
 
-        // Grab the free memory available in the free list
-        if (pMemPool->pFreeList) {
-            pAllocMem = pMemPool->pFreeList;
-            pMemPool->pFreeList = pMemPool->pFreeList->pNext;
-            pMemPool->usedBlockCount++;
+int32_t uMemPoolAllocBatch(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count)
+{
+    int32_t numAllocated = 0;
+
+    if ((pMemPool != NULL) && (ppMem != NULL) && (count > 0) &&
+        (pMemPool->mutex != NULL)) {
+        if (pMemPool->flags & U_MEMPOOL_FLAG_LOCK_FREE) {
+            numAllocated = popLockFree(pMemPool, ppMem, count);
+        } else {
+            U_PORT_MUTEX_LOCK(pMemPool->mutex);
+            numAllocated = allocLocked(pMemPool, ppMem, count);
+            U_PORT_MUTEX_UNLOCK(pMemPool->mutex);
         }
-
-#if U_MEMPOOL_USE_BUF_FENCE
-        // Add the memory fence right after the user allocation
-        if (pAllocMem != NULL) {
-            uint8_t *pDataPtr = (uint8_t *)pAllocMem;
-            uint16_t *pMagic = (uint16_t *)&pDataPtr[pMemPool->blockSize];
-            *pMagic = U_FENCE_MAGIC;
+        statsAlloc(pMemPool, numAllocated, count);
+        // The blocks are ours now, no need to lock to add the fences
+        for (int32_t i = 0; i < numAllocated; i++) {
+            fenceSet(pMemPool, ppMem[i]);
         }
-#endif
-
-        U_PORT_MUTEX_UNLOCK(pMemPool->mutex);
     }
 
-    return pAllocMem;
+    return numAllocated;
 }
 
 void uMemPoolFreeMem(uMemPoolDesc_t *pMemPool, void *pMem)
 {
-    void *pMemNext;
-
-    if ((pMemPool != NULL) && (pMem != NULL) && (pMemPool->mutex != NULL)) {
-        U_PORT_MUTEX_LOCK(pMemPool->mutex);
-        // Make sure the memory segment is within our buffer
-        U_ASSERT((uint8_t *)pMem >= pMemPool->pBuffer);
-        U_ASSERT((uint8_t *)pMem < (pMemPool->pBuffer + U_BUFFER_SIZE(pMemPool)));
-
-#if U_MEMPOOL_USE_BUF_FENCE
-        // Validate the magic number
-        uint8_t *pDataPtr = (uint8_t *)pMem;
-        uint16_t *pMagic = (uint16_t *)&pDataPtr[pMemPool->blockSize];
-        U_ASSERT(*pMagic == U_FENCE_MAGIC);
-        // Invalidate
-        *pMagic = 0;
-#endif
+    uMemPoolFreeBatch(pMemPool, &pMem, 1);
+}
 
-        // Add the freed memory reference before the head
-        pMemNext = pMemPool->pFreeList;
-        pMemPool->pFreeList = (uMemPoolFreeList_t *)pMem;
-        pMemPool->pFreeList->pNext = (uMemPoolFreeList_t *)pMemNext;
-        pMemPool->usedBlockCount--;
-        U_PORT_MUTEX_UNLOCK(pMemPool->mutex);
+void uMemPoolFreeBatch(uMemPoolDesc_t *pMemPool, void **ppMem, int32_t count)
+{
+    int32_t i = 0;
+    int32_t j;
+
+    if ((pMemPool != NULL) && (ppMem != NULL) && (count > 0) &&
+        (pMemPool->mutex != NULL)) {
+        if (pMemPool->flags & U_MEMPOOL_FLAG_LOCK_FREE) {
+            // Push each run of non-NULL entries in one go
+            while (i < count) {
+                while ((i < count) && (ppMem[i] == NULL)) {
+                    i++;
+                }
+                for (j = i; (j < count) && (ppMem[j] != NULL); j++) {
+                    fenceCheck(pMemPool, ppMem[j]);
+                }
+                if (j > i) {
+                    pushLockFree(pMemPool, &(ppMem[i]), j - i);
+                    statsFree(pMemPool, j - i);
+                }
+                i = j;
+            }
+        } else {
+            U_PORT_MUTEX_LOCK(pMemPool->mutex);
+            for (j = 0; i < count; i++) {
+                if (ppMem[i] != NULL) {
+                    freeLocked(pMemPool, ppMem[i]);
+                    j++;
+                }
+            }
+            U_PORT_MUTEX_UNLOCK(pMemPool->mutex);
+            statsFree(pMemPool, j);
+        }
     }
 }
 
@@ -210,9 +440,53 @@ void uMemPoolFreeAllMem(uMemPoolDesc_t *pMemPool)
 {
     if ((pMemPool != NULL) && (pMemPool->mutex != NULL)) {
         U_PORT_MUTEX_LOCK(pMemPool->mutex);
-        initFreeList(pMemPool);
+        if (pMemPool->flags & U_MEMPOOL_FLAG_LOCK_FREE) {
+            initFreeStack(pMemPool);
+        } else {
+            initFreeList(pMemPool);
+        }
         U_PORT_MUTEX_UNLOCK(pMemPool->mutex);
     }
 }
 
+bool uMemPoolContains(uMemPoolDesc_t *pMemPool, const void *pMem)
+{
+    bool contains = false;
+
+    if ((pMemPool != NULL) && (pMem != NULL) && (pMemPool->mutex != NULL)) {
+        if (pMemPool->flags & U_MEMPOOL_FLAG_EAGER_INIT) {
+            // The buffer of an eagerly-initialised pool never
+            // changes, no need to lock
+            contains = ((const uint8_t *)pMem >= pMemPool->pBuffer) &&
+                       ((const uint8_t *)pMem < (pMemPool->pBuffer + U_BUFFER_SIZE(pMemPool)));
+        } else {
+            U_PORT_MUTEX_LOCK(pMemPool->mutex);
+            contains = (pMemPool->pBuffer != NULL) &&
+                       ((const uint8_t *)pMem >= pMemPool->pBuffer) &&
+                       ((const uint8_t *)pMem < (pMemPool->pBuffer + U_BUFFER_SIZE(pMemPool)));
+            U_PORT_MUTEX_UNLOCK(pMemPool->mutex);
+        }
+    }
+
+    return contains;
+}
+
+int32_t uMemPoolGetStats(uMemPoolDesc_t *pMemPool, uMemPoolStats_t *pStats)
+{
+    int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pMemPool != NULL) && (pStats != NULL)) {
+        pStats->blockSize = pMemPool->blockSize;
+        pStats->totalBlockCount = pMemPool->totalBlockCount;
+        pStats->usedBlockCount = U_ATOMIC_GET(&pMemPool->usedBlockCount);
+        pStats->usedBlockCountMax = U_ATOMIC_GET(&pMemPool->usedBlockCountMax);
+        pStats->allocCount = U_ATOMIC_GET(&pMemPool->allocCount);
+        pStats->freeCount = U_ATOMIC_GET(&pMemPool->freeCount);
+        pStats->allocFailCount = U_ATOMIC_GET(&pMemPool->allocFailCount);
+        err = (int32_t)U_ERROR_COMMON_SUCCESS;
+    }
+
+    return err;
+}
+
 // End of file
@@ -34,7 +34,7 @@
 #include "stdio.h"    // snprintf()
 
 #include "u_cfg_sw.h"
-#include "u_compiler.h" // For U_INLINE
+#include "u_compiler.h" // For U_INLINE and U_ATOMIC_XXX()
 
 #include "u_error_common.h"
 #include "u_assert.h"
@@ -118,6 +118,48 @@ static U_INLINE const char *pPtrOffset(const char *pData, size_t offset,
     return pData;
 }
 
+// Set a read pointer, forgetting the slowest read pointer if it
+// is the one being moved.
+// The ring buffer's mutex should be locked before this is called
+static U_INLINE void setReadPointer(uRingBuffer_t *pRingBuffer, size_t x,
+                                    const char *pData)
+{
+    pRingBuffer->pDataRead[x] = pData;
+    if ((int32_t) x == pRingBuffer->slowestReadPointer) {
+        pRingBuffer->slowestReadPointer = -1;
+    }
+}
+
+// Return the amount of data behind the slowest read pointer that
+// an add must not overwrite, i.e. ignoring the "normal" read pointer
+// if a read handle is required, working out which one that is only
+// if it is not already known, which keeps the cost of an add
+// independent of the number of read handles.
+// The ring buffer's mutex should be locked before this is called
+static size_t slowestUsed(uRingBuffer_t *pRingBuffer)
+{
+    size_t used = 0;
+    size_t y;
+
+    if (pRingBuffer->slowestReadPointer < 0) {
+        for (size_t x = 0; x < pRingBuffer->maxNumReadPointers; x++) {
+            if ((pRingBuffer->pDataRead[x] != NULL) &&
+                ((x > 0) || !pRingBuffer->readHandleRequired)) {
+                y = ptrDiff(pRingBuffer->pDataRead[x], pRingBuffer->pDataWrite, pRingBuffer->size);
+                if ((pRingBuffer->slowestReadPointer < 0) || (y > used)) {
+                    pRingBuffer->slowestReadPointer = (int32_t) x;
+                    used = y;
+                }
+            }
+        }
+    } else {
+        used = ptrDiff(pRingBuffer->pDataRead[pRingBuffer->slowestReadPointer],
+                       pRingBuffer->pDataWrite, pRingBuffer->size);
+    }
+
+    return used;
+}
+
 // The ring buffer's mutex should be locked before this is called
 static void bufferReset(uRingBuffer_t *pRingBuffer)
 {
@@ -133,6 +175,7 @@ static void bufferReset(uRingBuffer_t *pRingBuffer)
     pRingBuffer->pDataWrite = pRingBuffer->pBuffer;
     // The default handle-less read pointer can always be set
     pRingBuffer->pDataRead[0] = pRingBuffer->pDataWrite;
+    pRingBuffer->slowestReadPointer = -1;
 }
 
 static int32_t createCommon(uRingBuffer_t *pRingBuffer, char *pLinearBuffer, size_t size)
@@ -170,7 +213,7 @@ static size_t read(uRingBuffer_t *pRingBuffer, int32_t handle, char *pData,
             bytesRead++;
         }
         if (destructive) {
-            pRingBuffer->pDataRead[handle] = pSource;
+            setReadPointer(pRingBuffer, handle, pSource);
         }
     }
 
@@ -187,6 +230,22 @@ static bool add(uRingBuffer_t *pRingBuffer, const char *pData,
 
     if (length >= pRingBuffer->size) {
         dataFitsInBuffer = false;
+    } else if (!destructive) {
+        // Only the slowest read pointer can stop the data fitting;
+        // +1 since we can't have the pointers overlap
+        if (slowestUsed(pRingBuffer) + 1 + length > pRingBuffer->size) {
+            dataFitsInBuffer = false;
+        } else if (pRingBuffer->readHandleRequired) {
+            // The "normal" read pointer can't be used so throw away
+            // enough of its data to make room
+            used = ptrDiff(pRingBuffer->pDataRead[0], pRingBuffer->pDataWrite,
+                           pRingBuffer->size) + 1;
+            if (used + length > pRingBuffer->size) {
+                pRingBuffer->statReadLossNormalBytes += read(pRingBuffer, 0, NULL,
+                                                             used + length - pRingBuffer->size,
+                                                             0, true);
+            }
+        }
     } else {
         for (size_t x = 0; (x < pRingBuffer->maxNumReadPointers) &&
              (dataFitsInBuffer || destructive); x++) {
@@ -229,12 +288,112 @@ static bool add(uRingBuffer_t *pRingBuffer, const char *pData,
     return dataFitsInBuffer;
 }
 
+// Copy length bytes into the ring buffer at pWrite, wrapping
+// as necessary, returning the new write pointer.
+static char *pCopyIn(uRingBuffer_t *pRingBuffer, char *pWrite,
+                     const char *pData, size_t length)
+{
+    size_t chunk = pRingBuffer->pBuffer + pRingBuffer->size - pWrite;
+
+    if (chunk > length) {
+        chunk = length;
+    }
+    memcpy(pWrite, pData, chunk);
+    pWrite += chunk;
+    if (pWrite >= pRingBuffer->pBuffer + pRingBuffer->size) {
+        pWrite = pRingBuffer->pBuffer;
+    }
+    if (length > chunk) {
+        memcpy(pWrite, pData + chunk, length - chunk);
+        pWrite += length - chunk;
+    }
+
+    return pWrite;
+}
+
+// Copy length bytes out of the ring buffer from pSource, wrapping
+// as necessary, returning the new read pointer; pData may be NULL.
+static const char *pCopyOut(const uRingBuffer_t *pRingBuffer, const char *pSource,
+                            char *pData, size_t length)
+{
+    size_t chunk = pRingBuffer->pBuffer + pRingBuffer->size - pSource;
+
+    if (chunk > length) {
+        chunk = length;
+    }
+    if (pData != NULL) {
+        memcpy(pData, pSource, chunk);
+    }
+    pSource = pPtrOffset(pSource, chunk, pRingBuffer->pBuffer, pRingBuffer->size);
+    if (length > chunk) {
+        if (pData != NULL) {
+            memcpy(pData + chunk, pSource, length - chunk);
+        }
+        pSource += length - chunk;
+    }
+
+    return pSource;
+}
+
+// Add data to a lock-free ring buffer: called by the producer only.
+static bool addLockFree(uRingBuffer_t *pRingBuffer, const char *pData,
+                        size_t length)
+{
+    bool dataFitsInBuffer = false;
+    // The write pointer is ours, the read pointer belongs to the consumer
+    char *pWrite = pRingBuffer->pDataWrite;
+    const char *pRead = U_ATOMIC_GET(&(pRingBuffer->pDataReadNormal));
+
+    if (pRingBuffer->pBuffer != NULL) {
+        // +1 since we can't have the pointers overlap
+        if (ptrDiff(pRead, pWrite, pRingBuffer->size) + 1 + length <= pRingBuffer->size) {
+            pWrite = pCopyIn(pRingBuffer, pWrite, pData, length);
+            // Only publish the new write pointer once the data is in
+            U_ATOMIC_SET(&(pRingBuffer->pDataWrite), pWrite);
+            dataFitsInBuffer = true;
+        } else {
+            pRingBuffer->statAddLossBytes += length;
+        }
+    }
+
+    return dataFitsInBuffer;
+}
+
+// Read data from a lock-free ring buffer: called by the consumer only.
+static size_t readLockFree(uRingBuffer_t *pRingBuffer, char *pData,
+                           size_t length, size_t offset, bool destructive)
+{
+    size_t bytesRead = 0;
+    // The read pointer is ours, the write pointer belongs to the producer
+    const char *pSource = pRingBuffer->pDataReadNormal;
+    char *pWrite = U_ATOMIC_GET(&(pRingBuffer->pDataWrite));
+    size_t available;
+
+    if (pRingBuffer->pBuffer != NULL) {
+        available = ptrDiff(pSource, pWrite, pRingBuffer->size);
+        if (offset < available) {
+            pSource = pPtrOffset(pSource, offset, pRingBuffer->pBuffer, pRingBuffer->size);
+            bytesRead = available - offset;
+            if (bytesRead > length) {
+                bytesRead = length;
+            }
+            pSource = pCopyOut(pRingBuffer, pSource, pData, bytesRead);
+            if (destructive) {
+                // Only hand the space back once the data is out
+                U_ATOMIC_SET(&(pRingBuffer->pDataReadNormal), pSource);
+            }
+        }
+    }
+
+    return bytesRead;
+}
+
 // This function does the ring buffer mutex locking itself.
 static size_t lock(uRingBuffer_t *pRingBuffer, int32_t handle, bool lockNotUnlock)
 {
     size_t dataSize = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -253,17 +412,22 @@ static size_t lock(uRingBuffer_t *pRingBuffer, int32_t handle, bool lockNotUnloc
     return dataSize;
 }
 
-// This function does the ring buffer mutex locking itself.
-static size_t availableSize(const uRingBuffer_t *pRingBuffer, bool max)
+// The ring buffer's mutex should be locked before this is called
+// (or it should be a lock-free ring buffer).
+static size_t availableSizeUnlocked(const uRingBuffer_t *pRingBuffer, bool max)
 {
     size_t size = 0;
     size_t y = 0;
     bool foundADataReadPointer = false;
 
-    if (pRingBuffer->pBuffer != NULL) {
-
-        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
-
+    if (pRingBuffer->isLockFree) {
+        if ((pRingBuffer->pBuffer != NULL) && !max) {
+            // -1 since we must keep one to prevent pointer wrap
+            size = pRingBuffer->size - 1 -
+                   ptrDiff(U_ATOMIC_GET(&(pRingBuffer->pDataReadNormal)),
+                           U_ATOMIC_GET(&(pRingBuffer->pDataWrite)), pRingBuffer->size);
+        }
+    } else {
         size = pRingBuffer->size;
         for (size_t x = 0; x < pRingBuffer->maxNumReadPointers; x++) {
             // If a read handle is required we ignore the data behind
@@ -296,6 +460,23 @@ static size_t availableSize(const uRingBuffer_t *pRingBuffer, bool max)
             //  Must keep one to prevent pointer wrap
             size--;
         }
+    }
+
+    return size;
+}
+
+// This function does the ring buffer mutex locking itself.
+static size_t availableSize(const uRingBuffer_t *pRingBuffer, bool max)
+{
+    size_t size = 0;
+
+    if (pRingBuffer->isLockFree) {
+        size = availableSizeUnlocked(pRingBuffer, max);
+    } else if (pRingBuffer->mutex != NULL) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+
+        size = availableSizeUnlocked(pRingBuffer, max);
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
     }
@@ -303,6 +484,21 @@ static size_t availableSize(const uRingBuffer_t *pRingBuffer, bool max)
     return size;
 }
 
+// Split length bytes starting at pStart into up to two spans,
+// wrapping at the end of the buffer, returning the length of
+// the first span.
+static size_t spanSplit(const uRingBuffer_t *pRingBuffer, const char *pStart,
+                        size_t length)
+{
+    size_t length0 = pRingBuffer->pBuffer + pRingBuffer->size - pStart;
+
+    if (length0 > length) {
+        length0 = length;
+    }
+
+    return length0;
+}
+
 // Hex print for debug purposes.
 static void printHex(const char *pBuffer, size_t size)
 {
@@ -355,7 +551,7 @@ void uRingBufferDump(uRingBuffer_t *pRingBuffer)
     char buffer1[3];
     char buffer2[16];
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -398,9 +594,28 @@ int32_t uRingBufferCreate(uRingBuffer_t *pRingBuffer, char *pLinearBuffer, size_
     return createCommon(pRingBuffer, pLinearBuffer, size);
 }
 
+int32_t uRingBufferCreateLockFree(uRingBuffer_t *pRingBuffer, char *pLinearBuffer, size_t size)
+{
+    memset(pRingBuffer, 0x00, sizeof(uRingBuffer_t));
+    // As for uRingBufferCreate() but with no mutex
+    pRingBuffer->pDataRead = &(pRingBuffer->pDataReadNormal);
+    pRingBuffer->maxNumReadPointers = 1;
+    pRingBuffer->isMalloced = false;
+    pRingBuffer->isLockFree = true;
+    pRingBuffer->pBuffer = pLinearBuffer;
+    pRingBuffer->size = size;
+    bufferReset(pRingBuffer);
+
+    return (int32_t) U_ERROR_COMMON_SUCCESS;
+}
+
 void uRingBufferDelete(uRingBuffer_t *pRingBuffer)
 {
-    if ((pRingBuffer != NULL) && (pRingBuffer->mutex != NULL)) {
+    if ((pRingBuffer != NULL) && pRingBuffer->isLockFree) {
+        pRingBuffer->isLockFree = false;
+        pRingBuffer->maxNumReadPointers = 0;
+        pRingBuffer->pBuffer = NULL;
+    } else if ((pRingBuffer != NULL) && (pRingBuffer->mutex != NULL)) {
         if (pRingBuffer->isMalloced) {
             uPortFree(pRingBuffer->pDataRead);
             pRingBuffer->pDataRead = NULL;
@@ -418,7 +633,9 @@ bool uRingBufferAdd(uRingBuffer_t *pRingBuffer, const char *pData, size_t length
 {
     bool dataFitsInBuffer = false;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->isLockFree) {
+        dataFitsInBuffer = addLockFree(pRingBuffer, pData, length);
+    } else if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -434,7 +651,10 @@ bool uRingBufferForceAdd(uRingBuffer_t *pRingBuffer, const char *pData, size_t l
 {
     bool dataFitsInBuffer = false;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->isLockFree) {
+        // Only the consumer may move the read pointer on
+        dataFitsInBuffer = addLockFree(pRingBuffer, pData, length);
+    } else if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -450,7 +670,9 @@ size_t uRingBufferRead(uRingBuffer_t *pRingBuffer, char *pData, size_t length)
 {
     size_t bytesRead = 0;
 
-    if ((pRingBuffer->pBuffer != NULL) && !pRingBuffer->readHandleRequired) {
+    if (pRingBuffer->isLockFree) {
+        bytesRead = readLockFree(pRingBuffer, pData, length, 0, true);
+    } else if ((pRingBuffer->mutex != NULL) && !pRingBuffer->readHandleRequired) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -467,7 +689,9 @@ size_t uRingBufferPeek(uRingBuffer_t *pRingBuffer, char *pData, size_t length,
 {
     size_t bytesRead = 0;
 
-    if ((pRingBuffer->pBuffer != NULL) && !pRingBuffer->readHandleRequired) {
+    if (pRingBuffer->isLockFree) {
+        bytesRead = readLockFree(pRingBuffer, pData, length, offset, false);
+    } else if ((pRingBuffer->mutex != NULL) && !pRingBuffer->readHandleRequired) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -483,7 +707,12 @@ size_t uRingBufferDataSize(const uRingBuffer_t *pRingBuffer)
 {
     size_t dataSize = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->isLockFree) {
+        if (pRingBuffer->pBuffer != NULL) {
+            dataSize = ptrDiff(U_ATOMIC_GET(&(pRingBuffer->pDataReadNormal)),
+                               U_ATOMIC_GET(&(pRingBuffer->pDataWrite)), pRingBuffer->size);
+        }
+    } else if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -505,11 +734,16 @@ size_t uRingBufferAvailableSize(const uRingBuffer_t *pRingBuffer)
 
 void uRingBufferFlush(uRingBuffer_t *pRingBuffer)
 {
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->isLockFree) {
+        if (pRingBuffer->pBuffer != NULL) {
+            U_ATOMIC_SET(&(pRingBuffer->pDataReadNormal),
+                         U_ATOMIC_GET(&(pRingBuffer->pDataWrite)));
+        }
+    } else if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
-        pRingBuffer->pDataRead[0] = pRingBuffer->pDataWrite;
+        setReadPointer(pRingBuffer, 0, pRingBuffer->pDataWrite);
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
     }
@@ -521,7 +755,7 @@ void uRingBufferFlushValue(uRingBuffer_t *pRingBuffer, char value, size_t length
     size_t dataSize;
     const char *pData;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -533,7 +767,7 @@ void uRingBufferFlushValue(uRingBuffer_t *pRingBuffer, char value, size_t length
                 bytesRead++;
             }
             if (bytesRead >= length) {
-                pRingBuffer->pDataRead[0] = pData;
+                setReadPointer(pRingBuffer, 0, pData);
             }
         }
 
@@ -543,7 +777,7 @@ void uRingBufferFlushValue(uRingBuffer_t *pRingBuffer, char value, size_t length
 
 void uRingBufferReset(uRingBuffer_t *pRingBuffer)
 {
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -557,7 +791,7 @@ size_t uRingBufferStatReadLoss(uRingBuffer_t *pRingBuffer)
 {
     size_t bytesLost = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -573,7 +807,9 @@ size_t uRingBufferStatAddLoss(uRingBuffer_t *pRingBuffer)
 {
     size_t bytesLost = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->isLockFree) {
+        bytesLost = pRingBuffer->statAddLossBytes;
+    } else if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -585,6 +821,138 @@ size_t uRingBufferStatAddLoss(uRingBuffer_t *pRingBuffer)
     return bytesLost;
 }
 
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: SPANS
+ * -------------------------------------------------------------- */
+
+size_t uRingBufferGetReadSpans(uRingBuffer_t *pRingBuffer,
+                               uRingBufferReadSpan_t spans[2])
+{
+    size_t dataSize = 0;
+    const char *pRead = NULL;
+
+    memset(spans, 0, sizeof(uRingBufferReadSpan_t) * 2);
+    if (pRingBuffer->isLockFree) {
+        if (pRingBuffer->pBuffer != NULL) {
+            pRead = pRingBuffer->pDataReadNormal;
+            dataSize = ptrDiff(pRead, U_ATOMIC_GET(&(pRingBuffer->pDataWrite)),
+                               pRingBuffer->size);
+        }
+    } else if (pRingBuffer->mutex != NULL) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+
+        if (!pRingBuffer->readHandleRequired) {
+            pRead = pRingBuffer->pDataRead[0];
+            dataSize = ptrDiff(pRead, pRingBuffer->pDataWrite, pRingBuffer->size);
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+    }
+
+    if (dataSize > 0) {
+        spans[0].pData = pRead;
+        spans[0].length = spanSplit(pRingBuffer, pRead, dataSize);
+        if (dataSize > spans[0].length) {
+            spans[1].pData = pRingBuffer->pBuffer;
+            spans[1].length = dataSize - spans[0].length;
+        }
+    }
+
+    return dataSize;
+}
+
+size_t uRingBufferCommitRead(uRingBuffer_t *pRingBuffer, size_t length)
+{
+    size_t bytesRead = 0;
+
+    if (pRingBuffer->isLockFree) {
+        bytesRead = readLockFree(pRingBuffer, NULL, length, 0, true);
+    } else if ((pRingBuffer->mutex != NULL) && !pRingBuffer->readHandleRequired) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+
+        bytesRead = ptrDiff(pRingBuffer->pDataRead[0], pRingBuffer->pDataWrite,
+                            pRingBuffer->size);
+        if (bytesRead > length) {
+            bytesRead = length;
+        }
+        setReadPointer(pRingBuffer, 0, pPtrOffset(pRingBuffer->pDataRead[0], bytesRead,
+                                                  pRingBuffer->pBuffer, pRingBuffer->size));
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+    }
+
+    return bytesRead;
+}
+
+size_t uRingBufferGetWriteSpans(uRingBuffer_t *pRingBuffer,
+                                uRingBufferWriteSpan_t spans[2])
+{
+    size_t freeSize = 0;
+    // Only the producer moves the write pointer
+    char *pWrite = pRingBuffer->pDataWrite;
+
+    memset(spans, 0, sizeof(uRingBufferWriteSpan_t) * 2);
+    freeSize = availableSize(pRingBuffer, false);
+    if (freeSize > 0) {
+        spans[0].pData = pWrite;
+        spans[0].length = spanSplit(pRingBuffer, pWrite, freeSize);
+        if (freeSize > spans[0].length) {
+            spans[1].pData = pRingBuffer->pBuffer;
+            spans[1].length = freeSize - spans[0].length;
+        }
+    }
+
+    return freeSize;
+}
+
+size_t uRingBufferCommitWrite(uRingBuffer_t *pRingBuffer, size_t length)
+{
+    size_t bytesAdded = 0;
+    size_t used;
+
+    if (pRingBuffer->isLockFree) {
+        if (pRingBuffer->pBuffer != NULL) {
+            bytesAdded = availableSizeUnlocked(pRingBuffer, false);
+            if (bytesAdded > length) {
+                bytesAdded = length;
+            }
+            U_ATOMIC_SET(&(pRingBuffer->pDataWrite),
+                         (char *) pPtrOffset(pRingBuffer->pDataWrite, bytesAdded,
+                                             pRingBuffer->pBuffer, pRingBuffer->size));
+            pRingBuffer->statAddLossBytes += length - bytesAdded;
+        }
+    } else if (pRingBuffer->mutex != NULL) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+
+        bytesAdded = availableSizeUnlocked(pRingBuffer, false);
+        if (bytesAdded > length) {
+            bytesAdded = length;
+        }
+        if (pRingBuffer->readHandleRequired) {
+            // As in add(), the "normal" read pointer can't be used
+            // so move it on if it is in the way
+            used = ptrDiff(pRingBuffer->pDataRead[0], pRingBuffer->pDataWrite,
+                           pRingBuffer->size) + 1;
+            if (used + bytesAdded > pRingBuffer->size) {
+                pRingBuffer->statReadLossNormalBytes += read(pRingBuffer, 0, NULL,
+                                                             used + bytesAdded -
+                                                             pRingBuffer->size,
+                                                             0, true);
+            }
+        }
+        pRingBuffer->pDataWrite = (char *) pPtrOffset(pRingBuffer->pDataWrite, bytesAdded,
+                                                      pRingBuffer->pBuffer, pRingBuffer->size);
+        pRingBuffer->statAddLossBytes += length - bytesAdded;
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+    }
+
+    return bytesAdded;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: MULTIPLE READERS
  * -------------------------------------------------------------- */
@@ -621,7 +989,7 @@ int32_t uRingBufferCreateWithReadHandle(uRingBuffer_t *pRingBuffer, char *pLinea
 
 void uRingBufferSetReadRequiresHandle(uRingBuffer_t *pRingBuffer, bool onNotOff)
 {
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -632,6 +1000,8 @@ void uRingBufferSetReadRequiresHandle(uRingBuffer_t *pRingBuffer, bool onNotOff)
             pRingBuffer->pDataRead[0] = pRingBuffer->pDataWrite;
         }
         pRingBuffer->readHandleRequired = onNotOff;
+        // Whether the "normal" read pointer counts may have changed
+        pRingBuffer->slowestReadPointer = -1;
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
     }
@@ -647,7 +1017,7 @@ int32_t uRingBufferTakeReadHandle(uRingBuffer_t *pRingBuffer)
 {
     int32_t readHandle = (int32_t) U_ERROR_COMMON_NO_MEMORY;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -670,12 +1040,12 @@ int32_t uRingBufferTakeReadHandle(uRingBuffer_t *pRingBuffer)
 
 void uRingBufferGiveReadHandle(uRingBuffer_t *pRingBuffer, int32_t handle)
 {
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
         if ((handle >= 1) && (handle < (int32_t) pRingBuffer->maxNumReadPointers)) {
-            pRingBuffer->pDataRead[handle] = NULL;
+            setReadPointer(pRingBuffer, handle, NULL);
             pRingBuffer->dataReadLockBitmap &= ~(1ULL << (handle - 1));
         }
 
@@ -700,7 +1070,7 @@ bool uRingBufferReadHandleIsLocked(uRingBuffer_t *pRingBuffer, int32_t handle)
 {
     bool isLocked = false;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -720,7 +1090,7 @@ size_t uRingBufferReadHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
 {
     size_t bytesRead = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -737,7 +1107,7 @@ size_t uRingBufferPeekHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
 {
     size_t bytesRead = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -749,11 +1119,48 @@ size_t uRingBufferPeekHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
     return bytesRead;
 }
 
+size_t uRingBufferPeekSpanHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
+                                 const char **ppSpan, size_t length,
+                                 size_t offset)
+{
+    size_t spanLength = 0;
+    size_t available;
+    const char *pSource;
+
+    if (pRingBuffer->mutex != NULL) {
+
+        U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+
+        if ((handle >= 0) && (handle < (int32_t) pRingBuffer->maxNumReadPointers) &&
+            (pRingBuffer->pDataRead[handle] != NULL)) {
+            available = ptrDiff(pRingBuffer->pDataRead[handle], pRingBuffer->pDataWrite,
+                                pRingBuffer->size);
+            if (offset < available) {
+                pSource = pPtrOffset(pRingBuffer->pDataRead[handle], offset,
+                                     pRingBuffer->pBuffer, pRingBuffer->size);
+                spanLength = available - offset;
+                if (spanLength > length) {
+                    spanLength = length;
+                }
+                // Can only go as far as the end of the buffer
+                if (spanLength > (size_t) (pRingBuffer->pBuffer + pRingBuffer->size - pSource)) {
+                    spanLength = pRingBuffer->pBuffer + pRingBuffer->size - pSource;
+                }
+                *ppSpan = pSource;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
+    }
+
+    return spanLength;
+}
+
 size_t uRingBufferDataSizeHandle(const uRingBuffer_t *pRingBuffer, int32_t handle)
 {
     size_t dataSize = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -775,13 +1182,13 @@ size_t uRingBufferAvailableSizeMax(const uRingBuffer_t *pRingBuffer)
 
 void uRingBufferFlushHandle(uRingBuffer_t *pRingBuffer, int32_t handle)
 {
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
         if ((handle >= 1) && (handle < (int32_t) pRingBuffer->maxNumReadPointers) &&
             (pRingBuffer->pDataRead[handle] != NULL)) {
-            pRingBuffer->pDataRead[handle] = pRingBuffer->pDataWrite;
+            setReadPointer(pRingBuffer, handle, pRingBuffer->pDataWrite);
         }
 
         U_PORT_MUTEX_UNLOCK((uPortMutexHandle_t) pRingBuffer->mutex);
@@ -793,7 +1200,7 @@ size_t uRingBufferStatReadLossHandle(uRingBuffer_t *pRingBuffer,
 {
     size_t bytesLost = 0;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -817,7 +1224,7 @@ size_t uRingBufferParseHandle(uRingBuffer_t *pRingBuffer, int32_t handle,
 {
     int32_t errorCodeOrLength = U_ERROR_COMMON_INVALID_PARAMETER;
 
-    if (pRingBuffer->pBuffer != NULL) {
+    if (pRingBuffer->mutex != NULL) {
 
         U_PORT_MUTEX_LOCK((uPortMutexHandle_t) pRingBuffer->mutex);
 
@@ -882,6 +1289,61 @@ bool uRingBufferGetByteUnprotected(uParseHandle_t parseHandle, void *p)
     return true;
 }
 
+bool uRingBufferPeekByteUnprotected(uParseHandle_t parseHandle, void *p)
+{
+    uRingBufferParseContext_t *pCtx = (uRingBufferParseContext_t *)parseHandle;
+    if (1 > pCtx->bytesAvailable) {
+        return false;
+    }
+    *((char *) p) = *pCtx->pSource;
+    return true;
+}
+
+size_t uRingBufferGetSpanUnprotected(uParseHandle_t parseHandle, const char **ppSpan,
+                                     size_t length)
+{
+    uRingBufferParseContext_t *pCtx = (uRingBufferParseContext_t *)parseHandle;
+    const char *pEnd = pCtx->pRingBuffer->pBuffer + pCtx->pRingBuffer->size;
+
+    if (length > pCtx->bytesAvailable) {
+        length = pCtx->bytesAvailable;
+    }
+    // Can only go as far as the end of the buffer
+    if (length > (size_t) (pEnd - pCtx->pSource)) {
+        length = pEnd - pCtx->pSource;
+    }
+    *ppSpan = pCtx->pSource;
+    pCtx->pSource += length;
+    if (pCtx->pSource >= pEnd) {
+        pCtx->pSource = pCtx->pRingBuffer->pBuffer;
+    }
+    pCtx->bytesParsed += length;
+    pCtx->bytesAvailable -= length;
+
+    return length;
+}
+
+size_t uRingBufferGetBytesUnprotected(uParseHandle_t parseHandle, void *p,
+                                      size_t length)
+{
+    char *pDest = (char *)p;
+    const char *pSpan = NULL;
+    size_t bytesGot = 0;
+    size_t chunkSize = 1;
+
+    // At most two chunks: up to the end of the buffer and then
+    // from the start of the buffer
+    while ((bytesGot < length) && (chunkSize > 0)) {
+        chunkSize = uRingBufferGetSpanUnprotected(parseHandle, &pSpan, length - bytesGot);
+        if ((pDest != NULL) && (chunkSize > 0)) {
+            memcpy(pDest + bytesGot, pSpan, chunkSize);
+        }
+        bytesGot += chunkSize;
+    }
+
+    return bytesGot;
+}
+
 size_t uRingBufferBytesAvailableUnprotected(uParseHandle_t parseHandle)
 {
     uRingBufferParseContext_t *pCtx = (uRingBufferParseContext_t *)parseHandle;
@@ -28,6 +28,7 @@
 # include "u_cfg_override.h" // For a customer's configuration override
 #endif
 
+#include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
 
@@ -45,17 +46,36 @@
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
-static const char gDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31,
-                                    31, 30, 31, 30, 31
-                                   };
-static const char gDaysInMonthLeapYear[] = {31, 29, 31, 30, 31, 30,
-                                            31, 31, 30, 31, 30, 31
-                                           };
+/** The number of days in a non-leap year before the start of
+ * each month.
+ */
+static const int16_t gDaysBeforeMonth[] = {0, 31, 59, 90, 120, 151,
+                                           181, 212, 243, 273, 304, 334
+                                          };
 
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Divide, rounding towards minus infinity rather than towards zero;
+// b must be positive.
+static int64_t floorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+
+    if ((a % b) < 0) {
+        q--;
+    }
+
+    return q;
+}
+
+// The number of leap years from year zero to the given year, inclusive.
+static int64_t leapYearsTo(int64_t year)
+{
+    return floorDiv(year, 4) - floorDiv(year, 100) + floorDiv(year, 400);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -71,16 +91,69 @@ bool uTimeIsLeapYear(int32_t year)
     return isLeapYear;
 }
 
+int64_t uTimeDaysFromCivil(int32_t year, int32_t month, int32_t day)
+{
+    int64_t y;
+    int64_t m = (int64_t) month - 1;
+    int64_t days;
+
+    // Bring the month into range, carrying into the year
+    y = (int64_t) year + floorDiv(m, 12);
+    m -= floorDiv(m, 12) * 12;
+    // Days from 1970 to the start of the year, then to the start
+    // of the month, then to the day
+    days = ((y - 1970) * 365) + leapYearsTo(y - 1) - leapYearsTo(1969);
+    days += gDaysBeforeMonth[m];
+    if ((m > 1) && uTimeIsLeapYear((int32_t) y)) {
+        days++;
+    }
+
+    return days + day - 1;
+}
+
+void uTimeCivilFromDays(int64_t days, int32_t *pYear, int32_t *pMonth,
+                        int32_t *pDay)
+{
+    int64_t era;
+    int64_t dayOfEra;
+    int64_t yearOfEra;
+    int64_t dayOfYear;
+    int64_t monthFromMarch;
+    int64_t year;
+    int32_t month;
+
+    // From H. Hinnant's civil_from_days(): count in 400-year eras
+    // of 146097 days from 1st March of year zero, so that the leap
+    // day falls at the end of each year
+    days += 719468;
+    era = floorDiv(days, 146097);
+    dayOfEra = days - (era * 146097);
+    yearOfEra = (dayOfEra - (dayOfEra / 1460) + (dayOfEra / 36524) -
+                 (dayOfEra / 146096)) / 365;
+    dayOfYear = dayOfEra - ((365 * yearOfEra) + (yearOfEra / 4) - (yearOfEra / 100));
+    monthFromMarch = ((5 * dayOfYear) + 2) / 153;
+    month = (int32_t) (monthFromMarch < 10 ? monthFromMarch + 3 : monthFromMarch - 9);
+    year = yearOfEra + (era * 400);
+    if (month <= 2) {
+        year++;
+    }
+    if (pYear != NULL) {
+        *pYear = (int32_t) year;
+    }
+    if (pMonth != NULL) {
+        *pMonth = month;
+    }
+    if (pDay != NULL) {
+        *pDay = (int32_t) (dayOfYear - (((153 * monthFromMarch) + 2) / 5) + 1);
+    }
+}
+
 int64_t uTimeMonthsToSecondsUtc(int32_t monthsUtc)
 {
     int64_t secondsUtc = 0;
 
-    for (int32_t x = 0; x < monthsUtc; x++) {
-        if (uTimeIsLeapYear((x / 12) + 1970)) {
-            secondsUtc += gDaysInMonthLeapYear[x % 12] * 3600 * 24;
-        } else {
-            secondsUtc += gDaysInMonth[x % 12] * 3600 * 24;
-        }
+    if (monthsUtc > 0) {
+        secondsUtc = uTimeDaysFromCivil(1970, monthsUtc + 1, 1) * 3600 * 24;
     }
 
     return secondsUtc;
@@ -89,25 +162,12 @@ int64_t uTimeMonthsToSecondsUtc(int32_t monthsUtc)
 int32_t uTimeSecondsToMonthsUtc(int64_t secondsUtc)
 {
     int32_t monthsUtc = 0;
-    int32_t year = 0;
-    int32_t month = 0;
-    int32_t x;
-
-    while (secondsUtc > 0) {
-        if (uTimeIsLeapYear(year + 1970)) {
-            x = gDaysInMonthLeapYear[month] * 3600 * 24;
-        } else {
-            x = gDaysInMonth[month] * 3600 * 24;
-        }
-        if (secondsUtc >= x) {
-            monthsUtc++;
-            month++;
-        }
-        secondsUtc -= x;
-        if (month == 12) {
-            month = 0;
-            year++;
-        }
+    int32_t year;
+    int32_t month;
+
+    if (secondsUtc > 0) {
+        uTimeCivilFromDays(secondsUtc / (3600 * 24), &year, &month, NULL);
+        monthsUtc = ((year - 1970) * 12) + month - 1;
     }
 
     return monthsUtc;
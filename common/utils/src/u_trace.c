@@ -0,0 +1,223 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Implementation of cross-layer tracing of operations.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_compiler.h" // U_ATOMIC_XXX() macros
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+
+#include "u_trace.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** An operation being traced.
+ */
+typedef struct {
+    volatile int32_t inUse;        /**< claimed with U_ATOMIC_COMPARE_AND_SWAP(). */
+    uPortTaskHandle_t taskHandle;  /**< NULL until the slot is ready. */
+    int64_t stageStartTimeUs;      /**< when the stage at the top was entered. */
+    uTraceStage_t stack[U_TRACE_STAGE_STACK_DEPTH];
+    size_t depth;                  /**< may be more than U_TRACE_STAGE_STACK_DEPTH. */
+    uTraceOperation_t report;
+} uTraceContext_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The callback, NULL if tracing is off.
+ */
+static volatile uTraceCallback_t gpCallback = NULL;
+
+/** The parameter for the callback.
+ */
+static void *gpCallbackParam = NULL;
+
+/** The operations; each is only ever touched by the task that
+ * claimed it, hence no mutex is required.
+ */
+static uTraceContext_t gContext[U_TRACE_MAX_NUM_OPERATIONS];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Find the operation that the calling task is in, NULL if none.
+static uTraceContext_t *pContextGet()
+{
+    uTraceContext_t *pContext = NULL;
+    uPortTaskHandle_t taskHandle = NULL;
+
+    if (uPortTaskGetHandle(&taskHandle) == 0) {
+        for (size_t x = 0; (x < sizeof(gContext) / sizeof(gContext[0])) &&
+             (pContext == NULL); x++) {
+            if (U_ATOMIC_GET(&(gContext[x].inUse)) &&
+                (gContext[x].taskHandle == taskHandle)) {
+                pContext = &(gContext[x]);
+            }
+        }
+    }
+
+    return pContext;
+}
+
+// Add the time since the stage at the top of the stack of an
+// operation was entered to that stage, returning the time now.
+static int64_t stageAccount(uTraceContext_t *pContext)
+{
+    int64_t nowUs = uPortGetTickTimeUs();
+    size_t index = pContext->depth;
+    uTraceStage_t stage;
+
+    if (index > U_TRACE_STAGE_STACK_DEPTH) {
+        index = U_TRACE_STAGE_STACK_DEPTH;
+    }
+    stage = pContext->stack[index - 1];
+    pContext->report.stageUs[stage] += (int32_t) (nowUs - pContext->stageStartTimeUs);
+    pContext->stageStartTimeUs = nowUs;
+
+    return nowUs;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Switch tracing on or off.
+void uTraceCallbackSet(uTraceCallback_t pCallback, void *pCallbackParam)
+{
+    gpCallbackParam = pCallbackParam;
+    gpCallback = pCallback;
+}
+
+// Start tracing an operation.
+int32_t uTraceOperationStart(const char *pName)
+{
+    int32_t handleOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    uPortTaskHandle_t taskHandle = NULL;
+    uTraceContext_t *pContext;
+
+    if (gpCallback != NULL) {
+        handleOrErrorCode = (int32_t) U_ERROR_COMMON_BUSY;
+        if ((pContextGet() == NULL) && (uPortTaskGetHandle(&taskHandle) == 0)) {
+            handleOrErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            for (size_t x = 0; (x < sizeof(gContext) / sizeof(gContext[0])) &&
+                 (handleOrErrorCode < 0); x++) {
+                pContext = &(gContext[x]);
+                if (U_ATOMIC_COMPARE_AND_SWAP(&(pContext->inUse), 0, 1)) {
+                    memset(&(pContext->report), 0, sizeof(pContext->report));
+                    pContext->report.pName = pName;
+                    pContext->stack[0] = U_TRACE_STAGE_API;
+                    pContext->depth = 1;
+                    pContext->report.stageCount[U_TRACE_STAGE_API] = 1;
+                    pContext->report.startTimeUs = uPortGetTickTimeUs();
+                    pContext->stageStartTimeUs = pContext->report.startTimeUs;
+                    pContext->taskHandle = taskHandle;
+                    handleOrErrorCode = (int32_t) x;
+                }
+            }
+        }
+    }
+
+    return handleOrErrorCode;
+}
+
+// Stop tracing an operation.
+void uTraceOperationStop(int32_t handle, int32_t result)
+{
+    uTraceContext_t *pContext;
+    uTraceCallback_t pCallback = gpCallback;
+
+    if ((handle >= 0) && (handle < (int32_t) (sizeof(gContext) / sizeof(gContext[0])))) {
+        pContext = &(gContext[handle]);
+        // Any stages left unpopped, e.g. on an error path,
+        // are accounted to the one at the top
+        pContext->report.durationUs = (int32_t) (stageAccount(pContext) -
+                                                 pContext->report.startTimeUs);
+        pContext->report.result = result;
+        if (pCallback != NULL) {
+            pCallback(&(pContext->report), gpCallbackParam);
+        }
+        pContext->taskHandle = NULL;
+        U_ATOMIC_SET(&(pContext->inUse), 0);
+    }
+}
+
+// Enter a stage.
+bool uTraceStagePush(uTraceStage_t stage)
+{
+    bool pushed = false;
+    uTraceContext_t *pContext;
+
+    if ((gpCallback != NULL) && (stage < U_TRACE_STAGE_MAX_NUM)) {
+        pContext = pContextGet();
+        if (pContext != NULL) {
+            stageAccount(pContext);
+            if (pContext->depth < U_TRACE_STAGE_STACK_DEPTH) {
+                pContext->stack[pContext->depth] = stage;
+                pContext->report.stageCount[stage]++;
+            }
+            pContext->depth++;
+            pushed = true;
+        }
+    }
+
+    return pushed;
+}
+
+// Leave a stage.
+void uTraceStagePop()
+{
+    uTraceContext_t *pContext;
+
+    if (gpCallback != NULL) {
+        pContext = pContextGet();
+        // Never pop the API stage, an operation always has that
+        if ((pContext != NULL) && (pContext->depth > 1)) {
+            stageAccount(pContext);
+            pContext->depth--;
+        }
+    }
+}
+
+// End of file
@@ -0,0 +1,155 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the arena API
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port_os.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_arena.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_ARENA_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_UTILS_TEST_ARENA_SIZE_BYTES
+/** The size of the arena used for testing.
+ */
+# define U_UTILS_TEST_ARENA_SIZE_BYTES 128
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Storage for an arena, one byte longer so that an unaligned
+ * start can be tested.
+ */
+static char gBuffer[U_UTILS_TEST_ARENA_SIZE_BYTES + 1];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Check that p is aligned and lies within the arena.
+static bool isGood(const uArena_t *pArena, const void *p, size_t size)
+{
+    const char *pC = (const char *) p;
+
+    return (p != NULL) && (((uintptr_t) p & (U_ARENA_ALIGNMENT_BYTES - 1)) == 0) &&
+           (pC >= pArena->pBuffer) && (pC + size <= pArena->pBuffer + pArena->size);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[arena]", "arenaBasic")
+{
+    uArena_t arena;
+    char *p1;
+    char *p2;
+    char *p3;
+    size_t mark;
+    size_t count = 0;
+
+    U_TEST_PRINT_LINE("testing arena.");
+
+    // Bad parameters
+    U_PORT_TEST_ASSERT(uArenaInit(NULL, gBuffer, sizeof(gBuffer)) < 0);
+    U_PORT_TEST_ASSERT(uArenaInit(&arena, gBuffer, 0) < 0);
+
+    // An arena whose memory is allocated
+    U_PORT_TEST_ASSERT(uArenaInit(&arena, NULL, U_UTILS_TEST_ARENA_SIZE_BYTES) == 0);
+    U_PORT_TEST_ASSERT(uArenaGetFree(&arena) == U_UTILS_TEST_ARENA_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pUArenaAlloc(&arena, 0) == NULL);
+    p1 = (char *) pUArenaAlloc(&arena, 1);
+    U_PORT_TEST_ASSERT(isGood(&arena, p1, 1));
+    p2 = (char *) pUArenaAlloc(&arena, 3);
+    U_PORT_TEST_ASSERT(isGood(&arena, p2, 3));
+    U_PORT_TEST_ASSERT(p2 >= p1 + 1);
+    // More than there is room for
+    U_PORT_TEST_ASSERT(pUArenaAlloc(&arena, U_UTILS_TEST_ARENA_SIZE_BYTES) == NULL);
+    U_PORT_TEST_ASSERT(pUArenaAlloc(&arena, (size_t) -1) == NULL);
+    // Release to a mark, which gives back the same memory again
+    mark = uArenaGetMark(&arena);
+    p3 = (char *) pUArenaAlloc(&arena, 10);
+    U_PORT_TEST_ASSERT(isGood(&arena, p3, 10));
+    uArenaResetToMark(&arena, mark);
+    U_PORT_TEST_ASSERT(pUArenaAlloc(&arena, 10) == p3);
+    // Reset and the first one comes back
+    uArenaReset(&arena);
+    U_PORT_TEST_ASSERT(uArenaGetFree(&arena) == U_UTILS_TEST_ARENA_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pUArenaAlloc(&arena, 1) == p1);
+    U_PORT_TEST_ASSERT(uArenaGetUsedMax(&arena) > 10);
+    uArenaDeinit(&arena);
+
+    // An arena in provided memory that is not aligned, filled
+    // right up with aligned buffers
+    U_PORT_TEST_ASSERT(uArenaInit(&arena, gBuffer + 1, U_UTILS_TEST_ARENA_SIZE_BYTES) == 0);
+    while ((p1 = (char *) pUArenaAlloc(&arena, U_ARENA_ALIGNMENT_BYTES)) != NULL) {
+        U_PORT_TEST_ASSERT(isGood(&arena, p1, U_ARENA_ALIGNMENT_BYTES));
+        memset(p1, 0xaa, U_ARENA_ALIGNMENT_BYTES);
+        count++;
+    }
+    U_PORT_TEST_ASSERT(count >= (U_UTILS_TEST_ARENA_SIZE_BYTES / U_ARENA_ALIGNMENT_BYTES) - 1);
+    U_PORT_TEST_ASSERT(uArenaGetFree(&arena) < U_ARENA_ALIGNMENT_BYTES * 2);
+    U_PORT_TEST_ASSERT(uArenaGetUsedMax(&arena) <= U_UTILS_TEST_ARENA_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(gBuffer[0] == 0);
+    uArenaDeinit(&arena);
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+// End of file
@@ -0,0 +1,301 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the base 64 API
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memcmp(), strlen()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_base64.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_BASE64_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_UTILS_TEST_BASE64_DATA_LENGTH_BYTES
+/** The amount of binary data to encode and decode.
+ */
+# define U_UTILS_TEST_BASE64_DATA_LENGTH_BYTES 1000
+#endif
+
+#ifndef U_UTILS_TEST_BASE64_BENCHMARK_ITERATIONS
+/** The number of times to encode and decode the data when comparing
+ * the whole-buffer and streaming functions.
+ */
+# define U_UTILS_TEST_BASE64_BENCHMARK_ITERATIONS 1000
+#endif
+
+/** The base 64 length of #U_UTILS_TEST_BASE64_DATA_LENGTH_BYTES.
+ */
+#define U_UTILS_TEST_BASE64_LENGTH_BYTES \
+    U_BASE64_ENCODE_STREAM_LENGTH_MAX(U_UTILS_TEST_BASE64_DATA_LENGTH_BYTES)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** A test vector.
+ */
+typedef struct {
+    const char *pBinary;
+    const char *pBase64;
+} uUtilsTestBase64Vector_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The test vectors from RFC 4648.
+ */
+static const uUtilsTestBase64Vector_t gVector[] = {
+    {"", ""},
+    {"f", "Zg=="},
+    {"fo", "Zm8="},
+    {"foo", "Zm9v"},
+    {"foob", "Zm9vYg=="},
+    {"fooba", "Zm9vYmE="},
+    {"foobar", "Zm9vYmFy"}
+};
+
+/** Binary data.
+ */
+static char gBinary[U_UTILS_TEST_BASE64_DATA_LENGTH_BYTES];
+
+/** Base 64 encoded by uBase64Encode().
+ */
+static char gBase64[U_UTILS_TEST_BASE64_LENGTH_BYTES];
+
+/** Somewhere to put streamed output, with room for white space.
+ */
+static char gBuffer[U_UTILS_TEST_BASE64_LENGTH_BYTES * 2];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Encode pBinary into pBase64 using the streaming API in chunks of
+// varying length, returning the length.
+static size_t encodeChunked(const char *pBinary, size_t length, char *pBase64)
+{
+    uBase64EncodeStream_t stream;
+    size_t consumed = 0;
+    size_t chunk;
+    size_t base64Length = 0;
+    int32_t x;
+
+    uBase64EncodeStreamInit(&stream);
+    for (size_t y = 0; consumed < length; y++) {
+        chunk = 1 + (y % 7);
+        if (chunk > length - consumed) {
+            chunk = length - consumed;
+        }
+        // Too little room must be refused without consuming anything
+        if (U_BASE64_ENCODE_STREAM_LENGTH_MAX(chunk) > 4) {
+            U_PORT_TEST_ASSERT(uBase64EncodeStream(&stream, pBinary + consumed, chunk,
+                                                   pBase64 + base64Length, 1) ==
+                               (int32_t) U_ERROR_COMMON_NO_MEMORY);
+        }
+        x = uBase64EncodeStream(&stream, pBinary + consumed, chunk, pBase64 + base64Length,
+                                U_BASE64_ENCODE_STREAM_LENGTH_MAX(chunk));
+        U_PORT_TEST_ASSERT((x >= 0) && ((x % 4) == 0));
+        consumed += chunk;
+        base64Length += x;
+    }
+    x = uBase64EncodeStreamFinish(&stream, pBase64 + base64Length, 4);
+    U_PORT_TEST_ASSERT((x == 0) || (x == 4));
+    base64Length += x;
+
+    return base64Length;
+}
+
+// Decode pBase64 into pBinary using the streaming API in chunks of
+// varying length, returning the length or negative error code.
+static int32_t decodeChunked(const char *pBase64, size_t length, char *pBinary,
+                             size_t binaryLength)
+{
+    uBase64DecodeStream_t stream;
+    size_t consumed = 0;
+    size_t chunk;
+    int32_t binaryLengthOrError = 0;
+    int32_t x = 0;
+
+    uBase64DecodeStreamInit(&stream);
+    for (size_t y = 0; (consumed < length) && (x >= 0); y++) {
+        chunk = 1 + (y % 11);
+        if (chunk > length - consumed) {
+            chunk = length - consumed;
+        }
+        x = uBase64DecodeStream(&stream, pBase64 + consumed, chunk,
+                                pBinary + binaryLengthOrError,
+                                binaryLength - binaryLengthOrError);
+        if (x >= 0) {
+            consumed += chunk;
+            binaryLengthOrError += x;
+        }
+    }
+    if (x >= 0) {
+        x = uBase64DecodeStreamFinish(&stream, pBinary + binaryLengthOrError,
+                                      binaryLength - binaryLengthOrError);
+    }
+    if (x >= 0) {
+        binaryLengthOrError += x;
+    } else {
+        binaryLengthOrError = x;
+    }
+
+    return binaryLengthOrError;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[base64]", "base64Stream")
+{
+    uBase64EncodeStream_t encodeStream;
+    uBase64DecodeStream_t decodeStream;
+    size_t length;
+    int32_t x;
+    int32_t startTimeMs;
+    int32_t wholeTimeMs;
+
+    // The test vectors, whole and chunked
+    for (size_t v = 0; v < sizeof(gVector) / sizeof(gVector[0]); v++) {
+        length = strlen(gVector[v].pBinary);
+        U_PORT_TEST_ASSERT(encodeChunked(gVector[v].pBinary, length, gBuffer) ==
+                           strlen(gVector[v].pBase64));
+        U_PORT_TEST_ASSERT(memcmp(gBuffer, gVector[v].pBase64, strlen(gVector[v].pBase64)) == 0);
+        x = decodeChunked(gVector[v].pBase64, strlen(gVector[v].pBase64),
+                          gBuffer, sizeof(gBuffer));
+        U_PORT_TEST_ASSERT(x == (int32_t) length);
+        U_PORT_TEST_ASSERT(memcmp(gBuffer, gVector[v].pBinary, length) == 0);
+    }
+
+    // A good length of binary data, checked against uBase64Encode()
+    for (size_t z = 0; z < sizeof(gBinary); z++) {
+        gBinary[z] = (char) ((z * 73) + (z >> 3));
+    }
+    for (size_t z = sizeof(gBinary) - 3; z <= sizeof(gBinary); z++) {
+        x = uBase64Encode(gBinary, z, gBase64, sizeof(gBase64));
+        U_PORT_TEST_ASSERT(x > 0);
+        U_PORT_TEST_ASSERT(encodeChunked(gBinary, z, gBuffer) == (size_t) x);
+        U_PORT_TEST_ASSERT(memcmp(gBuffer, gBase64, x) == 0);
+        U_PORT_TEST_ASSERT(decodeChunked(gBase64, x, gBuffer, sizeof(gBuffer)) == (int32_t) z);
+        U_PORT_TEST_ASSERT(memcmp(gBuffer, gBinary, z) == 0);
+    }
+
+    // Line breaks, as in a PEM file, should be ignored
+    length = 0;
+    for (size_t z = 0; z < sizeof(gBase64); z++) {
+        gBuffer[length] = gBase64[z];
+        length++;
+        if ((z % 64) == 63) {
+            gBuffer[length] = '\r';
+            length++;
+            gBuffer[length] = '\n';
+            length++;
+        }
+    }
+    U_PORT_TEST_ASSERT(decodeChunked(gBuffer, length, gBuffer,
+                                     sizeof(gBuffer)) == (int32_t) sizeof(gBinary));
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, gBinary, sizeof(gBinary)) == 0);
+
+    // Unpadded is fine, a lone character is not
+    U_PORT_TEST_ASSERT(decodeChunked("Zm9vYmE", 7, gBuffer, sizeof(gBuffer)) == 5);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, "fooba", 5) == 0);
+    U_PORT_TEST_ASSERT(decodeChunked("Zm9vYg", 6, gBuffer, sizeof(gBuffer)) == 4);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, "foob", 4) == 0);
+    U_PORT_TEST_ASSERT(decodeChunked("Zm9vY", 5, gBuffer,
+                                     sizeof(gBuffer)) == (int32_t) U_ERROR_COMMON_TRUNCATED);
+
+    // Bad characters, misplaced padding and data after padding
+    U_PORT_TEST_ASSERT(decodeChunked("Zm9v*mFy", 8, gBuffer,
+                                     sizeof(gBuffer)) == (int32_t) U_ERROR_COMMON_BAD_DATA);
+    U_PORT_TEST_ASSERT(decodeChunked("Z===", 4, gBuffer,
+                                     sizeof(gBuffer)) == (int32_t) U_ERROR_COMMON_BAD_DATA);
+    U_PORT_TEST_ASSERT(decodeChunked("Zg=a", 4, gBuffer,
+                                     sizeof(gBuffer)) == (int32_t) U_ERROR_COMMON_BAD_DATA);
+    U_PORT_TEST_ASSERT(decodeChunked("Zg==Zm8=", 8, gBuffer,
+                                     sizeof(gBuffer)) == (int32_t) U_ERROR_COMMON_BAD_DATA);
+
+    // Too little room should be refused without consuming anything
+    uBase64DecodeStreamInit(&decodeStream);
+    U_PORT_TEST_ASSERT(uBase64DecodeStream(&decodeStream, "Zm9vYmFy", 8, gBuffer,
+                                           5) == (int32_t) U_ERROR_COMMON_NO_MEMORY);
+    U_PORT_TEST_ASSERT(uBase64DecodeStream(&decodeStream, "Zm9vYmFy", 8, gBuffer, 6) == 6);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, "foobar", 6) == 0);
+    U_PORT_TEST_ASSERT(uBase64DecodeStreamFinish(&decodeStream, gBuffer, 0) == 0);
+
+    // Compare the speed of the whole-buffer and streaming functions
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t y = 0; y < U_UTILS_TEST_BASE64_BENCHMARK_ITERATIONS; y++) {
+        x = uBase64Encode(gBinary, sizeof(gBinary), gBase64, sizeof(gBase64));
+        uBase64Decode(gBase64, x, gBuffer, sizeof(gBuffer));
+    }
+    wholeTimeMs = uPortGetTickTimeMs() - startTimeMs;
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t y = 0; y < U_UTILS_TEST_BASE64_BENCHMARK_ITERATIONS; y++) {
+        uBase64EncodeStreamInit(&encodeStream);
+        x = uBase64EncodeStream(&encodeStream, gBinary, sizeof(gBinary),
+                                gBase64, sizeof(gBase64));
+        x += uBase64EncodeStreamFinish(&encodeStream, gBase64 + x, sizeof(gBase64) - x);
+        uBase64DecodeStreamInit(&decodeStream);
+        uBase64DecodeStream(&decodeStream, gBase64, x, gBuffer, sizeof(gBuffer));
+    }
+    U_TEST_PRINT_LINE("%d x %d byte(s) encoded and decoded: whole-buffer %d ms,"
+                      " streaming %d ms.", U_UTILS_TEST_BASE64_BENCHMARK_ITERATIONS,
+                      sizeof(gBinary), wholeTimeMs, uPortGetTickTimeMs() - startTimeMs);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, gBinary, sizeof(gBinary)) == 0);
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+// End of file
@@ -0,0 +1,171 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the hash set API
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port_os.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_hash_set.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_HASH_SET_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_UTILS_TEST_HASH_SET_NUM_SLOTS
+/** The number of slots in the hash set used for testing, must
+ * be a power of two.
+ */
+# define U_UTILS_TEST_HASH_SET_NUM_SLOTS 16
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Things to put in the hash set: more than will fit.
+ */
+static int32_t gEntry[U_UTILS_TEST_HASH_SET_NUM_SLOTS + 1];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Check that exactly the entries of gEntry with the given
+// bit set in pattern are in the set.
+static bool contentsAre(const uHashSet_t *pSet, uint32_t pattern)
+{
+    bool good = true;
+    size_t count = 0;
+
+    for (size_t x = 0; (x < U_UTILS_TEST_HASH_SET_NUM_SLOTS) && good; x++) {
+        good = (uHashSetContains(pSet, &(gEntry[x])) == ((pattern & (1UL << x)) != 0));
+        if (pattern & (1UL << x)) {
+            count++;
+        }
+    }
+
+    return good && (uHashSetGetCount(pSet) == count);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[hashSet]", "hashSetBasic")
+{
+    uHashSet_t set;
+    const void *slots[U_UTILS_TEST_HASH_SET_NUM_SLOTS];
+    uint32_t pattern = 0;
+
+    U_TEST_PRINT_LINE("testing hash set.");
+
+    // Bad parameters
+    U_PORT_TEST_ASSERT(uHashSetInit(NULL, slots, U_UTILS_TEST_HASH_SET_NUM_SLOTS) < 0);
+    U_PORT_TEST_ASSERT(uHashSetInit(&set, NULL, U_UTILS_TEST_HASH_SET_NUM_SLOTS) < 0);
+    U_PORT_TEST_ASSERT(uHashSetInit(&set, slots, 0) < 0);
+    U_PORT_TEST_ASSERT(uHashSetInit(&set, slots, U_UTILS_TEST_HASH_SET_NUM_SLOTS - 1) < 0);
+
+    U_PORT_TEST_ASSERT(uHashSetInit(&set, slots, U_UTILS_TEST_HASH_SET_NUM_SLOTS) == 0);
+    U_PORT_TEST_ASSERT(contentsAre(&set, pattern));
+    U_PORT_TEST_ASSERT(uHashSetAdd(&set, NULL) < 0);
+    U_PORT_TEST_ASSERT(!uHashSetContains(&set, NULL));
+    U_PORT_TEST_ASSERT(!uHashSetRemove(&set, NULL));
+    U_PORT_TEST_ASSERT(!uHashSetRemove(&set, &(gEntry[0])));
+
+    // Fill it right up, adding each entry twice, which is allowed
+    for (size_t x = 0; x < U_UTILS_TEST_HASH_SET_NUM_SLOTS; x++) {
+        U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[x])) == 0);
+        U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[x])) == 0);
+        pattern |= 1UL << x;
+        U_PORT_TEST_ASSERT(contentsAre(&set, pattern));
+    }
+    // One more should not fit, but what is there should still be found
+    U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[U_UTILS_TEST_HASH_SET_NUM_SLOTS])) ==
+                       (int32_t) U_ERROR_COMMON_NO_MEMORY);
+    U_PORT_TEST_ASSERT(!uHashSetContains(&set, &(gEntry[U_UTILS_TEST_HASH_SET_NUM_SLOTS])));
+    U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[0])) == 0);
+
+    // Remove every other one, checking that the rest can still be
+    // found each time, then add them back in reverse order
+    for (size_t x = 0; x < U_UTILS_TEST_HASH_SET_NUM_SLOTS; x += 2) {
+        U_PORT_TEST_ASSERT(uHashSetRemove(&set, &(gEntry[x])));
+        U_PORT_TEST_ASSERT(!uHashSetRemove(&set, &(gEntry[x])));
+        pattern &= ~(1UL << x);
+        U_PORT_TEST_ASSERT(contentsAre(&set, pattern));
+    }
+    for (size_t x = U_UTILS_TEST_HASH_SET_NUM_SLOTS; x > 0; x -= 2) {
+        U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[x - 2])) == 0);
+        pattern |= 1UL << (x - 2);
+        U_PORT_TEST_ASSERT(contentsAre(&set, pattern));
+    }
+
+    // Remove them all in a different order
+    for (size_t x = 0; x < U_UTILS_TEST_HASH_SET_NUM_SLOTS; x++) {
+        size_t y = (x * 7) % U_UTILS_TEST_HASH_SET_NUM_SLOTS;
+        U_PORT_TEST_ASSERT(uHashSetRemove(&set, &(gEntry[y])));
+        pattern &= ~(1UL << y);
+        U_PORT_TEST_ASSERT(contentsAre(&set, pattern));
+    }
+    U_PORT_TEST_ASSERT(pattern == 0);
+
+    // Add a few and clear
+    U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[1])) == 0);
+    U_PORT_TEST_ASSERT(uHashSetAdd(&set, &(gEntry[2])) == 0);
+    uHashSetClear(&set);
+    U_PORT_TEST_ASSERT(contentsAre(&set, 0));
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+// End of file
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the hex/binary conversion API
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memcmp(), memcpy()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_hex_bin_convert.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_HEX_BIN_CONVERT_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_UTILS_TEST_HEX_BIN_CONVERT_BENCHMARK_ITERATIONS
+/** The number of times to convert the data when timing things.
+ */
+# define U_UTILS_TEST_HEX_BIN_CONVERT_BENCHMARK_ITERATIONS 1000
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Binary data: every byte value plus a few so that the length is
+ * not a multiple of four.
+ */
+static char gBinary[256 + 3];
+
+/** ASCII hex of gBinary.
+ */
+static char gHex[sizeof(gBinary) * 2];
+
+/** Somewhere to put converted data, big enough to convert in place.
+ */
+static char gBuffer[sizeof(gHex)];
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[hexBinConvert]", "hexBinConvertBasic")
+{
+    int32_t startTimeMs;
+    size_t x;
+
+    U_TEST_PRINT_LINE("testing hex/binary conversion.");
+
+    for (x = 0; x < sizeof(gBinary); x++) {
+        gBinary[x] = (char) (x & 0xff);
+    }
+
+    // Known values, lower-case hex being accepted on the way back
+    U_PORT_TEST_ASSERT(uBinToHex("\x01\xab\xff", 3, gBuffer) == 6);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, "01ABFF", 6) == 0);
+    U_PORT_TEST_ASSERT(uHexToBin("01abFF7f", 8, gBuffer) == 4);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, "\x01\xab\xff\x7f", 4) == 0);
+
+    // Round trip of every length up to the size of the data
+    for (size_t y = 0; y <= sizeof(gBinary); y++) {
+        U_PORT_TEST_ASSERT(uBinToHex(gBinary, y, gHex) == y * 2);
+        U_PORT_TEST_ASSERT(uHexToBin(gHex, y * 2, gBuffer) == y);
+        U_PORT_TEST_ASSERT(memcmp(gBuffer, gBinary, y) == 0);
+    }
+
+    // An odd trailing character is ignored and conversion stops at
+    // the first pair that is not valid ASCII hex, wherever it falls
+    U_PORT_TEST_ASSERT(uHexToBin(gHex, 7, gBuffer) == 3);
+    for (size_t y = 0; y < 16; y++) {
+        memcpy(gBuffer, gHex, 32);
+        gBuffer[y] = 'g';
+        U_PORT_TEST_ASSERT(uHexToBin(gBuffer, 32, gBuffer + 32) == y / 2);
+        U_PORT_TEST_ASSERT(memcmp(gBuffer + 32, gBinary, y / 2) == 0);
+    }
+
+    // In place, both ways
+    memcpy(gBuffer, gBinary, sizeof(gBinary));
+    U_PORT_TEST_ASSERT(uBinToHexInPlace(gBuffer, sizeof(gBinary)) == sizeof(gHex));
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, gHex, sizeof(gHex)) == 0);
+    U_PORT_TEST_ASSERT(uHexToBin(gBuffer, sizeof(gHex), gBuffer) == sizeof(gBinary));
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, gBinary, sizeof(gBinary)) == 0);
+
+    // Printed for information
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t y = 0; y < U_UTILS_TEST_HEX_BIN_CONVERT_BENCHMARK_ITERATIONS; y++) {
+        x = uBinToHex(gBinary, sizeof(gBinary), gHex);
+        uHexToBin(gHex, x, gBuffer);
+    }
+    U_TEST_PRINT_LINE("%d x %d byte(s) converted to hex and back in %d ms.",
+                      U_UTILS_TEST_HEX_BIN_CONVERT_BENCHMARK_ITERATIONS, sizeof(gBinary),
+                      uPortGetTickTimeMs() - startTimeMs);
+    U_PORT_TEST_ASSERT(memcmp(gBuffer, gBinary, sizeof(gBinary)) == 0);
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+// End of file
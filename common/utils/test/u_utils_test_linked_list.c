@@ -88,10 +88,24 @@
 # define  U_UTILS_TEST_LINKED_LIST_CONTENTS_LENGTH_2 8
 #endif
 
+#ifndef U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES
+/** The number of entries to use when testing the intrusive list.
+ */
+# define U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES 5
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Structure to put on an intrusive list during testing, with the
+ * node deliberately not the first member.
+ */
+typedef struct {
+    int32_t value;
+    uIntrusiveListNode_t node;
+} uUtilsTestIntrusiveEntry_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -191,6 +205,68 @@ U_PORT_TEST_FUNCTION("[linkedList]", "linkedListBasic")
     // Memory leak checking is done in the clean-up
 }
 
+U_PORT_TEST_FUNCTION("[linkedList]", "linkedListIntrusive")
+{
+    uIntrusiveList_t list;
+    uUtilsTestIntrusiveEntry_t entry[U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES];
+    uUtilsTestIntrusiveEntry_t *pEntry;
+    uIntrusiveListNode_t *pNode;
+    int32_t count;
+    int32_t last = U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES - 1;
+    int32_t middle = U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES / 2;
+
+    U_TEST_PRINT_LINE("testing intrusive list.");
+
+    uIntrusiveListInit(&list);
+    U_PORT_TEST_ASSERT(uIntrusiveListIsEmpty(&list));
+    U_PORT_TEST_ASSERT(pUIntrusiveListFirst(&list) == NULL);
+    memset(entry, 0, sizeof(entry));
+    for (int32_t x = 0; x < U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES; x++) {
+        entry[x].value = x;
+        U_PORT_TEST_ASSERT(!uIntrusiveListNodeIsListed(&(entry[x].node)));
+        U_PORT_TEST_ASSERT(!uIntrusiveListRemove(&(entry[x].node)));
+        U_PORT_TEST_ASSERT(uIntrusiveListAdd(&list, &(entry[x].node)));
+        U_PORT_TEST_ASSERT(uIntrusiveListNodeIsListed(&(entry[x].node)));
+        // Can't add it twice
+        U_PORT_TEST_ASSERT(!uIntrusiveListAdd(&list, &(entry[x].node)));
+    }
+    U_PORT_TEST_ASSERT(!uIntrusiveListIsEmpty(&list));
+
+    // Iterate: should get them back in order
+    count = 0;
+    for (pNode = pUIntrusiveListFirst(&list); pNode != NULL;
+         pNode = pUIntrusiveListNext(&list, pNode)) {
+        pEntry = U_INTRUSIVE_LIST_CONTAINER(pNode, uUtilsTestIntrusiveEntry_t, node);
+        U_PORT_TEST_ASSERT(pEntry->value == count);
+        count++;
+    }
+    U_PORT_TEST_ASSERT(count == U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES);
+
+    // Remove the middle one, the first one and the last one
+    U_PORT_TEST_ASSERT(uIntrusiveListRemove(&(entry[middle].node)));
+    U_PORT_TEST_ASSERT(uIntrusiveListRemove(&(entry[0].node)));
+    U_PORT_TEST_ASSERT(uIntrusiveListRemove(&(entry[last].node)));
+    U_PORT_TEST_ASSERT(!uIntrusiveListNodeIsListed(&(entry[0].node)));
+    U_PORT_TEST_ASSERT(!uIntrusiveListRemove(&(entry[0].node)));
+    count = 0;
+    for (pNode = pUIntrusiveListFirst(&list); pNode != NULL;
+         pNode = pUIntrusiveListNext(&list, pNode)) {
+        pEntry = U_INTRUSIVE_LIST_CONTAINER(pNode, uUtilsTestIntrusiveEntry_t, node);
+        U_PORT_TEST_ASSERT((pEntry->value > 0) && (pEntry->value < last) &&
+                           (pEntry->value != middle));
+        count++;
+    }
+    U_PORT_TEST_ASSERT(count == U_UTILS_TEST_INTRUSIVE_LIST_NUM_ENTRIES - 3);
+
+    // Empty it while iterating
+    for (pNode = pUIntrusiveListFirst(&list); pNode != NULL;) {
+        uIntrusiveListNode_t *pNext = pUIntrusiveListNext(&list, pNode);
+        U_PORT_TEST_ASSERT(uIntrusiveListRemove(pNode));
+        pNode = pNext;
+    }
+    U_PORT_TEST_ASSERT(uIntrusiveListIsEmpty(&list));
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
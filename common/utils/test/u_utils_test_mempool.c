@@ -67,6 +67,11 @@
 #define TEST_BLOCK_COUNT 8
 #define TEST_BLOCK_SIZE  64
 
+/** The number of times each task of the lock-free test
+ * allocates and frees blocks.
+ */
+#define TEST_LOCK_FREE_NUM_LOOPS 1000
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -75,6 +80,15 @@
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/** Set by the lock-free test task when it has finished.
+ */
+static volatile bool gLockFreeTaskDone = false;
+
+/** Incremented by the lock-free test task for each block it
+ * found to have been corrupted.
+ */
+static volatile int32_t gLockFreeTaskErrors = 0;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -89,6 +103,29 @@ static bool isAllBytes(uint8_t *pBuf, size_t size, uint8_t cmpByte)
     return true;
 }
 
+// Task for the lock-free test: allocates blocks one at a time,
+// fills them, checks them and frees them again.
+static void lockFreeTask(void *pParameter)
+{
+    uMemPoolDesc_t *pMemPool = (uMemPoolDesc_t *) pParameter;
+    uint8_t *pBuf;
+
+    for (int32_t i = 0; i < TEST_LOCK_FREE_NUM_LOOPS; i++) {
+        pBuf = (uint8_t *)uMemPoolAllocMem(pMemPool);
+        if (pBuf != NULL) {
+            memset(pBuf, 0xAA, TEST_BLOCK_SIZE);
+            uPortTaskBlock(0);
+            if (!isAllBytes(pBuf, TEST_BLOCK_SIZE, 0xAA)) {
+                gLockFreeTaskErrors++;
+            }
+            uMemPoolFreeMem(pMemPool, pBuf);
+        }
+    }
+
+    gLockFreeTaskDone = true;
+    uPortTaskDelete(NULL);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -123,10 +160,17 @@ U_PORT_TEST_FUNCTION("[mempool]", "mempoolBasic")
     U_PORT_TEST_ASSERT(isAllBytes(pBuf1, TEST_BLOCK_SIZE, 0xFF));
     U_PORT_TEST_ASSERT(isAllBytes(pBuf2, TEST_BLOCK_SIZE, 0xEE));
 
+    // Both should be known to have come from the pool, the
+    // descriptor itself should not
+    U_PORT_TEST_ASSERT(uMemPoolContains(&mempoolDesc, pBuf1));
+    U_PORT_TEST_ASSERT(uMemPoolContains(&mempoolDesc, pBuf2));
+    U_PORT_TEST_ASSERT(!uMemPoolContains(&mempoolDesc, &mempoolDesc));
+
     uMemPoolFreeMem(&mempoolDesc, (void *)pBuf1);
     uMemPoolFreeMem(&mempoolDesc, (void *)pBuf2);
 
     uMemPoolDeinit(&mempoolDesc);
+    U_PORT_TEST_ASSERT(!uMemPoolContains(&mempoolDesc, pBuf1));
 
     // Check for resource leaks
     uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
@@ -140,6 +184,7 @@ U_PORT_TEST_FUNCTION("[mempool]", "mempoolFull")
     int32_t errCode;
     uMemPoolDesc_t mempoolDesc;
     uint8_t *pBuf[TEST_BLOCK_COUNT];
+    uMemPoolStats_t stats;
     int32_t resourceCount;
 
     // Whatever called us likely initialised the
@@ -150,6 +195,13 @@ U_PORT_TEST_FUNCTION("[mempool]", "mempoolFull")
 
     errCode = uMemPoolInit(&mempoolDesc, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT);
     U_PORT_TEST_ASSERT(errCode == U_ERROR_COMMON_SUCCESS);
+    U_PORT_TEST_ASSERT(uMemPoolGetStats(&mempoolDesc, NULL) < 0);
+    U_PORT_TEST_ASSERT(uMemPoolGetStats(&mempoolDesc, &stats) == 0);
+    U_PORT_TEST_ASSERT((stats.blockSize == TEST_BLOCK_SIZE) &&
+                       (stats.totalBlockCount == TEST_BLOCK_COUNT));
+    U_PORT_TEST_ASSERT((stats.usedBlockCount == 0) && (stats.usedBlockCountMax == 0) &&
+                       (stats.allocCount == 0) && (stats.freeCount == 0) &&
+                       (stats.allocFailCount == 0));
 
     // Allocate all buffers available in the pool
     for (int32_t i = 0; i < TEST_BLOCK_COUNT; i++) {
@@ -168,6 +220,14 @@ U_PORT_TEST_FUNCTION("[mempool]", "mempoolFull")
         uMemPoolFreeMem(&mempoolDesc, (void *)pBuf[i]);
     }
 
+    // The statistics should have seen all of that
+    U_PORT_TEST_ASSERT(uMemPoolGetStats(&mempoolDesc, &stats) == 0);
+    U_PORT_TEST_ASSERT(stats.usedBlockCount == 0);
+    U_PORT_TEST_ASSERT(stats.usedBlockCountMax == TEST_BLOCK_COUNT);
+    U_PORT_TEST_ASSERT(stats.allocCount == TEST_BLOCK_COUNT + 1);
+    U_PORT_TEST_ASSERT(stats.freeCount == TEST_BLOCK_COUNT + 1);
+    U_PORT_TEST_ASSERT(stats.allocFailCount == 1);
+
     uMemPoolDeinit(&mempoolDesc);
 
     // Check for resource leaks
@@ -224,4 +284,106 @@ U_PORT_TEST_FUNCTION("[mempool]", "mempoolFreeAllMem")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+U_PORT_TEST_FUNCTION("[mempool]", "mempoolLockFreeBatch")
+{
+    uMemPoolDesc_t mempoolDesc;
+    void *pBuf[TEST_BLOCK_COUNT + 2];
+    int32_t count;
+    uPortTaskHandle_t taskHandle;
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    // A lock-free pool must have a sane number of blocks
+    U_PORT_TEST_ASSERT(uMemPoolInitFlags(&mempoolDesc, TEST_BLOCK_SIZE, 0,
+                                         U_MEMPOOL_FLAG_LOCK_FREE) < 0);
+
+    // First with the mutex, eagerly initialised so the buffer should
+    // be there before anything has been allocated
+    U_PORT_TEST_ASSERT(uMemPoolInitFlags(&mempoolDesc, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT,
+                                         U_MEMPOOL_FLAG_EAGER_INIT) == 0);
+    U_PORT_TEST_ASSERT(mempoolDesc.pBuffer != NULL);
+    U_PORT_TEST_ASSERT(uMemPoolAllocBatch(&mempoolDesc, pBuf, 3) == 3);
+    U_PORT_TEST_ASSERT(mempoolDesc.usedBlockCount == 3);
+    U_PORT_TEST_ASSERT(uMemPoolAllocBatch(&mempoolDesc, pBuf + 3, TEST_BLOCK_COUNT) ==
+                       TEST_BLOCK_COUNT - 3);
+    uMemPoolFreeBatch(&mempoolDesc, pBuf, TEST_BLOCK_COUNT);
+    U_PORT_TEST_ASSERT(mempoolDesc.usedBlockCount == 0);
+    uMemPoolDeinit(&mempoolDesc);
+
+    // Then lock-free
+    U_PORT_TEST_ASSERT(uMemPoolInitFlags(&mempoolDesc, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT,
+                                         U_MEMPOOL_FLAG_LOCK_FREE) == 0);
+    U_PORT_TEST_ASSERT(mempoolDesc.pBuffer != NULL);
+
+    // Ask for more than there are, should get them all, all different
+    count = uMemPoolAllocBatch(&mempoolDesc, pBuf, TEST_BLOCK_COUNT + 2);
+    U_PORT_TEST_ASSERT(count == TEST_BLOCK_COUNT);
+    U_PORT_TEST_ASSERT(mempoolDesc.usedBlockCount == TEST_BLOCK_COUNT);
+    for (int32_t i = 0; i < count; i++) {
+        U_PORT_TEST_ASSERT(uMemPoolContains(&mempoolDesc, pBuf[i]));
+        memset(pBuf[i], i, TEST_BLOCK_SIZE);
+        for (int32_t j = 0; j < i; j++) {
+            U_PORT_TEST_ASSERT(pBuf[i] != pBuf[j]);
+        }
+    }
+    for (int32_t i = 0; i < count; i++) {
+        U_PORT_TEST_ASSERT(isAllBytes((uint8_t *)pBuf[i], TEST_BLOCK_SIZE, (uint8_t) i));
+    }
+    U_PORT_TEST_ASSERT(uMemPoolAllocMem(&mempoolDesc) == NULL);
+
+    // Free them with a NULL in the middle, which should be ignored
+    pBuf[TEST_BLOCK_COUNT] = pBuf[TEST_BLOCK_COUNT / 2];
+    pBuf[TEST_BLOCK_COUNT / 2] = NULL;
+    uMemPoolFreeBatch(&mempoolDesc, pBuf, TEST_BLOCK_COUNT + 1);
+    U_PORT_TEST_ASSERT(mempoolDesc.usedBlockCount == 0);
+
+    // Now have a task allocating and freeing single blocks while
+    // we allocate and free batches
+    gLockFreeTaskDone = false;
+    gLockFreeTaskErrors = 0;
+    U_PORT_TEST_ASSERT(uPortTaskCreate(lockFreeTask, "lockFreeMempool",
+                                       U_CFG_TEST_OS_TASK_STACK_SIZE_BYTES,
+                                       &mempoolDesc, U_CFG_TEST_OS_TASK_PRIORITY,
+                                       &taskHandle) == 0);
+    for (int32_t i = 0; (i < TEST_LOCK_FREE_NUM_LOOPS) || !gLockFreeTaskDone; i++) {
+        count = uMemPoolAllocBatch(&mempoolDesc, pBuf, 3);
+        U_PORT_TEST_ASSERT((count >= 0) && (count <= 3));
+        for (int32_t j = 0; j < count; j++) {
+            memset(pBuf[j], 0x55, TEST_BLOCK_SIZE);
+        }
+        uPortTaskBlock(0);
+        for (int32_t j = 0; j < count; j++) {
+            U_PORT_TEST_ASSERT(isAllBytes((uint8_t *)pBuf[j], TEST_BLOCK_SIZE, 0x55));
+        }
+        uMemPoolFreeBatch(&mempoolDesc, pBuf, count);
+    }
+    U_PORT_TEST_ASSERT(gLockFreeTaskErrors == 0);
+    U_PORT_TEST_ASSERT(mempoolDesc.usedBlockCount == 0);
+    // Everything should have gone back on the free stack
+    U_PORT_TEST_ASSERT(uMemPoolAllocBatch(&mempoolDesc, pBuf, TEST_BLOCK_COUNT) ==
+                       TEST_BLOCK_COUNT);
+    uMemPoolFreeAllMem(&mempoolDesc);
+    U_PORT_TEST_ASSERT(mempoolDesc.usedBlockCount == 0);
+    U_PORT_TEST_ASSERT(uMemPoolAllocBatch(&mempoolDesc, pBuf, TEST_BLOCK_COUNT) ==
+                       TEST_BLOCK_COUNT);
+
+    uMemPoolDeinit(&mempoolDesc);
+
+    // Let the task be cleaned up
+    uPortTaskBlock(100);
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 // End of file
\ No newline at end of file
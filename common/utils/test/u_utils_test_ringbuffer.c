@@ -35,6 +35,7 @@
 #include "string.h"    // strncpy(), strcmp(), memcpy(), memset()
 
 #include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
 #include "u_cfg_app_platform_specific.h"
 #include "u_cfg_test_platform_specific.h"
 
@@ -77,6 +78,20 @@
 # define U_TEST_UTILS_RINGBUFFER_FILL_CHAR 0x5a
 #endif
 
+#ifndef U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM
+/** The number of read handles to use when testing a ring buffer
+ * with many readers.
+ */
+# define U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM 10
+#endif
+
+#ifndef U_TEST_UTILS_RINGBUFFER_LOCK_FREE_NUM_BYTES
+/** The number of bytes to pass from the producer task to the
+ * consumer when testing a lock-free ring buffer.
+ */
+# define U_TEST_UTILS_RINGBUFFER_LOCK_FREE_NUM_BYTES 10000
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -85,6 +100,10 @@
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/** Set by the lock-free producer task when it has finished.
+ */
+static volatile bool gLockFreeProducerDone = false;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -109,6 +128,34 @@ static void printBuffer(const char *pTitle, const char *pStr, size_t length)
     uPortTaskBlock(10);
 }
 
+// Producer task for the lock-free test: adds a count to the ring
+// buffer in chunks of varying length, waiting while it is full.
+static void lockFreeProducerTask(void *pParameter)
+{
+    uRingBuffer_t *pRingBuffer = (uRingBuffer_t *) pParameter;
+    char chunk[7];
+    size_t length;
+    size_t count = 0;
+
+    while (count < U_TEST_UTILS_RINGBUFFER_LOCK_FREE_NUM_BYTES) {
+        length = 1 + (count % sizeof(chunk));
+        if (length > U_TEST_UTILS_RINGBUFFER_LOCK_FREE_NUM_BYTES - count) {
+            length = U_TEST_UTILS_RINGBUFFER_LOCK_FREE_NUM_BYTES - count;
+        }
+        for (size_t x = 0; x < length; x++) {
+            chunk[x] = (char) (count + x);
+        }
+        if (uRingBufferAdd(pRingBuffer, chunk, length)) {
+            count += length;
+        } else {
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        }
+    }
+
+    gLockFreeProducerDone = true;
+    uPortTaskDelete(NULL);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TESTS
  * -------------------------------------------------------------- */
@@ -321,6 +368,25 @@ U_PORT_TEST_FUNCTION("[ringbuffer]", "ringbufferBasic")
                        U_TEST_UTILS_RINGBUFFER_FILL_CHAR);
     U_PORT_TEST_ASSERT(bufferOut[sizeof(bufferOut) - 1] == U_TEST_UTILS_RINGBUFFER_FILL_CHAR);
     memset(bufferOut, U_TEST_UTILS_RINGBUFFER_FILL_CHAR, sizeof(bufferOut));
+    // Now the "handled" span peek, which should get the same data
+    // in no more than two spans
+    z = 0;
+    for (size_t x = 0; x < 3; x++) {
+        const char *pSpan = NULL;
+        y = uRingBufferPeekSpanHandle(&ringBuffer, handle[0], &pSpan, sizeof(bufferOut) - z, z);
+        if (y > 0) {
+            U_PORT_TEST_ASSERT(x < 2);
+            U_PORT_TEST_ASSERT((pSpan >= linearBuffer) &&
+                               (pSpan + y <= linearBuffer + sizeof(linearBuffer)));
+            memcpy(bufferOut + z, pSpan, y);
+            z += y;
+        }
+    }
+    U_TEST_PRINT_LINE(" span peek using handle 0x%08x returned %d byte(s).", handle[0], z);
+    U_PORT_TEST_ASSERT(z == sizeof(bufferIn) - 1);
+    U_PORT_TEST_ASSERT(memcmp(bufferOut, bufferIn, sizeof(bufferIn) - 1) == 0);
+    U_PORT_TEST_ASSERT(uRingBufferDataSizeHandle(&ringBuffer, handle[0]) == sizeof(bufferIn) - 1);
+    memset(bufferOut, U_TEST_UTILS_RINGBUFFER_FILL_CHAR, sizeof(bufferOut));
     // Now the "handled" read
     memset(bufferOut, U_TEST_UTILS_RINGBUFFER_FILL_CHAR, sizeof(bufferOut));
     printBuffer("  output buffer reset to", bufferOut, sizeof(bufferOut));
@@ -883,4 +949,265 @@ U_PORT_TEST_FUNCTION("[ringbuffer]", "ringbufferBasic")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Test the lock-free, single producer/single consumer, form of
+ * ring buffer: first the basics, including wrap, from a single task,
+ * then with a producer task and this task as the consumer.
+ */
+U_PORT_TEST_FUNCTION("[ringbuffer]", "ringbufferLockFree")
+{
+    int32_t resourceCount;
+    uRingBuffer_t ringBuffer;
+    char linearBuffer[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    char bufferOut[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    char bufferIn[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    uPortTaskHandle_t taskHandle;
+    size_t count = 0;
+    size_t y;
+
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    for (size_t x = 0; x < sizeof(bufferIn); x++) {
+        bufferIn[x] = (char) x;
+    }
+
+    U_TEST_PRINT_LINE("testing lock-free ring buffer from one task...");
+    U_PORT_TEST_ASSERT(uRingBufferCreateLockFree(&ringBuffer, linearBuffer,
+                                                 sizeof(linearBuffer)) == 0);
+    U_PORT_TEST_ASSERT(uRingBufferDataSize(&ringBuffer) == 0);
+    U_PORT_TEST_ASSERT(uRingBufferAvailableSize(&ringBuffer) == sizeof(linearBuffer) - 1);
+    // Too much should not go in, nor be lost from the read side
+    U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, bufferIn, sizeof(bufferIn)));
+    U_PORT_TEST_ASSERT(!uRingBufferForceAdd(&ringBuffer, bufferIn, sizeof(bufferIn)));
+    U_PORT_TEST_ASSERT(uRingBufferStatAddLoss(&ringBuffer) == sizeof(bufferIn) * 2);
+    // Go around the buffer a few times with an odd length so that the copies wrap
+    for (size_t x = 0; x < sizeof(linearBuffer) * 3; x++) {
+        U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, bufferIn, 3));
+        U_PORT_TEST_ASSERT(uRingBufferDataSize(&ringBuffer) == 3);
+        U_PORT_TEST_ASSERT(uRingBufferAvailableSize(&ringBuffer) == sizeof(linearBuffer) - 4);
+        memset(bufferOut, U_TEST_UTILS_RINGBUFFER_FILL_CHAR, sizeof(bufferOut));
+        U_PORT_TEST_ASSERT(uRingBufferPeek(&ringBuffer, bufferOut, sizeof(bufferOut), 1) == 2);
+        U_PORT_TEST_ASSERT(memcmp(bufferOut, bufferIn + 1, 2) == 0);
+        U_PORT_TEST_ASSERT(uRingBufferRead(&ringBuffer, bufferOut, sizeof(bufferOut)) == 3);
+        U_PORT_TEST_ASSERT(memcmp(bufferOut, bufferIn, 3) == 0);
+        U_PORT_TEST_ASSERT(bufferOut[3] == U_TEST_UTILS_RINGBUFFER_FILL_CHAR);
+    }
+    // Fill it right up, then flush it
+    U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, bufferIn, sizeof(bufferIn) - 1));
+    U_PORT_TEST_ASSERT(uRingBufferAvailableSize(&ringBuffer) == 0);
+    U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, bufferIn, 1));
+    uRingBufferFlush(&ringBuffer);
+    U_PORT_TEST_ASSERT(uRingBufferDataSize(&ringBuffer) == 0);
+    U_PORT_TEST_ASSERT(uRingBufferStatReadLoss(&ringBuffer) == 0);
+    uRingBufferDelete(&ringBuffer);
+    U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, bufferIn, 1));
+
+    U_TEST_PRINT_LINE("testing lock-free ring buffer with a producer task...");
+    U_PORT_TEST_ASSERT(uRingBufferCreateLockFree(&ringBuffer, linearBuffer,
+                                                 sizeof(linearBuffer)) == 0);
+    gLockFreeProducerDone = false;
+    U_PORT_TEST_ASSERT(uPortTaskCreate(lockFreeProducerTask, "lockFreeProducer",
+                                       U_CFG_TEST_OS_TASK_STACK_SIZE_BYTES,
+                                       &ringBuffer, U_CFG_TEST_OS_TASK_PRIORITY,
+                                       &taskHandle) == 0);
+    while (count < U_TEST_UTILS_RINGBUFFER_LOCK_FREE_NUM_BYTES) {
+        y = uRingBufferRead(&ringBuffer, bufferOut, sizeof(bufferOut));
+        for (size_t x = 0; x < y; x++) {
+            U_PORT_TEST_ASSERT(bufferOut[x] == (char) count);
+            count++;
+        }
+        if (y == 0) {
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        }
+    }
+    while (!gLockFreeProducerDone) {
+        uPortTaskBlock(10);
+    }
+    U_PORT_TEST_ASSERT(uRingBufferDataSize(&ringBuffer) == 0);
+    U_TEST_PRINT_LINE("%d byte(s) passed, %d byte(s) refused while full.",
+                      count, uRingBufferStatAddLoss(&ringBuffer));
+    uRingBufferDelete(&ringBuffer);
+
+    // Let the producer task be cleaned up
+    uPortTaskBlock(100);
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test the span functions of the ring buffer, on both the normal
+ * and the lock-free forms.
+ */
+U_PORT_TEST_FUNCTION("[ringbuffer]", "ringbufferSpans")
+{
+    int32_t resourceCount;
+    uRingBuffer_t ringBuffer;
+    char linearBuffer[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    char bufferOut[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    uRingBufferReadSpan_t readSpans[2];
+    uRingBufferWriteSpan_t writeSpans[2];
+    char count = 0;
+    char expected = 0;
+    size_t y;
+    size_t z;
+
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    for (size_t lockFree = 0; lockFree < 2; lockFree++) {
+        U_TEST_PRINT_LINE("testing spans on a%s ring buffer...", lockFree ? " lock-free" : "");
+        if (lockFree) {
+            U_PORT_TEST_ASSERT(uRingBufferCreateLockFree(&ringBuffer, linearBuffer,
+                                                         sizeof(linearBuffer)) == 0);
+        } else {
+            U_PORT_TEST_ASSERT(uRingBufferCreate(&ringBuffer, linearBuffer,
+                                                 sizeof(linearBuffer)) == 0);
+        }
+        // Empty: nothing to read, all free space in one span
+        U_PORT_TEST_ASSERT(uRingBufferGetReadSpans(&ringBuffer, readSpans) == 0);
+        U_PORT_TEST_ASSERT((readSpans[0].length == 0) && (readSpans[1].length == 0));
+        U_PORT_TEST_ASSERT(uRingBufferGetWriteSpans(&ringBuffer,
+                                                    writeSpans) == sizeof(linearBuffer) - 1);
+        U_PORT_TEST_ASSERT(writeSpans[0].length == sizeof(linearBuffer) - 1);
+        U_PORT_TEST_ASSERT(writeSpans[1].length == 0);
+        // Go around the buffer a few times, writing 4 and then consuming
+        // 4 through the spans so that both the free space and the data wrap
+        for (size_t x = 0; x < sizeof(linearBuffer) * 3; x++) {
+            y = uRingBufferGetWriteSpans(&ringBuffer, writeSpans);
+            U_PORT_TEST_ASSERT(y == sizeof(linearBuffer) - 1);
+            U_PORT_TEST_ASSERT(writeSpans[0].length + writeSpans[1].length == y);
+            z = 0;
+            for (size_t s = 0; (s < 2) && (z < 4); s++) {
+                for (size_t w = 0; (w < writeSpans[s].length) && (z < 4); w++) {
+                    writeSpans[s].pData[w] = count++;
+                    z++;
+                }
+            }
+            U_PORT_TEST_ASSERT(uRingBufferCommitWrite(&ringBuffer, 4) == 4);
+            U_PORT_TEST_ASSERT(uRingBufferDataSize(&ringBuffer) == 4);
+            U_PORT_TEST_ASSERT(uRingBufferGetReadSpans(&ringBuffer, readSpans) == 4);
+            U_PORT_TEST_ASSERT(readSpans[0].length + readSpans[1].length == 4);
+            for (size_t s = 0; s < 2; s++) {
+                for (size_t r = 0; r < readSpans[s].length; r++) {
+                    U_PORT_TEST_ASSERT(readSpans[s].pData[r] == expected);
+                    expected++;
+                }
+            }
+            U_PORT_TEST_ASSERT(uRingBufferCommitRead(&ringBuffer, 4) == 4);
+            U_PORT_TEST_ASSERT(uRingBufferDataSize(&ringBuffer) == 0);
+        }
+        // Committing more than there is room for/data available
+        // should be limited
+        U_PORT_TEST_ASSERT(uRingBufferCommitWrite(&ringBuffer,
+                                                  sizeof(linearBuffer)) == sizeof(linearBuffer) - 1);
+        U_PORT_TEST_ASSERT(uRingBufferStatAddLoss(&ringBuffer) == 1);
+        U_PORT_TEST_ASSERT(uRingBufferGetWriteSpans(&ringBuffer, writeSpans) == 0);
+        U_PORT_TEST_ASSERT((writeSpans[0].length == 0) && (writeSpans[1].length == 0));
+        U_PORT_TEST_ASSERT(uRingBufferCommitRead(&ringBuffer, 2) == 2);
+        U_PORT_TEST_ASSERT(uRingBufferRead(&ringBuffer, bufferOut,
+                                           sizeof(bufferOut)) == sizeof(linearBuffer) - 3);
+        U_PORT_TEST_ASSERT(uRingBufferCommitRead(&ringBuffer, 1) == 0);
+        uRingBufferDelete(&ringBuffer);
+        U_PORT_TEST_ASSERT(uRingBufferGetReadSpans(&ringBuffer, readSpans) == 0);
+        U_PORT_TEST_ASSERT(uRingBufferGetWriteSpans(&ringBuffer, writeSpans) == 0);
+    }
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test a ring buffer with many readers, checking that it is always
+ * the slowest of them that limits what can be added as the readers
+ * take turns at being the slowest.
+ */
+U_PORT_TEST_FUNCTION("[ringbuffer]", "ringbufferManyReaders")
+{
+    int32_t resourceCount;
+    uRingBuffer_t ringBuffer;
+    char linearBuffer[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    char bufferOut[U_TEST_UTILS_RINGBUFFER_SIZE + 1];
+    int32_t handle[U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM];
+    char b = 0;
+    size_t z;
+
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    U_TEST_PRINT_LINE("testing ring buffer with %d readers.",
+                      U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM);
+    U_PORT_TEST_ASSERT(uRingBufferCreateWithReadHandle(&ringBuffer, linearBuffer,
+                                                       sizeof(linearBuffer),
+                                                       U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM) == 0);
+    uRingBufferSetReadRequiresHandle(&ringBuffer, true);
+    for (size_t x = 0; x < U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM; x++) {
+        handle[x] = uRingBufferTakeReadHandle(&ringBuffer);
+        U_PORT_TEST_ASSERT(handle[x] > 0);
+    }
+    // Fill the buffer then, each time around, have all but one reader
+    // consume everything: only when the one left behind reads should
+    // there be room again
+    for (size_t x = 0; x < sizeof(linearBuffer) - 1; x++) {
+        U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, &b, 1));
+        b++;
+    }
+    for (size_t slowest = 0; slowest < U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM; slowest++) {
+        U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, &b, 1));
+        for (size_t x = 0; x < U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM; x++) {
+            if (x != slowest) {
+                uRingBufferReadHandle(&ringBuffer, handle[x], bufferOut, sizeof(bufferOut));
+                U_PORT_TEST_ASSERT(uRingBufferDataSizeHandle(&ringBuffer, handle[x]) == 0);
+            }
+        }
+        U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, &b, 1));
+        // The slowest reads one byte, making room for one byte
+        U_PORT_TEST_ASSERT(uRingBufferReadHandle(&ringBuffer, handle[slowest],
+                                                 bufferOut, 1) == 1);
+        U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, &b, 1));
+        b++;
+        U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, &b, 1));
+        // Now the others catch up and the slowest reads everything,
+        // checking that the last byte it reads is the last one added
+        z = uRingBufferDataSizeHandle(&ringBuffer, handle[slowest]);
+        U_PORT_TEST_ASSERT(z == sizeof(linearBuffer) - 1);
+        for (size_t x = 0; x < U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM; x++) {
+            if (x != slowest) {
+                U_PORT_TEST_ASSERT(uRingBufferReadHandle(&ringBuffer, handle[x],
+                                                         bufferOut, sizeof(bufferOut)) == 1);
+            }
+        }
+        U_PORT_TEST_ASSERT(uRingBufferReadHandle(&ringBuffer, handle[slowest],
+                                                 bufferOut, z) == z);
+        U_PORT_TEST_ASSERT(bufferOut[z - 1] == (char) (b - 1));
+        // All are now empty: fill the buffer again
+        for (size_t x = 0; x < sizeof(linearBuffer) - 1; x++) {
+            U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, &b, 1));
+            b++;
+        }
+    }
+    // Giving back a handle should not affect the others
+    uRingBufferGiveReadHandle(&ringBuffer, handle[0]);
+    U_PORT_TEST_ASSERT(!uRingBufferAdd(&ringBuffer, &b, 1));
+    for (size_t x = 1; x < U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM; x++) {
+        uRingBufferFlushHandle(&ringBuffer, handle[x]);
+    }
+    U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, bufferOut, sizeof(linearBuffer) - 1));
+    U_PORT_TEST_ASSERT(uRingBufferStatAddLoss(&ringBuffer) ==
+                       U_TEST_UTILS_RINGBUFFER_MANY_READERS_NUM * 3 + 1);
+    uRingBufferDelete(&ringBuffer);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 // End of file
\ No newline at end of file
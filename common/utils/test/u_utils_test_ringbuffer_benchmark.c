@@ -0,0 +1,433 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Throughput benchmark and stress test for the ring buffer:
+ * measures the rate at which data passes through a ring buffer when
+ * it is added and then read, peeked-at and read, or parsed and read,
+ * by one to #U_UTILS_TEST_RINGBUFFER_BENCHMARK_MAX_NUM_READ_HANDLES
+ * read handles, and when it is added by a producer task while being
+ * read by this one, for both the normal and the lock-free forms of
+ * ring buffer.  The results are printed, one measurement per line,
+ * as comma-separated values beginning with
+ * #U_UTILS_TEST_RINGBUFFER_BENCHMARK_CSV_PREFIX, the first such line
+ * being a header, so that they can be picked out of the test log by
+ * a script.  Should #U_UTILS_TEST_RINGBUFFER_BENCHMARK_MIN_BYTES_PER_SECOND
+ * be set the test fails if any rate is lower, so that a regression
+ * on a given platform can be caught.
+ * Run it on its own with the test filter "ringbufferBenchmark".
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_debug.h"
+#include "u_port_os.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_ringbuffer.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_RINGBUFFER_BENCHMARK_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+/** The string that follows #U_TEST_PREFIX at the start of each
+ * line of machine-readable results.
+ */
+#define U_UTILS_TEST_RINGBUFFER_BENCHMARK_CSV_PREFIX "CSV,"
+
+#ifndef U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES
+/** The number of bytes to pass through the ring buffer for each
+ * measurement.
+ */
+# define U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES (1024 * 256)
+#endif
+
+#ifndef U_UTILS_TEST_RINGBUFFER_BENCHMARK_BUFFER_SIZE
+/** The size of the linear buffer behind the ring buffer.
+ */
+# define U_UTILS_TEST_RINGBUFFER_BENCHMARK_BUFFER_SIZE 2048
+#endif
+
+#ifndef U_UTILS_TEST_RINGBUFFER_BENCHMARK_CHUNK_LENGTH
+/** The number of bytes added to the ring buffer at a time; must
+ * be a multiple of #U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_LENGTH
+ * and a factor of #U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES.
+ */
+# define U_UTILS_TEST_RINGBUFFER_BENCHMARK_CHUNK_LENGTH 128
+#endif
+
+#ifndef U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_LENGTH
+/** The length of the messages that the parser looks for.
+ */
+# define U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_LENGTH 32
+#endif
+
+/** The first byte of a message.
+ */
+#define U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_HEADER 0xb5
+
+#ifndef U_UTILS_TEST_RINGBUFFER_BENCHMARK_MAX_NUM_READ_HANDLES
+/** The largest number of read handles to benchmark with.
+ */
+# define U_UTILS_TEST_RINGBUFFER_BENCHMARK_MAX_NUM_READ_HANDLES 10
+#endif
+
+#ifndef U_UTILS_TEST_RINGBUFFER_BENCHMARK_MIN_BYTES_PER_SECOND
+/** If greater than zero, the test fails should any measured rate
+ * be lower than this.
+ */
+# define U_UTILS_TEST_RINGBUFFER_BENCHMARK_MIN_BYTES_PER_SECOND 0
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** The ways in which data is taken out of the ring buffer.
+ */
+typedef enum {
+    U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_READ,
+    U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_PEEK_READ,
+    U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_PARSE_READ,
+    U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_MAX_NUM
+} uUtilsTestRingBufferBenchmarkOp_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The names of the operations, for the CSV output, indexed by
+ * uUtilsTestRingBufferBenchmarkOp_t.
+ */
+static const char *const gpOpName[] = {"add/read", "add/peek/read", "add/parse/read"};
+
+/** The linear buffer behind the ring buffer.
+ */
+static char gLinearBuffer[U_UTILS_TEST_RINGBUFFER_BENCHMARK_BUFFER_SIZE];
+
+/** The data added: a sequence of messages.
+ */
+static char gChunk[U_UTILS_TEST_RINGBUFFER_BENCHMARK_CHUNK_LENGTH];
+
+/** Somewhere to read data into.
+ */
+static char gBuffer[U_UTILS_TEST_RINGBUFFER_BENCHMARK_CHUNK_LENGTH];
+
+/** The read handles.
+ */
+static int32_t gReadHandle[U_UTILS_TEST_RINGBUFFER_BENCHMARK_MAX_NUM_READ_HANDLES];
+
+/** The number of bytes the producer task has added.
+ */
+static volatile size_t gProducerCount = 0;
+
+/** Set by the producer task when it has finished.
+ */
+static volatile bool gProducerDone = false;
+
+/** The parsers, see benchmarkParser().
+ */
+static int32_t benchmarkParser(uParseHandle_t parseHandle, void *pUserParam);
+static U_RING_BUFFER_PARSER_f gParserList[] = {benchmarkParser, NULL};
+
+/** The number of results that fell short of
+ * #U_UTILS_TEST_RINGBUFFER_BENCHMARK_MIN_BYTES_PER_SECOND.
+ */
+static size_t gNumTooSlow = 0;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// A parser for the messages in gChunk.
+static int32_t benchmarkParser(uParseHandle_t parseHandle, void *pUserParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+    char c;
+
+    (void) pUserParam;
+
+    if (uRingBufferGetByteUnprotected(parseHandle, &c) &&
+        (c == (char) U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_HEADER)) {
+        errorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
+        if (uRingBufferGetBytesUnprotected(parseHandle, NULL,
+                                           U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_LENGTH - 1) ==
+            U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_LENGTH - 1) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    return errorCode;
+}
+
+// Take a chunk out of the ring buffer through the given handle,
+// or the non-handle functions if handle is negative, in the given
+// way, returning the number of bytes read.
+static size_t takeChunk(uRingBuffer_t *pRingBuffer, int32_t handle,
+                        uUtilsTestRingBufferBenchmarkOp_t op)
+{
+    size_t length = 0;
+    int32_t parsedLength = 1;
+
+    switch (op) {
+        case U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_PEEK_READ:
+            if (handle >= 0) {
+                uRingBufferPeekHandle(pRingBuffer, handle, gBuffer, sizeof(gBuffer), 0);
+            } else {
+                uRingBufferPeek(pRingBuffer, gBuffer, sizeof(gBuffer), 0);
+            }
+        //fall-through
+        case U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_READ:
+            if (handle >= 0) {
+                length = uRingBufferReadHandle(pRingBuffer, handle, gBuffer, sizeof(gBuffer));
+            } else {
+                length = uRingBufferRead(pRingBuffer, gBuffer, sizeof(gBuffer));
+            }
+            break;
+        case U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_PARSE_READ:
+            while ((length < sizeof(gBuffer)) && (parsedLength > 0)) {
+                parsedLength = (int32_t) uRingBufferParseHandle(pRingBuffer, handle,
+                                                                gParserList, NULL);
+                if (parsedLength > 0) {
+                    length += uRingBufferReadHandle(pRingBuffer, handle, gBuffer,
+                                                    (size_t) parsedLength);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+
+    return length;
+}
+
+// Print a result, checking it against the minimum rate.
+static void printResult(const char *pOp, size_t numReadHandles, int32_t durationMs)
+{
+    int64_t bytesPerSecond;
+
+    if (durationMs < 1) {
+        durationMs = 1;
+    }
+    bytesPerSecond = ((int64_t) U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES) * 1000 / durationMs;
+    U_TEST_PRINT_LINE(U_UTILS_TEST_RINGBUFFER_BENCHMARK_CSV_PREFIX "%s,%d,%d,%d,%d",
+                      pOp, (int32_t) numReadHandles, U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES,
+                      durationMs, (int32_t) bytesPerSecond);
+    if (bytesPerSecond < U_UTILS_TEST_RINGBUFFER_BENCHMARK_MIN_BYTES_PER_SECOND) {
+        gNumTooSlow++;
+    }
+}
+
+// Pass the data through the ring buffer, reading with the given
+// number of read handles, or with the non-handle functions if
+// numReadHandles is zero, returning the time taken.
+static int32_t measure(uRingBuffer_t *pRingBuffer, size_t numReadHandles,
+                       uUtilsTestRingBufferBenchmarkOp_t op)
+{
+    int32_t startTimeMs;
+    size_t count = 0;
+    size_t length;
+
+    startTimeMs = uPortGetTickTimeMs();
+    while (count < U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES) {
+        U_PORT_TEST_ASSERT(uRingBufferAdd(pRingBuffer, gChunk, sizeof(gChunk)));
+        if (numReadHandles == 0) {
+            length = takeChunk(pRingBuffer, -1, op);
+            U_PORT_TEST_ASSERT(length == sizeof(gChunk));
+        }
+        for (size_t x = 0; x < numReadHandles; x++) {
+            length = takeChunk(pRingBuffer, gReadHandle[x], op);
+            U_PORT_TEST_ASSERT(length == sizeof(gChunk));
+        }
+        count += sizeof(gChunk);
+    }
+
+    return uPortGetTickTimeMs() - startTimeMs;
+}
+
+// Producer task: adds the data in chunks, yielding while the
+// ring buffer is full.
+static void producerTask(void *pParameter)
+{
+    uRingBuffer_t *pRingBuffer = (uRingBuffer_t *) pParameter;
+
+    while (gProducerCount < U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES) {
+        if (uRingBufferAdd(pRingBuffer, gChunk, sizeof(gChunk))) {
+            gProducerCount += sizeof(gChunk);
+        } else {
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        }
+    }
+
+    gProducerDone = true;
+    uPortTaskDelete(NULL);
+}
+
+// Read the data as it is added by the producer task, returning
+// the time taken.
+static int32_t measureProducerConsumer(uRingBuffer_t *pRingBuffer)
+{
+    uPortTaskHandle_t taskHandle;
+    int32_t startTimeMs;
+    size_t count = 0;
+    size_t length;
+
+    gProducerCount = 0;
+    gProducerDone = false;
+    startTimeMs = uPortGetTickTimeMs();
+    U_PORT_TEST_ASSERT(uPortTaskCreate(producerTask, "benchmarkProducer",
+                                       U_CFG_TEST_OS_TASK_STACK_SIZE_BYTES,
+                                       pRingBuffer, U_CFG_TEST_OS_TASK_PRIORITY,
+                                       &taskHandle) == 0);
+    while (count < U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES) {
+        length = uRingBufferRead(pRingBuffer, gBuffer, sizeof(gBuffer));
+        if (length > 0) {
+            // The data must arrive in order
+            U_PORT_TEST_ASSERT(gBuffer[0] == gChunk[count % sizeof(gChunk)]);
+            count += length;
+        } else {
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        }
+    }
+    startTimeMs = uPortGetTickTimeMs() - startTimeMs;
+    while (!gProducerDone) {
+        uPortTaskBlock(10);
+    }
+    U_PORT_TEST_ASSERT(count == U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES);
+
+    return startTimeMs;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[ringbuffer]", "ringbufferBenchmark")
+{
+    int32_t resourceCount;
+    uRingBuffer_t ringBuffer;
+
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    // The data is a sequence of messages, each a header
+    // followed by a count
+    for (size_t x = 0; x < sizeof(gChunk); x++) {
+        gChunk[x] = (char) x;
+        if ((x % U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_LENGTH) == 0) {
+            gChunk[x] = (char) U_UTILS_TEST_RINGBUFFER_BENCHMARK_MESSAGE_HEADER;
+        }
+    }
+    gNumTooSlow = 0;
+
+    U_TEST_PRINT_LINE("passing %d byte(s) through a %d byte ring buffer, %d byte(s)"
+                      " at a time, for each measurement...",
+                      U_UTILS_TEST_RINGBUFFER_BENCHMARK_NUM_BYTES,
+                      U_UTILS_TEST_RINGBUFFER_BENCHMARK_BUFFER_SIZE,
+                      U_UTILS_TEST_RINGBUFFER_BENCHMARK_CHUNK_LENGTH);
+    U_TEST_PRINT_LINE(U_UTILS_TEST_RINGBUFFER_BENCHMARK_CSV_PREFIX
+                      "operation,read handles,bytes,duration ms,bytes per second");
+
+    // Without read handles
+    U_PORT_TEST_ASSERT(uRingBufferCreate(&ringBuffer, gLinearBuffer,
+                                         sizeof(gLinearBuffer)) == 0);
+    for (size_t op = 0; op < U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_PARSE_READ; op++) {
+        printResult(gpOpName[op], 0,
+                    measure(&ringBuffer, 0, (uUtilsTestRingBufferBenchmarkOp_t) op));
+    }
+    uRingBufferDelete(&ringBuffer);
+
+    // With one to the maximum number of read handles
+    for (size_t numReadHandles = 1;
+         numReadHandles <= U_UTILS_TEST_RINGBUFFER_BENCHMARK_MAX_NUM_READ_HANDLES;
+         numReadHandles++) {
+        U_PORT_TEST_ASSERT(uRingBufferCreateWithReadHandle(&ringBuffer, gLinearBuffer,
+                                                           sizeof(gLinearBuffer),
+                                                           numReadHandles) == 0);
+        uRingBufferSetReadRequiresHandle(&ringBuffer, true);
+        for (size_t x = 0; x < numReadHandles; x++) {
+            gReadHandle[x] = uRingBufferTakeReadHandle(&ringBuffer);
+            U_PORT_TEST_ASSERT(gReadHandle[x] >= 0);
+        }
+        for (size_t op = 0; op < U_UTILS_TEST_RINGBUFFER_BENCHMARK_OP_MAX_NUM; op++) {
+            printResult(gpOpName[op], numReadHandles,
+                        measure(&ringBuffer, numReadHandles,
+                                (uUtilsTestRingBufferBenchmarkOp_t) op));
+        }
+        for (size_t x = 0; x < numReadHandles; x++) {
+            uRingBufferGiveReadHandle(&ringBuffer, gReadHandle[x]);
+        }
+        uRingBufferDelete(&ringBuffer);
+    }
+
+    // With a producer task
+    U_PORT_TEST_ASSERT(uRingBufferCreate(&ringBuffer, gLinearBuffer,
+                                         sizeof(gLinearBuffer)) == 0);
+    printResult("producer/consumer", 0, measureProducerConsumer(&ringBuffer));
+    uRingBufferDelete(&ringBuffer);
+    U_PORT_TEST_ASSERT(uRingBufferCreateLockFree(&ringBuffer, gLinearBuffer,
+                                                 sizeof(gLinearBuffer)) == 0);
+    printResult("producer/consumer lock-free", 0, measureProducerConsumer(&ringBuffer));
+    uRingBufferDelete(&ringBuffer);
+
+    U_TEST_PRINT_LINE("%d result(s) below the minimum of %d byte(s) per second.",
+                      (int32_t) gNumTooSlow,
+                      U_UTILS_TEST_RINGBUFFER_BENCHMARK_MIN_BYTES_PER_SECOND);
+    U_PORT_TEST_ASSERT(gNumTooSlow == 0);
+
+    // Let the producer task be cleaned up
+    uPortTaskBlock(100);
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+// End of file
@@ -0,0 +1,200 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the time API
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_time.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_TIME_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_UTILS_TEST_TIME_NUM_MONTHS
+/** The number of months from 1970 over which to check the month
+ * conversions against a simple month-by-month count: 150 years.
+ */
+# define U_UTILS_TEST_TIME_NUM_MONTHS (150 * 12)
+#endif
+
+#ifndef U_UTILS_TEST_TIME_BENCHMARK_ITERATIONS
+/** The number of conversions to time.
+ */
+# define U_UTILS_TEST_TIME_BENCHMARK_ITERATIONS 1000
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Days in each month of a non-leap year.
+ */
+static const int32_t gDaysInMonth[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// The number of days in the given month (0 to 11) of the given year.
+static int32_t daysInMonth(int32_t year, int32_t month)
+{
+    int32_t days = gDaysInMonth[month];
+
+    if ((month == 1) && uTimeIsLeapYear(year)) {
+        days++;
+    }
+
+    return days;
+}
+
+// The loop-based conversion from months to seconds that
+// uTimeMonthsToSecondsUtc() once used, for comparison.
+static int64_t monthsToSecondsLoop(int32_t monthsUtc)
+{
+    int64_t secondsUtc = 0;
+
+    for (int32_t x = 0; x < monthsUtc; x++) {
+        secondsUtc += ((int64_t) daysInMonth((x / 12) + 1970, x % 12)) * 3600 * 24;
+    }
+
+    return secondsUtc;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[time]", "timeCalendar")
+{
+    int64_t days;
+    int64_t seconds;
+    int32_t year;
+    int32_t month;
+    int32_t day;
+    int32_t startTimeMs;
+    int32_t loopTimeMs;
+    int64_t x = 0;
+
+    U_TEST_PRINT_LINE("testing calendar conversions.");
+
+    U_PORT_TEST_ASSERT(uTimeIsLeapYear(2000));
+    U_PORT_TEST_ASSERT(!uTimeIsLeapYear(1900));
+    U_PORT_TEST_ASSERT(uTimeIsLeapYear(2024));
+    U_PORT_TEST_ASSERT(!uTimeIsLeapYear(2023));
+
+    // Some known dates, including a month that needs carrying
+    U_PORT_TEST_ASSERT(uTimeDaysFromCivil(1970, 1, 1) == 0);
+    U_PORT_TEST_ASSERT(uTimeDaysFromCivil(1969, 12, 31) == -1);
+    U_PORT_TEST_ASSERT(uTimeDaysFromCivil(2000, 3, 1) == 11017);
+    U_PORT_TEST_ASSERT(uTimeDaysFromCivil(2023, 13, 1) == uTimeDaysFromCivil(2024, 1, 1));
+    U_PORT_TEST_ASSERT(uTimeDaysFromCivil(2024, 0, 1) == uTimeDaysFromCivil(2023, 12, 1));
+    uTimeCivilFromDays(19723, &year, &month, &day);
+    U_PORT_TEST_ASSERT((year == 2024) && (month == 1) && (day == 1));
+    uTimeCivilFromDays(-719468, &year, &month, &day);
+    U_PORT_TEST_ASSERT((year == 0) && (month == 3) && (day == 1));
+    uTimeCivilFromDays(0, NULL, NULL, NULL);
+
+    // Walk day by day from 1600, checking that each conversion
+    // agrees with a simple count
+    days = uTimeDaysFromCivil(1600, 1, 1);
+    for (int32_t y = 1600; y < 2500; y++) {
+        for (int32_t m = 0; m < 12; m++) {
+            for (int32_t d = 1; d <= daysInMonth(y, m); d++) {
+                if ((y == 1970) && (m == 0) && (d == 1)) {
+                    U_PORT_TEST_ASSERT(days == 0);
+                }
+                U_PORT_TEST_ASSERT(uTimeDaysFromCivil(y, m + 1, d) == days);
+                U_PORT_TEST_ASSERT(uTimeDaysFromCivil(1600, ((y - 1600) * 12) + m + 1, d) == days);
+                uTimeCivilFromDays(days, &year, &month, &day);
+                U_PORT_TEST_ASSERT((year == y) && (month == m + 1) && (day == d));
+                days++;
+            }
+        }
+    }
+
+    // The month conversions against the loop, including either side
+    // of each boundary
+    U_PORT_TEST_ASSERT(uTimeMonthsToSecondsUtc(-1) == 0);
+    U_PORT_TEST_ASSERT(uTimeSecondsToMonthsUtc(-1) == 0);
+    for (int32_t m = 0; m < U_UTILS_TEST_TIME_NUM_MONTHS; m++) {
+        seconds = monthsToSecondsLoop(m);
+        U_PORT_TEST_ASSERT(uTimeMonthsToSecondsUtc(m) == seconds);
+        U_PORT_TEST_ASSERT(uTimeSecondsToMonthsUtc(seconds) == m);
+        U_PORT_TEST_ASSERT(uTimeSecondsToMonthsUtc(seconds + 1) == m);
+        if (m > 0) {
+            U_PORT_TEST_ASSERT(uTimeSecondsToMonthsUtc(seconds - 1) == m - 1);
+        }
+    }
+
+    // Compare the speed with the loop, for dates around now
+    startTimeMs = uPortGetTickTimeMs();
+    for (int32_t y = 0; y < U_UTILS_TEST_TIME_BENCHMARK_ITERATIONS; y++) {
+        x += monthsToSecondsLoop(((2023 - 1970) * 12) + (y % 12));
+    }
+    loopTimeMs = uPortGetTickTimeMs() - startTimeMs;
+    startTimeMs = uPortGetTickTimeMs();
+    for (int32_t y = 0; y < U_UTILS_TEST_TIME_BENCHMARK_ITERATIONS; y++) {
+        x -= uTimeMonthsToSecondsUtc(((2023 - 1970) * 12) + (y % 12));
+    }
+    U_TEST_PRINT_LINE("%d month conversion(s): by loop %d ms, by calculation %d ms.",
+                      U_UTILS_TEST_TIME_BENCHMARK_ITERATIONS, loopTimeMs,
+                      uPortGetTickTimeMs() - startTimeMs);
+    U_PORT_TEST_ASSERT(x == 0);
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+// End of file
@@ -0,0 +1,271 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the operation tracing API.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // strcmp()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+#include "u_cfg_os_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_trace.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_TRACE_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_UTILS_TEST_TRACE_STAGE_MS
+/** The time to spend in each stage of the test operation.
+ */
+# define U_UTILS_TEST_TRACE_STAGE_MS 20
+#endif
+
+/** The slack to allow when checking the time reported for a
+ * stage: some platforms have only a millisecond tick.
+ */
+#define U_UTILS_TEST_TRACE_SLACK_US 2000
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The number of times the callback has been called.
+ */
+static volatile int32_t gCallbackCount = 0;
+
+/** A copy of the report of the operation in the main test task.
+ */
+static uTraceOperation_t gReport;
+
+/** A copy of the report of the operation in the other task.
+ */
+static uTraceOperation_t gReportTask;
+
+/** Set to true when the other task has finished.
+ */
+static volatile bool gTaskDone = false;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// The trace callback.
+static void callback(const uTraceOperation_t *pOperation, void *pCallbackParam)
+{
+    int32_t *pParam = (int32_t *) pCallbackParam;
+
+    if ((pParam != NULL) && (*pParam == 0xabcd)) {
+        if (strcmp(pOperation->pName, "task") == 0) {
+            gReportTask = *pOperation;
+        } else {
+            gReport = *pOperation;
+        }
+        gCallbackCount++;
+    }
+}
+
+// Print a report.
+static void printReport(const uTraceOperation_t *pOperation)
+{
+    U_TEST_PRINT_LINE("\"%s\" returned %d after %d us:", pOperation->pName,
+                      pOperation->result, pOperation->durationUs);
+    for (size_t x = 0; x < U_TRACE_STAGE_MAX_NUM; x++) {
+        U_TEST_PRINT_LINE("  stage %d: %d us, entered %d time(s).", (int32_t) x,
+                          pOperation->stageUs[x], pOperation->stageCount[x]);
+    }
+}
+
+// Check that the stages of a report add up to its duration.
+static bool stagesAddUp(const uTraceOperation_t *pOperation)
+{
+    int32_t sumUs = 0;
+
+    for (size_t x = 0; x < U_TRACE_STAGE_MAX_NUM; x++) {
+        sumUs += pOperation->stageUs[x];
+    }
+
+    return sumUs == pOperation->durationUs;
+}
+
+// Task that traces an operation of its own while the main
+// test task is in the middle of one.
+static void traceTask(void *pParameter)
+{
+    int32_t handle;
+
+    (void) pParameter;
+
+    handle = uTraceOperationStart("task");
+    if (handle >= 0) {
+        if (uTraceStagePush(U_TRACE_STAGE_AT_WRITE)) {
+            uPortTaskBlock(U_UTILS_TEST_TRACE_STAGE_MS);
+            uTraceStagePop();
+        }
+        uTraceOperationStop(handle, 1);
+    }
+
+    gTaskDone = true;
+    uPortTaskDelete(NULL);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+U_PORT_TEST_FUNCTION("[trace]", "traceBasic")
+{
+    int32_t param = 0xabcd;
+    int32_t handle;
+    int32_t expectedUs = U_UTILS_TEST_TRACE_STAGE_MS * 1000;
+    uPortTaskHandle_t taskHandle;
+
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    U_TEST_PRINT_LINE("testing operation tracing.");
+
+    // With no callback nothing should be traced
+    gCallbackCount = 0;
+    U_PORT_TEST_ASSERT(uTraceOperationStart("nothing") < 0);
+    U_PORT_TEST_ASSERT(!uTraceStagePush(U_TRACE_STAGE_SERVICE));
+    uTraceStagePop();
+    uTraceOperationStop(-1, 0);
+    U_PORT_TEST_ASSERT(gCallbackCount == 0);
+
+    uTraceCallbackSet(callback, &param);
+
+    // Nor should a stage in a task that has no operation
+    U_PORT_TEST_ASSERT(!uTraceStagePush(U_TRACE_STAGE_SERVICE));
+
+    // Trace an operation with a stage of each type, nested
+    // as they would be for a uSockWrite()
+    handle = uTraceOperationStart("operation");
+    U_PORT_TEST_ASSERT(handle >= 0);
+    // A nested operation is not traced separately
+    U_PORT_TEST_ASSERT(uTraceOperationStart("nested") < 0);
+    uPortTaskBlock(U_UTILS_TEST_TRACE_STAGE_MS);
+    U_PORT_TEST_ASSERT(uTraceStagePush(U_TRACE_STAGE_SERVICE));
+    uPortTaskBlock(U_UTILS_TEST_TRACE_STAGE_MS);
+    U_PORT_TEST_ASSERT(uTraceStagePush(U_TRACE_STAGE_AT_LOCK_WAIT));
+    uPortTaskBlock(U_UTILS_TEST_TRACE_STAGE_MS);
+    uTraceStagePop();
+    U_PORT_TEST_ASSERT(uTraceStagePush(U_TRACE_STAGE_AT_WRITE));
+    uPortTaskBlock(U_UTILS_TEST_TRACE_STAGE_MS);
+    uTraceStagePop();
+    // Have another task trace an operation while this one is under way
+    gTaskDone = false;
+    U_PORT_TEST_ASSERT(uPortTaskCreate(traceTask, "traceTask",
+                                       U_CFG_TEST_OS_TASK_STACK_SIZE_BYTES,
+                                       NULL, U_CFG_TEST_OS_TASK_PRIORITY,
+                                       &taskHandle) == 0);
+    U_PORT_TEST_ASSERT(uTraceStagePush(U_TRACE_STAGE_AT_RESPONSE));
+    while (!gTaskDone) {
+        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+    }
+    uTraceStagePop();
+    uTraceStagePop();
+    // Overflow the stack: the pushes and pops should still balance
+    for (size_t x = 0; x < U_TRACE_STAGE_STACK_DEPTH + 2; x++) {
+        U_PORT_TEST_ASSERT(uTraceStagePush(U_TRACE_STAGE_AT_RESPONSE));
+    }
+    for (size_t x = 0; x < U_TRACE_STAGE_STACK_DEPTH + 2; x++) {
+        uTraceStagePop();
+    }
+    // An extra pop should do no harm
+    uTraceStagePop();
+    uPortTaskBlock(U_UTILS_TEST_TRACE_STAGE_MS);
+    U_PORT_TEST_ASSERT(gCallbackCount == 1);
+    uTraceOperationStop(handle, 42);
+    U_PORT_TEST_ASSERT(gCallbackCount == 2);
+
+    printReport(&gReportTask);
+    U_PORT_TEST_ASSERT(gReportTask.result == 1);
+    U_PORT_TEST_ASSERT(stagesAddUp(&gReportTask));
+    U_PORT_TEST_ASSERT(gReportTask.stageUs[U_TRACE_STAGE_AT_WRITE] >=
+                       expectedUs - U_UTILS_TEST_TRACE_SLACK_US);
+    U_PORT_TEST_ASSERT(gReportTask.stageCount[U_TRACE_STAGE_AT_WRITE] == 1);
+    U_PORT_TEST_ASSERT(gReportTask.stageCount[U_TRACE_STAGE_AT_RESPONSE] == 0);
+
+    printReport(&gReport);
+    U_PORT_TEST_ASSERT(strcmp(gReport.pName, "operation") == 0);
+    U_PORT_TEST_ASSERT(gReport.result == 42);
+    U_PORT_TEST_ASSERT(stagesAddUp(&gReport));
+    U_PORT_TEST_ASSERT(gReport.durationUs >= (expectedUs * 6) - U_UTILS_TEST_TRACE_SLACK_US);
+    U_PORT_TEST_ASSERT(gReport.stageUs[U_TRACE_STAGE_API] >=
+                       (expectedUs * 2) - U_UTILS_TEST_TRACE_SLACK_US);
+    for (size_t x = U_TRACE_STAGE_SERVICE; x < U_TRACE_STAGE_MAX_NUM; x++) {
+        U_PORT_TEST_ASSERT(gReport.stageUs[x] >= expectedUs - U_UTILS_TEST_TRACE_SLACK_US);
+    }
+    U_PORT_TEST_ASSERT(gReport.stageCount[U_TRACE_STAGE_API] == 1);
+    U_PORT_TEST_ASSERT(gReport.stageCount[U_TRACE_STAGE_SERVICE] == 1);
+    U_PORT_TEST_ASSERT(gReport.stageCount[U_TRACE_STAGE_AT_LOCK_WAIT] == 1);
+    U_PORT_TEST_ASSERT(gReport.stageCount[U_TRACE_STAGE_AT_WRITE] == 1);
+    // Only the pushes that fitted on the stack are counted
+    U_PORT_TEST_ASSERT(gReport.stageCount[U_TRACE_STAGE_AT_RESPONSE] ==
+                       1 + (U_TRACE_STAGE_STACK_DEPTH - 1));
+
+    // The operation is over so a stage should not be recorded
+    U_PORT_TEST_ASSERT(!uTraceStagePush(U_TRACE_STAGE_SERVICE));
+
+    // Switch tracing off again
+    uTraceCallbackSet(NULL, NULL);
+    U_PORT_TEST_ASSERT(uTraceOperationStart("nothing") < 0);
+    U_PORT_TEST_ASSERT(gCallbackCount == 2);
+
+    // Let the task be cleaned up
+    uPortTaskBlock(100);
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+// End of file
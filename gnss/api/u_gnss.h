@@ -276,6 +276,49 @@ int32_t uGnssGetSpiFillThreshold(uDeviceHandle_t gnssHandle);
  */
 int32_t uGnssSetSpiFillThreshold(uDeviceHandle_t gnssHandle, int32_t count);
 
+/** When using an I2C transport the MCU normally has to poll the GNSS
+ * chip to find out whether it has any data; if the TX ready pin of
+ * the GNSS chip is connected to the MCU this function may be called
+ * to have the GNSS chip assert TX ready when it has data, which
+ * avoids bothering the I2C bus with polling, freeing it for other
+ * devices; where the platform supports GPIO interrupts (see
+ * uPortGpioInterruptSet()) data is also read as soon as it is
+ * available.  When the pin is asserted all of the data the GNSS chip
+ * has is read in as few transfers as possible.  Only supported on
+ * I2C and for GNSS chips that support the CFG-VALSET mechanism
+ * (e.g. M9 and later).
+ *
+ * @param gnssHandle     the handle of the GNSS instance.
+ * @param pinMcu         the pin of the MCU that is connected to TX
+ *                       ready; OR in #U_GNSS_PIN_INVERTED if TX ready
+ *                       should be active low.  Use -1 to stop using
+ *                       TX ready (the default).
+ * @param pinGnss        the pin (PIO number) of the GNSS chip to use
+ *                       for TX ready; ignored if pinMcu is -1.
+ * @param thresholdBytes the amount of data the GNSS chip should have
+ *                       before it asserts TX ready, rounded up to a
+ *                       multiple of 8 bytes; smaller amounts remain
+ *                       in the GNSS chip until more arrives so, unless
+ *                       you always expect large messages, zero is the
+ *                       best choice.  Ignored if pinMcu is -1.
+ * @return               zero on success else negative error code.
+ */
+int32_t uGnssSetPinTxReady(uDeviceHandle_t gnssHandle, int32_t pinMcu,
+                           int32_t pinGnss, size_t thresholdBytes);
+
+/** Determine whether data from the GNSS chip on an SPI transport is
+ * being received in the background, using interrupts or DMA.  This
+ * will be the case if the platform supports
+ * uPortSpiControllerReceiveAsyncStart() and
+ * #U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES is non-zero, otherwise
+ * the SPI bus is polled.
+ *
+ * @param gnssHandle  the handle of the GNSS instance.
+ * @return            true if SPI data is being received in the
+ *                    background, else false.
+ */
+bool uGnssSpiReceiveIsAsync(uDeviceHandle_t gnssHandle);
+
 /** Get whether printing of UBX commands and responses is on or off.
  *
  * @param gnssHandle   the handle of the GNSS instance.
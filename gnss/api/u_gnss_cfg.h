@@ -112,6 +112,15 @@ extern "C" {
                        U_GNSS_CFG_VAL_LAYER_BBRAM |                        \
                        U_GNSS_CFG_VAL_LAYER_FLASH)
 
+#ifndef U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES
+/** The number of values that a #uGnssCfgValBatch_t can accumulate
+ * before they are sent to the GNSS device in a single UBX-CFG-VALSET
+ * message; this may be reduced to save RAM but may not be more than
+ * 64, the most a VALSET message can carry.
+ */
+# define U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES 64
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -173,6 +182,51 @@ typedef enum {
     U_GNSS_CFG_VAL_LAYER_MAX_NUM
 } uGnssCfgValLayer_t;
 
+/** A batch of values to be set using uGnssCfgValBatchStart(),
+ * uGnssCfgValBatchAdd() and uGnssCfgValBatchExecute(); the contents
+ * are private to this API, this structure is only here so that you
+ * may decide where the memory for it comes from.
+ */
+typedef struct {
+    uDeviceHandle_t gnssHandle;
+    uint32_t layers;
+    int32_t errorCode;
+    size_t numMessages;
+    size_t numValues;
+    uGnssCfgVal_t list[U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES];
+} uGnssCfgValBatch_t;
+
+/* The entries of this enum MUST be U_GNSS_CFG_VAL_KEY_TYPE_ followed
+ * by the type letter that begins the size indicator on the end of
+ * each item name in u_gnss_cfg_val_key.h, since the
+ * u_gnss_cfg_val_key.py script uses them in the key information
+ * table that it writes.
+ */
+/** The value types for the VALSET/VALGET/VALDEL API, as they appear
+ * in the key information table, see pUGnssCfgValKeyInfo().
+ */
+typedef enum {
+    U_GNSS_CFG_VAL_KEY_TYPE_L = 0, /**< a boolean, stored in one bit. */
+    U_GNSS_CFG_VAL_KEY_TYPE_U = 1, /**< an unsigned integer. */
+    U_GNSS_CFG_VAL_KEY_TYPE_I = 2, /**< a signed integer. */
+    U_GNSS_CFG_VAL_KEY_TYPE_E = 3, /**< an enumeration, unsigned. */
+    U_GNSS_CFG_VAL_KEY_TYPE_X = 4, /**< a bit-field, unsigned. */
+    U_GNSS_CFG_VAL_KEY_TYPE_R = 5  /**< an IEEE754 floating point number. */
+} uGnssCfgValKeyType_t;
+
+/** An entry in the key information table, see pUGnssCfgValKeyInfo();
+ * the storage size may be obtained from keyId with
+ * #U_GNSS_CFG_VAL_KEY_GET_SIZE.
+ */
+typedef struct {
+    uint32_t keyId;    /**< the key ID. */
+    uint8_t type;      /**< the #uGnssCfgValKeyType_t of the value, stored
+                            as a uint8_t to keep the table small. */
+    const char *pName; /**< the name of the key as it appears in the
+                            u-blox reference manual but without the
+                            "CFG-" prefix, e.g. "ANA-USE_ANA". */
+} uGnssCfgValKeyInfo_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: SPECIFIC CONFIGURATION FUNCTIONS
  * -------------------------------------------------------------- */
@@ -595,6 +649,59 @@ int32_t uGnssCfgValSetList(uDeviceHandle_t gnssHandle,
                            uGnssCfgValTransaction_t transaction,
                            uint32_t layers);
 
+/** Begin a batch of configuration values to be set; only applicable
+ * to M9 modules and beyond.  Rather than sending each value in a
+ * UBX-CFG-VALSET message of its own, and waiting for an acknowledgement
+ * each time, values added with uGnssCfgValBatchAdd() are accumulated
+ * and sent #U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES at a time as parts of
+ * a single transaction; the transaction is applied when
+ * uGnssCfgValBatchExecute() is called.  No communication with the
+ * GNSS device takes place in this function.
+ *
+ * As with any transaction, no other set/del operation must be
+ * performed on the GNSS device until the batch has been executed,
+ * otherwise the transaction will be cancelled.
+ *
+ * @param[out] pBatch  a pointer to the batch, which must remain
+ *                     valid until uGnssCfgValBatchExecute() has
+ *                     returned; cannot be NULL.
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param layers       the layers to set the values in, a bit-map of
+ *                     #uGnssCfgValLayer_t values OR'ed together, see
+ *                     uGnssCfgValSetList() for the details.
+ * @return             zero on success else negative error code.
+ */
+int32_t uGnssCfgValBatchStart(uGnssCfgValBatch_t *pBatch,
+                              uDeviceHandle_t gnssHandle,
+                              uint32_t layers);
+
+/** Add a value to a batch begun with uGnssCfgValBatchStart(); if
+ * the batch is already full its contents are first sent to the
+ * GNSS device, which will hold them until uGnssCfgValBatchExecute()
+ * is called.  If an error occurs it is remembered and returned by
+ * all subsequent calls for this batch, including
+ * uGnssCfgValBatchExecute(), so it is sufficient to check only
+ * the return value of the latter.
+ *
+ * @param[in] pBatch   a pointer to the batch; cannot be NULL.
+ * @param keyId        the ID of the key to set, see uGnssCfgValSet().
+ * @param value        the value to set.
+ * @return             zero on success else negative error code.
+ */
+int32_t uGnssCfgValBatchAdd(uGnssCfgValBatch_t *pBatch,
+                            uint32_t keyId, uint64_t value);
+
+/** Send any values remaining in a batch begun with
+ * uGnssCfgValBatchStart() to the GNSS device and apply all of the
+ * values in the batch; if all of the values fitted into a single
+ * message then no transaction is used.  Once this function has
+ * returned pBatch may be re-used or freed.
+ *
+ * @param[in] pBatch   a pointer to the batch; cannot be NULL.
+ * @return             zero on success else negative error code.
+ */
+int32_t uGnssCfgValBatchExecute(uGnssCfgValBatch_t *pBatch);
+
 /** Delete a configuration item; only applicable to M9 modules
  * and beyond, using the UBX-CFG-VALDEL mechanism.
  *
@@ -731,6 +838,122 @@ int32_t uGnssCfgValDelListX(uDeviceHandle_t gnssHandle,
                             uGnssCfgValTransaction_t transaction,
                             uint32_t layers);
 
+/* ----------------------------------------------------------------
+ * FUNCTIONS: KEY INFORMATION AND TYPE-CHECKED VALGET/VALSET, FROM M9
+ * -------------------------------------------------------------- */
+
+/** Get the information for a key ID from the table of all of the
+ * key IDs in u_gnss_cfg_val_key.h; this does not talk to the GNSS
+ * chip.  The table occupies around 33 kbytes of flash and is only
+ * linked into your application if you call this function or one
+ * of the type-checked functions below.
+ *
+ * @param keyId the key ID, e.g. #U_GNSS_CFG_VAL_KEY_ID_ANA_USE_ANA_L;
+ *              wild-cards are not permitted.
+ * @return      a pointer to the information for the key ID or NULL
+ *              if the key ID is not in the table.
+ */
+const uGnssCfgValKeyInfo_t *pUGnssCfgValKeyInfo(uint32_t keyId);
+
+/** Get the information for a key from its name, as it appears in
+ * the u-blox reference manual, e.g. "CFG-ANA-USE_ANA"; the "CFG-"
+ * prefix may be omitted.  This does not talk to the GNSS chip and
+ * is a linear search, hence is rather slower than
+ * pUGnssCfgValKeyInfo().
+ *
+ * @param[in] pName the name of the key, case sensitive; cannot be NULL.
+ * @return          a pointer to the information for the key or NULL
+ *                  if the name is not in the table.
+ */
+const uGnssCfgValKeyInfo_t *pUGnssCfgValKeyInfoFromName(const char *pName);
+
+/** Get the value of an integer, boolean, enumeration or bit-field
+ * configuration item, checking the key ID against the key information
+ * table; only applicable to M9 modules and beyond, uses the
+ * UBX-CFG-VALGET mechanism.  Signed values are sign-extended.
+ *
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param keyId        the ID of the key to get; wild-cards are not
+ *                     permitted.
+ * @param[out] pValue  a pointer to a place to put the value; cannot
+ *                     be NULL.
+ * @param layer        the layer to get the value from: use
+ *                     #U_GNSS_CFG_VAL_LAYER_RAM to get the currently
+ *                     applied value.
+ * @return             zero on success, #U_ERROR_COMMON_NOT_FOUND if
+ *                     keyId is not in the key information table,
+ *                     #U_ERROR_COMMON_INVALID_PARAMETER if keyId is
+ *                     that of a floating point value, else negative
+ *                     error code.
+ */
+int32_t uGnssCfgValGetInt(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                          int64_t *pValue, uGnssCfgValLayer_t layer);
+
+/** Set the value of an integer, boolean, enumeration or bit-field
+ * configuration item, checking the key ID against the key information
+ * table and the value against the type and size of the key; only
+ * applicable to M9 modules and beyond, uses the UBX-CFG-VALSET
+ * mechanism.  Note that, since value is an int64_t, unsigned eight
+ * byte values larger than INT64_MAX can only be set with
+ * uGnssCfgValSet().
+ *
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param keyId        the ID of the key to set.
+ * @param value        the value to set.
+ * @param transaction  the transaction, see uGnssCfgValSet().
+ * @param layers       the layers to set the value in, see uGnssCfgValSet().
+ * @return             zero on success, #U_ERROR_COMMON_NOT_FOUND if
+ *                     keyId is not in the key information table,
+ *                     #U_ERROR_COMMON_INVALID_PARAMETER if keyId is
+ *                     that of a floating point value or value does not
+ *                     fit the type and size of keyId, else negative
+ *                     error code.
+ */
+int32_t uGnssCfgValSetInt(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                          int64_t value, uGnssCfgValTransaction_t transaction,
+                          uint32_t layers);
+
+/** Get the value of a floating point configuration item, checking the
+ * key ID against the key information table; only applicable to M9
+ * modules and beyond, uses the UBX-CFG-VALGET mechanism.
+ *
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param keyId        the ID of the key to get; wild-cards are not
+ *                     permitted.
+ * @param[out] pValue  a pointer to a place to put the value; cannot
+ *                     be NULL.
+ * @param layer        the layer to get the value from: use
+ *                     #U_GNSS_CFG_VAL_LAYER_RAM to get the currently
+ *                     applied value.
+ * @return             zero on success, #U_ERROR_COMMON_NOT_FOUND if
+ *                     keyId is not in the key information table,
+ *                     #U_ERROR_COMMON_INVALID_PARAMETER if keyId is
+ *                     not that of a floating point value, else negative
+ *                     error code.
+ */
+int32_t uGnssCfgValGetFloat(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                            double *pValue, uGnssCfgValLayer_t layer);
+
+/** Set the value of a floating point configuration item, checking the
+ * key ID against the key information table; only applicable to M9
+ * modules and beyond, uses the UBX-CFG-VALSET mechanism.  If keyId is
+ * that of a four byte value, value is converted to a float.
+ *
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param keyId        the ID of the key to set.
+ * @param value        the value to set.
+ * @param transaction  the transaction, see uGnssCfgValSet().
+ * @param layers       the layers to set the value in, see uGnssCfgValSet().
+ * @return             zero on success, #U_ERROR_COMMON_NOT_FOUND if
+ *                     keyId is not in the key information table,
+ *                     #U_ERROR_COMMON_INVALID_PARAMETER if keyId is
+ *                     not that of a floating point value, else negative
+ *                     error code.
+ */
+int32_t uGnssCfgValSetFloat(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                            double value, uGnssCfgValTransaction_t transaction,
+                            uint32_t layers);
+
 #ifdef __cplusplus
 }
 #endif
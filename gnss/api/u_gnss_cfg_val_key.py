@@ -1,6 +1,6 @@
 #!/usr/bin/env python
 
-'''Update the file u_gnss_cfg_val_key.h with key ID macros.'''
+'''Update the file u_gnss_cfg_val_key.h with key ID macros and write the key information table.'''
 
 from multiprocessing import Process, freeze_support # Needed to make Windows behave
                                                     # when run under multiprocessing,
@@ -53,10 +53,24 @@ import platform # Figure out current OS
 #    ...erases anything between them and and writes all of the
 #    generated macros there instead.  A backup is made of the
 #    current file, just in case.
+#
+# 6. It writes the whole of the file u_gnss_cfg_val_key_table.c,
+#    by default in the src directory next to this one, containing
+#    the table gUGnssCfgValKeyInfo[]: for each key ID, sorted in
+#    ascending order of key ID (so that it can be binary-searched),
+#    the key ID, the type letter from the end of the item name, as
+#    a uGnssCfgValKeyType_t, and the name as it appears in the u-blox
+#    reference manual without the "CFG-" prefix, for instance
+#
+#    {0x10230001, U_GNSS_CFG_VAL_KEY_TYPE_L, "ANA-USE_ANA"},
 
 # The file to be read/modified
 TARGET_FILE_NAME = "u_gnss_cfg_val_key.h"
 
+# The key information table file to be written, relative to
+# the directory of the target file
+TABLE_FILE_NAME = os.path.join("..", "src", "u_gnss_cfg_val_key_table.c")
+
 # The file extension to be used for the back-up of the file
 BACKUP_EXTENSION = "_bak"
 
@@ -84,6 +98,10 @@ ENUM_NAME_POSTFIX = "_t"
 # The prefix to expect on every item
 ENUM_ENTRY_PREFIX_ITEMS = ENUM_ENTRY_PREFIX_ALL + "ITEM_"
 
+# The prefix of each entry in the key type enum, which must
+# be followed by the type letter from the end of the item name
+ENUM_ENTRY_PREFIX_KEY_TYPE = ENUM_ENTRY_PREFIX_ALL + "TYPE_"
+
 # The marker to look for, beyond which we can re-write the target
 # file up to FILE_REWRITE_MARKER_END
 FILE_REWRITE_MARKER_START = "// *** DO NOT MODIFY THIS LINE OR BELOW: AUTO-GENERATED BY u_gnss_cfg_val_key.py ***"
@@ -288,6 +306,102 @@ def rewrite_line_list(key_id_list, input_line_list):
 
     return output_line_list
 
+def write_table_file(key_id_list, table_file):
+    '''Write the key information table file, sorted by key ID'''
+    success = False
+    line_list = []
+    last_key_id = -1
+
+    line_list.append("/*\n"
+                     " * Copyright 2019-2023 u-blox\n"
+                     " *\n"
+                     " * Licensed under the Apache License, Version 2.0 (the \"License\");\n"
+                     " * you may not use this file except in compliance with the License.\n"
+                     " * You may obtain a copy of the License at\n"
+                     " *\n"
+                     " * http://www.apache.org/licenses/LICENSE-2.0\n"
+                     " *\n"
+                     " * Unless required by applicable law or agreed to in writing, software\n"
+                     " * distributed under the License is distributed on an \"AS IS\" BASIS,\n"
+                     " * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.\n"
+                     " * See the License for the specific language governing permissions and\n"
+                     " * limitations under the License.\n"
+                     " */\n"
+                     "\n"
+                     "/* NOTE TO MAINTAINERS: this file is written in its entirety by the\n"
+                     " * u_gnss_cfg_val_key.py Python script from the enumerations in\n"
+                     " * u_gnss_cfg_val_key.h: do NOT edit it, edit the enumerations and\n"
+                     " * run the script instead.\n"
+                     " */\n"
+                     "\n"
+                     "/* Only #includes of u_* and the C standard library are allowed here,\n"
+                     " * no platform stuff and no OS stuff.  Anything required from\n"
+                     " * the platform/OS must be brought in through u_port* to maintain\n"
+                     " * portability.\n"
+                     " */\n"
+                     "\n"
+                     "/** @file\n"
+                     " * @brief The table of key information for the VALSET/VALGET/VALDEL\n"
+                     " * API, sorted by key ID; this is only linked into an application\n"
+                     " * that calls one of the functions in u_gnss_cfg.h which use it,\n"
+                     " * e.g. pUGnssCfgValKeyInfo().\n"
+                     " */\n"
+                     "\n"
+                     "#ifdef U_CFG_OVERRIDE\n"
+                     "# include \"u_cfg_override.h\" // For a customer's configuration override\n"
+                     "#endif\n"
+                     "\n"
+                     "#include \"stddef.h\"    // NULL, size_t etc.\n"
+                     "#include \"stdint.h\"    // int32_t etc.\n"
+                     "#include \"stdbool.h\"\n"
+                     "\n"
+                     "#include \"u_port_os.h\"\n"
+                     "\n"
+                     "#include \"u_at_client.h\"\n"
+                     "\n"
+                     "#include \"u_gnss_module_type.h\"\n"
+                     "#include \"u_gnss_type.h\"\n"
+                     "#include \"u_gnss_private.h\"\n"
+                     "#include \"u_gnss_cfg_val_key.h\"\n"
+                     "#include \"u_gnss_cfg.h\"\n"
+                     "#include \"u_gnss_cfg_private.h\"\n"
+                     "\n"
+                     "/* ----------------------------------------------------------------\n"
+                     " * VARIABLES\n"
+                     " * -------------------------------------------------------------- */\n"
+                     "\n"
+                     "/** The key information table, sorted by key ID.\n"
+                     " */\n"
+                     "const uGnssCfgValKeyInfo_t gUGnssCfgValKeyInfo[] = {\n")
+    for key_id_tuple in sorted(key_id_list, key=lambda key_id_tuple: key_id_tuple[1]):
+        if key_id_tuple[1] == last_key_id:
+            print("Key ID 0x{:08x} ({}) appears twice, stopping.". \
+                  format(key_id_tuple[1], key_id_tuple[0]))
+            line_list = []
+            break
+        last_key_id = key_id_tuple[1]
+        # The item name ends with the type and size, e.g. "_U1"
+        bits = key_id_tuple[3].split("_")
+        line_list.append("    {{0x{:08x}, {}{}, \"{}-{}\"}},\n".            \
+                         format(key_id_tuple[1], ENUM_ENTRY_PREFIX_KEY_TYPE, \
+                                bits[len(bits) - 1][0], key_id_tuple[2],    \
+                                "_".join(bits[:len(bits) - 1])))
+    if line_list:
+        line_list.append("};\n"
+                         "\n"
+                         "/** The number of entries in gUGnssCfgValKeyInfo[].\n"
+                         " */\n"
+                         "const size_t gUGnssCfgValKeyInfoNum = sizeof(gUGnssCfgValKeyInfo) /\n"
+                         "                                      sizeof(gUGnssCfgValKeyInfo[0]);\n"
+                         "\n"
+                         "// End of file\n")
+        with open(table_file, "w", encoding="utf8") as file:
+            file.writelines(line_list)
+            print("{} has been written.".format(table_file))
+            success = True
+
+    return success
+
 def copy_file(source, destination):
     '''Copy a file from source to destination using OS commands'''
     success = False
@@ -309,7 +423,7 @@ def copy_file(source, destination):
               f"{error.cmd} {error.returncode}: \"{ error.output}\"")
     return success
 
-def main(target_file):
+def main(target_file, table_file):
     '''Main as a function'''
     return_value = 1
     keep_going = True
@@ -359,7 +473,8 @@ def main(target_file):
                                 key_id = create_key_id(item_tuple, group_id_tuple[1], key_size_list)
                                 if key_id >= 0:
                                     key_id_list.append((enum_entry_prefix_items.replace("ITEM", "ID") + \
-                                                       item_tuple[0], key_id))
+                                                       item_tuple[0], key_id,                         \
+                                                       group_id_tuple[0], item_tuple[0]))
                                 else: 
                                     print("Could not find key size for item \"{}\";"      \
                                           " does it have an _X on the end, where X"       \
@@ -399,6 +514,8 @@ def main(target_file):
                     with open(target_file, "w", encoding="utf8") as file:
                         file.writelines(line_list)
                         print("{} has been re-written.".format(target_file))
+                    #... then write the table file
+                    if write_table_file(key_id_list, table_file):
                         return_value = 0
     else:
         print(f"\"{target_file}\" is not a file.")
@@ -411,10 +528,15 @@ if __name__ == "__main__":
                                      " in " + TARGET_FILE_NAME + ".\n")
     PARSER.add_argument("-f", default=TARGET_FILE_NAME, help="the" \
                         " file name to update, default " + TARGET_FILE_NAME)
+    PARSER.add_argument("-t", help="the key information table file" \
+                        " to write, default " + TABLE_FILE_NAME +     \
+                        " relative to the directory of the file to update")
     ARGS = PARSER.parse_args()
+    if not ARGS.t:
+        ARGS.t = os.path.join(os.path.dirname(ARGS.f), TABLE_FILE_NAME)
 
     # Call main()
-    RETURN_VALUE = main(ARGS.f)
+    RETURN_VALUE = main(ARGS.f, ARGS.t)
 
     sys.exit(RETURN_VALUE)
 
@@ -24,6 +24,14 @@
 
 #include "u_gnss_dec_ubx_nav_pvt.h"
 #include "u_gnss_dec_ubx_nav_hpposllh.h"
+#include "u_gnss_dec_ubx_nav_sat.h"
+#include "u_gnss_dec_ubx_nav_sig.h"
+#include "u_gnss_dec_ubx_nav_cov.h"
+#include "u_gnss_dec_ubx_nav_timegps.h"
+#include "u_gnss_dec_ubx_esf_ins.h"
+#include "u_gnss_dec_ubx_rxm_rawx.h"
+#include "u_gnss_dec_ubx_mon_rf.h"
+#include "u_gnss_dec_ubx_tim_tp.h"
 
 /** \addtogroup _GNSS
  *  @{
@@ -37,6 +45,11 @@
  * to obtain high precision position from a HPG GNSS device
  * by requesting it to emit the UBX-NAV-HPPOSLLH message.
  *
+ * pUGnssDecAlloc() allocates memory for each decoded message; if
+ * you are decoding messages at a high rate and would rather avoid
+ * that, use uGnssDecDecode(), which decodes into storage that you
+ * provide.
+ *
  * The functions are thread-safe with the exception of
  * uGnssDecSetCallback().
  */
@@ -58,10 +71,18 @@ extern "C" {
 typedef union {
     uGnssDecUbxNavPvt_t           ubxNavPvt;      /**< UBX-NAV-PVT. */
     uGnssDecUbxNavHpposllh_t      ubxNavHpposllh; /**< UBX-NAV-HPPOSLLH. */
+    uGnssDecUbxNavSat_t           ubxNavSat;      /**< UBX-NAV-SAT. */
+    uGnssDecUbxNavSig_t           ubxNavSig;      /**< UBX-NAV-SIG. */
+    uGnssDecUbxNavCov_t           ubxNavCov;      /**< UBX-NAV-COV. */
+    uGnssDecUbxNavTimegps_t       ubxNavTimegps;  /**< UBX-NAV-TIMEGPS. */
+    uGnssDecUbxEsfIns_t           ubxEsfIns;      /**< UBX-ESF-INS. */
+    uGnssDecUbxRxmRawx_t          ubxRxmRawx;     /**< UBX-RXM-RAWX. */
+    uGnssDecUbxMonRf_t            ubxMonRf;       /**< UBX-MON-RF. */
+    uGnssDecUbxTimTp_t            ubxTimTp;       /**< UBX-TIM-TP. */
 } uGnssDecUnion_t;
 
 /** The result of attempting to decode a message, returned by
- * pUGnssDecAlloc().
+ * pUGnssDecAlloc() or populated by uGnssDecDecode().
  */
 typedef struct {
     int32_t errorCode;   /**< the outcome of message decoding:
@@ -155,12 +176,16 @@ typedef int32_t (uGnssDecFunction_t) (uGnssMessageId_t *pId,
  * and must include all headers; no checking of checksums etc. on the
  * end of a known message is performed, hence they may be omitted.
  *
- * Currently only a very limited set of messages (actually just
- * UBX-NAV-PVT and UBX-NAV-HPPOSLLH, the latter useful if you wish
- * to use a high precision GNSS (HPG) device to its full extent) are
- * supported; see the top of the file u_gnss_dec.c for instructions
- * on how to add more decoders, or use uGnssDecSetCallback() to
- * hook-in your own decoders at run-time.
+ * Currently only a limited set of messages are supported, see
+ * uGnssDecGetIdList() or #uGnssDecUnion_t; UBX-NAV-HPPOSLLH is
+ * useful if you wish to use a high precision GNSS (HPG) device
+ * to its full extent.  See the top of the file u_gnss_dec.c for
+ * instructions on how to add more decoders, or use
+ * uGnssDecSetCallback() to hook-in your own decoders at run-time.
+ *
+ * Only as much memory as the specific message type requires is
+ * allocated for the message body, not the size of the whole
+ * #uGnssDecUnion_t.
  *
  * If only a partial decode is possible then the errorCode field of
  * the returned structure will be negative but the protocol type
@@ -181,6 +206,34 @@ typedef int32_t (uGnssDecFunction_t) (uGnssMessageId_t *pId,
  */
 uGnssDec_t *pUGnssDecAlloc(const char *pBuffer, size_t size);
 
+/** As pUGnssDecAlloc() but no memory is allocated: the message is
+ * decoded into storage provided by the caller, which may be re-used
+ * for every message decoded, e.g. once per navigation epoch.  Only
+ * the built-in decoders are used, any callback set with
+ * uGnssDecSetCallback() is NOT called.  On a successful decode the
+ * pBody field of pDec will be set to pBody, otherwise it will be
+ * NULL.
+ *
+ * Note that #uGnssDecUnion_t is sized for the largest message
+ * supported, which is the UBX-RXM-RAWX message, around 1 kbyte
+ * with the default #U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS; think
+ * before putting it on a small stack.
+ *
+ * @param[in] pBuffer     the buffer containing the message to be
+ *                        decoded; cannot be NULL.
+ * @param size            the amount of data at pBuffer.
+ * @param[out] pDec       a pointer to a place to put the outcome
+ *                        of decoding, including the message ID;
+ *                        cannot be NULL.
+ * @param[out] pBody      a pointer to a place to put the decoded
+ *                        message body; cannot be NULL.
+ * @return                zero on success, else negative error code,
+ *                        as would be written to the errorCode field
+ *                        of pDec.
+ */
+int32_t uGnssDecDecode(const char *pBuffer, size_t size,
+                       uGnssDec_t *pDec, uGnssDecUnion_t *pBody);
+
 /** Free the memory returned by pUGnssDecAlloc().
  *
  * @param[in] pDec the pointer returned by pUGnssDecAlloc(); may
@@ -188,7 +241,8 @@ uGnssDec_t *pUGnssDecAlloc(const char *pBuffer, size_t size);
  */
 void uGnssDecFree(uGnssDec_t *pDec);
 
-/** Get the list of message IDs that pUGnssDecAlloc() can decode;
+/** Get the list of message IDs that pUGnssDecAlloc() and
+ * uGnssDecDecode() can decode;
  * does not include any added by uGnssDecSetCallback().
  *
  * @param[out] ppIdList  a pointer to a place to put the pointer
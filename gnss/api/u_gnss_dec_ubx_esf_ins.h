@@ -0,0 +1,117 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_GNSS_DEC_UBX_ESF_INS_H_
+#define _U_GNSS_DEC_UBX_ESF_INS_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup _GNSS
+ *  @{
+ */
+
+/** @file
+ * @brief This header file defines the types of a UBX-ESF-INS
+ * message.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The message class of a UBX-ESF-INS message.
+ */
+#define U_GNSS_DEC_UBX_ESF_INS_MESSAGE_CLASS 0x10
+
+/** The message ID of a UBX-ESF-INS message.
+ */
+#define U_GNSS_DEC_UBX_ESF_INS_MESSAGE_ID 0x15
+
+/** The minimum length of the body of a UBX-ESF-INS message.
+ */
+#define U_GNSS_DEC_UBX_ESF_INS_BODY_MIN_LENGTH 36
+
+/** Bit mask for the #U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_VERSION field
+ * of #uGnssDecUbxEsfInsBitfield0_t.
+ */
+#define U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_VERSION_MASK (0xffUL << U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_VERSION)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Bit fields of the "bitfield0" field of #uGnssDecUbxEsfIns_t; use
+ * these to mask specific bits, e.g.
+ *
+ * `if (bitfield0 & (1UL << U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_Z_ANG_RATE_VALID)) {`
+ *
+ * ...would determine if the "zAngRate" field is valid.  Note
+ * that the field #U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_VERSION is
+ * wider than a single bit.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_VERSION = 0, /**< not a single bit, the
+                                                       start of an 8-bit field,
+                                                       use #U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_VERSION_MASK
+                                                       to mask it and this to
+                                                       shift it down to obtain
+                                                       the message version. */
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_X_ANG_RATE_VALID = 8,  /**< xAngRate is valid. */
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_Y_ANG_RATE_VALID = 9,  /**< yAngRate is valid. */
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_Z_ANG_RATE_VALID = 10, /**< zAngRate is valid. */
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_X_ACCEL_VALID = 11,    /**< xAccel is valid. */
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_Y_ACCEL_VALID = 12,    /**< yAccel is valid. */
+    U_GNSS_DEC_UBX_ESF_INS_BITFIELD0_Z_ACCEL_VALID = 13     /**< zAccel is valid. */
+} uGnssDecUbxEsfInsBitfield0_t;
+
+/** UBX-ESF-INS message structure; the naming and type of each
+ * element follows that of the interface manual.  The values are
+ * compensated for sensor biases and gravity, in the vehicle frame.
+ */
+typedef struct {
+    uint32_t bitfield0; /**< see #uGnssDecUbxEsfInsBitfield0_t. */
+    uint32_t iTOW;      /**< GPS time of week of the navigation epoch
+                             in milliseconds. */
+    int32_t xAngRate;   /**< x-axis angular rate in degrees/second
+                             times 1e3. */
+    int32_t yAngRate;   /**< y-axis angular rate in degrees/second
+                             times 1e3. */
+    int32_t zAngRate;   /**< z-axis angular rate in degrees/second
+                             times 1e3. */
+    int32_t xAccel;     /**< x-axis acceleration in metres/second^2
+                             times 1e2. */
+    int32_t yAccel;     /**< y-axis acceleration in metres/second^2
+                             times 1e2. */
+    int32_t zAccel;     /**< z-axis acceleration in metres/second^2
+                             times 1e2. */
+} uGnssDecUbxEsfIns_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_GNSS_DEC_UBX_ESF_INS_H_
+
+// End of file
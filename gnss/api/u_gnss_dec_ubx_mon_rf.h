@@ -0,0 +1,160 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_GNSS_DEC_UBX_MON_RF_H_
+#define _U_GNSS_DEC_UBX_MON_RF_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup _GNSS
+ *  @{
+ */
+
+/** @file
+ * @brief This header file defines the types of a UBX-MON-RF
+ * message.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The message class of a UBX-MON-RF message.
+ */
+#define U_GNSS_DEC_UBX_MON_RF_MESSAGE_CLASS 0x0a
+
+/** The message ID of a UBX-MON-RF message.
+ */
+#define U_GNSS_DEC_UBX_MON_RF_MESSAGE_ID 0x38
+
+/** The minimum length of the body of a UBX-MON-RF message.
+ */
+#define U_GNSS_DEC_UBX_MON_RF_BODY_MIN_LENGTH 4
+
+/** The length of each repeated RF block in the body of a
+ * UBX-MON-RF message.
+ */
+#define U_GNSS_DEC_UBX_MON_RF_BODY_BLOCK_LENGTH 24
+
+#ifndef U_GNSS_DEC_UBX_MON_RF_MAX_NUM_BLOCKS
+/** The maximum number of RF blocks that are decoded from a
+ * UBX-MON-RF message; any beyond this are ignored.
+ */
+# define U_GNSS_DEC_UBX_MON_RF_MAX_NUM_BLOCKS 2
+#endif
+
+/** Bit mask for the #U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE field
+ * of #uGnssDecUbxMonRfFlags_t.
+ */
+#define U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_MASK (0x03 << U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Possible values of the #U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE
+ * bit-field of #uGnssDecUbxMonRfFlags_t.  To obtain the
+ * enum, do as follows:
+ *
+ * `(flags & (U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_MASK)) >> U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE`
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_UNKNOWN = 0,
+    U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_OK = 1,
+    U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_WARNING = 2,
+    U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_CRITICAL = 3
+} uGnssDecUbxMonRfFlagsJammingState_t;
+
+/** Bit fields of the "flags" field of #uGnssDecUbxMonRfBlock_t.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE = 0 /**< not a single bit, the
+                                                       start of a 2-bit field,
+                                                       use #U_GNSS_DEC_UBX_MON_RF_FLAGS_JAMMING_STATE_MASK
+                                                       to mask it, this to shift
+                                                       it down and then it will
+                                                       map to
+                                                       #uGnssDecUbxMonRfFlagsJammingState_t. */
+} uGnssDecUbxMonRfFlags_t;
+
+/** Possible values of the "antStatus" field of
+ * #uGnssDecUbxMonRfBlock_t.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_MON_RF_ANT_STATUS_INIT = 0,
+    U_GNSS_DEC_UBX_MON_RF_ANT_STATUS_DONT_KNOW = 1,
+    U_GNSS_DEC_UBX_MON_RF_ANT_STATUS_OK = 2,
+    U_GNSS_DEC_UBX_MON_RF_ANT_STATUS_SHORT = 3,
+    U_GNSS_DEC_UBX_MON_RF_ANT_STATUS_OPEN = 4
+} uGnssDecUbxMonRfAntStatus_t;
+
+/** Possible values of the "antPower" field of
+ * #uGnssDecUbxMonRfBlock_t.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_MON_RF_ANT_POWER_OFF = 0,
+    U_GNSS_DEC_UBX_MON_RF_ANT_POWER_ON = 1,
+    U_GNSS_DEC_UBX_MON_RF_ANT_POWER_DONT_KNOW = 2
+} uGnssDecUbxMonRfAntPower_t;
+
+/** One RF block of a UBX-MON-RF message; the naming and type of
+ * each element follows that of the interface manual.
+ */
+typedef struct {
+    uint8_t blockId;     /**< RF block ID, 0 for L1 and 1 for L2 or L5. */
+    uint8_t flags;       /**< see #uGnssDecUbxMonRfFlags_t. */
+    uint8_t antStatus;   /**< see #uGnssDecUbxMonRfAntStatus_t. */
+    uint8_t antPower;    /**< see #uGnssDecUbxMonRfAntPower_t. */
+    uint32_t postStatus; /**< POST status word. */
+    uint16_t noisePerMS; /**< noise level as measured by the GNSS core. */
+    uint16_t agcCnt;     /**< AGC monitor, range 0 to 8191. */
+    uint8_t jamInd;      /**< CW jamming indicator, range 0 (no CW
+                              jamming) to 255 (strong CW jamming). */
+    int8_t ofsI;         /**< imbalance of I-part of complex signal. */
+    uint8_t magI;        /**< magnitude of I-part of complex signal. */
+    int8_t ofsQ;         /**< imbalance of Q-part of complex signal. */
+    uint8_t magQ;        /**< magnitude of Q-part of complex signal. */
+} uGnssDecUbxMonRfBlock_t;
+
+/** UBX-MON-RF message structure; the naming and type of each
+ * element follows that of the interface manual.
+ */
+typedef struct {
+    uint8_t version; /**< message version. */
+    uint8_t nBlocks; /**< the number of RF blocks in the message;
+                          if this is more than
+                          #U_GNSS_DEC_UBX_MON_RF_MAX_NUM_BLOCKS then
+                          only the first #U_GNSS_DEC_UBX_MON_RF_MAX_NUM_BLOCKS
+                          will be present in block. */
+    uGnssDecUbxMonRfBlock_t block[U_GNSS_DEC_UBX_MON_RF_MAX_NUM_BLOCKS]; /**< the RF blocks. */
+} uGnssDecUbxMonRf_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_GNSS_DEC_UBX_MON_RF_H_
+
+// End of file
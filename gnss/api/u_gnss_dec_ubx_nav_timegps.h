@@ -0,0 +1,95 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_GNSS_DEC_UBX_NAV_TIMEGPS_H_
+#define _U_GNSS_DEC_UBX_NAV_TIMEGPS_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup _GNSS
+ *  @{
+ */
+
+/** @file
+ * @brief This header file defines the types of a UBX-NAV-TIMEGPS
+ * message.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The message class of a UBX-NAV-TIMEGPS message.
+ */
+#define U_GNSS_DEC_UBX_NAV_TIMEGPS_MESSAGE_CLASS 0x01
+
+/** The message ID of a UBX-NAV-TIMEGPS message.
+ */
+#define U_GNSS_DEC_UBX_NAV_TIMEGPS_MESSAGE_ID 0x20
+
+/** The minimum length of the body of a UBX-NAV-TIMEGPS message.
+ */
+#define U_GNSS_DEC_UBX_NAV_TIMEGPS_BODY_MIN_LENGTH 16
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Bit fields of the "valid" field of #uGnssDecUbxNavTimegps_t; use
+ * these to mask specific bits, e.g.
+ *
+ * `if (valid & (1 << U_GNSS_DEC_UBX_NAV_TIMEGPS_VALID_WEEK)) {`
+ *
+ * ...would determine if the "week" field is valid.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_NAV_TIMEGPS_VALID_TOW = 0,   /**< iTOW and fTOW are valid. */
+    U_GNSS_DEC_UBX_NAV_TIMEGPS_VALID_WEEK = 1,  /**< week is valid. */
+    U_GNSS_DEC_UBX_NAV_TIMEGPS_VALID_LEAP_S = 2 /**< leapS is valid. */
+} uGnssDecUbxNavTimegpsValid_t;
+
+/** UBX-NAV-TIMEGPS message structure; the naming and type of each
+ * element follows that of the interface manual.
+ */
+typedef struct {
+    uint32_t iTOW; /**< GPS time of week of the navigation epoch
+                        in milliseconds. */
+    int32_t fTOW;  /**< fractional part of iTOW in nanoseconds,
+                        range +/-500000; the precise GPS time of
+                        week in seconds is (iTOW * 1e-3) + (fTOW * 1e-9). */
+    int16_t week;  /**< GPS week number of the navigation epoch. */
+    int8_t leapS;  /**< GPS leap seconds (GPS-UTC). */
+    uint8_t valid; /**< validity flags, see
+                        #uGnssDecUbxNavTimegpsValid_t. */
+    uint32_t tAcc; /**< time accuracy estimate in nanoseconds. */
+} uGnssDecUbxNavTimegps_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_GNSS_DEC_UBX_NAV_TIMEGPS_H_
+
+// End of file
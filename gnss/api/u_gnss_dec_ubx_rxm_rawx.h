@@ -0,0 +1,154 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_GNSS_DEC_UBX_RXM_RAWX_H_
+#define _U_GNSS_DEC_UBX_RXM_RAWX_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup _GNSS
+ *  @{
+ */
+
+/** @file
+ * @brief This header file defines the types of a UBX-RXM-RAWX
+ * message.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The message class of a UBX-RXM-RAWX message.
+ */
+#define U_GNSS_DEC_UBX_RXM_RAWX_MESSAGE_CLASS 0x02
+
+/** The message ID of a UBX-RXM-RAWX message.
+ */
+#define U_GNSS_DEC_UBX_RXM_RAWX_MESSAGE_ID 0x15
+
+/** The minimum length of the body of a UBX-RXM-RAWX message.
+ */
+#define U_GNSS_DEC_UBX_RXM_RAWX_BODY_MIN_LENGTH 16
+
+/** The length of each repeated measurement block in the body of a
+ * UBX-RXM-RAWX message.
+ */
+#define U_GNSS_DEC_UBX_RXM_RAWX_BODY_BLOCK_LENGTH 32
+
+#ifndef U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS
+/** The maximum number of measurements that are decoded from a
+ * UBX-RXM-RAWX message; any beyond this are ignored.
+ */
+# define U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS 32
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Bit fields of the "recStat" field of #uGnssDecUbxRxmRawx_t; use
+ * these to mask specific bits, e.g.
+ *
+ * `if (recStat & (1 << U_GNSS_DEC_UBX_RXM_RAWX_REC_STAT_CLK_RESET)) {`
+ *
+ * ...would determine if a clock reset has been applied.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_RXM_RAWX_REC_STAT_LEAP_SEC = 0, /**< leap seconds have been
+                                                        determined. */
+    U_GNSS_DEC_UBX_RXM_RAWX_REC_STAT_CLK_RESET = 1 /**< a clock reset has been
+                                                        applied, typically a
+                                                        millisecond jump. */
+} uGnssDecUbxRxmRawxRecStat_t;
+
+/** Bit fields of the "trkStat" field of #uGnssDecUbxRxmRawxMeas_t;
+ * use these to mask specific bits, e.g.
+ *
+ * `if (trkStat & (1 << U_GNSS_DEC_UBX_RXM_RAWX_TRK_STAT_CP_VALID)) {`
+ *
+ * ...would determine if the "cpMes" field is valid.
+ */
+typedef enum {
+    U_GNSS_DEC_UBX_RXM_RAWX_TRK_STAT_PR_VALID = 0,    /**< prMes is valid. */
+    U_GNSS_DEC_UBX_RXM_RAWX_TRK_STAT_CP_VALID = 1,    /**< cpMes is valid. */
+    U_GNSS_DEC_UBX_RXM_RAWX_TRK_STAT_HALF_CYC = 2,    /**< half cycle is valid. */
+    U_GNSS_DEC_UBX_RXM_RAWX_TRK_STAT_SUB_HALF_CYC = 3 /**< half cycle has been
+                                                           subtracted from the
+                                                           phase. */
+} uGnssDecUbxRxmRawxTrkStat_t;
+
+/** One measurement in a UBX-RXM-RAWX message; the naming and type
+ * of each element follows that of the interface manual.
+ */
+typedef struct {
+    double prMes;    /**< pseudorange measurement in metres. */
+    double cpMes;    /**< carrier phase measurement in cycles. */
+    float doMes;     /**< Doppler measurement in Hz, positive
+                          sign for approaching satellites. */
+    uint8_t gnssId;  /**< GNSS identifier. */
+    uint8_t svId;    /**< satellite identifier. */
+    uint8_t sigId;   /**< signal identifier. */
+    uint8_t freqId;  /**< GLONASS frequency slot + 7, range 0 to 13. */
+    uint16_t locktime; /**< carrier phase locktime counter in
+                            milliseconds, maximum 64500. */
+    uint8_t cno;     /**< carrier to noise ratio in dBHz. */
+    uint8_t prStdev; /**< estimated pseudorange measurement standard
+                          deviation, 0.01 * 2^n metres, only the
+                          bottom four bits are used. */
+    uint8_t cpStdev; /**< estimated carrier phase measurement standard
+                          deviation, 0.004 * n cycles, only the bottom
+                          four bits are used, 0x0F means invalid. */
+    uint8_t doStdev; /**< estimated Doppler measurement standard
+                          deviation, 0.002 * 2^n Hz, only the bottom
+                          four bits are used. */
+    uint8_t trkStat; /**< see #uGnssDecUbxRxmRawxTrkStat_t. */
+} uGnssDecUbxRxmRawxMeas_t;
+
+/** UBX-RXM-RAWX message structure; the naming and type of each
+ * element follows that of the interface manual.
+ */
+typedef struct {
+    double rcvTow;   /**< measurement time of week in receiver
+                          local time in seconds. */
+    uint16_t week;   /**< GPS week number in receiver local time. */
+    int8_t leapS;    /**< GPS leap seconds (GPS-UTC). */
+    uint8_t numMeas; /**< the number of measurements in the message;
+                          if this is more than
+                          #U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS then
+                          only the first #U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS
+                          will be present in meas. */
+    uint8_t recStat; /**< see #uGnssDecUbxRxmRawxRecStat_t. */
+    uint8_t version; /**< message version. */
+    uGnssDecUbxRxmRawxMeas_t meas[U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS]; /**< the measurements. */
+} uGnssDecUbxRxmRawx_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_GNSS_DEC_UBX_RXM_RAWX_H_
+
+// End of file
@@ -146,11 +146,20 @@ extern "C" {
 
 #ifndef U_GNSS_MGA_RX_BUFFER_SIZE_BYTES
 /** The size of the GNSS chip's internal receive buffer, used when
- * employing smart flow control.
+ * employing smart or window flow control.
  */
 # define U_GNSS_MGA_RX_BUFFER_SIZE_BYTES 1000
 #endif
 
+#ifndef U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES
+/** The maximum number of messages that may be awaiting an
+ * acknowledgement at any one time when employing
+ * #U_GNSS_MGA_FLOW_CONTROL_WINDOW; the number of bytes in flight
+ * is also limited to #U_GNSS_MGA_RX_BUFFER_SIZE_BYTES.
+ */
+# define U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES 8
+#endif
+
 /** The maximum length of the payload of a UBX-MGA-DBD message; for
  * the avoidance of doubt, this does NOT include the two length
  * indicator bytes that precede it, i.e. the maximum length passed
@@ -213,6 +222,12 @@ typedef enum {
                                               chip's RX buffer with #U_GNSS_MGA_INTER_MESSAGE_DELAY_MS,
                                               then wait for ACKs; a compromise in terms of
                                               speed/reliability. */
+    U_GNSS_MGA_FLOW_CONTROL_WINDOW = 3,  /**< keep up to #U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES
+                                              messages, totalling no more than
+                                              #U_GNSS_MGA_RX_BUFFER_SIZE_BYTES, awaiting an ACK,
+                                              sending the next message as each ACK arrives;
+                                              as reliable as #U_GNSS_MGA_FLOW_CONTROL_SIMPLE
+                                              but without a round trip per message. */
     U_GNSS_MGA_FLOW_CONTROL_MAX_NUM
 } uGnssMgaFlowControl_t;
 
@@ -392,6 +407,83 @@ typedef bool (uGnssMgaDatabaseCallback_t) (uDeviceHandle_t devHandle,
                                            const char *pBuffer, size_t size,
                                            void *pCallbackParam);
 
+/** Callback that will be called by uGnssMgaGetDatabaseDelta() for
+ * each block of the navigation database that has changed.  The same
+ * rules as for #uGnssMgaDatabaseCallback_t apply: do NOT call into
+ * the GNSS API and return quickly.
+ *
+ * @param devHandle               the device handle.
+ * @param index                   the index of the block in the
+ *                                database, counting from zero.
+ * @param pBuffer                 the block, including its two length
+ *                                bytes, which should be stored in the
+ *                                slot for index, replacing any existing
+ *                                contents; NULL when the database has
+ *                                been read entirely, in which case index
+ *                                is the number of blocks in the database
+ *                                and any slots from index onwards may
+ *                                be discarded.
+ * @param size                    the number of bytes at pBuffer.
+ * @param[in,out] pCallbackParam  the pCallbackParam pointer that
+ *                                was passed to uGnssMgaGetDatabaseDelta().
+ * @return                        true to continue with the transfer,
+ *                                false to terminate it.
+ */
+typedef bool (uGnssMgaDatabaseDeltaCallback_t) (uDeviceHandle_t devHandle,
+                                                size_t index,
+                                                const char *pBuffer, size_t size,
+                                                void *pCallbackParam);
+
+/** Callback that will be called by uGnssMgaSetDatabaseStream() to get
+ * each block of the navigation database to be written to the GNSS device,
+ * e.g. from wherever the blocks passed to #uGnssMgaDatabaseDeltaCallback_t
+ * were stored.  Do NOT call into the GNSS API from this callback.
+ *
+ * @param devHandle               the device handle.
+ * @param index                   the index of the block that is wanted,
+ *                                counting from zero.
+ * @param[out] pBuffer            a place to write the block, including
+ *                                its two length bytes.
+ * @param size                    the amount of storage at pBuffer, which
+ *                                will be at least
+ *                                #U_GNSS_MGA_DBD_MESSAGE_PAYLOAD_LENGTH_MAX_BYTES
+ *                                plus two.
+ * @param[in,out] pCallbackParam  the pReadCallbackParam pointer that
+ *                                was passed to uGnssMgaSetDatabaseStream().
+ * @return                        the number of bytes written to pBuffer,
+ *                                zero if there are no more blocks, else
+ *                                negative error code, which will end the
+ *                                transfer.
+ */
+typedef int32_t (uGnssMgaDatabaseReadCallback_t) (uDeviceHandle_t devHandle,
+                                                  size_t index,
+                                                  char *pBuffer, size_t size,
+                                                  void *pCallbackParam);
+
+/** Callback that will be called by uGnssMgaResponseSendOfflineRead()
+ * to read pieces of the AssistNow Offline data, wherever it happens to
+ * be stored, e.g. in a file.  Do NOT call into the GNSS API from this
+ * callback.
+ *
+ * @param devHandle               the device handle.
+ * @param offset                  the offset from the start of the
+ *                                AssistNow Offline data to read from.
+ * @param[out] pBuffer            a place to write the data.
+ * @param size                    the number of bytes to read, which
+ *                                will not go beyond the end of the
+ *                                AssistNow Offline data.
+ * @param[in,out] pCallbackParam  the pReadCallbackParam pointer that
+ *                                was passed to
+ *                                uGnssMgaResponseSendOfflineRead().
+ * @return                        the number of bytes written to pBuffer
+ *                                (anything other than size will end
+ *                                the transfer) else negative error code.
+ */
+typedef int32_t (uGnssMgaOfflineReadCallback_t) (uDeviceHandle_t devHandle,
+                                                 size_t offset,
+                                                 char *pBuffer, size_t size,
+                                                 void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -630,6 +722,55 @@ int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
                              uGnssMgaProgressCallback_t *pCallback,
                              void *pCallbackParam);
 
+/** As uGnssMgaResponseSend() but for AssistNow Offline data that is
+ * not in RAM, e.g. an AssistNow Offline response covering several
+ * weeks that has been stored in a file, and with offlineOperation
+ * limited to #U_GNSS_MGA_SEND_OFFLINE_TODAYS or
+ * #U_GNSS_MGA_SEND_OFFLINE_ALMANAC.  The data is walked in place, in
+ * pieces, through pReadCallback, first reading only the header of
+ * each message to select those that are needed, and then those
+ * messages are read in full; the RAM required is only that for
+ * the messages that are sent to the GNSS device, hence this is
+ * suitable for an MCU with little RAM.  If your AssistNow Offline
+ * data is in memory-mapped flash you may as well call
+ * uGnssMgaResponseSend() with a pointer to it, no RAM is required
+ * for the whole data there either.
+ *
+ * The same notes as for uGnssMgaResponseSend() apply, e.g. this does
+ * not work for modules connected via an AT transport.
+ *
+ * @param gnssHandle                   the handle of the GNSS instance.
+ * @param timeUtcMilliseconds          the current UTC Unix time, NOT including
+ *                                     leap seconds, in milliseconds; must be
+ *                                     set.
+ * @param timeUtcAccuracyMilliseconds  the accuracy of timeUtcMilliseconds in
+ *                                     milliseconds.
+ * @param offlineOperation             #U_GNSS_MGA_SEND_OFFLINE_TODAYS or
+ *                                     #U_GNSS_MGA_SEND_OFFLINE_ALMANAC.
+ * @param flowControl                  the type of flow control to use.
+ * @param[in] pReadCallback            the function that reads the AssistNow
+ *                                     Offline data; cannot be NULL.
+ * @param[in,out] pReadCallbackParam   parameter that will be passed to
+ *                                     pReadCallback as its last parameter.
+ * @param size                         the total size of the AssistNow Offline
+ *                                     data in bytes; must be greater than zero.
+ * @param[in] pCallback                a progress callback, as for
+ *                                     uGnssMgaResponseSend(); may be NULL.
+ * @param[in,out] pCallbackParam       parameter that will be passed to
+ *                                     pCallback as its last parameter.
+ * @return                             zero on success else negative error code.
+ */
+int32_t uGnssMgaResponseSendOfflineRead(uDeviceHandle_t gnssHandle,
+                                        int64_t timeUtcMilliseconds,
+                                        int64_t timeUtcAccuracyMilliseconds,
+                                        uGnssMgaSendOfflineOperation_t offlineOperation,
+                                        uGnssMgaFlowControl_t flowControl,
+                                        uGnssMgaOfflineReadCallback_t *pReadCallback,
+                                        void *pReadCallbackParam,
+                                        size_t size,
+                                        uGnssMgaProgressCallback_t *pCallback,
+                                        void *pCallbackParam);
+
 /** Erase the flash memory attached to a GNSS chip in which the
  * assistance data is stored; normally there should be no reason
  * to use this since any new assistance data written to the GNSS
@@ -788,6 +929,69 @@ int32_t uGnssMgaSetDatabase(uDeviceHandle_t gnssHandle,
                             uGnssMgaProgressCallback_t *pCallback,
                             void *pCallbackParam);
 
+/** As uGnssMgaGetDatabase() but only the blocks of the database that
+ * have changed since the last call are passed to pCallback, allowing
+ * an application that keeps the database in non-volatile storage as
+ * a set of per-block slots to write only what has changed, reducing
+ * both time and flash wear.  A 32-bit hash of each block is kept in
+ * pHashList, which the application would normally keep alongside the
+ * stored blocks; block n is considered to have changed if its hash
+ * differs from entry n of pHashList, which is then updated.  Any blocks
+ * beyond the end of pHashList are always considered to have changed.
+ * Initialise pHashList to zero to get all of the blocks.  If an error
+ * is returned all of the entries in pHashList are zeroed, so that the
+ * next call will return the whole database.
+ *
+ * The same notes as for uGnssMgaGetDatabase() apply.
+ *
+ * @param gnssHandle              the handle of the GNSS instance.
+ * @param[in,out] pHashList       a pointer to hashListLength hashes;
+ *                                may only be NULL if hashListLength
+ *                                is zero.
+ * @param hashListLength          the number of entries at pHashList.
+ * @param[in] pCallback           the callback which will receive
+ *                                the changed blocks; cannot be NULL.
+ * @param[in] pCallbackParam      a user parameter which will be passed
+ *                                to pCallback as its last parameter.
+ * @return                        the number of blocks passed to
+ *                                pCallback, else negative error code.
+ */
+int32_t uGnssMgaGetDatabaseDelta(uDeviceHandle_t gnssHandle,
+                                 uint32_t *pHashList, size_t hashListLength,
+                                 uGnssMgaDatabaseDeltaCallback_t *pCallback,
+                                 void *pCallbackParam);
+
+/** As uGnssMgaSetDatabase() but the blocks of the database are read,
+ * one at a time, from pReadCallback rather than from a contiguous
+ * buffer, and are written with #U_GNSS_MGA_FLOW_CONTROL_WINDOW flow
+ * control, so that reading the next block from storage overlaps with
+ * waiting for the GNSS device to acknowledge the previous ones.  This
+ * is the counterpart of uGnssMgaGetDatabaseDelta().
+ *
+ * The same notes as for uGnssMgaSetDatabase() apply.
+ *
+ * @param gnssHandle              the handle of the GNSS instance.
+ * @param[in] pReadCallback       the callback that provides the blocks;
+ *                                cannot be NULL.
+ * @param[in] pReadCallbackParam  a user parameter which will be passed
+ *                                to pReadCallback as its last parameter.
+ * @param[in] pCallback           a function which will be called as each
+ *                                block is acknowledged, blocksTotal being
+ *                                the number of blocks read from
+ *                                pReadCallback so far; if false is
+ *                                returned the transfer will be cancelled.
+ *                                May be NULL.  Do NOT call into the GNSS
+ *                                API from this callback.
+ * @param[in,out] pCallbackParam  parameter that will be passed to pCallback
+ *                                as its last parameter.
+ * @return                        zero on success else negative error code.
+ */
+int32_t uGnssMgaSetDatabaseStream(uDeviceHandle_t gnssHandle,
+                                  uGnssMgaDatabaseReadCallback_t *pReadCallback,
+                                  void *pReadCallbackParam,
+                                  uGnssMgaProgressCallback_t *pCallback,
+                                  void *pCallbackParam);
+
 #ifdef __cplusplus
 }
 #endif
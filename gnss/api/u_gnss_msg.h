@@ -51,6 +51,19 @@ extern "C" {
 # define U_GNSS_MSG_RING_BUFFER_LENGTH_BYTES 2048
 #endif
 
+/* U_GNSS_MSG_RING_BUFFER_FILE_PATH: on the Linux and Windows
+ * platforms only, define this to a file path, e.g.
+ * "/var/tmp/gnss_ring", to have the ring buffer backed by a
+ * memory-mapped file (see u_port_file_map.h) rather than by heap;
+ * #U_GNSS_MSG_RING_BUFFER_LENGTH_BYTES may then be set large
+ * enough to hold hours of data without RAM pressure.  The file
+ * of each GNSS instance is the given path followed by "." and
+ * a number, e.g. "/var/tmp/gnss_ring.0"; it is created
+ * (replacing any existing file of that name) when the GNSS
+ * instance is added and left in place when it is removed.
+ * Not defined by default.
+ */
+
 #ifndef U_GNSS_MSG_TEMPORARY_BUFFER_LENGTH_BYTES
 /** A temporary buffer, used as a staging post to get stuff
  * from a streaming source (e.g. I2C or UART or SPI) into the
@@ -81,6 +94,50 @@ extern "C" {
 # define U_GNSS_MSG_RECEIVE_TASK_STACK_SIZE_BYTES (1024 * 3)
 #endif
 
+#ifndef U_GNSS_MSG_RECEIVE_QUEUE_SIZE_BYTES
+/** The default size of the queue that feeds each receiver started
+ * with uGnssMsgReceiveStartQueued(); must be big enough to hold the
+ * longest message that receiver is interested in plus a few bytes
+ * of overhead, ideally a few of them.
+ */
+# define U_GNSS_MSG_RECEIVE_QUEUE_SIZE_BYTES 1024
+#endif
+
+#ifndef U_GNSS_MSG_RECEIVE_QUEUED_TASK_STACK_SIZE_BYTES
+/** The number of bytes of stack to allocate to the task started
+ * for each receiver by uGnssMsgReceiveStartQueued(), the context
+ * in which the callback of that receiver is run.
+ */
+# define U_GNSS_MSG_RECEIVE_QUEUED_TASK_STACK_SIZE_BYTES U_GNSS_MSG_RECEIVE_TASK_STACK_SIZE_BYTES
+#endif
+
+#ifndef U_GNSS_MSG_INJECT_QUEUE_SIZE_BYTES
+/** The default size of the queue that holds the correction data
+ * passed to uGnssMsgInject() until it can be written to the GNSS
+ * chip; should be big enough for a few seconds' worth of
+ * corrections.
+ */
+# define U_GNSS_MSG_INJECT_QUEUE_SIZE_BYTES 4096
+#endif
+
+#ifndef U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES
+/** The size of the buffer in which the correction data passed to
+ * uGnssMsgInject() is framed into messages and from which those
+ * messages are written to the GNSS chip; this is the largest amount
+ * that is written in one go and it must be at least as big as the
+ * largest SPARTN message, 1104 bytes (the largest RTCM3 message
+ * is 1029 bytes).
+ */
+# define U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES 1280
+#endif
+
+#ifndef U_GNSS_MSG_INJECT_TASK_STACK_SIZE_BYTES
+/** The number of bytes of stack to allocate to the task started
+ * by uGnssMsgInjectStart().
+ */
+# define U_GNSS_MSG_INJECT_TASK_STACK_SIZE_BYTES (1024 * 2)
+#endif
+
 #ifndef U_GNSS_MSG_RECEIVE_TASK_QUEUE_LENGTH
 /** The length of the queue controlling the message receive
  * task: just need the one.
@@ -369,6 +426,60 @@ int32_t uGnssMsgReceiveStart(uDeviceHandle_t gnssHandle,
                              uGnssMsgReceiveCallback_t pCallback,
                              void *pCallbackParam);
 
+/** As uGnssMsgReceiveStart() but pCallback is run in a task of its
+ * own, fed by a queue of its own, so that a slow callback of another
+ * receiver cannot delay the delivery of messages to this one, and
+ * vice versa; use this for time-critical messages (e.g. UBX-NAV-PVT)
+ * when other receivers may take a while over what they are given.
+ *
+ * The message stream is still decoded just once: when a message
+ * matching pMessageId has been decoded a copy of it is added to the
+ * queue of this receiver, without waiting on any lock, and the task
+ * of this receiver then calls pCallback.  If the queue is full the
+ * message is dropped for this receiver only, see
+ * uGnssMsgReceiveStatQueueLoss().  Messages for queued receivers
+ * are queued before any uGnssMsgReceiveStart() callbacks are called,
+ * hence a uGnssMsgReceiveCallbackExtract() in one of those callbacks
+ * does not affect a queued receiver.
+ *
+ * The rules for pCallback are the same as for uGnssMsgReceiveStart():
+ * it may only call uGnssMsgReceiveCallbackRead() and
+ * uGnssMsgReceiveCallbackExtract() (which here both read from the
+ * queued copy of the message) and, potentially, pUGnssDecAlloc() /
+ * uGnssDecFree().  The receiver is stopped in the same way, with
+ * uGnssMsgReceiveStop() or uGnssMsgReceiveStopAll(), and counts
+ * towards #U_GNSS_MSG_RECEIVER_MAX_NUM.
+ *
+ * IMPORTANT: this does not work for modules connected via an AT
+ * transport, please instead open a Virtual Serial connection for
+ * that case (see uCellMuxAddChannel()).
+ *
+ * @param gnssHandle             the handle of the GNSS instance.
+ * @param[in] pMessageId         a pointer to the message ID to capture;
+ *                               a copy will be taken so this may be
+ *                               on the stack; cannot be NULL.
+ * @param[in] pCallback          the callback to be called when a
+ *                               matching message arrives, run in the
+ *                               context of a task with a stack of size
+ *                               #U_GNSS_MSG_RECEIVE_QUEUED_TASK_STACK_SIZE_BYTES;
+ *                               cannot be NULL.
+ * @param[in] pCallbackParam     will be passed to pCallback as its last
+ *                               parameter.
+ * @param queueSizeBytes         the size of the queue for this receiver,
+ *                               zero for the default of
+ *                               #U_GNSS_MSG_RECEIVE_QUEUE_SIZE_BYTES;
+ *                               this memory is allocated when this
+ *                               function is called and freed when the
+ *                               receiver is stopped.
+ * @return                       a handle for this asynchronous reader on
+ *                               success, else negative error code.
+ */
+int32_t uGnssMsgReceiveStartQueued(uDeviceHandle_t gnssHandle,
+                                   const uGnssMessageId_t *pMessageId,
+                                   uGnssMsgReceiveCallback_t pCallback,
+                                   void *pCallbackParam,
+                                   size_t queueSizeBytes);
+
 /** To be called from the pCallback of uGnssMsgReceiveStart() to take
  * a peek at the message data from the internal ring buffer, copying it
  * into your buffer but NOT REMOVING IT from the internal ring buffer,
@@ -391,6 +502,47 @@ int32_t uGnssMsgReceiveStart(uDeviceHandle_t gnssHandle,
 int32_t uGnssMsgReceiveCallbackRead(uDeviceHandle_t gnssHandle,
                                     char *pBuffer, size_t size);
 
+/** To be called from the pCallback of uGnssMsgReceiveStart() or
+ * uGnssMsgReceiveStartQueued() to get at the message data WITHOUT
+ * copying it: a pointer to the data where it sits, in the internal
+ * ring buffer or in the queue of the receiver, is returned.  The
+ * message may be split in two where the buffer wraps, so call this
+ * first with an offset of zero and then again with the offset
+ * increased by the length returned, until zero is returned, e.g.:
+ *
+ * ```
+ * const char *pSpan;
+ * size_t offset = 0;
+ * int32_t length;
+ * while ((length = uGnssMsgReceiveCallbackPeekSpan(gnssHandle, &pSpan, offset)) > 0) {
+ *     myForward(pSpan, length);
+ *     offset += length;
+ * }
+ * ```
+ *
+ * This is useful for long messages (e.g. UBX-RXM-RAWX) that are only
+ * to be forwarded somewhere.  Like uGnssMsgReceiveCallbackRead(),
+ * nothing is removed, so the message is still there for any other
+ * of your pCallbacks.
+ *
+ * IMPORTANT: this function can ONLY be called from the message receive
+ * pCallback, it is NOT thread-safe to call it from anywhere else; the
+ * span is ONLY valid until pCallback returns or calls
+ * uGnssMsgReceiveCallbackExtract(), whichever is the sooner.
+ *
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param[out] ppSpan  a place to put a pointer to the message data;
+ *                     cannot be NULL.
+ * @param offset       the offset into the message at which the span
+ *                     should start.
+ * @return             on success the number of bytes at *ppSpan,
+ *                     zero if there is no more of the message,
+ *                     else negative error code.
+ */
+int32_t uGnssMsgReceiveCallbackPeekSpan(uDeviceHandle_t gnssHandle,
+                                        const char **ppSpan,
+                                        size_t offset);
+
 /** To be called from the pCallback of uGnssMsgReceiveStart()
  * to REMOVE a message from the internal ring buffer into your buffer;
  * once this is called the message will not be available to any of your
@@ -412,6 +564,28 @@ int32_t uGnssMsgReceiveCallbackRead(uDeviceHandle_t gnssHandle,
 int32_t uGnssMsgReceiveCallbackExtract(uDeviceHandle_t gnssHandle,
                                        char *pBuffer, size_t size);
 
+/** To be called from the pCallback of uGnssMsgReceiveStart() or
+ * uGnssMsgReceiveStartQueued() to get the tick time, as returned by
+ * uPortGetTickTimeMs(), at which the first byte of the message being
+ * passed to pCallback arrived, i.e. was read from the transport into
+ * the internal ring buffer; compare this with uPortGetTickTimeMs()
+ * to find out how stale the message is.  The resolution is that of
+ * the reads from the transport: data which has waited in, for
+ * instance, a UART driver buffer is timed from when it was read.
+ *
+ * IMPORTANT: this function can ONLY be called from the message
+ * receive pCallback, it is NOT thread-safe to call it from anywhere else.
+ *
+ * @param gnssHandle    the handle of the GNSS instance.
+ * @param[out] pTimeMs  a place to put the arrival time; cannot be NULL.
+ * @return              zero on success, #U_ERROR_COMMON_NOT_FOUND if the
+ *                      message has been in the ring buffer for so long
+ *                      that its arrival time is no longer known, else
+ *                      negative error code.
+ */
+int32_t uGnssMsgReceiveCallbackGetArrivalTime(uDeviceHandle_t gnssHandle,
+                                              int32_t *pTimeMs);
+
 /** Stop monitoring the output of the GNSS chip for a message.
  * Once this function returns the pCallback function passed to the
  * associated uGnssMsgReceiveStart() will no longer be called.
@@ -457,6 +631,20 @@ int32_t uGnssMsgReceiveStackMinFree(uDeviceHandle_t gnssHandle);
  */
 size_t uGnssMsgReceiveStatReadLoss(uDeviceHandle_t gnssHandle);
 
+/** Get the number of messages that a receiver started with
+ * uGnssMsgReceiveStartQueued() has missed because its queue was
+ * full, i.e. its callback was not keeping up or the queue is too
+ * small for the messages it is receiving.
+ *
+ * @param gnssHandle   the handle of the GNSS instance.
+ * @param asyncHandle  the handle originally returned by
+ *                     uGnssMsgReceiveStartQueued().
+ * @return             on success the number of messages lost,
+ *                     else negative error code.
+ */
+int32_t uGnssMsgReceiveStatQueueLoss(uDeviceHandle_t gnssHandle,
+                                     int32_t asyncHandle);
+
 /** Check the number of bytes lost between a streaming source (for
  * instance I2C or UART or SPI) and the input of the ring buffer as a
  * result of the ring buffer not being emptied fast enough.  This is a
@@ -468,6 +656,87 @@ size_t uGnssMsgReceiveStatReadLoss(uDeviceHandle_t gnssHandle);
  */
 size_t uGnssMsgReceiveStatStreamLoss(uDeviceHandle_t gnssHandle);
 
+/** Start injecting correction data, e.g. RTCM3 from an NTRIP
+ * caster or SPARTN from a PointPerfect MQTT feed, into the GNSS
+ * chip.  Once this has been called, raw correction data can be passed
+ * to uGnssMsgInject() in chunks of any size, which need not be aligned
+ * with message boundaries; a task started by this function frames the
+ * data into RTCM3 and SPARTN messages, checking the CRC of each,
+ * throws away anything else, and writes the complete messages to the
+ * GNSS chip in batches of up to #U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES,
+ * so that the transport is claimed far less often than it would be
+ * if each message was sent with uGnssMsgSend().
+ *
+ * If injection has already been started, this function just changes
+ * maxRateBytesPerSecond.
+ *
+ * IMPORTANT: this does not work for modules connected via an AT
+ * transport, please instead open a Virtual Serial connection for
+ * that case (see uCellMuxAddChannel()).
+ *
+ * @param gnssHandle            the handle of the GNSS instance.
+ * @param queueSizeBytes        the size of the queue which holds the
+ *                              data passed to uGnssMsgInject() until it
+ *                              is written, zero for
+ *                              #U_GNSS_MSG_INJECT_QUEUE_SIZE_BYTES.
+ * @param maxRateBytesPerSecond the maximum average rate at which data
+ *                              may be written to the GNSS chip, zero
+ *                              for no limit; use this to leave room
+ *                              on a slow transport for other traffic.
+ * @return                      zero on success else negative error code.
+ */
+int32_t uGnssMsgInjectStart(uDeviceHandle_t gnssHandle,
+                            size_t queueSizeBytes,
+                            int32_t maxRateBytesPerSecond);
+
+/** Queue correction data for injection into the GNSS chip; call
+ * uGnssMsgInjectStart() first.  This function never blocks: the data
+ * is copied into the injection queue and the function returns,
+ * accepting only as much data as there is room for.
+ *
+ * Note: this function is not thread-safe with itself, call it from
+ * one task only, and it must not be called while uGnssMsgInjectStop()
+ * or uGnssRemove() are being called.
+ *
+ * @param gnssHandle  the handle of the GNSS instance.
+ * @param[in] pBuffer the raw correction data; may only be NULL if
+ *                    size is zero.
+ * @param size        the amount of data at pBuffer.
+ * @return            on success the number of bytes that were
+ *                    accepted, which will be less than size if the
+ *                    injection queue is full, else negative error
+ *                    code.
+ */
+int32_t uGnssMsgInject(uDeviceHandle_t gnssHandle,
+                       const char *pBuffer, size_t size);
+
+/** Stop injecting correction data into the GNSS chip; any data
+ * queued but not yet written is lost.  This is done automatically
+ * when the GNSS instance is removed.
+ *
+ * @param gnssHandle the handle of the GNSS instance.
+ * @return           zero on success else negative error code.
+ */
+int32_t uGnssMsgInjectStop(uDeviceHandle_t gnssHandle);
+
+/** Get the statistics of correction injection.
+ *
+ * @param gnssHandle            the handle of the GNSS instance.
+ * @param[out] pSentBytes       a place to put the number of bytes
+ *                              of correction messages written to the
+ *                              GNSS chip; may be NULL.
+ * @param[out] pDiscardedBytes  a place to put the number of bytes that
+ *                              were thrown away, either because they
+ *                              were not part of a valid RTCM3 or SPARTN
+ *                              message or because they could not be
+ *                              written to the GNSS chip; may be NULL.
+ * @return                      zero on success, #U_ERROR_COMMON_NOT_FOUND
+ *                              if injection has not been started, else
+ *                              negative error code.
+ */
+int32_t uGnssMsgInjectStat(uDeviceHandle_t gnssHandle,
+                           size_t *pSentBytes, size_t *pDiscardedBytes);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,9 @@
  * please keep #includes to your .c files. */
 
 #include "u_device.h"
+#include "u_gnss_dec_ubx_nav_pvt.h"
+#include "u_gnss_dec_ubx_nav_hpposllh.h"
+#include "u_gnss_dec_ubx_nav_cov.h"
 
 /** \addtogroup _GNSS
  *  @{
@@ -50,6 +53,11 @@ extern "C" {
  */
 #define U_GNSS_POS_STREAMED_PERIOD_DEFAULT_MS 1000
 
+/** The shortest period that may be requested of
+ * uGnssPosGetStreamedFixStart(), in milliseconds, i.e. 25 Hz.
+ */
+#define U_GNSS_POS_STREAMED_FIX_PERIOD_MIN_MS 40
+
 /** The recommended minimum number of satellites required to
  * be visible and meet the criteria when calling uGnssPosGetRrlp()
  * for the Cloud Locate service.
@@ -75,6 +83,52 @@ extern "C" {
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The possible contents of a #uGnssPosFix_t, used as bit
+ * positions in the contentsBitmap parameter of
+ * uGnssPosGetStreamedFixStart() and in the contentsBitmap field
+ * of #uGnssPosFix_t.
+ */
+typedef enum {
+    U_GNSS_POS_FIX_CONTENT_PVT = 0,      /**< UBX-NAV-PVT, always requested. */
+    U_GNSS_POS_FIX_CONTENT_HPPOSLLH = 1, /**< UBX-NAV-HPPOSLLH, only supported
+                                              by high precision GNSS devices. */
+    U_GNSS_POS_FIX_CONTENT_COV = 2,      /**< UBX-NAV-COV. */
+    U_GNSS_POS_FIX_CONTENT_MAX_NUM
+} uGnssPosFixContent_t;
+
+/** A position fix delivered by uGnssPosGetStreamedFixStart():
+ * the messages of one navigation epoch, i.e. with the same iTOW,
+ * merged together.
+ */
+typedef struct {
+    uint32_t iTOW;           /**< GPS time of week of the navigation epoch
+                                  in milliseconds. */
+    uint32_t contentsBitmap; /**< a bit-map of #uGnssPosFixContent_t
+                                  indicating which of the fields below
+                                  are populated; fields not populated
+                                  are zero. */
+    int32_t latencyMs;       /**< the time from the first message of the
+                                  epoch being read from the GNSS device
+                                  to the callback being called. */
+    uGnssDecUbxNavPvt_t pvt; /**< the UBX-NAV-PVT message. */
+    uGnssDecUbxNavHpposllh_t hpposllh; /**< the UBX-NAV-HPPOSLLH message. */
+    uGnssDecUbxNavCov_t cov; /**< the UBX-NAV-COV message. */
+} uGnssPosFix_t;
+
+/** Latency statistics for uGnssPosGetStreamedFixStart(), as
+ * returned by uGnssPosGetStreamedStatLatency().
+ */
+typedef struct {
+    int32_t numFixes;      /**< the number of fixes delivered. */
+    int32_t numIncomplete; /**< the number of fixes delivered without
+                                all of the requested contents because
+                                the next epoch began first. */
+    int32_t lastMs;        /**< the latency of the most recent fix. */
+    int32_t minMs;         /**< the smallest latency. */
+    int32_t maxMs;         /**< the largest latency. */
+    int32_t averageMs;     /**< the average latency. */
+} uGnssPosStatLatency_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS:  WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -280,6 +334,69 @@ int32_t uGnssPosGetStreamedStart(uDeviceHandle_t gnssHandle,
  */
 void uGnssPosGetStreamedStop(uDeviceHandle_t gnssHandle);
 
+/** A high rate version of uGnssPosGetStreamedStart(): rather than
+ * delivering only the contents of UBX-NAV-PVT, the UBX-NAV-PVT,
+ * UBX-NAV-HPPOSLLH and UBX-NAV-COV messages of each navigation
+ * epoch are merged into a single #uGnssPosFix_t and passed to
+ * pCallback, along with the latency of the fix.  Latency statistics
+ * may be read with uGnssPosGetStreamedStatLatency().
+ *
+ * The same conditions apply as for uGnssPosGetStreamedStart() and
+ * the two share the same storage: calling this function will stop
+ * any streamed position started with uGnssPosGetStreamedStart(),
+ * and vice-versa, and uGnssPosGetStreamedStop() is used to stop
+ * either.
+ *
+ * A fix is delivered as soon as all of the requested contents for an
+ * epoch have arrived; should the first message of the next epoch
+ * arrive before that, the fix is delivered with what it has, hence
+ * the latency is bounded by the epoch period.  Decoding is performed
+ * into storage allocated when this function is called, nothing is
+ * allocated per epoch.
+ *
+ * @param gnssHandle          the handle of the GNSS instance to use.
+ * @param rateMs              the desired time between position fixes in
+ *                            milliseconds, minimum
+ *                            #U_GNSS_POS_STREAMED_FIX_PERIOD_MIN_MS,
+ *                            or -1 to leave the rate settings unchanged;
+ *                            see uGnssPosGetStreamedStart().
+ * @param contentsBitmap      a bit-map of #uGnssPosFixContent_t, the
+ *                            contents wanted in each fix;
+ *                            #U_GNSS_POS_FIX_CONTENT_PVT is always
+ *                            included, whether set or not.
+ * @param[in] pCallback       a callback that will be called with each
+ *                            fix; the #uGnssPosFix_t pointed-to is valid
+ *                            only for the duration of the callback.
+ *                            pCallback is called from the message
+ *                            receive task of the uGnssMsg API: it should
+ *                            return quickly and must not call back into
+ *                            this API.
+ * @param[in] pCallbackParam  will be passed to pCallback as its last
+ *                            parameter; may be NULL.
+ * @return                    zero on success or negative error code on
+ *                            failure.
+ */
+int32_t uGnssPosGetStreamedFixStart(uDeviceHandle_t gnssHandle,
+                                    int32_t rateMs,
+                                    uint32_t contentsBitmap,
+                                    void (*pCallback) (uDeviceHandle_t gnssHandle,
+                                                       const uGnssPosFix_t *pFix,
+                                                       void *pCallbackParam),
+                                    void *pCallbackParam);
+
+/** Get the latency statistics of a uGnssPosGetStreamedFixStart();
+ * the statistics are reset each time uGnssPosGetStreamedFixStart()
+ * is called.
+ *
+ * @param gnssHandle  the handle of the GNSS instance.
+ * @param[out] pStat  a place to put the statistics; cannot be NULL.
+ * @return            zero on success or negative error code; if
+ *                    uGnssPosGetStreamedFixStart() is not running
+ *                    #U_ERROR_COMMON_NOT_FOUND will be returned.
+ */
+int32_t uGnssPosGetStreamedStatLatency(uDeviceHandle_t gnssHandle,
+                                       uGnssPosStatLatency_t *pStat);
+
 /** Set the mode for uGnssPosGetRrlp(); M10 modules or later only.
  * If this is not called U_GNSS_RRLP_MODE_MEASX will apply.  Setting
  * modes #U_GNSS_RRLP_MODE_MEAS50, #U_GNSS_RRLP_MODE_MEAS20,
@@ -400,6 +517,80 @@ int32_t uGnssPosGetRrlp(uDeviceHandle_t gnssHandle, char *pBuffer, size_t sizeBy
                         int32_t pseudorangeRmsErrorIndexLimit,
                         bool (*pKeepGoingCallback) (uDeviceHandle_t));
 
+/** Start batched capture of RRLP information: rather than polling
+ * for one measurement set per call, as uGnssPosGetRrlp() does, the
+ * GNSS chip is asked to emit UBX-RXM-MEASX with every measurement and
+ * those messages that meet the given criteria are accumulated, whole,
+ * in pArena.  When numSets of them have been accumulated pCallback is
+ * called, once, with the contents of pArena, which may then be sent
+ * to the Cloud Locate service in a single upload; when pCallback
+ * returns, accumulation begins again at the start of pArena.  If the
+ * next message would not fit into what is left of pArena then pCallback
+ * is called early, with fewer than numSets sets, so that nothing is lost.
+ *
+ * Since the measurement sets are delivered in one go, the application
+ * may power the GNSS chip down as soon as a batch has been delivered,
+ * minimising the time it is on; the current measurement rate applies,
+ * see uGnssCfgSetRate().  This uses the same stream as uGnssMsgReceiveStart()
+ * and so is only supported on a streaming transport (i.e. not AT), and
+ * only with #U_GNSS_RRLP_MODE_MEASX (the default), since the other modes
+ * are only polled.  Call uGnssPosGetRrlpBatchStop() to stop; calling this
+ * function again while a batched capture is running stops it first.
+ *
+ * @param gnssHandle                    the handle of the GNSS instance to use.
+ * @param[in] pArena                    storage for the measurement sets;
+ *                                      cannot be NULL and must remain valid
+ *                                      until uGnssPosGetRrlpBatchStop() is
+ *                                      called.  Each set is a complete
+ *                                      UBX-RXM-MEASX message, including the
+ *                                      UBX protocol header and CRC that the
+ *                                      Cloud Locate service expects, and
+ *                                      so occupies 52 + 24 * [number of
+ *                                      satellites] bytes.
+ * @param arenaSizeBytes                the number of bytes of storage at pArena,
+ *                                      must be at least 52.
+ * @param numSets                       the number of measurement sets to collect
+ *                                      before pCallback is called; must be
+ *                                      greater than zero.
+ * @param svsThreshold                  as for uGnssPosGetRrlp().
+ * @param cNoThreshold                  as for uGnssPosGetRrlp().
+ * @param multipathIndexLimit           as for uGnssPosGetRrlp().
+ * @param pseudorangeRmsErrorIndexLimit as for uGnssPosGetRrlp().
+ * @param[in] pCallback                 the callback that is given the batch of
+ *                                      measurement sets, which are the first
+ *                                      size bytes of pArena; cannot be NULL.
+ *                                      The callback is called from the message
+ *                                      receive task, see uGnssMsgReceiveStart(),
+ *                                      and so must not call back into this API:
+ *                                      in particular it must not call
+ *                                      uGnssPosGetRrlpBatchStop(), it should
+ *                                      instead signal a task of its own to do so.
+ * @param[in] pCallbackParam            a parameter that will be passed to
+ *                                      pCallback, may be NULL.
+ * @return                              zero on success else negative error code.
+ */
+int32_t uGnssPosGetRrlpBatchStart(uDeviceHandle_t gnssHandle,
+                                  char *pArena, size_t arenaSizeBytes,
+                                  size_t numSets, int32_t svsThreshold,
+                                  int32_t cNoThreshold,
+                                  int32_t multipathIndexLimit,
+                                  int32_t pseudorangeRmsErrorIndexLimit,
+                                  void (*pCallback) (uDeviceHandle_t gnssHandle,
+                                                     const char *pArena,
+                                                     size_t size,
+                                                     size_t numSets,
+                                                     void *pCallbackParam),
+                                  void *pCallbackParam);
+
+/** Stop a batched capture of RRLP information started with
+ * uGnssPosGetRrlpBatchStart(), setting the UBX-RXM-MEASX message
+ * rate back to what it was; any measurement sets that have been
+ * accumulated but not yet passed to the callback are discarded.
+ *
+ * @param gnssHandle  the handle of the GNSS instance.
+ */
+void uGnssPosGetRrlpBatchStop(uDeviceHandle_t gnssHandle);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_GNSS_POS_LOG_H_
+#define _U_GNSS_POS_LOG_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+#include "u_ringbuffer.h"
+
+/** \addtogroup _GNSS
+ *  @{
+ */
+
+/** @file
+ * @brief This header file defines the position log of the GNSS API:
+ * a compact, binary, ring-buffered record of position fixes, such
+ * as those delivered by uGnssPosGetStreamedStart(), kept on this MCU.
+ * It does not talk to the GNSS chip and needs no GNSS instance, hence
+ * it costs nothing unless it is used.
+ *
+ * Each fix is stored as the difference from the fix before it, so
+ * that a fix from a moving receiver logged once a second typically
+ * occupies 8 or 9 bytes and a stationary one 3 bytes.  Every
+ * #U_GNSS_POS_LOG_KEYFRAME_INTERVAL fixes a "key-frame", holding the
+ * absolute values, is stored; when the log is full, the oldest fixes
+ * are thrown away a key-frame at a time, so the log always begins
+ * with a key-frame and can always be decoded.
+ *
+ * The linear buffer under the log is supplied by the application,
+ * so it may be anywhere the MCU can byte-address, for instance
+ * retention RAM or memory-mapped FRAM; periodically calling
+ * uGnssPosLogExport() to move the contents to some other storage,
+ * e.g. flash, is also supported.  The format of the exported data
+ * is the same as that of the log and is decoded with
+ * uGnssPosLogDecode().
+ *
+ * These functions are not thread-safe: if you add fixes to and
+ * export fixes from a log in different tasks, protect the log
+ * with a mutex of your own.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_GNSS_POS_LOG_KEYFRAME_INTERVAL
+/** The number of fixes from one key-frame to the next; a larger
+ * number saves a little space but means that a little more of the
+ * log is thrown away when it is full.
+ */
+# define U_GNSS_POS_LOG_KEYFRAME_INTERVAL 32
+#endif
+
+/** The largest a single record in the log can be: a header byte,
+ * three variable-length 32-bit values, each of which can take up
+ * to five bytes, and a variable-length 64-bit value, which can
+ * take up to ten bytes.  A linear buffer given to
+ * uGnssPosLogCreate() must be bigger than this.
+ */
+#define U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES (1 + (5 * 3) + 10)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** A position fix, as stored in a position log.
+ */
+typedef struct {
+    int32_t latitudeX1e7;        /**< latitude in ten millionths of a degree. */
+    int32_t longitudeX1e7;       /**< longitude in ten millionths of a degree. */
+    int32_t altitudeMillimetres; /**< altitude in millimetres. */
+    int64_t timeMs;              /**< the time of the fix in milliseconds,
+                                      for instance timeUtc * 1000. */
+} uGnssPosLogFix_t;
+
+/** A position log; the contents of this structure are internal,
+ * please use the functions of this API to get to them.
+ */
+typedef struct {
+    uRingBuffer_t ringBuffer;
+    size_t numFixes;          /**< the number of fixes in ringBuffer. */
+    size_t numSinceKeyframe;  /**< the number of fixes added since the
+                                   last key-frame was added. */
+    uGnssPosLogFix_t last;    /**< the last fix added. */
+} uGnssPosLog_t;
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Create a position log.
+ *
+ * @param[in] pLog    a pointer to the position log, cannot be NULL.
+ * @param[in] pBuffer the linear buffer in which to store the log,
+ *                    which must remain valid until uGnssPosLogDelete()
+ *                    is called; cannot be NULL.
+ * @param size        the size of pBuffer in bytes; must be larger than
+ *                    #U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES.
+ * @return            zero on success else negative error code.
+ */
+int32_t uGnssPosLogCreate(uGnssPosLog_t *pLog, char *pBuffer,
+                          size_t size);
+
+/** Delete a position log; the linear buffer passed to
+ * uGnssPosLogCreate() is not touched.
+ *
+ * @param[in] pLog a pointer to the position log, cannot be NULL.
+ */
+void uGnssPosLogDelete(uGnssPosLog_t *pLog);
+
+/** Add a fix to a position log, throwing away the oldest fixes
+ * if there is not enough room.  This might, for instance, be
+ * called from the callback of uGnssPosGetStreamedStart() when
+ * errorCode is zero.
+ *
+ * @param[in] pLog             a pointer to the position log, cannot
+ *                             be NULL.
+ * @param latitudeX1e7         the latitude in ten millionths of
+ *                             a degree.
+ * @param longitudeX1e7        the longitude in ten millionths of
+ *                             a degree.
+ * @param altitudeMillimetres  the altitude in millimetres.
+ * @param timeMs               the time of the fix in milliseconds.
+ * @return                     zero on success else negative error code.
+ */
+int32_t uGnssPosLogAdd(uGnssPosLog_t *pLog,
+                       int32_t latitudeX1e7, int32_t longitudeX1e7,
+                       int32_t altitudeMillimetres, int64_t timeMs);
+
+/** Get the number of fixes in a position log.
+ *
+ * @param[in] pLog a pointer to the position log, cannot be NULL.
+ * @return         the number of fixes in the log.
+ */
+size_t uGnssPosLogGetNumFixes(const uGnssPosLog_t *pLog);
+
+/** Export the contents of a position log, oldest first, in whole
+ * fixes, optionally removing what was exported from the log.  The
+ * data begins with a key-frame unless a previous call removed
+ * only part of a sequence of fixes from the log, in which case it
+ * continues from where that call left off.
+ *
+ * @param[in] pLog     a pointer to the position log, cannot be NULL.
+ * @param[out] pBuffer a place to put the exported data; cannot be NULL.
+ * @param size         the amount of storage at pBuffer.
+ * @param remove       if true then the fixes that are exported
+ *                     are removed from the log.
+ * @return             on success the number of bytes written to
+ *                     pBuffer, else negative error code.
+ */
+int32_t uGnssPosLogExport(uGnssPosLog_t *pLog, char *pBuffer,
+                          size_t size, bool remove);
+
+/** Decode one fix from the data exported by uGnssPosLogExport().
+ * Since most fixes are stored as the difference from the fix
+ * before them, pFix must contain the previously decoded fix when
+ * this is called; to decode a whole export, keep calling this
+ * function with the same pFix, moving pBuffer on by the return
+ * value each time, and carry pFix over to the next export if
+ * fixes were removed from the log by the export.
+ *
+ * @param[in] pBuffer  a pointer to the exported data, cannot be NULL.
+ * @param size         the amount of data at pBuffer.
+ * @param[in,out] pFix on entry the previously decoded fix, on return
+ *                     the decoded fix; cannot be NULL.
+ * @return             on success the number of bytes of pBuffer that
+ *                     were decoded, #U_ERROR_COMMON_TIMEOUT if size is
+ *                     not enough to hold the whole record, else negative
+ *                     error code.
+ */
+int32_t uGnssPosLogDecode(const char *pBuffer, size_t size,
+                          uGnssPosLogFix_t *pFix);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_GNSS_POS_LOG_H_
+
+// End of file
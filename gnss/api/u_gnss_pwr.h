@@ -233,6 +233,63 @@ typedef enum {
                                                                    #U_GNSS_CFG_VAL_KEY_ID_PM_DONOTENTEROFF_L. */
 } uGnssPwrFlag_t;
 
+/** What the duty-cycling engine, see uGnssPwrDutyCycleFix(), is
+ * trying to achieve.
+ */
+typedef struct {
+    int32_t fixIntervalSeconds;   /**< the wanted interval between fixes. */
+    int32_t radiusMillimetresMax; /**< the largest radius of position that is
+                                       good enough; use -1 to accept the first
+                                       fix the GNSS chip reports. */
+    int32_t onTimeMaxSeconds;     /**< the longest the GNSS chip may be left on
+                                       in trying to achieve a fix, must be
+                                       greater than zero. */
+    bool assistNowAutonomous;     /**< if true then AssistNow Autonomous will
+                                       be switched on the first time the GNSS
+                                       chip is powered on, so that it can predict
+                                       orbits and hence reduce time to fix while
+                                       it is otherwise idle; this requires
+                                       battery-backed RAM. */
+} uGnssPwrDutyCycleCfg_t;
+
+/** Statistics from the duty-cycling engine: the on-time per fix
+ * is a proxy for the energy each fix costs.
+ */
+typedef struct {
+    size_t numFixes;          /**< the number of fixes that met the criteria. */
+    size_t numFailures;       /**< the number of attempts that did not. */
+    int64_t onTimeTotalMs;    /**< the total time for which the GNSS chip was on,
+                                   whether it achieved a fix or not. */
+    int32_t onTimeLastMs;     /**< the on-time of the most recent attempt, -1
+                                   if there has been none. */
+    int32_t onTimeMaxMs;      /**< the on-time of the longest attempt, -1 if
+                                   there has been none. */
+    int32_t onTimePerFixMs;   /**< onTimeTotalMs divided by numFixes, i.e.
+                                   including the on-time of failed attempts;
+                                   -1 if there has been no fix. */
+} uGnssPwrDutyCycleStat_t;
+
+/** The context for the duty-cycling engine; the contents of this
+ * structure are internal, please use the functions of this API to
+ * get to them.
+ */
+typedef struct {
+    uGnssPwrDutyCycleCfg_t cfg;
+    uGnssPwrDutyCycleStat_t stat;
+    bool (*pKeepGoingCallback) (uDeviceHandle_t); /**< the user's callback
+                                                       during an attempt. */
+    int64_t startTimeMs;      /**< tick time at the start of the last attempt,
+                                   -1 if there has been none. */
+    int64_t stopTimeMs;       /**< tick time at which the current attempt must end. */
+    bool autonomousDone;      /**< true once AssistNow Autonomous has been set. */
+    int64_t fixTimeMs;        /**< tick time of the last fix, -1 if there is none. */
+    int64_t fixTimeUtc;       /**< UTC time of the last fix, -1 if not known. */
+    int32_t latitudeX1e7;     /**< the last fix. */
+    int32_t longitudeX1e7;
+    int32_t altitudeMillimetres;
+    int32_t radiusMillimetres;
+} uGnssPwrDutyCycle_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -560,6 +617,83 @@ int32_t uGnssPwrSetExtintInactivityTimeout(uDeviceHandle_t gnssHandle,
  */
 int32_t uGnssPwrGetExtintInactivityTimeout(uDeviceHandle_t gnssHandle);
 
+/** Initialise the context of the duty-cycling engine.  Rather than
+ * relying on the power-saving modes of the GNSS chip, the duty-cycling
+ * engine powers the GNSS chip on for just long enough to get each
+ * fix, see uGnssPwrDutyCycleFix(), feeding it hints from the previous
+ * fix so that it can hot-start.  Use this when fixes are needed only
+ * infrequently, e.g. every few minutes or more, and the MCU is able to
+ * keep track of time in between.  The context is supplied by the
+ * application; there is no task involved and nothing is allocated.
+ *
+ * @param[out] pDutyCycle a pointer to the context, cannot be NULL.
+ * @param[in] pCfg        what the engine is trying to achieve, cannot
+ *                        be NULL; a copy is taken.
+ * @return                zero on success else negative error code.
+ */
+int32_t uGnssPwrDutyCycleInit(uGnssPwrDutyCycle_t *pDutyCycle,
+                              const uGnssPwrDutyCycleCfg_t *pCfg);
+
+/** Perform one cycle of the duty-cycling engine: power the GNSS chip
+ * on, give it the position and time of the previous fix (with an
+ * uncertainty that grows with the time since, see uGnssMgaIniPosSend()
+ * and uGnssMgaIniTimeSend()), wait for a fix with radius no larger than
+ * radiusMillimetresMax, or for onTimeMaxSeconds to pass, then power the
+ * GNSS chip off again.  Call this, having waited for
+ * uGnssPwrDutyCycleGetWaitMs() since the last call, in a loop.  The
+ * hints are not sent where the transport is #U_GNSS_TRANSPORT_AT,
+ * since the MGA API does not support that transport.
+ *
+ * This function is blocking; it may be called from any task but not at
+ * the same time for the same GNSS instance.  The power state of the GNSS
+ * chip should be left to this function between calls.
+ *
+ * @param gnssHandle                 the handle of the GNSS instance.
+ * @param[in,out] pDutyCycle         a pointer to the context, as initialised
+ *                                   by uGnssPwrDutyCycleInit(); cannot be NULL.
+ * @param[out] pLatitudeX1e7         a place to put latitude (in ten millionths
+ *                                   of a degree); may be NULL.
+ * @param[out] pLongitudeX1e7        a place to put longitude (in ten millionths
+ *                                   of a degree); may be NULL.
+ * @param[out] pAltitudeMillimetres  a place to put the altitude (in millimetres);
+ *                                   may be NULL.
+ * @param[out] pRadiusMillimetres    a place to put the radius of position
+ *                                   (in millimetres); may be NULL.
+ * @param[out] pTimeUtc              a place to put the UTC time; may be NULL.
+ * @param[in] pKeepGoingCallback     a callback function that is called while
+ *                                   waiting for the fix; the attempt will be
+ *                                   abandoned early if it returns false.  May
+ *                                   be NULL.
+ * @return                           zero on success, #U_ERROR_COMMON_TIMEOUT if
+ *                                   no fix good enough was achieved in the time,
+ *                                   else negative error code.
+ */
+int32_t uGnssPwrDutyCycleFix(uDeviceHandle_t gnssHandle,
+                             uGnssPwrDutyCycle_t *pDutyCycle,
+                             int32_t *pLatitudeX1e7, int32_t *pLongitudeX1e7,
+                             int32_t *pAltitudeMillimetres,
+                             int32_t *pRadiusMillimetres,
+                             int64_t *pTimeUtc,
+                             bool (*pKeepGoingCallback) (uDeviceHandle_t));
+
+/** Get how long to wait before calling uGnssPwrDutyCycleFix() again
+ * in order to meet the wanted fix interval.
+ *
+ * @param[in] pDutyCycle a pointer to the context, cannot be NULL.
+ * @return               the time to wait in milliseconds, zero if
+ *                       uGnssPwrDutyCycleFix() should be called now.
+ */
+int32_t uGnssPwrDutyCycleGetWaitMs(const uGnssPwrDutyCycle_t *pDutyCycle);
+
+/** Get the statistics of the duty-cycling engine.
+ *
+ * @param[in] pDutyCycle a pointer to the context, cannot be NULL.
+ * @param[out] pStat     a place to put the statistics, cannot be NULL.
+ * @return               zero on success else negative error code.
+ */
+int32_t uGnssPwrDutyCycleGetStat(const uGnssPwrDutyCycle_t *pDutyCycle,
+                                 uGnssPwrDutyCycleStat_t *pStat);
+
 #ifdef __cplusplus
 }
 #endif
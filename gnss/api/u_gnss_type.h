@@ -88,6 +88,23 @@
 # define U_GNSS_SPI_FILL_THRESHOLD_MAX 128
 #endif
 
+#ifndef U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES
+/** The length of each of the two buffers that the GNSS driver will
+ * use to receive from a GNSS chip on SPI in the background, where
+ * the platform supports uPortSpiControllerReceiveAsyncStart(); the
+ * storage is allocated from the heap.  Set this to zero to always
+ * poll the SPI bus instead.
+ */
+# define U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES 256
+#endif
+
+#ifndef U_GNSS_SPI_RECEIVE_ASYNC_INTERVAL_MS
+/** The interval between background SPI receive transfers, see
+ * #U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES.
+ */
+# define U_GNSS_SPI_RECEIVE_ASYNC_INTERVAL_MS 10
+#endif
+
 /** There can be an inverter in-line between an MCU pin
  * and whatever enables power to the GNSS chip; OR this value
  * with the value of the pin passed into uGnssAdd() and the sense of
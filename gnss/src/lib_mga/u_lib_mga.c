@@ -109,6 +109,9 @@ typedef int SOCKET;
 #define UBX_SIG_PREFIX_2        0x62
 #define UBX_MSG_FRAME_SIZE      8
 #define UBX_MSG_PAYLOAD_OFFSET  6
+// MODIFIED: added for mgaGetOfflineDataRead(), enough of the start of a UBX-MGA-ANO message to include its
+// year, month, day and hour, as used by isAnoMatch() and adjustTimeToBestMatch()
+#define MGA_OFFLINE_HEADER_READ_SIZE (UBX_MSG_PAYLOAD_OFFSET + 8)
 
 #define UBX_CLASS_MGA           0x13
 #define UBX_MGA_ANO             0x20
@@ -303,6 +306,8 @@ static void addMgaIniTime(const UBX_U1* pMgaData, UBX_I4* iSize, UBX_U1** pMgaDa
 static void addMgaIniPos(const UBX_U1* pMgaData, UBX_I4* iSize, UBX_U1** pMgaDataOut, const MgaPosAdjust* pPos);
 static void sendCfgMgaAidAcks(bool enable, bool bV3);
 static void sendInitialMsgBatch(void);
+// MODIFIED: this function added to support MGA_FLOW_WINDOW.
+static void sendInitialMsgWindow(void);
 static void sendFlashStop(void);
 static void sendAidingFlashStop(void);
 static void sendEmptyFlashBlock(void);
@@ -362,6 +367,11 @@ static void concatNumberWithBuffer(UBX_CH* pBuffer, UBX_I4 iSize, const char* pP
 // a lat/long, etc.
 static void numberToParts(int number, int fractionalDigits, int* pWhole, int* pFraction);
 
+// This function is used by the MODIFIED mgaGetOfflineDataRead().
+// It reads the start of the message at offset into pHeader, which must be MGA_OFFLINE_HEADER_READ_SIZE bytes long,
+// zero-filling anything beyond the end of the message, and returns the size of the whole message in pMsgSize.
+static MGA_API_RESULT readOfflineMsgHeader(EvtReadOfflineData pReadOfflineData, const void* pContext, UBX_U4 offset, UBX_I4 offlineDataSize, UBX_U1* pHeader, UBX_U4* pMsgSize);
+
 ///////////////////////////////////////////////////////////////////////////////
 // libMga API implementation
 
@@ -1447,6 +1457,117 @@ MGA_API_RESULT mgaGetTodaysOfflineData(const struct tm* pTime, UBX_U1* pOfflineD
     return MGA_API_OK;
 }
 
+// MODIFIED: this function added.
+MGA_API_RESULT mgaGetOfflineDataRead(const struct tm* pTime, EvtReadOfflineData pReadOfflineData, const void* pContext, UBX_I4 offlineDataSize, UBX_U1** ppData, UBX_I4* pDataSize)
+{
+    U_ASSERT(ppData);
+    U_ASSERT(pDataSize);
+    U_ASSERT(pReadOfflineData);
+    U_ASSERT(offlineDataSize);
+
+    MGA_API_RESULT res = MGA_API_OK;
+    UBX_U1 header[MGA_OFFLINE_HEADER_READ_SIZE];
+    UBX_U4 msgSize = 0;
+    UBX_U4 offset;
+    UBX_U4 dataSize = 0;
+    int curYear = 0;
+    int curMonth = 0;
+    int curDay = 0;
+
+    *ppData = NULL;
+    *pDataSize = 0;
+
+    if (pTime != NULL)
+    {
+        // First pass: find the closest offline data compared to the current time, exactly as adjustTimeToBestMatch() does
+        bool noneFound = true;
+        time_t diffSecondsMin = 0;
+        time_t correctTime = mktime((struct tm*)pTime);
+        struct tm timeAdjusted;
+
+        for (offset = 0; (res == MGA_API_OK) && (offset < (UBX_U4)offlineDataSize); offset += msgSize)
+        {
+            res = readOfflineMsgHeader(pReadOfflineData, pContext, offset, offlineDataSize, header, &msgSize);
+            if ((res == MGA_API_OK) && (header[2] == UBX_CLASS_MGA) && (header[3] == UBX_MGA_ANO))
+            {
+                struct tm timeOfflineData;
+                memset(&timeOfflineData, 0, sizeof(struct tm));
+                timeOfflineData.tm_year = header[10] + 100;
+                timeOfflineData.tm_mon = header[11] - 1;
+                timeOfflineData.tm_mday = header[12];
+                timeOfflineData.tm_hour = header[13];
+
+                time_t diffSeconds = mktime(&timeOfflineData) - mktime((struct tm*)pTime);
+                if (noneFound || diffSeconds < diffSecondsMin)
+                {
+                    diffSecondsMin = diffSeconds;
+                    noneFound = false;
+                }
+            }
+        }
+
+        correctTime += diffSecondsMin;
+        correctTime += uPortGetTimezoneOffsetSeconds();
+        gmtime_r(&correctTime, &timeAdjusted);
+        curYear = timeAdjusted.tm_year + 1900;
+        curMonth = timeAdjusted.tm_mon + 1;
+        curDay = timeAdjusted.tm_mday;
+    }
+
+    // Second pass: work out how much memory is required
+    for (offset = 0; (res == MGA_API_OK) && (offset < (UBX_U4)offlineDataSize); offset += msgSize)
+    {
+        res = readOfflineMsgHeader(pReadOfflineData, pContext, offset, offlineDataSize, header, &msgSize);
+        if ((res == MGA_API_OK) &&
+            (((pTime != NULL) && isAnoMatch(header, curYear, curMonth, curDay)) || isAlmMatch(header)))
+        {
+            dataSize += msgSize;
+        }
+    }
+
+    if ((res == MGA_API_OK) && (dataSize == 0))
+    {
+        res = MGA_API_NO_DATA_TO_SEND;
+    }
+
+    if (res == MGA_API_OK)
+    {
+        UBX_U1* pData = (UBX_U1*)pUPortMalloc(dataSize);
+        res = MGA_API_OUT_OF_MEMORY;
+        if (pData)
+        {
+            *ppData = pData;
+            *pDataSize = (UBX_I4)dataSize;
+
+            // Third pass: read the matching messages straight into the buffer
+            res = MGA_API_OK;
+            for (offset = 0; (res == MGA_API_OK) && (offset < (UBX_U4)offlineDataSize); offset += msgSize)
+            {
+                res = readOfflineMsgHeader(pReadOfflineData, pContext, offset, offlineDataSize, header, &msgSize);
+                if ((res == MGA_API_OK) &&
+                    (((pTime != NULL) && isAnoMatch(header, curYear, curMonth, curDay)) || isAlmMatch(header)))
+                {
+                    if ((pData + msgSize > *ppData + dataSize) ||
+                        (pReadOfflineData(pContext, offset, pData, (UBX_I4)msgSize) != (UBX_I4)msgSize))
+                    {
+                        res = MGA_API_BAD_DATA;
+                    }
+                    pData += msgSize;
+                }
+            }
+
+            if (res != MGA_API_OK)
+            {
+                uPortFree(*ppData);
+                *ppData = NULL;
+                *pDataSize = 0;
+            }
+        }
+    }
+
+    return res;
+}
+
 // MODIFIED: mgaStartLegacyAiding() removed, not required, but mainly because it removes the need for srand()/rand()/RAND_MAX
 #if 0
 MGA_API_RESULT mgaStartLegacyAiding(UBX_U1* pAidingData, UBX_I4 iSize)
@@ -1928,6 +2049,8 @@ static MGA_API_RESULT handleAidAckMsg(int ackType)
 {
     // do not lock here - lock must already be in place
     U_ASSERT(s_pFlowConfig->mgaFlowControl != MGA_FLOW_SMART);
+    // MODIFIED: MGA_FLOW_WINDOW added.
+    U_ASSERT(s_pFlowConfig->mgaFlowControl != MGA_FLOW_WINDOW);
     U_ASSERT(s_pLastMsgSent != NULL);
 
     if (s_pFlowConfig->mgaFlowControl == MGA_FLOW_NONE)
@@ -3317,6 +3440,34 @@ static void sendInitialMsgBatch(void)
     }
 }
 
+// MODIFIED: this function added to support MGA_FLOW_WINDOW.
+// Like sendInitialMsgBatch() but limited to U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES
+// and without overfilling the receiver's RX buffer; thereafter handleMgaAckMsg()
+// sends one message per ACK, keeping the window full.
+static void sendInitialMsgWindow(void)
+{
+    // do not lock here - lock must already be in place
+    UBX_I4 rxBufferSize = U_GNSS_MGA_RX_BUFFER_SIZE_BYTES;
+    UBX_U4 messagesLeft = U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES;
+    UBX_U4 nextMsg = (s_pLastMsgSent == NULL) ? 0 : s_messagesSent + 1;
+    bool keepGoing = true;
+
+    while (keepGoing && (messagesLeft > 0) && (nextMsg < s_mgaBlockCount))
+    {
+        // always send at least one message, even if it is on the large side
+        keepGoing = (messagesLeft == U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES) ||
+                    ((UBX_I4) s_pMgaMsgList[nextMsg].msgSize <= rxBufferSize);
+        if (keepGoing)
+        {
+            UBX_I4 msgSize = sendNextMgaMessage();
+            keepGoing = (msgSize > 0);
+            rxBufferSize -= msgSize;
+            messagesLeft--;
+            nextMsg++;
+        }
+    }
+}
+
 static void initiateMessageTransfer(void)
 {
     switch (s_pFlowConfig->mgaFlowControl)
@@ -3335,6 +3486,12 @@ static void initiateMessageTransfer(void)
         sendInitialMsgBatch();
         break;
 
+    // MODIFIED: MGA_FLOW_WINDOW added.
+    case MGA_FLOW_WINDOW:
+        sendCfgMgaAidAcks(true, false);
+        sendInitialMsgWindow();
+        break;
+
     default:
         U_ASSERT(0);
         break;
@@ -3366,6 +3523,38 @@ static bool isAnoMatch(const UBX_U1* pMgaData, int cy, int cm, int cd)
     return false;
 }
 
+// MODIFIED: this function added.
+static MGA_API_RESULT readOfflineMsgHeader(EvtReadOfflineData pReadOfflineData, const void* pContext, UBX_U4 offset, UBX_I4 offlineDataSize, UBX_U1* pHeader, UBX_U4* pMsgSize)
+{
+    MGA_API_RESULT res = MGA_API_BAD_DATA;
+    UBX_U4 remaining = (UBX_U4)offlineDataSize - offset;
+    UBX_U4 readSize = MGA_OFFLINE_HEADER_READ_SIZE;
+
+    if (readSize > remaining)
+    {
+        readSize = remaining;
+    }
+
+    memset(pHeader, 0, MGA_OFFLINE_HEADER_READ_SIZE);
+    if ((readSize >= UBX_MSG_FRAME_SIZE) &&
+        (pReadOfflineData(pContext, offset, pHeader, (UBX_I4)readSize) == (UBX_I4)readSize) &&
+        (pHeader[0] == UBX_SIG_PREFIX_1) && (pHeader[1] == UBX_SIG_PREFIX_2))
+    {
+        *pMsgSize = pHeader[4] + (pHeader[5] << 8) + UBX_MSG_FRAME_SIZE;
+        if (*pMsgSize <= remaining)
+        {
+            if (*pMsgSize < readSize)
+            {
+                // Don't let what follows the message be mistaken for its payload
+                memset(pHeader + *pMsgSize, 0, readSize - *pMsgSize);
+            }
+            res = MGA_API_OK;
+        }
+    }
+
+    return res;
+}
+
 static void adjustTimeToBestMatch(const UBX_U1* pMgaData, UBX_I4 pMgaDataSize, const struct tm* pTimeOriginal, struct tm* pTimeAdjusted)
 {
     UBX_U4 totalSize = 0;
@@ -157,7 +157,9 @@ extern "C" {
     {
         MGA_FLOW_SIMPLE,        //!< For each message transferred to the receiver, libMga waits for an ACK before sending the next. Reliable but slow.
         MGA_FLOW_NONE,          //!< No flow control. libMga sends MGA data to receiver as fast as possible. Fast but not necessarily reliable.
-        MGA_FLOW_SMART          //!< Initially a burst of messages is sent, that will fit into the receiver's 1000 byte RX buffer. Then for every ACK received, the next message is sent.
+        MGA_FLOW_SMART,         //!< Initially a burst of messages is sent, that will fit into the receiver's 1000 byte RX buffer. Then for every ACK received, the next message is sent.
+        // MODIFIED: MGA_FLOW_WINDOW added.
+        MGA_FLOW_WINDOW         //!< As MGA_FLOW_SMART but the initial burst is also limited to U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES messages and never overfills the RX buffer, so that at most that many messages are awaiting an ACK.
     } MGA_FLOW_CONTROL_TYPE;
 
     //! Definitions of the possible states libMga is in.
@@ -208,6 +210,17 @@ extern "C" {
                                   UBX_I4 iSize                     //!< Number of bytes to write.
                                   );
 
+    // MODIFIED: this type added to support mgaGetOfflineDataRead().
+    //! Function definition for the offline data read callback handler.
+    /*! Must read iSize bytes of MGA Offline data, starting offset bytes from the start of the data, into pBuffer and
+        return the number of bytes read, or a negative value on error.
+        */
+    typedef UBX_I4(*EvtReadOfflineData)(const void* pContext,      //!< Pointer to the context information supplied to mgaGetOfflineDataRead().
+                                        UBX_U4 offset,             //!< Offset into the MGA Offline data to read from.
+                                        UBX_U1* pBuffer,           //!< Pointer to a buffer to read into.
+                                        UBX_I4 iSize               //!< Number of bytes to read.
+                                        );
+
     //! Event handler jump table.
     /*! This structure defines the jump table of pointers to callback functions for implementing handlers
         to events generated from libMga. This jump table has to be supplied by the application to libMga.
@@ -684,6 +697,31 @@ extern "C" {
         */
     MGA_API_RESULT mgaGetTodaysOfflineData(const struct tm* pTime, UBX_U1* pOfflineData, UBX_I4 offlineDataSize, UBX_U1** ppTodaysData, UBX_I4* pTodaysDataSize);
 
+    // MODIFIED: this function added.
+    //! Extracts Offline MGA messages for a given day, or just ALM messages, from a superset of MGA Offline data that is read through a callback.
+    /*! As mgaGetTodaysOfflineData(), or mgaGetAlmOfflineData() if pTime is NULL, except that the MGA Offline data is
+        not in RAM: it is walked in place by reading just the header of each message through pReadOfflineData, and only
+        the messages that are extracted are read in full, straight into the allocated buffer, so the RAM required is only
+        that of the extracted messages.  The data is read three times over if pTime is not NULL, twice otherwise.
+        This API function will 'malloc' a buffer to return the extracted MGA messages. It is the responsibility of the
+        application to 'free' this buffer when it is finished with it.
+
+        \param pTime             Pointer to a time structure containing the date of the MGA messages to extract. Only year, month & day fields are used.
+                                 If NULL just the ALM messages are extracted.
+        \param pReadOfflineData  The function to call to read the MGA Offline data.
+        \param pContext          Pointer to context information that will be passed to pReadOfflineData.
+        \param offlineDataSize   Size in bytes of the MGA Offline data.
+        \param ppData            Pointer to a pointer to return the allocated buffer containing the extracted MGA messages.
+        \param pDataSize         Pointer to return the size of the allocated buffer.
+
+        \return     MGA_API_OK if extraction took place.\n
+        Fails with:\n
+        MGA_API_NO_DATA_TO_SEND - If no data could be extracted.\n
+        MGA_API_BAD_DATA        - If the data is not a sequence of UBX messages or could not be read.\n
+        MGA_API_OUT_OF_MEMORY   - Not enough memory for the extracted MGA messages.\n
+        */
+    MGA_API_RESULT mgaGetOfflineDataRead(const struct tm* pTime, EvtReadOfflineData pReadOfflineData, const void* pContext, UBX_I4 offlineDataSize, UBX_U1** ppData, UBX_I4* pDataSize);
+
     //! Transfer legacy aiding data to the receiver's flash.
     /*!
         \param pAidingData  Pointer to legacy aiding data.
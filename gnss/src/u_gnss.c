@@ -46,12 +46,18 @@
 #include "u_port_heap.h"
 #include "u_port_debug.h"
 #include "u_port_gpio.h"
+#ifdef U_GNSS_MSG_RING_BUFFER_FILE_PATH
+# include "stdio.h"    // snprintf()
+# include "u_port_clib_platform_specific.h" // In case snprintf() needs it
+# include "u_port_file_map.h"
+#endif
 
 #include "u_gnss_module_type.h"
 #include "u_gnss_type.h"
 #include "u_gnss.h"
 #include "u_gnss_msg.h"
 #include "u_gnss_private.h"
+#include "u_gnss_msg_private.h"
 
 // The headers below are necessary to work around an Espressif linker problem, see uGnssInit()
 #include "u_gnss_pos.h" // For uGnssPosPrivateLink()
@@ -68,6 +74,13 @@
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
+#ifdef U_GNSS_MSG_RING_BUFFER_FILE_PATH
+/** The number to append to #U_GNSS_MSG_RING_BUFFER_FILE_PATH for
+ * the next GNSS instance, protected by gUGnssPrivateMutex.
+ */
+static int32_t gLinearBufferFileIndex = 0;
+#endif
+
 #if U_CFG_ENABLE_LOGGING
 /** To display some nice text.
  */
@@ -131,6 +144,33 @@ static uGnssPrivateInstance_t *pGetGnssInstanceTransportHandle(uGnssTransportTyp
     return pInstance;
 }
 
+// Allocate the linear buffer underneath the ring buffer, from a
+// memory-mapped file if U_GNSS_MSG_RING_BUFFER_FILE_PATH is defined.
+// gUGnssPrivateMutex should be locked before this is called.
+static char *pLinearBufferAlloc()
+{
+#ifdef U_GNSS_MSG_RING_BUFFER_FILE_PATH
+    char path[256];
+
+    snprintf(path, sizeof(path), "%s.%d", U_GNSS_MSG_RING_BUFFER_FILE_PATH,
+             (int) gLinearBufferFileIndex);
+    gLinearBufferFileIndex++;
+    return (char *) pUPortFileMap(path, U_GNSS_MSG_RING_BUFFER_LENGTH_BYTES);
+#else
+    return (char *) pUPortMalloc(U_GNSS_MSG_RING_BUFFER_LENGTH_BYTES);
+#endif
+}
+
+// Free the linear buffer underneath the ring buffer.
+static void linearBufferFree(char *pLinearBuffer)
+{
+#ifdef U_GNSS_MSG_RING_BUFFER_FILE_PATH
+    uPortFileUnmap(pLinearBuffer, U_GNSS_MSG_RING_BUFFER_LENGTH_BYTES);
+#else
+    uPortFree(pLinearBuffer);
+#endif
+}
+
 // Add a GNS instance to the list.
 // gUGnssPrivateMutex should be locked before this is called.
 // Note: doesn't copy it, just adds it.
@@ -138,6 +178,8 @@ static void addGnssInstance(uGnssPrivateInstance_t *pInstance)
 {
     pInstance->pNext = gpUGnssPrivateInstanceList;
     gpUGnssPrivateInstanceList = pInstance;
+    // Allow pUGnssPrivateGetInstance() to go straight to it
+    U_DEVICE_INSTANCE(pInstance->gnssHandle)->pApiInstance = pInstance;
 }
 
 // Remove a GNSS instance from the list.
@@ -154,8 +196,16 @@ static void deleteGnssInstance(uGnssPrivateInstance_t *pInstance)
             uGnssPrivateCleanUpPosTask(pInstance);
             // Stop and clean up streamed position
             uGnssPrivateCleanUpStreamedPos(pInstance);
+            // Stop and clean up batched RRLP capture
+            uGnssPrivateCleanUpRrlpBatch(pInstance);
             // Stop asynchronus message receive from happening
             uGnssPrivateStopMsgReceive(pInstance);
+            // Stop any correction injection
+            uGnssMsgPrivateInjectStop(pInstance);
+            // Stop any background SPI reception
+            uGnssPrivateSpiReceiveAsyncStop(pInstance);
+            // Stop any TX ready interrupt
+            uGnssPrivateCleanUpTxReady(pInstance);
             // Free the SPI buffer, if there is one
             if (pInstance->pSpiRingBuffer != NULL) {
                 uRingBufferDelete(pInstance->pSpiRingBuffer);
@@ -165,7 +215,7 @@ static void deleteGnssInstance(uGnssPrivateInstance_t *pInstance)
             if (pInstance->pLinearBuffer != NULL) {
                 // Free the ring buffer
                 uRingBufferDelete(&(pInstance->ringBuffer));
-                uPortFree(pInstance->pLinearBuffer);
+                linearBufferFree(pInstance->pLinearBuffer);
             }
             // This can go now too
             uPortFree(pInstance->pTemporaryBuffer);
@@ -284,7 +334,7 @@ int32_t uGnssAdd(uGnssModuleType_t moduleType,
 
             // Check parameters
             errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-            if (((size_t) moduleType < gUGnssPrivateModuleListSize) &&
+            if (U_GNSS_PRIVATE_MODULE_IS_SUPPORTED(moduleType) &&
                 ((transportType > U_GNSS_TRANSPORT_NONE) &&
                  (transportType < U_GNSS_TRANSPORT_MAX_NUM)) &&
                 ((transportType == U_GNSS_TRANSPORT_I2C) ||
@@ -305,11 +355,13 @@ int32_t uGnssAdd(uGnssModuleType_t moduleType,
                         pInstance->transportType = transportType;
                         pInstance->ringBufferReadHandlePrivate = -1;
                         pInstance->ringBufferReadHandleMsgReceive = -1;
-                        pInstance->pModule = &(gUGnssPrivateModuleList[moduleType]);
+                        pInstance->pModule =
+                            &(gUGnssPrivateModuleList[U_GNSS_PRIVATE_MODULE_INDEX(moduleType)]);
                         pInstance->transportHandle = transportHandle;
                         pInstance->i2cAddress = U_GNSS_I2C_ADDRESS;
                         pInstance->timeoutMs = U_GNSS_DEFAULT_TIMEOUT_MS;
                         pInstance->spiFillThreshold = U_GNSS_DEFAULT_SPI_FILL_THRESHOLD;
+                        pInstance->pinTxReady = -1;
                         pInstance->printUbxMessages = false;
                         pInstance->pinGnssEnablePower = pinGnssEnablePower;
                         pInstance->atModulePinPwr = -1;
@@ -380,7 +432,7 @@ int32_t uGnssAdd(uGnssModuleType_t moduleType,
                             // Provided we're not on AT transport, i.e. we're on
                             // a streaming transport, then set up the buffer into
                             // which we stream messages received from the module
-                            pInstance->pLinearBuffer = (char *) pUPortMalloc(U_GNSS_MSG_RING_BUFFER_LENGTH_BYTES);
+                            pInstance->pLinearBuffer = pLinearBufferAlloc();
                             if (pInstance->pLinearBuffer != NULL) {
                                 // Also need a temporary buffer to get stuff out
                                 // of the UART/I2C/SPI in the first place
@@ -435,6 +487,11 @@ int32_t uGnssAdd(uGnssModuleType_t moduleType,
                         if (errorCode == 0) {
                             // Add it to the list
                             addGnssInstance(pInstance);
+                            if (pInstance->pSpiRingBuffer != NULL) {
+                                // Receive SPI data in the background if the
+                                // platform supports it; if it doesn't we poll
+                                uGnssPrivateSpiReceiveAsyncStart(pInstance);
+                            }
                             errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                             *pGnssHandle = pInstance->gnssHandle;
                         }
@@ -448,7 +505,7 @@ int32_t uGnssAdd(uGnssModuleType_t moduleType,
                         uPortFree(pInstance->pSpiLinearBuffer);
                         if (pInstance->pLinearBuffer != NULL) {
                             uRingBufferDelete(&(pInstance->ringBuffer));
-                            uPortFree(pInstance->pLinearBuffer);
+                            linearBufferFree(pInstance->pLinearBuffer);
                         }
                         uPortFree(pInstance->pTemporaryBuffer);
                         if (pInstance->transportMutex != NULL) {
@@ -739,6 +796,55 @@ int32_t uGnssSetSpiFillThreshold(uDeviceHandle_t gnssHandle, int32_t count)
     return errorCode;
 }
 
+// Set the TX ready pin.
+int32_t uGnssSetPinTxReady(uDeviceHandle_t gnssHandle, int32_t pinMcu,
+                           int32_t pinGnss, size_t thresholdBytes)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            if (pinMcu >= 0) {
+                errorCode = uGnssPrivateTxReadyStart(pInstance, pinMcu, pinGnss,
+                                                     thresholdBytes);
+            } else {
+                errorCode = uGnssPrivateTxReadyStop(pInstance);
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Get whether SPI data is being received in the background.
+bool uGnssSpiReceiveIsAsync(uDeviceHandle_t gnssHandle)
+{
+    uGnssPrivateInstance_t *pInstance;
+    bool isAsync = false;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            isAsync = (pInstance->pSpiReceiveAsyncBuffer != NULL);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return isAsync;
+}
+
 // Get whether printing of UBX commands and responses is on or off.
 bool uGnssGetUbxMessagePrint(uDeviceHandle_t gnssHandle)
 {
@@ -63,6 +63,10 @@
  */
 #define U_GNSS_CFG_VAL_MSG_MAX_NUM_VALUES 64
 
+#if U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES > U_GNSS_CFG_VAL_MSG_MAX_NUM_VALUES
+# error U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES must be less than or equal to U_GNSS_CFG_VAL_MSG_MAX_NUM_VALUES
+#endif
+
 #ifndef U_GNSS_CFG_MAX_NUM_VAL_GET_SEGMENTS
 /** The maximum number of a VALGET message segments, each containing
  * U_GNSS_CFG_VAL_MSG_MAX_NUM_VALUES, that we can handle.
@@ -132,6 +136,68 @@ static int32_t setUbxCfgNav5(uGnssPrivateInstance_t *pInstance,
                                       sizeof(message));
 }
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: CONFIGURATION SHADOW
+ * -------------------------------------------------------------- */
+
+// Find a key ID in the configuration shadow, returning its index
+// or -1 if it is not there.
+static int32_t shadowFind(const uGnssPrivateInstance_t *pInstance,
+                          uint32_t keyId)
+{
+    int32_t index = -1;
+
+    for (size_t x = 0; (x < pInstance->cfgShadowNumEntries) && (index < 0); x++) {
+        if (pInstance->cfgShadow[x].keyId == keyId) {
+            index = (int32_t) x;
+        }
+    }
+
+    return index;
+}
+
+// Return true if the configuration shadow says that the given
+// value is already set.
+static bool shadowMatches(const uGnssPrivateInstance_t *pInstance,
+                          const uGnssCfgVal_t *pCfgVal)
+{
+    int32_t index = shadowFind(pInstance, pCfgVal->keyId);
+
+    return (index >= 0) && (pInstance->cfgShadow[index].value == pCfgVal->value);
+}
+
+// Remove a key ID from the configuration shadow, if it is there.
+static void shadowRemove(uGnssPrivateInstance_t *pInstance, uint32_t keyId)
+{
+    int32_t index = shadowFind(pInstance, keyId);
+
+    if (index >= 0) {
+        // Order doesn't matter, just move the last one into the gap
+        pInstance->cfgShadowNumEntries--;
+        pInstance->cfgShadow[index] = pInstance->cfgShadow[pInstance->cfgShadowNumEntries];
+    }
+}
+
+// Put a value into the configuration shadow, if it fits.
+static void shadowUpdate(uGnssPrivateInstance_t *pInstance,
+                         const uGnssCfgVal_t *pCfgVal)
+{
+    int32_t index;
+
+    if (U_GNSS_CFG_VAL_KEY_GET_SIZE(pCfgVal->keyId) != U_GNSS_CFG_VAL_KEY_SIZE_EIGHT_BYTES) {
+        index = shadowFind(pInstance, pCfgVal->keyId);
+        if ((index < 0) &&
+            (pInstance->cfgShadowNumEntries < U_GNSS_CFG_SHADOW_MAX_NUM_ENTRIES)) {
+            index = (int32_t) pInstance->cfgShadowNumEntries;
+            pInstance->cfgShadow[index].keyId = pCfgVal->keyId;
+            pInstance->cfgShadowNumEntries++;
+        }
+        if (index >= 0) {
+            pInstance->cfgShadow[index].value = (uint32_t) pCfgVal->value;
+        }
+    }
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: VALGET/VALSET/VALDEL
  * -------------------------------------------------------------- */
@@ -412,11 +478,63 @@ static int32_t valSetByte(uGnssPrivateInstance_t *pInstance,
     *((uint32_t *) &(message[4])) = uUbxProtocolUint32Encode(keyId); // *NOPAD*
     message[8] = (char) value;
 
+    // This only sets the RAM layer so the shadow no longer applies
+    shadowRemove(pInstance, keyId);
+
     // Send the message off
     return uGnssPrivateSendUbxMessage(pInstance, 0x06, 0x8a,
                                       message, sizeof(message));
 }
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: KEY INFORMATION
+ * -------------------------------------------------------------- */
+
+// Check that a key ID is in the key information table and
+// is, or is not, that of a floating point value, returning
+// the size of its value in bits.
+static int32_t keyInfoCheck(uint32_t keyId, bool isFloat,
+                            uGnssCfgValKeyType_t *pType)
+{
+    int32_t errorCodeOrBits = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+    const uGnssCfgValKeyInfo_t *pKeyInfo = pUGnssCfgValKeyInfo(keyId);
+
+    if (pKeyInfo != NULL) {
+        errorCodeOrBits = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pKeyInfo->type == (uint8_t) U_GNSS_CFG_VAL_KEY_TYPE_R) == isFloat) {
+            *pType = (uGnssCfgValKeyType_t) pKeyInfo->type;
+            errorCodeOrBits = 1;
+            if (*pType != U_GNSS_CFG_VAL_KEY_TYPE_L) {
+                errorCodeOrBits = (int32_t) getStorageSizeBytes(U_GNSS_CFG_VAL_KEY_GET_SIZE(keyId));
+                errorCodeOrBits *= 8;
+            }
+        }
+    }
+
+    return errorCodeOrBits;
+}
+
+// Check that an integer value fits a value of the given type and
+// number of bits.
+static bool intFits(uGnssCfgValKeyType_t type, int32_t bits, int64_t value)
+{
+    bool fits = true;
+
+    if (bits < 64) {
+        if (type == U_GNSS_CFG_VAL_KEY_TYPE_I) {
+            fits = (value >= -(1LL << (bits - 1))) && (value < (1LL << (bits - 1)));
+        } else {
+            fits = (value >= 0) && (value < (1LL << bits));
+        }
+    } else {
+        if (type != U_GNSS_CFG_VAL_KEY_TYPE_I) {
+            fits = (value >= 0);
+        }
+    }
+
+    return fits;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS THAT ARE PRIVATE TO GNSS
  * -------------------------------------------------------------- */
@@ -500,7 +618,15 @@ int32_t uGnssCfgPrivateValSetList(uGnssPrivateInstance_t *pInstance,
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
     char *pMessage = NULL;
-    size_t messageSize = 4 + (4 * numValues);
+    size_t messageSize;
+    uGnssCfgVal_t *pNeeded = NULL;
+    const uGnssCfgVal_t *pSend = pList;
+    size_t numSend = numValues;
+    // The shadow holds values known to be in all of the
+    // U_GNSS_CFG_LAYERS_SET layers
+    bool shadowable = (transaction == U_GNSS_CFG_VAL_TRANSACTION_NONE) &&
+                      ((layers & U_GNSS_CFG_LAYERS_SET) == U_GNSS_CFG_LAYERS_SET);
+    size_t y = 0;
 
     if ((pInstance != NULL) &&
         ((pList != NULL) || (numValues == 0)) &&
@@ -510,27 +636,63 @@ int32_t uGnssCfgPrivateValSetList(uGnssPrivateInstance_t *pInstance,
         errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
         if (U_GNSS_PRIVATE_HAS(pInstance->pModule, U_GNSS_PRIVATE_FEATURE_CFGVALXXX)) {
             errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-            // Work out how much memory we need for the message;
-            // we already have the overhead and the amount per key ID,
-            // need to add the amount per value
-            for (size_t x = 0; x < numValues; x++) {
-                messageSize += getStorageSizeBytes(U_GNSS_CFG_VAL_KEY_GET_SIZE((pList + x)->keyId));
+            if (shadowable && (layers == U_GNSS_CFG_LAYERS_SET)) {
+                // Leave out any values that are already set
+                numSend = 0;
+                for (size_t x = 0; x < numValues; x++) {
+                    if (!shadowMatches(pInstance, pList + x)) {
+                        numSend++;
+                    }
+                }
+                if ((numSend > 0) && (numSend < numValues)) {
+                    pNeeded = (uGnssCfgVal_t *) pUPortMalloc(sizeof(uGnssCfgVal_t) * numSend);
+                    if (pNeeded != NULL) {
+                        for (size_t x = 0; x < numValues; x++) {
+                            if (!shadowMatches(pInstance, pList + x)) {
+                                *(pNeeded + y) = *(pList + x);
+                                y++;
+                            }
+                        }
+                    }
+                    pSend = pNeeded;
+                }
             }
-            // Get memory for the body of the UBX-CFG-VALSET message
-            pMessage = (char *) pUPortMalloc(messageSize);
-            if (pMessage != NULL) {
-                // Assemble the message
-                *pMessage       = 0x01; // Version
-                *(pMessage + 1) = layers;
-                *(pMessage + 2) = transaction;
-                *(pMessage + 3) = 0; // Reserved
-                // Add the values
-                packMessage(pList, numValues, pMessage + 4, messageSize - 4);
-                // Send them all off
-                errorCode = uGnssPrivateSendUbxMessage(pInstance, 0x06, 0x8a,
-                                                       pMessage, messageSize);
-                // Free memory
-                uPortFree(pMessage);
+            if ((numSend == 0) && (numValues > 0)) {
+                // Nothing has changed, nothing to do
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            } else if ((pSend != NULL) || (numSend == 0)) {
+                // Work out how much memory we need for the message;
+                // we already have the overhead and the amount per key ID,
+                // need to add the amount per value
+                messageSize = 4 + (4 * numSend);
+                for (size_t x = 0; x < numSend; x++) {
+                    messageSize += getStorageSizeBytes(U_GNSS_CFG_VAL_KEY_GET_SIZE((pSend + x)->keyId));
+                }
+                // Get memory for the body of the UBX-CFG-VALSET message
+                pMessage = (char *) pUPortMalloc(messageSize);
+                if (pMessage != NULL) {
+                    // Assemble the message
+                    *pMessage       = 0x01; // Version
+                    *(pMessage + 1) = layers;
+                    *(pMessage + 2) = transaction;
+                    *(pMessage + 3) = 0; // Reserved
+                    // Add the values
+                    packMessage(pSend, numSend, pMessage + 4, messageSize - 4);
+                    // Send them all off
+                    errorCode = uGnssPrivateSendUbxMessage(pInstance, 0x06, 0x8a,
+                                                           pMessage, messageSize);
+                    // Free memory
+                    uPortFree(pMessage);
+                }
+            }
+            uPortFree(pNeeded);
+            // Keep the shadow in step with what has happened
+            for (size_t x = 0; x < numValues; x++) {
+                if (shadowable && (errorCode == 0)) {
+                    shadowUpdate(pInstance, pList + x);
+                } else {
+                    shadowRemove(pInstance, (pList + x)->keyId);
+                }
             }
         }
     }
@@ -579,6 +741,8 @@ int32_t uGnssCfgPrivateValDelList(uGnssPrivateInstance_t *pInstance,
                                                        pMessage, messageSize);
                 // Free memory
                 uPortFree(pMessage);
+                // Key IDs may be wild-cards so just forget everything
+                uGnssCfgPrivateShadowClear(pInstance);
             }
         }
     }
@@ -586,6 +750,81 @@ int32_t uGnssCfgPrivateValDelList(uGnssPrivateInstance_t *pInstance,
     return errorCode;
 }
 
+// Populate the configuration shadow.
+int32_t uGnssCfgPrivateShadowFill(uGnssPrivateInstance_t *pInstance,
+                                  const uint32_t *pKeyIdList,
+                                  size_t numKeyIds)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    const uGnssCfgValLayer_t layers[] = {U_GNSS_CFG_VAL_LAYER_RAM,
+                                         U_GNSS_CFG_VAL_LAYER_BBRAM,
+                                         U_GNSS_CFG_VAL_LAYER_FLASH
+                                        };
+    uGnssCfgVal_t *pCfgValList;
+    int32_t numValues;
+    bool first = true;
+    bool found;
+    size_t x;
+
+    if ((pInstance != NULL) && (pKeyIdList != NULL)) {
+        uGnssCfgPrivateShadowClear(pInstance);
+        errorCodeOrCount = (int32_t) U_ERROR_COMMON_SUCCESS;
+        for (size_t l = 0; (l < sizeof(layers) / sizeof(layers[0])) &&
+             (errorCodeOrCount == 0); l++) {
+            if ((U_GNSS_CFG_LAYERS_SET & layers[l]) != 0) {
+                pCfgValList = NULL;
+                numValues = uGnssCfgPrivateValGetListAlloc(pInstance, pKeyIdList,
+                                                           numKeyIds, &pCfgValList,
+                                                           layers[l]);
+                if ((numValues > 0) && (pCfgValList != NULL)) {
+                    if (first) {
+                        // Take everything from the first layer
+                        for (int32_t y = 0; y < numValues; y++) {
+                            shadowUpdate(pInstance, pCfgValList + y);
+                        }
+                        first = false;
+                    } else {
+                        // Keep only what is the same in this layer
+                        x = 0;
+                        while (x < pInstance->cfgShadowNumEntries) {
+                            found = false;
+                            for (int32_t y = 0; (y < numValues) && !found; y++) {
+                                found = ((pCfgValList + y)->keyId == pInstance->cfgShadow[x].keyId) &&
+                                        ((pCfgValList + y)->value == pInstance->cfgShadow[x].value);
+                            }
+                            if (found) {
+                                x++;
+                            } else {
+                                shadowRemove(pInstance, pInstance->cfgShadow[x].keyId);
+                            }
+                        }
+                    }
+                } else {
+                    // No values in a layer means none we can rely on
+                    uGnssCfgPrivateShadowClear(pInstance);
+                    if (numValues < 0) {
+                        errorCodeOrCount = numValues;
+                    }
+                }
+                uPortFree(pCfgValList);
+            }
+        }
+        if (errorCodeOrCount == 0) {
+            errorCodeOrCount = (int32_t) pInstance->cfgShadowNumEntries;
+        }
+    }
+
+    return errorCodeOrCount;
+}
+
+// Empty the configuration shadow.
+void uGnssCfgPrivateShadowClear(uGnssPrivateInstance_t *pInstance)
+{
+    if (pInstance != NULL) {
+        pInstance->cfgShadowNumEntries = 0;
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: SPECIFIC CONFIGURATION FUNCTIONS
  * -------------------------------------------------------------- */
@@ -1156,6 +1395,89 @@ int32_t uGnssCfgValSetList(uDeviceHandle_t gnssHandle,
     return errorCode;
 }
 
+// Begin a batch of values to set.
+int32_t uGnssCfgValBatchStart(uGnssCfgValBatch_t *pBatch,
+                              uDeviceHandle_t gnssHandle,
+                              uint32_t layers)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (pBatch != NULL) {
+        pBatch->gnssHandle = gnssHandle;
+        pBatch->layers = layers;
+        pBatch->errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBatch->numMessages = 0;
+        pBatch->numValues = 0;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Add a value to a batch, sending the batch first if it is full.
+int32_t uGnssCfgValBatchAdd(uGnssCfgValBatch_t *pBatch,
+                            uint32_t keyId, uint64_t value)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssCfgValTransaction_t transaction = U_GNSS_CFG_VAL_TRANSACTION_CONTINUE;
+
+    if (pBatch != NULL) {
+        if ((pBatch->errorCode == 0) &&
+            (pBatch->numValues >= U_GNSS_CFG_VAL_BATCH_MAX_NUM_VALUES)) {
+            // Full: send what we have as part of the transaction,
+            // the first message beginning it
+            if (pBatch->numMessages == 0) {
+                transaction = U_GNSS_CFG_VAL_TRANSACTION_BEGIN;
+            }
+            pBatch->errorCode = uGnssCfgValSetList(pBatch->gnssHandle,
+                                                   pBatch->list,
+                                                   pBatch->numValues,
+                                                   transaction,
+                                                   pBatch->layers);
+            pBatch->numMessages++;
+            pBatch->numValues = 0;
+        }
+        if (pBatch->errorCode == 0) {
+            pBatch->list[pBatch->numValues].keyId = keyId;
+            pBatch->list[pBatch->numValues].value = value;
+            pBatch->numValues++;
+        }
+        errorCode = pBatch->errorCode;
+    }
+
+    return errorCode;
+}
+
+// Send the remainder of a batch and apply it.
+int32_t uGnssCfgValBatchExecute(uGnssCfgValBatch_t *pBatch)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssCfgValTransaction_t transaction = U_GNSS_CFG_VAL_TRANSACTION_EXECUTE;
+
+    if (pBatch != NULL) {
+        errorCode = pBatch->errorCode;
+        if (errorCode == 0) {
+            if (pBatch->numMessages == 0) {
+                // Everything fitted into one message, no need
+                // for a transaction at all
+                transaction = U_GNSS_CFG_VAL_TRANSACTION_NONE;
+            }
+            if ((pBatch->numValues > 0) || (pBatch->numMessages > 0)) {
+                errorCode = uGnssCfgValSetList(pBatch->gnssHandle,
+                                               pBatch->list,
+                                               pBatch->numValues,
+                                               transaction,
+                                               pBatch->layers);
+            }
+        }
+        pBatch->numMessages = 0;
+        pBatch->numValues = 0;
+        pBatch->errorCode = errorCode;
+    }
+
+    return errorCode;
+}
+
 // Delete a configuration item.
 int32_t uGnssCfgValDel(uDeviceHandle_t gnssHandle, uint32_t keyId,
                        uGnssCfgValTransaction_t transaction,
@@ -1258,4 +1580,170 @@ int32_t uGnssCfgValDelListX(uDeviceHandle_t gnssHandle,
     return errorCode;
 }
 
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: KEY INFORMATION AND TYPE-CHECKED VALGET/VALSET
+ * -------------------------------------------------------------- */
+
+// Get the information for a key ID.
+const uGnssCfgValKeyInfo_t *pUGnssCfgValKeyInfo(uint32_t keyId)
+{
+    const uGnssCfgValKeyInfo_t *pKeyInfo = NULL;
+    size_t lower = 0;
+    size_t upper = gUGnssCfgValKeyInfoNum;
+    size_t x;
+
+    // The table is sorted by key ID so a binary search will do
+    while ((pKeyInfo == NULL) && (lower < upper)) {
+        x = lower + ((upper - lower) / 2);
+        if (gUGnssCfgValKeyInfo[x].keyId < keyId) {
+            lower = x + 1;
+        } else if (gUGnssCfgValKeyInfo[x].keyId > keyId) {
+            upper = x;
+        } else {
+            pKeyInfo = &(gUGnssCfgValKeyInfo[x]);
+        }
+    }
+
+    return pKeyInfo;
+}
+
+// Get the information for a key from its name.
+const uGnssCfgValKeyInfo_t *pUGnssCfgValKeyInfoFromName(const char *pName)
+{
+    const uGnssCfgValKeyInfo_t *pKeyInfo = NULL;
+
+    if (pName != NULL) {
+        if (strncmp(pName, "CFG-", 4) == 0) {
+            pName += 4;
+        }
+        for (size_t x = 0; (pKeyInfo == NULL) && (x < gUGnssCfgValKeyInfoNum); x++) {
+            if (strcmp(gUGnssCfgValKeyInfo[x].pName, pName) == 0) {
+                pKeyInfo = &(gUGnssCfgValKeyInfo[x]);
+            }
+        }
+    }
+
+    return pKeyInfo;
+}
+
+// Get an integer value, checking the key ID.
+int32_t uGnssCfgValGetInt(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                          int64_t *pValue, uGnssCfgValLayer_t layer)
+{
+    int32_t errorCodeOrBits;
+    uGnssCfgValKeyType_t type = U_GNSS_CFG_VAL_KEY_TYPE_L;
+    uGnssCfgVal_t *pList = NULL;
+    int32_t bits;
+
+    errorCodeOrBits = keyInfoCheck(keyId, false, &type);
+    if ((errorCodeOrBits > 0) && (pValue == NULL)) {
+        errorCodeOrBits = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+    if (errorCodeOrBits > 0) {
+        bits = errorCodeOrBits;
+        errorCodeOrBits = uGnssCfgValGetAlloc(gnssHandle, keyId, &pList, layer);
+        if (errorCodeOrBits == 0) {
+            errorCodeOrBits = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+        } else if (errorCodeOrBits > 0) {
+            errorCodeOrBits = (int32_t) U_ERROR_COMMON_SUCCESS;
+            // Sign-extend if required
+            if ((type == U_GNSS_CFG_VAL_KEY_TYPE_I) && (bits < 64) &&
+                ((pList->value & (1ULL << (bits - 1))) != 0)) {
+                pList->value |= ~((1ULL << bits) - 1);
+            }
+            *pValue = (int64_t) pList->value;
+        }
+        uPortFree(pList);
+    }
+
+    return errorCodeOrBits;
+}
+
+// Set an integer value, checking the key ID and the value.
+int32_t uGnssCfgValSetInt(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                          int64_t value, uGnssCfgValTransaction_t transaction,
+                          uint32_t layers)
+{
+    int32_t errorCodeOrBits;
+    uGnssCfgValKeyType_t type = U_GNSS_CFG_VAL_KEY_TYPE_L;
+
+    errorCodeOrBits = keyInfoCheck(keyId, false, &type);
+    if (errorCodeOrBits > 0) {
+        if (intFits(type, errorCodeOrBits, value)) {
+            if (errorCodeOrBits < 64) {
+                value &= (int64_t) ((1ULL << errorCodeOrBits) - 1);
+            }
+            errorCodeOrBits = uGnssCfgValSet(gnssHandle, keyId, (uint64_t) value,
+                                             transaction, layers);
+        } else {
+            errorCodeOrBits = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        }
+    }
+
+    return errorCodeOrBits;
+}
+
+// Get a floating point value, checking the key ID.
+int32_t uGnssCfgValGetFloat(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                            double *pValue, uGnssCfgValLayer_t layer)
+{
+    int32_t errorCodeOrBits;
+    uGnssCfgValKeyType_t type = U_GNSS_CFG_VAL_KEY_TYPE_R;
+    uGnssCfgVal_t *pList = NULL;
+    int32_t bits;
+    uint32_t rawFloat;
+    float valueFloat;
+
+    errorCodeOrBits = keyInfoCheck(keyId, true, &type);
+    if ((errorCodeOrBits > 0) && (pValue == NULL)) {
+        errorCodeOrBits = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+    if (errorCodeOrBits > 0) {
+        bits = errorCodeOrBits;
+        errorCodeOrBits = uGnssCfgValGetAlloc(gnssHandle, keyId, &pList, layer);
+        if (errorCodeOrBits == 0) {
+            errorCodeOrBits = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+        } else if (errorCodeOrBits > 0) {
+            errorCodeOrBits = (int32_t) U_ERROR_COMMON_SUCCESS;
+            if (bits == 32) {
+                rawFloat = (uint32_t) pList->value;
+                memcpy(&valueFloat, &rawFloat, sizeof(valueFloat));
+                *pValue = valueFloat;
+            } else {
+                memcpy(pValue, &(pList->value), sizeof(*pValue));
+            }
+        }
+        uPortFree(pList);
+    }
+
+    return errorCodeOrBits;
+}
+
+// Set a floating point value, checking the key ID.
+int32_t uGnssCfgValSetFloat(uDeviceHandle_t gnssHandle, uint32_t keyId,
+                            double value, uGnssCfgValTransaction_t transaction,
+                            uint32_t layers)
+{
+    int32_t errorCodeOrBits;
+    uGnssCfgValKeyType_t type = U_GNSS_CFG_VAL_KEY_TYPE_R;
+    uint64_t rawValue = 0;
+    uint32_t rawFloat;
+    float valueFloat;
+
+    errorCodeOrBits = keyInfoCheck(keyId, true, &type);
+    if (errorCodeOrBits > 0) {
+        if (errorCodeOrBits == 32) {
+            valueFloat = (float) value;
+            memcpy(&rawFloat, &valueFloat, sizeof(rawFloat));
+            rawValue = rawFloat;
+        } else {
+            memcpy(&rawValue, &value, sizeof(rawValue));
+        }
+        errorCodeOrBits = uGnssCfgValSet(gnssHandle, keyId, rawValue,
+                                         transaction, layers);
+    }
+
+    return errorCodeOrBits;
+}
+
 // End of file
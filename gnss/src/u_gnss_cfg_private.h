@@ -33,6 +33,19 @@
 extern "C" {
 #endif
 
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The key information table, sorted by key ID, written by the
+ * u_gnss_cfg_val_key.py script into u_gnss_cfg_val_key_table.c.
+ */
+extern const uGnssCfgValKeyInfo_t gUGnssCfgValKeyInfo[];
+
+/** The number of entries in gUGnssCfgValKeyInfo[].
+ */
+extern const size_t gUGnssCfgValKeyInfoNum;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -158,6 +171,37 @@ int32_t uGnssCfgPrivateValDelList(uGnssPrivateInstance_t *pInstance,
                                   uGnssCfgValTransaction_t transaction,
                                   uint32_t layers);
 
+/** Populate the configuration shadow of a GNSS instance, see
+ * uGnssPrivateCfgShadowEntry_t, by reading the given key IDs from
+ * each of the #U_GNSS_CFG_LAYERS_SET layers with UBX-CFG-VALGET;
+ * only values that are the same in all of those layers are kept.
+ * Any existing contents of the shadow are discarded.  Once populated,
+ * uGnssCfgPrivateValSetList() will not send values that are already
+ * set and keeps the shadow up to date; uGnssCfgPrivateValDelList()
+ * empties it.  Only applicable to M9 modules and beyond.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot be NULL.
+ * @param[in] pKeyIdList a pointer to an array of key IDs to read;
+ *                       cannot be NULL.  Wild-cards may be included
+ *                       in any of the entries in the list.
+ * @param numKeyIds      the number of items in the array pointed-to
+ *                       by pKeyIdList.
+ * @return               on success the number of values now in the
+ *                       shadow, else negative error code.
+ */
+int32_t uGnssCfgPrivateShadowFill(uGnssPrivateInstance_t *pInstance,
+                                  const uint32_t *pKeyIdList,
+                                  size_t numKeyIds);
+
+/** Empty the configuration shadow of a GNSS instance; this should
+ * be called whenever the configuration of the GNSS chip might have
+ * changed without the knowledge of this code, e.g. because it has
+ * been reset or powered off.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot be NULL.
+ */
+void uGnssCfgPrivateShadowClear(uGnssPrivateInstance_t *pInstance);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1028 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* NOTE TO MAINTAINERS: this file is written in its entirety by the
+ * u_gnss_cfg_val_key.py Python script from the enumerations in
+ * u_gnss_cfg_val_key.h: do NOT edit it, edit the enumerations and
+ * run the script instead.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief The table of key information for the VALSET/VALGET/VALDEL
+ * API, sorted by key ID; this is only linked into an application
+ * that calls one of the functions in u_gnss_cfg.h which use it,
+ * e.g. pUGnssCfgValKeyInfo().
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_port_os.h"
+
+#include "u_at_client.h"
+
+#include "u_gnss_module_type.h"
+#include "u_gnss_type.h"
+#include "u_gnss_private.h"
+#include "u_gnss_cfg_val_key.h"
+#include "u_gnss_cfg.h"
+#include "u_gnss_cfg_private.h"
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The key information table, sorted by key ID.
+ */
+const uGnssCfgValKeyInfo_t gUGnssCfgValKeyInfo[] = {
+    {0x10050007, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-TP1_ENA"},
+    {0x10050008, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-SYNC_GNSS_TP1"},
+    {0x10050009, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-USE_LOCKED_TP1"},
+    {0x1005000a, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-ALIGN_TO_TOW_TP1"},
+    {0x1005000b, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-POL_TP1"},
+    {0x10050012, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-TP2_ENA"},
+    {0x10050013, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-SYNC_GNSS_TP2"},
+    {0x10050014, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-USE_LOCKED_TP2"},
+    {0x10050015, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-ALIGN_TO_TOW_TP2"},
+    {0x10050016, U_GNSS_CFG_VAL_KEY_TYPE_L, "TP-POL_TP2"},
+    {0x1006001d, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFIMU-IMU_EN"},
+    {0x10060027, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFIMU-AUTO_MNTALG_ENA"},
+    {0x10070001, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-COMBINE_TICKS"},
+    {0x10070003, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-USE_SPEED"},
+    {0x10070004, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-DIS_AUTOCOUNTMAX"},
+    {0x10070005, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-DIS_AUTODIRPINPOL"},
+    {0x10070006, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-DIS_AUTOSPEED"},
+    {0x1007000d, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-CNT_BOTH_EDGES"},
+    {0x1007000f, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-USE_WT_PIN"},
+    {0x10070010, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-DIR_PINPOL"},
+    {0x10070011, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFODO-DIS_AUTOSW"},
+    {0x10080001, U_GNSS_CFG_VAL_KEY_TYPE_L, "SFCORE-USE_SF"},
+    {0x10110013, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAVSPG-INIFIX3D"},
+    {0x10110019, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAVSPG-USE_PPP"},
+    {0x10110025, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAVSPG-ACKAIDING"},
+    {0x10110061, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAVSPG-USRDAT"},
+    {0x101100d7, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAVSPG-PL_ENA"},
+    {0x10170001, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAV2-OUT_ENABLED"},
+    {0x10170002, U_GNSS_CFG_VAL_KEY_TYPE_L, "NAV2-SBAS_USE_INTEGRITY"},
+    {0x10220001, U_GNSS_CFG_VAL_KEY_TYPE_L, "ODO-USE_ODO"},
+    {0x10220002, U_GNSS_CFG_VAL_KEY_TYPE_L, "ODO-USE_COG"},
+    {0x10220003, U_GNSS_CFG_VAL_KEY_TYPE_L, "ODO-OUTLPVEL"},
+    {0x10220004, U_GNSS_CFG_VAL_KEY_TYPE_L, "ODO-OUTLPCOG"},
+    {0x10230001, U_GNSS_CFG_VAL_KEY_TYPE_L, "ANA-USE_ANA"},
+    {0x10240012, U_GNSS_CFG_VAL_KEY_TYPE_L, "GEOFENCE-USE_PIO"},
+    {0x10240020, U_GNSS_CFG_VAL_KEY_TYPE_L, "GEOFENCE-USE_FENCE1"},
+    {0x10240030, U_GNSS_CFG_VAL_KEY_TYPE_L, "GEOFENCE-USE_FENCE2"},
+    {0x10240040, U_GNSS_CFG_VAL_KEY_TYPE_L, "GEOFENCE-USE_FENCE3"},
+    {0x10240050, U_GNSS_CFG_VAL_KEY_TYPE_L, "GEOFENCE-USE_FENCE4"},
+    {0x10260013, U_GNSS_CFG_VAL_KEY_TYPE_L, "BATCH-ENABLE"},
+    {0x10260014, U_GNSS_CFG_VAL_KEY_TYPE_L, "BATCH-PIOENABLE"},
+    {0x10260018, U_GNSS_CFG_VAL_KEY_TYPE_L, "BATCH-PIOACTIVELOW"},
+    {0x1026001a, U_GNSS_CFG_VAL_KEY_TYPE_L, "BATCH-EXTRAPVT"},
+    {0x1026001b, U_GNSS_CFG_VAL_KEY_TYPE_L, "BATCH-EXTRAODO"},
+    {0x10310001, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GPS_L1CA_ENA"},
+    {0x10310003, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GPS_L2C_ENA"},
+    {0x10310005, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-SBAS_L1CA_ENA"},
+    {0x10310007, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GAL_E1_ENA"},
+    {0x1031000a, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GAL_E5B_ENA"},
+    {0x1031000d, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-BDS_B1_ENA"},
+    {0x1031000e, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-BDS_B2_ENA"},
+    {0x10310012, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-QZSS_L1CA_ENA"},
+    {0x10310014, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-QZSS_L1S_ENA"},
+    {0x10310015, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-QZSS_L2C_ENA"},
+    {0x10310018, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GLO_L1_ENA"},
+    {0x1031001a, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GLO_L2_ENA"},
+    {0x1031001f, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GPS_ENA"},
+    {0x10310020, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-SBAS_ENA"},
+    {0x10310021, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GAL_ENA"},
+    {0x10310022, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-BDS_ENA"},
+    {0x10310024, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-QZSS_ENA"},
+    {0x10310025, U_GNSS_CFG_VAL_KEY_TYPE_L, "SIGNAL-GLO_ENA"},
+    {0x10340014, U_GNSS_CFG_VAL_KEY_TYPE_L, "BDS-USE_GEO_PRN"},
+    {0x10360002, U_GNSS_CFG_VAL_KEY_TYPE_L, "SBAS-USE_TESTMODE"},
+    {0x10360003, U_GNSS_CFG_VAL_KEY_TYPE_L, "SBAS-USE_RANGING"},
+    {0x10360004, U_GNSS_CFG_VAL_KEY_TYPE_L, "SBAS-USE_DIFFCORR"},
+    {0x10360005, U_GNSS_CFG_VAL_KEY_TYPE_L, "SBAS-USE_INTEGRITY"},
+    {0x10370005, U_GNSS_CFG_VAL_KEY_TYPE_L, "QZSS-USE_SLAS_DGNSS"},
+    {0x10370006, U_GNSS_CFG_VAL_KEY_TYPE_L, "QZSS-USE_SLAS_TESTMODE"},
+    {0x10370007, U_GNSS_CFG_VAL_KEY_TYPE_L, "QZSS-USE_SLAS_RAIM_UNCORR"},
+    {0x1041000d, U_GNSS_CFG_VAL_KEY_TYPE_L, "ITFM-ENABLE"},
+    {0x10410013, U_GNSS_CFG_VAL_KEY_TYPE_L, "ITFM-ENABLE_AUX"},
+    {0x10510002, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2C-EXTENDEDTIMEOUT"},
+    {0x10510003, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2C-ENABLED"},
+    {0x10520005, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1-ENABLED"},
+    {0x10530005, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2-ENABLED"},
+    {0x10640002, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPI-CPOLARITY"},
+    {0x10640003, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPI-CPHASE"},
+    {0x10640005, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPI-EXTENDEDTIMEOUT"},
+    {0x10640006, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPI-ENABLED"},
+    {0x10650001, U_GNSS_CFG_VAL_KEY_TYPE_L, "USB-ENABLED"},
+    {0x10650002, U_GNSS_CFG_VAL_KEY_TYPE_L, "USB-SELFPOW"},
+    {0x10710001, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2CINPROT-UBX"},
+    {0x10710002, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2CINPROT-NMEA"},
+    {0x10710004, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2CINPROT-RTCM3X"},
+    {0x10710005, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2CINPROT-SPARTN"},
+    {0x10720001, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2COUTPROT-UBX"},
+    {0x10720002, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2COUTPROT-NMEA"},
+    {0x10720004, U_GNSS_CFG_VAL_KEY_TYPE_L, "I2COUTPROT-RTCM3X"},
+    {0x10730001, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1INPROT-UBX"},
+    {0x10730002, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1INPROT-NMEA"},
+    {0x10730004, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1INPROT-RTCM3X"},
+    {0x10730005, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1INPROT-SPARTN"},
+    {0x10740001, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1OUTPROT-UBX"},
+    {0x10740002, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1OUTPROT-NMEA"},
+    {0x10740004, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART1OUTPROT-RTCM3X"},
+    {0x10750001, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2INPROT-UBX"},
+    {0x10750002, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2INPROT-NMEA"},
+    {0x10750004, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2INPROT-RTCM3X"},
+    {0x10750005, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2INPROT-SPARTN"},
+    {0x10760001, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2OUTPROT-UBX"},
+    {0x10760002, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2OUTPROT-NMEA"},
+    {0x10760004, U_GNSS_CFG_VAL_KEY_TYPE_L, "UART2OUTPROT-RTCM3X"},
+    {0x10770001, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBINPROT-UBX"},
+    {0x10770002, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBINPROT-NMEA"},
+    {0x10770004, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBINPROT-RTCM3X"},
+    {0x10770005, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBINPROT-SPARTN"},
+    {0x10780001, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBOUTPROT-UBX"},
+    {0x10780002, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBOUTPROT-NMEA"},
+    {0x10780004, U_GNSS_CFG_VAL_KEY_TYPE_L, "USBOUTPROT-RTCM3X"},
+    {0x10790001, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIINPROT-UBX"},
+    {0x10790002, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIINPROT-NMEA"},
+    {0x10790004, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIINPROT-RTCM3X"},
+    {0x10790005, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIINPROT-SPARTN"},
+    {0x107a0001, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIOUTPROT-UBX"},
+    {0x107a0002, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIOUTPROT-NMEA"},
+    {0x107a0004, U_GNSS_CFG_VAL_KEY_TYPE_L, "SPIOUTPROT-RTCM3X"},
+    {0x10930003, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-COMPAT"},
+    {0x10930004, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-CONSIDER"},
+    {0x10930005, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-LIMIT82"},
+    {0x10930006, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-HIGHPREC"},
+    {0x10930011, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-FILT_GPS"},
+    {0x10930012, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-FILT_SBAS"},
+    {0x10930013, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-FILT_GAL"},
+    {0x10930015, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-FILT_QZSS"},
+    {0x10930016, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-FILT_GLO"},
+    {0x10930017, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-FILT_BDS"},
+    {0x10930021, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-OUT_INVFIX"},
+    {0x10930022, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-OUT_MSKFIX"},
+    {0x10930023, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-OUT_INVTIME"},
+    {0x10930024, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-OUT_INVDATE"},
+    {0x10930025, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-OUT_ONLYGPS"},
+    {0x10930026, U_GNSS_CFG_VAL_KEY_TYPE_L, "NMEA-OUT_FROZENCOG"},
+    {0x10a20001, U_GNSS_CFG_VAL_KEY_TYPE_L, "TXREADY-ENABLED"},
+    {0x10a20002, U_GNSS_CFG_VAL_KEY_TYPE_L, "TXREADY-POLARITY"},
+    {0x10a3002e, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_VOLTCTRL"},
+    {0x10a3002f, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_SHORTDET"},
+    {0x10a30030, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_SHORTDET_POL"},
+    {0x10a30031, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_OPENDET"},
+    {0x10a30032, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_OPENDET_POL"},
+    {0x10a30033, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_PWRDOWN"},
+    {0x10a30034, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_PWRDOWN_POL"},
+    {0x10a30035, U_GNSS_CFG_VAL_KEY_TYPE_L, "HW-ANT_CFG_RECOVER"},
+    {0x10b10014, U_GNSS_CFG_VAL_KEY_TYPE_L, "PMP-USE_DESCRAMBLER"},
+    {0x10b10016, U_GNSS_CFG_VAL_KEY_TYPE_L, "PMP-USE_SERVICE_ID"},
+    {0x10b10019, U_GNSS_CFG_VAL_KEY_TYPE_L, "PMP-USE_PRESCRAMBLING"},
+    {0x10c70001, U_GNSS_CFG_VAL_KEY_TYPE_L, "RINV-DUMP"},
+    {0x10c70002, U_GNSS_CFG_VAL_KEY_TYPE_L, "RINV-BINARY"},
+    {0x10d00008, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-DONOTENTEROFF"},
+    {0x10d00009, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-WAITTIMEFIX"},
+    {0x10d0000a, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-UPDATEEPH"},
+    {0x10d0000c, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-EXTINTWAKE"},
+    {0x10d0000d, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-EXTINTBACKUP"},
+    {0x10d0000e, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-EXTINTINACTIVE"},
+    {0x10d00010, U_GNSS_CFG_VAL_KEY_TYPE_L, "PM-LIMITPEAKCURR"},
+    {0x10de0002, U_GNSS_CFG_VAL_KEY_TYPE_L, "LOGFILTER-RECORD_ENA"},
+    {0x10de0003, U_GNSS_CFG_VAL_KEY_TYPE_L, "LOGFILTER-ONCE_PER_WAKE_UP_ENA"},
+    {0x10de0004, U_GNSS_CFG_VAL_KEY_TYPE_L, "LOGFILTER-APPLY_ALL_FILTERS"},
+    {0x10f60009, U_GNSS_CFG_VAL_KEY_TYPE_L, "SEC-CFG_LOCK"},
+    {0x20030001, U_GNSS_CFG_VAL_KEY_TYPE_E, "TMODE-MODE"},
+    {0x20030002, U_GNSS_CFG_VAL_KEY_TYPE_E, "TMODE-POS_TYPE"},
+    {0x20030006, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-ECEF_X_HP"},
+    {0x20030007, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-ECEF_Y_HP"},
+    {0x20030008, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-ECEF_Z_HP"},
+    {0x2003000c, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-LAT_HP"},
+    {0x2003000d, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-LON_HP"},
+    {0x2003000e, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-HEIGHT_HP"},
+    {0x2005000c, U_GNSS_CFG_VAL_KEY_TYPE_E, "TP-TIMEGRID_TP1"},
+    {0x20050017, U_GNSS_CFG_VAL_KEY_TYPE_E, "TP-TIMEGRID_TP2"},
+    {0x20050023, U_GNSS_CFG_VAL_KEY_TYPE_E, "TP-PULSE_DEF"},
+    {0x20050030, U_GNSS_CFG_VAL_KEY_TYPE_E, "TP-PULSE_LENGTH_DEF"},
+    {0x20050035, U_GNSS_CFG_VAL_KEY_TYPE_E, "TP-DRSTR_TP1"},
+    {0x20050036, U_GNSS_CFG_VAL_KEY_TYPE_E, "TP-DRSTR_TP2"},
+    {0x20060008, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-GYRO_RMSTHDL"},
+    {0x20060009, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-GYRO_FREQUENCY"},
+    {0x20060015, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-ACCEL_RMSTHDL"},
+    {0x20060016, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-ACCEL_FREQUENCY"},
+    {0x2006001e, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-IMU_I2C_SCL_PIO"},
+    {0x2006001f, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-IMU_I2C_SDA_PIO"},
+    {0x2007000b, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFODO-FREQUENCY"},
+    {0x20090009, U_GNSS_CFG_VAL_KEY_TYPE_E, "RTCM-DF003_IN_FILTER"},
+    {0x20110011, U_GNSS_CFG_VAL_KEY_TYPE_E, "NAVSPG-FIXMODE"},
+    {0x2011001c, U_GNSS_CFG_VAL_KEY_TYPE_E, "NAVSPG-UTCSTANDARD"},
+    {0x20110021, U_GNSS_CFG_VAL_KEY_TYPE_E, "NAVSPG-DYNMODEL"},
+    {0x201100a1, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-INFIL_MINSVS"},
+    {0x201100a2, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-INFIL_MAXSVS"},
+    {0x201100a3, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-INFIL_MINCNO"},
+    {0x201100a4, U_GNSS_CFG_VAL_KEY_TYPE_I, "NAVSPG-INFIL_MINELEV"},
+    {0x201100aa, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-INFIL_NCNOTHRS"},
+    {0x201100ab, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-INFIL_CNOTHRS"},
+    {0x201100c4, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-CONSTR_DGNSSTO"},
+    {0x201100d6, U_GNSS_CFG_VAL_KEY_TYPE_E, "NAVSPG-SIGATTCOMP"},
+    {0x20140011, U_GNSS_CFG_VAL_KEY_TYPE_E, "NAVHPG-DGNSSMODE"},
+    {0x20210003, U_GNSS_CFG_VAL_KEY_TYPE_E, "RATE-TIMEREF"},
+    {0x20220005, U_GNSS_CFG_VAL_KEY_TYPE_E, "ODO-PROFILE"},
+    {0x20220021, U_GNSS_CFG_VAL_KEY_TYPE_U, "ODO-COGMAXSPEED"},
+    {0x20220022, U_GNSS_CFG_VAL_KEY_TYPE_U, "ODO-COGMAXPOSACC"},
+    {0x20220031, U_GNSS_CFG_VAL_KEY_TYPE_U, "ODO-VELLPGAIN"},
+    {0x20220032, U_GNSS_CFG_VAL_KEY_TYPE_U, "ODO-COGLPGAIN"},
+    {0x20240011, U_GNSS_CFG_VAL_KEY_TYPE_E, "GEOFENCE-CONFLVL"},
+    {0x20240013, U_GNSS_CFG_VAL_KEY_TYPE_E, "GEOFENCE-PINPOL"},
+    {0x20240014, U_GNSS_CFG_VAL_KEY_TYPE_U, "GEOFENCE-PIN"},
+    {0x20250038, U_GNSS_CFG_VAL_KEY_TYPE_U, "MOT-GNSSSPEED_THRS"},
+    {0x20260019, U_GNSS_CFG_VAL_KEY_TYPE_U, "BATCH-PIOID"},
+    {0x20370020, U_GNSS_CFG_VAL_KEY_TYPE_I, "QZSS-L6_SVIDA"},
+    {0x20370030, U_GNSS_CFG_VAL_KEY_TYPE_I, "QZSS-L6_SVIDB"},
+    {0x20370050, U_GNSS_CFG_VAL_KEY_TYPE_E, "QZSS-L6_MSGA"},
+    {0x20370060, U_GNSS_CFG_VAL_KEY_TYPE_E, "QZSS-L6_MSGB"},
+    {0x20370080, U_GNSS_CFG_VAL_KEY_TYPE_E, "QZSS-L6_RSDECODER"},
+    {0x20410001, U_GNSS_CFG_VAL_KEY_TYPE_U, "ITFM-BBTHRESHOLD"},
+    {0x20410002, U_GNSS_CFG_VAL_KEY_TYPE_U, "ITFM-CWTHRESHOLD"},
+    {0x20410010, U_GNSS_CFG_VAL_KEY_TYPE_E, "ITFM-ANTSETTING"},
+    {0x20510001, U_GNSS_CFG_VAL_KEY_TYPE_U, "I2C-ADDRESS"},
+    {0x20520002, U_GNSS_CFG_VAL_KEY_TYPE_E, "UART1-STOPBITS"},
+    {0x20520003, U_GNSS_CFG_VAL_KEY_TYPE_E, "UART1-DATABITS"},
+    {0x20520004, U_GNSS_CFG_VAL_KEY_TYPE_E, "UART1-PARITY"},
+    {0x20530002, U_GNSS_CFG_VAL_KEY_TYPE_E, "UART2-STOPBITS"},
+    {0x20530003, U_GNSS_CFG_VAL_KEY_TYPE_E, "UART2-DATABITS"},
+    {0x20530004, U_GNSS_CFG_VAL_KEY_TYPE_E, "UART2-PARITY"},
+    {0x20640001, U_GNSS_CFG_VAL_KEY_TYPE_U, "SPI-MAXFF"},
+    {0x20910006, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PVT_I2C"},
+    {0x20910007, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PVT_UART1"},
+    {0x20910008, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PVT_UART2"},
+    {0x20910009, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PVT_USB"},
+    {0x2091000a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PVT_SPI"},
+    {0x20910010, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ORB_I2C"},
+    {0x20910011, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ORB_UART1"},
+    {0x20910012, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ORB_UART2"},
+    {0x20910013, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ORB_USB"},
+    {0x20910014, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ORB_SPI"},
+    {0x20910015, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SAT_I2C"},
+    {0x20910016, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SAT_UART1"},
+    {0x20910017, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SAT_UART2"},
+    {0x20910018, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SAT_USB"},
+    {0x20910019, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SAT_SPI"},
+    {0x2091001a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_STATUS_I2C"},
+    {0x2091001b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_STATUS_UART1"},
+    {0x2091001c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_STATUS_UART2"},
+    {0x2091001d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_STATUS_USB"},
+    {0x2091001e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_STATUS_SPI"},
+    {0x20910024, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSECEF_I2C"},
+    {0x20910025, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSECEF_UART1"},
+    {0x20910026, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSECEF_UART2"},
+    {0x20910027, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSECEF_USB"},
+    {0x20910028, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSECEF_SPI"},
+    {0x20910029, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSLLH_I2C"},
+    {0x2091002a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSLLH_UART1"},
+    {0x2091002b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSLLH_UART2"},
+    {0x2091002c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSLLH_USB"},
+    {0x2091002d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_POSLLH_SPI"},
+    {0x2091002e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSECEF_I2C"},
+    {0x2091002f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSECEF_UART1"},
+    {0x20910030, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSECEF_UART2"},
+    {0x20910031, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSECEF_USB"},
+    {0x20910032, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSECEF_SPI"},
+    {0x20910033, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSLLH_I2C"},
+    {0x20910034, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSLLH_UART1"},
+    {0x20910035, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSLLH_UART2"},
+    {0x20910036, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSLLH_USB"},
+    {0x20910037, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_HPPOSLLH_SPI"},
+    {0x20910038, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_DOP_I2C"},
+    {0x20910039, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_DOP_UART1"},
+    {0x2091003a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_DOP_UART2"},
+    {0x2091003b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_DOP_USB"},
+    {0x2091003c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_DOP_SPI"},
+    {0x2091003d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELECEF_I2C"},
+    {0x2091003e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELECEF_UART1"},
+    {0x2091003f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELECEF_UART2"},
+    {0x20910040, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELECEF_USB"},
+    {0x20910041, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELECEF_SPI"},
+    {0x20910042, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELNED_I2C"},
+    {0x20910043, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELNED_UART1"},
+    {0x20910044, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELNED_UART2"},
+    {0x20910045, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELNED_USB"},
+    {0x20910046, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_VELNED_SPI"},
+    {0x20910047, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGPS_I2C"},
+    {0x20910048, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGPS_UART1"},
+    {0x20910049, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGPS_UART2"},
+    {0x2091004a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGPS_USB"},
+    {0x2091004b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGPS_SPI"},
+    {0x2091004c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGLO_I2C"},
+    {0x2091004d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGLO_UART1"},
+    {0x2091004e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGLO_UART2"},
+    {0x2091004f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGLO_USB"},
+    {0x20910050, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGLO_SPI"},
+    {0x20910051, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEBDS_I2C"},
+    {0x20910052, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEBDS_UART1"},
+    {0x20910053, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEBDS_UART2"},
+    {0x20910054, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEBDS_USB"},
+    {0x20910055, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEBDS_SPI"},
+    {0x20910056, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGAL_I2C"},
+    {0x20910057, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGAL_UART1"},
+    {0x20910058, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGAL_UART2"},
+    {0x20910059, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGAL_USB"},
+    {0x2091005a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEGAL_SPI"},
+    {0x2091005b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEUTC_I2C"},
+    {0x2091005c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEUTC_UART1"},
+    {0x2091005d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEUTC_UART2"},
+    {0x2091005e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEUTC_USB"},
+    {0x2091005f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEUTC_SPI"},
+    {0x20910060, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMELS_I2C"},
+    {0x20910061, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMELS_UART1"},
+    {0x20910062, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMELS_UART2"},
+    {0x20910063, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMELS_USB"},
+    {0x20910064, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMELS_SPI"},
+    {0x20910065, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_CLOCK_I2C"},
+    {0x20910066, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_CLOCK_UART1"},
+    {0x20910067, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_CLOCK_UART2"},
+    {0x20910068, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_CLOCK_USB"},
+    {0x20910069, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_CLOCK_SPI"},
+    {0x2091006a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SBAS_I2C"},
+    {0x2091006b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SBAS_UART1"},
+    {0x2091006c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SBAS_UART2"},
+    {0x2091006d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SBAS_USB"},
+    {0x2091006e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SBAS_SPI"},
+    {0x20910079, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_AOPSTATUS_I2C"},
+    {0x2091007a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_AOPSTATUS_UART1"},
+    {0x2091007b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_AOPSTATUS_UART2"},
+    {0x2091007c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_AOPSTATUS_USB"},
+    {0x2091007d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_AOPSTATUS_SPI"},
+    {0x2091007e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ODO_I2C"},
+    {0x2091007f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ODO_UART1"},
+    {0x20910080, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ODO_UART2"},
+    {0x20910081, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ODO_USB"},
+    {0x20910082, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_ODO_SPI"},
+    {0x20910083, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_COV_I2C"},
+    {0x20910084, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_COV_UART1"},
+    {0x20910085, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_COV_UART2"},
+    {0x20910086, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_COV_USB"},
+    {0x20910087, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_COV_SPI"},
+    {0x20910088, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SVIN_I2C"},
+    {0x20910089, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SVIN_UART1"},
+    {0x2091008a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SVIN_UART2"},
+    {0x2091008b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SVIN_USB"},
+    {0x2091008c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SVIN_SPI"},
+    {0x2091008d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_RELPOSNED_I2C"},
+    {0x2091008e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_RELPOSNED_UART1"},
+    {0x2091008f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_RELPOSNED_UART2"},
+    {0x20910090, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_RELPOSNED_USB"},
+    {0x20910091, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_RELPOSNED_SPI"},
+    {0x20910092, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_VRFY_I2C"},
+    {0x20910093, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_VRFY_UART1"},
+    {0x20910094, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_VRFY_UART2"},
+    {0x20910095, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_VRFY_USB"},
+    {0x20910096, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_VRFY_SPI"},
+    {0x209100a1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_GEOFENCE_I2C"},
+    {0x209100a2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_GEOFENCE_UART1"},
+    {0x209100a3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_GEOFENCE_UART2"},
+    {0x209100a4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_GEOFENCE_USB"},
+    {0x209100a5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_GEOFENCE_SPI"},
+    {0x209100a6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_DTM_I2C"},
+    {0x209100a7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_DTM_UART1"},
+    {0x209100a8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_DTM_UART2"},
+    {0x209100a9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_DTM_USB"},
+    {0x209100aa, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_DTM_SPI"},
+    {0x209100ab, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RMC_I2C"},
+    {0x209100ac, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RMC_UART1"},
+    {0x209100ad, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RMC_UART2"},
+    {0x209100ae, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RMC_USB"},
+    {0x209100af, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RMC_SPI"},
+    {0x209100b0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VTG_I2C"},
+    {0x209100b1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VTG_UART1"},
+    {0x209100b2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VTG_UART2"},
+    {0x209100b3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VTG_USB"},
+    {0x209100b4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VTG_SPI"},
+    {0x209100b5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GNS_I2C"},
+    {0x209100b6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GNS_UART1"},
+    {0x209100b7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GNS_UART2"},
+    {0x209100b8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GNS_USB"},
+    {0x209100b9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GNS_SPI"},
+    {0x209100ba, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GGA_I2C"},
+    {0x209100bb, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GGA_UART1"},
+    {0x209100bc, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GGA_UART2"},
+    {0x209100bd, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GGA_USB"},
+    {0x209100be, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GGA_SPI"},
+    {0x209100bf, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSA_I2C"},
+    {0x209100c0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSA_UART1"},
+    {0x209100c1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSA_UART2"},
+    {0x209100c2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSA_USB"},
+    {0x209100c3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSA_SPI"},
+    {0x209100c4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSV_I2C"},
+    {0x209100c5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSV_UART1"},
+    {0x209100c6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSV_UART2"},
+    {0x209100c7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSV_USB"},
+    {0x209100c8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GSV_SPI"},
+    {0x209100c9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GLL_I2C"},
+    {0x209100ca, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GLL_UART1"},
+    {0x209100cb, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GLL_UART2"},
+    {0x209100cc, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GLL_USB"},
+    {0x209100cd, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GLL_SPI"},
+    {0x209100ce, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GRS_I2C"},
+    {0x209100cf, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GRS_UART1"},
+    {0x209100d0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GRS_UART2"},
+    {0x209100d1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GRS_USB"},
+    {0x209100d2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GRS_SPI"},
+    {0x209100d3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GST_I2C"},
+    {0x209100d4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GST_UART1"},
+    {0x209100d5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GST_UART2"},
+    {0x209100d6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GST_USB"},
+    {0x209100d7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GST_SPI"},
+    {0x209100d8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_ZDA_I2C"},
+    {0x209100d9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_ZDA_UART1"},
+    {0x209100da, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_ZDA_UART2"},
+    {0x209100db, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_ZDA_USB"},
+    {0x209100dc, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_ZDA_SPI"},
+    {0x209100dd, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GBS_I2C"},
+    {0x209100de, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GBS_UART1"},
+    {0x209100df, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GBS_UART2"},
+    {0x209100e0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GBS_USB"},
+    {0x209100e1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_GBS_SPI"},
+    {0x209100e7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VLW_I2C"},
+    {0x209100e8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VLW_UART1"},
+    {0x209100e9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VLW_UART2"},
+    {0x209100ea, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VLW_USB"},
+    {0x209100eb, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_VLW_SPI"},
+    {0x209100ec, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYP_I2C"},
+    {0x209100ed, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYP_UART1"},
+    {0x209100ee, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYP_UART2"},
+    {0x209100ef, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYP_USB"},
+    {0x209100f0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYP_SPI"},
+    {0x209100f1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYS_I2C"},
+    {0x209100f2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYS_UART1"},
+    {0x209100f3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYS_UART2"},
+    {0x209100f4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYS_USB"},
+    {0x209100f5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYS_SPI"},
+    {0x209100f6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYT_I2C"},
+    {0x209100f7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYT_UART1"},
+    {0x209100f8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYT_UART2"},
+    {0x209100f9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYT_USB"},
+    {0x209100fa, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-PUBX_ID_POLYT_SPI"},
+    {0x20910105, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_STATUS_I2C"},
+    {0x20910106, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_STATUS_UART1"},
+    {0x20910107, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_STATUS_UART2"},
+    {0x20910108, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_STATUS_USB"},
+    {0x20910109, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_STATUS_SPI"},
+    {0x2091010f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_ALG_I2C"},
+    {0x20910110, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_ALG_UART1"},
+    {0x20910111, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_ALG_UART2"},
+    {0x20910112, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_ALG_USB"},
+    {0x20910113, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_ALG_SPI"},
+    {0x20910114, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_INS_I2C"},
+    {0x20910115, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_INS_UART1"},
+    {0x20910116, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_INS_UART2"},
+    {0x20910117, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_INS_USB"},
+    {0x20910118, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_INS_SPI"},
+    {0x2091015f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_EOE_I2C"},
+    {0x20910160, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_EOE_UART1"},
+    {0x20910161, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_EOE_UART2"},
+    {0x20910162, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_EOE_USB"},
+    {0x20910163, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_EOE_SPI"},
+    {0x20910178, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TM2_I2C"},
+    {0x20910179, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TM2_UART1"},
+    {0x2091017a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TM2_UART2"},
+    {0x2091017b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TM2_USB"},
+    {0x2091017c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TM2_SPI"},
+    {0x2091017d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TP_I2C"},
+    {0x2091017e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TP_UART1"},
+    {0x2091017f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TP_UART2"},
+    {0x20910180, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TP_USB"},
+    {0x20910181, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_TIM_TP_SPI"},
+    {0x20910187, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXR_I2C"},
+    {0x20910188, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXR_UART1"},
+    {0x20910189, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXR_UART2"},
+    {0x2091018a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXR_USB"},
+    {0x2091018b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXR_SPI"},
+    {0x20910196, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_MSGPP_I2C"},
+    {0x20910197, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_MSGPP_UART1"},
+    {0x20910198, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_MSGPP_UART2"},
+    {0x20910199, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_MSGPP_USB"},
+    {0x2091019a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_MSGPP_SPI"},
+    {0x2091019b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_TXBUF_I2C"},
+    {0x2091019c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_TXBUF_UART1"},
+    {0x2091019d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_TXBUF_UART2"},
+    {0x2091019e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_TXBUF_USB"},
+    {0x2091019f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_TXBUF_SPI"},
+    {0x209101a0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXBUF_I2C"},
+    {0x209101a1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXBUF_UART1"},
+    {0x209101a2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXBUF_UART2"},
+    {0x209101a3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXBUF_USB"},
+    {0x209101a4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RXBUF_SPI"},
+    {0x209101a5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_IO_I2C"},
+    {0x209101a6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_IO_UART1"},
+    {0x209101a7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_IO_UART2"},
+    {0x209101a8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_IO_USB"},
+    {0x209101a9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_IO_SPI"},
+    {0x209101b4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW_I2C"},
+    {0x209101b5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW_UART1"},
+    {0x209101b6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW_UART2"},
+    {0x209101b7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW_USB"},
+    {0x209101b8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW_SPI"},
+    {0x209101b9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW2_I2C"},
+    {0x209101ba, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW2_UART1"},
+    {0x209101bb, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW2_UART2"},
+    {0x209101bc, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW2_USB"},
+    {0x209101bd, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW2_SPI"},
+    {0x20910204, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_MEASX_I2C"},
+    {0x20910205, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_MEASX_UART1"},
+    {0x20910206, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_MEASX_UART2"},
+    {0x20910207, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_MEASX_USB"},
+    {0x20910208, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_MEASX_SPI"},
+    {0x20910231, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SFRBX_I2C"},
+    {0x20910232, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SFRBX_UART1"},
+    {0x20910233, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SFRBX_UART2"},
+    {0x20910234, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SFRBX_USB"},
+    {0x20910235, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SFRBX_SPI"},
+    {0x20910259, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_LOG_INFO_I2C"},
+    {0x2091025a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_LOG_INFO_UART1"},
+    {0x2091025b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_LOG_INFO_UART2"},
+    {0x2091025c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_LOG_INFO_USB"},
+    {0x2091025d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_LOG_INFO_SPI"},
+    {0x2091025e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RLM_I2C"},
+    {0x2091025f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RLM_UART1"},
+    {0x20910260, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RLM_UART2"},
+    {0x20910261, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RLM_USB"},
+    {0x20910262, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RLM_SPI"},
+    {0x20910268, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RTCM_I2C"},
+    {0x20910269, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RTCM_UART1"},
+    {0x2091026a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RTCM_UART2"},
+    {0x2091026b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RTCM_USB"},
+    {0x2091026c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RTCM_SPI"},
+    {0x20910277, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_MEAS_I2C"},
+    {0x20910278, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_MEAS_UART1"},
+    {0x20910279, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_MEAS_UART2"},
+    {0x2091027a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_MEAS_USB"},
+    {0x2091027b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_MEAS_SPI"},
+    {0x2091029f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_RAW_I2C"},
+    {0x209102a0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_RAW_UART1"},
+    {0x209102a1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_RAW_UART2"},
+    {0x209102a2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_RAW_USB"},
+    {0x209102a3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_ESF_RAW_SPI"},
+    {0x209102a4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RAWX_I2C"},
+    {0x209102a5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RAWX_UART1"},
+    {0x209102a6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RAWX_UART2"},
+    {0x209102a7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RAWX_USB"},
+    {0x209102a8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_RAWX_SPI"},
+    {0x209102bd, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1005_I2C"},
+    {0x209102be, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1005_UART1"},
+    {0x209102bf, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1005_UART2"},
+    {0x209102c0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1005_USB"},
+    {0x209102c1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1005_SPI"},
+    {0x209102cc, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1077_I2C"},
+    {0x209102cd, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1077_UART1"},
+    {0x209102ce, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1077_UART2"},
+    {0x209102cf, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1077_USB"},
+    {0x209102d0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1077_SPI"},
+    {0x209102d1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1087_I2C"},
+    {0x209102d2, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1087_UART1"},
+    {0x209102d3, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1087_UART2"},
+    {0x209102d4, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1087_USB"},
+    {0x209102d5, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1087_SPI"},
+    {0x209102d6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1127_I2C"},
+    {0x209102d7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1127_UART1"},
+    {0x209102d8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1127_UART2"},
+    {0x209102d9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1127_USB"},
+    {0x209102da, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1127_SPI"},
+    {0x209102fe, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE4072_0_I2C"},
+    {0x209102ff, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE4072_0_UART1"},
+    {0x20910300, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE4072_0_UART2"},
+    {0x20910302, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE4072_0_SPI"},
+    {0x20910303, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1230_I2C"},
+    {0x20910304, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1230_UART1"},
+    {0x20910305, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1230_UART2"},
+    {0x20910306, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1230_USB"},
+    {0x20910307, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1230_SPI"},
+    {0x20910318, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1097_I2C"},
+    {0x20910319, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1097_UART1"},
+    {0x2091031a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1097_UART2"},
+    {0x2091031b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1097_USB"},
+    {0x2091031c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1097_SPI"},
+    {0x2091031d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_PMP_I2C"},
+    {0x2091031e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_PMP_UART1"},
+    {0x2091031f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_PMP_UART2"},
+    {0x20910320, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_PMP_USB"},
+    {0x20910321, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_PMP_SPI"},
+    {0x20910336, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SLAS_I2C"},
+    {0x20910337, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SLAS_UART1"},
+    {0x20910338, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SLAS_UART2"},
+    {0x20910339, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SLAS_USB"},
+    {0x2091033a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SLAS_SPI"},
+    {0x2091033b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_QZSSL6_UART1"},
+    {0x2091033c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_QZSSL6_UART2"},
+    {0x2091033d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_QZSSL6_USB"},
+    {0x2091033e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_QZSSL6_SPI"},
+    {0x2091033f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_QZSSL6_I2C"},
+    {0x20910345, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SIG_I2C"},
+    {0x20910346, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SIG_UART1"},
+    {0x20910347, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SIG_UART2"},
+    {0x20910348, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SIG_USB"},
+    {0x20910349, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_SIG_SPI"},
+    {0x2091034f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_COMMS_I2C"},
+    {0x20910350, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_COMMS_UART1"},
+    {0x20910351, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_COMMS_UART2"},
+    {0x20910352, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_COMMS_USB"},
+    {0x20910353, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_COMMS_SPI"},
+    {0x20910354, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW3_I2C"},
+    {0x20910355, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW3_UART1"},
+    {0x20910356, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW3_UART2"},
+    {0x20910357, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW3_USB"},
+    {0x20910358, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_HW3_SPI"},
+    {0x20910359, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RF_I2C"},
+    {0x2091035a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RF_UART1"},
+    {0x2091035b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RF_UART2"},
+    {0x2091035c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RF_USB"},
+    {0x2091035d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_RF_SPI"},
+    {0x2091035e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1074_I2C"},
+    {0x2091035f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1074_UART1"},
+    {0x20910360, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1074_UART2"},
+    {0x20910361, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1074_USB"},
+    {0x20910362, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1074_SPI"},
+    {0x20910363, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1084_I2C"},
+    {0x20910364, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1084_UART1"},
+    {0x20910365, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1084_UART2"},
+    {0x20910366, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1084_USB"},
+    {0x20910367, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1084_SPI"},
+    {0x20910368, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1094_I2C"},
+    {0x20910369, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1094_UART1"},
+    {0x2091036a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1094_UART2"},
+    {0x2091036b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1094_USB"},
+    {0x2091036c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1094_SPI"},
+    {0x2091036d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1124_I2C"},
+    {0x2091036e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1124_UART1"},
+    {0x2091036f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1124_UART2"},
+    {0x20910370, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1124_USB"},
+    {0x20910371, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-RTCM_3X_TYPE1124_SPI"},
+    {0x20910386, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEQZSS_I2C"},
+    {0x20910387, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEQZSS_UART1"},
+    {0x20910388, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEQZSS_UART2"},
+    {0x20910389, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEQZSS_USB"},
+    {0x2091038a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_TIMEQZSS_SPI"},
+    {0x2091038b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SPAN_I2C"},
+    {0x2091038c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SPAN_UART1"},
+    {0x2091038d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SPAN_UART2"},
+    {0x2091038e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SPAN_USB"},
+    {0x2091038f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SPAN_SPI"},
+    {0x20910400, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RLM_I2C"},
+    {0x20910401, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RLM_UART1"},
+    {0x20910402, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RLM_UART2"},
+    {0x20910403, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RLM_USB"},
+    {0x20910404, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_ID_RLM_SPI"},
+    {0x20910415, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PL_I2C"},
+    {0x20910416, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PL_UART1"},
+    {0x20910417, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PL_UART2"},
+    {0x20910418, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PL_USB"},
+    {0x20910419, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV_PL_SPI"},
+    {0x20910430, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_CLOCK_I2C"},
+    {0x20910431, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_CLOCK_UART1"},
+    {0x20910432, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_CLOCK_UART2"},
+    {0x20910433, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_CLOCK_USB"},
+    {0x20910434, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_CLOCK_SPI"},
+    {0x20910435, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_COV_I2C"},
+    {0x20910436, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_COV_UART1"},
+    {0x20910437, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_COV_UART2"},
+    {0x20910438, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_COV_USB"},
+    {0x20910439, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_COV_SPI"},
+    {0x20910465, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_DOP_I2C"},
+    {0x20910466, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_DOP_UART1"},
+    {0x20910467, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_DOP_UART2"},
+    {0x20910468, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_DOP_USB"},
+    {0x20910469, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_DOP_SPI"},
+    {0x20910475, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_ODO_I2C"},
+    {0x20910476, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_ODO_UART1"},
+    {0x20910477, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_ODO_UART2"},
+    {0x20910478, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_ODO_USB"},
+    {0x20910479, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_ODO_SPI"},
+    {0x20910480, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSECEF_I2C"},
+    {0x20910481, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSECEF_UART1"},
+    {0x20910482, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSECEF_UART2"},
+    {0x20910483, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSECEF_USB"},
+    {0x20910484, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSECEF_SPI"},
+    {0x20910485, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSLLH_I2C"},
+    {0x20910486, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSLLH_UART1"},
+    {0x20910487, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSLLH_UART2"},
+    {0x20910488, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSLLH_USB"},
+    {0x20910489, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_POSLLH_SPI"},
+    {0x20910490, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_PVT_I2C"},
+    {0x20910491, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_PVT_UART1"},
+    {0x20910492, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_PVT_UART2"},
+    {0x20910493, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_PVT_USB"},
+    {0x20910494, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_PVT_SPI"},
+    {0x20910495, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SAT_I2C"},
+    {0x20910496, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SAT_UART1"},
+    {0x20910497, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SAT_UART2"},
+    {0x20910498, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SAT_USB"},
+    {0x20910499, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SAT_SPI"},
+    {0x20910500, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SBAS_I2C"},
+    {0x20910501, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SBAS_UART1"},
+    {0x20910502, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SBAS_UART2"},
+    {0x20910503, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SBAS_USB"},
+    {0x20910504, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SBAS_SPI"},
+    {0x20910505, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SIG_I2C"},
+    {0x20910506, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SIG_UART1"},
+    {0x20910507, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SIG_UART2"},
+    {0x20910508, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SIG_USB"},
+    {0x20910509, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SIG_SPI"},
+    {0x20910510, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SLAS_I2C"},
+    {0x20910511, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SLAS_UART1"},
+    {0x20910512, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SLAS_UART2"},
+    {0x20910513, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SLAS_USB"},
+    {0x20910514, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SLAS_SPI"},
+    {0x20910515, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_STATUS_I2C"},
+    {0x20910516, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_STATUS_UART1"},
+    {0x20910517, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_STATUS_UART2"},
+    {0x20910518, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_STATUS_USB"},
+    {0x20910519, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_STATUS_SPI"},
+    {0x20910520, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SVIN_I2C"},
+    {0x20910521, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SVIN_UART1"},
+    {0x20910522, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SVIN_UART2"},
+    {0x20910523, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SVIN_USB"},
+    {0x20910524, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_SVIN_SPI"},
+    {0x20910525, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEBDS_I2C"},
+    {0x20910526, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEBDS_UART1"},
+    {0x20910527, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEBDS_UART2"},
+    {0x20910528, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEBDS_USB"},
+    {0x20910529, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEBDS_SPI"},
+    {0x20910530, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGAL_I2C"},
+    {0x20910531, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGAL_UART1"},
+    {0x20910532, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGAL_UART2"},
+    {0x20910533, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGAL_USB"},
+    {0x20910534, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGAL_SPI"},
+    {0x20910535, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGLO_I2C"},
+    {0x20910536, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGLO_UART1"},
+    {0x20910537, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGLO_UART2"},
+    {0x20910538, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGLO_USB"},
+    {0x20910539, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGLO_SPI"},
+    {0x20910540, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGPS_I2C"},
+    {0x20910541, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGPS_UART1"},
+    {0x20910542, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGPS_UART2"},
+    {0x20910543, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGPS_USB"},
+    {0x20910544, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEGPS_SPI"},
+    {0x20910545, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMELS_I2C"},
+    {0x20910546, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMELS_UART1"},
+    {0x20910547, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMELS_UART2"},
+    {0x20910548, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMELS_USB"},
+    {0x20910549, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMELS_SPI"},
+    {0x20910550, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEUTC_I2C"},
+    {0x20910551, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEUTC_UART1"},
+    {0x20910552, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEUTC_UART2"},
+    {0x20910553, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEUTC_USB"},
+    {0x20910554, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEUTC_SPI"},
+    {0x20910555, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELECEF_I2C"},
+    {0x20910556, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELECEF_UART1"},
+    {0x20910557, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELECEF_UART2"},
+    {0x20910558, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELECEF_USB"},
+    {0x20910559, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELECEF_SPI"},
+    {0x20910560, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELNED_I2C"},
+    {0x20910561, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELNED_UART1"},
+    {0x20910562, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELNED_UART2"},
+    {0x20910563, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELNED_USB"},
+    {0x20910564, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_VELNED_SPI"},
+    {0x20910565, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_EOE_I2C"},
+    {0x20910566, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_EOE_UART1"},
+    {0x20910567, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_EOE_UART2"},
+    {0x20910568, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_EOE_USB"},
+    {0x20910569, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_EOE_SPI"},
+    {0x20910575, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEQZSS_I2C"},
+    {0x20910576, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEQZSS_UART1"},
+    {0x20910577, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEQZSS_UART2"},
+    {0x20910578, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEQZSS_USB"},
+    {0x20910579, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_NAV2_TIMEQZSS_SPI"},
+    {0x20910605, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SPARTN_I2C"},
+    {0x20910606, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SPARTN_UART1"},
+    {0x20910607, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SPARTN_UART2"},
+    {0x20910608, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SPARTN_USB"},
+    {0x20910609, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_SPARTN_SPI"},
+    {0x20910649, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_VTG_UART2"},
+    {0x20910652, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_RMC_I2C"},
+    {0x20910653, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_RMC_UART1"},
+    {0x20910654, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_RMC_UART2"},
+    {0x20910655, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_RMC_USB"},
+    {0x20910656, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_RMC_SPI"},
+    {0x20910657, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_VTG_I2C"},
+    {0x20910658, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_VTG_UART1"},
+    {0x2091065a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_VTG_USB"},
+    {0x2091065b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_VTG_SPI"},
+    {0x2091065c, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GNS_I2C"},
+    {0x2091065d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GNS_UART1"},
+    {0x2091065e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GNS_UART2"},
+    {0x2091065f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GNS_USB"},
+    {0x20910660, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GNS_SPI"},
+    {0x20910661, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GGA_I2C"},
+    {0x20910662, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GGA_UART1"},
+    {0x20910663, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GGA_UART2"},
+    {0x20910664, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GGA_USB"},
+    {0x20910665, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GGA_SPI"},
+    {0x20910666, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GSA_I2C"},
+    {0x20910667, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GSA_UART1"},
+    {0x20910668, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GSA_UART2"},
+    {0x20910669, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GSA_USB"},
+    {0x2091066a, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GSA_SPI"},
+    {0x20910670, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GLL_I2C"},
+    {0x20910671, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GLL_UART1"},
+    {0x20910672, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GLL_UART2"},
+    {0x20910673, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GLL_USB"},
+    {0x20910674, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_GLL_SPI"},
+    {0x2091067f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_ZDA_I2C"},
+    {0x20910680, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_ZDA_UART1"},
+    {0x20910681, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_ZDA_UART2"},
+    {0x20910682, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_ZDA_USB"},
+    {0x20910683, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-NMEA_NAV2_ID_ZDA_SPI"},
+    {0x2091069d, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SYS_I2C"},
+    {0x2091069e, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SYS_UART1"},
+    {0x2091069f, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SYS_UART2"},
+    {0x209106a0, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SYS_USB"},
+    {0x209106a1, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_MON_SYS_SPI"},
+    {0x209106b6, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_COR_I2C"},
+    {0x209106b7, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_COR_UART1"},
+    {0x209106b8, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_COR_UART2"},
+    {0x209106b9, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_COR_USB"},
+    {0x209106ba, U_GNSS_CFG_VAL_KEY_TYPE_U, "MSGOUT-UBX_RXM_COR_SPI"},
+    {0x20920001, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-UBX_I2C"},
+    {0x20920002, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-UBX_UART1"},
+    {0x20920003, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-UBX_UART2"},
+    {0x20920004, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-UBX_USB"},
+    {0x20920005, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-UBX_SPI"},
+    {0x20920006, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-NMEA_I2C"},
+    {0x20920007, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-NMEA_UART1"},
+    {0x20920008, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-NMEA_UART2"},
+    {0x20920009, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-NMEA_USB"},
+    {0x2092000a, U_GNSS_CFG_VAL_KEY_TYPE_X, "INFMSG-NMEA_SPI"},
+    {0x20930001, U_GNSS_CFG_VAL_KEY_TYPE_E, "NMEA-PROTVER"},
+    {0x20930002, U_GNSS_CFG_VAL_KEY_TYPE_E, "NMEA-MAXSVS"},
+    {0x20930007, U_GNSS_CFG_VAL_KEY_TYPE_E, "NMEA-SVNUMBERING"},
+    {0x20930031, U_GNSS_CFG_VAL_KEY_TYPE_E, "NMEA-MAINTALKERID"},
+    {0x20930032, U_GNSS_CFG_VAL_KEY_TYPE_E, "NMEA-GSVTALKERID"},
+    {0x20a20003, U_GNSS_CFG_VAL_KEY_TYPE_U, "TXREADY-PIN"},
+    {0x20a20005, U_GNSS_CFG_VAL_KEY_TYPE_E, "TXREADY-INTERFACE"},
+    {0x20a30036, U_GNSS_CFG_VAL_KEY_TYPE_U, "HW-ANT_SUP_SWITCH_PIN"},
+    {0x20a30037, U_GNSS_CFG_VAL_KEY_TYPE_U, "HW-ANT_SUP_SHORT_PIN"},
+    {0x20a30038, U_GNSS_CFG_VAL_KEY_TYPE_U, "HW-ANT_SUP_OPEN_PIN"},
+    {0x20a30054, U_GNSS_CFG_VAL_KEY_TYPE_E, "HW-ANT_SUP_ENGINE"},
+    {0x20a30055, U_GNSS_CFG_VAL_KEY_TYPE_U, "HW-ANT_SUP_SHORT_THR"},
+    {0x20a30056, U_GNSS_CFG_VAL_KEY_TYPE_U, "HW-ANT_SUP_OPEN_THR"},
+    {0x20a30057, U_GNSS_CFG_VAL_KEY_TYPE_E, "HW-RF_LNA_MODE"},
+    {0x20a70001, U_GNSS_CFG_VAL_KEY_TYPE_E, "SPARTN-USE_SOURCE"},
+    {0x20c70003, U_GNSS_CFG_VAL_KEY_TYPE_U, "RINV-DATA_SIZE"},
+    {0x20d00001, U_GNSS_CFG_VAL_KEY_TYPE_E, "PM-OPERATEMODE"},
+    {0x20d00006, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-MINACQTIME"},
+    {0x20d00007, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-MAXACQTIME"},
+    {0x20d0000b, U_GNSS_CFG_VAL_KEY_TYPE_E, "PM-EXTINTSEL"},
+    {0x30050001, U_GNSS_CFG_VAL_KEY_TYPE_I, "TP-ANT_CABLEDELAY"},
+    {0x30060007, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-GYRO_TC_UPDATE_PERIOD"},
+    {0x3006000a, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-GYRO_LATENCY"},
+    {0x3006000b, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-GYRO_ACCURACY"},
+    {0x30060017, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-ACCEL_LATENCY"},
+    {0x30060018, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-ACCEL_ACCURACY"},
+    {0x3006002e, U_GNSS_CFG_VAL_KEY_TYPE_I, "SFIMU-IMU_MNTALG_PITCH"},
+    {0x3006002f, U_GNSS_CFG_VAL_KEY_TYPE_I, "SFIMU-IMU_MNTALG_ROLL"},
+    {0x3007000a, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFODO-LATENCY"},
+    {0x3007000e, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFODO-SPEED_BAND"},
+    {0x30090001, U_GNSS_CFG_VAL_KEY_TYPE_U, "RTCM-DF003_OUT"},
+    {0x30090008, U_GNSS_CFG_VAL_KEY_TYPE_U, "RTCM-DF003_IN"},
+    {0x30110017, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-WKNROLLOVER"},
+    {0x301100b1, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-OUTFIL_PDOP"},
+    {0x301100b2, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-OUTFIL_TDOP"},
+    {0x301100b3, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-OUTFIL_PACC"},
+    {0x301100b4, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-OUTFIL_TACC"},
+    {0x301100b5, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-OUTFIL_FACC"},
+    {0x30210001, U_GNSS_CFG_VAL_KEY_TYPE_U, "RATE-MEAS"},
+    {0x30210002, U_GNSS_CFG_VAL_KEY_TYPE_U, "RATE-NAV"},
+    {0x30230002, U_GNSS_CFG_VAL_KEY_TYPE_U, "ANA-ORBMAXERR"},
+    {0x3025003b, U_GNSS_CFG_VAL_KEY_TYPE_U, "MOT-GNSSDIST_THRS"},
+    {0x30260015, U_GNSS_CFG_VAL_KEY_TYPE_U, "BATCH-MAXENTRIES"},
+    {0x30260016, U_GNSS_CFG_VAL_KEY_TYPE_U, "BATCH-WARNTHRS"},
+    {0x30370008, U_GNSS_CFG_VAL_KEY_TYPE_U, "QZSS-SLAS_MAX_BASELINE"},
+    {0x3065000a, U_GNSS_CFG_VAL_KEY_TYPE_U, "USB-VENDOR_ID"},
+    {0x3065000b, U_GNSS_CFG_VAL_KEY_TYPE_U, "USB-PRODUCT_ID"},
+    {0x3065000c, U_GNSS_CFG_VAL_KEY_TYPE_U, "USB-POWER"},
+    {0x30930033, U_GNSS_CFG_VAL_KEY_TYPE_U, "NMEA-BDSTALKERID"},
+    {0x30a20004, U_GNSS_CFG_VAL_KEY_TYPE_U, "TXREADY-THRESHOLD"},
+    {0x30b10012, U_GNSS_CFG_VAL_KEY_TYPE_U, "PMP-SEARCH_WINDOW"},
+    {0x30b10013, U_GNSS_CFG_VAL_KEY_TYPE_E, "PMP-DATA_RATE"},
+    {0x30b10015, U_GNSS_CFG_VAL_KEY_TYPE_U, "PMP-DESCRAMBLER_INIT"},
+    {0x30b10017, U_GNSS_CFG_VAL_KEY_TYPE_U, "PMP-SERVICE_ID"},
+    {0x30d00005, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-ONTIME"},
+    {0x30de0005, U_GNSS_CFG_VAL_KEY_TYPE_U, "LOGFILTER-MIN_INTERVAL"},
+    {0x30de0006, U_GNSS_CFG_VAL_KEY_TYPE_U, "LOGFILTER-TIME_THRS"},
+    {0x30de0007, U_GNSS_CFG_VAL_KEY_TYPE_U, "LOGFILTER-SPEED_THRS"},
+    {0x30f6000a, U_GNSS_CFG_VAL_KEY_TYPE_U, "SEC-CFG_LOCK_UNLOCKGRP1"},
+    {0x30f6000b, U_GNSS_CFG_VAL_KEY_TYPE_U, "SEC-CFG_LOCK_UNLOCKGRP2"},
+    {0x40030003, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-ECEF_X"},
+    {0x40030004, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-ECEF_Y"},
+    {0x40030005, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-ECEF_Z"},
+    {0x40030009, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-LAT"},
+    {0x4003000a, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-LON"},
+    {0x4003000b, U_GNSS_CFG_VAL_KEY_TYPE_I, "TMODE-HEIGHT"},
+    {0x4003000f, U_GNSS_CFG_VAL_KEY_TYPE_U, "TMODE-FIXED_POS_ACC"},
+    {0x40030010, U_GNSS_CFG_VAL_KEY_TYPE_U, "TMODE-SVIN_MIN_DUR"},
+    {0x40030011, U_GNSS_CFG_VAL_KEY_TYPE_U, "TMODE-SVIN_ACC_LIMIT"},
+    {0x40050002, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-PERIOD_TP1"},
+    {0x40050003, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-PERIOD_LOCK_TP1"},
+    {0x40050004, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-LEN_TP1"},
+    {0x40050005, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-LEN_LOCK_TP1"},
+    {0x40050006, U_GNSS_CFG_VAL_KEY_TYPE_I, "TP-USER_DELAY_TP1"},
+    {0x4005000d, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-PERIOD_TP2"},
+    {0x4005000e, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-PERIOD_LOCK_TP2"},
+    {0x4005000f, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-LEN_TP2"},
+    {0x40050010, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-LEN_LOCK_TP2"},
+    {0x40050011, U_GNSS_CFG_VAL_KEY_TYPE_I, "TP-USER_DELAY_TP2"},
+    {0x40050024, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-FREQ_TP1"},
+    {0x40050025, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-FREQ_LOCK_TP1"},
+    {0x40050026, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-FREQ_TP2"},
+    {0x40050027, U_GNSS_CFG_VAL_KEY_TYPE_U, "TP-FREQ_LOCK_TP2"},
+    {0x4006002d, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFIMU-IMU_MNTALG_YAW"},
+    {0x40070007, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFODO-FACTOR"},
+    {0x40070008, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFODO-QUANT_ERROR"},
+    {0x40070009, U_GNSS_CFG_VAL_KEY_TYPE_U, "SFODO-COUNT_MAX"},
+    {0x40110064, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_DX"},
+    {0x40110065, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_DY"},
+    {0x40110066, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_DZ"},
+    {0x40110067, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_ROTX"},
+    {0x40110068, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_ROTY"},
+    {0x40110069, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_ROTZ"},
+    {0x4011006a, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_SCALE"},
+    {0x401100c1, U_GNSS_CFG_VAL_KEY_TYPE_I, "NAVSPG-CONSTR_ALT"},
+    {0x401100c2, U_GNSS_CFG_VAL_KEY_TYPE_U, "NAVSPG-CONSTR_ALTVAR"},
+    {0x40240021, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE1_LAT"},
+    {0x40240022, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE1_LON"},
+    {0x40240023, U_GNSS_CFG_VAL_KEY_TYPE_U, "GEOFENCE-FENCE1_RAD"},
+    {0x40240031, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE2_LAT"},
+    {0x40240032, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE2_LON"},
+    {0x40240033, U_GNSS_CFG_VAL_KEY_TYPE_U, "GEOFENCE-FENCE2_RAD"},
+    {0x40240041, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE3_LAT"},
+    {0x40240042, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE3_LON"},
+    {0x40240043, U_GNSS_CFG_VAL_KEY_TYPE_U, "GEOFENCE-FENCE3_RAD"},
+    {0x40240051, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE4_LAT"},
+    {0x40240052, U_GNSS_CFG_VAL_KEY_TYPE_I, "GEOFENCE-FENCE4_LON"},
+    {0x40240053, U_GNSS_CFG_VAL_KEY_TYPE_U, "GEOFENCE-FENCE4_RAD"},
+    {0x40520001, U_GNSS_CFG_VAL_KEY_TYPE_U, "UART1-BAUDRATE"},
+    {0x40530001, U_GNSS_CFG_VAL_KEY_TYPE_U, "UART2-BAUDRATE"},
+    {0x40b10011, U_GNSS_CFG_VAL_KEY_TYPE_U, "PMP-CENTER_FREQUENCY"},
+    {0x40d00002, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-POSUPDATEPERIOD"},
+    {0x40d00003, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-ACQPERIOD"},
+    {0x40d00004, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-GRIDOFFSET"},
+    {0x40d0000f, U_GNSS_CFG_VAL_KEY_TYPE_U, "PM-EXTINTINACTIVITY"},
+    {0x40de0008, U_GNSS_CFG_VAL_KEY_TYPE_U, "LOGFILTER-POSITION_THRS"},
+    {0x5005002a, U_GNSS_CFG_VAL_KEY_TYPE_R, "TP-DUTY_TP1"},
+    {0x5005002b, U_GNSS_CFG_VAL_KEY_TYPE_R, "TP-DUTY_LOCK_TP1"},
+    {0x5005002c, U_GNSS_CFG_VAL_KEY_TYPE_R, "TP-DUTY_TP2"},
+    {0x5005002d, U_GNSS_CFG_VAL_KEY_TYPE_R, "TP-DUTY_LOCK_TP2"},
+    {0x50110062, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_MAJA"},
+    {0x50110063, U_GNSS_CFG_VAL_KEY_TYPE_R, "NAVSPG-USRDAT_FLAT"},
+    {0x50360006, U_GNSS_CFG_VAL_KEY_TYPE_X, "SBAS-PRNSCANMASK"},
+    {0x5065000d, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-VENDOR_STR0"},
+    {0x5065000e, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-VENDOR_STR1"},
+    {0x5065000f, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-VENDOR_STR2"},
+    {0x50650010, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-VENDOR_STR3"},
+    {0x50650011, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-PRODUCT_STR0"},
+    {0x50650012, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-PRODUCT_STR1"},
+    {0x50650013, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-PRODUCT_STR2"},
+    {0x50650014, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-PRODUCT_STR3"},
+    {0x50650015, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-SERIAL_NO_STR0"},
+    {0x50650016, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-SERIAL_NO_STR1"},
+    {0x50650017, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-SERIAL_NO_STR2"},
+    {0x50650018, U_GNSS_CFG_VAL_KEY_TYPE_X, "USB-SERIAL_NO_STR3"},
+    {0x50b1001a, U_GNSS_CFG_VAL_KEY_TYPE_U, "PMP-UNIQUE_WORD"},
+    {0x50c70004, U_GNSS_CFG_VAL_KEY_TYPE_X, "RINV-CHUNK0"},
+    {0x50c70005, U_GNSS_CFG_VAL_KEY_TYPE_X, "RINV-CHUNK1"},
+    {0x50c70006, U_GNSS_CFG_VAL_KEY_TYPE_X, "RINV-CHUNK2"},
+    {0x50c70007, U_GNSS_CFG_VAL_KEY_TYPE_X, "RINV-CHUNK3"},
+};
+
+/** The number of entries in gUGnssCfgValKeyInfo[].
+ */
+const size_t gUGnssCfgValKeyInfoNum = sizeof(gUGnssCfgValKeyInfo) /
+                                      sizeof(gUGnssCfgValKeyInfo[0]);
+
+// End of file
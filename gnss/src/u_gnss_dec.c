@@ -49,12 +49,13 @@
  *
  * 3. Create the static decode function for the message here,
  * following the naming pattern, e.g. for UBX-XXX-YYY the function
- * would be named ubxXxxYyyAlloc(); the function  must have the
- * function signature of #uGnssDecKnownFunction_t.
+ * would be named ubxXxxYyy(); the function must have the function
+ * signature of #uGnssDecKnownFunction_t and must decode into the
+ * storage it is given, it must NOT allocate memory.
  *
- * 4. Add the static function to the gpFunctionList array and add
- * its message ID to the gIdList array, making sure to put it in the
- * same position in both.
+ * 4. Add the static function, along with the size of its message
+ * structure, to the gKnownList array and add its message ID to the
+ * gIdList array, making sure to put it in the same position in both.
  *
  * 5. If in step (1) you chose to include helper functions, add a
  * .c file in this src directory, of the same name as the .h file,
@@ -108,12 +109,12 @@
  * TYPES
  * -------------------------------------------------------------- */
 
-/** Private version of function that can be hooked into
- * pUGnssDecAlloc() by uGnssDecSetCallback() to decode message types
- * that _are_ known to this code.
+/** Private version of function used by pUGnssDecAlloc() and
+ * uGnssDecDecode() to decode message types that _are_ known to
+ * this code.
  *
  * @param[in] pBuffer             the buffer pointer that was passed to
- *                                pUGnssDecAlloc().
+ *                                pUGnssDecAlloc() or uGnssDecDecode().
  * @param size                    the number of bytes at pBuffer;
  *                                for a known protocol it _might_
  *                                be that any FCS/check-sum bytes
@@ -121,10 +122,10 @@
  *                                by the caller, hence the function
  *                                should not _require_ them to be
  *                                present in the count.
- * @param[out] ppBody             a pointer to a place to put the
- *                                decoded message body, which the
- *                                callback should allocate using
- *                                pUPortMalloc(); will never be NULL.
+ * @param[out] pBody              a pointer to storage for the
+ *                                decoded message body, at least
+ *                                the size of the message structure
+ *                                in length; will never be NULL.
  * @return                        zero on a successful decode, else
  *                                negative error code, preferably
  *                                from the set suggested for the
@@ -132,7 +133,17 @@
  */
 typedef int32_t (uGnssDecKnownFunction_t) (const char *pBuffer,
                                            size_t size,
-                                           uGnssDecUnion_t **ppBody);
+                                           uGnssDecUnion_t *pBody);
+
+/** Structure describing a decoder for a message type that is known
+ * to this code.
+ */
+typedef struct {
+    uGnssDecKnownFunction_t *pFunction; /**< the decode function. */
+    size_t bodySize; /**< the size of the message structure that
+                          pFunction decodes into, the amount
+                          pUGnssDecAlloc() will allocate. */
+} uGnssDecKnown_t;
 
 /* ----------------------------------------------------------------
  * STATIC VARIABLES: MISC
@@ -147,7 +158,7 @@ static uGnssDecFunction_t *gpCallback = NULL;
 static void *gpCallbackParam = NULL;
 
 /** The list of known message IDs; order is important,
- * MUST be in the same order as gpFunctionList (see further
+ * MUST be in the same order as gKnownList (see further
  * down in this file) and both lists must contain the same number
  * of elements.
  */
@@ -159,128 +170,486 @@ static const uGnssMessageId_t gIdList[] = {
     {
         .type = U_GNSS_PROTOCOL_UBX,
         .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_NAV_HPPOSLLH_MESSAGE_CLASS, U_GNSS_DEC_UBX_NAV_HPPOSLLH_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_NAV_SAT_MESSAGE_CLASS, U_GNSS_DEC_UBX_NAV_SAT_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_NAV_SIG_MESSAGE_CLASS, U_GNSS_DEC_UBX_NAV_SIG_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_NAV_COV_MESSAGE_CLASS, U_GNSS_DEC_UBX_NAV_COV_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_NAV_TIMEGPS_MESSAGE_CLASS, U_GNSS_DEC_UBX_NAV_TIMEGPS_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_ESF_INS_MESSAGE_CLASS, U_GNSS_DEC_UBX_ESF_INS_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_RXM_RAWX_MESSAGE_CLASS, U_GNSS_DEC_UBX_RXM_RAWX_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_MON_RF_MESSAGE_CLASS, U_GNSS_DEC_UBX_MON_RF_MESSAGE_ID)
+    },
+    {
+        .type = U_GNSS_PROTOCOL_UBX,
+        .id.ubx = U_GNSS_UBX_MESSAGE(U_GNSS_DEC_UBX_TIM_TP_MESSAGE_CLASS, U_GNSS_DEC_UBX_TIM_TP_MESSAGE_ID)
     }
 };
 
 // MORE STATIC VARIABLES after the message decoders...
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: DECODE HELPERS
+ * -------------------------------------------------------------- */
+
+// Decode a little-endian IEEE 754 single-precision value (R4).
+static float floatDecode(const char *pByte)
+{
+    uint32_t x = uUbxProtocolUint32Decode(pByte);
+    float f;
+
+    memcpy(&f, &x, sizeof(f));
+
+    return f;
+}
+
+// Decode a little-endian IEEE 754 double-precision value (R8).
+static double doubleDecode(const char *pByte)
+{
+    uint64_t x = uUbxProtocolUint64Decode(pByte);
+    double d;
+
+    memcpy(&d, &x, sizeof(d));
+
+    return d;
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: MESSAGE DECODERS
  * -------------------------------------------------------------- */
 
 // Decode a UBX-NAV-PVT message.
-static int32_t ubxNavPvtAlloc(const char *pBuffer, size_t size,
-                              uGnssDecUnion_t **ppBody)
+static int32_t ubxNavPvt(const char *pBuffer, size_t size,
+                         uGnssDecUnion_t *pUnion)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
-    uGnssDecUbxNavPvt_t *pBody;
+    uGnssDecUbxNavPvt_t *pBody = &(pUnion->ubxNavPvt);
 
-    // No need to check pBuffer or ppBody for NULLity,
+    // No need to check pBuffer or pUnion for NULLity,
     // we will never give this function NULL for those.
     if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_PVT_BODY_MIN_LENGTH) {
         // Move past the header so that we can use payload offsets
         // throughout, matching the offsets in the interface manual
         pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
-        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-        pBody = (uGnssDecUbxNavPvt_t *) pUPortMalloc(sizeof(uGnssDecUbxNavPvt_t));
-        if (pBody != NULL) {
+        memset(pBody, 0, sizeof(*pBody));
+        // All good now, unless we hit a field we can't decode,
+        // in which case we _could_ set U_ERROR_COMMON_BAD_DATA,
+        // but, since this message will have been checked for
+        // integrity before it gets here, it is better to trust
+        // that the module emitted stuff correctly: it knows
+        // more about this than we do
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBody->iTOW = (int32_t) uUbxProtocolUint32Decode(pBuffer + 0);
+        pBody->year = uUbxProtocolUint16Decode(pBuffer + 4);
+        pBody->month = (uint8_t) *(pBuffer + 6); // *NOPAD* stop AStyle making * look like a multiply
+        pBody->day = (uint8_t) *(pBuffer + 7); // *NOPAD*
+        pBody->hour = (uint8_t) *(pBuffer + 8); // *NOPAD*
+        pBody->min = (uint8_t) *(pBuffer + 9); // *NOPAD*
+        pBody->sec = (uint8_t) *(pBuffer + 10); // *NOPAD*
+        pBody->valid = (uint8_t) *(pBuffer + 11); // *NOPAD*
+        pBody->tAcc = uUbxProtocolUint32Decode(pBuffer + 12);
+        pBody->nano = (int32_t) uUbxProtocolUint32Decode(pBuffer + 16);
+        pBody->fixType = (uGnssDecUbxNavPvtFixType_t) *(pBuffer + 20); // *NOPAD*
+        pBody->flags = (uint8_t) *(pBuffer + 21); // *NOPAD*
+        pBody->flags2 = (uint8_t) *(pBuffer + 22); // *NOPAD*
+        pBody->numSV = (uint8_t) *(pBuffer + 23); // *NOPAD*
+        pBody->lon = (int32_t) uUbxProtocolUint32Decode(pBuffer + 24);
+        pBody->lat = (int32_t) uUbxProtocolUint32Decode(pBuffer + 28);
+        pBody->height = (int32_t) uUbxProtocolUint32Decode(pBuffer + 32);
+        pBody->hMSL = (int32_t) uUbxProtocolUint32Decode(pBuffer + 36);
+        pBody->hAcc = uUbxProtocolUint32Decode(pBuffer + 40);
+        pBody->vAcc = uUbxProtocolUint32Decode(pBuffer + 44);
+        pBody->velN = (int32_t) uUbxProtocolUint32Decode(pBuffer + 48);
+        pBody->velE = (int32_t) uUbxProtocolUint32Decode(pBuffer + 52);
+        pBody->velD = (int32_t) uUbxProtocolUint32Decode(pBuffer + 56);
+        pBody->gSpeed = (int32_t) uUbxProtocolUint32Decode(pBuffer + 60);
+        pBody->headMot = (int32_t) uUbxProtocolUint32Decode(pBuffer + 64);
+        pBody->sAcc = uUbxProtocolUint32Decode(pBuffer + 68);
+        pBody->headAcc = uUbxProtocolUint32Decode(pBuffer + 72);
+        pBody->pDOP = uUbxProtocolUint16Decode(pBuffer + 76);
+        pBody->flags3 = uUbxProtocolUint16Decode(pBuffer + 78);
+        // 4 reserved bytes here
+        pBody->headVeh = (int32_t) uUbxProtocolUint32Decode(pBuffer + 84);
+        pBody->magDec = (int16_t) uUbxProtocolUint16Decode(pBuffer + 88);
+        pBody->magAcc = (int16_t) uUbxProtocolUint16Decode(pBuffer + 90);
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-NAV-HPPOSLLH message.
+static int32_t ubxNavHpposllh(const char *pBuffer, size_t size,
+                              uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxNavHpposllh_t *pBody = &(pUnion->ubxNavHpposllh);
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_HPPOSLLH_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        memset(pBody, 0, sizeof(*pBody));
+        // All good now, unless we hit a field we can't decode,
+        // in which case we _could_ set U_ERROR_COMMON_BAD_DATA,
+        // but, since this message will have been checked for
+        // integrity before it gets here, it is better to trust
+        // that the module emitted stuff correctly: it knows
+        // more about this than we do
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBody->version = (uint8_t) *(pBuffer + 0); // *NOPAD* stop AStyle making * look like a multiply
+        // 2 reserved bytes here
+        pBody->flags = (uint8_t) *(pBuffer + 3); // *NOPAD*
+        pBody->iTOW = (int32_t) uUbxProtocolUint32Decode(pBuffer + 4);
+        pBody->lon = (int32_t) uUbxProtocolUint32Decode(pBuffer + 8);
+        pBody->lat = (int32_t) uUbxProtocolUint32Decode(pBuffer + 12);
+        pBody->height = (int32_t) uUbxProtocolUint32Decode(pBuffer + 16);
+        pBody->hMSL = (int32_t) uUbxProtocolUint32Decode(pBuffer + 20);
+        pBody->lonHp = (int8_t) *(pBuffer + 24); // *NOPAD*
+        pBody->latHp = (int8_t) *(pBuffer + 25); // *NOPAD*
+        pBody->heightHp = (int8_t) *(pBuffer + 26); // *NOPAD*
+        pBody->hMSLHp = (int8_t) *(pBuffer + 27); // *NOPAD*
+        pBody->hAcc = uUbxProtocolUint32Decode(pBuffer + 28);
+        pBody->vAcc = uUbxProtocolUint32Decode(pBuffer + 32);
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-NAV-SAT message.
+static int32_t ubxNavSat(const char *pBuffer, size_t size,
+                         uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxNavSat_t *pBody = &(pUnion->ubxNavSat);
+    uGnssDecUbxNavSatSv_t *pSv;
+    const char *pBlock;
+    size_t numSvs;
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_SAT_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        numSvs = (uint8_t) *(pBuffer + 5); // *NOPAD*
+        // The repeated blocks must all be present
+        if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_SAT_BODY_MIN_LENGTH +
+            (numSvs * U_GNSS_DEC_UBX_NAV_SAT_BODY_BLOCK_LENGTH)) {
             memset(pBody, 0, sizeof(*pBody));
-            // All good now, unless we hit a field we can't decode,
-            // in which case we _could_ set U_ERROR_COMMON_BAD_DATA,
-            // but, since this message will have been checked for
-            // integrity before it gets here, it is better to trust
-            // that the module emitted stuff correctly: it knows
-            // more about this than we do
             errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-            pBody->iTOW = (int32_t) uUbxProtocolUint32Decode(pBuffer + 0);
-            pBody->year = uUbxProtocolUint16Decode(pBuffer + 4);
-            pBody->month = (uint8_t) *(pBuffer + 6); // *NOPAD* stop AStyle making * look like a multiply
-            pBody->day = (uint8_t) *(pBuffer + 7); // *NOPAD*
-            pBody->hour = (uint8_t) *(pBuffer + 8); // *NOPAD*
-            pBody->min = (uint8_t) *(pBuffer + 9); // *NOPAD*
-            pBody->sec = (uint8_t) *(pBuffer + 10); // *NOPAD*
-            pBody->valid = (uint8_t) *(pBuffer + 11); // *NOPAD*
-            pBody->tAcc = uUbxProtocolUint32Decode(pBuffer + 12);
-            pBody->nano = (int32_t) uUbxProtocolUint32Decode(pBuffer + 16);
-            pBody->fixType = (uGnssDecUbxNavPvtFixType_t) *(pBuffer + 20); // *NOPAD*
-            pBody->flags = (uint8_t) *(pBuffer + 21); // *NOPAD*
-            pBody->flags2 = (uint8_t) *(pBuffer + 22); // *NOPAD*
-            pBody->numSV = (uint8_t) *(pBuffer + 23); // *NOPAD*
-            pBody->lon = (int32_t) uUbxProtocolUint32Decode(pBuffer + 24);
-            pBody->lat = (int32_t) uUbxProtocolUint32Decode(pBuffer + 28);
-            pBody->height = (int32_t) uUbxProtocolUint32Decode(pBuffer + 32);
-            pBody->hMSL = (int32_t) uUbxProtocolUint32Decode(pBuffer + 36);
-            pBody->hAcc = uUbxProtocolUint32Decode(pBuffer + 40);
-            pBody->vAcc = uUbxProtocolUint32Decode(pBuffer + 44);
-            pBody->velN = (int32_t) uUbxProtocolUint32Decode(pBuffer + 48);
-            pBody->velE = (int32_t) uUbxProtocolUint32Decode(pBuffer + 52);
-            pBody->velD = (int32_t) uUbxProtocolUint32Decode(pBuffer + 56);
-            pBody->gSpeed = (int32_t) uUbxProtocolUint32Decode(pBuffer + 60);
-            pBody->headMot = (int32_t) uUbxProtocolUint32Decode(pBuffer + 64);
-            pBody->sAcc = uUbxProtocolUint32Decode(pBuffer + 68);
-            pBody->headAcc = uUbxProtocolUint32Decode(pBuffer + 72);
-            pBody->pDOP = uUbxProtocolUint16Decode(pBuffer + 76);
-            pBody->flags3 = uUbxProtocolUint16Decode(pBuffer + 78);
-            // 4 reserved bytes here
-            pBody->headVeh = (int32_t) uUbxProtocolUint32Decode(pBuffer + 84);
-            pBody->magDec = (int16_t) uUbxProtocolUint16Decode(pBuffer + 88);
-            pBody->magAcc = (int16_t) uUbxProtocolUint16Decode(pBuffer + 90);
-
-            // Populate the pointer that was passed in
-            *ppBody = (uGnssDecUnion_t *) pBody;
+            pBody->iTOW = uUbxProtocolUint32Decode(pBuffer + 0);
+            pBody->version = (uint8_t) *(pBuffer + 4); // *NOPAD*
+            pBody->numSvs = (uint8_t) numSvs;
+            // 2 reserved bytes here
+            pBlock = pBuffer + U_GNSS_DEC_UBX_NAV_SAT_BODY_MIN_LENGTH;
+            for (size_t x = 0; (x < numSvs) && (x < U_GNSS_DEC_UBX_NAV_SAT_MAX_NUM_SVS); x++) {
+                pSv = &(pBody->sv[x]);
+                pSv->gnssId = (uint8_t) *(pBlock + 0); // *NOPAD*
+                pSv->svId = (uint8_t) *(pBlock + 1); // *NOPAD*
+                pSv->cno = (uint8_t) *(pBlock + 2); // *NOPAD*
+                pSv->elev = (int8_t) *(pBlock + 3); // *NOPAD*
+                pSv->azim = (int16_t) uUbxProtocolUint16Decode(pBlock + 4);
+                pSv->prRes = (int16_t) uUbxProtocolUint16Decode(pBlock + 6);
+                pSv->flags = uUbxProtocolUint32Decode(pBlock + 8);
+                pBlock += U_GNSS_DEC_UBX_NAV_SAT_BODY_BLOCK_LENGTH;
+            }
         }
     }
 
     return errorCode;
 }
 
-// Decode a UBX-NAV-HPPOSLLH message.
-static int32_t ubxNavHpposllhAlloc(const char *pBuffer, size_t size,
-                                   uGnssDecUnion_t **ppBody)
+// Decode a UBX-NAV-SIG message.
+static int32_t ubxNavSig(const char *pBuffer, size_t size,
+                         uGnssDecUnion_t *pUnion)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
-    uGnssDecUbxNavHpposllh_t *pBody;
+    uGnssDecUbxNavSig_t *pBody = &(pUnion->ubxNavSig);
+    uGnssDecUbxNavSigSig_t *pSig;
+    const char *pBlock;
+    size_t numSigs;
 
-    // No need to check pBuffer or ppBody for NULLity,
+    // No need to check pBuffer or pUnion for NULLity,
     // we will never give this function NULL for those.
-    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_HPPOSLLH_BODY_MIN_LENGTH) {
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_SIG_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        numSigs = (uint8_t) *(pBuffer + 5); // *NOPAD*
+        // The repeated blocks must all be present
+        if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_SIG_BODY_MIN_LENGTH +
+            (numSigs * U_GNSS_DEC_UBX_NAV_SIG_BODY_BLOCK_LENGTH)) {
+            memset(pBody, 0, sizeof(*pBody));
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            pBody->iTOW = uUbxProtocolUint32Decode(pBuffer + 0);
+            pBody->version = (uint8_t) *(pBuffer + 4); // *NOPAD*
+            pBody->numSigs = (uint8_t) numSigs;
+            // 2 reserved bytes here
+            pBlock = pBuffer + U_GNSS_DEC_UBX_NAV_SIG_BODY_MIN_LENGTH;
+            for (size_t x = 0; (x < numSigs) && (x < U_GNSS_DEC_UBX_NAV_SIG_MAX_NUM_SIGS); x++) {
+                pSig = &(pBody->sig[x]);
+                pSig->gnssId = (uint8_t) *(pBlock + 0); // *NOPAD*
+                pSig->svId = (uint8_t) *(pBlock + 1); // *NOPAD*
+                pSig->sigId = (uint8_t) *(pBlock + 2); // *NOPAD*
+                pSig->freqId = (uint8_t) *(pBlock + 3); // *NOPAD*
+                pSig->prRes = (int16_t) uUbxProtocolUint16Decode(pBlock + 4);
+                pSig->cno = (uint8_t) *(pBlock + 6); // *NOPAD*
+                pSig->qualityInd = (uint8_t) *(pBlock + 7); // *NOPAD*
+                pSig->corrSource = (uint8_t) *(pBlock + 8); // *NOPAD*
+                pSig->ionoModel = (uint8_t) *(pBlock + 9); // *NOPAD*
+                pSig->sigFlags = uUbxProtocolUint16Decode(pBlock + 10);
+                // 4 reserved bytes here
+                pBlock += U_GNSS_DEC_UBX_NAV_SIG_BODY_BLOCK_LENGTH;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-NAV-COV message.
+static int32_t ubxNavCov(const char *pBuffer, size_t size,
+                         uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxNavCov_t *pBody = &(pUnion->ubxNavCov);
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_COV_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        memset(pBody, 0, sizeof(*pBody));
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBody->iTOW = uUbxProtocolUint32Decode(pBuffer + 0);
+        pBody->version = (uint8_t) *(pBuffer + 4); // *NOPAD*
+        pBody->posCovValid = (uint8_t) *(pBuffer + 5); // *NOPAD*
+        pBody->velCovValid = (uint8_t) *(pBuffer + 6); // *NOPAD*
+        // 9 reserved bytes here
+        pBody->posCovNN = floatDecode(pBuffer + 16);
+        pBody->posCovNE = floatDecode(pBuffer + 20);
+        pBody->posCovND = floatDecode(pBuffer + 24);
+        pBody->posCovEE = floatDecode(pBuffer + 28);
+        pBody->posCovED = floatDecode(pBuffer + 32);
+        pBody->posCovDD = floatDecode(pBuffer + 36);
+        pBody->velCovNN = floatDecode(pBuffer + 40);
+        pBody->velCovNE = floatDecode(pBuffer + 44);
+        pBody->velCovND = floatDecode(pBuffer + 48);
+        pBody->velCovEE = floatDecode(pBuffer + 52);
+        pBody->velCovED = floatDecode(pBuffer + 56);
+        pBody->velCovDD = floatDecode(pBuffer + 60);
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-NAV-TIMEGPS message.
+static int32_t ubxNavTimegps(const char *pBuffer, size_t size,
+                             uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxNavTimegps_t *pBody = &(pUnion->ubxNavTimegps);
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_NAV_TIMEGPS_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        memset(pBody, 0, sizeof(*pBody));
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBody->iTOW = uUbxProtocolUint32Decode(pBuffer + 0);
+        pBody->fTOW = (int32_t) uUbxProtocolUint32Decode(pBuffer + 4);
+        pBody->week = (int16_t) uUbxProtocolUint16Decode(pBuffer + 8);
+        pBody->leapS = (int8_t) *(pBuffer + 10); // *NOPAD*
+        pBody->valid = (uint8_t) *(pBuffer + 11); // *NOPAD*
+        pBody->tAcc = uUbxProtocolUint32Decode(pBuffer + 12);
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-ESF-INS message.
+static int32_t ubxEsfIns(const char *pBuffer, size_t size,
+                         uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxEsfIns_t *pBody = &(pUnion->ubxEsfIns);
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_ESF_INS_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        memset(pBody, 0, sizeof(*pBody));
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBody->bitfield0 = uUbxProtocolUint32Decode(pBuffer + 0);
+        // 4 reserved bytes here
+        pBody->iTOW = uUbxProtocolUint32Decode(pBuffer + 8);
+        pBody->xAngRate = (int32_t) uUbxProtocolUint32Decode(pBuffer + 12);
+        pBody->yAngRate = (int32_t) uUbxProtocolUint32Decode(pBuffer + 16);
+        pBody->zAngRate = (int32_t) uUbxProtocolUint32Decode(pBuffer + 20);
+        pBody->xAccel = (int32_t) uUbxProtocolUint32Decode(pBuffer + 24);
+        pBody->yAccel = (int32_t) uUbxProtocolUint32Decode(pBuffer + 28);
+        pBody->zAccel = (int32_t) uUbxProtocolUint32Decode(pBuffer + 32);
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-RXM-RAWX message.
+static int32_t ubxRxmRawx(const char *pBuffer, size_t size,
+                          uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxRxmRawx_t *pBody = &(pUnion->ubxRxmRawx);
+    uGnssDecUbxRxmRawxMeas_t *pMeas;
+    const char *pBlock;
+    size_t numMeas;
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_RXM_RAWX_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        numMeas = (uint8_t) *(pBuffer + 11); // *NOPAD*
+        // The repeated blocks must all be present
+        if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_RXM_RAWX_BODY_MIN_LENGTH +
+            (numMeas * U_GNSS_DEC_UBX_RXM_RAWX_BODY_BLOCK_LENGTH)) {
+            memset(pBody, 0, sizeof(*pBody));
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            pBody->rcvTow = doubleDecode(pBuffer + 0);
+            pBody->week = uUbxProtocolUint16Decode(pBuffer + 8);
+            pBody->leapS = (int8_t) *(pBuffer + 10); // *NOPAD*
+            pBody->numMeas = (uint8_t) numMeas;
+            pBody->recStat = (uint8_t) *(pBuffer + 12); // *NOPAD*
+            pBody->version = (uint8_t) *(pBuffer + 13); // *NOPAD*
+            // 2 reserved bytes here
+            pBlock = pBuffer + U_GNSS_DEC_UBX_RXM_RAWX_BODY_MIN_LENGTH;
+            for (size_t x = 0; (x < numMeas) && (x < U_GNSS_DEC_UBX_RXM_RAWX_MAX_NUM_MEAS); x++) {
+                pMeas = &(pBody->meas[x]);
+                pMeas->prMes = doubleDecode(pBlock + 0);
+                pMeas->cpMes = doubleDecode(pBlock + 8);
+                pMeas->doMes = floatDecode(pBlock + 16);
+                pMeas->gnssId = (uint8_t) *(pBlock + 20); // *NOPAD*
+                pMeas->svId = (uint8_t) *(pBlock + 21); // *NOPAD*
+                pMeas->sigId = (uint8_t) *(pBlock + 22); // *NOPAD*
+                pMeas->freqId = (uint8_t) *(pBlock + 23); // *NOPAD*
+                pMeas->locktime = uUbxProtocolUint16Decode(pBlock + 24);
+                pMeas->cno = (uint8_t) *(pBlock + 26); // *NOPAD*
+                pMeas->prStdev = (uint8_t) *(pBlock + 27); // *NOPAD*
+                pMeas->cpStdev = (uint8_t) *(pBlock + 28); // *NOPAD*
+                pMeas->doStdev = (uint8_t) *(pBlock + 29); // *NOPAD*
+                pMeas->trkStat = (uint8_t) *(pBlock + 30); // *NOPAD*
+                // 1 reserved byte here
+                pBlock += U_GNSS_DEC_UBX_RXM_RAWX_BODY_BLOCK_LENGTH;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Decode a UBX-MON-RF message.
+static int32_t ubxMonRf(const char *pBuffer, size_t size,
+                        uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxMonRf_t *pBody = &(pUnion->ubxMonRf);
+    uGnssDecUbxMonRfBlock_t *pRfBlock;
+    const char *pBlock;
+    size_t nBlocks;
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_MON_RF_BODY_MIN_LENGTH) {
         // Move past the header so that we can use payload offsets
         // throughout, matching the offsets in the interface manual
         pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
-        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-        pBody = (uGnssDecUbxNavHpposllh_t *) pUPortMalloc(sizeof(uGnssDecUbxNavHpposllh_t));
-        if (pBody != NULL) {
+        nBlocks = (uint8_t) *(pBuffer + 1); // *NOPAD*
+        // The repeated blocks must all be present
+        if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_MON_RF_BODY_MIN_LENGTH +
+            (nBlocks * U_GNSS_DEC_UBX_MON_RF_BODY_BLOCK_LENGTH)) {
             memset(pBody, 0, sizeof(*pBody));
-            // All good now, unless we hit a field we can't decode,
-            // in which case we _could_ set U_ERROR_COMMON_BAD_DATA,
-            // but, since this message will have been checked for
-            // integrity before it gets here, it is better to trust
-            // that the module emitted stuff correctly: it knows
-            // more about this than we do
             errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-            pBody->version = (uint8_t) *(pBuffer + 0); // *NOPAD* stop AStyle making * look like a multiply
+            pBody->version = (uint8_t) *(pBuffer + 0); // *NOPAD*
+            pBody->nBlocks = (uint8_t) nBlocks;
             // 2 reserved bytes here
-            pBody->flags = (uint8_t) *(pBuffer + 3); // *NOPAD*
-            pBody->iTOW = (int32_t) uUbxProtocolUint32Decode(pBuffer + 4);
-            pBody->lon = (int32_t) uUbxProtocolUint32Decode(pBuffer + 8);
-            pBody->lat = (int32_t) uUbxProtocolUint32Decode(pBuffer + 12);
-            pBody->height = (int32_t) uUbxProtocolUint32Decode(pBuffer + 16);
-            pBody->hMSL = (int32_t) uUbxProtocolUint32Decode(pBuffer + 20);
-            pBody->lonHp = (int8_t) *(pBuffer + 24); // *NOPAD*
-            pBody->latHp = (int8_t) *(pBuffer + 25); // *NOPAD*
-            pBody->heightHp = (int8_t) *(pBuffer + 26); // *NOPAD*
-            pBody->hMSLHp = (int8_t) *(pBuffer + 27); // *NOPAD*
-            pBody->hAcc = uUbxProtocolUint32Decode(pBuffer + 28);
-            pBody->vAcc = uUbxProtocolUint32Decode(pBuffer + 32);
-
-            // Populate the pointer that was passed in
-            *ppBody = (uGnssDecUnion_t *) pBody;
+            pBlock = pBuffer + U_GNSS_DEC_UBX_MON_RF_BODY_MIN_LENGTH;
+            for (size_t x = 0; (x < nBlocks) && (x < U_GNSS_DEC_UBX_MON_RF_MAX_NUM_BLOCKS); x++) {
+                pRfBlock = &(pBody->block[x]);
+                pRfBlock->blockId = (uint8_t) *(pBlock + 0); // *NOPAD*
+                pRfBlock->flags = (uint8_t) *(pBlock + 1); // *NOPAD*
+                pRfBlock->antStatus = (uint8_t) *(pBlock + 2); // *NOPAD*
+                pRfBlock->antPower = (uint8_t) *(pBlock + 3); // *NOPAD*
+                pRfBlock->postStatus = uUbxProtocolUint32Decode(pBlock + 4);
+                // 4 reserved bytes here
+                pRfBlock->noisePerMS = uUbxProtocolUint16Decode(pBlock + 12);
+                pRfBlock->agcCnt = uUbxProtocolUint16Decode(pBlock + 14);
+                pRfBlock->jamInd = (uint8_t) *(pBlock + 16); // *NOPAD*
+                pRfBlock->ofsI = (int8_t) *(pBlock + 17); // *NOPAD*
+                pRfBlock->magI = (uint8_t) *(pBlock + 18); // *NOPAD*
+                pRfBlock->ofsQ = (int8_t) *(pBlock + 19); // *NOPAD*
+                pRfBlock->magQ = (uint8_t) *(pBlock + 20); // *NOPAD*
+                // 3 reserved bytes here
+                pBlock += U_GNSS_DEC_UBX_MON_RF_BODY_BLOCK_LENGTH;
+            }
         }
     }
 
     return errorCode;
 }
 
+// Decode a UBX-TIM-TP message.
+static int32_t ubxTimTp(const char *pBuffer, size_t size,
+                        uGnssDecUnion_t *pUnion)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+    uGnssDecUbxTimTp_t *pBody = &(pUnion->ubxTimTp);
+
+    // No need to check pBuffer or pUnion for NULLity,
+    // we will never give this function NULL for those.
+    if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES + U_GNSS_DEC_UBX_TIM_TP_BODY_MIN_LENGTH) {
+        // Move past the header so that we can use payload offsets
+        // throughout, matching the offsets in the interface manual
+        pBuffer += U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+        memset(pBody, 0, sizeof(*pBody));
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        pBody->towMS = uUbxProtocolUint32Decode(pBuffer + 0);
+        pBody->towSubMS = uUbxProtocolUint32Decode(pBuffer + 4);
+        pBody->qErr = (int32_t) uUbxProtocolUint32Decode(pBuffer + 8);
+        pBody->week = uUbxProtocolUint16Decode(pBuffer + 12);
+        pBody->flags = (uint8_t) *(pBuffer + 14); // *NOPAD*
+        pBody->refInfo = (uint8_t) *(pBuffer + 15); // *NOPAD*
+    }
+
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES: MESSAGE DECODER LIST
  * -------------------------------------------------------------- */
@@ -289,113 +658,183 @@ static int32_t ubxNavHpposllhAlloc(const char *pBuffer, size_t size,
  * MUST be in the same order as gIdList and both lists
  * must contain the same number of elements.
  */
-static uGnssDecKnownFunction_t *gpFunctionList[] = {
-    ubxNavPvtAlloc,
-    ubxNavHpposllhAlloc
+static const uGnssDecKnown_t gKnownList[] = {
+    {ubxNavPvt, sizeof(uGnssDecUbxNavPvt_t)},
+    {ubxNavHpposllh, sizeof(uGnssDecUbxNavHpposllh_t)},
+    {ubxNavSat, sizeof(uGnssDecUbxNavSat_t)},
+    {ubxNavSig, sizeof(uGnssDecUbxNavSig_t)},
+    {ubxNavCov, sizeof(uGnssDecUbxNavCov_t)},
+    {ubxNavTimegps, sizeof(uGnssDecUbxNavTimegps_t)},
+    {ubxEsfIns, sizeof(uGnssDecUbxEsfIns_t)},
+    {ubxRxmRawx, sizeof(uGnssDecUbxRxmRawx_t)},
+    {ubxMonRf, sizeof(uGnssDecUbxMonRf_t)},
+    {ubxTimTp, sizeof(uGnssDecUbxTimTp_t)}
 };
 
 /* ----------------------------------------------------------------
- * PUBLIC FUNCTIONS
+ * STATIC FUNCTIONS: MISC
  * -------------------------------------------------------------- */
 
-// Decode a message buffer received from a GNSS device.
-uGnssDec_t *pUGnssDecAlloc(const char *pBuffer, size_t size)
+// Determine the protocol type and message ID of the message in
+// pBuffer, making sure that the header is sound; the outcome is
+// written to the errorCode, id and nmea fields of pDec, which
+// must have been zeroed by the caller.
+static void decodeId(const char *pBuffer, size_t size, uGnssDec_t *pDec)
 {
-    uGnssDec_t *pDec = NULL;
     uint8_t *pBufferUint8 = (uint8_t *) pBuffer; // To avoid problems with signed char compares
-    uGnssDecKnownFunction_t *pFunction = NULL;
     size_t x;
     size_t y;
 
-    pDec = (uGnssDec_t *) pUPortMalloc(sizeof(uGnssDec_t));
-    if (pDec != NULL) {
-        memset(pDec, 0, sizeof(*pDec));
-        pDec->errorCode = (int32_t) U_ERROR_COMMON_EMPTY;
-        pDec->id.type = U_GNSS_PROTOCOL_UNKNOWN;
-        if ((pBufferUint8 != NULL) && (size > 0)) {
-            // Determine the protocol type/message ID and make
-            // sure the header is sound
-            pDec->errorCode = (int32_t) U_ERROR_COMMON_UNKNOWN;
-            if ((*pBufferUint8 == 0xB5) && (size >= 1) && (*(pBufferUint8 + 1) == 0x62)) {
-                // Likely a UBX message
+    pDec->errorCode = (int32_t) U_ERROR_COMMON_EMPTY;
+    pDec->id.type = U_GNSS_PROTOCOL_UNKNOWN;
+    if ((pBufferUint8 != NULL) && (size > 0)) {
+        pDec->errorCode = (int32_t) U_ERROR_COMMON_UNKNOWN;
+        if ((*pBufferUint8 == 0xB5) && (size >= 1) && (*(pBufferUint8 + 1) == 0x62)) {
+            // Likely a UBX message
+            pBufferUint8 += 2;
+            pDec->id.type = U_GNSS_PROTOCOL_UBX;
+            pDec->errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+            if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES) {
+                // Grab the message class and message ID, check the length,
+                // allowing the checksum bytes to be omitted
+                pDec->id.id.ubx = U_GNSS_UBX_MESSAGE(*pBufferUint8, *(pBufferUint8 + 1));
                 pBufferUint8 += 2;
-                pDec->id.type = U_GNSS_PROTOCOL_UBX;
-                pDec->errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
-                if (size >= U_UBX_PROTOCOL_HEADER_LENGTH_BYTES) {
-                    // Grab the message class and message ID, check the length,
-                    // allowing the checksum bytes to be omitted
-                    pDec->id.id.ubx = U_GNSS_UBX_MESSAGE(*pBufferUint8, *(pBufferUint8 + 1));
-                    pBufferUint8 += 2;
-                    y = *pBufferUint8 + ((uint16_t) *(pBufferUint8 + 1) << 8); // *NOPAD*
-                    if (size >= y + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES) {
-                        pDec->errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-                    }
-                }
-            } else if (*pBufferUint8 == '$') {
-                // Likely an NMEA message
-                pBufferUint8++;
-                y = size - 1;
-                pDec->id.type = U_GNSS_PROTOCOL_NMEA;
-                pDec->errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
-                for (x = 0; (((*pBufferUint8 >= 'A') && (*pBufferUint8 <= 'Z')) ||
-                             ((*pBufferUint8 >= '0') && (*pBufferUint8 <= '9'))) &&
-                     (x < y) && (x < sizeof(pDec->nmea) - 1); x++) {
-                    // Looking for up to U_GNSS_NMEA_MESSAGE_MATCH_LENGTH_CHARACTERS
-                    // characters in the range 0-9, A-Z, followed by a comma
-                    pDec->nmea[x] = *pBufferUint8;
-                    pBufferUint8++;
-                }
-                if ((x < y) && (*pBufferUint8 == ',')) {
-                    pDec->id.id.pNmea = pDec->nmea;
+                y = *pBufferUint8 + ((uint16_t) *(pBufferUint8 + 1) << 8); // *NOPAD*
+                if (size >= y + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES) {
                     pDec->errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                 }
-                // No need to add a terminator since we zeroed the structure to begin with
-            } else if (*pBufferUint8 == 0xD3) {
-                // Likely an RTCM message
+            }
+        } else if (*pBufferUint8 == '$') {
+            // Likely an NMEA message
+            pBufferUint8++;
+            y = size - 1;
+            pDec->id.type = U_GNSS_PROTOCOL_NMEA;
+            pDec->errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+            for (x = 0; (((*pBufferUint8 >= 'A') && (*pBufferUint8 <= 'Z')) ||
+                         ((*pBufferUint8 >= '0') && (*pBufferUint8 <= '9'))) &&
+                 (x < y) && (x < sizeof(pDec->nmea) - 1); x++) {
+                // Looking for up to U_GNSS_NMEA_MESSAGE_MATCH_LENGTH_CHARACTERS
+                // characters in the range 0-9, A-Z, followed by a comma
+                pDec->nmea[x] = *pBufferUint8;
                 pBufferUint8++;
-                pDec->id.type = U_GNSS_PROTOCOL_RTCM;
-                pDec->errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
-                // Length is only in the first three bits of the first length byte,
-                // the rest must be zero
-                if ((size >= 1 /* D3 */ + 2 /* length */) &&
-                    ((*pBufferUint8 & 0xFC) == 0)) {
-                    y = ((uint16_t) (*pBufferUint8 & 0x03) << 8) + *(pBufferUint8 + 1);
-                    pBufferUint8 += 2;
-                    if (size >= 1 /* D3 */ + 2 /* length */ + 2 /* ID */) {
-                        // Grab the ID from the next two bytes
-                        pDec->id.id.rtcm = (*(pBufferUint8 + 1) >> 4) + (((uint16_t) *pBufferUint8) << 4); // *NOPAD*
-                        if (size >= 1 /* D3 */ + 2 /* length */ + y /* length includes the message ID */ ) {
-                            // Check the length, allowing the CRC bytes to be omitted
-                            pDec->errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-                        }
+            }
+            if ((x < y) && (*pBufferUint8 == ',')) {
+                pDec->id.id.pNmea = pDec->nmea;
+                pDec->errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+            // No need to add a terminator since the structure was zeroed to begin with
+        } else if (*pBufferUint8 == 0xD3) {
+            // Likely an RTCM message
+            pBufferUint8++;
+            pDec->id.type = U_GNSS_PROTOCOL_RTCM;
+            pDec->errorCode = (int32_t) U_ERROR_COMMON_TRUNCATED;
+            // Length is only in the first three bits of the first length byte,
+            // the rest must be zero
+            if ((size >= 1 /* D3 */ + 2 /* length */) &&
+                ((*pBufferUint8 & 0xFC) == 0)) {
+                y = ((uint16_t) (*pBufferUint8 & 0x03) << 8) + *(pBufferUint8 + 1);
+                pBufferUint8 += 2;
+                if (size >= 1 /* D3 */ + 2 /* length */ + 2 /* ID */) {
+                    // Grab the ID from the next two bytes
+                    pDec->id.id.rtcm = (*(pBufferUint8 + 1) >> 4) + (((uint16_t) *pBufferUint8) << 4); // *NOPAD*
+                    if (size >= 1 /* D3 */ + 2 /* length */ + y /* length includes the message ID */ ) {
+                        // Check the length, allowing the CRC bytes to be omitted
+                        pDec->errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                     }
                 }
             }
-            if (pDec->errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
-                // Got a known protocol, an ID and a valid length, see if we have
-                // a decoder for this message ID
-                pDec->errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
-                for (x = 0; (pFunction == NULL) && (x < sizeof(gIdList) / sizeof(gIdList[0])); x++) {
-                    if (uGnssMsgIdIsWanted(&(pDec->id), (uGnssMessageId_t *) & (gIdList[x]))) {
-                        pFunction = gpFunctionList[x];
+        }
+    }
+}
+
+// Find the built-in decoder for a message ID, NULL if there is none.
+static const uGnssDecKnown_t *pKnownFind(const uGnssMessageId_t *pId)
+{
+    const uGnssDecKnown_t *pKnown = NULL;
+
+    for (size_t x = 0; (pKnown == NULL) && (x < sizeof(gIdList) / sizeof(gIdList[0])); x++) {
+        if (uGnssMsgIdIsWanted((uGnssMessageId_t *) pId, (uGnssMessageId_t *) & (gIdList[x]))) {
+            pKnown = &(gKnownList[x]);
+        }
+    }
+
+    return pKnown;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Decode a message buffer received from a GNSS device.
+uGnssDec_t *pUGnssDecAlloc(const char *pBuffer, size_t size)
+{
+    uGnssDec_t *pDec = NULL;
+    const uGnssDecKnown_t *pKnown;
+
+    pDec = (uGnssDec_t *) pUPortMalloc(sizeof(uGnssDec_t));
+    if (pDec != NULL) {
+        memset(pDec, 0, sizeof(*pDec));
+        decodeId(pBuffer, size, pDec);
+        if (pDec->errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            // Got a known protocol, an ID and a valid length, see if we have
+            // a decoder for this message ID
+            pDec->errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            pKnown = pKnownFind(&(pDec->id));
+            if (pKnown != NULL) {
+                // Found a matching decoder, allocate just enough
+                // memory for this message type and run it
+                pDec->errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                pDec->pBody = (uGnssDecUnion_t *) pUPortMalloc(pKnown->bodySize);
+                if (pDec->pBody != NULL) {
+                    pDec->errorCode = pKnown->pFunction(pBuffer, size, pDec->pBody);
+                    if ((pDec->errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) &&
+                        (pDec->errorCode != (int32_t) U_ERROR_COMMON_BAD_DATA)) {
+                        // Nothing worth keeping
+                        uPortFree(pDec->pBody);
+                        pDec->pBody = NULL;
                     }
                 }
-                if (pFunction != NULL) {
-                    // Found a matching decoder, run it
-                    pDec->errorCode = pFunction(pBuffer, size, &(pDec->pBody));
-                }
-            }
-            if ((pDec->errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) &&
-                (gpCallback != NULL)) {
-                // Couldn't decode the message: let the user callback try
-                pDec->errorCode = gpCallback(&(pDec->id), pBuffer, size, &(pDec->pBody), gpCallbackParam);
             }
         }
+        if ((pBuffer != NULL) && (size > 0) && (pDec->pBody == NULL) &&
+            (pDec->errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) &&
+            (gpCallback != NULL)) {
+            // Couldn't decode the message: let the user callback try
+            pDec->errorCode = gpCallback(&(pDec->id), pBuffer, size, &(pDec->pBody), gpCallbackParam);
+        }
     }
 
     return pDec;
 }
 
+// Decode a message buffer received from a GNSS device into storage
+// provided by the caller.
+int32_t uGnssDecDecode(const char *pBuffer, size_t size,
+                       uGnssDec_t *pDec, uGnssDecUnion_t *pBody)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    const uGnssDecKnown_t *pKnown;
+
+    if ((pDec != NULL) && (pBody != NULL)) {
+        memset(pDec, 0, sizeof(*pDec));
+        decodeId(pBuffer, size, pDec);
+        if (pDec->errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            pDec->errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            pKnown = pKnownFind(&(pDec->id));
+            if (pKnown != NULL) {
+                pDec->errorCode = pKnown->pFunction(pBuffer, size, pBody);
+                if ((pDec->errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) ||
+                    (pDec->errorCode == (int32_t) U_ERROR_COMMON_BAD_DATA)) {
+                    pDec->pBody = pBody;
+                }
+            }
+        }
+        errorCode = pDec->errorCode;
+    }
+
+    return errorCode;
+}
+
 // Free the memory returned by pUGnssDecAlloc().
 void uGnssDecFree(uGnssDec_t *pDec)
 {
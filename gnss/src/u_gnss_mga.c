@@ -101,6 +101,32 @@ typedef struct {
     void *pCallbackParam;
 } uGnssMgaReadDeviceDatabase_t;
 
+/** A structure that is passed to databaseBufferReadCallback().
+ */
+typedef struct {
+    const char *pBuffer;
+    size_t size;
+} uGnssMgaDatabaseBuffer_t;
+
+/** A structure that is passed to databaseDeltaCallback().
+ */
+typedef struct {
+    uint32_t *pHashList;
+    size_t hashListLength;
+    size_t index;
+    int32_t numChanged;
+    uGnssMgaDatabaseDeltaCallback_t *pCallback;
+    void *pCallbackParam;
+} uGnssMgaDatabaseDelta_t;
+
+/** A structure that is passed to readOfflineDataCallback().
+ */
+typedef struct {
+    uDeviceHandle_t gnssHandle;
+    uGnssMgaOfflineReadCallback_t *pCallback;
+    void *pCallbackParam;
+} uGnssMgaOfflineRead_t;
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
@@ -172,7 +198,8 @@ static const char gAssistNowBufferStart[] = {0xb5, 0x62, 0x13, 0x40, 0x18, 0x00,
  */
 static const int32_t gInitialBytes[] = {0,           // U_GNSS_MGA_FLOW_CONTROL_SIMPLE
                                         INT_MAX,     // U_GNSS_MGA_FLOW_CONTROL_WAIT
-                                        U_GNSS_MGA_RX_BUFFER_SIZE_BYTES // U_GNSS_MGA_FLOW_CONTROL_SMART
+                                        U_GNSS_MGA_RX_BUFFER_SIZE_BYTES, // U_GNSS_MGA_FLOW_CONTROL_SMART
+                                        0            // U_GNSS_MGA_FLOW_CONTROL_WINDOW
                                        };
 
 /* ----------------------------------------------------------------
@@ -326,6 +353,18 @@ static void writeDeviceCallback(const void *pContext, const UBX_U1 *pData, UBX_I
     uGnssPrivateSendOnlyStreamRaw(pInstance, (const char *) pData, iSize);
 }
 
+// Callback called by libMga to read AssistNow Offline data that is
+// not in RAM.
+static UBX_I4 readOfflineDataCallback(const void *pContext, UBX_U4 offset,
+                                      UBX_U1 *pBuffer, UBX_I4 iSize)
+{
+    const uGnssMgaOfflineRead_t *pOfflineRead = (const uGnssMgaOfflineRead_t *) pContext;
+
+    return (UBX_I4) pOfflineRead->pCallback(pOfflineRead->gnssHandle, offset,
+                                            (char *) pBuffer, iSize,
+                                            pOfflineRead->pCallbackParam);
+}
+
 // Callback called by the ubxlib message receive infrastructure when something
 // arrives back from the GNSS device which libMga might need to know about.
 static void readDeviceLibMgaCallback(uDeviceHandle_t gnssHandle,
@@ -382,14 +421,12 @@ static int32_t ubxMgaAckEnable(uGnssPrivateInstance_t *pInstance)
     return errorCode;
 }
 
-// Send a UBX-MGA message and wait for the ack.
-static int32_t ubxMgaSendWaitAck(uGnssPrivateInstance_t *pInstance,
-                                 int32_t messageClass,
-                                 int32_t messageId,
-                                 const char *pMessageBody,
-                                 size_t messageBodyLengthBytes)
+// Wait for the UBX-MGA-ACK-DATA0 response to a UBX-MGA message
+// with the given message ID.
+static int32_t ubxMgaWaitAck(uGnssPrivateInstance_t *pInstance,
+                             int32_t messageId)
 {
-    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
     int32_t startTimeMs;
     // The UBX-MGA-ACK message ID
     uGnssPrivateMessageId_t ackMessageId = {.type = U_GNSS_PROTOCOL_UBX,
@@ -402,6 +439,43 @@ static int32_t ubxMgaSendWaitAck(uGnssPrivateInstance_t *pInstance,
     // 0 for "not acked", 1 for "nacked", 2 for "acked"
     size_t ackState = 0;
 
+    startTimeMs = uPortGetTickTimeMs();
+    do {
+        x = uGnssPrivateReceiveStreamMessage(pInstance, &ackMessageId,
+                                             pInstance->ringBufferReadHandlePrivate,
+                                             &pBuffer, sizeof(buffer),
+                                             1000, NULL);
+        if (x == sizeof(buffer)) {
+            // Check the Ack
+            if ((buffer[1 + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES] == 0) && // Ack message version
+                ((int32_t) buffer[3 + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES] == messageId)) { // Wanted ID
+                if (buffer[0 + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES] == 1) {
+                    ackState = 2;
+                } else {
+                    ackState = 1;
+                }
+            }
+        }
+    } while ((ackState == 0) && (uPortGetTickTimeMs() - startTimeMs < pInstance->timeoutMs));
+    if (ackState == 2) {
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    } else if (ackState == 1) {
+        errorCode = (int32_t) U_GNSS_ERROR_NACK;
+    }
+
+    return errorCode;
+}
+
+// Send a UBX-MGA message and wait for the ack.
+static int32_t ubxMgaSendWaitAck(uGnssPrivateInstance_t *pInstance,
+                                 int32_t messageClass,
+                                 int32_t messageId,
+                                 const char *pMessageBody,
+                                 size_t messageBodyLengthBytes)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t x;
+
     if ((pInstance != NULL) && (pMessageBody != NULL)) {
         // Send the message
         errorCode = uGnssPrivateSendOnlyStreamUbxMessage(pInstance,
@@ -412,31 +486,7 @@ static int32_t ubxMgaSendWaitAck(uGnssPrivateInstance_t *pInstance,
             x = errorCode;
             errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
             if (x == messageBodyLengthBytes + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) {
-                errorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
-                // Wait for the UBX-MGA-ACK-DATA0 response for our message ID
-                startTimeMs = uPortGetTickTimeMs();
-                do {
-                    x = uGnssPrivateReceiveStreamMessage(pInstance, &ackMessageId,
-                                                         pInstance->ringBufferReadHandlePrivate,
-                                                         &pBuffer, sizeof(buffer),
-                                                         1000, NULL);
-                    if (x == sizeof(buffer)) {
-                        // Check the Ack
-                        if ((buffer[1 + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES] == 0) && // Ack message version
-                            ((int32_t) buffer[3 + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES] == messageId)) { // Wanted ID
-                            if (buffer[0 + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES] == 1) {
-                                ackState = 2;
-                            } else {
-                                ackState = 1;
-                            }
-                        }
-                    }
-                } while ((ackState == 0) && (uPortGetTickTimeMs() - startTimeMs < pInstance->timeoutMs));
-                if (ackState == 2) {
-                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-                } else if (ackState == 1) {
-                    errorCode = (int32_t) U_GNSS_ERROR_NACK;
-                }
+                errorCode = ubxMgaWaitAck(pInstance, messageId);
             }
         }
     }
@@ -458,6 +508,185 @@ static int32_t ubxLength(const char *pBuffer, size_t size)
 
 }
 
+// Send the UBX-MGA-DBD blocks provided by pReadCallback, keeping a
+// window of up to U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES messages,
+// totalling no more than U_GNSS_MGA_RX_BUFFER_SIZE_BYTES, awaiting an
+// ack; since the GNSS device processes messages in order, each ack
+// releases the oldest message in the window.  If totalBlocks is
+// negative the number of blocks read so far is reported to pCallback
+// as the total.
+static int32_t ubxMgaDbdSendWindow(uGnssPrivateInstance_t *pInstance,
+                                   uGnssMgaDatabaseReadCallback_t *pReadCallback,
+                                   void *pReadCallbackParam,
+                                   int32_t totalBlocks,
+                                   uGnssMgaProgressCallback_t *pCallback,
+                                   void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    // Enough room for the largest UBX-MGA-DBD block, including the length bytes
+    char buffer[U_GNSS_MGA_DBD_MESSAGE_PAYLOAD_LENGTH_MAX_BYTES + 2];
+    // Ring of the lengths of the messages in flight, oldest first
+    int32_t lengthInFlight[U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES];
+    size_t numInFlight = 0;
+    size_t oldest = 0;
+    int32_t bytesInFlight = 0;
+    int32_t blocksRead = 0;
+    int32_t blocksAcked = 0;
+    // The payload length of the block in buffer, -1 if there is none
+    int32_t length = -1;
+    bool endOfData = false;
+    bool acked;
+    int32_t x;
+
+    while ((errorCode == 0) && (!endOfData || (numInFlight > 0))) {
+        acked = false;
+        if (!endOfData && (length < 0)) {
+            // Get the next block
+            x = pReadCallback(pInstance->gnssHandle, blocksRead, buffer, sizeof(buffer),
+                              pReadCallbackParam);
+            if (x > 0) {
+                errorCode = (int32_t) U_ERROR_COMMON_BAD_DATA;
+                length = ubxLength(buffer, x);
+                if ((length >= 0) && (length <= U_GNSS_MGA_DBD_MESSAGE_PAYLOAD_LENGTH_MAX_BYTES) &&
+                    (x == length + 2)) { // +2 to include the length bytes
+                    blocksRead++;
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                } else {
+                    uPortLog("U_GNSS_MGA: block %d, %d byte(s), bad length %d (max %d).\n",
+                             blocksRead, x, length, U_GNSS_MGA_DBD_MESSAGE_PAYLOAD_LENGTH_MAX_BYTES);
+                    length = -1;
+                }
+            } else if (x == 0) {
+                endOfData = true;
+            } else {
+                errorCode = x;
+            }
+        }
+        if (errorCode == 0) {
+            if ((length >= 0) && (numInFlight < U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES) &&
+                // Always allow one message in flight, however large
+                ((numInFlight == 0) ||
+                 (bytesInFlight + length + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES <=
+                  U_GNSS_MGA_RX_BUFFER_SIZE_BYTES))) {
+                // Room in the window: send the UBX-MGA-DBD message
+                errorCode = uGnssPrivateSendOnlyStreamUbxMessage(pInstance,
+                                                                 0x13, 0x80,
+                                                                 buffer + 2, // +2 to skip the length bytes
+                                                                 length);
+                if (errorCode == length + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) {
+                    lengthInFlight[(oldest + numInFlight) % U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES] = errorCode;
+                    numInFlight++;
+                    bytesInFlight += errorCode;
+                    length = -1;
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                } else if (errorCode >= 0) {
+                    errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+                }
+            } else if (numInFlight > 0) {
+                // Window full or no more data: wait for the oldest
+                // message in the window to be acked
+                errorCode = ubxMgaWaitAck(pInstance, 0x80);
+                if (errorCode == 0) {
+                    bytesInFlight -= lengthInFlight[oldest];
+                    oldest = (oldest + 1) % U_GNSS_MGA_FLOW_CONTROL_WINDOW_NUM_MESSAGES;
+                    numInFlight--;
+                    blocksAcked++;
+                    acked = true;
+                }
+            }
+        }
+        if ((pCallback != NULL) && (acked || (errorCode != 0)) &&
+            !pCallback(pInstance->gnssHandle, errorCode,
+                       totalBlocks >= 0 ? totalBlocks : blocksRead,
+                       blocksAcked, pCallbackParam) &&
+            (errorCode == 0)) {
+            // Application has cancelled the transfer
+            errorCode = (int32_t) U_ERROR_COMMON_CANCELLED;
+        }
+    }
+
+    return errorCode;
+}
+
+// Database read callback, for ubxMgaDbdSendWindow(), that takes blocks
+// from a contiguous buffer described by a uGnssMgaDatabaseBuffer_t.
+static int32_t databaseBufferReadCallback(uDeviceHandle_t gnssHandle, size_t index,
+                                          char *pBuffer, size_t size,
+                                          void *pCallbackParam)
+{
+    int32_t errorCodeOrLength = 0;
+    uGnssMgaDatabaseBuffer_t *pContext = (uGnssMgaDatabaseBuffer_t *) pCallbackParam;
+    int32_t length;
+
+    (void) gnssHandle;
+    (void) index;
+
+    if (pContext->size > 2) { // 2 'cos there must be a length indicator
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_BAD_DATA;
+        length = ubxLength(pContext->pBuffer, pContext->size) + 2; // +2 to include the length bytes
+        if ((length <= (int32_t) size) && (length <= (int32_t) pContext->size)) {
+            memcpy(pBuffer, pContext->pBuffer, length);
+            pContext->pBuffer += length;
+            pContext->size -= length;
+            errorCodeOrLength = length;
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// FNV-1a hash of a database block, never zero so that zero can
+// mean "no hash" in the hash list of uGnssMgaGetDatabaseDelta().
+static uint32_t databaseBlockHash(const char *pBuffer, size_t size)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (size_t x = 0; x < size; x++) {
+        hash ^= (uint8_t) pBuffer[x];
+        hash *= 16777619UL;
+    }
+    if (hash == 0) {
+        hash = 1;
+    }
+
+    return hash;
+}
+
+// Database callback, for uGnssMgaGetDatabase(), used by
+// uGnssMgaGetDatabaseDelta() to pass on only the blocks that
+// have changed.
+static bool databaseDeltaCallback(uDeviceHandle_t gnssHandle,
+                                  const char *pBuffer, size_t size,
+                                  void *pCallbackParam)
+{
+    bool keepGoing = true;
+    uGnssMgaDatabaseDelta_t *pContext = (uGnssMgaDatabaseDelta_t *) pCallbackParam;
+    uint32_t hash;
+    bool changed = true;
+
+    if (pBuffer != NULL) {
+        hash = databaseBlockHash(pBuffer, size);
+        if (pContext->index < pContext->hashListLength) {
+            changed = (pContext->pHashList[pContext->index] != hash);
+            pContext->pHashList[pContext->index] = hash;
+        }
+        if (changed) {
+            pContext->numChanged++;
+            keepGoing = pContext->pCallback(gnssHandle, pContext->index, pBuffer, size,
+                                            pContext->pCallbackParam);
+        }
+        pContext->index++;
+    } else {
+        // End of the database: forget any hashes beyond it
+        for (size_t x = pContext->index; x < pContext->hashListLength; x++) {
+            pContext->pHashList[x] = 0;
+        }
+        pContext->pCallback(gnssHandle, pContext->index, NULL, 0, pContext->pCallbackParam);
+    }
+
+    return keepGoing;
+}
+
 // Callback called by the ubxlib message receive infrastructure when readibg
 // the navigation database from the GNSS device.
 static void readDeviceDatabaseCallback(uDeviceHandle_t gnssHandle,
@@ -748,15 +977,18 @@ int32_t uGnssMgaIniPosSend(uDeviceHandle_t gnssHandle,
     return errorCode;
 }
 
-// Send the response from a u-blox assistance server to a GNSS module.
-int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
-                             int64_t timeUtcMilliseconds,
-                             int64_t timeUtcAccuracyMilliseconds,
-                             uGnssMgaSendOfflineOperation_t offlineOperation,
-                             uGnssMgaFlowControl_t flowControl,
-                             const char *pBuffer, size_t size,
-                             uGnssMgaProgressCallback_t *pCallback,
-                             void *pCallbackParam)
+// Send an AssistNow Online or Offline response to a GNSS device,
+// the response being either in pBuffer or, if pOfflineRead is not NULL,
+// (AssistNow Offline only) read through pOfflineRead.
+static int32_t responseSend(uDeviceHandle_t gnssHandle,
+                            int64_t timeUtcMilliseconds,
+                            int64_t timeUtcAccuracyMilliseconds,
+                            uGnssMgaSendOfflineOperation_t offlineOperation,
+                            uGnssMgaFlowControl_t flowControl,
+                            const char *pBuffer, size_t size,
+                            uGnssMgaOfflineRead_t *pOfflineRead,
+                            uGnssMgaProgressCallback_t *pCallback,
+                            void *pCallbackParam)
 {
     int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     uGnssPrivateInstance_t *pInstance;
@@ -780,8 +1012,11 @@ int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
 
         errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         pInstance = pUGnssPrivateGetInstance(gnssHandle);
-        if ((pInstance != NULL) && (pBuffer != NULL) && (size > 0) &&
+        if ((pInstance != NULL) && ((pBuffer != NULL) || (pOfflineRead != NULL)) && (size > 0) &&
             ((int32_t) flowControl >= 0) && (flowControl < U_GNSS_MGA_FLOW_CONTROL_MAX_NUM)) {
+            if (pOfflineRead != NULL) {
+                pOfflineRead->gnssHandle = gnssHandle;
+            }
             if (timeUtcMilliseconds >= 0) {
                 // Populate the time adjust structure, if present
                 pTimeAdjust = pCreateTimeAdjust(timeUtcMilliseconds,
@@ -837,7 +1072,7 @@ int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
                             if (result == MGA_API_OK) {
                                 errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
                                 // Determine what kind of AssistNow this is and start the transfer
-                                onlineNotOffline = detectAssistNowType(pBuffer, size);
+                                onlineNotOffline = (pBuffer != NULL) && detectAssistNowType(pBuffer, size);
                                 if (onlineNotOffline || (offlineOperation != U_GNSS_MGA_SEND_OFFLINE_NONE)) {
                                     errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
                                     if (onlineNotOffline) {
@@ -852,12 +1087,24 @@ int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
                                                     // Filter by today
                                                     time = (time_t) (timeUtcMilliseconds / 1000);
                                                     gmtime_r(&time, &structTm);
-                                                    result = mgaGetTodaysOfflineData(&structTm, (UBX_U1 *) pBuffer, size,
-                                                                                     &pBufferUbx, (UBX_I4 *) &size);
+                                                    if (pOfflineRead != NULL) {
+                                                        result = mgaGetOfflineDataRead(&structTm, readOfflineDataCallback,
+                                                                                       pOfflineRead, size,
+                                                                                       &pBufferUbx, (UBX_I4 *) &size);
+                                                    } else {
+                                                        result = mgaGetTodaysOfflineData(&structTm, (UBX_U1 *) pBuffer, size,
+                                                                                         &pBufferUbx, (UBX_I4 *) &size);
+                                                    }
                                                 } else if (offlineOperation == U_GNSS_MGA_SEND_OFFLINE_ALMANAC) {
                                                     // Filter almanac data
-                                                    result = mgaGetAlmOfflineData((UBX_U1 *) pBuffer, size,
-                                                                                  &pBufferUbx, (UBX_I4 *) &size);
+                                                    if (pOfflineRead != NULL) {
+                                                        result = mgaGetOfflineDataRead(NULL, readOfflineDataCallback,
+                                                                                       pOfflineRead, size,
+                                                                                       &pBufferUbx, (UBX_I4 *) &size);
+                                                    } else {
+                                                        result = mgaGetAlmOfflineData((UBX_U1 *) pBuffer, size,
+                                                                                      &pBufferUbx, (UBX_I4 *) &size);
+                                                    }
                                                 }
                                                 if (result == MGA_API_OK) {
                                                     if (pBufferUbx != NULL) {
@@ -910,6 +1157,61 @@ int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
     return errorCode;
 }
 
+// Send an AssistNow Online or Offline response to a GNSS device.
+int32_t uGnssMgaResponseSend(uDeviceHandle_t gnssHandle,
+                             int64_t timeUtcMilliseconds,
+                             int64_t timeUtcAccuracyMilliseconds,
+                             uGnssMgaSendOfflineOperation_t offlineOperation,
+                             uGnssMgaFlowControl_t flowControl,
+                             const char *pBuffer, size_t size,
+                             uGnssMgaProgressCallback_t *pCallback,
+                             void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (pBuffer != NULL) {
+        errorCode = responseSend(gnssHandle, timeUtcMilliseconds,
+                                 timeUtcAccuracyMilliseconds,
+                                 offlineOperation, flowControl,
+                                 pBuffer, size, NULL,
+                                 pCallback, pCallbackParam);
+    }
+
+    return errorCode;
+}
+
+// Send an AssistNow Offline response, read in pieces, to a GNSS device.
+int32_t uGnssMgaResponseSendOfflineRead(uDeviceHandle_t gnssHandle,
+                                        int64_t timeUtcMilliseconds,
+                                        int64_t timeUtcAccuracyMilliseconds,
+                                        uGnssMgaSendOfflineOperation_t offlineOperation,
+                                        uGnssMgaFlowControl_t flowControl,
+                                        uGnssMgaOfflineReadCallback_t *pReadCallback,
+                                        void *pReadCallbackParam,
+                                        size_t size,
+                                        uGnssMgaProgressCallback_t *pCallback,
+                                        void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssMgaOfflineRead_t offlineRead;
+
+    // Only the operations that extract a subset of the data can
+    // be done without having all of the data in RAM
+    if ((pReadCallback != NULL) &&
+        ((offlineOperation == U_GNSS_MGA_SEND_OFFLINE_TODAYS) ||
+         (offlineOperation == U_GNSS_MGA_SEND_OFFLINE_ALMANAC))) {
+        offlineRead.pCallback = pReadCallback;
+        offlineRead.pCallbackParam = pReadCallbackParam;
+        errorCode = responseSend(gnssHandle, timeUtcMilliseconds,
+                                 timeUtcAccuracyMilliseconds,
+                                 offlineOperation, flowControl,
+                                 NULL, size, &offlineRead,
+                                 pCallback, pCallbackParam);
+    }
+
+    return errorCode;
+}
+
 // Erase the flash memory attached to a GNSS chip.
 int32_t uGnssMgaErase(uDeviceHandle_t gnssHandle)
 {
@@ -1149,6 +1451,7 @@ int32_t uGnssMgaSetDatabase(uDeviceHandle_t gnssHandle,
     int32_t totalBlocks = 0;
     int32_t blocksSent = 0;
     int32_t protocolsOut = 0;
+    uGnssMgaDatabaseBuffer_t databaseBuffer;
 
     if (gUGnssPrivateMutex != NULL) {
 
@@ -1233,6 +1536,15 @@ int32_t uGnssMgaSetDatabase(uDeviceHandle_t gnssHandle,
                                 }
                             }
                         }
+                        if ((flowControl == U_GNSS_MGA_FLOW_CONTROL_WINDOW) && (errorCode == 0)) {
+                            // Keep a window of messages awaiting acks
+                            databaseBuffer.pBuffer = pBuffer;
+                            databaseBuffer.size = size;
+                            errorCode = ubxMgaDbdSendWindow(pInstance, databaseBufferReadCallback,
+                                                            &databaseBuffer, totalBlocks,
+                                                            pCallback, pCallbackParam);
+                            size = 0;
+                        }
                         // With that done we start waiting for acks
                         while ((size > 2) && (errorCode == 0)) { // 2 'cos there must be a length indicator
                             // Work out the length
@@ -1266,4 +1578,81 @@ int32_t uGnssMgaSetDatabase(uDeviceHandle_t gnssHandle,
     return errorCode;
 }
 
+// Get only the changed blocks of the assistance database.
+int32_t uGnssMgaGetDatabaseDelta(uDeviceHandle_t gnssHandle,
+                                 uint32_t *pHashList, size_t hashListLength,
+                                 uGnssMgaDatabaseDeltaCallback_t *pCallback,
+                                 void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssMgaDatabaseDelta_t context = {0};
+
+    if ((pCallback != NULL) && ((pHashList != NULL) || (hashListLength == 0))) {
+        context.pHashList = pHashList;
+        context.hashListLength = hashListLength;
+        context.pCallback = pCallback;
+        context.pCallbackParam = pCallbackParam;
+        errorCode = uGnssMgaGetDatabase(gnssHandle, databaseDeltaCallback, &context);
+        if (errorCode >= 0) {
+            errorCode = context.numChanged;
+        } else {
+            // The application will discard what it was given, so
+            // the hashes can no longer be trusted: forget them all
+            for (size_t x = 0; x < hashListLength; x++) {
+                pHashList[x] = 0;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Restore the assistance database block by block.
+int32_t uGnssMgaSetDatabaseStream(uDeviceHandle_t gnssHandle,
+                                  uGnssMgaDatabaseReadCallback_t *pReadCallback,
+                                  void *pReadCallbackParam,
+                                  uGnssMgaProgressCallback_t *pCallback,
+                                  void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+    int32_t protocolsOut = 0;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if ((pInstance != NULL) && (pReadCallback != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            // Not supported if there is an intermediate module
+            if ((pInstance->transportType != U_GNSS_TRANSPORT_AT) &&
+                (pInstance->intermediateHandle == NULL)) {
+                errorCode = ubxMgaAckEnable(pInstance);
+#ifndef U_GNSS_MGA_DISABLE_NMEA_MESSAGE_DISABLE
+                // On a best effort basis switch off NMEA messages while
+                // we wait for Acks, as for uGnssMgaSetDatabase()
+                protocolsOut = uGnssPrivateGetProtocolOut(pInstance);
+                if ((protocolsOut >= 0) && ((protocolsOut & (1ULL << U_GNSS_PROTOCOL_NMEA)) != 0)) {
+                    uGnssPrivateSetProtocolOut(pInstance, U_GNSS_PROTOCOL_NMEA, false);
+                }
+#endif
+                if (errorCode == 0) {
+                    errorCode = ubxMgaDbdSendWindow(pInstance, pReadCallback, pReadCallbackParam,
+                                                    -1, pCallback, pCallbackParam);
+                }
+                if ((protocolsOut >= 0) && ((protocolsOut & (1UL << U_GNSS_PROTOCOL_NMEA)) != 0)) {
+                    // Restore NMEA messages, if we switched them off above
+                    uGnssPrivateSetProtocolOut(pInstance, U_GNSS_PROTOCOL_NMEA, true);
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // End of file
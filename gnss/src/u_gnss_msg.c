@@ -83,6 +83,9 @@
 
 #include "u_hex_bin_convert.h"
 
+#include "u_spartn.h"
+#include "u_spartn_crc.h"
+
 #include "u_gnss_module_type.h"
 #include "u_gnss_type.h"
 #include "u_gnss.h"
@@ -108,6 +111,15 @@
 # define U_GNSS_MSG_RECEIVE_TASK_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
 #endif
 
+#ifndef U_GNSS_MSG_RECEIVE_QUEUED_TASK_PRIORITY
+/** The priority of the task of each receiver started with
+ * uGnssMsgReceiveStartQueued(); lower than that of the
+ * message receive task so that the decoding, which feeds all
+ * of the receivers, is never held up by any one of them.
+ */
+# define U_GNSS_MSG_RECEIVE_QUEUED_TASK_PRIORITY (U_GNSS_MSG_RECEIVE_TASK_PRIORITY - 1)
+#endif
+
 #ifndef U_GNSS_MSG_TASK_STACK_YIELD_TIME_MS
 /** How long the asynchronous message receive task guarantees to give
  * to the rest of the system; if this is made larger the asynchronous
@@ -117,6 +129,27 @@
 # define U_GNSS_MSG_TASK_STACK_YIELD_TIME_MS 50
 #endif
 
+#ifndef U_GNSS_MSG_INJECT_TASK_PRIORITY
+/** The priority of the task started by uGnssMsgInjectStart(); the
+ * same as that of the queued receivers, since it is equally
+ * important that it doesn't hold up the message receive task.
+ */
+# define U_GNSS_MSG_INJECT_TASK_PRIORITY U_GNSS_MSG_RECEIVE_QUEUED_TASK_PRIORITY
+#endif
+
+#if U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES < U_SPARTN_MESSAGE_LENGTH_MAX_BYTES
+/* The batch buffer must be able to hold the largest message that
+ * may be injected, else such a message would never be sent.
+ */
+# error U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES must be at least as big as U_SPARTN_MESSAGE_LENGTH_MAX_BYTES
+#endif
+
+/** The longest that a SPARTN message header can be: once this
+ * much data is present the length of a SPARTN message can always
+ * be determined.
+ */
+#define U_GNSS_MSG_INJECT_SPARTN_HEADER_LENGTH_MAX_BYTES (4 + 8)
+
 #if U_GNSS_MSG_TASK_STACK_YIELD_TIME_MS < U_CFG_OS_YIELD_MS
 /* U_GNSS_MSG_TASK_STACK_YIELD_TIME_MS must be at least as big as U_CFG_OS_YIELD_MS
  * or the asynchronous message receive task will be all-consuming.
@@ -128,14 +161,643 @@
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The header that precedes each message in a queue.
+ */
+typedef struct {
+    int32_t errorCodeOrLength;
+    uGnssPrivateMessageId_t privateMessageId;
+    int32_t arrivalErrorCode; /**< the return value of uGnssPrivateStreamGetArrivalTime(). */
+    int32_t arrivalTimeMs;
+} uGnssMsgQueueHeader_t;
+
+/** A single-producer, single-consumer queue of messages, plus the
+ * task that consumes them, for a receiver started with
+ * uGnssMsgReceiveStartQueued().  The producer is msgReceiveTask(),
+ * which is the only writer of writeIndex and lossCount, the consumer
+ * is msgQueueTask(), which is the only writer of readIndex, hence
+ * neither has to wait on a lock.
+ */
+typedef struct {
+    uDeviceHandle_t gnssHandle;
+    uGnssMsgReceiveCallback_t pCallback;
+    void *pCallbackParam;
+    char *pBuffer;
+    size_t size;
+    volatile size_t writeIndex;
+    volatile size_t readIndex;
+    volatile int32_t lossCount; /**< the number of messages dropped
+                                     because the queue was full. */
+    volatile bool exitNow;
+    size_t msgReadIndex; /**< where the unread part of the message
+                              currently being passed to pCallback
+                              begins. */
+    size_t msgBytesLeftToRead;
+    int32_t msgArrivalErrorCode; /**< for the message currently
+                                      being passed to pCallback. */
+    int32_t msgArrivalTimeMs;
+    uPortSemaphoreHandle_t semaphoreHandle;
+    uPortMutexHandle_t taskRunningMutexHandle;
+    uPortTaskHandle_t taskHandle;
+} uGnssMsgQueue_t;
+
+/** Structure to associate a queue with its task, so that
+ * uGnssMsgReceiveCallbackRead() can find the queue from the
+ * context of the task without having to lock the reader list.
+ */
+typedef struct {
+    volatile uPortTaskHandle_t taskHandle;
+    uGnssMsgQueue_t *pQueue;
+} uGnssMsgQueueTask_t;
+
+/** The context of the correction injection started by
+ * uGnssMsgInjectStart().  The raw input data is held in a
+ * uGnssMsgQueue_t, without message headers, for which
+ * uGnssMsgInject() is the producer, the only writer of writeIndex,
+ * and msgInjectTask() is the consumer, the only writer of
+ * readIndex; the task and its synchronisation are also those of
+ * the queue.
+ */
+typedef struct {
+    uGnssMsgQueue_t queue;
+    uGnssPrivateInstance_t *pInstance;
+    volatile int32_t maxRateBytesPerSecond;
+    char *pBatch; /**< #U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES long. */
+    volatile size_t sentCount; /**< bytes written to the GNSS chip. */
+    volatile size_t discardCount; /**< bytes thrown away because they were not
+                                       part of a message or could not be sent. */
+} uGnssMsgInject_t;
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
 
+/** The queues of the receivers started with
+ * uGnssMsgReceiveStartQueued(), across all GNSS instances;
+ * entries are only added or removed with gUGnssPrivateMutex
+ * locked.
+ */
+static uGnssMsgQueueTask_t gQueueTask[U_GNSS_MSG_RECEIVER_MAX_NUM] = {0};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Return the number of bytes in use in a queue.
+static size_t queueUsed(const uGnssMsgQueue_t *pQueue,
+                        size_t writeIndex, size_t readIndex)
+{
+    return (writeIndex + pQueue->size - readIndex) % pQueue->size;
+}
+
+// Copy data into a queue at the given index, wrapping as
+// necessary, returning the index after the data.
+static size_t queueCopyIn(uGnssMsgQueue_t *pQueue, size_t index,
+                          const char *pData, size_t size)
+{
+    size_t chunk;
+
+    while (size > 0) {
+        chunk = pQueue->size - index;
+        if (chunk > size) {
+            chunk = size;
+        }
+        memcpy(pQueue->pBuffer + index, pData, chunk);
+        pData += chunk;
+        size -= chunk;
+        index = (index + chunk) % pQueue->size;
+    }
+
+    return index;
+}
+
+// Copy data out of a queue from the given index, wrapping as
+// necessary, returning the index after the data.
+static size_t queueCopyOut(const uGnssMsgQueue_t *pQueue, size_t index,
+                           char *pData, size_t size)
+{
+    size_t chunk;
+
+    while (size > 0) {
+        chunk = pQueue->size - index;
+        if (chunk > size) {
+            chunk = size;
+        }
+        memcpy(pData, pQueue->pBuffer + index, chunk);
+        pData += chunk;
+        size -= chunk;
+        index = (index + chunk) % pQueue->size;
+    }
+
+    return index;
+}
+
+// Add the message at the front of the ring buffer to a queue;
+// this must only be called from msgReceiveTask().
+static void queuePush(uGnssPrivateInstance_t *pInstance, int32_t readHandle,
+                      uGnssMsgQueue_t *pQueue,
+                      const uGnssPrivateMessageId_t *pPrivateMessageId,
+                      int32_t errorCodeOrLength)
+{
+    uGnssMsgQueueHeader_t header;
+    size_t length = 0;
+    size_t index = pQueue->writeIndex;
+    size_t chunk;
+    bool success = false;
+
+    if (errorCodeOrLength > 0) {
+        length = (size_t) errorCodeOrLength;
+    }
+    // One byte is always left empty so that a full queue
+    // can be told apart from an empty one
+    if (queueUsed(pQueue, index, pQueue->readIndex) + sizeof(header) + length < pQueue->size) {
+        memset(&header, 0, sizeof(header));
+        header.errorCodeOrLength = errorCodeOrLength;
+        header.privateMessageId = *pPrivateMessageId;
+        // The arrival time has to be worked out now, it may
+        // be forgotten by the time that the queue task runs
+        header.arrivalErrorCode = uGnssPrivateStreamGetArrivalTime(pInstance,
+                                                                   uGnssPrivateStreamGetPosition(pInstance,
+                                                                           readHandle),
+                                                                   &(header.arrivalTimeMs));
+        index = queueCopyIn(pQueue, index, (const char *) &header, sizeof(header));
+        // Peek the message straight from the ring buffer into the
+        // queue, in two goes if it wraps
+        chunk = pQueue->size - index;
+        if (chunk > length) {
+            chunk = length;
+        }
+        success = (chunk == 0) ||
+                  (uGnssPrivateStreamPeekRingBuffer(pInstance, readHandle,
+                                                    pQueue->pBuffer + index, chunk, 0,
+                                                    U_GNSS_MSG_READ_TIMEOUT_MS) == (int32_t) chunk);
+        if (success && (length > chunk)) {
+            success = (uGnssPrivateStreamPeekRingBuffer(pInstance, readHandle,
+                                                        pQueue->pBuffer, length - chunk, chunk,
+                                                        U_GNSS_MSG_READ_TIMEOUT_MS) == (int32_t) (length - chunk));
+        }
+    }
+    if (success) {
+        // Only now make the message visible to the queue task
+        pQueue->writeIndex = (index + length) % pQueue->size;
+        uPortSemaphoreGive(pQueue->semaphoreHandle);
+    } else {
+        pQueue->lossCount++;
+    }
+}
+
+// Task that calls the callback of a queued receiver.
+static void msgQueueTask(void *pParam)
+{
+    uGnssMsgQueue_t *pQueue = (uGnssMsgQueue_t *) pParam;
+    uGnssMsgQueueHeader_t header;
+    uGnssMessageId_t messageId;
+    char nmeaId[U_GNSS_NMEA_MESSAGE_MATCH_LENGTH_CHARACTERS + 1];
+    size_t writeIndex;
+    size_t index;
+
+    U_PORT_MUTEX_LOCK(pQueue->taskRunningMutexHandle);
+
+    while (!pQueue->exitNow) {
+        // Wait to be told that there is something new; the write
+        // index is only read after this so that the message data
+        // written before it is visible
+        uPortSemaphoreTake(pQueue->semaphoreHandle);
+        writeIndex = pQueue->writeIndex;
+        while (!pQueue->exitNow && (pQueue->readIndex != writeIndex)) {
+            index = queueCopyOut(pQueue, pQueue->readIndex, (char *) &header, sizeof(header));
+            pQueue->msgReadIndex = index;
+            pQueue->msgBytesLeftToRead = 0;
+            pQueue->msgArrivalErrorCode = header.arrivalErrorCode;
+            pQueue->msgArrivalTimeMs = header.arrivalTimeMs;
+            if (header.errorCodeOrLength > 0) {
+                pQueue->msgBytesLeftToRead = (size_t) header.errorCodeOrLength;
+                index = (index + pQueue->msgBytesLeftToRead) % pQueue->size;
+            }
+            if (uGnssPrivateMessageIdToPublic(&(header.privateMessageId),
+                                              &messageId, nmeaId) == 0) {
+                pQueue->pCallback(pQueue->gnssHandle, &messageId,
+                                  header.errorCodeOrLength,
+                                  pQueue->pCallbackParam);
+            }
+            // Only now give the space back to msgReceiveTask()
+            pQueue->readIndex = index;
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(pQueue->taskRunningMutexHandle);
+
+    // Delete ourself
+    uPortTaskDelete(NULL);
+}
+
+// Find the queue that belongs to the calling task, if there is one.
+static uGnssMsgQueue_t *pQueueGetThisTask(void)
+{
+    uGnssMsgQueue_t *pQueue = NULL;
+
+    for (size_t x = 0; (x < sizeof(gQueueTask) / sizeof(gQueueTask[0])) &&
+         (pQueue == NULL); x++) {
+        if ((gQueueTask[x].taskHandle != NULL) &&
+            uPortTaskIsThis(gQueueTask[x].taskHandle)) {
+            pQueue = gQueueTask[x].pQueue;
+        }
+    }
+
+    return pQueue;
+}
+
+// Free a queue, stopping its task first; gUGnssPrivateMutex should
+// be locked before this is called.
+static void queueFree(uGnssMsgQueue_t *pQueue)
+{
+    if (pQueue->taskHandle != NULL) {
+        // Make the task exit and wait for it to do so
+        pQueue->exitNow = true;
+        uPortSemaphoreGive(pQueue->semaphoreHandle);
+        U_PORT_MUTEX_LOCK(pQueue->taskRunningMutexHandle);
+        U_PORT_MUTEX_UNLOCK(pQueue->taskRunningMutexHandle);
+        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+    }
+    for (size_t x = 0; x < sizeof(gQueueTask) / sizeof(gQueueTask[0]); x++) {
+        if (gQueueTask[x].pQueue == pQueue) {
+            gQueueTask[x].taskHandle = NULL;
+            gQueueTask[x].pQueue = NULL;
+        }
+    }
+    if (pQueue->taskRunningMutexHandle != NULL) {
+        uPortMutexDelete(pQueue->taskRunningMutexHandle);
+    }
+    if (pQueue->semaphoreHandle != NULL) {
+        uPortSemaphoreDelete(pQueue->semaphoreHandle);
+    }
+    uPortFree(pQueue->pBuffer);
+    uPortFree(pQueue);
+}
+
+// Create a queue and start its task; gUGnssPrivateMutex should
+// be locked before this is called.
+static uGnssMsgQueue_t *pQueueCreate(uDeviceHandle_t gnssHandle,
+                                     uGnssMsgReceiveCallback_t pCallback,
+                                     void *pCallbackParam,
+                                     size_t size)
+{
+    uGnssMsgQueue_t *pQueue = NULL;
+    uGnssMsgQueueTask_t *pQueueTask = NULL;
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+
+    for (size_t x = 0; (x < sizeof(gQueueTask) / sizeof(gQueueTask[0])) &&
+         (pQueueTask == NULL); x++) {
+        if (gQueueTask[x].pQueue == NULL) {
+            pQueueTask = &(gQueueTask[x]);
+        }
+    }
+    if (pQueueTask != NULL) {
+        pQueue = (uGnssMsgQueue_t *) pUPortMalloc(sizeof(*pQueue));
+    }
+    if (pQueue != NULL) {
+        memset(pQueue, 0, sizeof(*pQueue));
+        pQueue->gnssHandle = gnssHandle;
+        pQueue->pCallback = pCallback;
+        pQueue->pCallbackParam = pCallbackParam;
+        pQueue->size = size;
+        pQueue->pBuffer = (char *) pUPortMalloc(size);
+        if ((pQueue->pBuffer != NULL) &&
+            (uPortSemaphoreCreate(&(pQueue->semaphoreHandle), 0, 1) == 0) &&
+            (uPortMutexCreate(&(pQueue->taskRunningMutexHandle)) == 0)) {
+            errorCode = uPortTaskCreate(msgQueueTask, "gnssMsgQueue",
+                                        U_GNSS_MSG_RECEIVE_QUEUED_TASK_STACK_SIZE_BYTES,
+                                        pQueue, U_GNSS_MSG_RECEIVE_QUEUED_TASK_PRIORITY,
+                                        &(pQueue->taskHandle));
+            if (errorCode == 0) {
+                // Wait for the task to lock the mutex,
+                // which shows it is running
+                while (uPortMutexTryLock(pQueue->taskRunningMutexHandle, 0) == 0) {
+                    uPortMutexUnlock(pQueue->taskRunningMutexHandle);
+                    uPortTaskBlock(U_CFG_OS_YIELD_MS);
+                }
+                pQueueTask->pQueue = pQueue;
+                pQueueTask->taskHandle = pQueue->taskHandle;
+            } else {
+                pQueue->taskHandle = NULL;
+            }
+        }
+        if (errorCode != 0) {
+            // Clean up on error
+            queueFree(pQueue);
+            pQueue = NULL;
+        }
+    }
+
+    return pQueue;
+}
+
+// Send data to the GNSS chip over a streaming transport; the
+// transport mutex is locked here, gUGnssPrivateMutex need not be.
+static int32_t msgSend(uGnssPrivateInstance_t *pInstance,
+                       const char *pBuffer, size_t size)
+{
+    int32_t errorCodeOrLength = (int32_t) U_GNSS_ERROR_TRANSPORT;
+    int32_t privateStreamType = uGnssPrivateGetStreamType(pInstance->transportType);
+
+    U_PORT_MUTEX_LOCK(pInstance->transportMutex);
+
+    if (privateStreamType >= 0) {
+        // Streaming transport
+        switch (privateStreamType) {
+            case U_GNSS_PRIVATE_STREAM_TYPE_UART: {
+                errorCodeOrLength = uPortUartWrite(pInstance->transportHandle.uart,
+                                                   pBuffer, size);
+            }
+            break;
+            case U_GNSS_PRIVATE_STREAM_TYPE_I2C: {
+                errorCodeOrLength = uPortI2cControllerSend(pInstance->transportHandle.i2c,
+                                                           pInstance->i2cAddress,
+                                                           pBuffer, size, false);
+                if (errorCodeOrLength == 0) {
+                    errorCodeOrLength = (int32_t) size;
+                }
+            }
+            break;
+            case U_GNSS_PRIVATE_STREAM_TYPE_SPI: {
+                char spiBuffer[U_GNSS_SPI_FILL_THRESHOLD_MAX];
+                size_t offset = 0;
+                size_t thisSize;
+                // Since SPI is symmetrical, we must necessarily receive
+                // when we send.  We don't want to allocate a receive
+                // buffer here though, so we send in chunks of length
+                // up to our SPI fill-checking buffer ('cos it's a
+                // convenient length).
+                errorCodeOrLength = 0;
+                for (size_t x = 0; (offset < size) && (errorCodeOrLength >= 0); x++) {
+                    thisSize = size - offset;
+                    if (thisSize > U_GNSS_SPI_FILL_THRESHOLD_MAX) {
+                        thisSize = U_GNSS_SPI_FILL_THRESHOLD_MAX;
+                    }
+                    errorCodeOrLength = uPortSpiControllerSendReceiveBlock(pInstance->transportHandle.spi,
+                                                                           pBuffer + offset,
+                                                                           thisSize,
+                                                                           spiBuffer,
+                                                                           thisSize);
+                    if (errorCodeOrLength > 0) {
+                        offset += errorCodeOrLength;
+                        // This will add any non-fill SPI received data to the
+                        // internal SPI ring buffer
+                        uGnssPrivateSpiAddReceivedData(pInstance, spiBuffer, errorCodeOrLength);
+                    }
+                }
+                if (errorCodeOrLength >= 0) {
+                    errorCodeOrLength = offset;
+                }
+            }
+            break;
+            case U_GNSS_PRIVATE_STREAM_TYPE_VIRTUAL_SERIAL: {
+                uDeviceSerial_t *pDeviceSerial = pInstance->transportHandle.pDeviceSerial;
+                if (pDeviceSerial != NULL) {
+                    errorCodeOrLength = pDeviceSerial->write(pDeviceSerial, pBuffer, size);
+                }
+            }
+            break;
+            default:
+                break;
+        }
+        if (errorCodeOrLength == size) {
+            if (pInstance->printUbxMessages) {
+                uPortLog("U_GNSS: sent message");
+                uGnssPrivatePrintBuffer(pBuffer, size);
+                uPortLog(".\n");
+            }
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(pInstance->transportMutex);
+
+    return errorCodeOrLength;
+}
+
+// Return the length of the RTCM3 or SPARTN message at the start
+// of pBuffer, U_ERROR_COMMON_TIMEOUT if what is there may be the
+// start of such a message but it is not all there yet, else
+// U_ERROR_COMMON_NOT_FOUND.
+static int32_t injectMessageLength(const char *pBuffer, size_t size)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+    const uint8_t *pData = (const uint8_t *) pBuffer;
+    const char *pMessage = NULL;
+    size_t length;
+    uint32_t crc;
+
+    if (*pData == 0xD3) {
+        // RTCM3: 0xD3, six zero bits, a 10-bit length, that many
+        // bytes of message and then a CRC-24Q over everything before
+        // it, which is the same CRC-24 as SPARTN uses
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_TIMEOUT;
+        if (size >= 3) {
+            errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            if ((*(pData + 1) & 0xFC) == 0) {
+                errorCodeOrLength = (int32_t) U_ERROR_COMMON_TIMEOUT;
+                length = ((((size_t) * (pData + 1)) & 0x03) << 8) + *(pData + 2) + 6;
+                if (size >= length) {
+                    errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+                    crc = (((uint32_t) * (pData + length - 3)) << 16) +
+                          (((uint32_t) * (pData + length - 2)) << 8) +
+                          (uint32_t) * (pData + length - 1);
+                    if (uSpartnCrc24(pBuffer, length - 3) == crc) {
+                        errorCodeOrLength = (int32_t) length;
+                    }
+                }
+            }
+        }
+    } else if (*pData == 0x73) {
+        // SPARTN: get the length from the header, which must be
+        // the one at the start of pBuffer, then validate the lot
+        errorCodeOrLength = uSpartnDetect(pBuffer, size, &pMessage);
+        if (errorCodeOrLength > 0) {
+            if (pMessage != pBuffer) {
+                errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            } else if ((size_t) errorCodeOrLength > size) {
+                errorCodeOrLength = (int32_t) U_ERROR_COMMON_TIMEOUT;
+            } else if ((uSpartnValidate(pBuffer, (size_t) errorCodeOrLength,
+                                        &pMessage) != errorCodeOrLength) ||
+                       (pMessage != pBuffer)) {
+                errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            }
+        } else if ((errorCodeOrLength != (int32_t) U_ERROR_COMMON_TIMEOUT) ||
+                   (size >= U_GNSS_MSG_INJECT_SPARTN_HEADER_LENGTH_MAX_BYTES)) {
+            // If the whole of a header was there, the partial
+            // message that was found must be a later one
+            errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Frame the *pLength bytes of data in the batch buffer of the
+// injection context, moving the complete messages that are found
+// down to sit contiguously at the start of the buffer, followed by
+// any partial message, and throwing away anything else; returns the
+// number of bytes of complete messages, *pLength is updated to the
+// number of bytes still in the buffer.
+static size_t injectFrame(uGnssMsgInject_t *pInject, size_t *pLength)
+{
+    char *pBuffer = pInject->pBatch;
+    size_t framedLength = 0;
+    size_t offset = 0;
+    int32_t x = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+
+    while ((offset < *pLength) && (x != (int32_t) U_ERROR_COMMON_TIMEOUT)) {
+        x = injectMessageLength(pBuffer + offset, *pLength - offset);
+        if (x > 0) {
+            memmove(pBuffer + framedLength, pBuffer + offset, x);
+            framedLength += x;
+            offset += x;
+        } else if (x == (int32_t) U_ERROR_COMMON_NOT_FOUND) {
+            offset++;
+            pInject->discardCount++;
+        }
+    }
+    if ((offset == 0) && (*pLength >= U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES)) {
+        // Can't happen for a genuine message, but make sure that
+        // a full buffer can't stall us forever
+        offset++;
+        pInject->discardCount++;
+    }
+    // Move any partial message down behind the complete ones
+    memmove(pBuffer + framedLength, pBuffer + offset, *pLength - offset);
+    *pLength = framedLength + *pLength - offset;
+
+    return framedLength;
+}
+
+// Task that frames the data passed to uGnssMsgInject() and
+// writes it to the GNSS chip in batches.
+static void msgInjectTask(void *pParam)
+{
+    uGnssMsgInject_t *pInject = (uGnssMsgInject_t *) pParam;
+    uGnssMsgQueue_t *pQueue = &(pInject->queue);
+    int32_t nextWriteTimeMs = uPortGetTickTimeMs();
+    size_t length = 0;
+    size_t framedLength;
+    size_t used;
+
+    U_PORT_MUTEX_LOCK(pQueue->taskRunningMutexHandle);
+
+    while (!pQueue->exitNow) {
+        // Wait to be told that there is something new
+        uPortSemaphoreTake(pQueue->semaphoreHandle);
+        used = queueUsed(pQueue, pQueue->writeIndex, pQueue->readIndex);
+        while (!pQueue->exitNow && (used > 0)) {
+            // Top up the batch buffer from the queue
+            if (used > U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES - length) {
+                used = U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES - length;
+            }
+            pQueue->readIndex = queueCopyOut(pQueue, pQueue->readIndex,
+                                             pInject->pBatch + length, used);
+            length += used;
+            framedLength = injectFrame(pInject, &length);
+            if (framedLength > 0) {
+                // Hold off until the rate limit allows another write
+                while (!pQueue->exitNow &&
+                       (uPortGetTickTimeMs() - nextWriteTimeMs < 0)) {
+                    uPortTaskBlock(U_CFG_OS_YIELD_MS);
+                }
+                // Send all of the complete messages in one go, which
+                // means just the one claim of the transport
+                if (msgSend(pInject->pInstance, pInject->pBatch,
+                            framedLength) == (int32_t) framedLength) {
+                    pInject->sentCount += framedLength;
+                } else {
+                    pInject->discardCount += framedLength;
+                }
+                if (pInject->maxRateBytesPerSecond > 0) {
+                    nextWriteTimeMs = uPortGetTickTimeMs() +
+                                      (int32_t) (((int64_t) framedLength * 1000) /
+                                                 pInject->maxRateBytesPerSecond);
+                }
+                length -= framedLength;
+                memmove(pInject->pBatch, pInject->pBatch + framedLength, length);
+            }
+            used = queueUsed(pQueue, pQueue->writeIndex, pQueue->readIndex);
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(pQueue->taskRunningMutexHandle);
+
+    // Delete ourself
+    uPortTaskDelete(NULL);
+}
+
+// Free an injection context, stopping its task first.
+static void injectFree(uGnssMsgInject_t *pInject)
+{
+    uGnssMsgQueue_t *pQueue = &(pInject->queue);
+
+    if (pQueue->taskHandle != NULL) {
+        // Make the task exit and wait for it to do so
+        pQueue->exitNow = true;
+        uPortSemaphoreGive(pQueue->semaphoreHandle);
+        U_PORT_MUTEX_LOCK(pQueue->taskRunningMutexHandle);
+        U_PORT_MUTEX_UNLOCK(pQueue->taskRunningMutexHandle);
+        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+    }
+    if (pQueue->taskRunningMutexHandle != NULL) {
+        uPortMutexDelete(pQueue->taskRunningMutexHandle);
+    }
+    if (pQueue->semaphoreHandle != NULL) {
+        uPortSemaphoreDelete(pQueue->semaphoreHandle);
+    }
+    uPortFree(pQueue->pBuffer);
+    uPortFree(pInject->pBatch);
+    uPortFree(pInject);
+}
+
+// Create an injection context and start its task.
+static uGnssMsgInject_t *pInjectCreate(uGnssPrivateInstance_t *pInstance,
+                                       size_t size,
+                                       int32_t maxRateBytesPerSecond)
+{
+    uGnssMsgInject_t *pInject;
+    uGnssMsgQueue_t *pQueue;
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+
+    pInject = (uGnssMsgInject_t *) pUPortMalloc(sizeof(*pInject));
+    if (pInject != NULL) {
+        memset(pInject, 0, sizeof(*pInject));
+        pInject->pInstance = pInstance;
+        pInject->maxRateBytesPerSecond = maxRateBytesPerSecond;
+        pQueue = &(pInject->queue);
+        pQueue->gnssHandle = pInstance->gnssHandle;
+        pQueue->size = size;
+        pQueue->pBuffer = (char *) pUPortMalloc(size);
+        pInject->pBatch = (char *) pUPortMalloc(U_GNSS_MSG_INJECT_BATCH_SIZE_BYTES);
+        if ((pQueue->pBuffer != NULL) && (pInject->pBatch != NULL) &&
+            (uPortSemaphoreCreate(&(pQueue->semaphoreHandle), 0, 1) == 0) &&
+            (uPortMutexCreate(&(pQueue->taskRunningMutexHandle)) == 0)) {
+            errorCode = uPortTaskCreate(msgInjectTask, "gnssMsgInject",
+                                        U_GNSS_MSG_INJECT_TASK_STACK_SIZE_BYTES,
+                                        pInject, U_GNSS_MSG_INJECT_TASK_PRIORITY,
+                                        &(pQueue->taskHandle));
+            if (errorCode == 0) {
+                // Wait for the task to lock the mutex,
+                // which shows it is running
+                while (uPortMutexTryLock(pQueue->taskRunningMutexHandle, 0) == 0) {
+                    uPortMutexUnlock(pQueue->taskRunningMutexHandle);
+                    uPortTaskBlock(U_CFG_OS_YIELD_MS);
+                }
+            } else {
+                pQueue->taskHandle = NULL;
+            }
+        }
+        if (errorCode != 0) {
+            // Clean up on error
+            injectFree(pInject);
+            pInject = NULL;
+        }
+    }
+
+    return pInject;
+}
+
 // Task that runs the non-blocking message receive.
 static void msgReceiveTask(void *pParam)
 {
@@ -149,6 +811,7 @@ static void msgReceiveTask(void *pParam)
     size_t discardSize = 0;
     uGnssMessageId_t messageId;
     uGnssPrivateMessageId_t privateMessageId;
+    uGnssPrivateMessageFilter_t filter;
     char nmeaId[U_GNSS_NMEA_MESSAGE_MATCH_LENGTH_CHARACTERS + 1];
 
     U_PORT_MUTEX_LOCK(pMsgReceive->taskRunningMutexHandle);
@@ -183,22 +846,40 @@ static void msgReceiveTask(void *pParam)
                                                                        pMsgReceive->ringBufferReadHandle,
                                                                        &privateMessageId);
                 if ((errorCodeOrLength > 0) || (errorCodeOrLength == (int32_t) U_GNSS_ERROR_NACK)) {
-                    // Remember how long the message is
+                    // Remember how long the message is and where it starts
                     pMsgReceive->msgBytesLeftToRead = 0;
                     if (errorCodeOrLength > 0) {
                         pMsgReceive->msgBytesLeftToRead = errorCodeOrLength;
                     }
+                    pMsgReceive->msgPosition = uGnssPrivateStreamGetPosition(pInstance,
+                                                                             pMsgReceive->ringBufferReadHandle);
 
                     if (uGnssPrivateMessageIdToPublic(&privateMessageId, &messageId, nmeaId) == 0) {
                         // Got something, with a message ID now in public form;
-                        // go through the list of readers looking for those interested
+                        // compile the ID once and then go through the list
+                        // of readers looking for those interested
+                        uGnssPrivateMessageFilterCompile(&privateMessageId, &filter);
 
                         U_PORT_MUTEX_LOCK(pMsgReceive->readerMutexHandle);
 
+                        // Queued readers first, since that is quick and
+                        // they then can't be held up by the callbacks
+                        // of the others
                         pReader = pMsgReceive->pReaderList;
                         while (pReader != NULL) {
-                            if (uGnssPrivateMessageIdIsWanted(&privateMessageId,
-                                                              &(pReader->privateMessageId))) {
+                            if ((pReader->pQueue != NULL) &&
+                                uGnssPrivateMessageFilterIsWanted(&filter, &(pReader->filter))) {
+                                queuePush(pInstance, pMsgReceive->ringBufferReadHandle,
+                                          (uGnssMsgQueue_t *) pReader->pQueue,
+                                          &privateMessageId, errorCodeOrLength);
+                            }
+                            pReader = pReader->pNext;
+                        }
+
+                        pReader = pMsgReceive->pReaderList;
+                        while (pReader != NULL) {
+                            if ((pReader->pQueue == NULL) &&
+                                uGnssPrivateMessageFilterIsWanted(&filter, &(pReader->filter))) {
                                 // This reader is interested, call the callback
                                 ((uGnssMsgReceiveCallback_t) pReader->pCallback)(pInstance->gnssHandle,
                                                                                  &messageId,
@@ -227,7 +908,9 @@ static void msgReceiveTask(void *pParam)
         if ((receiveSize == 0) && (errorCodeOrLength != (int32_t) U_ERROR_COMMON_TIMEOUT))  {
             yieldTimeMs *= 2;
         }
-        uPortTaskBlock(yieldTimeMs);
+        // This will return early if there is a TX ready interrupt
+        // telling us that the GNSS chip has data
+        uGnssPrivateStreamWaitForData(pInstance, yieldTimeMs);
     }
 
     // Now we can unlock our ring buffer read handle.  Phew.
@@ -248,6 +931,7 @@ int32_t msgReceiveCallbackRead(uDeviceHandle_t gnssHandle,
     int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
     uGnssPrivateMsgReceive_t *pMsgReceive;
     uGnssPrivateInstance_t *pInstance;
+    uGnssMsgQueue_t *pQueue;
 
     pInstance = pUGnssPrivateGetInstance(gnssHandle);
     if ((pInstance != NULL) && (pBuffer != NULL)) {
@@ -272,21 +956,34 @@ int32_t msgReceiveCallbackRead(uDeviceHandle_t gnssHandle,
                                                                      pBuffer, size, 0,
                                                                      U_GNSS_MSG_READ_TIMEOUT_MS);
             }
+        } else {
+            // Might be a queued reader, in which case the
+            // message is read from its queue
+            pQueue = pQueueGetThisTask();
+            if (pQueue != NULL) {
+                if (size > pQueue->msgBytesLeftToRead) {
+                    size = pQueue->msgBytesLeftToRead;
+                }
+                queueCopyOut(pQueue, pQueue->msgReadIndex, pBuffer, size);
+                if (andRemove) {
+                    pQueue->msgReadIndex = (pQueue->msgReadIndex + size) % pQueue->size;
+                    pQueue->msgBytesLeftToRead -= size;
+                }
+                errorCodeOrLength = (int32_t) size;
+            }
         }
     }
 
     return errorCodeOrLength;
 }
 
-/* ----------------------------------------------------------------
- * PUBLIC FUNCTIONS THAT ARE PRIVATE TO GNSS
- * -------------------------------------------------------------- */
-
-// Start monitoring the output of the GNSS chip for a message.
-int32_t uGnssMsgPrivateReceiveStart(uGnssPrivateInstance_t *pInstance,
-                                    const uGnssPrivateMessageId_t *pPrivateMessageId,
-                                    uGnssMsgReceiveCallback_t pCallback,
-                                    void *pCallbackParam)
+// Start monitoring the output of the GNSS chip for a message,
+// pQueue being non-NULL if the reader has a queue of its own.
+static int32_t receiveStart(uGnssPrivateInstance_t *pInstance,
+                            const uGnssPrivateMessageId_t *pPrivateMessageId,
+                            uGnssMsgReceiveCallback_t pCallback,
+                            void *pCallbackParam,
+                            uGnssMsgQueue_t *pQueue)
 {
     int32_t errorCodeOrHandle = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
     uGnssPrivateMsgReceive_t *pMsgReceive;
@@ -380,8 +1077,10 @@ int32_t uGnssMsgPrivateReceiveStart(uGnssPrivateInstance_t *pInstance,
             pReader->handle = pInstance->pMsgReceive->nextHandle;
             pInstance->pMsgReceive->nextHandle++;
             pReader->privateMessageId = *pPrivateMessageId;
+            uGnssPrivateMessageFilterCompile(pPrivateMessageId, &(pReader->filter));
             pReader->pCallback = (void *) pCallback;
             pReader->pCallbackParam = pCallbackParam;
+            pReader->pQueue = (void *) pQueue;
             pReader->pNext = pInstance->pMsgReceive->pReaderList;
 
             U_PORT_MUTEX_LOCK(pInstance->pMsgReceive->readerMutexHandle);
@@ -398,6 +1097,142 @@ int32_t uGnssMsgPrivateReceiveStart(uGnssPrivateInstance_t *pInstance,
     return errorCodeOrHandle;
 }
 
+// Get a pointer to part of a message, for a user's callback.
+static int32_t msgReceiveCallbackPeekSpan(uDeviceHandle_t gnssHandle,
+                                          const char **ppSpan,
+                                          size_t offset)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssPrivateMsgReceive_t *pMsgReceive;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssMsgQueue_t *pQueue;
+    size_t index;
+    size_t length = 0;
+
+    pInstance = pUGnssPrivateGetInstance(gnssHandle);
+    if ((pInstance != NULL) && (ppSpan != NULL)) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        pMsgReceive = pInstance->pMsgReceive;
+        if ((pMsgReceive != NULL) &&
+            uPortTaskIsThis(pMsgReceive->taskHandle)) {
+            // The read handle is locked by msgReceiveTask() so
+            // the data can't be overwritten under our feet
+            if (offset < pMsgReceive->msgBytesLeftToRead) {
+                length = uRingBufferPeekSpanHandle(&(pInstance->ringBuffer),
+                                                   pMsgReceive->ringBufferReadHandle,
+                                                   ppSpan,
+                                                   pMsgReceive->msgBytesLeftToRead - offset,
+                                                   offset);
+            }
+            errorCodeOrLength = (int32_t) length;
+        } else {
+            pQueue = pQueueGetThisTask();
+            if (pQueue != NULL) {
+                // The space is only given back to msgReceiveTask()
+                // when the callback has returned
+                if (offset < pQueue->msgBytesLeftToRead) {
+                    index = (pQueue->msgReadIndex + offset) % pQueue->size;
+                    length = pQueue->msgBytesLeftToRead - offset;
+                    if (length > pQueue->size - index) {
+                        length = pQueue->size - index;
+                    }
+                    *ppSpan = pQueue->pBuffer + index;
+                }
+                errorCodeOrLength = (int32_t) length;
+            }
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Get the arrival time of a message, for a user's callback.
+static int32_t msgReceiveCallbackGetArrivalTime(uDeviceHandle_t gnssHandle,
+                                                int32_t *pTimeMs)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssPrivateMsgReceive_t *pMsgReceive;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssMsgQueue_t *pQueue;
+
+    pInstance = pUGnssPrivateGetInstance(gnssHandle);
+    if ((pInstance != NULL) && (pTimeMs != NULL)) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        pMsgReceive = pInstance->pMsgReceive;
+        if ((pMsgReceive != NULL) &&
+            uPortTaskIsThis(pMsgReceive->taskHandle)) {
+            errorCode = uGnssPrivateStreamGetArrivalTime(pInstance, pMsgReceive->msgPosition,
+                                                         pTimeMs);
+        } else {
+            pQueue = pQueueGetThisTask();
+            if (pQueue != NULL) {
+                errorCode = pQueue->msgArrivalErrorCode;
+                if (errorCode == 0) {
+                    *pTimeMs = pQueue->msgArrivalTimeMs;
+                }
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS THAT ARE PRIVATE TO GNSS
+ * -------------------------------------------------------------- */
+
+// Start monitoring the output of the GNSS chip for a message.
+int32_t uGnssMsgPrivateReceiveStart(uGnssPrivateInstance_t *pInstance,
+                                    const uGnssPrivateMessageId_t *pPrivateMessageId,
+                                    uGnssMsgReceiveCallback_t pCallback,
+                                    void *pCallbackParam)
+{
+    return receiveStart(pInstance, pPrivateMessageId, pCallback,
+                        pCallbackParam, NULL);
+}
+
+// Start monitoring the output of the GNSS chip for a message,
+// with a queue and task of its own.
+int32_t uGnssMsgPrivateReceiveStartQueued(uGnssPrivateInstance_t *pInstance,
+                                          const uGnssPrivateMessageId_t *pPrivateMessageId,
+                                          uGnssMsgReceiveCallback_t pCallback,
+                                          void *pCallbackParam,
+                                          size_t queueSizeBytes)
+{
+    int32_t errorCodeOrHandle = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssMsgQueue_t *pQueue;
+
+    if ((pInstance != NULL) && (pPrivateMessageId != NULL) && (pCallback != NULL)) {
+        if (queueSizeBytes == 0) {
+            queueSizeBytes = U_GNSS_MSG_RECEIVE_QUEUE_SIZE_BYTES;
+        }
+        errorCodeOrHandle = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        pQueue = pQueueCreate(pInstance->gnssHandle, pCallback,
+                              pCallbackParam, queueSizeBytes);
+        if (pQueue != NULL) {
+            errorCodeOrHandle = receiveStart(pInstance, pPrivateMessageId,
+                                             pCallback, pCallbackParam,
+                                             pQueue);
+            if (errorCodeOrHandle < 0) {
+                queueFree(pQueue);
+            }
+        }
+    }
+
+    return errorCodeOrHandle;
+}
+
+// Free a message reader.
+void uGnssMsgPrivateReaderFree(uGnssPrivateMsgReader_t *pReader)
+{
+    if (pReader != NULL) {
+        if (pReader->pQueue != NULL) {
+            queueFree((uGnssMsgQueue_t *) pReader->pQueue);
+        }
+        uPortFree(pReader);
+    }
+}
+
 // Stop monitoring the output of the GNSS chip for a message.
 int32_t uGnssMsgPrivateReceiveStop(uGnssPrivateInstance_t *pInstance,
                                    int32_t asyncHandle)
@@ -406,6 +1241,7 @@ int32_t uGnssMsgPrivateReceiveStop(uGnssPrivateInstance_t *pInstance,
     uGnssPrivateMsgReceive_t *pMsgReceive;
     uGnssPrivateMsgReader_t *pCurrent;
     uGnssPrivateMsgReader_t *pPrev = NULL;
+    uGnssPrivateMsgReader_t *pRemoved = NULL;
 
     if (pInstance != NULL) {
         errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
@@ -424,7 +1260,7 @@ int32_t uGnssMsgPrivateReceiveStop(uGnssPrivateInstance_t *pInstance,
                     } else {
                         pMsgReceive->pReaderList = pCurrent->pNext;
                     }
-                    uPortFree(pCurrent);
+                    pRemoved = pCurrent;
                     pCurrent = NULL;
                     errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
                 } else {
@@ -435,6 +1271,11 @@ int32_t uGnssMsgPrivateReceiveStop(uGnssPrivateInstance_t *pInstance,
 
             U_PORT_MUTEX_UNLOCK(pMsgReceive->readerMutexHandle);
 
+            // Free the reader outside the lock since, if it has
+            // a task of its own, that task may need the lock in
+            // order to exit
+            uGnssMsgPrivateReaderFree(pRemoved);
+
             if (pMsgReceive->pReaderList == NULL) {
                 // All gone, shut the task etc. down also
                 uGnssPrivateStopMsgReceive(pInstance);
@@ -446,6 +1287,18 @@ int32_t uGnssMsgPrivateReceiveStop(uGnssPrivateInstance_t *pInstance,
     return errorCode;
 }
 
+// Stop correction injection.
+void uGnssMsgPrivateInjectStop(uGnssPrivateInstance_t *pInstance)
+{
+    uGnssMsgInject_t *pInject;
+
+    if ((pInstance != NULL) && (pInstance->pMsgInject != NULL)) {
+        pInject = (uGnssMsgInject_t *) pInstance->pMsgInject;
+        pInstance->pMsgInject = NULL;
+        injectFree(pInject);
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: MISC
  * -------------------------------------------------------------- */
@@ -503,7 +1356,6 @@ int32_t uGnssMsgSend(uDeviceHandle_t gnssHandle, const char *pBuffer, size_t siz
 {
     int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     uGnssPrivateInstance_t *pInstance;
-    int32_t privateStreamType;
 
     if (gUGnssPrivateMutex != NULL) {
 
@@ -512,81 +1364,7 @@ int32_t uGnssMsgSend(uDeviceHandle_t gnssHandle, const char *pBuffer, size_t siz
         errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         pInstance = pUGnssPrivateGetInstance(gnssHandle);
         if ((pInstance != NULL) && (pBuffer != NULL)) {
-
-            errorCodeOrLength = (int32_t) U_GNSS_ERROR_TRANSPORT;
-            privateStreamType = uGnssPrivateGetStreamType(pInstance->transportType);
-
-            U_PORT_MUTEX_LOCK(pInstance->transportMutex);
-
-            if (privateStreamType >= 0) {
-                // Streaming transport
-                switch (privateStreamType) {
-                    case U_GNSS_PRIVATE_STREAM_TYPE_UART: {
-                        errorCodeOrLength = uPortUartWrite(pInstance->transportHandle.uart,
-                                                           pBuffer, size);
-                    }
-                    break;
-                    case U_GNSS_PRIVATE_STREAM_TYPE_I2C: {
-                        errorCodeOrLength = uPortI2cControllerSend(pInstance->transportHandle.i2c,
-                                                                   pInstance->i2cAddress,
-                                                                   pBuffer, size, false);
-                        if (errorCodeOrLength == 0) {
-                            errorCodeOrLength = (int32_t) size;
-                        }
-                    }
-                    break;
-                    case U_GNSS_PRIVATE_STREAM_TYPE_SPI: {
-                        char spiBuffer[U_GNSS_SPI_FILL_THRESHOLD_MAX];
-                        size_t offset = 0;
-                        size_t thisSize;
-                        // Since SPI is symmetrical, we must necessarily receive
-                        // when we send.  We don't want to allocate a receive
-                        // buffer here though, so we send in chunks of length
-                        // up to our SPI fill-checking buffer ('cos it's a
-                        // convenient length).
-                        errorCodeOrLength = 0;
-                        for (size_t x = 0; (offset < size) && (errorCodeOrLength >= 0); x++) {
-                            thisSize = size - offset;
-                            if (thisSize > U_GNSS_SPI_FILL_THRESHOLD_MAX) {
-                                thisSize = U_GNSS_SPI_FILL_THRESHOLD_MAX;
-                            }
-                            errorCodeOrLength = uPortSpiControllerSendReceiveBlock(pInstance->transportHandle.spi,
-                                                                                   pBuffer + offset,
-                                                                                   thisSize,
-                                                                                   spiBuffer,
-                                                                                   thisSize);
-                            if (errorCodeOrLength > 0) {
-                                offset += errorCodeOrLength;
-                                // This will add any non-fill SPI received data to the
-                                // internal SPI ring buffer
-                                uGnssPrivateSpiAddReceivedData(pInstance, spiBuffer, errorCodeOrLength);
-                            }
-                        }
-                        if (errorCodeOrLength >= 0) {
-                            errorCodeOrLength = offset;
-                        }
-                    }
-                    break;
-                    case U_GNSS_PRIVATE_STREAM_TYPE_VIRTUAL_SERIAL: {
-                        uDeviceSerial_t *pDeviceSerial = pInstance->transportHandle.pDeviceSerial;
-                        if (pDeviceSerial != NULL) {
-                            errorCodeOrLength = pDeviceSerial->write(pDeviceSerial, pBuffer, size);
-                        }
-                    }
-                    break;
-                    default:
-                        break;
-                }
-                if (errorCodeOrLength == size) {
-                    if (pInstance->printUbxMessages) {
-                        uPortLog("U_GNSS: sent message");
-                        uGnssPrivatePrintBuffer(pBuffer, size);
-                        uPortLog(".\n");
-                    }
-                }
-            }
-
-            U_PORT_MUTEX_UNLOCK(pInstance->transportMutex);
+            errorCodeOrLength = msgSend(pInstance, pBuffer, size);
         }
 
         U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
@@ -657,6 +1435,39 @@ int32_t uGnssMsgReceiveStart(uDeviceHandle_t gnssHandle,
     return errorCodeOrHandle;
 }
 
+// Monitor the output of the GNSS chip for a message, async version
+// with a queue and task of its own.
+int32_t uGnssMsgReceiveStartQueued(uDeviceHandle_t gnssHandle,
+                                   const uGnssMessageId_t *pMessageId,
+                                   uGnssMsgReceiveCallback_t pCallback,
+                                   void *pCallbackParam,
+                                   size_t queueSizeBytes)
+{
+    int32_t errorCodeOrHandle = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssPrivateMessageId_t privateMessageId;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCodeOrHandle = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if ((pInstance != NULL) &&
+            (uGnssPrivateMessageIdToPrivate(pMessageId, &privateMessageId) == 0)) {
+            errorCodeOrHandle = uGnssMsgPrivateReceiveStartQueued(pInstance,
+                                                                  &privateMessageId,
+                                                                  pCallback,
+                                                                  pCallbackParam,
+                                                                  queueSizeBytes);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCodeOrHandle;
+}
+
 // Read a message from the ring buffer into a user's buffer.
 // This function does NOT lock gUGnssPrivateMutex in order
 // that it can be called from pCallback; this is fine since
@@ -668,6 +1479,18 @@ int32_t uGnssMsgReceiveCallbackRead(uDeviceHandle_t gnssHandle,
     return msgReceiveCallbackRead(gnssHandle, pBuffer, size, false);
 }
 
+// Get a pointer to part of a message in the ring buffer.
+// This function does NOT lock gUGnssPrivateMutex in order
+// that it can be called from pCallback; this is fine since
+// the asynchronous receive task is brought up and torn down
+// in an organised way.
+int32_t uGnssMsgReceiveCallbackPeekSpan(uDeviceHandle_t gnssHandle,
+                                        const char **ppSpan,
+                                        size_t offset)
+{
+    return msgReceiveCallbackPeekSpan(gnssHandle, ppSpan, offset);
+}
+
 // Extract a message from the ring buffer into a user's buffer.
 // This function does NOT lock gUGnssPrivateMutex in order
 // that it can be called from pCallback; this is fine since
@@ -679,6 +1502,17 @@ int32_t uGnssMsgReceiveCallbackExtract(uDeviceHandle_t gnssHandle,
     return msgReceiveCallbackRead(gnssHandle, pBuffer, size, true);
 }
 
+// Get the arrival time of the message being passed to pCallback.
+// This function does NOT lock gUGnssPrivateMutex in order
+// that it can be called from pCallback; this is fine since
+// the asynchronous receive task is brought up and torn down
+// in an organised way.
+int32_t uGnssMsgReceiveCallbackGetArrivalTime(uDeviceHandle_t gnssHandle,
+                                              int32_t *pTimeMs)
+{
+    return msgReceiveCallbackGetArrivalTime(gnssHandle, pTimeMs);
+}
+
 // Stop monitoring the output of the GNSS chip for a message.
 int32_t uGnssMsgReceiveStop(uDeviceHandle_t gnssHandle, int32_t asyncHandle)
 {
@@ -769,6 +1603,47 @@ size_t uGnssMsgReceiveStatReadLoss(uDeviceHandle_t gnssHandle)
     return bytesLost;
 }
 
+// Count of messages lost by a queued receiver.
+int32_t uGnssMsgReceiveStatQueueLoss(uDeviceHandle_t gnssHandle,
+                                     int32_t asyncHandle)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssPrivateMsgReader_t *pReader;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCodeOrCount = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            errorCodeOrCount = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            if (pInstance->pMsgReceive != NULL) {
+
+                U_PORT_MUTEX_LOCK(pInstance->pMsgReceive->readerMutexHandle);
+
+                pReader = pInstance->pMsgReceive->pReaderList;
+                while ((pReader != NULL) && (pReader->handle != asyncHandle)) {
+                    pReader = pReader->pNext;
+                }
+                if (pReader != NULL) {
+                    errorCodeOrCount = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+                    if (pReader->pQueue != NULL) {
+                        errorCodeOrCount = ((uGnssMsgQueue_t *) pReader->pQueue)->lossCount;
+                    }
+                }
+
+                U_PORT_MUTEX_UNLOCK(pInstance->pMsgReceive->readerMutexHandle);
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCodeOrCount;
+}
+
 // Count of bytes lost at the input of the ring buffer.
 size_t uGnssMsgReceiveStatStreamLoss(uDeviceHandle_t gnssHandle)
 {
@@ -793,4 +1668,142 @@ size_t uGnssMsgReceiveStatStreamLoss(uDeviceHandle_t gnssHandle)
     return bytesLost;
 }
 
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: CORRECTION INJECTION
+ * -------------------------------------------------------------- */
+
+// Start correction injection.
+int32_t uGnssMsgInjectStart(uDeviceHandle_t gnssHandle,
+                            size_t queueSizeBytes,
+                            int32_t maxRateBytesPerSecond)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if ((pInstance != NULL) && (maxRateBytesPerSecond >= 0)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if (uGnssPrivateGetStreamType(pInstance->transportType) >= 0) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if (pInstance->pMsgInject != NULL) {
+                    // Already running, just change the rate
+                    ((uGnssMsgInject_t *) pInstance->pMsgInject)->maxRateBytesPerSecond = maxRateBytesPerSecond;
+                } else {
+                    if (queueSizeBytes == 0) {
+                        queueSizeBytes = U_GNSS_MSG_INJECT_QUEUE_SIZE_BYTES;
+                    }
+                    pInstance->pMsgInject = pInjectCreate(pInstance, queueSizeBytes,
+                                                          maxRateBytesPerSecond);
+                    if (pInstance->pMsgInject == NULL) {
+                        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                    }
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Queue correction data for injection.
+// This function does NOT lock gUGnssPrivateMutex, so that the caller
+// is never held up by another GNSS API call that is waiting on the
+// GNSS chip; this is fine since the injection task is brought up
+// and torn down in an organised way.
+int32_t uGnssMsgInject(uDeviceHandle_t gnssHandle,
+                       const char *pBuffer, size_t size)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssMsgQueue_t *pQueue;
+    size_t space;
+
+    pInstance = pUGnssPrivateGetInstance(gnssHandle);
+    if ((pInstance != NULL) && ((pBuffer != NULL) || (size == 0))) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+        if (pInstance->pMsgInject != NULL) {
+            pQueue = &(((uGnssMsgInject_t *) pInstance->pMsgInject)->queue);
+            // One byte is always left empty so that a full queue
+            // can be told apart from an empty one
+            space = pQueue->size - 1 - queueUsed(pQueue, pQueue->writeIndex,
+                                                 pQueue->readIndex);
+            if (size > space) {
+                size = space;
+            }
+            if (size > 0) {
+                pQueue->writeIndex = queueCopyIn(pQueue, pQueue->writeIndex,
+                                                 pBuffer, size);
+                uPortSemaphoreGive(pQueue->semaphoreHandle);
+            }
+            errorCodeOrLength = (int32_t) size;
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Stop correction injection.
+int32_t uGnssMsgInjectStop(uDeviceHandle_t gnssHandle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            uGnssMsgPrivateInjectStop(pInstance);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Get the statistics of correction injection.
+int32_t uGnssMsgInjectStat(uDeviceHandle_t gnssHandle,
+                           size_t *pSentBytes, size_t *pDiscardedBytes)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssMsgInject_t *pInject;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            pInject = (uGnssMsgInject_t *) pInstance->pMsgInject;
+            if (pInject != NULL) {
+                if (pSentBytes != NULL) {
+                    *pSentBytes = pInject->sentCount;
+                }
+                if (pDiscardedBytes != NULL) {
+                    *pDiscardedBytes = pInject->discardCount;
+                }
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 // End of file
@@ -80,6 +80,40 @@ int32_t uGnssMsgPrivateReceiveStart(uGnssPrivateInstance_t *pInstance,
                                     uGnssMsgReceiveCallback_t pCallback,
                                     void *pCallbackParam);
 
+/** As uGnssMsgPrivateReceiveStart() but pCallback is called from
+ * a task of its own, fed by a queue of queueSizeBytes, so that it
+ * does not hold up any other reader; see uGnssMsgReceiveStartQueued()
+ * for the details.
+ *
+ * @param[in] pInstance          a pointer to the GNSS instance, cannot
+ *                               be NULL.
+ * @param[in] pPrivateMessageId  a pointer to the message ID to capture;
+ *                               a copy will be taken so this may be
+ *                               on the stack; cannot be NULL.
+ * @param[in] pCallback          the callback to be called when a
+ *                               matching message arrives, cannot be NULL.
+ * @param[in] pCallbackParam     will be passed to pCallback as its last
+ *                               parameter.
+ * @param queueSizeBytes         the size of the queue in bytes, zero for
+ *                               #U_GNSS_MSG_RECEIVE_QUEUE_SIZE_BYTES.
+ * @return                       a handle for this asynchronous reader on
+ *                               success, else negative error code.
+ */
+int32_t uGnssMsgPrivateReceiveStartQueued(uGnssPrivateInstance_t *pInstance,
+                                          const uGnssPrivateMessageId_t *pPrivateMessageId,
+                                          uGnssMsgReceiveCallback_t pCallback,
+                                          void *pCallbackParam,
+                                          size_t queueSizeBytes);
+
+/** Free a message reader, shutting down its task first if it has
+ * one; the reader must already have been removed from the reader
+ * list, or the message receive task must have been stopped, and
+ * the reader mutex must NOT be locked.
+ *
+ * @param[in] pReader a pointer to the reader to free; may be NULL.
+ */
+void uGnssMsgPrivateReaderFree(uGnssPrivateMsgReader_t *pReader);
+
 /** Stop monitoring the output of the GNSS chip for a message.
  * Once this function returns the pCallback function passed to the
  * associated uGnssMsgPrivateReceiveStart() will no longer be called.
@@ -92,6 +126,13 @@ int32_t uGnssMsgPrivateReceiveStart(uGnssPrivateInstance_t *pInstance,
 int32_t uGnssMsgPrivateReceiveStop(uGnssPrivateInstance_t *pInstance,
                                    int32_t asyncHandle);
 
+/** Stop correction injection, as started by uGnssMsgInjectStart(),
+ * freeing its resources; does nothing if it was not started.
+ *
+ * @param[in] pInstance a pointer to the GNSS instance, cannot be NULL.
+ */
+void uGnssMsgPrivateInjectStop(uGnssPrivateInstance_t *pInstance);
+
 #ifdef __cplusplus
 }
 #endif
@@ -59,6 +59,7 @@
 #include "u_gnss_msg.h"
 #include "u_gnss_msg_private.h"
 #include "u_gnss_pos.h"
+#include "u_gnss_dec.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -85,6 +86,15 @@
 # define U_GNSS_POS_CALLBACK_TASK_STACK_DELAY_SECONDS 5
 #endif
 
+#ifndef U_GNSS_POS_STREAMED_FIX_MESSAGE_LENGTH_BYTES
+/** The size of the buffer used by uGnssPosGetStreamedFixStart() to
+ * read each message into: must be at least as large as the largest
+ * of UBX-NAV-PVT, UBX-NAV-HPPOSLLH and UBX-NAV-COV, including the
+ * UBX protocol overhead, with some room for future expansion.
+ */
+# define U_GNSS_POS_STREAMED_FIX_MESSAGE_LENGTH_BYTES 128
+#endif
+
 #ifndef U_GNSS_POS_RRLP_HEADER_SIZE_BYTES
 /** The number of bytes of UBX protocol header that
  * will be added to the front of the raw RRLP binary data.
@@ -92,6 +102,10 @@
 #define U_GNSS_POS_RRLP_HEADER_SIZE_BYTES (U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES - 2)
 #endif
 
+/** The smallest UBX-RXM-MEASX message body, that with no satellites.
+ */
+#define U_GNSS_POS_RRLP_MEASX_LENGTH_MIN_BYTES 44
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -112,6 +126,26 @@ typedef struct {
                        int64_t timeUtc);
 } uGnssPosGetTaskParameters_t;
 
+/** Context for uGnssPosGetStreamedFixStart(), hooked into the
+ * pFixContext field of uGnssPrivateStreamedPosition_t; everything
+ * needed per epoch is in here so that nothing need be allocated
+ * at run-time.
+ */
+typedef struct {
+    void (*pCallback) (uDeviceHandle_t gnssHandle,
+                       const uGnssPosFix_t *pFix,
+                       void *pCallbackParam);
+    void *pCallbackParam;
+    uint32_t contentsBitmap; /**< the wanted contents. */
+    int32_t firstMessageTimeMs; /**< when the first message of fix arrived. */
+    uGnssPosFix_t fix; /**< the fix being assembled. */
+    uGnssPosStatLatency_t stat;
+    int64_t latencySumMs; /**< to calculate stat.averageMs. */
+    char message[U_GNSS_POS_STREAMED_FIX_MESSAGE_LENGTH_BYTES];
+    uGnssDec_t dec;
+    uGnssDecUnion_t body;
+} uGnssPosStreamedFix_t;
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
@@ -281,6 +315,7 @@ static void posGetTask(void *pParameter)
     int32_t speedMillimetresPerSecond = INT_MIN;
     int32_t svs = -1;
     int64_t timeUtc = -1;
+    int32_t wakeTimeMs;
 
     // Copy the parameter into our local variable and free it
     memcpy(&taskParameters, pParameter, sizeof(taskParameters));
@@ -290,6 +325,7 @@ static void posGetTask(void *pParameter)
     U_PORT_MUTEX_LOCK(taskParameters.pInstance->posMutex);
 
     startTime = uPortGetTickTimeMs();
+    wakeTimeMs = (int32_t) startTime;
     taskParameters.pInstance->posTaskFlags |= U_GNSS_POS_TASK_FLAG_HAS_RUN;
 
     while ((taskParameters.pInstance->posTaskFlags & U_GNSS_POS_TASK_FLAG_KEEP_GOING) &&
@@ -305,7 +341,9 @@ static void posGetTask(void *pParameter)
                            &svs,
                            &timeUtc, false);
         if (errorCode != 0) {
-            uPortTaskBlock(U_GNSS_POS_CALLBACK_TASK_STACK_DELAY_SECONDS * 1000);
+            // Attempts are made at a fixed period, however long
+            // each one takes
+            uPortTaskBlockUntil(&wakeTimeMs, U_GNSS_POS_CALLBACK_TASK_STACK_DELAY_SECONDS * 1000);
         }
     }
 
@@ -369,6 +407,469 @@ static void messageCallback(uDeviceHandle_t gnssHandle,
     }
 }
 
+// Deliver the fix that has been assembled for
+// uGnssPosGetStreamedFixStart() and start afresh.
+static void fixDeliver(uDeviceHandle_t gnssHandle,
+                       uGnssPosStreamedFix_t *pContext)
+{
+    uGnssPosStatLatency_t *pStat = &(pContext->stat);
+    int32_t latencyMs = uPortGetTickTimeMs() - pContext->firstMessageTimeMs;
+
+    if ((pContext->fix.contentsBitmap & pContext->contentsBitmap) != pContext->contentsBitmap) {
+        pStat->numIncomplete++;
+    }
+    pStat->numFixes++;
+    pStat->lastMs = latencyMs;
+    if ((pStat->numFixes == 1) || (latencyMs < pStat->minMs)) {
+        pStat->minMs = latencyMs;
+    }
+    if (latencyMs > pStat->maxMs) {
+        pStat->maxMs = latencyMs;
+    }
+    pContext->latencySumMs += latencyMs;
+    pStat->averageMs = (int32_t) (pContext->latencySumMs / pStat->numFixes);
+
+    pContext->fix.latencyMs = latencyMs;
+    pContext->pCallback(gnssHandle, &(pContext->fix), pContext->pCallbackParam);
+
+    memset(&(pContext->fix), 0, sizeof(pContext->fix));
+}
+
+// Callback that receives the UBX-NAV class messages for
+// uGnssPosGetStreamedFixStart().
+static void fixMessageCallback(uDeviceHandle_t gnssHandle,
+                               const uGnssMessageId_t *pMessageId,
+                               int32_t errorCodeOrLength,
+                               void *pCallbackParam)
+{
+    uGnssPrivateInstance_t *pInstance = (uGnssPrivateInstance_t *) pCallbackParam;
+    uGnssPrivateStreamedPosition_t *pStreamedPosition = pInstance->pStreamedPosition;
+    uGnssPosStreamedFix_t *pContext = (uGnssPosStreamedFix_t *) pStreamedPosition->pFixContext;
+    int32_t content = -1;
+    uint32_t iTOW = 0;
+    const void *pSource = NULL;
+    void *pDestination = NULL;
+    size_t size = 0;
+
+    if ((errorCodeOrLength > 0) && (pMessageId->type == U_GNSS_PROTOCOL_UBX)) {
+        for (size_t x = 0; (content < 0) && (x < U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES); x++) {
+            if (pMessageId->id.ubx == gUGnssPrivateStreamedPosMessage[x].ubxMessageId) {
+                content = (int32_t) x;
+            }
+        }
+        if ((content >= 0) && (pContext->contentsBitmap & (1UL << content))) {
+            if (errorCodeOrLength > (int32_t) sizeof(pContext->message)) {
+                errorCodeOrLength = sizeof(pContext->message);
+            }
+            errorCodeOrLength = uGnssMsgReceiveCallbackRead(gnssHandle,
+                                                            pContext->message,
+                                                            errorCodeOrLength);
+            if ((errorCodeOrLength > 0) &&
+                (uGnssDecDecode(pContext->message, errorCodeOrLength,
+                                &(pContext->dec), &(pContext->body)) == 0)) {
+                switch (content) {
+                    case U_GNSS_POS_FIX_CONTENT_PVT:
+                        iTOW = (uint32_t) pContext->body.ubxNavPvt.iTOW;
+                        pSource = &(pContext->body.ubxNavPvt);
+                        pDestination = &(pContext->fix.pvt);
+                        size = sizeof(pContext->fix.pvt);
+                        break;
+                    case U_GNSS_POS_FIX_CONTENT_HPPOSLLH:
+                        iTOW = (uint32_t) pContext->body.ubxNavHpposllh.iTOW;
+                        pSource = &(pContext->body.ubxNavHpposllh);
+                        pDestination = &(pContext->fix.hpposllh);
+                        size = sizeof(pContext->fix.hpposllh);
+                        break;
+                    case U_GNSS_POS_FIX_CONTENT_COV:
+                        iTOW = pContext->body.ubxNavCov.iTOW;
+                        pSource = &(pContext->body.ubxNavCov);
+                        pDestination = &(pContext->fix.cov);
+                        size = sizeof(pContext->fix.cov);
+                        break;
+                    default:
+                        break;
+                }
+                // Note: there can be two handles involved here, e.g. if
+                // GNSS is inside a cellular device, hence we make sure
+                // we pass back the one that came in
+                if ((pContext->fix.contentsBitmap != 0) && (iTOW != pContext->fix.iTOW)) {
+                    // The next epoch has begun before the last was
+                    // complete: deliver what we have
+                    fixDeliver(pStreamedPosition->gnssHandle, pContext);
+                }
+                if (pContext->fix.contentsBitmap == 0) {
+                    pContext->fix.iTOW = iTOW;
+                    pContext->firstMessageTimeMs = pInstance->ringBufferAddTimeMs;
+                }
+                if (pDestination != NULL) {
+                    memcpy(pDestination, pSource, size);
+                    pContext->fix.contentsBitmap |= 1UL << content;
+                }
+                if (pContext->fix.contentsBitmap == pContext->contentsBitmap) {
+                    // Got everything we need for this epoch
+                    fixDeliver(pStreamedPosition->gnssHandle, pContext);
+                }
+            }
+        }
+    }
+}
+
+// Check that the body of a UBX-RXM-MEASX message, numBytes long,
+// meets the given criteria, returning numBytes if it does, else -1.
+static int32_t rrlpMeasxCheck(const uint8_t *pBody, int32_t numBytes,
+                              int32_t svsThreshold, int32_t cNoThreshold,
+                              int32_t multipathIndexLimit,
+                              int32_t pseudorangeRmsErrorIndexLimit,
+                              bool printIt)
+{
+    int32_t svs;
+    int32_t z;
+    int32_t numMeetingCriteria;
+    bool goodSatellite;
+
+    // 34 since that's the furthest we need to read to check on the number of satellites
+    if ((((svsThreshold >= 0) || (cNoThreshold >= 0) ||
+          (multipathIndexLimit >= 0) || (pseudorangeRmsErrorIndexLimit >= 0)) && (numBytes >= 34))) {
+        // The number of satellites is at offset 34
+        svs = *(pBody + 34);
+        if (printIt) {
+            uPortLog("U_GNSS_POS: RRLP information for %d satellite(s).\n", svs);
+        }
+        if ((svsThreshold >= 0) && (svs < svsThreshold)) {
+            // Not enough satellites in the first place
+            numBytes = -1;
+        }
+        if ((numBytes > 0) &&
+            ((cNoThreshold >= 0) || (multipathIndexLimit >= 0) || (pseudorangeRmsErrorIndexLimit >= 0))) {
+            numMeetingCriteria = svs;
+            // 65 since that's the furthest we need to check on the criteria
+            for (int8_t x = 0; (x < svs) && (numBytes >= 65 + (x * 24)); x++) {
+                goodSatellite = true;
+                // Carrier to noise ratio is at offset 46 + (x * 24)
+                if (cNoThreshold >= 0) {
+                    z = *(pBody + 46 + (x * 24));
+                    if (printIt) {
+                        uPortLog("U_GNSS_POS: RRLP CNo for satellite %d is %d.\n", x + 1, z);
+                    }
+                    if (z < cNoThreshold) {
+                        goodSatellite = false;
+                    }
+                }
+                // Multipath index is at offset 47 + (x * 24)
+                if (goodSatellite && (multipathIndexLimit >= 0)) {
+                    z = *(pBody + 47 + (x * 24));
+                    if (printIt) {
+                        uPortLog("U_GNSS_POS: RRLP multipath for satellite %d is %d.\n", x + 1, z);
+                    }
+                    if (z > multipathIndexLimit) {
+                        goodSatellite = false;
+                    }
+                }
+                // Pseudorange RMS error index is at offset 65 + (x * 24)
+                if (goodSatellite && (pseudorangeRmsErrorIndexLimit >= 0)) {
+                    z = *(pBody + 65 + (x * 24));
+                    if (printIt) {
+                        uPortLog("U_GNSS_POS: pseudorange RMS error index for satellite %d is %d.\n",
+                                 x + 1, z);
+                    }
+                    if (z > pseudorangeRmsErrorIndexLimit) {
+                        goodSatellite = false;
+                    }
+                }
+                if (!goodSatellite) {
+                    numMeetingCriteria--;
+                    if (printIt) {
+                        uPortLog("U_GNSS_POS: only up to %d satellite(s) meet the criteria.\n",
+                                 numMeetingCriteria);
+                    }
+                    if (numMeetingCriteria < svsThreshold) {
+                        // Force exit
+                        numBytes = -1;
+                    }
+                }
+            }
+        }
+    }
+
+    return numBytes;
+}
+
+// Pass the measurement sets accumulated by uGnssPosGetRrlpBatchStart()
+// to the user and start again at the beginning of the arena.
+static void rrlpBatchDeliver(uGnssPrivateRrlpBatch_t *pRrlpBatch)
+{
+    pRrlpBatch->pCallback(pRrlpBatch->gnssHandle, pRrlpBatch->pArena,
+                          pRrlpBatch->length, pRrlpBatch->numSets,
+                          pRrlpBatch->pCallbackParam);
+    pRrlpBatch->length = 0;
+    pRrlpBatch->numSets = 0;
+}
+
+// Message receive callback for uGnssPosGetRrlpBatchStart(), which
+// should receive a UBX-RXM-MEASX message.
+static void rrlpBatchMessageCallback(uDeviceHandle_t gnssHandle,
+                                     const uGnssMessageId_t *pMessageId,
+                                     int32_t errorCodeOrLength,
+                                     void *pCallbackParam)
+{
+    uGnssPrivateRrlpBatch_t *pRrlpBatch = (uGnssPrivateRrlpBatch_t *) pCallbackParam;
+    char *pSet;
+    int32_t numBytes;
+
+    (void) pMessageId;
+
+    if (errorCodeOrLength > U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES) {
+        if (((size_t) errorCodeOrLength > pRrlpBatch->arenaSize - pRrlpBatch->length) &&
+            (pRrlpBatch->numSets > 0)) {
+            // No room for this one: hand over what we have
+            // early rather than lose it
+            rrlpBatchDeliver(pRrlpBatch);
+        }
+        if ((size_t) errorCodeOrLength <= pRrlpBatch->arenaSize - pRrlpBatch->length) {
+            // Read the whole message, header and CRC included,
+            // straight into the arena, since that is the form
+            // the Cloud Locate service wants it in
+            pSet = pRrlpBatch->pArena + pRrlpBatch->length;
+            numBytes = uGnssMsgReceiveCallbackRead(gnssHandle, pSet, errorCodeOrLength);
+            if (numBytes == errorCodeOrLength) {
+                numBytes = rrlpMeasxCheck((const uint8_t *) pSet + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES,
+                                          numBytes - U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES,
+                                          pRrlpBatch->svsThreshold,
+                                          pRrlpBatch->cNoThreshold,
+                                          pRrlpBatch->multipathIndexLimit,
+                                          pRrlpBatch->pseudorangeRmsErrorIndexLimit,
+                                          false);
+                if (numBytes >= 0) {
+                    // Good enough: keep it
+                    pRrlpBatch->length += errorCodeOrLength;
+                    pRrlpBatch->numSets++;
+                    if (pRrlpBatch->numSets >= pRrlpBatch->numSetsWanted) {
+                        rrlpBatchDeliver(pRrlpBatch);
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Make sure that the given UBX message is emitted once per
+// navigation solution, writing the previous rate to *pMessageRate
+// if it had to be changed, so that it can be put back.
+static int32_t messageEnable(uGnssPrivateInstance_t *pInstance,
+                             uint16_t ubxMessageId, uint32_t keyIdMsgOutI2c,
+                             int32_t *pMessageRate)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    int32_t messageRate = -1;
+    uGnssPrivateMessageId_t privateMessageId = {.type = U_GNSS_PROTOCOL_UBX};
+    uint32_t keyId;
+    uGnssCfgVal_t *pCfgVal = NULL;
+    uGnssCfgVal_t cfgVal;
+
+    privateMessageId.id.ubx = ubxMessageId;
+    if (U_GNSS_PRIVATE_HAS(pInstance->pModule,
+                           U_GNSS_PRIVATE_FEATURE_OLD_CFG_API)) {
+        messageRate = uGnssPrivateGetMsgRate(pInstance, &privateMessageId);
+        if (messageRate != 1) {
+            errorCode = uGnssPrivateSetMsgRate(pInstance, &privateMessageId, 1);
+            if (errorCode == 0) {
+                *pMessageRate = messageRate;
+            }
+        }
+    } else {
+        // The keyId for the msgout rates is port dependent but, neatly,
+        // it is always the I2C value plus the port number (uGnssPort_t)
+        keyId = keyIdMsgOutI2c + pInstance->portNumber;
+        cfgVal.keyId = keyId;
+        cfgVal.value = 1;
+        if (uGnssCfgPrivateValGetListAlloc(pInstance,
+                                           &keyId, 1,
+                                           &pCfgVal,
+                                           U_GNSS_CFG_VAL_LAYER_RAM) == 1) {
+            messageRate = (int32_t) pCfgVal->value;
+            uPortFree(pCfgVal);
+        }
+        if (messageRate != (int32_t) cfgVal.value) {
+            errorCode = uGnssCfgPrivateValSetList(pInstance, &cfgVal, 1,
+                                                  U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                                  U_GNSS_CFG_LAYERS_SET);
+            if (errorCode == 0) {
+                *pMessageRate = messageRate;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Start streamed position, the common part of
+// uGnssPosGetStreamedStart() and uGnssPosGetStreamedFixStart();
+// if pFixCallback is non-NULL it is the latter.
+static int32_t streamedStart(uDeviceHandle_t gnssHandle,
+                             int32_t rateMs,
+                             void (*pCallback) (uDeviceHandle_t gnssHandle,
+                                                int32_t errorCode,
+                                                int32_t latitudeX1e7,
+                                                int32_t longitudeX1e7,
+                                                int32_t altitudeMillimetres,
+                                                int32_t radiusMillimetres,
+                                                int32_t speedMillimetresPerSecond,
+                                                int32_t svs,
+                                                int64_t timeUtc),
+                             uint32_t contentsBitmap,
+                             void (*pFixCallback) (uDeviceHandle_t gnssHandle,
+                                                   const uGnssPosFix_t *pFix,
+                                                   void *pCallbackParam),
+                             void *pFixCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssPrivateStreamedPosition_t *pStreamedPosition;
+    uGnssPosStreamedFix_t *pFixContext = NULL;
+    int32_t measurementPeriodMs = -1;
+    int32_t navigationCount = -1;
+    uGnssPrivateMessageId_t messageId =  {.type = U_GNSS_PROTOCOL_UBX,
+                                          .id.ubx = 0x0107
+                                         };
+#ifdef U_CFG_SARA_R5_M8_WORKAROUND
+    uint8_t message[4]; // Room for the body of a UBX-CFG-ANT message
+#endif
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if ((pInstance != NULL) && ((pCallback != NULL) || (pFixCallback != NULL)) &&
+            (rateMs != 0)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if (uGnssPrivateGetStreamType(pInstance->transportType) >= 0) {
+                // UBX-NAV-PVT is always used
+                contentsBitmap |= 1UL << U_GNSS_POS_FIX_CONTENT_PVT;
+                bool temp = pInstance->printUbxMessages;
+                pInstance->printUbxMessages = true;
+                pStreamedPosition = pInstance->pStreamedPosition;
+                if (pStreamedPosition != NULL) {
+                    // Stop the previous streamed position
+                    uGnssPrivateCleanUpStreamedPos(pInstance);
+                }
+                // Malloc memory to copy the parameters into:
+                // this memory will be free'd when
+                // uGnssPosGetStreamedStop() is called
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                pStreamedPosition = (uGnssPrivateStreamedPosition_t *) pUPortMalloc(sizeof(*pStreamedPosition));
+                if ((pStreamedPosition != NULL) && (pFixCallback != NULL)) {
+                    pFixContext = (uGnssPosStreamedFix_t *) pUPortMalloc(sizeof(*pFixContext));
+                    if (pFixContext == NULL) {
+                        uPortFree(pStreamedPosition);
+                        pStreamedPosition = NULL;
+                    }
+                }
+                if (pStreamedPosition != NULL) {
+                    memset(pStreamedPosition, 0, sizeof(*pStreamedPosition));
+                    // Put defaults in place so that we know
+                    // to change things back only if necessary
+                    pStreamedPosition->measurementPeriodMs = -1;
+                    pStreamedPosition->navigationCount = -1;
+                    for (size_t x = 0; x < U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES; x++) {
+                        pStreamedPosition->messageRate[x] = -1;
+                    }
+                    pStreamedPosition->asyncHandle = -1;
+                    pStreamedPosition->pCallback = pCallback;
+                    if (pFixContext != NULL) {
+                        memset(pFixContext, 0, sizeof(*pFixContext));
+                        pFixContext->pCallback = pFixCallback;
+                        pFixContext->pCallbackParam = pFixCallbackParam;
+                        pFixContext->contentsBitmap = contentsBitmap;
+                        pStreamedPosition->pFixContext = pFixContext;
+                    }
+                    pStreamedPosition->gnssHandle = gnssHandle;
+                    pInstance->pStreamedPosition = pStreamedPosition;
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    if (rateMs >= 0) {
+                        // Get the existing measurement/navigation rate
+                        // and, if it is not rateMs, set it to rateMs
+                        if (uGnssPrivateGetRate(pInstance,
+                                                &measurementPeriodMs,
+                                                &navigationCount,
+                                                NULL) != rateMs) {
+                            // Set the measurement rate, with a navigation count of 1
+                            // and leaving the time system unchanged
+                            errorCode = uGnssPrivateSetRate(pInstance, rateMs, 1,
+                                                            U_GNSS_TIME_SYSTEM_NONE);
+                            if (errorCode == 0) {
+                                pStreamedPosition->measurementPeriodMs = measurementPeriodMs;
+                                pStreamedPosition->navigationCount = navigationCount;
+                            }
+                        }
+                    }
+                    // Make sure that the wanted messages are
+                    // enabled at once per measurement
+                    for (size_t x = 0; (errorCode == 0) &&
+                         (x < U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES); x++) {
+                        if (contentsBitmap & (1UL << x)) {
+                            errorCode = messageEnable(pInstance,
+                                                      gUGnssPrivateStreamedPosMessage[x].ubxMessageId,
+                                                      gUGnssPrivateStreamedPosMessage[x].keyIdMsgOutI2c,
+                                                      &(pStreamedPosition->messageRate[x]));
+                        }
+                    }
+                    if (errorCode == 0) {
+#ifdef U_CFG_SARA_R5_M8_WORKAROUND
+                        if (uGnssPrivateGetIntermediateAtHandle(pInstance) != NULL) {
+                            // Temporary change: on prototype versions of the
+                            // SARA-R510M8S module (production week (printed on the
+                            // module label, upper right) earlier than 20/27)
+                            // the LNA in the GNSS chip is not automatically switched
+                            // on by the firmware in the cellular module, so we need
+                            // to switch it on ourselves by sending UBX-CFG-ANT
+                            // with contents 02000f039
+                            message[0] = 0x02;
+                            message[1] = 0;
+                            message[2] = 0xf0;
+                            message[3] = 0x39;
+                            uGnssPrivateSendUbxMessage(pInstance, 0x06, 0x13,
+                                                       (const char *) message, 4);
+                        }
+#endif
+                        pInstance->printUbxMessages = temp;
+                        // Start a message receiver for the UBX-NAV-PVT message,
+                        // or all UBX-NAV class messages if we're merging several,
+                        // which will ultimately call the callback
+                        if (pFixContext != NULL) {
+                            messageId.id.ubx = U_GNSS_UBX_MESSAGE(0x01, U_GNSS_UBX_MESSAGE_ID_ALL);
+                            errorCode = uGnssMsgPrivateReceiveStart(pInstance, &messageId,
+                                                                    fixMessageCallback,
+                                                                    pInstance);
+                        } else {
+                            errorCode = uGnssMsgPrivateReceiveStart(pInstance, &messageId,
+                                                                    messageCallback,
+                                                                    pInstance);
+                        }
+                        if (errorCode >= 0) {
+                            // And we're off
+                            pStreamedPosition->asyncHandle = errorCode;
+                        } else {
+                            // If we couldn't create the asynchronous
+                            // message receiver, clean up
+                            uGnssPrivateCleanUpStreamedPos(pInstance);
+                        }
+                    } else {
+                        // If we couldn't set the rate, clean up
+                        uGnssPrivateCleanUpStreamedPos(pInstance);
+                    }
+                }
+                pInstance->printUbxMessages = temp;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -583,173 +1084,87 @@ int32_t uGnssPosGetStreamedStart(uDeviceHandle_t gnssHandle,
                                                     int32_t svs,
                                                     int64_t timeUtc))
 {
-    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (pCallback != NULL) {
+        errorCode = streamedStart(gnssHandle, rateMs, pCallback, 0, NULL, NULL);
+    }
+
+    return errorCode;
+}
+
+// Cancel a uGnssPosGetStreamedStart().
+void uGnssPosGetStreamedStop(uDeviceHandle_t gnssHandle)
+{
     uGnssPrivateInstance_t *pInstance;
-    uGnssPrivateStreamedPosition_t *pStreamedPosition;
-    int32_t measurementPeriodMs = -1;
-    int32_t navigationCount = -1;
-    int32_t messageRate = -1;
-    uGnssPrivateMessageId_t ubxNavPvtMessageId =  {.type = U_GNSS_PROTOCOL_UBX,
-                                                   .id.ubx = 0x0107
-                                                  };
-    uint32_t keyId;
-    uGnssCfgVal_t *pCfgVal = NULL;
-    uGnssCfgVal_t cfgVal;
-#ifdef U_CFG_SARA_R5_M8_WORKAROUND
-    uint8_t message[4]; // Room for the body of a UBX-CFG-ANT message
-#endif
 
     if (gUGnssPrivateMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
 
-        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         pInstance = pUGnssPrivateGetInstance(gnssHandle);
-        if ((pInstance != NULL) && (pCallback != NULL) && (rateMs != 0)) {
-            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
-            if (uGnssPrivateGetStreamType(pInstance->transportType) >= 0) {
-                // The keyId for the msgout rates is port dependent but, neatly,
-                // it is always the I2C value plus the port number (uGnssPort_t)
-                keyId = U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_NAV_PVT_I2C_U1 + pInstance->portNumber;
-                cfgVal.keyId = keyId;
-                cfgVal.value = 1;
-                bool temp = pInstance->printUbxMessages;
-                pInstance->printUbxMessages = true;
-                pStreamedPosition = pInstance->pStreamedPosition;
-                if (pStreamedPosition != NULL) {
-                    // Stop the previous streamed position
-                    uGnssPrivateCleanUpStreamedPos(pInstance);
-                }
-                // Malloc memory to copy the parameters into:
-                // this memory will be free'd when
-                // uGnssPosGetStreamedStop() is called
-                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-                pStreamedPosition = (uGnssPrivateStreamedPosition_t *) pUPortMalloc(sizeof(*pStreamedPosition));
-                if (pStreamedPosition != NULL) {
-                    memset(pStreamedPosition, 0, sizeof(*pStreamedPosition));
-                    // Put defaults in place so that we know
-                    // to change things back only if necessary
-                    pStreamedPosition->measurementPeriodMs = -1;
-                    pStreamedPosition->navigationCount = -1;
-                    pStreamedPosition->messageRate = -1;
-                    pStreamedPosition->asyncHandle = -1;
-                    pStreamedPosition->pCallback = pCallback;
-                    pInstance->pStreamedPosition = pStreamedPosition;
-                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-                    if (rateMs >= 0) {
-                        // Get the existing measurement/navigation rate
-                        // and, if it is not rateMs, set it to rateMs
-                        if (uGnssPrivateGetRate(pInstance,
-                                                &measurementPeriodMs,
-                                                &navigationCount,
-                                                NULL) != rateMs) {
-                            // Set the measurement rate, with a navigation count of 1
-                            // and leaving the time system unchanged
-                            errorCode = uGnssPrivateSetRate(pInstance, rateMs, 1,
-                                                            U_GNSS_TIME_SYSTEM_NONE);
-                            if (errorCode == 0) {
-                                pStreamedPosition->measurementPeriodMs = measurementPeriodMs;
-                                pStreamedPosition->navigationCount = navigationCount;
-                            }
-                        }
-                    }
-                    if (errorCode == 0) {
-                        // Make sure that the UBX-NAV-PVT message
-                        // is enabled at once per measurement
-                        if (U_GNSS_PRIVATE_HAS(pInstance->pModule,
-                                               U_GNSS_PRIVATE_FEATURE_OLD_CFG_API)) {
-                            messageRate = uGnssPrivateGetMsgRate(pInstance,
-                                                                 &ubxNavPvtMessageId);
-                            if (messageRate != 1) {
-                                errorCode = uGnssPrivateSetMsgRate(pInstance,
-                                                                   &ubxNavPvtMessageId, 1);
-                                if (errorCode == 0) {
-                                    pStreamedPosition->messageRate = messageRate;
-                                }
-                            }
-                        } else {
-                            if (uGnssCfgPrivateValGetListAlloc(pInstance,
-                                                               &keyId, 1,
-                                                               &pCfgVal,
-                                                               U_GNSS_CFG_VAL_LAYER_RAM) == 1) {
-                                messageRate = (int32_t) pCfgVal->value;
-                                uPortFree(pCfgVal);
-                            }
-                            if (messageRate != (int32_t) cfgVal.value) {
-                                errorCode = uGnssCfgPrivateValSetList(pInstance, &cfgVal, 1,
-                                                                      U_GNSS_CFG_VAL_TRANSACTION_NONE,
-                                                                      U_GNSS_CFG_LAYERS_SET);
-                                if (errorCode == 0) {
-                                    pStreamedPosition->messageRate = messageRate;
-                                }
-                            }
-                        }
-                    }
-                    if (errorCode == 0) {
-#ifdef U_CFG_SARA_R5_M8_WORKAROUND
-                        if (uGnssPrivateGetIntermediateAtHandle(pInstance) != NULL) {
-                            // Temporary change: on prototype versions of the
-                            // SARA-R510M8S module (production week (printed on the
-                            // module label, upper right) earlier than 20/27)
-                            // the LNA in the GNSS chip is not automatically switched
-                            // on by the firmware in the cellular module, so we need
-                            // to switch it on ourselves by sending UBX-CFG-ANT
-                            // with contents 02000f039
-                            message[0] = 0x02;
-                            message[1] = 0;
-                            message[2] = 0xf0;
-                            message[3] = 0x39;
-                            uGnssPrivateSendUbxMessage(pInstance, 0x06, 0x13,
-                                                       (const char *) message, 4);
-                        }
-#endif
-                        pInstance->printUbxMessages = temp;
-                        // Start a message received for the UBX-NAV-PVT message,
-                        // which will ultimately call pCallback
-                        errorCode = uGnssMsgPrivateReceiveStart(pInstance,
-                                                                &ubxNavPvtMessageId,
-                                                                messageCallback,
-                                                                pInstance);
-                        if (errorCode >= 0) {
-                            // And we're off
-                            pStreamedPosition->gnssHandle = gnssHandle;
-                            pStreamedPosition->asyncHandle = errorCode;
-                        } else {
-                            // If we couldn't create the asynchronous
-                            // message receiver, clean up
-                            uGnssPrivateCleanUpStreamedPos(pInstance);
-                        }
-                    } else {
-                        // If we couldn't set the rate, clean up
-                        uGnssPrivateCleanUpStreamedPos(pInstance);
-                    }
-                }
-                pInstance->printUbxMessages = temp;
-            }
+        if (pInstance != NULL) {
+            uGnssPrivateCleanUpStreamedPos(pInstance);
         }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
     }
+}
 
-    U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+// Get merged, multi-message, position fixes streamed to a callback.
+int32_t uGnssPosGetStreamedFixStart(uDeviceHandle_t gnssHandle,
+                                    int32_t rateMs,
+                                    uint32_t contentsBitmap,
+                                    void (*pCallback) (uDeviceHandle_t gnssHandle,
+                                                       const uGnssPosFix_t *pFix,
+                                                       void *pCallbackParam),
+                                    void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pCallback != NULL) &&
+        ((rateMs < 0) || (rateMs >= U_GNSS_POS_STREAMED_FIX_PERIOD_MIN_MS)) &&
+        ((contentsBitmap & ~((1UL << U_GNSS_POS_FIX_CONTENT_MAX_NUM) - 1)) == 0)) {
+        errorCode = streamedStart(gnssHandle, rateMs, NULL, contentsBitmap,
+                                  pCallback, pCallbackParam);
+    }
 
     return errorCode;
 }
 
-// Cancel a uGnssPosGetStreamedStart().
-void uGnssPosGetStreamedStop(uDeviceHandle_t gnssHandle)
+// Get the latency statistics of a uGnssPosGetStreamedFixStart().
+int32_t uGnssPosGetStreamedStatLatency(uDeviceHandle_t gnssHandle,
+                                       uGnssPosStatLatency_t *pStat)
 {
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
     uGnssPrivateInstance_t *pInstance;
+    uGnssPosStreamedFix_t *pFixContext;
 
     if (gUGnssPrivateMutex != NULL) {
 
         U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
 
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         pInstance = pUGnssPrivateGetInstance(gnssHandle);
-        if (pInstance != NULL) {
-            uGnssPrivateCleanUpStreamedPos(pInstance);
+        if ((pInstance != NULL) && (pStat != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+            if ((pInstance->pStreamedPosition != NULL) &&
+                (pInstance->pStreamedPosition->pFixContext != NULL) &&
+                (pInstance->pMsgReceive != NULL)) {
+                pFixContext = (uGnssPosStreamedFix_t *) pInstance->pStreamedPosition->pFixContext;
+                // The statistics are updated by the message callback,
+                // which is called with the reader mutex locked
+                U_PORT_MUTEX_LOCK(pInstance->pMsgReceive->readerMutexHandle);
+                *pStat = pFixContext->stat;
+                U_PORT_MUTEX_UNLOCK(pInstance->pMsgReceive->readerMutexHandle);
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
     }
+
+    return errorCode;
 }
 
 // Set the mode for uGnssPosGetRrlp().
@@ -815,11 +1230,7 @@ int32_t uGnssPosGetRrlp(uDeviceHandle_t gnssHandle, char *pBuffer,
     uGnssPrivateInstance_t *pInstance;
     int32_t messageClass;
     int64_t startTime;
-    int32_t svs;
     int32_t numBytes;
-    int32_t z;
-    int32_t numMeetingCriteria;
-    bool goodSatellite;
     int32_t ca = 0;
     int32_t cb = 0;
     // Access the buffer as a uint8_t to avoid maths funnies with
@@ -869,60 +1280,11 @@ int32_t uGnssPosGetRrlp(uDeviceHandle_t gnssHandle, char *pBuffer,
                                                              pBuffer + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES,
                                                              sizeBytes - U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES);
                 if ((numBytes > 0) && (pInstance->rrlpMode == U_GNSS_RRLP_MODE_MEASX)) {
-                    // Got something; when using MEASX we need to check if it is good enough.
-                    // 34 since that's the furthest we need to read to check on the number of satellites
-                    if ((((svsThreshold >= 0) || (cNoThreshold >= 0) ||
-                          (multipathIndexLimit >= 0) || (pseudorangeRmsErrorIndexLimit >= 0)) && (numBytes >= 34))) {
-                        // The number of satellites is at offset 34
-                        svs = *(pBufferUint8 + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES + 34);
-                        uPortLog("U_GNSS_POS: RRLP information for %d satellite(s).\n", svs);
-                        if ((svsThreshold >= 0) && (svs < svsThreshold)) {
-                            // Not enough satellites in the first place
-                            numBytes = -1;
-                        }
-                        if ((numBytes > 0) &&
-                            ((cNoThreshold >= 0) || (multipathIndexLimit >= 0) || (pseudorangeRmsErrorIndexLimit >= 0))) {
-                            numMeetingCriteria = svs;
-                            // 65 since that's the furthest we need to check on the criteria
-                            for (int8_t x = 0; (x < svs) && (numBytes >= 65 + (x * 24)); x++) {
-                                goodSatellite = true;
-                                // Carrier to noise ratio is at offset 46 + (x * 24)
-                                if (cNoThreshold >= 0) {
-                                    z = *(pBufferUint8 + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES + 46 + (x * 24));
-                                    uPortLog("U_GNSS_POS: RRLP CNo for satellite %d is %d.\n", x + 1, z);
-                                    if (z < cNoThreshold) {
-                                        goodSatellite = false;
-                                    }
-                                }
-                                // Multipath index is at offset 47 + (x * 24)
-                                if (goodSatellite && (multipathIndexLimit >= 0)) {
-                                    z = *(pBufferUint8 + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES + 47 + (x * 24));
-                                    uPortLog("U_GNSS_POS: RRLP multipath for satellite %d is %d.\n", x + 1, z);
-                                    if (z > multipathIndexLimit) {
-                                        goodSatellite = false;
-                                    }
-                                }
-                                // Pseudorange RMS error index is at offset 65 + (x * 24)
-                                if (goodSatellite && (pseudorangeRmsErrorIndexLimit >= 0)) {
-                                    z = *(pBufferUint8 + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES + 65 + (x * 24));
-                                    uPortLog("U_GNSS_POS: pseudorange RMS error index for satellite %d is %d.\n",
-                                             x + 1, z);
-                                    if (z > pseudorangeRmsErrorIndexLimit) {
-                                        goodSatellite = false;
-                                    }
-                                }
-                                if (!goodSatellite) {
-                                    numMeetingCriteria--;
-                                    uPortLog("U_GNSS_POS: only up to %d satellite(s) meet the criteria.\n",
-                                             numMeetingCriteria);
-                                    if (numMeetingCriteria < svsThreshold) {
-                                        // Force exit
-                                        numBytes = -1;
-                                    }
-                                }
-                            }
-                        }
-                    }
+                    // Got something; when using MEASX we need to check if it is good enough
+                    numBytes = rrlpMeasxCheck(pBufferUint8 + U_GNSS_POS_RRLP_HEADER_SIZE_BYTES,
+                                              numBytes, svsThreshold, cNoThreshold,
+                                              multipathIndexLimit,
+                                              pseudorangeRmsErrorIndexLimit, true);
                 }
 
                 if (numBytes > 0) {
@@ -961,4 +1323,103 @@ int32_t uGnssPosGetRrlp(uDeviceHandle_t gnssHandle, char *pBuffer,
     return errorCodeOrLength;
 }
 
+// Start batched capture of RRLP information.
+int32_t uGnssPosGetRrlpBatchStart(uDeviceHandle_t gnssHandle,
+                                  char *pArena, size_t arenaSizeBytes,
+                                  size_t numSets, int32_t svsThreshold,
+                                  int32_t cNoThreshold,
+                                  int32_t multipathIndexLimit,
+                                  int32_t pseudorangeRmsErrorIndexLimit,
+                                  void (*pCallback) (uDeviceHandle_t gnssHandle,
+                                                     const char *pArena,
+                                                     size_t size,
+                                                     size_t numSets,
+                                                     void *pCallbackParam),
+                                  void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+    uGnssPrivateRrlpBatch_t *pRrlpBatch;
+    // UBX-RXM-MEASX
+    uGnssPrivateMessageId_t messageId =  {.type = U_GNSS_PROTOCOL_UBX,
+                                          .id.ubx = 0x0214
+                                         };
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if ((pInstance != NULL) && (pArena != NULL) && (numSets > 0) &&
+            (pCallback != NULL) &&
+            (arenaSizeBytes >= U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES +
+             U_GNSS_POS_RRLP_MEASX_LENGTH_MIN_BYTES)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if ((uGnssPrivateGetStreamType(pInstance->transportType) >= 0) &&
+                (pInstance->rrlpMode == U_GNSS_RRLP_MODE_MEASX)) {
+                // Stop any previous batched capture
+                uGnssPrivateCleanUpRrlpBatch(pInstance);
+                errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                // This will be free'd by uGnssPrivateCleanUpRrlpBatch()
+                pRrlpBatch = (uGnssPrivateRrlpBatch_t *) pUPortMalloc(sizeof(*pRrlpBatch));
+                if (pRrlpBatch != NULL) {
+                    memset(pRrlpBatch, 0, sizeof(*pRrlpBatch));
+                    pRrlpBatch->gnssHandle = gnssHandle;
+                    pRrlpBatch->asyncHandle = -1;
+                    pRrlpBatch->messageRate = -1;
+                    pRrlpBatch->pArena = pArena;
+                    pRrlpBatch->arenaSize = arenaSizeBytes;
+                    pRrlpBatch->numSetsWanted = numSets;
+                    pRrlpBatch->svsThreshold = svsThreshold;
+                    pRrlpBatch->cNoThreshold = cNoThreshold;
+                    pRrlpBatch->multipathIndexLimit = multipathIndexLimit;
+                    pRrlpBatch->pseudorangeRmsErrorIndexLimit = pseudorangeRmsErrorIndexLimit;
+                    pRrlpBatch->pCallback = pCallback;
+                    pRrlpBatch->pCallbackParam = pCallbackParam;
+                    pInstance->pRrlpBatch = pRrlpBatch;
+                    // Have UBX-RXM-MEASX emitted with every measurement
+                    errorCode = messageEnable(pInstance, messageId.id.ubx,
+                                              U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_RXM_MEASX_I2C_U1,
+                                              &(pRrlpBatch->messageRate));
+                    if (errorCode == 0) {
+                        errorCode = uGnssMsgPrivateReceiveStart(pInstance, &messageId,
+                                                                rrlpBatchMessageCallback,
+                                                                pRrlpBatch);
+                        if (errorCode >= 0) {
+                            pRrlpBatch->asyncHandle = errorCode;
+                            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                        }
+                    }
+                    if (errorCode < 0) {
+                        uGnssPrivateCleanUpRrlpBatch(pInstance);
+                    }
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Stop batched capture of RRLP information.
+void uGnssPosGetRrlpBatchStop(uDeviceHandle_t gnssHandle)
+{
+    uGnssPrivateInstance_t *pInstance;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            uGnssPrivateCleanUpRrlpBatch(pInstance);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+}
+
 // End of file
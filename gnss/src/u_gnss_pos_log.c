@@ -0,0 +1,400 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Implementation of the position log of the GNSS API.
+ *
+ * Each record in the log is a header byte followed by up to four
+ * LEB128-style variable-length values, least significant seven bits
+ * first with bit 7 set on all but the last byte.  The values are, in
+ * order, latitude, longitude, altitude and time, zig-zag encoded so
+ * that small negative numbers are as short as small positive ones.
+ * In a key-frame the values are absolute, otherwise they are the
+ * difference from the previous fix.  Bit 7 of the header byte is set
+ * for a key-frame and bits 0 to 3 indicate which of the four values
+ * are present, an absent value being zero; a key-frame always
+ * includes all four.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_error_common.h"
+
+#include "u_ringbuffer.h"
+
+#include "u_gnss_pos_log.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The bit in the header byte of a record that marks a key-frame.
+ */
+#define U_GNSS_POS_LOG_HEADER_KEYFRAME 0x80
+
+/** The bits in the header byte of a record that indicate which
+ * values are present.
+ */
+#define U_GNSS_POS_LOG_HEADER_VALUES_MASK 0x0f
+
+/** The number of values in a record.
+ */
+#define U_GNSS_POS_LOG_NUM_VALUES 4
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Zig-zag encode a signed value.
+static uint64_t zigZagEncode(int64_t value)
+{
+    uint64_t encoded = ((uint64_t) value) << 1;
+
+    if (value < 0) {
+        encoded = ~encoded;
+    }
+
+    return encoded;
+}
+
+// Zig-zag decode a value.
+static int64_t zigZagDecode(uint64_t value)
+{
+    uint64_t decoded = value >> 1;
+
+    if (value & 1) {
+        decoded = ~decoded;
+    }
+
+    return (int64_t) decoded;
+}
+
+// Write a variable-length value to pBuffer, returning the number
+// of bytes written.
+static size_t variableEncode(uint64_t value, char *pBuffer)
+{
+    size_t length = 0;
+
+    do {
+        *(pBuffer + length) = (char) (value & 0x7f);
+        value >>= 7;
+        if (value != 0) {
+            *(pBuffer + length) |= 0x80;
+        }
+        length++;
+    } while (value != 0);
+
+    return length;
+}
+
+// Read a variable-length value from pBuffer, returning the number
+// of bytes read.
+static int32_t variableDecode(const char *pBuffer, size_t size,
+                              uint64_t *pValue)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_TIMEOUT;
+    uint64_t value = 0;
+    uint8_t byte;
+
+    for (size_t x = 0; (x < size) && (errorCodeOrLength < 0); x++) {
+        if (x >= 10) {
+            // Too long for 64 bits
+            errorCodeOrLength = (int32_t) U_ERROR_COMMON_BAD_DATA;
+        } else {
+            byte = (uint8_t) * (pBuffer + x);
+            value |= ((uint64_t) (byte & 0x7f)) << (7 * x);
+            if ((byte & 0x80) == 0) {
+                *pValue = value;
+                errorCodeOrLength = (int32_t) (x + 1);
+            }
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Encode a fix into pBuffer, which must be at least
+// U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES long, returning the
+// number of bytes written.
+static size_t recordEncode(const uGnssPosLogFix_t *pFix,
+                           const uGnssPosLogFix_t *pLast,
+                           bool keyframe, char *pBuffer)
+{
+    int64_t value[U_GNSS_POS_LOG_NUM_VALUES];
+    uint8_t header = U_GNSS_POS_LOG_HEADER_KEYFRAME;
+    size_t length = 1;
+
+    value[0] = pFix->latitudeX1e7;
+    value[1] = pFix->longitudeX1e7;
+    value[2] = pFix->altitudeMillimetres;
+    value[3] = pFix->timeMs;
+    if (!keyframe) {
+        header = 0;
+        value[0] -= pLast->latitudeX1e7;
+        value[1] -= pLast->longitudeX1e7;
+        value[2] -= pLast->altitudeMillimetres;
+        value[3] -= pLast->timeMs;
+    }
+    for (size_t x = 0; x < U_GNSS_POS_LOG_NUM_VALUES; x++) {
+        if (keyframe || (value[x] != 0)) {
+            header |= 1 << x;
+            length += variableEncode(zigZagEncode(value[x]), pBuffer + length);
+        }
+    }
+    *pBuffer = (char) header;
+
+    return length;
+}
+
+// Decode a record from pBuffer into pFix, which must contain the
+// previous fix on entry, returning the number of bytes decoded.
+static int32_t recordDecode(const char *pBuffer, size_t size,
+                            uGnssPosLogFix_t *pFix, bool *pKeyframe)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_TIMEOUT;
+    int64_t value[U_GNSS_POS_LOG_NUM_VALUES] = {0};
+    uint64_t encoded;
+    uint8_t header;
+    bool keyframe;
+    size_t length = 1;
+    int32_t x;
+
+    if (size > 0) {
+        errorCodeOrLength = (int32_t) U_ERROR_COMMON_BAD_DATA;
+        header = (uint8_t) *pBuffer;
+        keyframe = ((header & U_GNSS_POS_LOG_HEADER_KEYFRAME) != 0);
+        if (((header & ~(U_GNSS_POS_LOG_HEADER_KEYFRAME | U_GNSS_POS_LOG_HEADER_VALUES_MASK)) == 0) &&
+            (!keyframe || ((header & U_GNSS_POS_LOG_HEADER_VALUES_MASK) ==
+                           U_GNSS_POS_LOG_HEADER_VALUES_MASK))) {
+            errorCodeOrLength = 0;
+            for (size_t y = 0; (y < U_GNSS_POS_LOG_NUM_VALUES) &&
+                 (errorCodeOrLength == 0); y++) {
+                if (header & (1 << y)) {
+                    x = variableDecode(pBuffer + length, size - length, &encoded);
+                    if (x > 0) {
+                        value[y] = zigZagDecode(encoded);
+                        length += x;
+                    } else {
+                        errorCodeOrLength = x;
+                    }
+                }
+            }
+            if (errorCodeOrLength == 0) {
+                if (keyframe) {
+                    memset(pFix, 0, sizeof(*pFix));
+                }
+                pFix->latitudeX1e7 = (int32_t) (pFix->latitudeX1e7 + value[0]);
+                pFix->longitudeX1e7 = (int32_t) (pFix->longitudeX1e7 + value[1]);
+                pFix->altitudeMillimetres = (int32_t) (pFix->altitudeMillimetres + value[2]);
+                pFix->timeMs += value[3];
+                if (pKeyframe != NULL) {
+                    *pKeyframe = keyframe;
+                }
+                errorCodeOrLength = (int32_t) length;
+            }
+        }
+    }
+
+    return errorCodeOrLength;
+}
+
+// Get the length of the record at the given offset into the log,
+// and whether it is a key-frame.
+static int32_t recordPeek(uGnssPosLog_t *pLog, size_t offset,
+                          bool *pKeyframe)
+{
+    char buffer[U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES];
+    uGnssPosLogFix_t fix = {0};
+    size_t length;
+
+    length = uRingBufferPeek(&(pLog->ringBuffer), buffer, sizeof(buffer), offset);
+
+    return recordDecode(buffer, length, &fix, pKeyframe);
+}
+
+// Throw away the oldest fixes in the log, up to the next key-frame.
+static void discardOldest(uGnssPosLog_t *pLog)
+{
+    bool keyframe = false;
+    int32_t length;
+
+    do {
+        length = recordPeek(pLog, 0, NULL);
+        if (length > 0) {
+            uRingBufferRead(&(pLog->ringBuffer), NULL, length);
+            pLog->numFixes--;
+        } else {
+            // Should never happen: start again
+            uRingBufferReset(&(pLog->ringBuffer));
+            pLog->numFixes = 0;
+        }
+        if (pLog->numFixes > 0) {
+            recordPeek(pLog, 0, &keyframe);
+        }
+    } while ((pLog->numFixes > 0) && !keyframe);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Create a position log.
+int32_t uGnssPosLogCreate(uGnssPosLog_t *pLog, char *pBuffer,
+                          size_t size)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    // +1 since the ring buffer uses a byte to prevent pointer-wrap
+    if ((pLog != NULL) && (pBuffer != NULL) &&
+        (size > U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES + 1)) {
+        memset(pLog, 0, sizeof(*pLog));
+        errorCode = uRingBufferCreate(&(pLog->ringBuffer), pBuffer, size);
+    }
+
+    return errorCode;
+}
+
+// Delete a position log.
+void uGnssPosLogDelete(uGnssPosLog_t *pLog)
+{
+    if (pLog != NULL) {
+        uRingBufferDelete(&(pLog->ringBuffer));
+        pLog->numFixes = 0;
+    }
+}
+
+// Add a fix to a position log.
+int32_t uGnssPosLogAdd(uGnssPosLog_t *pLog,
+                       int32_t latitudeX1e7, int32_t longitudeX1e7,
+                       int32_t altitudeMillimetres, int64_t timeMs)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    char record[U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES];
+    uGnssPosLogFix_t fix;
+    size_t length;
+    bool keyframe;
+
+    if (pLog != NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        fix.latitudeX1e7 = latitudeX1e7;
+        fix.longitudeX1e7 = longitudeX1e7;
+        fix.altitudeMillimetres = altitudeMillimetres;
+        fix.timeMs = timeMs;
+        keyframe = (pLog->numFixes == 0) ||
+                   (pLog->numSinceKeyframe + 1 >= U_GNSS_POS_LOG_KEYFRAME_INTERVAL);
+        length = recordEncode(&fix, &(pLog->last), keyframe, record);
+        // Make room, if required, by throwing away the oldest fixes
+        while ((uRingBufferAvailableSize(&(pLog->ringBuffer)) < length) &&
+               (pLog->numFixes > 0)) {
+            discardOldest(pLog);
+            if ((pLog->numFixes == 0) && !keyframe) {
+                // Nothing left to take a difference from
+                keyframe = true;
+                length = recordEncode(&fix, &(pLog->last), keyframe, record);
+            }
+        }
+        if (uRingBufferAdd(&(pLog->ringBuffer), record, length)) {
+            pLog->numFixes++;
+            pLog->numSinceKeyframe++;
+            if (keyframe) {
+                pLog->numSinceKeyframe = 0;
+            }
+            pLog->last = fix;
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    return errorCode;
+}
+
+// Get the number of fixes in a position log.
+size_t uGnssPosLogGetNumFixes(const uGnssPosLog_t *pLog)
+{
+    size_t numFixes = 0;
+
+    if (pLog != NULL) {
+        numFixes = pLog->numFixes;
+    }
+
+    return numFixes;
+}
+
+// Export the contents of a position log.
+int32_t uGnssPosLogExport(uGnssPosLog_t *pLog, char *pBuffer,
+                          size_t size, bool remove)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    size_t numFixes = 0;
+    size_t offset = 0;
+    int32_t length = 0;
+
+    if ((pLog != NULL) && (pBuffer != NULL)) {
+        // Work out how many whole records will fit
+        while ((numFixes < pLog->numFixes) && (length >= 0)) {
+            length = recordPeek(pLog, offset, NULL);
+            if ((length > 0) && (offset + length <= size)) {
+                offset += length;
+                numFixes++;
+            } else {
+                length = -1;
+            }
+        }
+        offset = uRingBufferPeek(&(pLog->ringBuffer), pBuffer, offset, 0);
+        if (remove) {
+            uRingBufferRead(&(pLog->ringBuffer), NULL, offset);
+            pLog->numFixes -= numFixes;
+        }
+        errorCodeOrLength = (int32_t) offset;
+    }
+
+    return errorCodeOrLength;
+}
+
+// Decode one fix from exported data.
+int32_t uGnssPosLogDecode(const char *pBuffer, size_t size,
+                          uGnssPosLogFix_t *pFix)
+{
+    int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pBuffer != NULL) && (pFix != NULL)) {
+        errorCodeOrLength = recordDecode(pBuffer, size, pFix, NULL);
+    }
+
+    return errorCodeOrLength;
+}
+
+// End of file
@@ -49,6 +49,7 @@
 #include "u_port_uart.h"
 #include "u_port_i2c.h"
 #include "u_port_spi.h"
+#include "u_port_gpio.h"
 #include "u_port_debug.h"
 
 #include "u_hex_bin_convert.h"
@@ -159,23 +160,24 @@ uPortMutexHandle_t gUGnssPrivateMutex = NULL;
  * is used to index into this array.
  */
 const uGnssPrivateModule_t gUGnssPrivateModuleList[] = {
-    {
-        U_GNSS_MODULE_TYPE_M8,
-        (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_OLD_CFG_API) /* features */
-    },
-    {
-        U_GNSS_MODULE_TYPE_M9,
-        ((1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_CFGVALXXX) |
-         (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_OLD_CFG_API) |
-         (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_GEOFENCE)  /* features */
-        )
-    },
-    {
-        U_GNSS_MODULE_TYPE_M10,
-        ((1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_CFGVALXXX) |
-         (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_RXM_MEAS_50_20_C12_D12)  /* features */
-        )
-    }
+#if U_GNSS_PRIVATE_MODULE_IS_COMPILED_IN(U_GNSS_PRIVATE_MODULE_NUM_M8)
+    {U_GNSS_MODULE_TYPE_M8, U_GNSS_PRIVATE_FEATURES_M8 /* features */},
+#endif
+#if U_GNSS_PRIVATE_MODULE_IS_COMPILED_IN(U_GNSS_PRIVATE_MODULE_NUM_M9)
+    {U_GNSS_MODULE_TYPE_M9, U_GNSS_PRIVATE_FEATURES_M9 /* features */},
+#endif
+#if U_GNSS_PRIVATE_MODULE_IS_COMPILED_IN(U_GNSS_PRIVATE_MODULE_NUM_M10)
+    {U_GNSS_MODULE_TYPE_M10, U_GNSS_PRIVATE_FEATURES_M10 /* features */},
+#endif
+};
+
+/** The UBX messages that streamed position may switch on; order
+ * is important, it must match that of uGnssPosFixContent_t.
+ */
+const uGnssPrivateStreamedPosMessage_t gUGnssPrivateStreamedPosMessage[] = {
+    {0x0107, U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_NAV_PVT_I2C_U1},      // UBX-NAV-PVT
+    {0x0114, U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_NAV_HPPOSLLH_I2C_U1}, // UBX-NAV-HPPOSLLH
+    {0x0136, U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_NAV_COV_I2C_U1}       // UBX-NAV-COV
 };
 
 /** Number of items in the gUGnssPrivateModuleList array, has to be
@@ -227,6 +229,29 @@ static const uint32_t gCfgValKeyIdCfgRate[] = {
     U_GNSS_CFG_VAL_KEY_ID_RATE_TIMEREF_E1  // Time system
 };
 
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS: MISC
+ * -------------------------------------------------------------- */
+
+// Get the GNSS instance for a GNSS device handle: the device
+// instance points straight at it, no need to search the list; the
+// device instance is invalidated when the GNSS instance is removed.
+static uGnssPrivateInstance_t *pGetInstanceGnssHandle(uDeviceHandle_t gnssHandle)
+{
+    uGnssPrivateInstance_t *pInstance = NULL;
+    uDeviceInstance_t *pDevInstance;
+
+    if ((uDeviceGetInstance(gnssHandle, &pDevInstance) == 0) &&
+        (pDevInstance->deviceType == U_DEVICE_TYPE_GNSS)) {
+        pInstance = (uGnssPrivateInstance_t *) pDevInstance->pApiInstance;
+        if ((pInstance != NULL) && (pInstance->gnssHandle != gnssHandle)) {
+            pInstance = NULL;
+        }
+    }
+
+    return pInstance;
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: MESSAGE RELATED
  * -------------------------------------------------------------- */
@@ -296,6 +321,91 @@ static void printId(uGnssPrivateMessageId_t *pId)
  * STATIC FUNCTIONS: STREAMING TRANSPORT ONLY
  * -------------------------------------------------------------- */
 
+// Return the number of SPI fill bytes at the start of pBuffer, checking
+// a word at a time where possible.
+static size_t spiFillLength(const char *pBuffer, size_t size)
+{
+    size_t x = 0;
+    uint32_t word;
+    bool keepGoing = true;
+
+    while (keepGoing && (size - x >= sizeof(word))) {
+        // memcpy() since pBuffer may not be aligned
+        memcpy(&word, pBuffer + x, sizeof(word));
+        if (word == 0xFFFFFFFF) {
+            x += sizeof(word);
+        } else {
+            keepGoing = false;
+        }
+    }
+    // Note: do the comparison as a uint8_t to avoid issues with
+    // char being signed
+    while ((x < size) && (*((const uint8_t *) pBuffer + x) == U_GNSS_PRIVATE_SPI_FILL)) {
+        x++;
+    }
+
+    return x;
+}
+
+// Return the number of bytes at the start of pBuffer that are not
+// SPI fill, checking a word at a time where possible.
+static size_t spiDataLength(const char *pBuffer, size_t size)
+{
+    size_t x = 0;
+    uint32_t word;
+    bool keepGoing = true;
+
+    while (keepGoing && (size - x >= sizeof(word))) {
+        memcpy(&word, pBuffer + x, sizeof(word));
+        // The usual "has a zero byte" trick, applied to the inverse
+        // of the word, tells us if any of its bytes is 0xFF
+        if (((~word - 0x01010101) & word & 0x80808080) == 0) {
+            x += sizeof(word);
+        } else {
+            keepGoing = false;
+        }
+    }
+    while ((x < size) && (*((const uint8_t *) pBuffer + x) != U_GNSS_PRIVATE_SPI_FILL)) {
+        x++;
+    }
+
+    return x;
+}
+
+// Interrupt callback for the TX ready pin.
+static void txReadyInterruptCallback(int32_t pin, void *pParam)
+{
+    (void) pin;
+
+    uPortSemaphoreGiveIrq(((uGnssPrivateInstance_t *) pParam)->txReadySemaphore);
+}
+
+// Return true if the TX ready pin says that the GNSS chip has data,
+// or if the pin can't be read, in which case we should look anyway.
+static bool txReadyIsAsserted(uGnssPrivateInstance_t *pInstance)
+{
+    int32_t level = uPortGpioGet(pInstance->pinTxReady & ~U_GNSS_PIN_INVERTED);
+
+    if (pInstance->pinTxReady & U_GNSS_PIN_INVERTED) {
+        level = (level == 0);
+    }
+
+    return (level != 0);
+}
+
+// Callback for background SPI reception; this is called in task context
+// by the platform and must not lock gUGnssPrivateMutex since that is held
+// while background reception is stopped, the SPI ring buffer has a mutex
+// of its own.
+static void spiReceiveAsyncCallback(int32_t handle, const char *pData,
+                                    size_t size, void *pCallbackParam)
+{
+    (void) handle;
+
+    uGnssPrivateSpiAddReceivedData((uGnssPrivateInstance_t *) pCallbackParam,
+                                   pData, size);
+}
+
 // Read or peek-at the data in the internal ring buffer.
 static int32_t streamGetFromRingBuffer(uGnssPrivateInstance_t *pInstance,
                                        int32_t readHandle,
@@ -979,6 +1089,41 @@ static int32_t parseRtcm(uParseHandle_t parseHandle, void *pUserParam)
     return U_ERROR_COMMON_SUCCESS;
 }
 
+/** Parser function for all of the protocols that may arrive from
+ * the GNSS chip: the first byte is looked at just once to pick the
+ * only parser that could match, rather than offering each byte
+ * position to each parser in turn, which matters when there
+ * are lots of non-message bytes to get through.
+ *
+ * @param parseHandle    the parse handle of the ring buffer to read from.
+ * @param[in] pUserParam the user parameter passed to uRingBufferParseHandle().
+ * @return               negative error or success code.
+ */
+static int32_t parseAny(uParseHandle_t parseHandle, void *pUserParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
+    uint8_t by = 0;
+
+    if (uRingBufferPeekByteUnprotected(parseHandle, &by)) {
+        switch (by) {
+            case 0xB5: // µ
+                errorCode = parseUbx(parseHandle, pUserParam);
+                break;
+            case '$':
+                errorCode = parseNmea(parseHandle, pUserParam);
+                break;
+            case 0xD3:
+                errorCode = parseRtcm(parseHandle, pUserParam);
+                break;
+            default:
+                errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+                break;
+        }
+    }
+
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: RATE CONFIGURATION
  * -------------------------------------------------------------- */
@@ -1163,6 +1308,35 @@ int32_t setRateUbxCfgVal(uGnssPrivateInstance_t *pInstance,
     return errorCode;
 }
 
+// Put back the output rate of a UBX message that streamed position
+// or batched RRLP capture had changed, trying a few times since
+// this sometimes fails while messages are being streamed.
+static void restoreMsgRate(uGnssPrivateInstance_t *pInstance,
+                           uint16_t ubxMessageId, uint32_t keyIdMsgOutI2c,
+                           int32_t messageRate)
+{
+    size_t tries = 1 + U_GNSS_PRIVATE_STREAMED_POS_ENSURE_SETTINGS_RETRIES;
+    int32_t y = -1;
+    uGnssPrivateMessageId_t privateMessageId =  {.type = U_GNSS_PROTOCOL_UBX};
+    uGnssCfgVal_t cfgVal;
+
+    privateMessageId.id.ubx = ubxMessageId;
+    for (size_t x = 0; (x < tries) && (y < 0); x++) {
+        if (U_GNSS_PRIVATE_HAS(pInstance->pModule,
+                               U_GNSS_PRIVATE_FEATURE_OLD_CFG_API)) {
+            y = uGnssPrivateSetMsgRate(pInstance, &privateMessageId, messageRate);
+        } else {
+            // The keyId for the msgout rates is port dependent:
+            // a base of the I2C value plus the port number (uGnssPort_t)
+            cfgVal.keyId = keyIdMsgOutI2c + pInstance->portNumber;
+            cfgVal.value = messageRate;
+            y = uGnssCfgPrivateValSetList(pInstance, &cfgVal, 1,
+                                          U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                          U_GNSS_CFG_LAYERS_SET);
+        }
+    }
+}
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: PROTOCOL OUTPUT CONFIGURATION
  * -------------------------------------------------------------- */
@@ -1408,7 +1582,6 @@ static int32_t getProtocolOutUbxCfgVal(uGnssPrivateInstance_t *pInstance)
 // Find a GNSS instance in the list by instance handle.
 uGnssPrivateInstance_t *pUGnssPrivateGetInstance(uDeviceHandle_t handle)
 {
-    uGnssPrivateInstance_t *pInstance = gpUGnssPrivateInstanceList;
     uDeviceHandle_t gnssHandle = uNetworkGetDeviceHandle(handle,
                                                          U_NETWORK_TYPE_GNSS);
 
@@ -1418,23 +1591,16 @@ uGnssPrivateInstance_t *pUGnssPrivateGetInstance(uDeviceHandle_t handle)
         // just use what we were given
         gnssHandle = handle;
     }
-    while ((pInstance != NULL) && (pInstance->gnssHandle != gnssHandle)) {
-        pInstance = pInstance->pNext;
-    }
 
-    return pInstance;
+    return pGetInstanceGnssHandle(gnssHandle);
 }
 
 // Get the module characteristics for a given instance.
 const uGnssPrivateModule_t *pUGnssPrivateGetModule(uDeviceHandle_t gnssHandle)
 {
-    uGnssPrivateInstance_t *pInstance = gpUGnssPrivateInstanceList;
+    uGnssPrivateInstance_t *pInstance = pGetInstanceGnssHandle(gnssHandle);
     const uGnssPrivateModule_t *pModule = NULL;
 
-    while ((pInstance != NULL) && (pInstance->gnssHandle != gnssHandle)) {
-        pInstance = pInstance->pNext;
-    }
-
     if (pInstance != NULL) {
         pModule = pInstance->pModule;
     }
@@ -1641,6 +1807,47 @@ int32_t uGnssPrivateGetProtocolOut(uGnssPrivateInstance_t *pInstance)
     return errorCodeOrBitMap;
 }
 
+// Populate the configuration shadow with rate and protocol output.
+int32_t uGnssPrivateCfgShadowFill(uGnssPrivateInstance_t *pInstance)
+{
+    int32_t errorCodeOrCount = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uint32_t keyId[2];
+    size_t numKeyIds = 0;
+
+    if (pInstance != NULL) {
+        errorCodeOrCount = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        if (U_GNSS_PRIVATE_HAS(pInstance->pModule, U_GNSS_PRIVATE_FEATURE_CFGVALXXX)) {
+            // Wild-cards so that it's all done in one VALGET per layer
+            keyId[numKeyIds] = U_GNSS_CFG_VAL_KEY(U_GNSS_CFG_VAL_KEY_GROUP_ID_RATE,
+                                                  U_GNSS_CFG_VAL_KEY_ITEM_ID_ALL, 0);
+            numKeyIds++;
+            if (pInstance->portNumber < sizeof(gPortToCfgValGroupIdOutProt) /
+                sizeof(gPortToCfgValGroupIdOutProt[0])) {
+                keyId[numKeyIds] = U_GNSS_CFG_VAL_KEY(gPortToCfgValGroupIdOutProt[pInstance->portNumber],
+                                                      U_GNSS_CFG_VAL_KEY_ITEM_ID_ALL, 0);
+                numKeyIds++;
+            }
+            errorCodeOrCount = uGnssCfgPrivateShadowFill(pInstance, keyId, numKeyIds);
+        }
+    }
+
+    return errorCodeOrCount;
+}
+
+// Shut down the TX ready interrupt and free its semaphore.
+void uGnssPrivateCleanUpTxReady(uGnssPrivateInstance_t *pInstance)
+{
+    if (pInstance->txReadySemaphore != NULL) {
+        if (pInstance->pinTxReady >= 0) {
+            uPortGpioInterruptSet(pInstance->pinTxReady & ~U_GNSS_PIN_INVERTED,
+                                  U_PORT_GPIO_INTERRUPT_EDGE_RISING, NULL, NULL);
+        }
+        uPortSemaphoreDelete(pInstance->txReadySemaphore);
+        pInstance->txReadySemaphore = NULL;
+    }
+    pInstance->pinTxReady = -1;
+}
+
 // Shut down and free memory from a running pos task.
 void uGnssPrivateCleanUpPosTask(uGnssPrivateInstance_t *pInstance)
 {
@@ -1665,10 +1872,6 @@ void uGnssPrivateCleanUpStreamedPos(uGnssPrivateInstance_t *pInstance)
     size_t tries = 1 + U_GNSS_PRIVATE_STREAMED_POS_ENSURE_SETTINGS_RETRIES;
     int32_t y;
     uGnssPrivateStreamedPosition_t *pStreamedPosition;
-    uGnssPrivateMessageId_t privateMessageId =  {.type = U_GNSS_PROTOCOL_UBX,
-                                                 .id.ubx = 0x0107
-                                                };
-    uGnssCfgVal_t cfgVal;
 
     if ((pInstance != NULL) && (pInstance->pStreamedPosition != NULL)) {
         pStreamedPosition = pInstance->pStreamedPosition;
@@ -1691,31 +1894,42 @@ void uGnssPrivateCleanUpStreamedPos(uGnssPrivateInstance_t *pInstance)
                                         U_GNSS_TIME_SYSTEM_NONE);
             }
         }
-        if (pStreamedPosition->messageRate >= 0) {
-            y = -1;
-            for (size_t x = 0; (x < tries) && (y < 0); x++) {
-                if (U_GNSS_PRIVATE_HAS(pInstance->pModule,
-                                       U_GNSS_PRIVATE_FEATURE_OLD_CFG_API)) {
-                    y = uGnssPrivateSetMsgRate(pInstance,
-                                               &privateMessageId,
-                                               pStreamedPosition->messageRate);
-                } else {
-                    // The keyId for the msgout rates is port dependent:
-                    // a base of the I2C value plus the port number (uGnssPort_t)
-                    cfgVal.keyId = U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_NAV_PVT_I2C_U1 + pInstance->portNumber;
-                    cfgVal.value = pStreamedPosition->messageRate;
-                    y = uGnssCfgPrivateValSetList(pInstance, &cfgVal, 1,
-                                                  U_GNSS_CFG_VAL_TRANSACTION_NONE,
-                                                  U_GNSS_CFG_LAYERS_SET);
-                }
+        for (size_t z = 0; z < U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES; z++) {
+            if (pStreamedPosition->messageRate[z] >= 0) {
+                restoreMsgRate(pInstance,
+                               gUGnssPrivateStreamedPosMessage[z].ubxMessageId,
+                               gUGnssPrivateStreamedPosMessage[z].keyIdMsgOutI2c,
+                               pStreamedPosition->messageRate[z]);
             }
         }
         // Now we can free the storage
+        uPortFree(pStreamedPosition->pFixContext);
         uPortFree(pStreamedPosition);
         pInstance->pStreamedPosition = NULL;
     }
 }
 
+// Shut down and free memory from a running batched RRLP capture.
+void uGnssPrivateCleanUpRrlpBatch(uGnssPrivateInstance_t *pInstance)
+{
+    uGnssPrivateRrlpBatch_t *pRrlpBatch;
+
+    if ((pInstance != NULL) && (pInstance->pRrlpBatch != NULL)) {
+        pRrlpBatch = pInstance->pRrlpBatch;
+        if (pRrlpBatch->asyncHandle >= 0) {
+            uGnssMsgPrivateReceiveStop(pInstance, pRrlpBatch->asyncHandle);
+        }
+        if (pRrlpBatch->messageRate >= 0) {
+            // UBX-RXM-MEASX
+            restoreMsgRate(pInstance, 0x0214,
+                           U_GNSS_CFG_VAL_KEY_ID_MSGOUT_UBX_RXM_MEASX_I2C_U1,
+                           pRrlpBatch->messageRate);
+        }
+        uPortFree(pRrlpBatch);
+        pInstance->pRrlpBatch = NULL;
+    }
+}
+
 // Check whether the GNSS chip is on-board the cellular module.
 bool uGnssPrivateIsInsideCell(const uGnssPrivateInstance_t *pInstance)
 {
@@ -1771,7 +1985,7 @@ void uGnssPrivateStopMsgReceive(uGnssPrivateInstance_t *pInstance)
         // we've shut the task down
         while (pMsgReceive->pReaderList != NULL) {
             pNext = pMsgReceive->pReaderList->pNext;
-            uPortFree(pMsgReceive->pReaderList);
+            uGnssMsgPrivateReaderFree(pMsgReceive->pReaderList);
             pMsgReceive->pReaderList = pNext;
         }
 
@@ -1909,6 +2123,82 @@ bool uGnssPrivateMessageIdIsWanted(uGnssPrivateMessageId_t *pMessageId,
     return isWanted;
 }
 
+// Compile a private message ID.
+void uGnssPrivateMessageFilterCompile(const uGnssPrivateMessageId_t *pMessageId,
+                                      uGnssPrivateMessageFilter_t *pFilter)
+{
+    char ch;
+
+    memset(pFilter, 0, sizeof(*pFilter));
+    pFilter->type = pMessageId->type;
+    switch (pMessageId->type) {
+        case U_GNSS_PROTOCOL_UBX:
+            // Same wild-cards as ubxIdMatch()
+            pFilter->idMask = 0xFFFF;
+            if ((pMessageId->id.ubx & U_GNSS_UBX_MESSAGE_ID_ALL) == U_GNSS_UBX_MESSAGE_ID_ALL) {
+                pFilter->idMask &= ~U_GNSS_UBX_MESSAGE_ID_ALL;
+            }
+            if ((pMessageId->id.ubx & (U_GNSS_UBX_MESSAGE_CLASS_ALL << 8)) ==
+                (U_GNSS_UBX_MESSAGE_CLASS_ALL << 8)) {
+                pFilter->idMask &= ~(U_GNSS_UBX_MESSAGE_CLASS_ALL << 8);
+            }
+            pFilter->idValue = pMessageId->id.ubx & pFilter->idMask;
+            break;
+        case U_GNSS_PROTOCOL_NMEA:
+            // Same wild-cards as nmeaIdMatch(): the wanted ID is a
+            // prefix, any character may be '?'
+            while ((pFilter->nmeaLength < U_GNSS_NMEA_MESSAGE_MATCH_LENGTH_CHARACTERS) &&
+                   (pMessageId->id.nmea[pFilter->nmeaLength] != 0)) {
+                ch = pMessageId->id.nmea[pFilter->nmeaLength];
+                if (ch != '?') {
+                    pFilter->nmeaValue |= ((uint64_t) (uint8_t) ch) << (pFilter->nmeaLength * 8);
+                    pFilter->nmeaMask |= ((uint64_t) 0xFF) << (pFilter->nmeaLength * 8);
+                }
+                pFilter->nmeaLength++;
+            }
+            break;
+        case U_GNSS_PROTOCOL_RTCM:
+            if (pMessageId->id.rtcm != U_GNSS_RTCM_MESSAGE_ID_ALL) {
+                pFilter->idMask = 0xFFFF;
+                pFilter->idValue = pMessageId->id.rtcm;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+// Return true if the given compiled message ID is wanted.
+bool uGnssPrivateMessageFilterIsWanted(const uGnssPrivateMessageFilter_t *pMessage,
+                                       const uGnssPrivateMessageFilter_t *pWanted)
+{
+    bool isWanted = false;
+
+    if ((pWanted->type == U_GNSS_PROTOCOL_ANY) ||
+        (pWanted->type == U_GNSS_PROTOCOL_ALL)) {
+        isWanted = true;
+    } else if (pWanted->type == pMessage->type) {
+        switch (pWanted->type) {
+            case U_GNSS_PROTOCOL_UNKNOWN:
+                isWanted = true;
+                break;
+            case U_GNSS_PROTOCOL_UBX:
+            //fall-through
+            case U_GNSS_PROTOCOL_RTCM:
+                isWanted = ((pMessage->idValue & pWanted->idMask) == pWanted->idValue);
+                break;
+            case U_GNSS_PROTOCOL_NMEA:
+                isWanted = (pMessage->nmeaLength >= pWanted->nmeaLength) &&
+                           ((pMessage->nmeaValue & pWanted->nmeaMask) == pWanted->nmeaValue);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return isWanted;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS THAT ARE PRIVATE TO GNSS: STREAMING TRANSPORT ONLY
  * -------------------------------------------------------------- */
@@ -1947,21 +2237,27 @@ int32_t uGnssPrivateStreamGetReceiveSize(uGnssPrivateInstance_t *pInstance)
             break;
             case U_GNSS_PRIVATE_STREAM_TYPE_I2C: {
                 int32_t i2cAddress = pInstance->i2cAddress;
-                // The number of bytes waiting for us is available by a read of
-                // I2C register addresses 0xFD and 0xFE in the GNSS chip.
-                // The register address in the GNSS chip auto-increments, so sending
-                // 0xFD, with no stop bit, and then a read request for two bytes
-                // should get us the [big-endian] length
-                buffer[0] = 0xFD;
-                errorCodeOrReceiveSize = uPortI2cControllerSend(pInstance->transportHandle.i2c,
-                                                                i2cAddress,
-                                                                buffer, 1, true);
-                if (errorCodeOrReceiveSize == 0) {
-                    errorCodeOrReceiveSize = uPortI2cControllerSendReceive(pInstance->transportHandle.i2c,
-                                                                           i2cAddress,
-                                                                           NULL, 0, buffer, sizeof(buffer));
-                    if (errorCodeOrReceiveSize == sizeof(buffer)) {
-                        errorCodeOrReceiveSize = (int32_t) ((((uint32_t) buffer[0]) << 8) + (uint32_t) buffer[1]);
+                if ((pInstance->pinTxReady >= 0) && !txReadyIsAsserted(pInstance)) {
+                    // TX ready says there is nothing for us, no need
+                    // to bother the I2C bus
+                    errorCodeOrReceiveSize = 0;
+                } else {
+                    // The number of bytes waiting for us is available by a read of
+                    // I2C register addresses 0xFD and 0xFE in the GNSS chip.
+                    // The register address in the GNSS chip auto-increments, so sending
+                    // 0xFD, with no stop bit, and then a read request for two bytes
+                    // should get us the [big-endian] length
+                    buffer[0] = 0xFD;
+                    errorCodeOrReceiveSize = uPortI2cControllerSend(pInstance->transportHandle.i2c,
+                                                                    i2cAddress,
+                                                                    buffer, 1, true);
+                    if (errorCodeOrReceiveSize == 0) {
+                        errorCodeOrReceiveSize = uPortI2cControllerSendReceive(pInstance->transportHandle.i2c,
+                                                                               i2cAddress,
+                                                                               NULL, 0, buffer, sizeof(buffer));
+                        if (errorCodeOrReceiveSize == sizeof(buffer)) {
+                            errorCodeOrReceiveSize = (int32_t) ((((uint32_t) buffer[0]) << 8) + (uint32_t) buffer[1]);
+                        }
                     }
                 }
             }
@@ -1969,27 +2265,33 @@ int32_t uGnssPrivateStreamGetReceiveSize(uGnssPrivateInstance_t *pInstance)
             case U_GNSS_PRIVATE_STREAM_TYPE_SPI: {
                 char spiBuffer[U_GNSS_SPI_FILL_THRESHOLD_MAX] = {0}; // Zero'ed to keep Valgrind happy
                 size_t spiReadLength;
-                // SPI handling is a little different: since there is no way
-                // to tell if there is any valid data, one just has to read
-                // it and see if it is not 0xFF fill, we actually do a read
-                // of up to spiFillThreshold bytes here, then we can determine
-                // whether there is any real stuff.  The data that is read is
-                // stored in the internal SPI ring buffer and can be read out
-                // by whoever called this function
-                spiReadLength = pInstance->spiFillThreshold;
-                if (spiReadLength < U_GNSS_PRIVATE_SPI_READ_LENGTH_MIN_BYTES) {
-                    spiReadLength = U_GNSS_PRIVATE_SPI_READ_LENGTH_MIN_BYTES;
-                }
-                errorCodeOrReceiveSize = uPortSpiControllerSendReceiveBlock(pInstance->transportHandle.spi,
-                                                                            NULL, 0,
-                                                                            spiBuffer,
-                                                                            spiReadLength);
-                if (errorCodeOrReceiveSize > 0) {
-                    // This will add any non-fill SPI received data to the
-                    // internal SPI ring buffer
-                    errorCodeOrReceiveSize = uGnssPrivateSpiAddReceivedData(pInstance,
-                                                                            spiBuffer,
-                                                                            errorCodeOrReceiveSize);
+                if (pInstance->pSpiReceiveAsyncBuffer != NULL) {
+                    // Data is being received in the background, straight
+                    // into the internal SPI ring buffer, no need to poll
+                    errorCodeOrReceiveSize = (int32_t) uRingBufferDataSize(pInstance->pSpiRingBuffer);
+                } else {
+                    // SPI handling is a little different: since there is no way
+                    // to tell if there is any valid data, one just has to read
+                    // it and see if it is not 0xFF fill, we actually do a read
+                    // of up to spiFillThreshold bytes here, then we can determine
+                    // whether there is any real stuff.  The data that is read is
+                    // stored in the internal SPI ring buffer and can be read out
+                    // by whoever called this function
+                    spiReadLength = pInstance->spiFillThreshold;
+                    if (spiReadLength < U_GNSS_PRIVATE_SPI_READ_LENGTH_MIN_BYTES) {
+                        spiReadLength = U_GNSS_PRIVATE_SPI_READ_LENGTH_MIN_BYTES;
+                    }
+                    errorCodeOrReceiveSize = uPortSpiControllerSendReceiveBlock(pInstance->transportHandle.spi,
+                                                                                NULL, 0,
+                                                                                spiBuffer,
+                                                                                spiReadLength);
+                    if (errorCodeOrReceiveSize > 0) {
+                        // This will add any non-fill SPI received data to the
+                        // internal SPI ring buffer
+                        errorCodeOrReceiveSize = uGnssPrivateSpiAddReceivedData(pInstance,
+                                                                                spiBuffer,
+                                                                                errorCodeOrReceiveSize);
+                    }
                 }
             }
             break;
@@ -2021,9 +2323,7 @@ int32_t uGnssPrivateStreamDecodeRingBuffer(uRingBuffer_t *pRingBuffer,
     if ((pRingBuffer != NULL) && (pPrivateMessageId != NULL)) {
         while (1) {
             U_RING_BUFFER_PARSER_f parserList[] = {
-                parseUbx,
-                parseNmea,
-                parseRtcm,
+                parseAny,
                 NULL
             };
             uGnssPrivateMessageId_t msg;
@@ -2096,8 +2396,12 @@ int32_t uGnssPrivateStreamFillRingBuffer(uGnssPrivateInstance_t *pInstance,
     int32_t receiveSize;
     int32_t totalReceiveSize = 0;
     int32_t ringBufferAvailableSize;
+    int32_t i2cReceiveSizeLeft = 0;
     char *pTemporaryBuffer;
+    const char *pReceived;
+    uDeviceSerial_t *pPeekedDeviceSerial;
 
+    U_LOG_RAM_TRACE_BEGIN(U_LOG_RAM_EVENT_GNSS_STREAM_FILL, timeoutMs);
     if (pInstance != NULL) {
         pTemporaryBuffer = pInstance->pTemporaryBuffer;
         if ((pInstance->pMsgReceive != NULL) &&
@@ -2116,7 +2420,17 @@ int32_t uGnssPrivateStreamFillRingBuffer(uGnssPrivateInstance_t *pInstance,
             // This is constructed as a do()/while() so that
             // it always has one go even with a zero timeout
             do {
-                receiveSize = uGnssPrivateStreamGetReceiveSize(pInstance);
+                if (i2cReceiveSizeLeft > 0) {
+                    // The GNSS chip has already told us how much it has
+                    // for us over I2C, no need to ask it again
+                    receiveSize = i2cReceiveSizeLeft;
+                } else {
+                    receiveSize = uGnssPrivateStreamGetReceiveSize(pInstance);
+                }
+                i2cReceiveSizeLeft = 0;
+                if (privateStreamTypeOrError == (int32_t) U_GNSS_PRIVATE_STREAM_TYPE_I2C) {
+                    i2cReceiveSizeLeft = receiveSize;
+                }
                 // Don't try to read in more than uRingBufferForceAdd()
                 // can put into the ring buffer
                 ringBufferAvailableSize = uRingBufferAvailableSizeMax(&(pInstance->ringBuffer));
@@ -2128,6 +2442,8 @@ int32_t uGnssPrivateStreamFillRingBuffer(uGnssPrivateInstance_t *pInstance,
                     if (receiveSize > U_GNSS_MSG_TEMPORARY_BUFFER_LENGTH_BYTES) {
                         receiveSize = U_GNSS_MSG_TEMPORARY_BUFFER_LENGTH_BYTES;
                     }
+                    pReceived = pTemporaryBuffer;
+                    pPeekedDeviceSerial = NULL;
                     switch (privateStreamTypeOrError) {
                         case U_GNSS_PRIVATE_STREAM_TYPE_UART:
                             // For UART we ask for as much data as we can, it will just
@@ -2146,6 +2462,13 @@ int32_t uGnssPrivateStreamFillRingBuffer(uGnssPrivateInstance_t *pInstance,
                                                                         NULL, 0,
                                                                         pTemporaryBuffer,
                                                                         receiveSize);
+                            if (receiveSize > 0) {
+                                // Anything left we can read straight away,
+                                // in the next go around this loop
+                                i2cReceiveSizeLeft -= receiveSize;
+                            } else {
+                                i2cReceiveSizeLeft = 0;
+                            }
                             break;
                         case U_GNSS_PRIVATE_STREAM_TYPE_SPI:
                             // For the SPI case, we need to pull the data that was
@@ -2155,10 +2478,23 @@ int32_t uGnssPrivateStreamFillRingBuffer(uGnssPrivateInstance_t *pInstance,
                                                                     pTemporaryBuffer, receiveSize);
                             break;
                         case U_GNSS_PRIVATE_STREAM_TYPE_VIRTUAL_SERIAL: {
-                            // As for the UART case, we ask for as much data as we can
                             uDeviceSerial_t *pDeviceSerial = pInstance->transportHandle.pDeviceSerial;
-                            receiveSize = pDeviceSerial->read(pDeviceSerial, pTemporaryBuffer,
-                                                              U_GNSS_MSG_TEMPORARY_BUFFER_LENGTH_BYTES);
+                            const void *pData = NULL;
+                            // If the serial device will let us see into its receive
+                            // buffer then add to the ring buffer straight from there,
+                            // consuming it afterwards; this saves a copy
+                            int32_t peekSize = pDeviceSerial->peek(pDeviceSerial, &pData);
+                            if (peekSize >= 0) {
+                                if (peekSize < receiveSize) {
+                                    receiveSize = peekSize;
+                                }
+                                pReceived = (const char *) pData;
+                                pPeekedDeviceSerial = pDeviceSerial;
+                            } else {
+                                // As for the UART case, we ask for as much data as we can
+                                receiveSize = pDeviceSerial->read(pDeviceSerial, pTemporaryBuffer,
+                                                                  U_GNSS_MSG_TEMPORARY_BUFFER_LENGTH_BYTES);
+                            }
                         }
                         break;
                         default:
@@ -2172,37 +2508,94 @@ int32_t uGnssPrivateStreamFillRingBuffer(uGnssPrivateInstance_t *pInstance,
                         // to block data from the GNSS chip, after all it has
                         // no UART flow control lines that we can stop it with
                         if (!uRingBufferForceAdd(&(pInstance->ringBuffer),
-                                                 pTemporaryBuffer, receiveSize)) {
+                                                 pReceived, receiveSize)) {
                             errorCodeOrLength = (int32_t) U_ERROR_COMMON_NO_MEMORY;
                         }
+                        if ((pPeekedDeviceSerial != NULL) && (receiveSize > 0)) {
+                            pPeekedDeviceSerial->consume(pPeekedDeviceSerial, receiveSize);
+                        }
+                        if (receiveSize > 0) {
+                            pInstance->ringBufferAddTimeMs = uPortGetTickTimeMs();
+                            // Remember when this chunk arrived, writing the mark
+                            // before moving the position on
+                            pInstance->arrivalMark[pInstance->arrivalMarkNext].endPosition =
+                                pInstance->ringBufferAddPosition + receiveSize;
+                            pInstance->arrivalMark[pInstance->arrivalMarkNext].timeMs =
+                                pInstance->ringBufferAddTimeMs;
+                            pInstance->arrivalMarkNext = (pInstance->arrivalMarkNext + 1) %
+                                                         U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM;
+                            pInstance->ringBufferAddPosition += receiveSize;
+                        }
                     } else {
                         // Error case
                         errorCodeOrLength = receiveSize;
                     }
                 } else if ((ringBufferAvailableSize > 0) && (timeoutMs > 0)) {
                     // Relax while we're waiting for more data to arrive
-                    uPortTaskBlock(10);
+                    uGnssPrivateStreamWaitForData(pInstance, 10);
                 }
                 // Exit if we get an error (that is not a timeout), or if we were given zero time,
                 // or if there is no room in the ring-buffer for more data, or if we've
                 // received nothing and hit the timeout, or if we are not still receiving stuff
-                // or were given a maximum time and have exceeded it
+                // or were given a maximum time and have exceeded it; however, if the GNSS chip
+                // has told us over I2C that it has more for us, always read it all
             } while (((errorCodeOrLength == (int32_t) U_ERROR_COMMON_TIMEOUT) || (errorCodeOrLength >= 0)) &&
-                     (timeoutMs > 0) && (ringBufferAvailableSize > 0) &&
-                     // The first condition below is the "not yet received anything case", guarded by timeoutMs
-                     // the second condition below is when we're receiving stuff, guarded by maxTimeMs
-                     (((totalReceiveSize == 0) && (uPortGetTickTimeMs() - startTimeMs < timeoutMs)) ||
-                      ((receiveSize > 0) && ((maxTimeMs == 0) || (uPortGetTickTimeMs() - startTimeMs < maxTimeMs)))));
+                     (ringBufferAvailableSize > 0) &&
+                     (((i2cReceiveSizeLeft > 0) && (receiveSize > 0)) ||
+                      ((timeoutMs > 0) &&
+                       // The first condition below is the "not yet received anything case", guarded by timeoutMs
+                       // the second condition below is when we're receiving stuff, guarded by maxTimeMs
+                       (((totalReceiveSize == 0) && (uPortGetTickTimeMs() - startTimeMs < timeoutMs)) ||
+                        ((receiveSize > 0) && ((maxTimeMs == 0) || (uPortGetTickTimeMs() - startTimeMs < maxTimeMs)))))));
         }
     }
 
     if (totalReceiveSize > 0) {
         errorCodeOrLength = totalReceiveSize;
     }
+    U_LOG_RAM_TRACE_END(U_LOG_RAM_EVENT_GNSS_STREAM_FILL, errorCodeOrLength);
 
     return errorCodeOrLength;
 }
 
+// Get the position of the data at a read handle of the ring buffer.
+uint32_t uGnssPrivateStreamGetPosition(const uGnssPrivateInstance_t *pInstance,
+                                       int32_t readHandle)
+{
+    // Position first, then data size: should data be added in between
+    // the result errs on the side of being too old rather than too new
+    uint32_t position = pInstance->ringBufferAddPosition;
+
+    return position - (uint32_t) uRingBufferDataSizeHandle(&(pInstance->ringBuffer), readHandle);
+}
+
+// Get the time at which the byte at a given position arrived.
+int32_t uGnssPrivateStreamGetArrivalTime(const uGnssPrivateInstance_t *pInstance,
+                                         uint32_t position, int32_t *pTimeMs)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+    const uGnssPrivateArrivalMark_t *pMark = NULL;
+    size_t index = pInstance->arrivalMarkNext;
+    bool keepGoing = true;
+
+    // Work backwards from the newest mark: the chunk containing
+    // position is the oldest one that ends after it
+    for (size_t x = 0; (x < U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM) && keepGoing; x++) {
+        index = (index + U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM - 1) % U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM;
+        if ((int32_t) (pInstance->arrivalMark[index].endPosition - position) > 0) {
+            pMark = &(pInstance->arrivalMark[index]);
+        } else {
+            keepGoing = false;
+        }
+    }
+    if ((pMark != NULL) && !keepGoing) {
+        *pTimeMs = pMark->timeMs;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
 // Read data from the internal ring buffer into the given linear buffer.
 int32_t uGnssPrivateStreamReadRingBuffer(uGnssPrivateInstance_t *pInstance,
                                          int32_t readHandle,
@@ -2449,26 +2842,31 @@ int32_t uGnssPrivateSpiAddReceivedData(uGnssPrivateInstance_t *pInstance,
                                        const char *pBuffer, size_t size)
 {
     int32_t errorCodeOrLength = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-    const char *pTmp = pBuffer;
-    int32_t y;
+    size_t start = 0;
+    size_t x = 0;
+    size_t y;
 
     if ((pInstance != NULL) && (pInstance->pSpiRingBuffer != NULL) &&
         (pBuffer != NULL) && (size > 0)) {
-        if ((pInstance->spiFillThreshold > 0) && (size >= (size_t) pInstance->spiFillThreshold)) {
-            // Check if all we have is fill and chuck stuff away if so
-            // Note: do the comparison as a uint8_t pointer to avoid
-            // issues with char being signed
-            for (size_t x = 0; (x < size) && ((*(const uint8_t *) pTmp) == U_GNSS_PRIVATE_SPI_FILL); x++) {
-                pTmp++;
-            }
-            y = pTmp - pBuffer;
-            if (y >= pInstance->spiFillThreshold) {
-                pBuffer += y;
-                size -= y;
+        if (pInstance->spiFillThreshold > 0) {
+            // Chuck away, in bulk, any runs of fill that are at least
+            // spiFillThreshold long, adding just the data in between
+            while (x < size) {
+                x += spiDataLength(pBuffer + x, size - x);
+                y = spiFillLength(pBuffer + x, size - x);
+                if (y >= (size_t) pInstance->spiFillThreshold) {
+                    if (x > start) {
+                        // Do a forced add so we always keep the most recent data
+                        uRingBufferForceAdd(pInstance->pSpiRingBuffer, pBuffer + start, x - start);
+                    }
+                    start = x + y;
+                }
+                x += y;
             }
         }
-        // Do a forced add so we always keep the most recent data
-        uRingBufferForceAdd(pInstance->pSpiRingBuffer, pBuffer, size);
+        if (size > start) {
+            uRingBufferForceAdd(pInstance->pSpiRingBuffer, pBuffer + start, size - start);
+        }
         if (pInstance->spiFillThreshold > 0) {
             // Fill might still have got into the ring buffer, e.g. if
             // we are receiving data in chunks smaller than the fill
@@ -2482,6 +2880,138 @@ int32_t uGnssPrivateSpiAddReceivedData(uGnssPrivateInstance_t *pInstance,
     return errorCodeOrLength;
 }
 
+// Start using the TX ready pin.
+int32_t uGnssPrivateTxReadyStart(uGnssPrivateInstance_t *pInstance,
+                                 int32_t pinMcu, int32_t pinGnss,
+                                 size_t thresholdBytes)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    uPortGpioConfig_t gpioConfig;
+    uPortGpioInterruptEdge_t edge = U_PORT_GPIO_INTERRUPT_EDGE_RISING;
+    uGnssCfgVal_t cfgVal[] = {{U_GNSS_CFG_VAL_KEY_ID_TXREADY_ENABLED_L, 1},
+        {U_GNSS_CFG_VAL_KEY_ID_TXREADY_POLARITY_L, 0},
+        {U_GNSS_CFG_VAL_KEY_ID_TXREADY_PIN_U1, 0},
+        {U_GNSS_CFG_VAL_KEY_ID_TXREADY_THRESHOLD_U2, 0},
+        {U_GNSS_CFG_VAL_KEY_ID_TXREADY_INTERFACE_E1, U_GNSS_CFG_VAL_KEY_ITEM_VALUE_TXREADY_INTERFACE_I2C}
+    };
+
+    if ((pInstance->transportType == U_GNSS_TRANSPORT_I2C) &&
+        U_GNSS_PRIVATE_HAS(pInstance->pModule, U_GNSS_PRIVATE_FEATURE_CFGVALXXX)) {
+        // Stop using any previous pin while we set up
+        if ((pInstance->pinTxReady >= 0) && (pInstance->txReadySemaphore != NULL)) {
+            uPortGpioInterruptSet(pInstance->pinTxReady & ~U_GNSS_PIN_INVERTED,
+                                  U_PORT_GPIO_INTERRUPT_EDGE_RISING, NULL, NULL);
+        }
+        pInstance->pinTxReady = -1;
+        if (pinMcu & U_GNSS_PIN_INVERTED) {
+            cfgVal[1].value = 1;
+            edge = U_PORT_GPIO_INTERRUPT_EDGE_FALLING;
+        }
+        cfgVal[2].value = pinGnss;
+        // The threshold is in units of 8 bytes
+        thresholdBytes = (thresholdBytes + 7) / 8;
+        if (thresholdBytes > UINT16_MAX) {
+            thresholdBytes = UINT16_MAX;
+        }
+        cfgVal[3].value = thresholdBytes;
+        errorCode = uGnssCfgPrivateValSetList(pInstance, cfgVal,
+                                              sizeof(cfgVal) / sizeof(cfgVal[0]),
+                                              U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                              U_GNSS_CFG_LAYERS_SET);
+        if (errorCode == 0) {
+            U_PORT_GPIO_SET_DEFAULT(&gpioConfig);
+            gpioConfig.pin = pinMcu & ~U_GNSS_PIN_INVERTED;
+            gpioConfig.direction = U_PORT_GPIO_DIRECTION_INPUT;
+            errorCode = uPortGpioConfig(&gpioConfig);
+            if (errorCode == 0) {
+                // The interrupt is optional: without it we still save
+                // the I2C bus from polling by checking the pin level
+                if ((pInstance->txReadySemaphore != NULL) ||
+                    (uPortSemaphoreCreate(&(pInstance->txReadySemaphore), 0, 1) == 0)) {
+                    if (uPortGpioInterruptSet(gpioConfig.pin, edge,
+                                              txReadyInterruptCallback, pInstance) != 0) {
+                        uPortLog("U_GNSS: no interrupt available on TX ready pin %d,"
+                                 " the pin will be polled.\n", gpioConfig.pin);
+                    }
+                }
+                pInstance->pinTxReady = pinMcu;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Stop using the TX ready pin.
+int32_t uGnssPrivateTxReadyStop(uGnssPrivateInstance_t *pInstance)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    uGnssCfgVal_t cfgVal = {U_GNSS_CFG_VAL_KEY_ID_TXREADY_ENABLED_L, 0};
+
+    if (pInstance->pinTxReady >= 0) {
+        if (pInstance->txReadySemaphore != NULL) {
+            uPortGpioInterruptSet(pInstance->pinTxReady & ~U_GNSS_PIN_INVERTED,
+                                  U_PORT_GPIO_INTERRUPT_EDGE_RISING, NULL, NULL);
+        }
+        pInstance->pinTxReady = -1;
+        errorCode = uGnssCfgPrivateValSetList(pInstance, &cfgVal, 1,
+                                              U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                              U_GNSS_CFG_LAYERS_SET);
+    }
+
+    return errorCode;
+}
+
+// Wait for data to arrive.
+void uGnssPrivateStreamWaitForData(uGnssPrivateInstance_t *pInstance,
+                                   int32_t timeMs)
+{
+    if ((pInstance->txReadySemaphore != NULL) && (pInstance->pinTxReady >= 0)) {
+        uPortSemaphoreTryTake(pInstance->txReadySemaphore, timeMs);
+    } else {
+        uPortTaskBlock(timeMs);
+    }
+}
+
+// Start background SPI reception.
+int32_t uGnssPrivateSpiReceiveAsyncStart(uGnssPrivateInstance_t *pInstance)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+
+    if ((U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES > 0) &&
+        (pInstance->pSpiRingBuffer != NULL) &&
+        (pInstance->pSpiReceiveAsyncBuffer == NULL)) {
+        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        // Two buffers, one being filled while the other is emptied
+        pInstance->pSpiReceiveAsyncBuffer = (char *) pUPortMalloc(U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES * 2);
+        if (pInstance->pSpiReceiveAsyncBuffer != NULL) {
+            errorCode = uPortSpiControllerReceiveAsyncStart(pInstance->transportHandle.spi,
+                                                            pInstance->pSpiReceiveAsyncBuffer,
+                                                            U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES,
+                                                            U_GNSS_SPI_RECEIVE_ASYNC_INTERVAL_MS,
+                                                            spiReceiveAsyncCallback,
+                                                            (void *) pInstance);
+            if (errorCode != 0) {
+                // No background reception, we will be polling
+                uPortFree(pInstance->pSpiReceiveAsyncBuffer);
+                pInstance->pSpiReceiveAsyncBuffer = NULL;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Stop background SPI reception.
+void uGnssPrivateSpiReceiveAsyncStop(uGnssPrivateInstance_t *pInstance)
+{
+    if (pInstance->pSpiReceiveAsyncBuffer != NULL) {
+        uPortSpiControllerReceiveAsyncStop(pInstance->transportHandle.spi);
+        uPortFree(pInstance->pSpiReceiveAsyncBuffer);
+        pInstance->pSpiReceiveAsyncBuffer = NULL;
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS THAT ARE PRIVATE TO GNSS: ANY TRANSPORT
  * -------------------------------------------------------------- */
@@ -82,8 +82,82 @@ extern "C" {
 // evaluates to True
 //lint -esym(755, U_GNSS_PRIVATE_HAS) Suppress macro not
 // referenced it may be conditionally compiled-out.
-#define U_GNSS_PRIVATE_HAS(pModule, feature) \
+#ifdef U_CFG_GNSS_MODULE_TYPE_ONLY
+# define U_GNSS_PRIVATE_HAS(pModule, feature) \
+    ((pModule != NULL) && ((U_GNSS_PRIVATE_FEATURES_ONLY) & (1UL << (int32_t) (feature))))
+#else
+# define U_GNSS_PRIVATE_HAS(pModule, feature) \
     ((pModule != NULL) && ((pModule->featuresBitmap) & (1UL << (int32_t) (feature))))
+#endif
+
+/** The features of each module type, the featuresBitmap field of
+ * its entry in gUGnssPrivateModuleList; these are macros so that,
+ * where the module type is fixed at compile time with
+ * U_CFG_GNSS_MODULE_TYPE_ONLY, U_GNSS_PRIVATE_HAS() is a constant.
+ */
+#define U_GNSS_PRIVATE_FEATURES_M8                              \
+    (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_OLD_CFG_API)
+
+#define U_GNSS_PRIVATE_FEATURES_M9                              \
+    ((1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_CFGVALXXX)   |    \
+     (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_OLD_CFG_API) |    \
+     (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_GEOFENCE))
+
+#define U_GNSS_PRIVATE_FEATURES_M10                                     \
+    ((1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_CFGVALXXX) |              \
+     (1UL << (int32_t) U_GNSS_PRIVATE_FEATURE_RXM_MEAS_50_20_C12_D12))
+
+/** The value of each member of uGnssModuleType_t, by suffix, for use
+ * where the preprocessor needs a number; must match uGnssModuleType_t.
+ */
+#define U_GNSS_PRIVATE_MODULE_NUM_M8  0
+#define U_GNSS_PRIVATE_MODULE_NUM_M9  1
+#define U_GNSS_PRIVATE_MODULE_NUM_M10 2
+
+/** Helpers to paste the suffix given by U_CFG_GNSS_MODULE_TYPE_ONLY
+ * onto something.
+ */
+#define U_GNSS_PRIVATE_CONCAT_(a, b) a##b
+#define U_GNSS_PRIVATE_CONCAT(a, b) U_GNSS_PRIVATE_CONCAT_(a, b)
+
+#ifdef U_CFG_GNSS_MODULE_TYPE_ONLY
+/** The number of the only module type this driver supports.
+ */
+# define U_GNSS_PRIVATE_MODULE_NUM_ONLY \
+    U_GNSS_PRIVATE_CONCAT(U_GNSS_PRIVATE_MODULE_NUM_, U_CFG_GNSS_MODULE_TYPE_ONLY)
+/** The only module type this driver supports.
+ */
+# define U_GNSS_PRIVATE_MODULE_TYPE_ONLY \
+    U_GNSS_PRIVATE_CONCAT(U_GNSS_MODULE_TYPE_, U_CFG_GNSS_MODULE_TYPE_ONLY)
+/** The features of the only module type this driver supports.
+ */
+# define U_GNSS_PRIVATE_FEATURES_ONLY \
+    U_GNSS_PRIVATE_CONCAT(U_GNSS_PRIVATE_FEATURES_, U_CFG_GNSS_MODULE_TYPE_ONLY)
+/** Return true if the given module type is supported by this driver.
+ */
+# define U_GNSS_PRIVATE_MODULE_IS_SUPPORTED(moduleType) \
+    ((moduleType) == U_GNSS_PRIVATE_MODULE_TYPE_ONLY)
+/** The index of the given module type in gUGnssPrivateModuleList.
+ */
+# define U_GNSS_PRIVATE_MODULE_INDEX(moduleType) 0
+/** The module type of the given instance: a constant since
+ * there is only one.
+ */
+# define U_GNSS_PRIVATE_MODULE_TYPE(pInstance) \
+    ((void) (pInstance), (uGnssModuleType_t) U_GNSS_PRIVATE_MODULE_TYPE_ONLY)
+#else
+# define U_GNSS_PRIVATE_MODULE_NUM_ONLY -1
+# define U_GNSS_PRIVATE_MODULE_IS_SUPPORTED(moduleType) \
+    ((size_t) (moduleType) < gUGnssPrivateModuleListSize)
+# define U_GNSS_PRIVATE_MODULE_INDEX(moduleType) (moduleType)
+# define U_GNSS_PRIVATE_MODULE_TYPE(pInstance) ((pInstance)->pModule->moduleType)
+#endif
+
+/** Return true if the module type with the given number is compiled
+ * into this driver; for use with #if.
+ */
+#define U_GNSS_PRIVATE_MODULE_IS_COMPILED_IN(moduleNum) \
+    ((U_GNSS_PRIVATE_MODULE_NUM_ONLY < 0) || (U_GNSS_PRIVATE_MODULE_NUM_ONLY == (moduleNum)))
 
 /** Flag to indicate that the pos task has run (for synchronisation
  * purposes.
@@ -100,6 +174,11 @@ extern "C" {
  */
 #define U_GNSS_POS_TASK_FLAG_CONTINUOUS 0x04
 
+/** The number of UBX messages that streamed position may
+ * switch on, see gUGnssPrivateStreamedPosMessage[].
+ */
+#define U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES 3
+
 /** The value that constitutes "no data" on SPI.
  */
 #define U_GNSS_PRIVATE_SPI_FILL 0xFF
@@ -112,10 +191,35 @@ extern "C" {
 # define U_GNSS_CFG_LAYERS_SET (U_GNSS_CFG_VAL_LAYER_RAM | U_GNSS_CFG_VAL_LAYER_BBRAM)
 #endif
 
+#ifndef U_GNSS_CFG_SHADOW_MAX_NUM_ENTRIES
+/** The maximum number of configuration values that are shadowed
+ * in each GNSS instance, see uGnssPrivateCfgShadowEntry_t.
+ */
+# define U_GNSS_CFG_SHADOW_MAX_NUM_ENTRIES 16
+#endif
+
+#ifndef U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM
+/** The number of additions to the ring buffer for which the arrival
+ * time is remembered, see uGnssPrivateArrivalMark_t; this bounds how
+ * old a message can be and still have its arrival time known.
+ */
+# define U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM 32
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The arrival time of a chunk of data added to the ring buffer of
+ * a GNSS instance; positions are counted in bytes since the instance
+ * was created, wrapping, so that the position of the first byte of a
+ * message can be turned back into the time at which it arrived.
+ */
+typedef struct {
+    uint32_t endPosition; /**< the position after the last byte of the chunk. */
+    int32_t timeMs;       /**< the tick time at which the chunk was added. */
+} uGnssPrivateArrivalMark_t;
+
 /** Features of a module that require different compile-time
  * behaviours in this implementation.
  */
@@ -128,6 +232,16 @@ typedef enum {
     U_GNSS_PRIVATE_FEATURE_RXM_MEAS_50_20_C12_D12
 } uGnssPrivateFeature_t;
 
+/** A host-side copy of a configuration value known to be set in all
+ * of the #U_GNSS_CFG_LAYERS_SET layers of the GNSS chip, allowing a
+ * UBX-CFG-VALSET of the same value to be skipped; only values of
+ * up to four bytes are shadowed.
+ */
+typedef struct {
+    uint32_t keyId;
+    uint32_t value;
+} uGnssPrivateCfgShadowEntry_t;
+
 /** The characteristics that may differ between GNSS modules.
  * Note: order is important since this is statically initialised.
  */
@@ -168,6 +282,22 @@ typedef struct {
     } id;
 } uGnssPrivateMessageId_t;
 
+/** A message ID compiled by uGnssPrivateMessageFilterCompile() so
+ * that uGnssPrivateMessageFilterIsWanted() can check one against
+ * another with a fixed number of integer operations, whatever the
+ * wild-cards.
+ */
+typedef struct {
+    uGnssProtocol_t type;
+    uint16_t idValue; /**< UBX or RTCM ID, with any wild-carded bits zeroed. */
+    uint16_t idMask;  /**< the bits of idValue that must match. */
+    uint64_t nmeaValue; /**< the NMEA ID, one character per byte, least
+                             significant byte first, with any wild-carded
+                             characters zeroed. */
+    uint64_t nmeaMask;  /**< the bytes of nmeaValue that must match. */
+    size_t nmeaLength;  /**< the number of characters in the NMEA ID. */
+} uGnssPrivateMessageFilter_t;
+
 /** Structure to hold the data associated with one non-blocking
  * message read utility function, intended to be used in a
  * linked-list.
@@ -175,10 +305,14 @@ typedef struct {
 typedef struct uGnssPrivateMsgReader_t {
     int32_t handle;
     uGnssPrivateMessageId_t privateMessageId;
+    uGnssPrivateMessageFilter_t filter; /**< privateMessageId, compiled. */
     void *pCallback; /**< stored as a void * to avoid having to bring
                           all the types of uGnssTransparentReceiveCallback_t
                           into everything. */
     void *pCallbackParam;
+    void *pQueue; /**< if this reader has its own task, as set up by
+                       uGnssMsgReceiveStartQueued(), the queue that
+                       feeds it (type private to u_gnss_msg.c), else NULL. */
     struct uGnssPrivateMsgReader_t *pNext;
 } uGnssPrivateMsgReader_t;
 
@@ -194,9 +328,22 @@ typedef struct {
     uPortMutexHandle_t readerMutexHandle;
     int32_t ringBufferReadHandle;
     size_t msgBytesLeftToRead;
+    uint32_t msgPosition; /**< the ring buffer position of the start of the message
+                               being passed to the callbacks, see uGnssPrivateArrivalMark_t. */
     uGnssPrivateMsgReader_t *pReaderList;
 } uGnssPrivateMsgReceive_t;
 
+/** A UBX message that streamed position may switch on.
+ */
+typedef struct {
+    uint16_t ubxMessageId; /**< the message class and ID, as for
+                                U_GNSS_UBX_MESSAGE(). */
+    uint32_t keyIdMsgOutI2c; /**< the CFG-MSGOUT key ID for the message
+                                  on the I2C port; the key ID for any
+                                  other port is this plus the port
+                                  number (#uGnssPort_t). */
+} uGnssPrivateStreamedPosMessage_t;
+
 /** Parameters to pass to the streamed position callback.
  */
 typedef struct {
@@ -213,9 +360,35 @@ typedef struct {
                        int64_t timeUtc);
     int32_t measurementPeriodMs; /**< set to -1 of nothing to restore. */
     int32_t navigationCount;     /**< set to -1 of nothing to restore. */
-    int32_t messageRate;         /**< set to -1 of nothing to restore. */
+    int32_t messageRate[U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES]; /**< indexed as
+                                                                        gUGnssPrivateStreamedPosMessage[],
+                                                                        each set to -1 if
+                                                                        nothing to restore. */
+    void *pFixContext;           /**< context for uGnssPosGetStreamedFixStart(),
+                                      NULL if not in use; free'd with uPortFree(). */
 } uGnssPrivateStreamedPosition_t;
 
+/** Context for uGnssPosGetRrlpBatchStart().
+ */
+typedef struct {
+    uDeviceHandle_t gnssHandle;
+    int32_t asyncHandle;
+    int32_t messageRate; /**< the previous UBX-RXM-MEASX rate, -1 if nothing to restore. */
+    char *pArena;        /**< the caller's storage for the measurement sets. */
+    size_t arenaSize;
+    size_t length;       /**< the number of bytes of pArena that are in use. */
+    size_t numSets;      /**< the number of measurement sets in pArena. */
+    size_t numSetsWanted;
+    int32_t svsThreshold;
+    int32_t cNoThreshold;
+    int32_t multipathIndexLimit;
+    int32_t pseudorangeRmsErrorIndexLimit;
+    void (*pCallback) (uDeviceHandle_t gnssHandle,
+                       const char *pArena, size_t size,
+                       size_t numSets, void *pCallbackParam);
+    void *pCallbackParam;
+} uGnssPrivateRrlpBatch_t;
+
 /** Parameters for AssistNow.
  */
 typedef struct {
@@ -243,14 +416,28 @@ typedef struct uGnssPrivateInstance_t {
     uGnssTransportHandle_t transportHandle; /**< the handle of the transport to use. */
     uRingBuffer_t *pSpiRingBuffer; /**< local ring buffer needed for SPI data received while we're sending. */
     char *pSpiLinearBuffer; /**< the linear buffer that will be used by pSpiRingBuffer. */
+    char *pSpiReceiveAsyncBuffer; /**< the two buffers for background SPI reception,
+                                       NULL if the SPI bus is being polled. */
     uRingBuffer_t ringBuffer; /**< the ring buffer where we put messages from the GNSS chip. */
     char *pLinearBuffer; /**< the linear buffer that will be used by ringBuffer. */
     char *pTemporaryBuffer; /**< a temporary buffer, used to get stuff into ringBuffer. */
+    int32_t ringBufferAddTimeMs; /**< the tick time at which data was last added to ringBuffer
+                                      from the transport, used in measuring latency. */
+    uint32_t ringBufferAddPosition; /**< the total number of bytes ever added to ringBuffer, wrapping. */
+    uGnssPrivateArrivalMark_t arrivalMark[U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM]; /**< the arrival
+                                                                                      times of the most
+                                                                                      recent additions
+                                                                                      to ringBuffer. */
+    size_t arrivalMarkNext; /**< the entry of arrivalMark[] that will be written next. */
     int32_t ringBufferReadHandlePrivate; /**< the read handle for this code to use, -1 if there isn't one. */
     int32_t ringBufferReadHandleMsgReceive; /**< the read handle for uGnssUtilTransparentReceive(). */
     uint16_t i2cAddress; /**< the I2C address of the GNSS chip, only relevant if the transport is I2C. */
     int32_t timeoutMs; /**< the timeout for responses from the GNSS chip in milliseconds. */
     int32_t spiFillThreshold; /**< the number of 0xFF fill bytes which constitute "no data" on SPI. */
+    int32_t pinTxReady; /**< the MCU pin connected to the TX ready pin of the GNSS chip, with
+                             #U_GNSS_PIN_INVERTED OR'ed in if it is active low, -1 if not in use. */
+    uPortSemaphoreHandle_t txReadySemaphore; /**< given from interrupt when TX ready is
+                                                  asserted, NULL if there is no interrupt. */
     bool printUbxMessages; /**< whether debug printing of UBX messages is on or off. */
     int32_t retriesOnNoResponse; /**< number of times to retry message transmission if there is no response. */
     int32_t pinGnssEnablePower; /**< the pin of the MCU that enables power to the GNSS module. */
@@ -267,10 +454,18 @@ typedef struct uGnssPrivateInstance_t {
     volatile uint8_t posTaskFlags; /**< flags to synchronisation the pos task. */
     uGnssPrivateMsgReceive_t *pMsgReceive; /**< stuff associated with the asychronous
                                                 message receive utility functions. */
+    void *pMsgInject; /**< the correction injection context, see uGnssMsgInjectStart(),
+                           private to u_gnss_msg.c. */
     uGnssPrivateStreamedPosition_t *pStreamedPosition; /**< context data for streamed position, hooked
                                                             here so that we can free it */
     uGnssRrlpMode_t rrlpMode; /**< The type of MEASX to use with RRLP capture. */
+    uGnssPrivateRrlpBatch_t *pRrlpBatch; /**< context for uGnssPosGetRrlpBatchStart(),
+                                              hooked here so that we can free it. */
+    void *pPwrDutyCycle; /**< the duty-cycling engine context while uGnssPwrDutyCycleFix()
+                              is running, a uGnssPwrDutyCycle_t, owned by the application. */
     uGnssPrivateMga_t *pMga; /**< Storage for AssistNow. */
+    uGnssPrivateCfgShadowEntry_t cfgShadow[U_GNSS_CFG_SHADOW_MAX_NUM_ENTRIES]; /**< shadow of configuration values. */
+    size_t cfgShadowNumEntries; /**< the number of valid entries in cfgShadow. */
     struct uGnssPrivateInstance_t *pNext;
 } uGnssPrivateInstance_t;
 // *INDENT-ON*
@@ -296,6 +491,11 @@ extern uGnssPrivateInstance_t *gpUGnssPrivateInstanceList;
  */
 extern uPortMutexHandle_t gUGnssPrivateMutex;
 
+/** The UBX messages that streamed position may switch on:
+ * UBX-NAV-PVT, UBX-NAV-HPPOSLLH and UBX-NAV-COV, in that order.
+ */
+extern const uGnssPrivateStreamedPosMessage_t gUGnssPrivateStreamedPosMessage[U_GNSS_PRIVATE_STREAMED_POS_NUM_MESSAGES];
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: MISC
  * -------------------------------------------------------------- */
@@ -482,6 +682,21 @@ int32_t uGnssPrivateSetProtocolOut(uGnssPrivateInstance_t *pInstance,
                                    uGnssProtocol_t protocol,
                                    bool onNotOff);
 
+/** Populate the configuration shadow of the GNSS instance (see
+ * uGnssCfgPrivateShadowFill()) with the rate and output protocol
+ * settings, so that uGnssPrivateSetRate() and
+ * uGnssPrivateSetProtocolOut() need not send values that are
+ * already set; does nothing for GNSS chips that do not support
+ * the UBX-CFG-VALXXX mechanism.
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot be NULL.
+ * @return               on success the number of values now in the
+ *                       shadow, else negative error code.
+ */
+int32_t uGnssPrivateCfgShadowFill(uGnssPrivateInstance_t *pInstance);
+
 /** Shut down and free memory from a [potentially] running pos task.
  *
  * Note: gUGnssPrivateMutex should be locked before this is called.
@@ -490,6 +705,15 @@ int32_t uGnssPrivateSetProtocolOut(uGnssPrivateInstance_t *pInstance,
  */
 void uGnssPrivateCleanUpPosTask(uGnssPrivateInstance_t *pInstance);
 
+/** Shut down the TX ready interrupt and free the semaphore used with
+ * it; should be called after uGnssPrivateStopMsgReceive().
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot  be NULL.
+ */
+void uGnssPrivateCleanUpTxReady(uGnssPrivateInstance_t *pInstance);
+
 /** Shut down and free memory from streamd position; should be called
  * before uGnssPrivateStopMsgReceive().
  *
@@ -499,6 +723,15 @@ void uGnssPrivateCleanUpPosTask(uGnssPrivateInstance_t *pInstance);
  */
 void uGnssPrivateCleanUpStreamedPos(uGnssPrivateInstance_t *pInstance);
 
+/** Shut down and free memory from batched RRLP capture; should be
+ * called before uGnssPrivateStopMsgReceive().
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot  be NULL.
+ */
+void uGnssPrivateCleanUpRrlpBatch(uGnssPrivateInstance_t *pInstance);
+
 /** Check whether a GNSS chip that we are using via a cellular module
  * is on-board the cellular module, in which case the AT+GPIOC
  * comands are not used.
@@ -566,6 +799,29 @@ int32_t uGnssPrivateMessageIdToPublic(const uGnssPrivateMessageId_t *pPrivateMes
 bool uGnssPrivateMessageIdIsWanted(uGnssPrivateMessageId_t *pMessageId,
                                    uGnssPrivateMessageId_t *pMessageIdWanted);
 
+/** Compile a private message ID, either a wanted one or the ID of
+ * a received message, for use with uGnssPrivateMessageFilterIsWanted();
+ * worth doing where the same IDs are checked over and over again,
+ * as the message receive task does.
+ *
+ * @param[in] pMessageId the private message ID to compile; cannot
+ *                       be NULL.
+ * @param[out] pFilter   a place to put the compiled message ID;
+ *                       cannot be NULL.
+ */
+void uGnssPrivateMessageFilterCompile(const uGnssPrivateMessageId_t *pMessageId,
+                                      uGnssPrivateMessageFilter_t *pFilter);
+
+/** As uGnssPrivateMessageIdIsWanted() but for message IDs that
+ * have been compiled with uGnssPrivateMessageFilterCompile().
+ *
+ * @param[in] pMessage the compiled message ID to check; cannot be NULL.
+ * @param[in] pWanted  the compiled wanted message ID; cannot be NULL.
+ * @return             true if pMessage is inside pWanted, else false.
+ */
+bool uGnssPrivateMessageFilterIsWanted(const uGnssPrivateMessageFilter_t *pMessage,
+                                       const uGnssPrivateMessageFilter_t *pWanted);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: STREAMING TRANSPORT (UART/I2C/VIRTUAL SERIAL) ONLY
  * -------------------------------------------------------------- */
@@ -670,6 +926,33 @@ int32_t uGnssPrivateStreamDecodeRingBuffer(uRingBuffer_t *pRingBuffer,
                                            int32_t readHandle,
                                            uGnssPrivateMessageId_t *pPrivateMessageId);
 
+/** Get the position, in the terms of uGnssPrivateArrivalMark_t, of
+ * the data at the read pointer of the given ring buffer read handle;
+ * following a successful uGnssPrivateStreamDecodeRingBuffer() this
+ * is the position of the first byte of the message.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot be NULL.
+ * @param readHandle     the read handle of the ring buffer.
+ * @return               the position.
+ */
+uint32_t uGnssPrivateStreamGetPosition(const uGnssPrivateInstance_t *pInstance,
+                                       int32_t readHandle);
+
+/** Get the tick time at which the byte at the given position, as
+ * returned by uGnssPrivateStreamGetPosition(), was added to the ring
+ * buffer, i.e. when it was read from the transport.
+ *
+ * @param[in] pInstance  a pointer to the GNSS instance, cannot be NULL.
+ * @param position       the position.
+ * @param[out] pTimeMs   a place to put the tick time; cannot be NULL.
+ * @return               zero on success, #U_ERROR_COMMON_NOT_FOUND if
+ *                       the position is older than the oldest of the
+ *                       #U_GNSS_RING_BUFFER_ARRIVAL_MARKS_NUM additions
+ *                       that are remembered.
+ */
+int32_t uGnssPrivateStreamGetArrivalTime(const uGnssPrivateInstance_t *pInstance,
+                                         uint32_t position, int32_t *pTimeMs);
+
 /** Read data from the internal ring buffer into the given linear buffer.
  *
  * Note: gUGnssPrivateMutex should be locked before this is called, but
@@ -865,6 +1148,73 @@ int32_t uGnssPrivateReceiveStreamMessage(uGnssPrivateInstance_t *pInstance,
 int32_t uGnssPrivateSpiAddReceivedData(uGnssPrivateInstance_t *pInstance,
                                        const char *pBuffer, size_t size);
 
+/** Start using the TX ready pin of the GNSS chip to tell when there is
+ * data to read over I2C: the GNSS chip is configured to assert TX ready
+ * when it has data, the MCU pin is set up as an input and, where the
+ * platform supports uPortGpioInterruptSet(), an interrupt is attached to
+ * it so that uGnssPrivateStreamWaitForData() returns as soon as data is
+ * available.
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance   a pointer to the GNSS instance, cannot be NULL.
+ * @param pinMcu          the MCU pin connected to TX ready, with
+ *                        #U_GNSS_PIN_INVERTED OR'ed in if the pin
+ *                        is to be active low.
+ * @param pinGnss         the pin (PIO number) of the GNSS chip that
+ *                        should carry TX ready.
+ * @param thresholdBytes  the amount of data the GNSS chip should have
+ *                        before asserting TX ready.
+ * @return                zero on success else negative error code.
+ */
+int32_t uGnssPrivateTxReadyStart(uGnssPrivateInstance_t *pInstance,
+                                 int32_t pinMcu, int32_t pinGnss,
+                                 size_t thresholdBytes);
+
+/** Stop using the TX ready pin and switch TX ready off in the GNSS chip;
+ * the semaphore is kept until uGnssPrivateCleanUpTxReady() is called
+ * since the message receive task may be waiting on it.
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance a pointer to the GNSS instance, cannot be NULL.
+ * @return              zero on success else negative error code.
+ */
+int32_t uGnssPrivateTxReadyStop(uGnssPrivateInstance_t *pInstance);
+
+/** Wait for up to timeMs for data to arrive from the GNSS chip: if
+ * there is a TX ready interrupt this may return early, otherwise it
+ * just blocks for timeMs.
+ *
+ * @param[in] pInstance a pointer to the GNSS instance, cannot be NULL.
+ * @param timeMs        the maximum time to wait in milliseconds.
+ */
+void uGnssPrivateStreamWaitForData(uGnssPrivateInstance_t *pInstance,
+                                   int32_t timeMs);
+
+/** Start receiving SPI data from the GNSS chip in the background, with
+ * uPortSpiControllerReceiveAsyncStart(), the received data being passed
+ * to uGnssPrivateSpiAddReceivedData().  If the platform does not support
+ * background SPI reception, or #U_GNSS_SPI_RECEIVE_ASYNC_BUFFER_LENGTH_BYTES
+ * is zero, the SPI bus will continue to be polled.
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance a pointer to the GNSS instance, cannot be NULL;
+ *                      pSpiRingBuffer must have been created.
+ * @return              zero on success else negative error code.
+ */
+int32_t uGnssPrivateSpiReceiveAsyncStart(uGnssPrivateInstance_t *pInstance);
+
+/** Stop background SPI reception, if it was started, and free the
+ * buffers; must be called before pSpiRingBuffer is deleted.
+ *
+ * Note: gUGnssPrivateMutex should be locked before this is called.
+ *
+ * @param[in] pInstance a pointer to the GNSS instance, cannot be NULL.
+ */
+void uGnssPrivateSpiReceiveAsyncStop(uGnssPrivateInstance_t *pInstance);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: ANY TRANSPORT
  * -------------------------------------------------------------- */
@@ -58,6 +58,8 @@
 #include "u_gnss_cfg_val_key.h"
 #include "u_gnss_cfg.h"
 #include "u_gnss_cfg_private.h"
+#include "u_gnss_pos.h"
+#include "u_gnss_mga.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -83,6 +85,29 @@
 # define U_GNSS_PWR_SYSTEM_TYPES 0x7f
 #endif
 
+#ifndef U_GNSS_PWR_DUTY_CYCLE_SPEED_MAX_MILLIMETRES_PER_SECOND
+/** The fastest the device is assumed to move between fixes when the
+ * duty-cycling engine works out how uncertain the position hint is:
+ * 30 metres per second is a little over 100 km/h.
+ */
+# define U_GNSS_PWR_DUTY_CYCLE_SPEED_MAX_MILLIMETRES_PER_SECOND 30000
+#endif
+
+#ifndef U_GNSS_PWR_DUTY_CYCLE_MCU_CLOCK_ACCURACY_PPM
+/** How accurately the tick time of this MCU keeps time, in parts
+ * per million, used by the duty-cycling engine when working out
+ * how uncertain the time hint is.
+ */
+# define U_GNSS_PWR_DUTY_CYCLE_MCU_CLOCK_ACCURACY_PPM 100
+#endif
+
+#ifndef U_GNSS_PWR_DUTY_CYCLE_POLL_INTERVAL_MS
+/** How long the duty-cycling engine waits before asking again for
+ * a fix when the one it got was not accurate enough.
+ */
+# define U_GNSS_PWR_DUTY_CYCLE_POLL_INTERVAL_MS 1000
+#endif
+
 /** The number of entries in gFlagToKeyId.
  */
 #define U_GNSS_PWR_FLAG_TO_KEY_ID_NUM_ENTRIES 8
@@ -471,6 +496,89 @@ static int32_t setOrClearFlags(uDeviceHandle_t gnssHandle, uint32_t bitMap, bool
     return errorCode;
 }
 
+// Mark a duty-cycling engine as running on a GNSS instance, or
+// not running if pDutyCycle is NULL, so that dutyCycleKeepGoing()
+// can find it.
+static int32_t dutyCycleSet(uDeviceHandle_t gnssHandle,
+                            uGnssPwrDutyCycle_t *pDutyCycle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uGnssPrivateInstance_t *pInstance;
+
+    if (gUGnssPrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUGnssPrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUGnssPrivateGetInstance(gnssHandle);
+        if (pInstance != NULL) {
+            errorCode = (int32_t) U_ERROR_COMMON_BUSY;
+            if ((pDutyCycle == NULL) || (pInstance->pPwrDutyCycle == NULL)) {
+                pInstance->pPwrDutyCycle = pDutyCycle;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUGnssPrivateMutex);
+    }
+
+    return errorCode;
+}
+
+// Return true if an attempt of the duty-cycling engine should continue.
+static bool dutyCycleContinue(uDeviceHandle_t gnssHandle,
+                              const uGnssPwrDutyCycle_t *pDutyCycle)
+{
+    return (uPortGetTickTimeMs() < pDutyCycle->stopTimeMs) &&
+           ((pDutyCycle->pKeepGoingCallback == NULL) ||
+            pDutyCycle->pKeepGoingCallback(gnssHandle));
+}
+
+// The keep-going callback passed to uGnssPosGet() by
+// uGnssPwrDutyCycleFix(); uGnssPosGet() calls this with
+// gUGnssPrivateMutex locked, hence the instance may be
+// looked up without locking it again.
+static bool dutyCycleKeepGoing(uDeviceHandle_t gnssHandle)
+{
+    bool keepGoing = false;
+    uGnssPrivateInstance_t *pInstance = pUGnssPrivateGetInstance(gnssHandle);
+
+    if ((pInstance != NULL) && (pInstance->pPwrDutyCycle != NULL)) {
+        keepGoing = dutyCycleContinue(gnssHandle,
+                                      (uGnssPwrDutyCycle_t *) pInstance->pPwrDutyCycle);
+    }
+
+    return keepGoing;
+}
+
+// Give the GNSS chip the position and time of the last fix, with
+// an uncertainty that has grown with the time since, to help it
+// hot-start; failure is not an error, the hints are just lost.
+static void dutyCycleHints(uDeviceHandle_t gnssHandle,
+                           const uGnssPwrDutyCycle_t *pDutyCycle)
+{
+    int64_t elapsedMs = uPortGetTickTimeMs() - pDutyCycle->fixTimeMs;
+    int64_t radiusMillimetres;
+    uGnssMgaPos_t mgaPos;
+
+    if (pDutyCycle->fixTimeUtc >= 0) {
+        uGnssMgaIniTimeSend(gnssHandle,
+                            ((pDutyCycle->fixTimeUtc * 1000) + elapsedMs) * 1000000,
+                            1000000000LL + (elapsedMs * U_GNSS_PWR_DUTY_CYCLE_MCU_CLOCK_ACCURACY_PPM),
+                            NULL);
+    }
+    radiusMillimetres = pDutyCycle->radiusMillimetres +
+                        ((elapsedMs * U_GNSS_PWR_DUTY_CYCLE_SPEED_MAX_MILLIMETRES_PER_SECOND) / 1000);
+    if (radiusMillimetres > INT_MAX) {
+        radiusMillimetres = INT_MAX;
+    }
+    mgaPos.latitudeX1e7 = pDutyCycle->latitudeX1e7;
+    mgaPos.longitudeX1e7 = pDutyCycle->longitudeX1e7;
+    mgaPos.altitudeMillimetres = pDutyCycle->altitudeMillimetres;
+    mgaPos.radiusMillimetres = (int32_t) radiusMillimetres;
+    uGnssMgaIniPosSend(gnssHandle, &mgaPos);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -531,7 +639,7 @@ int32_t uGnssPwrOn(uDeviceHandle_t gnssHandle)
                                                                           0x06, 0x04,
                                                                           message, 4) > 0) {
                                 errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-                                if (pInstance->pModule->moduleType == U_GNSS_MODULE_TYPE_M8) {
+                                if (U_GNSS_PRIVATE_MODULE_TYPE(pInstance) == U_GNSS_MODULE_TYPE_M8) {
                                     errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
                                     // From the M8 receiver description, a HW reset is also
                                     // required at this point if Galileo is enabled,
@@ -564,6 +672,15 @@ int32_t uGnssPwrOn(uDeviceHandle_t gnssHandle)
                 }
             }
 
+            // Whatever we knew of the configuration may now be wrong
+            uGnssCfgPrivateShadowClear(pInstance);
+            if (errorCode == 0) {
+                // Find out what is already configured so that boot-time
+                // configuration of the same values costs nothing; not
+                // being able to do so is not an error
+                uGnssPrivateCfgShadowFill(pInstance);
+            }
+
             if ((errorCode < 0) && (pInstance->pinGnssEnablePower >= 0)) {
                 // If we were unable to send all the relevant commands and
                 // there is a power enable then switch it off again so that
@@ -658,6 +775,8 @@ int32_t uGnssPwrOff(uDeviceHandle_t gnssHandle)
                 }
             }
 
+            uGnssCfgPrivateShadowClear(pInstance);
+
             if (pInstance->pinGnssEnablePower >= 0) {
                 // Let this overwrite any other errors
                 errorCode = uPortGpioSet(pInstance->pinGnssEnablePower,
@@ -688,6 +807,7 @@ int32_t uGnssPwrOffBackup(uDeviceHandle_t gnssHandle)
         if (pInstance != NULL) {
             errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
             if (pInstance->transportType != U_GNSS_TRANSPORT_AT) {
+                uGnssCfgPrivateShadowClear(pInstance);
                 // Put the GNSS chip into backup mode with UBX-RXM-PMREQ
                 // This message is not acknowledged and fiddling with the
                 // GNSS chip after this will wake it up again, so we just
@@ -1215,4 +1335,166 @@ int32_t uGnssPwrGetExtintInactivityTimeout(uDeviceHandle_t gnssHandle)
     return errorCodeOrTimeout;
 }
 
+// Initialise the context of the duty-cycling engine.
+int32_t uGnssPwrDutyCycleInit(uGnssPwrDutyCycle_t *pDutyCycle,
+                              const uGnssPwrDutyCycleCfg_t *pCfg)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pDutyCycle != NULL) && (pCfg != NULL) &&
+        (pCfg->fixIntervalSeconds >= 0) && (pCfg->onTimeMaxSeconds > 0)) {
+        memset(pDutyCycle, 0, sizeof(*pDutyCycle));
+        pDutyCycle->cfg = *pCfg;
+        pDutyCycle->stat.onTimeLastMs = -1;
+        pDutyCycle->stat.onTimeMaxMs = -1;
+        pDutyCycle->stat.onTimePerFixMs = -1;
+        pDutyCycle->startTimeMs = -1;
+        pDutyCycle->fixTimeMs = -1;
+        pDutyCycle->fixTimeUtc = -1;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Perform one cycle of the duty-cycling engine.
+int32_t uGnssPwrDutyCycleFix(uDeviceHandle_t gnssHandle,
+                             uGnssPwrDutyCycle_t *pDutyCycle,
+                             int32_t *pLatitudeX1e7, int32_t *pLongitudeX1e7,
+                             int32_t *pAltitudeMillimetres,
+                             int32_t *pRadiusMillimetres,
+                             int64_t *pTimeUtc,
+                             bool (*pKeepGoingCallback) (uDeviceHandle_t))
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uGnssTransportType_t transportType = U_GNSS_TRANSPORT_NONE;
+    int32_t latitudeX1e7;
+    int32_t longitudeX1e7;
+    int32_t altitudeMillimetres;
+    int32_t radiusMillimetres = -1;
+    int64_t timeUtc = -1;
+    int64_t onTimeMs;
+    bool goodEnough = false;
+
+    if (pDutyCycle != NULL) {
+        // Note: the GNSS API calls below each lock gUGnssPrivateMutex
+        // themselves, so it must not be held here
+        errorCode = dutyCycleSet(gnssHandle, pDutyCycle);
+        if (errorCode == 0) {
+            pDutyCycle->pKeepGoingCallback = pKeepGoingCallback;
+            pDutyCycle->startTimeMs = uPortGetTickTimeMs();
+            pDutyCycle->stopTimeMs = pDutyCycle->startTimeMs +
+                                     ((int64_t) pDutyCycle->cfg.onTimeMaxSeconds * 1000);
+            errorCode = uGnssPwrOn(gnssHandle);
+            if (errorCode == 0) {
+                uGnssGetTransportHandle(gnssHandle, &transportType, NULL);
+                if (transportType != U_GNSS_TRANSPORT_AT) {
+                    if (pDutyCycle->cfg.assistNowAutonomous && !pDutyCycle->autonomousDone &&
+                        (uGnssMgaSetAutonomous(gnssHandle, true) == 0)) {
+                        pDutyCycle->autonomousDone = true;
+                    }
+                    if (pDutyCycle->fixTimeMs >= 0) {
+                        dutyCycleHints(gnssHandle, pDutyCycle);
+                    }
+                }
+                errorCode = (int32_t) U_ERROR_COMMON_TIMEOUT;
+                while (!goodEnough && dutyCycleContinue(gnssHandle, pDutyCycle)) {
+                    if (uGnssPosGet(gnssHandle, &latitudeX1e7, &longitudeX1e7,
+                                    &altitudeMillimetres, &radiusMillimetres,
+                                    NULL, NULL, &timeUtc, dutyCycleKeepGoing) == 0) {
+                        // Any fix is worth keeping as a hint for next time
+                        pDutyCycle->fixTimeMs = uPortGetTickTimeMs();
+                        pDutyCycle->fixTimeUtc = timeUtc;
+                        pDutyCycle->latitudeX1e7 = latitudeX1e7;
+                        pDutyCycle->longitudeX1e7 = longitudeX1e7;
+                        pDutyCycle->altitudeMillimetres = altitudeMillimetres;
+                        pDutyCycle->radiusMillimetres = radiusMillimetres;
+                        goodEnough = (pDutyCycle->cfg.radiusMillimetresMax < 0) ||
+                                     (radiusMillimetres <= pDutyCycle->cfg.radiusMillimetresMax);
+                        if (!goodEnough) {
+                            uPortTaskBlock(U_GNSS_PWR_DUTY_CYCLE_POLL_INTERVAL_MS);
+                        }
+                    }
+                }
+                if (goodEnough) {
+                    errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    if (pLatitudeX1e7 != NULL) {
+                        *pLatitudeX1e7 = latitudeX1e7;
+                    }
+                    if (pLongitudeX1e7 != NULL) {
+                        *pLongitudeX1e7 = longitudeX1e7;
+                    }
+                    if (pAltitudeMillimetres != NULL) {
+                        *pAltitudeMillimetres = altitudeMillimetres;
+                    }
+                    if (pRadiusMillimetres != NULL) {
+                        *pRadiusMillimetres = radiusMillimetres;
+                    }
+                    if (pTimeUtc != NULL) {
+                        *pTimeUtc = timeUtc;
+                    }
+                }
+            }
+            // Off again, whatever happened
+            uGnssPwrOff(gnssHandle);
+            onTimeMs = uPortGetTickTimeMs() - pDutyCycle->startTimeMs;
+            if (onTimeMs > INT_MAX) {
+                onTimeMs = INT_MAX;
+            }
+            pDutyCycle->stat.onTimeLastMs = (int32_t) onTimeMs;
+            if (onTimeMs > pDutyCycle->stat.onTimeMaxMs) {
+                pDutyCycle->stat.onTimeMaxMs = (int32_t) onTimeMs;
+            }
+            pDutyCycle->stat.onTimeTotalMs += onTimeMs;
+            if (goodEnough) {
+                pDutyCycle->stat.numFixes++;
+            } else {
+                pDutyCycle->stat.numFailures++;
+            }
+            if (pDutyCycle->stat.numFixes > 0) {
+                pDutyCycle->stat.onTimePerFixMs = (int32_t) (pDutyCycle->stat.onTimeTotalMs /
+                                                             pDutyCycle->stat.numFixes);
+            }
+            dutyCycleSet(gnssHandle, NULL);
+        }
+    }
+
+    return errorCode;
+}
+
+// Get how long to wait before calling uGnssPwrDutyCycleFix() again.
+int32_t uGnssPwrDutyCycleGetWaitMs(const uGnssPwrDutyCycle_t *pDutyCycle)
+{
+    int64_t waitMs = 0;
+
+    if ((pDutyCycle != NULL) && (pDutyCycle->startTimeMs >= 0)) {
+        // The interval is measured from the start of one attempt
+        // to the start of the next
+        waitMs = pDutyCycle->startTimeMs + ((int64_t) pDutyCycle->cfg.fixIntervalSeconds * 1000) -
+                 uPortGetTickTimeMs();
+        if (waitMs < 0) {
+            waitMs = 0;
+        }
+        if (waitMs > INT_MAX) {
+            waitMs = INT_MAX;
+        }
+    }
+
+    return (int32_t) waitMs;
+}
+
+// Get the statistics of the duty-cycling engine.
+int32_t uGnssPwrDutyCycleGetStat(const uGnssPwrDutyCycle_t *pDutyCycle,
+                                 uGnssPwrDutyCycleStat_t *pStat)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if ((pDutyCycle != NULL) && (pStat != NULL)) {
+        *pStat = pDutyCycle->stat;
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
 // End of file
@@ -0,0 +1,809 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Benchmarks for GNSS.  The transport benchmark: for each of
+ * the transports available to this board, measures the round-trip
+ * time of a UBX transaction and, for the streaming transports, the
+ * sustained receive rate, the bytes lost, the time spent in the
+ * message receive callback and the latency of that callback.  The
+ * results are printed, one transport per line, as comma-separated
+ * values beginning with #U_GNSS_BENCHMARK_TEST_CSV_PREFIX, the first
+ * such line being a header, so that they can be picked out of the
+ * test log by a script.  The time-to-first-fix benchmark: for hot,
+ * warm and cold starts, with and without assistance through the
+ * uGnssMga API, measures the time from reset to first fix, broken down
+ * into phases, and prints the statistics in the same way.  These
+ * tests are only compiled if
+ * U_CFG_TEST_GNSS_MODULE_TYPE is defined.
+ * IMPORTANT: see notes in u_cfg_test_platform_specific.h for the
+ * naming rules that must be followed when using the U_PORT_TEST_FUNCTION()
+ * macro.
+ */
+
+#ifdef U_CFG_TEST_GNSS_MODULE_TYPE
+
+# ifdef U_CFG_OVERRIDE
+#  include "u_cfg_override.h" // For a customer's configuration override
+# endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "stdlib.h"    // qsort()
+#include "string.h"    // memset(), memcpy()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_at_client.h" // Required by u_gnss_private.h
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_gnss_module_type.h"
+#include "u_gnss_type.h"
+#include "u_gnss.h"
+#include "u_gnss_cfg.h"   // uGnssCfgSetProtocolOut(), uGnssCfgGetRate(), uGnssCfgSetRate()
+#include "u_gnss_info.h"  // uGnssInfoGetFirmwareVersionStr()
+#include "u_gnss_msg.h"
+#include "u_gnss_pwr.h"   // uGnssPwrIsAlive()
+#include "u_gnss_pos.h"   // uGnssPosGet()
+#include "u_gnss_mga.h"
+#include "u_gnss_private.h"
+
+#include "u_ubx_protocol.h"
+
+#include "u_gnss_test_private.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_GNSS_BENCHMARK_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+/** The string that follows #U_TEST_PREFIX at the start of each
+ * line of machine-readable results.
+ */
+#define U_GNSS_BENCHMARK_TEST_CSV_PREFIX "CSV,"
+
+#ifndef U_GNSS_BENCHMARK_TEST_NUM_TRANSACTIONS
+/** The number of UBX-MON-VER transactions to time on each transport.
+ */
+# define U_GNSS_BENCHMARK_TEST_NUM_TRANSACTIONS 20
+#endif
+
+#ifndef U_GNSS_BENCHMARK_TEST_STREAM_DURATION_SECONDS
+/** How long to measure the streamed receive rate for on each
+ * streaming transport.
+ */
+# define U_GNSS_BENCHMARK_TEST_STREAM_DURATION_SECONDS 30
+#endif
+
+#ifndef U_GNSS_BENCHMARK_TEST_MEASUREMENT_PERIOD_MS
+/** The measurement period to set while streaming, shorter than
+ * the default of one second so that the transport has some work
+ * to do; set this to -1 to leave the measurement period alone.
+ */
+# define U_GNSS_BENCHMARK_TEST_MEASUREMENT_PERIOD_MS 200
+#endif
+
+#ifndef U_GNSS_BENCHMARK_TEST_BUFFER_SIZE_BYTES
+/** The size of the buffer to read messages into, both the
+ * streamed messages and the firmware version string.
+ */
+# define U_GNSS_BENCHMARK_TEST_BUFFER_SIZE_BYTES 1024
+#endif
+
+#ifndef U_GNSS_BENCHMARK_TEST_TTFF_NUM
+/** The number of times to measure the time to first fix for each
+ * type of start.
+ */
+# define U_GNSS_BENCHMARK_TEST_TTFF_NUM 3
+#endif
+
+#ifndef U_GNSS_BENCHMARK_TEST_TTFF_TIMEOUT_SECONDS
+/** How long to wait for a fix after a reset.
+ */
+# define U_GNSS_BENCHMARK_TEST_TTFF_TIMEOUT_SECONDS 180
+#endif
+
+#ifndef U_GNSS_BENCHMARK_TEST_DATABASE_LENGTH_BYTES
+/** The amount of storage for the assistance database read from the
+ * GNSS chip with uGnssMgaGetDatabase(), which is restored to it by
+ * the assisted starts.
+ */
+# define U_GNSS_BENCHMARK_TEST_DATABASE_LENGTH_BYTES (10 * 1024)
+#endif
+
+/** The length of a UBX-NAV-STATUS message, including overhead.
+ */
+#define U_GNSS_BENCHMARK_TEST_NAV_STATUS_LENGTH_BYTES (16 + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES)
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** The results of benchmarking one transport.
+ */
+typedef struct {
+    int32_t transactionTotalMs;
+    int32_t transactionMinMs;
+    int32_t transactionMaxMs;
+    size_t transactionBytes;
+    int32_t streamDurationMs;  /**< zero if streaming was not measured. */
+    size_t streamNumMessages;
+    size_t streamBytes;
+    size_t streamLossBytes;
+    size_t readLossBytes;
+    size_t numTooBig;
+    int32_t callbackTotalMs;
+    int32_t latencyTotalMs;
+    int32_t latencyMaxMs;
+    size_t latencyNumMeasurements;
+} uGnssBenchmarkTestResult_t;
+
+/** Context for messageReceiveCallback().
+ */
+typedef struct {
+    char *pBuffer;
+    uGnssBenchmarkTestResult_t *pResult;
+} uGnssBenchmarkTestReceive_t;
+
+/** A type of start for the time-to-first-fix benchmark.
+ */
+typedef struct {
+    const char *pName;
+    uint16_t navBbrMask; /**< the battery-backed RAM sections cleared by
+                              UBX-CFG-RST: 0 for a hot start, 1 (ephemeris)
+                              for a warm start, 0xFFFF for a cold start. */
+    bool assisted;       /**< if true the time, the position and the
+                              assistance database are sent to the
+                              GNSS chip after the reset. */
+} uGnssBenchmarkTestStart_t;
+
+/** The phases of a start for the time-to-first-fix benchmark.
+ */
+typedef enum {
+    U_GNSS_BENCHMARK_TEST_PHASE_RESTART,     /**< UBX-CFG-RST to the GNSS chip responding. */
+    U_GNSS_BENCHMARK_TEST_PHASE_ASSIST,      /**< sending the assistance data, if any. */
+    U_GNSS_BENCHMARK_TEST_PHASE_FIX,         /**< from then to uGnssPosGet() returning a fix. */
+    U_GNSS_BENCHMARK_TEST_PHASE_TOTAL,       /**< all of the above. */
+    U_GNSS_BENCHMARK_TEST_PHASE_MODULE_TTFF, /**< the TTFF reported by UBX-NAV-STATUS. */
+    U_GNSS_BENCHMARK_TEST_PHASE_MAX_NUM
+} uGnssBenchmarkTestPhase_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Handles.
+ */
+static uGnssTestPrivate_t gHandles = U_GNSS_TEST_PRIVATE_DEFAULTS;
+
+/** A variable to track errors in the callbacks.
+ */
+static int32_t gCallbackErrorCode = 0;
+
+/** Buffer for the streamed messages and the firmware version string.
+ */
+static char *gpBuffer = NULL;
+
+/** The types of start for the time-to-first-fix benchmark.
+ */
+static const uGnssBenchmarkTestStart_t gStart[] = {
+    {"hot", 0x0000, false},
+    {"warm", 0x0001, false},
+    {"cold", 0xFFFF, false},
+    {"warm_assisted", 0x0001, true},
+    {"cold_assisted", 0xFFFF, true}
+};
+
+/** The names of the phases of a start, for the time-to-first-fix
+ * benchmark results; must match uGnssBenchmarkTestPhase_t.
+ */
+static const char *const gpPhaseName[] = {"restart", "assist", "fix", "total", "module_ttff"};
+
+/** The time-to-first-fix benchmark results, static to keep them off
+ * the stack.
+ */
+static int32_t gTtffMs[sizeof(gStart) / sizeof(gStart[0])][U_GNSS_BENCHMARK_TEST_PHASE_MAX_NUM]
+[U_GNSS_BENCHMARK_TEST_TTFF_NUM];
+
+/** Storage for the assistance database, read from the GNSS chip by
+ * the time-to-first-fix benchmark.
+ */
+static char *gpDatabase = NULL;
+
+/** Used for keepGoingCallback() timeout.
+ */
+static int32_t gStopTimeMs = 0;
+
+/** The time to first fix reported in UBX-NAV-STATUS by the
+ * GNSS chip, -1 if not yet known.
+ */
+static volatile int32_t gModuleTtffMs = -1;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Callback for the streamed message receive: reads the message out,
+// which is the "parse" work that an application would do, timing
+// how long that takes and how long ago the message arrived.
+static void messageReceiveCallback(uDeviceHandle_t gnssHandle,
+                                   const uGnssMessageId_t *pMessageId,
+                                   int32_t errorCodeOrLength,
+                                   void *pCallbackParam)
+{
+    uGnssBenchmarkTestReceive_t *pReceive = (uGnssBenchmarkTestReceive_t *) pCallbackParam;
+    uGnssBenchmarkTestResult_t *pResult;
+    int32_t startTimeMs = uPortGetTickTimeMs();
+    int32_t arrivalTimeMs;
+    int32_t latencyMs;
+
+    (void) pMessageId;
+
+    if (gnssHandle != gHandles.gnssHandle) {
+        gCallbackErrorCode = 1;
+    }
+    if ((pReceive == NULL) || (pReceive->pBuffer == NULL) || (pReceive->pResult == NULL)) {
+        gCallbackErrorCode = 2;
+    } else {
+        pResult = pReceive->pResult;
+        if (uGnssMsgReceiveCallbackGetArrivalTime(gnssHandle, &arrivalTimeMs) == 0) {
+            latencyMs = startTimeMs - arrivalTimeMs;
+            if (latencyMs < 0) {
+                gCallbackErrorCode = 3;
+            }
+            pResult->latencyTotalMs += latencyMs;
+            if (latencyMs > pResult->latencyMaxMs) {
+                pResult->latencyMaxMs = latencyMs;
+            }
+            pResult->latencyNumMeasurements++;
+        }
+        if ((errorCodeOrLength > 0) &&
+            (errorCodeOrLength <= U_GNSS_BENCHMARK_TEST_BUFFER_SIZE_BYTES)) {
+            if (uGnssMsgReceiveCallbackRead(gnssHandle, pReceive->pBuffer,
+                                            errorCodeOrLength) == errorCodeOrLength) {
+                pResult->streamNumMessages++;
+                pResult->streamBytes += errorCodeOrLength;
+            } else {
+                gCallbackErrorCode = 4;
+            }
+        } else {
+            // Not an error: some messages might just be too large
+            pResult->numTooBig++;
+        }
+        pResult->callbackTotalMs += uPortGetTickTimeMs() - startTimeMs;
+    }
+}
+
+// Time uGnssInfoGetFirmwareVersionStr(), which works on every
+// transport, including U_GNSS_TRANSPORT_AT.
+static void benchmarkTransaction(uDeviceHandle_t gnssHandle,
+                                 uGnssBenchmarkTestResult_t *pResult)
+{
+    int32_t startTimeMs;
+    int32_t durationMs;
+    int32_t x;
+
+    pResult->transactionMinMs = INT32_MAX;
+    for (size_t y = 0; y < U_GNSS_BENCHMARK_TEST_NUM_TRANSACTIONS; y++) {
+        startTimeMs = uPortGetTickTimeMs();
+        x = uGnssInfoGetFirmwareVersionStr(gnssHandle, gpBuffer,
+                                           U_GNSS_BENCHMARK_TEST_BUFFER_SIZE_BYTES);
+        durationMs = uPortGetTickTimeMs() - startTimeMs;
+        U_PORT_TEST_ASSERT(x > 0);
+        pResult->transactionBytes += x;
+        pResult->transactionTotalMs += durationMs;
+        if (durationMs < pResult->transactionMinMs) {
+            pResult->transactionMinMs = durationMs;
+        }
+        if (durationMs > pResult->transactionMaxMs) {
+            pResult->transactionMaxMs = durationMs;
+        }
+    }
+}
+
+// Measure the streamed receive rate.
+static void benchmarkStream(uDeviceHandle_t gnssHandle,
+                            uGnssBenchmarkTestResult_t *pResult)
+{
+    uGnssBenchmarkTestReceive_t receive;
+    uGnssMessageId_t messageId = {0};
+    int32_t measurementPeriodMs = -1;
+    int32_t asyncHandle;
+    int32_t startTimeMs;
+    size_t streamLossStart;
+    size_t readLossStart;
+
+    receive.pBuffer = gpBuffer;
+    receive.pResult = pResult;
+    messageId.type = U_GNSS_PROTOCOL_ALL;
+
+    // Make sure NMEA is on and, if requested, speed things up
+    U_PORT_TEST_ASSERT(uGnssCfgSetProtocolOut(gnssHandle, U_GNSS_PROTOCOL_NMEA, true) == 0);
+    if (U_GNSS_BENCHMARK_TEST_MEASUREMENT_PERIOD_MS >= 0) {
+        U_PORT_TEST_ASSERT(uGnssCfgGetRate(gnssHandle, &measurementPeriodMs, NULL, NULL) >= 0);
+        U_PORT_TEST_ASSERT(uGnssCfgSetRate(gnssHandle, U_GNSS_BENCHMARK_TEST_MEASUREMENT_PERIOD_MS,
+                                           -1, (uGnssTimeSystem_t) -1) == 0);
+    }
+
+    streamLossStart = uGnssMsgReceiveStatStreamLoss(gnssHandle);
+    readLossStart = uGnssMsgReceiveStatReadLoss(gnssHandle);
+    gCallbackErrorCode = 0;
+    startTimeMs = uPortGetTickTimeMs();
+    asyncHandle = uGnssMsgReceiveStart(gnssHandle, &messageId,
+                                       messageReceiveCallback, &receive);
+    U_PORT_TEST_ASSERT(asyncHandle >= 0);
+    U_TEST_PRINT_LINE("streaming for %d second(s)...",
+                      U_GNSS_BENCHMARK_TEST_STREAM_DURATION_SECONDS);
+    uPortTaskBlock(U_GNSS_BENCHMARK_TEST_STREAM_DURATION_SECONDS * 1000);
+    U_PORT_TEST_ASSERT(uGnssMsgReceiveStop(gnssHandle, asyncHandle) == 0);
+    pResult->streamDurationMs = uPortGetTickTimeMs() - startTimeMs;
+    pResult->streamLossBytes = uGnssMsgReceiveStatStreamLoss(gnssHandle) - streamLossStart;
+    pResult->readLossBytes = uGnssMsgReceiveStatReadLoss(gnssHandle) - readLossStart;
+
+    if (measurementPeriodMs >= 0) {
+        U_PORT_TEST_ASSERT(uGnssCfgSetRate(gnssHandle, measurementPeriodMs,
+                                           -1, (uGnssTimeSystem_t) -1) == 0);
+    }
+
+    U_TEST_PRINT_LINE("gCallbackErrorCode is %d.", gCallbackErrorCode);
+    U_PORT_TEST_ASSERT(gCallbackErrorCode == 0);
+    U_PORT_TEST_ASSERT(pResult->streamNumMessages > 0);
+}
+
+// Print the result for a transport as a line of comma-separated values.
+static void printResult(uGnssTransportType_t transportType,
+                        const uGnssBenchmarkTestResult_t *pResult)
+{
+    int32_t bytesPerSecond = 0;
+    int32_t callbackPerMilleCpu = 0;
+    int32_t latencyAverageMs = 0;
+
+    if (pResult->streamDurationMs > 0) {
+        bytesPerSecond = (int32_t) ((((int64_t) pResult->streamBytes) * 1000) /
+                                    pResult->streamDurationMs);
+        callbackPerMilleCpu = (int32_t) ((((int64_t) pResult->callbackTotalMs) * 1000) /
+                                         pResult->streamDurationMs);
+    }
+    if (pResult->latencyNumMeasurements > 0) {
+        latencyAverageMs = pResult->latencyTotalMs / (int32_t) pResult->latencyNumMeasurements;
+    }
+
+    U_TEST_PRINT_LINE(U_GNSS_BENCHMARK_TEST_CSV_PREFIX "%s,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d",
+                      pGnssTestPrivateTransportTypeName(transportType),
+                      U_GNSS_BENCHMARK_TEST_NUM_TRANSACTIONS,
+                      pResult->transactionTotalMs / U_GNSS_BENCHMARK_TEST_NUM_TRANSACTIONS,
+                      pResult->transactionMinMs, pResult->transactionMaxMs,
+                      pResult->transactionBytes,
+                      pResult->streamDurationMs, pResult->streamNumMessages,
+                      pResult->streamBytes, bytesPerSecond,
+                      pResult->streamLossBytes, pResult->readLossBytes,
+                      pResult->numTooBig, callbackPerMilleCpu,
+                      latencyAverageMs, pResult->latencyMaxMs);
+}
+
+// Callback for the position establishment process.
+static bool keepGoingCallback(uDeviceHandle_t gnssHandle)
+{
+    (void) gnssHandle;
+
+    return uPortGetTickTimeMs() < gStopTimeMs;
+}
+
+// Callback for assistance database reads, storing the chunks in
+// gpDatabase: the parameter is the number of bytes stored so far,
+// or negative if the database is too big.
+static bool databaseCallback(uDeviceHandle_t gnssHandle,
+                             const char *pBuffer, size_t size,
+                             void *pCallbackParam)
+{
+    int32_t *pLength = (int32_t *) pCallbackParam;
+    bool keepGoing = false;
+
+    (void) gnssHandle;
+
+    if ((pLength != NULL) && (*pLength >= 0)) {
+        keepGoing = true;
+        if ((pBuffer != NULL) && (size > 0)) {
+            if (((size_t) *pLength) + size <= U_GNSS_BENCHMARK_TEST_DATABASE_LENGTH_BYTES) {
+                memcpy(gpDatabase + *pLength, pBuffer, size);
+                *pLength += (int32_t) size;
+            } else {
+                *pLength = -1;
+                keepGoing = false;
+            }
+        }
+    }
+
+    return keepGoing;
+}
+
+// Callback for UBX-NAV-STATUS, picking out the time to first fix.
+static void navStatusCallback(uDeviceHandle_t gnssHandle,
+                              const uGnssMessageId_t *pMessageId,
+                              int32_t errorCodeOrLength,
+                              void *pCallbackParam)
+{
+    char buffer[U_GNSS_BENCHMARK_TEST_NAV_STATUS_LENGTH_BYTES];
+    const char *pBody = buffer + U_UBX_PROTOCOL_HEADER_LENGTH_BYTES;
+
+    (void) pMessageId;
+    (void) pCallbackParam;
+
+    if ((errorCodeOrLength == sizeof(buffer)) &&
+        (uGnssMsgReceiveCallbackRead(gnssHandle, buffer, sizeof(buffer)) == sizeof(buffer))) {
+        // Bit 0 of byte 5 of the body is gpsFixOk and the TTFF
+        // is at offset 8
+        if (*(pBody + 5) & 0x01) {
+            gModuleTtffMs = (int32_t) uUbxProtocolUint32Decode(pBody + 8);
+        }
+    }
+}
+
+// Get the time to first fix that the GNSS chip reports, -1 if it
+// doesn't report one.
+static int32_t getModuleTtff(uDeviceHandle_t gnssHandle)
+{
+    uGnssMessageId_t messageId = {0};
+    char command[U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES];
+    int32_t asyncHandle;
+    int32_t startTimeMs;
+
+    gModuleTtffMs = -1;
+    messageId.type = U_GNSS_PROTOCOL_UBX;
+    messageId.id.ubx = 0x0103;
+    asyncHandle = uGnssMsgReceiveStart(gnssHandle, &messageId, navStatusCallback, NULL);
+    if (asyncHandle >= 0) {
+        // Poll UBX-NAV-STATUS
+        if ((uUbxProtocolEncode(0x01, 0x03, NULL, 0, command) == sizeof(command)) &&
+            (uGnssMsgSend(gnssHandle, command, sizeof(command)) == sizeof(command))) {
+            startTimeMs = uPortGetTickTimeMs();
+            while ((gModuleTtffMs < 0) && (uPortGetTickTimeMs() - startTimeMs < 5000)) {
+                uPortTaskBlock(100);
+            }
+        }
+        uGnssMsgReceiveStop(gnssHandle, asyncHandle);
+    }
+
+    return gModuleTtffMs;
+}
+
+// Reset the GNSS chip with UBX-CFG-RST, a controlled software reset
+// of GNSS only, and wait for it to respond again.
+static void reset(uDeviceHandle_t gnssHandle, uint16_t navBbrMask)
+{
+    // navBbrMask, then resetMode 0x02 (controlled GNSS reset), then reserved
+    char body[4] = {0, 0, 0x02, 0};
+    char command[sizeof(body) + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES];
+    int32_t startTimeMs;
+
+    navBbrMask = uUbxProtocolUint16Encode(navBbrMask);
+    memcpy(body, &navBbrMask, sizeof(navBbrMask));
+    U_PORT_TEST_ASSERT(uUbxProtocolEncode(0x06, 0x04, body, sizeof(body),
+                                          command) == sizeof(command));
+    // The message is not acknowledged
+    U_PORT_TEST_ASSERT(uGnssMsgSend(gnssHandle, command, sizeof(command)) == sizeof(command));
+    // Give the reset time to take effect before checking that the
+    // GNSS chip is alive, then give it the full reset time to respond
+    uPortTaskBlock(100);
+    startTimeMs = uPortGetTickTimeMs();
+    while (!uGnssPwrIsAlive(gnssHandle) &&
+           (uPortGetTickTimeMs() - startTimeMs < U_GNSS_RESET_TIME_SECONDS * 1000)) {
+        uPortTaskBlock(100);
+    }
+}
+
+// Compare two int32_t's, for qsort().
+static int compareInt32(const void *p1, const void *p2)
+{
+    return *((const int32_t *) p1) - *((const int32_t *) p2);
+}
+
+// Print the statistics of a set of timings as a line of comma-separated
+// values, ignoring negative (unknown) timings; the timings are sorted
+// in the process.
+static void printStats(const char *pStartName, const char *pPhaseName,
+                       int32_t *pTimeMs, size_t num)
+{
+    int32_t totalMs = 0;
+    size_t first;
+
+    qsort(pTimeMs, num, sizeof(pTimeMs[0]), compareInt32);
+    first = 0;
+    while ((first < num) && (pTimeMs[first] < 0)) {
+        first++;
+    }
+    for (size_t x = first; x < num; x++) {
+        totalMs += pTimeMs[x];
+    }
+    if (first < num) {
+        U_TEST_PRINT_LINE(U_GNSS_BENCHMARK_TEST_CSV_PREFIX "%s,%s,%d,%d,%d,%d,%d",
+                          pStartName, pPhaseName, num - first, pTimeMs[first],
+                          pTimeMs[first + ((num - first) / 2)],
+                          totalMs / (int32_t) (num - first), pTimeMs[num - 1]);
+    } else {
+        U_TEST_PRINT_LINE(U_GNSS_BENCHMARK_TEST_CSV_PREFIX "%s,%s,0,,,,",
+                          pStartName, pPhaseName);
+    }
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Benchmark each of the transports to the GNSS chip that this
+ * board has.
+ */
+U_PORT_TEST_FUNCTION("[gnssBenchmark]", "gnssBenchmarkTransport")
+{
+    int32_t resourceCount;
+    size_t iterations;
+    uGnssTransportType_t transportTypes[U_GNSS_TRANSPORT_MAX_NUM];
+    uGnssBenchmarkTestResult_t results[U_GNSS_TRANSPORT_MAX_NUM];
+
+    // In case a previous test failed
+    uGnssTestPrivateCleanup(&gHandles);
+
+    // Get the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    gpBuffer = (char *) pUPortMalloc(U_GNSS_BENCHMARK_TEST_BUFFER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(gpBuffer != NULL);
+
+    memset(results, 0, sizeof(results));
+    iterations = uGnssTestPrivateTransportTypesSet(transportTypes, U_CFG_APP_GNSS_UART,
+                                                   U_CFG_APP_GNSS_I2C, U_CFG_APP_GNSS_SPI);
+    for (size_t x = 0; x < iterations; x++) {
+        // Do the standard preamble
+        U_TEST_PRINT_LINE("benchmarking transport %s...",
+                          pGnssTestPrivateTransportTypeName(transportTypes[x]));
+        U_PORT_TEST_ASSERT(uGnssTestPrivatePreamble(U_CFG_TEST_GNSS_MODULE_TYPE,
+                                                    transportTypes[x], &gHandles, true,
+                                                    U_CFG_APP_CELL_PIN_GNSS_POWER,
+                                                    U_CFG_APP_CELL_PIN_GNSS_DATA_READY) == 0);
+
+        benchmarkTransaction(gHandles.gnssHandle, &(results[x]));
+        // Streamed message receive is not supported over AT commands
+        if (transportTypes[x] != U_GNSS_TRANSPORT_AT) {
+            benchmarkStream(gHandles.gnssHandle, &(results[x]));
+        }
+
+        // Do the standard postamble
+        uGnssTestPrivatePostamble(&gHandles, true);
+    }
+
+    // Print the results together so that they are easy to find
+    U_TEST_PRINT_LINE(U_GNSS_BENCHMARK_TEST_CSV_PREFIX "transport,transactions,"
+                      "transaction_avg_ms,transaction_min_ms,transaction_max_ms,"
+                      "transaction_bytes,stream_ms,stream_messages,stream_bytes,"
+                      "stream_bytes_per_second,stream_loss_bytes,read_loss_bytes,"
+                      "messages_too_big,callback_cpu_per_mille,callback_latency_avg_ms,"
+                      "callback_latency_max_ms");
+    for (size_t x = 0; x < iterations; x++) {
+        printResult(transportTypes[x], &(results[x]));
+    }
+
+    uPortFree(gpBuffer);
+    gpBuffer = NULL;
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Benchmark the time to first fix of each type of start, with
+ * and without assistance, on the first transport that is not AT
+ * commands.  Assistance is what an application with no network
+ * connection can give: the time, the position and the assistance
+ * database, as read beforehand from the GNSS chip with
+ * uGnssMgaGetDatabase() (which includes whatever AssistNow data
+ * the GNSS chip was given or generated itself).
+ */
+U_PORT_TEST_FUNCTION("[gnssBenchmark]", "gnssBenchmarkTtff")
+{
+    int32_t resourceCount;
+    size_t iterations;
+    uGnssTransportType_t transportTypes[U_GNSS_TRANSPORT_MAX_NUM];
+    uGnssTransportType_t transportType = U_GNSS_TRANSPORT_NONE;
+    uDeviceHandle_t gnssHandle;
+    uDeviceHandle_t intermediateHandle = NULL;
+    uGnssMgaPos_t position;
+    int64_t timeUtc = -1;
+    int32_t fixTimeMs;
+    int32_t databaseLength = 0;
+    int32_t phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_MAX_NUM];
+    int32_t startTimeMs;
+    int32_t phaseStartTimeMs;
+    int32_t x;
+
+    // In case a previous test failed
+    uGnssTestPrivateCleanup(&gHandles);
+
+    // Get the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Resetting the GNSS chip and uGnssMga don't work over AT
+    // commands, so pick the first transport that isn't
+    iterations = uGnssTestPrivateTransportTypesSet(transportTypes, U_CFG_APP_GNSS_UART,
+                                                   U_CFG_APP_GNSS_I2C, U_CFG_APP_GNSS_SPI);
+    for (size_t y = 0; (y < iterations) && (transportType == U_GNSS_TRANSPORT_NONE); y++) {
+        if (transportTypes[y] != U_GNSS_TRANSPORT_AT) {
+            transportType = transportTypes[y];
+        }
+    }
+
+    if (transportType != U_GNSS_TRANSPORT_NONE) {
+        U_TEST_PRINT_LINE("benchmarking time to first fix on transport %s...",
+                          pGnssTestPrivateTransportTypeName(transportType));
+        U_PORT_TEST_ASSERT(uGnssTestPrivatePreamble(U_CFG_TEST_GNSS_MODULE_TYPE,
+                                                    transportType, &gHandles, true,
+                                                    U_CFG_APP_CELL_PIN_GNSS_POWER,
+                                                    U_CFG_APP_CELL_PIN_GNSS_DATA_READY) == 0);
+        gnssHandle = gHandles.gnssHandle;
+        U_PORT_TEST_ASSERT(uGnssGetIntermediate(gnssHandle, &intermediateHandle) == 0);
+    }
+
+    if ((transportType != U_GNSS_TRANSPORT_NONE) && (intermediateHandle == NULL)) {
+        // Get a fix to start with, so that the GNSS chip has
+        // something to retain and we have something to assist it with
+        U_TEST_PRINT_LINE("getting an initial fix...");
+        gStopTimeMs = uPortGetTickTimeMs() + (U_GNSS_BENCHMARK_TEST_TTFF_TIMEOUT_SECONDS * 1000);
+        U_PORT_TEST_ASSERT(uGnssPosGet(gnssHandle, &(position.latitudeX1e7),
+                                       &(position.longitudeX1e7),
+                                       &(position.altitudeMillimetres),
+                                       &(position.radiusMillimetres),
+                                       NULL, NULL, &timeUtc, keepGoingCallback) == 0);
+        fixTimeMs = uPortGetTickTimeMs();
+        if (position.radiusMillimetres < 100000) {
+            position.radiusMillimetres = 100000;
+        }
+        gpDatabase = (char *) pUPortMalloc(U_GNSS_BENCHMARK_TEST_DATABASE_LENGTH_BYTES);
+        U_PORT_TEST_ASSERT(gpDatabase != NULL);
+        x = uGnssMgaGetDatabase(gnssHandle, databaseCallback, &databaseLength);
+        if ((x < 0) || (databaseLength < 0)) {
+            // Not fatal, the assisted starts will just be less assisted
+            databaseLength = 0;
+        }
+        U_TEST_PRINT_LINE("assistance database is %d byte(s).", databaseLength);
+
+        memset(gTtffMs, 0xFF, sizeof(gTtffMs));
+        for (size_t y = 0; y < sizeof(gStart) / sizeof(gStart[0]); y++) {
+            for (size_t z = 0; z < U_GNSS_BENCHMARK_TEST_TTFF_NUM; z++) {
+                U_TEST_PRINT_LINE("%s start, go %d of %d...", gStart[y].pName, z + 1,
+                                  U_GNSS_BENCHMARK_TEST_TTFF_NUM);
+                startTimeMs = uPortGetTickTimeMs();
+                reset(gnssHandle, gStart[y].navBbrMask);
+                phaseStartTimeMs = uPortGetTickTimeMs();
+                phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_RESTART] = phaseStartTimeMs - startTimeMs;
+
+                if (gStart[y].assisted) {
+                    // Time is to the nearest second, so say that it is
+                    // accurate to two
+                    x = (phaseStartTimeMs - fixTimeMs) / 1000;
+                    U_PORT_TEST_ASSERT(uGnssMgaIniTimeSend(gnssHandle,
+                                                           (timeUtc + x) * 1000000000LL,
+                                                           2000000000LL, NULL) == 0);
+                    U_PORT_TEST_ASSERT(uGnssMgaIniPosSend(gnssHandle, &position) == 0);
+                    if (databaseLength > 0) {
+                        // A NACK for part of the database isn't fatal, the
+                        // rest of it will still have been accepted
+                        x = uGnssMgaSetDatabase(gnssHandle, U_GNSS_MGA_FLOW_CONTROL_SMART,
+                                                gpDatabase, databaseLength, NULL, NULL);
+                        if (x < 0) {
+                            U_TEST_PRINT_LINE("uGnssMgaSetDatabase() returned %d.", x);
+                        }
+                    }
+                }
+                x = uPortGetTickTimeMs();
+                phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_ASSIST] = x - phaseStartTimeMs;
+                phaseStartTimeMs = x;
+
+                gStopTimeMs = phaseStartTimeMs +
+                              (U_GNSS_BENCHMARK_TEST_TTFF_TIMEOUT_SECONDS * 1000);
+                U_PORT_TEST_ASSERT(uGnssPosGet(gnssHandle, NULL, NULL, NULL, NULL,
+                                               NULL, NULL, NULL, keepGoingCallback) == 0);
+                x = uPortGetTickTimeMs();
+                phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_FIX] = x - phaseStartTimeMs;
+                phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_TOTAL] = x - startTimeMs;
+                phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_MODULE_TTFF] = getModuleTtff(gnssHandle);
+
+                U_TEST_PRINT_LINE("restart %d ms, assist %d ms, fix %d ms, total %d ms,"
+                                  " module TTFF %d ms.",
+                                  phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_RESTART],
+                                  phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_ASSIST],
+                                  phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_FIX],
+                                  phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_TOTAL],
+                                  phaseMs[U_GNSS_BENCHMARK_TEST_PHASE_MODULE_TTFF]);
+                for (size_t w = 0; w < U_GNSS_BENCHMARK_TEST_PHASE_MAX_NUM; w++) {
+                    gTtffMs[y][w][z] = phaseMs[w];
+                }
+            }
+        }
+
+        // Print the results together so that they are easy to find
+        U_TEST_PRINT_LINE(U_GNSS_BENCHMARK_TEST_CSV_PREFIX "start,phase,num,min_ms,"
+                          "median_ms,avg_ms,max_ms");
+        for (size_t y = 0; y < sizeof(gStart) / sizeof(gStart[0]); y++) {
+            for (size_t w = 0; w < U_GNSS_BENCHMARK_TEST_PHASE_MAX_NUM; w++) {
+                printStats(gStart[y].pName, gpPhaseName[w], gTtffMs[y][w],
+                           U_GNSS_BENCHMARK_TEST_TTFF_NUM);
+            }
+        }
+
+        uPortFree(gpDatabase);
+        gpDatabase = NULL;
+    } else {
+        U_TEST_PRINT_LINE("the GNSS chip cannot be reset on this board, not benchmarking"
+                          " time to first fix.");
+    }
+
+    if (transportType != U_GNSS_TRANSPORT_NONE) {
+        // Do the standard postamble
+        uGnssTestPrivatePostamble(&gHandles, true);
+    }
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Clean-up to be run at the end of this round of tests, just
+ * in case there were test failures which would have resulted
+ * in the deinitialisation being skipped.
+ */
+U_PORT_TEST_FUNCTION("[gnssBenchmark]", "gnssBenchmarkCleanUp")
+{
+    uGnssTestPrivateCleanup(&gHandles);
+    uPortFree(gpBuffer);
+    gpBuffer = NULL;
+    uPortFree(gpDatabase);
+    gpDatabase = NULL;
+
+    // Printed for information: asserting happens in the postamble
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+}
+
+#endif // #ifdef U_CFG_TEST_GNSS_MODULE_TYPE
+
+// End of file
@@ -614,6 +614,7 @@ U_PORT_TEST_FUNCTION("[gnssCfg]", "gnssCfgValBasic")
     uint64_t value;
     uint64_t savedValue;
     uGnssCfgVal_t *pCfgValList = NULL;
+    uGnssCfgValBatch_t *pCfgValBatch;
     int32_t numValues;
     size_t iterations;
     uGnssTransportType_t transportTypes[U_GNSS_TRANSPORT_MAX_NUM];
@@ -718,6 +719,32 @@ U_PORT_TEST_FUNCTION("[gnssCfg]", "gnssCfgValBasic")
                     uPortTaskBlock(10);
                 }
 
+                // Modify every value again and write them back, this time
+                // as a batch
+                pCfgValBatch = (uGnssCfgValBatch_t *) pUPortMalloc(sizeof(*pCfgValBatch));
+                U_PORT_TEST_ASSERT(pCfgValBatch != NULL);
+                modValues(pCfgValList, numValues);
+                U_TEST_PRINT_LINE("writing GEOFENCE values as a batch.");
+                U_PORT_TEST_ASSERT(uGnssCfgValBatchStart(pCfgValBatch, gnssHandle,
+                                                         U_GNSS_CFG_VAL_LAYER_RAM) == 0);
+                for (int32_t x = 0; x < numValues; x++) {
+                    U_PORT_TEST_ASSERT(uGnssCfgValBatchAdd(pCfgValBatch,
+                                                           (pCfgValList + x)->keyId,
+                                                           (pCfgValList + x)->value) == 0);
+                }
+                U_PORT_TEST_ASSERT(uGnssCfgValBatchExecute(pCfgValBatch) == 0);
+                uPortFree(pCfgValBatch);
+                U_TEST_PRINT_LINE("reading back the batch-written GEOFENCE values.");
+                for (int32_t x = 0; x < numValues; x++) {
+                    value = 0;
+                    U_PORT_TEST_ASSERT(uGnssCfgValGet(gnssHandle, gKeyIdGeofence[x],
+                                                      &value, storageSizeBytes(gKeyIdGeofence[x]),
+                                                      U_GNSS_CFG_VAL_LAYER_RAM) == 0);
+                    U_PORT_TEST_ASSERT(valueMatches(gKeyIdGeofence[x], value,  pCfgValList, numValues));
+                    // Don't overload logging
+                    uPortTaskBlock(10);
+                }
+
                 // Now modify one value, non-list style, using the helper macro
                 value = 0xFFFFFFFF;
                 U_TEST_PRINT_LINE("modifying one GEOFENCE value 0x%08x to 0x%08x.",
@@ -224,13 +224,272 @@ static const uGnssDecTestDataKnown_t gUbxNavHpposllh[] = {
     }
 };
 
+/** Decoded test data for UBX-NAV-SAT, to be used by gUbxNavSat (item 0).
+ */
+static const uGnssDecUbxNavSat_t gUbxNavSatDecoded0 = {
+    486173000 /* iTOW */, 1 /* version */, 2 /* numSvs */,
+    {
+        {
+            0 /* gnssId */, 5 /* svId */, 42 /* cno */, 63 /* elev */,
+            247 /* azim */, -12 /* prRes */, 0x0000191f /* flags */
+        },
+        {
+            6 /* gnssId */, 76 /* svId */, 33 /* cno */, -5 /* elev */,
+            18 /* azim */, 33 /* prRes */, 0x00001214 /* flags */
+        }
+    }
+};
+
+/** Array of test data for UBX-NAV-SAT.
+ */
+static const uGnssDecTestDataKnown_t gUbxNavSat[] = {
+    {
+        {
+            "\xb5\x62\x01\x35\x20\x00\x48\x69\xfa\x1c\x01\x02\x00\x00\x00\x05"
+            "\x2a\x3f\xf7\x00\xf4\xff\x1f\x19\x00\x00\x06\x4c\x21\xfb\x12\x00"
+            "\x21\x00\x14\x12\x00\x00\x77\xad", 40
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0135, NULL
+        },
+        (void *) &gUbxNavSatDecoded0
+    }
+};
+
+/** Decoded test data for UBX-NAV-SIG, to be used by gUbxNavSig (item 0).
+ */
+static const uGnssDecUbxNavSig_t gUbxNavSigDecoded0 = {
+    486173000 /* iTOW */, 0 /* version */, 2 /* numSigs */,
+    {
+        {
+            0 /* gnssId */, 5 /* svId */, 0 /* sigId */, 0 /* freqId */,
+            -12 /* prRes */, 42 /* cno */, 7 /* qualityInd */,
+            0 /* corrSource */, 2 /* ionoModel */, 0x0029 /* sigFlags */
+        },
+        {
+            6 /* gnssId */, 76 /* svId */, 0 /* sigId */, 11 /* freqId */,
+            33 /* prRes */, 33 /* cno */, 4 /* qualityInd */,
+            0 /* corrSource */, 0 /* ionoModel */, 0x0009 /* sigFlags */
+        }
+    }
+};
+
+/** Array of test data for UBX-NAV-SIG.
+ */
+static const uGnssDecTestDataKnown_t gUbxNavSig[] = {
+    {
+        {
+            "\xb5\x62\x01\x43\x28\x00\x48\x69\xfa\x1c\x00\x02\x00\x00\x00\x05"
+            "\x00\x00\xf4\xff\x2a\x07\x00\x02\x29\x00\x00\x00\x00\x00\x06\x4c"
+            "\x00\x0b\x21\x00\x21\x04\x00\x00\x09\x00\x00\x00\x00\x00\x35\x14", 48
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0143, NULL
+        },
+        (void *) &gUbxNavSigDecoded0
+    }
+};
+
+/** Decoded test data for UBX-NAV-COV, to be used by gUbxNavCov (item 0).
+ */
+static const uGnssDecUbxNavCov_t gUbxNavCovDecoded0 = {
+    486173000 /* iTOW */, 0 /* version */, 1 /* posCovValid */,
+    1 /* velCovValid */, 0.25f /* posCovNN */, -0.125f /* posCovNE */,
+    0.0625f /* posCovND */, 0.5f /* posCovEE */, -0.03125f /* posCovED */,
+    1.5f /* posCovDD */, 0.0078125f /* velCovNN */,
+    0.00390625f /* velCovNE */, -0.001953125f /* velCovND */,
+    0.015625f /* velCovEE */, 0.0f /* velCovED */, 0.03125f /* velCovDD */
+};
+
+/** Array of test data for UBX-NAV-COV.
+ */
+static const uGnssDecTestDataKnown_t gUbxNavCov[] = {
+    {
+        {
+            "\xb5\x62\x01\x36\x40\x00\x48\x69\xfa\x1c\x00\x01\x01\x00\x00\x00"
+            "\x00\x00\x00\x00\x00\x00\x00\x00\x80\x3e\x00\x00\x00\xbe\x00\x00"
+            "\x80\x3d\x00\x00\x00\x3f\x00\x00\x00\xbd\x00\x00\xc0\x3f\x00\x00"
+            "\x00\x3c\x00\x00\x80\x3b\x00\x00\x00\xbb\x00\x00\x80\x3c\x00\x00"
+            "\x00\x00\x00\x00\x00\x3d\x1f\x6d", 72
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0136, NULL
+        },
+        (void *) &gUbxNavCovDecoded0
+    }
+};
+
+/** Decoded test data for UBX-NAV-TIMEGPS, to be used by gUbxNavTimegps (item 0).
+ */
+static const uGnssDecUbxNavTimegps_t gUbxNavTimegpsDecoded0 = {
+    486173000 /* iTOW */, -73790 /* fTOW */, 2279 /* week */,
+    18 /* leapS */, 0x07 /* valid */, 12 /* tAcc */
+};
+
+/** Array of test data for UBX-NAV-TIMEGPS.
+ */
+static const uGnssDecTestDataKnown_t gUbxNavTimegps[] = {
+    {
+        {
+            "\xb5\x62\x01\x20\x10\x00\x48\x69\xfa\x1c\xc2\xdf\xfe\xff\xe7\x08"
+            "\x12\x07\x0c\x00\x00\x00\xaa\x12", 24
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0120, NULL
+        },
+        (void *) &gUbxNavTimegpsDecoded0
+    }
+};
+
+/** Decoded test data for UBX-ESF-INS, to be used by gUbxEsfIns (item 0).
+ */
+static const uGnssDecUbxEsfIns_t gUbxEsfInsDecoded0 = {
+    0x00003f01 /* bitfield0 */, 486173000 /* iTOW */,
+    -1234 /* xAngRate */, 567 /* yAngRate */, 89 /* zAngRate */,
+    -1010 /* xAccel */, 23 /* yAccel */, 981 /* zAccel */
+};
+
+/** Array of test data for UBX-ESF-INS.
+ */
+static const uGnssDecTestDataKnown_t gUbxEsfIns[] = {
+    {
+        {
+            "\xb5\x62\x10\x15\x24\x00\x01\x3f\x00\x00\x00\x00\x00\x00\x48\x69"
+            "\xfa\x1c\x2e\xfb\xff\xff\x37\x02\x00\x00\x59\x00\x00\x00\x0e\xfc"
+            "\xff\xff\x17\x00\x00\x00\xd5\x03\x00\x00\x00\x11", 44
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x1015, NULL
+        },
+        (void *) &gUbxEsfInsDecoded0
+    }
+};
+
+/** Decoded test data for UBX-RXM-RAWX, to be used by gUbxRxmRawx (item 0).
+ */
+static const uGnssDecUbxRxmRawx_t gUbxRxmRawxDecoded0 = {
+    486173.5 /* rcvTow */, 2279 /* week */, 18 /* leapS */,
+    2 /* numMeas */, 0x01 /* recStat */, 1 /* version */,
+    {
+        {
+            21234567.25 /* prMes */, 111588812.5 /* cpMes */,
+            -1234.5f /* doMes */, 0 /* gnssId */, 5 /* svId */,
+            0 /* sigId */, 0 /* freqId */, 64500 /* locktime */,
+            42 /* cno */, 5 /* prStdev */, 2 /* cpStdev */,
+            4 /* doStdev */, 0x0f /* trkStat */
+        },
+        {
+            19876543.75 /* prMes */, 104452567.125 /* cpMes */,
+            567.25f /* doMes */, 6 /* gnssId */, 76 /* svId */,
+            0 /* sigId */, 11 /* freqId */, 3200 /* locktime */,
+            33 /* cno */, 7 /* prStdev */, 15 /* cpStdev */,
+            6 /* doStdev */, 0x01 /* trkStat */
+        }
+    }
+};
+
+/** Array of test data for UBX-RXM-RAWX.
+ */
+static const uGnssDecTestDataKnown_t gUbxRxmRawx[] = {
+    {
+        {
+            "\xb5\x62\x02\x15\x50\x00\x00\x00\x00\x00\x76\xac\x1d\x41\xe7\x08"
+            "\x12\x02\x01\x01\x00\x00\x00\x00\x00\x74\x38\x40\x74\x41\x00\x00"
+            "\x00\x32\xd7\x9a\x9a\x41\x00\x50\x9a\xc4\x00\x05\x00\x00\xf4\xfb"
+            "\x2a\x05\x02\x04\x0f\x00\x00\x00\x00\xfc\xab\xf4\x72\x41\x00\x00"
+            "\x80\x5c\x47\xe7\x98\x41\x00\xd0\x0d\x44\x06\x4c\x00\x0b\x80\x0c"
+            "\x21\x07\x0f\x06\x01\x00\x6a\xe1", 88
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0215, NULL
+        },
+        (void *) &gUbxRxmRawxDecoded0
+    }
+};
+
+/** Decoded test data for UBX-MON-RF, to be used by gUbxMonRf (item 0).
+ */
+static const uGnssDecUbxMonRf_t gUbxMonRfDecoded0 = {
+    0 /* version */, 2 /* nBlocks */,
+    {
+        {
+            0 /* blockId */, 0x01 /* flags */, 2 /* antStatus */,
+            1 /* antPower */, 0x00000000 /* postStatus */,
+            83 /* noisePerMS */, 5731 /* agcCnt */, 12 /* jamInd */,
+            -3 /* ofsI */, 128 /* magI */, 4 /* ofsQ */, 130 /* magQ */
+        },
+        {
+            1 /* blockId */, 0x02 /* flags */, 2 /* antStatus */,
+            1 /* antPower */, 0x00000001 /* postStatus */,
+            45 /* noisePerMS */, 4099 /* agcCnt */, 200 /* jamInd */,
+            1 /* ofsI */, 127 /* magI */, -2 /* ofsQ */, 125 /* magQ */
+        }
+    }
+};
+
+/** Array of test data for UBX-MON-RF.
+ */
+static const uGnssDecTestDataKnown_t gUbxMonRf[] = {
+    {
+        {
+            "\xb5\x62\x0a\x38\x34\x00\x00\x02\x00\x00\x00\x01\x02\x01\x00\x00"
+            "\x00\x00\x00\x00\x00\x00\x53\x00\x63\x16\x0c\xfd\x80\x04\x82\x00"
+            "\x00\x00\x01\x02\x02\x01\x01\x00\x00\x00\x00\x00\x00\x00\x2d\x00"
+            "\x03\x10\xc8\x01\x7f\xfe\x7d\x00\x00\x00\x61\x55", 60
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0a38, NULL
+        },
+        (void *) &gUbxMonRfDecoded0
+    }
+};
+
+/** Decoded test data for UBX-TIM-TP, to be used by gUbxTimTp (item 0).
+ */
+static const uGnssDecUbxTimTp_t gUbxTimTpDecoded0 = {
+    486174000 /* towMS */, 2147483648U /* towSubMS */, -1500 /* qErr */,
+    2279 /* week */, 0x0b /* flags */, 0x00 /* refInfo */
+};
+
+/** Array of test data for UBX-TIM-TP.
+ */
+static const uGnssDecTestDataKnown_t gUbxTimTp[] = {
+    {
+        {
+            "\xb5\x62\x0d\x01\x10\x00\x30\x6d\xfa\x1c\x00\x00\x00\x80\x24\xfa"
+            "\xff\xff\xe7\x08\x0b\x00\x67\xe7", 24
+        },
+        {
+            U_GNSS_PROTOCOL_UBX, 0x0d01, NULL
+        },
+        (void *) &gUbxTimTpDecoded0
+    }
+};
+
 /** Array of arrays of test vectors for all known message types.
  */
 static const uGnssDecTestDataKnownSet_t gTestDataKnownSet[] = {
     {gUbxNavPvt, sizeof(gUbxNavPvt) / sizeof(gUbxNavPvt[0]), sizeof(gUbxNavPvtDecoded0)},
-    {gUbxNavHpposllh, sizeof(gUbxNavHpposllh) / sizeof(gUbxNavHpposllh[0]), sizeof(gUbxNavHpposllhDecoded0)}
+    {gUbxNavHpposllh, sizeof(gUbxNavHpposllh) / sizeof(gUbxNavHpposllh[0]), sizeof(gUbxNavHpposllhDecoded0)},
+    {gUbxNavSat, sizeof(gUbxNavSat) / sizeof(gUbxNavSat[0]), sizeof(gUbxNavSatDecoded0)},
+    {gUbxNavSig, sizeof(gUbxNavSig) / sizeof(gUbxNavSig[0]), sizeof(gUbxNavSigDecoded0)},
+    {gUbxNavCov, sizeof(gUbxNavCov) / sizeof(gUbxNavCov[0]), sizeof(gUbxNavCovDecoded0)},
+    {gUbxNavTimegps, sizeof(gUbxNavTimegps) / sizeof(gUbxNavTimegps[0]), sizeof(gUbxNavTimegpsDecoded0)},
+    {gUbxEsfIns, sizeof(gUbxEsfIns) / sizeof(gUbxEsfIns[0]), sizeof(gUbxEsfInsDecoded0)},
+    {gUbxRxmRawx, sizeof(gUbxRxmRawx) / sizeof(gUbxRxmRawx[0]), sizeof(gUbxRxmRawxDecoded0)},
+    {gUbxMonRf, sizeof(gUbxMonRf) / sizeof(gUbxMonRf[0]), sizeof(gUbxMonRfDecoded0)},
+    {gUbxTimTp, sizeof(gUbxTimTp) / sizeof(gUbxTimTp[0]), sizeof(gUbxTimTpDecoded0)}
 };
 
+/** Storage for uGnssDecDecode() to decode into.
+ */
+static uGnssDec_t gDec;
+
+/** Storage for uGnssDecDecode() to decode the message body into;
+ * static since it is a bit large for the stack.
+ */
+static uGnssDecUnion_t gDecBody;
+
 /** Flag to share with the user callback.
  */
 static int32_t gCallback;
@@ -697,9 +956,25 @@ U_PORT_TEST_FUNCTION("[gnssDec]", "gnssDecKnown")
             }
             // Free the structure once more
             uGnssDecFree(pDec);
+
+            // Do the same again but decoding into our own storage
+            memset(&gDecBody, 0xFF, sizeof(gDecBody));
+            U_PORT_TEST_ASSERT(uGnssDecDecode(pTestData->raw.p,
+                                              pTestData->raw.length - gCrcLength[pTestData->id.type],
+                                              &gDec, &gDecBody) == 0);
+            U_PORT_TEST_ASSERT(gDec.errorCode == 0);
+            U_PORT_TEST_ASSERT(gDec.id.type == pTestData->id.type);
+            U_PORT_TEST_ASSERT(gDec.pBody == &gDecBody);
+            U_PORT_TEST_ASSERT(memcmp(&gDecBody, pTestData->pDecoded, decodedStructureSize) == 0);
         }
     }
 
+    // Parameter checking of uGnssDecDecode()
+    U_PORT_TEST_ASSERT(uGnssDecDecode(gUbxNavPvt[0].raw.p, gUbxNavPvt[0].raw.length,
+                                      NULL, &gDecBody) < 0);
+    U_PORT_TEST_ASSERT(uGnssDecDecode(gUbxNavPvt[0].raw.p, gUbxNavPvt[0].raw.length,
+                                      &gDec, NULL) < 0);
+
     // Check for resource leaks
     uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
     resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
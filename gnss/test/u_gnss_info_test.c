@@ -97,6 +97,13 @@
 #define U_GNSS_TIME_TEST_TIMEOUT_SECONDS 180
 #endif
 
+#ifndef U_GNSS_INFO_TEST_THROUGHPUT_ITERATIONS
+/** The number of firmware version string reads to time when
+ * comparing the throughput of the different transports.
+ */
+# define U_GNSS_INFO_TEST_THROUGHPUT_ITERATIONS 10
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -316,6 +323,104 @@ U_PORT_TEST_FUNCTION("[gnssInfo]", "gnssInfoTime")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Compare the throughput of the transports to GNSS; in particular,
+ * where GNSS is inside or connected via a cellular module, this shows
+ * the difference between tunnelling UBX messages through AT+UGUBX
+ * (#U_GNSS_TRANSPORT_AT) and using the CMUX GNSS channel
+ * (#U_GNSS_TRANSPORT_VIRTUAL_SERIAL), the latter being what the
+ * network API selects by default.
+ */
+U_PORT_TEST_FUNCTION("[gnssInfo]", "gnssInfoThroughput")
+{
+    uDeviceHandle_t gnssHandle;
+    int32_t resourceCount;
+    char *pBuffer;
+    int32_t y;
+    int32_t bytes;
+    int32_t startTimeMs;
+    int32_t durationMs;
+    int32_t durationAtMs = -1;
+    int32_t durationVirtualSerialMs = -1;
+    size_t iterations;
+    uGnssTransportType_t transportTypes[U_GNSS_TRANSPORT_MAX_NUM];
+
+    // In case a previous test failed
+    uGnssTestPrivateCleanup(&gHandles);
+
+    // Get the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    pBuffer = (char *) pUPortMalloc(U_GNSS_INFO_TEST_VERSION_SIZE_MAX_BYTES);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+
+    // Repeat for all transport types
+    iterations = uGnssTestPrivateTransportTypesSet(transportTypes, U_CFG_APP_GNSS_UART,
+                                                   U_CFG_APP_GNSS_I2C, U_CFG_APP_GNSS_SPI);
+    for (size_t w = 0; w < iterations; w++) {
+        // Do the standard preamble
+        U_TEST_PRINT_LINE("testing on transport %s...",
+                          pGnssTestPrivateTransportTypeName(transportTypes[w]));
+        U_PORT_TEST_ASSERT(uGnssTestPrivatePreamble(U_CFG_TEST_GNSS_MODULE_TYPE,
+                                                    transportTypes[w], &gHandles, true,
+                                                    U_CFG_APP_CELL_PIN_GNSS_POWER,
+                                                    U_CFG_APP_CELL_PIN_GNSS_DATA_READY) == 0);
+        gnssHandle = gHandles.gnssHandle;
+
+        // No printing, that would skew the timing
+        uGnssSetUbxMessagePrint(gnssHandle, false);
+
+        bytes = 0;
+        startTimeMs = uPortGetTickTimeMs();
+        for (size_t x = 0; x < U_GNSS_INFO_TEST_THROUGHPUT_ITERATIONS; x++) {
+            y = uGnssInfoGetFirmwareVersionStr(gnssHandle, pBuffer,
+                                               U_GNSS_INFO_TEST_VERSION_SIZE_MAX_BYTES);
+            U_PORT_TEST_ASSERT(y > 0);
+            bytes += y;
+        }
+        durationMs = uPortGetTickTimeMs() - startTimeMs;
+        if (durationMs <= 0) {
+            durationMs = 1;
+        }
+        U_TEST_PRINT_LINE("%d firmware version read(s) on transport %s took %d ms,"
+                          " %d ms each, %d byte(s)/second.",
+                          U_GNSS_INFO_TEST_THROUGHPUT_ITERATIONS,
+                          pGnssTestPrivateTransportTypeName(transportTypes[w]),
+                          durationMs, durationMs / U_GNSS_INFO_TEST_THROUGHPUT_ITERATIONS,
+                          (int32_t) ((((int64_t) bytes) * 1000) / durationMs));
+        if (transportTypes[w] == U_GNSS_TRANSPORT_AT) {
+            durationAtMs = durationMs;
+        } else if (transportTypes[w] == U_GNSS_TRANSPORT_VIRTUAL_SERIAL) {
+            durationVirtualSerialMs = durationMs;
+        }
+
+        // Check that we haven't dropped any incoming data
+        y = uGnssMsgReceiveStatStreamLoss(gnssHandle);
+        U_TEST_PRINT_LINE("%d byte(s) lost at the input to the ring-buffer during that test.", y);
+        U_PORT_TEST_ASSERT(y == 0);
+
+        // Do the standard postamble, leaving the module on for the next
+        // test to speed things up
+        uGnssTestPrivatePostamble(&gHandles, false);
+    }
+
+    if ((durationAtMs > 0) && (durationVirtualSerialMs > 0)) {
+        U_TEST_PRINT_LINE("CMUX took %d%% of the time taken by AT+UGUBX.",
+                          (durationVirtualSerialMs * 100) / durationAtMs);
+        if (durationVirtualSerialMs > durationAtMs) {
+            U_TEST_PRINT_LINE("*** WARNING *** CMUX was slower than AT+UGUBX.");
+        }
+    }
+
+    // Free memory
+    uPortFree(pBuffer);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 #endif // #ifdef U_CFG_TEST_GNSS_MODULE_TYPE
 
 // End of file
@@ -154,6 +154,13 @@
 # define U_GNSS_MGA_TEST_DATABASE_LENGTH_BYTES (10 * 1024)
 #endif
 
+#ifndef U_GNSS_MGA_TEST_DATABASE_MAX_NUM_BLOCKS
+/** The number of database block hashes to keep when testing
+ * uGnssMgaGetDatabaseDelta().
+ */
+# define U_GNSS_MGA_TEST_DATABASE_MAX_NUM_BLOCKS 256
+#endif
+
 #ifndef U_GNSS_MGA_TEST_MY_LOCATION
 /** Location to filter AssistNow Online requests: set this to your
  * test system's location. */
@@ -216,10 +223,23 @@ static const uGnssMgaPos_t gMgaPosFilter = U_GNSS_MGA_TEST_MY_LOCATION;
  */
 static size_t gDatabaseCalledCount = 0;
 
+/** The block hashes for uGnssMgaGetDatabaseDelta().
+ */
+static uint32_t gDatabaseHashList[U_GNSS_MGA_TEST_DATABASE_MAX_NUM_BLOCKS];
+
+/** The number of blocks in the database, as reported by the
+ * last call of databaseDeltaCallback(); -1 if not yet reported.
+ */
+static int32_t gDatabaseNumBlocks = -1;
+
+/** The length of the database at gpDatabase, for databaseReadCallback().
+ */
+static size_t gDatabaseLength = 0;
+
 /** The names of the flow control types; must have the same number of
  * members as gFlowControlList and match the order.
  */
-static const char *gpFlowControlNameList[] = {"no", "ack/nack", "smart"};
+static const char *gpFlowControlNameList[] = {"no", "ack/nack", "smart", "window"};
 
 /** The types of flow control to use with the GNSS chip while downloading;
  * must have the same number of members as gpFlowControlNameList and match
@@ -227,7 +247,8 @@ static const char *gpFlowControlNameList[] = {"no", "ack/nack", "smart"};
 */
 static const uGnssMgaFlowControl_t gFlowControlList[] = {U_GNSS_MGA_FLOW_CONTROL_WAIT,
                                                          U_GNSS_MGA_FLOW_CONTROL_SIMPLE,
-                                                         U_GNSS_MGA_FLOW_CONTROL_SMART
+                                                         U_GNSS_MGA_FLOW_CONTROL_SMART,
+                                                         U_GNSS_MGA_FLOW_CONTROL_WINDOW
                                                         };
 # endif
 
@@ -512,6 +533,54 @@ static bool databaseCallback(uDeviceHandle_t devHandle,
     return keepGoing;
 }
 
+// Callback for delta database reads: just counts the changed blocks.
+static bool databaseDeltaCallback(uDeviceHandle_t devHandle, size_t index,
+                                  const char *pBuffer, size_t size,
+                                  void *pDatabaseCallbackParam)
+{
+    int32_t *pCount = (int32_t *) pDatabaseCallbackParam;
+
+    (void) devHandle;
+
+    if (pBuffer != NULL) {
+        if ((size > U_GNSS_MGA_DBD_MESSAGE_PAYLOAD_LENGTH_MAX_BYTES + 2) || // +2 for the length bytes
+            (*pCount < 0)) {
+            *pCount = -1;
+        } else {
+            (*pCount)++;
+        }
+    } else {
+        gDatabaseNumBlocks = (int32_t) index;
+    }
+
+    return true;
+}
+
+// Callback for streamed database writes: takes blocks from
+// gpDatabase, pDatabaseCallbackParam pointing to the read offset.
+static int32_t databaseReadCallback(uDeviceHandle_t devHandle, size_t index,
+                                    char *pBuffer, size_t size,
+                                    void *pDatabaseCallbackParam)
+{
+    int32_t length = 0;
+    size_t *pOffset = (size_t *) pDatabaseCallbackParam;
+
+    (void) devHandle;
+    (void) index;
+
+    if (gDatabaseLength - *pOffset > 2) {
+        length = (uint8_t) gpDatabase[*pOffset] + (((uint8_t) gpDatabase[*pOffset + 1]) << 8) + 2;
+        if ((length > (int32_t) size) || (length > (int32_t) (gDatabaseLength - *pOffset))) {
+            length = (int32_t) U_ERROR_COMMON_BAD_DATA;
+        } else {
+            memcpy(pBuffer, gpDatabase + *pOffset, length);
+            *pOffset += length;
+        }
+    }
+
+    return length;
+}
+
 # endif // ifndef U_GNSS_MGA_TEST_DISABLE_DATABASE
 
 /* ----------------------------------------------------------------
@@ -544,6 +613,7 @@ U_PORT_TEST_FUNCTION("[gnssMga]", "gnssMgaBasic")
     char buffer[4 + U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES];
     uGnssCommunicationStats_t communicationStats;
     const char *pProtocolName;
+    size_t streamOffset;
 
     // In case a previous test failed
     uGnssTestPrivateCleanup(&gHandles);
@@ -680,8 +750,13 @@ U_PORT_TEST_FUNCTION("[gnssMga]", "gnssMgaBasic")
                     U_TEST_PRINT_LINE_X("writing database to GNSS device using %s flow control.",
                                         x + 1, gpFlowControlNameList[x]);
                     callbackParameter = 0;
+                    startTimeMs = uPortGetTickTimeMs();
                     y = uGnssMgaSetDatabase(gnssDevHandle, gFlowControlList[x],
                                             gpDatabase, z, progressCallback, &callbackParameter);
+                    // Print the time taken so that the flow control types can be compared
+                    U_TEST_PRINT_LINE_X("writing %d byte(s) with %s flow control took %d ms.",
+                                        x + 1, z, gpFlowControlNameList[x],
+                                        uPortGetTickTimeMs() - startTimeMs);
                     if (callbackParameter >= 0) {
                         U_TEST_PRINT_LINE_X("progress callback was called %d time(s).",
                                             x + 1, callbackParameter);
@@ -744,6 +819,44 @@ U_PORT_TEST_FUNCTION("[gnssMga]", "gnssMgaBasic")
                     }
                     U_PORT_TEST_ASSERT(callbackParameter >= 0);
                 }
+
+                // Read the database as a delta: the first time everything
+                // should be returned, the second time only what has changed
+                memset(gDatabaseHashList, 0, sizeof(gDatabaseHashList));
+                for (size_t x = 0; x < 2; x++) {
+                    callbackParameter = 0;
+                    gDatabaseNumBlocks = -1;
+                    y = uGnssMgaGetDatabaseDelta(gnssDevHandle, gDatabaseHashList,
+                                                 sizeof(gDatabaseHashList) / sizeof(gDatabaseHashList[0]),
+                                                 databaseDeltaCallback, &callbackParameter);
+                    U_TEST_PRINT_LINE("uGnssMgaGetDatabaseDelta() returned %d, %d block(s) in total.",
+                                      y, gDatabaseNumBlocks);
+                    U_PORT_TEST_ASSERT(y >= 0);
+                    U_PORT_TEST_ASSERT(y == callbackParameter);
+                    U_PORT_TEST_ASSERT(y <= gDatabaseNumBlocks);
+                    if ((x == 0) && (gDatabaseNumBlocks <= (int32_t) (sizeof(gDatabaseHashList) /
+                                                                      sizeof(gDatabaseHashList[0])))) {
+                        U_PORT_TEST_ASSERT(y == gDatabaseNumBlocks);
+                    }
+                }
+
+                // Write the database back again using the streamed API
+                gDatabaseLength = z;
+                streamOffset = 0;
+                callbackParameter = 0;
+                startTimeMs = uPortGetTickTimeMs();
+                y = uGnssMgaSetDatabaseStream(gnssDevHandle, databaseReadCallback, &streamOffset,
+                                              progressCallback, &callbackParameter);
+                U_TEST_PRINT_LINE("uGnssMgaSetDatabaseStream() returned %d, writing %d byte(s)"
+                                  " took %d ms.", y, streamOffset, uPortGetTickTimeMs() - startTimeMs);
+                if ((y == (int32_t) U_GNSS_ERROR_NACK) && gDatabaseHasQzss) {
+                    U_TEST_PRINT_LINE("*** WARNING *** NACK, probably for the QZSS MGA DBD record,"
+                                      " letting that by.");
+                } else {
+                    U_PORT_TEST_ASSERT(y == 0);
+                    U_PORT_TEST_ASSERT(streamOffset == (size_t) z);
+                    U_PORT_TEST_ASSERT(callbackParameter >= 0);
+                }
             } else {
                 U_TEST_PRINT_LINE("*** WARNING *** not testing writing database as there is nothing to write.");
             }
@@ -63,6 +63,8 @@
 
 #include "u_ubx_protocol.h"
 
+#include "u_spartn_crc.h" // For uSpartnCrc24(), which is also CRC-24Q
+
 #include "u_gnss_module_type.h"
 #include "u_gnss_type.h"
 #include "u_gnss.h"
@@ -135,6 +137,30 @@
 # define U_GNSS_MSG_TEST_MESSAGE_RECEIVE_NON_BLOCKING_POLL_DELAY_SECONDS 3
 #endif
 
+#ifndef U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES
+/** The number of RTCM3 messages to inject in the injection test.
+ */
+# define U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES 20
+#endif
+
+#ifndef U_GNSS_MSG_TEST_INJECT_RATE_BYTES_PER_SECOND
+/** The rate limit to apply in the injection test.
+ */
+# define U_GNSS_MSG_TEST_INJECT_RATE_BYTES_PER_SECOND 200
+#endif
+
+#ifndef U_GNSS_MSG_TEST_INJECT_TIMEOUT_SECONDS
+/** How long to wait for all of the injected messages to be sent.
+ */
+# define U_GNSS_MSG_TEST_INJECT_TIMEOUT_SECONDS 10
+#endif
+
+/** The length of the RTCM3 1005 (stationary antenna reference
+ * point) message used in the injection test: three bytes of
+ * header, 19 bytes of message and three bytes of CRC.
+ */
+#define U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES (3 + 19 + 3)
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -155,6 +181,7 @@ typedef struct {
     size_t numWhenStopped;
     size_t numNotWanted;
     bool useNmeaComprehender;
+    bool usePeekSpan;
     void *pNmeaComprehenderContext;
     bool nmeaSequenceHasBegun;
     size_t numNmeaSequence;
@@ -254,6 +281,48 @@ static void checkMessageReceive(uGnssMessageId_t *pMessageId,
 // NRF52, which we use NRF5SDK on, doesn't have enough heap for this test
 #ifndef U_CFG_TEST_USING_NRF5SDK
 
+// Read a message using uGnssMsgReceiveCallbackPeekSpan(), which
+// should result in the same thing as uGnssMsgReceiveCallbackRead().
+static int32_t readWithPeekSpan(uDeviceHandle_t gnssHandle, char *pBuffer,
+                                size_t size)
+{
+    const char *pSpan = NULL;
+    size_t offset = 0;
+    int32_t length = 1;
+
+    while ((length > 0) && (offset < size)) {
+        length = uGnssMsgReceiveCallbackPeekSpan(gnssHandle, &pSpan, offset);
+        if (length > 0) {
+            if (length > (int32_t) (size - offset)) {
+                length = (int32_t) (size - offset);
+            }
+            memcpy(pBuffer + offset, pSpan, length);
+            offset += length;
+        }
+    }
+
+    return (int32_t) offset;
+}
+
+// Write an all-zeroes RTCM3 1005 message, with a valid CRC, to
+// pBuffer, which must be U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES
+// long.
+static void encodeRtcm1005(char *pBuffer)
+{
+    uint32_t crc;
+
+    memset(pBuffer, 0, U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES);
+    *pBuffer = (char) 0xD3;
+    *(pBuffer + 2) = U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES - 6;
+    // The 12-bit message number comes first
+    *(pBuffer + 3) = (char) (1005 >> 4);
+    *(pBuffer + 4) = (char) ((1005 & 0x0f) << 4);
+    crc = uSpartnCrc24(pBuffer, U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES - 3);
+    *(pBuffer + U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES - 3) = (char) (crc >> 16);
+    *(pBuffer + U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES - 2) = (char) (crc >> 8);
+    *(pBuffer + U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES - 1) = (char) crc;
+}
+
 // Callback for the non-blocking message receives.
 static void messageReceiveCallback(uDeviceHandle_t gnssHandle,
                                    const uGnssMessageId_t *pMessageId,
@@ -262,10 +331,21 @@ static void messageReceiveCallback(uDeviceHandle_t gnssHandle,
 {
     uGnssMsgTestReceive_t *pMsgReceive = (uGnssMsgTestReceive_t *) pCallbackParam;
     int32_t nmeaComprehenderErrorCode;
+    int32_t readLength = 0;
+    int32_t arrivalTimeMs;
+    int32_t arrivalErrorCode;
 
     if (gnssHandle != gHandles.gnssHandle) {
         gCallbackErrorCode = 1;
     }
+    // The arrival time, if still known, must not be in the future
+    arrivalErrorCode = uGnssMsgReceiveCallbackGetArrivalTime(gnssHandle, &arrivalTimeMs);
+    if ((arrivalErrorCode != 0) && (arrivalErrorCode != (int32_t) U_ERROR_COMMON_NOT_FOUND)) {
+        gCallbackErrorCode = 6;
+    }
+    if ((arrivalErrorCode == 0) && (arrivalTimeMs - uPortGetTickTimeMs() > 0)) {
+        gCallbackErrorCode = 7;
+    }
     if (pMessageId == NULL) {
         gCallbackErrorCode = 2;
     }
@@ -286,9 +366,15 @@ static void messageReceiveCallback(uDeviceHandle_t gnssHandle,
         }
         if ((errorCodeOrLength > 0) &&
             (errorCodeOrLength <= U_GNSS_MSG_TEST_MESSAGE_RECEIVE_NON_BLOCKING_BUFFER_SIZE_BYTES)) {
-            if (uGnssMsgReceiveCallbackRead(gnssHandle,
-                                            pMsgReceive->pBuffer,
-                                            errorCodeOrLength) == errorCodeOrLength) {
+            if (pMsgReceive->usePeekSpan) {
+                readLength = readWithPeekSpan(gnssHandle, pMsgReceive->pBuffer,
+                                              errorCodeOrLength);
+            } else {
+                readLength = uGnssMsgReceiveCallbackRead(gnssHandle,
+                                                         pMsgReceive->pBuffer,
+                                                         errorCodeOrLength);
+            }
+            if (readLength == errorCodeOrLength) {
                 pMsgReceive->numRead++;
                 pMsgReceive->numDecoded++;
                 // NOTE: uGnssTestPrivateNmeaComprehender() doesn't support
@@ -484,6 +570,7 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
     int32_t b;
     int32_t c;
     int32_t d;
+    int32_t e;
     bool bad = false;
     // Enough room to poll UBX-RXM-MEASX
     char command[U_UBX_PROTOCOL_OVERHEAD_LENGTH_BYTES];
@@ -560,6 +647,11 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
                     } else  {
                         // Just NMEA this time
                         pTmp->useNmeaComprehender = true;
+                        // Have a couple of them, including the queued one,
+                        // get at the messages without copying
+                        if (x < 3) {
+                            pTmp->usePeekSpan = (x % 2) == 0;
+                        }
                     }
                 }
 
@@ -567,10 +659,18 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
                 gCallbackErrorCode = 0;
                 for (size_t x = 0; x < sizeof(gpMessageReceive) / sizeof(gpMessageReceive[0]); x++) {
                     pTmp = gpMessageReceive[x];
-                    pTmp->asyncHandle = uGnssMsgReceiveStart(gnssHandle,
-                                                             &(pTmp->messageId),
-                                                             messageReceiveCallback,
-                                                             (void *) pTmp);
+                    if ((z == 1) && (x == 0)) {
+                        // Give the first NMEA receiver a queue and task of its own
+                        pTmp->asyncHandle = uGnssMsgReceiveStartQueued(gnssHandle,
+                                                                       &(pTmp->messageId),
+                                                                       messageReceiveCallback,
+                                                                       (void *) pTmp, 0);
+                    } else {
+                        pTmp->asyncHandle = uGnssMsgReceiveStart(gnssHandle,
+                                                                 &(pTmp->messageId),
+                                                                 messageReceiveCallback,
+                                                                 (void *) pTmp);
+                    }
                     pTmp->moduleType = pModule->moduleType;
                     U_PORT_TEST_ASSERT(pTmp->asyncHandle >= 0);
                 }
@@ -608,6 +708,10 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
                 // stop everything; not asserting here so that we can see what
                 // the outcome of all the above was first
                 a = uGnssMsgReceiveStackMinFree(gnssHandle);
+                e = 0;
+                if (z == 1) {
+                    e = uGnssMsgReceiveStatQueueLoss(gnssHandle, gpMessageReceive[0]->asyncHandle);
+                }
                 uPortTaskBlock(100);
                 b = uGnssMsgReceiveStopAll(gnssHandle);
                 uPortTaskBlock(100);
@@ -697,6 +801,7 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
                 }
                 U_TEST_PRINT_LINE("%d byte(s) lost at the input to the ring-buffer during that test.", c);
                 U_TEST_PRINT_LINE("%d byte(s) lost by the asynchronous read task during that test.", d);
+                U_TEST_PRINT_LINE("%d message(s) lost by the queued receiver during that test.", e);
                 if (a != U_ERROR_COMMON_NOT_SUPPORTED) {
                     U_TEST_PRINT_LINE("the minimum stack of the callback task  was %d.", a);
                 }
@@ -709,6 +814,7 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
                 U_PORT_TEST_ASSERT(b == 0);
                 U_PORT_TEST_ASSERT(c == 0);
                 U_PORT_TEST_ASSERT(d == 0);
+                U_PORT_TEST_ASSERT(e == 0);
                 U_PORT_TEST_ASSERT(gCallbackErrorCode == 0);
 
                 // Switch message printing on for this bit
@@ -777,6 +883,107 @@ U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgReceiveNonBlocking")
 
 #endif // U_CFG_TEST_USING_NRF5SDK 
 
+/** Inject RTCM3 messages, mixed with rubbish, into the GNSS chip.
+ */
+U_PORT_TEST_FUNCTION("[gnssMsg]", "gnssMsgInject")
+{
+    uDeviceHandle_t gnssHandle;
+    int32_t resourceCount;
+    // The rubbish contains no 0xD3 or 0x73, so it can't start a message
+    const char rubbish[] = "junk";
+    char *pBuffer;
+    size_t bufferLength;
+    size_t offset;
+    size_t sent = 0;
+    size_t discarded = 0;
+    int32_t startTimeMs;
+    int32_t x;
+    size_t iterations;
+    uGnssTransportType_t transportTypes[U_GNSS_TRANSPORT_MAX_NUM];
+
+    // In case a previous test failed
+    uGnssTestPrivateCleanup(&gHandles);
+
+    // Get the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Make up the stream of data, each RTCM3 message preceded by rubbish
+    bufferLength = (sizeof(rubbish) - 1 + U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES) *
+                   U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES;
+    pBuffer = (char *) pUPortMalloc(bufferLength);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+    offset = 0;
+    for (size_t y = 0; y < U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES; y++) {
+        memcpy(pBuffer + offset, rubbish, sizeof(rubbish) - 1);
+        offset += sizeof(rubbish) - 1;
+        encodeRtcm1005(pBuffer + offset);
+        offset += U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES;
+    }
+
+    // Repeat for all transport types except U_GNSS_TRANSPORT_AT
+    iterations = uGnssTestPrivateTransportTypesSet(transportTypes, U_CFG_APP_GNSS_UART,
+                                                   U_CFG_APP_GNSS_I2C, U_CFG_APP_GNSS_SPI);
+    for (size_t w = 0; w < iterations; w++) {
+        // Do the standard preamble
+        U_TEST_PRINT_LINE("testing on transport %s...",
+                          pGnssTestPrivateTransportTypeName(transportTypes[w]));
+        U_PORT_TEST_ASSERT(uGnssTestPrivatePreamble(U_CFG_TEST_GNSS_MODULE_TYPE,
+                                                    transportTypes[w], &gHandles, true,
+                                                    U_CFG_APP_CELL_PIN_GNSS_POWER,
+                                                    U_CFG_APP_CELL_PIN_GNSS_DATA_READY) == 0);
+        gnssHandle = gHandles.gnssHandle;
+
+        // Nothing should be injected before starting
+        U_PORT_TEST_ASSERT(uGnssMsgInject(gnssHandle, pBuffer, bufferLength) < 0);
+        U_PORT_TEST_ASSERT(uGnssMsgInjectStat(gnssHandle, NULL, NULL) < 0);
+
+        U_TEST_PRINT_LINE("injecting %d RTCM3 message(s), %d byte(s) in all, at up to"
+                          " %d byte(s)/second.", U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES,
+                          bufferLength, U_GNSS_MSG_TEST_INJECT_RATE_BYTES_PER_SECOND);
+        U_PORT_TEST_ASSERT(uGnssMsgInjectStart(gnssHandle, 0,
+                                               U_GNSS_MSG_TEST_INJECT_RATE_BYTES_PER_SECOND) == 0);
+        startTimeMs = uPortGetTickTimeMs();
+        // Pass the data in, in chunks which don't line up with the
+        // messages, none of which should be refused
+        offset = 0;
+        while (offset < bufferLength) {
+            x = (int32_t) (bufferLength - offset);
+            if (x > 7) {
+                x = 7;
+            }
+            U_PORT_TEST_ASSERT(uGnssMsgInject(gnssHandle, pBuffer + offset, x) == x);
+            offset += x;
+        }
+        // Wait for it all to be sent
+        while ((sent < U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES * U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES) &&
+               (uPortGetTickTimeMs() - startTimeMs < U_GNSS_MSG_TEST_INJECT_TIMEOUT_SECONDS * 1000)) {
+            U_PORT_TEST_ASSERT(uGnssMsgInjectStat(gnssHandle, &sent, &discarded) == 0);
+            uPortTaskBlock(100);
+        }
+        U_TEST_PRINT_LINE("%d byte(s) sent, %d byte(s) discarded, took %d ms.", sent,
+                          discarded, uPortGetTickTimeMs() - startTimeMs);
+        U_PORT_TEST_ASSERT(sent == U_GNSS_MSG_TEST_INJECT_RTCM_LENGTH_BYTES *
+                           U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES);
+        U_PORT_TEST_ASSERT(discarded == (sizeof(rubbish) - 1) * U_GNSS_MSG_TEST_INJECT_NUM_MESSAGES);
+
+        U_PORT_TEST_ASSERT(uGnssMsgInjectStop(gnssHandle) == 0);
+        U_PORT_TEST_ASSERT(uGnssMsgInjectStat(gnssHandle, NULL, NULL) < 0);
+        sent = 0;
+        discarded = 0;
+
+        // Do the standard postamble
+        uGnssTestPrivatePostamble(&gHandles, true);
+    }
+
+    uPortFree(pBuffer);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
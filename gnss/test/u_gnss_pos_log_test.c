@@ -0,0 +1,248 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Tests for the GNSS position log API: they do not require a
+ * GNSS module to run, hence these should pass on all platforms.
+ * IMPORTANT: see notes in u_cfg_test_platform_specific.h for the
+ * naming rules that must be followed when using the U_PORT_TEST_FUNCTION()
+ * macro.
+ */
+
+# ifdef U_CFG_OVERRIDE
+#  include "u_cfg_override.h" // For a customer's configuration override
+# endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memset()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_port_debug.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_ringbuffer.h"
+
+#include "u_gnss_pos_log.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_GNSS_POS_LOG_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+#ifndef U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES
+/** The size of the buffer to put the position log in.
+ */
+# define U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES 512
+#endif
+
+#ifndef U_GNSS_POS_LOG_TEST_NUM_FIXES
+/** The number of fixes to add to the log, enough to
+ * overflow it several times.
+ */
+# define U_GNSS_POS_LOG_TEST_NUM_FIXES 500
+#endif
+
+#ifndef U_GNSS_POS_LOG_TEST_EXPORT_SIZE_BYTES
+/** The size of the chunks to export in when removing from the log.
+ */
+# define U_GNSS_POS_LOG_TEST_EXPORT_SIZE_BYTES 50
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Make up the fix with the given index: something moving at around
+// 10 metres per second once a second, stopping now and again.
+static void getFix(size_t index, uGnssPosLogFix_t *pFix)
+{
+    int32_t moving = (int32_t) index;
+
+    if ((index % 100) > 90) {
+        // Stopped
+        moving = (int32_t) (index - (index % 100) + 90);
+    }
+    pFix->latitudeX1e7 = 521234567 + (moving * 73) + ((moving % 7) * 5);
+    pFix->longitudeX1e7 = -12345678 - (moving * 51) + ((moving % 5) * 3);
+    pFix->altitudeMillimetres = 85000 + ((moving % 20) * 150) - 1500;
+    pFix->timeMs = 1700000000000LL + (((int64_t) index) * 1000);
+}
+
+// Check that a decoded fix matches the made-up fix at index.
+static bool fixIsGood(size_t index, const uGnssPosLogFix_t *pFix)
+{
+    uGnssPosLogFix_t fix;
+
+    getFix(index, &fix);
+
+    return (fix.latitudeX1e7 == pFix->latitudeX1e7) &&
+           (fix.longitudeX1e7 == pFix->longitudeX1e7) &&
+           (fix.altitudeMillimetres == pFix->altitudeMillimetres) &&
+           (fix.timeMs == pFix->timeMs);
+}
+
+// Decode all of the fixes in pBuffer, checking them against the
+// made-up fixes from *pIndex onwards, returning the number decoded.
+static size_t decodeCheck(const char *pBuffer, size_t size,
+                          uGnssPosLogFix_t *pFix, size_t *pIndex)
+{
+    size_t numFixes = 0;
+    int32_t x;
+
+    while (size > 0) {
+        x = uGnssPosLogDecode(pBuffer, size, pFix);
+        U_PORT_TEST_ASSERT(x > 0);
+        U_PORT_TEST_ASSERT((size_t) x <= size);
+        U_PORT_TEST_ASSERT(fixIsGood(*pIndex, pFix));
+        pBuffer += x;
+        size -= x;
+        (*pIndex)++;
+        numFixes++;
+    }
+
+    return numFixes;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Test the position log.
+ */
+U_PORT_TEST_FUNCTION("[gnssPosLog]", "gnssPosLogBasic")
+{
+    int32_t resourceCount;
+    uGnssPosLog_t log;
+    char *pBuffer;
+    char *pExport;
+    uGnssPosLogFix_t fix;
+    size_t numFixes;
+    size_t index;
+    size_t numOverflow = 0;
+    int32_t x;
+
+    // Get the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    pBuffer = (char *) pUPortMalloc(U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+    pExport = (char *) pUPortMalloc(U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pExport != NULL);
+
+    // A buffer too small for even one record should be refused
+    U_PORT_TEST_ASSERT(uGnssPosLogCreate(&log, pBuffer,
+                                         U_GNSS_POS_LOG_RECORD_LENGTH_MAX_BYTES) < 0);
+    U_PORT_TEST_ASSERT(uGnssPosLogCreate(&log, pBuffer,
+                                         U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES) == 0);
+    U_PORT_TEST_ASSERT(uGnssPosLogGetNumFixes(&log) == 0);
+    U_PORT_TEST_ASSERT(uGnssPosLogExport(&log, pExport,
+                                         U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES, false) == 0);
+
+    // Add fixes until the log has filled up and wrapped a few times,
+    // checking that the whole of what is left can be decoded each time
+    for (size_t y = 0; y < U_GNSS_POS_LOG_TEST_NUM_FIXES; y++) {
+        getFix(y, &fix);
+        U_PORT_TEST_ASSERT(uGnssPosLogAdd(&log, fix.latitudeX1e7, fix.longitudeX1e7,
+                                          fix.altitudeMillimetres, fix.timeMs) == 0);
+        numFixes = uGnssPosLogGetNumFixes(&log);
+        U_PORT_TEST_ASSERT((numFixes > 0) && (numFixes <= y + 1));
+        if ((numFixes < y + 1) && (numOverflow == 0)) {
+            numOverflow = y;
+            U_TEST_PRINT_LINE("log of %d byte(s) full after %d fix(es), average %d"
+                              " byte(s) per fix.", U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES,
+                              numOverflow, U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES / numOverflow);
+            U_PORT_TEST_ASSERT(U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES / numOverflow <= 12);
+        }
+        x = uGnssPosLogExport(&log, pExport, U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES, false);
+        U_PORT_TEST_ASSERT(x > 0);
+        // The export must start with a key-frame, hence the
+        // fix we start with is irrelevant
+        memset(&fix, 0, sizeof(fix));
+        index = y + 1 - numFixes;
+        U_PORT_TEST_ASSERT(decodeCheck(pExport, x, &fix, &index) == numFixes);
+        // Not removing, so the log should be unchanged
+        U_PORT_TEST_ASSERT(uGnssPosLogGetNumFixes(&log) == numFixes);
+    }
+    U_PORT_TEST_ASSERT(numOverflow > 0);
+
+    // Now export it all in smaller chunks, removing it as we go
+    U_TEST_PRINT_LINE("exporting %d fix(es) in chunks of %d byte(s).",
+                      numFixes, U_GNSS_POS_LOG_TEST_EXPORT_SIZE_BYTES);
+    memset(&fix, 0, sizeof(fix));
+    index = U_GNSS_POS_LOG_TEST_NUM_FIXES - numFixes;
+    x = 1;
+    while (x > 0) {
+        x = uGnssPosLogExport(&log, pExport, U_GNSS_POS_LOG_TEST_EXPORT_SIZE_BYTES, true);
+        U_PORT_TEST_ASSERT(x >= 0);
+        decodeCheck(pExport, x, &fix, &index);
+    }
+    U_PORT_TEST_ASSERT(index == U_GNSS_POS_LOG_TEST_NUM_FIXES);
+    U_PORT_TEST_ASSERT(uGnssPosLogGetNumFixes(&log) == 0);
+
+    // A partial record should be reported as such
+    U_PORT_TEST_ASSERT(uGnssPosLogAdd(&log, 1, 2, 3, 4) == 0);
+    x = uGnssPosLogExport(&log, pExport, U_GNSS_POS_LOG_TEST_BUFFER_SIZE_BYTES, false);
+    U_PORT_TEST_ASSERT(x > 1);
+    U_PORT_TEST_ASSERT(uGnssPosLogDecode(pExport, x - 1, &fix) == (int32_t) U_ERROR_COMMON_TIMEOUT);
+    U_PORT_TEST_ASSERT(uGnssPosLogDecode(pExport, x, &fix) == x);
+    U_PORT_TEST_ASSERT((fix.latitudeX1e7 == 1) && (fix.longitudeX1e7 == 2) &&
+                       (fix.altitudeMillimetres == 3) && (fix.timeMs == 4));
+
+    uGnssPosLogDelete(&log);
+    uPortFree(pExport);
+    uPortFree(pBuffer);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+// End of file
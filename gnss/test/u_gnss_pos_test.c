@@ -134,6 +134,22 @@
 # define U_GNSS_POS_RRLP_SIZE_BYTES 1024
 #endif
 
+#ifndef U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS
+/** The number of measurement sets to ask for when testing
+ * uGnssPosGetRrlpBatchStart().
+ */
+# define U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS 3
+#endif
+
+#ifndef U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES
+/** The size of the arena to give to uGnssPosGetRrlpBatchStart(),
+ * enough for #U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS sets with a
+ * reasonable number of satellites.
+ */
+# define U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES (U_GNSS_POS_RRLP_SIZE_BYTES * \
+                                                      U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS)
+#endif
+
 #ifndef U_GNSS_POS_TEST_RRLP_SVS_THRESHOLD
 /** Minimum number of space vehicles for RRLP testing.
  */
@@ -272,6 +288,30 @@ static int32_t gProtocolBitMap = -1;
  */
 static uGnssMessageId_t gUbxNavPvtMessageId = {U_GNSS_PROTOCOL_UBX, {0x0107}};
 
+/** Count of complete fixes received by fixCallback().
+ */
+static volatile size_t gGoodFixCount;
+
+/** The last complete fix received by fixCallback().
+ */
+static uGnssPosFix_t gFix;
+
+/** Latency statistics for uGnssPosGetStreamedFixStart().
+ */
+static uGnssPosStatLatency_t gStatLatency;
+
+/** The number of times rrlpBatchCallback() has been called.
+ */
+static volatile size_t gRrlpBatchCount;
+
+/** The number of measurement sets received by rrlpBatchCallback().
+ */
+static volatile size_t gRrlpBatchNumSets;
+
+/** Zero if rrlpBatchCallback() has found nothing wrong.
+ */
+static volatile int32_t gRrlpBatchErrorCode;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -314,6 +354,63 @@ static void posCallback(uDeviceHandle_t gnssHandle,
     }
 }
 
+// Callback function for uGnssPosGetStreamedFixStart().
+static void fixCallback(uDeviceHandle_t gnssHandle,
+                        const uGnssPosFix_t *pFix,
+                        void *pCallbackParam)
+{
+    uint32_t wanted = (1UL << U_GNSS_POS_FIX_CONTENT_PVT) |
+                      (1UL << U_GNSS_POS_FIX_CONTENT_COV);
+
+    gGnssHandle = gnssHandle;
+    if ((pCallbackParam == (void *) &gFix) &&
+        ((pFix->contentsBitmap & wanted) == wanted)) {
+        gFix = *pFix;
+        gGoodFixCount++;
+    }
+}
+
+// Callback function for uGnssPosGetRrlpBatchStart(): checks that
+// the arena contains numSets whole UBX-RXM-MEASX messages, since
+// it will be overwritten once this returns.
+static void rrlpBatchCallback(uDeviceHandle_t gnssHandle,
+                              const char *pArena, size_t size,
+                              size_t numSets, void *pCallbackParam)
+{
+    const uint8_t *pSet = (const uint8_t *) pArena;
+    size_t count = 0;
+    size_t length;
+
+    gGnssHandle = gnssHandle;
+    if (pCallbackParam != (void *) &gRrlpBatchCount) {
+        gRrlpBatchErrorCode = 1;
+    }
+    if ((numSets == 0) || (numSets > U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS)) {
+        gRrlpBatchErrorCode = 2;
+    }
+    while ((gRrlpBatchErrorCode == 0) && (size > 0)) {
+        // Each set should be a UBX-RXM-MEASX message with header
+        if ((size < 8) || (*pSet != 0xb5) || (*(pSet + 1) != 0x62) ||
+            (*(pSet + 2) != 0x02) || (*(pSet + 3) != 0x14)) {
+            gRrlpBatchErrorCode = 3;
+        } else {
+            length = *(pSet + 4) + (((size_t) * (pSet + 5)) << 8) + 8;
+            if (length > size) {
+                gRrlpBatchErrorCode = 4;
+            } else {
+                pSet += length;
+                size -= length;
+                count++;
+            }
+        }
+    }
+    if ((gRrlpBatchErrorCode == 0) && (count != numSets)) {
+        gRrlpBatchErrorCode = 5;
+    }
+    gRrlpBatchNumSets += numSets;
+    gRrlpBatchCount++;
+}
+
 // Convert a lat/long into a whole number and a
 // bit-after-the-decimal-point that can be printed
 // without having to invoke floating point operations,
@@ -535,6 +632,7 @@ U_PORT_TEST_FUNCTION("[gnssPos]", "gnssPosRrlp")
     uDeviceHandle_t gnssHandle;
     int32_t y;
     char *pBuffer;
+    char *pArena;
     int64_t startTimeMs;
     int32_t resourceCount;
     size_t iterations;
@@ -551,6 +649,8 @@ U_PORT_TEST_FUNCTION("[gnssPos]", "gnssPosRrlp")
     U_PORT_TEST_ASSERT(pBuffer != NULL);
     //lint -esym(613, pBuffer) Suppress possible use of NULL pointer
     // for pBuffer from now on
+    pArena = (char *) pUPortMalloc(U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(pArena != NULL);
 
     // Repeat for all transport types
     iterations = uGnssTestPrivateTransportTypesSet(transportTypes, U_CFG_APP_GNSS_UART,
@@ -630,6 +730,12 @@ U_PORT_TEST_FUNCTION("[gnssPos]", "gnssPosRrlp")
         }
 
         if (y == 0) {
+            // Batched capture is only supported in MEASX mode
+            U_PORT_TEST_ASSERT(uGnssPosGetRrlpBatchStart(gnssHandle, pArena,
+                                                         U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES,
+                                                         1, -1, -1, -1, -1,
+                                                         rrlpBatchCallback,
+                                                         NULL) == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
             // Do an RRLP get of the 12C compact mode with whacky thresholds, since
             // they should be ignored
             startTimeMs = uPortGetTickTimeMs();
@@ -650,6 +756,57 @@ U_PORT_TEST_FUNCTION("[gnssPos]", "gnssPosRrlp")
         // Put the RRLP mode back to the default again (should always work)
         U_PORT_TEST_ASSERT(uGnssPosSetRrlpMode(gnssHandle, U_GNSS_RRLP_MODE_MEASX) == 0);
 
+        if (transportTypes[x] != U_GNSS_TRANSPORT_AT) {
+            // Check that bad parameters are rejected
+            U_PORT_TEST_ASSERT(uGnssPosGetRrlpBatchStart(gnssHandle, NULL,
+                                                         U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES,
+                                                         1, -1, -1, -1, -1,
+                                                         rrlpBatchCallback, NULL) < 0);
+            U_PORT_TEST_ASSERT(uGnssPosGetRrlpBatchStart(gnssHandle, pArena, 8,
+                                                         1, -1, -1, -1, -1,
+                                                         rrlpBatchCallback, NULL) < 0);
+            U_PORT_TEST_ASSERT(uGnssPosGetRrlpBatchStart(gnssHandle, pArena,
+                                                         U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES,
+                                                         0, -1, -1, -1, -1,
+                                                         rrlpBatchCallback, NULL) < 0);
+            U_PORT_TEST_ASSERT(uGnssPosGetRrlpBatchStart(gnssHandle, pArena,
+                                                         U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES,
+                                                         1, -1, -1, -1, -1, NULL, NULL) < 0);
+            // Now collect a batch of RRLP information
+            gRrlpBatchCount = 0;
+            gRrlpBatchNumSets = 0;
+            gRrlpBatchErrorCode = 0;
+            gGnssHandle = NULL;
+            startTimeMs = uPortGetTickTimeMs();
+            U_TEST_PRINT_LINE("collecting a batch of %d set(s) of RRLP information...",
+                              U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS);
+            U_PORT_TEST_ASSERT(uGnssPosGetRrlpBatchStart(gnssHandle, pArena,
+                                                         U_GNSS_POS_TEST_RRLP_BATCH_ARENA_SIZE_BYTES,
+                                                         U_GNSS_POS_TEST_RRLP_BATCH_NUM_SETS,
+                                                         U_GNSS_POS_TEST_RRLP_SVS_THRESHOLD,
+                                                         U_GNSS_POS_TEST_RRLP_CNO_THRESHOLD,
+                                                         U_GNSS_POS_TEST_RRLP_MULTIPATH_INDEX_LIMIT,
+                                                         U_GNSS_POS_TEST_RRLP_PSEUDORANGE_RMS_ERROR_INDEX_LIMIT,
+                                                         rrlpBatchCallback,
+                                                         (void *) &gRrlpBatchCount) == 0);
+            while ((gRrlpBatchCount == 0) &&
+                   (uPortGetTickTimeMs() - startTimeMs < U_GNSS_POS_TEST_TIMEOUT_SECONDS * 1000)) {
+                uPortTaskBlock(100);
+            }
+            uGnssPosGetRrlpBatchStop(gnssHandle);
+            U_TEST_PRINT_LINE("%d batch(es) containing %d set(s) of RRLP information"
+                              " arrived in %d second(s), error code %d.", gRrlpBatchCount,
+                              gRrlpBatchNumSets,
+                              (int32_t) (uPortGetTickTimeMs() - startTimeMs) / 1000,
+                              gRrlpBatchErrorCode);
+            U_PORT_TEST_ASSERT(gRrlpBatchCount > 0);
+            U_PORT_TEST_ASSERT(gRrlpBatchNumSets > 0);
+            U_PORT_TEST_ASSERT(gRrlpBatchErrorCode == 0);
+            U_PORT_TEST_ASSERT(gGnssHandle == gnssHandle);
+            // Stopping again should do no harm
+            uGnssPosGetRrlpBatchStop(gnssHandle);
+        }
+
         // Check that we haven't dropped any incoming data
         y = uGnssMsgReceiveStatStreamLoss(gnssHandle);
         U_TEST_PRINT_LINE("%d byte(s) lost at the input to the ring-buffer during that test.", y);
@@ -661,6 +818,7 @@ U_PORT_TEST_FUNCTION("[gnssPos]", "gnssPosRrlp")
     }
 
     // Free memory
+    uPortFree(pArena);
     uPortFree(pBuffer);
 
     // Check for resource leaks
@@ -829,8 +987,38 @@ U_PORT_TEST_FUNCTION("[gnssPos]", "gnssPosStreamed")
                 // Don't, stop, me, now.
             }
 
+            // Now the merged version, adding UBX-NAV-COV to the fix;
+            // this also stops the streamed position above
+            U_PORT_TEST_ASSERT(uGnssPosGetStreamedFixStart(gnssHandle,
+                                                           U_GNSS_POS_STREAMED_FIX_PERIOD_MIN_MS - 1,
+                                                           1UL << U_GNSS_POS_FIX_CONTENT_COV,
+                                                           fixCallback, &gFix) < 0);
+            gGoodFixCount = 0;
+            y = uGnssPosGetStreamedFixStart(gnssHandle, U_GNSS_POS_TEST_STREAMED_RATE_MS,
+                                            1UL << U_GNSS_POS_FIX_CONTENT_COV,
+                                            fixCallback, &gFix);
+            U_TEST_PRINT_LINE("uGnssPosGetStreamedFixStart() returned %d.", y);
+            U_PORT_TEST_ASSERT(y == 0);
+            uPortTaskBlock(1000 * (U_GNSS_POS_TEST_STREAMED_WAIT_SECONDS + U_GNSS_POS_TEST_STREAMED_SECONDS));
+            U_PORT_TEST_ASSERT(uGnssPosGetStreamedStatLatency(gnssHandle, &gStatLatency) == 0);
+            U_TEST_PRINT_LINE("%d merged fix(es), %d complete, %d incomplete, latency"
+                              " last %d ms, min %d ms, max %d ms, average %d ms.",
+                              gStatLatency.numFixes, gGoodFixCount, gStatLatency.numIncomplete,
+                              gStatLatency.lastMs, gStatLatency.minMs, gStatLatency.maxMs,
+                              gStatLatency.averageMs);
+            if (gGoodFixCount > 0) {
+                U_PORT_TEST_ASSERT(gGnssHandle == gnssHandle);
+                U_PORT_TEST_ASSERT(gStatLatency.numFixes >= (int32_t) gGoodFixCount);
+                U_PORT_TEST_ASSERT(gStatLatency.minMs >= 0);
+                U_PORT_TEST_ASSERT(gStatLatency.minMs <= gStatLatency.averageMs);
+                U_PORT_TEST_ASSERT(gStatLatency.averageMs <= gStatLatency.maxMs);
+                U_PORT_TEST_ASSERT(gFix.pvt.iTOW == (int32_t) gFix.iTOW);
+                U_PORT_TEST_ASSERT(gFix.cov.iTOW == gFix.iTOW);
+            }
+
             // Now stop
             uGnssPosGetStreamedStop(gnssHandle);
+            U_PORT_TEST_ASSERT(uGnssPosGetStreamedStatLatency(gnssHandle, &gStatLatency) < 0);
 
             U_TEST_PRINT_LINE("waiting %d second(s) for things to calm down and then flushing...",
                               U_GNSS_POS_TEST_STREAMED_WAIT_SECONDS);
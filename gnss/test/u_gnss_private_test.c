@@ -39,6 +39,7 @@
 #include "string.h"    // strlen()/strncpy()
 #include "stdlib.h"    // rand()
 #include "ctype.h"     // isprint()
+#include "time.h"      // struct tm
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -65,6 +66,11 @@
 #include "u_gnss_type.h"
 #include "u_gnss.h"
 #include "u_gnss_private.h"
+#include "u_gnss_cfg_val_key.h"
+#include "u_gnss_cfg.h"
+#include "u_gnss_cfg_private.h"
+
+#include "u_lib_mga.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -139,6 +145,15 @@ typedef struct {
     uint16_t id;
 } uGnssPrivateTestRtcmMatch_t;
 
+/** Context for mgaOfflineReadCallback().
+ */
+typedef struct {
+    const char *pData;
+    size_t size;
+    size_t readSizeMax;
+    bool fail;
+} uGnssPrivateTestMgaOfflineRead_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -493,6 +508,57 @@ static bool checkDecodeUbx(uRingBuffer_t *pRingBuffer, int32_t readHandle,
 
 #endif // #ifndef __ZEPHYR__
 
+// Read callback for mgaGetOfflineDataRead(), recording the largest
+// read that was asked for.
+static UBX_I4 mgaOfflineReadCallback(const void *pContext, UBX_U4 offset,
+                                     UBX_U1 *pBuffer, UBX_I4 iSize)
+{
+    uGnssPrivateTestMgaOfflineRead_t *pRead = (uGnssPrivateTestMgaOfflineRead_t *) pContext;
+    UBX_I4 size = -1;
+
+    if (!pRead->fail && (offset + iSize <= pRead->size)) {
+        memcpy(pBuffer, pRead->pData + offset, iSize);
+        if ((size_t) iSize > pRead->readSizeMax) {
+            pRead->readSizeMax = iSize;
+        }
+        size = iSize;
+    }
+
+    return size;
+}
+
+// Make a fake AssistNow Offline blob in pBuffer: one UBX-MGA-GPS
+// and one UBX-MGA-GAL almanac message followed by UBX-MGA-ANO
+// messages for two satellites at two hours of each of numDays days
+// from 1st October 2023, returning the number of bytes written.
+static size_t makeMgaOfflineBlob(char *pBuffer, size_t numDays)
+{
+    char body[76] = {0};
+    size_t size = 0;
+
+    // UBX-MGA-GPS-ALM and UBX-MGA-GAL-ALM
+    body[0] = 0x02;
+    size += uUbxProtocolEncode(0x13, 0x00, body, 36, pBuffer + size);
+    size += uUbxProtocolEncode(0x13, 0x02, body, 32, pBuffer + size);
+    // UBX-MGA-ANO
+    body[0] = 0x00;
+    for (size_t day = 0; day < numDays; day++) {
+        for (size_t hour = 0; hour < 24; hour += 12) {
+            for (size_t svId = 1; svId <= 2; svId++) {
+                body[2] = (char) svId;
+                body[4] = 23;
+                body[5] = 10;
+                body[6] = (char) (day + 1);
+                body[7] = (char) hour;
+                size += uUbxProtocolEncode(0x13, 0x20, body, sizeof(body),
+                                           pBuffer + size);
+            }
+        }
+    }
+
+    return size;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -891,6 +957,293 @@ U_PORT_TEST_FUNCTION("[gnss]", "gnssPrivateUbx")
 
 #endif // #ifndef __ZEPHYR__
 
+/** Test that compiled message filters give the same answers as
+ * uGnssPrivateMessageIdIsWanted().
+ */
+U_PORT_TEST_FUNCTION("[gnss]", "gnssPrivateMessageFilter")
+{
+    uGnssPrivateMessageId_t id[16];
+    uGnssPrivateMessageFilter_t filter[sizeof(id) / sizeof(id[0])];
+    const char *pNmea[] = {"", "G", "GP", "G?GSV", "GPGSV", "GNGGA", "GPGS?", "GPGS"};
+    const uint16_t ubx[] = {0x0107, 0x01FF, 0xFF07, 0xFFFF};
+    const uint16_t rtcm[] = {1005, U_GNSS_RTCM_MESSAGE_ID_ALL};
+    size_t y = 0;
+    bool wanted;
+
+    memset(id, 0, sizeof(id));
+    for (size_t x = 0; x < sizeof(pNmea) / sizeof(pNmea[0]); x++, y++) {
+        id[y].type = U_GNSS_PROTOCOL_NMEA;
+        strncpy(id[y].id.nmea, pNmea[x], sizeof(id[y].id.nmea));
+    }
+    for (size_t x = 0; x < sizeof(ubx) / sizeof(ubx[0]); x++, y++) {
+        id[y].type = U_GNSS_PROTOCOL_UBX;
+        id[y].id.ubx = ubx[x];
+    }
+    for (size_t x = 0; x < sizeof(rtcm) / sizeof(rtcm[0]); x++, y++) {
+        id[y].type = U_GNSS_PROTOCOL_RTCM;
+        id[y].id.rtcm = rtcm[x];
+    }
+    id[y++].type = U_GNSS_PROTOCOL_UNKNOWN;
+    id[y++].type = U_GNSS_PROTOCOL_ALL;
+    U_PORT_TEST_ASSERT(y == sizeof(id) / sizeof(id[0]));
+
+    for (size_t x = 0; x < y; x++) {
+        uGnssPrivateMessageFilterCompile(&(id[x]), &(filter[x]));
+    }
+    // Every ID against every other ID as the wanted one
+    for (size_t x = 0; x < y; x++) {
+        for (size_t z = 0; z < y; z++) {
+            wanted = uGnssPrivateMessageIdIsWanted(&(id[x]), &(id[z]));
+            if (uGnssPrivateMessageFilterIsWanted(&(filter[x]), &(filter[z])) != wanted) {
+                U_TEST_PRINT_LINE("ID %d against wanted ID %d should give %s.",
+                                  x, z, wanted ? "true" : "false");
+                U_PORT_TEST_ASSERT(false);
+            }
+        }
+    }
+}
+
+/** Test that a VALSET of values the configuration shadow says are
+ * already set is not sent: the instance here has no transport so
+ * anything that tried to send would fail.
+ */
+U_PORT_TEST_FUNCTION("[gnss]", "gnssPrivateCfgShadow")
+{
+    uGnssPrivateInstance_t instance;
+    uGnssCfgVal_t val[2] = {{U_GNSS_CFG_VAL_KEY_ID_RATE_MEAS_U2, 1000},
+        {U_GNSS_CFG_VAL_KEY_ID_RATE_NAV_U2, 1}
+    };
+
+    memset(&instance, 0, sizeof(instance));
+    for (size_t x = 0; (x < gUGnssPrivateModuleListSize) && (instance.pModule == NULL); x++) {
+        if (U_GNSS_PRIVATE_HAS((&(gUGnssPrivateModuleList[x])),
+                               U_GNSS_PRIVATE_FEATURE_CFGVALXXX)) {
+            instance.pModule = &(gUGnssPrivateModuleList[x]);
+        }
+    }
+    U_PORT_TEST_ASSERT(instance.pModule != NULL);
+
+    for (size_t x = 0; x < sizeof(val) / sizeof(val[0]); x++) {
+        instance.cfgShadow[x].keyId = val[x].keyId;
+        instance.cfgShadow[x].value = (uint32_t) val[x].value;
+    }
+    instance.cfgShadowNumEntries = sizeof(val) / sizeof(val[0]);
+    U_PORT_TEST_ASSERT(uGnssCfgPrivateValSetList(&instance, val,
+                                                 sizeof(val) / sizeof(val[0]),
+                                                 U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                                 U_GNSS_CFG_LAYERS_SET) == 0);
+    U_PORT_TEST_ASSERT(uGnssCfgPrivateValSetList(&instance, &(val[1]), 1,
+                                                 U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                                 U_GNSS_CFG_LAYERS_SET) == 0);
+    U_PORT_TEST_ASSERT(instance.cfgShadowNumEntries == sizeof(val) / sizeof(val[0]));
+    uGnssCfgPrivateShadowClear(&instance);
+    U_PORT_TEST_ASSERT(instance.cfgShadowNumEntries == 0);
+}
+
+/** Test the key information table and the type checking of the
+ * typed VALGET/VALSET functions, neither of which need a GNSS chip.
+ */
+U_PORT_TEST_FUNCTION("[gnss]", "gnssPrivateCfgValKeyInfo")
+{
+    const uGnssCfgValKeyInfo_t *pKeyInfo;
+
+    // The table must be sorted, with no duplicates, for the binary search
+    U_PORT_TEST_ASSERT(gUGnssCfgValKeyInfoNum > 0);
+    for (size_t x = 1; x < gUGnssCfgValKeyInfoNum; x++) {
+        U_PORT_TEST_ASSERT(gUGnssCfgValKeyInfo[x].keyId > gUGnssCfgValKeyInfo[x - 1].keyId);
+    }
+
+    // Every key should then be findable, both ways
+    for (size_t x = 0; x < gUGnssCfgValKeyInfoNum; x++) {
+        U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfo(gUGnssCfgValKeyInfo[x].keyId) ==
+                           &(gUGnssCfgValKeyInfo[x]));
+    }
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfoFromName(gUGnssCfgValKeyInfo[0].pName) ==
+                       &(gUGnssCfgValKeyInfo[0]));
+
+    pKeyInfo = pUGnssCfgValKeyInfo(U_GNSS_CFG_VAL_KEY_ID_ANA_USE_ANA_L);
+    U_PORT_TEST_ASSERT(pKeyInfo != NULL);
+    U_PORT_TEST_ASSERT(pKeyInfo->type == (uint8_t) U_GNSS_CFG_VAL_KEY_TYPE_L);
+    U_PORT_TEST_ASSERT(strcmp(pKeyInfo->pName, "ANA-USE_ANA") == 0);
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfoFromName("CFG-ANA-USE_ANA") == pKeyInfo);
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfoFromName("ANA-USE_ANA") == pKeyInfo);
+    pKeyInfo = pUGnssCfgValKeyInfo(U_GNSS_CFG_VAL_KEY_ID_NAVSPG_USRDAT_DX_R4);
+    U_PORT_TEST_ASSERT(pKeyInfo != NULL);
+    U_PORT_TEST_ASSERT(pKeyInfo->type == (uint8_t) U_GNSS_CFG_VAL_KEY_TYPE_R);
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfoFromName("CFG-NAVSPG-USRDAT_DX") == pKeyInfo);
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfo(U_GNSS_CFG_VAL_KEY(0x7ff, 0x7ff,
+                                                              U_GNSS_CFG_VAL_KEY_SIZE_ONE_BIT)) == NULL);
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfoFromName("CFG-ANA-NOT_A_KEY") == NULL);
+    U_PORT_TEST_ASSERT(pUGnssCfgValKeyInfoFromName(NULL) == NULL);
+
+    // The type and range checks happen before a GNSS instance is
+    // needed, so these can be tested with a NULL handle
+    U_PORT_TEST_ASSERT(uGnssCfgValSetInt(NULL, U_GNSS_CFG_VAL_KEY(0x7ff, 0x7ff,
+                                                                  U_GNSS_CFG_VAL_KEY_SIZE_ONE_BYTE),
+                                         0, U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                         U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_NOT_FOUND);
+    U_PORT_TEST_ASSERT(uGnssCfgValSetInt(NULL, U_GNSS_CFG_VAL_KEY_ID_ANA_USE_ANA_L, 2,
+                                         U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                         U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_INVALID_PARAMETER);
+    U_PORT_TEST_ASSERT(uGnssCfgValSetInt(NULL, U_GNSS_CFG_VAL_KEY_ID_ANA_ORBMAXERR_U2, 0x10000,
+                                         U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                         U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_INVALID_PARAMETER);
+    U_PORT_TEST_ASSERT(uGnssCfgValSetInt(NULL, U_GNSS_CFG_VAL_KEY_ID_ANA_ORBMAXERR_U2, -1,
+                                         U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                         U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_INVALID_PARAMETER);
+    U_PORT_TEST_ASSERT(uGnssCfgValSetInt(NULL, U_GNSS_CFG_VAL_KEY_ID_GEOFENCE_FENCE1_LAT_I4,
+                                         -2147483649LL, U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                         U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_INVALID_PARAMETER);
+    U_PORT_TEST_ASSERT(uGnssCfgValSetInt(NULL, U_GNSS_CFG_VAL_KEY_ID_NAVSPG_USRDAT_DX_R4, 0,
+                                         U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                         U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_INVALID_PARAMETER);
+    U_PORT_TEST_ASSERT(uGnssCfgValSetFloat(NULL, U_GNSS_CFG_VAL_KEY_ID_ANA_USE_ANA_L, 0,
+                                           U_GNSS_CFG_VAL_TRANSACTION_NONE,
+                                           U_GNSS_CFG_VAL_LAYER_RAM) == (int32_t) U_ERROR_COMMON_INVALID_PARAMETER);
+}
+
+/** Test that fill is stripped from received SPI data in the way
+ * that the fill threshold says it should be.
+ */
+U_PORT_TEST_FUNCTION("[gnss]", "gnssPrivateSpiFill")
+{
+    uGnssPrivateInstance_t instance;
+    uRingBuffer_t ringBuffer;
+    char linearBuffer[64];
+    char buffer[128];
+    char readBuffer[sizeof(linearBuffer)];
+    size_t x = 0;
+    int32_t y;
+
+    memset(&instance, 0, sizeof(instance));
+    U_PORT_TEST_ASSERT(uRingBufferCreate(&ringBuffer, linearBuffer, sizeof(linearBuffer)) == 0);
+    instance.pSpiRingBuffer = &ringBuffer;
+    instance.spiFillThreshold = 8;
+
+    // Build: a run of fill, some data, a run of fill shorter than the threshold,
+    // more data, a long run of fill starting at an odd offset, one byte of data
+    // and then trailing fill shorter than the threshold
+    memset(buffer, 0xFF, sizeof(buffer));
+    x += 13;
+    memcpy(buffer + x, "abcdefg", 7);
+    x += 7 + 3;
+    memcpy(buffer + x, "hi", 2);
+    x += 2 + 41;
+    buffer[x] = 'j';
+    x++;
+    x += 5;
+    y = uGnssPrivateSpiAddReceivedData(&instance, buffer, x);
+    U_TEST_PRINT_LINE("%d byte(s) of %d added to the SPI ring buffer.", y, x);
+    U_PORT_TEST_ASSERT(y == 7 + 3 + 2 + 1 + 5);
+    U_PORT_TEST_ASSERT(uRingBufferRead(&ringBuffer, readBuffer, sizeof(readBuffer)) == (size_t) y);
+    U_PORT_TEST_ASSERT(memcmp(readBuffer, "abcdefg\xFF\xFF\xFFhij\xFF\xFF\xFF\xFF\xFF", y) == 0);
+
+    // Short chunks of fill which together reach the threshold should
+    // be removed from the ring buffer
+    for (x = 0; x < 4; x++) {
+        y = uGnssPrivateSpiAddReceivedData(&instance, buffer, 2);
+        U_PORT_TEST_ASSERT(y == (int32_t) ((x < 3) ? (x + 1) * 2 : 0));
+    }
+    U_PORT_TEST_ASSERT(uGnssPrivateSpiAddReceivedData(&instance, "k", 1) == 1);
+    U_PORT_TEST_ASSERT(uRingBufferRead(&ringBuffer, readBuffer, sizeof(readBuffer)) == 1);
+    U_PORT_TEST_ASSERT(readBuffer[0] == 'k');
+
+    // With no threshold everything should be kept
+    instance.spiFillThreshold = 0;
+    U_PORT_TEST_ASSERT(uGnssPrivateSpiAddReceivedData(&instance, buffer, 20) == 20);
+    U_PORT_TEST_ASSERT(uGnssPrivateSpiAddReceivedData(NULL, buffer, 20) < 0);
+
+    uRingBufferDelete(&ringBuffer);
+}
+
+/** Test that reading AssistNow Offline data through a callback using
+ * mgaGetOfflineDataRead() gives the same answer as the in-RAM libMga
+ * filtering functions, only reading the selected messages in full.
+ */
+U_PORT_TEST_FUNCTION("[gnss]", "gnssPrivateMgaOfflineRead")
+{
+    int32_t resourceCount;
+    char *pBlob;
+    size_t blobSize;
+    uGnssPrivateTestMgaOfflineRead_t read = {0};
+    struct tm structTm = {0};
+    UBX_U1 *pRead = NULL;
+    UBX_I4 readSize = 0;
+    UBX_U1 *pRam = NULL;
+    UBX_I4 ramSize = 0;
+
+    // Get the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    // Four days, 2 hours, 2 satellites, each message 84 bytes,
+    // plus the two almanac messages
+    pBlob = (char *) pUPortMalloc((4 * 2 * 2 * 84) + 44 + 40);
+    U_PORT_TEST_ASSERT(pBlob != NULL);
+    blobSize = makeMgaOfflineBlob(pBlob, 4);
+    U_PORT_TEST_ASSERT(blobSize == (4 * 2 * 2 * 84) + 44 + 40);
+    read.pData = pBlob;
+    read.size = blobSize;
+
+    // Today's data
+    structTm.tm_year = 2023 - 1900;
+    structTm.tm_mon = 10 - 1;
+    structTm.tm_mday = 2;
+    structTm.tm_hour = 6;
+    U_PORT_TEST_ASSERT(mgaGetOfflineDataRead(&structTm, mgaOfflineReadCallback, &read,
+                                             (UBX_I4) blobSize, &pRead, &readSize) == MGA_API_OK);
+    U_PORT_TEST_ASSERT(pRead != NULL);
+    U_TEST_PRINT_LINE("%d byte(s) of today's data read from %d byte(s), largest read %d byte(s).",
+                      readSize, blobSize, read.readSizeMax);
+    // One day's worth of ANO messages plus the almanac
+    U_PORT_TEST_ASSERT(readSize == (2 * 2 * 84) + 44 + 40);
+    U_PORT_TEST_ASSERT(read.readSizeMax <= 84);
+    U_PORT_TEST_ASSERT(mgaGetTodaysOfflineData(&structTm, (UBX_U1 *) pBlob, (UBX_I4) blobSize,
+                                               &pRam, &ramSize) == MGA_API_OK);
+    U_PORT_TEST_ASSERT(ramSize == readSize);
+    U_PORT_TEST_ASSERT(memcmp(pRead, pRam, readSize) == 0);
+    uPortFree(pRead);
+    pRead = NULL;
+    uPortFree(pRam);
+    pRam = NULL;
+
+    // Almanac data only
+    U_PORT_TEST_ASSERT(mgaGetOfflineDataRead(NULL, mgaOfflineReadCallback, &read,
+                                             (UBX_I4) blobSize, &pRead, &readSize) == MGA_API_OK);
+    U_PORT_TEST_ASSERT(readSize == 44 + 40);
+    U_PORT_TEST_ASSERT(mgaGetAlmOfflineData((UBX_U1 *) pBlob, (UBX_I4) blobSize,
+                                            &pRam, &ramSize) == MGA_API_OK);
+    U_PORT_TEST_ASSERT(ramSize == readSize);
+    U_PORT_TEST_ASSERT(memcmp(pRead, pRam, readSize) == 0);
+    uPortFree(pRead);
+    pRead = NULL;
+    uPortFree(pRam);
+
+    // A read failure, a truncated blob and a corrupt blob should all
+    // be reported and leave nothing allocated
+    read.fail = true;
+    U_PORT_TEST_ASSERT(mgaGetOfflineDataRead(&structTm, mgaOfflineReadCallback, &read,
+                                             (UBX_I4) blobSize, &pRead, &readSize) == MGA_API_BAD_DATA);
+    U_PORT_TEST_ASSERT((pRead == NULL) && (readSize == 0));
+    read.fail = false;
+    read.size = blobSize - 1;
+    U_PORT_TEST_ASSERT(mgaGetOfflineDataRead(&structTm, mgaOfflineReadCallback, &read,
+                                             (UBX_I4) read.size, &pRead, &readSize) == MGA_API_BAD_DATA);
+    U_PORT_TEST_ASSERT((pRead == NULL) && (readSize == 0));
+    read.size = blobSize;
+    *(pBlob + 44) = 0;
+    U_PORT_TEST_ASSERT(mgaGetOfflineDataRead(NULL, mgaOfflineReadCallback, &read,
+                                             (UBX_I4) blobSize, &pRead, &readSize) == MGA_API_BAD_DATA);
+    U_PORT_TEST_ASSERT((pRead == NULL) && (readSize == 0));
+
+    uPortFree(pBlob);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
@@ -38,7 +38,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
-#include "string.h"    // strstr()
+#include "string.h"    // strstr(), memset()
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -107,6 +107,25 @@
 # define U_GNSS_PWR_TEST_FLAG_SET_RETRIES 1
 #endif
 
+#ifndef U_GNSS_PWR_TEST_DUTY_CYCLE_NUM_FIXES
+/** The number of fixes to obtain when testing the duty-cycling engine.
+ */
+# define U_GNSS_PWR_TEST_DUTY_CYCLE_NUM_FIXES 2
+#endif
+
+#ifndef U_GNSS_PWR_TEST_DUTY_CYCLE_INTERVAL_SECONDS
+/** The fix interval to use when testing the duty-cycling engine.
+ */
+# define U_GNSS_PWR_TEST_DUTY_CYCLE_INTERVAL_SECONDS 10
+#endif
+
+#ifndef U_GNSS_PWR_TEST_DUTY_CYCLE_ON_TIME_MAX_SECONDS
+/** The maximum on-time to allow per fix when testing the
+ * duty-cycling engine, enough for a cold start.
+ */
+# define U_GNSS_PWR_TEST_DUTY_CYCLE_ON_TIME_MAX_SECONDS 180
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -660,6 +679,100 @@ U_PORT_TEST_FUNCTION("[gnssPwr]", "gnssPwrSaving")
 
 #endif // #ifndef U_CFG_TEST_GNSS_POWER_SAVING_NOT_SUPPORTED
 
+/** Test the duty-cycling engine.
+ */
+U_PORT_TEST_FUNCTION("[gnssPwr]", "gnssPwrDutyCycle")
+{
+    uDeviceHandle_t gnssHandle;
+    int32_t resourceCount;
+    size_t iterations;
+    uGnssTransportType_t transportTypes[U_GNSS_TRANSPORT_MAX_NUM];
+    uGnssPwrDutyCycleCfg_t cfg;
+    uGnssPwrDutyCycle_t dutyCycle;
+    uGnssPwrDutyCycleStat_t stat;
+    int32_t latitudeX1e7;
+    int32_t longitudeX1e7;
+    int32_t radiusMillimetres;
+    int32_t y;
+
+    // In case a previous test failed
+    uGnssTestPrivateCleanup(&gHandles);
+
+    // Obtain the initial resource count
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    memset(&cfg, 0, sizeof(cfg));
+    cfg.fixIntervalSeconds = U_GNSS_PWR_TEST_DUTY_CYCLE_INTERVAL_SECONDS;
+    cfg.radiusMillimetresMax = -1;
+    cfg.onTimeMaxSeconds = 0;
+    // Bad parameters
+    U_PORT_TEST_ASSERT(uGnssPwrDutyCycleInit(NULL, &cfg) < 0);
+    U_PORT_TEST_ASSERT(uGnssPwrDutyCycleInit(&dutyCycle, NULL) < 0);
+    U_PORT_TEST_ASSERT(uGnssPwrDutyCycleInit(&dutyCycle, &cfg) < 0);
+    cfg.onTimeMaxSeconds = U_GNSS_PWR_TEST_DUTY_CYCLE_ON_TIME_MAX_SECONDS;
+
+    // Repeat for all transport types
+    iterations = uGnssTestPrivateTransportTypesSet(transportTypes, U_CFG_APP_GNSS_UART,
+                                                   U_CFG_APP_GNSS_I2C, U_CFG_APP_GNSS_SPI);
+    for (size_t x = 0; x < iterations; x++) {
+        // Do the standard preamble, leaving the GNSS chip off
+        // since the duty-cycling engine switches it on
+        U_TEST_PRINT_LINE("testing duty-cycling on transport %s...",
+                          pGnssTestPrivateTransportTypeName(transportTypes[x]));
+        U_PORT_TEST_ASSERT(uGnssTestPrivatePreamble(U_CFG_TEST_GNSS_MODULE_TYPE,
+                                                    transportTypes[x], &gHandles, false,
+                                                    U_CFG_APP_CELL_PIN_GNSS_POWER,
+                                                    U_CFG_APP_CELL_PIN_GNSS_DATA_READY) == 0);
+        gnssHandle = gHandles.gnssHandle;
+
+        U_PORT_TEST_ASSERT(uGnssPwrDutyCycleInit(&dutyCycle, &cfg) == 0);
+        U_PORT_TEST_ASSERT(uGnssPwrDutyCycleGetWaitMs(&dutyCycle) == 0);
+        U_PORT_TEST_ASSERT(uGnssPwrDutyCycleGetStat(&dutyCycle, &stat) == 0);
+        U_PORT_TEST_ASSERT((stat.numFixes == 0) && (stat.numFailures == 0));
+        U_PORT_TEST_ASSERT(stat.onTimePerFixMs < 0);
+
+        for (size_t z = 0; z < U_GNSS_PWR_TEST_DUTY_CYCLE_NUM_FIXES; z++) {
+            y = uGnssPwrDutyCycleGetWaitMs(&dutyCycle);
+            U_PORT_TEST_ASSERT((y >= 0) && (y <= U_GNSS_PWR_TEST_DUTY_CYCLE_INTERVAL_SECONDS * 1000));
+            U_TEST_PRINT_LINE("waiting %d ms for fix %d.", y, z + 1);
+            uPortTaskBlock(y);
+            y = uGnssPwrDutyCycleFix(gnssHandle, &dutyCycle, &latitudeX1e7,
+                                     &longitudeX1e7, NULL, &radiusMillimetres,
+                                     NULL, NULL);
+            U_PORT_TEST_ASSERT(uGnssPwrDutyCycleGetStat(&dutyCycle, &stat) == 0);
+            U_TEST_PRINT_LINE("fix %d returned %d after an on-time of %d ms, radius %d mm.",
+                              z + 1, y, stat.onTimeLastMs, radiusMillimetres);
+            U_PORT_TEST_ASSERT(y == 0);
+            U_PORT_TEST_ASSERT(stat.onTimeLastMs >= 0);
+        }
+
+        U_PORT_TEST_ASSERT(uGnssPwrDutyCycleGetStat(&dutyCycle, &stat) == 0);
+        U_TEST_PRINT_LINE("%d fix(es), %d failure(s), on-time total %d ms, max %d ms,"
+                          " per fix %d ms.", stat.numFixes, stat.numFailures,
+                          (int32_t) stat.onTimeTotalMs, stat.onTimeMaxMs,
+                          stat.onTimePerFixMs);
+        U_PORT_TEST_ASSERT(stat.numFixes == U_GNSS_PWR_TEST_DUTY_CYCLE_NUM_FIXES);
+        U_PORT_TEST_ASSERT(stat.numFailures == 0);
+        U_PORT_TEST_ASSERT(stat.onTimeTotalMs >= stat.onTimeMaxMs);
+        U_PORT_TEST_ASSERT(stat.onTimeMaxMs >= stat.onTimeLastMs);
+        U_PORT_TEST_ASSERT(stat.onTimePerFixMs == (int32_t) (stat.onTimeTotalMs / stat.numFixes));
+
+        // Check that we haven't dropped any incoming data
+        y = uGnssMsgReceiveStatStreamLoss(gnssHandle);
+        U_TEST_PRINT_LINE("%d byte(s) lost from the message stream during that test.", y);
+        U_PORT_TEST_ASSERT(y == 0);
+
+        // Do the standard postamble
+        uGnssTestPrivatePostamble(&gHandles, false);
+    }
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Clean-up to be run at the end of this round of tests, just
  * in case there were test failures which would have resulted
  * in the deinitialisation being skipped.
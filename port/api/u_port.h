@@ -80,6 +80,18 @@ extern "C" {
     }                                                                   \
 }
 
+#ifndef U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS
+/** Where working out the timezone offset is costly, e.g. on Linux
+ * and Windows, where mktime() consults the timezone database each
+ * time, uPortGetTimezoneOffsetSeconds() keeps the offset it last
+ * worked out for the rest of the period of UTC time, of this many
+ * seconds and aligned to a multiple of it, in which it was worked
+ * out; daylight saving changes fall on such a boundary.  Set this
+ * to 0 to work the offset out afresh on every call.
+ */
+# define U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS 900
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -143,6 +155,19 @@ void uPortDeinit();
  */
 int32_t uPortGetTickTimeMs();
 
+/** Get a monotonic time in microseconds, for measuring how long
+ * things take.  Like uPortGetTickTimeMs() this is unaffected by
+ * any time setting activity and is NOT maintained while the
+ * processor is in deep sleep.  The resolution depends on the
+ * platform: it is at least as good as that of uPortGetTickTimeMs()
+ * and usually very much better but, on some platforms, this may
+ * only be a microsecond representation of that time; see the
+ * implementation for your platform.
+ *
+ * @return the current time in microseconds.
+ */
+int64_t uPortGetTickTimeUs();
+
 /** Get the heap high watermark, the minimum amount of heap
  * free, ever.
  *
@@ -204,7 +229,8 @@ void uPortExitCritical();
  * It is ONLY a requirement that this API is implemented if the
  * underlying system allows a non-zero timezone to be set: where it is
  * not implemented zero will be returned by a weakly-linked default
- * function.
+ * function.  The result may be cached, see
+ * #U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS.
  *
  * @return the current timezone offset in seconds.
  */
@@ -56,6 +56,33 @@ extern "C" {
  * FUNCTIONS
  * -------------------------------------------------------------- */
 
+/** Perform a CRC calculation on a block of data with a hardware
+ * CRC peripheral: the CRC is not reflected (i.e. it is MSB first)
+ * and no final XOR is applied.  The SPARTN CRC functions call this
+ * if U_SPARTN_CRC_USE_PORT_CRYPTO is defined.  This function is
+ * NOT mapped to mbedTLS: a default #U_WEAK implementation, provided
+ * in u_port_crypto_crc.c, returns #U_ERROR_COMMON_NOT_SUPPORTED; if
+ * your platform has a CRC peripheral you may implement it yourself.
+ * An implementation must be thread-safe.
+ *
+ * @param polynomial   the polynomial, without the top bit, e.g.
+ *                     0x04C11DB7 for CRC32.
+ * @param widthBits    the width of the CRC in bits, up to 32.
+ * @param initialValue the initial value of the CRC.
+ * @param[in] pData    a pointer to the data; cannot be NULL unless
+ *                     size is zero.
+ * @param size         the number of bytes at pData.
+ * @param[out] pCrc    a place to put the CRC, right-aligned; cannot
+ *                     be NULL.
+ * @return             zero on success, #U_ERROR_COMMON_NOT_SUPPORTED
+ *                     if the given CRC cannot be performed in hardware,
+ *                     else negative error code from the U_ERROR_COMMON_xxx
+ *                     enumeration.
+ */
+int32_t uPortCryptoCrc(uint32_t polynomial, size_t widthBits,
+                       uint32_t initialValue, const char *pData,
+                       size_t size, uint32_t *pCrc);
+
 /** Perform a SHA256 calculation on a block of data.
  *
  * @param pInput           a pointer to the input data; cannot be
@@ -22,6 +22,9 @@
  * of another module should be included here; otherwise
  * please keep #includes to your .c files. */
 
+#include "stdbool.h"
+#include "stdarg.h" // va_list, for uPortLogAsyncWrite()
+
 /** \addtogroup __port
  *  @{
  */
@@ -49,6 +52,44 @@ extern "C" {
 # define uPortLog(...)
 #endif
 
+#ifndef U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES
+/** The size of the buffer that log prints are written into while
+ * asynchronous logging is on, see uPortLogAsyncStart(); must be
+ * a power of two.
+ */
+# define U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES 4096
+#endif
+
+#ifndef U_PORT_LOG_ASYNC_MAX_LENGTH_BYTES
+/** The longest single log print while asynchronous logging is on,
+ * not including the null terminator; longer prints are truncated.
+ * Must be less than half of #U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES.
+ */
+# define U_PORT_LOG_ASYNC_MAX_LENGTH_BYTES 256
+#endif
+
+#ifndef U_PORT_LOG_ASYNC_TASK_STACK_SIZE_BYTES
+/** The stack size of the task that writes out log prints while
+ * asynchronous logging is on.
+ */
+# define U_PORT_LOG_ASYNC_TASK_STACK_SIZE_BYTES (1024 * 2)
+#endif
+
+#ifndef U_PORT_LOG_ASYNC_TASK_PRIORITY
+/** The priority of the task that writes out log prints while
+ * asynchronous logging is on: low, so that it gets on with it
+ * when nothing more important is going on.
+ */
+# define U_PORT_LOG_ASYNC_TASK_PRIORITY (U_CFG_OS_PRIORITY_MIN + 1)
+#endif
+
+#ifndef U_PORT_LOG_ASYNC_FLUSH_INTERVAL_MS
+/** How often the task that writes out log prints checks for more
+ * while asynchronous logging is on, in case it was not woken up.
+ */
+# define U_PORT_LOG_ASYNC_FLUSH_INTERVAL_MS 100
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -82,10 +123,66 @@ int32_t uPortLogOff(void);
  */
 int32_t uPortLogOn(void);
 
+/** Switch asynchronous logging on: from now on uPortLogF() formats
+ * each print into a buffer of #U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES,
+ * without waiting on a lock, and a background task writes the
+ * buffer out in the way the platform usually would.  The time
+ * taken by a print is then that of formatting it, rather than of
+ * getting it out of the device, so that switching prints on, e.g.
+ * with uAtClientPrintAtSet(), does not alter the timing of what is
+ * being printed.  If the buffer is full the print is dropped and
+ * counted, see uPortLogAsyncGetDropCount(); the background task
+ * also prints a note saying how many were dropped.
+ * Does nothing if asynchronous logging is already on.
+ *
+ * @return zero on success else negative error code.
+ */
+int32_t uPortLogAsyncStart(void);
+
+/** Switch asynchronous logging off, writing out everything
+ * that is in the buffer first; uPortLogF() goes back to writing
+ * prints directly.
+ */
+void uPortLogAsyncStop(void);
+
+/** Get the number of log prints that have been dropped since
+ * uPortLogAsyncStart() was called because the buffer was full.
+ *
+ * @return the number of log prints dropped.
+ */
+int32_t uPortLogAsyncGetDropCount(void);
+
+/** Called by the platform implementation of uPortLogF() before it
+ * writes anything: if asynchronous logging is on this takes the
+ * print, and it should not then be written by uPortLogF().  Not
+ * intended to be called by the application.
+ *
+ * @param[in] pFormat the printf() style format string.
+ * @param args        the arguments for pFormat.
+ * @return            true if the print has been dealt with.
+ */
+bool uPortLogAsyncWrite(const char *pFormat, va_list args);
+
 #ifdef __cplusplus
 }
 #endif
 
+/* ----------------------------------------------------------------
+ * INCLUDE FOR U_CFG_LOG_RAM_TRACE
+ * -------------------------------------------------------------- */
+
+/* This is included down here as the trace points in the ubxlib
+ * code are brought in through this header, which all of that code
+ * includes; without U_CFG_LOG_RAM_TRACE they compile to nothing.
+ */
+#ifdef U_CFG_LOG_RAM_TRACE
+# include "u_log_ram.h"
+#else
+# define U_LOG_RAM_TRACE(event, parameter)
+# define U_LOG_RAM_TRACE_BEGIN(event, parameter)
+# define U_LOG_RAM_TRACE_END(event, parameter)
+#endif
+
 /** @}*/
 
 #endif // _U_PORT_DEBUG_H_
@@ -82,6 +82,9 @@
  * where `myFunction()` will be invoked with it. This may be
  * repeated as necessary. `uPortEventQueueSendIrq()` is
  * a version which is safe to call from an interrupt.
+ * `uPortEventQueueSendPriority()` is a version which lets a
+ * time-critical event jump ahead of those already waiting on
+ * the queue.
  *
  * `uPortEventQueueClose()` shuts down the queue and deletes
  * the task.  This is a cooperative process: your function
@@ -124,10 +127,66 @@ extern "C" {
                            U_PORT_EVENT_QUEUE_MAX_PARAM_LENGTH_BYTES
 #endif
 
+#ifndef U_PORT_EVENT_QUEUE_POOL_NUM_TASKS
+/** Normally each event queue has a task, and hence a stack, of its
+ * own.  If this is set to a value greater than zero then instead
+ * the event queues share a pool of this many tasks, saving both
+ * tasks and RAM: the events of any one event queue are still
+ * handled in order, one at a time.  An event queue which asks
+ * for more stack than #U_PORT_EVENT_QUEUE_POOL_TASK_STACK_SIZE_BYTES
+ * still gets a task of its own.
+ *
+ * Note that the pool must have more tasks than there are event
+ * queues whose functions block waiting for something that needs
+ * an event on another event queue to be handled, otherwise all of
+ * the tasks in the pool may end up waiting.
+ */
+# define U_PORT_EVENT_QUEUE_POOL_NUM_TASKS 0
+#endif
+
+#ifndef U_PORT_EVENT_QUEUE_POOL_TASK_STACK_SIZE_BYTES
+/** The stack size of each of the tasks in the pool, see
+ * #U_PORT_EVENT_QUEUE_POOL_NUM_TASKS.
+ */
+# define U_PORT_EVENT_QUEUE_POOL_TASK_STACK_SIZE_BYTES (1024 * 3)
+#endif
+
+#ifndef U_PORT_EVENT_QUEUE_POOL_TASK_PRIORITY
+/** The priority of the tasks in the pool, see
+ * #U_PORT_EVENT_QUEUE_POOL_NUM_TASKS; the priority given to
+ * uPortEventQueueOpen() is ignored if the pool is used.
+ */
+# define U_PORT_EVENT_QUEUE_POOL_TASK_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
+#endif
+
+#ifndef U_PORT_EVENT_QUEUE_POOL_MAX_EVENTS_PER_TURN
+/** The number of events of one event queue that a task in the
+ * pool will handle before moving on to the next event queue
+ * that has events waiting, see #U_PORT_EVENT_QUEUE_POOL_NUM_TASKS.
+ */
+# define U_PORT_EVENT_QUEUE_POOL_MAX_EVENTS_PER_TURN 4
+#endif
+
+#ifndef U_PORT_EVENT_QUEUE_HIGH_PRIORITY_QUEUE_LENGTH
+/** The number of high priority events, see
+ * uPortEventQueueSendPriority(), that may be waiting on an
+ * event queue; the memory for these is only allocated once
+ * the first high priority event is sent.
+ */
+# define U_PORT_EVENT_QUEUE_HIGH_PRIORITY_QUEUE_LENGTH 4
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The priority of an event sent with uPortEventQueueSendPriority().
+ */
+typedef enum {
+    U_PORT_EVENT_QUEUE_PRIORITY_NORMAL = 0, /**< in order with all other events. */
+    U_PORT_EVENT_QUEUE_PRIORITY_HIGH = 1    /**< ahead of normal priority events. */
+} uPortEventQueuePriority_t;
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -196,9 +255,11 @@ int32_t uPortEventQueueOpen(void (*pFunction) (void *, size_t),
                             size_t queueLength);
 
 /** Send to an event queue.  The data at pParam will be copied
- * onto the queue.  If the queue is full this function will block
- * until room is available.  An event queue should not be closed
- * while this function is in progress.
+ * onto the queue; no heap memory is used in doing so.  For large
+ * parameter blocks consider uPortEventQueueSendPointer().  If
+ * the queue is full this function will block until room is
+ * available.  An event queue should not be closed while this
+ * function is in progress.
  *
  * @param handle            the handle for the event queue.
  * @param[in] pParam        a pointer to the parameters structure
@@ -213,11 +274,69 @@ int32_t uPortEventQueueOpen(void (*pFunction) (void *, size_t),
 int32_t uPortEventQueueSend(int32_t handle, const void *pParam,
                             size_t paramLengthBytes);
 
+/** Send to an event queue with a priority.  This is the same as
+ * uPortEventQueueSend() except that an event sent with
+ * #U_PORT_EVENT_QUEUE_PRIORITY_HIGH will be handled before any
+ * normal priority events that are waiting on the queue, e.g. so
+ * that a time pulse is not held up behind a backlog of received
+ * data; high priority events are handled in the order they were
+ * sent.  If #U_PORT_EVENT_QUEUE_HIGH_PRIORITY_QUEUE_LENGTH high
+ * priority events are already waiting this function will block
+ * until room is available.  There is no interrupt version of
+ * this function.
+ *
+ * @param handle            the handle for the event queue.
+ * @param[in] pParam        a pointer to the parameters structure
+ *                          to send.  May be NULL, in which case
+ *                          paramLengthBytes must be zero.
+ * @param paramLengthBytes  the length of the parameters
+ *                          structure.  Must be less than or
+ *                          equal to paramMaxLengthBytes as
+ *                          given to uPortEventQueueOpen().
+ * @param priority          the priority of the event.
+ * @return                  zero on success else negative error code.
+ */
+int32_t uPortEventQueueSendPriority(int32_t handle, const void *pParam,
+                                    size_t paramLengthBytes,
+                                    uPortEventQueuePriority_t priority);
+
+/** Send a pointer to a parameter block to an event queue: rather
+ * than the parameter block being copied onto the queue, as
+ * uPortEventQueueSend() does, only the pointer is, hence the
+ * parameter block may be of any size, it need not fit within
+ * the paramMaxLengthBytes given to uPortEventQueueOpen().  The
+ * event queue function will be called with pParam and
+ * paramLengthBytes, after which pRelease, if not NULL, will be
+ * called with pParam, e.g. to free it or return it to a pool;
+ * until then the parameter block must remain valid.  If the
+ * queue is full this function will block until room is available.
+ * If an error is returned the caller retains ownership of the
+ * parameter block and pRelease will not be called.  An event
+ * queue should not be closed while this function is in progress.
+ *
+ * @param handle            the handle for the event queue.
+ * @param[in] pParam        a pointer to the parameters structure
+ *                          to pass to the event queue function.
+ *                          May be NULL, in which case
+ *                          paramLengthBytes must be zero.
+ * @param paramLengthBytes  the length of the parameters
+ *                          structure.
+ * @param[in] pRelease      the function to call with pParam once
+ *                          the event queue function has returned;
+ *                          may be NULL.
+ * @return                  zero on success else negative error code.
+ */
+int32_t uPortEventQueueSendPointer(int32_t handle, void *pParam,
+                                   size_t paramLengthBytes,
+                                   void (*pRelease)(void *));
+
 /** Send to an event queue from an interrupt.  The data at
  * pParam will be copied onto the queue.  If the queue is full
  * the event will not be sent and an error will be returned.
  * Note: you must ensure that your interrupt stack is large
- * enough to hold an array of size paramLengthBytes +
+ * enough to hold an array of size paramMaxLengthBytes, as
+ * given to uPortEventQueueOpen(), or three pointers,
+ * whichever is the larger, plus
  * #U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES. An event
  * queue should not be closed while this function is in
  * progress.
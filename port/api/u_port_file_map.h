@@ -0,0 +1,85 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_PORT_FILE_MAP_H_
+#define _U_PORT_FILE_MAP_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup __port __Port
+ *  @{
+ */
+
+/** @file
+ * @brief Memory-mapped file API: allows a large buffer, e.g. the
+ * linear buffer underneath a ring buffer (see u_ringbuffer.h), to
+ * be backed by a file rather than by RAM.  Only the Linux and
+ * Windows platforms, which have a file system and virtual memory,
+ * implement this API; it is not available on MCU platforms.
+ * These functions are thread-safe.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Create a file of the given size, replacing any existing file of
+ * that name, and map it into memory for reading and writing.  The
+ * contents of the memory are initially zero; the operating system
+ * writes them back to the file as it sees fit, so that only the
+ * parts of the buffer in use occupy RAM.
+ *
+ * @param[in] pPath  the path of the file, cannot be NULL.
+ * @param sizeBytes  the size of the file and of the mapping in bytes,
+ *                   must be greater than zero.
+ * @return           a pointer to the mapped memory, or NULL on
+ *                   failure.
+ */
+void *pUPortFileMap(const char *pPath, size_t sizeBytes);
+
+/** Unmap memory returned by pUPortFileMap(); the file itself is
+ * left in place.
+ *
+ * @param[in] pMap   the pointer returned by pUPortFileMap(); may be
+ *                   NULL, in which case nothing is done.
+ * @param sizeBytes  the sizeBytes that was passed to pUPortFileMap().
+ */
+void uPortFileUnmap(void *pMap, size_t sizeBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_PORT_FILE_MAP_H_
+
+// End of file
@@ -38,6 +38,14 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_PORT_GATT_MAX_OUTSTANDING_NOTIFICATIONS
+/** The maximum number of notifications that uPortGattNotifyNoWait()
+ * will queue on one connection; this should not be more than the
+ * number of transmit buffers the BLE stack has.
+ */
+# define U_PORT_GATT_MAX_OUTSTANDING_NOTIFICATIONS 3
+#endif
+
 // ATT permissions
 #define U_PORT_GATT_ATT_PERM_READ          0x01
 #define U_PORT_GATT_ATT_PERM_WRITE         0x02
@@ -419,6 +427,44 @@ int32_t uPortGattGetMtu(int32_t connHandle);
 int32_t uPortGattExchangeMtu(int32_t connHandle,
                              mtuXchangeRespCallback_t respCallback);
 
+/** Request the link layer of a connection to use Data Length
+ * Extension, i.e. to put up to txOctets of payload in one link
+ * layer packet rather than the default 27; the outcome depends on
+ * the remote device, the request completes in the background.
+ *
+ * @param connHandle connection handle.
+ * @param txOctets   the maximum link layer payload length to
+ *                   request, 27 to 251.
+ * @return           zero on success else negative error code.
+ */
+int32_t uPortGattRequestDataLength(int32_t connHandle, uint16_t txOctets);
+
+/** Request that a connection moves to the 2 Mbit/s PHY in both
+ * directions; the outcome depends on the remote device, the request
+ * completes in the background.
+ *
+ * @param connHandle connection handle.
+ * @return           zero on success else negative error code.
+ */
+int32_t uPortGattRequestPhy2M(int32_t connHandle);
+
+/** Request new connection parameters for an existing connection;
+ * the outcome depends on the remote device, the request completes
+ * in the background.
+ *
+ * @param connHandle      connection handle.
+ * @param connIntervalMin connection interval (N*1.25 ms).
+ * @param connIntervalMax connection interval (N*1.25 ms).
+ * @param connLatency     connection latency, nbr of connection intervals.
+ * @param linkLossTimeout link loss timeout in ms.
+ * @return                zero on success else negative error code.
+ */
+int32_t uPortGattUpdateConnParams(int32_t connHandle,
+                                  uint16_t connIntervalMin,
+                                  uint16_t connIntervalMax,
+                                  uint16_t connLatency,
+                                  uint32_t linkLossTimeout);
+
 /** Send characteristic notification.
  *
  * @param connHandle     connection handle.
@@ -430,6 +476,36 @@ int32_t uPortGattNotify(int32_t connHandle,
                         const uPortGattCharacteristic_t *pChar,
                         const void *data, uint16_t len);
 
+/** Send characteristic notification without waiting: the data is
+ * copied and queued for sending, so that several notifications may
+ * go out in the same connection event.  At most
+ * #U_PORT_GATT_MAX_OUTSTANDING_NOTIFICATIONS may be queued on a
+ * connection; when that many are queued use
+ * uPortGattNotifyWaitSlot() to wait for one to be sent.
+ *
+ * @param connHandle     connection handle.
+ * @param[in] pChar      pointer to characteristic.
+ * @param[in] data       pointer to notification data to send.
+ * @param len            length of data to send.
+ * @return               zero on success, #U_ERROR_COMMON_BUSY if
+ *                       the maximum number of notifications is
+ *                       already queued, else negative error code.
+ */
+int32_t uPortGattNotifyNoWait(int32_t connHandle,
+                              const uPortGattCharacteristic_t *pChar,
+                              const void *data, uint16_t len);
+
+/** Wait until uPortGattNotifyNoWait() is able to queue another
+ * notification on a connection.
+ *
+ * @param connHandle  connection handle.
+ * @param timeoutMs   the maximum time to wait in milliseconds.
+ * @return            zero on success, #U_ERROR_COMMON_TIMEOUT if
+ *                    no notification was sent in time, else
+ *                    negative error code.
+ */
+int32_t uPortGattNotifyWaitSlot(int32_t connHandle, int32_t timeoutMs);
+
 /** Connect GAP.
  *
  * @param[in] pAddress    pointer to array with address (6 bytes).
@@ -83,6 +83,25 @@ typedef enum {
     MAX_NUM_U_PORT_GPIO_DRIVE_CAPABILITIES
 } uPortGpioDriveCapability_t;
 
+/** The edges on which a GPIO interrupt may be triggered.
+ */
+typedef enum {
+    U_PORT_GPIO_INTERRUPT_EDGE_RISING,
+    U_PORT_GPIO_INTERRUPT_EDGE_FALLING,
+    U_PORT_GPIO_INTERRUPT_EDGE_BOTH,
+    MAX_NUM_U_PORT_GPIO_INTERRUPT_EDGES
+} uPortGpioInterruptEdge_t;
+
+/** Callback type for uPortGpioInterruptSet(); note that this is
+ * called from interrupt context and hence must be brief and may only
+ * call operating system functions that are interrupt-safe, e.g.
+ * uPortSemaphoreGiveIrq() or uPortQueueSendIrq().
+ *
+ * @param pin    the pin that triggered the interrupt.
+ * @param pParam the pParam that was passed to uPortGpioInterruptSet().
+ */
+typedef void (uPortGpioInterruptCallback_t)(int32_t pin, void *pParam);
+
 /** GPIO configuration structure.
  * If you update this, don't forget to update
  * #U_PORT_GPIO_CONFIG_DEFAULT and
@@ -168,6 +187,31 @@ int32_t uPortGpioSet(int32_t pin, int32_t level);
  */
 int32_t uPortGpioGet(int32_t pin);
 
+/** Set, or remove, an interrupt on a GPIO pin, which should already
+ * have been configured as an input with uPortGpioConfig().  Only one
+ * callback may be set per pin: setting a new one replaces the old.
+ *
+ * You do not need to implement this function: where it is not
+ * implemented a #U_WEAK implementation provided in
+ * u_port_gpio_interrupt.c will return #U_ERROR_COMMON_NOT_SUPPORTED,
+ * in which case the caller should fall back to polling the pin with
+ * uPortGpioGet().
+ *
+ * @param pin           the pin, a positive integer.
+ * @param edge          the edge on which the interrupt should trigger.
+ * @param[in] pCallback the callback to be called, from interrupt
+ *                      context, when the interrupt triggers; use NULL
+ *                      to remove an interrupt that was previously set,
+ *                      in which case edge is ignored and, on return,
+ *                      the callback will not be called again.
+ * @param[in] pParam    a parameter that will be passed to pCallback;
+ *                      may be NULL.
+ * @return              zero on success else negative error code.
+ */
+int32_t uPortGpioInterruptSet(int32_t pin, uPortGpioInterruptEdge_t edge,
+                              uPortGpioInterruptCallback_t *pCallback,
+                              void *pParam);
+
 #ifdef __cplusplus
 }
 #endif
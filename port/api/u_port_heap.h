@@ -42,6 +42,21 @@
  * they can be printed with uPortHeapDump().  Note that monitoring
  * will require at least 28 additional bytes of heap storage per
  * heap allocation.
+ *
+ * Since heap monitoring is too heavy for a field build, a lighter
+ * alternative is to define U_CFG_HEAP_PROFILE (not at the same time
+ * as U_CFG_HEAP_MONITOR): one in U_PORT_HEAP_PROFILE_SAMPLE_EVERY
+ * (see u_port_heap.c) allocations is then counted against its call
+ * site, adding no heap storage; the counts can be read out in a
+ * compact binary form with uPortHeapProfileDump().
+ *
+ * To see how much RAM each part of ubxlib is holding, define
+ * U_CFG_HEAP_BUDGET (again not at the same time as either of the
+ * above): each allocation is then tagged with the subsystem whose
+ * source file made it, see #uPortHeapTag_t, and the live and peak
+ * bytes per tag can be read with uPortHeapBudgetGet().  This adds
+ * #U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES of heap storage to each
+ * heap allocation.
  */
 
 #ifdef __cplusplus
@@ -52,15 +67,44 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The number of bytes added to the front of each heap allocation
+ * when U_CFG_HEAP_BUDGET is defined, enough to keep the memory
+ * returned aligned for the worst-case structure type.
+ */
+#define U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES 16
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The subsystems that heap allocations are accounted against when
+ * U_CFG_HEAP_BUDGET is defined.  The tag is worked out from the path
+ * of the source file that called pUPortMalloc(): for instance
+ * cell/src/u_cell_sock.c counts as #U_PORT_HEAP_TAG_SOCK, while
+ * cell/src/u_cell_net.c counts as #U_PORT_HEAP_TAG_CELL.
+ */
+typedef enum {
+    U_PORT_HEAP_TAG_OTHER,       /**< port, device, network, application, etc. */
+    U_PORT_HEAP_TAG_AT_CLIENT,   /**< common/at_client. */
+    U_PORT_HEAP_TAG_CELL,        /**< cell, other than the below. */
+    U_PORT_HEAP_TAG_GNSS,        /**< gnss. */
+    U_PORT_HEAP_TAG_SHORT_RANGE, /**< common/short_range, ble and wifi,
+                                      other than the below. */
+    U_PORT_HEAP_TAG_SOCK,        /**< common/sock and the cell/wifi
+                                      socket code. */
+    U_PORT_HEAP_TAG_MQTT,        /**< common/mqtt_client and the
+                                      cell/wifi MQTT code. */
+    U_PORT_HEAP_TAG_LOCATION,    /**< common/location and cell
+                                      locate. */
+    U_PORT_HEAP_TAG_MAX_NUM
+} uPortHeapTag_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
 
-#ifndef U_CFG_HEAP_MONITOR
+#if !defined(U_CFG_HEAP_MONITOR) && !defined(U_CFG_HEAP_PROFILE) && \
+    !defined(U_CFG_HEAP_BUDGET)
 /** Allocate memory: does whatever malloc() does on your platform,
  * which should be to return a pointer to a block of heap memory
  * of at least the requested size, aligned for the worst-case
@@ -73,7 +117,7 @@ extern "C" {
  *                  alignment, else NULL.
  */
 void *pUPortMalloc(size_t sizeBytes);
-#else
+#elif defined(U_CFG_HEAP_MONITOR)
 /** For heap monitoring, pUPortMalloc() becomes a macro so that we
  * get to trap the file/line and add our structure in
  * pUPortMallocMonitor() before, internally, calling pUPortMalloc().
@@ -95,6 +139,47 @@ void *pUPortMalloc(size_t sizeBytes);
  */
 void *pUPortMallocMonitor(size_t sizeBytes, const char *pFile,
                           int32_t line);
+#elif defined(U_CFG_HEAP_PROFILE)
+/** For heap profiling, pUPortMalloc() becomes a macro so that we
+ * get to trap the file/line in pUPortMallocProfile() before,
+ * internally, calling pUPortMalloc().
+ */
+# define pUPortMalloc(sizeBytes) pUPortMallocProfile(sizeBytes, __FILE__, __LINE__)
+
+/** Allocate memory, sampling the call site along the way: this
+ * should NOT be called directly, it is called through the
+ * pUPortMalloc() macro when U_CFG_HEAP_PROFILE is defined.
+ *
+ * @param sizeBytes the amount of memory required in bytes.
+ * @param[in] pFile the name of the file that the calling
+ *                  function is in.
+ * @param line      the line in pFile that is calling this
+ *                  function.
+ * @return          a pointer to at least sizeBytes of memory,
+ *                  aligned for the worst-case structure-type
+ *                  alignment, else NULL.
+ */
+void *pUPortMallocProfile(size_t sizeBytes, const char *pFile,
+                          int32_t line);
+#else
+/** For heap budget accounting, pUPortMalloc() becomes a macro so
+ * that we get to trap the file in pUPortMallocBudget() before,
+ * internally, calling pUPortMalloc().
+ */
+# define pUPortMalloc(sizeBytes) pUPortMallocBudget(sizeBytes, __FILE__)
+
+/** Allocate memory, accounting it against the subsystem of the
+ * caller: this should NOT be called directly, it is called through
+ * the pUPortMalloc() macro when U_CFG_HEAP_BUDGET is defined.
+ *
+ * @param sizeBytes the amount of memory required in bytes.
+ * @param[in] pFile the name of the file that the calling
+ *                  function is in.
+ * @return          a pointer to at least sizeBytes of memory,
+ *                  aligned for the worst-case structure-type
+ *                  alignment, else NULL.
+ */
+void *pUPortMallocBudget(size_t sizeBytes, const char *pFile);
 #endif
 
 /** Free memory that was allocated by pUPortMalloc(); does whatever
@@ -152,9 +237,83 @@ int32_t uPortHeapPerpetualAllocCount();
  */
 int32_t uPortHeapDump(const char *pPrefix);
 
+/** Write out the heap profile in binary form; only useful if
+ * U_CFG_HEAP_PROFILE is defined.  All values are little-endian
+ * and the output begins with a 16 byte header:
+ *
+ * - the characters 'H', 'P',
+ * - a uint8_t version number, currently 1,
+ * - a uint8_t count of the records that follow,
+ * - a uint32_t: one in this many allocations is sampled,
+ * - a uint32_t: the number of allocations made,
+ * - a uint32_t: the number of samples not counted because the
+ *   table of call sites was full,
+ *
+ * ...followed by a 16 byte record for each call site:
+ *
+ * - a uint32_t: the 32-bit FNV-1a hash of the __FILE__ string of
+ *   the call site,
+ * - a uint32_t: the __LINE__ of the call site,
+ * - a uint32_t: the number of sampled allocations,
+ * - a uint32_t: the total size in bytes of the sampled allocations.
+ *
+ * Multiply the sampled counts by the sampling rate to estimate
+ * the whole.  A given call site may appear more than once, e.g.
+ * where it is in a header file included in several places; the
+ * records are then simply added together.
+ *
+ * @param[out] pBuffer  a place to put the output; use NULL to find
+ *                      out how much space is needed.
+ * @param sizeBytes     the amount of storage at pBuffer; if this is
+ *                      too small for all of the records then only
+ *                      as many as will fit are written.
+ * @return              the number of bytes written (or, if pBuffer
+ *                      is NULL, that would be written), else negative
+ *                      error code; #U_ERROR_COMMON_NOT_SUPPORTED
+ *                      is returned if U_CFG_HEAP_PROFILE is not
+ *                      defined.
+ */
+int32_t uPortHeapProfileDump(char *pBuffer, size_t sizeBytes);
+
+/** Reset the heap profile; only useful if U_CFG_HEAP_PROFILE is
+ * defined.
+ */
+void uPortHeapProfileReset();
+
+/** Get the heap currently held by, and the most ever held by, a
+ * subsystem; only useful if U_CFG_HEAP_BUDGET is defined.  The
+ * figures are what the callers asked for, they do not include
+ * #U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES or any overhead of malloc().
+ *
+ * @param tag              the subsystem.
+ * @param[out] pLiveBytes  a place to put the number of bytes
+ *                         currently allocated by the subsystem;
+ *                         may be NULL.
+ * @param[out] pPeakBytes  a place to put the largest number of
+ *                         bytes the subsystem has had allocated
+ *                         since start-up or since
+ *                         uPortHeapBudgetReset() was last called;
+ *                         may be NULL.
+ * @return                 zero on success else negative error code;
+ *                         #U_ERROR_COMMON_NOT_SUPPORTED is returned
+ *                         if U_CFG_HEAP_BUDGET is not defined.
+ */
+int32_t uPortHeapBudgetGet(uPortHeapTag_t tag, size_t *pLiveBytes,
+                           size_t *pPeakBytes);
+
+/** Set the peak of each subsystem to its current live figure, so
+ * that the peak of a particular operation can be measured; only
+ * useful if U_CFG_HEAP_BUDGET is defined.
+ */
+void uPortHeapBudgetReset();
+
 /** Initialise heap monitoring: you do NOT need to call this, it
- * is called internally by the porting layer if U_CFG_HEAP_MONITOR
- * is defined.
+ * is called internally by the porting layer; it does nothing unless
+ * U_CFG_HEAP_MONITOR, U_CFG_HEAP_PROFILE or U_CFG_HEAP_BUDGET is
+ * defined or
+ * U_PORT_HEAP_POOL_BLOCKS_PER_CLASS (see u_port_heap.c) is greater
+ * than zero, in which case the pool of small blocks is also set up
+ * here.
  *
  * @param[in] pMutexCreate normally this will be NULL; it is only
  *                         provided for platforms where the
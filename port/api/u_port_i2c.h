@@ -33,6 +33,13 @@
  * to which they are tested; should you decide to use them to talk
  * with other I2C devices then it may be worth expanding the testing
  * also.
+ *
+ * In addition to the blocking functions, transactions may be queued
+ * with uPortI2cControllerSendReceiveAsync(); these are run, in order,
+ * by a task of the porting layer so that the caller is free to go
+ * about its business, and on platforms where the I2C driver is
+ * interrupt or DMA driven (ESP-IDF, Zephyr, NRF5SDK) the CPU is
+ * also free while the transaction is in progress.
  */
 
 #ifdef __cplusplus
@@ -56,10 +63,47 @@ extern "C" {
 # define U_PORT_I2C_TIMEOUT_MILLISECONDS 10
 #endif
 
+#ifndef U_PORT_I2C_ASYNC_QUEUE_LENGTH
+/** The number of transactions that may be queued with
+ * uPortI2cControllerSendReceiveAsync() before it blocks.
+ */
+# define U_PORT_I2C_ASYNC_QUEUE_LENGTH 8
+#endif
+
+#ifndef U_PORT_I2C_ASYNC_TASK_STACK_SIZE_BYTES
+/** The stack size of the task that runs the transactions queued
+ * by uPortI2cControllerSendReceiveAsync(); the callbacks are
+ * called from this task.
+ */
+# define U_PORT_I2C_ASYNC_TASK_STACK_SIZE_BYTES (1024 * 2)
+#endif
+
+#ifndef U_PORT_I2C_ASYNC_TASK_PRIORITY
+/** The priority of the task that runs the transactions queued
+ * by uPortI2cControllerSendReceiveAsync().
+ */
+# define U_PORT_I2C_ASYNC_TASK_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Callback type for uPortI2cControllerSendReceiveAsync().
+ *
+ * @param handle            the handle of the I2C instance.
+ * @param errorCodeOrLength what uPortI2cControllerSendReceive()
+ *                          returned for the transaction, or
+ *                          #U_ERROR_COMMON_CANCELLED if the
+ *                          transaction was not run because I2C
+ *                          was deinitialised.
+ * @param pCallbackParam    the pCallbackParam that was passed to
+ *                          uPortI2cControllerSendReceiveAsync().
+ */
+typedef void (uPortI2cTransactionCallback_t)(int32_t handle,
+                                             int32_t errorCodeOrLength,
+                                             void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -305,6 +349,57 @@ int32_t uPortI2cControllerSend(int32_t handle, uint16_t address,
                                const char *pSend, size_t bytesToSend,
                                bool noStop);
 
+/** Queue a transaction, exactly as would be performed by
+ * uPortI2cControllerSendReceive(), and return without waiting for
+ * it; the transactions are performed in the order they are queued
+ * and pCallback is called, in task context, when each one is
+ * complete.  The buffers at pSend and pReceive must remain valid
+ * until pCallback has been called.  If the queue is full, see
+ * #U_PORT_I2C_ASYNC_QUEUE_LENGTH, this function will block until
+ * there is room.
+ *
+ * If uPortI2cDeinit() is called while transactions are still queued,
+ * it will wait for the one in progress to complete and the callbacks
+ * of the others will be called with #U_ERROR_COMMON_CANCELLED.
+ *
+ * @param handle          the handle of the I2C instance.
+ * @param address         the I2C address, as for
+ *                        uPortI2cControllerSendReceive().
+ * @param pSend           a pointer to the data to send, use NULL
+ *                        if only receive is required.
+ * @param bytesToSend     the number of bytes to send, must be zero if
+ *                        pSend is NULL.
+ * @param pReceive        a pointer to a buffer in which to store
+ *                        received data; use NULL if only send is
+ *                        required.
+ * @param bytesToReceive  the size of buffer pointed to by pReceive,
+ *                        must be zero if pReceive is NULL.
+ * @param[in] pCallback   the callback to be called when the transaction
+ *                        is complete; may be NULL.
+ * @param pCallbackParam  a parameter that will be passed to pCallback;
+ *                        may be NULL.
+ * @return                zero if the transaction has been queued else
+ *                        negative error code.
+ */
+int32_t uPortI2cControllerSendReceiveAsync(int32_t handle, uint16_t address,
+                                           const char *pSend, size_t bytesToSend,
+                                           char *pReceive, size_t bytesToReceive,
+                                           uPortI2cTransactionCallback_t *pCallback,
+                                           void *pCallbackParam);
+
+/** Initialise asynchronous I2C transactions: you do NOT need to call
+ * this, it is called internally by uPortI2cInit().
+ *
+ * @return zero on success else negative error code.
+ */
+int32_t uPortI2cAsyncInit();
+
+/** Deinitialise asynchronous I2C transactions: you do NOT need to
+ * call this, it is called internally by uPortI2cDeinit() before the
+ * I2C instances are closed.
+ */
+void uPortI2cAsyncDeinit();
+
 /** Get the number of I2C interfaces currently open; this may be used
  * as a basic check for heap monitoring.
  *
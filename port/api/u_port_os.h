@@ -55,6 +55,106 @@ extern "C" {
  */
 #define U_PORT_EXECUTABLE_CHUNK_NO_FLAGS      0
 
+/* The macros below size the statically allocated OS resources used
+ * if U_PORT_OS_STATIC_ALLOCATION is defined, in which case, on the
+ * platforms that support it (ESP-IDF, nRF5 SDK and Zephyr), tasks,
+ * queues, mutexes and semaphores are created in memory reserved at
+ * build time instead of on the heap: creation is then quick and
+ * deterministic, the heap is not fragmented by the churn of
+ * resources being created and deleted and, should a table be too
+ * small, creation fails with #U_ERROR_COMMON_NO_MEMORY.  Task stacks
+ * and queue storage come in two sizes, small and large, and a
+ * resource is given the smallest free one that is big enough.
+ */
+
+#ifndef U_PORT_OS_STATIC_NUM_MUTEXES
+/** The number of mutexes available if U_PORT_OS_STATIC_ALLOCATION
+ * is defined.
+ */
+# define U_PORT_OS_STATIC_NUM_MUTEXES 40
+#endif
+
+#ifndef U_PORT_OS_STATIC_NUM_SEMAPHORES
+/** The number of semaphores available if U_PORT_OS_STATIC_ALLOCATION
+ * is defined.
+ */
+# define U_PORT_OS_STATIC_NUM_SEMAPHORES 16
+#endif
+
+#ifndef U_PORT_OS_STATIC_TASK_STACK_SMALL_SIZE_BYTES
+/** The size of a small task stack if U_PORT_OS_STATIC_ALLOCATION
+ * is defined.
+ */
+# define U_PORT_OS_STATIC_TASK_STACK_SMALL_SIZE_BYTES (1024 * 3)
+#endif
+
+#ifndef U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM
+/** The number of small task stacks if U_PORT_OS_STATIC_ALLOCATION
+ * is defined.
+ */
+# define U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM 6
+#endif
+
+#ifndef U_PORT_OS_STATIC_TASK_STACK_LARGE_SIZE_BYTES
+/** The size of a large task stack if U_PORT_OS_STATIC_ALLOCATION
+ * is defined; no task may have a bigger stack than this.
+ */
+# define U_PORT_OS_STATIC_TASK_STACK_LARGE_SIZE_BYTES (1024 * 6)
+#endif
+
+#ifndef U_PORT_OS_STATIC_TASK_STACK_LARGE_NUM
+/** The number of large task stacks if U_PORT_OS_STATIC_ALLOCATION
+ * is defined.
+ */
+# define U_PORT_OS_STATIC_TASK_STACK_LARGE_NUM 2
+#endif
+
+#ifndef U_PORT_OS_STATIC_QUEUE_SMALL_SIZE_BYTES
+/** The size of a small queue if U_PORT_OS_STATIC_ALLOCATION is
+ * defined: the length of a queue multiplied by its item size
+ * must fit.
+ */
+# define U_PORT_OS_STATIC_QUEUE_SMALL_SIZE_BYTES 256
+#endif
+
+#ifndef U_PORT_OS_STATIC_QUEUE_SMALL_NUM
+/** The number of small queues if U_PORT_OS_STATIC_ALLOCATION is
+ * defined.
+ */
+# define U_PORT_OS_STATIC_QUEUE_SMALL_NUM 16
+#endif
+
+#ifndef U_PORT_OS_STATIC_QUEUE_LARGE_SIZE_BYTES
+/** The size of a large queue if U_PORT_OS_STATIC_ALLOCATION is
+ * defined; no queue may be bigger than this.
+ */
+# define U_PORT_OS_STATIC_QUEUE_LARGE_SIZE_BYTES (1024 * 2)
+#endif
+
+#ifndef U_PORT_OS_STATIC_QUEUE_LARGE_NUM
+/** The number of large queues if U_PORT_OS_STATIC_ALLOCATION is
+ * defined.
+ */
+# define U_PORT_OS_STATIC_QUEUE_LARGE_NUM 6
+#endif
+
+#ifndef U_PORT_OS_TASK_NAME_MAX_LENGTH_BYTES
+/** The maximum length of the name of a task reported by
+ * uPortTaskInfoGet(), including the null terminator; longer
+ * names are truncated.
+ */
+# define U_PORT_OS_TASK_NAME_MAX_LENGTH_BYTES 16
+#endif
+
+#ifndef U_PORT_OS_TASK_INFO_MAX_NUM_TASKS
+/** The maximum number of tasks that uPortTaskInfoGet() can keep
+ * track of on platforms where the port layer has to remember the
+ * tasks it has created itself (FreeRTOS); tasks beyond this number
+ * still run but are not reported.
+ */
+# define U_PORT_OS_TASK_INFO_MAX_NUM_TASKS 32
+#endif
+
 #ifndef U_PORT_OS_DEBUG_PRINT_PREFIX
 /** The string to prefix all debug prints from this file with:
  * only used if U_PORT_OS_DEBUG_PRINT is defined.  Defining
@@ -201,6 +301,22 @@ typedef uint32_t uPortExeChunkFlags_t;
  */
 typedef void (pTimerCallback_t) (const uPortTimerHandle_t, void *);
 
+/** Information about a task created with uPortTaskCreate(), as
+ * returned by uPortTaskInfoGet().
+ */
+typedef struct {
+    uPortTaskHandle_t handle;
+    char name[U_PORT_OS_TASK_NAME_MAX_LENGTH_BYTES]; /**< null terminated,
+                                                          may be truncated. */
+    int32_t stackMinFreeBytes; /**< the minimum stack free over the lifetime
+                                    of the task, as uPortTaskStackMinFree(),
+                                    or negative error code if that is not
+                                    known on this platform. */
+    int64_t cpuTimeUs;         /**< the CPU time the task has used so far,
+                                    or negative error code if that is not
+                                    known on this platform. */
+} uPortTaskInfo_t;
+
 /** The possible types of OS resource.
  */
 typedef enum {
@@ -287,6 +403,35 @@ bool uPortTaskIsThis(const uPortTaskHandle_t taskHandle);
  */
 void uPortTaskBlock(int32_t delayMs);
 
+/** Block the current task until a time, for work that must be
+ * done periodically: unlike calling uPortTaskBlock() in a loop the
+ * period does not drift by the time taken to do the work, and there
+ * is only the one wake-up per period.  For example:
+ *
+ * ```
+ * int32_t wakeTimeMs = uPortGetTickTimeMs();
+ * while (keepGoing) {
+ *     doWork();
+ *     uPortTaskBlockUntil(&wakeTimeMs, 1000);
+ * }
+ * ```
+ *
+ * If the task is already more than a whole period late, e.g. because
+ * the work took a long time, this returns immediately and the period
+ * is restarted from now.
+ *
+ * @param[in,out] pWakeTimeMs a pointer to the time at which the task
+ *                            last woke, in the units of
+ *                            uPortGetTickTimeMs(); set it to
+ *                            uPortGetTickTimeMs() before the first
+ *                            call, it is updated by this function
+ *                            to the time at which the task wakes.
+ *                            Nothing happens if this is NULL.
+ * @param periodMs            the period in milliseconds; nothing
+ *                            happens if this is not positive.
+ */
+void uPortTaskBlockUntil(int32_t *pWakeTimeMs, int32_t periodMs);
+
 /** Get the stack high watermark, the minimum amount
  * of stack free, in bytes, for a given task.
  *
@@ -298,6 +443,28 @@ void uPortTaskBlock(int32_t delayMs);
  */
 int32_t uPortTaskStackMinFree(const uPortTaskHandle_t taskHandle);
 
+/** Get information about all of the tasks that have been created
+ * with uPortTaskCreate() and not yet deleted, in one go: handle,
+ * name, stack high watermark and CPU time used.  This is intended
+ * for monitoring the system as a whole; where a platform cannot
+ * provide one of the values, e.g. CPU time on a FreeRTOS platform
+ * without run-time stats enabled, that field is set to a negative
+ * error code.
+ * It is NOT a requirement that this API is implemented:
+ * where it is not implemented #U_ERROR_COMMON_NOT_SUPPORTED
+ * is returned.
+ *
+ * @param[out] pInfo  an array of maxNum entries to be filled in;
+ *                    may be NULL to just find out how many tasks
+ *                    there are.
+ * @param maxNum      the number of entries at pInfo.
+ * @return            on success the number of tasks, which may
+ *                    be more than maxNum (in which case only the
+ *                    first maxNum are written to pInfo), else
+ *                    negative error code.
+ */
+int32_t uPortTaskInfoGet(uPortTaskInfo_t *pInfo, size_t maxNum);
+
 /** Get the current task handle.
  * It is NOT a requirement that this API is implemented:
  * where it is not implemented #U_ERROR_COMMON_NOT_IMPLEMENTED
@@ -39,7 +39,8 @@
  * SPI devices then it may be worth expanding the testing also.
  *
  * Note also that the interface is blocking, 'cos that's all we
- * [currently] need.
+ * [currently] need, with the exception of the background reception
+ * offered by uPortSpiControllerReceiveAsyncStart().
  */
 
 #ifdef __cplusplus
@@ -50,10 +51,37 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_PORT_SPI_RECEIVE_ASYNC_TASK_STACK_SIZE_BYTES
+/** The stack size of the task that a platform may use to run
+ * background reception begun by uPortSpiControllerReceiveAsyncStart();
+ * the callback is called from this task.
+ */
+# define U_PORT_SPI_RECEIVE_ASYNC_TASK_STACK_SIZE_BYTES (1024 * 3)
+#endif
+
+#ifndef U_PORT_SPI_RECEIVE_ASYNC_TASK_PRIORITY
+/** The priority of the task that a platform may use to run
+ * background reception begun by uPortSpiControllerReceiveAsyncStart().
+ */
+# define U_PORT_SPI_RECEIVE_ASYNC_TASK_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Callback type for uPortSpiControllerReceiveAsyncStart().
+ *
+ * @param handle         the handle of the SPI instance.
+ * @param[in] pData      a pointer to a buffer of received data, which
+ *                       will usually contain fill bytes.
+ * @param size           the number of bytes at pData.
+ * @param pCallbackParam the pCallbackParam that was passed to
+ *                       uPortSpiControllerReceiveAsyncStart().
+ */
+typedef void (uPortSpiReceiveCallback_t)(int32_t handle, const char *pData,
+                                         size_t size, void *pCallbackParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -209,6 +237,64 @@ int32_t uPortSpiControllerSendReceiveBlock(int32_t handle, const char *pSend,
                                            size_t bytesToSend, char *pReceive,
                                            size_t bytesToReceive);
 
+/** Start receiving from an SPI device in the background, using interrupts
+ * or DMA, so that the caller does not have to poll the SPI bus.  The
+ * platform clocks in a transfer of bufferSizeBytes, sending fill (0xFF),
+ * into one of the two buffers at pBuffer while the other is being
+ * handed to pCallback, i.e. the transfers are double-buffered.
+ *
+ * pCallback is called in task context, never from an interrupt, and the
+ * buffer it is given is not re-used by the platform until pCallback
+ * has returned; pCallback should hence return quickly.
+ *
+ * While background reception is running
+ * uPortSpiControllerSendReceiveBlock() and
+ * uPortSpiControllerSendReceiveWord() may still be called: the platform
+ * must hold off background transfers until they are complete and
+ * data received by those transfers is returned to their caller, not
+ * to pCallback.
+ *
+ * You do not need to implement this function: where it is not
+ * implemented a #U_WEAK implementation provided in u_port_spi_async.c
+ * will return #U_ERROR_COMMON_NOT_SUPPORTED, in which case the caller
+ * should fall back to polling with uPortSpiControllerSendReceiveBlock().
+ *
+ * @param handle          the handle of the SPI instance.
+ * @param[in] pBuffer     storage for the two receive buffers, must be
+ *                        at least 2 * bufferSizeBytes long and, for
+ *                        the NRF52, NRF53 and ESP32 cases, in RAM.
+ * @param bufferSizeBytes the size of each of the two buffers in BYTES;
+ *                        this must be an integer multiple of the
+ *                        configured word size for the device.
+ * @param intervalMs      the minimum time between the start of one
+ *                        background transfer and the start of the next;
+ *                        use 0 for back-to-back transfers.
+ * @param[in] pCallback   the callback to be called with each full buffer,
+ *                        cannot be NULL.
+ * @param pCallbackParam  a parameter that will be passed to pCallback;
+ *                        may be NULL.
+ * @return                zero on success else negative error code.
+ */
+int32_t uPortSpiControllerReceiveAsyncStart(int32_t handle, char *pBuffer,
+                                            size_t bufferSizeBytes,
+                                            int32_t intervalMs,
+                                            uPortSpiReceiveCallback_t *pCallback,
+                                            void *pCallbackParam);
+
+/** Stop background reception that was begun with
+ * uPortSpiControllerReceiveAsyncStart(); when this function returns
+ * the callback will not be called again and the buffer that was passed
+ * to uPortSpiControllerReceiveAsyncStart() may be freed.  This MUST
+ * be called before the SPI instance is closed.
+ *
+ * You do not need to implement this function: where it is not
+ * implemented a #U_WEAK implementation provided in u_port_spi_async.c
+ * will do nothing.
+ *
+ * @param handle the handle of the SPI instance.
+ */
+void uPortSpiControllerReceiveAsyncStop(int32_t handle);
+
 /** Get the number of SPI interfaces currently open; this may be used
  * as a basic check for heap monitoring.
  *
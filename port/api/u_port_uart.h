@@ -89,6 +89,37 @@ extern "C" {
  * TYPES
  * -------------------------------------------------------------- */
 
+/** One of the buffers to be sent by uPortUartWriteVec().
+ */
+typedef struct {
+    const void *pBuffer; /**< the data to send. */
+    size_t sizeBytes;    /**< the number of bytes at pBuffer. */
+} uPortUartIoVec_t;
+
+/** Statistics for a UART instance, see uPortUartStatsGet().  A
+ * platform that cannot detect a given condition leaves its count
+ * at zero.
+ */
+typedef struct {
+    uint32_t bytesReceived;     /**< the number of bytes that have arrived
+                                     in the receive buffer. */
+    uint32_t bytesSent;         /**< the number of bytes written. */
+    uint32_t overrunCount;      /**< the number of times received data was
+                                     lost before it reached the receive buffer,
+                                     e.g. because the HW FIFO overflowed. */
+    uint32_t framingErrorCount; /**< the number of framing errors. */
+    uint32_t parityErrorCount;  /**< the number of parity errors. */
+    uint32_t bufferFullCount;   /**< the number of times the receive buffer
+                                     became full; with RTS flow control the
+                                     far end is then held off, without it
+                                     further data will usually be lost and
+                                     counted in overrunCount. */
+    int32_t bufferFullTimeMs;   /**< the total time for which the receive
+                                     buffer has been full, i.e. for which
+                                     reception was stalled, including any
+                                     period that is still in progress. */
+} uPortUartStats_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -237,6 +268,50 @@ int32_t uPortUartGetReceiveSize(int32_t handle);
 int32_t uPortUartRead(int32_t handle, void *pBuffer,
                       size_t sizeBytes);
 
+/** Get a pointer to the received data of the given UART instance,
+ * non-blocking, without copying it or removing it from the UART
+ * buffer: this allows received data to be parsed in place, after
+ * which uPortUartConsume() should be called to say how much of it
+ * is finished with.  Since the receive buffer is usually circular
+ * the span may be shorter than uPortUartGetReceiveSize() indicates:
+ * once the span has been consumed, call this function again to
+ * obtain the remainder.
+ *
+ * The pointer remains valid until the next call to
+ * uPortUartConsume(), uPortUartRead() or uPortUartClose() for
+ * this UART instance; there must be only one reader of a UART
+ * instance, reading with either this function or uPortUartRead(),
+ * which may be mixed.
+ *
+ * This function may NOT be supported on all platforms; where it
+ * is not supported it will return #U_ERROR_COMMON_NOT_SUPPORTED and
+ * uPortUartRead() should be used instead.
+ *
+ * @param handle      the handle of the UART instance.
+ * @param[out] ppData a place to put the pointer to the received
+ *                    data; cannot be NULL.  Set to NULL if there
+ *                    is no received data.
+ * @return            the number of bytes at *ppData else negative
+ *                    error code.
+ */
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData);
+
+/** Remove data that was obtained with uPortUartReadSpan() from
+ * the UART buffer, freeing the space for more received data.
+ *
+ * This function must be supported if uPortUartReadSpan() is
+ * supported.
+ *
+ * @param handle    the handle of the UART instance.
+ * @param sizeBytes the number of bytes to remove, which should not
+ *                  be more than the last call to uPortUartReadSpan()
+ *                  returned.
+ * @return          the number of bytes removed, which will be less
+ *                  than sizeBytes if there was less data in the
+ *                  UART buffer, else negative error code.
+ */
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes);
+
 /** Write to the given UART interface.  Will block until
  * all of the data has been written or an error has occurred.
  *
@@ -249,6 +324,27 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
 int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
                        size_t sizeBytes);
 
+/** Write several buffers to the given UART interface, in order, as
+ * if they were one, e.g. the header, body and trailer of a frame
+ * that are held separately; where the platform supports it this is
+ * done in a single call to the driver.  Will block until all of the
+ * data has been written or an error has occurred.
+ *
+ * You do not need to implement this function: where it is not
+ * implemented a #U_WEAK implementation in u_port_uart_vec.c will
+ * call uPortUartWrite() for each buffer in turn, in which case data
+ * written to the same UART by another task may be sent in between
+ * the buffers.
+ *
+ * @param handle   the handle of the UART instance.
+ * @param[in] pVec an array of count buffers to send; a buffer
+ *                 with a sizeBytes of zero is skipped.
+ * @param count    the number of entries at pVec.
+ * @return         the number of bytes sent or negative error code.
+ */
+int32_t uPortUartWriteVec(int32_t handle, const uPortUartIoVec_t *pVec,
+                          size_t count);
+
 /** Set a callback to be called when a UART event occurs.
  * pFunction will be called asynchronously in its own task,
  * for which the stack size and priority can be specified.
@@ -443,6 +539,33 @@ int32_t uPortUartCtsSuspend(int32_t handle);
  */
 void uPortUartCtsResume(int32_t handle);
 
+/** Get the statistics of a UART instance, which can be used to
+ * find out where received data is being lost; the AT client
+ * and the GNSS message interface have equivalents for the layers
+ * above, see uAtClientReceiveBufferHighWaterMarkGet() and
+ * uGnssMsgReceiveStatStreamLoss().  The statistics are reset when
+ * the UART is opened and by uPortUartStatsReset().
+ *
+ * You do not need to implement this function: where it is not
+ * implemented a #U_WEAK implementation in u_port_uart_stats.c will
+ * return #U_ERROR_COMMON_NOT_SUPPORTED.
+ *
+ * @param handle      the handle of the UART instance.
+ * @param[out] pStats a place to put the statistics; cannot be NULL.
+ * @return            zero on success else negative error code.
+ */
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats);
+
+/** Reset the statistics of a UART instance.
+ *
+ * This function must be implemented if uPortUartStatsGet() is
+ * implemented.
+ *
+ * @param handle the handle of the UART instance.
+ * @return       zero on success else negative error code.
+ */
+int32_t uPortUartStatsReset(int32_t handle);
+
 /** Get the number of UART interfaces currently open; this may be
  * used as a basic check for heap monitoring.
  *
@@ -38,29 +38,28 @@ struct tm *gmtime_r(const time_t *pTime, struct tm *pBuf)
 {
     struct tm *pTm = NULL;
     int64_t time;
-    int32_t months;
-    int32_t years;
+    int64_t days;
+    int32_t year;
+    int32_t month;
+    int32_t day;
 
     if ((pTime != NULL) && (pBuf != NULL) && (*pTime >= 0)) {
         time = (int64_t) * pTime;
         memset(pBuf, 0, sizeof(*pBuf));
-        // Work out the number of months since 1970
-        months = uTimeSecondsToMonthsUtc(time);
-        // From that, the number of years
-        years = months / 12;
+        // Work out the date from the number of days since 1970
+        days = time / (3600 * 24);
+        uTimeCivilFromDays(days, &year, &month, &day);
         // Years since 1900 for struct tm
-        pBuf->tm_year = years + 70;
+        pBuf->tm_year = year - 1900;
         // Months since January (0 to 11)
-        pBuf->tm_mon = months - (years * 12);
+        pBuf->tm_mon = month - 1;
+        // Day of the month (1 to 31)
+        pBuf->tm_mday = day;
         // Days in the year (0 to 365)
-        pBuf->tm_yday = (int32_t) ((time - uTimeMonthsToSecondsUtc(years * 12)) / (3600 * 24));
+        pBuf->tm_yday = (int32_t) (days - uTimeDaysFromCivil(year, 1, 1));
         // Day of the week, from Sunday (0 to 6); the 1/1/1970 was a Wednesday (4)
-        pBuf->tm_wday = (4 + (time / (3600 * 24))) % 7;
-        time -= uTimeMonthsToSecondsUtc(months);
-        // Day of the month (1 to 31)
-        pBuf->tm_mday = (int32_t) (time / (3600 * 24));
-        time -= pBuf->tm_mday * 3600 * 24;
-        pBuf->tm_mday++;
+        pBuf->tm_wday = (int32_t) ((4 + days) % 7);
+        time -= days * 3600 * 24;
         // Hours (0 to 23)
         pBuf->tm_hour = (int32_t)  (time / 3600);
         time -= pBuf->tm_hour * 3600;
@@ -206,6 +206,13 @@ int32_t uPortGetTickTimeMs()
     return tx_time_get();
 }
 
+// Get the current time in microseconds: no better
+// resolution than the tick is available.
+int64_t uPortGetTickTimeUs()
+{
+    return ((int64_t) tx_time_get()) * 1000;
+}
+
 // Get the minimum amount of heap free, ever, in bytes.
 int32_t uPortGetHeapMinFree()
 {
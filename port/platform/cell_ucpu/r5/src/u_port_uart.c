@@ -565,6 +565,22 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     return errorCodeOrSize;
 }
 
+// Get a pointer to the received data: not supported.
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    (void) handle;
+    (void) ppData;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// Remove data obtained with uPortUartReadSpan(): not supported.
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    (void) handle;
+    (void) sizeBytes;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 // Write to the given UART interface.
 int32_t uPortUartWrite(int32_t handle,
                        const void *pBuffer,
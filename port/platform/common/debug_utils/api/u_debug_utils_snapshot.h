@@ -0,0 +1,215 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_DEBUG_UTILS_SNAPSHOT_H_
+#define _U_DEBUG_UTILS_SNAPSHOT_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+#include "u_at_client.h"
+#include "u_sock.h"
+#include "u_ringbuffer.h"
+
+/** @file
+ * @brief A diagnostic snapshot: the statistics that ubxlib gathers
+ * at run-time (heap, tasks, event queues, AT clients, sockets,
+ * UARTs, ring buffers and pbuf pools) serialised into one compact
+ * binary blob, small enough to be sent from a device in the field,
+ * e.g. as an MQTT message, and decoded elsewhere.
+ *
+ * All values are little-endian.  The blob begins with an 8 byte
+ * header:
+ *
+ * - the characters 'D', 'S',
+ * - a uint8_t version number, currently 1,
+ * - a uint8_t count of the sections that follow,
+ * - a uint32_t: uPortGetTickTimeMs() when the snapshot was taken.
+ *
+ * Each section begins with a 4 byte header:
+ *
+ * - a uint8_t: the section type, a value from
+ *   #uDebugUtilsSnapshotSection_t,
+ * - a uint8_t: the size of each record in the section in bytes,
+ * - a uint16_t: the number of records in the section,
+ *
+ * ...followed by the records, all of the same size, each made
+ * up of uint32_t/int32_t fields, as described against the section
+ * types below.  A decoder should skip a section type it does not
+ * know and should ignore fields beyond those it knows, since later
+ * versions may add fields to the end of a record.  Where a name
+ * or string is involved the 32-bit FNV-1a hash of it is sent,
+ * in the same way as uPortHeapProfileDump(), so that it can be
+ * matched against the known names off-target.
+ *
+ * A section is omitted if there is nothing to put in it, e.g.
+ * because the underlying statistics are not supported on this
+ * platform or have not been compiled in.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The version number in the header of a snapshot.
+ */
+#define U_DEBUG_UTILS_SNAPSHOT_VERSION 1
+
+/** The size of the header at the start of a snapshot.
+ */
+#define U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES 8
+
+/** The size of the header at the start of each section of a
+ * snapshot.
+ */
+#define U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES 4
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** The types of section in a snapshot and the fields of their
+ * records, all 32 bits wide.  Where a field is marked "index" it
+ * is the index of the item in the relevant array of
+ * #uDebugUtilsSnapshotCfg_t.
+ */
+typedef enum {
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP = 1, /**< one record: heap free,
+                                                  heap minimum free,
+                                                  uPortHeapAllocCount(),
+                                                  uPortHeapPerpetualAllocCount(). */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP_BUDGET = 2, /**< one record per
+                                                         #uPortHeapTag_t,
+                                                         only if
+                                                         U_CFG_HEAP_BUDGET is
+                                                         defined: tag, live
+                                                         bytes, peak bytes. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_TASK = 3, /**< one record per task, from
+                                                  uPortTaskInfoGet(): name hash,
+                                                  stack minimum free, CPU time
+                                                  in microseconds (low 32 bits),
+                                                  CPU time (high 32 bits). */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_EVENT_QUEUE = 4, /**< one record per open
+                                                         event queue: handle,
+                                                         entries free, stack
+                                                         minimum free. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_AT_CLIENT = 5, /**< one record per AT client:
+                                                       index, receive buffer
+                                                       high-water mark. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_AT_COMMAND = 6, /**< one record per AT command,
+                                                        only if
+                                                        #U_AT_CLIENT_STATS_NUM_COMMANDS
+                                                        is non-zero: AT client index,
+                                                        prefix hash, count, timeout
+                                                        count, mean ms, p99 ms,
+                                                        max ms, tx bytes, rx bytes. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_SOCK = 7, /**< one record per socket, from
+                                                  uSockStatsGet(): index,
+                                                  bytes sent, bytes received,
+                                                  writes, reads, would-blocks,
+                                                  write time total ms, write
+                                                  time peak ms, read time total
+                                                  ms, read time peak ms, blocked
+                                                  time ms. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_UART = 8, /**< one record per UART, from
+                                                  uPortUartStatsGet(): index,
+                                                  bytes received, bytes sent,
+                                                  overruns, framing errors,
+                                                  parity errors, buffer full
+                                                  count, buffer full time ms. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_RING_BUFFER = 9, /**< one record per ring
+                                                         buffer: index, size,
+                                                         bytes currently held,
+                                                         add loss, read loss. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_PBUF = 10, /**< one record per pbuf pool
+                                                   size class that has been
+                                                   used, only
+                                                   if short-range is included:
+                                                   pool * 256 + size class,
+                                                   block size, num blocks,
+                                                   blocks in use, most blocks
+                                                   ever in use, alloc fails. */
+    U_DEBUG_UTILS_SNAPSHOT_SECTION_PBUF_LIST = 11 /**< one record per pbuf pool
+                                                       that has been used, only
+                                                       if short-range
+                                                       is included: pool, num lists,
+                                                       most lists ever in use, list
+                                                       alloc fails, average chain
+                                                       length x 100. */
+} uDebugUtilsSnapshotSection_t;
+
+/** The things, other than those that ubxlib can find for itself,
+ * to include in a snapshot; any of the arrays may be NULL, in
+ * which case the corresponding number must be zero.
+ */
+typedef struct {
+    const uAtClientHandle_t *pAtClientHandles; /**< the AT clients to include. */
+    size_t numAtClientHandles;                 /**< the number of entries at
+                                                    pAtClientHandles. */
+    const uSockDescriptor_t *pSockDescriptors; /**< the sockets to include. */
+    size_t numSockDescriptors;                 /**< the number of entries at
+                                                    pSockDescriptors. */
+    const int32_t *pUartHandles;               /**< the UARTs to include. */
+    size_t numUartHandles;                     /**< the number of entries at
+                                                    pUartHandles. */
+    uRingBuffer_t *const *ppRingBuffers;       /**< the ring buffers to include. */
+    size_t numRingBuffers;                     /**< the number of entries at
+                                                    ppRingBuffers. */
+} uDebugUtilsSnapshotCfg_t;
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Take a diagnostic snapshot: see the top of this file for the
+ * format.  The heap, task, event queue and pbuf pool sections are
+ * gathered automatically, the things listed in pCfg are added to
+ * that.  The snapshot is taken a section at a time, not atomically,
+ * and none of the statistics are reset.
+ *
+ * The snapshot uses a little heap while it is being taken: enough
+ * for the statistics of #U_PORT_OS_TASK_INFO_MAX_NUM_TASKS tasks
+ * and of #U_AT_CLIENT_STATS_NUM_COMMANDS AT commands.
+ *
+ * @param[in] pCfg      the additional things to include; may be NULL.
+ * @param[out] pBuffer  a place to put the snapshot; use NULL to find
+ *                      out how much space is needed (though, of
+ *                      course, that may change by the time the
+ *                      snapshot is taken).
+ * @param sizeBytes     the amount of storage at pBuffer; if this is
+ *                      too small then as many whole records as will
+ *                      fit are written, the result still being a
+ *                      valid snapshot.
+ * @return              the number of bytes written (or, if pBuffer
+ *                      is NULL, that would be written), else negative
+ *                      error code.
+ */
+int32_t uDebugUtilsSnapshot(const uDebugUtilsSnapshotCfg_t *pCfg,
+                            char *pBuffer, size_t sizeBytes);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _U_DEBUG_UTILS_SNAPSHOT_H_
+
+// End of file
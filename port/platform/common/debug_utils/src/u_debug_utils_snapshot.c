@@ -0,0 +1,415 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Implementation of the diagnostic snapshot.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_port_uart.h"
+#include "u_port_event_queue.h"
+
+#include "u_at_client.h"
+#include "u_sock.h"
+#include "u_ringbuffer.h"
+
+#include "u_short_range_pbuf.h"
+#include "u_short_range_module_type.h"
+#include "u_short_range.h"
+#include "u_short_range_edm_stream.h"
+
+#include "u_debug_utils_snapshot.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The most fields there are in any record of a snapshot, that
+ * of #U_DEBUG_UTILS_SNAPSHOT_SECTION_SOCK.
+ */
+#define U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS 11
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** Where a snapshot has got to.
+ */
+typedef struct {
+    char *pBuffer;         /**< NULL if only counting. */
+    size_t sizeBytes;
+    size_t offset;         /**< bytes written, or that would be. */
+    size_t numSections;
+    bool full;             /**< true once a record didn't fit. */
+    uint8_t sectionType;
+    size_t sectionOffset;  /**< where the section header is. */
+    size_t numRecords;     /**< records in the current section. */
+} uDebugUtilsSnapshot_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Write a uint32_t, little-endian, to a buffer.
+static void putUint32(char *pBuffer, uint32_t value)
+{
+    for (size_t x = 0; x < sizeof(value); x++) {
+        *pBuffer = (char) (value & 0xff);
+        pBuffer++;
+        value >>= 8;
+    }
+}
+
+// FNV-1a of a string, as in uPortHeapProfileDump().
+static uint32_t hashString(const char *pString)
+{
+    uint32_t hash = 0x811c9dc5UL;
+
+    for (; *pString != 0; pString++) {
+        hash = (hash ^ (uint8_t) *pString) * 0x01000193UL;
+    }
+
+    return hash;
+}
+
+// Begin a section; its header is only written with its first record.
+static void sectionStart(uDebugUtilsSnapshot_t *pSnapshot,
+                         uDebugUtilsSnapshotSection_t type)
+{
+    pSnapshot->sectionType = (uint8_t) type;
+    pSnapshot->sectionOffset = pSnapshot->offset;
+    pSnapshot->numRecords = 0;
+}
+
+// Add a record of numFields uint32_t's to the current section.
+static void recordAdd(uDebugUtilsSnapshot_t *pSnapshot,
+                      const uint32_t *pField, size_t numFields)
+{
+    size_t sizeBytes = numFields * sizeof(uint32_t);
+    char *pSection;
+
+    if (pSnapshot->numRecords == 0) {
+        sizeBytes += U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES;
+    }
+    if ((pSnapshot->pBuffer != NULL) &&
+        (pSnapshot->offset + sizeBytes > pSnapshot->sizeBytes)) {
+        pSnapshot->full = true;
+    }
+    if (!pSnapshot->full && (pSnapshot->numRecords < UINT16_MAX)) {
+        if (pSnapshot->pBuffer != NULL) {
+            pSection = pSnapshot->pBuffer + pSnapshot->sectionOffset;
+            if (pSnapshot->numRecords == 0) {
+                pSection[0] = (char) pSnapshot->sectionType;
+                pSection[1] = (char) (numFields * sizeof(uint32_t));
+                pSnapshot->offset += U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES;
+            }
+            for (size_t x = 0; x < numFields; x++) {
+                putUint32(pSnapshot->pBuffer + pSnapshot->offset, *pField);
+                pSnapshot->offset += sizeof(uint32_t);
+                pField++;
+            }
+            pSnapshot->numRecords++;
+            // Keep the record count up to date as we go
+            pSection[2] = (char) (pSnapshot->numRecords & 0xff);
+            pSection[3] = (char) (pSnapshot->numRecords >> 8);
+        } else {
+            pSnapshot->offset += sizeBytes;
+            pSnapshot->numRecords++;
+        }
+        if (pSnapshot->numRecords == 1) {
+            pSnapshot->numSections++;
+        }
+    }
+}
+
+// Add the heap and heap budget sections.
+static void heapAdd(uDebugUtilsSnapshot_t *pSnapshot)
+{
+    uint32_t field[U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS];
+    size_t liveBytes;
+    size_t peakBytes;
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP);
+    field[0] = (uint32_t) uPortGetHeapFree();
+    field[1] = (uint32_t) uPortGetHeapMinFree();
+    field[2] = (uint32_t) uPortHeapAllocCount();
+    field[3] = (uint32_t) uPortHeapPerpetualAllocCount();
+    recordAdd(pSnapshot, field, 4);
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP_BUDGET);
+    for (int32_t x = 0; x < (int32_t) U_PORT_HEAP_TAG_MAX_NUM; x++) {
+        if (uPortHeapBudgetGet((uPortHeapTag_t) x, &liveBytes, &peakBytes) == 0) {
+            field[0] = (uint32_t) x;
+            field[1] = (uint32_t) liveBytes;
+            field[2] = (uint32_t) peakBytes;
+            recordAdd(pSnapshot, field, 3);
+        }
+    }
+}
+
+// Add the task section.
+static void taskAdd(uDebugUtilsSnapshot_t *pSnapshot)
+{
+    uint32_t field[U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS];
+    uPortTaskInfo_t *pInfo;
+    int32_t numTasks;
+
+    pInfo = (uPortTaskInfo_t *) pUPortMalloc(sizeof(uPortTaskInfo_t) *
+                                              U_PORT_OS_TASK_INFO_MAX_NUM_TASKS);
+    if (pInfo != NULL) {
+        sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_TASK);
+        numTasks = uPortTaskInfoGet(pInfo, U_PORT_OS_TASK_INFO_MAX_NUM_TASKS);
+        if (numTasks > U_PORT_OS_TASK_INFO_MAX_NUM_TASKS) {
+            numTasks = U_PORT_OS_TASK_INFO_MAX_NUM_TASKS;
+        }
+        for (int32_t x = 0; x < numTasks; x++) {
+            field[0] = hashString(pInfo[x].name);
+            field[1] = (uint32_t) pInfo[x].stackMinFreeBytes;
+            field[2] = (uint32_t) (((uint64_t) pInfo[x].cpuTimeUs) & 0xffffffffUL);
+            field[3] = (uint32_t) (((uint64_t) pInfo[x].cpuTimeUs) >> 32);
+            recordAdd(pSnapshot, field, 4);
+        }
+        uPortFree(pInfo);
+    }
+}
+
+// Add the event queue section.
+static void eventQueueAdd(uDebugUtilsSnapshot_t *pSnapshot)
+{
+    uint32_t field[U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS];
+    int32_t numFree;
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_EVENT_QUEUE);
+    for (int32_t x = 0; x < U_PORT_EVENT_QUEUE_MAX_NUM; x++) {
+        // Only open event queues will give a number of entries free
+        numFree = uPortEventQueueGetFree(x);
+        if (numFree >= 0) {
+            field[0] = (uint32_t) x;
+            field[1] = (uint32_t) numFree;
+            field[2] = (uint32_t) uPortEventQueueStackMinFree(x);
+            recordAdd(pSnapshot, field, 3);
+        }
+    }
+}
+
+// Add the AT client and AT command sections.
+static void atClientAdd(uDebugUtilsSnapshot_t *pSnapshot,
+                        const uDebugUtilsSnapshotCfg_t *pCfg)
+{
+    uint32_t field[U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS];
+    int32_t highWaterMark;
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    uAtClientStats_t *pStats;
+    int32_t numStats;
+#endif
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_AT_CLIENT);
+    for (size_t x = 0; x < pCfg->numAtClientHandles; x++) {
+        highWaterMark = uAtClientReceiveBufferHighWaterMarkGet(pCfg->pAtClientHandles[x]);
+        if (highWaterMark >= 0) {
+            field[0] = (uint32_t) x;
+            field[1] = (uint32_t) highWaterMark;
+            recordAdd(pSnapshot, field, 2);
+        }
+    }
+
+#if U_AT_CLIENT_STATS_NUM_COMMANDS > 0
+    if (pCfg->numAtClientHandles > 0) {
+        pStats = (uAtClientStats_t *) pUPortMalloc(sizeof(uAtClientStats_t) *
+                                                   U_AT_CLIENT_STATS_NUM_COMMANDS);
+        if (pStats != NULL) {
+            sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_AT_COMMAND);
+            for (size_t x = 0; x < pCfg->numAtClientHandles; x++) {
+                numStats = uAtClientStatsGet(pCfg->pAtClientHandles[x], pStats,
+                                             U_AT_CLIENT_STATS_NUM_COMMANDS);
+                if (numStats > U_AT_CLIENT_STATS_NUM_COMMANDS) {
+                    numStats = U_AT_CLIENT_STATS_NUM_COMMANDS;
+                }
+                for (int32_t y = 0; y < numStats; y++) {
+                    field[0] = (uint32_t) x;
+                    field[1] = hashString(pStats[y].prefix);
+                    field[2] = (uint32_t) pStats[y].count;
+                    field[3] = (uint32_t) pStats[y].timeoutCount;
+                    field[4] = (uint32_t) pStats[y].meanMs;
+                    field[5] = (uint32_t) pStats[y].p99Ms;
+                    field[6] = (uint32_t) pStats[y].maxMs;
+                    field[7] = (uint32_t) pStats[y].txBytes;
+                    field[8] = (uint32_t) pStats[y].rxBytes;
+                    recordAdd(pSnapshot, field, 9);
+                }
+            }
+            uPortFree(pStats);
+        }
+    }
+#endif
+}
+
+// Add the socket, UART and ring buffer sections.
+static void streamAdd(uDebugUtilsSnapshot_t *pSnapshot,
+                      const uDebugUtilsSnapshotCfg_t *pCfg)
+{
+    uint32_t field[U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS];
+    uSockStats_t sockStats;
+    uPortUartStats_t uartStats;
+    uRingBuffer_t *pRingBuffer;
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_SOCK);
+    for (size_t x = 0; x < pCfg->numSockDescriptors; x++) {
+        if (uSockStatsGet(pCfg->pSockDescriptors[x], &sockStats) == 0) {
+            field[0] = (uint32_t) x;
+            field[1] = (uint32_t) sockStats.bytesSent;
+            field[2] = (uint32_t) sockStats.bytesReceived;
+            field[3] = (uint32_t) sockStats.numWrites;
+            field[4] = (uint32_t) sockStats.numReads;
+            field[5] = (uint32_t) sockStats.numWouldBlock;
+            field[6] = (uint32_t) sockStats.writeTimeTotalMs;
+            field[7] = (uint32_t) sockStats.writeTimePeakMs;
+            field[8] = (uint32_t) sockStats.readTimeTotalMs;
+            field[9] = (uint32_t) sockStats.readTimePeakMs;
+            field[10] = (uint32_t) sockStats.blockedTimeMs;
+            recordAdd(pSnapshot, field, 11);
+        }
+    }
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_UART);
+    for (size_t x = 0; x < pCfg->numUartHandles; x++) {
+        if (uPortUartStatsGet(pCfg->pUartHandles[x], &uartStats) == 0) {
+            field[0] = (uint32_t) x;
+            field[1] = uartStats.bytesReceived;
+            field[2] = uartStats.bytesSent;
+            field[3] = uartStats.overrunCount;
+            field[4] = uartStats.framingErrorCount;
+            field[5] = uartStats.parityErrorCount;
+            field[6] = uartStats.bufferFullCount;
+            field[7] = (uint32_t) uartStats.bufferFullTimeMs;
+            recordAdd(pSnapshot, field, 8);
+        }
+    }
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_RING_BUFFER);
+    for (size_t x = 0; x < pCfg->numRingBuffers; x++) {
+        pRingBuffer = pCfg->ppRingBuffers[x];
+        if (pRingBuffer != NULL) {
+            field[0] = (uint32_t) x;
+            field[1] = (uint32_t) pRingBuffer->size;
+            field[2] = (uint32_t) uRingBufferDataSize(pRingBuffer);
+            field[3] = (uint32_t) uRingBufferStatAddLoss(pRingBuffer);
+            field[4] = (uint32_t) uRingBufferStatReadLoss(pRingBuffer);
+            recordAdd(pSnapshot, field, 5);
+        }
+    }
+}
+
+// Add the pbuf and pbuf list sections.
+static void pbufAdd(uDebugUtilsSnapshot_t *pSnapshot)
+{
+    uint32_t field[U_DEBUG_UTILS_SNAPSHOT_MAX_NUM_FIELDS];
+    uShortRangePbufStats_t pbufStats;
+    uShortRangePbufListStats_t listStats;
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_PBUF);
+    for (int32_t x = 0; x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM; x++) {
+        for (int32_t y = 0; y < U_SHORT_RANGE_PBUF_NUM_SIZE_CLASSES; y++) {
+            if ((uShortRangePbufGetStats(x, y, &pbufStats) == 0) &&
+                (pbufStats.numAllocs > 0)) {
+                field[0] = (uint32_t) ((x << 8) | y);
+                field[1] = (uint32_t) pbufStats.blockSizeBytes;
+                field[2] = (uint32_t) pbufStats.numBlocks;
+                field[3] = (uint32_t) pbufStats.numBlocksUsed;
+                field[4] = (uint32_t) pbufStats.numBlocksUsedMax;
+                field[5] = (uint32_t) pbufStats.numAllocFails;
+                recordAdd(pSnapshot, field, 6);
+            }
+        }
+    }
+
+    sectionStart(pSnapshot, U_DEBUG_UTILS_SNAPSHOT_SECTION_PBUF_LIST);
+    for (int32_t x = 0; x < U_SHORT_RANGE_EDM_STREAM_MAX_NUM; x++) {
+        if ((uShortRangePbufGetListStats(x, &listStats) == 0) &&
+            (listStats.numLists > 0)) {
+            field[0] = (uint32_t) x;
+            field[1] = (uint32_t) listStats.numLists;
+            field[2] = (uint32_t) listStats.numListsUsedMax;
+            field[3] = (uint32_t) listStats.numListAllocFails;
+            field[4] = (uint32_t) listStats.averageLengthX100;
+            recordAdd(pSnapshot, field, 5);
+        }
+    }
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Take a diagnostic snapshot.
+int32_t uDebugUtilsSnapshot(const uDebugUtilsSnapshotCfg_t *pCfg,
+                            char *pBuffer, size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+    uDebugUtilsSnapshot_t snapshot = {0};
+    uDebugUtilsSnapshotCfg_t cfg = {0};
+
+    if ((pBuffer == NULL) || (sizeBytes >= U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES)) {
+        if (pCfg != NULL) {
+            cfg = *pCfg;
+        }
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (((cfg.pAtClientHandles != NULL) || (cfg.numAtClientHandles == 0)) &&
+            ((cfg.pSockDescriptors != NULL) || (cfg.numSockDescriptors == 0)) &&
+            ((cfg.pUartHandles != NULL) || (cfg.numUartHandles == 0)) &&
+            ((cfg.ppRingBuffers != NULL) || (cfg.numRingBuffers == 0))) {
+            snapshot.pBuffer = pBuffer;
+            snapshot.sizeBytes = sizeBytes;
+            snapshot.offset = U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES;
+            if (pBuffer != NULL) {
+                pBuffer[0] = 'D';
+                pBuffer[1] = 'S';
+                pBuffer[2] = U_DEBUG_UTILS_SNAPSHOT_VERSION;
+                putUint32(pBuffer + 4, (uint32_t) uPortGetTickTimeMs());
+            }
+            heapAdd(&snapshot);
+            taskAdd(&snapshot);
+            eventQueueAdd(&snapshot);
+            atClientAdd(&snapshot, &cfg);
+            streamAdd(&snapshot, &cfg);
+            pbufAdd(&snapshot);
+            if (pBuffer != NULL) {
+                pBuffer[3] = (char) snapshot.numSections;
+            }
+            sizeOrErrorCode = (int32_t) snapshot.offset;
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+
+// End of file
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Stubs to allow the diagnostic snapshot to compile without
+ * short-range.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "u_compiler.h" // U_WEAK
+#include "u_error_common.h"
+#include "u_short_range_pbuf.h"
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+U_WEAK int32_t uShortRangePbufGetStats(int32_t pool, int32_t sizeClass,
+                                       uShortRangePbufStats_t *pStats)
+{
+    (void) pool;
+    (void) sizeClass;
+    (void) pStats;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+U_WEAK int32_t uShortRangePbufGetListStats(int32_t pool, uShortRangePbufListStats_t *pStats)
+{
+    (void) pool;
+    (void) pStats;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// End of file
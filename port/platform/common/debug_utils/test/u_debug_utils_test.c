@@ -0,0 +1,269 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Only #includes of u_* and the C standard library are allowed here,
+ * no platform stuff and no OS stuff.  Anything required from
+ * the platform/OS must be brought in through u_port* to maintain
+ * portability.
+ */
+
+/** @file
+ * @brief Test for the diagnostic snapshot API.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memcpy(), memset()
+
+#include "u_cfg_sw.h"
+#include "u_cfg_os_platform_specific.h"
+#include "u_cfg_app_platform_specific.h"
+#include "u_cfg_test_platform_specific.h"
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_port_debug.h"
+#include "u_port_event_queue.h"
+
+#include "u_test_util_resource_check.h"
+
+#include "u_debug_utils_snapshot.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The string to put at the start of all prints from this test.
+ */
+#define U_TEST_PREFIX "U_DEBUG_UTILS_TEST: "
+
+/** Print a whole line, with terminator, prefixed for this test file.
+ */
+#define U_TEST_PRINT_LINE(format, ...) uPortLog(U_TEST_PREFIX format "\n", ##__VA_ARGS__)
+
+/** The size of the ring buffer to include in the snapshot.
+ */
+#define U_DEBUG_UTILS_TEST_RING_BUFFER_SIZE_BYTES 64
+
+/** The size of the buffer to take a snapshot into.
+ */
+#define U_DEBUG_UTILS_TEST_SNAPSHOT_SIZE_BYTES 2048
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Storage for the ring buffer.
+ */
+static char gRingBufferStorage[U_DEBUG_UTILS_TEST_RING_BUFFER_SIZE_BYTES];
+
+/** Somewhere to put a snapshot.
+ */
+static char gSnapshot[U_DEBUG_UTILS_TEST_SNAPSHOT_SIZE_BYTES];
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Read a little-endian uint32_t.
+static uint32_t getUint32(const char *pBuffer)
+{
+    uint32_t value = 0;
+
+    for (size_t x = sizeof(value); x > 0; x--) {
+        value = (value << 8) | (uint8_t) pBuffer[x - 1];
+    }
+
+    return value;
+}
+
+// Walk the sections of a snapshot of the given size, returning the
+// number of sections found, or -1 if the snapshot is malformed; if
+// type is found then the first field of each of its records is
+// compared with matchField and, where they match, the record is
+// copied into pRecord.
+static int32_t snapshotWalk(const char *pSnapshot, size_t sizeBytes,
+                            uDebugUtilsSnapshotSection_t type,
+                            uint32_t matchField, char *pRecord,
+                            size_t recordSizeBytes)
+{
+    int32_t numSections = 0;
+    size_t offset = U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES;
+    size_t sectionRecordSize;
+    size_t sectionNumRecords;
+
+    if ((sizeBytes < U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES) ||
+        (pSnapshot[0] != 'D') || (pSnapshot[1] != 'S') ||
+        (pSnapshot[2] != U_DEBUG_UTILS_SNAPSHOT_VERSION)) {
+        numSections = -1;
+    }
+    while ((numSections >= 0) && (offset < sizeBytes)) {
+        sectionRecordSize = (uint8_t) pSnapshot[offset + 1];
+        sectionNumRecords = (uint8_t) pSnapshot[offset + 2] +
+                            (((size_t) (uint8_t) pSnapshot[offset + 3]) << 8);
+        if ((sectionRecordSize == 0) || (sectionNumRecords == 0) ||
+            (offset + U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES +
+             (sectionRecordSize * sectionNumRecords) > sizeBytes)) {
+            numSections = -1;
+        } else {
+            if (pSnapshot[offset] == (char) type) {
+                for (size_t x = 0; x < sectionNumRecords; x++) {
+                    const char *pTmp = pSnapshot + offset +
+                                       U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES +
+                                       (x * sectionRecordSize);
+                    if ((getUint32(pTmp) == matchField) && (pRecord != NULL) &&
+                        (recordSizeBytes <= sectionRecordSize)) {
+                        memcpy(pRecord, pTmp, recordSizeBytes);
+                    }
+                }
+            }
+            offset += U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES +
+                      (sectionRecordSize * sectionNumRecords);
+            numSections++;
+        }
+    }
+    if ((numSections >= 0) && (numSections != (uint8_t) pSnapshot[3])) {
+        numSections = -1;
+    }
+
+    return numSections;
+}
+
+// Event queue callback, does nothing.
+static void eventQueueFunction(void *pParam, size_t paramLength)
+{
+    (void) pParam;
+    (void) paramLength;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS: TESTS
+ * -------------------------------------------------------------- */
+
+/** Test taking a diagnostic snapshot.
+ */
+U_PORT_TEST_FUNCTION("[debugUtils]", "debugUtilsSnapshot")
+{
+    int32_t resourceCount;
+    int32_t eventQueueHandle;
+    uRingBuffer_t ringBuffer;
+    uRingBuffer_t *pRingBuffer = &ringBuffer;
+    uDebugUtilsSnapshotCfg_t cfg = {0};
+    int32_t sizeBytes;
+    int32_t numSections;
+    char record[20];
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    U_TEST_PRINT_LINE("testing diagnostic snapshot.");
+
+    // Something for the event queue and ring buffer sections
+    eventQueueHandle = uPortEventQueueOpen(eventQueueFunction, "snapshot", 4,
+                                           U_PORT_EVENT_QUEUE_MIN_TASK_STACK_SIZE_BYTES,
+                                           U_CFG_TEST_OS_TASK_PRIORITY, 5);
+    U_PORT_TEST_ASSERT(eventQueueHandle >= 0);
+    U_PORT_TEST_ASSERT(uRingBufferCreate(&ringBuffer, gRingBufferStorage,
+                                         sizeof(gRingBufferStorage)) == 0);
+    U_PORT_TEST_ASSERT(uRingBufferAdd(&ringBuffer, "0123456789", 10));
+    cfg.ppRingBuffers = &pRingBuffer;
+    cfg.numRingBuffers = 1;
+
+    // Bad parameters
+    U_PORT_TEST_ASSERT(uDebugUtilsSnapshot(NULL, gSnapshot,
+                                           U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES - 1) < 0);
+    cfg.numUartHandles = 1;
+    U_PORT_TEST_ASSERT(uDebugUtilsSnapshot(&cfg, NULL, 0) < 0);
+    cfg.numUartHandles = 0;
+
+    // With no configuration there is at least a heap section
+    sizeBytes = uDebugUtilsSnapshot(NULL, gSnapshot, sizeof(gSnapshot));
+    U_TEST_PRINT_LINE("snapshot with no configuration is %d byte(s).", sizeBytes);
+    U_PORT_TEST_ASSERT(sizeBytes >= U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES +
+                       U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES + 16);
+    U_PORT_TEST_ASSERT(snapshotWalk(gSnapshot, sizeBytes,
+                                    U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP, 0, NULL, 0) > 0);
+
+    // Now with the configuration, asking for the size first
+    sizeBytes = uDebugUtilsSnapshot(&cfg, NULL, 0);
+    U_TEST_PRINT_LINE("snapshot will be %d byte(s).", sizeBytes);
+    U_PORT_TEST_ASSERT((sizeBytes > 0) && (sizeBytes <= (int32_t) sizeof(gSnapshot)));
+    sizeBytes = uDebugUtilsSnapshot(&cfg, gSnapshot, sizeof(gSnapshot));
+    U_TEST_PRINT_LINE("snapshot is %d byte(s).", sizeBytes);
+    U_PORT_TEST_ASSERT(sizeBytes > 0);
+    numSections = snapshotWalk(gSnapshot, sizeBytes,
+                               U_DEBUG_UTILS_SNAPSHOT_SECTION_RING_BUFFER, 0,
+                               record, sizeof(record));
+    U_TEST_PRINT_LINE("snapshot has %d section(s).", numSections);
+    U_PORT_TEST_ASSERT(numSections > 0);
+    // Index, size, bytes held, add loss, read loss
+    U_PORT_TEST_ASSERT(getUint32(record + 4) == sizeof(gRingBufferStorage));
+    U_PORT_TEST_ASSERT(getUint32(record + 8) == 10);
+    U_PORT_TEST_ASSERT(getUint32(record + 12) == 0);
+    // The event queue should be there if the platform can count free entries
+    if (uPortEventQueueGetFree(eventQueueHandle) >= 0) {
+        memset(record, 0xff, sizeof(record));
+        U_PORT_TEST_ASSERT(snapshotWalk(gSnapshot, sizeBytes,
+                                        U_DEBUG_UTILS_SNAPSHOT_SECTION_EVENT_QUEUE,
+                                        (uint32_t) eventQueueHandle,
+                                        record, 12) == numSections);
+        U_PORT_TEST_ASSERT(getUint32(record) == (uint32_t) eventQueueHandle);
+        U_PORT_TEST_ASSERT(getUint32(record + 4) == 5);
+    }
+
+    // A buffer with only room for the heap section should still
+    // give a valid snapshot
+    sizeBytes = uDebugUtilsSnapshot(&cfg, gSnapshot, U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES +
+                                    U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES + 16);
+    U_PORT_TEST_ASSERT(sizeBytes == U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES +
+                       U_DEBUG_UTILS_SNAPSHOT_SECTION_HEADER_SIZE_BYTES + 16);
+    U_PORT_TEST_ASSERT(snapshotWalk(gSnapshot, sizeBytes,
+                                    U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP, 0, NULL, 0) == 1);
+    // ...and with room for nothing but the header
+    sizeBytes = uDebugUtilsSnapshot(&cfg, gSnapshot, U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(sizeBytes == U_DEBUG_UTILS_SNAPSHOT_HEADER_SIZE_BYTES);
+    U_PORT_TEST_ASSERT(snapshotWalk(gSnapshot, sizeBytes,
+                                    U_DEBUG_UTILS_SNAPSHOT_SECTION_HEAP, 0, NULL, 0) == 0);
+
+    uRingBufferDelete(&ringBuffer);
+    U_PORT_TEST_ASSERT(uPortEventQueueClose(eventQueueHandle) == 0);
+    uPortEventQueueCleanUp();
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+// End of file
@@ -52,6 +52,16 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The largest item that can be on the OS queue of any event
+ * queue: the control word followed by either the parameter block
+ * or a uEventQueuePointer_t, whichever is the larger.
+ */
+#define U_EVENT_QUEUE_ITEM_MAX_LENGTH_BYTES (U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES + \
+                                             ((U_PORT_EVENT_QUEUE_MAX_PARAM_LENGTH_BYTES >   \
+                                               sizeof(uEventQueuePointer_t)) ?              \
+                                              U_PORT_EVENT_QUEUE_MAX_PARAM_LENGTH_BYTES :   \
+                                              sizeof(uEventQueuePointer_t)))
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -63,9 +73,25 @@ typedef struct uEventQueue_t {
     void (*pFunction)(void *, size_t); /** The function to be called. */
     int32_t handle;            /** Handle for this event queue. */
     uPortQueueHandle_t queue; /** Handle for the OS queue. */
-    size_t paramMaxLengthBytes; /** Max length of an item on this OS queue. */
-    uPortTaskHandle_t task; /** Handle for the OS task. */
+    uPortQueueHandle_t highPriorityQueue; /** Handle for the OS queue of high
+                                              priority events, NULL until the
+                                              first one is sent. */
+    size_t paramMaxLengthBytes; /** Max length of a parameter block copied
+                                    onto this OS queue. */
+    size_t itemSizeBytes; /** Length of an item on the OS queues, including
+                              the control word. */
+    uPortTaskHandle_t task; /** Handle for the OS task, NULL if the pool is used. */
     uPortMutexHandle_t taskRunningMutex; /** Mutex to determine if task has exited. */
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+    volatile bool poolPending; /** true while the handle is on the ready
+                                   queue of the pool. */
+    bool poolBusy; /** true while a task of the pool is handling events. */
+    bool poolRepeat; /** true if the handle was taken from the ready queue
+                         while poolBusy was true. */
+    volatile bool poolExited; /** true once the pool has handled the exit
+                                  control word. */
+    uPortTaskHandle_t poolTask; /** The task of the pool handling events, else NULL. */
+#endif
 } uEventQueue_t;
 
 /** The control/size word, prefixed to the parameter block sent to
@@ -78,9 +104,37 @@ typedef enum {
                                                * be 32 bit so that it can
                                                * also be used as a size. */
     U_EVENT_CONTROL_NONE = 0,
-    U_EVENT_CONTROL_EXIT_NOW = -1
+    U_EVENT_CONTROL_EXIT_NOW = -1,
+    U_EVENT_CONTROL_HIGH_PRIORITY = -2, /* Sent on the normal queue to wake
+                                         * the task up when an event has been
+                                         * put on the high priority queue. */
+    U_EVENT_CONTROL_POINTER = -3 /* Followed by a uEventQueuePointer_t
+                                  * rather than a parameter block. */
 } uEventQueueControlOrSize_t;
 
+/** What follows #U_EVENT_CONTROL_POINTER on the OS queue, an event
+ * sent with uPortEventQueueSendPointer().
+ */
+typedef struct {
+    void *pParam;
+    size_t paramLengthBytes;
+    void (*pRelease)(void *);
+} uEventQueuePointer_t;
+
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+/** The tasks shared by event queues, see
+ * #U_PORT_EVENT_QUEUE_POOL_NUM_TASKS.
+ */
+typedef struct {
+    uPortQueueHandle_t readyQueue; /** Handles of event queues with events
+                                       waiting, -1 tells a task to exit. */
+    uPortMutexHandle_t mutex; /** Protects the pool fields of the event
+                                  queues and changes to gpEventQueue. */
+    uPortSemaphoreHandle_t stopped; /** Given by each task as it exits. */
+    uPortTaskHandle_t task[U_PORT_EVENT_QUEUE_POOL_NUM_TASKS]; /** The tasks. */
+} uEventQueuePool_t;
+#endif
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -93,21 +147,20 @@ static uPortMutexHandle_t gMutex = NULL;
  */
 static uEventQueue_t *gpEventQueue[U_PORT_EVENT_QUEUE_MAX_NUM];
 
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+/** The pool of tasks, started when the first event queue which
+ * can use it is opened.
+ */
+static uEventQueuePool_t gPool;
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
-// Run the user function.  This will be run multiple times in a
-// task of its own.
-static void eventQueueTask(void *pParam)
+// Called at the start of any task that calls user functions.
+static void taskStart(void)
 {
-    uEventQueue_t *pEventQueue = (uEventQueue_t *) pParam;
-    char param[U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES +
-                                                               U_PORT_EVENT_QUEUE_MAX_PARAM_LENGTH_BYTES];
-    uEventQueueControlOrSize_t *pControlOrSize = (uEventQueueControlOrSize_t *)
-                                                 & (param[0]);
-
-    U_PORT_MUTEX_LOCK(pEventQueue->taskRunningMutex);
 #if defined(__NEWLIB__) && defined(_REENT_SMALL) && \
     !defined(_REENT_GLOBAL_STDIO_STREAMS) && !defined(_UNBUF_STREAM_OPT)
     // This is a temporary workaround to prevent false memory leak failures
@@ -121,77 +174,332 @@ static void eventQueueTask(void *pParam)
     // Note: If this is enabled for ESP32 it will crash... (?)
     uPortLog("");
 #endif
+}
+
+// Handle a block received from the OS queue of an event queue: if
+// it is not a control message, call the user function with the
+// parameter block, skipping the "control or size" word at the
+// start and passing it in instead as the size parameter, or with
+// the parameter block the block points to, then releasing it.
+// The "control or size" word is returned.
+static uEventQueueControlOrSize_t eventRun(const uEventQueue_t *pEventQueue,
+                                           char *pBlock)
+{
+    //lint -e(826) Suppress area too small; pBlock is always at least
+    // U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES in size
+    uEventQueueControlOrSize_t controlOrSize = *((uEventQueueControlOrSize_t *) pBlock);
+    uEventQueuePointer_t pointer;
+
+    if (controlOrSize == U_EVENT_CONTROL_POINTER) {
+        // Copied out since it may not be aligned in pBlock
+        memcpy(&pointer, pBlock + U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES,
+               sizeof(pointer));
+        pEventQueue->pFunction(pointer.pParam, pointer.paramLengthBytes);
+        if (pointer.pRelease != NULL) {
+            pointer.pRelease(pointer.pParam);
+        }
+    } else if ((int32_t) controlOrSize >= 0) {
+        if ((int32_t) controlOrSize > 0) {
+            pEventQueue->pFunction((void *) (pBlock + U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES),
+                                   // Cast in two stages to keep Lint happy
+                                   (size_t) (int32_t) controlOrSize);
+        } else {
+            pEventQueue->pFunction(NULL, 0);
+        }
+    }
+
+    return controlOrSize;
+}
+
+// Run the user function.  This will be run multiple times in a
+// task of its own.
+static void eventQueueTask(void *pParam)
+{
+    uEventQueue_t *pEventQueue = (uEventQueue_t *) pParam;
+    char param[U_EVENT_QUEUE_ITEM_MAX_LENGTH_BYTES];
+    uEventQueueControlOrSize_t controlOrSize = U_EVENT_CONTROL_NONE;
+
+    U_PORT_MUTEX_LOCK(pEventQueue->taskRunningMutex);
+    taskStart();
 
-    *pControlOrSize = U_EVENT_CONTROL_NONE;
     // Continue until we're told to exit
-    while (*pControlOrSize != U_EVENT_CONTROL_EXIT_NOW) {
-        if (uPortQueueReceive(pEventQueue->queue, param) == 0) {
-            // If this is not a control message, call the
-            // user function with the parameter block,
-            // skipping the "control or size" word at the
-            // start and passing it in instead as the size
-            // parameter
-            if ((int32_t) *pControlOrSize >= 0) {
-                if ((int32_t) *pControlOrSize > 0) {
-                    pEventQueue->pFunction((void *) & (param[U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES]),
-                                           // Cast in two stages to keep Lint happy
-                                           (size_t) (int32_t) *pControlOrSize);
-                } else {
-                    pEventQueue->pFunction(NULL, 0);
+    while (controlOrSize != U_EVENT_CONTROL_EXIT_NOW) {
+        // Anything of high priority goes first, without waiting,
+        // otherwise wait on the normal queue; the high priority
+        // queue is only ever set once, under gMutex, before an
+        // event is sent to it
+        if (((pEventQueue->highPriorityQueue != NULL) &&
+             (uPortQueueTryReceive(pEventQueue->highPriorityQueue, 0, param) == 0)) ||
+            (uPortQueueReceive(pEventQueue->queue, param) == 0)) {
+            controlOrSize = eventRun(pEventQueue, param);
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(pEventQueue->taskRunningMutex);
+
+    // Delete ourself
+    uPortTaskDelete(NULL);
+}
+
+// Set an entry in the table of event queues.
+// The mutex must be locked before this is called.
+static void eventQueueSet(int32_t handle, uEventQueue_t *pEventQueue)
+{
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+    if (gPool.mutex != NULL) {
+        // The tasks of the pool look at the table without gMutex
+        U_PORT_MUTEX_LOCK(gPool.mutex);
+        gpEventQueue[handle] = pEventQueue;
+        U_PORT_MUTEX_UNLOCK(gPool.mutex);
+    } else {
+        gpEventQueue[handle] = pEventQueue;
+    }
+#else
+    gpEventQueue[handle] = pEventQueue;
+#endif
+}
+
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+
+// Make sure that an event queue, which is in the pool, is on the
+// ready queue of the pool; to be called after an event has been
+// sent to it.
+static int32_t poolSchedule(uEventQueue_t *pEventQueue)
+{
+    int32_t errorCode = 0;
+    int32_t handle = pEventQueue->handle;
+
+    U_PORT_MUTEX_LOCK(gPool.mutex);
+
+    if (!pEventQueue->poolPending) {
+        // This can't block for long: there is room on the ready
+        // queue for every event queue plus the exit control words
+        pEventQueue->poolPending = true;
+        errorCode = uPortQueueSend(gPool.readyQueue, &handle);
+        if (errorCode != 0) {
+            pEventQueue->poolPending = false;
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(gPool.mutex);
+
+    return errorCode;
+}
+
+// A task of the pool: take the handle of an event queue with events
+// waiting from the ready queue and handle up to
+// U_PORT_EVENT_QUEUE_POOL_MAX_EVENTS_PER_TURN of them, in order,
+// then put it back on the ready queue if there may be more, so
+// that one busy event queue can't hold up the rest.
+static void poolTask(void *pParam)
+{
+    uPortTaskHandle_t task;
+    uEventQueue_t *pEventQueue;
+    int32_t handle = 0;
+    bool more;
+    char param[U_EVENT_QUEUE_ITEM_MAX_LENGTH_BYTES];
+
+    // poolStart() holds the mutex until all of the task handles
+    // have been written
+    U_PORT_MUTEX_LOCK(gPool.mutex);
+    task = gPool.task[(size_t) (uintptr_t) pParam];
+    U_PORT_MUTEX_UNLOCK(gPool.mutex);
+    taskStart();
+
+    while (handle >= 0) {
+        if ((uPortQueueReceive(gPool.readyQueue, &handle) == 0) && (handle >= 0) &&
+            (handle < (int32_t) (sizeof(gpEventQueue) / sizeof(gpEventQueue[0])))) {
+            pEventQueue = NULL;
+
+            U_PORT_MUTEX_LOCK(gPool.mutex);
+
+            // Another task of the pool may already be handling the
+            // events of this event queue, in which case it is asked
+            // to put it back on the ready queue when it is done, since
+            // it may not have seen the event that caused this
+            if ((gpEventQueue[handle] != NULL) && (gpEventQueue[handle]->task == NULL)) {
+                gpEventQueue[handle]->poolPending = false;
+                if (gpEventQueue[handle]->poolBusy) {
+                    gpEventQueue[handle]->poolRepeat = true;
+                } else if (!gpEventQueue[handle]->poolExited) {
+                    pEventQueue = gpEventQueue[handle];
+                    pEventQueue->poolBusy = true;
+                    pEventQueue->poolRepeat = false;
+                    pEventQueue->poolTask = task;
                 }
             }
+
+            U_PORT_MUTEX_UNLOCK(gPool.mutex);
+
+            if (pEventQueue != NULL) {
+                more = true;
+                for (size_t x = 0; (x < U_PORT_EVENT_QUEUE_POOL_MAX_EVENTS_PER_TURN) &&
+                     more && !pEventQueue->poolExited; x++) {
+                    // Anything of high priority goes first
+                    more = ((pEventQueue->highPriorityQueue != NULL) &&
+                            (uPortQueueTryReceive(pEventQueue->highPriorityQueue, 0, param) == 0)) ||
+                           (uPortQueueTryReceive(pEventQueue->queue, 0, param) == 0);
+                    if (more && (eventRun(pEventQueue, param) == U_EVENT_CONTROL_EXIT_NOW)) {
+                        pEventQueue->poolExited = true;
+                    }
+                }
+
+                U_PORT_MUTEX_LOCK(gPool.mutex);
+
+                pEventQueue->poolBusy = false;
+                pEventQueue->poolTask = NULL;
+                // more is still true if the turn ran out
+                if (!pEventQueue->poolExited && !pEventQueue->poolPending &&
+                    (more || pEventQueue->poolRepeat)) {
+                    pEventQueue->poolPending = true;
+                    uPortQueueSend(gPool.readyQueue, &handle);
+                }
+
+                U_PORT_MUTEX_UNLOCK(gPool.mutex);
+            }
         }
     }
 
-    U_PORT_MUTEX_UNLOCK(pEventQueue->taskRunningMutex);
+    uPortSemaphoreGive(gPool.stopped);
 
     // Delete ourself
     uPortTaskDelete(NULL);
 }
 
+// Stop the given number of tasks of the pool and free the rest of it.
+// gMutex must be locked before this is called.
+static void poolStop(size_t numTasks)
+{
+    int32_t exitNow = -1;
+
+    for (size_t x = 0; x < numTasks; x++) {
+        uPortQueueSend(gPool.readyQueue, &exitNow);
+    }
+    for (size_t x = 0; x < numTasks; x++) {
+        uPortSemaphoreTake(gPool.stopped);
+    }
+    if (gPool.stopped != NULL) {
+        uPortSemaphoreDelete(gPool.stopped);
+    }
+    if (gPool.mutex != NULL) {
+        uPortMutexDelete(gPool.mutex);
+    }
+    if (gPool.readyQueue != NULL) {
+        uPortQueueDelete(gPool.readyQueue);
+    }
+    memset(&gPool, 0, sizeof(gPool));
+
+    // Pause here to allow the deletions
+    // above to actually occur in the idle thread,
+    // required by some RTOSs (e.g. FreeRTOS)
+    uPortTaskBlock(U_CFG_OS_YIELD_MS);
+}
+
+// Start the pool, if it is not already running.
+// gMutex must be locked before this is called.
+static int32_t poolStart()
+{
+    int32_t errorCode = 0;
+    size_t numTasks = 0;
+
+    if (gPool.readyQueue == NULL) {
+        errorCode = uPortQueueCreate(U_PORT_EVENT_QUEUE_MAX_NUM +
+                                     U_PORT_EVENT_QUEUE_POOL_NUM_TASKS,
+                                     sizeof(int32_t), &(gPool.readyQueue));
+        if (errorCode == 0) {
+            errorCode = uPortMutexCreate(&(gPool.mutex));
+        }
+        if (errorCode == 0) {
+            errorCode = uPortSemaphoreCreate(&(gPool.stopped), 0,
+                                             U_PORT_EVENT_QUEUE_POOL_NUM_TASKS);
+        }
+        if (errorCode == 0) {
+            uPortMutexLock(gPool.mutex);
+            while ((numTasks < U_PORT_EVENT_QUEUE_POOL_NUM_TASKS) && (errorCode == 0)) {
+                errorCode = uPortTaskCreate(poolTask, "eventQueuePool",
+                                            U_PORT_EVENT_QUEUE_POOL_TASK_STACK_SIZE_BYTES,
+                                            (void *) (uintptr_t) numTasks,
+                                            U_PORT_EVENT_QUEUE_POOL_TASK_PRIORITY,
+                                            &(gPool.task[numTasks]));
+                if (errorCode == 0) {
+                    numTasks++;
+                }
+            }
+            uPortMutexUnlock(gPool.mutex);
+        }
+        if (errorCode != 0) {
+            // Clean up whatever was done
+            poolStop(numTasks);
+        }
+    }
+
+    return errorCode;
+}
+
+// Wait for a task of the pool to handle the exit control word
+// of an event queue, which must already have been sent.
+static void poolWaitExit(uEventQueue_t *pEventQueue)
+{
+    bool exited = false;
+
+    poolSchedule(pEventQueue);
+    while (!exited) {
+        U_PORT_MUTEX_LOCK(gPool.mutex);
+        exited = pEventQueue->poolExited && !pEventQueue->poolBusy;
+        U_PORT_MUTEX_UNLOCK(gPool.mutex);
+        if (!exited) {
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        }
+    }
+}
+
+#endif // #if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+
 // Free memory held by an event queue.
 // The mutex must be locked before this is called.
 static int32_t eventQueueFree(uEventQueue_t *pEventQueue)
 {
-    int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
-    void *pControl;
+    int32_t errorCode;
+    char block[U_EVENT_QUEUE_ITEM_MAX_LENGTH_BYTES];
 
     // It would be nice to send just U_EVENT_CONTROL_EXIT_NOW
     // on its own here but, as address sanitizer points out,
     // the uPortQueueSend() function must copy the required
     // length for an item on the queue so it has to be
-    // given that data size, hence we allocate the block,
-    // put U_EVENT_CONTROL_EXIT_NOW at the start of it and
-    // then free it once it is sent
-    pControl = pUPortMalloc(pEventQueue->paramMaxLengthBytes +
-                            U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES);
-
-    if (pControl != NULL) {
-        // Keep memory checkers (e.g. Valgrind) happy
-        memset(pControl, 0, pEventQueue->paramMaxLengthBytes +
-               U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES);
-        *((uEventQueueControlOrSize_t *) pControl) = U_EVENT_CONTROL_EXIT_NOW;
-        // Get the task to exit, persisting until it is done
-        while (uPortQueueSend(pEventQueue->queue, pControl) != 0) {
-            uPortTaskBlock(10);
-        }
-        uPortFree(pControl);
+    // given a whole block, zeroed to keep memory checkers
+    // (e.g. Valgrind) happy
+    memset(block, 0, pEventQueue->itemSizeBytes);
+    //lint -e(826) Suppress area too small
+    *((uEventQueueControlOrSize_t *) block) = U_EVENT_CONTROL_EXIT_NOW;
+    // Get the task to exit, persisting until it is done
+    while (uPortQueueSend(pEventQueue->queue, block) != 0) {
+        uPortTaskBlock(10);
+    }
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+    if (pEventQueue->task == NULL) {
+        poolWaitExit(pEventQueue);
+    } else
+#endif
+    {
         U_PORT_MUTEX_LOCK(pEventQueue->taskRunningMutex);
         U_PORT_MUTEX_UNLOCK(pEventQueue->taskRunningMutex);
+    }
 
-        // Tidy up
-        uPortMutexDelete(pEventQueue->taskRunningMutex);
-        errorCode = uPortQueueDelete(pEventQueue->queue);
+    // Tidy up
+    uPortMutexDelete(pEventQueue->taskRunningMutex);
+    errorCode = uPortQueueDelete(pEventQueue->queue);
+    if (pEventQueue->highPriorityQueue != NULL) {
+        uPortQueueDelete(pEventQueue->highPriorityQueue);
+    }
 
-        // Pause here to allow the deletions
-        // above to actually occur in the idle thread,
-        // required by some RTOSs (e.g. FreeRTOS)
-        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+    // Pause here to allow the deletions
+    // above to actually occur in the idle thread,
+    // required by some RTOSs (e.g. FreeRTOS)
+    uPortTaskBlock(U_CFG_OS_YIELD_MS);
 
-        // Now remove it from the list and free it
-        gpEventQueue[pEventQueue->handle] = NULL;
-        uPortFree(pEventQueue);
-    }
+    // Now remove it from the list and free it
+    eventQueueSet(pEventQueue->handle, NULL);
+    uPortFree(pEventQueue);
 
     return errorCode;
 }
@@ -233,6 +541,126 @@ static inline uEventQueue_t *pEventQueueGet(int32_t handle)
     return pEventQueue;
 }
 
+// Send to an event queue, either a copy of the parameter block or,
+// if byPointer is true, a pointer to it.
+static int32_t eventQueueSend(int32_t handle, const void *pParam,
+                              size_t paramLengthBytes, bool byPointer,
+                              void (*pRelease)(void *),
+                              uPortEventQueuePriority_t priority)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    uEventQueue_t *pEventQueue;
+    char block[U_EVENT_QUEUE_ITEM_MAX_LENGTH_BYTES];
+    char *pBlock = NULL;
+    uPortQueueHandle_t queue = NULL;
+    uPortQueueHandle_t highPriorityQueue = NULL;
+    uEventQueue_t *pPooled = NULL;
+    uEventQueuePointer_t pointer;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        pEventQueue = pEventQueueGet(handle);
+        if ((pEventQueue != NULL) &&
+            (byPointer || (paramLengthBytes <= pEventQueue->paramMaxLengthBytes)) &&
+            ((pParam != NULL) || (paramLengthBytes == 0)) &&
+            ((priority == U_PORT_EVENT_QUEUE_PRIORITY_NORMAL) ||
+             (priority == U_PORT_EVENT_QUEUE_PRIORITY_HIGH))) {
+            queue = pEventQueue->queue;
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+            if (pEventQueue->task == NULL) {
+                pPooled = pEventQueue;
+            }
+#endif
+            errorCode = U_ERROR_COMMON_NO_MEMORY;
+            if (priority == U_PORT_EVENT_QUEUE_PRIORITY_HIGH) {
+                highPriorityQueue = pEventQueue->highPriorityQueue;
+                if (highPriorityQueue == NULL) {
+                    // First high priority event: the task may look at
+                    // the queue handle at any time, hence it is only
+                    // set once the queue is complete
+                    if (uPortQueueCreate(U_PORT_EVENT_QUEUE_HIGH_PRIORITY_QUEUE_LENGTH,
+                                         pEventQueue->itemSizeBytes,
+                                         &highPriorityQueue) == 0) {
+                        pEventQueue->highPriorityQueue = highPriorityQueue;
+                    } else {
+                        // Couldn't create it
+                        highPriorityQueue = NULL;
+                        queue = NULL;
+                    }
+                }
+            }
+            if (queue != NULL) {
+                // We need to add the control word to the start of a
+                // block that is the full item size of the queue (not
+                // just the paramLengthBytes passed in, since uPortQueueSend()
+                // will expect to copy the full length); this is on the
+                // stack so that sending requires no heap at all
+                pBlock = block;
+                // Keep memory checkers (e.g. Valgrind) happy
+                memset(pBlock, 0, pEventQueue->itemSizeBytes);
+                if (byPointer) {
+                    //lint -e(826) Suppress area too small
+                    *((uEventQueueControlOrSize_t *) pBlock) = U_EVENT_CONTROL_POINTER;
+                    // The cast drops the const: it is the user function
+                    // that the parameter block is passed to which decides
+                    pointer.pParam = (void *) pParam;
+                    pointer.paramLengthBytes = paramLengthBytes;
+                    pointer.pRelease = pRelease;
+                    memcpy(pBlock + U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES,
+                           &pointer, sizeof(pointer));
+                } else {
+                    // Copy in the control word, which is actually just
+                    // the size in this case
+                    //lint -e(826) Suppress area too small; the size of pBlock is always
+                    // at least U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES in size
+                    *((uEventQueueControlOrSize_t *) pBlock) = (uEventQueueControlOrSize_t) paramLengthBytes;
+                    if (pParam != NULL) {
+                        // Copy in param
+                        //lint -e{826} Suppress pointed-to area too small, we make sure it is OK above
+                        memcpy(pBlock + U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES,
+                               pParam, paramLengthBytes);
+                    }
+                }
+            }
+        }
+
+        // We release the mutex before sending to the
+        // queue since the send process may block (e.g.
+        // if the queue is full) and we don't want
+        // that to block the entire API
+        U_PORT_MUTEX_UNLOCK(gMutex);
+
+        if (pBlock != NULL) {
+            if (highPriorityQueue != NULL) {
+                errorCode = (uErrorCode_t) uPortQueueSend(highPriorityQueue, pBlock);
+                if ((errorCode == U_ERROR_COMMON_SUCCESS) && (pPooled == NULL) &&
+                    (uPortQueueGetFree(queue) > 0)) {
+                    // Wake the task up in case it is waiting on the
+                    // normal queue; if that is full there's no need,
+                    // the task is busy and will get to the high priority
+                    // queue before the next normal event; the pool
+                    // always looks at the high priority queue first
+                    *((uEventQueueControlOrSize_t *) pBlock) = U_EVENT_CONTROL_HIGH_PRIORITY;
+                    uPortQueueSend(queue, pBlock);
+                }
+            } else if (queue != NULL) {
+                // Send it off
+                errorCode = (uErrorCode_t) uPortQueueSend(queue, pBlock);
+            }
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+            if ((errorCode == U_ERROR_COMMON_SUCCESS) && (pPooled != NULL)) {
+                errorCode = (uErrorCode_t) poolSchedule(pPooled);
+            }
+#endif
+        }
+    }
+
+    return (int32_t) errorCode;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: BUT ONES THAT SHOULD BE CALLED INTERNALLY ONLY
  * -------------------------------------------------------------- */
@@ -281,6 +709,13 @@ void uPortEventQueuePrivateDeinit(void)
             }
         }
 
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+        // Stop the pool, if it was started
+        if (gPool.readyQueue != NULL) {
+            poolStop(U_PORT_EVENT_QUEUE_POOL_NUM_TASKS);
+        }
+#endif
+
         U_PORT_MUTEX_UNLOCK(gMutex);
 
         // Finally delete the mutex
@@ -326,41 +761,65 @@ int32_t uPortEventQueueOpen(void (*pFunction) (void *, size_t),
                 pEventQueue = (uEventQueue_t *) pUPortMalloc(sizeof(uEventQueue_t));
                 if (pEventQueue != NULL) {
                     pEventQueue->closed = false;
+                    pEventQueue->highPriorityQueue = NULL;
                     pEventQueue->pFunction = pFunction;
                     pEventQueue->paramMaxLengthBytes = paramMaxLengthBytes;
+                    // Room for either the parameter block or a pointer to one
+                    pEventQueue->itemSizeBytes = paramMaxLengthBytes;
+                    if (pEventQueue->itemSizeBytes < sizeof(uEventQueuePointer_t)) {
+                        pEventQueue->itemSizeBytes = sizeof(uEventQueuePointer_t);
+                    }
+                    pEventQueue->itemSizeBytes += U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES;
+                    pEventQueue->task = NULL;
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+                    pEventQueue->poolPending = false;
+                    pEventQueue->poolBusy = false;
+                    pEventQueue->poolRepeat = false;
+                    pEventQueue->poolExited = false;
+                    pEventQueue->poolTask = NULL;
+#endif
                     // Create the queue
                     handleOrError = (uErrorCode_t) uPortQueueCreate(queueLength,
-                                                                    paramMaxLengthBytes +
-                                                                    U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES,
+                                                                    pEventQueue->itemSizeBytes,
                                                                     &(pEventQueue->queue));
                     if (handleOrError == U_ERROR_COMMON_SUCCESS) {
                         // Create the mutex for task running status
                         handleOrError = (uErrorCode_t) uPortMutexCreate(&(pEventQueue->taskRunningMutex));
                         if (handleOrError == U_ERROR_COMMON_SUCCESS) {
-                            // Finally, create the task itself
+                            // Finally, create the task itself or, if the
+                            // stack it needs is small enough, use the pool
                             if (pName != NULL) {
                                 pTaskName = pName;
                             }
-                            handleOrError = (uErrorCode_t) uPortTaskCreate(eventQueueTask,
-                                                                           pTaskName,
-                                                                           stackSizeBytes,
-                                                                           (void *) pEventQueue,
-                                                                           priority,
-                                                                           &(pEventQueue->task));
-                            if (handleOrError == U_ERROR_COMMON_SUCCESS) {
-                                // Wait for the eventQueueTask to lock the mutex,
-                                // which shows it is running
-                                while (uPortMutexTryLock(pEventQueue->taskRunningMutex, 0) == 0) {
-                                    uPortMutexUnlock(pEventQueue->taskRunningMutex);
-                                    uPortTaskBlock(U_CFG_OS_YIELD_MS);
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+                            if (stackSizeBytes <= U_PORT_EVENT_QUEUE_POOL_TASK_STACK_SIZE_BYTES) {
+                                handleOrError = (uErrorCode_t) poolStart();
+                            } else
+#endif
+                            {
+                                handleOrError = (uErrorCode_t) uPortTaskCreate(eventQueueTask,
+                                                                               pTaskName,
+                                                                               stackSizeBytes,
+                                                                               (void *) pEventQueue,
+                                                                               priority,
+                                                                               &(pEventQueue->task));
+                                if (handleOrError == U_ERROR_COMMON_SUCCESS) {
+                                    // Wait for the eventQueueTask to lock the mutex,
+                                    // which shows it is running
+                                    while (uPortMutexTryLock(pEventQueue->taskRunningMutex, 0) == 0) {
+                                        uPortMutexUnlock(pEventQueue->taskRunningMutex);
+                                        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+                                    }
                                 }
+                            }
+                            if (handleOrError == U_ERROR_COMMON_SUCCESS) {
                                 // Add the event queue structure to the list
                                 pEventQueue->handle = handle;
-                                gpEventQueue[handle] = pEventQueue;
+                                eventQueueSet(handle, pEventQueue);
                                 // Return the handle
                                 handleOrError = (uErrorCode_t) handle;
                             } else {
-                                // Couldn't create the task, delete the
+                                // Couldn't create the task or start the pool, delete the
                                 // mutex and queue and free the structure
                                 uPortMutexDelete(pEventQueue->taskRunningMutex);
                                 uPortQueueDelete(pEventQueue->queue);
@@ -390,64 +849,26 @@ int32_t uPortEventQueueOpen(void (*pFunction) (void *, size_t),
 int32_t uPortEventQueueSend(int32_t handle, const void *pParam,
                             size_t paramLengthBytes)
 {
-    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
-    uEventQueue_t *pEventQueue;
-    char *pBlock = NULL;
-    uPortQueueHandle_t queue = NULL;
-
-    if (gMutex != NULL) {
-
-        U_PORT_MUTEX_LOCK(gMutex);
-
-        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-        pEventQueue = pEventQueueGet(handle);
-        if ((pEventQueue != NULL) &&
-            (paramLengthBytes <= pEventQueue->paramMaxLengthBytes) &&
-            ((pParam != NULL) || (paramLengthBytes == 0))) {
-            queue = pEventQueue->queue;
-            errorCode = U_ERROR_COMMON_NO_MEMORY;
-            // We need to add the control word to the start, so pUPortMalloc
-            // a block that is paramMaxLengthBytes (i.e. paramMaxLengthBytes
-            // of the queue, not just the paramLengthBytes passed in, since
-            // uPortQueueSend() will expect to copy the full length) plus
-            // plus the control word length
-            pBlock = (char *) pUPortMalloc(pEventQueue->paramMaxLengthBytes +
-                                           U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES);
-            if (pBlock != NULL) {
-                // Keep memory checkers (e.g. Valgrind) happy
-                memset(pBlock, 0, pEventQueue->paramMaxLengthBytes +
-                       U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES);
-                // Copy in the control word, which is actually just
-                // the size in this case
-                //lint -e(826) Suppress area too small; the size of pBlock is always
-                // at least U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES in size
-                *((uEventQueueControlOrSize_t *) pBlock) = (uEventQueueControlOrSize_t) paramLengthBytes;
-                if (pParam != NULL) {
-                    // Copy in param
-                    //lint -e{826} Suppress pointed-to area too small, we make sure it is OK above
-                    memcpy(pBlock + U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES,
-                           pParam, paramLengthBytes);
-                }
-            }
-        }
-
-        // We release the mutex before sending to the
-        // queue since the send process may block (e.g.
-        // if the queue is full) and we don't want
-        // that to block the entire API
-        U_PORT_MUTEX_UNLOCK(gMutex);
+    return eventQueueSend(handle, pParam, paramLengthBytes, false, NULL,
+                          U_PORT_EVENT_QUEUE_PRIORITY_NORMAL);
+}
 
-        if (pBlock != NULL) {
-            if (queue != NULL) {
-                // Send it off
-                errorCode = (uErrorCode_t) uPortQueueSend(queue, pBlock);
-            }
-            // Free memory again
-            uPortFree(pBlock);
-        }
-    }
+// Send to an event queue with a priority.
+int32_t uPortEventQueueSendPriority(int32_t handle, const void *pParam,
+                                    size_t paramLengthBytes,
+                                    uPortEventQueuePriority_t priority)
+{
+    return eventQueueSend(handle, pParam, paramLengthBytes, false, NULL,
+                          priority);
+}
 
-    return (int32_t) errorCode;
+// Send a pointer to a parameter block to an event queue.
+int32_t uPortEventQueueSendPointer(int32_t handle, void *pParam,
+                                   size_t paramLengthBytes,
+                                   void (*pRelease)(void *))
+{
+    return eventQueueSend(handle, pParam, paramLengthBytes, true, pRelease,
+                          U_PORT_EVENT_QUEUE_PRIORITY_NORMAL);
 }
 
 // Send to an event queue from an interrupt.
@@ -457,8 +878,6 @@ int32_t uPortEventQueueSendIrq(int32_t handle, const void *pParam,
 #ifndef _WIN32
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
     uEventQueue_t *pEventQueue;
-    char block[paramLengthBytes +
-                                U_PORT_EVENT_QUEUE_CONTROL_OR_SIZE_LENGTH_BYTES];
 
     if (gMutex != NULL) {
         // Can't lock the mutex, we're in an interrupt.
@@ -467,6 +886,8 @@ int32_t uPortEventQueueSendIrq(int32_t handle, const void *pParam,
         if ((pEventQueue != NULL) &&
             (paramLengthBytes <= pEventQueue->paramMaxLengthBytes) &&
             ((pParam != NULL) || (paramLengthBytes == 0))) {
+            // uPortQueueSendIrq() copies a whole item
+            char block[pEventQueue->itemSizeBytes];
             // Copy in the control word, which is actually just
             // the size in this case
             //lint -e(826) Suppress area too small; the size of pBlock is always
@@ -481,6 +902,19 @@ int32_t uPortEventQueueSendIrq(int32_t handle, const void *pParam,
             // Send it off
             errorCode = (uErrorCode_t) uPortQueueSendIrq(pEventQueue->queue,
                                                          block);
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+            if ((errorCode == U_ERROR_COMMON_SUCCESS) && (pEventQueue->task == NULL) &&
+                !pEventQueue->poolPending) {
+                // Can't lock gPool.mutex either: at worst a handle ends up
+                // on the ready queue twice, which the pool tolerates
+                pEventQueue->poolPending = true;
+                errorCode = (uErrorCode_t) uPortQueueSendIrq(gPool.readyQueue,
+                                                             &(pEventQueue->handle));
+                if (errorCode != U_ERROR_COMMON_SUCCESS) {
+                    pEventQueue->poolPending = false;
+                }
+            }
+#endif
         }
     }
 #else
@@ -512,7 +946,15 @@ bool uPortEventQueueIsTask(int32_t handle)
 
         pEventQueue = pEventQueueGet(handle);
         if (pEventQueue != NULL) {
-            isEventTask = uPortTaskIsThis(pEventQueue->task);
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+            if (pEventQueue->task == NULL) {
+                isEventTask = (pEventQueue->poolTask != NULL) &&
+                              uPortTaskIsThis(pEventQueue->poolTask);
+            } else
+#endif
+            {
+                isEventTask = uPortTaskIsThis(pEventQueue->task);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
@@ -534,7 +976,22 @@ int32_t uPortEventQueueStackMinFree(int32_t handle)
         sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         pEventQueue = pEventQueueGet(handle);
         if (pEventQueue != NULL) {
-            sizeOrErrorCode = uPortTaskStackMinFree(pEventQueue->task);
+#if U_PORT_EVENT_QUEUE_POOL_NUM_TASKS > 0
+            if (pEventQueue->task == NULL) {
+                // Any task of the pool might handle the events
+                // of this event queue: report the worst of them
+                int32_t thisSizeOrErrorCode;
+                for (size_t x = 0; x < U_PORT_EVENT_QUEUE_POOL_NUM_TASKS; x++) {
+                    thisSizeOrErrorCode = uPortTaskStackMinFree(gPool.task[x]);
+                    if ((x == 0) || (thisSizeOrErrorCode < sizeOrErrorCode)) {
+                        sizeOrErrorCode = thisSizeOrErrorCode;
+                    }
+                }
+            } else
+#endif
+            {
+                sizeOrErrorCode = uPortTaskStackMinFree(pEventQueue->task);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
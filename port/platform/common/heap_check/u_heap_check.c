@@ -27,6 +27,10 @@
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
 
+#include "u_error_common.h"
+
+#include "u_heap_check.h"
+
 // The platform must provide this:
 extern int uPortInternalGetSbrkFreeBytes();
 
@@ -46,6 +50,20 @@ extern void *__real__realloc_r(struct _reent *reent, void *pMem, size_t size);
  * TYPES
  * -------------------------------------------------------------- */
 
+#if U_HEAP_CHECK_NEWLIB_NANO
+/** A block on the free list of the nano version of newlib, which
+ * must match the chunk structure in its nano-mallocr.c; size
+ * includes the size field itself.
+ */
+typedef struct uHeapCheckNanoChunk_t {
+    long size;
+    struct uHeapCheckNanoChunk_t *pNext;
+} uHeapCheckNanoChunk_t;
+
+// This is provided by the nano version of newlib.
+extern uHeapCheckNanoChunk_t *__malloc_free_list;
+#endif
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -58,10 +76,92 @@ static size_t gHeapSizeBytes = 0;
  */
 static size_t gHeapUsedMaxBytes = 0;
 
+/** The number of allocations since the last sample.
+ */
+static size_t gAllocsSinceSample = 0;
+
+/** The fragmentation of the heap, as of the last sample, plus
+ * the histogram of allocation sizes; only touched with the
+ * malloc lock of newlib held.
+ */
+static uHeapCheckFragmentation_t gFragmentation = {0};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Sample the fragmentation of the heap into gFragmentation; the
+// malloc lock of newlib must be held.
+static void sample()
+{
+    int32_t sbrkFreeBytes = uPortInternalGetSbrkFreeBytes();
+    size_t largestFreeBlockBytes = 0;
+    size_t numFreeBlocks = 0;
+#if U_HEAP_CHECK_NEWLIB_NANO
+    size_t blockBytes;
+#else
+    struct mallinfo mallInfo;
+#endif
+
+    // Memory not yet claimed from sbrk() is one block
+    if (sbrkFreeBytes > 0) {
+        largestFreeBlockBytes = (size_t) sbrkFreeBytes;
+    }
+#if U_HEAP_CHECK_NEWLIB_NANO
+    for (uHeapCheckNanoChunk_t *pChunk = __malloc_free_list; pChunk != NULL;
+         pChunk = pChunk->pNext) {
+        blockBytes = 0;
+        if (pChunk->size > (long) sizeof(pChunk->size)) {
+            blockBytes = (size_t) pChunk->size - sizeof(pChunk->size);
+        }
+        if (blockBytes > largestFreeBlockBytes) {
+            largestFreeBlockBytes = blockBytes;
+        }
+        numFreeBlocks++;
+    }
+#else
+    // The full version of newlib doesn't expose its free
+    // lists, the best that can be done is the top-most block,
+    // which can grow into the memory not yet claimed from sbrk()
+    mallInfo = mallinfo();
+    numFreeBlocks = mallInfo.ordblks;
+    largestFreeBlockBytes += mallInfo.keepcost;
+#endif
+
+    gFragmentation.largestFreeBlockBytes = largestFreeBlockBytes;
+    gFragmentation.numFreeBlocks = numFreeBlocks;
+    if ((gFragmentation.numSamples == 0) ||
+        (largestFreeBlockBytes < gFragmentation.minLargestFreeBlockBytes)) {
+        gFragmentation.minLargestFreeBlockBytes = largestFreeBlockBytes;
+    }
+    if (numFreeBlocks > gFragmentation.maxNumFreeBlocks) {
+        gFragmentation.maxNumFreeBlocks = numFreeBlocks;
+    }
+    gFragmentation.numSamples++;
+}
+
+// Add an allocation to the histogram and sample the fragmentation
+// of the heap if it is time.
+static void allocTrack(size_t sizeBytes)
+{
+    size_t index = 0;
+    size_t limitBytes = U_HEAP_CHECK_HISTOGRAM_BUCKET_0_BYTES;
+
+    while ((sizeBytes >= limitBytes) && (index < U_HEAP_CHECK_HISTOGRAM_NUM_BUCKETS - 1)) {
+        limitBytes <<= 1;
+        index++;
+    }
+
+    __malloc_lock(_REENT);
+    gFragmentation.allocCount[index]++;
+    gAllocsSinceSample++;
+    if (gAllocsSinceSample >= U_HEAP_CHECK_SAMPLE_INTERVAL) {
+        gAllocsSinceSample = 0;
+        sample();
+    }
+    __malloc_unlock(_REENT);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: MALLOC WRAPPERS
  * To use these, add linker option:
@@ -93,6 +193,8 @@ void *__wrap_malloc(size_t sizeBytes)
         gHeapUsedMaxBytes = mallInfo.uordblks;
     }
 
+    allocTrack(sizeBytes);
+
     return pMem;
 }
 
@@ -119,6 +221,8 @@ void *__wrap__malloc_r(void *pReent, size_t sizeBytes)
         gHeapUsedMaxBytes = mallInfo.uordblks;
     }
 
+    allocTrack(sizeBytes);
+
     return pMem;
 }
 
@@ -145,6 +249,8 @@ void *__wrap_calloc(size_t count, size_t sizeBytes)
         gHeapUsedMaxBytes = mallInfo.uordblks;
     }
 
+    allocTrack(count * sizeBytes);
+
     return pMem;
 }
 
@@ -171,6 +277,8 @@ void *__wrap__calloc_r(void *pReent, size_t count, size_t sizeBytes)
         gHeapUsedMaxBytes = mallInfo.uordblks;
     }
 
+    allocTrack(count * sizeBytes);
+
     return pMem;
 }
 
@@ -197,6 +305,8 @@ void *__wrap_realloc(void *pMem, size_t sizeBytes)
         gHeapUsedMaxBytes = mallInfo.uordblks;
     }
 
+    allocTrack(sizeBytes);
+
     return pReallocMem;
 }
 
@@ -223,6 +333,8 @@ void *__wrap__realloc_r(void *pReent, void *pMem, size_t sizeBytes)
         gHeapUsedMaxBytes = mallInfo.uordblks;
     }
 
+    allocTrack(sizeBytes);
+
     return pReallocMem;
 }
 
@@ -244,4 +356,31 @@ size_t uHeapCheckGetMinFree(void)
     return minFree;
 }
 
+// Get the fragmentation of the heap.
+int32_t uHeapCheckGetFragmentation(uHeapCheckFragmentation_t *pFragmentation)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    struct mallinfo mallInfo;
+    int32_t sbrkFreeBytes;
+
+    if (pFragmentation != NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+        if (gHeapSizeBytes > 0) {
+            mallInfo = mallinfo();
+            sbrkFreeBytes = uPortInternalGetSbrkFreeBytes();
+            __malloc_lock(_REENT);
+            sample();
+            *pFragmentation = gFragmentation;
+            __malloc_unlock(_REENT);
+            pFragmentation->freeBytes = mallInfo.fordblks;
+            if (sbrkFreeBytes > 0) {
+                pFragmentation->freeBytes += (size_t) sbrkFreeBytes;
+            }
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    return errorCode;
+}
+
 // End of file
@@ -29,10 +29,67 @@ extern "C" {
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifndef U_HEAP_CHECK_NEWLIB_NANO
+/** Set this to 1 if the platform uses the nano version of newlib
+ * (--specs=nano.specs), in which case the free list of newlib
+ * is walked to find the largest free block and the number of
+ * free blocks; set it to 0 for the full version of newlib, in
+ * which case these are estimated from mallinfo().
+ */
+# define U_HEAP_CHECK_NEWLIB_NANO 1
+#endif
+
+#ifndef U_HEAP_CHECK_SAMPLE_INTERVAL
+/** Fragmentation is sampled once every this many allocations,
+ * in order to track the worst case; it is also sampled each
+ * time uHeapCheckGetFragmentation() is called.
+ */
+# define U_HEAP_CHECK_SAMPLE_INTERVAL 16
+#endif
+
+#ifndef U_HEAP_CHECK_HISTOGRAM_NUM_BUCKETS
+/** The number of buckets in the histogram of allocation sizes:
+ * bucket 0 counts allocations of less than
+ * #U_HEAP_CHECK_HISTOGRAM_BUCKET_0_BYTES, bucket x counts
+ * allocations of at least #U_HEAP_CHECK_HISTOGRAM_BUCKET_0_BYTES
+ * << (x - 1) bytes but less than twice that, and the last bucket
+ * counts all allocations bigger than that.
+ */
+# define U_HEAP_CHECK_HISTOGRAM_NUM_BUCKETS 12
+#endif
+
+#ifndef U_HEAP_CHECK_HISTOGRAM_BUCKET_0_BYTES
+/** The upper limit of bucket 0 of the histogram of allocation
+ * sizes; must be a power of two.
+ */
+# define U_HEAP_CHECK_HISTOGRAM_BUCKET_0_BYTES 16
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The fragmentation of the heap, as returned by
+ * uHeapCheckGetFragmentation().
+ */
+typedef struct {
+    size_t freeBytes;                /**< the total heap free now. */
+    size_t largestFreeBlockBytes;    /**< the largest block that is free now,
+                                          roughly the largest allocation
+                                          that would succeed. */
+    size_t numFreeBlocks;            /**< the number of free blocks now. */
+    size_t minLargestFreeBlockBytes; /**< the smallest value of
+                                          largestFreeBlockBytes seen at
+                                          any sample. */
+    size_t maxNumFreeBlocks;         /**< the largest value of numFreeBlocks
+                                          seen at any sample. */
+    uint32_t numSamples;             /**< the number of samples taken. */
+    uint32_t allocCount[U_HEAP_CHECK_HISTOGRAM_NUM_BUCKETS]; /**< the number
+                                                                  of allocations,
+                                                                  by size, see
+                                                                  #U_HEAP_CHECK_HISTOGRAM_NUM_BUCKETS. */
+} uHeapCheckFragmentation_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -43,6 +100,21 @@ extern "C" {
  */
 size_t uHeapCheckGetMinFree(void);
 
+/** Get the fragmentation of the heap: a long-running device on which
+ * minLargestFreeBlockBytes is heading towards the size of the larger
+ * allocations it makes (e.g. the message buffers of
+ * uGnssPrivateSendReceiveUbxMessageAlloc()) is going to fail one of
+ * those allocations, even if freeBytes is healthy.
+ *
+ * @param[out] pFragmentation a place to put the fragmentation;
+ *                            cannot be NULL.
+ * @return                    zero on success, else negative error
+ *                            code; if there has been no allocation
+ *                            yet #U_ERROR_COMMON_NOT_INITIALISED
+ *                            will be returned.
+ */
+int32_t uHeapCheckGetFragmentation(uHeapCheckFragmentation_t *pFragmentation);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,8 +32,10 @@
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
 #include "string.h"    // memcpy()/memset()
+#include "stdio.h"     // snprintf()
 
 #include "u_cfg_sw.h"
+#include "u_compiler.h" // U_PTR_TO_INT32
 
 #include "u_port.h"
 #include "u_port_os.h"
@@ -48,6 +50,15 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+/** The most that a line of exported trace, aside from the event
+ * name, can occupy.
+ */
+#define U_LOG_RAM_EXPORT_LINE_FIXED_LENGTH_BYTES 112
+
+#if U_LOG_RAM_EXPORT_LINE_MAX_LENGTH_BYTES <= U_LOG_RAM_EXPORT_LINE_FIXED_LENGTH_BYTES
+# error U_LOG_RAM_EXPORT_LINE_MAX_LENGTH_BYTES must be larger than U_LOG_RAM_EXPORT_LINE_FIXED_LENGTH_BYTES
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -75,16 +86,163 @@ static uPortMutexHandle_t gMutex = NULL;
 // Print a single item from a log.
 static void printItem(const uLogRamEntry_t *pItem, size_t itemIndex)
 {
-    if (pItem->event > gULogRamNumStrings) {
-        uPortLog("%10d: out of range event at entry %u (%u when max is %d).\n",
-                 pItem->timestamp, itemIndex, pItem->event, gULogRamNumStrings);
+    // The phase is printed as the opening or closing of a bracket
+    const char *pPhase = " ";
+    int32_t timestampMs = (int32_t) (pItem->timestampUs / 1000);
+    int32_t timestampUsRemainder = (int32_t) (pItem->timestampUs % 1000);
+
+    if (pItem->phase == (uint32_t) U_LOG_RAM_PHASE_BEGIN) {
+        pPhase = "{";
+    } else if (pItem->phase == (uint32_t) U_LOG_RAM_PHASE_END) {
+        pPhase = "}";
+    }
+    if (pItem->event >= gULogRamNumStrings) {
+        uPortLog("%10d.%03d: out of range event at entry %u (%u when max is %d).\n",
+                 timestampMs, timestampUsRemainder, itemIndex, pItem->event,
+                 gULogRamNumStrings);
     } else {
-        uPortLog("%10d: [%3u] %s %d (%#x)\n",  pItem->timestamp,
-                 pItem->event, gULogRamString[pItem->event],
+        uPortLog("%10d.%03d: %08x %s [%3u] %s %d (%#x)\n", timestampMs, timestampUsRemainder,
+                 pItem->taskId, pPhase, pItem->event, gULogRamString[pItem->event],
                  pItem->parameter, pItem->parameter);
     }
 }
 
+// Add an entry to the log.
+static void logEntry(uLogRamPhase_t phase, uLogRamEvent_t event, int32_t parameter)
+{
+    int64_t timestampUs = uPortGetTickTimeUs();
+    uPortTaskHandle_t taskHandle = NULL;
+
+    if ((gpContext != NULL) && (gpContext->pLogNextEmpty)) {
+        // Check if the timestamp has wrapped and
+        // insert a log point before this one if that's the
+        // case (coding gods: please excuse my recursion)
+        if (timestampUs < gpContext->lastLogTimeUs) {
+            gpContext->lastLogTimeUs = timestampUs;
+            logEntry(U_LOG_RAM_PHASE_INSTANT, U_LOG_RAM_EVENT_TIME_WRAP,
+                     (int32_t) (timestampUs / 1000));
+        }
+        uPortTaskGetHandle(&taskHandle);
+        gpContext->lastLogTimeUs = timestampUs;
+        gpContext->pLogNextEmpty->timestampUs = timestampUs;
+        gpContext->pLogNextEmpty->event = (uint32_t) event;
+        gpContext->pLogNextEmpty->parameter = parameter;
+        gpContext->pLogNextEmpty->phase = (uint32_t) phase;
+        gpContext->pLogNextEmpty->taskId = U_PTR_TO_INT32(taskHandle);
+#if defined(U_LOG_RAM_PRINT) || defined(U_LOG_RAM_PRINT_ONLY)
+        printItem(gpContext->pLogNextEmpty, 0);
+#endif
+#ifndef U_LOG_RAM_PRINT_ONLY
+        if (gpContext->pLogNextEmpty < gpContext->pLog + U_LOG_RAM_ENTRIES_MAX_NUM - 1) {
+            gpContext->pLogNextEmpty++;
+        } else {
+            gpContext->pLogNextEmpty = gpContext->pLog;
+        }
+
+        if (gpContext->pLogNextEmpty == gpContext->pLogFirstFull) {
+            // Logging has wrapped, so move the
+            // first pointer on to reflect the
+            // overwrite
+            if (gpContext->pLogFirstFull < gpContext->pLog + U_LOG_RAM_ENTRIES_MAX_NUM - 1) {
+                gpContext->pLogFirstFull++;
+            } else {
+                gpContext->pLogFirstFull = gpContext->pLog;
+            }
+            gpContext->logEntriesOverwritten++;
+        } else {
+            gpContext->numLogItems++;
+        }
+#endif
+    }
+}
+
+// Write a microsecond time as a JSON number, avoiding 64-bit
+// printf() formats, which are not supported everywhere.
+static int32_t writeTimeUs(char *pBuffer, size_t size, int64_t timeUs)
+{
+    int32_t length;
+
+    if (timeUs < 0) {
+        timeUs = 0;
+    }
+    if (timeUs >= 1000000) {
+        length = snprintf(pBuffer, size, "%d%06d", (int32_t) (timeUs / 1000000),
+                          (int32_t) (timeUs % 1000000));
+    } else {
+        length = snprintf(pBuffer, size, "%d", (int32_t) timeUs);
+    }
+
+    return length;
+}
+
+// Export a single item from a log as a line of Chrome trace event
+// JSON, returning the length of the line.
+static int32_t exportItem(const uLogRamEntry_t *pItem, bool isFirst,
+                          char *pBuffer, size_t size)
+{
+    int32_t length = 0;
+    int32_t x;
+    const char *pName = "OUT_OF_RANGE";
+    const char *pPhase = "\"ph\":\"i\",\"s\":\"t\"";
+
+    if (pItem->event < gULogRamNumStrings) {
+        pName = gULogRamString[pItem->event];
+        // Skip the " "/"*" markers at the start of the strings
+        while ((*pName == ' ') || (*pName == '*')) {
+            pName++;
+        }
+    }
+    if (pItem->phase == (uint32_t) U_LOG_RAM_PHASE_BEGIN) {
+        pPhase = "\"ph\":\"B\"";
+    } else if (pItem->phase == (uint32_t) U_LOG_RAM_PHASE_END) {
+        pPhase = "\"ph\":\"E\"";
+    }
+    length = snprintf(pBuffer, size, "%s{\"name\":\"", isFirst ? "" : ",\n");
+    // Copy in the name, escaping anything that JSON would object to
+    // and leaving room for the rest of the line
+    for (; (*pName != 0) &&
+         (length < (int32_t) (size - U_LOG_RAM_EXPORT_LINE_FIXED_LENGTH_BYTES)); pName++) {
+        if ((*pName == '"') || (*pName == '\\')) {
+            *(pBuffer + length) = '\\';
+            length++;
+        }
+        if ((uint8_t) *pName >= ' ') {
+            *(pBuffer + length) = *pName;
+            length++;
+        }
+    }
+    x = snprintf(pBuffer + length, size - length, "\",%s,\"ts\":", pPhase);
+    if (x > 0) {
+        length += x;
+        x = writeTimeUs(pBuffer + length, size - length, pItem->timestampUs);
+    }
+    if (x > 0) {
+        length += x;
+        x = snprintf(pBuffer + length, size - length,
+                     ",\"pid\":0,\"tid\":%u,\"args\":{\"parameter\":%d}}",
+                     (uint32_t) pItem->taskId, pItem->parameter);
+    }
+    if (x > 0) {
+        length += x;
+    }
+    if (length >= (int32_t) size) {
+        length = (int32_t) size - 1;
+    }
+
+    return length;
+}
+
+// Write out a piece of exported trace.
+static void exportWrite(uLogRamWrite_t *pWrite, void *pWriteParam,
+                        const char *pBuffer, size_t size)
+{
+    if (pWrite != NULL) {
+        pWrite(pBuffer, size, pWriteParam);
+    } else {
+        uPortLog("%.*s", (int32_t) size, pBuffer);
+    }
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -120,7 +278,7 @@ bool uLogRamInit(void *pBuffer)
                 gpContext->pLogFirstFull = gpContext->pLog;
                 gpContext->numLogItems = 0;
                 gpContext->logEntriesOverwritten = 0;
-                gpContext->lastLogTime = uPortGetTickTimeMs();
+                gpContext->lastLogTimeUs = uPortGetTickTimeUs();
                 gpContext->magicWord = 0x123456;
             }
 
@@ -162,45 +320,19 @@ void uLogRamDeinit()
 // Log an event plus parameter.
 void uLogRam(uLogRamEvent_t event, int32_t parameter)
 {
-    int32_t timestamp = uPortGetTickTimeMs();
+    logEntry(U_LOG_RAM_PHASE_INSTANT, event, parameter);
+}
 
-    if ((gpContext != NULL) && (gpContext->pLogNextEmpty)) {
-        // Check if the timestamp has wrapped and
-        // insert a log point before this one if that's the
-        // case (coding gods: please excuse my recursion)
-        if (timestamp < gpContext->lastLogTime) {
-            gpContext->lastLogTime = timestamp;
-            uLogRam(U_LOG_RAM_EVENT_TIME_WRAP, timestamp);
-        }
-        gpContext->lastLogTime = timestamp;
-        gpContext->pLogNextEmpty->timestamp = timestamp;
-        gpContext->pLogNextEmpty->event = (uint32_t) event;
-        gpContext->pLogNextEmpty->parameter = parameter;
-#if defined(U_LOG_RAM_PRINT) || defined(U_LOG_RAM_PRINT_ONLY)
-        printItem(gpContext->pLogNextEmpty, 0);
-#endif
-#ifndef U_LOG_RAM_PRINT_ONLY
-        if (gpContext->pLogNextEmpty < gpContext->pLog + U_LOG_RAM_ENTRIES_MAX_NUM - 1) {
-            gpContext->pLogNextEmpty++;
-        } else {
-            gpContext->pLogNextEmpty = gpContext->pLog;
-        }
+// Log the beginning of a span.
+void uLogRamBegin(uLogRamEvent_t event, int32_t parameter)
+{
+    logEntry(U_LOG_RAM_PHASE_BEGIN, event, parameter);
+}
 
-        if (gpContext->pLogNextEmpty == gpContext->pLogFirstFull) {
-            // Logging has wrapped, so move the
-            // first pointer on to reflect the
-            // overwrite
-            if (gpContext->pLogFirstFull < gpContext->pLog + U_LOG_RAM_ENTRIES_MAX_NUM - 1) {
-                gpContext->pLogFirstFull++;
-            } else {
-                gpContext->pLogFirstFull = gpContext->pLog;
-            }
-            gpContext->logEntriesOverwritten++;
-        } else {
-            gpContext->numLogItems++;
-        }
-#endif
-    }
+// Log the end of a span.
+void uLogRamEnd(uLogRamEvent_t event, int32_t parameter)
+{
+    logEntry(U_LOG_RAM_PHASE_END, event, parameter);
 }
 
 // Log an event plus parameter, this time with mutex protection.
@@ -230,9 +362,11 @@ size_t uLogRamGet(uLogRamEntry_t *pEntries, size_t numEntries)
         while ((pItem != gpContext->pLogNextEmpty) &&
                (itemCount < numEntries)) {
             if (gpContext->logEntriesOverwritten > 0) {
-                uLogRamEntry_t insert = {pItem->timestamp,
+                uLogRamEntry_t insert = {pItem->timestampUs,
                                          U_LOG_RAM_EVENT_ENTRIES_OVERWRITTEN,
-                                         (int32_t) gpContext->logEntriesOverwritten
+                                         (int32_t) gpContext->logEntriesOverwritten,
+                                         (uint32_t) U_LOG_RAM_PHASE_INSTANT,
+                                         pItem->taskId
                                         };
                 memcpy(pEntries, &insert, sizeof(*pEntries));
                 itemCount++;
@@ -308,4 +442,41 @@ void uLogRamPrint()
     }
 }
 
+// Export the log as a trace.
+size_t uLogRamExportTrace(uLogRamWrite_t *pWrite, void *pWriteParam)
+{
+    const uLogRamEntry_t *pItem;
+    char buffer[U_LOG_RAM_EXPORT_LINE_MAX_LENGTH_BYTES];
+    int32_t length;
+    size_t x = 0;
+
+    if (gpContext != NULL) {
+
+        if (gMutex != NULL) {
+            U_PORT_MUTEX_LOCK(gMutex);
+        }
+
+        length = snprintf(buffer, sizeof(buffer), "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+        exportWrite(pWrite, pWriteParam, buffer, length);
+        pItem = gpContext->pLogFirstFull;
+        while (pItem != gpContext->pLogNextEmpty) {
+            length = exportItem(pItem, x == 0, buffer, sizeof(buffer));
+            exportWrite(pWrite, pWriteParam, buffer, length);
+            x++;
+            pItem++;
+            if (pItem >= gpContext->pLog + U_LOG_RAM_ENTRIES_MAX_NUM) {
+                pItem = gpContext->pLog;
+            }
+        }
+        length = snprintf(buffer, sizeof(buffer), "\n]}\n");
+        exportWrite(pWrite, pWriteParam, buffer, length);
+
+        if (gMutex != NULL) {
+            U_PORT_MUTEX_UNLOCK(gMutex);
+        }
+    }
+
+    return x;
+}
+
 // End of file
@@ -22,6 +22,7 @@
  * of another module should be included here; otherwise
  * please keep #includes to your .c files. */
 
+#include "stddef.h"
 #include "stdint.h"
 #include "stdbool.h"
 
@@ -30,10 +31,19 @@
 /** @file
  * @brief This logging utility allows events to be logged to RAM at minimal
  * run-time cost.  Each entry includes an event, a 32 bit parameter (which
- * is printed with the event) and a millisecond time-stamp.  This code
- * is not multithreaded in that there can only be a single log buffer
- * at any one time, however the functions, aside from uLogRam(),
- * are mutex-protected.
+ * is printed with the event), a microsecond time-stamp, an identifier
+ * for the task that logged it and whether the entry is an instant or
+ * marks the beginning or end of a span, so that the log can be exported
+ * as a trace, see uLogRamExportTrace().  This code is not multithreaded
+ * in that there can only be a single log buffer at any one time,
+ * however the functions, aside from uLogRam(), uLogRamBegin() and
+ * uLogRamEnd(), are mutex-protected.
+ *
+ * If U_CFG_LOG_RAM_TRACE is defined for the build then this header
+ * is brought in by u_port_debug.h and the trace points in the ubxlib
+ * code (the AT client, CMUX, EDM and GNSS streaming paths), which are
+ * otherwise compiled out, log to RAM; nothing is logged until
+ * uLogRamInit() has been called.
  */
 
 #ifdef __cplusplus
@@ -50,18 +60,49 @@ extern "C" {
 # define U_LOG_RAM_ENTRIES_MAX_NUM 500
 #endif
 
+/** The maximum length of a line of exported trace, including
+ * the event name; must be more than 112.
+ */
+#ifndef U_LOG_RAM_EXPORT_LINE_MAX_LENGTH_BYTES
+# define U_LOG_RAM_EXPORT_LINE_MAX_LENGTH_BYTES 192
+#endif
+
+#ifdef U_CFG_LOG_RAM_TRACE
+/** Trace points in the ubxlib code: an instant.
+ */
+# define U_LOG_RAM_TRACE(event, parameter) uLogRam(event, parameter)
+
+/** Trace points in the ubxlib code: the beginning of a span.
+ */
+# define U_LOG_RAM_TRACE_BEGIN(event, parameter) uLogRamBegin(event, parameter)
+
+/** Trace points in the ubxlib code: the end of a span.
+ */
+# define U_LOG_RAM_TRACE_END(event, parameter) uLogRamEnd(event, parameter)
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
 
+/** The phase of a log entry.
+ */
+typedef enum {
+    U_LOG_RAM_PHASE_INSTANT = 0,
+    U_LOG_RAM_PHASE_BEGIN,  /**< the start of a span, see uLogRamBegin(). */
+    U_LOG_RAM_PHASE_END     /**< the end of a span, see uLogRamEnd(). */
+} uLogRamPhase_t;
+
 /** An entry in the log.
  */
 typedef struct {
-    int32_t timestamp;
+    int64_t timestampUs;
     uint32_t event; // This will be #uLogRamEvent_t but it is stored as an int
     // so that we are guaranteed to get a 32-bit value,
     // making it easier to decode logs on another platform
     int32_t parameter;
+    uint32_t phase; // #uLogRamPhase_t, stored as an int for the same reason
+    int32_t taskId; // The bottom 32 bits of the handle of the logging task
 } uLogRamEntry_t;
 
 
@@ -75,13 +116,22 @@ typedef struct {
     uLogRamEntry_t const *pLogFirstFull;
     size_t numLogItems;
     size_t logEntriesOverwritten;
-    int32_t lastLogTime;
+    int64_t lastLogTimeUs;
 } uLogRamContext_t;
 
 /** The size of the log store, given the number of entries requested.
  */
 #define U_LOG_RAM_STORE_SIZE (sizeof(uLogRamContext_t) + (sizeof(uLogRamEntry_t) * U_LOG_RAM_ENTRIES_MAX_NUM))
 
+/** Callback used by uLogRamExportTrace() to write out the trace.
+ *
+ * @param[in] pBuffer the data to write; not NULL-terminated.
+ * @param size        the number of bytes at pBuffer.
+ * @param[in] pParam  the parameter that was passed to
+ *                    uLogRamExportTrace().
+ */
+typedef void (uLogRamWrite_t)(const char *pBuffer, size_t size, void *pParam);
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -109,6 +159,23 @@ void uLogRamDeinit();
  */
 void uLogRam(uLogRamEvent_t event, int32_t parameter);
 
+/** Log the beginning of a span to RAM; as uLogRam() but the entry
+ * opens a span which is closed by a call to uLogRamEnd() from the
+ * same task.  Spans from a given task may be nested.
+ *
+ * @param event     the event.
+ * @param parameter the parameter.
+ */
+void uLogRamBegin(uLogRamEvent_t event, int32_t parameter);
+
+/** Log the end of a span to RAM, see uLogRamBegin().
+ *
+ * @param event     the event, usually the one passed to uLogRamBegin().
+ * @param parameter the parameter, which need not be the same as the
+ *                  one passed to uLogRamBegin().
+ */
+void uLogRamEnd(uLogRamEvent_t event, int32_t parameter);
+
 /** Log an event plus parameter to RAM, employing a mutex to protect the
  * log contents.  This will take longer, potentially a lot longer,
  * than uLogRam() so call this only in applications where you don't
@@ -136,6 +203,24 @@ size_t uLogRamGetNumEntries();
  */
 void uLogRamPrint();
 
+/** Export the currently logged items, without removing them, in
+ * Chrome trace event (JSON) format, which can be loaded into
+ * https://ui.perfetto.dev or chrome://tracing.  Each task that
+ * logged has its own track; entries logged with uLogRamBegin()
+ * and uLogRamEnd() become spans and those logged with uLogRam()
+ * or uLogRamX() become instants.
+ *
+ * @param[in] pWrite      the function that writes out the trace,
+ *                        for instance to a file; may be NULL
+ *                        in which case the trace is printed with
+ *                        uPortLog(), from where it can be cut and
+ *                        pasted into a ".json" file.
+ * @param[in] pWriteParam a parameter that will be passed to pWrite;
+ *                        may be NULL.
+ * @return                the number of log entries exported.
+ */
+size_t uLogRamExportTrace(uLogRamWrite_t *pWrite, void *pWriteParam);
+
 #ifdef __cplusplus
 }
 #endif
@@ -37,7 +37,7 @@ extern "C" {
 
 /** Increment this variable if you make any changes to the enum below.
  */
-#define U_LOG_RAM_VERSION 0
+#define U_LOG_RAM_VERSION 1
 
 /* ----------------------------------------------------------------
  * TYPES
@@ -66,6 +66,13 @@ typedef enum {
     U_LOG_RAM_EVENT_USER_7,
     U_LOG_RAM_EVENT_USER_8,
     U_LOG_RAM_EVENT_USER_9,
+    // Trace points in ubxlib, see U_CFG_LOG_RAM_TRACE
+    U_LOG_RAM_EVENT_AT_CLIENT_LOCK,
+    U_LOG_RAM_EVENT_AT_CLIENT_URC,
+    U_LOG_RAM_EVENT_CELL_MUX_DECODE,
+    U_LOG_RAM_EVENT_EDM_RECEIVE,
+    U_LOG_RAM_EVENT_EDM_SEND,
+    U_LOG_RAM_EVENT_GNSS_STREAM_FILL,
     // Add your own named log points in u_log_ram_enum_user.h
 #include "u_log_ram_enum_user.h"
 } uLogRamEvent_t;
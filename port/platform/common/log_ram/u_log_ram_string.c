@@ -53,6 +53,13 @@ const char *gULogRamString[] = {
     "  USER_7",
     "  USER_8",
     "  USER_9",
+    // Trace points in ubxlib, do not change
+    "  AT_CLIENT_LOCK",
+    "  AT_CLIENT_URC",
+    "  CELL_MUX_DECODE",
+    "  EDM_RECEIVE",
+    "  EDM_SEND",
+    "  GNSS_STREAM_FILL",
     // Specific log points defined by the user
 #include "u_log_ram_string_user.h"
 };
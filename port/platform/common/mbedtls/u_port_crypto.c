@@ -15,7 +15,9 @@
  */
 
 /** @file
- * @brief Implementation of the crypto API using mbedTLS.
+ * @brief Implementation of the crypto API using mbedTLS; if
+ * U_PORT_CRYPTO_HW is defined each operation is first offered to
+ * the hardware backend of the platform (see u_port_crypto_hw.h).
  */
 
 #ifdef U_CFG_OVERRIDE
@@ -35,6 +37,10 @@
 #include "u_port.h"
 #include "u_port_crypto.h"
 
+#ifdef U_PORT_CRYPTO_HW
+# include "u_port_crypto_hw.h"
+#endif
+
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
@@ -51,6 +57,53 @@
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+#ifndef U_PORT_CRYPTO_HW
+// No hardware backend: always use mbedTLS.
+static int32_t uPortCryptoHwSha256(const char *pInput,
+                                   size_t inputLengthBytes,
+                                   char *pOutput)
+{
+    (void) pInput;
+    (void) inputLengthBytes;
+    (void) pOutput;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// No hardware backend: always use mbedTLS.
+static int32_t uPortCryptoHwHmacSha256(const char *pKey,
+                                       size_t keyLengthBytes,
+                                       const char *pInput,
+                                       size_t inputLengthBytes,
+                                       char *pOutput)
+{
+    (void) pKey;
+    (void) keyLengthBytes;
+    (void) pInput;
+    (void) inputLengthBytes;
+    (void) pOutput;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// No hardware backend: always use mbedTLS.
+static int32_t uPortCryptoHwAes128Cbc(bool encrypt,
+                                      const char *pKey,
+                                      size_t keyLengthBytes,
+                                      char *pInitVector,
+                                      const char *pInput,
+                                      size_t lengthBytes,
+                                      char *pOutput)
+{
+    (void) encrypt;
+    (void) pKey;
+    (void) keyLengthBytes;
+    (void) pInitVector;
+    (void) pInput;
+    (void) lengthBytes;
+    (void) pOutput;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+#endif
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -68,10 +121,13 @@ int32_t uPortCryptoSha256(const char *pInput,
 
     if (((pInput != NULL) || (inputLengthBytes == 0)) &&
         (pOutput != NULL)) {
-        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
-        mbedtls_sha256((const unsigned char *) pInput,
-                       inputLengthBytes,
-                       (unsigned char *) pOutput, 0);
+        errorCode = uPortCryptoHwSha256(pInput, inputLengthBytes, pOutput);
+        if (errorCode == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            mbedtls_sha256((const unsigned char *) pInput,
+                           inputLengthBytes,
+                           (unsigned char *) pOutput, 0);
+        }
     }
 
     return errorCode;
@@ -84,14 +140,24 @@ int32_t uPortCryptoHmacSha256(const char *pKey,
                               size_t inputLengthBytes,
                               char *pOutput)
 {
-    // mbedTLS has it sorted
-    const mbedtls_md_info_t *pInfo = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
-    return mbedtls_md_hmac(pInfo,
-                           (const unsigned char *) pKey,
-                           keyLengthBytes,
-                           (const unsigned char *) pInput,
-                           inputLengthBytes,
-                           (unsigned char *) pOutput);
+    int32_t errorCode;
+    const mbedtls_md_info_t *pInfo;
+
+    errorCode = uPortCryptoHwHmacSha256(pKey, keyLengthBytes,
+                                        pInput, inputLengthBytes,
+                                        pOutput);
+    if (errorCode == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED) {
+        // mbedTLS has it sorted
+        pInfo = mbedtls_md_info_from_type(MBEDTLS_MD_SHA256);
+        errorCode = mbedtls_md_hmac(pInfo,
+                                    (const unsigned char *) pKey,
+                                    keyLengthBytes,
+                                    (const unsigned char *) pInput,
+                                    inputLengthBytes,
+                                    (unsigned char *) pOutput);
+    }
+
+    return errorCode;
 }
 
 // Perform AES 128 CBC encryption of a block of data.
@@ -105,16 +171,21 @@ int32_t uPortCryptoAes128CbcEncrypt(const char *pKey,
     int32_t errorCode;
     mbedtls_aes_context context;
 
-    errorCode = mbedtls_aes_setkey_enc(&context,
-                                       (const unsigned char *) pKey,
-                                       keyLengthBytes * 8);
-    if (errorCode == 0) {
-        errorCode = mbedtls_aes_crypt_cbc(&context,
-                                          MBEDTLS_AES_ENCRYPT,
-                                          lengthBytes,
-                                          (unsigned char *) pInitVector,
-                                          (const unsigned char *) pInput,
-                                          (unsigned char *) pOutput);
+    errorCode = uPortCryptoHwAes128Cbc(true, pKey, keyLengthBytes,
+                                       pInitVector, pInput,
+                                       lengthBytes, pOutput);
+    if (errorCode == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED) {
+        errorCode = mbedtls_aes_setkey_enc(&context,
+                                           (const unsigned char *) pKey,
+                                           keyLengthBytes * 8);
+        if (errorCode == 0) {
+            errorCode = mbedtls_aes_crypt_cbc(&context,
+                                              MBEDTLS_AES_ENCRYPT,
+                                              lengthBytes,
+                                              (unsigned char *) pInitVector,
+                                              (const unsigned char *) pInput,
+                                              (unsigned char *) pOutput);
+        }
     }
 
     return errorCode;
@@ -131,16 +202,21 @@ int32_t uPortCryptoAes128CbcDecrypt(const char *pKey,
     int32_t errorCode;
     mbedtls_aes_context context;
 
-    errorCode = mbedtls_aes_setkey_dec(&context,
-                                       (const unsigned char *) pKey,
-                                       keyLengthBytes * 8);
-    if (errorCode == 0) {
-        errorCode = mbedtls_aes_crypt_cbc(&context,
-                                          MBEDTLS_AES_DECRYPT,
-                                          lengthBytes,
-                                          (unsigned char *) pInitVector,
-                                          (const unsigned char *) pInput,
-                                          (unsigned char *) pOutput);
+    errorCode = uPortCryptoHwAes128Cbc(false, pKey, keyLengthBytes,
+                                       pInitVector, pInput,
+                                       lengthBytes, pOutput);
+    if (errorCode == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED) {
+        errorCode = mbedtls_aes_setkey_dec(&context,
+                                           (const unsigned char *) pKey,
+                                           keyLengthBytes * 8);
+        if (errorCode == 0) {
+            errorCode = mbedtls_aes_crypt_cbc(&context,
+                                              MBEDTLS_AES_DECRYPT,
+                                              lengthBytes,
+                                              (unsigned char *) pInitVector,
+                                              (const unsigned char *) pInput,
+                                              (unsigned char *) pOutput);
+        }
     }
 
     return errorCode;
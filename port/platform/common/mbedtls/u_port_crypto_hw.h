@@ -0,0 +1,116 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_PORT_CRYPTO_HW_H_
+#define _U_PORT_CRYPTO_HW_H_
+
+/** @file
+ * @brief Hardware crypto backend for the mbedTLS implementation of
+ * the crypto API.  When U_PORT_CRYPTO_HW is defined, u_port_crypto.c
+ * first offers each operation to the functions here, which a platform
+ * implements using its crypto accelerator; should the accelerator not
+ * be able to do the job (e.g. it is not present, it is busy or the data
+ * are not somewhere it can reach) such a function returns
+ * #U_ERROR_COMMON_NOT_SUPPORTED and the mbedTLS software
+ * implementation is used instead.  The parameters are as for the
+ * functions of u_port_crypto.h, and are checked before these functions
+ * are called.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Perform a SHA256 calculation on a block of data in hardware.
+ *
+ * @param[in] pInput        a pointer to the input data.
+ * @param inputLengthBytes  the length of the input data.
+ * @param[out] pOutput      a pointer to at least
+ *                          #U_PORT_CRYPTO_SHA256_OUTPUT_LENGTH_BYTES
+ *                          of storage for the output.
+ * @return                  zero on success, #U_ERROR_COMMON_NOT_SUPPORTED
+ *                          if the software implementation should be
+ *                          used, else negative error code.
+ */
+int32_t uPortCryptoHwSha256(const char *pInput,
+                            size_t inputLengthBytes,
+                            char *pOutput);
+
+/** Perform a HMAC SHA256 calculation on a block of data in hardware.
+ *
+ * @param[in] pKey          a pointer to the key.
+ * @param keyLengthBytes    the length of the key.
+ * @param[in] pInput        a pointer to the input data.
+ * @param inputLengthBytes  the length of the input data.
+ * @param[out] pOutput      a pointer to at least
+ *                          #U_PORT_CRYPTO_SHA256_OUTPUT_LENGTH_BYTES
+ *                          of storage for the output.
+ * @return                  zero on success, #U_ERROR_COMMON_NOT_SUPPORTED
+ *                          if the software implementation should be
+ *                          used, else negative error code.
+ */
+int32_t uPortCryptoHwHmacSha256(const char *pKey,
+                                size_t keyLengthBytes,
+                                const char *pInput,
+                                size_t inputLengthBytes,
+                                char *pOutput);
+
+/** Perform AES 128 CBC encryption or decryption of a block of data
+ * in hardware.
+ *
+ * @param encrypt             true to encrypt, false to decrypt.
+ * @param[in] pKey            a pointer to the key.
+ * @param keyLengthBytes      the length of the key.
+ * @param[in,out] pInitVector a pointer to the
+ *                            #U_PORT_CRYPTO_AES128_INITIALISATION_VECTOR_LENGTH_BYTES
+ *                            initialisation vector, which is updated
+ *                            on success, exactly as mbedTLS would.
+ * @param[in] pInput          a pointer to the input data.
+ * @param lengthBytes         the length of the input data, a multiple
+ *                            of 16 bytes.
+ * @param[out] pOutput        a pointer to lengthBytes of storage for
+ *                            the output.
+ * @return                    zero on success, #U_ERROR_COMMON_NOT_SUPPORTED
+ *                            if the software implementation should be
+ *                            used, else negative error code.
+ */
+int32_t uPortCryptoHwAes128Cbc(bool encrypt,
+                               const char *pKey,
+                               size_t keyLengthBytes,
+                               char *pInitVector,
+                               const char *pInput,
+                               size_t lengthBytes,
+                               char *pOutput);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _U_PORT_CRYPTO_HW_H_
+
+// End of file
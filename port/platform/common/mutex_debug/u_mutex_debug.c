@@ -85,9 +85,41 @@ typedef struct uMutexFunctionInfo_t {
     const char *pFile; // If this is NULL the entry is not in use.
     int32_t line;
     int32_t counter;
+#ifdef U_MUTEX_DEBUG_PROFILE
+    int64_t startTimeUs; // When a waiting entry started waiting
+    bool contended; // True if a waiting entry found the mutex locked
+#endif
     struct uMutexFunctionInfo_t *pNext;
 } uMutexFunctionInfo_t;
 
+#ifdef U_MUTEX_DEBUG_PROFILE
+/** Contention statistics for a place in the code that waited
+ * for a mutex.
+ */
+typedef struct {
+    const char *pFile; // If this is NULL the entry is not in use.
+    int32_t line;
+    uint32_t count;
+    int64_t waitTotalUs;
+    int64_t waitMaxUs;
+} uMutexProfileWaiter_t;
+
+/** Contention statistics for the mutexes created at a place in
+ * the code.
+ */
+typedef struct {
+    const char *pFile; // If this is NULL the entry is not in use.
+    int32_t line;
+    uint32_t lockCount;
+    uint32_t contendedCount;
+    int64_t waitTotalUs;
+    int64_t waitMaxUs;
+    int64_t holdTotalUs;
+    int64_t holdMaxUs;
+    uMutexProfileWaiter_t waiter[U_MUTEX_DEBUG_PROFILE_WAITER_MAX_NUM];
+} uMutexProfile_t;
+#endif
+
 /** A structure to keep track of a mutex as part of a linked list.
  * Note that the handle MUST be the first member of the structure.
  * This is because, when simulating critical sections under Windows,
@@ -99,6 +131,10 @@ typedef struct uMutexInfo_t {
     uMutexFunctionInfo_t *pCreator; // If this is NULL the entry is not in use.
     uMutexFunctionInfo_t *pLocker;
     uMutexFunctionInfo_t *pWaiting;
+#ifdef U_MUTEX_DEBUG_PROFILE
+    uMutexProfile_t *pProfile; // May be NULL if the profile array is full
+    int64_t lockTimeUs;
+#endif
     struct uMutexInfo_t *pNext;
 } uMutexInfo_t;
 
@@ -149,6 +185,13 @@ static uMutexInfo_t gMutexInfo[U_MUTEX_DEBUG_MUTEX_INFO_MAX_NUM];
  */
 static uMutexFunctionInfo_t gMutexFunctionInfo[U_MUTEX_DEBUG_FUNCTION_INFO_MAX_NUM];
 
+#ifdef U_MUTEX_DEBUG_PROFILE
+/** Array of contention statistics, one for each place in the code
+ * that mutexes are created.
+ */
+static uMutexProfile_t gMutexProfile[U_MUTEX_DEBUG_PROFILE_MAX_NUM];
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS; ONES THAT DO NOT LOCK THE LIST MUTEX
  * -------------------------------------------------------------- */
@@ -197,6 +240,10 @@ static uMutexInfo_t *pAllocMutexInformationBlock()
             pMutexInfo->pWaiting = NULL;
             pMutexInfo->handle = NULL;
             pMutexInfo->pNext = NULL;
+#ifdef U_MUTEX_DEBUG_PROFILE
+            pMutexInfo->pProfile = NULL;
+            pMutexInfo->lockTimeUs = 0;
+#endif
         }
     }
 
@@ -289,6 +336,120 @@ static bool unlinkWaiting(uMutexInfo_t *pMutexInfo,
     return success;
 }
 
+#ifdef U_MUTEX_DEBUG_PROFILE
+
+// Find or allocate the contention statistics for a place in the
+// code where mutexes are created.
+// gMutexList should be locked before this is called.
+static uMutexProfile_t *pGetProfile(const char *pFile, int32_t line)
+{
+    uMutexProfile_t *pProfile = NULL;
+    uMutexProfile_t *pFree = NULL;
+
+    for (size_t x = 0; (x < sizeof(gMutexProfile) / sizeof(gMutexProfile[0])) &&
+         (pProfile == NULL); x++) {
+        if (gMutexProfile[x].pFile == NULL) {
+            if (pFree == NULL) {
+                pFree = &(gMutexProfile[x]);
+            }
+        } else if ((gMutexProfile[x].line == line) &&
+                   (strcmp(gMutexProfile[x].pFile, pFile) == 0)) {
+            pProfile = &(gMutexProfile[x]);
+        }
+    }
+    if ((pProfile == NULL) && (pFree != NULL)) {
+        pProfile = pFree;
+        memset(pProfile, 0, sizeof(*pProfile));
+        pProfile->pFile = pFile;
+        pProfile->line = line;
+    }
+
+    return pProfile;
+}
+
+// Record a lock in the contention statistics, pWaiting being
+// the now-successful waiting entry.
+// gMutexList should be locked before this is called.
+static void profileLock(uMutexInfo_t *pMutexInfo,
+                        const uMutexFunctionInfo_t *pWaiting)
+{
+    uMutexProfile_t *pProfile = pMutexInfo->pProfile;
+    uMutexProfileWaiter_t *pWaiter = NULL;
+    uMutexProfileWaiter_t *pLeast = NULL;
+    int64_t waitUs;
+
+    pMutexInfo->lockTimeUs = uPortGetTickTimeUs();
+    if (pProfile != NULL) {
+        waitUs = pMutexInfo->lockTimeUs - pWaiting->startTimeUs;
+        pProfile->lockCount++;
+        pProfile->waitTotalUs += waitUs;
+        if (waitUs > pProfile->waitMaxUs) {
+            pProfile->waitMaxUs = waitUs;
+        }
+        if (pWaiting->contended) {
+            pProfile->contendedCount++;
+            // Find the waiter, else a free entry, else the entry
+            // that has waited least, which this one replaces if
+            // it has already waited longer
+            for (size_t x = 0; (x < sizeof(pProfile->waiter) / sizeof(pProfile->waiter[0])) &&
+                 (pWaiter == NULL); x++) {
+                if ((pProfile->waiter[x].pFile == NULL) ||
+                    ((pProfile->waiter[x].line == pWaiting->line) &&
+                     (strcmp(pProfile->waiter[x].pFile, pWaiting->pFile) == 0))) {
+                    pWaiter = &(pProfile->waiter[x]);
+                } else if ((pLeast == NULL) ||
+                           (pProfile->waiter[x].waitTotalUs < pLeast->waitTotalUs)) {
+                    pLeast = &(pProfile->waiter[x]);
+                }
+            }
+            if ((pWaiter == NULL) && (pLeast != NULL) && (waitUs > pLeast->waitTotalUs)) {
+                pWaiter = pLeast;
+                pWaiter->pFile = NULL;
+            }
+            if (pWaiter != NULL) {
+                if (pWaiter->pFile == NULL) {
+                    memset(pWaiter, 0, sizeof(*pWaiter));
+                    pWaiter->pFile = pWaiting->pFile;
+                    pWaiter->line = pWaiting->line;
+                }
+                pWaiter->count++;
+                pWaiter->waitTotalUs += waitUs;
+                if (waitUs > pWaiter->waitMaxUs) {
+                    pWaiter->waitMaxUs = waitUs;
+                }
+            }
+        }
+    }
+}
+
+// Record an unlock in the contention statistics.
+// gMutexList should be locked before this is called.
+static void profileUnlock(const uMutexInfo_t *pMutexInfo)
+{
+    uMutexProfile_t *pProfile = pMutexInfo->pProfile;
+    int64_t holdUs;
+
+    if ((pProfile != NULL) && (pMutexInfo->pLocker != NULL)) {
+        holdUs = uPortGetTickTimeUs() - pMutexInfo->lockTimeUs;
+        pProfile->holdTotalUs += holdUs;
+        if (holdUs > pProfile->holdMaxUs) {
+            pProfile->holdMaxUs = holdUs;
+        }
+    }
+}
+
+// Limit a time to what will fit in an int32_t, for printing.
+static int32_t timeForPrint(int64_t time)
+{
+    if (time > INT32_MAX) {
+        time = INT32_MAX;
+    }
+
+    return (int32_t) time;
+}
+
+#endif // U_MUTEX_DEBUG_PROFILE
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS: ONES THAT LOCK THE LIST MUTEX
  * -------------------------------------------------------------- */
@@ -310,6 +471,10 @@ static uMutexFunctionInfo_t *pLockAddWaiting(uMutexInfo_t *pMutexInfo,
         if (pWaiting != NULL) {
             pWaiting->pFile = pFile;
             pWaiting->line = line;
+#ifdef U_MUTEX_DEBUG_PROFILE
+            pWaiting->startTimeUs = uPortGetTickTimeUs();
+            pWaiting->contended = (pMutexInfo->pLocker != NULL);
+#endif
             // Add it to the front of the waiting list
             pTmp = pMutexInfo->pWaiting;
             pMutexInfo->pWaiting = pWaiting;
@@ -339,6 +504,9 @@ static bool lockMoveWaitingToLocker(uMutexInfo_t *pMutexInfo,
         // disappeared in the meantime
         success = unlinkWaiting(pMutexInfo, pWaiting);
         if (success) {
+#ifdef U_MUTEX_DEBUG_PROFILE
+            profileLock(pMutexInfo, pWaiting);
+#endif
             // The waiting entry is now the locker
             pMutexInfo->pLocker = pWaiting;
             // Zero the counter
@@ -468,6 +636,9 @@ int32_t uMutexDebugCreate(uPortMutexHandle_t *pMutexHandle,
                 pMutexInfo->pCreator->pNext = NULL;
                 pMutexInfo->pLocker = NULL;
                 pMutexInfo->pWaiting = NULL;
+#ifdef U_MUTEX_DEBUG_PROFILE
+                pMutexInfo->pProfile = pGetProfile(pFile, line);
+#endif
                 if (_uPortMutexCreate(&(pMutexInfo->handle)) == 0) {
                     // Add the entry to the front of the list
                     pTmp = gpMutexInfoList;
@@ -584,6 +755,9 @@ int32_t uMutexDebugUnlock(uPortMutexHandle_t mutexHandle)
 
         U_MUTEX_DEBUG_PORT_MUTEX_LOCK(gMutexList);
 
+#ifdef U_MUTEX_DEBUG_PROFILE
+        profileUnlock(pMutexInfo);
+#endif
         // Unlock the mutex and free the locker entry
         errorCode = _uPortMutexUnlock(pMutexInfo->handle);
         freeFunctionInformationBlock(pMutexInfo->pLocker);
@@ -607,6 +781,9 @@ int32_t uMutexDebugInit(void)
     if (gMutexList == NULL) {
         memset(gMutexInfo, 0, sizeof(gMutexInfo));
         memset(gMutexFunctionInfo, 0, sizeof(gMutexFunctionInfo));
+#ifdef U_MUTEX_DEBUG_PROFILE
+        memset(gMutexProfile, 0, sizeof(gMutexProfile));
+#endif
         errorCode = _uPortMutexCreate(&gMutexList);
         if (errorCode == 0) {
             // Mark this as a perpetual mutex for accounting purposes
@@ -758,6 +935,93 @@ void uMutexDebugPrint(void *pParam)
     }
 }
 
+#ifdef U_MUTEX_DEBUG_PROFILE
+
+// Print out the mutex contention profile.
+void uMutexDebugProfilePrint(void *pParam)
+{
+    int16_t order[U_MUTEX_DEBUG_PROFILE_MAX_NUM];
+    size_t numProfiles = 0;
+    size_t y;
+    const uMutexProfile_t *pProfile;
+    const uMutexProfileWaiter_t *pWaiter;
+
+    (void) pParam;
+
+    if (gMutexList != NULL) {
+
+        U_MUTEX_DEBUG_PORT_MUTEX_LOCK(gMutexList);
+
+        // Insertion sort the profiles that have been
+        // locked into order of total waiting time
+        for (size_t x = 0; x < sizeof(gMutexProfile) / sizeof(gMutexProfile[0]); x++) {
+            if ((gMutexProfile[x].pFile != NULL) && (gMutexProfile[x].lockCount > 0)) {
+                for (y = numProfiles; (y > 0) &&
+                     (gMutexProfile[order[y - 1]].waitTotalUs < gMutexProfile[x].waitTotalUs); y--) {
+                    order[y] = order[y - 1];
+                }
+                order[y] = (int16_t) x;
+                numProfiles++;
+            }
+        }
+
+        for (size_t x = 0; x < numProfiles; x++) {
+            pProfile = &(gMutexProfile[order[x]]);
+            uPortLog("U_MUTEX_DEBUG_PROFILE: %s:%d: %u lock(s), %u contended,"
+                     " waiting %d ms in total (max %d us), held %d ms in total"
+                     " (max %d us).\n",
+                     pProfile->pFile, pProfile->line,
+                     pProfile->lockCount, pProfile->contendedCount,
+                     timeForPrint(pProfile->waitTotalUs / 1000),
+                     timeForPrint(pProfile->waitMaxUs),
+                     timeForPrint(pProfile->holdTotalUs / 1000),
+                     timeForPrint(pProfile->holdMaxUs));
+            for (y = 0; y < sizeof(pProfile->waiter) / sizeof(pProfile->waiter[0]); y++) {
+                pWaiter = &(pProfile->waiter[y]);
+                if (pWaiter->pFile != NULL) {
+                    uPortLog("U_MUTEX_DEBUG_PROFILE:   waiter %s:%d: %u time(s),"
+                             " %d ms in total (max %d us).\n",
+                             pWaiter->pFile, pWaiter->line, pWaiter->count,
+                             timeForPrint(pWaiter->waitTotalUs / 1000),
+                             timeForPrint(pWaiter->waitMaxUs));
+                }
+            }
+        }
+        uPortLog("U_MUTEX_DEBUG_PROFILE: %d place(s) where mutexes were created"
+                 " and locked.\n", (int32_t) numProfiles);
+
+        U_MUTEX_DEBUG_PORT_MUTEX_UNLOCK(gMutexList);
+    }
+}
+
+// Reset the mutex contention profile.
+void uMutexDebugProfileReset(void)
+{
+    uMutexProfile_t *pProfile;
+
+    if (gMutexList != NULL) {
+
+        U_MUTEX_DEBUG_PORT_MUTEX_LOCK(gMutexList);
+
+        // Keep the entries, since existing mutexes point
+        // to them, just zero the statistics
+        for (size_t x = 0; x < sizeof(gMutexProfile) / sizeof(gMutexProfile[0]); x++) {
+            pProfile = &(gMutexProfile[x]);
+            pProfile->lockCount = 0;
+            pProfile->contendedCount = 0;
+            pProfile->waitTotalUs = 0;
+            pProfile->waitMaxUs = 0;
+            pProfile->holdTotalUs = 0;
+            pProfile->holdMaxUs = 0;
+            memset(pProfile->waiter, 0, sizeof(pProfile->waiter));
+        }
+
+        U_MUTEX_DEBUG_PORT_MUTEX_UNLOCK(gMutexList);
+    }
+}
+
+#endif // U_MUTEX_DEBUG_PROFILE
+
 #endif // U_CFG_MUTEX_DEBUG
 
 // End of file
@@ -90,6 +90,16 @@
  * U_MUTEX_DEBUG_0x2000a7e8: created by C:/projects/ubxlib/port/platform/stm32cube/src/u_port_uart.c:892 approx. 12 second(s) ago is not locked.
  * U_MUTEX_DEBUG_0x2000a840: created by C:/projects/ubxlib/port/platform/common/event_queue/u_port_event_queue.c:229 approx. 12 second(s) ago is not locked.
  * U_MUTEX_DEBUG: 3 mutex(es), 1 locked, a maximum of 1 waiting, max waiting time approx. 12 second(s).
+ *
+ * If, in addition, U_MUTEX_DEBUG_PROFILE is defined, contention is
+ * profiled: for the mutexes created at each place in the code, the
+ * number of locks, how many of those had to wait for another locker,
+ * the total and maximum time spent waiting for and holding the lock,
+ * and the places in the code that waited the longest, are recorded,
+ * cheaply enough to be left running in a soak test.  Call
+ * uMutexDebugProfilePrint() to print the results, busiest first, and
+ * uMutexDebugProfileReset() to start again, e.g. once the system
+ * has reached a steady state.
  */
 
 #ifdef __cplusplus
@@ -127,6 +137,23 @@ extern "C" {
 # define U_MUTEX_DEBUG_WATCHDOG_MAX_BARK_SECONDS 10
 #endif
 
+#ifndef U_MUTEX_DEBUG_PROFILE_MAX_NUM
+/** The maximum number of places in the code where mutexes are
+ * created that U_MUTEX_DEBUG_PROFILE will keep statistics for;
+ * all of the mutexes created at the same place (e.g. one for each
+ * socket) share statistics.
+ */
+# define U_MUTEX_DEBUG_PROFILE_MAX_NUM 64
+#endif
+
+#ifndef U_MUTEX_DEBUG_PROFILE_WAITER_MAX_NUM
+/** The number of places in the code, those which have waited
+ * longest in total, that U_MUTEX_DEBUG_PROFILE will record
+ * as waiting for the mutexes created at one place.
+ */
+# define U_MUTEX_DEBUG_PROFILE_WAITER_MAX_NUM 4
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -279,6 +306,21 @@ int32_t uMutexDebugWatchdog(void (*pCallback) (void *),
  */
 void uMutexDebugPrint(void *pParam);
 
+/** Print out the mutex contention profile, only available if
+ * U_MUTEX_DEBUG_PROFILE is defined.  The places in the code where
+ * mutexes were created are printed in order of the total time
+ * spent waiting for them.
+ *
+ * @param pParam  a dummy parameter so that this function matches
+ *                the function signature for uMutexDebugWatchdog().
+ */
+void uMutexDebugProfilePrint(void *pParam);
+
+/** Reset the mutex contention profile, only available if
+ * U_MUTEX_DEBUG_PROFILE is defined.
+ */
+void uMutexDebugProfileReset(void);
+
 #ifdef __cplusplus
 }
 #endif
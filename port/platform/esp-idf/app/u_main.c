@@ -116,6 +116,10 @@ static void appTask(void *pParam)
     // called deinit so call init again here.
     uPortInit();
 
+#if defined(U_CFG_MUTEX_DEBUG) && defined(U_MUTEX_DEBUG_PROFILE)
+    uMutexDebugProfilePrint(NULL);
+#endif
+
     UNITY_END();
 
     uPortDeinit();
@@ -142,6 +142,12 @@ int32_t uPortGetTickTimeMs()
     return esp_timer_get_time() / 1000;
 }
 
+// Get the current time in microseconds.
+int64_t uPortGetTickTimeUs()
+{
+    return esp_timer_get_time();
+}
+
 // Get the minimum amount of heap free, ever, in bytes.
 int32_t uPortGetHeapMinFree()
 {
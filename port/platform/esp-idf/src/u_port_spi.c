@@ -23,6 +23,7 @@
 #include "stdbool.h"
 #include "string.h"  // memset()
 
+#include "u_cfg_os_platform_specific.h" // U_CFG_OS_PRIORITY_MAX
 #include "u_compiler.h" // U_ATOMIC_XXX() macros
 
 #include "u_error_common.h"
@@ -52,6 +53,20 @@
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Structure to keep track of background reception, followed in
+ * memory by bufferSizeBytes of fill to send.
+ */
+typedef struct {
+    int32_t handle;
+    char *pBuffer;
+    size_t bufferSizeBytes;
+    int32_t intervalMs;
+    uPortSpiReceiveCallback_t *pCallback;
+    void *pCallbackParam;
+    uPortSemaphoreHandle_t exitedSemaphore;
+    volatile bool stop;
+} uPortSpiReceiveAsync_t;
+
 /** Structure of the things we need to keep track of per SPI instance.
  */
 typedef struct {
@@ -60,6 +75,7 @@ typedef struct {
     uint8_t fillByte;
     spi_device_handle_t deviceHandle; // NULL if no device has been opened
     spi_device_interface_config_t *pDeviceCfg;
+    uPortSpiReceiveAsync_t *pReceiveAsync; // NULL if there is no background reception
     bool initialised; // false if entry not in use.
 } uPortSpiData_t;
 
@@ -119,6 +135,66 @@ static int32_t transfer(uPortSpiData_t *pSpiData, spi_transaction_t *pTransactio
     return errorCode;
 }
 
+// The task that runs background reception: each transfer is queued
+// to the DMA-driven SPI driver with gMutex locked, so that blocking
+// transfers are held off, and the buffer is handed to the callback
+// with gMutex unlocked.
+static void receiveAsyncTask(void *pParam)
+{
+    uPortSpiReceiveAsync_t *pReceiveAsync = (uPortSpiReceiveAsync_t *) pParam;
+    uPortSpiData_t *pSpiData = &(gSpiData[pReceiveAsync->handle]);
+    uPortSemaphoreHandle_t exitedSemaphore = pReceiveAsync->exitedSemaphore;
+    spi_transaction_t transaction;
+    char *pReceive;
+    size_t index = 0;
+    int32_t startTimeMs;
+    int32_t waitMs;
+    int32_t errorCode;
+
+    while (!pReceiveAsync->stop) {
+        startTimeMs = uPortGetTickTimeMs();
+        pReceive = pReceiveAsync->pBuffer + (index * pReceiveAsync->bufferSizeBytes);
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        if (pSpiData->deviceHandle != NULL) {
+            memset(&transaction, 0, sizeof(transaction));
+            if (pSpiData->pinMosi >= 0) {
+                // Must send as much as we receive: send the fill
+                // that follows the structure
+                transaction.tx_buffer = pReceiveAsync + 1;
+                transaction.length = pReceiveAsync->bufferSizeBytes * 8;
+            }
+            transaction.rx_buffer = pReceive;
+            transaction.rxlength = pReceiveAsync->bufferSizeBytes * 8;
+            errorCode = transfer(pSpiData, &transaction);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+
+        if (errorCode == 0) {
+            pReceiveAsync->pCallback(pReceiveAsync->handle, pReceive,
+                                     pReceiveAsync->bufferSizeBytes,
+                                     pReceiveAsync->pCallbackParam);
+            // The other buffer is filled next
+            index = (index + 1) & 1;
+        }
+
+        waitMs = pReceiveAsync->intervalMs - (uPortGetTickTimeMs() - startTimeMs);
+        if (waitMs < U_CFG_OS_YIELD_MS) {
+            // Always give others a chance
+            waitMs = U_CFG_OS_YIELD_MS;
+        }
+        uPortTaskBlock(waitMs);
+    }
+
+    // pReceiveAsync may be free'd as soon as this is given
+    uPortSemaphoreGive(exitedSemaphore);
+
+    uPortTaskDelete(NULL);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -485,6 +561,95 @@ int32_t uPortSpiControllerSendReceiveBlock(int32_t handle, const char *pSend,
     return errorCodeOrReceiveSize;
 }
 
+// Start background reception.
+int32_t uPortSpiControllerReceiveAsyncStart(int32_t handle, char *pBuffer,
+                                            size_t bufferSizeBytes,
+                                            int32_t intervalMs,
+                                            uPortSpiReceiveCallback_t *pCallback,
+                                            void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortSpiData_t *pSpiData;
+    uPortSpiReceiveAsync_t *pReceiveAsync;
+    uPortTaskHandle_t taskHandle;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) && (handle < sizeof(gSpiData) / sizeof(gSpiData[0])) &&
+            gSpiData[handle].initialised && (gSpiData[handle].deviceHandle != NULL) &&
+            (gSpiData[handle].pinMiso >= 0) && (gSpiData[handle].pReceiveAsync == NULL) &&
+            (pBuffer != NULL) && (bufferSizeBytes > 0) && (intervalMs >= 0) &&
+            (pCallback != NULL)) {
+            pSpiData = &(gSpiData[handle]);
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pReceiveAsync = (uPortSpiReceiveAsync_t *) pUPortMalloc(sizeof(*pReceiveAsync) +
+                                                                    bufferSizeBytes);
+            if (pReceiveAsync != NULL) {
+                memset(pReceiveAsync, 0, sizeof(*pReceiveAsync));
+                memset(pReceiveAsync + 1, pSpiData->fillByte, bufferSizeBytes);
+                pReceiveAsync->handle = handle;
+                pReceiveAsync->pBuffer = pBuffer;
+                pReceiveAsync->bufferSizeBytes = bufferSizeBytes;
+                pReceiveAsync->intervalMs = intervalMs;
+                pReceiveAsync->pCallback = pCallback;
+                pReceiveAsync->pCallbackParam = pCallbackParam;
+                errorCode = uPortSemaphoreCreate(&(pReceiveAsync->exitedSemaphore), 0, 1);
+                if (errorCode == 0) {
+                    errorCode = uPortTaskCreate(receiveAsyncTask, "spiReceiveAsync",
+                                                U_PORT_SPI_RECEIVE_ASYNC_TASK_STACK_SIZE_BYTES,
+                                                (void *) pReceiveAsync,
+                                                U_PORT_SPI_RECEIVE_ASYNC_TASK_PRIORITY,
+                                                &taskHandle);
+                    if (errorCode == 0) {
+                        pSpiData->pReceiveAsync = pReceiveAsync;
+                    } else {
+                        uPortSemaphoreDelete(pReceiveAsync->exitedSemaphore);
+                    }
+                }
+                if (errorCode != 0) {
+                    // Clean up on error
+                    uPortFree(pReceiveAsync);
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
+// Stop background reception.
+void uPortSpiControllerReceiveAsyncStop(int32_t handle)
+{
+    uPortSpiReceiveAsync_t *pReceiveAsync = NULL;
+
+    if ((gMutex != NULL) && (handle >= 0) &&
+        (handle < sizeof(gSpiData) / sizeof(gSpiData[0]))) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        pReceiveAsync = gSpiData[handle].pReceiveAsync;
+        gSpiData[handle].pReceiveAsync = NULL;
+        if (pReceiveAsync != NULL) {
+            pReceiveAsync->stop = true;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+
+        if (pReceiveAsync != NULL) {
+            // Wait for the task to exit, with gMutex unlocked since
+            // the task may need it in order to get there
+            uPortSemaphoreTake(pReceiveAsync->exitedSemaphore);
+            uPortSemaphoreDelete(pReceiveAsync->exitedSemaphore);
+            uPortFree(pReceiveAsync);
+        }
+    }
+}
+
 // Get the number of SPI interfaces currently open.
 int32_t uPortSpiResourceAllocCount()
 {
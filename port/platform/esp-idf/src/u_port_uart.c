@@ -25,6 +25,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memcpy()
 
 #include "u_cfg_sw.h"
 #include "u_cfg_hw_platform_specific.h"
@@ -35,6 +36,7 @@
 #include "u_port_debug.h"
 #include "u_port.h"
 #include "u_port_os.h"
+#include "u_port_heap.h"
 #include "u_port_uart.h"
 
 #include "driver/uart.h"
@@ -53,6 +55,14 @@
  */
 #define U_PORT_UART_EVENT_MIN_TASK_STACK_SIZE_BYTES 768
 
+#ifndef U_PORT_UART_SPAN_BUFFER_SIZE_BYTES
+/** The ESP-IDF UART driver does not expose its receive buffer,
+ * hence uPortUartReadSpan() reads from the driver into a buffer
+ * of this size, allocated the first time it is called for a UART.
+ */
+# define U_PORT_UART_SPAN_BUFFER_SIZE_BYTES 256
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -68,6 +78,12 @@ typedef struct {
     uint32_t eventFilter;
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
+    char *pSpanBuffer; /**< Data taken from the driver by uPortUartReadSpan(). */
+    size_t spanSize; /**< The number of bytes at pSpanBuffer. */
+    size_t spanRead; /**< The number of bytes at pSpanBuffer already consumed. */
+    uPortUartStats_t stats; /**< The error counts are only gathered while an event task is running. */
+    bool bufferFull; /**< The driver has reported UART_BUFFER_FULL and nothing has been read since. */
+    int32_t bufferFullStartMs;
 } uPortUartData_t;
 
 /* ----------------------------------------------------------------
@@ -154,17 +170,62 @@ static void uartCloseRequiresMutex(int32_t handle)
         // Shut down the driver, which will delete the queue
         uart_driver_delete(handle);
 
+        uPortFree(gUartData[handle].pSpanBuffer);
+        gUartData[handle].pSpanBuffer = NULL;
+
         // Set queue to NULL to mark this as free
         gUartData[handle].queue = NULL;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
     }
 }
 
+// Count the bytes read from the driver for a UART, ending any
+// period for which its receive buffer was full; gMutex must be
+// locked.
+static void statsRead(uPortUartData_t *pUartData, int32_t numBytes)
+{
+    if (numBytes > 0) {
+        pUartData->stats.bytesReceived += (uint32_t) numBytes;
+        if (pUartData->bufferFull) {
+            pUartData->bufferFull = false;
+            pUartData->stats.bufferFullTimeMs += uPortGetTickTimeMs() -
+                                                 pUartData->bufferFullStartMs;
+        }
+    }
+}
+
+// Count a fault event from the ESP-IDF driver for a UART; gMutex
+// must be locked.
+static void statsEvent(uPortUartData_t *pUartData, uart_event_type_t esp32Event)
+{
+    switch (esp32Event) {
+        case UART_FIFO_OVF:
+            pUartData->stats.overrunCount++;
+            break;
+        case UART_BUFFER_FULL:
+            if (!pUartData->bufferFull) {
+                pUartData->bufferFull = true;
+                pUartData->bufferFullStartMs = uPortGetTickTimeMs();
+                pUartData->stats.bufferFullCount++;
+            }
+            break;
+        case UART_FRAME_ERR:
+            pUartData->stats.framingErrorCount++;
+            break;
+        case UART_PARITY_ERR:
+            pUartData->stats.parityErrorCount++;
+            break;
+        default:
+            break;
+    }
+}
+
 // Event handler.  If an event callback is registered for a UART
 // this will be run in a task of its own for that UART.
 static void eventTask(void *pParam)
 {
     uart_event_t event;
+    uart_event_t nextEvent;
     int32_t handle = (int32_t) pParam;
     uint32_t eventBitMask;
 
@@ -173,6 +234,21 @@ static void eventTask(void *pParam)
     do {
         if (uPortQueueReceive((const uPortQueueHandle_t) gUartData[handle].queue,
                               &event) == 0) {
+            // The ESP-IDF driver queues a UART_DATA event for every
+            // burst received; coalesce any that are already queued
+            // behind this one as the callback will read everything
+            // there is anyway
+            while ((event.type == UART_DATA) &&
+                   (uPortQueuePeek((const uPortQueueHandle_t) gUartData[handle].queue,
+                                   &nextEvent) == 0) &&
+                   (nextEvent.type == UART_DATA) &&
+                   (uPortQueueTryReceive((const uPortQueueHandle_t) gUartData[handle].queue,
+                                         0, &event) == 0)) {}
+            if ((event.type != UART_DATA) && (event.type < UART_EVENT_MAX)) {
+                U_PORT_MUTEX_LOCK(gMutex);
+                statsEvent(&(gUartData[handle]), event.type);
+                U_PORT_MUTEX_UNLOCK(gMutex);
+            }
             // Check if it is in the filter
             eventBitMask = getEventFromEsp32Event(event.type);
             if (eventBitMask & gUartData[handle].eventFilter) {
@@ -282,6 +358,11 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
             gUartData[uart].pEventCallback = NULL;
             gUartData[uart].pEventCallbackParam = NULL;
             gUartData[uart].eventFilter = 0;
+            gUartData[uart].pSpanBuffer = NULL;
+            gUartData[uart].spanSize = 0;
+            gUartData[uart].spanRead = 0;
+            memset(&(gUartData[uart].stats), 0, sizeof(gUartData[uart].stats));
+            gUartData[uart].bufferFull = false;
 
             // Set the things that won't change
             config.data_bits  = UART_DATA_8_BITS;
@@ -395,7 +476,8 @@ int32_t uPortUartGetReceiveSize(int32_t handle)
 
             // Will get back either size or -1
             if (uart_get_buffered_data_len(handle, &receiveSize) == 0) {
-                sizeOrErrorCode = receiveSize;
+                sizeOrErrorCode = receiveSize + gUartData[handle].spanSize -
+                                  gUartData[handle].spanRead;
             }
         }
 
@@ -410,6 +492,9 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
                       size_t sizeBytes)
 {
     int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+    size_t thisSize;
+    int x;
 
     if (gMutex != NULL) {
 
@@ -420,12 +505,82 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
             (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
             !gUartData[handle].markedForDeletion) {
 
-            // Will get back either size or -1
-            sizeOrErrorCode = uart_read_bytes(handle,
-                                              (uint8_t *) pBuffer,
-                                              sizeBytes, 0);
-            if (sizeOrErrorCode < 0) {
-                sizeOrErrorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+            // Anything taken from the driver by uPortUartReadSpan()
+            // but not yet consumed comes first
+            pUartData = &(gUartData[handle]);
+            thisSize = pUartData->spanSize - pUartData->spanRead;
+            if (thisSize > sizeBytes) {
+                thisSize = sizeBytes;
+            }
+            if (thisSize > 0) {
+                memcpy(pBuffer, pUartData->pSpanBuffer + pUartData->spanRead, thisSize);
+                pUartData->spanRead += thisSize;
+            }
+            sizeOrErrorCode = (int32_t) thisSize;
+            if (thisSize < sizeBytes) {
+                // Will get back either size or -1
+                x = uart_read_bytes(handle,
+                                    (uint8_t *) pBuffer + thisSize,
+                                    sizeBytes - thisSize, 0);
+                if (x >= 0) {
+                    sizeOrErrorCode += x;
+                    statsRead(pUartData, x);
+                } else if (thisSize == 0) {
+                    sizeOrErrorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
+// Get a pointer to the received data.
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+    int x;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((ppData != NULL) && (handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].queue != NULL) &&
+            !gUartData[handle].markedForDeletion) {
+            pUartData = &(gUartData[handle]);
+            sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            if (pUartData->pSpanBuffer == NULL) {
+                pUartData->pSpanBuffer = (char *) pUPortMalloc(U_PORT_UART_SPAN_BUFFER_SIZE_BYTES);
+            }
+            if (pUartData->pSpanBuffer != NULL) {
+                sizeOrErrorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                if (pUartData->spanRead >= pUartData->spanSize) {
+                    // All consumed, take what there is from the driver
+                    pUartData->spanSize = 0;
+                    pUartData->spanRead = 0;
+                    // Will get back either size or -1
+                    x = uart_read_bytes(handle, (uint8_t *) pUartData->pSpanBuffer,
+                                        U_PORT_UART_SPAN_BUFFER_SIZE_BYTES, 0);
+                    if (x >= 0) {
+                        pUartData->spanSize = x;
+                        statsRead(pUartData, x);
+                    } else {
+                        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+                    }
+                }
+                if (sizeOrErrorCode == 0) {
+                    *ppData = NULL;
+                    sizeOrErrorCode = (int32_t) (pUartData->spanSize - pUartData->spanRead);
+                    if (sizeOrErrorCode > 0) {
+                        *ppData = pUartData->pSpanBuffer + pUartData->spanRead;
+                    }
+                }
             }
         }
 
@@ -435,6 +590,34 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     return sizeOrErrorCode;
 }
 
+// Remove data obtained with uPortUartReadSpan().
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            !gUartData[handle].markedForDeletion) {
+            pUartData = &(gUartData[handle]);
+            if (sizeBytes > pUartData->spanSize - pUartData->spanRead) {
+                sizeBytes = pUartData->spanSize - pUartData->spanRead;
+            }
+            pUartData->spanRead += sizeBytes;
+            sizeOrErrorCode = (int32_t) sizeBytes;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
 // Write to the given UART interface.
 int32_t uPortUartWrite(int32_t handle,
                        const void *pBuffer,
@@ -463,7 +646,9 @@ int32_t uPortUartWrite(int32_t handle,
             sizeOrErrorCode = uart_write_bytes(handle,
                                                (const char *) pBuffer,
                                                sizeBytes);
-            if (sizeOrErrorCode < 0) {
+            if (sizeOrErrorCode >= 0) {
+                gUartData[handle].stats.bytesSent += (uint32_t) sizeOrErrorCode;
+            } else {
                 sizeOrErrorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
             }
         }
@@ -857,6 +1042,59 @@ void uPortUartCtsResume(int32_t handle)
     }
 }
 
+// Get the statistics of a UART.
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pStats != NULL) && (handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].queue != NULL) &&
+            !gUartData[handle].markedForDeletion) {
+            *pStats = gUartData[handle].stats;
+            if (gUartData[handle].bufferFull) {
+                pStats->bufferFullTimeMs += uPortGetTickTimeMs() -
+                                            gUartData[handle].bufferFullStartMs;
+            }
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
+// Reset the statistics of a UART.
+int32_t uPortUartStatsReset(int32_t handle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].queue != NULL) &&
+            !gUartData[handle].markedForDeletion) {
+            memset(&(gUartData[handle].stats), 0, sizeof(gUartData[handle].stats));
+            gUartData[handle].bufferFullStartMs = uPortGetTickTimeMs();
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
 // Get the number of UART interfaces currently open.
 int32_t uPortUartResourceAllocCount()
 {
@@ -27,6 +27,7 @@
 
 #include "time.h"
 #include "unistd.h"
+#include "pthread.h"
 #include "malloc.h"
 
 #include "u_cfg_sw.h"
@@ -55,6 +56,17 @@
  * VARIABLES
  * -------------------------------------------------------------- */
 
+/** The timezone offset last worked out by
+ * uPortGetTimezoneOffsetSeconds() and the period of
+ * #U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS in which it was worked out.
+ */
+static int32_t gTimezoneOffsetSeconds = 0;
+static time_t gTimezoneOffsetSlot = -1;
+
+/** Protection for the two variables above.
+ */
+static pthread_mutex_t gTimezoneMutex = PTHREAD_MUTEX_INITIALIZER;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -114,6 +126,17 @@ int32_t uPortGetTickTimeMs()
     return ms;
 }
 
+// Get the current time in microseconds.
+int64_t uPortGetTickTimeUs()
+{
+    int64_t us = 0;
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) == 0) {
+        us = (((int64_t) ts.tv_sec) * 1000000) + (ts.tv_nsec / 1000);
+    }
+    return us;
+}
+
 // Get the minimum amount of heap free, ever, in bytes.
 int32_t uPortGetHeapMinFree()
 {
@@ -134,21 +157,31 @@ int32_t uPortGetHeapFree()
 
 int32_t uPortGetTimezoneOffsetSeconds()
 {
+    int32_t offsetSeconds;
     struct tm utcTm;
     time_t utc;
-    time_t mktimeSays;
+    time_t slot = -1;
 
     utc = time(NULL);
-    utcTm = *gmtime(&utc);
-    // Setting daylight saving flag to -1 causes mktime()
-    // to decide whether DST is in effect
-    utcTm.tm_isdst = -1;
-    mktimeSays = mktime(&utcTm);
-    // mktime will have subtracted the timezone from what it was
-    // given in order to return local time, hence the timezone
-    // offset is the difference
-
-    return (int32_t)(utc - mktimeSays);
+#if U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS > 0
+    slot = utc / U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS;
+#endif
+    pthread_mutex_lock(&gTimezoneMutex);
+    if ((slot < 0) || (slot != gTimezoneOffsetSlot)) {
+        gmtime_r(&utc, &utcTm);
+        // Setting daylight saving flag to -1 causes mktime()
+        // to decide whether DST is in effect
+        utcTm.tm_isdst = -1;
+        // mktime will have subtracted the timezone from what it was
+        // given in order to return local time, hence the timezone
+        // offset is the difference
+        gTimezoneOffsetSeconds = (int32_t) (utc - mktime(&utcTm));
+        gTimezoneOffsetSlot = slot;
+    }
+    offsetSeconds = gTimezoneOffsetSeconds;
+    pthread_mutex_unlock(&gTimezoneMutex);
+
+    return offsetSeconds;
 }
 
 // End of file
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Implementation of the memory-mapped file API on Linux.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "fcntl.h"
+#include "unistd.h"
+#include "sys/mman.h"
+
+#include "u_port_file_map.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Create a file and map it into memory.
+void *pUPortFileMap(const char *pPath, size_t sizeBytes)
+{
+    void *pMap = NULL;
+    int fd;
+
+    if ((pPath != NULL) && (sizeBytes > 0)) {
+        fd = open(pPath, O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (fd >= 0) {
+            if (ftruncate(fd, (off_t) sizeBytes) == 0) {
+                pMap = mmap(NULL, sizeBytes, PROT_READ | PROT_WRITE,
+                            MAP_SHARED, fd, 0);
+                if (pMap == MAP_FAILED) {
+                    pMap = NULL;
+                }
+            }
+            // The mapping keeps the file open
+            close(fd);
+        }
+    }
+
+    return pMap;
+}
+
+// Unmap a file.
+void uPortFileUnmap(void *pMap, size_t sizeBytes)
+{
+    if (pMap != NULL) {
+        munmap(pMap, sizeBytes);
+    }
+}
+
+// End of file
@@ -111,6 +111,9 @@ int32_t uPortI2cInit()
     if (gMutex == NULL) {
         errorCode = uPortMutexCreate(&gMutex);
     }
+    if (errorCode == U_ERROR_COMMON_SUCCESS) {
+        errorCode = uPortI2cAsyncInit();
+    }
     return (int32_t)errorCode;
 }
 
@@ -118,6 +121,8 @@ int32_t uPortI2cInit()
 void uPortI2cDeinit()
 {
     if (gMutex != NULL) {
+        // Stop asynchronous transactions first, they need the I2C instances
+        uPortI2cAsyncDeinit();
         U_PORT_MUTEX_LOCK(gMutex);
         U_PORT_MUTEX_UNLOCK(gMutex);
         uPortMutexDelete(gMutex);
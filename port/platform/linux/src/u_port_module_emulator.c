@@ -0,0 +1,356 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Implementation of a scriptable, pseudo-terminal based, AT
+ * module emulator on Linux.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#define _GNU_SOURCE    // For ptsname_r()
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "stdlib.h"    // posix_openpt()
+#include "stdio.h"     // snprintf()
+#include "string.h"    // strncmp(), strlen()
+#include "errno.h"
+
+#include "fcntl.h"
+#include "termios.h"
+#include "unistd.h"
+#include "poll.h"
+#include "pthread.h"
+#include "time.h"      // nanosleep()
+
+#include "u_error_common.h"
+
+#include "u_port_module_emulator.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** How often the emulator thread checks whether it has been asked
+ * to stop.
+ */
+#define U_PORT_MODULE_EMULATOR_POLL_MS 50
+
+/** The number of bytes written at a time when the output is being
+ * paced at a baud rate.
+ */
+#define U_PORT_MODULE_EMULATOR_PACE_CHUNK_BYTES 16
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** An emulator.
+ */
+typedef struct {
+    const uPortModuleEmulatorCfg_t *pCfg;
+    int masterFd;
+    int slaveFd;  /**< kept open so that the pseudo-terminal stays raw and
+                       does not hang up when the host closes its end. */
+    pthread_t thread;
+    volatile bool stop;
+    pthread_mutex_t writeMutex;  /**< so that URCs do not break into responses. */
+    uPortModuleEmulatorStats_t stats;
+    char line[U_PORT_MODULE_EMULATOR_LINE_MAX_LENGTH_BYTES + 1];
+    size_t lineLength;
+} uPortModuleEmulator_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Protects gpEmulator.
+ */
+static pthread_mutex_t gMutex = PTHREAD_MUTEX_INITIALIZER;
+
+/** The emulators, indexed by handle.
+ */
+static uPortModuleEmulator_t *gpEmulator[U_PORT_MODULE_EMULATOR_MAX_NUM] = {0};
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Sleep for a number of microseconds.
+static void sleepUs(int64_t us)
+{
+    struct timespec t;
+
+    if (us > 0) {
+        t.tv_sec = us / 1000000;
+        t.tv_nsec = (us % 1000000) * 1000;
+        while ((nanosleep(&t, &t) != 0) && (errno == EINTR)) {}
+    }
+}
+
+// Get an emulator from its handle.
+static uPortModuleEmulator_t *pGetEmulator(int32_t handle)
+{
+    uPortModuleEmulator_t *pEmulator = NULL;
+
+    if ((handle >= 0) && (handle < U_PORT_MODULE_EMULATOR_MAX_NUM)) {
+        pthread_mutex_lock(&gMutex);
+        pEmulator = gpEmulator[handle];
+        pthread_mutex_unlock(&gMutex);
+    }
+
+    return pEmulator;
+}
+
+// Send data to the host, paced at the configured baud rate;
+// writeMutex must be locked.
+static void emulatorSend(uPortModuleEmulator_t *pEmulator, const char *pData,
+                         size_t length)
+{
+    int32_t baudRate = pEmulator->pCfg->baudRate;
+    size_t chunk;
+    ssize_t written;
+
+    while ((length > 0) && !pEmulator->stop) {
+        chunk = length;
+        if ((baudRate > 0) && (chunk > U_PORT_MODULE_EMULATOR_PACE_CHUNK_BYTES)) {
+            chunk = U_PORT_MODULE_EMULATOR_PACE_CHUNK_BYTES;
+        }
+        written = write(pEmulator->masterFd, pData, chunk);
+        if (written > 0) {
+            pData += written;
+            length -= written;
+            pEmulator->stats.bytesSent += written;
+            if (baudRate > 0) {
+                // Ten bits per character
+                sleepUs(((int64_t) written * 10 * 1000000) / baudRate);
+            }
+        } else if ((written < 0) && (errno != EAGAIN) && (errno != EINTR)) {
+            break;
+        } else {
+            sleepUs(1000);
+        }
+    }
+}
+
+// Send a response or URC after a delay.
+static void respond(uPortModuleEmulator_t *pEmulator, const char *pStr,
+                    int32_t delayMs)
+{
+    if (pStr != NULL) {
+        sleepUs((int64_t) delayMs * 1000);
+        pthread_mutex_lock(&pEmulator->writeMutex);
+        emulatorSend(pEmulator, pStr, strlen(pStr));
+        pthread_mutex_unlock(&pEmulator->writeMutex);
+    }
+}
+
+// Handle a complete AT command line.
+static void handleLine(uPortModuleEmulator_t *pEmulator)
+{
+    const uPortModuleEmulatorCfg_t *pCfg = pEmulator->pCfg;
+    const uPortModuleEmulatorRule_t *pRule = NULL;
+
+    pEmulator->line[pEmulator->lineLength] = 0;
+    pEmulator->stats.commandCount++;
+    if (pCfg->echo) {
+        pthread_mutex_lock(&pEmulator->writeMutex);
+        emulatorSend(pEmulator, pEmulator->line, pEmulator->lineLength);
+        emulatorSend(pEmulator, "\r", 1);
+        pthread_mutex_unlock(&pEmulator->writeMutex);
+    }
+    for (size_t x = 0; (pRule == NULL) && (pCfg->pRules != NULL) &&
+         (x < pCfg->numRules); x++) {
+        if ((pCfg->pRules[x].pCommandPrefix != NULL) &&
+            (strncmp(pEmulator->line, pCfg->pRules[x].pCommandPrefix,
+                     strlen(pCfg->pRules[x].pCommandPrefix)) == 0)) {
+            pRule = &(pCfg->pRules[x]);
+        }
+    }
+    if (pRule != NULL) {
+        respond(pEmulator, pRule->pResponse, pRule->delayMs);
+        respond(pEmulator, pRule->pUrc, pRule->urcDelayMs);
+    } else {
+        pEmulator->stats.unmatchedCount++;
+        respond(pEmulator, pCfg->pDefaultResponse, pCfg->defaultDelayMs);
+    }
+}
+
+// The emulator thread: assemble AT command lines and handle them.
+static void *emulatorThread(void *pParam)
+{
+    uPortModuleEmulator_t *pEmulator = (uPortModuleEmulator_t *) pParam;
+    struct pollfd pollFd;
+    char buffer[128];
+    ssize_t length;
+
+    pollFd.fd = pEmulator->masterFd;
+    pollFd.events = POLLIN;
+    while (!pEmulator->stop) {
+        if ((poll(&pollFd, 1, U_PORT_MODULE_EMULATOR_POLL_MS) > 0) &&
+            (pollFd.revents & POLLIN)) {
+            length = read(pEmulator->masterFd, buffer, sizeof(buffer));
+            for (ssize_t x = 0; x < length; x++) {
+                pEmulator->stats.bytesReceived++;
+                if (buffer[x] == '\r') {
+                    if (pEmulator->lineLength > 0) {
+                        handleLine(pEmulator);
+                    }
+                    pEmulator->lineLength = 0;
+                } else if (buffer[x] != '\n') {
+                    if (pEmulator->lineLength < sizeof(pEmulator->line) - 1) {
+                        pEmulator->line[pEmulator->lineLength] = buffer[x];
+                        pEmulator->lineLength++;
+                    }
+                }
+            }
+        }
+    }
+
+    return NULL;
+}
+
+// Free an emulator's file descriptors and memory.
+static void freeEmulator(uPortModuleEmulator_t *pEmulator)
+{
+    if (pEmulator->slaveFd >= 0) {
+        close(pEmulator->slaveFd);
+    }
+    if (pEmulator->masterFd >= 0) {
+        close(pEmulator->masterFd);
+    }
+    pthread_mutex_destroy(&pEmulator->writeMutex);
+    // Not pUPortMalloc(): the emulator stays out of the heap accounting
+    free(pEmulator);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Start an emulator.
+int32_t uPortModuleEmulatorStart(const uPortModuleEmulatorCfg_t *pCfg,
+                                 char *pDeviceName)
+{
+    int32_t errorCodeOrHandle = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uPortModuleEmulator_t *pEmulator;
+    struct termios options;
+    int32_t handle = -1;
+
+    if ((pCfg != NULL) && (pDeviceName != NULL) && (pCfg->baudRate >= 0) &&
+        ((pCfg->pRules != NULL) || (pCfg->numRules == 0))) {
+        errorCodeOrHandle = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        pEmulator = (uPortModuleEmulator_t *) malloc(sizeof(*pEmulator));
+        if (pEmulator != NULL) {
+            memset(pEmulator, 0, sizeof(*pEmulator));
+            pEmulator->pCfg = pCfg;
+            pEmulator->slaveFd = -1;
+            pthread_mutex_init(&pEmulator->writeMutex, NULL);
+            errorCodeOrHandle = (int32_t) U_ERROR_COMMON_PLATFORM;
+            pEmulator->masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+            if ((pEmulator->masterFd >= 0) &&
+                (grantpt(pEmulator->masterFd) == 0) &&
+                (unlockpt(pEmulator->masterFd) == 0) &&
+                (ptsname_r(pEmulator->masterFd, pDeviceName,
+                           U_PORT_MODULE_EMULATOR_DEVICE_NAME_MAX_LENGTH_BYTES) == 0)) {
+                pEmulator->slaveFd = open(pDeviceName, O_RDWR | O_NOCTTY);
+            }
+            if ((pEmulator->slaveFd >= 0) &&
+                (tcgetattr(pEmulator->slaveFd, &options) == 0)) {
+                // Raw so that nothing is echoed or translated before
+                // the host has opened the device and made it raw itself
+                cfmakeraw(&options);
+                if (tcsetattr(pEmulator->slaveFd, TCSANOW, &options) == 0) {
+                    errorCodeOrHandle = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                    pthread_mutex_lock(&gMutex);
+                    for (size_t x = 0; (handle < 0) && (x < U_PORT_MODULE_EMULATOR_MAX_NUM); x++) {
+                        if (gpEmulator[x] == NULL) {
+                            handle = (int32_t) x;
+                        }
+                    }
+                    if ((handle >= 0) &&
+                        (pthread_create(&pEmulator->thread, NULL,
+                                        emulatorThread, pEmulator) == 0)) {
+                        gpEmulator[handle] = pEmulator;
+                        errorCodeOrHandle = handle;
+                    }
+                    pthread_mutex_unlock(&gMutex);
+                }
+            }
+            if (errorCodeOrHandle < 0) {
+                // Clean up on error
+                freeEmulator(pEmulator);
+            }
+        }
+    }
+
+    return errorCodeOrHandle;
+}
+
+// Send a URC.
+int32_t uPortModuleEmulatorSendUrc(int32_t handle, const char *pUrc)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uPortModuleEmulator_t *pEmulator = pGetEmulator(handle);
+
+    if ((pEmulator != NULL) && (pUrc != NULL)) {
+        respond(pEmulator, pUrc, 0);
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Get the statistics of an emulator.
+int32_t uPortModuleEmulatorGetStats(int32_t handle,
+                                    uPortModuleEmulatorStats_t *pStats)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    uPortModuleEmulator_t *pEmulator = pGetEmulator(handle);
+
+    if ((pEmulator != NULL) && (pStats != NULL)) {
+        pthread_mutex_lock(&pEmulator->writeMutex);
+        *pStats = pEmulator->stats;
+        pthread_mutex_unlock(&pEmulator->writeMutex);
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+// Stop an emulator.
+void uPortModuleEmulatorStop(int32_t handle)
+{
+    uPortModuleEmulator_t *pEmulator = NULL;
+
+    if ((handle >= 0) && (handle < U_PORT_MODULE_EMULATOR_MAX_NUM)) {
+        pthread_mutex_lock(&gMutex);
+        pEmulator = gpEmulator[handle];
+        gpEmulator[handle] = NULL;
+        pthread_mutex_unlock(&gMutex);
+    }
+    if (pEmulator != NULL) {
+        pEmulator->stop = true;
+        pthread_join(pEmulator->thread, NULL);
+        freeEmulator(pEmulator);
+    }
+}
+
+// End of file
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _U_PORT_MODULE_EMULATOR_H_
+#define _U_PORT_MODULE_EMULATOR_H_
+
+/* Only header files representing a direct and unavoidable
+ * dependency between the API of this module and the API
+ * of another module should be included here; otherwise
+ * please keep #includes to your .c files. */
+
+/** \addtogroup __port
+ *  @{
+ */
+
+/** @file
+ * @brief A scriptable emulator of an AT-command based module (e.g.
+ * a SARA cellular module or a NINA short-range module), Linux only,
+ * intended for testing and profiling the host side of ubxlib (the AT
+ * client, cellular sockets, CMUX etc.) without real hardware.
+ *
+ * The emulator creates a pseudo-terminal: the name of its device
+ * (e.g. "/dev/pts/3") is passed to uPortUartPrefix() and the UART
+ * is then opened with uPortUartOpen() with a uart parameter of -1,
+ * exactly as if it were a real module on a real serial port.  Each
+ * AT command line received (terminated by a carriage return) is
+ * compared against a table of rules and the response of the first
+ * rule whose command prefix matches is sent back after that rule's
+ * delay, followed, optionally, by a URC.  The output is paced at the
+ * configured baud rate so that the timing, though not bit-accurate,
+ * is that of a real serial link, and everything is deterministic,
+ * which makes the host-side CPU cost of a given sequence of AT
+ * commands easy to measure.
+ *
+ * Note that bytes which arrive other than as part of an AT command
+ * line (e.g. binary data following "@" in AT+USOWR) are simply
+ * collected into the next command line and so will, in general,
+ * match no rule: give such commands a default response.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_PORT_MODULE_EMULATOR_LINE_MAX_LENGTH_BYTES
+/** The maximum length of an AT command line the emulator will
+ * receive; longer lines are truncated before being matched.
+ */
+# define U_PORT_MODULE_EMULATOR_LINE_MAX_LENGTH_BYTES 1024
+#endif
+
+#ifndef U_PORT_MODULE_EMULATOR_DEVICE_NAME_MAX_LENGTH_BYTES
+/** Room for the name of the pseudo-terminal device, including
+ * a terminator.
+ */
+# define U_PORT_MODULE_EMULATOR_DEVICE_NAME_MAX_LENGTH_BYTES 32
+#endif
+
+#ifndef U_PORT_MODULE_EMULATOR_MAX_NUM
+/** The maximum number of emulators that may be running at once.
+ */
+# define U_PORT_MODULE_EMULATOR_MAX_NUM 8
+#endif
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** A rule: what the emulator should send back in response to a
+ * given AT command.
+ */
+typedef struct {
+    const char *pCommandPrefix; /**< the prefix of the AT command line this
+                                     rule matches, e.g. "AT+CSQ"; the
+                                     rules are tried in order and the
+                                     first match wins, so put the longer
+                                     prefixes first. */
+    const char *pResponse;      /**< the null-terminated response to send,
+                                     e.g. "\r\n+CSQ: 20,99\r\n\r\nOK\r\n";
+                                     may be NULL for no response. */
+    int32_t delayMs;            /**< the time between the end of the AT
+                                     command and the start of the response,
+                                     i.e. the processing time of the module. */
+    const char *pUrc;           /**< a null-terminated URC to send after
+                                     the response, e.g. "\r\n+UUSORD: 0,12\r\n";
+                                     may be NULL. */
+    int32_t urcDelayMs;         /**< the time between the end of the
+                                     response and the start of pUrc. */
+} uPortModuleEmulatorRule_t;
+
+/** The configuration of an emulator.
+ */
+typedef struct {
+    const uPortModuleEmulatorRule_t *pRules; /**< the rules, may be NULL. */
+    size_t numRules;                         /**< the number of entries at pRules. */
+    const char *pDefaultResponse;            /**< the null-terminated response
+                                                  to an AT command that matches
+                                                  no rule, e.g. "\r\nOK\r\n";
+                                                  may be NULL for none. */
+    int32_t defaultDelayMs;                  /**< the delay before pDefaultResponse. */
+    int32_t baudRate;                        /**< the baud rate at which to pace
+                                                  the output, assuming ten bits per
+                                                  character; zero to send as fast
+                                                  as possible. */
+    bool echo;                               /**< true to echo AT commands back,
+                                                  as a module does before ATE0. */
+} uPortModuleEmulatorCfg_t;
+
+/** Statistics from an emulator.
+ */
+typedef struct {
+    size_t commandCount;    /**< the number of AT command lines received. */
+    size_t unmatchedCount;  /**< the number of those which matched no rule. */
+    size_t bytesReceived;   /**< the number of bytes received from the host. */
+    size_t bytesSent;       /**< the number of bytes sent to the host. */
+} uPortModuleEmulatorStats_t;
+
+/* ----------------------------------------------------------------
+ * FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/** Start a module emulator; the emulator runs in a thread of its
+ * own, outside the OS resources of the port layer, so it does not
+ * figure in the resource counts of a test.
+ *
+ * @param[in] pCfg         the configuration; the contents, including
+ *                         the rules and strings it points to, must
+ *                         remain valid until uPortModuleEmulatorStop()
+ *                         is called.  Cannot be NULL.
+ * @param[out] pDeviceName a place to put the null-terminated name of
+ *                         the device to open, which can be passed to
+ *                         uPortUartPrefix(); must be at least
+ *                         #U_PORT_MODULE_EMULATOR_DEVICE_NAME_MAX_LENGTH_BYTES
+ *                         long.  Cannot be NULL.
+ * @return                 a handle for the emulator on success, else
+ *                         negative error code.
+ */
+int32_t uPortModuleEmulatorStart(const uPortModuleEmulatorCfg_t *pCfg,
+                                 char *pDeviceName);
+
+/** Send a URC from an emulator now, e.g. to emulate an incoming
+ * call or received socket data; thread-safe, the URC will not be
+ * sent in the middle of a response.
+ *
+ * @param handle    the handle of the emulator.
+ * @param[in] pUrc  the null-terminated URC, e.g. "\r\nRING\r\n".
+ * @return          zero on success else negative error code.
+ */
+int32_t uPortModuleEmulatorSendUrc(int32_t handle, const char *pUrc);
+
+/** Get the statistics of an emulator.
+ *
+ * @param handle      the handle of the emulator.
+ * @param[out] pStats a place to put the statistics; cannot be NULL.
+ * @return            zero on success else negative error code.
+ */
+int32_t uPortModuleEmulatorGetStats(int32_t handle,
+                                    uPortModuleEmulatorStats_t *pStats);
+
+/** Stop a module emulator; the UART opened on its device should be
+ * closed first.
+ *
+ * @param handle  the handle of the emulator.
+ */
+void uPortModuleEmulatorStop(int32_t handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @}*/
+
+#endif // _U_PORT_MODULE_EMULATOR_H_
+
+// End of file
@@ -77,6 +77,7 @@
 #include "time.h"
 #include "signal.h"
 #include "errno.h"
+#include "sys/syscall.h" // SYS_gettid
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -112,17 +113,22 @@ int32_t _uPortMutexUnlock(uPortMutexHandle_t mutexHandle);
 
 /* Structures for storing os specific type data to be kept in linked lists. */
 
-/** Queues are implemented using Posix pipes. A mutex is protecting the
- *  available count and a semaphore is used for synchronisation.
- *  Pipe descriptor 0 is used for reading and 1 for writing.
+/** Queues are implemented as a ring of items in memory, allocated
+ *  along with this structure, so that sending and receiving need no
+ *  system calls unless a task has to wait. A mutex is protecting the
+ *  ring, one semaphore is given when an item is added, for
+ *  receivers to wait on, and another when an item is removed, for
+ *  senders to wait on when the queue is full.
 */
 typedef struct {
     uPortMutexHandle_t mutex;
-    uPortSemaphoreHandle_t semHandle;
-    int fd[2];            /*!< Pipe in/out descriptor. */
+    uPortSemaphoreHandle_t semHandle;      /*!< Given when an item is added. */
+    uPortSemaphoreHandle_t spaceSemHandle; /*!< Given when an item is removed. */
     size_t queueLength;   /*!< Max number of elements. */
     size_t itemSizeBytes; /*!< Element size */
-    size_t readCount;     /*!< Unread bytes in the queue. */
+    size_t readIndex;     /*!< Index of the oldest element in the ring. */
+    size_t count;         /*!< Number of elements in the ring. */
+    char *pRing;          /*!< Storage for queueLength elements. */
 } uPortQueue_t;
 
 /** Timers are implemented using Posix timer_t timers.
@@ -135,12 +141,22 @@ typedef struct {
     void *pCallbackParam;
 } uPortTimer_t;
 
+/** What is kept in gpThreadList for each task, so that it can be
+ *  suspended and reported on by uPortTaskInfoGet().
+*/
+typedef struct {
+    pthread_t threadId;
+    pid_t tid;    /*!< The Linux thread ID, zero until the task has started. */
+    char name[U_PORT_OS_TASK_NAME_MAX_LENGTH_BYTES];
+} uPortTaskRecord_t;
+
 /** Threads are implemented using Posix pthreads. As the Posix api wants the callback
  *  to return a void pointer we have to use this struct as a middle man.
 */
 typedef struct {
     void (*pFunction)(void *);
     void *param;
+    uPortTaskRecord_t *pRecord;
 } uPortThread_t;
 
 /** Semaphores are implemented using Posix sem_t functions.
@@ -201,12 +217,73 @@ static void threadSignalCallback(int sig)
     MTX_FN(uPortMutexUnlock(gMutexCriticalSection));
 }
 
+// Remove a task from gpThreadList, if it is there.
+static void taskRecordRemove(pthread_t threadId)
+{
+    if (gMutexThread != NULL) {
+        MTX_FN(uPortMutexLock(gMutexThread));
+        for (uLinkedList_t *p = gpThreadList; p != NULL; p = p->pNext) {
+            uPortTaskRecord_t *pRecord = (uPortTaskRecord_t *) p->p;
+            if (pRecord->threadId == threadId) {
+                uLinkedListRemove(&gpThreadList, pRecord);
+                uPortFree(pRecord);
+                break;
+            }
+        }
+        MTX_FN(uPortMutexUnlock(gMutexThread));
+    }
+}
+
+// Get the CPU time used so far by the thread with the given Linux
+// thread ID from /proc/self/task.
+static int64_t cpuTimeUsGet(pid_t tid)
+{
+    int64_t cpuTimeUsOrErrorCode = (int64_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    char buffer[256];
+    FILE *pFile;
+    size_t length;
+    char *pStr;
+    unsigned long userTicks;
+    unsigned long systemTicks;
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+
+    if ((tid > 0) && (ticksPerSecond > 0)) {
+        snprintf(buffer, sizeof(buffer), "/proc/self/task/%d/stat", (int) tid);
+        pFile = fopen(buffer, "r");
+        if (pFile != NULL) {
+            length = fread(buffer, 1, sizeof(buffer) - 1, pFile);
+            fclose(pFile);
+            buffer[length] = 0;
+            // The second field is the name of the thread in brackets,
+            // which may include spaces, so start after the last
+            // closing bracket: from there the user and system times
+            // are the 12th and 13th fields
+            pStr = strrchr(buffer, ')');
+            if ((pStr != NULL) &&
+                (sscanf(pStr + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                        &userTicks, &systemTicks) == 2)) {
+                cpuTimeUsOrErrorCode = ((int64_t) (userTicks + systemTicks) * 1000000) /
+                                       ticksPerSecond;
+            }
+        }
+    }
+
+    return cpuTimeUsOrErrorCode;
+}
+
 // Posix threads want function returning void*
 static void *taskProc(void *pParam)
 {
     uPortThread_t info = *((uPortThread_t *)pParam);
     uPortFree(pParam);
 
+    // gMutexThread is held by uPortTaskCreate() until this task
+    // is in gpThreadList
+    MTX_FN(uPortMutexLock(gMutexThread));
+    info.pRecord->tid = (pid_t) syscall(SYS_gettid);
+    pthread_setname_np(pthread_self(), info.pRecord->name);
+    MTX_FN(uPortMutexUnlock(gMutexThread));
+
     // Setup the signal used for suspending the thread.
     struct sigaction act;
     sigemptyset(&act.sa_mask);
@@ -216,6 +293,10 @@ static void *taskProc(void *pParam)
 
     // Launch
     info.pFunction(info.param);
+
+    // Only get here if the task function returned, rather
+    // than calling uPortTaskDelete()
+    taskRecordRemove(pthread_self());
     return NULL;
 }
 
@@ -230,7 +311,7 @@ static int32_t suspendOrResumeAllTasks(bool suspend)
         uLinkedList_t *p = gpThreadList;
         // Signal all tasks to suspend.
         while ((errorCode == U_ERROR_COMMON_SUCCESS) && (p != NULL)) {
-            pthread_t threadId = (pthread_t)(p->p);
+            pthread_t threadId = ((uPortTaskRecord_t *)(p->p))->threadId;
             if (threadId != pthread_self()) {
                 if (pthread_kill(threadId, SIGUSR1) != 0) {
                     errorCode = U_ERROR_COMMON_PLATFORM;
@@ -260,19 +341,61 @@ static uErrorCode_t readFromQueue(uPortQueue_t *pQueue,
 {
     uErrorCode_t errorCode = U_ERROR_COMMON_EMPTY;
     MTX_FN(uPortMutexLock(pQueue->mutex));
-    if (pQueue->readCount >= pQueue->itemSizeBytes) {
-        errorCode = U_ERROR_COMMON_TRUNCATED;
-        size_t readCount = read(pQueue->fd[0], pEventData, pQueue->itemSizeBytes);
-        if (readCount == pQueue->itemSizeBytes) {
-            errorCode = U_ERROR_COMMON_SUCCESS;
+    if (pQueue->count > 0) {
+        memcpy(pEventData, pQueue->pRing + (pQueue->readIndex * pQueue->itemSizeBytes),
+               pQueue->itemSizeBytes);
+        pQueue->readIndex++;
+        if (pQueue->readIndex >= pQueue->queueLength) {
+            pQueue->readIndex = 0;
         }
-        if (readCount >= 0) {
-            pQueue->readCount -= readCount;
-        } else {
-            errorCode = U_ERROR_COMMON_PLATFORM;
+        pQueue->count--;
+        errorCode = U_ERROR_COMMON_SUCCESS;
+    }
+    MTX_FN(uPortMutexUnlock(pQueue->mutex));
+    if (errorCode == U_ERROR_COMMON_SUCCESS) {
+        // Let any sender waiting for room know
+        uPortSemaphoreGive(pQueue->spaceSemHandle);
+    }
+    return errorCode;
+}
+
+// Write to a queue if there is room.
+static uErrorCode_t writeToQueue(uPortQueue_t *pQueue,
+                                 const void *pEventData)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NO_MEMORY;
+    size_t writeIndex;
+    MTX_FN(uPortMutexLock(pQueue->mutex));
+    if (pQueue->count < pQueue->queueLength) {
+        writeIndex = pQueue->readIndex + pQueue->count;
+        if (writeIndex >= pQueue->queueLength) {
+            writeIndex -= pQueue->queueLength;
         }
+        memcpy(pQueue->pRing + (writeIndex * pQueue->itemSizeBytes), pEventData,
+               pQueue->itemSizeBytes);
+        pQueue->count++;
+        errorCode = U_ERROR_COMMON_SUCCESS;
     }
     MTX_FN(uPortMutexUnlock(pQueue->mutex));
+    if (errorCode == U_ERROR_COMMON_SUCCESS) {
+        // Let any receiver waiting for an item know
+        uPortSemaphoreGive(pQueue->semHandle);
+    }
+    return errorCode;
+}
+
+// Initialise a pthread mutex as adaptive: a task that finds it
+// locked spins briefly before sleeping on a futex, which suits
+// the short critical sections that mutexes are used for here.
+static int32_t mutexInit(pthread_mutex_t *pMutex)
+{
+    int32_t errorCode = -1;
+    pthread_mutexattr_t attr;
+    if (pthread_mutexattr_init(&attr) == 0) {
+        pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+        errorCode = pthread_mutex_init(pMutex, &attr);
+        pthread_mutexattr_destroy(&attr);
+    }
     return errorCode;
 }
 
@@ -287,7 +410,7 @@ static int32_t mutexCreate(uPortMutexHandle_t *pMutexHandle)
         pthread_mutex_t *pMutex = malloc(sizeof(pthread_mutex_t));
         if (pMutex != NULL) {
             errorCode = U_ERROR_COMMON_PLATFORM;
-            if (pthread_mutex_init(pMutex, NULL) == 0) {
+            if (mutexInit(pMutex) == 0) {
                 *pMutexHandle = pMutex;
                 errorCode = U_ERROR_COMMON_SUCCESS;
             }
@@ -386,7 +509,9 @@ void uPortOsPrivateDeinit(void)
         uLinkedList_t *p = gpThreadList;
         while (p != NULL) {
             uLinkedList_t *pNext = p->pNext;
-            uLinkedListRemove(&gpThreadList, p);
+            uPortTaskRecord_t *pRecord = (uPortTaskRecord_t *)(p->p);
+            uLinkedListRemove(&gpThreadList, pRecord);
+            uPortFree(pRecord);
             p = pNext;
         }
         MTX_FN(uPortMutexUnlock(gMutexThread));
@@ -418,8 +543,16 @@ int32_t uPortTaskCreate(void (*pFunction)(void *),
     if (pInfo == NULL) {
         return U_ERROR_COMMON_NO_MEMORY;
     }
+    uPortTaskRecord_t *pRecord = pUPortMalloc(sizeof(uPortTaskRecord_t));
+    if (pRecord == NULL) {
+        uPortFree(pInfo);
+        return U_ERROR_COMMON_NO_MEMORY;
+    }
+    memset(pRecord, 0, sizeof(*pRecord));
+    if (pName != NULL) {
+        strncpy(pRecord->name, pName, sizeof(pRecord->name) - 1);
+    }
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-    (void)pName;
     if ((pFunction != NULL) && (pTaskHandle != NULL) &&
         (priority >= U_CFG_OS_PRIORITY_MIN) &&
         (priority <= U_CFG_OS_PRIORITY_MAX)) {
@@ -438,15 +571,23 @@ int32_t uPortTaskCreate(void (*pFunction)(void *),
         pthread_t threadId;
         pInfo->pFunction = pFunction;
         pInfo->param = pParameter;
+        pInfo->pRecord = pRecord;
+        // Lock gpThreadList before the task starts so that it is
+        // in the list before it can delete itself
+        MTX_FN(uPortMutexLock(gMutexThread));
         if (pthread_create(&threadId, &attr, taskProc, (void *)pInfo) == 0) {
             *pTaskHandle = (void *)threadId;
             errorCode = U_ERROR_COMMON_SUCCESS;
-            MTX_FN(uPortMutexLock(gMutexThread));
-            uLinkedListAdd(&gpThreadList, (void *)threadId);
-            MTX_FN(uPortMutexUnlock(gMutexThread));
+            pRecord->threadId = threadId;
+            uLinkedListAdd(&gpThreadList, (void *)pRecord);
             U_ATOMIC_INCREMENT(&gResourceAllocCount);
             U_PORT_OS_DEBUG_PRINT_TASK_CREATE(*pTaskHandle, pName, stackSizeBytes, priority);
         }
+        MTX_FN(uPortMutexUnlock(gMutexThread));
+    }
+    if (errorCode != U_ERROR_COMMON_SUCCESS) {
+        uPortFree(pRecord);
+        uPortFree(pInfo);
     }
     return (int32_t)errorCode;
 }
@@ -464,9 +605,7 @@ int32_t uPortTaskDelete(const uPortTaskHandle_t taskHandle)
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_TASK_DELETE(tread);
     }
-    MTX_FN(uPortMutexLock(gMutexThread));
-    uLinkedListRemove(&gpThreadList, (void *)tread);
-    MTX_FN(uPortMutexUnlock(gMutexThread));
+    taskRecordRemove(tread);
     return (int32_t)errorCode;
 }
 
@@ -489,6 +628,29 @@ int32_t uPortTaskStackMinFree(const uPortTaskHandle_t taskHandle)
     return U_ERROR_COMMON_NOT_SUPPORTED;
 }
 
+// Get information about all of the tasks.
+int32_t uPortTaskInfoGet(uPortTaskInfo_t *pInfo, size_t maxNum)
+{
+    if (gMutexThread == NULL) {
+        return U_ERROR_COMMON_NOT_INITIALISED;
+    }
+    int32_t numTasks = 0;
+    MTX_FN(uPortMutexLock(gMutexThread));
+    for (uLinkedList_t *p = gpThreadList; p != NULL; p = p->pNext) {
+        uPortTaskRecord_t *pRecord = (uPortTaskRecord_t *)(p->p);
+        if ((pInfo != NULL) && ((size_t) numTasks < maxNum)) {
+            pInfo->handle = (uPortTaskHandle_t) pRecord->threadId;
+            memcpy(pInfo->name, pRecord->name, sizeof(pInfo->name));
+            pInfo->stackMinFreeBytes = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            pInfo->cpuTimeUs = cpuTimeUsGet(pRecord->tid);
+            pInfo++;
+        }
+        numTasks++;
+    }
+    MTX_FN(uPortMutexUnlock(gMutexThread));
+    return numTasks;
+}
+
 // Get the current task handle.
 int32_t uPortTaskGetHandle(uPortTaskHandle_t *pTaskHandle)
 {
@@ -510,32 +672,37 @@ int32_t uPortQueueCreate(size_t queueLength,
                          uPortQueueHandle_t *pQueueHandle)
 {
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
-    if (pQueueHandle != NULL) {
+    if ((pQueueHandle != NULL) && (queueLength > 0) && (itemSizeBytes > 0)) {
         errorCode = U_ERROR_COMMON_NO_MEMORY;
-        uPortQueue_t *pQueue = (uPortQueue_t *)pUPortMalloc(sizeof(uPortQueue_t));
+        // The ring goes on the end of the structure
+        uPortQueue_t *pQueue = (uPortQueue_t *)pUPortMalloc(sizeof(uPortQueue_t) +
+                                                            (queueLength * itemSizeBytes));
         if (pQueue) {
             uPortMutexHandle_t mutex;
             uPortSemaphoreHandle_t semHandle;
+            uPortSemaphoreHandle_t spaceSemHandle;
             if (uPortSemaphoreCreate(&semHandle, 0, queueLength) != 0) {
                 uPortFree(pQueue);
+            } else if (uPortSemaphoreCreate(&spaceSemHandle, 0, queueLength) != 0) {
+                uPortSemaphoreDelete(semHandle);
+                uPortFree(pQueue);
             } else if (MTX_FN(uPortMutexCreate(&mutex)) == 0) {
-                // Create a non blocking pipe.
-                if (pipe2(pQueue->fd, O_NONBLOCK) == 0) {
-                    if (queueLength * itemSizeBytes < fcntl(pQueue->fd[1], F_GETPIPE_SZ)) {
-                        pQueue->mutex = mutex;
-                        pQueue->semHandle = semHandle;
-                        pQueue->queueLength = queueLength;
-                        pQueue->itemSizeBytes = itemSizeBytes;
-                        pQueue->readCount = 0;
-                        *pQueueHandle = pQueue;
-                        errorCode = U_ERROR_COMMON_SUCCESS;
-                        U_ATOMIC_INCREMENT(&gResourceAllocCount);
-                        U_PORT_OS_DEBUG_PRINT_QUEUE_CREATE(*pQueueHandle, queueLength, itemSizeBytes);
-                    }
-                } else {
-                    MTX_FN(uPortMutexDelete(mutex));
-                    uPortFree(pQueue);
-                }
+                pQueue->mutex = mutex;
+                pQueue->semHandle = semHandle;
+                pQueue->spaceSemHandle = spaceSemHandle;
+                pQueue->queueLength = queueLength;
+                pQueue->itemSizeBytes = itemSizeBytes;
+                pQueue->readIndex = 0;
+                pQueue->count = 0;
+                pQueue->pRing = ((char *) pQueue) + sizeof(uPortQueue_t);
+                *pQueueHandle = pQueue;
+                errorCode = U_ERROR_COMMON_SUCCESS;
+                U_ATOMIC_INCREMENT(&gResourceAllocCount);
+                U_PORT_OS_DEBUG_PRINT_QUEUE_CREATE(*pQueueHandle, queueLength, itemSizeBytes);
+            } else {
+                uPortSemaphoreDelete(spaceSemHandle);
+                uPortSemaphoreDelete(semHandle);
+                uPortFree(pQueue);
             }
         }
     }
@@ -548,10 +715,9 @@ int32_t uPortQueueDelete(const uPortQueueHandle_t queueHandle)
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
     uPortQueue_t *pQueue = (uPortQueue_t *)queueHandle;
     if (pQueue != NULL) {
-        close(pQueue->fd[0]);
-        close(pQueue->fd[1]);
         MTX_FN(uPortMutexDelete(pQueue->mutex));
         uPortSemaphoreDelete(pQueue->semHandle);
+        uPortSemaphoreDelete(pQueue->spaceSemHandle);
         uPortFree(pQueue);
         errorCode = U_ERROR_COMMON_SUCCESS;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
@@ -567,19 +733,12 @@ int32_t uPortQueueSend(const uPortQueueHandle_t queueHandle,
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
     uPortQueue_t *pQueue = (uPortQueue_t *)queueHandle;
     if (pQueue != NULL) {
-        errorCode = U_ERROR_COMMON_TRUNCATED;
-        MTX_FN(uPortMutexLock(pQueue->mutex));
-        size_t writeCount = write(pQueue->fd[1], pEventData, pQueue->itemSizeBytes);
-        if (writeCount == pQueue->itemSizeBytes) {
-            errorCode = U_ERROR_COMMON_SUCCESS;
+        errorCode = writeToQueue(pQueue, pEventData);
+        while (errorCode == U_ERROR_COMMON_NO_MEMORY) {
+            // Full, blocking wait for room.
+            uPortSemaphoreTake(pQueue->spaceSemHandle);
+            errorCode = writeToQueue(pQueue, pEventData);
         }
-        if (writeCount >= 0) {
-            pQueue->readCount += writeCount;
-        } else {
-            errorCode = U_ERROR_COMMON_PLATFORM;
-        }
-        MTX_FN(uPortMutexUnlock(pQueue->mutex));
-        uPortSemaphoreGive(pQueue->semHandle);
     }
     return (int32_t)errorCode;
 }
@@ -641,12 +800,8 @@ int32_t uPortQueueGetFree(const uPortQueueHandle_t queueHandle)
 {
     uPortQueue_t *pQueue = (uPortQueue_t *)queueHandle;
     if (pQueue != NULL) {
-        size_t maxFree = pQueue->queueLength * pQueue->itemSizeBytes;
-        size_t freeBytes = fcntl(pQueue->fd[1], F_GETPIPE_SZ) - pQueue->readCount;
-        if (freeBytes > maxFree) {
-            freeBytes = maxFree;
-        }
-        return (freeBytes / pQueue->itemSizeBytes);
+        // A snapshot, no need to lock
+        return (int32_t) (pQueue->queueLength - pQueue->count);
     } else {
         return (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
     }
@@ -665,7 +820,7 @@ int32_t MTX_FN(uPortMutexCreate(uPortMutexHandle_t *pMutexHandle))
         pthread_mutex_t *pMutex = pUPortMalloc(sizeof(pthread_mutex_t));
         if (pMutex != NULL) {
             errorCode = U_ERROR_COMMON_PLATFORM;
-            if (pthread_mutex_init(pMutex, NULL) == 0) {
+            if (mutexInit(pMutex) == 0) {
                 *pMutexHandle = pMutex;
                 errorCode = U_ERROR_COMMON_SUCCESS;
                 U_ATOMIC_INCREMENT(&gResourceAllocCount);
@@ -716,10 +871,9 @@ int32_t MTX_FN(uPortMutexTryLock(const uPortMutexHandle_t mutexHandle,
             int32_t sta = pthread_mutex_trylock((pthread_mutex_t *)mutexHandle);
             if (sta == 0) {
                 errorCode = U_ERROR_COMMON_SUCCESS;
-            } else if (errno == EAGAIN) {
+            } else if (sta == EBUSY) {
+                // Note: pthread functions return the error, they don't set errno
                 errorCode = U_ERROR_COMMON_TIMEOUT;
-                // Clear errno in this case
-                errno = 0;
             }
         } else {
             struct timespec t;
@@ -31,10 +31,13 @@
 #include "fcntl.h"
 #include "termios.h"
 #include "unistd.h"
-#include "sys/select.h"
+#include "sys/epoll.h"
+#include "sys/eventfd.h"
 #include "pthread.h"  // threadId
 #include "sys/ioctl.h"
 #include "sys/param.h"
+#include "sys/uio.h"   // writev()
+#include "linux/serial.h" // struct serial_icounter_struct
 #include "u_error_common.h"
 #include "u_linked_list.h"
 
@@ -54,17 +57,30 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
-#ifndef U_PORT_UART_READ_WAIT_MS
-/** How long to wait when there is nothing to read from the UART.
+#ifndef U_PORT_UART_WRITE_VEC_MAX_NUM
+/** The maximum number of buffers that uPortUartWriteVec() passes
+ * to writev() at once; more are sent in further calls.
  */
-# define U_PORT_UART_READ_WAIT_MS 10
+# define U_PORT_UART_WRITE_VEC_MAX_NUM 16
 #endif
 
-#ifndef U_PORT_UART_START_STOP_WAIT_MS
-/** How long to wait for a UART, mostly the read task, to start up
- * and shut down.
+#ifndef U_PORT_UART_REACTOR_MAX_NUM_EVENTS
+/** The maximum number of events the reactor task, which receives
+ * data for all UARTs, handles per wake-up.
  */
-# define U_PORT_UART_START_STOP_WAIT_MS (U_PORT_UART_READ_WAIT_MS * 10)
+# define U_PORT_UART_REACTOR_MAX_NUM_EVENTS 8
+#endif
+
+#ifndef U_PORT_UART_REACTOR_STACK_SIZE_BYTES
+/** The stack size of the reactor task.
+ */
+# define U_PORT_UART_REACTOR_STACK_SIZE_BYTES (1024 * 4)
+#endif
+
+#ifndef U_PORT_UART_REACTOR_PRIORITY
+/** The priority of the reactor task.
+ */
+# define U_PORT_UART_REACTOR_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
 #endif
 
 /* ----------------------------------------------------------------
@@ -74,7 +90,6 @@
 typedef struct uPortUartData_t {
     int uartFd;
     bool markedForDeletion;
-    uPortTaskHandle_t rxTask;
     uPortMutexHandle_t mutex;
     bool bufferAllocated;
     char *pBuffer;
@@ -82,14 +97,29 @@ typedef struct uPortUartData_t {
     size_t readPos;
     size_t writePos;
     bool bufferFull;
+    int32_t bufferFullStartMs;
+    uPortUartStats_t stats; /**< all but the error counts, which come from the driver. */
+    struct serial_icounter_struct icountBase; /**< the driver's error counts at reset. */
     bool hwHandshake;
     bool handshakeSuspended;
     int32_t eventQueueHandle;
     uint32_t eventFilter;
+    volatile bool eventPending; /**< a data received event is queued but not yet handled. */
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
 } uPortUartData_t;
 
+/** The reactor: a single task which waits, using epoll, for
+ * received data on all of the open UARTs; it is started when the
+ * first UART is opened and stopped when the last one is closed.
+ */
+typedef struct {
+    int epollFd;
+    int eventFd;  /**< written to make the reactor task exit. */
+    uPortSemaphoreHandle_t stopped;
+    uPortTaskHandle_t task;
+} uPortUartReactor_t;
+
 /** Structure describing an event.
  */
 typedef struct {
@@ -97,6 +127,9 @@ typedef struct {
     uint32_t eventBitMap;
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
+    volatile bool *pEventPending; /**< NULL if the event was not coalesced;
+                                       valid since the event queue is closed
+                                       before the UART data is freed. */
 } uPortUartEvent_t;
 
 /** Structure to hold a UART name prefix along with the thread
@@ -124,6 +157,10 @@ static uLinkedList_t *gpUartList = NULL;
  */
 static uLinkedList_t *gpUartPrefixList = NULL;
 
+/** The reactor, NULL if no UART is open; protected by gMutex.
+ */
+static uPortUartReactor_t *gpReactor = NULL;
+
 /** Variable to keep track of the number of UARTs open.
  */
 static volatile int32_t gResourceAllocCount = 0;
@@ -137,6 +174,11 @@ static void eventHandler(void *pParam, size_t paramLength)
 {
     uPortUartEvent_t *pEvent = (uPortUartEvent_t *) pParam;
     (void) paramLength;
+    if (pEvent->pEventPending != NULL) {
+        // Clear this before calling the callback so that data
+        // arriving while the callback is running raises a new event
+        *pEvent->pEventPending = false;
+    }
     if (pEvent->pEventCallback != NULL) {
         pEvent->pEventCallback(pEvent->uartHandle,
                                pEvent->eventBitMap,
@@ -144,76 +186,6 @@ static void eventHandler(void *pParam, size_t paramLength)
     }
 }
 
-// Task handling incoming uart data
-static void readTask(void *pParam)
-{
-    uPortUartData_t *p = (uPortUartData_t *)pParam;
-    struct timeval tv = {0};
-
-    // Initiate a set for select operation.
-    fd_set set;
-    tv.tv_usec = U_CFG_OS_YIELD_MS * 1000;
-    // Need a brief pause before calling select after open.
-    uPortTaskBlock(10);
-    while (!p->markedForDeletion) {
-        FD_ZERO(&set);
-        FD_SET(p->uartFd, &set);
-        // Wait for input
-        int res = select(p->uartFd + 1, &set, NULL, NULL, &tv);
-        if (res > 0) {
-            // Input is available.
-            int available;
-            do {
-                available = 0;
-                ioctl(p->uartFd, FIONREAD, &available);
-                size_t cnt = 0;
-                size_t tot = 0;
-                // Sample readPos
-                size_t readPos = p->readPos;
-                U_PORT_MUTEX_LOCK(p->mutex);
-                if (p->writePos >= readPos) {
-                    // Write pos ahead of read. Use the remaining area in the
-                    // buffer first.
-                    cnt = MIN(available, p->bufferSize - p->writePos);
-                    cnt = read(p->uartFd, p->pBuffer + p->writePos, cnt);
-                    if (cnt > 0) {
-                        available -= cnt;
-                        p->writePos = (p->writePos + cnt) % p->bufferSize;
-                    }
-                    tot = cnt;
-                }
-                if ((available > 0) && (p->writePos < readPos)) {
-                    // Read pos ahead of write.
-                    cnt = MIN(available, readPos - p->writePos);
-                    cnt = read(p->uartFd, p->pBuffer + p->writePos, cnt);
-                    if (cnt > 0) {
-                        available -= cnt;
-                        p->writePos = (p->writePos + cnt) % p->bufferSize;
-                        // We might have filled up the buffer, in which case we must wait below.
-                        p->bufferFull = p->writePos == readPos;
-                    }
-                    tot += cnt;
-                }
-                U_PORT_MUTEX_UNLOCK(p->mutex);
-                if ((tot > 0) &&
-                    (p->eventQueueHandle >= 0)) {
-                    // Call the user callback
-                    uPortUartEvent_t event;
-                    event.uartHandle = p->uartFd;
-                    event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
-                    event.pEventCallback = p->pEventCallback;
-                    event.pEventCallbackParam = p->pEventCallbackParam;
-                    uPortEventQueueSend(p->eventQueueHandle, &event, sizeof(event));
-                }
-                while (p->bufferFull && !p->markedForDeletion) {
-                    // Buffer is full, wait for consumption.
-                    uPortTaskBlock(U_PORT_UART_READ_WAIT_MS);
-                }
-            } while ((available > 0) && !p->markedForDeletion);
-        }
-    }
-}
-
 static uPortUartPrefix_t *findPrefix(pthread_t threadId)
 {
     uLinkedList_t *p = gpUartPrefixList;
@@ -240,16 +212,268 @@ static uPortUartData_t *findUart(int32_t handle)
     return NULL;
 }
 
+// Read what has been received on a UART into its buffer, up to
+// the point that the buffer is full; p->mutex must be locked.
+static size_t uartReceive(uPortUartData_t *p)
+{
+    int available = 0;
+    size_t total = 0;
+    size_t space;
+    ssize_t cnt;
+
+    ioctl(p->uartFd, FIONREAD, &available);
+    while ((available > 0) && !p->bufferFull) {
+        // Read up to the end of the buffer or up to the read
+        // position, whichever comes first
+        if (p->writePos >= p->readPos) {
+            space = p->bufferSize - p->writePos;
+        } else {
+            space = p->readPos - p->writePos;
+        }
+        cnt = read(p->uartFd, p->pBuffer + p->writePos, MIN(space, (size_t) available));
+        if (cnt > 0) {
+            available -= cnt;
+            total += cnt;
+            p->writePos = (p->writePos + cnt) % p->bufferSize;
+            p->bufferFull = (p->writePos == p->readPos);
+            p->stats.bytesReceived += (uint32_t) cnt;
+            if (p->bufferFull) {
+                p->stats.bufferFullCount++;
+                p->bufferFullStartMs = uPortGetTickTimeMs();
+            }
+        } else {
+            available = 0;
+        }
+    }
+
+    return total;
+}
+
+// Get the number of received bytes that are contiguous in a UART's
+// buffer, starting at the read position; p->mutex must be locked.
+static size_t rxSpan(const uPortUartData_t *p)
+{
+    size_t span = 0;
+
+    if (p->readPos < p->writePos) {
+        span = p->writePos - p->readPos;
+    } else if ((p->readPos > p->writePos) || p->bufferFull) {
+        // Up to the end of the buffer, the rest is at the start
+        span = p->bufferSize - p->readPos;
+    }
+
+    return span;
+}
+
+// Move the read position of a UART's buffer on by sizeBytes, which
+// must be no more than rxSpan() returns; gMutex and p->mutex must
+// be locked.
+static void rxConsume(uPortUartData_t *p, size_t sizeBytes)
+{
+    struct epoll_event epollEvent = {0};
+
+    if (sizeBytes > 0) {
+        p->readPos = (p->readPos + sizeBytes) % p->bufferSize;
+        if (p->bufferFull) {
+            // There is space again: have the reactor listen
+            // to the UART once more
+            p->bufferFull = false;
+            p->stats.bufferFullTimeMs += uPortGetTickTimeMs() - p->bufferFullStartMs;
+            if (gpReactor != NULL) {
+                epollEvent.events = EPOLLIN;
+                epollEvent.data.fd = p->uartFd;
+                epoll_ctl(gpReactor->epollFd, EPOLL_CTL_MOD, p->uartFd, &epollEvent);
+            }
+        }
+    }
+}
+
+// Service an event from epoll on the given UART.
+static void reactorService(uPortUartReactor_t *pReactor, int fd, uint32_t events)
+{
+    uPortUartData_t *pUartData = NULL;
+    int32_t eventQueueHandle = -1;
+    uPortUartEvent_t event;
+    struct epoll_event epollEvent = {0};
+
+    U_PORT_MUTEX_LOCK(gMutex);
+    // If this reactor is on its way out it no longer owns the UARTs
+    if (gpReactor == pReactor) {
+        pUartData = findUart(fd);
+    }
+    if ((pUartData != NULL) && !pUartData->markedForDeletion) {
+        // Lock the UART before letting go of gMutex:
+        // disposeUartData() locks it too before freeing it,
+        // hence the lock/unlock pairs here can't be balanced
+        uPortMutexLock(pUartData->mutex);
+        eventQueueHandle = pUartData->eventQueueHandle;
+        event.uartHandle = pUartData->uartFd;
+        event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
+        event.pEventCallback = pUartData->pEventCallback;
+        event.pEventCallbackParam = pUartData->pEventCallbackParam;
+        event.pEventPending = &(pUartData->eventPending);
+    } else {
+        pUartData = NULL;
+    }
+    U_PORT_MUTEX_UNLOCK(gMutex);
+
+    if (pUartData != NULL) {
+        if (events & (EPOLLERR | EPOLLHUP)) {
+            // These can't be masked: stop listening to the UART,
+            // e.g. a USB serial adapter has been removed, or the
+            // reactor would spin
+            epoll_ctl(pReactor->epollFd, EPOLL_CTL_DEL, fd, NULL);
+            eventQueueHandle = -1;
+        } else {
+            if ((uartReceive(pUartData) == 0) || pUartData->eventPending) {
+                // Nothing new or an event is already waiting to be
+                // handled: the callback will read everything there is
+                eventQueueHandle = -1;
+            } else if (eventQueueHandle >= 0) {
+                pUartData->eventPending = true;
+            }
+            if (pUartData->bufferFull) {
+                // Stop listening until uPortUartRead() makes space
+                epollEvent.data.fd = fd;
+                epoll_ctl(pReactor->epollFd, EPOLL_CTL_MOD, fd, &epollEvent);
+            }
+        }
+        uPortMutexUnlock(pUartData->mutex);
+        if ((eventQueueHandle >= 0) &&
+            (uPortEventQueueSend(eventQueueHandle, &event, sizeof(event)) != 0)) {
+            // Sending the event failed: the UART may have gone
+            // since it was unlocked, hence the look-up
+            U_PORT_MUTEX_LOCK(gMutex);
+            if (findUart(fd) == pUartData) {
+                pUartData->eventPending = false;
+            }
+            U_PORT_MUTEX_UNLOCK(gMutex);
+        }
+    }
+}
+
+// The reactor task, which receives data for all UARTs.
+static void reactorTask(void *pParam)
+{
+    uPortUartReactor_t *pReactor = (uPortUartReactor_t *) pParam;
+    struct epoll_event events[U_PORT_UART_REACTOR_MAX_NUM_EVENTS];
+    bool stop = false;
+    int numEvents;
+
+    while (!stop) {
+        numEvents = epoll_wait(pReactor->epollFd, events,
+                               sizeof(events) / sizeof(events[0]), -1);
+        for (int x = 0; x < numEvents; x++) {
+            if (events[x].data.fd == pReactor->eventFd) {
+                stop = true;
+            } else {
+                reactorService(pReactor, events[x].data.fd, events[x].events);
+            }
+        }
+    }
+
+    // pReactor must not be touched after this
+    uPortSemaphoreGive(pReactor->stopped);
+    uPortTaskDelete(NULL);
+}
+
+// Free a reactor's resources, including its task; must be called
+// without gMutex locked.
+static void reactorStop(uPortUartReactor_t *pReactor)
+{
+    uint64_t value = 1;
+
+    if (pReactor != NULL) {
+        if (pReactor->task != NULL) {
+            if (write(pReactor->eventFd, &value, sizeof(value)) == sizeof(value)) {
+                uPortSemaphoreTake(pReactor->stopped);
+                // Let the task finish exiting
+                uPortTaskBlock(U_CFG_OS_YIELD_MS);
+            }
+        }
+        if (pReactor->stopped != NULL) {
+            uPortSemaphoreDelete(pReactor->stopped);
+        }
+        if (pReactor->eventFd >= 0) {
+            close(pReactor->eventFd);
+        }
+        if (pReactor->epollFd >= 0) {
+            close(pReactor->epollFd);
+        }
+        uPortFree(pReactor);
+    }
+}
+
+// Start a reactor; gMutex must be locked.
+static uPortUartReactor_t *pReactorStart()
+{
+    uPortUartReactor_t *pReactor = pUPortMalloc(sizeof(uPortUartReactor_t));
+    struct epoll_event epollEvent = {0};
+
+    if (pReactor != NULL) {
+        memset(pReactor, 0, sizeof(*pReactor));
+        pReactor->epollFd = epoll_create1(EPOLL_CLOEXEC);
+        pReactor->eventFd = eventfd(0, EFD_CLOEXEC);
+        epollEvent.events = EPOLLIN;
+        epollEvent.data.fd = pReactor->eventFd;
+        if ((pReactor->epollFd < 0) || (pReactor->eventFd < 0) ||
+            (epoll_ctl(pReactor->epollFd, EPOLL_CTL_ADD, pReactor->eventFd, &epollEvent) != 0) ||
+            (uPortSemaphoreCreate(&(pReactor->stopped), 0, 1) != 0) ||
+            (uPortTaskCreate(reactorTask, "uartReactor", U_PORT_UART_REACTOR_STACK_SIZE_BYTES,
+                             pReactor, U_PORT_UART_REACTOR_PRIORITY, &(pReactor->task)) != 0)) {
+            pReactor->task = NULL;
+            reactorStop(pReactor);
+            pReactor = NULL;
+        }
+    }
+
+    return pReactor;
+}
+
+// Listen for data received on a UART; gMutex must be locked.
+static int32_t reactorAdd(uPortUartData_t *p)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+    struct epoll_event epollEvent = {0};
+
+    if (gpReactor == NULL) {
+        gpReactor = pReactorStart();
+    }
+    if (gpReactor != NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        epollEvent.events = EPOLLIN;
+        epollEvent.data.fd = p->uartFd;
+        if (epoll_ctl(gpReactor->epollFd, EPOLL_CTL_ADD, p->uartFd, &epollEvent) == 0) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    return errorCode;
+}
+
 static void disposeUartData(uPortUartData_t *p)
 {
+    uPortUartReactor_t *pReactor = NULL;
+
     if (p != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
         uLinkedListRemove(&gpUartList, p);
-        if (p->rxTask != NULL) {
-            uPortTaskDelete(p->rxTask);
-            // Wait for the task to exit before
-            // we pull the structures out from under it
-            uPortTaskBlock(U_PORT_UART_START_STOP_WAIT_MS);
+        if ((gpReactor != NULL) && (p->uartFd >= 0)) {
+            epoll_ctl(gpReactor->epollFd, EPOLL_CTL_DEL, p->uartFd, NULL);
         }
+        if (gpUartList == NULL) {
+            // Last one out turns off the lights
+            pReactor = gpReactor;
+            gpReactor = NULL;
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+        if (p->mutex != NULL) {
+            // Wait for the reactor to finish with the UART, if
+            // it was in the middle of doing so
+            U_PORT_MUTEX_LOCK(p->mutex);
+            U_PORT_MUTEX_UNLOCK(p->mutex);
+        }
+        reactorStop(pReactor);
         if (p->eventQueueHandle >= 0) {
             uPortEventQueueClose(p->eventQueueHandle);
         }
@@ -267,6 +491,18 @@ static void disposeUartData(uPortUartData_t *p)
     }
 }
 
+// Reset the statistics of a UART; the error counts are kept by
+// the driver (if it supports TIOCGICOUNT, a PTY doesn't, in which
+// case they stay at zero) and so a baseline is taken here.
+static void statsReset(uPortUartData_t *p)
+{
+    memset(&(p->stats), 0, sizeof(p->stats));
+    p->bufferFullStartMs = uPortGetTickTimeMs();
+    if (ioctl(p->uartFd, TIOCGICOUNT, &(p->icountBase)) != 0) {
+        memset(&(p->icountBase), 0, sizeof(p->icountBase));
+    }
+}
+
 static uint32_t suspendResumeUartHwHandshake(int32_t handle, bool suspendNotResume)
 {
     uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
@@ -485,18 +721,20 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
     pUartData->readPos = 0;
     pUartData->writePos = 0;
     pUartData->bufferFull = false;
+    statsReset(pUartData);
     if (uPortMutexCreate(&(pUartData->mutex)) != 0) {
         FAIL(U_ERROR_COMMON_NO_MEMORY);
     }
-    if (uPortTaskCreate(readTask, "", 4 * 1024, pUartData, U_CFG_OS_PRIORITY_MAX - 5,
-                        &(pUartData->rxTask)) != 0) {
-        FAIL(U_ERROR_COMMON_PLATFORM);
-    }
-    // Wait for the read task to start
-    uPortTaskBlock(U_PORT_UART_START_STOP_WAIT_MS);
+    int32_t errorCode;
     U_PORT_MUTEX_LOCK(gMutex);
-    uLinkedListAdd(&gpUartList, (void *)pUartData);
+    errorCode = reactorAdd(pUartData);
+    if (errorCode == 0) {
+        uLinkedListAdd(&gpUartList, (void *)pUartData);
+    }
     U_PORT_MUTEX_UNLOCK(gMutex);
+    if (errorCode != 0) {
+        FAIL(errorCode);
+    }
     U_ATOMIC_INCREMENT(&gResourceAllocCount);
     return (int32_t)(pUartData->uartFd);
 }
@@ -564,36 +802,63 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
             (pUartData != NULL) && !pUartData->markedForDeletion) {
             sizeOrErrorCode = 0;
             U_PORT_MUTEX_LOCK(pUartData->mutex);
-            if (pUartData->readPos < pUartData->writePos) {
-                // Read pointer is behind write, just take as much
-                // of the difference as the user allows
-                sizeOrErrorCode = MIN(pUartData->writePos - pUartData->readPos, (int32_t)sizeBytes);
-                memcpy(pBuffer, pUartData->pBuffer + pUartData->readPos, sizeOrErrorCode);
-                // Move the pointer on
-                pUartData->readPos += sizeOrErrorCode;
-            } else if ((pUartData->readPos > pUartData->writePos) || pUartData->bufferFull) {
-                // Read pointer is ahead of write or buffer is full, first take up to the
-                // end of the buffer as far as the user allows
-                size_t cnt = MIN(pUartData->bufferSize - pUartData->readPos, (int32_t)sizeBytes);
+            // At most two goes: up to the end of the buffer
+            // and then on from the start
+            for (size_t x = 0; (x < 2) && (sizeBytes > 0); x++) {
+                size_t cnt = MIN(rxSpan(pUartData), sizeBytes);
                 memcpy(pBuffer, pUartData->pBuffer + pUartData->readPos, cnt);
+                rxConsume(pUartData, cnt);
                 pBuffer = (char *) pBuffer + cnt;
                 sizeBytes -= cnt;
-                sizeOrErrorCode = (int32_t)cnt;
-                // Move the read pointer on, wrapping as necessary
-                pUartData->readPos = (pUartData->readPos + cnt) % pUartData->bufferSize;
-                // If there is still room in the user buffer then
-                // carry on taking up to the write pointer
-                if (sizeBytes > 0) {
-                    cnt = MIN(pUartData->writePos, sizeBytes);
-                    memcpy(pBuffer, pUartData->pBuffer, cnt);
-                    sizeOrErrorCode += cnt;
-                    // Move the read pointer on
-                    pUartData->readPos += cnt;
-                }
+                sizeOrErrorCode += (int32_t) cnt;
             }
-            if (pUartData->bufferFull && (sizeOrErrorCode > 0)) {
-                // Release possible waiting read task.
-                pUartData->bufferFull = false;
+            U_PORT_MUTEX_UNLOCK(pUartData->mutex);
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+    return sizeOrErrorCode;
+}
+
+// Get a pointer to the received data.
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    if (gMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        uPortUartData_t *pUartData = findUart(handle);
+        if ((ppData != NULL) && (pUartData != NULL) && !pUartData->markedForDeletion) {
+            U_PORT_MUTEX_LOCK(pUartData->mutex);
+            // The reactor only writes outside the span, so the
+            // span stays put until it is consumed
+            sizeOrErrorCode = (int32_t) rxSpan(pUartData);
+            *ppData = NULL;
+            if (sizeOrErrorCode > 0) {
+                *ppData = pUartData->pBuffer + pUartData->readPos;
+            }
+            U_PORT_MUTEX_UNLOCK(pUartData->mutex);
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+    return sizeOrErrorCode;
+}
+
+// Remove data obtained with uPortUartReadSpan().
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    if (gMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        uPortUartData_t *pUartData = findUart(handle);
+        if ((pUartData != NULL) && !pUartData->markedForDeletion) {
+            sizeOrErrorCode = 0;
+            U_PORT_MUTEX_LOCK(pUartData->mutex);
+            for (size_t x = 0; (x < 2) && (sizeBytes > 0); x++) {
+                size_t cnt = MIN(rxSpan(pUartData), sizeBytes);
+                rxConsume(pUartData, cnt);
+                sizeBytes -= cnt;
+                sizeOrErrorCode += (int32_t) cnt;
             }
             U_PORT_MUTEX_UNLOCK(pUartData->mutex);
         }
@@ -614,7 +879,11 @@ int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
         if ((pBuffer != NULL) && (sizeBytes > 0) &&
             (pUartData != NULL) && !pUartData->markedForDeletion) {
             sizeOrErrorCode = write(pUartData->uartFd, pBuffer, sizeBytes);
-            if (sizeOrErrorCode < 0) {
+            if (sizeOrErrorCode >= 0) {
+                U_PORT_MUTEX_LOCK(pUartData->mutex);
+                pUartData->stats.bytesSent += (uint32_t) sizeOrErrorCode;
+                U_PORT_MUTEX_UNLOCK(pUartData->mutex);
+            } else {
                 sizeOrErrorCode = (int32_t)U_ERROR_COMMON_PLATFORM;
             }
         }
@@ -623,6 +892,54 @@ int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
     return sizeOrErrorCode;
 }
 
+// Write several buffers to the given UART interface.
+int32_t uPortUartWriteVec(int32_t handle, const uPortUartIoVec_t *pVec,
+                          size_t count)
+{
+    int32_t sizeOrErrorCode = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+    struct iovec iov[U_PORT_UART_WRITE_VEC_MAX_NUM];
+    size_t numIov = 0;
+    size_t wanted = 0;
+    ssize_t written;
+    bool allSent = true;
+    if (gMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        uPortUartData_t *pUartData = findUart(handle);
+        if (((pVec != NULL) || (count == 0)) &&
+            (pUartData != NULL) && !pUartData->markedForDeletion) {
+            sizeOrErrorCode = 0;
+            for (size_t x = 0; (x < count) && allSent; x++) {
+                if (pVec[x].sizeBytes > 0) {
+                    iov[numIov].iov_base = (void *) pVec[x].pBuffer;
+                    iov[numIov].iov_len = pVec[x].sizeBytes;
+                    wanted += pVec[x].sizeBytes;
+                    numIov++;
+                }
+                if ((numIov == U_PORT_UART_WRITE_VEC_MAX_NUM) ||
+                    ((x == count - 1) && (numIov > 0))) {
+                    written = writev(pUartData->uartFd, iov, (int) numIov);
+                    allSent = (written == (ssize_t) wanted);
+                    if (written >= 0) {
+                        sizeOrErrorCode += (int32_t) written;
+                    } else if (sizeOrErrorCode == 0) {
+                        sizeOrErrorCode = (int32_t)U_ERROR_COMMON_PLATFORM;
+                    }
+                    numIov = 0;
+                    wanted = 0;
+                }
+            }
+            U_PORT_MUTEX_LOCK(pUartData->mutex);
+            if (sizeOrErrorCode > 0) {
+                pUartData->stats.bytesSent += (uint32_t) sizeOrErrorCode;
+            }
+            U_PORT_MUTEX_UNLOCK(pUartData->mutex);
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+    return sizeOrErrorCode;
+}
+
 // Set an event callback.
 int32_t uPortUartEventCallbackSet(int32_t handle,
                                   uint32_t filter,
@@ -651,6 +968,7 @@ int32_t uPortUartEventCallbackSet(int32_t handle,
                                             priority,
                                             U_PORT_UART_EVENT_QUEUE_SIZE);
             if (errorCode >= 0) {
+                pUartData->eventPending = false;
                 pUartData->eventQueueHandle = (int32_t) errorCode;
                 pUartData->eventFilter = filter;
                 pUartData->pEventCallback = pFunction;
@@ -743,6 +1061,8 @@ int32_t uPortUartEventSend(int32_t handle, uint32_t eventBitMap)
             event.eventBitMap = eventBitMap;
             event.pEventCallback = pUartData->pEventCallback;
             event.pEventCallbackParam = pUartData->pEventCallbackParam;
+            // Explicitly-sent events are not coalesced
+            event.pEventPending = NULL;
             errorCode = uPortEventQueueSend(pUartData->eventQueueHandle,
                                             &event, sizeof(event));
         }
@@ -830,6 +1150,56 @@ void uPortUartCtsResume(int32_t handle)
     suspendResumeUartHwHandshake(handle, true);
 }
 
+// Get the statistics of a UART.
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    struct serial_icounter_struct icount;
+    if (gMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        uPortUartData_t *pUartData = findUart(handle);
+        if ((pStats != NULL) && (pUartData != NULL) && !pUartData->markedForDeletion) {
+            U_PORT_MUTEX_LOCK(pUartData->mutex);
+            *pStats = pUartData->stats;
+            if (pUartData->bufferFull) {
+                pStats->bufferFullTimeMs += uPortGetTickTimeMs() - pUartData->bufferFullStartMs;
+            }
+            if (ioctl(pUartData->uartFd, TIOCGICOUNT, &icount) == 0) {
+                // The HW FIFO overruns plus anything the tty layer
+                // had to drop because its own buffer was full
+                pStats->overrunCount = (uint32_t) ((icount.overrun - pUartData->icountBase.overrun) +
+                                                   (icount.buf_overrun - pUartData->icountBase.buf_overrun));
+                pStats->framingErrorCount = (uint32_t) (icount.frame - pUartData->icountBase.frame);
+                pStats->parityErrorCount = (uint32_t) (icount.parity - pUartData->icountBase.parity);
+            }
+            U_PORT_MUTEX_UNLOCK(pUartData->mutex);
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+    return (int32_t) errorCode;
+}
+
+// Reset the statistics of a UART.
+int32_t uPortUartStatsReset(int32_t handle)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    if (gMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gMutex);
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        uPortUartData_t *pUartData = findUart(handle);
+        if ((pUartData != NULL) && !pUartData->markedForDeletion) {
+            U_PORT_MUTEX_LOCK(pUartData->mutex);
+            statsReset(pUartData);
+            U_PORT_MUTEX_UNLOCK(pUartData->mutex);
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+    return (int32_t) errorCode;
+}
+
 // Get the number of UART interfaces currently open.
 int32_t uPortUartResourceAllocCount()
 {
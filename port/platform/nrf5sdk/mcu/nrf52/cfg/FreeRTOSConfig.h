@@ -228,4 +228,16 @@ extern uint32_t SystemCoreClock;
 #define FREERTOS_TASKS_C_ADDITIONS_INIT()
 #endif
 
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+/* When ubxlib is told to allocate its OS resources statically,
+ * FreeRTOS must support that and must tell ubxlib when it has
+ * finished with a deleted task so that its memory can be re-used
+ */
+#define configSUPPORT_STATIC_ALLOCATION                  1
+#if !(defined(__ASSEMBLY__) || defined(__ASSEMBLER__))
+void uPortOsStaticTaskCleanUp(void *pTcb);
+#endif
+#define portCLEAN_UP_TCB(pxTCB)                          uPortOsStaticTaskCleanUp(pxTCB)
+#endif
+
 #endif /* FREERTOS_CONFIG_H */
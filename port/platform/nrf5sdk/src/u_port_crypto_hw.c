@@ -0,0 +1,249 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Hardware crypto backend for the NRF52 platform, using the
+ * ARM CryptoCell CC310 of the NRF52840 through the nrf_cc310 runtime
+ * library of the nRF5 SDK; only compiled in if U_PORT_CRYPTO_HW is
+ * defined.  Since the CryptoCell can only reach RAM, operations on
+ * data that is elsewhere (e.g. constants in flash), or that are
+ * requested while the CryptoCell is in use by another task, are left
+ * to the mbedTLS software implementation.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#ifdef U_PORT_CRYPTO_HW
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+#include "string.h"    // memcpy()
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_crypto.h"
+
+#include "nrf.h"
+#include "sns_silib.h"
+#include "crys_hash.h"
+#include "crys_hmac.h"
+#include "ssi_aes.h"
+
+#include "u_port_crypto_hw.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/** The start of the RAM that the CryptoCell can reach.
+ */
+#define U_PORT_CRYPTO_HW_RAM_START 0x20000000UL
+
+/** The end of the RAM that the CryptoCell can reach.
+ */
+#define U_PORT_CRYPTO_HW_RAM_END 0x20040000UL
+
+/** The length of an AES block.
+ */
+#define U_PORT_CRYPTO_HW_AES_BLOCK_LENGTH_BYTES 16
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** True while the CryptoCell is in use.
+ */
+static bool gInUse = false;
+
+/** True once the CryptoCell library has been initialised.
+ */
+static bool gLibInitialised = false;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Return true if the given block of memory is reachable by the
+// CryptoCell.
+static bool inRam(const void *pData, size_t lengthBytes)
+{
+    uintptr_t start = (uintptr_t) pData;
+
+    return (lengthBytes == 0) ||
+           ((start >= U_PORT_CRYPTO_HW_RAM_START) &&
+            (start + lengthBytes <= U_PORT_CRYPTO_HW_RAM_END));
+}
+
+// Claim the CryptoCell and switch it on, returning false if it is
+// already in use or cannot be initialised.
+static bool claim()
+{
+    bool claimed = false;
+
+    if (uPortEnterCritical() == 0) {
+        if (!gInUse) {
+            gInUse = true;
+            claimed = true;
+        }
+        uPortExitCritical();
+    }
+
+    if (claimed) {
+        NRF_CRYPTOCELL->ENABLE = 1;
+        if (!gLibInitialised) {
+            gLibInitialised = (SaSi_LibInit() == SA_SILIB_RET_OK);
+        }
+        if (!gLibInitialised) {
+            NRF_CRYPTOCELL->ENABLE = 0;
+            gInUse = false;
+            claimed = false;
+        }
+    }
+
+    return claimed;
+}
+
+// Switch the CryptoCell off and release it.
+static void release()
+{
+    NRF_CRYPTOCELL->ENABLE = 0;
+    gInUse = false;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Perform a SHA256 calculation in hardware.
+int32_t uPortCryptoHwSha256(const char *pInput,
+                            size_t inputLengthBytes,
+                            char *pOutput)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    CRYS_HASH_Result_t result;
+
+    if (inRam(pInput, inputLengthBytes) && claim()) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        if (CRYS_HASH(CRYS_HASH_SHA256_mode, (uint8_t *) pInput,
+                      inputLengthBytes, result) == CRYS_OK) {
+            memcpy(pOutput, result, U_PORT_CRYPTO_SHA256_OUTPUT_LENGTH_BYTES);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+        release();
+    }
+
+    return errorCode;
+}
+
+// Perform a HMAC SHA256 calculation in hardware.
+int32_t uPortCryptoHwHmacSha256(const char *pKey,
+                                size_t keyLengthBytes,
+                                const char *pInput,
+                                size_t inputLengthBytes,
+                                char *pOutput)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    CRYS_HASH_Result_t result;
+
+    if ((pKey != NULL) && (keyLengthBytes > 0) &&
+        (keyLengthBytes <= UINT16_MAX) &&
+        inRam(pKey, keyLengthBytes) &&
+        inRam(pInput, inputLengthBytes) && claim()) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        if (CRYS_HMAC(CRYS_HASH_SHA256_mode, (uint8_t *) pKey,
+                      (uint16_t) keyLengthBytes, (uint8_t *) pInput,
+                      inputLengthBytes, result) == CRYS_OK) {
+            memcpy(pOutput, result, U_PORT_CRYPTO_SHA256_OUTPUT_LENGTH_BYTES);
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+        release();
+    }
+
+    return errorCode;
+}
+
+// Perform AES 128 CBC encryption or decryption in hardware.
+int32_t uPortCryptoHwAes128Cbc(bool encrypt,
+                               const char *pKey,
+                               size_t keyLengthBytes,
+                               char *pInitVector,
+                               const char *pInput,
+                               size_t lengthBytes,
+                               char *pOutput)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+    SaSiAesUserContext_t context;
+    SaSiAesUserKeyData_t keyData;
+    SaSiAesIv_t initVector;
+    char nextInitVector[U_PORT_CRYPTO_AES128_INITIALISATION_VECTOR_LENGTH_BYTES];
+    size_t outputLengthBytes = lengthBytes;
+    bool success = false;
+
+    if ((keyLengthBytes == U_PORT_CRYPTO_HW_AES_BLOCK_LENGTH_BYTES) &&
+        (lengthBytes > 0) &&
+        ((lengthBytes % U_PORT_CRYPTO_HW_AES_BLOCK_LENGTH_BYTES) == 0) &&
+        inRam(pInput, lengthBytes) && inRam(pOutput, lengthBytes) &&
+        claim()) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        if (!encrypt) {
+            // The next initialisation vector is the last block
+            // of the input, which may be overwritten by the output
+            memcpy(nextInitVector,
+                   pInput + lengthBytes - sizeof(nextInitVector),
+                   sizeof(nextInitVector));
+        }
+        memcpy(initVector, pInitVector, sizeof(initVector));
+        keyData.pKey = (uint8_t *) pKey;
+        keyData.keySize = keyLengthBytes;
+        if (SaSi_AesInit(&context, encrypt ? SASI_AES_ENCRYPT : SASI_AES_DECRYPT,
+                         SASI_AES_MODE_CBC, SASI_AES_PADDING_NONE) == SASI_OK) {
+            success = (SaSi_AesSetKey(&context, SASI_AES_USER_KEY,
+                                      &keyData, sizeof(keyData)) == SASI_OK) &&
+                      (SaSi_AesSetIv(&context, initVector) == SASI_OK) &&
+                      (SaSi_AesFinish(&context, lengthBytes, (uint8_t *) pInput,
+                                      lengthBytes, (uint8_t *) pOutput,
+                                      &outputLengthBytes) == SASI_OK);
+            SaSi_AesFree(&context);
+        }
+        if (success && (outputLengthBytes == lengthBytes)) {
+            if (encrypt) {
+                // The next initialisation vector is the last
+                // block of the output
+                memcpy(nextInitVector,
+                       pOutput + lengthBytes - sizeof(nextInitVector),
+                       sizeof(nextInitVector));
+            }
+            // Update the initialisation vector as mbedTLS would
+            memcpy(pInitVector, nextInitVector, sizeof(nextInitVector));
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+        release();
+    }
+
+    return errorCode;
+}
+
+#endif // #ifdef U_PORT_CRYPTO_HW
+
+// End of file
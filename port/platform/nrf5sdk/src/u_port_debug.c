@@ -29,6 +29,8 @@
 
 #include "u_error_common.h"
 
+#include "u_port_debug.h"
+
 #if NRF_LOG_ENABLED
 # include "nrfx.h"
 # include "nrf_log.h"
@@ -80,17 +82,19 @@ void uPortLogF(const char *pFormat, ...)
 
     if (gPortLogOn) {
         va_start(args, pFormat);
+        if (!uPortLogAsyncWrite(pFormat, args)) {
 #if NRF_LOG_ENABLED
-        vsnprintf(gLogBuffer, sizeof(gLogBuffer), pFormat, args);
-        NRF_LOG_RAW_INFO("%s", gLogBuffer);
-        NRF_LOG_FLUSH();
+            vsnprintf(gLogBuffer, sizeof(gLogBuffer), pFormat, args);
+            NRF_LOG_RAW_INFO("%s", gLogBuffer);
+            NRF_LOG_FLUSH();
 #else
 # ifdef U_CFG_PLAIN_OLD_PRINTF
-        vprintf(pFormat, args);
+            vprintf(pFormat, args);
 # else
-        SEGGER_RTT_vprintf(0, pFormat, &args);
+            SEGGER_RTT_vprintf(0, pFormat, &args);
 # endif
 #endif
+        }
         va_end(args);
     }
     gStdoutCounter++;
@@ -284,6 +284,9 @@ int32_t uPortI2cInit()
             }
         }
     }
+    if (errorCode == 0) {
+        errorCode = uPortI2cAsyncInit();
+    }
 
     return errorCode;
 #else
@@ -295,6 +298,8 @@ int32_t uPortI2cInit()
 void uPortI2cDeinit()
 {
     if (gMutex != NULL) {
+        // Stop asynchronous transactions first, they need the I2C instances
+        uPortI2cAsyncDeinit();
 
         U_PORT_MUTEX_LOCK(gMutex);
 
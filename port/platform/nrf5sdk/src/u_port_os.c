@@ -62,6 +62,7 @@
 #include "stddef.h"    // NULL, size_t etc.
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
+#include "string.h"    // memset(), strncpy()
 
 #include "u_cfg_sw.h"
 #include "u_cfg_os_platform_specific.h"
@@ -72,6 +73,7 @@
 #include "u_port_debug.h"
 #include "u_port.h"
 #include "u_port_os.h"
+#include "u_port_heap.h"
 #include "u_port_private.h"
 
 #include "FreeRTOS.h"
@@ -84,6 +86,26 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+
+// configSUPPORT_STATIC_ALLOCATION and portCLEAN_UP_TCB() are
+// set by FreeRTOSConfig.h when U_PORT_OS_STATIC_ALLOCATION is defined
+# if !configSUPPORT_STATIC_ALLOCATION
+#  error U_PORT_OS_STATIC_ALLOCATION requires configSUPPORT_STATIC_ALLOCATION.
+# endif
+
+/** The total number of statically allocated tasks.
+ */
+# define U_PORT_OS_STATIC_NUM_TASKS (U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM + \
+                                     U_PORT_OS_STATIC_TASK_STACK_LARGE_NUM)
+
+/** The total number of statically allocated queues.
+ */
+# define U_PORT_OS_STATIC_NUM_QUEUES (U_PORT_OS_STATIC_QUEUE_SMALL_NUM + \
+                                      U_PORT_OS_STATIC_QUEUE_LARGE_NUM)
+
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -96,10 +118,137 @@
  */
 static volatile int32_t gResourceAllocCount = 0;
 
+/** The tasks created by uPortTaskCreate(), so that uPortTaskInfoGet()
+ * can tell them apart from the tasks of the system; this is only
+ * ever compared against, the handles are not used.
+ */
+static TaskHandle_t gTaskList[U_PORT_OS_TASK_INFO_MAX_NUM_TASKS] = {0};
+
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+
+/** Task control blocks; a slot remains in use after the task has
+ * deleted itself until the idle task has tidied it up.
+ */
+static StaticTask_t gStaticTask[U_PORT_OS_STATIC_NUM_TASKS];
+static volatile bool gStaticTaskInUse[U_PORT_OS_STATIC_NUM_TASKS];
+
+/** Task stacks: the first U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM
+ * slots of gStaticTask[] use the small ones.
+ */
+static StackType_t gStaticStackSmall[U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM]
+[U_PORT_OS_STATIC_TASK_STACK_SMALL_SIZE_BYTES / sizeof(StackType_t)];
+static StackType_t gStaticStackLarge[U_PORT_OS_STATIC_TASK_STACK_LARGE_NUM]
+[U_PORT_OS_STATIC_TASK_STACK_LARGE_SIZE_BYTES / sizeof(StackType_t)];
+
+/** Queues: the first U_PORT_OS_STATIC_QUEUE_SMALL_NUM slots of
+ * gStaticQueue[] use the small storage.
+ */
+static StaticQueue_t gStaticQueue[U_PORT_OS_STATIC_NUM_QUEUES];
+static volatile bool gStaticQueueInUse[U_PORT_OS_STATIC_NUM_QUEUES];
+static uint8_t gStaticQueueStorageSmall[U_PORT_OS_STATIC_QUEUE_SMALL_NUM]
+[U_PORT_OS_STATIC_QUEUE_SMALL_SIZE_BYTES];
+static uint8_t gStaticQueueStorageLarge[U_PORT_OS_STATIC_QUEUE_LARGE_NUM]
+[U_PORT_OS_STATIC_QUEUE_LARGE_SIZE_BYTES];
+
+/** Mutexes.
+ */
+static StaticSemaphore_t gStaticMutex[U_PORT_OS_STATIC_NUM_MUTEXES];
+static volatile bool gStaticMutexInUse[U_PORT_OS_STATIC_NUM_MUTEXES];
+
+/** Semaphores.
+ */
+static StaticSemaphore_t gStaticSemaphore[U_PORT_OS_STATIC_NUM_SEMAPHORES];
+static volatile bool gStaticSemaphoreInUse[U_PORT_OS_STATIC_NUM_SEMAPHORES];
+
+/** Memory for the FreeRTOS idle and timer tasks, which FreeRTOS
+ * expects the application to provide when static allocation is on.
+ */
+static StaticTask_t gIdleTask;
+static StackType_t gIdleStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t gTimerTask;
+static StackType_t gTimerStack[configTIMER_TASK_STACK_DEPTH];
+
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+// Replace the first entry in gTaskList[] that is oldHandle with
+// newHandle: use NULL as oldHandle to add a task and as newHandle
+// to remove it.
+static void taskListUpdate(TaskHandle_t oldHandle, TaskHandle_t newHandle)
+{
+    taskENTER_CRITICAL();
+    for (size_t x = 0; x < sizeof(gTaskList) / sizeof(gTaskList[0]); x++) {
+        if (gTaskList[x] == oldHandle) {
+            gTaskList[x] = newHandle;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+}
+
+#if (configUSE_TRACE_FACILITY == 1)
+// Return true if the given task was created by uPortTaskCreate().
+static bool taskListContains(TaskHandle_t handle)
+{
+    bool found = false;
+
+    taskENTER_CRITICAL();
+    for (size_t x = 0; (x < sizeof(gTaskList) / sizeof(gTaskList[0])) && !found; x++) {
+        found = (gTaskList[x] == handle);
+    }
+    taskEXIT_CRITICAL();
+
+    return found;
+}
+#endif
+
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+
+// Take the first free slot from a static table whose storage is at
+// least sizeBytes, where the first numSmall slots have smallSizeBytes
+// of storage and the rest largeSizeBytes; returns the index of the
+// slot or -1 if there is none.
+static int32_t staticSlotTake(volatile bool *pInUse, size_t numSlots,
+                              size_t numSmall, size_t smallSizeBytes,
+                              size_t largeSizeBytes, size_t sizeBytes)
+{
+    int32_t index = -1;
+    size_t slotSizeBytes;
+
+    taskENTER_CRITICAL();
+    for (size_t x = 0; (x < numSlots) && (index < 0); x++) {
+        slotSizeBytes = (x < numSmall) ? smallSizeBytes : largeSizeBytes;
+        if (!pInUse[x] && (sizeBytes <= slotSizeBytes)) {
+            pInUse[x] = true;
+            index = (int32_t) x;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return index;
+}
+
+// Return the slot of a static table that a handle points into, or -1
+// if the handle is not from that table (e.g. it was created elsewhere).
+static int32_t staticSlotFind(const void *pHandle, const void *pTable,
+                              size_t numSlots, size_t slotSizeBytes)
+{
+    int32_t index = -1;
+    const uint8_t *pStart = (const uint8_t *) pTable;
+    const uint8_t *p = (const uint8_t *) pHandle;
+
+    if ((p >= pStart) && (p < pStart + (numSlots * slotSizeBytes))) {
+        index = (int32_t) ((size_t) (p - pStart) / slotSizeBytes);
+    }
+
+    return index;
+}
+
+#endif
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: TASKS
  * -------------------------------------------------------------- */
@@ -117,6 +266,39 @@ int32_t uPortTaskCreate(void (*pFunction)(void *),
     if ((pFunction != NULL) && (pTaskHandle != NULL) &&
         (priority >= U_CFG_OS_PRIORITY_MIN) &&
         (priority <= U_CFG_OS_PRIORITY_MAX)) {
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        errorCode = U_ERROR_COMMON_NO_MEMORY;
+        int32_t slot = staticSlotTake(gStaticTaskInUse, U_PORT_OS_STATIC_NUM_TASKS,
+                                      U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM,
+                                      U_PORT_OS_STATIC_TASK_STACK_SMALL_SIZE_BYTES,
+                                      U_PORT_OS_STATIC_TASK_STACK_LARGE_SIZE_BYTES,
+                                      stackSizeBytes);
+        if (slot >= 0) {
+            StackType_t *pStack = gStaticStackSmall[0];
+            size_t slotStackSizeBytes = U_PORT_OS_STATIC_TASK_STACK_SMALL_SIZE_BYTES;
+            if (slot < U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM) {
+                pStack = gStaticStackSmall[slot];
+            } else {
+                pStack = gStaticStackLarge[slot - U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM];
+                slotStackSizeBytes = U_PORT_OS_STATIC_TASK_STACK_LARGE_SIZE_BYTES;
+            }
+            // No need to arrange anything for the slot to be freed:
+            // portCLEAN_UP_TCB() calls uPortOsStaticTaskCleanUp()
+            // once FreeRTOS has finished with the task
+            *pTaskHandle = (uPortTaskHandle_t) xTaskCreateStatic(pFunction, pName,
+                                                                 slotStackSizeBytes /
+                                                                 sizeof(StackType_t),
+                                                                 pParameter, priority,
+                                                                 pStack, &(gStaticTask[slot]));
+            if (*pTaskHandle != NULL) {
+                errorCode = U_ERROR_COMMON_SUCCESS;
+                U_ATOMIC_INCREMENT(&gResourceAllocCount);
+                U_PORT_OS_DEBUG_PRINT_TASK_CREATE(*pTaskHandle, pName, stackSizeBytes, priority);
+            } else {
+                gStaticTaskInUse[slot] = false;
+            }
+        }
+#else
         // On the native FreeRTOS that NRF52840 uses stack size is
         // actually in words, so divide by four here.
         if (xTaskCreate(pFunction, pName, stackSizeBytes / 4,
@@ -126,6 +308,11 @@ int32_t uPortTaskCreate(void (*pFunction)(void *),
             U_ATOMIC_INCREMENT(&gResourceAllocCount);
             U_PORT_OS_DEBUG_PRINT_TASK_CREATE(*pTaskHandle, pName, stackSizeBytes, priority);
         }
+#endif
+    }
+
+    if (errorCode == U_ERROR_COMMON_SUCCESS) {
+        taskListUpdate(NULL, (TaskHandle_t) *pTaskHandle);
     }
 
     return (int32_t) errorCode;
@@ -140,6 +327,7 @@ int32_t uPortTaskDelete(const uPortTaskHandle_t taskHandle)
     if (taskHandle == NULL) {
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_TASK_DELETE(xTaskGetCurrentTaskHandle());
+        taskListUpdate(xTaskGetCurrentTaskHandle(), NULL);
         vTaskDelete((TaskHandle_t) taskHandle);
         errorCode = U_ERROR_COMMON_SUCCESS;
     }
@@ -176,6 +364,47 @@ int32_t uPortTaskStackMinFree(const uPortTaskHandle_t taskHandle)
     return uxTaskGetStackHighWaterMark(handle) * 4;
 }
 
+#if (configUSE_TRACE_FACILITY == 1)
+// Get information about all of the tasks created by uPortTaskCreate().
+int32_t uPortTaskInfoGet(uPortTaskInfo_t *pInfo, size_t maxNum)
+{
+    int32_t errorCodeOrNumTasks = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+    // Allow a few spare in case tasks are created while we're here,
+    // since uxTaskGetSystemState() returns nothing if there isn't room
+    UBaseType_t numStatus = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *pStatus = (TaskStatus_t *) pUPortMalloc(numStatus * sizeof(TaskStatus_t));
+
+    if (pStatus != NULL) {
+        errorCodeOrNumTasks = 0;
+        numStatus = uxTaskGetSystemState(pStatus, numStatus, NULL);
+        for (size_t x = 0; x < numStatus; x++) {
+            if (taskListContains(pStatus[x].xHandle)) {
+                if ((pInfo != NULL) && ((size_t) errorCodeOrNumTasks < maxNum)) {
+                    pInfo->handle = (uPortTaskHandle_t) pStatus[x].xHandle;
+                    memset(pInfo->name, 0, sizeof(pInfo->name));
+                    if (pStatus[x].pcTaskName != NULL) {
+                        strncpy(pInfo->name, pStatus[x].pcTaskName, sizeof(pInfo->name) - 1);
+                    }
+                    // The water mark is in words on NRF52
+                    pInfo->stackMinFreeBytes = (int32_t) pStatus[x].usStackHighWaterMark * 4;
+                    pInfo->cpuTimeUs = (int64_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#if (configGENERATE_RUN_TIME_STATS == 1)
+                    // portGET_RUN_TIME_COUNTER_VALUE() must count microseconds
+                    // for this to be right
+                    pInfo->cpuTimeUs = (int64_t) pStatus[x].ulRunTimeCounter;
+#endif
+                    pInfo++;
+                }
+                errorCodeOrNumTasks++;
+            }
+        }
+        uPortFree(pStatus);
+    }
+
+    return errorCodeOrNumTasks;
+}
+#endif
+
 // Get the current task handle.
 int32_t uPortTaskGetHandle(uPortTaskHandle_t *pTaskHandle)
 {
@@ -203,8 +432,34 @@ int32_t uPortQueueCreate(size_t queueLength,
     if (pQueueHandle != NULL) {
         errorCode = U_ERROR_COMMON_PLATFORM;
         // Actually create the queue
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        *pQueueHandle = NULL;
+        int32_t slot = staticSlotTake(gStaticQueueInUse, U_PORT_OS_STATIC_NUM_QUEUES,
+                                      U_PORT_OS_STATIC_QUEUE_SMALL_NUM,
+                                      U_PORT_OS_STATIC_QUEUE_SMALL_SIZE_BYTES,
+                                      U_PORT_OS_STATIC_QUEUE_LARGE_SIZE_BYTES,
+                                      queueLength * itemSizeBytes);
+        if (slot < 0) {
+            errorCode = U_ERROR_COMMON_NO_MEMORY;
+        } else {
+            uint8_t *pStorage = gStaticQueueStorageSmall[0];
+            if (slot < U_PORT_OS_STATIC_QUEUE_SMALL_NUM) {
+                pStorage = gStaticQueueStorageSmall[slot];
+            } else {
+                pStorage = gStaticQueueStorageLarge[slot - U_PORT_OS_STATIC_QUEUE_SMALL_NUM];
+            }
+            *pQueueHandle = (uPortQueueHandle_t) xQueueCreateStatic(queueLength,
+                                                                    itemSizeBytes,
+                                                                    pStorage,
+                                                                    &(gStaticQueue[slot]));
+            if (*pQueueHandle == NULL) {
+                gStaticQueueInUse[slot] = false;
+            }
+        }
+#else
         *pQueueHandle = (uPortQueueHandle_t) xQueueCreate(queueLength,
                                                           itemSizeBytes);
+#endif
         if (*pQueueHandle != NULL) {
             errorCode = U_ERROR_COMMON_SUCCESS;
             U_ATOMIC_INCREMENT(&gResourceAllocCount);
@@ -222,6 +477,14 @@ int32_t uPortQueueDelete(const uPortQueueHandle_t queueHandle)
 
     if (queueHandle != NULL) {
         vQueueDelete((QueueHandle_t) queueHandle);
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        int32_t slot = staticSlotFind(queueHandle, gStaticQueue,
+                                      U_PORT_OS_STATIC_NUM_QUEUES,
+                                      sizeof(gStaticQueue[0]));
+        if (slot >= 0) {
+            gStaticQueueInUse[slot] = false;
+        }
+#endif
         errorCode = U_ERROR_COMMON_SUCCESS;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_QUEUE_DELETE(queueHandle);
@@ -386,7 +649,21 @@ int32_t MTX_FN(uPortMutexCreate(uPortMutexHandle_t *pMutexHandle))
     if (pMutexHandle != NULL) {
         errorCode = U_ERROR_COMMON_PLATFORM;
         // Actually create the mutex
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        *pMutexHandle = NULL;
+        int32_t slot = staticSlotTake(gStaticMutexInUse, U_PORT_OS_STATIC_NUM_MUTEXES,
+                                      U_PORT_OS_STATIC_NUM_MUTEXES, 0, 0, 0);
+        if (slot < 0) {
+            errorCode = U_ERROR_COMMON_NO_MEMORY;
+        } else {
+            *pMutexHandle = (uPortMutexHandle_t) xSemaphoreCreateMutexStatic(&(gStaticMutex[slot]));
+            if (*pMutexHandle == NULL) {
+                gStaticMutexInUse[slot] = false;
+            }
+        }
+#else
         *pMutexHandle = (uPortMutexHandle_t) xSemaphoreCreateMutex();
+#endif
         if (*pMutexHandle != NULL) {
             errorCode = U_ERROR_COMMON_SUCCESS;
             U_ATOMIC_INCREMENT(&gResourceAllocCount);
@@ -404,6 +681,14 @@ int32_t MTX_FN(uPortMutexDelete(const uPortMutexHandle_t mutexHandle))
 
     if (mutexHandle != NULL) {
         vSemaphoreDelete((SemaphoreHandle_t) mutexHandle);
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        int32_t slot = staticSlotFind(mutexHandle, gStaticMutex,
+                                      U_PORT_OS_STATIC_NUM_MUTEXES,
+                                      sizeof(gStaticMutex[0]));
+        if (slot >= 0) {
+            gStaticMutexInUse[slot] = false;
+        }
+#endif
         errorCode = U_ERROR_COMMON_SUCCESS;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_MUTEX_DELETE(mutexHandle);
@@ -471,7 +756,23 @@ int32_t uPortSemaphoreCreate(uPortSemaphoreHandle_t *pSemaphoreHandle,
     if ((pSemaphoreHandle != NULL) && (limit != 0) && (initialCount <= limit)) {
         errorCode = U_ERROR_COMMON_PLATFORM;
         // Actually create the semaphore
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        *pSemaphoreHandle = NULL;
+        int32_t slot = staticSlotTake(gStaticSemaphoreInUse, U_PORT_OS_STATIC_NUM_SEMAPHORES,
+                                      U_PORT_OS_STATIC_NUM_SEMAPHORES, 0, 0, 0);
+        if (slot < 0) {
+            errorCode = U_ERROR_COMMON_NO_MEMORY;
+        } else {
+            *pSemaphoreHandle = (uPortSemaphoreHandle_t) xSemaphoreCreateCountingStatic(limit,
+                                                                                        initialCount,
+                                                                                        &(gStaticSemaphore[slot]));
+            if (*pSemaphoreHandle == NULL) {
+                gStaticSemaphoreInUse[slot] = false;
+            }
+        }
+#else
         *pSemaphoreHandle = (uPortSemaphoreHandle_t) xSemaphoreCreateCounting(limit, initialCount);
+#endif
         if (*pSemaphoreHandle != NULL) {
             errorCode = U_ERROR_COMMON_SUCCESS;
             U_ATOMIC_INCREMENT(&gResourceAllocCount);
@@ -489,6 +790,14 @@ int32_t uPortSemaphoreDelete(const uPortSemaphoreHandle_t semaphoreHandle)
 
     if (semaphoreHandle != NULL) {
         vSemaphoreDelete((SemaphoreHandle_t) semaphoreHandle);
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        int32_t slot = staticSlotFind(semaphoreHandle, gStaticSemaphore,
+                                      U_PORT_OS_STATIC_NUM_SEMAPHORES,
+                                      sizeof(gStaticSemaphore[0]));
+        if (slot >= 0) {
+            gStaticSemaphoreInUse[slot] = false;
+        }
+#endif
         errorCode = U_ERROR_COMMON_SUCCESS;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_SEMAPHORE_DELETE(semaphoreHandle);
@@ -667,6 +976,45 @@ void vApplicationMallocFailedHook( void )
     U_ASSERT(false);
 }
 
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+
+// Called through portCLEAN_UP_TCB(), see FreeRTOSConfig.h, when
+// FreeRTOS has finished with a deleted task: only now may the
+// task's slot be re-used.
+void uPortOsStaticTaskCleanUp(void *pTcb)
+{
+    int32_t slot = staticSlotFind(pTcb, gStaticTask,
+                                  U_PORT_OS_STATIC_NUM_TASKS,
+                                  sizeof(gStaticTask[0]));
+    if (slot >= 0) {
+        gStaticTaskInUse[slot] = false;
+    }
+}
+
+// Provide the memory for the idle task, required by FreeRTOS when
+// configSUPPORT_STATIC_ALLOCATION is set to 1 in FreeRTOSConfig.h.
+void vApplicationGetIdleTaskMemory(StaticTask_t **ppIdleTaskTcb,
+                                   StackType_t **ppIdleTaskStack,
+                                   uint32_t *pIdleTaskStackSize)
+{
+    *ppIdleTaskTcb = &gIdleTask;
+    *ppIdleTaskStack = gIdleStack;
+    *pIdleTaskStackSize = sizeof(gIdleStack) / sizeof(gIdleStack[0]);
+}
+
+// Provide the memory for the timer task, required by FreeRTOS when
+// configSUPPORT_STATIC_ALLOCATION is set to 1 in FreeRTOSConfig.h.
+void vApplicationGetTimerTaskMemory(StaticTask_t **ppTimerTaskTcb,
+                                    StackType_t **ppTimerTaskStack,
+                                    uint32_t *pTimerTaskStackSize)
+{
+    *ppTimerTaskTcb = &gTimerTask;
+    *ppTimerTaskStack = gTimerStack;
+    *pTimerTaskStackSize = sizeof(gTimerStack) / sizeof(gTimerStack[0]);
+}
+
+#endif
+
 /* ----------------------------------------------------------------
  * FUNCTIONS: DEBUGGING/MONITORING
  * -------------------------------------------------------------- */
@@ -123,6 +123,10 @@ void uPortPrivateDeinit();
  */
 int64_t uPortPrivateGetTickTimeMs();
 
+/** Get the current OS tick converted to a time in microseconds.
+ */
+int64_t uPortPrivateGetTickTimeUs();
+
 /** Register a callback to be called when tick timer
  * overflow interrupt occurs.
  *
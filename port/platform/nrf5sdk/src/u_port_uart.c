@@ -126,6 +126,7 @@ typedef struct {
     int32_t uartHandle;
     int32_t eventQueueHandle;
     uint32_t eventFilter;
+    volatile bool eventPending; /**< a data received event is queued but not yet handled. */
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
     size_t rxBufferSizeBytes;
@@ -138,10 +139,13 @@ typedef struct {
     uint32_t bufferWrite;
     uint32_t txBuffLen;
     uint32_t txWritten;
+    bool txBuffLast; /**< txSem is given once pTxBuff has been sent. */
     bool bufferFull;
     bool disableTxIrq;
     uPortSemaphoreHandle_t txSem;
     uPortQueueHandle_t txQueueHandle;
+    uPortUartStats_t stats; /**< Written in the interrupt as well as by tasks. */
+    int32_t bufferFullStartMs;
 } uPortUartData_t;
 
 /** Structure describing an event.
@@ -155,6 +159,7 @@ typedef struct {
     int32_t handle;
     uint8_t *pData;
     uint32_t len;
+    bool last; /**< the last of the buffers the writer is waiting for. */
 } uartTxData_t;
 
 /* ----------------------------------------------------------------
@@ -234,6 +239,9 @@ static void eventHandler(void *pParam, size_t paramLength)
 
     if ((pEvent->uartHandle >= 0) &&
         (pEvent->uartHandle < sizeof(gUartData) / sizeof(gUartData[0]))) {
+        // Clear this before calling the callback so that data
+        // arriving while the callback is running raises a new event
+        gUartData[pEvent->uartHandle].eventPending = false;
         if (gUartData[pEvent->uartHandle].pEventCallback != NULL) {
             gUartData[pEvent->uartHandle].pEventCallback(pEvent->uartHandle,
                                                          pEvent->eventBitMap,
@@ -308,16 +316,23 @@ static void uartClose(int32_t handle)
         }
     }
 }
+// Let the user know that data has been received, unless an event
+// is already waiting to be handled: the callback will read
+// everything there is anyway.
 static void userNotify(uPortUartData_t *pUartData)
 {
 
     if ((pUartData->eventQueueHandle >= 0) &&
-        (pUartData->eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
+        (pUartData->eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED) &&
+        !pUartData->eventPending) {
         uPortUartEvent_t event;
+        pUartData->eventPending = true;
         event.uartHandle = pUartData->uartHandle;
         event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
-        uPortEventQueueSendIrq(pUartData->eventQueueHandle,
-                               &event, sizeof(event));
+        if (uPortEventQueueSendIrq(pUartData->eventQueueHandle,
+                                   &event, sizeof(event)) != 0) {
+            pUartData->eventPending = false;
+        }
     }
 }
 
@@ -368,6 +383,7 @@ static void uartIrqHandler(uPortUartData_t *pUartData)
 {
     NRF_UARTE_Type *pReg = pUartData->pReg;
     bool read = false;
+    uint32_t errorSrc;
 
     if (nrf_uarte_int_enable_check(pReg, NRF_UARTE_INT_ENDTX_MASK) &&
         nrf_uarte_event_check(pReg, NRF_UARTE_EVENT_ENDTX)) {
@@ -386,6 +402,16 @@ static void uartIrqHandler(uPortUartData_t *pUartData)
 
     if (nrf_uarte_event_check(pReg, NRF_UARTE_EVENT_ERROR)) {
         nrf_uarte_event_clear(pReg, NRF_UARTE_EVENT_ERROR);
+        errorSrc = nrf_uarte_errorsrc_get_and_clear(pReg);
+        if (errorSrc & NRF_UARTE_ERROR_OVERRUN_MASK) {
+            pUartData->stats.overrunCount++;
+        }
+        if (errorSrc & NRF_UARTE_ERROR_FRAMING_MASK) {
+            pUartData->stats.framingErrorCount++;
+        }
+        if (errorSrc & NRF_UARTE_ERROR_PARITY_MASK) {
+            pUartData->stats.parityErrorCount++;
+        }
     }
 
     // Handle Rx
@@ -397,11 +423,14 @@ static void uartIrqHandler(uPortUartData_t *pUartData)
 
                 pUartData->bufferWrite++;
                 pUartData->bufferWrite %= pUartData->rxBufferSizeBytes;
+                pUartData->stats.bytesReceived++;
                 read = true;
                 // Stop Rx interrupt when there is no more space
                 // Rx interrupts will be renabled in the uPortUartRead
                 if (pUartData->bufferWrite == pUartData->bufferRead) {
                     pUartData->bufferFull = true;
+                    pUartData->stats.bufferFullCount++;
+                    pUartData->bufferFullStartMs = uPortGetTickTimeMs();
                     nrf_uarte_int_disable(pReg, NRF_UARTE_INT_ENDRX_MASK);
                     break;
                 }
@@ -424,6 +453,7 @@ static void uartIrqHandler(uPortUartData_t *pUartData)
             if (uPortQueueReceiveIrq(pUartData->txQueueHandle, (void *)&txData) == U_ERROR_COMMON_SUCCESS) {
                 pUartData->pTxBuff = txData.pData;
                 pUartData->txBuffLen = txData.len;
+                pUartData->txBuffLast = txData.last;
             }
         }
 
@@ -440,7 +470,9 @@ static void uartIrqHandler(uPortUartData_t *pUartData)
             pUartData->pTxBuff = NULL;
             pUartData->txBuffLen = 0;
             pUartData->txWritten = 0;
-            uPortSemaphoreGiveIrq(pUartData->txSem);
+            if (pUartData->txBuffLast) {
+                uPortSemaphoreGiveIrq(pUartData->txSem);
+            }
         }
     }
 }
@@ -621,11 +653,13 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                 gUartData[uart].hwfcSuspended = false;
                 gUartData[uart].eventQueueHandle = -1;
                 gUartData[uart].eventFilter = 0;
+                gUartData[uart].eventPending = false;
                 gUartData[uart].pEventCallback = NULL;
                 gUartData[uart].pEventCallbackParam = NULL;
                 gUartData[uart].bufferRead = 0;
                 gUartData[uart].bufferWrite = 0;
                 gUartData[uart].bufferFull = false;
+                memset(&gUartData[uart].stats, 0, sizeof(gUartData[uart].stats));
                 uPortSemaphoreCreate(&gUartData[uart].txSem, 0, 1);
                 nrf_uarte_disable(pReg);
                 // Set baud rate
@@ -762,6 +796,10 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
 
                 // Reset buffer full condition and renable
                 // Rx interrupts
+                if (gUartData[handle].bufferFull) {
+                    gUartData[handle].stats.bufferFullTimeMs += uPortGetTickTimeMs() -
+                                                                gUartData[handle].bufferFullStartMs;
+                }
                 gUartData[handle].bufferFull = false;
                 nrf_uarte_int_enable(pReg, NRF_UARTE_INT_ENDRX_MASK);
             }
@@ -773,6 +811,22 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     return (int32_t) sizeOrErrorCode;
 }
 
+// Get a pointer to the received data: not supported.
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    (void) handle;
+    (void) ppData;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// Remove data obtained with uPortUartReadSpan(): not supported.
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    (void) handle;
+    (void) sizeBytes;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 // Write to the given UART interface.
 int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
                        size_t sizeBytes)
@@ -795,11 +849,13 @@ int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
             txData.handle = handle;
             txData.pData = (void *)pBuffer;
             txData.len = sizeBytes;
+            txData.last = true;
             // enqueue the buffer here and retrieve it when
             // the TXSTOPPED interrupt is triggered.
             uPortQueueSend(txQueueHandle, (void *)&txData);
             nrf_uarte_int_enable(pReg, NRF_UARTE_INT_TXSTOPPED_MASK);
             uPortSemaphoreTake(gUartData[handle].txSem);
+            gUartData[handle].stats.bytesSent += sizeBytes;
             U_PORT_MUTEX_UNLOCK(gMutex);
             sizeOrErrorCode = sizeBytes;
         }
@@ -809,6 +865,63 @@ int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
     return (int32_t) sizeOrErrorCode;
 }
 
+// Write several buffers to the given UART interface.
+int32_t uPortUartWriteVec(int32_t handle, const uPortUartIoVec_t *pVec,
+                          size_t count)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    NRF_UARTE_Type *pReg;
+    uartTxData_t txData;
+    uPortQueueHandle_t txQueueHandle;
+    size_t numQueued = 0;
+    size_t lastIndex = 0;
+
+    if (gMutex != NULL) {
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if (((pVec != NULL) || (count == 0)) && (handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0]))) {
+
+            U_PORT_MUTEX_LOCK(gMutex);
+            pReg = gUartData[handle].pReg;
+            txQueueHandle = gUartData[handle].txQueueHandle;
+
+            // Chain the buffers through the Tx queue, from which the
+            // TXSTOPPED interrupt moves on to the next without this
+            // task being involved, up to a queue-full at a time; only
+            // the last of each batch wakes this task
+            sizeOrErrorCode = 0;
+            for (size_t x = 0; x < count; x++) {
+                if (pVec[x].sizeBytes > 0) {
+                    lastIndex = x;
+                }
+            }
+            for (size_t x = 0; x < count; x++) {
+                if (pVec[x].sizeBytes > 0) {
+                    txData.handle = handle;
+                    txData.pData = (void *) pVec[x].pBuffer;
+                    txData.len = pVec[x].sizeBytes;
+                    sizeOrErrorCode += (int32_t) pVec[x].sizeBytes;
+                    numQueued++;
+                    txData.last = (numQueued == U_PORT_UART_TX_QUEUE_LENGTH) ||
+                                  (x == lastIndex);
+                    uPortQueueSend(txQueueHandle, (void *) &txData);
+                    if (txData.last) {
+                        nrf_uarte_int_enable(pReg, NRF_UARTE_INT_TXSTOPPED_MASK);
+                        uPortSemaphoreTake(gUartData[handle].txSem);
+                        numQueued = 0;
+                    }
+                }
+            }
+            gUartData[handle].stats.bytesSent += (uint32_t) sizeOrErrorCode;
+            U_PORT_MUTEX_UNLOCK(gMutex);
+        }
+
+    }
+
+    return sizeOrErrorCode;
+}
+
 // Set an event callback.
 int32_t uPortUartEventCallbackSet(int32_t handle,
                                   uint32_t filter,
@@ -841,6 +954,7 @@ int32_t uPortUartEventCallbackSet(int32_t handle,
                                             priority,
                                             U_PORT_UART_EVENT_QUEUE_SIZE);
             if (errorCode >= 0) {
+                gUartData[handle].eventPending = false;
                 gUartData[handle].eventQueueHandle = (int32_t) errorCode;
                 gUartData[handle].pEventCallback = pFunction;
                 gUartData[handle].pEventCallbackParam = pParam;
@@ -1140,6 +1254,66 @@ void uPortUartCtsResume(int32_t handle)
     }
 }
 
+// Get the statistics of a UART.
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    NRF_UARTE_Type *pReg;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pStats != NULL) && (handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].pRxBuff != NULL)) {
+            pReg = gUartData[handle].pReg;
+            // Keep the interrupt out while copying
+            NRFX_IRQ_DISABLE(getIrqNumber((void *) pReg));
+            *pStats = gUartData[handle].stats;
+            if (gUartData[handle].bufferFull) {
+                pStats->bufferFullTimeMs += uPortGetTickTimeMs() -
+                                            gUartData[handle].bufferFullStartMs;
+            }
+            NRFX_IRQ_ENABLE(getIrqNumber((void *) pReg));
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return (int32_t) errorCode;
+}
+
+// Reset the statistics of a UART.
+int32_t uPortUartStatsReset(int32_t handle)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    NRF_UARTE_Type *pReg;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].pRxBuff != NULL)) {
+            pReg = gUartData[handle].pReg;
+            NRFX_IRQ_DISABLE(getIrqNumber((void *) pReg));
+            memset(&gUartData[handle].stats, 0, sizeof(gUartData[handle].stats));
+            gUartData[handle].bufferFullStartMs = uPortGetTickTimeMs();
+            NRFX_IRQ_ENABLE(getIrqNumber((void *) pReg));
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return (int32_t) errorCode;
+}
+
 // Get the number of UART interfaces currently open.
 int32_t uPortUartResourceAllocCount()
 {
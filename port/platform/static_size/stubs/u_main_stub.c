@@ -22,10 +22,191 @@
 # include "u_cfg_override.h" // For a customer's configuration override
 #endif
 
+#ifdef U_STATIC_SIZE_MINIMAL
+
+/* When building the "minimal" profile (see the minimal_size target
+ * of the Makefile) the image is linked with --gc-sections, so only
+ * what is reachable from main() is kept; main() below references
+ * the entry points of each feature selected with
+ * -DU_STATIC_SIZE_FEATURE_XXX, hence the size of the image is the
+ * size of just that feature set.
+ */
+
+# include "stddef.h"    // NULL, size_t etc.
+# include "stdint.h"    // int32_t etc.
+# include "stdbool.h"
+
+# include "u_error_common.h"
+
+# include "u_device.h"
+# include "u_network.h"
+
+# if defined(U_STATIC_SIZE_FEATURE_CELL) || defined(U_STATIC_SIZE_FEATURE_CELL_MUX) || \
+     defined(U_STATIC_SIZE_FEATURE_CELL_LOC)
+#  include "u_at_client.h"
+#  include "u_cell_module_type.h"
+#  include "u_cell.h"
+#  include "u_cell_net.h"
+#  include "u_cell_pwr.h"
+#  include "u_cell_mux.h"
+#  include "u_cell_loc.h"
+# endif
+
+# if defined(U_STATIC_SIZE_FEATURE_GNSS) || defined(U_STATIC_SIZE_FEATURE_GNSS_DEC) || \
+     defined(U_STATIC_SIZE_FEATURE_GNSS_MGA)
+#  include "u_gnss_module_type.h"
+#  include "u_gnss_type.h"
+#  include "u_gnss.h"
+#  include "u_gnss_pwr.h"
+#  include "u_gnss_pos.h"
+#  include "u_gnss_dec.h"
+#  include "u_gnss_mga.h"
+# endif
+
+# if defined(U_STATIC_SIZE_FEATURE_SOCK) || defined(U_STATIC_SIZE_FEATURE_MQTT_CLIENT) || \
+     defined(U_STATIC_SIZE_FEATURE_HTTP_CLIENT)
+#  include "u_sock.h"
+# endif
+
+# if defined(U_STATIC_SIZE_FEATURE_SECURITY) || defined(U_STATIC_SIZE_FEATURE_MQTT_CLIENT) || \
+     defined(U_STATIC_SIZE_FEATURE_HTTP_CLIENT)
+#  include "u_security_tls.h"
+# endif
+
+# ifdef U_STATIC_SIZE_FEATURE_MQTT_CLIENT
+#  include "u_mqtt_common.h"
+#  include "u_mqtt_client.h"
+# endif
+
+# ifdef U_STATIC_SIZE_FEATURE_HTTP_CLIENT
+#  include "u_http_client.h"
+# endif
+
+# ifdef U_STATIC_SIZE_FEATURE_LOCATION
+#  include "u_location.h"
+# endif
+
+# ifdef U_STATIC_SIZE_FEATURE_BLE
+#  include "u_ble.h"
+#  include "u_ble_gap.h"
+#  include "u_ble_sps.h"
+# endif
+
+# ifdef U_STATIC_SIZE_FEATURE_WIFI
+#  include "u_wifi.h"
+# endif
+
+/** Entry points, the signatures don't matter as they are never called.
+ */
+typedef void (*uStaticSizeFunction_t)(void);
+
+/** The entry points of the selected features; volatile so that the
+ * compiler cannot work out that they are never called.
+ */
+static volatile uStaticSizeFunction_t gFunction[] = {
+    (uStaticSizeFunction_t) uDeviceInit,
+    (uStaticSizeFunction_t) uDeviceOpen,
+    (uStaticSizeFunction_t) uDeviceClose,
+    (uStaticSizeFunction_t) uNetworkInterfaceUp,
+    (uStaticSizeFunction_t) uNetworkInterfaceDown,
+# ifdef U_STATIC_SIZE_FEATURE_CELL
+    (uStaticSizeFunction_t) uCellInit,
+    (uStaticSizeFunction_t) uCellAdd,
+    (uStaticSizeFunction_t) uCellPwrOn,
+    (uStaticSizeFunction_t) uCellNetConnect,
+    (uStaticSizeFunction_t) uCellNetDisconnect,
+    (uStaticSizeFunction_t) uCellPwrOff,
+    (uStaticSizeFunction_t) uCellRemove,
+    (uStaticSizeFunction_t) uCellDeinit,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_CELL_MUX
+    (uStaticSizeFunction_t) uCellMuxEnable,
+    (uStaticSizeFunction_t) uCellMuxAddChannel,
+    (uStaticSizeFunction_t) uCellMuxDisable,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_CELL_LOC
+    (uStaticSizeFunction_t) uCellLocGet,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_GNSS
+    (uStaticSizeFunction_t) uGnssInit,
+    (uStaticSizeFunction_t) uGnssAdd,
+    (uStaticSizeFunction_t) uGnssPwrOn,
+    (uStaticSizeFunction_t) uGnssPosGet,
+    (uStaticSizeFunction_t) uGnssPwrOff,
+    (uStaticSizeFunction_t) uGnssRemove,
+    (uStaticSizeFunction_t) uGnssDeinit,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_GNSS_DEC
+    (uStaticSizeFunction_t) pUGnssDecAlloc,
+    (uStaticSizeFunction_t) uGnssDecFree,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_GNSS_MGA
+    (uStaticSizeFunction_t) uGnssMgaOnlineRequestEncode,
+    (uStaticSizeFunction_t) uGnssMgaResponseSend,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_SOCK
+    (uStaticSizeFunction_t) uSockGetHostByName,
+    (uStaticSizeFunction_t) uSockCreate,
+    (uStaticSizeFunction_t) uSockConnect,
+    (uStaticSizeFunction_t) uSockWrite,
+    (uStaticSizeFunction_t) uSockRead,
+    (uStaticSizeFunction_t) uSockClose,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_SECURITY
+    (uStaticSizeFunction_t) pUSecurityTlsAdd,
+    (uStaticSizeFunction_t) uSecurityTlsRemove,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_MQTT_CLIENT
+    (uStaticSizeFunction_t) pUMqttClientOpen,
+    (uStaticSizeFunction_t) uMqttClientConnect,
+    (uStaticSizeFunction_t) uMqttClientPublish,
+    (uStaticSizeFunction_t) uMqttClientSubscribe,
+    (uStaticSizeFunction_t) uMqttClientClose,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_HTTP_CLIENT
+    (uStaticSizeFunction_t) pUHttpClientOpen,
+    (uStaticSizeFunction_t) uHttpClientGetRequest,
+    (uStaticSizeFunction_t) uHttpClientClose,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_LOCATION
+    (uStaticSizeFunction_t) uLocationGet,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_BLE
+    (uStaticSizeFunction_t) uBleInit,
+    (uStaticSizeFunction_t) uBleGapAdvertiseStart,
+    (uStaticSizeFunction_t) uBleSpsConnectSps,
+    (uStaticSizeFunction_t) uBleSpsSend,
+    (uStaticSizeFunction_t) uBleDeinit,
+# endif
+# ifdef U_STATIC_SIZE_FEATURE_WIFI
+    (uStaticSizeFunction_t) uWifiInit,
+    (uStaticSizeFunction_t) uWifiStationConnect,
+    (uStaticSizeFunction_t) uWifiDeinit,
+# endif
+};
+
+// Entry point
+int main(void)
+{
+    // Only reached if someone runs the image: the functions
+    // are never actually called, they merely have to look callable
+    for (size_t x = 0; x < sizeof(gFunction) / sizeof(gFunction[0]); x++) {
+        if (gFunction[x] == NULL) {
+            return (int) x;
+        }
+    }
+
+    return 0;
+}
+
+#else
+
 // Entry point
 int main(void)
 {
     return 0;
 }
 
+#endif // #ifdef U_STATIC_SIZE_MINIMAL
+
 // End of file
@@ -58,6 +58,10 @@ int32_t uPortGetTickTimeMs()
 {
     return 0;
 }
+int64_t uPortGetTickTimeUs()
+{
+    return 0;
+}
 int32_t uPortGetHeapMinFree()
 {
     return 0;
@@ -356,6 +360,18 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     (void) sizeBytes;
     return 0;
 }
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    (void) handle;
+    (void) ppData;
+    return 0;
+}
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    (void) handle;
+    (void) sizeBytes;
+    return 0;
+}
 int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
                        size_t sizeBytes)
 {
@@ -0,0 +1,170 @@
+#!/usr/bin/env python
+
+'''Split the flash/RAM of a static_size build by ubxlib feature, using the linker map file.'''
+
+import sys
+import re
+import argparse
+
+# The features, in order of precedence: the first entry whose
+# path fragment is in the path of an object file wins, so the more
+# specific entries must come before the less specific ones; archive
+# members, from the C library, are checked first since the path of
+# the toolchain could contain anything
+FEATURES = [["c_library", [".a("]],
+            ["cell_mux", ["cell/src/u_cell_mux"]],
+            ["cell_loc", ["cell/src/u_cell_loc"]],
+            ["cell_mqtt", ["cell/src/u_cell_mqtt"]],
+            ["cell_http", ["cell/src/u_cell_http"]],
+            ["cell_sock", ["cell/src/u_cell_sock", "cell/src/u_cell_sec"]],
+            ["cell", ["cell/"]],
+            ["gnss_dec", ["gnss/src/u_gnss_dec"]],
+            ["gnss_mga", ["gnss/src/u_gnss_mga", "gnss/src/lib_mga/"]],
+            ["gnss", ["gnss/"]],
+            ["ble", ["ble/"]],
+            ["wifi", ["wifi/"]],
+            ["short_range", ["common/short_range/"]],
+            ["at_client", ["common/at_client/"]],
+            ["sock", ["common/sock/"]],
+            ["security", ["common/security/"]],
+            ["mqtt_client", ["common/mqtt_client/"]],
+            ["http_client", ["common/http_client/"]],
+            ["location", ["common/location/"]],
+            ["ubx_protocol", ["common/ubx_protocol/"]],
+            ["spartn", ["common/spartn/"]],
+            ["dns", ["common/dns/"]],
+            ["device", ["common/device/"]],
+            ["network", ["common/network/"]],
+            ["utils", ["common/utils/", "common/error/", "common/assert/"]],
+            ["port", ["port/", "stubs/"]]]
+
+# The catch-all feature
+FEATURE_OTHER = "other"
+
+# The input section name prefixes that occupy flash
+SECTIONS_FLASH = [".text", ".rodata", ".ARM.extab", ".ARM.exidx", ".init", ".fini"]
+
+# The input section name prefixes that occupy flash and RAM
+SECTIONS_FLASH_AND_RAM = [".data"]
+
+# The input section name prefixes that occupy RAM only
+SECTIONS_RAM = [".bss", "COMMON"]
+
+# The line of a map file after which the memory map begins; what
+# comes before is the archive member list, the discarded input
+# sections (when linked with --gc-sections) and the memory regions
+MEMORY_MAP_START = "Linker script and memory map"
+
+# An input section with its address, size and object on one line, e.g.
+#  .text          0x00008130       0x88 output/no_float/obj/cell/src/u_cell.o
+RE_SECTION_ONE_LINE = re.compile(r"^ (\.\S+|COMMON)\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+# An input section name too long to share a line with its address, e.g.
+#  .text.uCellInit
+RE_SECTION_NAME = re.compile(r"^ (\.\S+|COMMON)\s*$")
+
+# The line following RE_SECTION_NAME, e.g.
+#                 0x00008130       0x88 output/no_float/obj/cell/src/u_cell.o
+RE_SECTION_REST = re.compile(r"^\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+
+def feature_get(path):
+    '''Return the feature that an object file belongs to'''
+    path = path.replace("\\", "/")
+    for feature in FEATURES:
+        for fragment in feature[1]:
+            if fragment in path:
+                return feature[0]
+    return FEATURE_OTHER
+
+def section_type_get(name):
+    '''Return (flash, ram), as booleans, for an input section'''
+    for prefix in SECTIONS_FLASH_AND_RAM:
+        if name.startswith(prefix):
+            return True, True
+    for prefix in SECTIONS_RAM:
+        if name.startswith(prefix):
+            return False, True
+    for prefix in SECTIONS_FLASH:
+        if name.startswith(prefix):
+            return True, False
+    return False, False
+
+def map_parse(file):
+    '''Parse a GNU ld map file, returning a dictionary of [flash, ram] by feature'''
+    sizes = {}
+    in_map = False
+    pending_name = None
+    for line in file:
+        line = line.rstrip("\r\n")
+        if not in_map:
+            in_map = line.startswith(MEMORY_MAP_START)
+            continue
+        name = None
+        size = 0
+        path = None
+        if pending_name:
+            match = RE_SECTION_REST.match(line)
+            if match:
+                name = pending_name
+                size = int(match.group(1), 16)
+                path = match.group(2)
+            pending_name = None
+        else:
+            match = RE_SECTION_ONE_LINE.match(line)
+            if match:
+                name = match.group(1)
+                size = int(match.group(2), 16)
+                path = match.group(3)
+            else:
+                match = RE_SECTION_NAME.match(line)
+                if match:
+                    pending_name = match.group(1)
+        if name and size > 0:
+            flash, ram = section_type_get(name)
+            if flash or ram:
+                feature = feature_get(path)
+                if feature not in sizes:
+                    sizes[feature] = [0, 0]
+                if flash:
+                    sizes[feature][0] += size
+                if ram:
+                    sizes[feature][1] += size
+    return sizes
+
+def report(sizes, csv):
+    '''Print the sizes, largest flash first'''
+    total_flash = 0
+    total_ram = 0
+    if csv:
+        print("feature,flash,ram")
+    else:
+        print("{:<16} {:>10} {:>10}".format("feature", "flash", "ram"))
+    for feature, size in sorted(sizes.items(), key=lambda item: item[1][0], reverse=True):
+        total_flash += size[0]
+        total_ram += size[1]
+        if csv:
+            print("{},{},{}".format(feature, size[0], size[1]))
+        else:
+            print("{:<16} {:>10} {:>10}".format(feature, size[0], size[1]))
+    if csv:
+        print("total,{},{}".format(total_flash, total_ram))
+    else:
+        print("{:<16} {:>10} {:>10}".format("total", total_flash, total_ram))
+
+if __name__ == "__main__":
+    PARSER = argparse.ArgumentParser(description="Print the static flash and RAM" \
+                                     " occupied by each ubxlib feature, in bytes," \
+                                     " given the map file of a static_size build.")
+    PARSER.add_argument("map_file", help="the map file written by the linker.")
+    PARSER.add_argument("-c", action="store_true", help="print the report as CSV.")
+    ARGS = PARSER.parse_args()
+    try:
+        with open(ARGS.map_file, "r", encoding="utf8", errors="replace") as MAP_FILE:
+            SIZES = map_parse(MAP_FILE)
+    except OSError as ex:
+        print("Unable to read map file {}: {}".format(ARGS.map_file, ex))
+        sys.exit(1)
+    if not SIZES:
+        print("No sections found in map file {}.".format(ARGS.map_file))
+        sys.exit(1)
+    report(SIZES, ARGS.c)
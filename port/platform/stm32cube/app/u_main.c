@@ -147,6 +147,10 @@ static void appTask(void *pParam)
     // called deinit so call init again here.
     uPortInit();
 
+#if defined(U_CFG_MUTEX_DEBUG) && defined(U_MUTEX_DEBUG_PROFILE)
+    uMutexDebugProfilePrint(NULL);
+#endif
+
     // Call Unity hook
     UNITY_END();
 
@@ -271,6 +271,119 @@
  */
 #define U_CFG_HW_UART8_DMA_CHANNEL             5
 
+/** The UART driver also uses DMA to transmit, where a DMA stream
+ * is available for that, so that uPortUartWrite() need not feed
+ * the UART a byte at a time.  The Tx DMA engine is necessarily
+ * the same as the Rx DMA engine of a UART; the fixed mapping of
+ * stream/channel to UART/USART TX, again from table 42 of RM0090,
+ * is represented below.  Setting the Tx DMA stream of a UART to
+ * -1 makes that UART transmit without DMA, which is necessary
+ * where the stream is needed for the Rx of another UART.
+ */
+
+#ifndef U_CFG_HW_UART1_DMA_TX_STREAM
+/** The DMA stream for USART1 Tx: fixed in the STM32F4 chip.
+ */
+# define U_CFG_HW_UART1_DMA_TX_STREAM          7
+#endif
+
+#ifndef U_CFG_HW_UART1_DMA_TX_CHANNEL
+/** The DMA channel for USART1 Tx.
+ */
+# define U_CFG_HW_UART1_DMA_TX_CHANNEL         4
+#endif
+
+#ifndef U_CFG_HW_UART2_DMA_TX_STREAM
+/** The DMA stream for USART2 Tx: note that this is the stream used by
+ * UART8 Rx so, if both are used, set this to -1.
+ */
+# define U_CFG_HW_UART2_DMA_TX_STREAM          6
+#endif
+
+#ifndef U_CFG_HW_UART2_DMA_TX_CHANNEL
+/** The DMA channel for USART2 Tx.
+ */
+# define U_CFG_HW_UART2_DMA_TX_CHANNEL         4
+#endif
+
+#ifndef U_CFG_HW_UART3_DMA_TX_STREAM
+/** The DMA stream for USART3 Tx: can also be set to 4, with
+ * U_CFG_HW_UART3_DMA_TX_CHANNEL set to 7; note that stream 3
+ * is used by UART7 Rx.
+ */
+# define U_CFG_HW_UART3_DMA_TX_STREAM          3
+#endif
+
+#ifndef U_CFG_HW_UART3_DMA_TX_CHANNEL
+/** The DMA channel for USART3 Tx.
+ */
+# define U_CFG_HW_UART3_DMA_TX_CHANNEL         4
+#endif
+
+#ifndef U_CFG_HW_UART4_DMA_TX_STREAM
+/** The DMA stream for UART4 Tx: note that this is the stream used by
+ * USART3 Tx if that is moved to stream 4.
+ */
+# define U_CFG_HW_UART4_DMA_TX_STREAM          4
+#endif
+
+#ifndef U_CFG_HW_UART4_DMA_TX_CHANNEL
+/** The DMA channel for UART4 Tx.
+ */
+# define U_CFG_HW_UART4_DMA_TX_CHANNEL         4
+#endif
+
+#ifndef U_CFG_HW_UART5_DMA_TX_STREAM
+/** The DMA stream for UART5 Tx: fixed in the STM32F4 chip.
+ */
+# define U_CFG_HW_UART5_DMA_TX_STREAM          7
+#endif
+
+#ifndef U_CFG_HW_UART5_DMA_TX_CHANNEL
+/** The DMA channel for UART5 Tx.
+ */
+# define U_CFG_HW_UART5_DMA_TX_CHANNEL         4
+#endif
+
+#ifndef U_CFG_HW_UART6_DMA_TX_STREAM
+/** The DMA stream for USART6 Tx: can also be set to 7 (with the same
+ * channel).
+ */
+# define U_CFG_HW_UART6_DMA_TX_STREAM          6
+#endif
+
+#ifndef U_CFG_HW_UART6_DMA_TX_CHANNEL
+/** The DMA channel for USART6 Tx.
+ */
+# define U_CFG_HW_UART6_DMA_TX_CHANNEL         5
+#endif
+
+#ifndef U_CFG_HW_UART7_DMA_TX_STREAM
+/** The DMA stream for UART7 Tx: the only stream that may be used is 1,
+ * which is that used by USART3 Rx, hence not used by default.
+ */
+# define U_CFG_HW_UART7_DMA_TX_STREAM          -1
+#endif
+
+#ifndef U_CFG_HW_UART7_DMA_TX_CHANNEL
+/** The DMA channel for UART7 Tx.
+ */
+# define U_CFG_HW_UART7_DMA_TX_CHANNEL         5
+#endif
+
+#ifndef U_CFG_HW_UART8_DMA_TX_STREAM
+/** The DMA stream for UART8 Tx: the only stream that may be used is 0,
+ * which is that used by UART5 Rx, hence not used by default.
+ */
+# define U_CFG_HW_UART8_DMA_TX_STREAM          -1
+#endif
+
+#ifndef U_CFG_HW_UART8_DMA_TX_CHANNEL
+/** The DMA channel for UART8 Tx.
+ */
+# define U_CFG_HW_UART8_DMA_TX_CHANNEL         5
+#endif
+
 #endif // _U_CFG_HW_PLATFORM_SPECIFIC_H_
 
 // End of file
@@ -16,7 +16,16 @@ PLATFORM_PATH = $(UBXLIB_BASE)/platform/stm32cube/mcu/stm32f4
 UBXLIB_SRC += \
 	$(UBXLIB_BASE)/port/clib/u_port_clib_mktime64.c \
 	$(UBXLIB_BASE)/port/u_port_timezone.c \
+	$(UBXLIB_BASE)/port/u_port_spi_async.c \
+	$(UBXLIB_BASE)/port/u_port_os_block_until.c \
+	$(UBXLIB_BASE)/port/u_port_os_task_info.c \
+	$(UBXLIB_BASE)/port/u_port_log_async.c \
+	$(UBXLIB_BASE)/port/u_port_i2c_async.c \
+	$(UBXLIB_BASE)/port/u_port_gpio_interrupt.c \
+	$(UBXLIB_BASE)/port/u_port_uart_vec.c \
+	$(UBXLIB_BASE)/port/u_port_uart_stats.c \
 	$(UBXLIB_BASE)/port/platform/common/mbedtls/u_port_crypto.c \
+	$(PLATFORM_PATH)/src/u_port_crypto_hw.c \
 	$(PLATFORM_PATH)/src/u_port_debug.c \
 	$(PLATFORM_PATH)/src/u_port_gpio.c \
 	$(PLATFORM_PATH)/src/u_port_os.c \
@@ -33,6 +42,7 @@ UBXLIB_ASM += \
 UBXLIB_INC += \
 	$(UBXLIB_PRIVATE_INC) \
 	$(UBXLIB_BASE)/port/clib \
+	$(UBXLIB_BASE)/port/platform/common/mbedtls \
 	$(PLATFORM_PATH)/src \
 	$(PLATFORM_PATH)
 
@@ -85,6 +85,12 @@ extern "C" {
 #define HAL_FLASH_MODULE_ENABLED
 #define HAL_PWR_MODULE_ENABLED
 #define HAL_CORTEX_MODULE_ENABLED
+#ifdef U_PORT_CRYPTO_HW
+/* The STM32F437 of the u-blox C030 board has HASH and CRYP
+   peripherals, used by u_port_crypto_hw.c */
+#define HAL_CRYP_MODULE_ENABLED
+#define HAL_HASH_MODULE_ENABLED
+#endif
 
 /* ########################## HSE/HSI Values adaptation ##################### */
 /**
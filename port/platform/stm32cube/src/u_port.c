@@ -225,6 +225,18 @@ int32_t uPortGetTickTimeMs()
     return tickTime;
 }
 
+// Get the current time in microseconds.
+int64_t uPortGetTickTimeUs()
+{
+    int64_t tickTime = 0;
+
+    if (gInitialised) {
+        tickTime = uPortPrivateGetTickTimeUs();
+    }
+
+    return tickTime;
+}
+
 // Get the minimum amount of heap free, ever, in bytes.
 int32_t uPortGetHeapMinFree()
 {
@@ -0,0 +1,284 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Hardware crypto backend for the STM32F4 platform, using the
+ * HASH and CRYP peripherals of those parts that have them (e.g. the
+ * STM32F437); only compiled in if U_PORT_CRYPTO_HW is defined, and then
+ * the HASH peripheral is only used if HAL_HASH_MODULE_ENABLED is
+ * defined and the CRYP peripheral only if HAL_CRYP_MODULE_ENABLED is
+ * defined (see stm32f4xx_hal_conf.h).  If a peripheral is already in
+ * use by another task the mbedTLS software implementation is used.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#ifdef U_PORT_CRYPTO_HW
+
+#include "stddef.h"
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"    // memset(), memcpy()
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_crypto.h"
+
+#include "stm32f4xx_hal.h"
+
+#include "u_port_crypto_hw.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#ifndef U_PORT_CRYPTO_HW_TIMEOUT_MS
+/** How long to allow the HASH or CRYP peripheral for an operation.
+ */
+# define U_PORT_CRYPTO_HW_TIMEOUT_MS 1000
+#endif
+
+/** The length of an AES block.
+ */
+#define U_PORT_CRYPTO_HW_AES_BLOCK_LENGTH_BYTES 16
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+#ifdef HAL_HASH_MODULE_ENABLED
+/** True while the HASH peripheral is in use.
+ */
+static bool gHashInUse = false;
+#endif
+
+#ifdef HAL_CRYP_MODULE_ENABLED
+/** True while the CRYP peripheral is in use.
+ */
+static bool gCrypInUse = false;
+#endif
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+#if defined(HAL_HASH_MODULE_ENABLED) || defined(HAL_CRYP_MODULE_ENABLED)
+// Claim a peripheral, returning false if it is already in use.
+static bool claim(bool *pInUse)
+{
+    bool claimed = false;
+
+    if (uPortEnterCritical() == 0) {
+        if (!*pInUse) {
+            *pInUse = true;
+            claimed = true;
+        }
+        uPortExitCritical();
+    }
+
+    return claimed;
+}
+#endif
+
+#ifdef HAL_CRYP_MODULE_ENABLED
+// Load a sequence of bytes into words the way the CRYP
+// peripheral wants its key and initialisation vector:
+// big-endian, first byte most significant.
+static void bytesToWords(const char *pBytes, uint32_t *pWords,
+                         size_t numWords)
+{
+    const uint8_t *pUint8 = (const uint8_t *) pBytes;
+
+    for (size_t x = 0; x < numWords; x++) {
+        *(pWords + x) = (((uint32_t) * (pUint8)) << 24) |
+                        (((uint32_t) * (pUint8 + 1)) << 16) |
+                        (((uint32_t) * (pUint8 + 2)) << 8) |
+                        ((uint32_t) * (pUint8 + 3));
+        pUint8 += 4;
+    }
+}
+#endif
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Perform a SHA256 calculation in hardware.
+int32_t uPortCryptoHwSha256(const char *pInput,
+                            size_t inputLengthBytes,
+                            char *pOutput)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#ifdef HAL_HASH_MODULE_ENABLED
+    HASH_HandleTypeDef hash;
+
+    if (claim(&gHashInUse)) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        __HAL_RCC_HASH_CLK_ENABLE();
+        memset(&hash, 0, sizeof(hash));
+        hash.Init.DataType = HASH_DATATYPE_8B;
+        if (HAL_HASH_Init(&hash) == HAL_OK) {
+            if (HAL_HASHEx_SHA256_Start(&hash, (uint8_t *) pInput,
+                                        (uint32_t) inputLengthBytes,
+                                        (uint8_t *) pOutput,
+                                        U_PORT_CRYPTO_HW_TIMEOUT_MS) == HAL_OK) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+            HAL_HASH_DeInit(&hash);
+        }
+        gHashInUse = false;
+    }
+#else
+    (void) pInput;
+    (void) inputLengthBytes;
+    (void) pOutput;
+#endif
+
+    return errorCode;
+}
+
+// Perform a HMAC SHA256 calculation in hardware.
+int32_t uPortCryptoHwHmacSha256(const char *pKey,
+                                size_t keyLengthBytes,
+                                const char *pInput,
+                                size_t inputLengthBytes,
+                                char *pOutput)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#ifdef HAL_HASH_MODULE_ENABLED
+    HASH_HandleTypeDef hash;
+
+    if ((pKey != NULL) && (keyLengthBytes > 0) &&
+        claim(&gHashInUse)) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        __HAL_RCC_HASH_CLK_ENABLE();
+        memset(&hash, 0, sizeof(hash));
+        hash.Init.DataType = HASH_DATATYPE_8B;
+        hash.Init.KeySize = (uint32_t) keyLengthBytes;
+        hash.Init.pKey = (uint8_t *) pKey;
+        if (HAL_HASH_Init(&hash) == HAL_OK) {
+            if (HAL_HMACEx_SHA256_Start(&hash, (uint8_t *) pInput,
+                                        (uint32_t) inputLengthBytes,
+                                        (uint8_t *) pOutput,
+                                        U_PORT_CRYPTO_HW_TIMEOUT_MS) == HAL_OK) {
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+            HAL_HASH_DeInit(&hash);
+        }
+        gHashInUse = false;
+    }
+#else
+    (void) pKey;
+    (void) keyLengthBytes;
+    (void) pInput;
+    (void) inputLengthBytes;
+    (void) pOutput;
+#endif
+
+    return errorCode;
+}
+
+// Perform AES 128 CBC encryption or decryption in hardware.
+int32_t uPortCryptoHwAes128Cbc(bool encrypt,
+                               const char *pKey,
+                               size_t keyLengthBytes,
+                               char *pInitVector,
+                               const char *pInput,
+                               size_t lengthBytes,
+                               char *pOutput)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#ifdef HAL_CRYP_MODULE_ENABLED
+    CRYP_HandleTypeDef cryp;
+    uint32_t key[4];
+    uint32_t initVector[4];
+    char nextInitVector[U_PORT_CRYPTO_AES128_INITIALISATION_VECTOR_LENGTH_BYTES];
+    HAL_StatusTypeDef status;
+
+    // The peripheral moves whole words so the data must be aligned
+    if ((keyLengthBytes == sizeof(key)) && (lengthBytes > 0) &&
+        ((lengthBytes % U_PORT_CRYPTO_HW_AES_BLOCK_LENGTH_BYTES) == 0) &&
+        ((((uintptr_t) pInput) & 0x03) == 0) &&
+        ((((uintptr_t) pOutput) & 0x03) == 0) &&
+        claim(&gCrypInUse)) {
+        errorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+        bytesToWords(pKey, key, sizeof(key) / sizeof(key[0]));
+        bytesToWords(pInitVector, initVector, sizeof(initVector) / sizeof(initVector[0]));
+        if (!encrypt) {
+            // The next initialisation vector is the last block
+            // of the input, which may be overwritten by the output
+            memcpy(nextInitVector,
+                   pInput + lengthBytes - sizeof(nextInitVector),
+                   sizeof(nextInitVector));
+        }
+        __HAL_RCC_CRYP_CLK_ENABLE();
+        memset(&cryp, 0, sizeof(cryp));
+        cryp.Instance = CRYP;
+        cryp.Init.DataType = CRYP_DATATYPE_8B;
+        cryp.Init.KeySize = CRYP_KEYSIZE_128B;
+        cryp.Init.pKey = key;
+        cryp.Init.pInitVect = initVector;
+        cryp.Init.Algorithm = CRYP_AES_CBC;
+        if (HAL_CRYP_Init(&cryp) == HAL_OK) {
+            // Size is in words
+            if (encrypt) {
+                status = HAL_CRYP_Encrypt(&cryp, (uint32_t *) pInput,
+                                          (uint16_t) (lengthBytes / 4),
+                                          (uint32_t *) pOutput,
+                                          U_PORT_CRYPTO_HW_TIMEOUT_MS);
+                // The next initialisation vector is the last
+                // block of the output
+                memcpy(nextInitVector,
+                       pOutput + lengthBytes - sizeof(nextInitVector),
+                       sizeof(nextInitVector));
+            } else {
+                status = HAL_CRYP_Decrypt(&cryp, (uint32_t *) pInput,
+                                          (uint16_t) (lengthBytes / 4),
+                                          (uint32_t *) pOutput,
+                                          U_PORT_CRYPTO_HW_TIMEOUT_MS);
+            }
+            if (status == HAL_OK) {
+                // Update the initialisation vector as mbedTLS would
+                memcpy(pInitVector, nextInitVector, sizeof(nextInitVector));
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            }
+            HAL_CRYP_DeInit(&cryp);
+        }
+        gCrypInUse = false;
+    }
+#else
+    (void) encrypt;
+    (void) pKey;
+    (void) keyLengthBytes;
+    (void) pInitVector;
+    (void) pInput;
+    (void) lengthBytes;
+    (void) pOutput;
+#endif
+
+    return errorCode;
+}
+
+#endif // #ifdef U_PORT_CRYPTO_HW
+
+// End of file
@@ -424,6 +424,27 @@ int64_t uPortPrivateGetTickTimeMs()
     return gTickTimerRtosCount;
 }
 
+// Get the current tick converted to a time in microseconds: the
+// part below a millisecond comes from SysTick, which counts down
+// from LOAD to zero once per RTOS tick, so this stays in step with
+// uPortPrivateGetTickTimeMs() and doesn't wrap like the DWT cycle
+// counter would.
+int64_t uPortPrivateGetTickTimeUs()
+{
+    int32_t tickTime;
+    uint32_t load;
+    uint32_t value;
+
+    // Try again if a tick went off while SysTick was being read
+    do {
+        tickTime = *((volatile int32_t *) &gTickTimerRtosCount);
+        value = SysTick->VAL;
+    } while (tickTime != *((volatile int32_t *) &gTickTimerRtosCount));
+    load = SysTick->LOAD;
+
+    return (((int64_t) tickTime) * 1000) + ((((uint64_t) (load - value)) * 1000) / (load + 1));
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS SPECIFIC TO THIS PORT: MISC
  * -------------------------------------------------------------- */
@@ -71,6 +71,10 @@ void uPortPrivateDeinit();
  */
 int64_t uPortPrivateGetTickTimeMs();
 
+/** Get the current OS tick converted to a time in microseconds.
+ */
+int64_t uPortPrivateGetTickTimeUs();
+
 /** Return the address of the port register for a given GPIO pin.
  *
  * @param pin the pin number.
@@ -82,15 +82,40 @@
 // The maximum number of DMA streams on an STM32F4.
 #define U_PORT_MAX_NUM_DMA_STREAMS 8
 
+// Determine if the given DMA engine/stream interrupt is in use for Rx
+#define U_PORT_DMA_RX_INTERRUPT_IN_USE(x, y) (((U_CFG_HW_UART1_AVAILABLE != 0) && (U_CFG_HW_UART1_DMA_ENGINE == x) && (U_CFG_HW_UART1_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART2_AVAILABLE != 0) && (U_CFG_HW_UART2_DMA_ENGINE == x) && (U_CFG_HW_UART2_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART3_AVAILABLE != 0) && (U_CFG_HW_UART3_DMA_ENGINE == x) && (U_CFG_HW_UART3_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART4_AVAILABLE != 0) && (U_CFG_HW_UART4_DMA_ENGINE == x) && (U_CFG_HW_UART4_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART5_AVAILABLE != 0) && (U_CFG_HW_UART5_DMA_ENGINE == x) && (U_CFG_HW_UART5_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART6_AVAILABLE != 0) && (U_CFG_HW_UART6_DMA_ENGINE == x) && (U_CFG_HW_UART6_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART7_AVAILABLE != 0) && (U_CFG_HW_UART7_DMA_ENGINE == x) && (U_CFG_HW_UART7_DMA_STREAM == y)) || \
+                                              ((U_CFG_HW_UART8_AVAILABLE != 0) && (U_CFG_HW_UART8_DMA_ENGINE == x) && (U_CFG_HW_UART8_DMA_STREAM == y)))
+
+// Determine if the given DMA engine/stream interrupt is in use for Tx
+#define U_PORT_DMA_TX_INTERRUPT_IN_USE(x, y) (((U_CFG_HW_UART1_AVAILABLE != 0) && (U_CFG_HW_UART1_DMA_ENGINE == x) && (U_CFG_HW_UART1_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART2_AVAILABLE != 0) && (U_CFG_HW_UART2_DMA_ENGINE == x) && (U_CFG_HW_UART2_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART3_AVAILABLE != 0) && (U_CFG_HW_UART3_DMA_ENGINE == x) && (U_CFG_HW_UART3_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART4_AVAILABLE != 0) && (U_CFG_HW_UART4_DMA_ENGINE == x) && (U_CFG_HW_UART4_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART5_AVAILABLE != 0) && (U_CFG_HW_UART5_DMA_ENGINE == x) && (U_CFG_HW_UART5_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART6_AVAILABLE != 0) && (U_CFG_HW_UART6_DMA_ENGINE == x) && (U_CFG_HW_UART6_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART7_AVAILABLE != 0) && (U_CFG_HW_UART7_DMA_ENGINE == x) && (U_CFG_HW_UART7_DMA_TX_STREAM == y)) || \
+                                              ((U_CFG_HW_UART8_AVAILABLE != 0) && (U_CFG_HW_UART8_DMA_ENGINE == x) && (U_CFG_HW_UART8_DMA_TX_STREAM == y)))
+
+// The maximum number of items a DMA stream can transfer in one go.
+#define U_PORT_DMA_MAX_DATA_LENGTH 0xFFFF
+
+#ifdef CCMDATARAM_BASE
+// Determine if the given memory can be reached by DMA: the
+// core-coupled memory, which may hold task stacks, cannot.
+# define U_PORT_DMA_CAN_ACCESS(p) (((uint32_t) (p) - CCMDATARAM_BASE) >= 0x10000)
+#else
+# define U_PORT_DMA_CAN_ACCESS(p) true
+#endif
+
 // Determine if the given DMA engine/stream interrupt is in use
-#define U_PORT_DMA_INTERRUPT_IN_USE(x, y) (((U_CFG_HW_UART1_AVAILABLE != 0) && (U_CFG_HW_UART1_DMA_ENGINE == x) && (U_CFG_HW_UART1_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART2_AVAILABLE != 0) && (U_CFG_HW_UART2_DMA_ENGINE == x) && (U_CFG_HW_UART2_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART3_AVAILABLE != 0) && (U_CFG_HW_UART3_DMA_ENGINE == x) && (U_CFG_HW_UART3_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART4_AVAILABLE != 0) && (U_CFG_HW_UART4_DMA_ENGINE == x) && (U_CFG_HW_UART4_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART5_AVAILABLE != 0) && (U_CFG_HW_UART5_DMA_ENGINE == x) && (U_CFG_HW_UART5_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART6_AVAILABLE != 0) && (U_CFG_HW_UART6_DMA_ENGINE == x) && (U_CFG_HW_UART6_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART7_AVAILABLE != 0) && (U_CFG_HW_UART7_DMA_ENGINE == x) && (U_CFG_HW_UART7_DMA_STREAM == y)) || \
-                                           ((U_CFG_HW_UART8_AVAILABLE != 0) && (U_CFG_HW_UART8_DMA_ENGINE == x) && (U_CFG_HW_UART8_DMA_STREAM == y)))
+#define U_PORT_DMA_INTERRUPT_IN_USE(x, y) (U_PORT_DMA_RX_INTERRUPT_IN_USE(x, y) || \
+                                           U_PORT_DMA_TX_INTERRUPT_IN_USE(x, y))
 
 /* ----------------------------------------------------------------
  * TYPES
@@ -110,6 +135,8 @@ typedef struct {
     uint32_t dmaStream;
     uint32_t dmaChannel;
     IRQn_Type irq;
+    int32_t dmaTxStream;   /**< -1 if Tx does not use DMA, else uses dmaEngine. */
+    uint32_t dmaTxChannel;
 } uPortUartConstData_t;
 
 /** Structure of the data per UART.
@@ -120,6 +147,7 @@ typedef struct uPortUartData_t {
     bool ctsSuspended;
     int32_t eventQueueHandle;
     uint32_t eventFilter;
+    volatile bool eventPending; /**< a data received event is queued but not yet handled. */
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
     const uPortUartConstData_t *pConstData;
@@ -128,6 +156,8 @@ typedef struct uPortUartData_t {
     char *pRxBufferStart;
     char *pRxBufferRead;
     volatile char *pRxBufferWrite;
+    uPortSemaphoreHandle_t txDmaSemaphore; /**< NULL if Tx does not use DMA. */
+    uPortUartStats_t stats; /**< Mostly written in interrupt context. */
     struct uPortUartData_t *pNext;
 } uPortUartData_t;
 
@@ -339,6 +369,18 @@ static const uDmaActiveFunc_t gpLlDmaIsActiveFlagTc[] = {
     LL_DMA_IsActiveFlag_TC7
 };
 
+// Table of functions LL_DMA_IsActiveFlag_TEx(DMA_TypeDef *DMAx) for each stream.
+static const uDmaActiveFunc_t gpLlDmaIsActiveFlagTe[] = {
+    LL_DMA_IsActiveFlag_TE0,
+    LL_DMA_IsActiveFlag_TE1,
+    LL_DMA_IsActiveFlag_TE2,
+    LL_DMA_IsActiveFlag_TE3,
+    LL_DMA_IsActiveFlag_TE4,
+    LL_DMA_IsActiveFlag_TE5,
+    LL_DMA_IsActiveFlag_TE6,
+    LL_DMA_IsActiveFlag_TE7
+};
+
 // Table of the constant data per UART.
 static const uPortUartConstData_t gUartCfg[] = {{}, // This to avoid having to -1 all the time
     {
@@ -346,56 +388,72 @@ static const uPortUartConstData_t gUartCfg[] = {{}, // This to avoid having to -
         U_CFG_HW_UART1_DMA_ENGINE,
         U_CFG_HW_UART1_DMA_STREAM,
         U_CFG_HW_UART1_DMA_CHANNEL,
-        USART1_IRQn
+        USART1_IRQn,
+        U_CFG_HW_UART1_DMA_TX_STREAM,
+        U_CFG_HW_UART1_DMA_TX_CHANNEL
     },
     {
         USART2,
         U_CFG_HW_UART2_DMA_ENGINE,
         U_CFG_HW_UART2_DMA_STREAM,
         U_CFG_HW_UART2_DMA_CHANNEL,
-        USART2_IRQn
+        USART2_IRQn,
+        U_CFG_HW_UART2_DMA_TX_STREAM,
+        U_CFG_HW_UART2_DMA_TX_CHANNEL
     },
     {
         USART3,
         U_CFG_HW_UART3_DMA_ENGINE,
         U_CFG_HW_UART3_DMA_STREAM,
         U_CFG_HW_UART3_DMA_CHANNEL,
-        USART3_IRQn
+        USART3_IRQn,
+        U_CFG_HW_UART3_DMA_TX_STREAM,
+        U_CFG_HW_UART3_DMA_TX_CHANNEL
     },
     {
         UART4,
         U_CFG_HW_UART4_DMA_ENGINE,
         U_CFG_HW_UART4_DMA_STREAM,
         U_CFG_HW_UART4_DMA_CHANNEL,
-        UART4_IRQn
+        UART4_IRQn,
+        U_CFG_HW_UART4_DMA_TX_STREAM,
+        U_CFG_HW_UART4_DMA_TX_CHANNEL
     },
     {
         UART5,
         U_CFG_HW_UART5_DMA_ENGINE,
         U_CFG_HW_UART5_DMA_STREAM,
         U_CFG_HW_UART5_DMA_CHANNEL,
-        UART5_IRQn
+        UART5_IRQn,
+        U_CFG_HW_UART5_DMA_TX_STREAM,
+        U_CFG_HW_UART5_DMA_TX_CHANNEL
     },
     {
         USART6,
         U_CFG_HW_UART6_DMA_ENGINE,
         U_CFG_HW_UART6_DMA_STREAM,
         U_CFG_HW_UART6_DMA_CHANNEL,
-        USART6_IRQn
+        USART6_IRQn,
+        U_CFG_HW_UART6_DMA_TX_STREAM,
+        U_CFG_HW_UART6_DMA_TX_CHANNEL
     },
     {
         UART7,
         U_CFG_HW_UART7_DMA_ENGINE,
         U_CFG_HW_UART7_DMA_STREAM,
         U_CFG_HW_UART7_DMA_CHANNEL,
-        UART7_IRQn
+        UART7_IRQn,
+        U_CFG_HW_UART7_DMA_TX_STREAM,
+        U_CFG_HW_UART7_DMA_TX_CHANNEL
     },
     {
         UART8,
         U_CFG_HW_UART8_DMA_ENGINE,
         U_CFG_HW_UART8_DMA_STREAM,
         U_CFG_HW_UART8_DMA_CHANNEL,
-        UART8_IRQn
+        UART8_IRQn,
+        U_CFG_HW_UART8_DMA_TX_STREAM,
+        U_CFG_HW_UART8_DMA_TX_CHANNEL
     }
 };
 
@@ -407,6 +465,10 @@ static uPortUartData_t *gpUart[U_PORT_MAX_NUM_UARTS + 1] = {NULL};
 // get to the UART data.  +1 is for the usual reason.
 static uPortUartData_t *gpDmaUart[U_PORT_MAX_NUM_DMA_ENGINES + 1][U_PORT_MAX_NUM_DMA_STREAMS] = {NULL};
 
+// Table to make it possible for a Tx DMA interrupt to
+// get to the UART data.  +1 is for the usual reason.
+static uPortUartData_t *gpDmaTxUart[U_PORT_MAX_NUM_DMA_ENGINES + 1][U_PORT_MAX_NUM_DMA_STREAMS] = {NULL};
+
 /** Variable to keep track of the number of UARTs open.
  */
 static volatile int32_t gResourceAllocCount = 0;
@@ -453,6 +515,9 @@ static uPortUartData_t *pAddUart(uPortUartData_t *pUartData)
         // And set the other table up so that the
         // DMA interrupt can find the UART data as well
         gpDmaUart[pUartData->pConstData->dmaEngine][pUartData->pConstData->dmaStream] = *ppUartData;
+        if (pUartData->txDmaSemaphore != NULL) {
+            gpDmaTxUart[pUartData->pConstData->dmaEngine][pUartData->pConstData->dmaTxStream] = *ppUartData;
+        }
     }
 
     return *ppUartData;
@@ -523,6 +588,9 @@ static bool removeUart(uPortUartData_t *pUartData)
         // NULL the entries in the two tables
         gpUart[pList->uart] = NULL;
         gpDmaUart[pList->pConstData->dmaEngine][pList->pConstData->dmaStream] = NULL;
+        if (pList->txDmaSemaphore != NULL) {
+            gpDmaTxUart[pList->pConstData->dmaEngine][pList->pConstData->dmaTxStream] = NULL;
+        }
         // Set the new head pointer if it's the head and free memory
         if (pList == gpUartDataHead) {
             gpUartDataHead = pList->pNext;
@@ -548,6 +616,11 @@ static void eventHandler(void *pParam, size_t paramLength)
     // API which will need to lock the mutex.
 
     pUartData = pGetUartDataByHandle(pEvent->uartHandle);
+    if (pUartData != NULL) {
+        // Clear this before calling the callback so that data
+        // arriving while the callback is running raises a new event
+        pUartData->eventPending = false;
+    }
     if ((pUartData != NULL) && (pUartData->pEventCallback != NULL)) {
         pUartData->pEventCallback(pEvent->uartHandle,
                                   pEvent->eventBitMap,
@@ -555,6 +628,159 @@ static void eventHandler(void *pParam, size_t paramLength)
     }
 }
 
+// Set up the Tx DMA stream of a UART, if it has one, creating
+// the semaphore that the Tx DMA interrupt gives.
+static ErrorStatus txDmaOpen(uPortUartData_t *pUartData, USART_TypeDef *pUartReg)
+{
+    ErrorStatus platformError = SUCCESS;
+    const uPortUartConstData_t *pUartCfg = pUartData->pConstData;
+    DMA_TypeDef *const pDmaReg = gpDmaReg[pUartCfg->dmaEngine];
+    uint32_t dmaStream = (uint32_t) pUartCfg->dmaTxStream;
+    IRQn_Type dmaIrq;
+
+    if (pUartCfg->dmaTxStream >= 0) {
+        platformError = ERROR;
+        if (uPortSemaphoreCreate(&(pUartData->txDmaSemaphore), 0, 1) == 0) {
+            dmaIrq = gpDmaStreamIrq[pUartCfg->dmaEngine][dmaStream];
+            LL_DMA_DisableStream(pDmaReg, dmaStream);
+            while (LL_DMA_IsEnabledStream(pDmaReg, dmaStream)) {}
+            // As for Rx but towards the UART/USART and not circular:
+            // the memory address and length are set per write
+            LL_DMA_SetChannelSelection(pDmaReg, dmaStream,
+                                       gLlDmaChannel[pUartCfg->dmaTxChannel]);
+            LL_DMA_SetDataTransferDirection(pDmaReg, dmaStream,
+                                            LL_DMA_DIRECTION_MEMORY_TO_PERIPH);
+            LL_DMA_SetStreamPriorityLevel(pDmaReg, dmaStream,
+                                          LL_DMA_PRIORITY_LOW);
+            LL_DMA_SetMode(pDmaReg, dmaStream, LL_DMA_MODE_NORMAL);
+            LL_DMA_SetPeriphIncMode(pDmaReg, dmaStream,
+                                    LL_DMA_PERIPH_NOINCREMENT);
+            LL_DMA_SetMemoryIncMode(pDmaReg, dmaStream,
+                                    LL_DMA_MEMORY_INCREMENT);
+            LL_DMA_SetPeriphSize(pDmaReg, dmaStream,
+                                 LL_DMA_PDATAALIGN_BYTE);
+            LL_DMA_SetMemorySize(pDmaReg, dmaStream,
+                                 LL_DMA_MDATAALIGN_BYTE);
+            LL_DMA_DisableFifoMode(pDmaReg, dmaStream);
+            LL_DMA_SetPeriphAddress(pDmaReg, dmaStream,
+                                    (uint32_t) & (pUartReg->DR));
+            gpLlDmaClearFlagHt[dmaStream](pDmaReg);
+            gpLlDmaClearFlagTc[dmaStream](pDmaReg);
+            gpLlDmaClearFlagTe[dmaStream](pDmaReg);
+            gpLlDmaClearFlagDme[dmaStream](pDmaReg);
+            gpLlDmaClearFlagFe[dmaStream](pDmaReg);
+            NVIC_ClearPendingIRQ(dmaIrq);
+            // Only transfer complete and error are of interest
+            LL_DMA_EnableIT_TC(pDmaReg, dmaStream);
+            LL_DMA_EnableIT_TE(pDmaReg, dmaStream);
+            NVIC_SetPriority(dmaIrq,
+                             NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 5, 0));
+            NVIC_EnableIRQ(dmaIrq);
+            platformError = SUCCESS;
+        }
+    }
+
+    return platformError;
+}
+
+// Write to a UART using its Tx DMA stream, returning the number
+// of bytes sent; pData must be accessible to DMA.
+// Note: gMutex should be locked before this is called.
+static size_t txDmaWrite(uPortUartData_t *pUartData, const uint8_t *pData,
+                         size_t sizeBytes, int32_t startTimeMs)
+{
+    const uPortUartConstData_t *pUartCfg = pUartData->pConstData;
+    DMA_TypeDef *const pDmaReg = gpDmaReg[pUartCfg->dmaEngine];
+    uint32_t dmaStream = (uint32_t) pUartCfg->dmaTxStream;
+    size_t sent = 0;
+    size_t thisSize;
+    size_t remaining = 0;
+    int32_t waitMs;
+
+    while ((sent < sizeBytes) && (remaining == 0)) {
+        thisSize = sizeBytes - sent;
+        if (thisSize > U_PORT_DMA_MAX_DATA_LENGTH) {
+            thisSize = U_PORT_DMA_MAX_DATA_LENGTH;
+        }
+        // The stream must be off while it is configured and
+        // any give from a previous timed-out write is stale
+        LL_DMA_DisableStream(pDmaReg, dmaStream);
+        while (LL_DMA_IsEnabledStream(pDmaReg, dmaStream)) {}
+        uPortSemaphoreTryTake(pUartData->txDmaSemaphore, 0);
+        gpLlDmaClearFlagTc[dmaStream](pDmaReg);
+        gpLlDmaClearFlagTe[dmaStream](pDmaReg);
+        gpLlDmaClearFlagDme[dmaStream](pDmaReg);
+        gpLlDmaClearFlagFe[dmaStream](pDmaReg);
+        LL_DMA_SetMemoryAddress(pDmaReg, dmaStream, (uint32_t) (pData + sent));
+        LL_DMA_SetDataLength(pDmaReg, dmaStream, thisSize);
+        LL_USART_ClearFlag_TC(pUartCfg->pReg);
+        LL_DMA_EnableStream(pDmaReg, dmaStream);
+        // Hint when debugging: if this times out it is because
+        // the CTS line of this MCU's UART HW is floating high,
+        // see the similar note in uartWrite()
+        waitMs = U_PORT_UART_WRITE_TIMEOUT_MS - (uPortGetTickTimeMs() - startTimeMs);
+        if (waitMs < 0) {
+            waitMs = 0;
+        }
+        if (uPortSemaphoreTryTake(pUartData->txDmaSemaphore, waitMs) != 0) {
+            LL_DMA_DisableStream(pDmaReg, dmaStream);
+            while (LL_DMA_IsEnabledStream(pDmaReg, dmaStream)) {}
+        }
+        // Non-zero if there was a timeout or an error
+        remaining = LL_DMA_GetDataLength(pDmaReg, dmaStream);
+        sent += thisSize - remaining;
+    }
+
+    return sent;
+}
+
+// Write to a UART without waiting for transmission to complete,
+// returning the number of bytes sent.
+// Note: gMutex should be locked before this is called.
+static size_t uartWrite(uPortUartData_t *pUartData, const uint8_t *pData,
+                        size_t sizeBytes, int32_t startTimeMs)
+{
+    USART_TypeDef *pReg = pUartData->pConstData->pReg;
+    size_t sent = 0;
+    bool txOk = true;
+
+    if ((pUartData->txDmaSemaphore != NULL) && U_PORT_DMA_CAN_ACCESS(pData)) {
+        // DMA does the work while this task waits, leaving
+        // the MCU free for other things
+        sent = txDmaWrite(pUartData, pData, sizeBytes, startTimeMs);
+    } else {
+        while ((sent < sizeBytes) && (txOk)) {
+            LL_USART_TransmitData8(pReg, *(pData + sent));
+            // Hint when debugging: if your code stops dead here
+            // it is because the CTS line of this MCU's UART HW
+            // is floating high, stopping the UART from
+            // transmitting once its buffer is full: either
+            // the thing at the other end doesn't want data sent to
+            // it or the CTS pin when configuring this UART
+            // was wrong and it's not connected to the right
+            // thing.
+            while (!(txOk = LL_USART_IsActiveFlag_TXE(pReg)) &&
+                   (uPortGetTickTimeMs() - startTimeMs < U_PORT_UART_WRITE_TIMEOUT_MS)) {}
+            if (txOk) {
+                sent++;
+            }
+        }
+    }
+
+    return sent;
+}
+
+// Wait for transmission on a UART to complete so that
+// whatever is written next doesn't write over it.
+static void uartWaitTransmitComplete(uPortUartData_t *pUartData,
+                                     int32_t startTimeMs)
+{
+    USART_TypeDef *pReg = pUartData->pConstData->pReg;
+
+    while (!LL_USART_IsActiveFlag_TC(pReg) &&
+           (uPortGetTickTimeMs() - startTimeMs < U_PORT_UART_WRITE_TIMEOUT_MS)) {}
+}
+
 // Close a UART instance
 // Note: gMutex should be locked before this is called.
 static void uartClose(int32_t handle)
@@ -573,6 +799,9 @@ static void uartClose(int32_t handle)
 
         // Disable DMA and UART/USART interrupts
         NVIC_DisableIRQ(gpDmaStreamIrq[dmaEngine][dmaStream]);
+        if (pUartData->txDmaSemaphore != NULL) {
+            NVIC_DisableIRQ(gpDmaStreamIrq[dmaEngine][pUartData->pConstData->dmaTxStream]);
+        }
         NVIC_DisableIRQ(gUartCfg[pUartData->uart].irq);
 
         // Disable DMA and USART, waiting for DMA to be
@@ -580,6 +809,12 @@ static void uartClose(int32_t handle)
         // section 10.3.17 of ST's RM0090.
         LL_DMA_DisableStream(gpDmaReg[dmaEngine], dmaStream);
         while (LL_DMA_IsEnabledStream(gpDmaReg[dmaEngine], dmaStream)) {}
+        if (pUartData->txDmaSemaphore != NULL) {
+            dmaStream = (uint32_t) pUartData->pConstData->dmaTxStream;
+            LL_DMA_DisableStream(gpDmaReg[dmaEngine], dmaStream);
+            while (LL_DMA_IsEnabledStream(gpDmaReg[dmaEngine], dmaStream)) {}
+            uPortSemaphoreDelete(pUartData->txDmaSemaphore);
+        }
         LL_USART_Disable(pUartReg);
         LL_USART_DeInit(pUartReg);
 
@@ -603,6 +838,7 @@ static inline void dataIrqHandler(uPortUartData_t *pUartData,
                                   char *pRxBufferWriteDma)
 {
     uPortUartEventData_t uartSizeOrError = 0;
+    size_t unread = 0;
 
     // Work out how much new data there is
     if (pUartData->pRxBufferWrite < pRxBufferWriteDma) {
@@ -620,6 +856,20 @@ static inline void dataIrqHandler(uPortUartData_t *pUartData,
                           (pRxBufferWriteDma - pUartData->pRxBufferStart);
     }
 
+    // The Rx DMA is circular and so can't be held off: if the
+    // new data has caught up with the read pointer then data
+    // which had not been read has been overwritten
+    if (pUartData->pRxBufferWrite >= pUartData->pRxBufferRead) {
+        unread = pUartData->pRxBufferWrite - pUartData->pRxBufferRead;
+    } else {
+        unread = pUartData->rxBufferSizeBytes - (pUartData->pRxBufferRead -
+                                                 pUartData->pRxBufferWrite);
+    }
+    if (unread + uartSizeOrError >= pUartData->rxBufferSizeBytes) {
+        pUartData->stats.bufferFullCount++;
+    }
+    pUartData->stats.bytesReceived += uartSizeOrError;
+
     // Move the write pointer on
     pUartData->pRxBufferWrite += uartSizeOrError;
     if (pUartData->pRxBufferWrite >= pUartData->pRxBufferStart +
@@ -628,14 +878,19 @@ static inline void dataIrqHandler(uPortUartData_t *pUartData,
                                     pUartData->rxBufferSizeBytes;
     }
 
-    // Let the user know
+    // Let the user know, unless an event is already waiting to
+    // be handled: the callback will read everything there is anyway
     if ((uartSizeOrError > 0) && (pUartData->eventQueueHandle >= 0) &&
-        (pUartData->eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
+        (pUartData->eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED) &&
+        !pUartData->eventPending) {
         uPortUartEvent_t event;
+        pUartData->eventPending = true;
         event.uartHandle = pUartData->uartHandle;
         event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
-        uPortEventQueueSendIrq(pUartData->eventQueueHandle,
-                               &event, sizeof(event));
+        if (uPortEventQueueSendIrq(pUartData->eventQueueHandle,
+                                   &event, sizeof(event)) != 0) {
+            pUartData->eventPending = false;
+        }
     }
 }
 
@@ -647,8 +902,24 @@ static inline void dataIrqHandler(uPortUartData_t *pUartData,
 void dmaIrqHandler(uint32_t dmaEngine, uint32_t dmaStream)
 {
     DMA_TypeDef *const pDmaReg = gpDmaReg[dmaEngine];
+    uPortUartData_t *pTxUartData = gpDmaTxUart[dmaEngine][dmaStream];
     uPortUartData_t *pUartData = NULL;
 
+    if (pTxUartData != NULL) {
+        // A Tx stream: on transfer complete or transfer error
+        // (which disables the stream) let uPortUartWrite() know,
+        // it can work out which from the data length left; the
+        // Rx checks below then find no flags set
+        if ((LL_DMA_IsEnabledIT_TC(pDmaReg, dmaStream) &&
+             gpLlDmaIsActiveFlagTc[dmaStream](pDmaReg)) ||
+            (LL_DMA_IsEnabledIT_TE(pDmaReg, dmaStream) &&
+             gpLlDmaIsActiveFlagTe[dmaStream](pDmaReg))) {
+            gpLlDmaClearFlagTc[dmaStream](pDmaReg);
+            gpLlDmaClearFlagTe[dmaStream](pDmaReg);
+            uPortSemaphoreGiveIrq(pTxUartData->txDmaSemaphore);
+        }
+    }
+
     // Check half-transfer complete interrupt
     if (LL_DMA_IsEnabledIT_HT(pDmaReg, dmaStream) &&
         gpLlDmaIsActiveFlagHt[dmaStream](pDmaReg)) {
@@ -688,6 +959,24 @@ void uartIrqHandler(uPortUartData_t *pUartData)
     const uPortUartConstData_t *pUartCfg = pUartData->pConstData;
     USART_TypeDef *const pUartReg = pUartCfg->pReg;
 
+    // Check for errors, which are flagged along with a received
+    // character and so interrupt (EIE) even though the DMA is
+    // doing the receiving
+    if (LL_USART_IsEnabledIT_ERROR(pUartReg)) {
+        if (LL_USART_IsActiveFlag_ORE(pUartReg)) {
+            pUartData->stats.overrunCount++;
+        }
+        if (LL_USART_IsActiveFlag_FE(pUartReg)) {
+            pUartData->stats.framingErrorCount++;
+        }
+        if (LL_USART_IsActiveFlag_PE(pUartReg)) {
+            pUartData->stats.parityErrorCount++;
+        }
+        // This is the SR-then-DR read sequence, which clears
+        // all of the error flags at once
+        LL_USART_ClearFlag_ORE(pUartReg);
+    }
+
     // Check for IDLE line interrupt
     if (LL_USART_IsEnabledIT_IDLE(pUartReg) &&
         LL_USART_IsActiveFlag_IDLE(pUartReg)) {
@@ -988,6 +1277,7 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                     uartData.pRxBufferWrite = uartData.pRxBufferStart;
                     uartData.ctsSuspended = false;
                     uartData.eventQueueHandle = -1;
+                    uartData.eventPending = false;
 
                     pUartReg = gUartCfg[uart].pReg;
                     dmaEngine = gUartCfg[uart].dmaEngine;
@@ -1129,6 +1419,11 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                         platformError = LL_USART_Init(pUartReg, &usartInitStruct);
                     }
 
+                    // Configure Tx DMA, if there is one
+                    if (platformError == SUCCESS) {
+                        platformError = txDmaOpen(&uartData, pUartReg);
+                    }
+
                     // Connect it all together
                     if (platformError == SUCCESS) {
                         // Asynchronous UART/USART with DMA on the receive
@@ -1136,7 +1431,12 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                         // DMA does the rest
                         LL_USART_ConfigAsyncMode(pUartReg);
                         LL_USART_EnableDMAReq_RX(pUartReg);
+                        if (uartData.txDmaSemaphore != NULL) {
+                            // The stream is only enabled during a write
+                            LL_USART_EnableDMAReq_TX(pUartReg);
+                        }
                         LL_USART_EnableIT_IDLE(pUartReg);
+                        LL_USART_EnableIT_ERROR(pUartReg);
 
                         // Enable the UART/USART interrupt
                         NVIC_SetPriority(uartIrq,
@@ -1164,6 +1464,11 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
 
                 // If we failed, clean up
                 if (handleOrErrorCode < 0) {
+                    if (uartData.txDmaSemaphore != NULL) {
+                        NVIC_DisableIRQ(gpDmaStreamIrq[uartData.pConstData->dmaEngine]
+                                        [uartData.pConstData->dmaTxStream]);
+                        uPortSemaphoreDelete(uartData.txDmaSemaphore);
+                    }
                     if (uartData.rxBufferIsMalloced) {
                         uPortFree(uartData.pRxBufferStart);
                     }
@@ -1299,16 +1604,29 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     return (int32_t) sizeOrErrorCode;
 }
 
+// Get a pointer to the received data: not supported.
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    (void) handle;
+    (void) ppData;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// Remove data obtained with uPortUartReadSpan(): not supported.
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    (void) handle;
+    (void) sizeBytes;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 // Write to the given UART interface.
 int32_t uPortUartWrite(int32_t handle,
                        const void *pBuffer,
                        size_t sizeBytes)
 {
     int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
-    const uint8_t *pDataPtr = pBuffer;
     uPortUartData_t *pUartData;
-    USART_TypeDef *pReg;
-    bool txOk = true;
     int32_t startTimeMs;
 
     if (gMutex != NULL) {
@@ -1318,32 +1636,51 @@ int32_t uPortUartWrite(int32_t handle,
         sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
         pUartData = pGetUartDataByHandle(handle);
         if (pUartData != NULL) {
-            pReg = gUartCfg[pUartData->uart].pReg;
             // Do the blocking send
-            sizeOrErrorCode = (int32_t) sizeBytes;
             startTimeMs = uPortGetTickTimeMs();
-            while ((sizeBytes > 0) && (txOk)) {
-                LL_USART_TransmitData8(pReg, *pDataPtr);
-                // Hint when debugging: if your code stops dead here
-                // it is because the CTS line of this MCU's UART HW
-                // is floating high, stopping the UART from
-                // transmitting once its buffer is full: either
-                // the thing at the other end doesn't want data sent to
-                // it or the CTS pin when configuring this UART
-                // was wrong and it's not connected to the right
-                // thing.
-                while (!(txOk = LL_USART_IsActiveFlag_TXE(pReg)) &&
-                       (uPortGetTickTimeMs() - startTimeMs < U_PORT_UART_WRITE_TIMEOUT_MS)) {}
-                if (txOk) {
-                    pDataPtr++;
-                    sizeBytes--;
-                }
+            sizeOrErrorCode = (int32_t) uartWrite(pUartData, (const uint8_t *) pBuffer,
+                                                  sizeBytes, startTimeMs);
+            uartWaitTransmitComplete(pUartData, startTimeMs);
+            pUartData->stats.bytesSent += (uint32_t) sizeOrErrorCode;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
+// Write several buffers to the given UART interface.
+int32_t uPortUartWriteVec(int32_t handle, const uPortUartIoVec_t *pVec,
+                          size_t count)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+    int32_t startTimeMs;
+    size_t sent;
+    bool allSent = true;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pUartData = pGetUartDataByHandle(handle);
+        if ((pUartData != NULL) && ((pVec != NULL) || (count == 0))) {
+            // The STM32F4 DMA engines can't follow a chain of
+            // buffers so each is sent in turn, the UART only being
+            // allowed to drain at the end; the mutex is held
+            // throughout so that nothing can get in between
+            sizeOrErrorCode = 0;
+            startTimeMs = uPortGetTickTimeMs();
+            for (size_t x = 0; (x < count) && allSent; x++) {
+                sent = uartWrite(pUartData, (const uint8_t *) pVec[x].pBuffer,
+                                 pVec[x].sizeBytes, startTimeMs);
+                sizeOrErrorCode += (int32_t) sent;
+                allSent = (sent == pVec[x].sizeBytes);
             }
-            // Wait for transmission to complete so that we don't
-            // write over stuff the next time
-            while (!LL_USART_IsActiveFlag_TC(pReg) &&
-                   (uPortGetTickTimeMs() - startTimeMs < U_PORT_UART_WRITE_TIMEOUT_MS)) {}
-            sizeOrErrorCode -= (int32_t) sizeBytes;
+            uartWaitTransmitComplete(pUartData, startTimeMs);
+            pUartData->stats.bytesSent += (uint32_t) sizeOrErrorCode;
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
@@ -1384,6 +1721,7 @@ int32_t uPortUartEventCallbackSet(int32_t handle,
                                             priority,
                                             U_PORT_UART_EVENT_QUEUE_SIZE);
             if (errorCode >= 0) {
+                pUartData->eventPending = false;
                 pUartData->eventQueueHandle = errorCode;
                 pUartData->pEventCallback = pFunction;
                 pUartData->pEventCallbackParam = pParam;
@@ -1693,6 +2031,56 @@ void uPortUartCtsResume(int32_t handle)
     }
 }
 
+// Get the statistics of a UART.
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        pUartData = pGetUartDataByHandle(handle);
+        if ((pUartData != NULL) && (pStats != NULL)) {
+            // Each count is a single word, which is enough
+            // for consistency with the interrupt; the receive
+            // buffer is circular DMA and so never stalls,
+            // hence bufferFullTimeMs is always zero here
+            *pStats = pUartData->stats;
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return (int32_t) errorCode;
+}
+
+// Reset the statistics of a UART.
+int32_t uPortUartStatsReset(int32_t handle)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        pUartData = pGetUartDataByHandle(handle);
+        if (pUartData != NULL) {
+            memset(&(pUartData->stats), 0, sizeof(pUartData->stats));
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return (int32_t) errorCode;
+}
+
 // Get the number of UART interfaces currently open.
 int32_t uPortUartResourceAllocCount()
 {
@@ -96,6 +96,10 @@ static void appTask(void *pParam)
     // called deinit so call init again here.
     uPortInit();
 
+#if defined(U_CFG_MUTEX_DEBUG) && defined(U_MUTEX_DEBUG_PROFILE)
+    uMutexDebugProfilePrint(NULL);
+#endif
+
     UNITY_END();
 
     uPortLog("\n\nU_APP: application task ended.\n");
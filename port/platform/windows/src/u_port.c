@@ -78,6 +78,17 @@ extern DWORD *gpMainThreadId;
 // Keep track of whether we've been initialised or not.
 static bool gInitialised = false;
 
+/** The timezone offset last worked out by
+ * uPortGetTimezoneOffsetSeconds() and the period of
+ * #U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS in which it was worked out.
+ */
+static int32_t gTimezoneOffsetSeconds = 0;
+static time_t gTimezoneOffsetSlot = -1;
+
+/** Protection for the two variables above.
+ */
+static SRWLOCK gTimezoneLock = SRWLOCK_INIT;
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -156,6 +167,22 @@ int32_t uPortGetTickTimeMs()
     return GetTickCount() % INT_MAX;
 }
 
+// Get the current time in microseconds.
+int64_t uPortGetTickTimeUs()
+{
+    int64_t us = 0;
+    LARGE_INTEGER frequency;
+    LARGE_INTEGER count;
+
+    if (QueryPerformanceFrequency(&frequency) && QueryPerformanceCounter(&count)) {
+        // Split the division to avoid overflow
+        us = ((count.QuadPart / frequency.QuadPart) * 1000000) +
+             (((count.QuadPart % frequency.QuadPart) * 1000000) / frequency.QuadPart);
+    }
+
+    return us;
+}
+
 // Get the minimum amount of heap free, ever, in bytes.
 int32_t uPortGetHeapMinFree()
 {
@@ -183,21 +210,32 @@ void uPortExitCritical()
 // Get the timezone offset.
 int32_t uPortGetTimezoneOffsetSeconds()
 {
+    int32_t offsetSeconds;
     struct tm utcTm;
     time_t utc;
-    time_t mktimeSays;
+    time_t slot = -1;
 
     utc = time(NULL);
-    utcTm = *gmtime(&utc);
-    // Setting daylight saving flag to -1 causes mktime()
-    // to decide whether DST is in effect
-    utcTm.tm_isdst = -1;
-    mktimeSays = mktime(&utcTm);
-    // mktime will have subtracted the timezone from what it was
-    // given in order to return local time, hence the timezone
-    // offset is the difference
-
-    return (int32_t) (utc - mktimeSays);
+#if U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS > 0
+    slot = utc / U_PORT_TIMEZONE_OFFSET_CACHE_SECONDS;
+#endif
+    AcquireSRWLockExclusive(&gTimezoneLock);
+    if ((slot < 0) || (slot != gTimezoneOffsetSlot)) {
+        // Windows doesn't have gmtime_r()
+        gmtime_s(&utcTm, &utc);
+        // Setting daylight saving flag to -1 causes mktime()
+        // to decide whether DST is in effect
+        utcTm.tm_isdst = -1;
+        // mktime will have subtracted the timezone from what it was
+        // given in order to return local time, hence the timezone
+        // offset is the difference
+        gTimezoneOffsetSeconds = (int32_t) (utc - mktime(&utcTm));
+        gTimezoneOffsetSlot = slot;
+    }
+    offsetSeconds = gTimezoneOffsetSeconds;
+    ReleaseSRWLockExclusive(&gTimezoneLock);
+
+    return offsetSeconds;
 }
 
 // End of file
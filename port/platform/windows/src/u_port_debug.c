@@ -28,6 +28,8 @@
 
 #include "u_error_common.h"
 
+#include "u_port_debug.h"
+
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
@@ -63,7 +65,9 @@ void uPortLogF(const char *pFormat, ...)
 
     if (gPortLogOn) {
         va_start(args, pFormat);
-        vprintf(pFormat, args);
+        if (!uPortLogAsyncWrite(pFormat, args)) {
+            vprintf(pFormat, args);
+        }
         va_end(args);
 
         fflush(stdout);
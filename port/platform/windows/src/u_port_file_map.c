@@ -0,0 +1,91 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Implementation of the memory-mapped file API on Windows.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"    // NULL, size_t etc.
+#include "stdint.h"    // int32_t etc.
+#include "stdbool.h"
+
+#include "windows.h"
+
+#include "u_port_file_map.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Create a file and map it into memory.
+void *pUPortFileMap(const char *pPath, size_t sizeBytes)
+{
+    void *pMap = NULL;
+    HANDLE file;
+    HANDLE mapping;
+    ULARGE_INTEGER size;
+
+    if ((pPath != NULL) && (sizeBytes > 0)) {
+        size.QuadPart = sizeBytes;
+        file = CreateFileA(pPath, GENERIC_READ | GENERIC_WRITE, 0, NULL,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file != INVALID_HANDLE_VALUE) {
+            // Creating the mapping extends the file to the given size
+            mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                                         size.HighPart, size.LowPart, NULL);
+            if (mapping != NULL) {
+                pMap = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeBytes);
+                // The view keeps the mapping and the file open
+                CloseHandle(mapping);
+            }
+            CloseHandle(file);
+        }
+    }
+
+    return pMap;
+}
+
+// Unmap a file.
+void uPortFileUnmap(void *pMap, size_t sizeBytes)
+{
+    (void) sizeBytes;
+
+    if (pMap != NULL) {
+        UnmapViewOfFile(pMap);
+    }
+}
+
+// End of file
@@ -57,16 +57,17 @@
 #endif
 
 #ifndef U_PORT_UART_READ_TIMEOUT_MS
-/** The read timeout to set on the COM ports.
+/** The read timeout to set on the COM ports: the time after which
+ * a read completes when nothing has been received.
  */
 # define U_PORT_UART_READ_TIMEOUT_MS 50
 #endif
 
-#ifndef U_PORT_UART_TIMER_POLL_TIME_MS
-/** Poll every 10 milliseconds to catch anything we might have missed.
+/** The number of bytes transferred, as posted to the completion
+ * port, of a kick saying that a UART is being closed; a kick with
+ * any other value says that there is room in the receive buffer again.
  */
-# define U_PORT_UART_TIMER_POLL_TIME_MS 10
-#endif
+#define U_PORT_UART_KICK_CLOSE 1
 
 /* ----------------------------------------------------------------
  * TYPES
@@ -80,9 +81,14 @@ typedef struct uPortUartData_t {
     bool markedForDeletion;
     char nameStr[U_PORT_UART_MAX_COM_PORT_NAME_BUFFER_LENGTH];
     HANDLE windowsUartHandle;
-    HANDLE waitCommEventThreadHandle;
-    HANDLE waitCommEventThreadReadyHandle;
-    HANDLE waitCommEventThreadTerminateHandle;
+    OVERLAPPED readOverlap;
+    volatile bool readPending; /**< a read is in progress, using readOverlap. */
+    volatile bool rxBufferFull; /**< there was no room to start a read. */
+    volatile bool rxStalled; /**< rxBufferFull for real, bufferFullStartMs is valid. */
+    volatile int32_t bufferFullStartMs;
+    uPortUartStats_t stats; /**< counts from reception are written by readCompletionThread(). */
+    bool closeRequested; /**< only touched by readCompletionThread(). */
+    HANDLE readStoppedHandle; /**< set once readCompletionThread() is done with the UART. */
     bool rxBufferIsMalloced;
     size_t rxBufferSizeBytes;
     char *pRxBufferStart;
@@ -91,6 +97,7 @@ typedef struct uPortUartData_t {
     bool ctsFlowControlSuspended;
     int32_t eventQueueHandle;
     uint32_t eventFilter;
+    volatile bool eventPending; /**< a data received event is queued but not yet handled. */
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
     struct uPortUartData_t *pNext;
@@ -103,6 +110,9 @@ typedef struct {
     uint32_t eventBitMap;
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
+    volatile bool *pEventPending; /**< NULL if the event was not coalesced;
+                                       valid since the event queue is closed
+                                       before the UART data is freed. */
 } uPortUartEvent_t;
 
 /* ----------------------------------------------------------------
@@ -113,6 +123,14 @@ typedef struct {
  */
 static uPortMutexHandle_t gMutex = NULL;
 
+/** The I/O completion port that the reads of all UARTs complete to.
+ */
+static HANDLE gCompletionPort = NULL;
+
+/** The thread that handles gCompletionPort.
+ */
+static HANDLE gCompletionThreadHandle = NULL;
+
 /** Root of linked list of UART data.
  */
 static uPortUartData_t *gpUartListRoot = NULL;
@@ -171,9 +189,7 @@ static uPortUartData_t *pUartAdd()
         pTmp->eventQueueHandle = -1;
         pTmp->uartHandle = -1;
         pTmp->windowsUartHandle = INVALID_HANDLE_VALUE;
-        pTmp->waitCommEventThreadHandle = INVALID_HANDLE_VALUE;
-        pTmp->waitCommEventThreadReadyHandle = INVALID_HANDLE_VALUE;
-        pTmp->waitCommEventThreadTerminateHandle = INVALID_HANDLE_VALUE;
+        pTmp->readStoppedHandle = NULL;
         pTmp->pNext = NULL;
         // Get the next UART handle
         x = gUartHandleNext;
@@ -230,13 +246,16 @@ static void uartRemove(const uPortUartData_t *pUartData)
 // !!! gMutex should NOT be locked when this is called !!!
 static void uartCloseRequiresMutex(uPortUartData_t *pUartData)
 {
-    // Set the terminate event and wait for the waitCommEvent
-    // thread to exit
-    SetEvent(pUartData->waitCommEventThreadTerminateHandle);
-    WaitForSingleObject(pUartData->waitCommEventThreadHandle, INFINITE);
-    // Close the ready and terminate events
-    CloseHandle(pUartData->waitCommEventThreadReadyHandle);
-    CloseHandle(pUartData->waitCommEventThreadTerminateHandle);
+    // Cancel any read that is in progress, tell the read completion
+    // thread that the UART is going and wait for it to let go; the
+    // UART is already marked for deletion so no more kicks will
+    // be posted for it after this one
+    CancelIoEx(pUartData->windowsUartHandle, &(pUartData->readOverlap));
+    if (PostQueuedCompletionStatus(gCompletionPort, U_PORT_UART_KICK_CLOSE,
+                                   (ULONG_PTR) pUartData, NULL)) {
+        WaitForSingleObject(pUartData->readStoppedHandle, INFINITE);
+    }
+    CloseHandle(pUartData->readStoppedHandle);
     // Remove the callback if there is one
     if (pUartData->eventQueueHandle >= 0) {
         uPortEventQueueClose(pUartData->eventQueueHandle);
@@ -271,6 +290,11 @@ static void eventHandler(void *pParam, size_t paramLength)
     // will want to be able to access functions in this
     // API which will need to lock the mutex.
 
+    if (pEvent->pEventPending != NULL) {
+        // Clear this before calling the callback so that data
+        // arriving while the callback is running raises a new event
+        *pEvent->pEventPending = false;
+    }
     if (pEvent->pEventCallback != NULL) {
         pEvent->pEventCallback(pEvent->uartHandle,
                                pEvent->eventBitMap,
@@ -278,211 +302,171 @@ static void eventHandler(void *pParam, size_t paramLength)
     }
 }
 
-// Handle a UART event, called by waitCommEventThread().
-// Returns the system error code that the attempt to read the
-// UART results in, usually either:
-// ERROR_SUCCESS (0)
-// ERROR_TIMEOUT (1460)
-static DWORD handleThreadUartEvent(uPortUartData_t *pUartData,
-                                   DWORD uartEvent)
+// Start a read into the linear free space of the receive buffer
+// of a UART; the completion of the read, successful or not, arrives
+// at readCompletionThread().  Only called by readCompletionThread(),
+// or by uPortUartOpen() before the UART is known to anyone, so that
+// there is only ever one writer of the receive buffer.
+static void readStart(uPortUartData_t *pUartData)
 {
-    uPortUartEvent_t event;
-    OVERLAPPED overlap;
-    DWORD bytesRead;
-    DWORD totalSize = 0;
-    DWORD lastErrorCode = -1;
     const volatile char *pRxBufferRead;
     int32_t spaceAvailable;
 
-    if (uartEvent & EV_RXCHAR) {
-        // There's received data, go get it
-        memset(&overlap, 0, sizeof(overlap));
-        overlap.hEvent = CreateEvent(NULL, true, false, NULL);
-        if (overlap.hEvent != INVALID_HANDLE_VALUE) {
-            do {
-                // Work out how much linear space we have
-                // free in the buffer
-                pRxBufferRead = pUartData->pRxBufferRead;
-                if (pUartData->pRxBufferWrite >= pRxBufferRead) {
-                    //        |              rxBufferSizeBytes          |
-                    //        |---------------|-----------|----- X -----|
-                    //        ^               ^           ^
-                    //        |               |           |
-                    // pRxBufferStart pRxBufferRead pRxBufferWrite
-                    //
-                    // Write pointer is at or ahead of the read pointer,
-                    // bytes available, X, are from the write pointer
-                    // up to the end of the buffer but we also need to
-                    // make sure that wouldn't cause the pointers to
-                    // catch up
-                    spaceAvailable = pUartData->pRxBufferStart +
-                                     (pUartData->rxBufferSizeBytes) -
-                                     pUartData->pRxBufferWrite;
-                    if ((spaceAvailable > 0) &&
-                        (pRxBufferRead == pUartData->pRxBufferStart)) {
-                        spaceAvailable--;
-                    }
-                } else {
-                    //        |              rxBufferSizeBytes          |
-                    //        |---------------|-----X-----|-------------|
-                    //        ^               ^           ^
-                    //        |               |           |
-                    // pRxBufferStart pRxBufferWrite pRxBufferRead
-                    //
-                    // Write pointer is behind read, bytes available, X, is
-                    // simply the difference, -1 so that they don't catch up
-                    spaceAvailable = (pRxBufferRead - pUartData->pRxBufferWrite) - 1;
-                }
+    // Flag that the buffer is full before looking at the read
+    // pointer: if uPortUartRead() moves the read pointer after we've
+    // looked it will see this flag and kick us to try again
+    pUartData->rxBufferFull = true;
+    // Work out how much linear space we have free in the buffer
+    pRxBufferRead = pUartData->pRxBufferRead;
+    if (pUartData->pRxBufferWrite >= pRxBufferRead) {
+        //        |              rxBufferSizeBytes          |
+        //        |---------------|-----------|----- X -----|
+        //        ^               ^           ^
+        //        |               |           |
+        // pRxBufferStart pRxBufferRead pRxBufferWrite
+        //
+        // Write pointer is at or ahead of the read pointer,
+        // bytes available, X, are from the write pointer
+        // up to the end of the buffer but we also need to
+        // make sure that wouldn't cause the pointers to
+        // catch up
+        spaceAvailable = pUartData->pRxBufferStart +
+                         (pUartData->rxBufferSizeBytes) -
+                         pUartData->pRxBufferWrite;
+        if ((spaceAvailable > 0) &&
+            (pRxBufferRead == pUartData->pRxBufferStart)) {
+            spaceAvailable--;
+        }
+    } else {
+        //        |              rxBufferSizeBytes          |
+        //        |---------------|-----X-----|-------------|
+        //        ^               ^           ^
+        //        |               |           |
+        // pRxBufferStart pRxBufferWrite pRxBufferRead
+        //
+        // Write pointer is behind read, bytes available, X, is
+        // simply the difference, -1 so that they don't catch up
+        spaceAvailable = (pRxBufferRead - pUartData->pRxBufferWrite) - 1;
+    }
 
-                // Now read up to that amount of data or until
-                // we hit the read COMM timeout
-                bytesRead = 0;
-                lastErrorCode = ERROR_SUCCESS;
-                if (!ReadFile(pUartData->windowsUartHandle,
-                              pUartData->pRxBufferWrite,
-                              spaceAvailable, &bytesRead, &overlap)) {
-                    lastErrorCode = GetLastError();
-                    if (lastErrorCode == ERROR_IO_PENDING) {
-                        GetOverlappedResult(pUartData->windowsUartHandle,
-                                            &overlap, &bytesRead, true);
-                        lastErrorCode = GetLastError();
-                    }
-                }
-                // Move the write pointer on
-                pUartData->pRxBufferWrite += bytesRead;
-                totalSize += bytesRead;
-                if (pUartData->pRxBufferWrite >= pUartData->pRxBufferStart +
-                    pUartData->rxBufferSizeBytes) {
-                    pUartData->pRxBufferWrite = pUartData->pRxBufferStart;
-                }
-                // Keep reading while there is stuff to read
-            } while (bytesRead > 0);
-        } else {
-            lastErrorCode = GetLastError() ;
+    if (spaceAvailable <= 0) {
+        if (!pUartData->rxStalled) {
+            pUartData->stats.bufferFullCount++;
+            pUartData->bufferFullStartMs = uPortGetTickTimeMs();
+            pUartData->rxStalled = true;
+        }
+    } else {
+        pUartData->rxBufferFull = false;
+        // With the COMM timeouts set in uPortUartOpen() this
+        // completes as soon as there is any received data
+        // or, if there is none, after U_PORT_UART_READ_TIMEOUT_MS
+        memset(&(pUartData->readOverlap), 0, sizeof(pUartData->readOverlap));
+        pUartData->readPending = true;
+        if (!ReadFile(pUartData->windowsUartHandle,
+                      (void *) pUartData->pRxBufferWrite,
+                      spaceAvailable, NULL, &(pUartData->readOverlap)) &&
+            (GetLastError() != ERROR_IO_PENDING)) {
+            // No completion will arrive for this
+            pUartData->readPending = false;
+        }
+    }
+}
+
+// Handle the completion of a read started by readStart(),
+// called by readCompletionThread().
+static void readCompleted(uPortUartData_t *pUartData, DWORD bytesRead)
+{
+    uPortUartEvent_t event;
+    DWORD errors = 0;
+
+    // Collect any line errors there have been; this also clears
+    // them, which is required in case fAbortOnError is set
+    if (ClearCommError(pUartData->windowsUartHandle, &errors, NULL)) {
+        if (errors & (CE_OVERRUN | CE_RXOVER)) {
+            pUartData->stats.overrunCount++;
+        }
+        if (errors & CE_FRAME) {
+            pUartData->stats.framingErrorCount++;
         }
+        if (errors & CE_RXPARITY) {
+            pUartData->stats.parityErrorCount++;
+        }
+    }
+    pUartData->stats.bytesReceived += bytesRead;
 
-        CloseHandle(overlap.hEvent);
+    // Move the write pointer on
+    pUartData->pRxBufferWrite += bytesRead;
+    if (pUartData->pRxBufferWrite >= pUartData->pRxBufferStart +
+        pUartData->rxBufferSizeBytes) {
+        pUartData->pRxBufferWrite = pUartData->pRxBufferStart;
     }
 
-    if ((totalSize > 0) &&
-        (pUartData->eventQueueHandle >= 0)) {
-        // Call the user callback
+    if ((bytesRead > 0) &&
+        (pUartData->eventQueueHandle >= 0) && !pUartData->eventPending) {
+        // Call the user callback, unless an event is already waiting
+        // to be handled: the callback will read everything there is
+        pUartData->eventPending = true;
         event.uartHandle = pUartData->uartHandle;
         event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
         event.pEventCallback = pUartData->pEventCallback;
         event.pEventCallbackParam = pUartData->pEventCallbackParam;
-        uPortEventQueueSend(pUartData->eventQueueHandle, &event, sizeof(event));
+        event.pEventPending = &(pUartData->eventPending);
+        if (uPortEventQueueSend(pUartData->eventQueueHandle, &event, sizeof(event)) != 0) {
+            pUartData->eventPending = false;
+        }
     }
-
-    return lastErrorCode;
 }
 
-// Event thread used by all UARTs for COM events.
-static int32_t waitCommEventThread(void *pParam)
+// Thread used by all UARTs, handling everything that arrives at
+// gCompletionPort: read completions, which carry an OVERLAPPED
+// pointer, and kicks, which don't; the completion key is the
+// UART data, NULL telling the thread to exit.
+static int32_t readCompletionThread(void *pParam)
 {
+    HANDLE completionPort = (HANDLE) pParam;
     uPortUartData_t *pUartData;
-    OVERLAPPED overlap;
-    int32_t uartHandle;
-    HANDLE windowsUartHandle = INVALID_HANDLE_VALUE;
-    HANDLE windowsTimerHandle = INVALID_HANDLE_VALUE;
-    HANDLE readyHandle = INVALID_HANDLE_VALUE;
-    LARGE_INTEGER timerDueTime;
-    HANDLE eventHandles[3];
-    DWORD uartEvent;
-    DWORD x;
+    OVERLAPPED *pOverlap;
+    ULONG_PTR key;
+    DWORD bytesRead;
     bool keepGoing = true;
 
-    if (gMutex != NULL) {
-        // The parameter passed to us is actually the UART (non-windows) handle
-        uartHandle = (int32_t) pParam;
-        for (size_t x = 0; x < sizeof(eventHandles) / sizeof(eventHandles[0]); x++) {
-            eventHandles[x] = INVALID_HANDLE_VALUE;
-        }
-
-        pUartData = pUartGetByHandle(uartHandle);
-        if (pUartData != NULL) {
-            // First item in the array is the event thread terminate event,
-            // don't want to miss that
-            eventHandles[0] = pUartData->waitCommEventThreadTerminateHandle;
-            // Need the ready handle
-            readyHandle = pUartData->waitCommEventThreadReadyHandle;
-            // Also need the Windows handle of the UART
-            windowsUartHandle = pUartData->windowsUartHandle;
+    while (keepGoing) {
+        bytesRead = 0;
+        key = 0;
+        pOverlap = NULL;
+        // A failed read, e.g. one cancelled by uartCloseRequiresMutex(),
+        // returns false with pOverlap populated and is handled just
+        // like a read of no characters; false with no pOverlap means
+        // that the completion port itself has gone
+        if (!GetQueuedCompletionStatus(completionPort, &bytesRead,
+                                       &key, &pOverlap, INFINITE) &&
+            (pOverlap == NULL)) {
+            key = 0;
         }
-
-        // Create an event to capture stuff going-on on the serial port
-        // The event is used by WaitCommEvent()
-        eventHandles[1] = CreateEvent(NULL, true, false, NULL);
-        if (eventHandles[1] != INVALID_HANDLE_VALUE) {
-            // Put the event into the overlap structure so that it can
-            // be passed to WaitCommEvent()
-            memset(&overlap, 0, sizeof(overlap));
-            overlap.hEvent = eventHandles[1];
-            // Finally, last in the array, add a timer that we can
-            // use to periodically poll the UART for received data
-            // in case we were unable to process any events (e.g.
-            // if our buffer was full at the time).
-            eventHandles[2] = CreateWaitableTimer(NULL, false, NULL);
-            if (eventHandles[2] != INVALID_HANDLE_VALUE) {
-                // Start the periodic timer, a relative timeout value
-                // that is in units of 100 nanosecond intervals in the future
-                timerDueTime.QuadPart = -U_PORT_UART_TIMER_POLL_TIME_MS * 10;
-                if (SetWaitableTimer(eventHandles[2], &timerDueTime,
-                                     U_PORT_UART_TIMER_POLL_TIME_MS, NULL, NULL, 0)) {
-                    // Now we can wait for events on those handles
-                    SetEvent(readyHandle);
-                    while (keepGoing) {
-                        if (WaitCommEvent(windowsUartHandle, &uartEvent, &overlap)) {
-                            // An event has already occurred, handle it
-                            // However, I have seen this return that there is a character
-                            // in the buffer and then any attempt to read the buffer result
-                            // in timeout, which means the code gets stuck here because
-                            // it never processes any of the events in the section below.
-                            // Hence if handleThreadUartEvent() doesn't return
-                            // ERROR_SUCCESS then we move to waiting on events
-                            x = handleThreadUartEvent(pUartData, uartEvent);
-                        } else {
-                            x = GetLastError();
-                        }
-                        if (x != ERROR_SUCCESS) {
-                            // WaitCommEvent will now signal us with the
-                            // eventHandles[1] flag when something has happened
-                            // while a terminate event might arrive on eventHandles[0]
-                            // and the periodic poll timer on eventHandles[2]
-                            x = WaitForMultipleObjectsEx(sizeof(eventHandles) / sizeof(eventHandles[0]),
-                                                         eventHandles,
-                                                         false, INFINITE, true);
-                            switch (x) {
-                                case WAIT_OBJECT_0 + 0:
-                                    // Terminate thread was signalled
-                                    keepGoing = false;
-                                    break;
-                                case WAIT_OBJECT_0 + 1:
-                                    // UART event was signaled, go get it
-                                    if (GetOverlappedResult(windowsUartHandle, &overlap, &uartEvent, true)) {
-                                        handleThreadUartEvent(pUartData, uartEvent);
-                                    }
-                                    break;
-                                case WAIT_OBJECT_0 + 2:
-                                    // Periodic timer has gone off, do a read
-                                    handleThreadUartEvent(pUartData, EV_RXCHAR);
-                                    break;
-                                default:
-                                    // Ignore and continue
-                                    break;
-                            }
-                        }
-                    }
-
-                    // Stop the periodic timer
-                    CancelWaitableTimer(eventHandles[2]);
-                }
+        pUartData = (uPortUartData_t *) key;
+        if (pUartData == NULL) {
+            keepGoing = false;
+        } else if (pOverlap == &(pUartData->readOverlap)) {
+            // A read has completed
+            pUartData->readPending = false;
+            readCompleted(pUartData, bytesRead);
+            if (pUartData->closeRequested) {
+                SetEvent(pUartData->readStoppedHandle);
+            } else if (!pUartData->markedForDeletion) {
+                readStart(pUartData);
             }
+        } else if (pOverlap != NULL) {
+            // Not one of ours, ignore it
+        } else if (bytesRead == U_PORT_UART_KICK_CLOSE) {
+            // This is the last kick for this UART, it is going
+            pUartData->closeRequested = true;
+            if (!pUartData->readPending) {
+                SetEvent(pUartData->readStoppedHandle);
+            }
+        } else if (!pUartData->readPending && !pUartData->markedForDeletion) {
+            // Room has been made in the receive buffer
+            readStart(pUartData);
         }
-
-        // Close the waitable timer handle and the UART event handle
-        CloseHandle(eventHandles[2]);
-        CloseHandle(eventHandles[1]);
     }
 
     ExitThread(0);
@@ -498,7 +482,31 @@ int32_t uPortUartInit()
     uErrorCode_t errorCode = U_ERROR_COMMON_SUCCESS;
 
     if (gMutex == NULL) {
-        errorCode = uPortMutexCreate(&gMutex);
+        errorCode = U_ERROR_COMMON_PLATFORM;
+        // One completion port and one thread to serve the reads
+        // of all UARTs, however many there are
+        gCompletionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+        if (gCompletionPort != NULL) {
+            gCompletionThreadHandle = CreateThread(NULL, 0,
+                                                   (LPTHREAD_START_ROUTINE) readCompletionThread,
+                                                   (PVOID) gCompletionPort, 0, NULL);
+            if (gCompletionThreadHandle != NULL) {
+                errorCode = uPortMutexCreate(&gMutex);
+                if (errorCode != U_ERROR_COMMON_SUCCESS) {
+                    PostQueuedCompletionStatus(gCompletionPort, 0, 0, NULL);
+                    WaitForSingleObject(gCompletionThreadHandle, INFINITE);
+                }
+            }
+            if (errorCode != U_ERROR_COMMON_SUCCESS) {
+                // Clean up on error
+                if (gCompletionThreadHandle != NULL) {
+                    CloseHandle(gCompletionThreadHandle);
+                    gCompletionThreadHandle = NULL;
+                }
+                CloseHandle(gCompletionPort);
+                gCompletionPort = NULL;
+            }
+        }
     }
 
     return (int32_t) errorCode;
@@ -532,6 +540,14 @@ void uPortUartDeinit()
         U_PORT_MUTEX_UNLOCK(gMutex);
         uPortMutexDelete(gMutex);
         gMutex = NULL;
+
+        // Tell the read completion thread to exit
+        PostQueuedCompletionStatus(gCompletionPort, 0, 0, NULL);
+        WaitForSingleObject(gCompletionThreadHandle, INFINITE);
+        CloseHandle(gCompletionThreadHandle);
+        gCompletionThreadHandle = NULL;
+        CloseHandle(gCompletionPort);
+        gCompletionPort = NULL;
     }
 }
 
@@ -619,39 +635,30 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                             }
                             if (SetCommState(pUartData->windowsUartHandle, &dcb)) {
                                 // Set the timeouts: no timeout in the write case,
-                                // i.e. write is blocking, read timeout is set to
+                                // i.e. write is blocking; a read returns at once
+                                // with whatever has been received or, if nothing
+                                // has, as soon as something is, up to
                                 // U_PORT_UART_READ_TIMEOUT_MS
                                 memset (&timeouts, 0, sizeof(timeouts));
                                 timeouts.ReadIntervalTimeout = MAXDWORD ;
                                 timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
                                 timeouts.ReadTotalTimeoutConstant = U_PORT_UART_READ_TIMEOUT_MS;
                                 if (SetCommTimeouts(pUartData->windowsUartHandle, &timeouts)) {
-                                    // Create an event that lets us know the WaitCom event
-                                    // thread is ready
-                                    pUartData->waitCommEventThreadReadyHandle = CreateEvent(NULL, true,
-                                                                                            false, NULL);
-                                    if (pUartData->waitCommEventThreadReadyHandle != INVALID_HANDLE_VALUE) {
-                                        // Create an event that can terminate our WaitCom event thread
-                                        pUartData->waitCommEventThreadTerminateHandle = CreateEvent(NULL,
-                                                                                                    true,
-                                                                                                    false,
-                                                                                                    NULL);
-                                        if (pUartData->waitCommEventThreadTerminateHandle != INVALID_HANDLE_VALUE) {
-                                            // Now mask-in the receive event flag as that's the only
-                                            // one we support/care about
-                                            if (SetCommMask(pUartData->windowsUartHandle, EV_RXCHAR)) {
-                                                // ...then create the WaitCom thread
-                                                pUartData->waitCommEventThreadHandle = CreateThread(NULL, 0,
-                                                                                                    (LPTHREAD_START_ROUTINE) waitCommEventThread,
-                                                                                                    (PVOID) pUartData->uartHandle,
-                                                                                                    0, NULL);
-                                                if (pUartData->waitCommEventThreadHandle != INVALID_HANDLE_VALUE) {
-                                                    U_ATOMIC_INCREMENT(&gResourceAllocCount);
-                                                    // Done!
-                                                    handleOrErrorCode = pUartData->uartHandle;
-                                                }
-                                            }
-                                        }
+                                    // Create the event that the read completion
+                                    // thread sets when it has finished with us
+                                    pUartData->readStoppedHandle = CreateEvent(NULL, true,
+                                                                               false, NULL);
+                                    if ((pUartData->readStoppedHandle != NULL) &&
+                                        (CreateIoCompletionPort(pUartData->windowsUartHandle,
+                                                                gCompletionPort,
+                                                                (ULONG_PTR) pUartData, 0) != NULL)) {
+                                        // Start the first read: from here on
+                                        // reads are restarted by the read
+                                        // completion thread
+                                        readStart(pUartData);
+                                        U_ATOMIC_INCREMENT(&gResourceAllocCount);
+                                        // Done!
+                                        handleOrErrorCode = pUartData->uartHandle;
                                     }
                                 }
                             }
@@ -660,13 +667,11 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                 }
 
                 if (handleOrErrorCode < 0) {
-                    // Clean up
-                    if (pUartData->waitCommEventThreadHandle != INVALID_HANDLE_VALUE) {
-                        SetEvent(pUartData->waitCommEventThreadTerminateHandle);
-                        WaitForSingleObject(pUartData->waitCommEventThreadHandle, INFINITE);
+                    // Clean up: nothing can have been posted to the
+                    // completion port for this UART yet
+                    if (pUartData->readStoppedHandle != NULL) {
+                        CloseHandle(pUartData->readStoppedHandle);
                     }
-                    CloseHandle(pUartData->waitCommEventThreadReadyHandle);
-                    CloseHandle(pUartData->waitCommEventThreadTerminateHandle);
                     CloseHandle(pUartData->windowsUartHandle);
                     if (pUartData->rxBufferIsMalloced) {
                         uPortFree(pUartData->pRxBufferStart);
@@ -679,11 +684,6 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
         U_PORT_MUTEX_UNLOCK(gMutex);
     }
 
-    if (handleOrErrorCode >= 0) {
-        // Wait for the WaitCom thread to be ready before continuing
-        WaitForSingleObject(pUartData->waitCommEventThreadReadyHandle, INFINITE);
-    }
-
     return (int32_t) handleOrErrorCode;
 }
 
@@ -812,6 +812,18 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
                     pUartData->pRxBufferRead += thisSize;
                 }
             }
+            if ((sizeOrErrorCode > 0) && pUartData->rxBufferFull) {
+                // Reading had stopped for lack of room, kick
+                // the read completion thread to start again
+                pUartData->rxBufferFull = false;
+                if (pUartData->rxStalled) {
+                    pUartData->rxStalled = false;
+                    pUartData->stats.bufferFullTimeMs += uPortGetTickTimeMs() -
+                                                         pUartData->bufferFullStartMs;
+                }
+                PostQueuedCompletionStatus(gCompletionPort, 0,
+                                           (ULONG_PTR) pUartData, NULL);
+            }
         }
 
         U_PORT_MUTEX_UNLOCK(gMutex);
@@ -820,6 +832,22 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     return (int32_t) sizeOrErrorCode;
 }
 
+// Get a pointer to the received data: not supported.
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    (void) handle;
+    (void) ppData;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// Remove data obtained with uPortUartReadSpan(): not supported.
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    (void) handle;
+    (void) sizeBytes;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
 // Write to the given UART interface.
 int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
                        size_t sizeBytes)
@@ -841,12 +869,75 @@ int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
             memset(&overlap, 0, sizeof(overlap));
             overlap.hEvent = CreateEvent(NULL, true, false, NULL);
             if (overlap.hEvent != INVALID_HANDLE_VALUE) {
+                // Setting the low bit of the event handle stops the
+                // write completing to gCompletionPort
+                overlap.hEvent = (HANDLE) ((ULONG_PTR) overlap.hEvent | 1);
                 if (WriteFile(pUartData->windowsUartHandle, pBuffer,
                               sizeBytes, &bytesWritten, &overlap) ||
                     ((GetLastError() == ERROR_IO_PENDING) &&
                      GetOverlappedResult(pUartData->windowsUartHandle,
                                          &overlap, &bytesWritten, true))) {
                     sizeOrErrorCode = (int32_t) bytesWritten;
+                    pUartData->stats.bytesSent += bytesWritten;
+                }
+            }
+
+            CloseHandle(overlap.hEvent);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
+// Write several buffers to the given UART interface.
+int32_t uPortUartWriteVec(int32_t handle, const uPortUartIoVec_t *pVec,
+                          size_t count)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    OVERLAPPED overlap;
+    DWORD bytesWritten;
+    bool allSent = true;
+    uPortUartData_t *pUartData;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pUartData = pUartGetByHandle(handle);
+        if (((pVec != NULL) || (count == 0)) &&
+            (pUartData != NULL) && !pUartData->markedForDeletion) {
+            sizeOrErrorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+            memset(&overlap, 0, sizeof(overlap));
+            overlap.hEvent = CreateEvent(NULL, true, false, NULL);
+            if (overlap.hEvent != INVALID_HANDLE_VALUE) {
+                // Setting the low bit of the event handle stops the
+                // write completing to gCompletionPort
+                overlap.hEvent = (HANDLE) ((ULONG_PTR) overlap.hEvent | 1);
+                // WriteFileGather() is only for files opened without
+                // buffering, hence the buffers are written one after
+                // the other, with the mutex held throughout so that
+                // nothing can get in between them
+                sizeOrErrorCode = 0;
+                for (size_t x = 0; (x < count) && allSent; x++) {
+                    if (pVec[x].sizeBytes > 0) {
+                        bytesWritten = 0;
+                        allSent = false;
+                        ResetEvent(overlap.hEvent);
+                        if (WriteFile(pUartData->windowsUartHandle, pVec[x].pBuffer,
+                                      pVec[x].sizeBytes, &bytesWritten, &overlap) ||
+                            ((GetLastError() == ERROR_IO_PENDING) &&
+                             GetOverlappedResult(pUartData->windowsUartHandle,
+                                                 &overlap, &bytesWritten, true))) {
+                            sizeOrErrorCode += (int32_t) bytesWritten;
+                            pUartData->stats.bytesSent += bytesWritten;
+                            allSent = (bytesWritten == pVec[x].sizeBytes);
+                        } else if (sizeOrErrorCode == 0) {
+                            sizeOrErrorCode = (int32_t) U_ERROR_COMMON_PLATFORM;
+                        }
+                    }
                 }
             }
 
@@ -891,6 +982,7 @@ int32_t uPortUartEventCallbackSet(int32_t handle,
                                             priority,
                                             U_PORT_UART_EVENT_QUEUE_SIZE);
             if (errorCode >= 0) {
+                pUartData->eventPending = false;
                 pUartData->eventQueueHandle = (int32_t) errorCode;
                 pUartData->eventFilter = filter;
                 pUartData->pEventCallback = pFunction;
@@ -1005,6 +1097,8 @@ int32_t uPortUartEventSend(int32_t handle, uint32_t eventBitMap)
             event.eventBitMap = eventBitMap;
             event.pEventCallback = pUartData->pEventCallback;
             event.pEventCallbackParam = pUartData->pEventCallbackParam;
+            // Explicitly-sent events are not coalesced
+            event.pEventPending = NULL;
             errorCode = uPortEventQueueSend(pUartData->eventQueueHandle,
                                             &event, sizeof(event));
         }
@@ -1203,6 +1297,57 @@ void uPortUartCtsResume(int32_t handle)
     }
 }
 
+// Get the statistics of a UART.
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pUartData = pUartGetByHandle(handle);
+        if ((pStats != NULL) && (pUartData != NULL) && !pUartData->markedForDeletion) {
+            *pStats = pUartData->stats;
+            if (pUartData->rxStalled) {
+                pStats->bufferFullTimeMs += uPortGetTickTimeMs() -
+                                            pUartData->bufferFullStartMs;
+            }
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
+// Reset the statistics of a UART.
+int32_t uPortUartStatsReset(int32_t handle)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortUartData_t *pUartData;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pUartData = pUartGetByHandle(handle);
+        if ((pUartData != NULL) && !pUartData->markedForDeletion) {
+            memset(&(pUartData->stats), 0, sizeof(pUartData->stats));
+            pUartData->bufferFullStartMs = uPortGetTickTimeMs();
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
 // Get the number of UART interfaces currently open.
 int32_t uPortUartResourceAllocCount()
 {
@@ -124,6 +124,18 @@ int32_t uPortGetTickTimeMs()
     return k_uptime_get();
 }
 
+// Get the current time in microseconds.
+int64_t uPortGetTickTimeUs()
+{
+#ifdef CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER
+    return (int64_t) k_cyc_to_us_floor64(k_cycle_get_64());
+#else
+    // The 32-bit cycle counter wraps too quickly to be
+    // useful here, use the system tick instead
+    return (int64_t) k_ticks_to_us_floor64(k_uptime_ticks());
+#endif
+}
+
 // Get the minimum amount of heap free, ever, in bytes.
 int32_t uPortGetHeapMinFree()
 {
@@ -33,6 +33,8 @@
 
 #include "u_error_common.h"
 
+#include "u_port_debug.h"
+
 #include "sys/printk.h"
 
 /* ----------------------------------------------------------------
@@ -70,7 +72,9 @@ void uPortLogF(const char *pFormat, ...)
 
     if (gPortLogOn) {
         va_start(args, pFormat);
-        vprintf(pFormat, args);
+        if (!uPortLogAsyncWrite(pFormat, args)) {
+            vprintf(pFormat, args);
+        }
         va_end(args);
     }
     gStdoutCounter++;
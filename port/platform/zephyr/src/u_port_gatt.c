@@ -105,6 +105,7 @@ typedef struct {
     mtuXchangeRespCallback_t       mtuXchangeCallback;
     void                          *discoveryCallback;
     struct bt_gatt_discover_params discoverParams;
+    struct k_sem                   notifySem; // Free notification slots
 } gattConnection_t;
 
 /* ----------------------------------------------------------------
@@ -150,6 +151,8 @@ static int32_t startDiscovery(int32_t connHandle, const uPortGattUuid_t *pUuid,
                               void *callback, uint8_t type);
 static void gattXchangeMtuRsp(struct bt_conn *conn, uint8_t err,
                               struct bt_gatt_exchange_params *params);
+static struct bt_gatt_attr *pFindValueAttr(const uPortGattCharacteristic_t *pChar);
+static void notifySent(struct bt_conn *conn, void *user_data);
 
 /* ----------------------------------------------------------------
  * VARIABLES
@@ -358,6 +361,9 @@ static void gapConnected(struct bt_conn *conn, uint8_t err)
 
     if (connHandle != U_PORT_GATT_GAP_INVALID_CONNHANDLE) {
         gCurrentConnections[connHandle].pConn = conn;
+        k_sem_init(&gCurrentConnections[connHandle].notifySem,
+                   U_PORT_GATT_MAX_OUTSTANDING_NOTIFICATIONS,
+                   U_PORT_GATT_MAX_OUTSTANDING_NOTIFICATIONS);
         if (pGapConnStatusCallback != NULL) {
             pGapConnStatusCallback(connHandle, U_PORT_GATT_GAP_CONNECTED, pGapConnStatusParam);
         }
@@ -834,11 +840,99 @@ int32_t uPortGattExchangeMtu(int32_t connHandle, mtuXchangeRespCallback_t respCa
     return errorCode;
 }
 
+int32_t uPortGattRequestDataLength(int32_t connHandle, uint16_t txOctets)
+{
+    int32_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (validConnHandle(connHandle) && (txOctets >= BT_GAP_DATA_LEN_DEFAULT) &&
+        (txOctets <= BT_GAP_DATA_LEN_MAX)) {
+#ifdef CONFIG_BT_USER_DATA_LEN_UPDATE
+        struct bt_conn_le_data_len_param param;
+        param.tx_max_len = txOctets;
+        // Time to send txOctets plus overhead on the 1 Mbit/s PHY
+        param.tx_max_time = (uint16_t)((txOctets + 14) * 8);
+        errorCode = U_ERROR_COMMON_UNKNOWN;
+        if (bt_conn_le_data_len_update(gCurrentConnections[connHandle].pConn, &param) == 0) {
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+#else
+        errorCode = U_ERROR_COMMON_NOT_SUPPORTED;
+#endif
+    }
+
+    return errorCode;
+}
+
+int32_t uPortGattRequestPhy2M(int32_t connHandle)
+{
+    int32_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (validConnHandle(connHandle)) {
+#ifdef CONFIG_BT_USER_PHY_UPDATE
+        errorCode = U_ERROR_COMMON_UNKNOWN;
+        if (bt_conn_le_phy_update(gCurrentConnections[connHandle].pConn,
+                                  BT_CONN_LE_PHY_PARAM_2M) == 0) {
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+#else
+        errorCode = U_ERROR_COMMON_NOT_SUPPORTED;
+#endif
+    }
+
+    return errorCode;
+}
+
+int32_t uPortGattUpdateConnParams(int32_t connHandle,
+                                  uint16_t connIntervalMin,
+                                  uint16_t connIntervalMax,
+                                  uint16_t connLatency,
+                                  uint32_t linkLossTimeout)
+{
+    int32_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+    struct bt_le_conn_param param;
+
+    if (validConnHandle(connHandle) && (connIntervalMin <= connIntervalMax)) {
+        param.interval_min = connIntervalMin;
+        param.interval_max = connIntervalMax;
+        param.latency = connLatency;
+        // Zephyr wants the supervision timeout in units of 10 ms
+        param.timeout = (uint16_t)(linkLossTimeout / 10);
+        errorCode = U_ERROR_COMMON_UNKNOWN;
+        if (bt_conn_le_param_update(gCurrentConnections[connHandle].pConn, &param) == 0) {
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+    }
+
+    return errorCode;
+}
+
+static struct bt_gatt_attr *pFindValueAttr(const uPortGattCharacteristic_t *pChar)
+{
+    struct bt_gatt_attr *pAtt = gAttrPool;
+
+    // We are given a pointer to the porting layer characteristic struct
+    // but we need to find the corresponding zephyr attribute in the attribute pool.
+    while ((pAtt != gpNextFreeAttr) && (pAtt->user_data != &(pChar->valueAtt))) {
+        pAtt++;
+    }
+
+    return (pAtt != gpNextFreeAttr) ? pAtt : NULL;
+}
+
+// Called by Zephyr when a notification sent with
+// uPortGattNotifyNoWait() has gone, user_data is the
+// semaphore of the connection it was sent on.
+static void notifySent(struct bt_conn *conn, void *user_data)
+{
+    (void)conn;
+    k_sem_give((struct k_sem *)user_data);
+}
+
 int32_t uPortGattNotify(int32_t connHandle, const uPortGattCharacteristic_t *pChar,
                         const void *data, uint16_t len)
 {
     int32_t returnValue = U_ERROR_COMMON_UNKNOWN;
-    struct bt_gatt_attr *pAtt = gAttrPool;
+    struct bt_gatt_attr *pAtt;
 
     if (!validConnHandle(connHandle) || (pChar == NULL) || (data == NULL) || (len == 0)) {
         return U_ERROR_COMMON_INVALID_PARAMETER;
@@ -848,14 +942,69 @@ int32_t uPortGattNotify(int32_t connHandle, const uPortGattCharacteristic_t *pCh
         return returnValue;
     }
 
-    // We are given a pointer to the porting layer characteristic struct
-    // but we need to find the corresponding zephyr attribute in the attribute pool.
-    while ((pAtt != gpNextFreeAttr) && (pAtt->user_data != &(pChar->valueAtt))) {
-        pAtt++;
+    pAtt = pFindValueAttr(pChar);
+    if (pAtt != NULL) {
+        returnValue = bt_gatt_notify(gCurrentConnections[connHandle].pConn, pAtt, data, len);
     }
 
-    if (pAtt != gpNextFreeAttr) {
-        returnValue = bt_gatt_notify(gCurrentConnections[connHandle].pConn, pAtt, data, len);
+    return returnValue;
+}
+
+int32_t uPortGattNotifyNoWait(int32_t connHandle, const uPortGattCharacteristic_t *pChar,
+                              const void *data, uint16_t len)
+{
+    int32_t returnValue = U_ERROR_COMMON_UNKNOWN;
+    struct bt_gatt_notify_params params = {0};
+    gattConnection_t *pConn;
+
+    if (!validConnHandle(connHandle) || (pChar == NULL) || (data == NULL) || (len == 0)) {
+        return U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+
+    pConn = &gCurrentConnections[connHandle];
+    if (pConn->pConn == NULL) {
+        return returnValue;
+    }
+
+    params.attr = pFindValueAttr(pChar);
+    if (params.attr != NULL) {
+        // Only send if there is a free slot: that way Zephyr
+        // always has a buffer ready and bt_gatt_notify_cb() copies
+        // the data and returns without waiting, leaving it to send
+        // all the queued notifications in the next connection event
+        returnValue = U_ERROR_COMMON_BUSY;
+        if (k_sem_take(&pConn->notifySem, K_NO_WAIT) == 0) {
+            params.data = data;
+            params.len = len;
+            params.func = notifySent;
+            params.user_data = &pConn->notifySem;
+            returnValue = bt_gatt_notify_cb(pConn->pConn, &params);
+            if (returnValue != 0) {
+                k_sem_give(&pConn->notifySem);
+            }
+        }
+    }
+
+    return returnValue;
+}
+
+int32_t uPortGattNotifyWaitSlot(int32_t connHandle, int32_t timeoutMs)
+{
+    int32_t returnValue = U_ERROR_COMMON_UNKNOWN;
+    gattConnection_t *pConn;
+
+    if (!validConnHandle(connHandle) || (timeoutMs < 0)) {
+        return U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+
+    pConn = &gCurrentConnections[connHandle];
+    if (pConn->pConn != NULL) {
+        returnValue = U_ERROR_COMMON_TIMEOUT;
+        if (k_sem_take(&pConn->notifySem, K_MSEC(timeoutMs)) == 0) {
+            // Only looking: put the slot back for uPortGattNotifyNoWait()
+            k_sem_give(&pConn->notifySem);
+            returnValue = U_ERROR_COMMON_SUCCESS;
+        }
     }
 
     return returnValue;
@@ -196,6 +196,9 @@ int32_t uPortI2cInit()
             }
         }
     }
+    if (errorCode == 0) {
+        errorCode = uPortI2cAsyncInit();
+    }
 
     return errorCode;
 }
@@ -204,6 +207,8 @@ int32_t uPortI2cInit()
 void uPortI2cDeinit()
 {
     if (gMutex != NULL) {
+        // Stop asynchronous transactions first, they need the I2C instances
+        uPortI2cAsyncDeinit();
         // Zephyr doesn't have an I2C deinitialisation
         // API so nothing in particular to do here
         // aside from free the mutex
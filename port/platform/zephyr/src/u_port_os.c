@@ -92,6 +92,19 @@ exe_chunk_0[U_CFG_OS_EXECUTABLE_CHUNK_INDEX_0_SIZE];
 K_MEM_PARTITION_DEFINE(chunk0_reloc, exe_chunk_0, sizeof(exe_chunk_0),
                        K_MEM_PARTITION_P_RWX_U_RWX);
 #endif
+
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+/** The total number of statically allocated task stacks.
+ */
+# define U_PORT_OS_STATIC_NUM_TASKS (U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM + \
+                                     U_PORT_OS_STATIC_TASK_STACK_LARGE_NUM)
+
+/** The total number of statically allocated queues.
+ */
+# define U_PORT_OS_STATIC_NUM_QUEUES (U_PORT_OS_STATIC_QUEUE_SMALL_NUM + \
+                                      U_PORT_OS_STATIC_QUEUE_LARGE_NUM)
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -102,6 +115,9 @@ typedef struct {
     void *pStackAllocation;
     size_t stackSize;
     bool isAllocated;
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+    int32_t staticStackSlot;
+#endif
 } uPortOsThreadInstance_t;
 /* ----------------------------------------------------------------
  * VARIABLES
@@ -115,10 +131,96 @@ static uPortOsThreadInstance_t gThreadInstances[U_CFG_OS_MAX_THREADS];
  */
 static volatile int32_t gResourceAllocCount = 0;
 
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+
+/** Lock protecting the in-use flags of the static tables.
+ */
+static struct k_spinlock gStaticLock;
+
+/** The thread objects, one for each entry in gThreadInstances[].
+ */
+static struct k_thread gStaticThread[U_CFG_OS_MAX_THREADS];
+
+/** Task stacks: stack slots less than U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM
+ * are the small ones.
+ */
+static K_KERNEL_STACK_ARRAY_DEFINE(gStaticStackSmall, U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM,
+                                   U_PORT_OS_STATIC_TASK_STACK_SMALL_SIZE_BYTES);
+static K_KERNEL_STACK_ARRAY_DEFINE(gStaticStackLarge, U_PORT_OS_STATIC_TASK_STACK_LARGE_NUM,
+                                   U_PORT_OS_STATIC_TASK_STACK_LARGE_SIZE_BYTES);
+static volatile bool gStaticStackInUse[U_PORT_OS_STATIC_NUM_TASKS];
+
+/** Queues: the first U_PORT_OS_STATIC_QUEUE_SMALL_NUM slots of
+ * gStaticQueue[] use the small storage.
+ */
+static struct k_msgq gStaticQueue[U_PORT_OS_STATIC_NUM_QUEUES];
+static volatile bool gStaticQueueInUse[U_PORT_OS_STATIC_NUM_QUEUES];
+static char __aligned(4) gStaticQueueStorageSmall[U_PORT_OS_STATIC_QUEUE_SMALL_NUM]
+[U_PORT_OS_STATIC_QUEUE_SMALL_SIZE_BYTES];
+static char __aligned(4) gStaticQueueStorageLarge[U_PORT_OS_STATIC_QUEUE_LARGE_NUM]
+[U_PORT_OS_STATIC_QUEUE_LARGE_SIZE_BYTES];
+
+/** Mutexes.
+ */
+static struct k_mutex gStaticMutex[U_PORT_OS_STATIC_NUM_MUTEXES];
+static volatile bool gStaticMutexInUse[U_PORT_OS_STATIC_NUM_MUTEXES];
+
+/** Semaphores.
+ */
+static struct k_sem gStaticSemaphore[U_PORT_OS_STATIC_NUM_SEMAPHORES];
+static volatile bool gStaticSemaphoreInUse[U_PORT_OS_STATIC_NUM_SEMAPHORES];
+
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
 
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+
+// Take the first free slot from a static table whose storage is at
+// least sizeBytes, where the first numSmall slots have smallSizeBytes
+// of storage and the rest largeSizeBytes; returns the index of the
+// slot or -1 if there is none.
+static int32_t staticSlotTake(volatile bool *pInUse, size_t numSlots,
+                              size_t numSmall, size_t smallSizeBytes,
+                              size_t largeSizeBytes, size_t sizeBytes)
+{
+    int32_t index = -1;
+    size_t slotSizeBytes;
+    k_spinlock_key_t key = k_spin_lock(&gStaticLock);
+
+    for (size_t x = 0; (x < numSlots) && (index < 0); x++) {
+        slotSizeBytes = (x < numSmall) ? smallSizeBytes : largeSizeBytes;
+        if (!pInUse[x] && (sizeBytes <= slotSizeBytes)) {
+            pInUse[x] = true;
+            index = (int32_t) x;
+        }
+    }
+
+    k_spin_unlock(&gStaticLock, key);
+
+    return index;
+}
+
+// Return the slot of a static table that a handle points into, or -1
+// if the handle is not from that table.
+static int32_t staticSlotFind(const void *pHandle, const void *pTable,
+                              size_t numSlots, size_t slotSizeBytes)
+{
+    int32_t index = -1;
+    const uint8_t *pStart = (const uint8_t *) pTable;
+    const uint8_t *p = (const uint8_t *) pHandle;
+
+    if ((p >= pStart) && (p < pStart + (numSlots * slotSizeBytes))) {
+        index = (int32_t) ((size_t) (p - pStart) / slotSizeBytes);
+    }
+
+    return index;
+}
+
+#endif
+
 static uPortOsThreadInstance_t *getNewThreadInstance(size_t stackSizeBytes)
 {
     uPortOsThreadInstance_t *threadPtr = NULL;
@@ -126,6 +228,30 @@ static uPortOsThreadInstance_t *getNewThreadInstance(size_t stackSizeBytes)
     for (i = 0; i < U_CFG_OS_MAX_THREADS; i++) {
         if (!gThreadInstances[i].isAllocated) {
             threadPtr = &gThreadInstances[i];
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+            // The thread object belongs to this instance, the stack
+            // is the smallest free one that will do
+            int32_t slot = staticSlotTake(gStaticStackInUse, U_PORT_OS_STATIC_NUM_TASKS,
+                                          U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM,
+                                          K_KERNEL_STACK_SIZEOF(gStaticStackSmall[0]),
+                                          K_KERNEL_STACK_SIZEOF(gStaticStackLarge[0]),
+                                          stackSizeBytes);
+            threadPtr->pThread = NULL;
+            threadPtr->pStack = NULL;
+            if (slot >= 0) {
+                threadPtr->pThread = &gStaticThread[i];
+                if (slot < U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM) {
+                    threadPtr->pStack = gStaticStackSmall[slot];
+                    threadPtr->stackSize = K_KERNEL_STACK_SIZEOF(gStaticStackSmall[0]);
+                } else {
+                    threadPtr->pStack = gStaticStackLarge[slot - U_PORT_OS_STATIC_TASK_STACK_SMALL_NUM];
+                    threadPtr->stackSize = K_KERNEL_STACK_SIZEOF(gStaticStackLarge[0]);
+                }
+                threadPtr->staticStackSlot = slot;
+                memset(threadPtr->pThread, 0, sizeof(struct k_thread));
+                threadPtr->isAllocated = true;
+            }
+#else
             //Free if previously used instance
             if (threadPtr->stackSize > 0) {
                 k_free(threadPtr->pThread);
@@ -170,6 +296,7 @@ static uPortOsThreadInstance_t *getNewThreadInstance(size_t stackSizeBytes)
                 threadPtr->stackSize = stackSizeBytes;
                 threadPtr->isAllocated = true;
             }
+#endif
             break;
         }
     }
@@ -177,10 +304,12 @@ static uPortOsThreadInstance_t *getNewThreadInstance(size_t stackSizeBytes)
         uPortLogF("No more threads available in thread pool, please increase U_CFG_OS_MAX_THREADS\n");
     } else if (threadPtr->pThread == NULL || threadPtr->pStack == NULL) {
         uPortLogF("Unable to allocate memory for thread with stack size %d\n", stackSizeBytes);
+#ifndef U_PORT_OS_STATIC_ALLOCATION
         k_free(threadPtr->pThread);
         k_free(threadPtr->pStackAllocation);
         threadPtr->pThread = NULL;
         threadPtr->pStackAllocation = NULL;
+#endif
         threadPtr = NULL;
     }
     return threadPtr;
@@ -191,6 +320,12 @@ static void freeThreadInstance(struct k_thread *threadPtr)
     int32_t i = 0;
     for (i = 0; i < U_CFG_OS_MAX_THREADS; i++) {
         if (threadPtr == gThreadInstances[i].pThread ) {
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+            // Fine to do this before the thread has been aborted
+            // since ubxlib threads are cooperative: nothing else
+            // can run and pick up the stack until then
+            gStaticStackInUse[gThreadInstances[i].staticStackSlot] = false;
+#endif
             gThreadInstances[i].isAllocated = false;
             break;
         }
@@ -222,9 +357,11 @@ void uPortOsPrivateDeinit()
     int32_t i = 0;
     for (i = 0; i < U_CFG_OS_MAX_THREADS; i++) {
         if (gThreadInstances[i].stackSize > 0) {
+#ifndef U_PORT_OS_STATIC_ALLOCATION
             k_free(gThreadInstances[i].pThread);
-            gThreadInstances[i].pThread = NULL;
             k_free(gThreadInstances[i].pStackAllocation);
+#endif
+            gThreadInstances[i].pThread = NULL;
             gThreadInstances[i].pStackAllocation = NULL;
             gThreadInstances[i].pStack = NULL;
             gThreadInstances[i].stackSize = 0;
@@ -325,6 +462,43 @@ int32_t uPortTaskStackMinFree(const uPortTaskHandle_t taskHandle)
     return result;
 }
 
+// Get information about all of the tasks; gThreadInstances[] is
+// the record of the ones ubxlib created.
+int32_t uPortTaskInfoGet(uPortTaskInfo_t *pInfo, size_t maxNum)
+{
+    int32_t numTasks = 0;
+    struct k_thread *pThread;
+    const char *pName;
+
+    k_sched_lock();
+    for (size_t x = 0; x < U_CFG_OS_MAX_THREADS; x++) {
+        if (gThreadInstances[x].isAllocated) {
+            if ((pInfo != NULL) && ((size_t) numTasks < maxNum)) {
+                pThread = gThreadInstances[x].pThread;
+                pInfo->handle = (uPortTaskHandle_t) pThread;
+                memset(pInfo->name, 0, sizeof(pInfo->name));
+                pName = k_thread_name_get(pThread);
+                if (pName != NULL) {
+                    strncpy(pInfo->name, pName, sizeof(pInfo->name) - 1);
+                }
+                pInfo->stackMinFreeBytes = uPortTaskStackMinFree(pThread);
+                pInfo->cpuTimeUs = (int64_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#ifdef CONFIG_THREAD_RUNTIME_STATS
+                k_thread_runtime_stats_t stats;
+                if (k_thread_runtime_stats_get(pThread, &stats) == 0) {
+                    pInfo->cpuTimeUs = (int64_t) k_cyc_to_us_floor64(stats.execution_cycles);
+                }
+#endif
+                pInfo++;
+            }
+            numTasks++;
+        }
+    }
+    k_sched_unlock();
+
+    return numTasks;
+}
+
 // Get the current task handle.
 int32_t uPortTaskGetHandle(uPortTaskHandle_t *pTaskHandle)
 {
@@ -352,6 +526,27 @@ int32_t uPortQueueCreate(size_t queueLength,
     if (pQueueHandle != NULL) {
         errorCode = U_ERROR_COMMON_NO_MEMORY;
         // Actually create the queue
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        int32_t slot = staticSlotTake(gStaticQueueInUse, U_PORT_OS_STATIC_NUM_QUEUES,
+                                      U_PORT_OS_STATIC_QUEUE_SMALL_NUM,
+                                      U_PORT_OS_STATIC_QUEUE_SMALL_SIZE_BYTES,
+                                      U_PORT_OS_STATIC_QUEUE_LARGE_SIZE_BYTES,
+                                      queueLength * itemSizeBytes);
+        if (slot >= 0) {
+            struct k_msgq *pMsgQ = &(gStaticQueue[slot]);
+            char *pStorage = gStaticQueueStorageSmall[0];
+            if (slot < U_PORT_OS_STATIC_QUEUE_SMALL_NUM) {
+                pStorage = gStaticQueueStorageSmall[slot];
+            } else {
+                pStorage = gStaticQueueStorageLarge[slot - U_PORT_OS_STATIC_QUEUE_SMALL_NUM];
+            }
+            k_msgq_init(pMsgQ, pStorage, itemSizeBytes, queueLength);
+            *pQueueHandle = (uPortQueueHandle_t) pMsgQ;
+            errorCode = U_ERROR_COMMON_SUCCESS;
+            U_ATOMIC_INCREMENT(&gResourceAllocCount);
+            U_PORT_OS_DEBUG_PRINT_QUEUE_CREATE(*pQueueHandle, queueLength, itemSizeBytes);
+        }
+#else
         struct k_msgq *pMsgQ = (struct k_msgq *) k_malloc(sizeof(struct k_msgq));
         if (pMsgQ != NULL) {
             if (k_msgq_alloc_init(pMsgQ, itemSizeBytes, queueLength) == 0) {
@@ -361,6 +556,7 @@ int32_t uPortQueueCreate(size_t queueLength,
                 U_PORT_OS_DEBUG_PRINT_QUEUE_CREATE(*pQueueHandle, queueLength, itemSizeBytes);
             }
         }
+#endif
     }
 
     return (int32_t) errorCode;
@@ -376,7 +572,15 @@ int32_t uPortQueueDelete(const uPortQueueHandle_t queueHandle)
         errorCode = U_ERROR_COMMON_PLATFORM;
         k_msgq_purge(pMsgQ);
         if (0 == k_msgq_cleanup(pMsgQ)) {
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+            int32_t slot = staticSlotFind(pMsgQ, gStaticQueue, U_PORT_OS_STATIC_NUM_QUEUES,
+                                          sizeof(gStaticQueue[0]));
+            if (slot >= 0) {
+                gStaticQueueInUse[slot] = false;
+            }
+#else
             k_free(pMsgQ);
+#endif
             errorCode = U_ERROR_COMMON_SUCCESS;
             U_ATOMIC_DECREMENT(&gResourceAllocCount);
             U_PORT_OS_DEBUG_PRINT_QUEUE_DELETE(queueHandle);
@@ -521,7 +725,16 @@ int32_t MTX_FN(uPortMutexCreate(uPortMutexHandle_t *pMutexHandle))
     if (pMutexHandle != NULL) {
         errorCode = U_ERROR_COMMON_NO_MEMORY;
         // Actually create the mutex
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        *pMutexHandle = NULL;
+        int32_t slot = staticSlotTake(gStaticMutexInUse, U_PORT_OS_STATIC_NUM_MUTEXES,
+                                      U_PORT_OS_STATIC_NUM_MUTEXES, 0, 0, 0);
+        if (slot >= 0) {
+            *pMutexHandle = (uPortMutexHandle_t) &(gStaticMutex[slot]);
+        }
+#else
         *pMutexHandle = (uPortMutexHandle_t) k_malloc(sizeof(struct k_mutex));
+#endif
         if (*pMutexHandle != NULL) {
             errorCode = U_ERROR_COMMON_PLATFORM;
             if (0 == k_mutex_init((struct k_mutex *)*pMutexHandle)) {
@@ -541,7 +754,15 @@ int32_t MTX_FN(uPortMutexDelete(const uPortMutexHandle_t mutexHandle))
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
 
     if (mutexHandle != NULL) {
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        int32_t slot = staticSlotFind(mutexHandle, gStaticMutex, U_PORT_OS_STATIC_NUM_MUTEXES,
+                                      sizeof(gStaticMutex[0]));
+        if (slot >= 0) {
+            gStaticMutexInUse[slot] = false;
+        }
+#else
         k_free((struct k_mutex *) mutexHandle);
+#endif
         errorCode = U_ERROR_COMMON_SUCCESS;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_MUTEX_DELETE(mutexHandle);
@@ -614,7 +835,16 @@ int32_t uPortSemaphoreCreate(uPortSemaphoreHandle_t *pSemaphoreHandle,
     if ((pSemaphoreHandle != NULL) && (limit != 0) && (initialCount <= limit)) {
         errorCode = U_ERROR_COMMON_NO_MEMORY;
         // Actually create the semaphore
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        *pSemaphoreHandle = NULL;
+        int32_t slot = staticSlotTake(gStaticSemaphoreInUse, U_PORT_OS_STATIC_NUM_SEMAPHORES,
+                                      U_PORT_OS_STATIC_NUM_SEMAPHORES, 0, 0, 0);
+        if (slot >= 0) {
+            *pSemaphoreHandle = (uPortSemaphoreHandle_t) &(gStaticSemaphore[slot]);
+        }
+#else
         *pSemaphoreHandle = (uPortSemaphoreHandle_t) k_malloc(sizeof(struct k_sem));
+#endif
         if (*pSemaphoreHandle != NULL) {
             errorCode = U_ERROR_COMMON_PLATFORM;
             if (0 == k_sem_init((struct k_sem *)*pSemaphoreHandle, initialCount, limit)) {
@@ -634,7 +864,16 @@ int32_t uPortSemaphoreDelete(const uPortSemaphoreHandle_t semaphoreHandle)
     uErrorCode_t errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
 
     if (semaphoreHandle != NULL) {
+#ifdef U_PORT_OS_STATIC_ALLOCATION
+        int32_t slot = staticSlotFind(semaphoreHandle, gStaticSemaphore,
+                                      U_PORT_OS_STATIC_NUM_SEMAPHORES,
+                                      sizeof(gStaticSemaphore[0]));
+        if (slot >= 0) {
+            gStaticSemaphoreInUse[slot] = false;
+        }
+#else
         k_free((struct k_sem *) semaphoreHandle);
+#endif
         errorCode = U_ERROR_COMMON_SUCCESS;
         U_ATOMIC_DECREMENT(&gResourceAllocCount);
         U_PORT_OS_DEBUG_PRINT_SEMAPHORE_DELETE(semaphoreHandle);
@@ -32,12 +32,14 @@
 #include "stdbool.h"
 #include "string.h"
 
+#include "u_cfg_os_platform_specific.h" // U_CFG_OS_PRIORITY_MAX
 #include "u_compiler.h" // U_ATOMIC_XXX() macros
 
 #include "u_error_common.h"
 
 #include "u_port.h"
 #include "u_port_os.h"
+#include "u_port_heap.h"
 #include "u_port_gpio.h"
 #include "u_port_spi.h"
 #include "u_port_private.h"
@@ -77,12 +79,26 @@
  * TYPES
  * -------------------------------------------------------------- */
 
+/** Structure to keep track of background reception.
+ */
+typedef struct {
+    int32_t handle;
+    char *pBuffer;
+    size_t bufferSizeBytes;
+    int32_t intervalMs;
+    uPortSpiReceiveCallback_t *pCallback;
+    void *pCallbackParam;
+    uPortSemaphoreHandle_t exitedSemaphore;
+    volatile bool stop;
+} uPortSpiReceiveAsync_t;
+
 /** Structure of the things we need to keep track of per SPI interface.
  */
 typedef struct {
     const struct device *pDevice;  // NULL if not in use
     struct spi_config spiConfig;
     struct spi_cs_control spiCsControl;
+    uPortSpiReceiveAsync_t *pReceiveAsync; // NULL if there is no background reception
 } uPortSpiCfg_t;
 
 /* ----------------------------------------------------------------
@@ -373,6 +389,64 @@ static int32_t setSpiConfig(int32_t spi, uPortSpiCfg_t *pSpiCfg,
     return (int32_t) errorCode;
 }
 
+// The task that runs background reception: each transfer is handed
+// to the SPI driver, which is interrupt or DMA driven, with gMutex
+// locked, so that blocking transfers are held off, and the buffer is
+// passed to the callback with gMutex unlocked.
+static void receiveAsyncTask(void *pParam)
+{
+    uPortSpiReceiveAsync_t *pReceiveAsync = (uPortSpiReceiveAsync_t *) pParam;
+    uPortSpiCfg_t *pSpiCfg = &(gSpiCfg[pReceiveAsync->handle]);
+    uPortSemaphoreHandle_t exitedSemaphore = pReceiveAsync->exitedSemaphore;
+    struct spi_buf receiveBuffer;
+    struct spi_buf_set receiveBufferList;
+    char *pReceive;
+    size_t index = 0;
+    int32_t startTimeMs;
+    int32_t waitMs;
+    int32_t errorCode;
+
+    receiveBufferList.buffers = &receiveBuffer;
+    receiveBufferList.count = 1;
+    while (!pReceiveAsync->stop) {
+        startTimeMs = uPortGetTickTimeMs();
+        pReceive = pReceiveAsync->pBuffer + (index * pReceiveAsync->bufferSizeBytes);
+        errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        if (pSpiCfg->pDevice != NULL) {
+            receiveBuffer.buf = pReceive;
+            receiveBuffer.len = pReceiveAsync->bufferSizeBytes;
+            // No send buffer: the driver clocks out its fill
+            errorCode = spi_transceive(pSpiCfg->pDevice, &(pSpiCfg->spiConfig),
+                                       NULL, &receiveBufferList);
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+
+        if (errorCode == 0) {
+            pReceiveAsync->pCallback(pReceiveAsync->handle, pReceive,
+                                     pReceiveAsync->bufferSizeBytes,
+                                     pReceiveAsync->pCallbackParam);
+            // The other buffer is filled next
+            index = (index + 1) & 1;
+        }
+
+        waitMs = pReceiveAsync->intervalMs - (uPortGetTickTimeMs() - startTimeMs);
+        if (waitMs < U_CFG_OS_YIELD_MS) {
+            // Always give others a chance
+            waitMs = U_CFG_OS_YIELD_MS;
+        }
+        uPortTaskBlock(waitMs);
+    }
+
+    // pReceiveAsync may be free'd as soon as this is given
+    uPortSemaphoreGive(exitedSemaphore);
+
+    uPortTaskDelete(NULL);
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -387,6 +461,7 @@ int32_t uPortSpiInit()
         if (errorCode == 0) {
             for (size_t x = 0; x < sizeof(gSpiCfg) / sizeof(gSpiCfg[0]); x++) {
                 gSpiCfg[x].pDevice = NULL;
+                gSpiCfg[x].pReceiveAsync = NULL;
             }
         }
     }
@@ -696,6 +771,90 @@ int32_t uPortSpiControllerSendReceiveBlock(int32_t handle, const char *pSend,
     return errorCodeOrReceiveSize;
 }
 
+// Start background reception.
+int32_t uPortSpiControllerReceiveAsyncStart(int32_t handle, char *pBuffer,
+                                            size_t bufferSizeBytes,
+                                            int32_t intervalMs,
+                                            uPortSpiReceiveCallback_t *pCallback,
+                                            void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortSpiReceiveAsync_t *pReceiveAsync;
+    uPortTaskHandle_t taskHandle;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) && (handle < sizeof(gSpiCfg) / sizeof(gSpiCfg[0])) &&
+            (gSpiCfg[handle].pDevice != NULL) && (gSpiCfg[handle].pReceiveAsync == NULL) &&
+            (pBuffer != NULL) && (bufferSizeBytes > 0) && (intervalMs >= 0) &&
+            (pCallback != NULL)) {
+            errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+            pReceiveAsync = (uPortSpiReceiveAsync_t *) pUPortMalloc(sizeof(*pReceiveAsync));
+            if (pReceiveAsync != NULL) {
+                memset(pReceiveAsync, 0, sizeof(*pReceiveAsync));
+                pReceiveAsync->handle = handle;
+                pReceiveAsync->pBuffer = pBuffer;
+                pReceiveAsync->bufferSizeBytes = bufferSizeBytes;
+                pReceiveAsync->intervalMs = intervalMs;
+                pReceiveAsync->pCallback = pCallback;
+                pReceiveAsync->pCallbackParam = pCallbackParam;
+                errorCode = uPortSemaphoreCreate(&(pReceiveAsync->exitedSemaphore), 0, 1);
+                if (errorCode == 0) {
+                    errorCode = uPortTaskCreate(receiveAsyncTask, "spiReceiveAsync",
+                                                U_PORT_SPI_RECEIVE_ASYNC_TASK_STACK_SIZE_BYTES,
+                                                (void *) pReceiveAsync,
+                                                U_PORT_SPI_RECEIVE_ASYNC_TASK_PRIORITY,
+                                                &taskHandle);
+                    if (errorCode == 0) {
+                        gSpiCfg[handle].pReceiveAsync = pReceiveAsync;
+                    } else {
+                        uPortSemaphoreDelete(pReceiveAsync->exitedSemaphore);
+                    }
+                }
+                if (errorCode != 0) {
+                    // Clean up on error
+                    uPortFree(pReceiveAsync);
+                }
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
+// Stop background reception.
+void uPortSpiControllerReceiveAsyncStop(int32_t handle)
+{
+    uPortSpiReceiveAsync_t *pReceiveAsync = NULL;
+
+    if ((gMutex != NULL) && (handle >= 0) &&
+        (handle < sizeof(gSpiCfg) / sizeof(gSpiCfg[0]))) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        pReceiveAsync = gSpiCfg[handle].pReceiveAsync;
+        gSpiCfg[handle].pReceiveAsync = NULL;
+        if (pReceiveAsync != NULL) {
+            pReceiveAsync->stop = true;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+
+        if (pReceiveAsync != NULL) {
+            // Wait for the task to exit, with gMutex unlocked since
+            // the task may need it in order to get there
+            uPortSemaphoreTake(pReceiveAsync->exitedSemaphore);
+            uPortSemaphoreDelete(pReceiveAsync->exitedSemaphore);
+            uPortFree(pReceiveAsync);
+        }
+    }
+}
+
 // Get the number of SPI interfaces currently open.
 int32_t uPortSpiResourceAllocCount()
 {
@@ -77,6 +77,7 @@ typedef struct {
     struct uart_config config;
     int32_t eventQueueHandle;
     uint32_t eventFilter;
+    volatile bool eventPending; /**< a data received event is queued but not yet handled. */
     void (*pEventCallback)(int32_t, uint32_t, void *);
     void *pEventCallbackParam;
     char *pBuffer;
@@ -84,6 +85,8 @@ typedef struct {
     uint32_t bufferRead;
     int32_t bufferWrite;
     bool bufferFull;
+    int32_t bufferFullStartMs;
+    uPortUartStats_t stats; /**< Mostly written in interrupt context. */
     struct k_timer rxTimer;
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
     struct uartData_t *pTxData;
@@ -138,6 +141,9 @@ static void eventHandler(void *pParam, size_t paramLength)
 
     if ((pEvent->uartHandle >= 0) &&
         (pEvent->uartHandle < sizeof(gUartData) / sizeof(gUartData[0]))) {
+        // Clear this before calling the callback so that data
+        // arriving while the callback is running raises a new event
+        gUartData[pEvent->uartHandle].eventPending = false;
         if (gUartData[pEvent->uartHandle].pEventCallback != NULL) {
             gUartData[pEvent->uartHandle].pEventCallback(pEvent->uartHandle,
                                                          pEvent->eventBitMap,
@@ -173,20 +179,112 @@ static void uartClose(int32_t handle)
     U_ATOMIC_DECREMENT(&gResourceAllocCount);
 }
 
-static void rxTimer(struct k_timer *timer_id)
+// Note that the receive buffer of a UART has become full; called
+// in interrupt context.
+static void bufferFullStartIrq(uPortUartData_t *pUartData)
 {
-    uint32_t uart = (uint32_t)(timer_id->user_data);
+    pUartData->bufferFull = true;
+    pUartData->stats.bufferFullCount++;
+    pUartData->bufferFullStartMs = uPortGetTickTimeMs();
+}
+
+// Note that there is space in the receive buffer of a UART again.
+// Note: gMutex should be locked before this is called.
+static void bufferFullEnd(uPortUartData_t *pUartData)
+{
+    if (pUartData->bufferFull) {
+        pUartData->bufferFull = false;
+        pUartData->stats.bufferFullTimeMs += uPortGetTickTimeMs() -
+                                             pUartData->bufferFullStartMs;
+    }
+}
+
+// Count any errors the driver has seen on a UART; called in
+// interrupt context.  Drivers which don't support error
+// checking return a negative value, in which case the counts
+// stay at zero.
+static void errorCheckIrq(uPortUartData_t *pUartData)
+{
+    int errors = uart_err_check(pUartData->pDevice);
+
+    if (errors > 0) {
+        if (errors & UART_ERROR_OVERRUN) {
+            pUartData->stats.overrunCount++;
+        }
+        if (errors & UART_ERROR_FRAMING) {
+            pUartData->stats.framingErrorCount++;
+        }
+        if (errors & UART_ERROR_PARITY) {
+            pUartData->stats.parityErrorCount++;
+        }
+    }
+}
+
+// Get the number of received bytes that are contiguous in the
+// buffer of a UART, starting at the read position; the receive
+// interrupt only ever writes outside of this span.
+// Note: gMutex should be locked before this is called.
+static size_t rxSpan(int32_t handle)
+{
+    uPortUartData_t *pUartData = &(gUartData[handle]);
+    int32_t bufferWrite = pUartData->bufferWrite;
+    size_t span = 0;
+
+    if (pUartData->bufferFull || (bufferWrite < (int32_t) pUartData->bufferRead)) {
+        // Up to the end of the buffer, the rest is at the start
+        span = pUartData->receiveBufferSizeBytes - pUartData->bufferRead;
+    } else {
+        span = bufferWrite - pUartData->bufferRead;
+    }
+
+    return span;
+}
+
+// Move the read position of the buffer of a UART on by sizeBytes,
+// which must be no more than rxSpan() returns.
+// Note: gMutex should be locked before this is called.
+static void rxConsume(int32_t handle, size_t sizeBytes)
+{
+    uPortUartData_t *pUartData = &(gUartData[handle]);
+
+    if (sizeBytes > 0) {
+        pUartData->bufferRead += sizeBytes;
+        pUartData->bufferRead %= pUartData->receiveBufferSizeBytes;
+        bufferFullEnd(pUartData);
+#ifdef CONFIG_UART_INTERRUPT_DRIVEN
+        uart_irq_rx_enable(pUartData->pDevice);
+#endif
+    }
+}
+
+// Send a data received event from interrupt context, if the
+// user wants one and one is not already waiting to be handled:
+// there is no point in queueing another as the callback will
+// read everything there is anyway.
+static void sendDataReceivedEventIrq(int32_t uart)
+{
+    uPortUartEvent_t event;
 
     if ((gUartData[uart].eventQueueHandle >= 0) &&
-        (gUartData[uart].eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
-        uPortUartEvent_t event;
+        (gUartData[uart].eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED) &&
+        !gUartData[uart].eventPending) {
+        gUartData[uart].eventPending = true;
         event.uartHandle = uart;
         event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
-        uPortEventQueueSendIrq(gUartData[uart].eventQueueHandle,
-                               &event, sizeof(event));
+        if (uPortEventQueueSendIrq(gUartData[uart].eventQueueHandle,
+                                   &event, sizeof(event)) != 0) {
+            gUartData[uart].eventPending = false;
+        }
     }
 }
 
+static void rxTimer(struct k_timer *timer_id)
+{
+    uint32_t uart = (uint32_t)(timer_id->user_data);
+
+    sendDataReceivedEventIrq(uart);
+}
+
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
 // uartCb called by the interrupt-based UART driver.
 static void uartCb(const struct device *uart, void *user_data)
@@ -209,24 +307,19 @@ static void uartCb(const struct device *uart, void *user_data)
 
     if (uart_irq_rx_ready(uart)) {
         bool read = false;
+        errorCheckIrq(&gUartData[i]);
         if (!gUartData[i].bufferFull) {
             while (uart_fifo_read(uart, (gUartData[i].pBuffer + gUartData[i].bufferWrite), 1) != 0) {
                 gUartData[i].bufferWrite++;
                 gUartData[i].bufferWrite %= gUartData[i].receiveBufferSizeBytes;
+                gUartData[i].stats.bytesReceived++;
                 read = true;
 
                 if (gUartData[i].bufferWrite == gUartData[i].bufferRead) {
-                    gUartData[i].bufferFull = true;
+                    bufferFullStartIrq(&gUartData[i]);
                     uart_irq_rx_disable(uart);
                     k_timer_stop(&gUartData[i].rxTimer);
-                    if ((gUartData[i].eventQueueHandle >= 0) &&
-                        (gUartData[i].eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
-                        uPortUartEvent_t event;
-                        event.uartHandle = i;
-                        event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
-                        uPortEventQueueSendIrq(gUartData[i].eventQueueHandle,
-                                               &event, sizeof(event));
-                    }
+                    sendDataReceivedEventIrq(i);
                     break;
                 } else {
 
@@ -284,23 +377,18 @@ static void pollTimer(struct k_timer *timer_id)
     uint32_t uart = (uint32_t)(timer_id->user_data);
     bool read = false;
 
+    errorCheckIrq(&gUartData[uart]);
     while (!gUartData[uart].bufferFull &&
            (uart_poll_in(gUartData[uart].pDevice,
                          gUartData[uart].pBuffer + gUartData[uart].bufferWrite) == 0)) {
         gUartData[uart].bufferWrite++;
         gUartData[uart].bufferWrite %= gUartData[uart].receiveBufferSizeBytes;
+        gUartData[uart].stats.bytesReceived++;
         read = true;
         if (gUartData[uart].bufferWrite == gUartData[uart].bufferRead) {
-            gUartData[uart].bufferFull = true;
+            bufferFullStartIrq(&gUartData[uart]);
             k_timer_stop(&gUartData[uart].rxTimer);
-            if ((gUartData[uart].eventQueueHandle >= 0) &&
-                (gUartData[uart].eventFilter & U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED)) {
-                uPortUartEvent_t event;
-                event.uartHandle = uart;
-                event.eventBitMap = U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED;
-                uPortEventQueueSendIrq(gUartData[uart].eventQueueHandle,
-                                       &event, sizeof(event));
-            }
+            sendDataReceivedEventIrq(uart);
         }
     }
 
@@ -431,8 +519,10 @@ int32_t uPortUartOpen(int32_t uart, int32_t baudRate,
                     gUartData[uart].bufferRead = 0;
                     gUartData[uart].bufferWrite = 0;
                     gUartData[uart].bufferFull = false;
+                    memset(&gUartData[uart].stats, 0, sizeof(gUartData[uart].stats));
                     gUartData[uart].eventQueueHandle = -1;
                     gUartData[uart].eventFilter = 0;
+                    gUartData[uart].eventPending = false;
                     gUartData[uart].pEventCallback = NULL;
                     gUartData[uart].pEventCallbackParam = NULL;
                     k_timer_init(&gUartData[uart].rxTimer, rxTimer, NULL);
@@ -565,7 +655,7 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
                     gUartData[handle].bufferRead += toRead;
                 }
 
-                gUartData[handle].bufferFull = false;
+                bufferFullEnd(&gUartData[handle]);
 #ifdef CONFIG_UART_INTERRUPT_DRIVEN
                 uart_irq_rx_enable(gUartData[handle].pDevice);
 #endif
@@ -578,6 +668,61 @@ int32_t uPortUartRead(int32_t handle, void *pBuffer,
     return (int32_t) sizeOrErrorCode;
 }
 
+int32_t uPortUartReadSpan(int32_t handle, const char **ppData)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((ppData != NULL) && (handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].pDevice != NULL)) {
+            sizeOrErrorCode = (int32_t) rxSpan(handle);
+            *ppData = NULL;
+            if (sizeOrErrorCode > 0) {
+                *ppData = gUartData[handle].pBuffer + gUartData[handle].bufferRead;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
+int32_t uPortUartConsume(int32_t handle, size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    size_t cnt;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].pDevice != NULL)) {
+            sizeOrErrorCode = 0;
+            // At most two goes: up to the end of the buffer
+            // and then on from the start
+            for (size_t x = 0; (x < 2) && (sizeBytes > 0); x++) {
+                cnt = MIN(rxSpan(handle), sizeBytes);
+                rxConsume(handle, cnt);
+                sizeBytes -= cnt;
+                sizeOrErrorCode += (int32_t) cnt;
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return sizeOrErrorCode;
+}
+
 int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
                        size_t sizeBytes)
 {
@@ -620,6 +765,7 @@ int32_t uPortUartWrite(int32_t handle, const void *pBuffer,
                 sizeBytes--;
             }
 #endif
+            gUartData[handle].stats.bytesSent += (uint32_t) errorCode;
             U_PORT_MUTEX_UNLOCK(gMutex);
         }
     }
@@ -659,6 +805,7 @@ int32_t uPortUartEventCallbackSet(int32_t handle,
                                             priority,
                                             U_PORT_UART_EVENT_QUEUE_SIZE);
             if (errorCode >= 0) {
+                gUartData[handle].eventPending = false;
                 gUartData[handle].eventQueueHandle = (int32_t) errorCode;
                 gUartData[handle].eventQueueHandle = (int32_t) errorCode;
                 gUartData[handle].pEventCallback = pFunction;
@@ -917,6 +1064,59 @@ void uPortUartCtsResume(int32_t handle)
     (void) handle;
 }
 
+// Get the statistics of a UART.
+int32_t uPortUartStatsGet(int32_t handle, uPortUartStats_t *pStats)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((pStats != NULL) && (handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].pBuffer != NULL)) {
+            // Each count is a single word, which is enough
+            // for consistency with the interrupt
+            *pStats = gUartData[handle].stats;
+            if (gUartData[handle].bufferFull) {
+                pStats->bufferFullTimeMs += uPortGetTickTimeMs() -
+                                            gUartData[handle].bufferFullStartMs;
+            }
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return (int32_t) errorCode;
+}
+
+// Reset the statistics of a UART.
+int32_t uPortUartStatsReset(int32_t handle)
+{
+    uErrorCode_t errorCode = U_ERROR_COMMON_NOT_INITIALISED;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) &&
+            (handle < sizeof(gUartData) / sizeof(gUartData[0])) &&
+            (gUartData[handle].pBuffer != NULL)) {
+            memset(&gUartData[handle].stats, 0, sizeof(gUartData[handle].stats));
+            gUartData[handle].bufferFullStartMs = uPortGetTickTimeMs();
+            errorCode = U_ERROR_COMMON_SUCCESS;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return (int32_t) errorCode;
+}
+
 // Get the number of UART interfaces currently open.
 int32_t uPortUartResourceAllocCount()
 {
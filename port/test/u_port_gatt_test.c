@@ -1497,6 +1497,18 @@ U_PORT_TEST_FUNCTION("[portGatt]", "portGattServerConf")
         U_TEST_PRINT_LINE("uPortGattNotify() - data length = 0.");
         errorCode = uPortGattNotify(connHandle, &gSpsCreditsChar, &credits, 0);
         U_PORT_TEST_ASSERT_EQUAL(errorCode, (int32_t)U_ERROR_COMMON_INVALID_PARAMETER);
+        U_TEST_PRINT_LINE("uPortGattNotifyNoWait() - invalid connection handle.");
+        errorCode = uPortGattNotifyNoWait(-1, &gSpsCreditsChar, &credits, 1);
+        U_PORT_TEST_ASSERT_EQUAL(errorCode, (int32_t)U_ERROR_COMMON_INVALID_PARAMETER);
+        U_TEST_PRINT_LINE("uPortGattNotifyNoWait() - NULL characteristics.");
+        errorCode = uPortGattNotifyNoWait(connHandle, NULL, &credits, 1);
+        U_PORT_TEST_ASSERT_EQUAL(errorCode, (int32_t)U_ERROR_COMMON_INVALID_PARAMETER);
+        U_TEST_PRINT_LINE("uPortGattNotifyWaitSlot() - invalid connection handle.");
+        errorCode = uPortGattNotifyWaitSlot(-1, 0);
+        U_PORT_TEST_ASSERT_EQUAL(errorCode, (int32_t)U_ERROR_COMMON_INVALID_PARAMETER);
+        U_TEST_PRINT_LINE("uPortGattNotifyWaitSlot() - nothing queued.");
+        errorCode = uPortGattNotifyWaitSlot(connHandle, 0);
+        U_PORT_TEST_ASSERT_EQUAL(errorCode, (int32_t)U_ERROR_COMMON_SUCCESS);
 
         U_TEST_PRINT_LINE("notify credits to remote client.");
         errorCode = uPortGattNotify(connHandle, &gSpsCreditsChar, &credits, 1);
@@ -1511,7 +1523,7 @@ U_PORT_TEST_FUNCTION("[portGatt]", "portGattServerConf")
 
         notifyEvt_t *notify = &evt.notify;
         U_TEST_PRINT_LINE("notify data to remote client.");
-        errorCode = uPortGattNotify(connHandle, &gSpsFifoChar, "abcd", 4);
+        errorCode = uPortGattNotifyNoWait(connHandle, &gSpsFifoChar, "abcd", 4);
         U_PORT_TEST_ASSERT_EQUAL(errorCode, (int32_t)U_ERROR_COMMON_SUCCESS);
         U_TEST_PRINT_LINE("wait for data to echo back.");
         U_PORT_TEST_ASSERT(waitForEvt(GATT_EVT_SPS_WRITE_FIFO_CHAR, &evt, CONNECTION_SETUP_TIMEOUT));
@@ -58,9 +58,7 @@
 #include "u_port_gpio.h"
 //lint -esym(766, u_port_uart.h) Suppress not referenced, which will be the case if U_PORT_TEST_CHECK_TIME_TAKEN is defined
 #include "u_port_uart.h"
-#if (U_CFG_APP_GNSS_I2C >= 0)
-# include "u_port_i2c.h"
-#endif
+#include "u_port_i2c.h"
 #if (U_CFG_APP_GNSS_SPI >= 0)
 # include "u_port_spi.h"
 #endif
@@ -287,6 +285,20 @@
 # define U_PORT_TEST_CRITICAL_SECTION_TEST_WAIT_LOOPS 1000000
 #endif
 
+#ifndef U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES
+/** The size of the block of data used by the crypto benchmark,
+ * must be a multiple of 16.
+ */
+# define U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES 4096
+#endif
+
+#ifndef U_PORT_TEST_CRYPTO_BENCHMARK_ITERATIONS
+/** The number of times the crypto benchmark processes its block
+ * of data for each operation.
+ */
+# define U_PORT_TEST_CRYPTO_BENCHMARK_ITERATIONS 64
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -374,6 +386,29 @@ static int32_t gEventQueueMinErrorFlag;
 // Counter for event queue callback min length
 static int32_t gEventQueueMinCounter;
 
+// Flag to let the event queue priority callback go.
+static volatile bool gEventQueuePriorityGo;
+
+// The order in which events arrived at the event queue
+// priority callback.
+static uint8_t gEventQueuePriorityOrder[U_PORT_TEST_QUEUE_LENGTH];
+
+// The number of events that arrived at the event queue
+// priority callback.
+static volatile size_t gEventQueuePriorityCount;
+
+// The number of bytes that arrived, correctly, at the event
+// queue pointer callback.
+static volatile size_t gEventQueuePointerBytes;
+
+// The number of parameter blocks released by the event queue
+// pointer release function.
+static volatile size_t gEventQueuePointerReleased;
+
+// The number of asynchronous I2C transactions that have completed,
+// in order and with the expected outcome.
+static volatile size_t gI2cAsyncCount;
+
 #if (U_CFG_TEST_UART_A >= 0) && (U_CFG_TEST_UART_B < 0)
 
 // The data to send during UART testing.
@@ -923,6 +958,61 @@ static void eventQueueMinFunction(void *pParam,
     gEventQueueMinCounter++;
 }
 
+// Event queue pointer callback: counts the bytes that arrive,
+// which should be an incrementing pattern.
+static void eventQueuePointerFunction(void *pParam, size_t paramLength)
+{
+    const uint8_t *pData = (const uint8_t *) pParam;
+    bool good = true;
+
+    for (size_t x = 0; (x < paramLength) && good; x++) {
+        good = (pData[x] == (uint8_t) x);
+    }
+    if (good) {
+        gEventQueuePointerBytes += paramLength;
+    }
+}
+
+// Event queue pointer release function.
+static void eventQueuePointerRelease(void *pParam)
+{
+    uPortFree(pParam);
+    gEventQueuePointerReleased++;
+}
+
+// Asynchronous I2C transaction callback: pCallbackParam is the
+// order in which the transaction was queued and, since the handle
+// isn't open, the transaction should have failed.
+static void i2cAsyncCallback(int32_t handle, int32_t errorCodeOrLength,
+                             void *pCallbackParam)
+{
+    (void) handle;
+
+    if ((errorCodeOrLength < 0) && ((size_t) pCallbackParam == gI2cAsyncCount)) {
+        gI2cAsyncCount++;
+    }
+}
+
+// Event queue priority callback: on the first event it waits to be
+// told to go so that other events can pile up behind it and then it
+// just records the order in which they arrive.
+static void eventQueuePriorityFunction(void *pParam, size_t paramLength)
+{
+    uint8_t value = *((uint8_t *) pParam);
+
+    (void) paramLength;
+
+    if (value == 0) {
+        while (!gEventQueuePriorityGo) {
+            uPortTaskBlock(10);
+        }
+    }
+    if (gEventQueuePriorityCount < sizeof(gEventQueuePriorityOrder)) {
+        gEventQueuePriorityOrder[gEventQueuePriorityCount] = value;
+        gEventQueuePriorityCount++;
+    }
+}
+
 #if (U_CFG_TEST_UART_A >= 0) && (U_CFG_TEST_UART_B < 0)
 
 // Callback that is called when data arrives at the UART
@@ -933,6 +1023,8 @@ static void uartReceivedDataCallback(int32_t uartHandle,
     int32_t receiveSizeOrError;
     int32_t actualSizeOrError;
     uartEventCallbackData_t *pEventCallbackData = (uartEventCallbackData_t *) pParameters;
+    const char *pSpan = NULL;
+    int32_t space;
 
     pEventCallbackData->callCount++;
     if (filter != U_PORT_UART_EVENT_BITMASK_DATA_RECEIVED) {
@@ -952,10 +1044,26 @@ static void uartReceivedDataCallback(int32_t uartHandle,
             // it only occurs during testing.
             actualSizeOrError = 0;
             if (receiveSizeOrError > 0) {
-                actualSizeOrError = uPortUartRead(uartHandle,
-                                                  pEventCallbackData->pReceive,
-                                                  gUartBuffer + sizeof(gUartBuffer) -
-                                                  pEventCallbackData->pReceive);
+                space = gUartBuffer + sizeof(gUartBuffer) - pEventCallbackData->pReceive;
+                // On every other callback, try reading in place,
+                // copying to pReceive so that the checks are the same
+                actualSizeOrError = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+                if (pEventCallbackData->callCount & 1) {
+                    actualSizeOrError = uPortUartReadSpan(uartHandle, &pSpan);
+                }
+                if (actualSizeOrError == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED) {
+                    actualSizeOrError = uPortUartRead(uartHandle,
+                                                      pEventCallbackData->pReceive,
+                                                      space);
+                } else if (actualSizeOrError > 0) {
+                    if (actualSizeOrError > space) {
+                        actualSizeOrError = space;
+                    }
+                    memcpy(pEventCallbackData->pReceive, pSpan, actualSizeOrError);
+                    if (uPortUartConsume(uartHandle, actualSizeOrError) != actualSizeOrError) {
+                        pEventCallbackData->errorCode = -7;
+                    }
+                }
                 if (actualSizeOrError < 0) {
                     pEventCallbackData->errorCode = -2;
                 }
@@ -1013,6 +1121,8 @@ static void runUartTest(int32_t size, int32_t speed,
     int32_t stackMinFreeBytes;
     int32_t x;
     const char *pFlowControl = "?";
+    uPortUartIoVec_t vec[3];
+    bool useVec = false;
 
     eventCallbackData.callCount = 0;
     eventCallbackData.pReceive = gUartBuffer;
@@ -1167,9 +1277,23 @@ static void runUartTest(int32_t size, int32_t speed,
         if (bytesToSend > size - bytesSent) {
             bytesToSend = size - bytesSent;
         }
-        U_PORT_TEST_ASSERT(uPortUartWrite(uartHandle,
-                                          gUartTestData,
-                                          bytesToSend) == bytesToSend);
+        if (useVec) {
+            // Every other time send the same in pieces, including
+            // an empty one, which should look no different
+            vec[0].pBuffer = gUartTestData;
+            vec[0].sizeBytes = bytesToSend / 2;
+            vec[1].pBuffer = NULL;
+            vec[1].sizeBytes = 0;
+            vec[2].pBuffer = gUartTestData + vec[0].sizeBytes;
+            vec[2].sizeBytes = bytesToSend - vec[0].sizeBytes;
+            U_PORT_TEST_ASSERT(uPortUartWriteVec(uartHandle, vec,
+                                                 sizeof(vec) / sizeof(vec[0])) == bytesToSend);
+        } else {
+            U_PORT_TEST_ASSERT(uPortUartWrite(uartHandle,
+                                              gUartTestData,
+                                              bytesToSend) == bytesToSend);
+        }
+        useVec = !useVec;
         bytesSent += bytesToSend;
         U_TEST_PRINT_LINE("%d byte(s) sent.", bytesSent);
         // Yield so that the receive task has chance to do
@@ -1497,6 +1621,8 @@ U_PORT_TEST_FUNCTION("[port]", "portOs")
 //lint -esym(550, startTimeMs, timeNowMs) measuring time delays
     int32_t startTimeMs;
     int32_t timeNowMs;
+    int64_t startTimeUs;
+    int64_t timeNowUs;
     int32_t stackMinFreeBytes;
     int32_t y = -1;
     int32_t z;
@@ -1511,6 +1637,7 @@ U_PORT_TEST_FUNCTION("[port]", "portOs")
     U_PORT_TEST_ASSERT(uPortInit() == 0);
 
     startTimeMs = uPortGetTickTimeMs();
+    startTimeUs = uPortGetTickTimeUs();
     U_TEST_PRINT_LINE("tick time now is %d.", (int32_t) startTimeMs);
 
     U_TEST_PRINT_LINE("creating a mutex...");
@@ -1601,6 +1728,35 @@ U_PORT_TEST_FUNCTION("[port]", "portOs")
                 U_PORT_TEST_ASSERT(stackMinFreeBytes > 0);
             }
 
+            z = uPortTaskInfoGet(NULL, 0);
+            if (z != (int32_t) U_ERROR_COMMON_NOT_SUPPORTED) {
+                U_TEST_PRINT_LINE("%d task(s) reported by uPortTaskInfoGet().", z);
+                U_PORT_TEST_ASSERT(z > 0);
+                uPortTaskInfo_t *pTaskInfo = (uPortTaskInfo_t *) pUPortMalloc(z * sizeof(*pTaskInfo));
+                U_PORT_TEST_ASSERT(pTaskInfo != NULL);
+                // The number of tasks may have changed in the meantime
+                int32_t numTasks = uPortTaskInfoGet(pTaskInfo, z);
+                U_PORT_TEST_ASSERT(numTasks >= 0);
+                if (numTasks > z) {
+                    numTasks = z;
+                }
+                int32_t found = -1;
+                for (int32_t w = 0; w < numTasks; w++) {
+                    U_TEST_PRINT_LINE("task 0x%08x \"%s\": stack min free %d, CPU time %d us.",
+                                      U_PTR_TO_INT32(pTaskInfo[w].handle), pTaskInfo[w].name,
+                                      pTaskInfo[w].stackMinFreeBytes, (int32_t) pTaskInfo[w].cpuTimeUs);
+                    if (pTaskInfo[w].handle == gTaskHandle) {
+                        found = w;
+                    }
+                }
+                U_PORT_TEST_ASSERT(found >= 0);
+                U_PORT_TEST_ASSERT(strcmp(pTaskInfo[found].name, "osTestTask") == 0);
+                U_PORT_TEST_ASSERT((pTaskInfo[found].cpuTimeUs >= 0) ||
+                                   (pTaskInfo[found].cpuTimeUs ==
+                                    (int64_t) U_ERROR_COMMON_NOT_SUPPORTED));
+                uPortFree(pTaskInfo);
+            }
+
             U_TEST_PRINT_LINE("sending -1 to terminate test task"
                               " control queue and waiting for it to stop...");
             sendToQueue(gQueueHandleControl, -1);
@@ -1655,13 +1811,44 @@ U_PORT_TEST_FUNCTION("[port]", "portOs")
     U_PORT_TEST_ASSERT(uPortQueueDelete(queueHandle) == 0);
 
     timeNowMs = uPortGetTickTimeMs() - startTimeMs;
+    timeNowUs = uPortGetTickTimeUs() - startTimeUs;
     U_TEST_PRINT_LINE("according to uPortGetTickTimeMs()"
                       " the test took %d ms.", (int32_t) timeNowMs);
+    U_TEST_PRINT_LINE("according to uPortGetTickTimeUs()"
+                      " the test took %d ms.", (int32_t) (timeNowUs / 1000));
+    // Must never go backwards
+    U_PORT_TEST_ASSERT(timeNowUs >= 0);
 #ifdef U_PORT_TEST_CHECK_TIME_TAKEN
     U_PORT_TEST_ASSERT((timeNowMs > 0) &&
                        (timeNowMs < U_PORT_TEST_OS_GUARD_DURATION_MS));
+    U_PORT_TEST_ASSERT((timeNowUs > 0) &&
+                       (timeNowUs < ((int64_t) U_PORT_TEST_OS_GUARD_DURATION_MS) * 1000));
 #endif
 
+    U_TEST_PRINT_LINE("testing uPortTaskBlockUntil().");
+    // The period should not drift by the time spent between calls
+    startTimeMs = uPortGetTickTimeMs();
+    y = startTimeMs;
+    for (size_t x = 0; x < 5; x++) {
+        uPortTaskBlock(50);
+        uPortTaskBlockUntil(&y, 100);
+    }
+    timeNowMs = uPortGetTickTimeMs() - startTimeMs;
+    U_TEST_PRINT_LINE("5 periods of 100 ms took %d ms.", timeNowMs);
+    U_PORT_TEST_ASSERT(y - startTimeMs == 500);
+#ifdef U_PORT_TEST_CHECK_TIME_TAKEN
+    U_PORT_TEST_ASSERT((timeNowMs >= 500) && (timeNowMs < 500 + 100));
+#endif
+    // More than a period late: the period restarts from now
+    uPortTaskBlock(250);
+    uPortTaskBlockUntil(&y, 100);
+    U_PORT_TEST_ASSERT(uPortGetTickTimeMs() - y < 100);
+    // Silly parameters do nothing
+    z = y;
+    uPortTaskBlockUntil(&y, 0);
+    U_PORT_TEST_ASSERT(y == z);
+    uPortTaskBlockUntil(NULL, 100);
+
     uPortDeinit();
 
     // Check for resource leaks
@@ -2186,6 +2373,260 @@ U_PORT_TEST_FUNCTION("[port]", "portEventQueue")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Test that high priority events jump the event queue.
+ */
+U_PORT_TEST_FUNCTION("[port]", "portEventQueuePriority")
+{
+    int32_t handle;
+    uint8_t value;
+    // The blocking event, then normal events with
+    // high priority ones, 100 and up, mixed in
+    const uint8_t sent[] = {0, 1, 2, 100, 3, 101, 4};
+    const uint8_t expected[] = {0, 100, 101, 1, 2, 3, 4};
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    gEventQueuePriorityGo = false;
+    gEventQueuePriorityCount = 0;
+
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    handle = uPortEventQueueOpen(eventQueuePriorityFunction, NULL, sizeof(value),
+                                 U_PORT_EVENT_QUEUE_MIN_TASK_STACK_SIZE_BYTES,
+                                 U_CFG_TEST_OS_TASK_PRIORITY,
+                                 U_PORT_TEST_QUEUE_LENGTH);
+    U_PORT_TEST_ASSERT(handle >= 0);
+
+    value = 0;
+    U_PORT_TEST_ASSERT(uPortEventQueueSendPriority(handle, &value, sizeof(value),
+                                                   (uPortEventQueuePriority_t) 2) < 0);
+
+    for (size_t x = 0; x < sizeof(sent); x++) {
+        U_PORT_TEST_ASSERT(uPortEventQueueSendPriority(handle, &(sent[x]), sizeof(sent[x]),
+                                                       sent[x] >= 100 ?
+                                                       U_PORT_EVENT_QUEUE_PRIORITY_HIGH :
+                                                       U_PORT_EVENT_QUEUE_PRIORITY_NORMAL) == 0);
+        if (x == 0) {
+            // Let the first one get to the callback, which
+            // will then hold everything else up
+            uPortTaskBlock(100);
+        }
+    }
+    gEventQueuePriorityGo = true;
+    uPortTaskBlock(500);
+
+    U_TEST_PRINT_LINE("%d event(s) received.", gEventQueuePriorityCount);
+    U_PORT_TEST_ASSERT(gEventQueuePriorityCount == sizeof(expected));
+    for (size_t x = 0; x < sizeof(expected); x++) {
+        U_TEST_PRINT_LINE("event %d was %d.", x, gEventQueuePriorityOrder[x]);
+        U_PORT_TEST_ASSERT(gEventQueuePriorityOrder[x] == expected[x]);
+    }
+
+    // A high priority event with nothing in the way
+    value = 102;
+    U_PORT_TEST_ASSERT(uPortEventQueueSendPriority(handle, &value, sizeof(value),
+                                                   U_PORT_EVENT_QUEUE_PRIORITY_HIGH) == 0);
+    uPortTaskBlock(100);
+    U_PORT_TEST_ASSERT(gEventQueuePriorityCount == sizeof(expected) + 1);
+    U_PORT_TEST_ASSERT(gEventQueuePriorityOrder[sizeof(expected)] == value);
+
+    U_PORT_TEST_ASSERT(uPortEventQueueClose(handle) == 0);
+
+    uPortDeinit();
+
+    // Give the RTOS idle task time to tidy-away the tasks
+    uPortTaskBlock(1000);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test sending parameter blocks by pointer to an event queue.
+ */
+U_PORT_TEST_FUNCTION("[port]", "portEventQueuePointer")
+{
+    int32_t handle;
+    uint8_t *pBuffer;
+    uint8_t value = 0;
+    // Too big to be copied onto the queue
+    static uint8_t buffer[100];
+    size_t expectedBytes = 0;
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+
+    gEventQueuePointerBytes = 0;
+    gEventQueuePointerReleased = 0;
+    for (size_t x = 0; x < sizeof(buffer); x++) {
+        buffer[x] = (uint8_t) x;
+    }
+
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    handle = uPortEventQueueOpen(eventQueuePointerFunction, NULL, sizeof(value),
+                                 U_PORT_EVENT_QUEUE_MIN_TASK_STACK_SIZE_BYTES,
+                                 U_CFG_TEST_OS_TASK_PRIORITY,
+                                 U_PORT_TEST_QUEUE_LENGTH);
+    U_PORT_TEST_ASSERT(handle >= 0);
+
+    U_PORT_TEST_ASSERT(uPortEventQueueSendPointer(handle, NULL, 1, NULL) < 0);
+    U_PORT_TEST_ASSERT(uPortEventQueueSend(handle, buffer, sizeof(buffer)) < 0);
+
+    // Copied and by pointer, mixed, with and without a release function
+    U_PORT_TEST_ASSERT(uPortEventQueueSend(handle, &value, sizeof(value)) == 0);
+    expectedBytes += sizeof(value);
+    U_PORT_TEST_ASSERT(uPortEventQueueSendPointer(handle, buffer, sizeof(buffer), NULL) == 0);
+    expectedBytes += sizeof(buffer);
+    for (size_t x = 1; x < 4; x++) {
+        pBuffer = (uint8_t *) pUPortMalloc(x * 200);
+        U_PORT_TEST_ASSERT(pBuffer != NULL);
+        for (size_t y = 0; y < x * 200; y++) {
+            pBuffer[y] = (uint8_t) y;
+        }
+        U_PORT_TEST_ASSERT(uPortEventQueueSendPointer(handle, pBuffer, x * 200,
+                                                      eventQueuePointerRelease) == 0);
+        expectedBytes += x * 200;
+        U_PORT_TEST_ASSERT(uPortEventQueueSend(handle, &value, sizeof(value)) == 0);
+        expectedBytes += sizeof(value);
+    }
+    uPortTaskBlock(500);
+
+    U_TEST_PRINT_LINE("%d byte(s) received, %d block(s) released.",
+                      gEventQueuePointerBytes, gEventQueuePointerReleased);
+    U_PORT_TEST_ASSERT(gEventQueuePointerBytes == expectedBytes);
+    U_PORT_TEST_ASSERT(gEventQueuePointerReleased == 3);
+
+    U_PORT_TEST_ASSERT(uPortEventQueueClose(handle) == 0);
+
+    uPortDeinit();
+
+    // Give the RTOS idle task time to tidy-away the tasks
+    uPortTaskBlock(1000);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test that asynchronous I2C transactions are queued and completed
+ * in order; no I2C HW is required since the handle used is not open.
+ */
+U_PORT_TEST_FUNCTION("[port]", "portI2cAsync")
+{
+    char buffer[4] = {0};
+    int32_t startTimeMs;
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    if (uPortI2cInit() == 0) {
+        U_TEST_PRINT_LINE("testing asynchronous I2C transactions.");
+        U_PORT_TEST_ASSERT(uPortI2cControllerSendReceiveAsync(-1, 0x42, buffer, sizeof(buffer),
+                                                              NULL, 0, i2cAsyncCallback,
+                                                              NULL) < 0);
+        U_PORT_TEST_ASSERT(uPortI2cControllerSendReceiveAsync(1000, 0x42, NULL, sizeof(buffer),
+                                                              NULL, 0, i2cAsyncCallback,
+                                                              NULL) < 0);
+        gI2cAsyncCount = 0;
+        for (size_t x = 0; x < U_PORT_I2C_ASYNC_QUEUE_LENGTH + 2; x++) {
+            U_PORT_TEST_ASSERT(uPortI2cControllerSendReceiveAsync(1000, 0x42,
+                                                                  buffer, sizeof(buffer),
+                                                                  buffer, sizeof(buffer),
+                                                                  i2cAsyncCallback,
+                                                                  (void *) x) == 0);
+        }
+        startTimeMs = uPortGetTickTimeMs();
+        while ((gI2cAsyncCount < U_PORT_I2C_ASYNC_QUEUE_LENGTH + 2) &&
+               (uPortGetTickTimeMs() - startTimeMs < 5000)) {
+            uPortTaskBlock(10);
+        }
+        U_TEST_PRINT_LINE("%d transaction(s) completed.", gI2cAsyncCount);
+        U_PORT_TEST_ASSERT(gI2cAsyncCount == U_PORT_I2C_ASYNC_QUEUE_LENGTH + 2);
+        uPortI2cDeinit();
+    }
+
+    uPortDeinit();
+
+    // Give the RTOS idle task time to tidy-away the tasks
+    uPortTaskBlock(1000);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
+/** Test asynchronous logging.
+ */
+U_PORT_TEST_FUNCTION("[port]", "portLogAsync")
+{
+    int32_t startTimeMs;
+    int32_t dropCount;
+    int32_t resourceCount;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    U_PORT_TEST_ASSERT(uPortLogAsyncStart() == 0);
+    // Starting again does nothing
+    U_PORT_TEST_ASSERT(uPortLogAsyncStart() == 0);
+    // A few prints must fit without any being dropped
+    for (size_t x = 0; x < 10; x++) {
+        U_TEST_PRINT_LINE("asynchronous log print %d.", x);
+    }
+    U_PORT_TEST_ASSERT(uPortLogAsyncGetDropCount() == 0);
+    // Lots may not, but however many are dropped each print
+    // must take no longer than formatting it
+    startTimeMs = uPortGetTickTimeMs();
+    for (size_t x = 0; x < 1000; x++) {
+        U_TEST_PRINT_LINE("asynchronous log print %d of a flood.", x);
+    }
+    U_TEST_PRINT_LINE("1000 asynchronous log prints took %d ms.",
+                      uPortGetTickTimeMs() - startTimeMs);
+    uPortLogAsyncStop();
+    dropCount = uPortLogAsyncGetDropCount();
+    U_TEST_PRINT_LINE("%d asynchronous log print(s) were dropped.", dropCount);
+    U_PORT_TEST_ASSERT((dropCount >= 0) && (dropCount <= 1000));
+    // Stopping again does nothing
+    uPortLogAsyncStop();
+    U_TEST_PRINT_LINE("synchronous logging again.");
+
+    uPortDeinit();
+
+    // Give the RTOS idle task time to tidy-away the tasks
+    uPortTaskBlock(1000);
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Test heap API.
  *
  * NOTE: for this to work fully U_ASSERT_HOOK_FUNCTION_TEST_RETURN must be defined.
@@ -2194,6 +2635,14 @@ U_PORT_TEST_FUNCTION("[port]", "portHeap")
 {
     int32_t x;
     int32_t y;
+#ifdef U_CFG_HEAP_PROFILE
+    char profileBuffer[32];
+#endif
+#ifdef U_CFG_HEAP_BUDGET
+    size_t liveBytes;
+    size_t peakBytes;
+    size_t startBytes;
+#endif
 
     U_PORT_TEST_ASSERT(uPortInit() == 0);
 
@@ -2257,6 +2706,62 @@ U_PORT_TEST_FUNCTION("[port]", "portHeap")
     U_PORT_TEST_ASSERT(gVariable == 1);
 #endif
 
+#ifdef U_CFG_HEAP_PROFILE
+    U_TEST_PRINT_LINE("testing heap profiling.");
+    uPortHeapProfileReset();
+    // Enough allocations from the one call site to be sure of sampling it
+    for (size_t z = 0; z < 64; z++) {
+        gpMalloc = pUPortMalloc(U_PORT_MALLOC_LENGTH_BYTES);
+        U_PORT_TEST_ASSERT(gpMalloc != NULL);
+        uPortFree(gpMalloc);
+    }
+    gpMalloc = NULL;
+    y = uPortHeapProfileDump(NULL, 0);
+    U_TEST_PRINT_LINE("heap profile is %d byte(s).", y);
+    U_PORT_TEST_ASSERT(y >= 32);
+    U_PORT_TEST_ASSERT(uPortHeapProfileDump(profileBuffer, 15) < 0);
+    // Room for the header and just one record
+    U_PORT_TEST_ASSERT(uPortHeapProfileDump(profileBuffer,
+                                            sizeof(profileBuffer)) == 32);
+    U_PORT_TEST_ASSERT((profileBuffer[0] == 'H') && (profileBuffer[1] == 'P') &&
+                       (profileBuffer[3] == 1));
+    // The allocation count, little-endian, is at offset 8
+    x = (int32_t) (uint8_t) profileBuffer[8] + (((int32_t) (uint8_t) profileBuffer[9]) << 8);
+    U_PORT_TEST_ASSERT(x >= 64);
+#else
+    U_PORT_TEST_ASSERT(uPortHeapProfileDump(NULL, 0) == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
+#endif
+
+#ifdef U_CFG_HEAP_BUDGET
+    U_TEST_PRINT_LINE("testing heap budget accounting.");
+    for (int32_t z = 0; z < (int32_t) U_PORT_HEAP_TAG_MAX_NUM; z++) {
+        U_PORT_TEST_ASSERT(uPortHeapBudgetGet((uPortHeapTag_t) z, &liveBytes, &peakBytes) == 0);
+        U_TEST_PRINT_LINE("tag %d: %d byte(s) live, peak %d byte(s).", z,
+                          (int32_t) liveBytes, (int32_t) peakBytes);
+        U_PORT_TEST_ASSERT(peakBytes >= liveBytes);
+    }
+    U_PORT_TEST_ASSERT(uPortHeapBudgetGet(U_PORT_HEAP_TAG_MAX_NUM, NULL, NULL) < 0);
+    // This file is in port/test so its allocations count as "other"
+    U_PORT_TEST_ASSERT(uPortHeapBudgetGet(U_PORT_HEAP_TAG_OTHER, &startBytes, NULL) == 0);
+    gpMalloc = pUPortMalloc(U_PORT_MALLOC_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(gpMalloc != NULL);
+    U_PORT_TEST_ASSERT(uPortHeapBudgetGet(U_PORT_HEAP_TAG_OTHER, &liveBytes, &peakBytes) == 0);
+    U_PORT_TEST_ASSERT(liveBytes == startBytes + U_PORT_MALLOC_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(peakBytes >= liveBytes);
+    uPortFree(gpMalloc);
+    gpMalloc = NULL;
+    U_PORT_TEST_ASSERT(uPortHeapBudgetGet(U_PORT_HEAP_TAG_OTHER, &liveBytes, &peakBytes) == 0);
+    U_PORT_TEST_ASSERT(liveBytes == startBytes);
+    U_PORT_TEST_ASSERT(peakBytes >= startBytes + U_PORT_MALLOC_LENGTH_BYTES);
+    // Resetting brings the peak down to the live figure
+    uPortHeapBudgetReset();
+    U_PORT_TEST_ASSERT(uPortHeapBudgetGet(U_PORT_HEAP_TAG_OTHER, &liveBytes, &peakBytes) == 0);
+    U_PORT_TEST_ASSERT(peakBytes == liveBytes);
+#else
+    U_PORT_TEST_ASSERT(uPortHeapBudgetGet(U_PORT_HEAP_TAG_OTHER, NULL,
+                                          NULL) == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
+#endif
+
     U_TEST_PRINT_LINE("removing assert hook.");
     // Remove the assert hook
     uAssertHookSet(NULL);
@@ -3168,6 +3673,105 @@ U_PORT_TEST_FUNCTION("[port]", "portCrypto")
     U_PORT_TEST_ASSERT(resourceCount <= 0);
 }
 
+/** Benchmark crypto: print the throughput of each operation so
+ * that platforms, and hardware versus software crypto (see
+ * U_PORT_CRYPTO_HW), can be compared.
+ */
+U_PORT_TEST_FUNCTION("[port]", "portCryptoBenchmark")
+{
+    const char *pName[] = {"SHA256", "HMAC SHA256", "AES CBC 128 encrypt",
+                           "AES CBC 128 decrypt"
+                          };
+    char *pBuffer;
+    char output[U_PORT_CRYPTO_SHA256_OUTPUT_LENGTH_BYTES];
+    char iv[U_PORT_CRYPTO_AES128_INITIALISATION_VECTOR_LENGTH_BYTES];
+    char key[sizeof(gHmacSha256Key)];
+    int32_t resourceCount;
+    int32_t startTimeMs;
+    int32_t durationMs;
+    int32_t bytesPerMs;
+    int32_t x = 0;
+
+    // Whatever called us likely initialised the
+    // port so deinitialise it here to obtain the
+    // correct initial heap size
+    uPortDeinit();
+
+    resourceCount = uTestUtilGetDynamicResourceCount();
+    U_PORT_TEST_ASSERT(uPortInit() == 0);
+
+    // Data on the heap: hardware may not be able to reach
+    // data elsewhere
+    pBuffer = (char *) pUPortMalloc(U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES);
+    U_PORT_TEST_ASSERT(pBuffer != NULL);
+    for (size_t y = 0; y < U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES; y++) {
+        *(pBuffer + y) = (char) y;
+    }
+    memcpy(iv, gAes128CbcIV, sizeof(iv));
+    memcpy(key, gHmacSha256Key, sizeof(key));
+
+    for (size_t y = 0; y < sizeof(pName) / sizeof(pName[0]); y++) {
+        startTimeMs = uPortGetTickTimeMs();
+        for (size_t z = 0; (z < U_PORT_TEST_CRYPTO_BENCHMARK_ITERATIONS) && (x == 0); z++) {
+            switch (y) {
+                case 0:
+                    x = uPortCryptoSha256(pBuffer,
+                                          U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES,
+                                          output);
+                    break;
+                case 1:
+                    x = uPortCryptoHmacSha256(key, sizeof(key) - 1,
+                                              pBuffer,
+                                              U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES,
+                                              output);
+                    break;
+                case 2:
+                    // In-place
+                    x = uPortCryptoAes128CbcEncrypt(gAes128CbcKey,
+                                                    sizeof(gAes128CbcKey) - 1,
+                                                    iv, pBuffer,
+                                                    U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES,
+                                                    pBuffer);
+                    break;
+                default:
+                    x = uPortCryptoAes128CbcDecrypt(gAes128CbcKey,
+                                                    sizeof(gAes128CbcKey) - 1,
+                                                    iv, pBuffer,
+                                                    U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES,
+                                                    pBuffer);
+                    break;
+            }
+        }
+        durationMs = uPortGetTickTimeMs() - startTimeMs;
+        if (x == 0) {
+            if (durationMs <= 0) {
+                durationMs = 1;
+            }
+            // Bytes per millisecond is kbytes per second
+            bytesPerMs = (U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES *
+                          U_PORT_TEST_CRYPTO_BENCHMARK_ITERATIONS) / durationMs;
+            U_TEST_PRINT_LINE("%s: %d byte(s) in %d ms, %d.%02d Mbytes/s.", pName[y],
+                              U_PORT_TEST_CRYPTO_BENCHMARK_LENGTH_BYTES *
+                              U_PORT_TEST_CRYPTO_BENCHMARK_ITERATIONS, durationMs,
+                              bytesPerMs / 1000, (bytesPerMs % 1000) / 10);
+        } else {
+            U_PORT_TEST_ASSERT(x == (int32_t) U_ERROR_COMMON_NOT_SUPPORTED);
+            U_TEST_PRINT_LINE("%s not supported.", pName[y]);
+            x = 0;
+        }
+    }
+
+    uPortFree(pBuffer);
+
+    uPortDeinit();
+
+    // Check for resource leaks
+    uTestUtilResourceCheck(U_TEST_PREFIX, NULL, true);
+    resourceCount = uTestUtilGetDynamicResourceCount() - resourceCount;
+    U_TEST_PRINT_LINE("we have leaked %d resources(s).", resourceCount);
+    U_PORT_TEST_ASSERT(resourceCount <= 0);
+}
+
 /** Test timers.
  */
 U_PORT_TEST_FUNCTION("[port]", "portTimers")
@@ -0,0 +1,67 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Default implementation of uPortGpioInterruptSet(), for
+ * platforms which do not support GPIO interrupts.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"     // NULL, size_t etc.
+#include "stdint.h"     // int32_t etc.
+#include "stdbool.h"
+#include "u_compiler.h" // U_WEAK
+
+#include "u_error_common.h"
+
+#include "u_port_gpio.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Default implementation of setting a GPIO interrupt.
+U_WEAK int32_t uPortGpioInterruptSet(int32_t pin, uPortGpioInterruptEdge_t edge,
+                                     uPortGpioInterruptCallback_t *pCallback,
+                                     void *pParam)
+{
+    (void) pin;
+    (void) edge;
+    (void) pCallback;
+    (void) pParam;
+    return (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+}
+
+// End of file
@@ -16,7 +16,8 @@
 
 /** @file
  * @brief Default implementation of pUPortMalloc() / uPortFree() and
- * uPortHeapAllocCount().
+ * uPortHeapAllocCount(), with an optional pool of fixed-size blocks
+ * in front of malloc() for small allocations.
  */
 
 #ifdef U_CFG_OVERRIDE
@@ -50,6 +51,14 @@
  * COMPILE-TIME MACROS
  * -------------------------------------------------------------- */
 
+#if defined(U_CFG_HEAP_MONITOR) && defined(U_CFG_HEAP_PROFILE)
+# error U_CFG_HEAP_MONITOR and U_CFG_HEAP_PROFILE cannot both be defined.
+#endif
+
+#if defined(U_CFG_HEAP_BUDGET) && (defined(U_CFG_HEAP_MONITOR) || defined(U_CFG_HEAP_PROFILE))
+# error U_CFG_HEAP_BUDGET cannot be defined with U_CFG_HEAP_MONITOR or U_CFG_HEAP_PROFILE.
+#endif
+
 #ifndef U_PORT_HEAP_GUARD
 /** The uint32_t guard to put before and after each heap block, allowing
  * us to check for overruns ("DEADBEEF", readable in a hex dump on
@@ -78,6 +87,91 @@
 # define U_PORT_HEAP_BUFFER_UNDERRUN_MARKER " *** BUFFER UNDERRUN *** "
 #endif
 
+#ifndef U_PORT_HEAP_POOL_BLOCKS_PER_CLASS
+/** ubxlib makes many small, short-lived, allocations; if this is
+ * set to a value greater than zero then a statically allocated pool
+ * of blocks, this many of each size class, is placed in front of
+ * malloc(), reducing heap fragmentation and allocation time.  The
+ * size classes start at #U_PORT_HEAP_POOL_SMALLEST_BLOCK_SIZE_BYTES
+ * and double each time, #U_PORT_HEAP_POOL_NUM_CLASSES of them (by
+ * default 16, 32, 64, 128 and 256 bytes); an allocation that won't
+ * fit in the largest class, or arrives when all of the blocks of its
+ * class are in use, is passed to malloc() as normal.  The RAM taken
+ * is #U_PORT_HEAP_POOL_SIZE_BYTES.  The pool is only used once
+ * uPortHeapMonitorInit() has been called by the porting layer.
+ */
+# define U_PORT_HEAP_POOL_BLOCKS_PER_CLASS 0
+#endif
+
+#ifndef U_PORT_HEAP_POOL_SMALLEST_BLOCK_SIZE_BYTES
+/** The size of the blocks in the smallest class of the pool, see
+ * #U_PORT_HEAP_POOL_BLOCKS_PER_CLASS; must be a multiple of eight
+ * to keep the blocks aligned.
+ */
+# define U_PORT_HEAP_POOL_SMALLEST_BLOCK_SIZE_BYTES 16
+#endif
+
+#ifndef U_PORT_HEAP_POOL_NUM_CLASSES
+/** The number of size classes in the pool, see
+ * #U_PORT_HEAP_POOL_BLOCKS_PER_CLASS.
+ */
+# define U_PORT_HEAP_POOL_NUM_CLASSES 5
+#endif
+
+/** The block size of a given class of the pool.
+ */
+#define U_PORT_HEAP_POOL_BLOCK_SIZE_BYTES(class) (U_PORT_HEAP_POOL_SMALLEST_BLOCK_SIZE_BYTES << (class))
+
+/** The offset of the first block of a given class of the pool from
+ * the start of the pool: the classes are stored one after another,
+ * smallest first.
+ */
+#define U_PORT_HEAP_POOL_CLASS_OFFSET_BYTES(class) (U_PORT_HEAP_POOL_SMALLEST_BLOCK_SIZE_BYTES * \
+                                                    ((1UL << (class)) - 1) *                  \
+                                                    U_PORT_HEAP_POOL_BLOCKS_PER_CLASS)
+
+/** The amount of RAM taken by the pool.
+ */
+#define U_PORT_HEAP_POOL_SIZE_BYTES U_PORT_HEAP_POOL_CLASS_OFFSET_BYTES(U_PORT_HEAP_POOL_NUM_CLASSES)
+
+#ifndef U_PORT_HEAP_PROFILE_SAMPLE_EVERY
+/** When U_CFG_HEAP_PROFILE is defined, one in this many calls to
+ * pUPortMalloc() is sampled and counted against its call site.
+ */
+# define U_PORT_HEAP_PROFILE_SAMPLE_EVERY 16
+#endif
+
+#ifndef U_PORT_HEAP_PROFILE_NUM_SITES
+/** When U_CFG_HEAP_PROFILE is defined, the number of distinct call
+ * sites that can be counted; must be a power of two.  A sample from
+ * a call site that won't fit is counted as dropped.
+ */
+# define U_PORT_HEAP_PROFILE_NUM_SITES 64
+#endif
+
+/** The version number at the start of the output of
+ * uPortHeapProfileDump().
+ */
+#define U_PORT_HEAP_PROFILE_DUMP_VERSION 1
+
+/** The size of the header at the start of the output of
+ * uPortHeapProfileDump().
+ */
+#define U_PORT_HEAP_PROFILE_DUMP_HEADER_SIZE_BYTES 16
+
+/** The size of each record after the header in the output of
+ * uPortHeapProfileDump().
+ */
+#define U_PORT_HEAP_PROFILE_DUMP_RECORD_SIZE_BYTES 16
+
+#ifndef U_PORT_HEAP_BUDGET_NUM_FILES
+/** When U_CFG_HEAP_BUDGET is defined, the number of source files
+ * whose tag is remembered, so that the path of a file doesn't have
+ * to be searched on every allocation; must be a power of two.
+ */
+# define U_PORT_HEAP_BUDGET_NUM_FILES 32
+#endif
+
 /** Local version of the lock helper, since this can't necessarily
  * use the normal one.
  */
@@ -119,6 +213,40 @@ typedef struct uPortHeapBlock_t {
     int32_t timeMilliseconds;
 } uPortHeapBlock_t;
 
+/** Structure to count the samples from one call site when
+ * U_CFG_HEAP_PROFILE is defined.
+ */
+typedef struct {
+    const char *pFile; /**< NULL if the entry is not in use. */
+    int32_t line;
+    uint32_t fileHash;
+    uint32_t allocCount;
+    uint32_t allocBytes;
+} uPortHeapProfileSite_t;
+
+/** The header placed in front of each heap allocation when
+ * U_CFG_HEAP_BUDGET is defined; must be no bigger than
+ * #U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES.
+ */
+typedef struct {
+    size_t size;
+    uPortHeapTag_t tag;
+} uPortHeapBudgetHeader_t;
+
+/** A fragment of a source file path and the subsystem it belongs to.
+ */
+typedef struct {
+    const char *pFragment;
+    uPortHeapTag_t tag;
+} uPortHeapBudgetPath_t;
+
+/** The live and peak heap of one subsystem.
+ */
+typedef struct {
+    size_t liveBytes;
+    size_t peakBytes;
+} uPortHeapBudget_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -141,7 +269,70 @@ static uPortHeapBlock_t *gpHeapBlockList = NULL;
 /** Mutex to protect the linked list.
  */
 static uPortMutexHandle_t gMutex = NULL;
+#endif
+
+#ifdef U_CFG_HEAP_PROFILE
+/** The call sites being counted, hashed by file and line.
+ */
+static uPortHeapProfileSite_t gHeapProfileSite[U_PORT_HEAP_PROFILE_NUM_SITES];
+
+/** The number of calls to pUPortMalloc(), sampled or not.
+ */
+static uint32_t gHeapProfileAllocCount = 0;
+
+/** The number of samples that were not counted because
+ * gHeapProfileSite[] was full.
+ */
+static uint32_t gHeapProfileDropCount = 0;
+
+/** Mutex to protect gHeapProfileSite[].
+ */
+static uPortMutexHandle_t gHeapProfileMutex = NULL;
+#endif
+
+#ifdef U_CFG_HEAP_BUDGET
+/** The path fragments that decide the tag of a source file, checked
+ * in order, so the more specific ones come first; a file that
+ * matches none of them is #U_PORT_HEAP_TAG_OTHER.
+ */
+static const uPortHeapBudgetPath_t gHeapBudgetPath[] = {
+    {"common/mqtt_client/", U_PORT_HEAP_TAG_MQTT},
+    {"cell/src/u_cell_mqtt", U_PORT_HEAP_TAG_MQTT},
+    {"wifi/src/u_wifi_mqtt", U_PORT_HEAP_TAG_MQTT},
+    {"common/sock/", U_PORT_HEAP_TAG_SOCK},
+    {"cell/src/u_cell_sock", U_PORT_HEAP_TAG_SOCK},
+    {"wifi/src/u_wifi_sock", U_PORT_HEAP_TAG_SOCK},
+    {"common/location/", U_PORT_HEAP_TAG_LOCATION},
+    {"cell/src/u_cell_loc", U_PORT_HEAP_TAG_LOCATION},
+    {"common/at_client/", U_PORT_HEAP_TAG_AT_CLIENT},
+    {"common/short_range/", U_PORT_HEAP_TAG_SHORT_RANGE},
+    {"ble/", U_PORT_HEAP_TAG_SHORT_RANGE},
+    {"wifi/", U_PORT_HEAP_TAG_SHORT_RANGE},
+    {"cell/", U_PORT_HEAP_TAG_CELL},
+    {"gnss/", U_PORT_HEAP_TAG_GNSS}
+};
+
+/** The tags of recently seen source files, indexed by a hash of
+ * the address of the __FILE__ string.
+ */
+static struct {
+    const char *pFile;
+    uPortHeapTag_t tag;
+} gHeapBudgetFile[U_PORT_HEAP_BUDGET_NUM_FILES];
 
+/** The live and peak heap of each subsystem.
+ */
+static uPortHeapBudget_t gHeapBudget[U_PORT_HEAP_TAG_MAX_NUM];
+
+/** Mutex to protect gHeapBudget[]; until it exists (i.e. before
+ * uPortHeapMonitorInit() has been called, when there is only one
+ * thread) gHeapBudget[] is updated without it.
+ */
+static uPortMutexHandle_t gHeapBudgetMutex = NULL;
+#endif
+
+#if defined(U_CFG_HEAP_MONITOR) || defined(U_CFG_HEAP_PROFILE) || \
+    defined(U_CFG_HEAP_BUDGET) || (U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0)
 /** Hook for platform-specific mutex lock function, if required
  * (e.g. the Linux port needs this).
  */
@@ -151,7 +342,22 @@ static int32_t (*gpMutexLock) (const uPortMutexHandle_t) = NULL;
  * (e.g. the Linux port needs this).
  */
 static int32_t (*gpMutexUnlock) (const uPortMutexHandle_t) = NULL;
+#endif
+
+#if U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0
+/** The pool, see #U_PORT_HEAP_POOL_BLOCKS_PER_CLASS, uint64_t
+ * for alignment.
+ */
+static uint64_t gPool[U_PORT_HEAP_POOL_SIZE_BYTES / sizeof(uint64_t)];
 
+/** The first free block of each class of the pool, the first
+ * pointer's worth of a free block being the next free block.
+ */
+static void *gpPoolFree[U_PORT_HEAP_POOL_NUM_CLASSES];
+
+/** Mutex to protect the pool, NULL until the pool is ready.
+ */
+static uPortMutexHandle_t gPoolMutex = NULL;
 #endif
 
 /* ----------------------------------------------------------------
@@ -184,19 +390,283 @@ static void printMemory(const char *pMemory, size_t size)
 }
 #endif
 
+#if defined(U_CFG_HEAP_MONITOR) || defined(U_CFG_HEAP_PROFILE) || \
+    defined(U_CFG_HEAP_BUDGET) || (U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0)
+// Create a mutex with pMutexCreate, if given, else uPortMutexCreate().
+static int32_t heapMutexCreate(int32_t (*pMutexCreate) (uPortMutexHandle_t *),
+                               uPortMutexHandle_t *pMutex)
+{
+    int32_t errorCode;
+
+    if (pMutexCreate != NULL) {
+        errorCode = pMutexCreate(pMutex);
+    } else {
+        errorCode = uPortMutexCreate(pMutex);
+        if (errorCode == 0) {
+            // Mark the call to uPortMutexCreate() as perpetual for accounting purposes
+            uPortOsResourcePerpetualAdd(U_PORT_OS_RESOURCE_TYPE_MUTEX);
+        }
+    }
+
+    return errorCode;
+}
+#endif
+
+#ifdef U_CFG_HEAP_PROFILE
+// Write a uint32_t, little-endian, to a buffer.
+static void putUint32(char *pBuffer, uint32_t value)
+{
+    for (size_t x = 0; x < sizeof(value); x++) {
+        *pBuffer = (char) (value & 0xff);
+        pBuffer++;
+        value >>= 8;
+    }
+}
+
+// Count a sampled allocation against its call site.
+static void profileSample(size_t sizeBytes, const char *pFile, int32_t line)
+{
+    uPortHeapProfileSite_t *pSite = NULL;
+    // Only the file pointer is hashed here, quick, since the same
+    // file is always at the same address in a given image
+    size_t index = (((uintptr_t) pFile) ^ (((uint32_t) line) * 0x9e3779b1UL)) &
+                   (U_PORT_HEAP_PROFILE_NUM_SITES - 1);
+    uint32_t fileHash;
+
+    U_PORT_HEAP_MUTEX_LOCK(gHeapProfileMutex);
+
+    // Probe linearly for the entry of this call site, or an empty one
+    for (size_t x = 0; (x < U_PORT_HEAP_PROFILE_NUM_SITES) && (pSite == NULL); x++) {
+        if (gHeapProfileSite[index].pFile == NULL) {
+            // FNV-1a of the file name, so that the output of
+            // uPortHeapProfileDump() can be decoded off-target
+            fileHash = 0x811c9dc5UL;
+            for (const char *pTmp = pFile; *pTmp != 0; pTmp++) {
+                fileHash = (fileHash ^ (uint8_t) *pTmp) * 0x01000193UL;
+            }
+            gHeapProfileSite[index].pFile = pFile;
+            gHeapProfileSite[index].line = line;
+            gHeapProfileSite[index].fileHash = fileHash;
+        }
+        if ((gHeapProfileSite[index].pFile == pFile) &&
+            (gHeapProfileSite[index].line == line)) {
+            pSite = &(gHeapProfileSite[index]);
+        }
+        index = (index + 1) & (U_PORT_HEAP_PROFILE_NUM_SITES - 1);
+    }
+    if (pSite != NULL) {
+        pSite->allocCount++;
+        pSite->allocBytes += (uint32_t) sizeBytes;
+    } else {
+        gHeapProfileDropCount++;
+    }
+
+    U_PORT_HEAP_MUTEX_UNLOCK(gHeapProfileMutex);
+}
+#endif
+
+#ifdef U_CFG_HEAP_BUDGET
+// Return true if pFragment is found in pPath, treating '\\' in
+// pPath as '/' so that Windows paths work too.
+static bool pathContains(const char *pPath, const char *pFragment)
+{
+    bool found = false;
+    const char *pP;
+    const char *pF;
+
+    for (; (*pPath != 0) && !found; pPath++) {
+        pP = pPath;
+        pF = pFragment;
+        while ((*pF != 0) && ((*pP == *pF) || ((*pP == '\\') && (*pF == '/')))) {
+            pP++;
+            pF++;
+        }
+        found = (*pF == 0);
+    }
+
+    return found;
+}
+
+// Work out the tag of a source file.
+static uPortHeapTag_t budgetTag(const char *pFile)
+{
+    uPortHeapTag_t tag = U_PORT_HEAP_TAG_OTHER;
+    size_t index = (((uintptr_t) pFile) >> 2) & (U_PORT_HEAP_BUDGET_NUM_FILES - 1);
+
+    // Not protected: the worst a race can do is cause the path to
+    // be searched again
+    if (gHeapBudgetFile[index].pFile == pFile) {
+        tag = gHeapBudgetFile[index].tag;
+    } else {
+        for (size_t x = 0; x < sizeof(gHeapBudgetPath) / sizeof(gHeapBudgetPath[0]); x++) {
+            if (pathContains(pFile, gHeapBudgetPath[x].pFragment)) {
+                tag = gHeapBudgetPath[x].tag;
+                break;
+            }
+        }
+        gHeapBudgetFile[index].tag = tag;
+        gHeapBudgetFile[index].pFile = pFile;
+    }
+
+    return tag;
+}
+
+// Lock gHeapBudgetMutex, if it exists, returning the mutex that
+// was locked (or NULL), which should be passed to budgetUnlock();
+// the lock/unlock macros can't be used as the mutex may be NULL.
+static uPortMutexHandle_t budgetLock()
+{
+    uPortMutexHandle_t mutex = gHeapBudgetMutex;
+
+    if (mutex != NULL) {
+        if (gpMutexLock != NULL) {
+            gpMutexLock(mutex);
+        } else {
+            uPortMutexLock(mutex);
+        }
+    }
+
+    return mutex;
+}
+
+// Unlock the mutex returned by budgetLock().
+static void budgetUnlock(uPortMutexHandle_t mutex)
+{
+    if (mutex != NULL) {
+        if (gpMutexUnlock != NULL) {
+            gpMutexUnlock(mutex);
+        } else {
+            uPortMutexUnlock(mutex);
+        }
+    }
+}
+
+// Add to (isAlloc true) or take away from the live heap of a tag.
+static void budgetUpdate(uPortHeapTag_t tag, size_t sizeBytes, bool isAlloc)
+{
+    uPortHeapBudget_t *pBudget = &(gHeapBudget[tag]);
+    uPortMutexHandle_t mutex = budgetLock();
+
+    if (isAlloc) {
+        pBudget->liveBytes += sizeBytes;
+        if (pBudget->liveBytes > pBudget->peakBytes) {
+            pBudget->peakBytes = pBudget->liveBytes;
+        }
+    } else if (pBudget->liveBytes >= sizeBytes) {
+        pBudget->liveBytes -= sizeBytes;
+    } else {
+        pBudget->liveBytes = 0;
+    }
+    budgetUnlock(mutex);
+}
+#endif
+
+#if U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0
+// Take a block from the pool, NULL if there isn't a free one that
+// is big enough.
+static void *pPoolAlloc(size_t sizeBytes)
+{
+    void *pBlock = NULL;
+    size_t poolClass = 0;
+
+    if ((gPoolMutex != NULL) &&
+        (sizeBytes <= U_PORT_HEAP_POOL_BLOCK_SIZE_BYTES(U_PORT_HEAP_POOL_NUM_CLASSES - 1))) {
+        while (sizeBytes > U_PORT_HEAP_POOL_BLOCK_SIZE_BYTES(poolClass)) {
+            poolClass++;
+        }
+
+        U_PORT_HEAP_MUTEX_LOCK(gPoolMutex);
+
+        // Only the class that fits is used, a larger block would be
+        // better employed by a larger allocation
+        pBlock = gpPoolFree[poolClass];
+        if (pBlock != NULL) {
+            gpPoolFree[poolClass] = *((void **) pBlock);
+        }
+
+        U_PORT_HEAP_MUTEX_UNLOCK(gPoolMutex);
+    }
+
+    return pBlock;
+}
+
+// Return a block to the pool, returning false if it isn't
+// from the pool.
+static bool poolFree(void *pMemory)
+{
+    bool isFromPool = false;
+    size_t offset = ((char *) pMemory) - ((char *) gPool);
+    size_t poolClass = 0;
+
+    if ((pMemory >= (void *) gPool) && (offset < sizeof(gPool))) {
+        while (offset >= U_PORT_HEAP_POOL_CLASS_OFFSET_BYTES(poolClass + 1)) {
+            poolClass++;
+        }
+
+        U_PORT_HEAP_MUTEX_LOCK(gPoolMutex);
+
+        *((void **) pMemory) = gpPoolFree[poolClass];
+        gpPoolFree[poolClass] = pMemory;
+
+        U_PORT_HEAP_MUTEX_UNLOCK(gPoolMutex);
+
+        isFromPool = true;
+    }
+
+    return isFromPool;
+}
+
+// Set up the pool and the mutex that protects it.
+static int32_t poolInit(int32_t (*pMutexCreate) (uPortMutexHandle_t *))
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    uPortMutexHandle_t mutex = NULL;
+    char *pBlock;
+
+    if (gPoolMutex == NULL) {
+        errorCode = heapMutexCreate(pMutexCreate, &mutex);
+        if (errorCode == 0) {
+            // Link each class together, lowest address first
+            for (size_t x = 0; x < U_PORT_HEAP_POOL_NUM_CLASSES; x++) {
+                gpPoolFree[x] = NULL;
+                pBlock = ((char *) gPool) + U_PORT_HEAP_POOL_CLASS_OFFSET_BYTES(x + 1);
+                for (size_t y = 0; y < U_PORT_HEAP_POOL_BLOCKS_PER_CLASS; y++) {
+                    pBlock -= U_PORT_HEAP_POOL_BLOCK_SIZE_BYTES(x);
+                    *((void **) pBlock) = gpPoolFree[x];
+                    gpPoolFree[x] = pBlock;
+                }
+            }
+            // The pool is in use from here on
+            gPoolMutex = mutex;
+        }
+    }
+
+    return errorCode;
+}
+#endif
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
 
-#ifdef U_CFG_HEAP_MONITOR
-// For heap monitoring, pUPortMalloc() becomes static _pUPortMalloc()
-// which we call internally from pUPortMallocMonitor().
+#if defined(U_CFG_HEAP_MONITOR) || defined(U_CFG_HEAP_PROFILE) || \
+    defined(U_CFG_HEAP_BUDGET)
+// For heap monitoring, profiling or budget accounting, pUPortMalloc()
+// becomes static _pUPortMalloc() which we call internally from
+// pUPortMallocMonitor(), pUPortMallocProfile() or pUPortMallocBudget().
 static void *_pUPortMalloc(size_t sizeBytes)
 #else
 U_WEAK void *pUPortMalloc(size_t sizeBytes)
 #endif
 {
-    void *pMalloc = malloc(sizeBytes);
+    void *pMalloc = NULL;
+#if U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0
+    pMalloc = pPoolAlloc(sizeBytes);
+    if (pMalloc == NULL)
+#endif
+    {
+        pMalloc = malloc(sizeBytes);
+    }
     if (pMalloc != NULL) {
         gHeapAllocCount++;
     }
@@ -252,6 +722,41 @@ void *pUPortMallocMonitor(size_t sizeBytes, const char *pFile,
 
     return pMemory;
 }
+#elif defined(U_CFG_HEAP_PROFILE)
+// The malloc call that replaces pUPortMalloc() when U_CFG_HEAP_PROFILE
+// is defined.
+void *pUPortMallocProfile(size_t sizeBytes, const char *pFile,
+                          int32_t line)
+{
+    // Not protected, an occasional lost count doesn't matter
+    // and this keeps the unsampled case cheap
+    if (((gHeapProfileAllocCount % U_PORT_HEAP_PROFILE_SAMPLE_EVERY) == 0) &&
+        (gHeapProfileMutex != NULL)) {
+        profileSample(sizeBytes, pFile, line);
+    }
+    gHeapProfileAllocCount++;
+
+    return _pUPortMalloc(sizeBytes);
+}
+#elif defined(U_CFG_HEAP_BUDGET)
+// The malloc call that replaces pUPortMalloc() when U_CFG_HEAP_BUDGET
+// is defined.
+void *pUPortMallocBudget(size_t sizeBytes, const char *pFile)
+{
+    char *pMemory = NULL;
+    uPortHeapBudgetHeader_t *pHeader;
+
+    pHeader = (uPortHeapBudgetHeader_t *) _pUPortMalloc(sizeBytes +
+                                                         U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES);
+    if (pHeader != NULL) {
+        pHeader->size = sizeBytes;
+        pHeader->tag = budgetTag(pFile);
+        budgetUpdate(pHeader->tag, sizeBytes, true);
+        pMemory = ((char *) pHeader) + U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES;
+    }
+
+    return pMemory;
+}
 #endif
 
 U_WEAK void uPortFree(void *pMemory)
@@ -314,10 +819,25 @@ U_WEAK void uPortFree(void *pMemory)
         // pBlock is what we need to free
         pMemory = pBlock;
     }
+#elif defined(U_CFG_HEAP_BUDGET)
+    uPortHeapBudgetHeader_t *pHeader;
+
+    if (pMemory != NULL) {
+        // Wind back to the header, which is what we need to free
+        pHeader = (uPortHeapBudgetHeader_t *) (((char *) pMemory) -
+                                               U_PORT_HEAP_BUDGET_HEADER_SIZE_BYTES);
+        budgetUpdate(pHeader->tag, pHeader->size, false);
+        pMemory = pHeader;
+    }
 #endif
 
     gHeapAllocCount--;
-    free(pMemory);
+#if U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0
+    if (!poolFree(pMemory))
+#endif
+    {
+        free(pMemory);
+    }
 }
 
 U_WEAK int32_t uPortHeapAllocCount()
@@ -358,6 +878,120 @@ int32_t uPortHeapDump(const char *pPrefix)
     return x;
 }
 
+// Write the heap profile to a buffer.
+int32_t uPortHeapProfileDump(char *pBuffer, size_t sizeBytes)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#ifdef U_CFG_HEAP_PROFILE
+    size_t numRecords = 0;
+    char *pRecord;
+
+    sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    if (gHeapProfileMutex != NULL) {
+        sizeOrErrorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        if ((pBuffer == NULL) || (sizeBytes >= U_PORT_HEAP_PROFILE_DUMP_HEADER_SIZE_BYTES)) {
+
+            U_PORT_HEAP_MUTEX_LOCK(gHeapProfileMutex);
+
+            pRecord = pBuffer + U_PORT_HEAP_PROFILE_DUMP_HEADER_SIZE_BYTES;
+            for (size_t x = 0; x < U_PORT_HEAP_PROFILE_NUM_SITES; x++) {
+                if ((gHeapProfileSite[x].pFile != NULL) &&
+                    ((pBuffer == NULL) ||
+                     (sizeBytes >= U_PORT_HEAP_PROFILE_DUMP_HEADER_SIZE_BYTES +
+                      ((numRecords + 1) * U_PORT_HEAP_PROFILE_DUMP_RECORD_SIZE_BYTES)))) {
+                    if (pBuffer != NULL) {
+                        putUint32(pRecord, gHeapProfileSite[x].fileHash);
+                        putUint32(pRecord + 4, (uint32_t) gHeapProfileSite[x].line);
+                        putUint32(pRecord + 8, gHeapProfileSite[x].allocCount);
+                        putUint32(pRecord + 12, gHeapProfileSite[x].allocBytes);
+                        pRecord += U_PORT_HEAP_PROFILE_DUMP_RECORD_SIZE_BYTES;
+                    }
+                    numRecords++;
+                }
+            }
+            if (pBuffer != NULL) {
+                pBuffer[0] = 'H';
+                pBuffer[1] = 'P';
+                pBuffer[2] = U_PORT_HEAP_PROFILE_DUMP_VERSION;
+                pBuffer[3] = (char) numRecords;
+                putUint32(pBuffer + 4, U_PORT_HEAP_PROFILE_SAMPLE_EVERY);
+                putUint32(pBuffer + 8, gHeapProfileAllocCount);
+                putUint32(pBuffer + 12, gHeapProfileDropCount);
+            }
+
+            U_PORT_HEAP_MUTEX_UNLOCK(gHeapProfileMutex);
+
+            sizeOrErrorCode = (int32_t) (U_PORT_HEAP_PROFILE_DUMP_HEADER_SIZE_BYTES +
+                                         (numRecords * U_PORT_HEAP_PROFILE_DUMP_RECORD_SIZE_BYTES));
+        }
+    }
+#else
+    (void) pBuffer;
+    (void) sizeBytes;
+#endif
+
+    return sizeOrErrorCode;
+}
+
+// Reset the heap profile.
+void uPortHeapProfileReset()
+{
+#ifdef U_CFG_HEAP_PROFILE
+    if (gHeapProfileMutex != NULL) {
+
+        U_PORT_HEAP_MUTEX_LOCK(gHeapProfileMutex);
+
+        memset(gHeapProfileSite, 0, sizeof(gHeapProfileSite));
+        gHeapProfileAllocCount = 0;
+        gHeapProfileDropCount = 0;
+
+        U_PORT_HEAP_MUTEX_UNLOCK(gHeapProfileMutex);
+    }
+#endif
+}
+
+// Get the live and peak heap of a subsystem.
+int32_t uPortHeapBudgetGet(uPortHeapTag_t tag, size_t *pLiveBytes,
+                           size_t *pPeakBytes)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+#ifdef U_CFG_HEAP_BUDGET
+    uPortMutexHandle_t mutex;
+
+    errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    if (((int32_t) tag >= 0) && (tag < U_PORT_HEAP_TAG_MAX_NUM)) {
+        mutex = budgetLock();
+        if (pLiveBytes != NULL) {
+            *pLiveBytes = gHeapBudget[tag].liveBytes;
+        }
+        if (pPeakBytes != NULL) {
+            *pPeakBytes = gHeapBudget[tag].peakBytes;
+        }
+        budgetUnlock(mutex);
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+#else
+    (void) tag;
+    (void) pLiveBytes;
+    (void) pPeakBytes;
+#endif
+
+    return errorCode;
+}
+
+// Reset the peak heap of all subsystems.
+void uPortHeapBudgetReset()
+{
+#ifdef U_CFG_HEAP_BUDGET
+    uPortMutexHandle_t mutex = budgetLock();
+
+    for (size_t x = 0; x < sizeof(gHeapBudget) / sizeof(gHeapBudget[0]); x++) {
+        gHeapBudget[x].peakBytes = gHeapBudget[x].liveBytes;
+    }
+    budgetUnlock(mutex);
+#endif
+}
+
 // Initialise heap monitoring.
 int32_t uPortHeapMonitorInit(int32_t (*pMutexCreate) (uPortMutexHandle_t *),
                              int32_t (*pMutexLock) (const uPortMutexHandle_t),
@@ -367,20 +1001,32 @@ int32_t uPortHeapMonitorInit(int32_t (*pMutexCreate) (uPortMutexHandle_t *),
 
 #ifdef U_CFG_HEAP_MONITOR
     if (gMutex == NULL) {
-        if (pMutexCreate != NULL) {
-            errorCode = pMutexCreate(&gMutex);
-        } else {
-            errorCode = uPortMutexCreate(&gMutex);
-        }
+        errorCode = heapMutexCreate(pMutexCreate, &gMutex);
         if (errorCode == 0) {
-            if (pMutexCreate == NULL) {
-                // Mark the call to uPortMutexCreate() as perpetual for accounting purposes
-                uPortOsResourcePerpetualAdd(U_PORT_OS_RESOURCE_TYPE_MUTEX);
-            }
             gpMutexLock = pMutexLock;
             gpMutexUnlock = pMutexUnlock;
         }
     }
+#elif defined(U_CFG_HEAP_PROFILE)
+    if (gHeapProfileMutex == NULL) {
+        gpMutexLock = pMutexLock;
+        gpMutexUnlock = pMutexUnlock;
+        errorCode = heapMutexCreate(pMutexCreate, &gHeapProfileMutex);
+    }
+#elif defined(U_CFG_HEAP_BUDGET)
+    if (gHeapBudgetMutex == NULL) {
+        gpMutexLock = pMutexLock;
+        gpMutexUnlock = pMutexUnlock;
+        errorCode = heapMutexCreate(pMutexCreate, &gHeapBudgetMutex);
+    }
+#endif
+
+#if U_PORT_HEAP_POOL_BLOCKS_PER_CLASS > 0
+    if (errorCode == 0) {
+        gpMutexLock = pMutexLock;
+        gpMutexUnlock = pMutexUnlock;
+        errorCode = poolInit(pMutexCreate);
+    }
 #endif
 
     return errorCode;
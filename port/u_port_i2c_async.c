@@ -0,0 +1,242 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Implementation of uPortI2cControllerSendReceiveAsync(), common
+ * to all platforms: transactions are queued to a task which performs
+ * them with uPortI2cControllerSendReceive().
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"     // NULL, size_t etc.
+#include "stdint.h"     // int32_t etc.
+#include "stdbool.h"
+
+#include "u_cfg_os_platform_specific.h" // U_CFG_OS_PRIORITY_MAX
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_i2c.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/** A queued transaction; a handle of less than zero tells the
+ * task to exit.
+ */
+typedef struct {
+    int32_t handle;
+    uint16_t address;
+    const char *pSend;
+    size_t bytesToSend;
+    char *pReceive;
+    size_t bytesToReceive;
+    uPortI2cTransactionCallback_t *pCallback;
+    void *pCallbackParam;
+} uPortI2cAsyncTransaction_t;
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** Mutex to ensure thread-safety.
+ */
+static uPortMutexHandle_t gMutex = NULL;
+
+/** The queue of transactions, NULL until the first transaction
+ * is queued.
+ */
+static uPortQueueHandle_t gQueue = NULL;
+
+/** Given by the task when it exits.
+ */
+static uPortSemaphoreHandle_t gExitedSemaphore = NULL;
+
+/** Set to make the task cancel, rather than perform, the
+ * transactions that remain in the queue.
+ */
+static volatile bool gCancel = false;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// The task that performs the queued transactions; gMutex is not
+// locked here, it is only needed to get things into the queue.
+static void transactionTask(void *pParam)
+{
+    uPortQueueHandle_t queue = (uPortQueueHandle_t) pParam;
+    uPortI2cAsyncTransaction_t transaction = {0};
+    int32_t errorCodeOrLength;
+
+    while (transaction.handle >= 0) {
+        if (uPortQueueReceive(queue, &transaction) == 0) {
+            if (transaction.handle >= 0) {
+                errorCodeOrLength = (int32_t) U_ERROR_COMMON_CANCELLED;
+                if (!gCancel) {
+                    errorCodeOrLength = uPortI2cControllerSendReceive(transaction.handle,
+                                                                      transaction.address,
+                                                                      transaction.pSend,
+                                                                      transaction.bytesToSend,
+                                                                      transaction.pReceive,
+                                                                      transaction.bytesToReceive);
+                }
+                if (transaction.pCallback != NULL) {
+                    transaction.pCallback(transaction.handle, errorCodeOrLength,
+                                          transaction.pCallbackParam);
+                }
+            }
+        }
+    }
+
+    uPortSemaphoreGive(gExitedSemaphore);
+
+    uPortTaskDelete(NULL);
+}
+
+// Create the queue and start the task; gMutex must be locked.
+static int32_t start()
+{
+    int32_t errorCode;
+    uPortTaskHandle_t taskHandle;
+
+    errorCode = uPortQueueCreate(U_PORT_I2C_ASYNC_QUEUE_LENGTH,
+                                 sizeof(uPortI2cAsyncTransaction_t),
+                                 &gQueue);
+    if (errorCode == 0) {
+        errorCode = uPortSemaphoreCreate(&gExitedSemaphore, 0, 1);
+        if (errorCode == 0) {
+            gCancel = false;
+            errorCode = uPortTaskCreate(transactionTask, "i2cAsync",
+                                        U_PORT_I2C_ASYNC_TASK_STACK_SIZE_BYTES,
+                                        (void *) gQueue,
+                                        U_PORT_I2C_ASYNC_TASK_PRIORITY,
+                                        &taskHandle);
+            if (errorCode != 0) {
+                uPortSemaphoreDelete(gExitedSemaphore);
+                gExitedSemaphore = NULL;
+            }
+        }
+        if (errorCode != 0) {
+            // Clean up on error
+            uPortQueueDelete(gQueue);
+            gQueue = NULL;
+        }
+    }
+
+    return errorCode;
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Initialise asynchronous I2C transactions.
+int32_t uPortI2cAsyncInit()
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+
+    if (gMutex == NULL) {
+        errorCode = uPortMutexCreate(&gMutex);
+    }
+
+    return errorCode;
+}
+
+// Deinitialise asynchronous I2C transactions.
+void uPortI2cAsyncDeinit()
+{
+    uPortI2cAsyncTransaction_t transaction = {0};
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        if (gQueue != NULL) {
+            // Cancel whatever is left in the queue and
+            // then tell the task to exit
+            gCancel = true;
+            transaction.handle = -1;
+            uPortQueueSend(gQueue, &transaction);
+            uPortSemaphoreTake(gExitedSemaphore);
+            // Give the task time to delete itself, since the
+            // OS may be shut down right after this
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+            uPortSemaphoreDelete(gExitedSemaphore);
+            gExitedSemaphore = NULL;
+            uPortQueueDelete(gQueue);
+            gQueue = NULL;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+        uPortMutexDelete(gMutex);
+        gMutex = NULL;
+    }
+}
+
+// Queue an I2C transaction.
+int32_t uPortI2cControllerSendReceiveAsync(int32_t handle, uint16_t address,
+                                           const char *pSend, size_t bytesToSend,
+                                           char *pReceive, size_t bytesToReceive,
+                                           uPortI2cTransactionCallback_t *pCallback,
+                                           void *pCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uPortI2cAsyncTransaction_t transaction;
+
+    if (gMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        if ((handle >= 0) &&
+            ((pSend != NULL) || (bytesToSend == 0)) &&
+            ((pReceive != NULL) || (bytesToReceive == 0))) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            if (gQueue == NULL) {
+                // Only start the task when it is first needed
+                errorCode = start();
+            }
+            if (errorCode == 0) {
+                transaction.handle = handle;
+                transaction.address = address;
+                transaction.pSend = pSend;
+                transaction.bytesToSend = bytesToSend;
+                transaction.pReceive = pReceive;
+                transaction.bytesToReceive = bytesToReceive;
+                transaction.pCallback = pCallback;
+                transaction.pCallbackParam = pCallbackParam;
+                errorCode = uPortQueueSend(gQueue, &transaction);
+            }
+        }
+
+        U_PORT_MUTEX_UNLOCK(gMutex);
+    }
+
+    return errorCode;
+}
+
+// End of file
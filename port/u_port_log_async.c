@@ -0,0 +1,367 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Implementation of asynchronous logging, common to all
+ * platforms: uPortLogF() formats prints into a ring buffer, space
+ * in which is reserved with a compare-and-swap so that no task
+ * waits on another, and a task writes the ring buffer out.
+ *
+ * Each print is a record in the ring: a 32-bit header, giving the
+ * length of the print and whether it has been completely written,
+ * followed by the null-terminated print, padded to a multiple of
+ * four bytes.  A record never wraps around the end of the ring:
+ * where it would, the space up to the end is reserved as well
+ * and filled with a padding record.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"     // NULL, size_t etc.
+#include "stdint.h"     // int32_t etc.
+#include "stdbool.h"
+#include "stdarg.h"
+#include "stdio.h"      // vsnprintf()
+#include "string.h"     // memset()
+
+#include "u_cfg_os_platform_specific.h" // U_CFG_OS_PRIORITY_MIN
+#include "u_compiler.h" // U_ATOMIC_XXX()
+
+#include "u_error_common.h"
+
+#include "u_port.h"
+#include "u_port_os.h"
+#include "u_port_heap.h"
+#include "u_port_debug.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+#if (U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES & (U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES - 1)) != 0
+# error U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES must be a power of two.
+#endif
+
+#if U_PORT_LOG_ASYNC_MAX_LENGTH_BYTES >= U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES / 2
+# error U_PORT_LOG_ASYNC_MAX_LENGTH_BYTES must be less than half of U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES.
+#endif
+
+/** Set in the header of a record once it has been written.
+ */
+#define U_PORT_LOG_ASYNC_HEADER_COMMITTED 0x80000000UL
+
+/** Set in the header of a padding record.
+ */
+#define U_PORT_LOG_ASYNC_HEADER_PADDING 0x40000000UL
+
+/** The part of the header of a record that is the length: for
+ * a print this is the length without the null terminator, for
+ * padding the number of bytes after the header.
+ */
+#define U_PORT_LOG_ASYNC_HEADER_LENGTH_MASK 0x0000FFFFUL
+
+/** The size of a record header.
+ */
+#define U_PORT_LOG_ASYNC_HEADER_SIZE_BYTES sizeof(uint32_t)
+
+/** The size of the record holding a print of the given length.
+ */
+#define U_PORT_LOG_ASYNC_RECORD_SIZE_BYTES(length) \
+    (U_PORT_LOG_ASYNC_HEADER_SIZE_BYTES + (((length) + 1 + 3) & ~3UL))
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/** The ring buffer.
+ */
+static char *gpBuffer = NULL;
+
+/** The ring buffer as writers see it: NULL when asynchronous
+ * logging is off or is being switched off.
+ */
+static char *volatile gpRing = NULL;
+
+/** The total number of bytes ever reserved in gpRing by writers:
+ * the offset into gpRing of the next record is this modulo
+ * the size of the ring.
+ */
+static volatile uint32_t gReserved = 0;
+
+/** The total number of bytes ever read from gpRing by the task.
+ */
+static volatile uint32_t gRead = 0;
+
+/** The number of writers currently in uPortLogAsyncWrite(), so that
+ * uPortLogAsyncStop() knows when it can free gpRing.
+ */
+static volatile int32_t gWriterCount = 0;
+
+/** The number of prints dropped because gpRing was full.
+ */
+static volatile int32_t gDropCount = 0;
+
+/** Set to tell the task to write out what is left and exit.
+ */
+static volatile bool gStop = false;
+
+/** The task that writes gpRing out.
+ */
+static uPortTaskHandle_t gTaskHandle = NULL;
+
+/** Given to wake the task up.
+ */
+static uPortSemaphoreHandle_t gWakeSemaphore = NULL;
+
+/** Given by the task when it exits.
+ */
+static uPortSemaphoreHandle_t gExitedSemaphore = NULL;
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Write out everything that has been committed to gpRing.
+static void flush()
+{
+    uint32_t read = gRead;
+    uint32_t header;
+    uint32_t length;
+    uint32_t recordSizeBytes;
+    char *pRecord;
+    bool stop = false;
+
+    while (!stop && (read != U_ATOMIC_GET(&gReserved))) {
+        pRecord = gpBuffer + (read & (U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES - 1));
+        header = U_ATOMIC_GET((volatile uint32_t *) pRecord);
+        if ((header & U_PORT_LOG_ASYNC_HEADER_COMMITTED) == 0) {
+            // A writer is still busy with this one, come back later
+            stop = true;
+        } else {
+            length = header & U_PORT_LOG_ASYNC_HEADER_LENGTH_MASK;
+            if (header & U_PORT_LOG_ASYNC_HEADER_PADDING) {
+                recordSizeBytes = U_PORT_LOG_ASYNC_HEADER_SIZE_BYTES + length;
+            } else {
+                recordSizeBytes = U_PORT_LOG_ASYNC_RECORD_SIZE_BYTES(length);
+                // This task is the one that uPortLogAsyncWrite()
+                // lets through to the platform's normal output
+                uPortLogF("%s", pRecord + U_PORT_LOG_ASYNC_HEADER_SIZE_BYTES);
+            }
+            // Clear the header before handing the space back so that
+            // it does not look committed the next time around the ring
+            U_ATOMIC_SET((volatile uint32_t *) pRecord, 0);
+            read += recordSizeBytes;
+            U_ATOMIC_SET(&gRead, read);
+        }
+    }
+}
+
+// The task that writes gpRing out.
+static void logTask(void *pParam)
+{
+    int32_t dropCountReported = 0;
+    int32_t dropCount;
+    bool stop = false;
+
+    (void) pParam;
+
+    while (!stop) {
+        uPortSemaphoreTryTake(gWakeSemaphore, U_PORT_LOG_ASYNC_FLUSH_INTERVAL_MS);
+        // Read gStop before flushing, so that what was written
+        // before uPortLogAsyncStop() was called is not missed
+        stop = gStop;
+        flush();
+        dropCount = U_ATOMIC_GET(&gDropCount);
+        if (dropCount != dropCountReported) {
+            uPortLogF("U_PORT_LOG: %d log print(s) dropped, buffer full.\n",
+                      dropCount - dropCountReported);
+            dropCountReported = dropCount;
+        }
+    }
+
+    uPortSemaphoreGive(gExitedSemaphore);
+
+    uPortTaskDelete(NULL);
+}
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Switch asynchronous logging on.
+int32_t uPortLogAsyncStart(void)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+
+    if (gpBuffer == NULL) {
+        errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+        gpBuffer = (char *) pUPortMalloc(U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES);
+        if (gpBuffer != NULL) {
+            memset(gpBuffer, 0, U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES);
+            gReserved = 0;
+            gRead = 0;
+            gDropCount = 0;
+            gStop = false;
+            errorCode = uPortSemaphoreCreate(&gWakeSemaphore, 0, 1);
+            if (errorCode == 0) {
+                errorCode = uPortSemaphoreCreate(&gExitedSemaphore, 0, 1);
+                if (errorCode == 0) {
+                    errorCode = uPortTaskCreate(logTask, "logAsync",
+                                                U_PORT_LOG_ASYNC_TASK_STACK_SIZE_BYTES,
+                                                NULL, U_PORT_LOG_ASYNC_TASK_PRIORITY,
+                                                &gTaskHandle);
+                    if (errorCode == 0) {
+                        // Only now can writers start using the ring
+                        U_ATOMIC_SET(&gpRing, gpBuffer);
+                    } else {
+                        uPortSemaphoreDelete(gExitedSemaphore);
+                        gExitedSemaphore = NULL;
+                    }
+                }
+                if (errorCode != 0) {
+                    uPortSemaphoreDelete(gWakeSemaphore);
+                    gWakeSemaphore = NULL;
+                }
+            }
+            if (errorCode != 0) {
+                // Clean up on error
+                uPortFree(gpBuffer);
+                gpBuffer = NULL;
+            }
+        }
+    }
+
+    return errorCode;
+}
+
+// Switch asynchronous logging off.
+void uPortLogAsyncStop(void)
+{
+    if (gpBuffer != NULL) {
+        // Stop new writers using the ring and wait for
+        // those that already are to finish
+        U_ATOMIC_SET(&gpRing, NULL);
+        while (U_ATOMIC_GET(&gWriterCount) > 0) {
+            uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        }
+        // The task writes out what is left and exits
+        gStop = true;
+        uPortSemaphoreGive(gWakeSemaphore);
+        uPortSemaphoreTake(gExitedSemaphore);
+        // Give the task time to delete itself, since the
+        // OS may be shut down right after this
+        uPortTaskBlock(U_CFG_OS_YIELD_MS);
+        gTaskHandle = NULL;
+        uPortSemaphoreDelete(gExitedSemaphore);
+        gExitedSemaphore = NULL;
+        uPortSemaphoreDelete(gWakeSemaphore);
+        gWakeSemaphore = NULL;
+        uPortFree(gpBuffer);
+        gpBuffer = NULL;
+    }
+}
+
+// Get the number of log prints that have been dropped.
+int32_t uPortLogAsyncGetDropCount(void)
+{
+    return U_ATOMIC_GET(&gDropCount);
+}
+
+// Take a print, if asynchronous logging is on.
+bool uPortLogAsyncWrite(const char *pFormat, va_list args)
+{
+    bool taken = false;
+    char *pRing;
+    va_list argsCopy;
+    int32_t length;
+    uint32_t reserved;
+    uint32_t offset;
+    uint32_t spaceToEnd;
+    uint32_t recordSizeBytes;
+    uint32_t reserveSizeBytes;
+    uint32_t recordStart;
+    bool full;
+    bool retry;
+
+    // Quick exit if asynchronous logging is off
+    if ((U_ATOMIC_GET(&gpRing) != NULL) && !uPortTaskIsThis(gTaskHandle)) {
+        U_ATOMIC_INCREMENT(&gWriterCount);
+        pRing = U_ATOMIC_GET(&gpRing);
+        // Check again now that uPortLogAsyncStop() knows we're here
+        if (pRing != NULL) {
+            taken = true;
+            // Find out how long the print is going to be
+            va_copy(argsCopy, args);
+            length = vsnprintf(NULL, 0, pFormat, argsCopy);
+            va_end(argsCopy);
+            if (length > U_PORT_LOG_ASYNC_MAX_LENGTH_BYTES) {
+                length = U_PORT_LOG_ASYNC_MAX_LENGTH_BYTES;
+            }
+            if (length > 0) {
+                recordSizeBytes = U_PORT_LOG_ASYNC_RECORD_SIZE_BYTES(length);
+                // Reserve space for the record, plus the space to the
+                // end of the ring if the record wouldn't fit there
+                do {
+                    reserved = U_ATOMIC_GET(&gReserved);
+                    offset = reserved & (U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES - 1);
+                    spaceToEnd = U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES - offset;
+                    reserveSizeBytes = recordSizeBytes;
+                    if (recordSizeBytes > spaceToEnd) {
+                        reserveSizeBytes += spaceToEnd;
+                    }
+                    full = (reserved + reserveSizeBytes - U_ATOMIC_GET(&gRead) >
+                            U_PORT_LOG_ASYNC_BUFFER_SIZE_BYTES);
+                    retry = !full && !U_ATOMIC_COMPARE_AND_SWAP(&gReserved, reserved,
+                                                                reserved + reserveSizeBytes);
+                } while (retry);
+                if (full) {
+                    U_ATOMIC_INCREMENT(&gDropCount);
+                } else {
+                    if (reserveSizeBytes > recordSizeBytes) {
+                        // Pad to the end of the ring and start from the beginning
+                        U_ATOMIC_SET((volatile uint32_t *) (pRing + offset),
+                                     U_PORT_LOG_ASYNC_HEADER_COMMITTED |
+                                     U_PORT_LOG_ASYNC_HEADER_PADDING |
+                                     (spaceToEnd - U_PORT_LOG_ASYNC_HEADER_SIZE_BYTES));
+                        offset = 0;
+                    }
+                    vsnprintf(pRing + offset + U_PORT_LOG_ASYNC_HEADER_SIZE_BYTES,
+                              length + 1, pFormat, args);
+                    U_ATOMIC_SET((volatile uint32_t *) (pRing + offset),
+                                 U_PORT_LOG_ASYNC_HEADER_COMMITTED | (uint32_t) length);
+                    recordStart = reserved + reserveSizeBytes - recordSizeBytes;
+                    if (U_ATOMIC_GET(&gRead) == recordStart) {
+                        // The task has got as far as this record and
+                        // so may be waiting for it: wake it up; if it
+                        // hasn't got this far it will get here anyway
+                        uPortSemaphoreGive(gWakeSemaphore);
+                    }
+                }
+            }
+        }
+        U_ATOMIC_DECREMENT(&gWriterCount);
+    }
+
+    return taken;
+}
+
+// End of file
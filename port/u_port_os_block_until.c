@@ -0,0 +1,78 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Default implementation of uPortTaskBlockUntil(), built on
+ * uPortGetTickTimeMs() and uPortTaskBlock(), for platforms which do
+ * not have a native "delay until".
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"     // NULL, size_t etc.
+#include "stdint.h"     // int32_t etc.
+#include "stdbool.h"
+#include "u_compiler.h" // U_WEAK
+
+#include "u_port.h"
+#include "u_port_os.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Default implementation of blocking until a time: a single block
+// for whatever is left of the period.
+U_WEAK void uPortTaskBlockUntil(int32_t *pWakeTimeMs, int32_t periodMs)
+{
+    int32_t nowMs;
+    int32_t remainingMs;
+
+    if ((pWakeTimeMs != NULL) && (periodMs > 0)) {
+        // Unsigned arithmetic since the tick time may wrap
+        *pWakeTimeMs = (int32_t) ((uint32_t) *pWakeTimeMs + (uint32_t) periodMs);
+        nowMs = uPortGetTickTimeMs();
+        remainingMs = (int32_t) ((uint32_t) *pWakeTimeMs - (uint32_t) nowMs);
+        if (remainingMs > 0) {
+            uPortTaskBlock(remainingMs);
+        } else if (remainingMs < -periodMs) {
+            // More than a whole period late: start again from now
+            // rather than returning immediately over and over to
+            // catch up
+            *pWakeTimeMs = nowMs;
+        }
+    }
+}
+
+// End of file
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2019-2023 u-blox
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** @file
+ * @brief Default implementation of uPortUartWriteVec(), for platforms
+ * which do not have a native way of writing several buffers at once.
+ */
+
+#ifdef U_CFG_OVERRIDE
+# include "u_cfg_override.h" // For a customer's configuration override
+#endif
+
+#include "stddef.h"     // NULL, size_t etc.
+#include "stdint.h"     // int32_t etc.
+#include "stdbool.h"
+#include "u_compiler.h" // U_WEAK
+
+#include "u_error_common.h"
+
+#include "u_port_uart.h"
+
+/* ----------------------------------------------------------------
+ * COMPILE-TIME MACROS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * TYPES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * VARIABLES
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * STATIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS
+ * -------------------------------------------------------------- */
+
+// Default implementation of writing several buffers: one at a time.
+U_WEAK int32_t uPortUartWriteVec(int32_t handle, const uPortUartIoVec_t *pVec,
+                                 size_t count)
+{
+    int32_t sizeOrErrorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t thisSizeOrErrorCode = 0;
+    bool allSent = true;
+
+    if ((pVec != NULL) || (count == 0)) {
+        sizeOrErrorCode = 0;
+        for (size_t x = 0; (x < count) && allSent; x++) {
+            if (pVec[x].sizeBytes > 0) {
+                thisSizeOrErrorCode = uPortUartWrite(handle, pVec[x].pBuffer,
+                                                     pVec[x].sizeBytes);
+                if (thisSizeOrErrorCode >= 0) {
+                    sizeOrErrorCode += thisSizeOrErrorCode;
+                }
+                allSent = (thisSizeOrErrorCode == (int32_t) pVec[x].sizeBytes);
+            }
+        }
+        if ((thisSizeOrErrorCode < 0) && (sizeOrErrorCode == 0)) {
+            // Nothing was sent: return the error
+            sizeOrErrorCode = thisSizeOrErrorCode;
+        }
+    }
+
+    return sizeOrErrorCode;
+}
+
+// End of file
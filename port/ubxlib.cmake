@@ -121,6 +121,7 @@ list(APPEND UBXLIB_PRIVATE_INC
 # Device and network require special care since they contains stub & optional files
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/common/network/src/u_network.c)
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/common/network/src/u_network_shared.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/common/network/src/u_network_failover.c)
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/common/network/src/u_network_private_ble_extmod_stub.c)
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/common/network/src/u_network_private_cell_stub.c)
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/common/network/src/u_network_private_gnss_stub.c)
@@ -142,6 +143,15 @@ list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_heap.c)
 
 # Default uPortGetTimezoneOffsetSeconds() implementation
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_timezone.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_spi_async.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_os_block_until.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_os_task_info.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_log_async.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_i2c_async.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_gpio_interrupt.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_uart_vec.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_uart_stats.c)
+list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_crypto_crc.c)
 
 # Default uPortXxxResource implementation
 list(APPEND UBXLIB_SRC ${UBXLIB_BASE}/port/u_port_resource.c)
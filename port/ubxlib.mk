@@ -44,6 +44,7 @@ UBXLIB_PRIVATE_INC += \
 # Device and network require special care since they contain stub & optional files
 UBXLIB_SRC += ${UBXLIB_BASE}/common/network/src/u_network.c
 UBXLIB_SRC += ${UBXLIB_BASE}/common/network/src/u_network_shared.c
+UBXLIB_SRC += ${UBXLIB_BASE}/common/network/src/u_network_failover.c
 UBXLIB_SRC += ${UBXLIB_BASE}/common/network/src/u_network_private_ble_extmod_stub.c
 UBXLIB_SRC += ${UBXLIB_BASE}/common/network/src/u_network_private_cell_stub.c
 UBXLIB_SRC += ${UBXLIB_BASE}/common/network/src/u_network_private_gnss_stub.c
@@ -65,6 +66,15 @@ UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_heap.c
 
 # Default uPortGetTimezoneOffsetSeconds() implementation
 UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_timezone.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_spi_async.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_os_block_until.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_os_task_info.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_log_async.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_i2c_async.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_gpio_interrupt.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_uart_vec.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_uart_stats.c
+UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_crypto_crc.c
 
 # Default uPortXxxResource implementation
 UBXLIB_SRC += ${UBXLIB_BASE}/port/u_port_resource.c
@@ -78,6 +78,7 @@
 #include <u_network_config_cell.h>
 #include <u_network_config_gnss.h>
 #include <u_network_config_wifi.h>
+#include <u_network_failover.h>
 #include <u_base64.h>
 #include <u_hex_bin_convert.h>
 #include <u_mempool.h>
@@ -113,6 +114,7 @@
 #include <u_ble_cfg.h>
 #include <u_ble_sps.h>
 #include <u_ble_nus.h>
+#include <u_ble_central.h>
 #include <u_cell_net.h>
 #include <u_cell.h>
 #include <u_cell_cfg.h>
@@ -140,6 +142,14 @@
 #include <u_gnss_dec.h>
 #include <u_gnss_dec_ubx_nav_pvt.h>
 #include <u_gnss_dec_ubx_nav_hpposllh.h>
+#include <u_gnss_dec_ubx_nav_sat.h>
+#include <u_gnss_dec_ubx_nav_sig.h>
+#include <u_gnss_dec_ubx_nav_cov.h>
+#include <u_gnss_dec_ubx_nav_timegps.h>
+#include <u_gnss_dec_ubx_esf_ins.h>
+#include <u_gnss_dec_ubx_rxm_rawx.h>
+#include <u_gnss_dec_ubx_mon_rf.h>
+#include <u_gnss_dec_ubx_tim_tp.h>
 #include <u_gnss_mga.h>
 #include <u_gnss_util.h>
 #include <u_wifi.h>
@@ -22,6 +22,8 @@
  * of another module should be included here; otherwise
  * please keep #includes to your .c files. */
 
+#include "u_wifi_cfg.h"
+
 /** \addtogroup _wifi _Wifi
  *  @{
  */
@@ -77,6 +79,32 @@ extern "C" {
 #define U_WIFI_CIPHER_MASK_AES_CCMP    (1 << 3)
 #define U_WIFI_CIPHER_MASK_UNKNOWN     0xFF /**< This will be the value for modules that doesn't support cipher masks */
 
+#ifndef U_WIFI_SCAN_CACHE_NUM_ENTRIES
+/** The number of access points that are remembered from the
+ * results of uWifiStationScan(), for use by uWifiStationScanCacheGet()
+ * and uWifiStationConnectCached(); must be at least 1.  The cache is
+ * allocated from the heap, around 60 bytes per entry, the first time
+ * uWifiStationScan() is called on an instance and is freed when the
+ * instance is closed.  When the cache is full the oldest entry is
+ * replaced.
+ */
+# define U_WIFI_SCAN_CACHE_NUM_ENTRIES 8
+#endif
+
+#ifndef U_WIFI_SCAN_CACHE_MAX_AGE_SECONDS
+/** How long an access point remains in the scan cache after it was
+ * last seen in the results of uWifiStationScan().
+ */
+# define U_WIFI_SCAN_CACHE_MAX_AGE_SECONDS 300
+#endif
+
+#ifndef U_WIFI_CHANNEL_LIST_MAX_LENGTH
+/** The maximum number of channels in the channel list of the module
+ * that uWifiStationConnectCached() is able to save and restore.
+ */
+# define U_WIFI_CHANNEL_LIST_MAX_LENGTH 40
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -198,6 +226,82 @@ int32_t uWifiSetHostName(uDeviceHandle_t devHandle, const char *pHostName);
 int32_t uWifiStationConnect(uDeviceHandle_t devHandle, const char *pSsid,
                             uWifiAuth_t authentication, const char *pPassPhrase);
 
+/** Connect to a Wifi access point using the scan cache: if an access
+ * point with the given SSID was seen by uWifiStationScan() within
+ * the last #U_WIFI_SCAN_CACHE_MAX_AGE_SECONDS then the channel list of
+ * the module is narrowed to the channel of the strongest such access
+ * point for the connection, so that the module need not scan all
+ * channels before it connects.  If there is no such access point this
+ * behaves exactly as uWifiStationConnect().
+ *
+ * The channel list of the module remains narrowed until the next call
+ * to uWifiStationConnect(), uWifiStationConnectCached() (with
+ * no fresh cache entry) or uWifiStationDisconnect(), which put the
+ * original list back; while it is narrowed the module cannot roam to
+ * an access point on a different channel.  If the connection fails
+ * (i.e. the connection status callback reports disconnected) the
+ * cache entry that was used is removed, so that a second call to this
+ * function will fall back to a full connect.
+ *
+ * @param devHandle        the handle of the wifi instance.
+ * @param[in] pSsid        the Service Set Identifier, cannot be NULL.
+ * @param authentication   the authentication type.
+ * @param[in] pPassPhrase  the passphrase (8-63 ASCII characters as a string) for WPA/WPA2/WPA3.
+ * @return                 zero on successful, else negative error code.
+ *                         Note: there is no actual connection until the Wifi callback reports
+ *                         connected.
+ */
+int32_t uWifiStationConnectCached(uDeviceHandle_t devHandle, const char *pSsid,
+                                  uWifiAuth_t authentication, const char *pPassPhrase);
+
+/** Connect to a Wifi access point with as little AT traffic as
+ * possible, intended for devices that are duty-cycled and so
+ * reconnect to the same access point many times.  Compared with
+ * uWifiStationConnect():
+ *
+ * - if pSsid is NULL the network profile stored in the module by
+ *   uWifiStationStoreConfig() is loaded and used, without first
+ *   changing the start-up behaviour of the module,
+ * - if pSsid, authentication, pPassPhrase and pIpCfg are the same
+ *   as those of the previous successful call to this function, or
+ *   the SSID, authentication and passphrase are the same as those of
+ *   the previous call to uWifiStationConnect() with pIpCfg NULL, and
+ *   the module has not restarted since, none of the station settings
+ *   are written again,
+ * - if pIpCfg is not NULL the given static IPv4 configuration is
+ *   used, so that the module need not wait for DHCP; this may, for
+ *   instance, be the lease obtained by DHCP on a previous connection,
+ *   read with uWifiStationGetIpCfg(), though note that it is up to
+ *   the application to know that the lease is still good.  If pIpCfg
+ *   is NULL the IP settings of the module are left as they are.
+ *
+ * @param devHandle        the handle of the wifi instance.
+ * @param[in] pSsid        the Service Set Identifier, NULL to use the
+ *                         stored network profile.
+ * @param authentication   the authentication type.
+ * @param[in] pPassPhrase  the passphrase (8-63 ASCII characters as a string) for WPA/WPA2/WPA3.
+ * @param[in] pIpCfg       a static IPv4 configuration, may be NULL.
+ * @return                 zero on successful, else negative error code.
+ *                         Note: there is no actual connection until the Wifi callback reports
+ *                         connected.
+ */
+int32_t uWifiStationConnectFast(uDeviceHandle_t devHandle, const char *pSsid,
+                                uWifiAuth_t authentication, const char *pPassPhrase,
+                                const uWifiIpCfg_t *pIpCfg);
+
+/** Get the IPv4 configuration currently in use by the wifi station,
+ * e.g. as obtained by DHCP, in a form that may be passed to
+ * uWifiStationConnectFast() for a later connection.
+ *
+ * @param devHandle        the handle of the wifi instance.
+ * @param[out] pIpCfg      a place to put the IPv4 configuration;
+ *                         cannot be NULL.
+ * @return                 zero on success, #U_ERROR_COMMON_NOT_FOUND
+ *                         if the station has no IPv4 address, else
+ *                         negative error code.
+ */
+int32_t uWifiStationGetIpCfg(uDeviceHandle_t devHandle, uWifiIpCfg_t *pIpCfg);
+
 /** Disconnect from Wifi access point
  *
  * @param devHandle the handle of the wifi instance.
@@ -311,6 +415,31 @@ bool uWifiAccessPointHasStoredConfig(uDeviceHandle_t devHandle);
 int32_t uWifiStationScan(uDeviceHandle_t devHandle, const char *pSsid,
                          uWifiScanResultCallback_t pCallback);
 
+/** Get the freshest result that uWifiStationScan() has seen for the
+ * given SSID, as held in the scan cache; where more than one access
+ * point with that SSID is in the cache, the one with the strongest
+ * RSSI is returned.  Results older than
+ * #U_WIFI_SCAN_CACHE_MAX_AGE_SECONDS are ignored.
+ *
+ * @param devHandle     the handle of the wifi instance.
+ * @param[in] pSsid     the SSID to look for; cannot be NULL.
+ * @param[out] pResult  a place to put the scan result; may be NULL
+ *                      if only the presence of the SSID in the
+ *                      cache is of interest.
+ * @return              on success the number of seconds since the
+ *                      result was last seen, #U_ERROR_COMMON_NOT_FOUND
+ *                      if there is no fresh result for the SSID,
+ *                      else negative error code.
+ */
+int32_t uWifiStationScanCacheGet(uDeviceHandle_t devHandle, const char *pSsid,
+                                 uWifiScanResult_t *pResult);
+
+/** Empty the scan cache of the given wifi instance.
+ *
+ * @param devHandle     the handle of the wifi instance.
+ */
+void uWifiStationScanCacheClear(uDeviceHandle_t devHandle);
+
 #ifdef __cplusplus
 }
 #endif
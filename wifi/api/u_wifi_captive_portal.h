@@ -54,6 +54,23 @@ extern "C" {
 # define U_WIFI_CAPTIVE_PORTAL_DNS_TASK_PRIORITY (U_CFG_OS_APP_TASK_PRIORITY + 1)
 #endif
 
+#ifndef U_WIFI_CAPTIVE_PORTAL_URL_MAX_LENGTH_BYTES
+/** The maximum length of the URL of a request to the web server
+ * of the captive portal, including the terminator; this limits
+ * the length of the path of an asset passed to
+ * uWifiCaptivePortalSetAssets().
+ */
+# define U_WIFI_CAPTIVE_PORTAL_URL_MAX_LENGTH_BYTES 64
+#endif
+
+#ifndef U_WIFI_CAPTIVE_PORTAL_ETAG_MAX_LENGTH_BYTES
+/** The maximum length of the ETag of an asset passed to
+ * uWifiCaptivePortalSetAssets(), excluding the quotes and the
+ * terminator.
+ */
+# define U_WIFI_CAPTIVE_PORTAL_ETAG_MAX_LENGTH_BYTES 32
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -66,6 +83,34 @@ extern "C" {
  */
 typedef bool (*uWifiCaptivePortalKeepGoingCallback_t)(uDeviceHandle_t deviceHandle);
 
+/** A static asset, e.g. an HTML page, a script or a style sheet,
+ * served by the web server of the captive portal, see
+ * uWifiCaptivePortalSetAssets().  The asset is sent with an ETag
+ * so that a browser which has it cached will be told "304 Not
+ * Modified" rather than being sent it again.
+ */
+typedef struct {
+    const char *pPath;        /**< the null-terminated path of the asset,
+                                   e.g. "/app.js"; an asset with the path
+                                   "/" replaces the built-in page, which
+                                   is served for any path that is not
+                                   otherwise known.  Cannot be NULL. */
+    const char *pContentType; /**< the null-terminated content type of
+                                   the asset, e.g. "text/javascript";
+                                   cannot be NULL. */
+    const void *pData;        /**< the content of the asset. */
+    size_t length;            /**< the number of bytes at pData. */
+    bool gzip;                /**< true if the content at pData is gzip
+                                   compressed, in which case it is sent
+                                   with "Content-Encoding: gzip". */
+    const char *pETag;        /**< the null-terminated ETag of the asset,
+                                   without quotes, e.g. a version string,
+                                   at most
+                                   #U_WIFI_CAPTIVE_PORTAL_ETAG_MAX_LENGTH_BYTES
+                                   long; if NULL an ETag is derived from
+                                   a hash of the content. */
+} uWifiCaptivePortalAsset_t;
+
 /* ----------------------------------------------------------------
  * FUNCTIONS
  * -------------------------------------------------------------- */
@@ -103,6 +148,27 @@ int32_t uWifiCaptivePortal(uDeviceHandle_t deviceHandle,
                            const char *pPassword,
                            uWifiCaptivePortalKeepGoingCallback_t cb);
 
+/** Set the static assets to be served by the web server of the captive
+ * portal, e.g. a richer provisioning user interface than the built-in
+ * page; call this before calling uWifiCaptivePortal().  The assets are
+ * served directly from the given table, which would usually be in
+ * flash, hence no RAM is required to hold them and gzip compressed
+ * content may be used to reduce the time taken to load them.  Note
+ * that the built-in page uses the paths "/get_ssid_list" and
+ * "/set_wifi" to get the list of SSIDs and to set the credentials;
+ * a page provided as an asset should do the same.
+ *
+ * This function is NOT threadsafe.
+ *
+ * @param[in] pAssets  a pointer to the table of assets, which must
+ *                     remain valid while uWifiCaptivePortal() is
+ *                     running; use NULL to serve only the built-in page.
+ * @param numAssets    the number of entries at pAssets.
+ * @return             zero on success else negative error code.
+ */
+int32_t uWifiCaptivePortalSetAssets(const uWifiCaptivePortalAsset_t *pAssets,
+                                    size_t numAssets);
+
 #ifdef __cplusplus
 }
 #endif
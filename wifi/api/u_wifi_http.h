@@ -65,6 +65,15 @@ extern "C" {
 # define U_WIFI_HTTP_BLOB_MAX_LENGTH_BYTES 2000
 #endif
 
+#ifndef U_WIFI_HTTP_STREAM_MAX_LENGTH_BYTES
+/** The maximum length of the content that may be sent with
+ * uWifiHttpRequestExStream(); since the content is never held in
+ * RAM as a whole no limit is applied by default, though the module
+ * may impose one of its own.
+ */
+# define U_WIFI_HTTP_STREAM_MAX_LENGTH_BYTES INT32_MAX
+#endif
+
 #ifndef U_WIFI_HTTP_PATH_MAX_LENGTH_BYTES
 /** The maximum length of path that can be sent in a
  * uWifiHttpRequest();
@@ -109,6 +118,31 @@ typedef void (uWifiHttpCallback_t) (uDeviceHandle_t wifiHandle,
                                     bool error,
                                     void *pCallbackParam);
 
+/** Callback that provides the content of a streamed HTTP request,
+ * see uWifiHttpRequestExStream(); called from the task that called
+ * uWifiHttpRequestExStream() while the AT interface is locked, hence
+ * it must not call into this API itself.
+ *
+ * @param wifiHandle            the handle of the Wi-Fi instance.
+ * @param[out] pBuffer          a place to put the content; will not
+ *                              be NULL.
+ * @param size                  the number of bytes to put at pBuffer,
+ *                              at most #U_HTTP_CLIENT_WIFI_CHUNK_LENGTH.
+ * @param offset                the offset of these bytes from the
+ *                              start of the content, e.g. so that they
+ *                              can be read from flash directly.
+ * @param[in] pCallbackParam    the pSourceCallbackParam pointer that
+ *                              was passed to uWifiHttpRequestExStream().
+ * @return                      the number of bytes written to pBuffer;
+ *                              if this is not size, e.g. because a
+ *                              negative error code is returned, the
+ *                              request is abandoned.
+ */
+typedef int32_t (uWifiHttpSourceCallback_t) (uDeviceHandle_t wifiHandle,
+                                             char *pBuffer, size_t size,
+                                             size_t offset,
+                                             void *pCallbackParam);
+
 /** Private context structures for HTTP, WiFi-flavour.
  * The contents of this structure may be changed without
  * notice at any time; it is only placed here so that the
@@ -235,6 +269,49 @@ int32_t uWifiHttpRequestEx(uDeviceHandle_t wifiHandle, int32_t httpHandle,
                            uWifiHttpRequest_t requestType, const char *pPath,
                            const char *pData, size_t contentLength, const char *pContentType);
 
+/** As uWifiHttpRequestEx() but, rather than the content being passed in
+ * as a whole, it is fetched from pSourceCallback in chunks of
+ * #U_HTTP_CLIENT_WIFI_CHUNK_LENGTH bytes as it is written to the module,
+ * so that large content, e.g. a log bundle stored in flash, may be sent
+ * using a bounded amount of RAM.  The module requires the length of
+ * the content to be known before it is sent, hence HTTP "chunked"
+ * transfer encoding is not used: contentLength must be the total
+ * number of bytes that pSourceCallback will provide.  Only PUT, POST,
+ * PATCH, DELETE and OPTIONS requests are supported.  To stream the body
+ * of a response, see uHttpClientGetRequestStream().
+ *
+ * This function will block while the request is being sent.
+ *
+ * IMPORTANT: you MUST wait for the function to return before issuing your next
+ * HTTP request.  Flow control on the UART interface to the Wi-Fi module
+ * is strongly recommended.
+ *
+ * @param wifiHandle                the handle of the Wi-Fi instance to be used.
+ * @param httpHandle                the handle of the HTTP instance, as returned
+ *                                  by uWifiHttpOpen().
+ * @param requestType               the request type to perform.
+ * @param[in] pPath                 the null-terminated path on the HTTP server
+ *                                  to perform the request on, for example
+ *                                  "/thing/form.html"; cannot be NULL.
+ * @param contentLength             the total length of the content, in bytes;
+ *                                  cannot be more than
+ *                                  #U_WIFI_HTTP_STREAM_MAX_LENGTH_BYTES.
+ * @param[in] pContentType          the null-terminated content type, for example
+ *                                  "application/octet-stream"; cannot be more
+ *                                  than #U_WIFI_HTTP_CONTENT_TYPE_MAX_LENGTH_BYTES.
+ * @param[in] pSourceCallback       the callback that provides the content;
+ *                                  cannot be NULL.
+ * @param[in] pSourceCallbackParam  a parameter that will be passed to
+ *                                  pSourceCallback; may be NULL.
+ * @return                          zero if the request has been successfully
+ *                                  sent, else negative error code.
+ */
+int32_t uWifiHttpRequestExStream(uDeviceHandle_t wifiHandle, int32_t httpHandle,
+                                 uWifiHttpRequest_t requestType, const char *pPath,
+                                 size_t contentLength, const char *pContentType,
+                                 uWifiHttpSourceCallback_t *pSourceCallback,
+                                 void *pSourceCallbackParam);
+
 /** Get the last HTTP error code.
  *
  * @param wifiHandle     the handle of the Wi-Fi instance to be used.
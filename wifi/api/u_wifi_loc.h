@@ -54,6 +54,13 @@ extern "C" {
 # define U_WIFI_LOC_ANSWER_TIMEOUT_SECONDS 30
 #endif
 
+#ifndef U_WIFI_LOC_CACHE_MAX_NUM_BSSIDS
+/** The maximum number of access points that the location cache,
+ * see uWifiLocSetCache(), remembers alongside a location.
+ */
+# define U_WIFI_LOC_CACHE_MAX_NUM_BSSIDS 20
+#endif
+
 /* ----------------------------------------------------------------
  * TYPES
  * -------------------------------------------------------------- */
@@ -219,6 +226,40 @@ void uWifiLocGetStop(uDeviceHandle_t wifiHandle);
  */
 void uWifiLocFree(uDeviceHandle_t wifiHandle);
 
+/** Switch on, or off, the location cache of uWifiLocGet().  When
+ * the cache is on, uWifiLocGet() first scans for access points and
+ * compares the set of BSSIDs found with the set that was visible
+ * when the last successful location was obtained; if the two sets
+ * are similar enough, measured as the size of their intersection
+ * as a percentage of the size of their union (Jaccard similarity),
+ * and the last location is young enough and was of the same type,
+ * then that location is returned without a request being made of
+ * the cloud service.  The scan costs a few seconds: if the
+ * environment has changed, it is made in addition to the scan the
+ * module performs itself as part of the location request.  As a
+ * throttle, uWifiLocGet() will return a cached location that is
+ * younger than noScanSeconds without scanning at all.
+ *
+ * uWifiLocGetStart() is not affected by the cache.
+ *
+ * The cache costs around 180 bytes of heap, which is free'd
+ * when the cache is switched off, by uWifiLocFree() or when the
+ * Wi-Fi instance is closed.
+ *
+ * @param wifiHandle         the handle of the Wi-Fi instance.
+ * @param similarityPercent  the minimum Jaccard similarity, as a
+ *                           percentage, for a cached location to be
+ *                           returned; 0 switches the cache off and
+ *                           empties it.
+ * @param maxAgeSeconds      the maximum age of a cached location.
+ * @param noScanSeconds      the age below which a cached location is
+ *                           returned without scanning, 0 to always
+ *                           scan.
+ * @return                   zero on success else negative error code.
+ */
+int32_t uWifiLocSetCache(uDeviceHandle_t wifiHandle, int32_t similarityPercent,
+                         int32_t maxAgeSeconds, int32_t noScanSeconds);
+
 #ifdef __cplusplus
 }
 #endif
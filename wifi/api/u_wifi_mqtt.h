@@ -48,6 +48,15 @@ extern "C" {
  */
 #define U_WIFI_MQTT_MAX_NUM_CONNECTIONS 7
 
+#ifndef U_WIFI_MQTT_PUBLISH_WINDOW_SIZE
+/** The maximum number of asynchronous publishes, see
+ * uWifiMqttSetPublishCallback(), that may be in flight at any one
+ * time on an MQTT session; each one holds a copy of its topic and
+ * message on the heap until it completes.
+ */
+# define U_WIFI_MQTT_PUBLISH_WINDOW_SIZE 4
+#endif
+
 
 typedef enum {
     U_WIFI_MQTT_QOS_AT_MOST_ONCE = 0,
@@ -106,7 +115,11 @@ int32_t uWifiMqttDisconnect(const uMqttClientContext_t *pContext);
  * @param qos               qos of the message.
  * @param retain            set to true if the message need to be retained by the broker
  *                          between connect and disconnect.
- * @return                  zero on success or negative error code.
+ * @return                  zero on success or negative error code; if a
+ *                          publish callback has been set with
+ *                          uWifiMqttSetPublishCallback() then, on
+ *                          success, the non-negative message ID is
+ *                          returned instead.
  */
 int32_t uWifiMqttPublish(const uMqttClientContext_t *pContext,
                          const char *pTopicNameStr,
@@ -115,6 +128,34 @@ int32_t uWifiMqttPublish(const uMqttClientContext_t *pContext,
                          uMqttQos_t qos,
                          bool retain);
 
+/** Set a callback to be called when a publish completes, putting
+ * uWifiMqttPublish() into asynchronous mode: uWifiMqttPublish() then
+ * takes a copy of the topic and message, queues them for a task of
+ * its own to write to the EDM data channel of the topic, and returns
+ * a non-negative message ID at once; pCallback is called from that
+ * task with the message ID and the outcome once the message has been
+ * written.  Note that the module does not report when the broker has
+ * acknowledged a message, hence completion here means that the
+ * message has been handed to the module.  When
+ * #U_WIFI_MQTT_PUBLISH_WINDOW_SIZE publishes are in flight
+ * uWifiMqttPublish() returns #U_ERROR_COMMON_BUSY.
+ *
+ * @param[in] pContext       client context returned by pUMqttClientOpen().
+ * @param[in] pCallback      the callback. The first parameter is the
+ *                           message ID, as returned by uWifiMqttPublish(),
+ *                           the second parameter is zero on success else
+ *                           negative error code, the third parameter is
+ *                           pCallbackParam. Use NULL to return to
+ *                           synchronous mode; any publishes already in
+ *                           flight are still completed but without a
+ *                           callback.
+ * @param[in] pCallbackParam this value will be passed to pCallback.
+ * @return                   zero on success else negative error code.
+ */
+int32_t uWifiMqttSetPublishCallback(const uMqttClientContext_t *pContext,
+                                    void (*pCallback) (int32_t, int32_t, void *),
+                                    void *pCallbackParam);
+
 /** Set a callback to be called when new messages are available to
  * be read.  The callback may then call uWifiMqttGetUnread() to read
  * the messages.  Note that this callback will only be called when
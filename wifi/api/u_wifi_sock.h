@@ -62,13 +62,34 @@ extern "C" {
 # define U_WIFI_SOCK_TCP_RETRY_LIMIT 3
 #endif
 
-/** The maximum number of sockets that can be open at one time.
+/** The number of bytes that must be free in front of the data
+ * passed to uWifiSockWriteZeroCopy().
  */
-#define U_WIFI_SOCK_MAX_NUM_SOCKETS 7
+#define U_WIFI_SOCK_WRITE_ZERO_COPY_HEADROOM_BYTES 6
 
+/** The number of bytes that must be free after the data passed
+ * to uWifiSockWriteZeroCopy().
+ */
+#define U_WIFI_SOCK_WRITE_ZERO_COPY_TAILROOM_BYTES 1
+
+#ifndef U_WIFI_SOCK_MAX_NUM_SOCKETS
+/** The maximum number of sockets that can be open at one time,
+ * across all Wi-Fi instances; each costs a little over 100 bytes
+ * of RAM.  If you increase this you will likely also need to
+ * increase #U_SOCK_MAX_NUM_SOCKETS, if you are using the u_sock
+ * API, and U_SHORT_RANGE_EDM_STREAM_MAX_CONNECTIONS, the number
+ * of connections an EDM stream can carry; each connection that
+ * a socket makes, including any accepted by a listening socket,
+ * is an EDM connection.
+ */
+# define U_WIFI_SOCK_MAX_NUM_SOCKETS 7
+#endif
+
+#ifndef U_WIFI_SOCK_MAX_NUM_CONNECTIONS
 /** The maximum number of connections that can be open at one time.
  */
-#define U_WIFI_SOCK_MAX_NUM_CONNECTIONS 7
+# define U_WIFI_SOCK_MAX_NUM_CONNECTIONS U_WIFI_SOCK_MAX_NUM_SOCKETS
+#endif
 
 #ifndef U_WIFI_SOCK_CONNECT_TIMEOUT_SECONDS
 /** The amount of time allowed to connect a socket.
@@ -247,6 +268,15 @@ bool uWifiSockBlockingGet(uDeviceHandle_t devHandle,
  * #U_SOCK_OPT_RCVTIMEO and then the option value would be
  * a pointer to a structure of type timeval.
  *
+ * For a TCP socket, level #U_SOCK_OPT_LEVEL_SOCK and option
+ * #U_SOCK_OPT_RCVBUF, with an int32_t value, gives the socket a
+ * contiguous receive ring buffer of that many bytes: received
+ * data is copied into it as it arrives, releasing the EDM buffers
+ * that it arrived in (which are shared by all sockets) straight
+ * away, and reads become a simple copy.  Zero, the default,
+ * removes the ring buffer; the size cannot be changed while there
+ * is data in the ring buffer.
+ *
  * @param devHandle         the handle of the wifi instance.
  * @param sockHandle        the handle of the socket.
  * @param level             the option level
@@ -392,6 +422,27 @@ int32_t uWifiSockWrite(uDeviceHandle_t devHandle,
                        int32_t sockHandle,
                        const void *pData, size_t dataSizeBytes);
 
+/** As uWifiSockWrite() but the data is sent to the wifi module
+ * without being copied.  To make this possible pBuffer must
+ * point to #U_WIFI_SOCK_WRITE_ZERO_COPY_HEADROOM_BYTES of free
+ * space, followed by the data to send, followed by
+ * #U_WIFI_SOCK_WRITE_ZERO_COPY_TAILROOM_BYTES of free space; the
+ * free space is overwritten but the data is unchanged on return.
+ *
+ * @param devHandle     the handle of the wifi instance.
+ * @param sockHandle    the handle of the socket.
+ * @param[in] pBuffer   a pointer to the headroom in front of the
+ *                      data to send; cannot be NULL.
+ * @param dataSizeBytes the number of bytes of data to send, not
+ *                      including the headroom or tailroom.
+ * @return              the number of bytes sent on
+ *                      success else negated value
+ *                      of U_SOCK_Exxx from u_sock_errno.h.
+ */
+int32_t uWifiSockWriteZeroCopy(uDeviceHandle_t devHandle,
+                               int32_t sockHandle,
+                               char *pBuffer, size_t dataSizeBytes);
+
 /** Receive bytes on a connected socket.
  *
  * @param devHandle     the handle of the wifi instance.
@@ -37,6 +37,7 @@
 
 #include "u_error_common.h"
 
+#include "u_port.h"
 #include "u_port_os.h"
 #include "u_port_heap.h"
 #include "u_port_debug.h"
@@ -65,6 +66,7 @@
 #include "u_wifi_mqtt.h"     // For uWifiMqttPrivateLink()
 #include "u_wifi_http_private.h"   // For uWifiHttpPrivateLink()
 #include "u_wifi_loc_private.h"    // For uWifiLocPrivateLink()
+#include "u_wifi_private.h"
 
 /* ----------------------------------------------------------------
  * COMPILE-TIME MACROS
@@ -115,6 +117,28 @@ typedef enum {
     CFG_ACTION_DEACTIVATE = 4
 } uWifiCfgAction_t;
 
+/** An entry in the scan cache.
+ */
+typedef struct {
+    uWifiScanResult_t result;
+    int32_t timeMs; /**< the tick time at which result was last seen. */
+    bool valid;
+} uWifiScanCacheEntry_t;
+
+/** The scan cache, pointed to by pWifiScanCache in the short range
+ * instance and protected by wifiScanCacheMutex.
+ */
+typedef struct {
+    uWifiScanCacheEntry_t entry[U_WIFI_SCAN_CACHE_NUM_ENTRIES];
+    int32_t channelList[U_WIFI_CHANNEL_LIST_MAX_LENGTH]; /**< the channel list
+                                                              of the module before
+                                                              it was narrowed. */
+    size_t channelListLength; /**< non-zero if the channel list of the
+                                   module has been narrowed. */
+    int32_t fastPathEntry;    /**< the index of the entry used to narrow the
+                                   channel list, -1 once connected. */
+} uWifiScanCache_t;
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * -------------------------------------------------------------- */
@@ -386,6 +410,148 @@ static int32_t readIfaceStatusString(uAtClientHandle_t atHandle,
     return retValue;
 }
 
+// Get the scan cache of an instance, optionally creating it;
+// must be called with the short range lock held.
+static uWifiScanCache_t *pScanCacheGet(uShortRangePrivateInstance_t *pInstance,
+                                       bool create)
+{
+    uWifiScanCache_t *pCache = (uWifiScanCache_t *) pInstance->pWifiScanCache;
+
+    if ((pCache == NULL) && create) {
+        if ((pInstance->wifiScanCacheMutex != NULL) ||
+            (uPortMutexCreate(&(pInstance->wifiScanCacheMutex)) == 0)) {
+            pCache = (uWifiScanCache_t *) pUPortMalloc(sizeof(*pCache));
+            if (pCache != NULL) {
+                memset(pCache, 0, sizeof(*pCache));
+                pCache->fastPathEntry = -1;
+                pInstance->pWifiScanCache = pCache;
+            }
+        }
+    }
+
+    return pCache;
+}
+
+// Return true if a scan cache entry is valid and not too old.
+static bool scanCacheEntryIsFresh(const uWifiScanCacheEntry_t *pEntry)
+{
+    return pEntry->valid &&
+           (uPortGetTickTimeMs() - pEntry->timeMs < U_WIFI_SCAN_CACHE_MAX_AGE_SECONDS * 1000);
+}
+
+// Add a scan result to the scan cache, replacing the entry with the
+// same BSSID, else a stale entry, else the oldest entry; must be
+// called with the scan cache mutex held.
+static void scanCacheAdd(uWifiScanCache_t *pCache, const uWifiScanResult_t *pResult)
+{
+    uWifiScanCacheEntry_t *pEntry = NULL;
+    uWifiScanCacheEntry_t *pOldest = &(pCache->entry[0]);
+
+    for (size_t x = 0; (x < U_WIFI_SCAN_CACHE_NUM_ENTRIES) && (pEntry == NULL); x++) {
+        if (pCache->entry[x].valid &&
+            (memcmp(pCache->entry[x].result.bssid, pResult->bssid,
+                    sizeof(pResult->bssid)) == 0)) {
+            pEntry = &(pCache->entry[x]);
+        }
+    }
+    for (size_t x = 0; (x < U_WIFI_SCAN_CACHE_NUM_ENTRIES) && (pEntry == NULL); x++) {
+        if (!scanCacheEntryIsFresh(&(pCache->entry[x]))) {
+            pEntry = &(pCache->entry[x]);
+        } else if (pCache->entry[x].timeMs - pOldest->timeMs < 0) {
+            pOldest = &(pCache->entry[x]);
+        }
+    }
+    if (pEntry == NULL) {
+        pEntry = pOldest;
+    }
+    pEntry->result = *pResult;
+    pEntry->timeMs = uPortGetTickTimeMs();
+    pEntry->valid = true;
+}
+
+// Find the index of the fresh scan cache entry with the strongest
+// RSSI for the given SSID, -1 if there is none; must be called
+// with the scan cache mutex held.
+static int32_t scanCacheFind(const uWifiScanCache_t *pCache, const char *pSsid)
+{
+    int32_t index = -1;
+
+    for (size_t x = 0; x < U_WIFI_SCAN_CACHE_NUM_ENTRIES; x++) {
+        if (scanCacheEntryIsFresh(&(pCache->entry[x])) &&
+            (strcmp(pCache->entry[x].result.ssid, pSsid) == 0) &&
+            ((index < 0) || (pCache->entry[x].result.rssi > pCache->entry[index].result.rssi))) {
+            index = (int32_t) x;
+        }
+    }
+
+    return index;
+}
+
+// Save the channel list of the module in the scan cache and then
+// narrow it to the given channel.
+static int32_t narrowChannelList(uAtClientHandle_t atHandle,
+                                 uWifiScanCache_t *pCache, int32_t channel)
+{
+    int32_t errorCode;
+    int32_t x = 0;
+    size_t length = 0;
+
+    if (pCache->channelListLength == 0) {
+        uAtClientLock(atHandle);
+        uAtClientCommandStart(atHandle, "AT+UWCL?");
+        uAtClientCommandStop(atHandle);
+        uAtClientResponseStart(atHandle, "+UWCL:");
+        while ((x >= 0) && (length < U_WIFI_CHANNEL_LIST_MAX_LENGTH)) {
+            x = uAtClientReadInt(atHandle);
+            if (x > 0) {
+                pCache->channelList[length] = x;
+                length++;
+            }
+        }
+        uAtClientResponseStop(atHandle);
+        errorCode = uAtClientUnlock(atHandle);
+        if ((errorCode == 0) && (length == 0)) {
+            // Without a list to put back, don't narrow it
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+        }
+        if (errorCode == 0) {
+            pCache->channelListLength = length;
+        }
+    }
+    if (pCache->channelListLength > 0) {
+        uAtClientLock(atHandle);
+        uAtClientCommandStart(atHandle, "AT+UWCL=");
+        uAtClientWriteInt(atHandle, channel);
+        uAtClientCommandStopReadResponse(atHandle);
+        errorCode = uAtClientUnlock(atHandle);
+    }
+
+    return errorCode;
+}
+
+// Put back the channel list saved by narrowChannelList().
+static int32_t restoreChannelList(uAtClientHandle_t atHandle,
+                                  uWifiScanCache_t *pCache)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+
+    if (pCache->channelListLength > 0) {
+        uAtClientLock(atHandle);
+        uAtClientCommandStart(atHandle, "AT+UWCL=");
+        for (size_t x = 0; x < pCache->channelListLength; x++) {
+            uAtClientWriteInt(atHandle, pCache->channelList[x]);
+        }
+        uAtClientCommandStopReadResponse(atHandle);
+        errorCode = uAtClientUnlock(atHandle);
+        if (errorCode == 0) {
+            pCache->channelListLength = 0;
+        }
+    }
+    pCache->fastPathEntry = -1;
+
+    return errorCode;
+}
+
 static void wifiConnectCallback(uAtClientHandle_t atHandle,
                                 void *pParameter)
 {
@@ -400,12 +566,28 @@ static void wifiConnectCallback(uAtClientHandle_t atHandle,
     }
 
     if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
-        const uShortRangePrivateInstance_t *pInstance;
+        uShortRangePrivateInstance_t *pInstance;
+        uWifiScanCache_t *pCache = NULL;
         pInstance = pUShortRangePrivateGetInstance(pStatus->devHandle);
         if (pInstance && pInstance->pWifiConnectionStatusCallback) {
             pCallback = pInstance->pWifiConnectionStatusCallback;
             pCallbackParam = pInstance->pWifiConnectionStatusCallbackParameter;
         }
+        if (pInstance) {
+            pCache = pScanCacheGet(pInstance, false);
+        }
+        if (pCache != NULL) {
+            uPortMutexLock(pInstance->wifiScanCacheMutex);
+            if (pCache->fastPathEntry >= 0) {
+                if (pStatus->status == U_WIFI_CON_STATUS_DISCONNECTED) {
+                    // The connection on the cached channel failed: forget
+                    // the entry so that the next attempt is a full one
+                    pCache->entry[pCache->fastPathEntry].valid = false;
+                }
+                pCache->fastPathEntry = -1;
+            }
+            uPortMutexUnlock(pInstance->wifiScanCacheMutex);
+        }
 
         uShortRangeUnlock();
 
@@ -620,6 +802,271 @@ static int32_t ApCfgAction(uDeviceHandle_t devHandle, int32_t op)
     return errorCode;
 }
 
+// FNV-1a hash a block of memory into hash.
+static uint32_t hashAdd(uint32_t hash, const void *pData, size_t length)
+{
+    const uint8_t *pByte = (const uint8_t *) pData;
+
+    for (size_t x = 0; x < length; x++) {
+        hash = (hash ^ *pByte) * 16777619UL;
+        pByte++;
+    }
+
+    return hash;
+}
+
+// Form a hash of the station settings written by stationConnect(),
+// never zero since zero means "not known".
+static uint32_t staCfgHash(const char *pSsid, uWifiAuth_t authentication,
+                           const char *pPassPhrase, const uWifiIpCfg_t *pIpCfg)
+{
+    uint32_t hash = 2166136261UL;
+
+    hash = hashAdd(hash, pSsid, strlen(pSsid) + 1);
+    hash = hashAdd(hash, &authentication, sizeof(authentication));
+    if ((authentication != U_WIFI_AUTH_OPEN) && (pPassPhrase != NULL)) {
+        hash = hashAdd(hash, pPassPhrase, strlen(pPassPhrase) + 1);
+    }
+    if (pIpCfg != NULL) {
+        hash = hashAdd(hash, pIpCfg, sizeof(*pIpCfg));
+    }
+    if (hash == 0) {
+        hash = 1;
+    }
+
+    return hash;
+}
+
+// Write a static IPv4 configuration to the station settings.
+static int32_t writeWifiStaIpCfg(uAtClientHandle_t atHandle,
+                                 const uWifiIpCfg_t *pIpCfg)
+{
+    int32_t errorCode;
+    const uint8_t *pAddress[] = {pIpCfg->IPv4Addr, pIpCfg->subnetMask,
+                                 pIpCfg->defaultGW, pIpCfg->DNS1, pIpCfg->DNS2
+                                };
+
+    // Tag 100 value 1 is static IPv4, tags 101 to 105 are the addresses
+    errorCode = writeWifiStaCfgInt(atHandle, 0, 100, 1);
+    for (size_t x = 0; (x < sizeof(pAddress) / sizeof(pAddress[0])) &&
+         (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS); x++) {
+        // Addresses are written without quotes
+        uAtClientLock(atHandle);
+        uAtClientCommandStart(atHandle, "AT+UWSC=");
+        uAtClientWriteInt(atHandle, 0);
+        uAtClientWriteInt(atHandle, 101 + (int32_t) x);
+        uAtClientWriteString(atHandle, (const char *) pAddress[x], false);
+        uAtClientCommandStopReadResponse(atHandle);
+        errorCode = uAtClientUnlock(atHandle);
+    }
+
+    return errorCode;
+}
+
+// Connect to an access point, optionally using the scan cache and,
+// if fast is true, writing only the settings that have changed
+// since the last connection, with an optional static IP configuration.
+static int32_t stationConnect(uDeviceHandle_t devHandle, const char *pSsid,
+                              uWifiAuth_t authentication,
+                              const char *pPassPhrase, bool useCache,
+                              bool fast, const uWifiIpCfg_t *pIpCfg)
+{
+    int32_t errorCode;
+    uShortRangePrivateInstance_t *pInstance;
+    uWifiScanCache_t *pCache;
+    int32_t index = -1;
+    uint32_t cfgHash = 0;
+    bool cfgUnchanged = false;
+
+    errorCode = uShortRangeLock();
+    if (errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) {
+        return errorCode;
+    }
+
+    errorCode = getInstance(devHandle, &pInstance);
+    if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+        uAtClientHandle_t atHandle = pInstance->atHandle;
+
+        // Read connection status
+        int32_t conStatus = readWifiStaStatusInt(atHandle, 3);
+        if ((conStatus == 2) && (pSsid != NULL)) {
+            // Wifi already connected. Check if the SSID is the same
+            char ssid[32 + 1];
+            errorCode = (int32_t) U_WIFI_ERROR_ALREADY_CONNECTED;
+            int32_t tmp = readWifiStaStatusString(atHandle, 0, ssid, sizeof(ssid));
+            if (tmp >= 0) {
+                if (strcmp(ssid, pSsid) == 0) {
+                    errorCode = (int32_t) U_WIFI_ERROR_ALREADY_CONNECTED_TO_SSID;
+                }
+            }
+        }
+
+        if (pSsid != NULL) {
+            cfgHash = staCfgHash(pSsid, authentication, pPassPhrase, pIpCfg);
+            // The settings in the module are lost if it restarts
+            cfgUnchanged = fast && (cfgHash == pInstance->wifiStaCfgHash) &&
+                           (pInstance->ticksLastRestart == pInstance->wifiStaCfgTicksLastRestart);
+        }
+        pInstance->wifiStaCfgHash = 0;
+
+        // Configure Wifi
+        if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            uPortLog(LOG_TAG "Activating wifi STA mode\n");
+            if (!fast) {
+                // Set Wifi STA inactive on start up
+                errorCode = writeWifiStaCfgInt(atHandle, 0, 0, 0);
+            }
+        }
+        if (pSsid == NULL) {
+            errorCode = writeWifiStaCfgAction(atHandle, 0, CFG_ACTION_LOAD);
+        } else if (cfgUnchanged) {
+            uPortLog(LOG_TAG "Wifi STA settings unchanged\n");
+        } else {
+            if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+                // Set SSID
+                errorCode = writeWifiStaCfgStr(atHandle, 0, 2, pSsid);
+            }
+            if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+                // Set authentication
+                errorCode = writeWifiStaCfgInt(atHandle, 0, 5, (int32_t)authentication);
+            }
+            if ((errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) &&
+                (authentication != U_WIFI_AUTH_OPEN)) {
+                // Set PSK/passphrase
+                errorCode = writeWifiStaCfgStr(atHandle, 0, 8, pPassPhrase);
+            }
+        }
+        if ((errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) &&
+            (pIpCfg != NULL) && !cfgUnchanged) {
+            errorCode = writeWifiStaIpCfg(atHandle, pIpCfg);
+        }
+        if ((errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) && (pSsid != NULL)) {
+            pInstance->wifiStaCfgHash = cfgHash;
+            pInstance->wifiStaCfgTicksLastRestart = pInstance->ticksLastRestart;
+        }
+        pCache = pScanCacheGet(pInstance, false);
+        if ((errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) && (pCache != NULL)) {
+            uPortMutexLock(pInstance->wifiScanCacheMutex);
+            if (useCache) {
+                index = scanCacheFind(pCache, pSsid);
+            }
+            if (index >= 0) {
+                // Fast path: only look on the channel the access point was seen on
+                uPortLog(LOG_TAG "Using cached channel %d\n",
+                         pCache->entry[index].result.channel);
+                if (narrowChannelList(atHandle, pCache,
+                                      pCache->entry[index].result.channel) == 0) {
+                    pCache->fastPathEntry = index;
+                }
+            } else {
+                restoreChannelList(atHandle, pCache);
+            }
+            uPortMutexUnlock(pInstance->wifiScanCacheMutex);
+        }
+        if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            // Activate wifi
+            errorCode = writeWifiStaCfgAction(atHandle, 0, CFG_ACTION_ACTIVATE);
+        }
+    }
+
+    uShortRangeUnlock();
+
+    return errorCode;
+}
+
+// Perform a scan, calling pCallback, if not NULL, with each result
+// and/or storing up to maxNumBssids BSSIDs in pBssids, returning the
+// number stored or negative error code.
+static int32_t stationScan(uDeviceHandle_t devHandle, const char *pSsid,
+                           uWifiScanResultCallback_t pCallback,
+                           uint8_t *pBssids, size_t maxNumBssids)
+{
+    int32_t errorCodeOrNum;
+    uShortRangePrivateInstance_t *pInstance;
+    size_t numBssids = 0;
+
+    errorCodeOrNum = uShortRangeLock();
+    if (errorCodeOrNum != (int32_t) U_ERROR_COMMON_SUCCESS) {
+        return errorCodeOrNum;
+    }
+
+    errorCodeOrNum = getInstance(devHandle, &pInstance);
+    if (errorCodeOrNum == (int32_t) U_ERROR_COMMON_SUCCESS) {
+        uAtClientHandle_t atHandle = pInstance->atHandle;
+        // The scan cache is filled as we go; if it can't be
+        // allocated the scan proceeds without it
+        uWifiScanCache_t *pCache = pScanCacheGet(pInstance, true);
+        uPortMutexHandle_t cacheMutex = pInstance->wifiScanCacheMutex;
+
+        uAtClientLock(atHandle);
+        // Since the scanning can take some time we release the short range lock here
+        // This should be fine since we currently have the AT client lock instead
+        uShortRangeUnlock();
+        if (pSsid) {
+            uAtClientCommandStart(atHandle, "AT+UWSCAN=");
+            uAtClientWriteString(atHandle, pSsid, false);
+        } else {
+            uAtClientCommandStart(atHandle, "AT+UWSCAN");
+        }
+        uAtClientCommandStop(atHandle);
+
+        uAtClientTimeoutSet(atHandle, 10000);
+
+        // Handle the scan results
+        // Loop until we get OK, ERROR or timeout
+        while (uAtClientResponseStart(atHandle, "+UWSCAN:") == 0) {
+            uWifiScanResult_t scanResult;
+            int32_t result;
+            char bssid[32];
+
+            result = uAtClientReadString(atHandle, bssid, sizeof(bssid), false);
+            if (result >= 0) {
+                if (uHexToBin(bssid, result, (char *)scanResult.bssid) != result / 2) {
+                    result = -1;
+                }
+            }
+            if (result < 0) {
+                uPortLog(LOG_TAG "Warning: Failed to parse BSSID");
+            }
+            scanResult.opMode = uAtClientReadInt(atHandle);
+            result = uAtClientReadString(atHandle, scanResult.ssid, sizeof(scanResult.ssid), false);
+            if (result < 0) {
+                uPortLog(LOG_TAG "Warning: Failed to parse SSID");
+            }
+            scanResult.channel = uAtClientReadInt(atHandle);
+            scanResult.rssi = uAtClientReadInt(atHandle);
+            scanResult.authSuiteBitmask = uAtClientReadInt(atHandle);
+            scanResult.uniCipherBitmask = (uint8_t)uAtClientReadInt(atHandle);
+            scanResult.grpCipherBitmask = (uint8_t)uAtClientReadInt(atHandle);
+
+            if ((pCache != NULL) && (scanResult.channel > 0)) {
+                uPortMutexLock(cacheMutex);
+                scanCacheAdd(pCache, &scanResult);
+                uPortMutexUnlock(cacheMutex);
+            }
+
+            if ((pBssids != NULL) && (numBssids < maxNumBssids)) {
+                memcpy(pBssids + (numBssids * U_WIFI_BSSID_SIZE),
+                       scanResult.bssid, U_WIFI_BSSID_SIZE);
+                numBssids++;
+            }
+            if (pCallback != NULL) {
+                pCallback(devHandle, &scanResult);
+            }
+        }
+
+        errorCodeOrNum = uAtClientUnlock(atHandle);
+        if (errorCodeOrNum == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            errorCodeOrNum = (int32_t) numBssids;
+        }
+    } else {
+        uShortRangeUnlock();
+    }
+
+
+    return errorCodeOrNum;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -719,10 +1166,41 @@ int32_t uWifiSetNetworkStatusCallback(uDeviceHandle_t devHandle,
 int32_t uWifiStationConnect(uDeviceHandle_t devHandle, const char *pSsid,
                             uWifiAuth_t authentication,
                             const char *pPassPhrase)
+{
+    return stationConnect(devHandle, pSsid, authentication, pPassPhrase,
+                          false, false, NULL);
+}
+
+int32_t uWifiStationConnectCached(uDeviceHandle_t devHandle, const char *pSsid,
+                                  uWifiAuth_t authentication,
+                                  const char *pPassPhrase)
+{
+    if (pSsid == NULL) {
+        return (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+
+    return stationConnect(devHandle, pSsid, authentication, pPassPhrase,
+                          true, false, NULL);
+}
+
+int32_t uWifiStationConnectFast(uDeviceHandle_t devHandle, const char *pSsid,
+                                uWifiAuth_t authentication,
+                                const char *pPassPhrase,
+                                const uWifiIpCfg_t *pIpCfg)
+{
+    return stationConnect(devHandle, pSsid, authentication, pPassPhrase,
+                          false, true, pIpCfg);
+}
+
+int32_t uWifiStationGetIpCfg(uDeviceHandle_t devHandle, uWifiIpCfg_t *pIpCfg)
 {
     int32_t errorCode;
     uShortRangePrivateInstance_t *pInstance;
 
+    if (pIpCfg == NULL) {
+        return (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+
     errorCode = uShortRangeLock();
     if (errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) {
         return errorCode;
@@ -731,48 +1209,25 @@ int32_t uWifiStationConnect(uDeviceHandle_t devHandle, const char *pSsid,
     errorCode = getInstance(devHandle, &pInstance);
     if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
         uAtClientHandle_t atHandle = pInstance->atHandle;
-
-        // Read connection status
-        int32_t conStatus = readWifiStaStatusInt(atHandle, 3);
-        if ((conStatus == 2) && (pSsid != NULL)) {
-            // Wifi already connected. Check if the SSID is the same
-            char ssid[32 + 1];
-            errorCode = (int32_t) U_WIFI_ERROR_ALREADY_CONNECTED;
-            int32_t tmp = readWifiStaStatusString(atHandle, 0, ssid, sizeof(ssid));
-            if (tmp >= 0) {
-                if (strcmp(ssid, pSsid) == 0) {
-                    errorCode = (int32_t) U_WIFI_ERROR_ALREADY_CONNECTED_TO_SSID;
-                }
-            }
-        }
-
-        // Configure Wifi
-        if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
-            // Set Wifi STA inactive on start up
-            uPortLog(LOG_TAG "Activating wifi STA mode\n");
-            errorCode = writeWifiStaCfgInt(atHandle, 0, 0, 0);
+        uint8_t *pAddress[] = {pIpCfg->IPv4Addr, pIpCfg->subnetMask,
+                               pIpCfg->defaultGW, pIpCfg->DNS1, pIpCfg->DNS2
+                              };
+        memset(pIpCfg, 0, sizeof(*pIpCfg));
+        // Status IDs 101 to 105 are the IPv4 address, subnet mask,
+        // gateway and DNS servers of the interface
+        for (size_t x = 0; (x < sizeof(pAddress) / sizeof(pAddress[0])) &&
+             (errorCode >= 0); x++) {
+            errorCode = readIfaceStatusString(atHandle, 0, 101 + (int32_t) x,
+                                              (char *) pAddress[x],
+                                              U_WIFI_IP_ADDR_STR_MAX_LEN);
         }
-        if (pSsid == NULL) {
-            errorCode = writeWifiStaCfgAction(atHandle, 0, CFG_ACTION_LOAD);
-        } else {
-            if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
-                // Set SSID
-                errorCode = writeWifiStaCfgStr(atHandle, 0, 2, pSsid);
-            }
-            if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
-                // Set authentication
-                errorCode = writeWifiStaCfgInt(atHandle, 0, 5, (int32_t)authentication);
-            }
-            if ((errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) &&
-                (authentication != U_WIFI_AUTH_OPEN)) {
-                // Set PSK/passphrase
-                errorCode = writeWifiStaCfgStr(atHandle, 0, 8, pPassPhrase);
+        if (errorCode >= 0) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            if (strcmp((const char *) pIpCfg->IPv4Addr, "0.0.0.0") == 0) {
+                // No address, the network is not up
+                errorCode = (int32_t) U_ERROR_COMMON_NOT_FOUND;
             }
         }
-        if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
-            // Activate wifi
-            errorCode = writeWifiStaCfgAction(atHandle, 0, CFG_ACTION_ACTIVATE);
-        }
     }
 
     uShortRangeUnlock();
@@ -784,6 +1239,7 @@ int32_t uWifiStationDisconnect(uDeviceHandle_t devHandle)
 {
     int32_t errorCode;
     uShortRangePrivateInstance_t *pInstance;
+    uWifiScanCache_t *pCache;
 
     errorCode = uShortRangeLock();
     if (errorCode != (int32_t)U_ERROR_COMMON_SUCCESS) {
@@ -802,6 +1258,12 @@ int32_t uWifiStationDisconnect(uDeviceHandle_t devHandle)
             // Wifi is already disabled
             errorCode = (int32_t) U_WIFI_ERROR_ALREADY_DISCONNECTED;
         }
+        pCache = pScanCacheGet(pInstance, false);
+        if (pCache != NULL) {
+            uPortMutexLock(pInstance->wifiScanCacheMutex);
+            restoreChannelList(atHandle, pCache);
+            uPortMutexUnlock(pInstance->wifiScanCacheMutex);
+        }
     }
 
     uShortRangeUnlock();
@@ -838,6 +1300,13 @@ int32_t uWifiStationStoreConfig(uDeviceHandle_t devHandle, bool erase)
     int32_t errorCode = (int32_t)U_ERROR_COMMON_SUCCESS;
     if (erase) {
         errorCode = StaCfgAction(devHandle, CFG_ACTION_RESET);
+        if (uShortRangeLock() == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            uShortRangePrivateInstance_t *pInstance;
+            if (getInstance(devHandle, &pInstance) == (int32_t) U_ERROR_COMMON_SUCCESS) {
+                pInstance->wifiStaCfgHash = 0;
+            }
+            uShortRangeUnlock();
+        }
     }
     if (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) {
         errorCode = StaCfgAction(devHandle, CFG_ACTION_STORE);
@@ -859,6 +1328,7 @@ bool uWifiStationHasStoredConfig(uDeviceHandle_t devHandle)
     if (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) {
         // Load saved credentials and check if there is a valid ssid
         uAtClientHandle_t atHandle = pInstance->atHandle;
+        pInstance->wifiStaCfgHash = 0;
         errorCode = writeWifiStaCfgAction(atHandle, 0, CFG_ACTION_LOAD);
         if (errorCode == (int32_t)U_ERROR_COMMON_SUCCESS) {
             char ssid[U_WIFI_SSID_SIZE] = {0};
@@ -1026,69 +1496,84 @@ bool uWifiAccessPointHasStoredConfig(uDeviceHandle_t devHandle)
 int32_t uWifiStationScan(uDeviceHandle_t devHandle, const char *pSsid,
                          uWifiScanResultCallback_t pCallback)
 {
-    int32_t errorCode;
+    int32_t errorCode = stationScan(devHandle, pSsid, pCallback, NULL, 0);
+
+    if (errorCode > 0) {
+        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+    }
+
+    return errorCode;
+}
+
+int32_t uWifiStationScanCacheGet(uDeviceHandle_t devHandle, const char *pSsid,
+                                 uWifiScanResult_t *pResult)
+{
+    int32_t errorCodeOrAge;
     uShortRangePrivateInstance_t *pInstance;
+    uWifiScanCache_t *pCache;
+    int32_t index;
 
-    errorCode = uShortRangeLock();
-    if (errorCode != (int32_t) U_ERROR_COMMON_SUCCESS) {
-        return errorCode;
+    if (pSsid == NULL) {
+        return (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
     }
 
-    errorCode = getInstance(devHandle, &pInstance);
-    if (errorCode == (int32_t) U_ERROR_COMMON_SUCCESS) {
-        uAtClientHandle_t atHandle = pInstance->atHandle;
+    errorCodeOrAge = uShortRangeLock();
+    if (errorCodeOrAge != (int32_t) U_ERROR_COMMON_SUCCESS) {
+        return errorCodeOrAge;
+    }
 
-        uAtClientLock(atHandle);
-        // Since the scanning can take some time we release the short range lock here
-        // This should be fine since we currently have the AT client lock instead
-        uShortRangeUnlock();
-        if (pSsid) {
-            uAtClientCommandStart(atHandle, "AT+UWSCAN=");
-            uAtClientWriteString(atHandle, pSsid, false);
-        } else {
-            uAtClientCommandStart(atHandle, "AT+UWSCAN");
+    errorCodeOrAge = getInstance(devHandle, &pInstance);
+    if (errorCodeOrAge == (int32_t) U_ERROR_COMMON_SUCCESS) {
+        errorCodeOrAge = (int32_t) U_ERROR_COMMON_NOT_FOUND;
+        pCache = pScanCacheGet(pInstance, false);
+        if (pCache != NULL) {
+            uPortMutexLock(pInstance->wifiScanCacheMutex);
+            index = scanCacheFind(pCache, pSsid);
+            if (index >= 0) {
+                if (pResult != NULL) {
+                    *pResult = pCache->entry[index].result;
+                }
+                errorCodeOrAge = (uPortGetTickTimeMs() - pCache->entry[index].timeMs) / 1000;
+            }
+            uPortMutexUnlock(pInstance->wifiScanCacheMutex);
         }
-        uAtClientCommandStop(atHandle);
+    }
 
-        uAtClientTimeoutSet(atHandle, 10000);
+    uShortRangeUnlock();
 
-        // Handle the scan results
-        // Loop until we get OK, ERROR or timeout
-        while (uAtClientResponseStart(atHandle, "+UWSCAN:") == 0) {
-            uWifiScanResult_t scanResult;
-            int32_t result;
-            char bssid[32];
+    return errorCodeOrAge;
+}
 
-            result = uAtClientReadString(atHandle, bssid, sizeof(bssid), false);
-            if (result >= 0) {
-                if (uHexToBin(bssid, result, (char *)scanResult.bssid) != result / 2) {
-                    result = -1;
+void uWifiStationScanCacheClear(uDeviceHandle_t devHandle)
+{
+    uShortRangePrivateInstance_t *pInstance;
+    uWifiScanCache_t *pCache;
+
+    if (uShortRangeLock() == (int32_t) U_ERROR_COMMON_SUCCESS) {
+        if (getInstance(devHandle, &pInstance) == (int32_t) U_ERROR_COMMON_SUCCESS) {
+            pCache = pScanCacheGet(pInstance, false);
+            if (pCache != NULL) {
+                uPortMutexLock(pInstance->wifiScanCacheMutex);
+                for (size_t x = 0; x < U_WIFI_SCAN_CACHE_NUM_ENTRIES; x++) {
+                    pCache->entry[x].valid = false;
                 }
+                pCache->fastPathEntry = -1;
+                uPortMutexUnlock(pInstance->wifiScanCacheMutex);
             }
-            if (result < 0) {
-                uPortLog(LOG_TAG "Warning: Failed to parse BSSID");
-            }
-            scanResult.opMode = uAtClientReadInt(atHandle);
-            result = uAtClientReadString(atHandle, scanResult.ssid, sizeof(scanResult.ssid), false);
-            if (result < 0) {
-                uPortLog(LOG_TAG "Warning: Failed to parse SSID");
-            }
-            scanResult.channel = uAtClientReadInt(atHandle);
-            scanResult.rssi = uAtClientReadInt(atHandle);
-            scanResult.authSuiteBitmask = uAtClientReadInt(atHandle);
-            scanResult.uniCipherBitmask = (uint8_t)uAtClientReadInt(atHandle);
-            scanResult.grpCipherBitmask = (uint8_t)uAtClientReadInt(atHandle);
-
-            pCallback(devHandle, &scanResult);
         }
-
-        errorCode = uAtClientUnlock(atHandle);
-    } else {
         uShortRangeUnlock();
     }
+}
 
+/* ----------------------------------------------------------------
+ * PUBLIC FUNCTIONS THAT ARE PRIVATE TO WIFI
+ * -------------------------------------------------------------- */
 
-    return errorCode;
+// Scan, returning the BSSIDs only.
+int32_t uWifiPrivateScanBssids(uDeviceHandle_t devHandle, uint8_t *pBssids,
+                               size_t maxNumBssids)
+{
+    return stationScan(devHandle, NULL, NULL, pBssids, maxNumBssids);
 }
 
 // End of file
@@ -34,6 +34,7 @@
 #include "string.h"
 #include "stdio.h"
 #include "limits.h"
+#include "ctype.h"
 
 #include "u_error_common.h"
 
@@ -76,6 +77,21 @@
 # define U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_READ_DELAY_MS 100
 #endif
 
+#ifndef U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_WRITE_DELAY_MS
+/** When writing to a client that has connected to us and not all
+ * of the data could be written, wait this many milliseconds before
+ * trying again.
+ */
+# define U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_WRITE_DELAY_MS 20
+#endif
+
+#ifndef U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_WRITE_RETRIES
+/** The number of times to try again, without making progress,
+ * when writing to a client, before giving up.
+ */
+# define U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_WRITE_RETRIES 100
+#endif
+
 /* ----------------------------------------------------------------
  * STATIC VARIABLES
  * ------------------------------------------------------------- */
@@ -169,6 +185,16 @@ static const char gIndexPage[] =
     "</body>\r\n"
     "</html>\r\n";
 
+// The built-in page as an asset, served unless the application
+// has provided an asset with the path "/".
+static const uWifiCaptivePortalAsset_t gIndexAsset = {
+    "/", "text/html", gIndexPage, sizeof(gIndexPage) - 1, false, NULL
+};
+
+// The assets provided by the application.
+static const uWifiCaptivePortalAsset_t *gpAssets = NULL;
+static size_t gNumAssets = 0;
+
 // The list of available network SSIDs
 static char gSsidList[1024];
 static uDeviceHandle_t gDevHandle;
@@ -214,6 +240,149 @@ static void sendHeader(int32_t sock, const char *code,
     uSockWrite(sock, header, strlen(header));
 }
 
+// Write all of the given data to a socket, retrying if the
+// socket would block.
+static void sendBody(int32_t sock, const void *pData, size_t length)
+{
+    const char *pBytes = (const char *) pData;
+    int32_t retries = 0;
+    int32_t x;
+
+    while ((length > 0) &&
+           (retries < U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_WRITE_RETRIES)) {
+        x = uSockWrite(sock, pBytes, length);
+        if (x > 0) {
+            pBytes += x;
+            length -= x;
+            retries = 0;
+        } else {
+            retries++;
+            uPortTaskBlock(U_WIFI_CAPTIVE_PORTAL_CLIENT_SOCKET_WRITE_DELAY_MS);
+        }
+    }
+}
+
+// Find the value of the given header in a request, NULL if
+// it is not there; the name is compared case-insensitively.
+static const char *pHeaderValue(const char *pRequest, const char *pName)
+{
+    const char *pValue = NULL;
+    const char *pLine = strchr(pRequest, '\n');
+    size_t nameLength = strlen(pName);
+    size_t x;
+
+    // An empty line marks the end of the headers
+    while ((pValue == NULL) && (pLine != NULL) &&
+           (*(pLine + 1) != '\r') && (*(pLine + 1) != '\n')) {
+        pLine++;
+        x = 0;
+        while ((x < nameLength) && (pLine[x] != 0) &&
+               (tolower((int32_t) pLine[x]) == tolower((int32_t) pName[x]))) {
+            x++;
+        }
+        if ((x == nameLength) && (pLine[x] == ':')) {
+            pValue = pLine + x + 1;
+            while (*pValue == ' ') {
+                pValue++;
+            }
+        }
+        pLine = strchr(pLine, '\n');
+    }
+
+    return pValue;
+}
+
+// Return true if the request has an If-None-Match header
+// that includes the given (quoted) ETag.
+static bool eTagMatches(const char *pRequest, const char *pETag)
+{
+    bool matches = false;
+    const char *pValue = pHeaderValue(pRequest, "If-None-Match");
+    size_t length = strlen(pETag);
+
+    while ((pValue != NULL) && !matches && (*pValue != 0) &&
+           (*pValue != '\r') && (*pValue != '\n')) {
+        matches = (*pValue == '*') || (strncmp(pValue, pETag, length) == 0);
+        pValue++;
+    }
+
+    return matches;
+}
+
+// Write the quoted ETag of an asset to pBuffer.
+static void getETag(const uWifiCaptivePortalAsset_t *pAsset,
+                    char *pBuffer, size_t size)
+{
+    const uint8_t *pData = (const uint8_t *) pAsset->pData;
+    uint32_t hash = 2166136261U;
+
+    if (pAsset->pETag != NULL) {
+        snprintf(pBuffer, size, "\"%s\"", pAsset->pETag);
+    } else {
+        // FNV-1a hash of the content: this is a great deal
+        // quicker than sending it over the link to the module
+        for (size_t x = 0; x < pAsset->length; x++) {
+            hash ^= pData[x];
+            hash *= 16777619U;
+        }
+        snprintf(pBuffer, size, "\"%08x-%x\"", (unsigned int) hash,
+                 (unsigned int) pAsset->length);
+    }
+}
+
+// Find the asset for a URL, ignoring any query string, NULL if
+// there is none.
+static const uWifiCaptivePortalAsset_t *pAssetFind(const char *pUrl)
+{
+    const uWifiCaptivePortalAsset_t *pAsset = NULL;
+    size_t length;
+
+    for (size_t x = 0; (pAsset == NULL) && (x < gNumAssets); x++) {
+        length = strlen(gpAssets[x].pPath);
+        if ((strncmp(pUrl, gpAssets[x].pPath, length) == 0) &&
+            ((pUrl[length] == 0) || (pUrl[length] == '?'))) {
+            pAsset = &(gpAssets[x]);
+        }
+    }
+
+    return pAsset;
+}
+
+// Send an asset, or just "304 Not Modified" if the browser
+// already has the current version of it.
+static void sendAsset(int32_t sock, const uWifiCaptivePortalAsset_t *pAsset,
+                      const char *pRequest)
+{
+    static char header[255];
+    char eTag[U_WIFI_CAPTIVE_PORTAL_ETAG_MAX_LENGTH_BYTES + 3];
+
+    getETag(pAsset, eTag, sizeof(eTag));
+    if (eTagMatches(pRequest, eTag)) {
+        snprintf(header, sizeof(header),
+                 "HTTP/1.0 304 Not Modified\r\n"
+                 "Server: ubxlib\r\n"
+                 "ETag: %s\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "\r\n",
+                 eTag);
+        uSockWrite(sock, header, strlen(header));
+    } else {
+        snprintf(header, sizeof(header),
+                 "HTTP/1.0 200 OK\r\n"
+                 "Server: ubxlib\r\n"
+                 "Content-type: %s\r\n"
+                 "Content-Length: %d\r\n"
+                 "%s"
+                 "ETag: %s\r\n"
+                 "Cache-Control: no-cache\r\n"
+                 "\r\n",
+                 pAsset->pContentType, (int) pAsset->length,
+                 pAsset->gzip ? "Content-Encoding: gzip\r\n" : "", eTag);
+        uSockWrite(sock, header, strlen(header));
+        sendBody(sock, pAsset->pData, pAsset->length);
+    }
+}
+
 // Send the gathered SSID list
 static void sendSsidList(int32_t sock)
 {
@@ -267,7 +436,8 @@ static void updateWifi(int32_t sock, const char *params)
 static void handleRequest(const char *request, int32_t sock)
 {
     char method[15];
-    char url[25];
+    char url[U_WIFI_CAPTIVE_PORTAL_URL_MAX_LENGTH_BYTES];
+    const uWifiCaptivePortalAsset_t *pAsset;
     size_t pos = 0;
     while ((pos < (sizeof(method) - 1)) && (*request != ' ')) {
         method[pos++] = *(request++);
@@ -285,17 +455,21 @@ static void handleRequest(const char *request, int32_t sock)
         url[pos] = 0;
         uPortLog(LOG_PREFIX "Requested url \"%s\"\n", url);
         if (strcmp(method, "GET") == 0) {
+            pAsset = pAssetFind(url);
             if (strstr(url, "/get_ssid_list")) {
                 sendSsidList(sock);
+            } else if (pAsset != NULL) {
+                sendAsset(sock, pAsset, request);
             } else if (strstr(url, "/favicon.ico")) {
                 // Chrome will request this but none available here
                 ok = false;
             } else {
                 // Any other request else just gets the main page
-                const char *p = gIndexPage;
-                size_t len = strlen(p);
-                sendHeader(sock, "200 OK", "text/html", len);
-                uSockWrite(sock, p, len);
+                pAsset = pAssetFind("/");
+                if (pAsset == NULL) {
+                    pAsset = &gIndexAsset;
+                }
+                sendAsset(sock, pAsset, request);
             }
         } else if (strcmp(method, "POST") == 0) {
             if (strstr(url, "/set_wifi")) {
@@ -332,6 +506,32 @@ static void dnsServerTask(void *pParameters)
 // Special for now, non exposed global for accept timeouts, see u_wifi_sock.c
 extern int32_t gUWifiSocketAcceptTimeoutS;
 
+// Set the static assets to be served.
+int32_t uWifiCaptivePortalSetAssets(const uWifiCaptivePortalAsset_t *pAssets,
+                                    size_t numAssets)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+
+    if ((pAssets == NULL) && (numAssets > 0)) {
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    }
+    for (size_t x = 0; (errorCode == 0) && (x < numAssets); x++) {
+        if ((pAssets[x].pPath == NULL) || (pAssets[x].pContentType == NULL) ||
+            (strlen(pAssets[x].pPath) >= U_WIFI_CAPTIVE_PORTAL_URL_MAX_LENGTH_BYTES) ||
+            ((pAssets[x].pData == NULL) && (pAssets[x].length > 0)) ||
+            ((pAssets[x].pETag != NULL) &&
+             (strlen(pAssets[x].pETag) > U_WIFI_CAPTIVE_PORTAL_ETAG_MAX_LENGTH_BYTES))) {
+            errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        }
+    }
+    if (errorCode == 0) {
+        gpAssets = pAssets;
+        gNumAssets = numAssets;
+    }
+
+    return errorCode;
+}
+
 // Captive portal main function
 int32_t uWifiCaptivePortal(uDeviceHandle_t deviceHandle,
                            const char *pSsid,
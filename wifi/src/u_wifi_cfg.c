@@ -194,6 +194,9 @@ int32_t uWifiCfgConfigure(uDeviceHandle_t devHandle,
             if (pInstance != NULL) {
                 atHandle = pInstance->atHandle;
                 errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                // The IP settings are about to change under the feet
+                // of uWifiStationConnectFast()
+                pInstance->wifiStaCfgHash = 0;
                 if (pCfg->dhcp) {
                     uWifiStationSetDHCP(atHandle);
                 } else {
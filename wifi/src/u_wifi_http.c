@@ -107,6 +107,15 @@
 # define U_WIFI_HTTP_MAX_AT_PRINT_LENGTH 128
 #endif
 
+#ifndef U_WIFI_HTTP_STREAM_HEX_CHUNK_LENGTH_BYTES
+/** When the body of an HTTP response is being streamed, the hex
+ * coded bytes are read from the AT interface in chunks of this
+ * size, which is taken from the stack of the URC task; must be
+ * an even number.
+ */
+# define U_WIFI_HTTP_STREAM_HEX_CHUNK_LENGTH_BYTES 64
+#endif
+
 #ifndef U_WIFI_HTTP_MAX_NUM
 /** The maximum number of HTTP sessions that can be open at the same time.
  */
@@ -212,6 +221,195 @@ static int32_t atCloseHttp(uAtClientHandle_t atHandle, int32_t httpHandle)
     return uAtClientUnlock(atHandle);
 }
 
+// Read length bytes of HTTP response body from the AT interface into
+// the streaming buffer of pHttpContext, calling the body callback
+// each time the buffer is full and at the end; returns the number
+// of bytes passed to the body callback.
+static size_t readBodyStream(uAtClientHandle_t atHandle, uDeviceHandle_t devHandle,
+                             uHttpClientContext_t *pHttpContext, bool binary,
+                             size_t length)
+{
+    char hexBuffer[U_WIFI_HTTP_STREAM_HEX_CHUNK_LENGTH_BYTES];
+    size_t delivered = 0;
+    size_t fill = 0;
+    size_t thisSize;
+    bool readOk = true;
+
+    while ((length > 0) && readOk) {
+        thisSize = pHttpContext->bodyBufferSize - fill;
+        if (thisSize > length) {
+            thisSize = length;
+        }
+        if (binary) {
+            // Got the reply in hex, two characters per byte
+            if (thisSize > sizeof(hexBuffer) / 2) {
+                thisSize = sizeof(hexBuffer) / 2;
+            }
+            readOk = (uAtClientReadBytes(atHandle, hexBuffer, thisSize * 2,
+                                         true) == (int32_t) (thisSize * 2));
+            if (readOk) {
+                uHexToBin(hexBuffer, thisSize * 2, pHttpContext->pResponse + fill);
+            }
+        } else {
+            readOk = (uAtClientReadBytes(atHandle, pHttpContext->pResponse + fill,
+                                         thisSize, true) == (int32_t) thisSize);
+        }
+        if (readOk) {
+            fill += thisSize;
+            length -= thisSize;
+        }
+        if ((fill > 0) && ((fill == pHttpContext->bodyBufferSize) || (length == 0) || !readOk)) {
+            // Pass the buffer on, unless the user has asked
+            // to stop, in which case the data is just discarded
+            if (!pHttpContext->bodyStopped) {
+                delivered += fill;
+                if (!pHttpContext->pBodyCallback(devHandle, pHttpContext->pResponse,
+                                                 fill, pHttpContext->pBodyCallbackParam)) {
+                    pHttpContext->bodyStopped = true;
+                }
+            }
+            fill = 0;
+        }
+    }
+
+    return delivered;
+}
+
+// Perform an extended HTTP request, taking the data to send either
+// from pData or, if pSourceCallback is not NULL, from pSourceCallback
+// in chunks of at most U_HTTP_CLIENT_WIFI_CHUNK_LENGTH bytes.
+static int32_t requestEx(uDeviceHandle_t wifiHandle, int32_t httpHandle,
+                         uWifiHttpRequest_t requestType, const char *pPath,
+                         const char *pData, size_t contentLength,
+                         size_t maxContentLength, const char *pContentType,
+                         uWifiHttpSourceCallback_t *pSourceCallback,
+                         void *pSourceCallbackParam)
+{
+    uShortRangePrivateInstance_t *pInstance;
+    uAtClientHandle_t atHandle;
+    uHttpClientContextWifi_t *pContextWifi;
+    int32_t httpCommand = (int32_t) requestType;
+    int32_t bytesToWrite = 0;
+    size_t offset = 0;
+    char *pChunk = NULL;
+    const char *pBytes;
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+    int32_t err;
+
+    if (gUShortRangePrivateMutex != NULL) {
+        U_PORT_MUTEX_LOCK(gUShortRangePrivateMutex);
+
+        pInstance = pUShortRangePrivateGetInstance(wifiHandle);
+        if (pSourceCallback != NULL) {
+            // Allocate the chunk buffer before taking the AT lock
+            pChunk = (char *) pUPortMalloc(U_HTTP_CLIENT_WIFI_CHUNK_LENGTH);
+        }
+        if ((pInstance != NULL) &&
+            (httpHandle > 0) &&
+            (httpCommand >= 0) &&
+            ((pSourceCallback == NULL) || (pChunk != NULL))) {
+            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
+            if (U_SHORT_RANGE_PRIVATE_HAS(pInstance->pModule,
+                                          U_SHORT_RANGE_PRIVATE_FEATURE_HTTP_CLIENT)) {
+                if ((isAllowedHttpRequestStr(pPath, U_WIFI_HTTP_PATH_MAX_LENGTH_BYTES)) &&
+                    ((requestType == U_WIFI_HTTP_REQUEST_GET) ||
+                     (requestType == U_WIFI_HTTP_REQUEST_POST) ||
+                     (requestType == U_WIFI_HTTP_REQUEST_PUT) ||
+                     (requestType == U_WIFI_HTTP_REQUEST_PATCH) ||
+                     (requestType == U_WIFI_HTTP_REQUEST_DELETE) ||
+                     (requestType == U_WIFI_HTTP_REQUEST_OPTIONS) ||
+                     (requestType == U_WIFI_HTTP_REQUEST_GET_BINARY))) {
+                    pContextWifi = pInstance->pHttpContext->pPriv;
+                    if (requestType == U_WIFI_HTTP_REQUEST_GET_BINARY) {
+                        pContextWifi->binary = true;
+                    } else {
+                        pContextWifi->binary = false;
+                    }
+
+                    atHandle = pInstance->atHandle;
+                    uAtClientLock(atHandle);
+                    uAtClientCommandStart(atHandle, "AT+UDHTTPE=");
+                    uAtClientWriteInt(atHandle, httpHandle);
+                    uAtClientWriteInt(atHandle, httpCommand);
+                    uAtClientWriteString(atHandle, pPath, true);
+                    pContextWifi->atPrintWasOn = false;
+                    if ((requestType != U_WIFI_HTTP_REQUEST_GET_BINARY) &&
+                        (requestType != U_WIFI_HTTP_REQUEST_GET)) {
+                        if (isAllowedHttpRequestStr(pContentType,
+                                                    U_WIFI_HTTP_CONTENT_TYPE_MAX_LENGTH_BYTES) &&
+                            (contentLength <= maxContentLength)) {
+                            uAtClientWriteString(atHandle, pContentType, true);
+                            uAtClientWriteInt(atHandle, contentLength);
+                            uAtClientCommandStop(atHandle);
+#if U_WIFI_HTTP_MAX_AT_PRINT_LENGTH >= 0
+                            if (uAtClientPrintAtGet(atHandle) &&
+                                (contentLength > U_WIFI_HTTP_MAX_AT_PRINT_LENGTH)) {
+                                // Turn off AT command printing so as not to
+                                // overwhelm the logging stream
+                                uAtClientPrintAtSet(atHandle, false);
+                                pContextWifi->atPrintWasOn = true;
+                            }
+#endif
+                            // Wait for the prompt
+                            if (uAtClientWaitCharacter(atHandle, '>') == 0) {
+                                // Allow plenty of time for this to complete
+                                uAtClientTimeoutSet(atHandle, 10000);
+                                // Wait for it...
+                                do {
+                                    uPortTaskBlock(50);
+                                    // Write the binary message
+                                    if ((contentLength - offset) < U_HTTP_CLIENT_WIFI_CHUNK_LENGTH) {
+                                        bytesToWrite = contentLength - offset;
+                                    } else {
+                                        bytesToWrite = U_HTTP_CLIENT_WIFI_CHUNK_LENGTH;
+                                    }
+                                    errorCode = (int32_t) U_ERROR_COMMON_DEVICE_ERROR;
+                                    if (pSourceCallback != NULL) {
+                                        // Fetch the next chunk from the application
+                                        pBytes = pChunk;
+                                        if (pSourceCallback(wifiHandle, pChunk, bytesToWrite,
+                                                            offset, pSourceCallbackParam) != bytesToWrite) {
+                                            bytesToWrite = -1;
+                                        }
+                                    } else {
+                                        pBytes = pData + offset;
+                                    }
+                                    if ((bytesToWrite >= 0) &&
+                                        ((int32_t) uAtClientWriteBytes(atHandle, pBytes, bytesToWrite,
+                                                                       true) == bytesToWrite)) {
+                                        errorCode = U_ERROR_COMMON_SUCCESS;
+                                        offset += bytesToWrite;
+                                    }
+                                } while ((offset < contentLength) && errorCode == U_ERROR_COMMON_SUCCESS);
+                                uPortLog("\nU_WIFI_HTTP: wrote %d byte(s).\n", offset);
+                            }
+                        }
+                    } else {
+#if U_WIFI_HTTP_MAX_AT_PRINT_LENGTH >= 0
+                        if (uAtClientPrintAtGet(atHandle)) {
+                            // Turn off AT command printing so as not to
+                            // overwhelm the logging stream
+                            uAtClientPrintAtSet(atHandle, false);
+                            pContextWifi->atPrintWasOn = true;
+                        }
+#endif
+                        errorCode = U_ERROR_COMMON_SUCCESS;
+                    }
+                    uAtClientCommandStopReadResponse(atHandle);
+
+                    err = uAtClientUnlock(atHandle);
+                    if (err != U_ERROR_COMMON_SUCCESS) {
+                        errorCode = err;
+                    }
+                }
+            }
+        }
+        U_PORT_MUTEX_UNLOCK(gUShortRangePrivateMutex);
+        uPortFree(pChunk);
+    }
+    return errorCode;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -262,7 +460,11 @@ bool uWifiHttpPrivateUrc(uAtClientHandle_t atHandle, void *pParameter)
                         }
                     }
                     uAtClientIgnoreStopTag(atHandle);
-                    if (pHttpContext->pResponse) {
+                    if (pHttpContext->pBodyCallback != NULL) {
+                        replyLen = readBodyStream(atHandle, pWiFiInstance->devHandle,
+                                                  pHttpContext, pContextWifi->binary,
+                                                  replyLen);
+                    } else if (pHttpContext->pResponse) {
                         if (pContextWifi->binary) {
                             readBytes = replyLen * 2; // got reply in hex
                             pHexBuffer = (char *)pUPortMalloc(readBytes);
@@ -325,7 +527,13 @@ bool uWifiHttpPrivateUrc(uAtClientHandle_t atHandle, void *pParameter)
                         uAtClientSkipParameters(atHandle, 1);
                     }
                     uAtClientIgnoreStopTag(atHandle);
-                    if (pHttpContext->pResponse) {
+                    if (pHttpContext->pBodyCallback != NULL) {
+                        pContextWifi->replyOffset += readBodyStream(atHandle,
+                                                                    pWiFiInstance->devHandle,
+                                                                    pHttpContext,
+                                                                    pContextWifi->binary,
+                                                                    replyLen);
+                    } else if (pHttpContext->pResponse) {
                         if (pContextWifi->binary) {
                             readBytes = replyLen * 2; // got reply in hex
                             pHexBuffer = (char *)pUPortMalloc(readBytes);
@@ -573,110 +781,28 @@ int32_t uWifiHttpRequestEx(uDeviceHandle_t wifiHandle, int32_t httpHandle,
                            uWifiHttpRequest_t requestType, const char *pPath,
                            const char *pData, size_t contentLength, const char *pContentType)
 {
-    uShortRangePrivateInstance_t *pInstance;
-    uAtClientHandle_t atHandle;
-    uHttpClientContextWifi_t *pContextWifi;
-    int32_t httpCommand = (int32_t) requestType;
-    int32_t bytesToWrite = 0;
-    size_t offset = 0;
-    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
-    int32_t err;
-
-    if (gUShortRangePrivateMutex != NULL) {
-        U_PORT_MUTEX_LOCK(gUShortRangePrivateMutex);
-
-        pInstance = pUShortRangePrivateGetInstance(wifiHandle);
-        if ((pInstance != NULL) &&
-            (httpHandle > 0) &&
-            (httpCommand >= 0)) {
-            errorCode = (int32_t) U_ERROR_COMMON_NOT_SUPPORTED;
-            if (U_SHORT_RANGE_PRIVATE_HAS(pInstance->pModule,
-                                          U_SHORT_RANGE_PRIVATE_FEATURE_HTTP_CLIENT)) {
-                if ((isAllowedHttpRequestStr(pPath, U_WIFI_HTTP_PATH_MAX_LENGTH_BYTES)) &&
-                    ((requestType == U_WIFI_HTTP_REQUEST_GET) ||
-                     (requestType == U_WIFI_HTTP_REQUEST_POST) ||
-                     (requestType == U_WIFI_HTTP_REQUEST_PUT) ||
-                     (requestType == U_WIFI_HTTP_REQUEST_PATCH) ||
-                     (requestType == U_WIFI_HTTP_REQUEST_DELETE) ||
-                     (requestType == U_WIFI_HTTP_REQUEST_OPTIONS) ||
-                     (requestType == U_WIFI_HTTP_REQUEST_GET_BINARY))) {
-                    pContextWifi = pInstance->pHttpContext->pPriv;
-                    if (requestType == U_WIFI_HTTP_REQUEST_GET_BINARY) {
-                        pContextWifi->binary = true;
-                    } else {
-                        pContextWifi->binary = false;
-                    }
+    return requestEx(wifiHandle, httpHandle, requestType, pPath, pData,
+                     contentLength, U_WIFI_HTTP_BLOB_MAX_LENGTH_BYTES,
+                     pContentType, NULL, NULL);
+}
 
-                    atHandle = pInstance->atHandle;
-                    uAtClientLock(atHandle);
-                    uAtClientCommandStart(atHandle, "AT+UDHTTPE=");
-                    uAtClientWriteInt(atHandle, httpHandle);
-                    uAtClientWriteInt(atHandle, httpCommand);
-                    uAtClientWriteString(atHandle, pPath, true);
-                    pContextWifi->atPrintWasOn = false;
-                    if ((requestType != U_WIFI_HTTP_REQUEST_GET_BINARY) &&
-                        (requestType != U_WIFI_HTTP_REQUEST_GET)) {
-                        if (isAllowedHttpRequestStr(pContentType,
-                                                    U_WIFI_HTTP_CONTENT_TYPE_MAX_LENGTH_BYTES) &&
-                            (contentLength <= U_WIFI_HTTP_BLOB_MAX_LENGTH_BYTES)) {
-                            uAtClientWriteString(atHandle, pContentType, true);
-                            uAtClientWriteInt(atHandle, contentLength);
-                            uAtClientCommandStop(atHandle);
-#if U_WIFI_HTTP_MAX_AT_PRINT_LENGTH >= 0
-                            if (uAtClientPrintAtGet(atHandle) &&
-                                (contentLength > U_WIFI_HTTP_MAX_AT_PRINT_LENGTH)) {
-                                // Turn off AT command printing so as not to
-                                // overwhelm the logging stream
-                                uAtClientPrintAtSet(atHandle, false);
-                                pContextWifi->atPrintWasOn = true;
-                            }
-#endif
-                            // Wait for the prompt
-                            if (uAtClientWaitCharacter(atHandle, '>') == 0) {
-                                // Allow plenty of time for this to complete
-                                uAtClientTimeoutSet(atHandle, 10000);
-                                // Wait for it...
-                                do {
-                                    uPortTaskBlock(50);
-                                    // Write the binary message
-                                    if ((contentLength - offset) < U_HTTP_CLIENT_WIFI_CHUNK_LENGTH) {
-                                        bytesToWrite = contentLength - offset;
-                                    } else {
-                                        bytesToWrite = U_HTTP_CLIENT_WIFI_CHUNK_LENGTH;
-                                    }
-                                    if (uAtClientWriteBytes(atHandle,
-                                                            pData + offset,
-                                                            bytesToWrite,
-                                                            true) == bytesToWrite) {
-                                        errorCode = U_ERROR_COMMON_SUCCESS;
-                                    }
-                                    offset += bytesToWrite;
-                                } while ((offset < contentLength) && errorCode == U_ERROR_COMMON_SUCCESS);
-                                uPortLog("\nU_WIFI_HTTP: wrote %d byte(s).\n", offset);
-                            }
-                        }
-                    } else {
-#if U_WIFI_HTTP_MAX_AT_PRINT_LENGTH >= 0
-                        if (uAtClientPrintAtGet(atHandle)) {
-                            // Turn off AT command printing so as not to
-                            // overwhelm the logging stream
-                            uAtClientPrintAtSet(atHandle, false);
-                            pContextWifi->atPrintWasOn = true;
-                        }
-#endif
-                        errorCode = U_ERROR_COMMON_SUCCESS;
-                    }
-                    uAtClientCommandStopReadResponse(atHandle);
+// Perform an extended HTTP request with the data taken from a callback.
+int32_t uWifiHttpRequestExStream(uDeviceHandle_t wifiHandle, int32_t httpHandle,
+                                 uWifiHttpRequest_t requestType, const char *pPath,
+                                 size_t contentLength, const char *pContentType,
+                                 uWifiHttpSourceCallback_t *pSourceCallback,
+                                 void *pSourceCallbackParam)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
 
-                    err = uAtClientUnlock(atHandle);
-                    if (err != U_ERROR_COMMON_SUCCESS) {
-                        errorCode = err;
-                    }
-                }
-            }
-        }
-        U_PORT_MUTEX_UNLOCK(gUShortRangePrivateMutex);
+    if ((pSourceCallback != NULL) &&
+        (requestType != U_WIFI_HTTP_REQUEST_GET) &&
+        (requestType != U_WIFI_HTTP_REQUEST_GET_BINARY)) {
+        errorCode = requestEx(wifiHandle, httpHandle, requestType, pPath, NULL,
+                              contentLength, U_WIFI_HTTP_STREAM_MAX_LENGTH_BYTES,
+                              pContentType, pSourceCallback, pSourceCallbackParam);
     }
+
     return errorCode;
 }
 
@@ -56,6 +56,7 @@
 #include "u_short_range.h"
 #include "u_short_range_private.h"
 #include "u_wifi_module_type.h"
+#include "u_wifi.h"
 #include "u_wifi_loc.h"
 #include "u_wifi_loc_private.h"
 #include "u_wifi_private.h"
@@ -100,6 +101,21 @@ typedef struct {
     uWifiLocCallback_t *pCallback;
 } uWifiLocCallbackContext_t;
 
+/** The location cache, hung off the Wi-Fi instance as pLocCache
+ * and protected by gUShortRangePrivateMutex.
+ */
+typedef struct {
+    int32_t similarityPercent;
+    int32_t maxAgeSeconds;
+    int32_t noScanSeconds;
+    bool valid;
+    uLocationType_t type;
+    uLocation_t location;
+    int32_t timeMs;    /**< the tick time at which location was obtained. */
+    size_t numBssids;
+    uint8_t bssid[U_WIFI_LOC_CACHE_MAX_NUM_BSSIDS * U_WIFI_BSSID_SIZE];
+} uWifiLocCache_t;
+
 /* ----------------------------------------------------------------
  * VARIABLES
  * -------------------------------------------------------------- */
@@ -353,6 +369,50 @@ static volatile uWifiLocContext_t *pBeginLocationAlloc(uShortRangePrivateInstanc
     return pContext;
 }
 
+// Return the Jaccard similarity, as a percentage, of two sets of BSSIDs.
+static int32_t jaccardPercent(const uint8_t *pBssidsA, size_t numA,
+                              const uint8_t *pBssidsB, size_t numB)
+{
+    size_t numCommon = 0;
+    size_t numUnion;
+
+    for (size_t x = 0; x < numA; x++) {
+        for (size_t y = 0; y < numB; y++) {
+            if (memcmp(pBssidsA + (x * U_WIFI_BSSID_SIZE),
+                       pBssidsB + (y * U_WIFI_BSSID_SIZE), U_WIFI_BSSID_SIZE) == 0) {
+                numCommon++;
+                break;
+            }
+        }
+    }
+    numUnion = numA + numB - numCommon;
+
+    return (numUnion > 0) ? (int32_t) ((numCommon * 100) / numUnion) : 0;
+}
+
+// Return true if the cached location may be returned in place of
+// a location of the given type, given the BSSIDs now visible or,
+// if numBssids is negative, without a scan; must be called with
+// gUShortRangePrivateMutex held.
+static bool locCacheHit(const uWifiLocCache_t *pCache, uLocationType_t type,
+                        const uint8_t *pBssids, int32_t numBssids)
+{
+    bool hit = false;
+    int32_t ageMs = uPortGetTickTimeMs() - pCache->timeMs;
+
+    if (pCache->valid && (pCache->type == type)) {
+        if (numBssids < 0) {
+            hit = ageMs < pCache->noScanSeconds * 1000;
+        } else {
+            hit = (ageMs < pCache->maxAgeSeconds * 1000) &&
+                  (jaccardPercent(pCache->bssid, pCache->numBssids,
+                                  pBssids, (size_t) numBssids) >= pCache->similarityPercent);
+        }
+    }
+
+    return hit;
+}
+
 // Ensure that we have a location mutex for the instance.
 static int32_t ensureMutex(uShortRangePrivateInstance_t *pInstance)
 {
@@ -504,6 +564,10 @@ int32_t uWifiLocGet(uDeviceHandle_t wifiHandle,
     volatile uWifiLocContext_t *pContext;
     uAtClientHandle_t atHandle;
     int32_t startTimeMs;
+    uWifiLocCache_t *pCache = NULL;
+    uint8_t bssids[U_WIFI_LOC_CACHE_MAX_NUM_BSSIDS * U_WIFI_BSSID_SIZE];
+    int32_t numBssids = -1;
+    bool cacheHit = false;
 
     if (gUShortRangePrivateMutex != NULL) {
 
@@ -517,10 +581,39 @@ int32_t uWifiLocGet(uDeviceHandle_t wifiHandle,
         if ((pInstance != NULL) && (pApiKey != NULL) && (rssiDbmFilter <= 0) &&
             (type >= 0) &&
             (type < sizeof(gULocationTypeToUConnectType) / sizeof(gULocationTypeToUConnectType[0]))) {
-            // Make sure we have a mutex (needed to protect the context
-            // for async operations but we use it here as a busy-check also)
-            errorCode = ensureMutex(pInstance);
-            if (errorCode == 0) {
+            pCache = (uWifiLocCache_t *) pInstance->pLocCache;
+            if (pLocation == NULL) {
+                // Nowhere to put a cached location
+                pCache = NULL;
+            }
+            if ((pCache != NULL) && !locCacheHit(pCache, type, NULL, -1)) {
+                // Scanning takes gUShortRangePrivateMutex, so let
+                // go of the mutex, scan and come back
+                uPortMutexUnlock(gUShortRangePrivateMutex);
+                numBssids = uWifiPrivateScanBssids(wifiHandle, bssids,
+                                                   U_WIFI_LOC_CACHE_MAX_NUM_BSSIDS);
+                uPortMutexLock(gUShortRangePrivateMutex);
+                // The instance may have gone while we were away
+                pCache = NULL;
+                pInstance = pUShortRangePrivateGetInstance(wifiHandle);
+                if (pInstance != NULL) {
+                    pCache = (uWifiLocCache_t *) pInstance->pLocCache;
+                }
+                cacheHit = (pCache != NULL) && (numBssids >= 0) &&
+                           locCacheHit(pCache, type, bssids, numBssids);
+            } else {
+                cacheHit = (pCache != NULL);
+            }
+            if (pInstance == NULL) {
+                errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+            } else if (cacheHit) {
+                uPortLog("U_WIFI_LOC: environment unchanged, using cached location.\n");
+                *pLocation = pCache->location;
+                errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            } else {
+                errorCode = ensureMutex(pInstance);
+            }
+            if ((errorCode == 0) && !cacheHit) {
                 // Can only fiddle with memory if we have the location mutex
                 errorCode = (int32_t) U_ERROR_COMMON_BUSY;
                 if (uPortMutexTryLock(pInstance->locMutex, 0) == 0) {
@@ -547,6 +640,16 @@ int32_t uWifiLocGet(uDeviceHandle_t wifiHandle,
                             }
                             errorCode = pContext->errorCode;
                         }
+                        if ((errorCode == 0) && (pCache != NULL) && (pLocation != NULL) &&
+                            (numBssids >= 0)) {
+                            // Remember the location and the environment it was in
+                            pCache->valid = true;
+                            pCache->type = type;
+                            pCache->location = *pLocation;
+                            pCache->timeMs = uPortGetTickTimeMs();
+                            pCache->numBssids = (size_t) numBssids;
+                            memcpy(pCache->bssid, bssids, numBssids * U_WIFI_BSSID_SIZE);
+                        }
                         pInstance->pLocContext = NULL;
                         // Free memory
                         uPortFree((void *) pContext);
@@ -696,9 +799,58 @@ void uWifiLocFree(uDeviceHandle_t wifiHandle)
             uPortMutexDelete(pInstance->locMutex);
             pInstance->locMutex = NULL;
         }
+        if (pInstance != NULL) {
+            uPortFree(pInstance->pLocCache);
+            pInstance->pLocCache = NULL;
+        }
+
+        U_PORT_MUTEX_UNLOCK(gUShortRangePrivateMutex);
+    }
+}
+
+// Switch the location cache on or off.
+int32_t uWifiLocSetCache(uDeviceHandle_t wifiHandle, int32_t similarityPercent,
+                         int32_t maxAgeSeconds, int32_t noScanSeconds)
+{
+    int32_t errorCode = (int32_t) U_ERROR_COMMON_NOT_INITIALISED;
+    uShortRangePrivateInstance_t *pInstance;
+    uWifiLocCache_t *pCache;
+
+    if (gUShortRangePrivateMutex != NULL) {
+
+        U_PORT_MUTEX_LOCK(gUShortRangePrivateMutex);
+
+        errorCode = (int32_t) U_ERROR_COMMON_INVALID_PARAMETER;
+        pInstance = pUShortRangePrivateGetInstance(wifiHandle);
+        if ((pInstance != NULL) && (similarityPercent >= 0) && (similarityPercent <= 100) &&
+            (maxAgeSeconds >= 0) && (noScanSeconds >= 0)) {
+            errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+            pCache = (uWifiLocCache_t *) pInstance->pLocCache;
+            if (similarityPercent == 0) {
+                uPortFree(pCache);
+                pInstance->pLocCache = NULL;
+            } else {
+                if (pCache == NULL) {
+                    errorCode = (int32_t) U_ERROR_COMMON_NO_MEMORY;
+                    pCache = (uWifiLocCache_t *) pUPortMalloc(sizeof(*pCache));
+                    if (pCache != NULL) {
+                        memset(pCache, 0, sizeof(*pCache));
+                        pInstance->pLocCache = pCache;
+                        errorCode = (int32_t) U_ERROR_COMMON_SUCCESS;
+                    }
+                }
+                if (pCache != NULL) {
+                    pCache->similarityPercent = similarityPercent;
+                    pCache->maxAgeSeconds = maxAgeSeconds;
+                    pCache->noScanSeconds = noScanSeconds;
+                }
+            }
+        }
 
         U_PORT_MUTEX_UNLOCK(gUShortRangePrivateMutex);
     }
+
+    return errorCode;
 }
 
 // End of file
@@ -77,6 +77,25 @@
 # define U_WIFI_MQTT_DATA_EVENT_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
 #endif
 
+#ifndef U_WIFI_MQTT_PUBLISH_EVENT_STACK_SIZE
+/* The stack size for the asynchronous publish event queue task,
+ * which calls uShortRangeEdmStreamWrite() and possibly connects to
+ * the broker for a new topic.
+ */
+# define U_WIFI_MQTT_PUBLISH_EVENT_STACK_SIZE 2048
+#endif
+
+#ifndef U_WIFI_MQTT_PUBLISH_EVENT_PRIORITY
+# define U_WIFI_MQTT_PUBLISH_EVENT_PRIORITY (U_CFG_OS_PRIORITY_MAX - 5)
+#endif
+
+#ifndef U_WIFI_MQTT_CLOSE_WAIT_MS
+/* How long uWifiMqttClose() will wait for asynchronous publishes
+ * that are in flight to complete.
+ */
+# define U_WIFI_MQTT_CLOSE_WAIT_MS 5000
+#endif
+
 typedef struct uWifiMqttTopic_t {
     char *pTopicStr;
     int32_t edmChannel;
@@ -110,8 +129,24 @@ typedef struct uWifiMqttSession_t {
     void *pCbParam;
     void (*pDataCb)(int32_t unreadMsgsCount, void *pCbParam);
     void (*pDisconnectCb)(int32_t status, void *pCbParam);
+    void (*pPublishCb)(int32_t messageId, int32_t errorCode, void *pCbParam);
+    void *pPublishCbParam;
+    int32_t publishCount; /**< the number of asynchronous publishes in flight. */
+    int32_t publishNextId;
 } uWifiMqttSession_t;
 
+/** An asynchronous publish; the topic string and then the message
+ * follow this structure in the same allocation.
+ */
+typedef struct {
+    const uMqttClientContext_t *pContext;
+    uWifiMqttSession_t *pMqttSession;
+    int32_t messageId;
+    size_t messageSizeBytes;
+    uMqttQos_t qos;
+    bool retain;
+} uWifiMqttPublish_t;
+
 typedef struct {
     uWifiMqttSession_t *pMqttSession;
     void *pCbParam;
@@ -124,6 +159,7 @@ static uWifiMqttSession_t gMqttSessions[U_WIFI_MQTT_MAX_NUM_CONNECTIONS];
 static uPortMutexHandle_t gMqttSessionMutex = NULL;
 static int32_t gCallbackQueue = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
 static int32_t gEdmChannel = -1;
+static int32_t gPublishQueue = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
 
 /**
  * Fetch the topic string in a given MQTT session associated to particular EDM channel
@@ -761,6 +797,10 @@ static void freeMqtt(uMqttClientContext_t *pContext)
                                                      NULL);
             uPortEventQueueClose(gCallbackQueue);
             gCallbackQueue = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+            if (gPublishQueue >= 0) {
+                uPortEventQueueClose(gPublishQueue);
+                gPublishQueue = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+            }
 
         }
     }
@@ -838,6 +878,158 @@ static int32_t configureMqttSessionConnection(uWifiMqttSession_t *pMqttSession,
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
 
+/**
+ * Publish a message, synchronously
+ */
+static int32_t publish(const uMqttClientContext_t *pContext,
+                       const char *pTopicNameStr,
+                       const char *pMessage,
+                       size_t messageSizeBytes,
+                       uMqttQos_t qos,
+                       bool retain)
+{
+    uWifiMqttSession_t *pMqttSession;
+    uWifiMqttTopic_t *pTopic;
+    uShortRangePrivateInstance_t *pInstance;
+    int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+
+        // Check WiFi SHO handle and MQTT session exists
+        if (getMqttInstance(pContext, &pInstance, &pMqttSession) == (int32_t)U_ERROR_COMMON_SUCCESS) {
+
+            // Check if we have this pTopic already mapped to this session
+            pTopic = findTopic(pMqttSession, pTopicNameStr, true);
+
+            if (pTopic == NULL) {
+
+                // Create a new pTopic and insert it to this session
+                pTopic = pAllocateMqttTopic(pMqttSession, true);
+
+                if (pTopic != NULL) {
+
+                    pTopic->retain = retain;
+                    pTopic->qos = qos;
+
+                    err = copyConnectionParams(&pTopic->pTopicStr,
+                                               pTopicNameStr);
+
+                    if (err == (int32_t)U_ERROR_COMMON_SUCCESS) {
+                        err = establishMqttConnectionToBroker(pContext, pMqttSession, pTopic, true);
+                    }
+
+                }
+
+            } else {
+
+                err = (int32_t)U_ERROR_COMMON_SUCCESS;
+
+            }
+
+            if (err == (int32_t)U_ERROR_COMMON_SUCCESS) {
+                //lint -esym(613, pTopic) Suppress possible use of NULL pointer in future
+                err = uShortRangeEdmStreamWrite(pInstance->streamHandle,
+                                                pTopic->edmChannel,
+                                                pMessage,
+                                                messageSizeBytes,
+                                                U_WIFI_MQTT_WRITE_TIMEOUT_MS);
+                uPortLog("EDM write for channel %d message bytes %d written bytes %d\n", pTopic->edmChannel,
+                         messageSizeBytes,
+                         err);
+            }
+            if (err == messageSizeBytes) {
+                err = (int32_t)U_ERROR_COMMON_SUCCESS;
+            }
+        }
+        uShortRangeUnlock();
+    }
+
+    return err;
+}
+
+/**
+ * Callback to perform an asynchronous publish, from gPublishQueue
+ */
+static void onPublishEvent(void *pParam, size_t eventSize)
+{
+    uWifiMqttPublish_t *pPublish = *((uWifiMqttPublish_t **) pParam);
+    const char *pTopicNameStr = (const char *) (pPublish + 1);
+    uWifiMqttSession_t *pMqttSession = pPublish->pMqttSession;
+    void (*pCallback)(int32_t, int32_t, void *) = NULL;
+    void *pCallbackParam = NULL;
+    int32_t err;
+    (void) eventSize;
+
+    err = publish(pPublish->pContext, pTopicNameStr,
+                  pTopicNameStr + strlen(pTopicNameStr) + 1,
+                  pPublish->messageSizeBytes, pPublish->qos, pPublish->retain);
+
+    U_PORT_MUTEX_LOCK(gMqttSessionMutex);
+    if (pMqttSession->publishCount > 0) {
+        pMqttSession->publishCount--;
+    }
+    pCallback = pMqttSession->pPublishCb;
+    pCallbackParam = pMqttSession->pPublishCbParam;
+    U_PORT_MUTEX_UNLOCK(gMqttSessionMutex);
+
+    if (pCallback != NULL) {
+        pCallback(pPublish->messageId, err, pCallbackParam);
+    }
+
+    uPortFree(pPublish);
+}
+
+/**
+ * Queue a message for asynchronous publish, returning the message ID
+ */
+static int32_t publishAsync(const uMqttClientContext_t *pContext,
+                            uWifiMqttSession_t *pMqttSession,
+                            const char *pTopicNameStr,
+                            const char *pMessage,
+                            size_t messageSizeBytes,
+                            uMqttQos_t qos,
+                            bool retain)
+{
+    int32_t errOrId = (int32_t)U_ERROR_COMMON_BUSY;
+    uWifiMqttPublish_t *pPublish;
+    size_t topicSizeBytes = strlen(pTopicNameStr) + 1;
+
+    U_PORT_MUTEX_LOCK(gMqttSessionMutex);
+
+    if (pMqttSession->publishCount < U_WIFI_MQTT_PUBLISH_WINDOW_SIZE) {
+        errOrId = (int32_t)U_ERROR_COMMON_NO_MEMORY;
+        pPublish = (uWifiMqttPublish_t *) pUPortMalloc(sizeof(*pPublish) + topicSizeBytes +
+                                                       messageSizeBytes);
+        if (pPublish != NULL) {
+            pPublish->pContext = pContext;
+            pPublish->pMqttSession = pMqttSession;
+            pPublish->messageId = pMqttSession->publishNextId;
+            pPublish->messageSizeBytes = messageSizeBytes;
+            pPublish->qos = qos;
+            pPublish->retain = retain;
+            memcpy(pPublish + 1, pTopicNameStr, topicSizeBytes);
+            if (messageSizeBytes > 0) {
+                memcpy(((char *) (pPublish + 1)) + topicSizeBytes, pMessage, messageSizeBytes);
+            }
+            errOrId = uPortEventQueueSend(gPublishQueue, &pPublish, sizeof(pPublish));
+            if (errOrId == 0) {
+                errOrId = pPublish->messageId;
+                pMqttSession->publishCount++;
+                pMqttSession->publishNextId++;
+                if (pMqttSession->publishNextId < 0) {
+                    pMqttSession->publishNextId = 0;
+                }
+            } else {
+                uPortFree(pPublish);
+            }
+        }
+    }
+
+    U_PORT_MUTEX_UNLOCK(gMqttSessionMutex);
+
+    return errOrId;
+}
+
 void uWifiMqttPrivateLink()
 {
     //dummy
@@ -977,6 +1169,40 @@ int32_t uWifiMqttSetMessageCallback(const uMqttClientContext_t *pContext,
     return err;
 }
 
+int32_t uWifiMqttSetPublishCallback(const uMqttClientContext_t *pContext,
+                                    void (*pCallback) (int32_t, int32_t, void *),
+                                    void *pCallbackParam)
+{
+    uWifiMqttSession_t *pMqttSession;
+    uShortRangePrivateInstance_t *pInstance;
+    int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+
+    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+        err = getMqttInstance(pContext, &pInstance, &pMqttSession);
+        if (err == (int32_t)U_ERROR_COMMON_SUCCESS) {
+            U_PORT_MUTEX_LOCK(gMqttSessionMutex);
+            if ((pCallback != NULL) && (gPublishQueue == (int32_t)U_ERROR_COMMON_NOT_INITIALISED)) {
+                gPublishQueue = uPortEventQueueOpen(onPublishEvent,
+                                                    "uWifiMqttPublishQueue",
+                                                    sizeof(uWifiMqttPublish_t *),
+                                                    U_WIFI_MQTT_PUBLISH_EVENT_STACK_SIZE,
+                                                    U_WIFI_MQTT_PUBLISH_EVENT_PRIORITY,
+                                                    U_WIFI_MQTT_PUBLISH_WINDOW_SIZE *
+                                                    U_WIFI_MQTT_MAX_NUM_CONNECTIONS);
+            }
+            if ((pCallback == NULL) || (gPublishQueue >= 0)) {
+                pMqttSession->pPublishCb = pCallback;
+                pMqttSession->pPublishCbParam = pCallbackParam;
+            } else {
+                err = (int32_t)U_ERROR_COMMON_NOT_INITIALISED;
+            }
+            U_PORT_MUTEX_UNLOCK(gMqttSessionMutex);
+        }
+        uShortRangeUnlock();
+    }
+    return err;
+}
+
 int32_t uWifiMqttSetDisconnectCallback(const uMqttClientContext_t *pContext,
                                        void (*pCallback) (int32_t, void *),
                                        void *pCallbackParam)
@@ -1017,63 +1243,27 @@ int32_t uWifiMqttPublish(const uMqttClientContext_t *pContext,
                          uMqttQos_t qos,
                          bool retain)
 {
-    uWifiMqttSession_t *pMqttSession;
-    uWifiMqttTopic_t *pTopic;
+    uWifiMqttSession_t *pMqttSession = NULL;
     uShortRangePrivateInstance_t *pInstance;
-    int32_t err = (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+    bool async = false;
 
-    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+    if ((pTopicNameStr == NULL) || ((pMessage == NULL) && (messageSizeBytes > 0))) {
+        return (int32_t)U_ERROR_COMMON_INVALID_PARAMETER;
+    }
 
-        // Check WiFi SHO handle and MQTT session exists
+    if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
         if (getMqttInstance(pContext, &pInstance, &pMqttSession) == (int32_t)U_ERROR_COMMON_SUCCESS) {
-
-            // Check if we have this pTopic already mapped to this session
-            pTopic = findTopic(pMqttSession, pTopicNameStr, true);
-
-            if (pTopic == NULL) {
-
-                // Create a new pTopic and insert it to this session
-                pTopic = pAllocateMqttTopic(pMqttSession, true);
-
-                if (pTopic != NULL) {
-
-                    pTopic->retain = retain;
-                    pTopic->qos = qos;
-
-                    err = copyConnectionParams(&pTopic->pTopicStr,
-                                               pTopicNameStr);
-
-                    if (err == (int32_t)U_ERROR_COMMON_SUCCESS) {
-                        err = establishMqttConnectionToBroker(pContext, pMqttSession, pTopic, true);
-                    }
-
-                }
-
-            } else {
-
-                err = (int32_t)U_ERROR_COMMON_SUCCESS;
-
-            }
-
-            if (err == (int32_t)U_ERROR_COMMON_SUCCESS) {
-                //lint -esym(613, pTopic) Suppress possible use of NULL pointer in future
-                err = uShortRangeEdmStreamWrite(pInstance->streamHandle,
-                                                pTopic->edmChannel,
-                                                pMessage,
-                                                messageSizeBytes,
-                                                U_WIFI_MQTT_WRITE_TIMEOUT_MS);
-                uPortLog("EDM write for channel %d message bytes %d written bytes %d\n", pTopic->edmChannel,
-                         messageSizeBytes,
-                         err);
-            }
-            if (err == messageSizeBytes) {
-                err = (int32_t)U_ERROR_COMMON_SUCCESS;
-            }
+            async = (pMqttSession->pPublishCb != NULL);
         }
         uShortRangeUnlock();
     }
 
-    return err;
+    if (async) {
+        return publishAsync(pContext, pMqttSession, pTopicNameStr,
+                            pMessage, messageSizeBytes, qos, retain);
+    }
+
+    return publish(pContext, pTopicNameStr, pMessage, messageSizeBytes, qos, retain);
 }
 
 int32_t uWifiMqttSubscribe(const uMqttClientContext_t *pContext,
@@ -1195,6 +1385,26 @@ void uWifiMqttClose(uMqttClientContext_t *pContext)
     uWifiMqttSession_t *pMqttSession;
     uShortRangePrivateInstance_t *pInstance;
     bool isMqttConnected;
+    int32_t publishCount = 0;
+    int32_t startTimeMs = uPortGetTickTimeMs();
+
+    // Let any asynchronous publishes complete, since they refer to
+    // pContext, for a while at least
+    do {
+        if (publishCount > 0) {
+            uPortTaskBlock(50);
+        }
+        publishCount = 0;
+        if (uShortRangeLock() == (int32_t)U_ERROR_COMMON_SUCCESS) {
+            if (getMqttInstance(pContext, &pInstance, &pMqttSession) == (int32_t)U_ERROR_COMMON_SUCCESS) {
+                U_PORT_MUTEX_LOCK(gMqttSessionMutex);
+                publishCount = pMqttSession->publishCount;
+                U_PORT_MUTEX_UNLOCK(gMqttSessionMutex);
+            }
+            uShortRangeUnlock();
+        }
+    } while ((publishCount > 0) &&
+             (uPortGetTickTimeMs() - startTimeMs < U_WIFI_MQTT_CLOSE_WAIT_MS));
 
     isMqttConnected = uWifiMqttIsConnected(pContext);
 
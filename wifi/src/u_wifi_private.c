@@ -34,6 +34,7 @@
 #include "stdint.h"    // int32_t etc.
 #include "stdbool.h"
 
+#include "u_device.h"
 #include "u_at_client.h"
 
 #include "u_wifi_http_private.h"
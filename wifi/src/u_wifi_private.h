@@ -52,6 +52,21 @@ extern "C" {
  */
 void uWifiPrivateUudhttpUrc(uAtClientHandle_t atHandle, void *pParameter);
 
+/** Scan for access points, as uWifiStationScan() does, but just
+ * return the BSSIDs that are found.  This takes the short range lock
+ * so must NOT be called with it held.
+ *
+ * @param devHandle     the handle of the wifi instance.
+ * @param[out] pBssids  a place to put the binary BSSIDs, each of
+ *                      #U_WIFI_BSSID_SIZE bytes; cannot be NULL.
+ * @param maxNumBssids  the number of BSSIDs there is room for at
+ *                      pBssids; any more are ignored.
+ * @return              on success the number of BSSIDs stored at
+ *                      pBssids, else negative error code.
+ */
+int32_t uWifiPrivateScanBssids(uDeviceHandle_t devHandle, uint8_t *pBssids,
+                               size_t maxNumBssids);
+
 #ifdef __cplusplus
 }
 #endif
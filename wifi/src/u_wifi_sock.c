@@ -41,12 +41,15 @@
 
 #include "u_port.h"
 #include "u_port_os.h"
+#include "u_port_heap.h"
 #include "u_cfg_sw.h"
 #include "u_port_debug.h"
 #include "u_cfg_os_platform_specific.h"
 
 #include "u_at_client.h"
 
+#include "u_ringbuffer.h"
+
 #include "u_sock_errno.h"
 #include "u_sock.h"
 
@@ -63,7 +66,31 @@
  * COMPILE-TIME MACROS
  * ------------------------------------------------------------- */
 
-#define U_WIFI_MAX_INSTANCE_COUNT 2
+#ifndef U_WIFI_MAX_INSTANCE_COUNT
+/** The maximum number of Wi-Fi instances that sockets can be
+ * used on at one time.
+ */
+# define U_WIFI_MAX_INSTANCE_COUNT 2
+#endif
+
+#ifndef U_WIFI_SOCK_EDM_CHANNEL_MAP_SIZE
+/** The number of EDM channels, counting from zero, for which the
+ * socket carrying that channel can be found by a direct look-up,
+ * see gEdmChannelToSocket; a socket on a channel outside this range
+ * is still found, just by searching.  Costs one byte per channel
+ * per Wi-Fi instance.
+ */
+# define U_WIFI_SOCK_EDM_CHANNEL_MAP_SIZE 32
+#endif
+
+#if U_WIFI_SOCK_MAX_NUM_SOCKETS > INT8_MAX
+# error U_WIFI_SOCK_MAX_NUM_SOCKETS must fit into the int8_t entries of gEdmChannelToSocket.
+#endif
+
+#if (U_WIFI_SOCK_WRITE_ZERO_COPY_HEADROOM_BYTES != U_SHORT_RANGE_EDM_STREAM_WRITE_HEADROOM_BYTES) || \
+    (U_WIFI_SOCK_WRITE_ZERO_COPY_TAILROOM_BYTES != U_SHORT_RANGE_EDM_STREAM_WRITE_TAILROOM_BYTES)
+# error U_WIFI_SOCK_WRITE_ZERO_COPY_HEADROOM_BYTES/TAILROOM_BYTES do not match the EDM stream
+#endif
 
 /* ----------------------------------------------------------------
  * TYPES
@@ -75,6 +102,7 @@ typedef enum {
     WIFI_INT_OPT_TCP_KEEPIDLE,
     WIFI_INT_OPT_TCP_KEEPINTVL,
     WIFI_INT_OPT_TCP_KEEPCNT,
+    WIFI_INT_OPT_SOCK_RCVBUF,
 
     /* Sentinel */
     WIFI_INT_OPT_MAX
@@ -102,6 +130,10 @@ typedef struct {
     int32_t serverId;
     int32_t remotePort;
     uShortRangePbufList_t *pTcpRxBuff;
+    char *pTcpRxRingBuffer; /**< The linear buffer under tcpRxRing,
+                                 NULL if the socket has no receive
+                                 ring buffer, see setRxRingSize(). */
+    uRingBuffer_t tcpRxRing;
     uShortRangePktList_t udpPktList;
     int32_t intOpts[WIFI_INT_OPT_MAX];
     uWifiSockCallback_t pAsyncClosedCallback; /**< Set to NULL if socket is not in use. */
@@ -139,6 +171,13 @@ static uDeviceHandle_t gInstanceDeviceHandleList[U_WIFI_MAX_INSTANCE_COUNT];
 
 uPortMutexHandle_t gSocketsMutex = NULL;
 static uWifiSockSocket_t gSockets[U_WIFI_SOCK_MAX_NUM_SOCKETS];
+
+/** The handle of the socket carrying each EDM channel, -1 for none,
+ * for each entry in gInstanceDeviceHandleList, so that received
+ * data can be passed to its socket without searching for it;
+ * kept up to date by setEdmChannel().
+ */
+static int8_t gEdmChannelToSocket[U_WIFI_MAX_INSTANCE_COUNT][U_WIFI_SOCK_EDM_CHANNEL_MAP_SIZE];
 static uPingContext_t gPingContext;
 
 /* ----------------------------------------------------------------
@@ -155,13 +194,53 @@ int32_t gUWifiSocketAcceptTimeoutS = -1;
  * STATIC FUNCTIONS
  * ------------------------------------------------------------- */
 
+// Return the index of devHandle in gInstanceDeviceHandleList,
+// -1 if it is not there.
+static int32_t getInstanceIndex(uDeviceHandle_t devHandle)
+{
+    int32_t index = -1;
+
+    for (int32_t i = 0; (i < U_WIFI_MAX_INSTANCE_COUNT) && (devHandle != NULL); i++) {
+        if (gInstanceDeviceHandleList[i] == devHandle) {
+            index = i;
+            break;
+        }
+    }
+
+    return index;
+}
+
+// Set the EDM channel of a socket, -1 for none, keeping
+// gEdmChannelToSocket up to date.
+static void setEdmChannel(uWifiSockSocket_t *pSock, int32_t edmChannel)
+{
+    int32_t index = getInstanceIndex(pSock->devHandle);
+
+    if (index >= 0) {
+        if ((pSock->edmChannel >= 0) && (pSock->edmChannel < U_WIFI_SOCK_EDM_CHANNEL_MAP_SIZE) &&
+            (gEdmChannelToSocket[index][pSock->edmChannel] == pSock->sockHandle)) {
+            gEdmChannelToSocket[index][pSock->edmChannel] = -1;
+        }
+        if ((edmChannel >= 0) && (edmChannel < U_WIFI_SOCK_EDM_CHANNEL_MAP_SIZE) &&
+            (pSock->sockHandle >= 0)) {
+            gEdmChannelToSocket[index][edmChannel] = (int8_t) pSock->sockHandle;
+        }
+    }
+    pSock->edmChannel = edmChannel;
+}
+
 static void freeSocket(uWifiSockSocket_t *pSock)
 {
     if (pSock != NULL) {
+        setEdmChannel(pSock, -1);
         pSock->sockHandle = -1;
-        pSock->edmChannel = -1;
         pSock->isClient = false;
         pSock->connected = false;
+        if (pSock->pTcpRxRingBuffer != NULL) {
+            uRingBufferDelete(&(pSock->tcpRxRing));
+            uPortFree(pSock->pTcpRxRingBuffer);
+            pSock->pTcpRxRingBuffer = NULL;
+        }
         if (pSock->semaphore != NULL) {
             uPortSemaphoreDelete(pSock->semaphore);
             pSock->semaphore = NULL;
@@ -230,6 +309,8 @@ static inline WifiIntOptId_t getIntOptionId(int32_t level, uint32_t option)
             default:
                 break;
         }
+    } else if ((level == U_SOCK_OPT_LEVEL_SOCK) && (option == U_SOCK_OPT_RCVBUF)) {
+        return WIFI_INT_OPT_SOCK_RCVBUF;
     }
     return WIFI_INT_OPT_INVALID;
 }
@@ -313,8 +394,24 @@ static uWifiSockSocket_t *pFindConnectingSocketByRemoteAddress(uDeviceHandle_t d
 static uWifiSockSocket_t *pFindSocketByEdmChannel(uDeviceHandle_t devHandle, int32_t edmChannel)
 {
     uWifiSockSocket_t *pSock = NULL;
+    int32_t instanceIndex = getInstanceIndex(devHandle);
+    int32_t sockHandle;
+
+    // This is called for every packet of received data so
+    // try the direct look-up first
+    if ((instanceIndex >= 0) && (edmChannel >= 0) &&
+        (edmChannel < U_WIFI_SOCK_EDM_CHANNEL_MAP_SIZE)) {
+        sockHandle = gEdmChannelToSocket[instanceIndex][edmChannel];
+        if ((sockHandle >= 0) &&
+            (gSockets[sockHandle].sockHandle == sockHandle) &&
+            (gSockets[sockHandle].devHandle == devHandle) &&
+            (gSockets[sockHandle].edmChannel == edmChannel)) {
+            pSock = &(gSockets[sockHandle]);
+        }
+    }
 
-    for (int32_t index = 0; index < U_WIFI_SOCK_MAX_NUM_SOCKETS; index++) {
+    // Otherwise search, e.g. for a channel beyond the map
+    for (int32_t index = 0; (index < U_WIFI_SOCK_MAX_NUM_SOCKETS) && (pSock == NULL); index++) {
         if (gSockets[index].sockHandle == index &&      // is active socket
             gSockets[index].devHandle == devHandle && // correct instance
             gSockets[index].edmChannel == edmChannel) { // correct edm channel
@@ -472,6 +569,77 @@ static int32_t setOptionInt(uWifiSockSocket_t *pSock,
     return U_SOCK_ENONE;
 }
 
+// Move as much received data as will fit from the pbuf list of a
+// TCP socket into its receive ring buffer, if it has one, so that
+// the pbufs go back to the pool for the other sockets straight away.
+static void moveRxDataToRing(uWifiSockSocket_t *pSock)
+{
+    uShortRangePbufList_t *pList = pSock->pTcpRxBuff;
+
+    if ((pSock->pTcpRxRingBuffer != NULL) && (pList != NULL)) {
+        uShortRangePbufListConsumeDataToRingBuffer(pList, &(pSock->tcpRxRing));
+        if (pList->totalLen == 0) {
+            uShortRangePbufListFree(pList);
+            pSock->pTcpRxBuff = NULL;
+        }
+    }
+}
+
+// Set the #U_SOCK_OPT_RCVBUF option of a TCP socket: the size of
+// a contiguous ring buffer into which received data is copied, zero
+// (the default) for none, in which case received data stays in
+// the pbufs it arrived in until it is read.
+static int32_t setRxRingSize(uWifiSockSocket_t *pSock,
+                             const void *pOptionValue,
+                             size_t optionValueLength)
+{
+    int32_t errnoLocal = -U_SOCK_EINVAL;
+    int32_t size;
+    char *pBuffer = NULL;
+
+    if ((pOptionValue != NULL) && (optionValueLength >= sizeof(int32_t))) {
+        size = *((const int32_t *)pOptionValue);
+        if (pSock->protocol != U_SOCK_PROTOCOL_TCP) {
+            errnoLocal = -U_SOCK_EOPNOTSUPP;
+        } else if (size >= 0) {
+            // Don't throw away data that is already in the ring
+            errnoLocal = -U_SOCK_EBUSY;
+            if ((pSock->pTcpRxRingBuffer == NULL) ||
+                (uRingBufferDataSize(&(pSock->tcpRxRing)) == 0)) {
+                errnoLocal = U_SOCK_ENONE;
+                if (size > 0) {
+                    // +1 since a ring buffer loses one byte to pointer-wrap
+                    pBuffer = (char *)pUPortMalloc(size + 1);
+                    if (pBuffer == NULL) {
+                        errnoLocal = -U_SOCK_ENOMEM;
+                    }
+                }
+            }
+            if (errnoLocal == U_SOCK_ENONE) {
+                // Out with the old (empty) ring, in with the new
+                if (pSock->pTcpRxRingBuffer != NULL) {
+                    uRingBufferDelete(&(pSock->tcpRxRing));
+                    uPortFree(pSock->pTcpRxRingBuffer);
+                    pSock->pTcpRxRingBuffer = NULL;
+                }
+                pSock->intOpts[WIFI_INT_OPT_SOCK_RCVBUF] = 0;
+                if (pBuffer != NULL) {
+                    if (uRingBufferCreate(&(pSock->tcpRxRing), pBuffer, size + 1) == 0) {
+                        pSock->pTcpRxRingBuffer = pBuffer;
+                        pSock->intOpts[WIFI_INT_OPT_SOCK_RCVBUF] = size;
+                        moveRxDataToRing(pSock);
+                    } else {
+                        uPortFree(pBuffer);
+                        errnoLocal = -U_SOCK_ENOMEM;
+                    }
+                }
+            }
+        }
+    }
+
+    return errnoLocal;
+}
+
 // Convert a short range IP struct to uSockAddress structs
 static void convertToSockAddress(const uShortRangeConnectDataIp_t *pShoAddr,
                                  uint16_t *pLocalPort,
@@ -573,14 +741,14 @@ static void edmIpConnectionCallback(int32_t edmHandle,
                                  &remoteAddr);
             pSock = pFindConnectingSocketByRemoteAddress(devHandle, &remoteAddr);
             if (pSock) {
-                pSock->edmChannel = edmChannel;
+                setEdmChannel(pSock, edmChannel);
                 pSock->connected = true;
                 pSock->localPort = localPort;
                 uPortSemaphoreGive(pSock->semaphore);
             } else {
                 pSock = pFindOrCreateClientSocket(devHandle, pConnectData);
                 if (pSock) {
-                    pSock->edmChannel = edmChannel;
+                    setEdmChannel(pSock, edmChannel);
                     pSock->remoteAddress = remoteAddr;
                     pSock->connected = true;
                 } else {
@@ -652,6 +820,7 @@ static void edmIpDataCallback(int32_t edmHandle, int32_t edmChannel,
             } else {
                 uShortRangePbufListMerge(pSock->pTcpRxBuff, pBufList);
             }
+            moveRxDataToRing(pSock);
         }
 
         // Schedule user data callback
@@ -823,6 +992,57 @@ int32_t deinitInstance(uDeviceHandle_t devHandle)
     return errnoLocal;
 }
 
+// Do a TCP write, either of pData or, zero copy, from pZeroCopyBuffer.
+static int32_t sockWrite(uDeviceHandle_t devHandle, int32_t sockHandle,
+                         const void *pData, char *pZeroCopyBuffer,
+                         size_t dataSizeBytes)
+{
+    int32_t errnoLocal;
+    int32_t shortRangeEC;
+    uWifiSockSocket_t *pSock = NULL;
+    uShortRangePrivateInstance_t *pInstance = NULL;
+
+    if (uShortRangeLock() != (int32_t) U_ERROR_COMMON_SUCCESS) {
+        return -U_SOCK_EIO;
+    }
+
+    errnoLocal = getInstanceAndSocket(devHandle, sockHandle, &pInstance, &pSock);
+
+    // We only support Write for TCP sockets
+    if ((errnoLocal == U_SOCK_ENONE) && (pSock->protocol != U_SOCK_PROTOCOL_TCP)) {
+        errnoLocal = -U_SOCK_EOPNOTSUPP;
+    }
+
+    if (errnoLocal == U_SOCK_ENONE) {
+        // Make sure we got the EDM channel
+        if (pSock->edmChannel < 0) {
+            errnoLocal = -U_SOCK_EUNATCH;
+        }
+    }
+    if (errnoLocal == U_SOCK_ENONE) {
+        if (pZeroCopyBuffer != NULL) {
+            shortRangeEC = uShortRangeEdmStreamWriteZeroCopy(pInstance->streamHandle,
+                                                             pSock->edmChannel,
+                                                             pZeroCopyBuffer, dataSizeBytes,
+                                                             U_WIFI_SOCK_WRITE_TIMEOUT_MS);
+        } else {
+            shortRangeEC = uShortRangeEdmStreamWrite(pInstance->streamHandle,
+                                                     pSock->edmChannel,
+                                                     pData, dataSizeBytes,
+                                                     U_WIFI_SOCK_WRITE_TIMEOUT_MS);
+        }
+        if (shortRangeEC >= 0) {
+            errnoLocal = shortRangeEC;
+        } else {
+            errnoLocal = U_SOCK_ECOMM;
+        }
+    }
+
+    uShortRangeUnlock();
+
+    return errnoLocal;
+}
+
 /* ----------------------------------------------------------------
  * PUBLIC FUNCTIONS: WORKAROUND FOR LINKER ISSUE
  * -------------------------------------------------------------- */
@@ -857,6 +1077,7 @@ int32_t uWifiSockInit(void)
         for (int i = 0; i < U_WIFI_MAX_INSTANCE_COUNT; i++) {
             gInstanceDeviceHandleList[i] = NULL;
         }
+        memset(gEdmChannelToSocket, -1, sizeof(gEdmChannelToSocket));
         if (errnoLocal == U_SOCK_ENONE) {
             freeAllSockets();
             gInitialised = true;
@@ -893,6 +1114,7 @@ int32_t uWifiSockInitInstance(uDeviceHandle_t devHandle)
             if (gInstanceDeviceHandleList[i] == NULL) {
                 errnoLocal = U_SOCK_ENONE;
                 gInstanceDeviceHandleList[i] = devHandle;
+                memset(gEdmChannelToSocket[i], -1, sizeof(gEdmChannelToSocket[i]));
                 break;
             }
         }
@@ -1000,7 +1222,7 @@ int32_t uWifiSockCreate(uDeviceHandle_t devHandle,
             pSock->protocol = protocol;
             pSock->connected = false;
             pSock->closing = false;
-            pSock->edmChannel = -1;
+            setEdmChannel(pSock, -1);
             pSock->connHandle = -1;
             pSock->serverId = -1;
             pSock->connHandle = -1;
@@ -1103,7 +1325,7 @@ int32_t uWifiSockConnect(uDeviceHandle_t devHandle,
                     closePeer(pInstance->atHandle, pSock->connHandle);
                     // Update socket state
                     pSock->connHandle = -1;
-                    pSock->edmChannel = -1;
+                    setEdmChannel(pSock, -1);
                 }
             } else {
                 errnoLocal = conPeerResult;
@@ -1203,7 +1425,9 @@ int32_t uWifiSockOptionSet(uDeviceHandle_t devHandle,
         WifiIntOptId_t wifiOpt = getIntOptionId(level, option);
 
         errnoLocal = -U_SOCK_EINVAL;
-        if (wifiOpt != WIFI_INT_OPT_INVALID) {
+        if (wifiOpt == WIFI_INT_OPT_SOCK_RCVBUF) {
+            errnoLocal = setRxRingSize(pSock, pOptionValue, optionValueLength);
+        } else if (wifiOpt != WIFI_INT_OPT_INVALID) {
             errnoLocal = setOptionInt(pSock, wifiOpt, pOptionValue, optionValueLength);
         }
     }
@@ -1262,46 +1486,22 @@ int32_t uWifiSockWrite(uDeviceHandle_t devHandle,
                        int32_t sockHandle,
                        const void *pData, size_t dataSizeBytes)
 {
-    int32_t errnoLocal;
-    uWifiSockSocket_t *pSock = NULL;
-    uShortRangePrivateInstance_t *pInstance = NULL;
-
     if ((dataSizeBytes == 0) || (pData == NULL)) {
         return -U_SOCK_EINVAL;
     }
 
-    if (uShortRangeLock() != (int32_t) U_ERROR_COMMON_SUCCESS) {
-        return -U_SOCK_EIO;
-    }
-
-    errnoLocal = getInstanceAndSocket(devHandle, sockHandle, &pInstance, &pSock);
-
-    // We only support Write for TCP sockets
-    if ((errnoLocal == U_SOCK_ENONE) && (pSock->protocol != U_SOCK_PROTOCOL_TCP)) {
-        errnoLocal = -U_SOCK_EOPNOTSUPP;
-    }
+    return sockWrite(devHandle, sockHandle, pData, NULL, dataSizeBytes);
+}
 
-    if (errnoLocal == U_SOCK_ENONE) {
-        // Make sure we got the EDM channel
-        if (pSock->edmChannel < 0) {
-            errnoLocal = -U_SOCK_EUNATCH;
-        }
-    }
-    if (errnoLocal == U_SOCK_ENONE) {
-        int32_t shortRangeEC = uShortRangeEdmStreamWrite(pInstance->streamHandle,
-                                                         pSock->edmChannel,
-                                                         pData, dataSizeBytes,
-                                                         U_WIFI_SOCK_WRITE_TIMEOUT_MS);
-        if (shortRangeEC >= 0) {
-            errnoLocal = shortRangeEC;
-        } else {
-            errnoLocal = U_SOCK_ECOMM;
-        }
+int32_t uWifiSockWriteZeroCopy(uDeviceHandle_t devHandle,
+                               int32_t sockHandle,
+                               char *pBuffer, size_t dataSizeBytes)
+{
+    if ((dataSizeBytes == 0) || (pBuffer == NULL)) {
+        return -U_SOCK_EINVAL;
     }
 
-    uShortRangeUnlock();
-
-    return errnoLocal;
+    return sockWrite(devHandle, sockHandle, NULL, pBuffer, dataSizeBytes);
 }
 
 int32_t uWifiSockRead(uDeviceHandle_t devHandle,
@@ -1312,6 +1512,7 @@ int32_t uWifiSockRead(uDeviceHandle_t devHandle,
     uWifiSockSocket_t *pSock = NULL;
     uShortRangePrivateInstance_t *pInstance = NULL;
     uShortRangePbufList_t *pList;
+    size_t readSize;
 
     if (uShortRangeLock() != (int32_t) U_ERROR_COMMON_SUCCESS) {
         return -U_SOCK_EIO;
@@ -1325,8 +1526,16 @@ int32_t uWifiSockRead(uDeviceHandle_t devHandle,
     }
 
     if (errnoLocal == U_SOCK_ENONE) {
+        // Data in the receive ring buffer, if there is one, arrived
+        // before any data still in the pbuf list
+        readSize = 0;
+        if ((pSock->pTcpRxRingBuffer != NULL) && (pData != NULL)) {
+            readSize = uRingBufferRead(&(pSock->tcpRxRing), (char *)pData, dataSizeBytes);
+        }
         pList = pSock->pTcpRxBuff;
-        errnoLocal = (int32_t)uShortRangePbufListConsumeData(pList, (char *)pData, dataSizeBytes);
+        readSize += uShortRangePbufListConsumeData(pList, (char *)pData + readSize,
+                                                   dataSizeBytes - readSize);
+        errnoLocal = (int32_t)readSize;
         if (errnoLocal == 0) {
             // If there are no data available we must return U_SOCK_EWOULDBLOCK
             errnoLocal = -U_SOCK_EWOULDBLOCK;
@@ -1336,6 +1545,8 @@ int32_t uWifiSockRead(uDeviceHandle_t devHandle,
             uShortRangePbufListFree(pList);
             pSock->pTcpRxBuff = NULL;
         }
+        // Refill the receive ring buffer from anything left over
+        moveRxDataToRing(pSock);
     }
 
     uShortRangeUnlock();
@@ -1421,7 +1632,7 @@ int32_t uWifiSockSendTo(uDeviceHandle_t devHandle,
                     closePeer(pInstance->atHandle, pSock->connHandle);
                     // Update socket state
                     pSock->connHandle = -1;
-                    pSock->edmChannel = -1;
+                    setEdmChannel(pSock, -1);
                 }
             } else {
                 errnoLocal = -U_SOCK_EIO;
@@ -126,6 +126,14 @@ static uDeviceCfg_t gDeviceCfg = {
 
 static int32_t gStartTimeMs = -1;
 
+/** Assets to be served by the captive portal, in addition to
+ * the built-in page.
+ */
+static const uWifiCaptivePortalAsset_t gAssets[] = {
+    {"/hello.txt", "text/plain", "hello", 5, false, "v1"},
+    {"/empty.txt", "text/plain", NULL, 0, false, NULL}
+};
+
 /* ----------------------------------------------------------------
  * STATIC FUNCTIONS
  * -------------------------------------------------------------- */
@@ -176,12 +184,18 @@ U_PORT_TEST_FUNCTION("[wifiCaptivePortal]", "wifiCaptivePortal")
                                           &(remoteAddress.ipAddress)) == 0);
     uNetworkInterfaceDown(gDeviceHandle, U_NETWORK_TYPE_WIFI);
 
+    // Check parameters and set the assets
+    U_PORT_TEST_ASSERT(uWifiCaptivePortalSetAssets(NULL, 1) < 0);
+    U_PORT_TEST_ASSERT(uWifiCaptivePortalSetAssets(gAssets,
+                                                   sizeof(gAssets) / sizeof(gAssets[0])) == 0);
+
     // Now do the actual test
     gStartTimeMs = uPortGetTickTimeMs();
     int32_t returnCode = uWifiCaptivePortal(gDeviceHandle, "UBXLIB_TEST_PORTAL", NULL,
                                             keepGoingCallback);
     U_TEST_PRINT_LINE("uWifiCaptivePortal() returned %d.", returnCode);
     U_PORT_TEST_ASSERT(returnCode == 0);
+    U_PORT_TEST_ASSERT(uWifiCaptivePortalSetAssets(NULL, 0) == 0);
 
     // The network interface will have been brought up by
     // uWifiCaptivePortal(), we need to take it down again
@@ -370,6 +370,41 @@ U_PORT_TEST_FUNCTION("[wifiLoc]", "wifiLocBasic")
         }
     }
 
+    // Now switch the location cache on: if a location is obtained a
+    // second request, made immediately, should be answered from the cache
+    U_TEST_PRINT_LINE("testing the location cache with %s.", gLocType[0].pName);
+    U_PORT_TEST_ASSERT(uWifiLocSetCache(gHandles.devHandle, 101, 60, 0) < 0);
+    U_PORT_TEST_ASSERT(uWifiLocSetCache(gHandles.devHandle, 50, 60, 0) == 0);
+    z = -1;
+    for (size_t y = 0; (y < U_WIFI_LOC_TEST_TRIES) && (z != 0); y++) {
+        gStopTimeMs = uPortGetTickTimeMs() + U_WIFI_LOC_TEST_TIMEOUT_SECONDS * 1000;
+        locationSetDefaults(&location);
+        z = uWifiLocGet(gHandles.devHandle, gLocType[0].type, gLocType[0].pApiKey,
+                        U_WIFI_LOC_TEST_AP_FILTER, U_WIFI_LOC_TEST_RSSI_FILTER_DBM,
+                        &location, keepGoingCallback);
+    }
+    if (z == 0) {
+        uLocation_t cachedLocation;
+        locationSetDefaults(&cachedLocation);
+        startTimeMs = uPortGetTickTimeMs();
+        gStopTimeMs = startTimeMs + U_WIFI_LOC_TEST_TIMEOUT_SECONDS * 1000;
+        z = uWifiLocGet(gHandles.devHandle, gLocType[0].type, gLocType[0].pApiKey,
+                        U_WIFI_LOC_TEST_AP_FILTER, U_WIFI_LOC_TEST_RSSI_FILTER_DBM,
+                        &cachedLocation, keepGoingCallback);
+        U_TEST_PRINT_LINE("second uWifiLocGet() returned %d in %d ms.", z,
+                          uPortGetTickTimeMs() - startTimeMs);
+        U_PORT_TEST_ASSERT(z == 0);
+        // The environment may, of course, have changed, so just a warning
+        if ((cachedLocation.latitudeX1e7 != location.latitudeX1e7) ||
+            (cachedLocation.longitudeX1e7 != location.longitudeX1e7)) {
+            U_TEST_PRINT_LINE("*** WARNING *** second location was not from the cache.");
+        }
+    } else {
+        U_TEST_PRINT_LINE("*** WARNING *** %s cloud service was unable to determine position,"
+                          " cache not tested.", gLocType[0].pName);
+    }
+    U_PORT_TEST_ASSERT(uWifiLocSetCache(gHandles.devHandle, 0, 0, 0) == 0);
+
     uWifiTestPrivatePostamble(&gHandles);
 
     // Check for resource leaks
@@ -165,6 +165,9 @@ static uWifiTestPrivate_t gHandles = { -1, -1, NULL, NULL };
 
 static volatile bool gMqttSessionDisconnected = false;
 
+static volatile int32_t gMqttPublishCompleteCount = 0;
+static volatile int32_t gMqttPublishErrorCode = 0;
+
 static uShortRangeUartConfig_t gUart = { .uartPort = U_CFG_APP_SHORT_RANGE_UART,
                                          .baudRate = U_SHORT_RANGE_UART_BAUD_RATE,
                                          .pinTx = U_CFG_APP_PIN_SHORT_RANGE_TXD,
@@ -212,6 +215,17 @@ static void mqttDisconnectCb(int32_t status, void *pCbParam)
     gMqttSessionDisconnected = true;
 }
 
+static void mqttPublishCb(int32_t messageId, int32_t errorCode, void *pCbParam)
+{
+    (void)pCbParam;
+    U_TEST_PRINT_LINE("MQTT publish of message ID %d completed with %d.",
+                      messageId, errorCode);
+    if (errorCode != 0) {
+        gMqttPublishErrorCode = errorCode;
+    }
+    gMqttPublishCompleteCount++;
+}
+
 
 static int32_t mqttSubscribe(uMqttClientContext_t *gpMqttClientCtx,
                              const char *pTopicFilterStr,
@@ -534,6 +548,28 @@ static int32_t wifiMqttPublishSubscribeTest(bool isSecuredConnection)
     U_PORT_TEST_ASSERT(uMqttClientGetTotalMessagesReceived(gpMqttClientCtx) ==
                        (MQTT_PUBLISH_TOTAL_MSG_COUNT << 1));
 
+    // Now publish asynchronously, all in one go
+    gMqttPublishCompleteCount = 0;
+    gMqttPublishErrorCode = 0;
+    U_PORT_TEST_ASSERT(uMqttClientSetPublishCallback(gpMqttClientCtx, mqttPublishCb, NULL) == 0);
+    for (count = 0; count < MQTT_PUBLISH_TOTAL_MSG_COUNT; count++) {
+        err = uMqttClientPublish(gpMqttClientCtx,
+                                 pTopicOut1,
+                                 gTestPublishMsg[count],
+                                 strlen(gTestPublishMsg[count]),
+                                 qos,
+                                 false);
+        U_TEST_PRINT_LINE("asynchronous publish returned %d.", err);
+        U_PORT_TEST_ASSERT(err >= 0);
+    }
+    for (count = 0; (count < MQTT_RETRY_COUNT) &&
+         (gMqttPublishCompleteCount < MQTT_PUBLISH_TOTAL_MSG_COUNT); count++) {
+        uPortTaskBlock(1000);
+    }
+    U_PORT_TEST_ASSERT(gMqttPublishCompleteCount == MQTT_PUBLISH_TOTAL_MSG_COUNT);
+    U_PORT_TEST_ASSERT(gMqttPublishErrorCode == 0);
+    U_PORT_TEST_ASSERT(uMqttClientSetPublishCallback(gpMqttClientCtx, NULL, NULL) == 0);
+
     err = uMqttClientDisconnect(gpMqttClientCtx);
     U_PORT_TEST_ASSERT(err == (int32_t)U_ERROR_COMMON_SUCCESS);
 
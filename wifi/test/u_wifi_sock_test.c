@@ -449,6 +449,21 @@ U_PORT_TEST_FUNCTION("[wifiSock]", "wifiSockTCPTest")
                                         closedCallbackTcp);
     }
 
+    // Give the TCP socket a receive ring buffer
+    if (!TEST_HAS_ERROR()) {
+        int32_t rxRingSize = U_WIFI_SOCK_MAX_SEGMENT_SIZE_BYTES;
+        size_t length = sizeof(rxRingSize);
+        returnCode = uWifiSockOptionSet(gHandles.devHandle, gSockHandleTcp,
+                                        U_SOCK_OPT_LEVEL_SOCK, U_SOCK_OPT_RCVBUF,
+                                        &rxRingSize, sizeof(rxRingSize));
+        TEST_CHECK_TRUE(returnCode == 0);
+        rxRingSize = 0;
+        returnCode = uWifiSockOptionGet(gHandles.devHandle, gSockHandleTcp,
+                                        U_SOCK_OPT_LEVEL_SOCK, U_SOCK_OPT_RCVBUF,
+                                        &rxRingSize, &length);
+        TEST_CHECK_TRUE((returnCode == 0) && (rxRingSize == U_WIFI_SOCK_MAX_SEGMENT_SIZE_BYTES));
+    }
+
     if (!TEST_HAS_ERROR()) {
         uSockAddress_t localAddress;
         returnCode = uWifiSockGetLocalAddress(gHandles.devHandle,
@@ -491,14 +506,23 @@ U_PORT_TEST_FUNCTION("[wifiSock]", "wifiSockTCPTest")
                 bytesToWrite = 1ul + ((uint32_t)rand() % ((sizeof(gAllChars) - bytesWritten) - 1ul));
             }
             chunkCounter++;
-            returnCode = uWifiSockWrite(gHandles.devHandle, gSockHandleTcp,
-                                        gAllChars + bytesWritten, bytesToWrite);
+            if (chunkCounter % 2 == 0) {
+                // Send every other chunk zero-copy, from pBuffer,
+                // which is not otherwise in use at this point
+                memcpy(pBuffer + U_WIFI_SOCK_WRITE_ZERO_COPY_HEADROOM_BYTES,
+                       gAllChars + bytesWritten, bytesToWrite);
+                returnCode = uWifiSockWriteZeroCopy(gHandles.devHandle, gSockHandleTcp,
+                                                    pBuffer, bytesToWrite);
+            } else {
+                returnCode = uWifiSockWrite(gHandles.devHandle, gSockHandleTcp,
+                                            gAllChars + bytesWritten, bytesToWrite);
+            }
             if (returnCode > 0) {
                 bytesWritten += returnCode;
             } else if (returnCode == 0) {
                 uPortTaskBlock(500);
             } else {
-                U_TEST_PRINT_LINE("uWifiSockWrite() returned: %d.", returnCode);
+                U_TEST_PRINT_LINE("uWifiSockWrite[ZeroCopy]() returned: %d.", returnCode);
                 TEST_CHECK_TRUE(false);
             }
         }
@@ -221,6 +221,18 @@ static uWifiTestError_t runWifiTest(const char *pSsid, const char *pPassPhrase)
                 uPortTaskBlock(1000);
                 waitCtr++;
             }
+            if (!connectError) {
+                // Read back the IP configuration obtained by DHCP, as
+                // an application would for uWifiStationConnectFast()
+                uWifiIpCfg_t ipCfg;
+                if (uWifiStationGetIpCfg(gHandles.devHandle, &ipCfg) == 0) {
+                    U_TEST_PRINT_LINE("IP address %s, gateway %s.",
+                                      (char *) ipCfg.IPv4Addr, (char *) ipCfg.defaultGW);
+                } else {
+                    U_TEST_PRINT_LINE("unable to read IP configuration.");
+                    connectError = U_WIFI_TEST_ERROR_IPRECV;
+                }
+            }
         } else {
             connectError = U_WIFI_TEST_ERROR_CONNECT;
         }
@@ -544,6 +556,23 @@ U_PORT_TEST_FUNCTION("[wifi]", "wifiScan")
     // Make sure the AP was NOT found
     U_PORT_TEST_ASSERT(gScanResult.channel == 0);
 
+    //----------------------------------------------------------
+    // Check the scan cache
+    //----------------------------------------------------------
+    memset(&gScanResult, 0, sizeof(gScanResult));
+    result = uWifiStationScanCacheGet(gHandles.devHandle,
+                                      U_PORT_STRINGIFY_QUOTED(U_WIFI_TEST_CFG_SSID),
+                                      &gScanResult);
+    U_TEST_PRINT_LINE("scan cache entry for the AP is %d second(s) old.", result);
+    U_PORT_TEST_ASSERT(result >= 0);
+    U_PORT_TEST_ASSERT(validateScanResult(&gScanResult));
+    U_PORT_TEST_ASSERT(uWifiStationScanCacheGet(gHandles.devHandle, "DUMMYSSID",
+                                                NULL) == (int32_t) U_ERROR_COMMON_NOT_FOUND);
+    uWifiStationScanCacheClear(gHandles.devHandle);
+    U_PORT_TEST_ASSERT(uWifiStationScanCacheGet(gHandles.devHandle,
+                                                U_PORT_STRINGIFY_QUOTED(U_WIFI_TEST_CFG_SSID),
+                                                NULL) == (int32_t) U_ERROR_COMMON_NOT_FOUND);
+
     uWifiTestPrivatePostamble(&gHandles);
 
     // Handle errors